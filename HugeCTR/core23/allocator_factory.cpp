@@ -20,6 +20,7 @@
 #include <core23/details/new_delete_allocator.hpp>
 #include <core23/details/pinned_host_allocator.hpp>
 #include <core23/details/simple_cuda_allocator.hpp>
+#include <core23/details/virtual_cuda_allocator.hpp>
 #include <core23/logger.hpp>
 #include <memory>
 
@@ -31,7 +32,11 @@ std::unique_ptr<Allocator> GetDefaultGPUAllocator(const AllocatorParams& allocat
                                                   const Device& device) {
   std::unique_ptr<Allocator> ret;
   if (allocator_params.pinned) {
-    if (allocator_params.compressible) {
+    if (allocator_params.growable) {
+      HCTR_THROW_IF(allocator_params.compressible, HugeCTR::Error_t::IllegalCall,
+                    "Growable allocations cannot be compressible");
+      ret.reset(new VirtualCUDAAllocator(device));
+    } else if (allocator_params.compressible) {
       ret.reset(new LowLevelCUDAAllocator(device, true));
     } else {
       ret.reset(new SimpleCUDAAllocator());
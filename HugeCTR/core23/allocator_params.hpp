@@ -30,6 +30,7 @@ struct AllocatorParams {
   static CustomFactory default_allocator_factory;
   bool pinned = true;
   bool compressible = false;  // TODO: perhaps replace by a Decorator
+  bool growable = false;      // GPU allocations can grow in place, see VirtualCUDAAllocator
   CustomFactory custom_factory = default_allocator_factory;
 };
 
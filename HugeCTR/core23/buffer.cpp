@@ -14,16 +14,29 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <core23/buffer.hpp>
 #include <core23/buffer_client.hpp>
 #include <core23/device_guard.hpp>
 #include <core23/logger.hpp>
+#include <core23/memory_usage.hpp>
 #include <core23/offsetted_buffer.hpp>
 
 namespace HugeCTR {
 
 namespace core23 {
 
+namespace {
+
+// The clients which are not created from TensorParams, and have no tag, count as untagged.
+void RecordClientMemoryUsage(const Device& device, const BufferRequirements& requirements,
+                             const int64_t sign) {
+  RecordMemoryUsage(device, requirements.tag.empty() ? "untagged" : requirements.tag,
+                    sign * requirements.num_bytes);
+}
+
+}  // namespace
+
 Buffer::~Buffer() {
   HCTR_CHECK_HINT(served_client_requirements_.size() == 0 && new_client_requirements_.size() == 0,
                   "There must be no remaining clients in destructing a Buffer");
@@ -63,6 +76,7 @@ void Buffer::unsubscribe(BufferClient* client) {
     auto offset = it_co->second;
     client_offsets_.erase(it_co);
     post_unsubscribe(client, requirements, offset);
+    RecordClientMemoryUsage(device_, requirements, -1);
   } else {
     auto it1 = new_client_requirements_.find(client);
     if (it1 != new_client_requirements_.end()) {
@@ -75,6 +89,21 @@ void Buffer::unsubscribe(BufferClient* client) {
   client->on_unsubscribe(OffsettedBuffer(nullptr, {}));
 }
 
+void Buffer::set_lifetime(BufferClient* client, int64_t first_step, int64_t last_step,
+                          AccessKey) {
+  auto it = new_client_requirements_.find(client);
+  HCTR_THROW_IF(it == new_client_requirements_.end(), HugeCTR::Error_t::IllegalCall,
+                "The lifetime can only be set before the client is allocated.");
+  auto& lifetime = it->second.lifetime;
+  if (lifetime) {
+    // The tensors that share a client, e.g., by reshape(), extend its lifetime.
+    lifetime->first = std::min(lifetime->first, first_step);
+    lifetime->second = std::max(lifetime->second, last_step);
+  } else {
+    lifetime = std::make_pair(first_step, last_step);
+  }
+}
+
 void Buffer::allocate() {
   DeviceGuard device_guard(device_);
 
@@ -89,6 +118,9 @@ void Buffer::allocate() {
     }
   }
 
+  for (const auto& [client, requirements] : new_client_requirements_) {
+    RecordClientMemoryUsage(device_, requirements, 1);
+  }
   client_offsets_.merge(new_client_offsets);
   served_client_requirements_.merge(new_client_requirements_);
 }
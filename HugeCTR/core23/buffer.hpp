@@ -53,6 +53,7 @@ class Buffer : public std::enable_shared_from_this<Buffer> {
   }
 
   inline void* data(int64_t offset, AccessKey) const { return data_impl(offset); }
+  void set_lifetime(BufferClient* client, int64_t first_step, int64_t last_step, AccessKey);
 
   virtual std::pair<void*, int64_t> decay() const { return std::make_pair(nullptr, 0LL); }
   size_t reserved_size() { return do_get_reserved_size(allocator_, new_client_requirements_); };
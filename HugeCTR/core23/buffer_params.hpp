@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 
 namespace HugeCTR {
 
@@ -35,6 +36,8 @@ struct BufferParams {
 
   BufferChannel channel = GetRandomBufferChannel();
   bool unitary = true;
+  // Subsystem and layer the Tensors are attributed to, instead of the tag of the MemoryTagScope.
+  std::string tag;
   static CustomFactory custom_factory;
 };
 
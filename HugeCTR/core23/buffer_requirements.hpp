@@ -18,6 +18,9 @@
 
 #include <core23/cuda_stream.hpp>
 #include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
 
 namespace HugeCTR {
 
@@ -27,6 +30,11 @@ struct BufferRequirements {
   int64_t num_bytes;
   int64_t alignment;
   CUDAStream stream;
+  // The first and last steps the client is used in. A UnitaryBuffer shares the memory among the
+  // clients whose lifetimes are disjoint, while a client without a lifetime has its own memory.
+  std::optional<std::pair<int64_t, int64_t>> lifetime;
+  // What the memory usage of the client is attributed to. See core23/memory_usage.hpp.
+  std::string tag;
 };
 
 }  // namespace core23
@@ -17,6 +17,7 @@
 #include <core23/buffer_requirements.hpp>
 #include <core23/details/tensor_helpers.hpp>
 #include <core23/logger.hpp>
+#include <core23/memory_usage.hpp>
 #include <core23/tensor_params.hpp>
 
 namespace HugeCTR {
@@ -50,7 +51,9 @@ BufferRequirements ConvertToBufferRequirements(const TensorParams& tensor_params
   BufferRequirements requirements = {
       .num_bytes = tensor_params.shape().size() * tensor_params.data_type().size(),
       .alignment = GetValidAlignment(tensor_params.alignment(), tensor_params.data_type()),
-      .stream = tensor_params.stream()};
+      .stream = tensor_params.stream(),
+      .tag = tensor_params.buffer_params().tag.empty() ? GetMemoryTag()
+                                                       : tensor_params.buffer_params().tag};
   return requirements;
 }
 
@@ -42,6 +42,12 @@ void* TensorImpl::data() const {
   }
   return bound_data_ ? bound_data_.value() : nullptr;
 }
+
+void TensorImpl::set_lifetime(int64_t first_step, int64_t last_step) {
+  if (offsetted_buffer()) {
+    offsetted_buffer()->set_lifetime(this, first_step, last_step);
+  }
+}
 }  // namespace core23
 
 }  // namespace HugeCTR
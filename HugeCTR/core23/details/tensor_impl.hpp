@@ -55,6 +55,8 @@ class TensorImpl : public BufferClient {
 
   bool own_data() const { return offsetted_buffer() != nullptr; }
 
+  void set_lifetime(int64_t first_step, int64_t last_step);
+
  private:
   TensorParams params_;
   std::optional<void*> bound_data_;
@@ -14,13 +14,16 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <core23/allocator.hpp>
 #include <core23/buffer_client.hpp>
 #include <core23/details/unitary_buffer.hpp>
 #include <core23/device.hpp>
 #include <core23/logger.hpp>
 #include <core23/offsetted_buffer.hpp>
+#include <limits>
 #include <memory>
+#include <vector>
 
 namespace HugeCTR {
 
@@ -41,27 +44,94 @@ size_t UnitaryBuffer::do_get_reserved_size(const std::unique_ptr<Allocator>& all
   if (client_requirements.empty()) {
     return 0;
   }
-  int64_t current_offset = 0;
-  bool is_first = true;
-
+  std::vector<BufferClient*> clients;
   std::queue<BufferClient*> tmp_order = new_insertion_order_;
   while (!tmp_order.empty()) {
     auto client = tmp_order.front();
-    auto search = client_requirements.find(client);
-    if (search != client_requirements.end()) {
-      auto requirements = search->second;
+    if (client_requirements.find(client) != client_requirements.end()) {
+      clients.push_back(client);
+    }
+    tmp_order.pop();
+  }
+  ClientOffsets client_offsets;
+  return compute_offsets(allocator, client_requirements, clients, client_offsets);
+}
+
+int64_t UnitaryBuffer::compute_offsets(const std::unique_ptr<Allocator>& allocator,
+                                       const ClientRequirements& client_requirements,
+                                       const std::vector<BufferClient*>& clients,
+                                       ClientOffsets& client_offsets) {
+  const bool has_lifetimes =
+      std::any_of(clients.begin(), clients.end(), [&client_requirements](BufferClient* client) {
+        return client_requirements.at(client).lifetime.has_value();
+      });
+  if (!has_lifetimes) {
+    int64_t current_offset = 0;
+    bool is_first = true;
+    for (auto client : clients) {
+      const auto& requirements = client_requirements.at(client);
       int64_t alignment = requirements.alignment;
       if (is_first) {
         alignment = allocator->get_valid_alignment(alignment);
         is_first = false;
       }
       current_offset = compute_offset(current_offset, alignment);
+      client_offsets[client] = current_offset;
       current_offset += requirements.num_bytes;
     }
-    tmp_order.pop();
+    return current_offset;
+  }
+
+  // The clients with a lifetime are placed from the largest one, each at the lowest offset where
+  // it doesn't overlap with the placed clients whose lifetimes overlap with its own. The clients
+  // without a lifetime are placed first, as they overlap with all the others.
+  constexpr std::pair<int64_t, int64_t> whole_lifetime{std::numeric_limits<int64_t>::min(),
+                                                       std::numeric_limits<int64_t>::max()};
+  std::vector<BufferClient*> order = clients;
+  std::stable_sort(order.begin(), order.end(),
+                   [&client_requirements](BufferClient* lhs, BufferClient* rhs) {
+                     const auto& l = client_requirements.at(lhs);
+                     const auto& r = client_requirements.at(rhs);
+                     if (l.lifetime.has_value() != r.lifetime.has_value()) {
+                       return !l.lifetime.has_value();
+                     }
+                     return l.lifetime.has_value() && l.num_bytes > r.num_bytes;
+                   });
+  struct Placement {
+    int64_t begin;
+    int64_t end;
+    std::pair<int64_t, int64_t> lifetime;
+  };
+  std::vector<Placement> placements;
+  int64_t size = 0;
+  for (auto client : order) {
+    const auto& requirements = client_requirements.at(client);
+    const auto lifetime = requirements.lifetime.value_or(whole_lifetime);
+    std::vector<const Placement*> overlapping;
+    for (const auto& placement : placements) {
+      if (placement.lifetime.first <= lifetime.second &&
+          lifetime.first <= placement.lifetime.second) {
+        overlapping.push_back(&placement);
+      }
+    }
+    std::sort(overlapping.begin(), overlapping.end(),
+              [](const Placement* lhs, const Placement* rhs) { return lhs->begin < rhs->begin; });
+    int64_t offset = 0;
+    for (auto placement : overlapping) {
+      offset = compute_offset(offset, requirements.alignment);
+      if (offset + requirements.num_bytes <= placement->begin) {
+        break;
+      }
+      offset = std::max(offset, placement->end);
+    }
+    offset = compute_offset(offset, requirements.alignment);
+    client_offsets[client] = offset;
+    placements.push_back({offset, offset + requirements.num_bytes, lifetime});
+    size = std::max(size, offset + requirements.num_bytes);
   }
-  return current_offset;
+  return size;
 }
+
 Buffer::ClientOffsets UnitaryBuffer::do_allocate(const std::unique_ptr<Allocator>& allocator,
                                                  const ClientRequirements& client_requirements) {
   if (client_requirements.empty()) {
@@ -75,36 +145,26 @@ Buffer::ClientOffsets UnitaryBuffer::do_allocate(const std::unique_ptr<Allocator
                    "The UnitaryBuffer doesn't allow the multiple allocation.");
   }
 
-  int64_t current_offset = 0;
-  bool is_first = true;
   const auto& first_stream = client_requirements.begin()->second.stream;
 
-  ClientOffsets client_offsets;
-
+  std::vector<BufferClient*> clients;
   while (!new_insertion_order_.empty()) {
     auto client = new_insertion_order_.front();
     auto search = client_requirements.find(client);
     if (search != client_requirements.end()) {
-      auto requirements = search->second;
-      int64_t alignment = requirements.alignment;
-      if (is_first) {
-        alignment = allocator->get_valid_alignment(alignment);
-        is_first = false;
-      } else {
-        const auto& current_stream = requirements.stream;
-        if (first_stream != current_stream) {
-          HCTR_LOG_S(WARNING, ROOT)
-              << "A BufferClient doesn't have the same CUDAStream with the first BufferClient."
-              << std::endl;
-        }
+      if (!clients.empty() && first_stream != search->second.stream) {
+        HCTR_LOG_S(WARNING, ROOT)
+            << "A BufferClient doesn't have the same CUDAStream with the first BufferClient."
+            << std::endl;
       }
-
-      current_offset = compute_offset(current_offset, alignment);
-      client_offsets[client] = current_offset;
-      current_offset += requirements.num_bytes;
+      clients.push_back(client);
     }
     new_insertion_order_.pop();
   }
+
+  ClientOffsets client_offsets;
+  const int64_t current_offset =
+      compute_offsets(allocator, client_requirements, clients, client_offsets);
   ptr_ = allocator->allocate(current_offset, first_stream);
   if (ptr_ == nullptr && current_offset) {
     HCTR_OWN_THROW(HugeCTR::Error_t::OutOfMemory,
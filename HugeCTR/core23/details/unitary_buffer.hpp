@@ -18,6 +18,7 @@
 
 #include <core23/buffer.hpp>
 #include <queue>
+#include <vector>
 
 namespace HugeCTR {
 
@@ -51,6 +52,10 @@ class UnitaryBuffer final : public Buffer {
   void post_subscribe(const BufferClient* client, BufferRequirements requirements) override;
 
   int64_t compute_offset(int64_t offset, int64_t alignment);
+  // Sets the offsets of the clients, which subscribed in their order, and returns the total size.
+  int64_t compute_offsets(const std::unique_ptr<Allocator>& allocator,
+                          const ClientRequirements& client_requirements,
+                          const std::vector<BufferClient*>& clients, ClientOffsets& client_offsets);
 
   bool allocated_;
   void* ptr_;
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core23/details/virtual_cuda_allocator.hpp>
+#include <core23/device.hpp>
+#include <core23/device_guard.hpp>
+#include <core23/logger.hpp>
+#include <string>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+VirtualCUDAAllocator::VirtualCUDAAllocator(const Device& device, int64_t reserve_size,
+                                           const std::vector<int>& peers)
+    : prop_{.type = CU_MEM_ALLOCATION_TYPE_PINNED,
+            .location = {CU_MEM_LOCATION_TYPE_DEVICE, device.index()}},
+      granularity_(0) {
+  HCTR_THROW_IF(device.type() != DeviceType::GPU, HugeCTR::Error_t::IllegalCall,
+                "Only DeviceType::GPU is supported.");
+  HCTR_THROW_IF(reserve_size < 0, HugeCTR::Error_t::WrongInput, "Invalid reserve size");
+
+  DeviceGuard guard(device);
+  HCTR_LIB_THROW(cudaFree(0));
+  HCTR_LIB_THROW(
+      cuMemGetAllocationGranularity(&granularity_, &prop_, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
+
+  if (reserve_size == 0) {
+    size_t free = 0, total = 0;
+    HCTR_LIB_THROW(cudaMemGetInfo(&free, &total));
+    reserve_size = static_cast<int64_t>(total);
+  }
+  reserve_size_ = get_padded_size(reserve_size);
+
+  access_descs_.push_back(
+      {.location = prop_.location, .flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE});
+  for (const int peer : peers) {
+    if (peer != device.index()) {
+      access_descs_.push_back({.location = {CU_MEM_LOCATION_TYPE_DEVICE, peer},
+                               .flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE});
+    }
+  }
+}
+
+VirtualCUDAAllocator::~VirtualCUDAAllocator() {
+  for (const auto& [ptr, allocation] : allocations_) {
+    release(ptr, allocation);
+  }
+}
+
+void* VirtualCUDAAllocator::allocate(int64_t size, CUDAStream) {
+  CUdeviceptr ptr = 0ULL;
+  HCTR_LIB_THROW(cuMemAddressReserve(&ptr, reserve_size_, granularity_, 0ULL, 0ULL));
+  allocations_[ptr] = {0, {}, {}};
+  try {
+    grow(reinterpret_cast<void*>(ptr), size);
+  } catch (...) {
+    deallocate(reinterpret_cast<void*>(ptr));
+    throw;
+  }
+  return reinterpret_cast<void*>(ptr);
+}
+
+void VirtualCUDAAllocator::grow(void* ptr, int64_t new_size) {
+  const CUdeviceptr dev_ptr = reinterpret_cast<CUdeviceptr>(ptr);
+  auto it = allocations_.find(dev_ptr);
+  HCTR_THROW_IF(it == allocations_.end(), HugeCTR::Error_t::IllegalCall,
+                "`ptr` is not allocated by this allocator");
+  HCTR_THROW_IF(new_size < 0 || static_cast<size_t>(new_size) > reserve_size_,
+                HugeCTR::Error_t::OutOfMemory,
+                "Cannot grow an allocation beyond the " + std::to_string(reserve_size_) +
+                    " bytes reserved for it");
+
+  Allocation& allocation = it->second;
+  const size_t padded_size = get_padded_size(new_size);
+  if (padded_size <= allocation.mapped_size) {
+    return;
+  }
+
+  // Map a physical chunk right after the mapped part of the reserved range.
+  const size_t chunk_size = padded_size - allocation.mapped_size;
+  CUmemGenericAllocationHandle handle;
+  HCTR_LIB_THROW(cuMemCreate(&handle, chunk_size, &prop_, 0));
+  const CUdeviceptr chunk_ptr = dev_ptr + allocation.mapped_size;
+  const CUresult map_status = cuMemMap(chunk_ptr, chunk_size, 0ULL, handle, 0ULL);
+  if (map_status != CUDA_SUCCESS) {
+    cuMemRelease(handle);
+    HCTR_LIB_THROW(map_status);
+  }
+  allocation.handles.push_back(handle);
+  allocation.handle_sizes.push_back(chunk_size);
+  allocation.mapped_size = padded_size;
+  HCTR_LIB_THROW(cuMemSetAccess(chunk_ptr, chunk_size, access_descs_.data(), access_descs_.size()));
+}
+
+void VirtualCUDAAllocator::deallocate(void* ptr, CUDAStream) {
+  const CUdeviceptr dev_ptr = reinterpret_cast<CUdeviceptr>(ptr);
+  auto it = allocations_.find(dev_ptr);
+  HCTR_THROW_IF(dev_ptr == 0ULL || it == allocations_.end(), HugeCTR::Error_t::IllegalCall,
+                "`ptr` is nullptr or not allocated by this allocator");
+  release(dev_ptr, it->second);
+  allocations_.erase(it);
+}
+
+void VirtualCUDAAllocator::release(CUdeviceptr ptr, const Allocation& allocation) {
+  if (allocation.mapped_size > 0) {
+    HCTR_LIB_CHECK_(cuMemUnmap(ptr, allocation.mapped_size));
+  }
+  for (const auto handle : allocation.handles) {
+    HCTR_LIB_CHECK_(cuMemRelease(handle));
+  }
+  HCTR_LIB_CHECK_(cuMemAddressFree(ptr, reserve_size_));
+}
+
+int64_t VirtualCUDAAllocator::default_alignment() const { return granularity_; }
+
+int64_t VirtualCUDAAllocator::mapped_size(void* ptr) const {
+  auto it = allocations_.find(reinterpret_cast<CUdeviceptr>(ptr));
+  return it == allocations_.end() ? 0 : it->second.mapped_size;
+}
+
+}  // namespace core23
+
+}  // namespace HugeCTR
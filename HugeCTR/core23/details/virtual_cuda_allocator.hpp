@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda.h>
+
+#include <core23/allocator.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+class Device;
+
+/**
+ * Each allocation reserves a fixed range of virtual addresses, of which only the allocated size is
+ * backed by physical memory. grow() maps more physical memory at the end of the range, so that the
+ * allocation grows in place, without a copy, and pointers into it stay valid.
+ */
+class VirtualCUDAAllocator : public Allocator {
+ public:
+  /**
+   * @param reserve_size Virtual addresses reserved per allocation, which bound its size. 0
+   * reserves the memory of the device.
+   * @param peers Other devices that can access the memory.
+   */
+  VirtualCUDAAllocator(const Device& device, int64_t reserve_size = 0,
+                       const std::vector<int>& peers = {});
+  ~VirtualCUDAAllocator() override;
+
+  void* allocate(int64_t size, CUDAStream stream = CUDAStream()) override;
+
+  // Maps the allocation at ptr up to new_size bytes. It never shrinks.
+  void grow(void* ptr, int64_t new_size);
+
+  void deallocate(void* ptr, CUDAStream stream = CUDAStream()) override;
+
+  int64_t default_alignment() const override;
+
+  int64_t reserve_size() const { return reserve_size_; }
+  int64_t mapped_size(void* ptr) const;
+
+ private:
+  struct Allocation {
+    size_t mapped_size;
+    std::vector<CUmemGenericAllocationHandle> handles;
+    std::vector<size_t> handle_sizes;
+  };
+
+  size_t get_padded_size(size_t size) const {
+    return ((size + granularity_ - 1) / granularity_) * granularity_;
+  }
+  void release(CUdeviceptr ptr, const Allocation& allocation);
+
+  CUmemAllocationProp prop_;
+  std::vector<CUmemAccessDesc> access_descs_;
+  size_t granularity_;
+  size_t reserve_size_;
+  std::unordered_map<CUdeviceptr, Allocation> allocations_;
+};
+
+}  // namespace core23
+
+}  // namespace HugeCTR
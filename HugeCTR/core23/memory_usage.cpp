@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/memory_usage.hpp>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+namespace {
+
+thread_local std::string g_memory_tag;
+
+struct DeviceLess {
+  bool operator()(const Device& lhs, const Device& rhs) const {
+    return std::make_pair(lhs.type(), lhs.index()) < std::make_pair(rhs.type(), rhs.index());
+  }
+};
+
+struct TagLess {
+  bool operator()(const std::pair<Device, std::string>& lhs,
+                  const std::pair<Device, std::string>& rhs) const {
+    if (lhs.first != rhs.first) {
+      return DeviceLess()(lhs.first, rhs.first);
+    }
+    return lhs.second < rhs.second;
+  }
+};
+
+// The current and peak bytes of each tag, and of all tags of each device.
+struct MemoryUsageRegistry {
+  std::mutex mutex;
+  std::map<std::pair<Device, std::string>, std::pair<int64_t, int64_t>, TagLess> usage;
+  std::map<Device, std::pair<int64_t, int64_t>, DeviceLess> device_usage;
+};
+
+MemoryUsageRegistry& registry() {
+  // Never destroyed, as the Buffers which are destroyed during static destruction still record.
+  static MemoryUsageRegistry* registry = new MemoryUsageRegistry();
+  return *registry;
+}
+
+}  // namespace
+
+MemoryTagScope::MemoryTagScope(const std::string& tag) : outer_tag_(g_memory_tag) {
+  g_memory_tag = outer_tag_.empty() ? tag : outer_tag_ + "/" + tag;
+}
+
+MemoryTagScope::~MemoryTagScope() { g_memory_tag = outer_tag_; }
+
+std::string GetMemoryTag() { return g_memory_tag.empty() ? "untagged" : g_memory_tag; }
+
+void RecordMemoryUsage(const Device& device, const std::string& tag, const int64_t num_bytes) {
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto* bytes : {&r.usage[{device, tag}], &r.device_usage[device]}) {
+    bytes->first += num_bytes;
+    bytes->second = std::max(bytes->second, bytes->first);
+  }
+}
+
+std::vector<MemoryUsage> GetMemoryUsage() {
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  std::vector<MemoryUsage> usage;
+  for (const auto& [key, bytes] : r.usage) {
+    usage.push_back({key.first, key.second, bytes.first, bytes.second});
+  }
+  return usage;
+}
+
+void ResetPeakMemoryUsage() {
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto& [key, bytes] : r.usage) {
+    bytes.second = bytes.first;
+  }
+  for (auto& [device, bytes] : r.device_usage) {
+    bytes.second = bytes.first;
+  }
+}
+
+std::string GetMemoryUsageReport() {
+  constexpr double mib = 1024. * 1024.;
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(2);
+  os << std::left << std::setw(12) << "Device" << std::setw(48) << "Tag" << std::right
+     << std::setw(16) << "Current (MiB)" << std::setw(16) << "Peak (MiB)" << std::endl;
+  const auto print = [&os](const Device& device, const std::string& tag,
+                          const std::pair<int64_t, int64_t>& bytes) {
+    os << std::left << std::setw(12) << device << std::setw(48) << tag << std::right
+       << std::setw(16) << bytes.first / mib << std::setw(16) << bytes.second / mib << std::endl;
+  };
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (auto it = r.usage.begin(); it != r.usage.end(); ++it) {
+    const Device& device = it->first.first;
+    print(device, it->first.second, it->second);
+    if (std::next(it) == r.usage.end() || std::next(it)->first.first != device) {
+      // The peak of a device is that of the sum of its tags, rather than the sum of their peaks.
+      print(device, "total", r.device_usage[device]);
+    }
+  }
+  return os.str();
+}
+
+}  // namespace core23
+
+}  // namespace HugeCTR
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core23/device.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+// What the memory of a tag on a device is used for, e.g. "dense/fc1", and how much it is.
+struct MemoryUsage {
+  Device device;
+  std::string tag;
+  int64_t current_bytes;
+  int64_t peak_bytes;
+};
+
+/**
+ * Attributes the Tensors created by this thread while it is alive to a tag, unless their
+ * BufferParams have a tag of their own. A scope inside another one appends its tag to the outer
+ * tag after a '/', so that a subsystem can scope its construction and the layers within it.
+ */
+class MemoryTagScope {
+ public:
+  explicit MemoryTagScope(const std::string& tag);
+  ~MemoryTagScope();
+
+  MemoryTagScope(const MemoryTagScope&) = delete;
+  MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+ private:
+  std::string outer_tag_;
+};
+
+// Tag of the innermost MemoryTagScope of this thread, or "untagged" if there is none.
+std::string GetMemoryTag();
+
+// Adds num_bytes, which is negative for a deallocation, to the usage of tag on device.
+void RecordMemoryUsage(const Device& device, const std::string& tag, int64_t num_bytes);
+
+/**
+ * Usage of all tags that were ever recorded, ordered by device and tag. The bytes of a Tensor are
+ * counted while it is allocated, so the Tensors that share memory by their lifetimes are counted
+ * in full each.
+ */
+std::vector<MemoryUsage> GetMemoryUsage();
+
+// Sets the peak of each tag to its current usage.
+void ResetPeakMemoryUsage();
+
+// Table of GetMemoryUsage() in MiB, with the total of each device.
+std::string GetMemoryUsageReport();
+
+}  // namespace core23
+
+}  // namespace HugeCTR
@@ -35,6 +35,13 @@ void* OffsettedBuffer::data() const {
   return buffer_->data(offset_, {});
 }
 
+void OffsettedBuffer::set_lifetime(BufferClient* client, int64_t first_step,
+                                   int64_t last_step) const {
+  if (buffer_) {
+    buffer_->set_lifetime(client, first_step, last_step, {});
+  }
+}
+
 }  // namespace core23
 
 }  // namespace HugeCTR
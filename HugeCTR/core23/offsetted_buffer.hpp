@@ -24,6 +24,7 @@ namespace HugeCTR {
 namespace core23 {
 
 class Buffer;
+class BufferClient;
 
 class OffsettedBuffer final {
  private:
@@ -43,6 +44,7 @@ class OffsettedBuffer final {
   ~OffsettedBuffer();
 
   void* data() const;
+  void set_lifetime(BufferClient* client, int64_t first_step, int64_t last_step) const;
 
  private:
   std::shared_ptr<Buffer> buffer_;
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_runtime_api.h>
+#include <numa.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include <core23/details/pinned_host_allocator.hpp>
+#include <core23/logger.hpp>
+#include <core23/pinned_host_arena.hpp>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+PinnedHostBuffer& PinnedHostBuffer::operator=(PinnedHostBuffer&& other) noexcept {
+  if (this != &other) {
+    reset();
+    std::swap(arena_, other.arena_);
+    std::swap(consumer_, other.consumer_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(numa_node_, other.numa_node_);
+  }
+  return *this;
+}
+
+void PinnedHostBuffer::reset() {
+  if (arena_) {
+    arena_->release(consumer_, {data_, capacity_, numa_node_});
+    arena_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+  }
+}
+
+PinnedHostArena& PinnedHostArena::instance() {
+  // Never destroyed, as buffers may be returned during static destruction, after CUDA shut down.
+  static PinnedHostArena* arena = new PinnedHostArena();
+  return *arena;
+}
+
+PinnedHostArena::PinnedHostArena() : numa_(numa_available() >= 0) {}
+
+PinnedHostArena::~PinnedHostArena() { trim(); }
+
+void PinnedHostArena::set_quota(const std::string& consumer, const int64_t quota_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (quota_bytes < 0) {
+    quotas_.erase(consumer);
+  } else {
+    quotas_[consumer] = quota_bytes;
+  }
+}
+
+PinnedHostBuffer PinnedHostArena::acquire(const std::string& consumer, const int64_t size,
+                                          int numa_node) {
+  HCTR_THROW_IF(size <= 0, HugeCTR::Error_t::WrongInput, "Invalid pinned buffer size");
+  if (!numa_) {
+    numa_node = 0;
+  } else if (numa_node < 0) {
+    numa_node = numa_node_of_cpu(sched_getcpu());
+  }
+  const int64_t page_size = sysconf(_SC_PAGESIZE);
+  const int64_t capacity = (size + page_size - 1) / page_size * page_size;
+
+  Chunk chunk{nullptr, capacity, numa_node};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t& lent_bytes = lent_bytes_[consumer];
+    const auto quota = quotas_.find(consumer);
+    HCTR_THROW_IF(quota != quotas_.end() && lent_bytes + capacity > quota->second,
+                  HugeCTR::Error_t::OutOfMemory,
+                  "The pinned host buffers of " + consumer + " would exceed its quota of " +
+                      std::to_string(quota->second) + " bytes");
+
+    const auto it = free_chunks_.lower_bound({numa_node, capacity});
+    if (it != free_chunks_.end() && it->first.first == numa_node &&
+        it->first.second <= 2 * capacity) {
+      chunk.capacity = it->first.second;
+      chunk.data = it->second;
+      free_chunks_.erase(it);
+    }
+    lent_bytes += chunk.capacity;
+  }
+  if (!chunk.data) {
+    try {
+      chunk = pin(capacity, numa_node);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      lent_bytes_[consumer] -= capacity;
+      throw;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    pinned_bytes_ += capacity;
+  }
+
+  PinnedHostBuffer buffer;
+  buffer.arena_ = this;
+  buffer.consumer_ = consumer;
+  buffer.data_ = chunk.data;
+  buffer.size_ = size;
+  buffer.capacity_ = chunk.capacity;
+  buffer.numa_node_ = numa_node;
+  return buffer;
+}
+
+void PinnedHostArena::release(const std::string& consumer, const Chunk& chunk) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  lent_bytes_[consumer] -= chunk.capacity;
+  free_chunks_.emplace(std::make_pair(chunk.numa_node, chunk.capacity), chunk.data);
+}
+
+void PinnedHostArena::trim() {
+  std::multimap<std::pair<int, int64_t>, void*> free_chunks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_chunks.swap(free_chunks_);
+    for (const auto& [key, data] : free_chunks) {
+      pinned_bytes_ -= key.second;
+    }
+  }
+  for (const auto& [key, data] : free_chunks) {
+    unpin({data, key.second, key.first});
+  }
+}
+
+PinnedHostArena::Stats PinnedHostArena::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return {pinned_bytes_, lent_bytes_};
+}
+
+PinnedHostArena::Chunk PinnedHostArena::pin(const int64_t capacity, const int numa_node) const {
+  if (!numa_) {
+    return {PinnedHostAllocator().allocate(capacity, {}), capacity, numa_node};
+  }
+  void* data = numa_alloc_onnode(capacity, numa_node);
+  HCTR_THROW_IF(data == nullptr, HugeCTR::Error_t::OutOfMemory,
+                "Cannot allocate " + std::to_string(capacity) + " bytes on NUMA node " +
+                    std::to_string(numa_node));
+  const cudaError_t err = cudaHostRegister(data, capacity, cudaHostRegisterPortable);
+  if (err != cudaSuccess) {
+    numa_free(data, capacity);
+    HCTR_LIB_THROW(err);
+  }
+  return {data, capacity, numa_node};
+}
+
+void PinnedHostArena::unpin(const Chunk& chunk) const {
+  if (!numa_) {
+    PinnedHostAllocator().deallocate(chunk.data, {});
+    return;
+  }
+  HCTR_LIB_CHECK_(cudaHostUnregister(chunk.data));
+  numa_free(chunk.data, chunk.capacity);
+}
+
+}  // namespace core23
+
+}  // namespace HugeCTR
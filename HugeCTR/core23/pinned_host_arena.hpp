@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+class PinnedHostArena;
+
+/**
+ * Pinned host memory lent out by the PinnedHostArena. It is returned to the arena upon destruction,
+ * and stays pinned for the next buffer of a similar size.
+ */
+class PinnedHostBuffer {
+ public:
+  PinnedHostBuffer() = default;
+  PinnedHostBuffer(PinnedHostBuffer&& other) noexcept { *this = std::move(other); }
+  PinnedHostBuffer& operator=(PinnedHostBuffer&& other) noexcept;
+  PinnedHostBuffer(const PinnedHostBuffer&) = delete;
+  PinnedHostBuffer& operator=(const PinnedHostBuffer&) = delete;
+  ~PinnedHostBuffer() { reset(); }
+
+  void* data() const { return data_; }
+  int64_t size() const { return size_; }
+  int numa_node() const { return numa_node_; }
+
+  // Returns the memory to the arena.
+  void reset();
+
+ private:
+  friend class PinnedHostArena;
+
+  PinnedHostArena* arena_ = nullptr;
+  std::string consumer_;
+  void* data_ = nullptr;
+  int64_t size_ = 0;
+  int64_t capacity_ = 0;
+  int numa_node_ = 0;
+};
+
+/**
+ * Process-wide pool of pinned host memory, which is shared by the data readers and the embedding
+ * training cache. Memory is allocated on a NUMA node and registered with CUDA once. Returned
+ * buffers are lent out again to any consumer, without pinning them again. Each consumer can be
+ * limited to a quota of the bytes it holds at once.
+ */
+class PinnedHostArena {
+ public:
+  struct Stats {
+    int64_t pinned_bytes;                       // Pinned memory, lent out or not
+    std::map<std::string, int64_t> lent_bytes;  // By consumer
+  };
+
+  static PinnedHostArena& instance();
+
+  // Limits the bytes that the consumer may hold at once. A negative quota means no limit.
+  void set_quota(const std::string& consumer, int64_t quota_bytes);
+
+  // Lends a buffer of size bytes on numa_node, or on the node of the calling thread if negative.
+  // Reuses a returned buffer of up to twice the size, or pins new memory. Buffers are page-aligned.
+  PinnedHostBuffer acquire(const std::string& consumer, int64_t size, int numa_node = -1);
+
+  // Unpins and frees the memory that is not lent out.
+  void trim();
+
+  Stats stats() const;
+
+ private:
+  struct Chunk {
+    void* data;
+    int64_t capacity;
+    int numa_node;
+  };
+
+  PinnedHostArena();
+  ~PinnedHostArena();
+
+  void release(const std::string& consumer, const Chunk& chunk);
+  Chunk pin(int64_t capacity, int numa_node) const;
+  void unpin(const Chunk& chunk) const;
+
+  friend class PinnedHostBuffer;
+
+  mutable std::mutex mutex_;
+  bool numa_;
+  int64_t pinned_bytes_ = 0;
+  std::multimap<std::pair<int, int64_t>, void*> free_chunks_;  // By NUMA node and capacity
+  std::map<std::string, int64_t> quotas_;
+  std::map<std::string, int64_t> lent_bytes_;
+};
+
+}  // namespace core23
+
+}  // namespace HugeCTR
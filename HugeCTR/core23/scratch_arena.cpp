@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/device.hpp>
+#include <core23/device_guard.hpp>
+#include <core23/logger.hpp>
+#include <core23/memory_usage.hpp>
+#include <core23/scratch_arena.hpp>
+#include <map>
+#include <mutex>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+namespace {
+
+constexpr int64_t scratch_alignment = 256;
+
+int64_t align_scratch(const int64_t size) {
+  return (size + scratch_alignment - 1) / scratch_alignment * scratch_alignment;
+}
+
+bool is_capturing(cudaStream_t stream) {
+  cudaStreamCaptureStatus status;
+  HCTR_LIB_THROW(cudaStreamIsCapturing(stream, &status));
+  return status != cudaStreamCaptureStatusNone;
+}
+
+struct ScratchArenaRegistry {
+  std::mutex mutex;
+  std::map<std::pair<int, cudaStream_t>, ScratchArena*> arenas;
+};
+
+ScratchArenaRegistry& registry() {
+  // Never destroyed, as the buffers cannot be freed during static destruction, after CUDA shut
+  // down.
+  static ScratchArenaRegistry* registry = new ScratchArenaRegistry();
+  return *registry;
+}
+
+}  // namespace
+
+ScratchArena::Scope::Scope(ScratchArena& arena)
+    : arena_(arena), offset_(arena.offset_), num_overflows_(arena.overflows_.size()) {
+  ++arena_.num_scopes_;
+}
+
+ScratchArena::Scope::~Scope() {
+  arena_.release(offset_, num_overflows_);
+  --arena_.num_scopes_;
+}
+
+ScratchArena& ScratchArena::get(const int device_id, cudaStream_t stream) {
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  ScratchArena*& arena = r.arenas[{device_id, stream}];
+  if (!arena) {
+    arena = new ScratchArena(device_id, stream);
+  }
+  return *arena;
+}
+
+void ScratchArena::reset_all() {
+  auto& r = registry();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  for (const auto& [key, arena] : r.arenas) {
+    arena->reset();
+  }
+}
+
+ScratchArena::ScratchArena(const int device_id, cudaStream_t stream)
+    : device_id_(device_id), stream_(stream) {}
+
+void* ScratchArena::allocate(const int64_t size) {
+  HCTR_THROW_IF(size < 0, HugeCTR::Error_t::WrongInput, "Invalid scratch size");
+  const int64_t aligned_size = align_scratch(std::max<int64_t>(size, 1));
+  void* ptr = nullptr;
+  if (offset_ + aligned_size <= capacity_) {
+    ptr = static_cast<char*>(buffer_) + offset_;
+    offset_ += aligned_size;
+    captured_ = captured_ || is_capturing(stream_);
+  } else {
+    // Captured into a CUDA graph as an allocation node, if the stream is capturing.
+    DeviceGuard guard(Device(DeviceType::GPU, device_id_));
+    HCTR_LIB_THROW(cudaMallocAsync(&ptr, aligned_size, stream_));
+    overflows_.emplace_back(ptr, aligned_size);
+    overflow_bytes_ += aligned_size;
+  }
+  high_water_mark_ = std::max(high_water_mark_, offset_ + overflow_bytes_);
+  return ptr;
+}
+
+void ScratchArena::release(const int64_t offset, const size_t num_overflows) {
+  DeviceGuard guard(Device(DeviceType::GPU, device_id_));
+  while (overflows_.size() > num_overflows) {
+    HCTR_LIB_CHECK_(cudaFreeAsync(overflows_.back().first, stream_));
+    overflow_bytes_ -= overflows_.back().second;
+    overflows_.pop_back();
+  }
+  offset_ = offset;
+}
+
+void ScratchArena::reset() {
+  HCTR_THROW_IF(num_scopes_ > 0, HugeCTR::Error_t::IllegalCall,
+                "A scratch arena cannot be reset while its memory is in use");
+  release(0, 0);
+  if (high_water_mark_ > capacity_ && !captured_) {
+    DeviceGuard guard(Device(DeviceType::GPU, device_id_));
+    if (buffer_) {
+      HCTR_LIB_THROW(cudaFreeAsync(buffer_, stream_));
+    }
+    HCTR_LIB_THROW(cudaMallocAsync(&buffer_, high_water_mark_, stream_));
+    RecordMemoryUsage(Device(DeviceType::GPU, device_id_), "scratch_arena",
+                      high_water_mark_ - capacity_);
+    capacity_ = high_water_mark_;
+  }
+  high_water_mark_ = 0;
+}
+
+}  // namespace core23
+
+}  // namespace HugeCTR
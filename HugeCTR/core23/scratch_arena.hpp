@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime_api.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace core23 {
+
+/**
+ * Stream-ordered scratch memory of the temporaries of the operators on a stream, like the temp
+ * storage of cub. Allocations bump an offset into one device buffer, and are released in the order
+ * of the stream, so that operators that run one after another reuse the same memory. A request
+ * that doesn't fit is served by cudaMallocAsync, and the buffer grows to the high-water mark when
+ * the arena is reset at the start of the next iteration. The peak memory is the scratch space that
+ * is in use at once, rather than the sum of the worst cases of the operators.
+ *
+ * An arena is used by the thread which enqueues the work of its stream. Buffers which are used
+ * by a captured CUDA graph are never reallocated.
+ */
+class ScratchArena {
+ public:
+  /**
+   * Releases the memory that is allocated while it is alive, once the work that the stream holds
+   * at its destruction is done. Scopes of an arena must be nested.
+   */
+  class Scope {
+   public:
+    explicit Scope(ScratchArena& arena);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    void* allocate(int64_t size) { return arena_.allocate(size); }
+
+   private:
+    ScratchArena& arena_;
+    int64_t offset_;
+    size_t num_overflows_;
+  };
+
+  // Arena of stream on device_id, which is created on first use and never destroyed.
+  static ScratchArena& get(int device_id, cudaStream_t stream);
+
+  // Resets the arenas of all streams. Must not be called while a Scope is alive.
+  static void reset_all();
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  // Memory that the work enqueued on the stream can use until it is released. 256-byte aligned.
+  void* allocate(int64_t size);
+
+  // Releases all memory, and grows the buffer to the high-water mark since the last reset.
+  void reset();
+
+  int64_t capacity() const { return capacity_; }
+  int64_t high_water_mark() const { return high_water_mark_; }
+
+ private:
+  ScratchArena(int device_id, cudaStream_t stream);
+
+  void release(int64_t offset, size_t num_overflows);
+
+  int device_id_;
+  cudaStream_t stream_;
+  void* buffer_ = nullptr;
+  int64_t capacity_ = 0;
+  int64_t offset_ = 0;
+  std::vector<std::pair<void*, int64_t>> overflows_;
+  int64_t overflow_bytes_ = 0;
+  int64_t high_water_mark_ = 0;
+  bool captured_ = false;  // buffer_ is used by a CUDA graph
+  int num_scopes_ = 0;
+};
+
+}  // namespace core23
+
+}  // namespace HugeCTR
@@ -64,6 +64,12 @@ bool Tensor::is_unique() const { return own_data() && impl_.use_count() == 1; }
 
 bool Tensor::own_data() const { return impl_ && impl_->own_data(); }
 
+void Tensor::set_lifetime(int64_t first_step, int64_t last_step) const {
+  if (impl_) {
+    impl_->set_lifetime(first_step, last_step);
+  }
+}
+
 Tensor::Tensor(const std::shared_ptr<TensorImpl>& impl)
     : impl_(impl), shape_or_(impl->shape()), data_(nullptr) {}
 
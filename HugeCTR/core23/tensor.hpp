@@ -75,6 +75,13 @@ class Tensor {
   bool is_unique() const;
   bool own_data() const;
 
+  /**
+   * Declares that the tensor is used from first_step to last_step, before it is allocated. The
+   * tensors of a buffer whose lifetimes are disjoint can share the memory. Calling it again
+   * extends the lifetime.
+   */
+  void set_lifetime(int64_t first_step, int64_t last_step) const;
+
   template <typename BuiltInType, int64_t Dims>
   TensorView<BuiltInType, Dims> view() const {
     return view<BuiltInType, Dims>(Shape(Dims));
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <core23/scratch_arena.hpp>
 #include <cub/cub.cuh>
 #include <embedding/all2all_embedding_collection.hpp>
 #include <embedding/data_distributor/data_distributor.hpp>
@@ -258,14 +259,11 @@ void weighted_sparse_forward_per_gpu(
             size_t temp_bytes = 0;
             cub::DeviceScan::InclusiveSum(nullptr, temp_bytes, (offset_t *)nullptr,
                                           (offset_t *)nullptr, bucket_range.num_elements());
-            core23::Tensor temp_scan_storage =
-                core23::Tensor(core23::TensorParams()
-                                   .shape({static_cast<int64_t>(temp_bytes)})
-                                   .device(device)
-                                   .data_type(core23::ScalarType::Char));
+            core23::ScratchArena::Scope scratch(
+                core23::ScratchArena::get(device.index(), stream));
 
             cub::DeviceScan::InclusiveSum(
-                temp_scan_storage.data(), temp_bytes, bucket_range.data<offset_t>(),
+                scratch.allocate(temp_bytes), temp_bytes, bucket_range.data<offset_t>(),
                 bucket_range.data<offset_t>(), bucket_range.num_elements(), stream);
           });
     };
@@ -274,17 +272,13 @@ void weighted_sparse_forward_per_gpu(
       DISPATCH_INTEGRAL_FUNCTION_CORE23(
           row_lengths_all_gather_recv_buffer.data_type().type(), offset_t, [&] {
             size_t temp_bytes = 0;
-            core23::Tensor temp_scan_storage;
             cub::DeviceScan::InclusiveSum(nullptr, temp_bytes, (offset_t *)nullptr,
                                           (offset_t *)nullptr,
                                           row_lengths_all_gather_recv_buffer.num_elements() + 1);
+            core23::ScratchArena::Scope scratch(
+                core23::ScratchArena::get(device.index(), stream));
 
-            temp_scan_storage = core23::Tensor(core23::TensorParams()
-                                                   .shape({static_cast<int64_t>(temp_bytes)})
-                                                   .device(device)
-                                                   .data_type(core23::ScalarType::Char));
-
-            cub::DeviceScan::InclusiveSum(temp_scan_storage.data(), temp_bytes,
+            cub::DeviceScan::InclusiveSum(scratch.allocate(temp_bytes), temp_bytes,
                                           row_lengths_all_gather_recv_buffer.data<offset_t>(),
                                           all_gather_row_offsets.data<offset_t>() + 1,
                                           row_lengths_all_gather_recv_buffer.num_elements(),
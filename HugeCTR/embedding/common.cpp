@@ -16,8 +16,10 @@
 
 #include <cuda_runtime.h>
 
+#include <algorithm>
 #include <core/hctr_impl/hctr_backend.hpp>
 #include <embedding/common.hpp>
+#include <numeric>
 #include <utils.hpp>
 
 namespace HugeCTR {
@@ -102,6 +104,35 @@ std::ostream &operator<<(std::ostream &os, const CommunicationStrategy &p) {
   return os;
 }
 
+std::ostream &operator<<(std::ostream &os, const CommQuantizationStrategy &p) {
+  switch (p) {
+    case CommQuantizationStrategy::Disabled:
+      os << "Disabled";
+      break;
+    case CommQuantizationStrategy::FP8:
+      os << "FP8";
+      break;
+    default:
+      HCTR_OWN_THROW(HugeCTR::Error_t::NotInitialized,
+                     "CommQuantizationStrategy is not initialized");
+  }
+  return os;
+}
+
+std::ostream &operator<<(std::ostream &os, const TableStorageType &p) {
+  switch (p) {
+    case TableStorageType::FP32:
+      os << "FP32";
+      break;
+    case TableStorageType::FP16:
+      os << "FP16";
+      break;
+    default:
+      HCTR_OWN_THROW(HugeCTR::Error_t::NotInitialized, "TableStorageType is not initialized");
+  }
+  return os;
+}
+
 std::ostream &operator<<(std::ostream &os, const SortStrategy &p) {
   switch (p) {
     case SortStrategy::Radix:
@@ -110,6 +141,9 @@ std::ostream &operator<<(std::ostream &os, const SortStrategy &p) {
     case SortStrategy::Segmented:
       os << "Segmented";
       break;
+    case SortStrategy::Hash:
+      os << "Hash";
+      break;
     default:
       HCTR_OWN_THROW(HugeCTR::Error_t::NotInitialized, "SortStrategy is not initialized");
   }
@@ -156,6 +190,132 @@ std::ostream &operator<<(std::ostream &os, const LookupParam &p) {
   return os;
 }
 
+void EmbeddingCollectionParam::init_sparse_frequent_keys(const SparseFrequentKeysData &data) {
+  HCTR_CHECK_HINT(data.table_ids.size() == data.h_frequent_keys.size(),
+                  "frequent keys are required for each table.");
+  HCTR_CHECK_HINT(allreduce_strategy_ != AllreduceStrategy::GroupDense,
+                  "frequent keys of model parallel tables do not support grouped all-reduce.");
+
+  std::vector<size_t> order(data.table_ids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return data.table_ids[a] < data.table_ids[b]; });
+
+  sparse_freq_keys_data = SparseFrequentKeysData{};
+  for (size_t i : order) {
+    int table_id = data.table_ids[i];
+    HCTR_CHECK_HINT(table_id >= 0 && table_id < num_table, "table_id ", table_id,
+                    " of the frequent keys is out of range.");
+    HCTR_CHECK_HINT(sparse_freq_keys_data.table_ids.empty() ||
+                        sparse_freq_keys_data.table_ids.back() != table_id,
+                    "frequent keys of table ", table_id, " are given more than once.");
+    bool is_model_parallel = false;
+    for (const auto &table_param : grouped_table_params) {
+      if (std::find(table_param.table_ids.begin(), table_param.table_ids.end(), table_id) ==
+          table_param.table_ids.end())
+        continue;
+      is_model_parallel =
+          table_param.table_placement_strategy == TablePlacementStrategy::ModelParallel;
+    }
+    HCTR_CHECK_HINT(is_model_parallel, "frequent keys require a model parallel table, table ",
+                    table_id);
+    for (const auto &group_param : grouped_lookup_params) {
+      if (group_param.embedding_type == EmbeddingType::FrequentSparse) continue;
+      for (int lookup_id : group_param.lookup_ids) {
+        HCTR_CHECK_HINT(lookup_params[lookup_id].table_id != table_id ||
+                            group_param.embedding_type == EmbeddingType::Sparse,
+                        "frequent keys require a sparse embedding, table ", table_id);
+      }
+    }
+    HCTR_CHECK_HINT(!is_column_wise_table(table_id),
+                    "frequent keys do not support column-wise sharding, table ", table_id);
+    for (const auto &lookup_param : lookup_params) {
+      if (lookup_param.table_id != table_id) continue;
+      HCTR_CHECK_HINT(lookup_param.combiner != Combiner::Concat,
+                      "frequent keys do not support concat combiner, table ", table_id);
+    }
+
+    std::vector<int64_t> keys = data.h_frequent_keys[i];
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    if (keys.empty()) continue;
+    sparse_freq_keys_data.table_ids.push_back(table_id);
+    sparse_freq_keys_data.h_frequent_keys.push_back(std::move(keys));
+  }
+
+  grouped_lookup_params.erase(
+      std::remove_if(grouped_lookup_params.begin(), grouped_lookup_params.end(),
+                     [](const GroupedLookupParam &p) {
+                       return p.embedding_type == EmbeddingType::FrequentSparse;
+                     }),
+      grouped_lookup_params.end());
+
+  std::vector<int> frequent_lookup_ids;
+  for (int lookup_id = 0; lookup_id < num_lookup; ++lookup_id) {
+    if (get_frequent_table_index(lookup_params[lookup_id].table_id) >= 0) {
+      frequent_lookup_ids.push_back(lookup_id);
+    }
+  }
+  if (frequent_lookup_ids.empty()) return;
+  grouped_lookup_params.emplace_back(-1, TablePlacementStrategy::DataParallel, frequent_lookup_ids,
+                                     EmbeddingType::FrequentSparse);
+}
+
+void EmbeddingCollectionParam::init_unique_pooled_keys(const std::vector<int> &table_ids) {
+  auto is_unique_table = [&](int table_id) {
+    return std::find(table_ids.begin(), table_ids.end(), table_id) != table_ids.end();
+  };
+  for (int table_id : table_ids) {
+    HCTR_CHECK_HINT(table_id >= 0 && table_id < num_table, "table_id ", table_id,
+                    " of the unique keys is out of range.");
+    HCTR_CHECK_HINT(!is_column_wise_table(table_id),
+                    "unique keys do not support column-wise sharding, table ", table_id);
+    HCTR_CHECK_HINT(get_frequent_table_index(table_id) < 0,
+                    "unique keys do not support frequent keys, table ", table_id);
+  }
+
+  std::vector<GroupedLookupParam> dense_lookup_params;
+  for (auto &group_param : grouped_lookup_params) {
+    if (group_param.embedding_type != EmbeddingType::Sparse ||
+        group_param.table_placement_strategy != TablePlacementStrategy::ModelParallel)
+      continue;
+
+    std::vector<int> sparse_lookup_ids;
+    // Dense groups require the same ev_size, and either concat or pooled lookups.
+    std::vector<std::vector<int>> dense_lookup_ids;
+    for (int lookup_id : group_param.lookup_ids) {
+      if (!is_unique_table(lookup_params[lookup_id].table_id)) {
+        sparse_lookup_ids.push_back(lookup_id);
+        continue;
+      }
+      const auto &lookup_param = lookup_params[lookup_id];
+      auto it = std::find_if(
+          dense_lookup_ids.begin(), dense_lookup_ids.end(), [&](const std::vector<int> &ids) {
+            return lookup_params[ids[0]].ev_size == lookup_param.ev_size &&
+                   (lookup_params[ids[0]].combiner == Combiner::Concat) ==
+                       (lookup_param.combiner == Combiner::Concat);
+          });
+      if (it == dense_lookup_ids.end()) {
+        dense_lookup_ids.push_back({lookup_id});
+      } else {
+        it->push_back(lookup_id);
+      }
+    }
+    group_param.lookup_ids = sparse_lookup_ids;
+    for (const auto &ids : dense_lookup_ids) {
+      dense_lookup_params.emplace_back(group_param.grouped_table_idx,
+                                       TablePlacementStrategy::ModelParallel, ids,
+                                       EmbeddingType::Dense);
+    }
+  }
+  grouped_lookup_params.erase(
+      std::remove_if(grouped_lookup_params.begin(), grouped_lookup_params.end(),
+                     [](const GroupedLookupParam &p) { return p.lookup_ids.empty(); }),
+      grouped_lookup_params.end());
+  grouped_lookup_params.insert(grouped_lookup_params.end(), dense_lookup_params.begin(),
+                               dense_lookup_params.end());
+}
+
 void EmbeddingOutputAttr::init(std::shared_ptr<CoreResourceManager> core,
                                const EmbeddingCollectionParam &ebc_param) {
   this->num_lookup = ebc_param.num_lookup;
@@ -289,7 +449,7 @@ std::vector<int> get_table_id_to_ev_size(std::shared_ptr<CoreResourceManager> co
   h_table_id_to_ev_size.resize(ebc_param.num_table);
   for (int lookup_id = 0; lookup_id < ebc_param.num_lookup; ++lookup_id) {
     int table_id = lookup_params[lookup_id].table_id;
-    h_table_id_to_ev_size[table_id] = lookup_params[lookup_id].ev_size;
+    h_table_id_to_ev_size[table_id] = ebc_param.get_local_ev_size(lookup_id);
   }
   return h_table_id_to_ev_size;
 }
@@ -377,13 +537,11 @@ std::vector<int> get_wgrad_max_num_keys(const EmbeddingCollectionParam &ebc_para
 
 std::vector<int> get_wgrad_ev_size(const EmbeddingCollectionParam &ebc_param, size_t grouped_id,
                                    int gpu_id) {
-  const auto &lookup_params = ebc_param.lookup_params;
   std::vector<int> local_ev_size_list;
   for (int lookup_id = 0; lookup_id < ebc_param.num_lookup; ++lookup_id) {
     if (!ebc_param.has_table_shard(gpu_id, grouped_id, lookup_id)) continue;
 
-    int ev_size = lookup_params[lookup_id].ev_size;
-    local_ev_size_list.push_back(ev_size);
+    local_ev_size_list.push_back(ebc_param.get_local_ev_size(lookup_id));
   }
   return local_ev_size_list;
 }
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <core/core.hpp>
 #include <core23/low_level_primitives.hpp>
 #include <core23/registry.hpp>
@@ -22,6 +23,7 @@
 #include <core23/tensor_operations.hpp>
 #include <core23/tensor_params.hpp>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -134,13 +136,23 @@ enum class EmbeddingLayout : int8_t { FeatureMajor, BatchMajor };
 std::ostream &operator<<(std::ostream &os, const EmbeddingLayout &p);
 enum class CommunicationStrategy : int8_t { Uniform, Hierarchical };
 std::ostream &operator<<(std::ostream &os, const CommunicationStrategy &p);
-enum class SortStrategy : int8_t { Radix, Segmented };
+// Precision of the all-to-all payloads of the sparse model parallel lookups. FP8 sends E4M3
+// values with an FP32 scale per embedding vector.
+enum class CommQuantizationStrategy : int8_t { Disabled, FP8 };
+std::ostream &operator<<(std::ostream &os, const CommQuantizationStrategy &p);
+// Precision of the weights of the static embedding tables. FP16 weights are updated with
+// stochastic rounding, without FP32 master weights.
+enum class TableStorageType : int8_t { FP32, FP16 };
+std::ostream &operator<<(std::ostream &os, const TableStorageType &p);
+enum class SortStrategy : int8_t { Radix, Segmented, Hash };
 std::ostream &operator<<(std::ostream &os, const SortStrategy &p);
 enum class KeysPreprocessStrategy : int8_t { None, AddOffset };
 std::ostream &operator<<(std::ostream &os, const KeysPreprocessStrategy &p);
 enum class AllreduceStrategy : int8_t { Sparse, Dense, GroupDense };
 std::ostream &operator<<(std::ostream &os, const AllreduceStrategy &p);
-enum class EmbeddingType : int8_t { Sparse, Dense, FrequentDense, InfrequentDense };
+// FrequentSparse lookups hold the frequent keys of the sum and average lookups of model parallel
+// tables, whose rows are replicated on all gpus.
+enum class EmbeddingType : int8_t { Sparse, Dense, FrequentDense, InfrequentDense, FrequentSparse };
 enum class DenseCompressionStrategy : int8_t { Unique, CacheFrequent };
 
 struct LookupParam {
@@ -159,13 +171,34 @@ struct LookupParam {
 };
 std::ostream &operator<<(std::ostream &os, const LookupParam &p);
 
+enum class FeatureHashFunction : int8_t { Murmur, XXHash };
+
+// A lookup whose keys are computed on the gpus from the input features of the data reader: the
+// hash of the keys of one input feature, or the cross of two, which hashes each pair of their keys
+// in a sample. The hashes are taken modulo num_buckets, unless it is 0.
+struct VirtualFeatureParam {
+  int lookup_id;
+  std::vector<int> input_feature_ids;
+  std::vector<int> input_hotness;  // of each input feature, their keys have a fixed hotness
+  FeatureHashFunction hash_function;
+  uint64_t num_buckets;
+  uint64_t seed;
+};
+
 struct GroupedTableParam {
   TablePlacementStrategy table_placement_strategy;
   std::vector<int> table_ids;
+  // -1 if the model parallel tables are split row-wise over the GPUs of the shard matrix.
+  // Otherwise, the tables are split column-wise over these GPUs, and this group holds the
+  // column_shard_id-th slice of the embedding vectors of each table, on the
+  // column_shard_id-th of its GPUs.
+  int column_shard_id;
 
   GroupedTableParam(TablePlacementStrategy _table_placement_strategy,
-                    const std::vector<int> &_table_ids)
-      : table_placement_strategy(_table_placement_strategy), table_ids(_table_ids) {}
+                    const std::vector<int> &_table_ids, int _column_shard_id = -1)
+      : table_placement_strategy(_table_placement_strategy),
+        table_ids(_table_ids),
+        column_shard_id(_column_shard_id) {}
 };
 
 struct GroupedLookupParam {
@@ -187,6 +220,13 @@ struct DenseFrequentKeysData {
   std::vector<core23::Tensor> h_frequent_keys;
 };
 
+// Frequent keys of model parallel tables. They are looked up in replicas of their rows on each gpu,
+// which are updated with an all-reduce, and only the other keys are sent to the table shards.
+struct SparseFrequentKeysData {
+  std::vector<int> table_ids;                         // ascending
+  std::vector<std::vector<int64_t>> h_frequent_keys;  // sorted and unique keys of each table
+};
+
 struct EmbeddingCollectionParam {
   int num_table;
 
@@ -213,7 +253,32 @@ struct EmbeddingCollectionParam {
   CommunicationStrategy comm_strategy_;
 
   DenseCompressionStrategy dense_compression_strategy_ = DenseCompressionStrategy::Unique;
+  CommQuantizationStrategy comm_quantization_strategy_ = CommQuantizationStrategy::Disabled;
+  TableStorageType table_storage_type_ = TableStorageType::FP32;
+  // Single node only. The sparse model parallel lookups store their all-to-all payloads directly
+  // into the buffers of the peer GPUs over NVLink instead of using NCCL.
+  bool use_p2p_all2all_ = false;
+  // Tables whose gradients are reduced in a fixed order, so that their training is bitwise
+  // reproducible. Sorted.
+  std::vector<int> deterministic_table_ids_;
+  // Number of streams that the grouped lookups compute on concurrently, 1 if they run one after
+  // the other on the current stream.
+  int num_lookup_streams_ = 1;
+  // Stream priority of each table, lower is higher as in CUDA. Other tables have priority 0.
+  std::map<int, int> table_id_to_stream_priority_;
+  // Unique keys of the tables with a static vocabulary, by table id. The row of a key is its
+  // position. Shared by the copies of the param, since vocabularies can be large.
+  std::map<int, std::shared_ptr<const std::vector<int64_t>>> static_vocabularies_;
+  // Input feature of the data reader of each lookup, -1 for the virtual features. Empty if there
+  // are no virtual features, then each lookup reads the input feature of its index.
+  int num_input_features_ = 0;
+  std::vector<int> lookup_input_feature_ids_;
+  std::vector<VirtualFeatureParam> virtual_features_;
+  // The data reader returns 64-bit keys and bucket ranges, which are converted to the 32-bit key
+  // and offset types of the collection before the data distribution.
+  bool narrow_input_keys_ = false;
   DenseFrequentKeysData dense_freq_keys_data;
+  SparseFrequentKeysData sparse_freq_keys_data;
 
   EmbeddingCollectionParam(
       int num_table, int num_lookup, const std::vector<LookupParam> &lookup_params,
@@ -289,6 +354,29 @@ struct EmbeddingCollectionParam {
         }
       }
     }
+    check_column_wise_tables();
+  }
+
+  void check_column_wise_tables() const {
+    for (const auto &table_param : grouped_table_params) {
+      if (table_param.column_shard_id < 0) continue;
+      HCTR_CHECK_HINT(table_param.table_placement_strategy == TablePlacementStrategy::ModelParallel,
+                      "column-wise sharding requires model parallel tables.");
+      for (int table_id : table_param.table_ids) {
+        int num_column_shards = get_num_column_shards(table_id);
+        HCTR_CHECK_HINT(table_param.column_shard_id < num_column_shards, "table ", table_id,
+                        " has only ", num_column_shards, " column shards in the shard matrix.");
+        for (const auto &lookup_param : lookup_params) {
+          if (lookup_param.table_id != table_id) continue;
+          HCTR_CHECK_HINT(lookup_param.combiner != Combiner::Concat,
+                          "column-wise sharding does not support concat combiner, table ",
+                          table_id);
+          HCTR_CHECK_HINT(lookup_param.ev_size % num_column_shards == 0, "ev_size of table ",
+                          table_id, " is not divisible by its ", num_column_shards,
+                          " column shards.");
+        }
+      }
+    }
   }
 
   bool lookup_id_in_group(size_t grouped_id, int lookup_id) const {
@@ -297,13 +385,82 @@ struct EmbeddingCollectionParam {
            group_param.lookup_ids.end();
   }
 
+  bool is_column_wise_table(int table_id) const {
+    for (const auto &table_param : grouped_table_params) {
+      if (table_param.column_shard_id >= 0 &&
+          std::find(table_param.table_ids.begin(), table_param.table_ids.end(), table_id) !=
+              table_param.table_ids.end()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Number of slices of the embedding vectors of a table, 1 if it is not split column-wise.
+  int get_num_column_shards(int table_id) const {
+    if (!is_column_wise_table(table_id)) return 1;
+    int num_column_shards = 0;
+    for (const auto &gpu_shards : shard_matrix) {
+      num_column_shards += gpu_shards[table_id];
+    }
+    return num_column_shards;
+  }
+
+  bool has_grouped_table_shard(int gpu_id, size_t grouped_table_id, int table_id) const {
+    if (this->shard_matrix[gpu_id][table_id] == 0) return false;
+    int column_shard_id = this->grouped_table_params[grouped_table_id].column_shard_id;
+    if (column_shard_id < 0) return true;
+
+    int column_shard_gpu_id = -1;
+    for (int ggpu_id = 0, shard_id = 0; ggpu_id < static_cast<int>(shard_matrix.size());
+         ++ggpu_id) {
+      if (this->shard_matrix[ggpu_id][table_id] == 0) continue;
+      if (shard_id++ == column_shard_id) {
+        column_shard_gpu_id = ggpu_id;
+        break;
+      }
+    }
+    return column_shard_gpu_id == gpu_id;
+  }
+
   bool has_table_shard(int gpu_id, size_t grouped_id, int lookup_id) const {
     int table_id = this->lookup_params[lookup_id].table_id;
-    bool has_portion = (this->shard_matrix[gpu_id][table_id] != 0);
+    int grouped_table_id = this->grouped_lookup_params[grouped_id].grouped_table_idx;
+    bool has_portion = false;
+    if (grouped_table_id >= 0) {
+      has_portion = has_grouped_table_shard(gpu_id, grouped_table_id, table_id);
+    } else if (this->grouped_lookup_params[grouped_id].embedding_type ==
+               EmbeddingType::FrequentSparse) {
+      has_portion = get_frequent_table_index(table_id) >= 0;
+    } else {
+      has_portion = this->shard_matrix[gpu_id][table_id] != 0;
+    }
     return this->lookup_id_in_group(grouped_id, lookup_id) && has_portion;
   }
 
+  // Size of the embedding vectors that a GPU looks up for a lookup, and their offset in the output
+  // of the lookup, for the GPUs of a grouped lookup.
+  int get_local_ev_size(int lookup_id) const {
+    int table_id = this->lookup_params[lookup_id].table_id;
+    return this->lookup_params[lookup_id].ev_size / get_num_column_shards(table_id);
+  }
+
+  int get_local_ev_offset(size_t grouped_id, int lookup_id) const {
+    int grouped_table_id = this->grouped_lookup_params[grouped_id].grouped_table_idx;
+    if (grouped_table_id < 0) return 0;
+    int column_shard_id = this->grouped_table_params[grouped_table_id].column_shard_id;
+    return column_shard_id < 0 ? 0 : column_shard_id * get_local_ev_size(lookup_id);
+  }
+
+  // Row shard of a table on a GPU. Each column shard holds all rows of its table.
   void get_table_shard_id(int gpu_id, int table_id, int *shard_id, int *num_shard) const {
+    if (is_column_wise_table(table_id)) {
+      HCTR_CHECK_HINT(this->shard_matrix[gpu_id][table_id] == 1,
+                      "get_table_shard_id does not find shard id");
+      *shard_id = 0;
+      *num_shard = 1;
+      return;
+    }
     size_t num_gpus = shard_matrix.size();
 
     std::vector<int> shard_gpus;
@@ -320,6 +477,56 @@ struct EmbeddingCollectionParam {
   }
 
   void init_dense_frequent_keys(const DenseFrequentKeysData &data) { dense_freq_keys_data = data; }
+
+  // Index of a table in sparse_freq_keys_data, -1 if it has no frequent keys.
+  int get_frequent_table_index(int table_id) const {
+    const auto &table_ids = sparse_freq_keys_data.table_ids;
+    auto it = std::lower_bound(table_ids.begin(), table_ids.end(), table_id);
+    return (it != table_ids.end() && *it == table_id) ? std::distance(table_ids.begin(), it) : -1;
+  }
+
+  // Replicates the rows of the frequent keys of model parallel tables, and adds a FrequentSparse
+  // data parallel lookup of these keys for all lookups of the tables.
+  void init_sparse_frequent_keys(const SparseFrequentKeysData &data);
+
+  // Moves the sum and average lookups of model parallel tables into Dense groups, whose keys are
+  // unique per destination GPU and table before the all-to-all. Their pooling is done after the
+  // unique rows are sent back.
+  void init_unique_pooled_keys(const std::vector<int> &table_ids);
+
+  void init_deterministic_tables(const std::vector<int> &table_ids) {
+    deterministic_table_ids_ = table_ids;
+    std::sort(deterministic_table_ids_.begin(), deterministic_table_ids_.end());
+  }
+
+  // Whether a grouped lookup reduces its gradients in a fixed order, because it looks up a
+  // deterministic table. All tables of a group share the same reduction.
+  bool is_deterministic(size_t grouped_id) const {
+    for (int lookup_id : this->grouped_lookup_params[grouped_id].lookup_ids) {
+      if (std::binary_search(deterministic_table_ids_.begin(), deterministic_table_ids_.end(),
+                             this->lookup_params[lookup_id].table_id)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void init_lookup_streams(int num_streams, const std::map<int, int> &table_id_to_priority) {
+    num_lookup_streams_ = num_streams;
+    table_id_to_stream_priority_ = table_id_to_priority;
+  }
+
+  // Stream priority of a grouped lookup, the highest of its tables.
+  int get_stream_priority(size_t grouped_id) const {
+    int priority = 0;
+    for (int lookup_id : this->grouped_lookup_params[grouped_id].lookup_ids) {
+      auto it = table_id_to_stream_priority_.find(this->lookup_params[lookup_id].table_id);
+      if (it != table_id_to_stream_priority_.end()) {
+        priority = std::min(priority, it->second);
+      }
+    }
+    return priority;
+  }
 };
 
 struct EmbeddingInput {
@@ -95,8 +95,8 @@ __global__ void count_num_bucket_ids_kernel(const BucketRangeType **__restrict__
 template <typename BucketRangeType>
 __global__ void generate_sequence_kernel(const BucketRangeType **bucket_range,
                                          const int *lookup_ids, int num_local_lookup,
-                                         int num_sample_per_lookup, BucketRangeType *bucket_ids,
-                                         uint64_t num_keys) {
+                                         int num_sample_per_lookup, bool pooled,
+                                         BucketRangeType *bucket_ids, uint64_t num_keys) {
   extern __shared__ uint64_t smem_bucket_range_on_lookup_ids[];
   // FIXME: do scan in collective way
   if (threadIdx.x == 0) {
@@ -118,7 +118,8 @@ __global__ void generate_sequence_kernel(const BucketRangeType **bucket_range,
     BucketRangeType end = bucket_range[lookup_id][sample_id + 1];
 
     for (auto hotness_id = 0; hotness_id < (end - start); ++hotness_id) {
-      auto bucket_id = sample_id + (lookup_start_offset + hotness_id) * num_sample_per_lookup;
+      auto bucket_id =
+          pooled ? i : sample_id + (lookup_start_offset + hotness_id) * num_sample_per_lookup;
       auto dst_id = smem_bucket_range_on_lookup_ids[local_lookup_id] + start + hotness_id;
       bucket_ids[dst_id] = bucket_id;
     }
@@ -279,10 +280,14 @@ PartitionAndUniqueOperator::PartitionAndUniqueOperator(
       num_features_(0),
       batch_size_(ebc_param.universal_batch_size),
       global_gpu_count_(core->get_global_gpu_count()),
-      batch_size_per_gpu_(batch_size_ / global_gpu_count_) {
+      batch_size_per_gpu_(batch_size_ / global_gpu_count_),
+      pooled_(false) {
   CudaDeviceContext ctx(core->get_device_id());
 
   auto &grouped_lookup_param = ebc_param.grouped_lookup_params[group_id];
+  for (int lookup_id : grouped_lookup_param.lookup_ids) {
+    pooled_ = ebc_param.lookup_params[lookup_id].combiner != embedding::Combiner::Concat;
+  }
 
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
   core23::TensorParams params = core23::TensorParams().device(device);
@@ -422,7 +427,7 @@ void PartitionAndUniqueOperator::fill_continuous_bucket_ids(const DataDistributi
 
     generate_sequence_kernel<<<grid_size, block_size, smem_bytes, stream>>>(
         bucket_range_ptrs, d_lookup_ids_.data<int>(), d_lookup_ids_.num_elements(),
-        batch_size_per_gpu_, bucket_ids.data<BucketRangeType>(), num_keys);
+        batch_size_per_gpu_, pooled_, bucket_ids.data<BucketRangeType>(), num_keys);
   });
 }
 
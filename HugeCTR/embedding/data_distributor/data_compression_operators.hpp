@@ -119,6 +119,8 @@ class PartitionAndUniqueOperator {
   int batch_size_;
   int global_gpu_count_;
   int batch_size_per_gpu_;
+  // Whether the lookups are pooled, so that all keys of a sample share a bucket id.
+  bool pooled_;
 };
 
 class CompactPartitionDataOperator {
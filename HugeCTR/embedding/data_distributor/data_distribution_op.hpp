@@ -187,6 +187,8 @@ class SparseMPDataDistributionOp : public IDataDistributionOp {
   mp::CountKeysOperator count_keys_operator_;
   mp::TransposeBucketsOperator transpose_buckets_operator_;
   mp::SwizzleKeysOperator swizzle_keys_operator_;
+  // Removes the frequent keys, which are looked up in the replicated rows.
+  std::unique_ptr<FrequentKeysFilterOperator> frequent_keys_filter_;
 
   core23::Tensor d_local_table_ids_;
   std::unique_ptr<embedding::CompressOffset> compress_offset_;
@@ -212,6 +214,8 @@ class SparseDPDataDistributionOp final : public IDataDistributionOp {
   size_t batch_size_per_gpu_;
 
   dp::ConcatKeysAndBucketRangeOperator concat_keys_and_bucket_range_operator_;
+  // Selects the frequent keys of model parallel tables, if this group looks up their replicas.
+  std::unique_ptr<FrequentKeysFilterOperator> frequent_keys_filter_;
 
   core23::Tensor d_local_table_ids_;
   std::unique_ptr<embedding::CompressOffset> compress_offset_;
@@ -54,6 +54,9 @@ DataDistributor::DataDistributor(
   init_indices_converter();
   init_filtered_all_to_all();
   init_fixed_dp_bucket_range();
+  init_vocabulary_remap();
+  init_feature_transform();
+  init_narrow_keys();
 
   for (size_t gpu_id = 0; gpu_id < num_local_gpus_; ++gpu_id) {
     data_distribution_input_.emplace_back(core_resource_managers_[gpu_id], ebc_param.num_lookup,
@@ -112,7 +115,8 @@ void DataDistributor::init_filtered_all_to_all() {
         data_distribution_ops.push_back(std::make_unique<SparseMPDataDistributionOp>(
             core, ebc_param_, group_id, emb_table_param_list_));
       } else if (table_placement_strategy == embedding::TablePlacementStrategy::DataParallel &&
-                 embedding_type == embedding::EmbeddingType::Sparse) {
+                 (embedding_type == embedding::EmbeddingType::Sparse ||
+                  embedding_type == embedding::EmbeddingType::FrequentSparse)) {
         data_distribution_ops.push_back(std::make_unique<SparseDPDataDistributionOp>(
             core, ebc_param_, group_id, emb_table_param_list_));
       } else if (table_placement_strategy == embedding::TablePlacementStrategy::ModelParallel &&
@@ -163,22 +167,85 @@ void DataDistributor::init_fixed_dp_bucket_range() {
   }
 }
 
-void DataDistributor::distribute(int gpu_id, const std::vector<core23::Tensor>& dp_keys,
-                                 const std::vector<core23::Tensor>& dp_bucket_range,
+void DataDistributor::init_vocabulary_remap() {
+  if (ebc_param_.static_vocabularies_.empty()) return;
+  HCTR_CHECK_HINT(ebc_param_.input_layout_ == embedding::EmbeddingLayout::FeatureMajor,
+                  "Static vocabularies require the feature major input of the RawAsync reader.");
+
+  // The hashes are built once on the host, and copied to each GPU.
+  std::map<int, embedding::PerfectHash> perfect_hashes;
+  for (const auto& [table_id, keys] : ebc_param_.static_vocabularies_) {
+    perfect_hashes[table_id] = embedding::build_perfect_hash(*keys);
+  }
+  for (size_t gpu_id = 0; gpu_id < num_local_gpus_; ++gpu_id) {
+    CudaDeviceContext context(core_resource_managers_[gpu_id]->get_device_id());
+    vocabulary_remaps_.push_back(std::make_unique<VocabularyRemapOperator>(
+        core_resource_managers_[gpu_id], ebc_param_, perfect_hashes));
+  }
+}
+
+void DataDistributor::init_feature_transform() {
+  if (ebc_param_.virtual_features_.empty()) return;
+  HCTR_CHECK_HINT(ebc_param_.input_layout_ == embedding::EmbeddingLayout::FeatureMajor,
+                  "Virtual features require the feature major input of the RawAsync or InMemory "
+                  "reader.");
+  for (size_t gpu_id = 0; gpu_id < num_local_gpus_; ++gpu_id) {
+    CudaDeviceContext context(core_resource_managers_[gpu_id]->get_device_id());
+    feature_transforms_.push_back(
+        std::make_unique<FeatureTransformOperator>(core_resource_managers_[gpu_id], ebc_param_));
+  }
+}
+
+void DataDistributor::init_narrow_keys() {
+  if (!ebc_param_.narrow_input_keys_) return;
+  HCTR_CHECK_HINT(ebc_param_.input_layout_ == embedding::EmbeddingLayout::FeatureMajor,
+                  "32-bit keys of 64-bit input keys require the feature major input of the "
+                  "RawAsync or InMemory reader.");
+  for (size_t gpu_id = 0; gpu_id < num_local_gpus_; ++gpu_id) {
+    CudaDeviceContext context(core_resource_managers_[gpu_id]->get_device_id());
+    narrow_keys_.push_back(
+        std::make_unique<NarrowKeysOperator>(core_resource_managers_[gpu_id], ebc_param_));
+  }
+}
+
+void DataDistributor::distribute(int gpu_id, const std::vector<core23::Tensor>& input_keys,
+                                 const std::vector<core23::Tensor>& input_bucket_range,
                                  DataDistributor::Result& output, int batch_size) {
   auto core = core_resource_managers_[gpu_id];
   CudaDeviceContext ctx(core->get_device_id());
   cudaStream_t stream = core->get_local_gpu()->get_stream();
 
-  const bool bucket_ranges_outdated = batch_size != gpu_comm_data_[gpu_id].last_batch_size;
-  gpu_comm_data_[gpu_id].last_batch_size = batch_size;
+  // The reader returns the keys of the input features, from which the virtual features are hashed.
+  HCTR_CHECK_HINT(feature_transforms_.empty() || input_bucket_range.empty(),
+                  "Virtual features require input features with a fixed hotness");
+  const std::vector<core23::Tensor>& keys =
+      feature_transforms_.empty() ? input_keys : (*feature_transforms_[gpu_id])(input_keys, stream);
+  if (!narrow_keys_.empty()) {
+    (*narrow_keys_[gpu_id])(keys, input_bucket_range, stream);
+  }
+  const std::vector<core23::Tensor>& dp_keys =
+      narrow_keys_.empty() ? keys : narrow_keys_[gpu_id]->keys();
+  const std::vector<core23::Tensor>& dp_bucket_range =
+      narrow_keys_.empty() ? input_bucket_range : narrow_keys_[gpu_id]->bucket_ranges();
+
+  // Bucket ranges of the data reader change with each batch, the fixed ones with the batch size.
+  const bool reader_bucket_ranges = !dp_bucket_range.empty();
+  const bool bucket_ranges_outdated =
+      reader_bucket_ranges || batch_size != gpu_comm_data_[gpu_id].last_batch_size;
+  gpu_comm_data_[gpu_id].last_batch_size = reader_bucket_ranges ? -1 : batch_size;
 
   // sparse_forward new full batch bucket range (to be deprecated)
   // sparse_forward dp bucket ranges (to be moved to data reader)
-  if (bucket_ranges_outdated) {
+  if (reader_bucket_ranges) {
+    HCTR_CHECK_HINT(dp_bucket_range.size() == dp_keys.size(),
+                    "The data reader must return a bucket range for each lookup");
+    compute_dp_bucket_range_operators_[gpu_id].count_keys_per_bucket(
+        dp_bucket_range, output[0].num_keys_per_bucket, stream);
+  } else if (bucket_ranges_outdated) {
     compute_dp_bucket_range_operators_[gpu_id](fixed_dp_bucket_range_[gpu_id],
                                                output[0].num_keys_per_bucket, batch_size, stream);
-
+  }
+  if (bucket_ranges_outdated) {
     // Instead of recomputing for each group, copy computed result
     for (size_t grouped_id = 1; grouped_id < ebc_param_.grouped_lookup_params.size();
          ++grouped_id) {
@@ -188,11 +255,15 @@ void DataDistributor::distribute(int gpu_id, const std::vector<core23::Tensor>&
     }
   }
 
-  data_distribution_input_[gpu_id].copy_tensor_vec(dp_keys, fixed_dp_bucket_range_[gpu_id], stream);
+  data_distribution_input_[gpu_id].copy_tensor_vec(
+      dp_keys, reader_bucket_ranges ? dp_bucket_range : fixed_dp_bucket_range_[gpu_id], stream);
+  const DataDistributionInput& input =
+      vocabulary_remaps_.empty()
+          ? data_distribution_input_[gpu_id]
+          : (*vocabulary_remaps_[gpu_id])(data_distribution_input_[gpu_id], stream);
 
   for (size_t grouped_id = 0; grouped_id < ebc_param_.grouped_lookup_params.size(); grouped_id++) {
-    data_distribution_ops_[grouped_id][gpu_id]->distribute(data_distribution_input_[gpu_id],
-                                                           output[grouped_id], stream);
+    data_distribution_ops_[grouped_id][gpu_id]->distribute(input, output[grouped_id], stream);
   }
 }
 
@@ -241,7 +312,8 @@ DataDistributor::Result allocate_output_for_data_distributor(
             .data_type(ebc_param.offset_type));
 
     switch (grouped_lookup_params.embedding_type) {
-      case embedding::EmbeddingType::Sparse: {
+      case embedding::EmbeddingType::Sparse:
+      case embedding::EmbeddingType::FrequentSparse: {
         embedding_input.bucket_range = core23::Tensor(
             params.shape({static_cast<int64_t>(batch_size_after_filter * num_buckets + 1)})
                 .data_type(ebc_param.offset_type));
@@ -66,6 +66,12 @@ class DataDistributor {
 
   void init_fixed_dp_bucket_range();
 
+  void init_vocabulary_remap();
+
+  void init_feature_transform();
+
+  void init_narrow_keys();
+
   std::vector<std::shared_ptr<core::CoreResourceManager>> core_resource_managers_;
   std::vector<int> feature_pooling_factors_;
   std::vector<std::vector<int>> resident_feature_tables_;  // [gpu_id][feature_id]
@@ -122,6 +128,15 @@ class DataDistributor {
 
   std::vector<std::unique_ptr<embedding::PreprocessInput>> preprocess_inputs_;
 
+  // Remaps the keys of tables with a static vocabulary, empty if there are none.
+  std::vector<std::unique_ptr<VocabularyRemapOperator>> vocabulary_remaps_;
+
+  // Computes the keys of the virtual features, empty if there are none.
+  std::vector<std::unique_ptr<FeatureTransformOperator>> feature_transforms_;
+
+  // Converts the 64-bit keys of the data reader to 32-bit keys, empty if they are not converted.
+  std::vector<std::unique_ptr<NarrowKeysOperator>> narrow_keys_;
+
   std::vector<embedding::CompressOffset> compress_offsets_;
   std::vector<core23::Tensor> d_local_table_id_lists_;
   std::vector<embedding::KeysToIndicesConverter> indices_converters_;
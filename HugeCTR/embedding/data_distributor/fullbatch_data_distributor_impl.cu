@@ -154,6 +154,8 @@ void DataDistributor::init_batch_major_fullbatch_input_preprocessor() {
 
 void DataDistributor::init_indices_converter() {
   if (ebc_param_.keys_preprocess_strategy_ != embedding::KeysPreprocessStrategy::AddOffset) return;
+  // Frequent keys of model parallel tables are only supported with the DP input, see distribute.
+  if (!ebc_param_.sparse_freq_keys_data.table_ids.empty()) return;
   int num_gpus = core_resource_managers_.size();
   for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
     CudaDeviceContext context(core_resource_managers_[gpu_id]->get_device_id());
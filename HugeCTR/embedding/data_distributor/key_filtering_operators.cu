@@ -19,6 +19,10 @@
 #include <cooperative_groups/scan.h>
 #include <cuda_runtime.h>
 
+#include <cub/cub.cuh>
+#include <embedding/operators/feature_hash.cuh>
+#include <embedding/operators/perfect_hash.cuh>
+#include <numeric>
 #include <utils.cuh>
 #include <utils.hpp>
 
@@ -197,6 +201,121 @@ __global__ void count_keys_per_gpu(const offset_t* __restrict k_per_b_gpu_major,
   }
 }
 
+// Position of a key in the sorted frequent keys of its table, -1 if it is not frequent.
+template <typename key_t>
+__device__ int64_t find_frequent_key(const key_t* __restrict frequent_keys, int64_t num_keys,
+                                     key_t key) {
+  int64_t lo = 0;
+  int64_t hi = num_keys;
+  while (lo < hi) {
+    int64_t mid = (lo + hi) / 2;
+    if (frequent_keys[mid] < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo < num_keys && frequent_keys[lo] == key) ? lo : -1;
+}
+
+template <typename key_t, typename offset_t>
+__global__ void count_frequent_keys(const key_t** __restrict keys,
+                                    const offset_t** __restrict bucket_range,
+                                    const int* __restrict filtered_lookup_ids,
+                                    const int* __restrict filtered_table_ids,
+                                    const uint64_t* __restrict frequent_key_offsets,
+                                    const key_t* __restrict frequent_keys, bool keep_frequent,
+                                    offset_t* keys_per_bucket, int batch_size_per_gpu) {
+  const int filtered_id = blockIdx.y;
+  const int lookup_id = filtered_lookup_ids[filtered_id];
+  const int table_id = filtered_table_ids[filtered_id];
+  const key_t* table_keys = frequent_keys + frequent_key_offsets[table_id];
+  const int64_t num_table_keys =
+      frequent_key_offsets[table_id + 1] - frequent_key_offsets[table_id];
+
+  CUDA_1D_KERNEL_LOOP(bucket_idx, batch_size_per_gpu) {
+    offset_t count = 0;
+    for (offset_t i = bucket_range[lookup_id][bucket_idx];
+         i < bucket_range[lookup_id][bucket_idx + 1]; ++i) {
+      bool is_frequent = find_frequent_key(table_keys, num_table_keys, keys[lookup_id][i]) >= 0;
+      count += is_frequent == keep_frequent ? 1 : 0;
+    }
+    keys_per_bucket[filtered_id * batch_size_per_gpu + bucket_idx] = count;
+  }
+}
+
+// flat_bucket_range holds the filtered bucket ranges of all filtered lookups, which are rebased
+// to start at 0 for each lookup.
+template <typename key_t, typename offset_t>
+__global__ void scatter_frequent_keys(const key_t** __restrict keys,
+                                      const offset_t** __restrict bucket_range,
+                                      const int* __restrict filtered_lookup_ids,
+                                      const int* __restrict filtered_table_ids,
+                                      const uint64_t* __restrict frequent_key_offsets,
+                                      const key_t* __restrict frequent_keys, bool keep_frequent,
+                                      const offset_t* __restrict flat_bucket_range,
+                                      key_t** result_keys, offset_t** result_bucket_range,
+                                      int batch_size_per_gpu) {
+  const int filtered_id = blockIdx.y;
+  const int lookup_id = filtered_lookup_ids[filtered_id];
+  const int table_id = filtered_table_ids[filtered_id];
+  const uint64_t table_offset = frequent_key_offsets[table_id];
+  const key_t* table_keys = frequent_keys + table_offset;
+  const int64_t num_table_keys = frequent_key_offsets[table_id + 1] - table_offset;
+
+  const offset_t* lookup_range = flat_bucket_range + filtered_id * batch_size_per_gpu;
+  const offset_t lookup_start = lookup_range[0];
+  key_t* lookup_result_keys = result_keys[lookup_id];
+  offset_t* lookup_result_range = result_bucket_range[lookup_id];
+
+  CUDA_1D_KERNEL_LOOP(bucket_idx, batch_size_per_gpu) {
+    offset_t dst = lookup_range[bucket_idx] - lookup_start;
+    lookup_result_range[bucket_idx] = dst;
+    if (bucket_idx == batch_size_per_gpu - 1) {
+      lookup_result_range[batch_size_per_gpu] = lookup_range[batch_size_per_gpu] - lookup_start;
+    }
+    for (offset_t i = bucket_range[lookup_id][bucket_idx];
+         i < bucket_range[lookup_id][bucket_idx + 1]; ++i) {
+      key_t key = keys[lookup_id][i];
+      int64_t pos = find_frequent_key(table_keys, num_table_keys, key);
+      if ((pos >= 0) != keep_frequent) continue;
+      lookup_result_keys[dst++] = keep_frequent ? static_cast<key_t>(table_offset + pos) : key;
+    }
+  }
+}
+
+// Keys outside of the vocabulary of their table are replaced by num_keys.
+template <typename key_t, typename offset_t>
+__global__ void remap_vocabulary_keys(const key_t** __restrict keys,
+                                      const offset_t** __restrict bucket_range,
+                                      const int* __restrict remapped_lookup_ids,
+                                      const int* __restrict vocabulary_ids,
+                                      const embedding::PerfectHashParams* __restrict hash_params,
+                                      const uint32_t* __restrict pilots,
+                                      const uint64_t* __restrict slot_keys,
+                                      const uint32_t* __restrict slot_rows, key_t** result_keys,
+                                      int batch_size_per_gpu) {
+  const int remapped_id = blockIdx.y;
+  const int lookup_id = remapped_lookup_ids[remapped_id];
+  const embedding::PerfectHashParams params = hash_params[vocabulary_ids[remapped_id]];
+  const uint32_t* table_pilots = pilots + params.pilot_offset;
+  const uint64_t* table_slot_keys = slot_keys + params.slot_offset;
+  const uint32_t* table_slot_rows = slot_rows + params.slot_offset;
+
+  CUDA_1D_KERNEL_LOOP(bucket_idx, batch_size_per_gpu) {
+    for (offset_t i = bucket_range[lookup_id][bucket_idx];
+         i < bucket_range[lookup_id][bucket_idx + 1]; ++i) {
+      uint64_t key = static_cast<uint64_t>(keys[lookup_id][i]);
+      uint64_t hash = embedding::perfect_hash_key(key, params.seed);
+      uint32_t pilot = table_pilots[embedding::perfect_hash_bucket(hash, params.num_buckets)];
+      uint64_t slot = embedding::perfect_hash_slot(hash, pilot, params.num_keys);
+      result_keys[lookup_id][i] = table_slot_keys[slot] == key
+                                      ? static_cast<key_t>(table_slot_rows[slot])
+                                      : static_cast<key_t>(params.num_keys);
+    }
+  }
+}
+
 template <typename offset_t>
 __global__ void compute_bucket_ranges_with_padding(offset_t** bucket_ranges,
                                                    offset_t* keys_per_bucket,
@@ -235,6 +354,18 @@ __global__ void compute_bucket_ranges_with_padding(offset_t** bucket_ranges,
   }
 }
 
+template <typename offset_t>
+__global__ void compute_keys_per_bucket(offset_t** bucket_ranges, offset_t* keys_per_bucket,
+                                        int batch_size_per_gpu) {
+  const int lookup_id = blockIdx.y;
+  const offset_t* bucket_range = bucket_ranges[lookup_id];
+
+  CUDA_1D_KERNEL_LOOP(bucket_idx, batch_size_per_gpu) {
+    keys_per_bucket[lookup_id * batch_size_per_gpu + bucket_idx] =
+        bucket_range[bucket_idx + 1] - bucket_range[bucket_idx];
+  }
+}
+
 template <int TILE_SIZE, typename offset_t>
 __global__ void compute_shard_ranges(uint32_t* shard_ranges,
                                      const offset_t** __restrict bucket_ranges,
@@ -320,6 +451,69 @@ __global__ void concat_keys_and_bucket_range(key_t* concat_keys, offset_t* conca
   }
 }
 
+// Device view of a virtual feature. Hashed features have no cross input, whose id is -1.
+struct VirtualFeatureKernelParams {
+  int64_t input_id;
+  int64_t cross_input_id;
+  int64_t input_hotness;
+  int64_t cross_hotness;
+  int64_t hash_function;
+  uint64_t num_buckets;
+  uint64_t seed;
+};
+static_assert(sizeof(VirtualFeatureKernelParams) == 7 * sizeof(uint64_t), "copied as uint64_t");
+
+// Key j of a sample of a cross is the pair of key j / cross_hotness of the first input and key
+// j % cross_hotness of the second one.
+template <typename key_t>
+__global__ void compute_virtual_feature_keys(const key_t** __restrict input_keys,
+                                             const VirtualFeatureKernelParams* __restrict params,
+                                             key_t** virtual_keys, int batch_size_per_gpu) {
+  const VirtualFeatureKernelParams p = params[blockIdx.y];
+  const auto hash_function = static_cast<embedding::FeatureHashFunction>(p.hash_function);
+  const key_t* keys = input_keys[p.input_id];
+  key_t* result_keys = virtual_keys[blockIdx.y];
+
+  if (p.cross_input_id < 0) {
+    CUDA_1D_KERNEL_LOOP_T(int64_t, i, batch_size_per_gpu * p.input_hotness) {
+      result_keys[i] = static_cast<key_t>(embedding::hash_feature_key(
+          static_cast<uint64_t>(keys[i]), p.seed, p.num_buckets, hash_function));
+    }
+    return;
+  }
+  const key_t* cross_keys = input_keys[p.cross_input_id];
+  const int64_t hotness = p.input_hotness * p.cross_hotness;
+  CUDA_1D_KERNEL_LOOP_T(int64_t, i, batch_size_per_gpu * hotness) {
+    const int64_t sample = i / hotness;
+    const int64_t j = i % hotness;
+    const key_t key = keys[sample * p.input_hotness + j / p.cross_hotness];
+    const key_t cross_key = cross_keys[sample * p.cross_hotness + j % p.cross_hotness];
+    result_keys[i] = static_cast<key_t>(
+        embedding::cross_feature_keys(static_cast<uint64_t>(key), static_cast<uint64_t>(cross_key),
+                                      p.seed, p.num_buckets, hash_function));
+  }
+}
+
+// Converts the keys of lookup blockIdx.y, and its bucket range if the data reader returns them.
+__global__ void narrow_keys_and_bucket_ranges(const int64_t* const* __restrict input_ptrs,
+                                              uint32_t* const* __restrict output_ptrs,
+                                              const int* __restrict hotness, int num_lookup,
+                                              int batch_size_per_gpu, bool has_bucket_ranges) {
+  const int lookup_id = blockIdx.y;
+  const int64_t* keys = input_ptrs[lookup_id];
+  uint32_t* result_keys = output_ptrs[lookup_id];
+  CUDA_1D_KERNEL_LOOP_T(int64_t, i, static_cast<int64_t>(batch_size_per_gpu) * hotness[lookup_id]) {
+    result_keys[i] = static_cast<uint32_t>(keys[i]);
+  }
+  if (!has_bucket_ranges) return;
+
+  const int64_t* bucket_range = input_ptrs[num_lookup + lookup_id];
+  uint32_t* result_bucket_range = output_ptrs[num_lookup + lookup_id];
+  CUDA_1D_KERNEL_LOOP(i, batch_size_per_gpu + 1) {
+    result_bucket_range[i] = static_cast<uint32_t>(bucket_range[i]);
+  }
+}
+
 }  // namespace kernels
 
 template <typename T>
@@ -650,6 +844,412 @@ void ComputeDPBucketRangeOperator::operator()(std::vector<core23::Tensor> dp_buc
   HCTR_LIB_THROW(cudaGetLastError());
 }
 
+void ComputeDPBucketRangeOperator::count_keys_per_bucket(
+    const std::vector<core23::Tensor>& dp_bucket_ranges, core23::Tensor keys_per_bucket,
+    cudaStream_t stream) {
+  int num_lookup = dp_bucket_ranges.size();
+
+  init_tensor_list(h_ptrs_, dp_bucket_ranges);
+  core23::copy_async(d_ptrs_, h_ptrs_, stream);
+
+  dim3 block(128);
+  dim3 grid((batch_size_per_gpu_ + block.x - 1) / block.x, num_lookup);
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(dp_bucket_ranges[0].data_type().type(), BucketRangeType, [&] {
+    kernels::compute_keys_per_bucket<<<grid, block, 0, stream>>>(
+        d_ptrs_.data<BucketRangeType*>(), keys_per_bucket.data<BucketRangeType>(),
+        batch_size_per_gpu_);
+  });
+
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+FrequentKeysFilterOperator::FrequentKeysFilterOperator(
+    std::shared_ptr<core::CoreResourceManager> core,
+    const embedding::EmbeddingCollectionParam& ebc_param, size_t grouped_id, bool keep_frequent)
+    : keep_frequent_(keep_frequent),
+      batch_size_per_gpu_(ebc_param.universal_batch_size / core->get_global_gpu_count()),
+      h_filtered_ids_(ebc_param.num_lookup, -1),
+      output_(core, ebc_param.num_lookup, ebc_param.key_type, ebc_param.offset_type) {
+  CudaDeviceContext ctx(core->get_device_id());
+
+  const auto& freq_keys_data = ebc_param.sparse_freq_keys_data;
+  std::vector<uint64_t> h_frequent_key_offsets(ebc_param.num_table + 1, 0);
+  for (size_t i = 0; i < freq_keys_data.table_ids.size(); ++i) {
+    h_frequent_key_offsets[freq_keys_data.table_ids[i] + 1] =
+        freq_keys_data.h_frequent_keys[i].size();
+  }
+  std::partial_sum(h_frequent_key_offsets.begin(), h_frequent_key_offsets.end(),
+                   h_frequent_key_offsets.begin());
+
+  std::vector<int> h_filtered_lookup_ids;
+  std::vector<int> h_filtered_table_ids;
+  for (int lookup_id = 0; lookup_id < ebc_param.num_lookup; ++lookup_id) {
+    int table_id = ebc_param.lookup_params[lookup_id].table_id;
+    if (!ebc_param.lookup_id_in_group(grouped_id, lookup_id) ||
+        ebc_param.get_frequent_table_index(table_id) < 0)
+      continue;
+    h_filtered_ids_[lookup_id] = static_cast<int>(h_filtered_lookup_ids.size());
+    h_filtered_lookup_ids.push_back(lookup_id);
+    h_filtered_table_ids.push_back(table_id);
+  }
+  num_filtered_ = static_cast<int>(h_filtered_lookup_ids.size());
+  if (num_filtered_ == 0) return;
+
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::BufferParams buffer_params;
+  buffer_params.unitary = false;
+  core23::TensorParams params = core23::TensorParams().device(device).buffer_params(buffer_params);
+
+  filtered_lookup_ids_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(num_filtered_)}).data_type(core23::ScalarType::Int32));
+  core23::copy_sync(filtered_lookup_ids_, h_filtered_lookup_ids);
+  filtered_table_ids_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(num_filtered_)}).data_type(core23::ScalarType::Int32));
+  core23::copy_sync(filtered_table_ids_, h_filtered_table_ids);
+  frequent_key_offsets_ =
+      core23::Tensor(params.shape({static_cast<int64_t>(h_frequent_key_offsets.size())})
+                         .data_type(core23::ScalarType::UInt64));
+  core23::copy_sync(frequent_key_offsets_, h_frequent_key_offsets);
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(ebc_param.key_type.type(), KeyType, [&] {
+    std::vector<KeyType> h_frequent_keys;
+    for (const auto& table_keys : freq_keys_data.h_frequent_keys) {
+      for (int64_t key : table_keys) {
+        h_frequent_keys.push_back(static_cast<KeyType>(key));
+      }
+    }
+    frequent_keys_ = core23::Tensor(params.shape({static_cast<int64_t>(h_frequent_keys.size())})
+                                        .data_type(ebc_param.key_type));
+    core23::copy_sync(frequent_keys_, h_frequent_keys);
+  });
+
+  int64_t num_buckets = static_cast<int64_t>(num_filtered_) * batch_size_per_gpu_;
+  keys_per_bucket_ = core23::Tensor(params.shape({num_buckets}).data_type(ebc_param.offset_type));
+  flat_bucket_range_ =
+      core23::Tensor(params.shape({num_buckets + 1}).data_type(ebc_param.offset_type));
+  {
+    size_t temp_bytes = 0;
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(ebc_param.offset_type.type(), BucketRangeType, [&] {
+      cub::DeviceScan::InclusiveSum(nullptr, temp_bytes, (BucketRangeType*)nullptr,
+                                    (BucketRangeType*)nullptr, num_buckets);
+    });
+    temp_scan_storage_ = core23::Tensor(
+        params.shape({static_cast<int64_t>(temp_bytes)}).data_type(core23::ScalarType::Char));
+  }
+
+  for (int lookup_id : h_filtered_lookup_ids) {
+    int max_hotness = ebc_param.lookup_params[lookup_id].max_hotness;
+    keys_.emplace_back(
+        params.shape({static_cast<int64_t>(batch_size_per_gpu_) * max_hotness})
+            .data_type(ebc_param.key_type));
+    bucket_ranges_.emplace_back(params.shape({static_cast<int64_t>(batch_size_per_gpu_) + 1})
+                                    .data_type(ebc_param.offset_type));
+  }
+}
+
+const DataDistributionInput& FrequentKeysFilterOperator::operator()(
+    const DataDistributionInput& input, cudaStream_t stream) {
+  const int num_lookup = input.num_lookup_;
+  void** h_ptrs = output_.h_ptrs_.data<void*>();
+  void* const* h_input_ptrs = input.h_ptrs_.data<void*>();
+  for (int lookup_id = 0; lookup_id < num_lookup; ++lookup_id) {
+    int filtered_id = h_filtered_ids_[lookup_id];
+    h_ptrs[lookup_id] = filtered_id < 0 ? h_input_ptrs[lookup_id] : keys_[filtered_id].data();
+    h_ptrs[num_lookup + lookup_id] = filtered_id < 0 ? h_input_ptrs[num_lookup + lookup_id]
+                                                     : bucket_ranges_[filtered_id].data();
+  }
+  core23::copy_async(output_.d_ptrs_, output_.h_ptrs_, stream);
+  if (num_filtered_ == 0) return output_;
+
+  dim3 block(128);
+  dim3 grid((batch_size_per_gpu_ + block.x - 1) / block.x, num_filtered_);
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(input.key_type.type(), KeyType, [&] {
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(input.offset_type.type(), BucketRangeType, [&] {
+      kernels::count_frequent_keys<<<grid, block, 0, stream>>>(
+          input.get_dp_keys_pointer_ptr<KeyType>(),
+          input.get_dp_bucket_range_pointer_ptr<BucketRangeType>(),
+          filtered_lookup_ids_.data<int>(), filtered_table_ids_.data<int>(),
+          frequent_key_offsets_.data<uint64_t>(), frequent_keys_.data<KeyType>(), keep_frequent_,
+          keys_per_bucket_.data<BucketRangeType>(), batch_size_per_gpu_);
+      HCTR_LIB_THROW(cudaGetLastError());
+
+      size_t temp_bytes = temp_scan_storage_.num_bytes();
+      HCTR_LIB_THROW(cudaMemsetAsync(flat_bucket_range_.data<BucketRangeType>(), 0,
+                                     sizeof(BucketRangeType), stream));
+      cub::DeviceScan::InclusiveSum(temp_scan_storage_.data(), temp_bytes,
+                                    keys_per_bucket_.data<BucketRangeType>(),
+                                    flat_bucket_range_.data<BucketRangeType>() + 1,
+                                    keys_per_bucket_.num_elements(), stream);
+
+      kernels::scatter_frequent_keys<<<grid, block, 0, stream>>>(
+          input.get_dp_keys_pointer_ptr<KeyType>(),
+          input.get_dp_bucket_range_pointer_ptr<BucketRangeType>(),
+          filtered_lookup_ids_.data<int>(), filtered_table_ids_.data<int>(),
+          frequent_key_offsets_.data<uint64_t>(), frequent_keys_.data<KeyType>(), keep_frequent_,
+          flat_bucket_range_.data<BucketRangeType>(), (KeyType**)output_.d_ptrs_.data(),
+          (BucketRangeType**)output_.d_ptrs_.data() + num_lookup, batch_size_per_gpu_);
+    });
+  });
+  HCTR_LIB_THROW(cudaGetLastError());
+  return output_;
+}
+
+VocabularyRemapOperator::VocabularyRemapOperator(
+    std::shared_ptr<core::CoreResourceManager> core,
+    const embedding::EmbeddingCollectionParam& ebc_param,
+    const std::map<int, embedding::PerfectHash>& perfect_hashes)
+    : batch_size_per_gpu_(ebc_param.universal_batch_size / core->get_global_gpu_count()),
+      h_remapped_ids_(ebc_param.num_lookup, -1),
+      output_(core, ebc_param.num_lookup, ebc_param.key_type, ebc_param.offset_type) {
+  CudaDeviceContext ctx(core->get_device_id());
+
+  std::vector<uint64_t> h_hash_params;
+  std::vector<uint32_t> h_pilots;
+  std::vector<uint64_t> h_slot_keys;
+  std::vector<uint32_t> h_slot_rows;
+  std::map<int, int> table_id_to_vocabulary_id;
+  for (const auto& [table_id, ph] : perfect_hashes) {
+    table_id_to_vocabulary_id[table_id] = static_cast<int>(table_id_to_vocabulary_id.size());
+    embedding::PerfectHashParams params{ph.seed, ph.num_keys, ph.num_buckets, h_pilots.size(),
+                                        h_slot_keys.size()};
+    const uint64_t* params_ptr = reinterpret_cast<const uint64_t*>(&params);
+    h_hash_params.insert(h_hash_params.end(), params_ptr,
+                         params_ptr + sizeof(params) / sizeof(uint64_t));
+    h_pilots.insert(h_pilots.end(), ph.pilots.begin(), ph.pilots.end());
+    h_slot_keys.insert(h_slot_keys.end(), ph.slot_keys.begin(), ph.slot_keys.end());
+    h_slot_rows.insert(h_slot_rows.end(), ph.slot_rows.begin(), ph.slot_rows.end());
+  }
+
+  std::vector<int> h_remapped_lookup_ids;
+  std::vector<int> h_vocabulary_ids;
+  for (int lookup_id = 0; lookup_id < ebc_param.num_lookup; ++lookup_id) {
+    auto it = table_id_to_vocabulary_id.find(ebc_param.lookup_params[lookup_id].table_id);
+    if (it == table_id_to_vocabulary_id.end()) continue;
+    h_remapped_ids_[lookup_id] = static_cast<int>(h_remapped_lookup_ids.size());
+    h_remapped_lookup_ids.push_back(lookup_id);
+    h_vocabulary_ids.push_back(it->second);
+  }
+  num_remapped_ = static_cast<int>(h_remapped_lookup_ids.size());
+  if (num_remapped_ == 0) return;
+
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::BufferParams buffer_params;
+  buffer_params.unitary = false;
+  core23::TensorParams params = core23::TensorParams().device(device).buffer_params(buffer_params);
+
+  remapped_lookup_ids_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(num_remapped_)}).data_type(core23::ScalarType::Int32));
+  core23::copy_sync(remapped_lookup_ids_, h_remapped_lookup_ids);
+  vocabulary_ids_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(num_remapped_)}).data_type(core23::ScalarType::Int32));
+  core23::copy_sync(vocabulary_ids_, h_vocabulary_ids);
+  hash_params_ = core23::Tensor(params.shape({static_cast<int64_t>(h_hash_params.size())})
+                                    .data_type(core23::ScalarType::UInt64));
+  core23::copy_sync(hash_params_, h_hash_params);
+  pilots_ = core23::Tensor(params.shape({static_cast<int64_t>(h_pilots.size())})
+                               .data_type(core23::ScalarType::UInt32));
+  core23::copy_sync(pilots_, h_pilots);
+  slot_keys_ = core23::Tensor(params.shape({static_cast<int64_t>(h_slot_keys.size())})
+                                  .data_type(core23::ScalarType::UInt64));
+  core23::copy_sync(slot_keys_, h_slot_keys);
+  slot_rows_ = core23::Tensor(params.shape({static_cast<int64_t>(h_slot_rows.size())})
+                                  .data_type(core23::ScalarType::UInt32));
+  core23::copy_sync(slot_rows_, h_slot_rows);
+
+  for (int lookup_id : h_remapped_lookup_ids) {
+    int max_hotness = ebc_param.lookup_params[lookup_id].max_hotness;
+    keys_.emplace_back(
+        params.shape({static_cast<int64_t>(batch_size_per_gpu_) * max_hotness})
+            .data_type(ebc_param.key_type));
+  }
+}
+
+const DataDistributionInput& VocabularyRemapOperator::operator()(const DataDistributionInput& input,
+                                                                 cudaStream_t stream) {
+  const int num_lookup = input.num_lookup_;
+  void** h_ptrs = output_.h_ptrs_.data<void*>();
+  void* const* h_input_ptrs = input.h_ptrs_.data<void*>();
+  for (int lookup_id = 0; lookup_id < num_lookup; ++lookup_id) {
+    int remapped_id = h_remapped_ids_[lookup_id];
+    h_ptrs[lookup_id] = remapped_id < 0 ? h_input_ptrs[lookup_id] : keys_[remapped_id].data();
+    h_ptrs[num_lookup + lookup_id] = h_input_ptrs[num_lookup + lookup_id];
+  }
+  core23::copy_async(output_.d_ptrs_, output_.h_ptrs_, stream);
+  if (num_remapped_ == 0) return output_;
+
+  dim3 block(128);
+  dim3 grid((batch_size_per_gpu_ + block.x - 1) / block.x, num_remapped_);
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(input.key_type.type(), KeyType, [&] {
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(input.offset_type.type(), BucketRangeType, [&] {
+      kernels::remap_vocabulary_keys<<<grid, block, 0, stream>>>(
+          input.get_dp_keys_pointer_ptr<KeyType>(),
+          input.get_dp_bucket_range_pointer_ptr<BucketRangeType>(),
+          remapped_lookup_ids_.data<int>(), vocabulary_ids_.data<int>(),
+          reinterpret_cast<const embedding::PerfectHashParams*>(hash_params_.data<uint64_t>()),
+          pilots_.data<uint32_t>(), slot_keys_.data<uint64_t>(), slot_rows_.data<uint32_t>(),
+          (KeyType**)output_.d_ptrs_.data(), batch_size_per_gpu_);
+    });
+  });
+  HCTR_LIB_THROW(cudaGetLastError());
+  return output_;
+}
+
+FeatureTransformOperator::FeatureTransformOperator(
+    std::shared_ptr<core::CoreResourceManager> core,
+    const embedding::EmbeddingCollectionParam& ebc_param)
+    : batch_size_per_gpu_(ebc_param.universal_batch_size / core->get_global_gpu_count()),
+      num_input_features_(ebc_param.num_input_features_),
+      key_type_(ebc_param.narrow_input_keys_ ? core23::ScalarType::Int64 : ebc_param.key_type),
+      lookup_input_feature_ids_(ebc_param.lookup_input_feature_ids_),
+      virtual_features_(ebc_param.virtual_features_),
+      keys_(ebc_param.num_lookup) {
+  CudaDeviceContext ctx(core->get_device_id());
+  HCTR_CHECK_HINT(!virtual_features_.empty(), "FeatureTransformOperator without virtual features");
+
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::BufferParams buffer_params;
+  buffer_params.unitary = false;
+  core23::TensorParams params = core23::TensorParams().device(device).buffer_params(buffer_params);
+
+  std::vector<uint64_t> h_feature_params;
+  std::vector<void*> h_virtual_ptrs;
+  for (const auto& feature : virtual_features_) {
+    const bool is_cross = feature.input_feature_ids.size() == 2;
+    kernels::VirtualFeatureKernelParams feature_params{
+        feature.input_feature_ids[0],
+        is_cross ? feature.input_feature_ids[1] : -1,
+        feature.input_hotness[0],
+        is_cross ? feature.input_hotness[1] : 1,
+        static_cast<int64_t>(feature.hash_function),
+        feature.num_buckets,
+        feature.seed};
+    const uint64_t* params_ptr = reinterpret_cast<const uint64_t*>(&feature_params);
+    h_feature_params.insert(h_feature_params.end(), params_ptr,
+                            params_ptr + sizeof(feature_params) / sizeof(uint64_t));
+
+    const int hotness = ebc_param.lookup_params[feature.lookup_id].max_hotness;
+    max_hotness_ = std::max(max_hotness_, hotness);
+    virtual_keys_.emplace_back(
+        params.shape({static_cast<int64_t>(batch_size_per_gpu_) * hotness}).data_type(key_type_));
+    h_virtual_ptrs.push_back(virtual_keys_.back().data());
+    keys_[feature.lookup_id] = virtual_keys_.back();
+  }
+
+  feature_params_ = core23::Tensor(params.shape({static_cast<int64_t>(h_feature_params.size())})
+                                       .data_type(core23::ScalarType::UInt64));
+  core23::copy_sync(feature_params_, h_feature_params);
+  d_virtual_ptrs_ = core23::Tensor(params.shape({static_cast<int64_t>(h_virtual_ptrs.size())})
+                                       .data_type(core23::ScalarType::Pointer));
+  core23::copy_sync(d_virtual_ptrs_, h_virtual_ptrs);
+  d_input_ptrs_ = core23::Tensor(params.shape({static_cast<int64_t>(num_input_features_)})
+                                     .data_type(core23::ScalarType::Pointer));
+  h_input_ptrs_ = core23::Tensor(core23::TensorParams()
+                                     .device(core23::DeviceType::CPU)
+                                     .shape({static_cast<int64_t>(num_input_features_)})
+                                     .data_type(core23::ScalarType::Pointer));
+}
+
+const std::vector<core23::Tensor>& FeatureTransformOperator::operator()(
+    const std::vector<core23::Tensor>& input_keys, cudaStream_t stream) {
+  HCTR_CHECK_HINT(static_cast<int>(input_keys.size()) == num_input_features_,
+                  "The data reader must return the keys of each of the ", num_input_features_,
+                  " input features");
+  for (int input_id = 0; input_id < num_input_features_; ++input_id) {
+    h_input_ptrs_.data<void*>()[input_id] = input_keys[input_id].data();
+  }
+  core23::copy_async(d_input_ptrs_, h_input_ptrs_, stream);
+  for (size_t lookup_id = 0; lookup_id < lookup_input_feature_ids_.size(); ++lookup_id) {
+    const int input_id = lookup_input_feature_ids_[lookup_id];
+    if (input_id >= 0) keys_[lookup_id] = input_keys[input_id];
+  }
+
+  dim3 block(256);
+  dim3 grid(std::min<unsigned int>((batch_size_per_gpu_ * max_hotness_ + block.x - 1) / block.x,
+                                    1024),
+            virtual_features_.size());
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), KeyType, [&] {
+    kernels::compute_virtual_feature_keys<<<grid, block, 0, stream>>>(
+        (const KeyType**)d_input_ptrs_.data(),
+        reinterpret_cast<const kernels::VirtualFeatureKernelParams*>(feature_params_.data()),
+        (KeyType**)d_virtual_ptrs_.data(), batch_size_per_gpu_);
+  });
+  HCTR_LIB_THROW(cudaGetLastError());
+  return keys_;
+}
+
+NarrowKeysOperator::NarrowKeysOperator(std::shared_ptr<core::CoreResourceManager> core,
+                                       const embedding::EmbeddingCollectionParam& ebc_param)
+    : batch_size_per_gpu_(ebc_param.universal_batch_size / core->get_global_gpu_count()),
+      num_lookup_(ebc_param.num_lookup) {
+  CudaDeviceContext ctx(core->get_device_id());
+  HCTR_CHECK_HINT(ebc_param.key_type.size() == sizeof(uint32_t) &&
+                      ebc_param.offset_type.size() == sizeof(uint32_t),
+                  "NarrowKeysOperator requires 32-bit keys and offsets");
+
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::BufferParams buffer_params;
+  buffer_params.unitary = false;
+  core23::TensorParams params = core23::TensorParams().device(device).buffer_params(buffer_params);
+
+  std::vector<int> h_hotness;
+  std::vector<void*> h_output_ptrs(2 * num_lookup_);
+  for (int lookup_id = 0; lookup_id < num_lookup_; ++lookup_id) {
+    const int hotness = ebc_param.lookup_params[lookup_id].max_hotness;
+    h_hotness.push_back(hotness);
+    max_hotness_ = std::max(max_hotness_, hotness);
+    keys_.emplace_back(params.shape({static_cast<int64_t>(batch_size_per_gpu_) * hotness})
+                           .data_type(ebc_param.key_type));
+    bucket_ranges_.emplace_back(params.shape({static_cast<int64_t>(batch_size_per_gpu_) + 1})
+                                    .data_type(ebc_param.offset_type));
+    h_output_ptrs[lookup_id] = keys_.back().data();
+    h_output_ptrs[num_lookup_ + lookup_id] = bucket_ranges_.back().data();
+  }
+
+  hotness_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(num_lookup_)}).data_type(core23::ScalarType::Int32));
+  core23::copy_sync(hotness_, h_hotness);
+  d_output_ptrs_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(2 * num_lookup_)}).data_type(core23::ScalarType::Pointer));
+  core23::copy_sync(d_output_ptrs_, h_output_ptrs);
+  d_input_ptrs_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(2 * num_lookup_)}).data_type(core23::ScalarType::Pointer));
+  h_input_ptrs_ = core23::Tensor(core23::TensorParams()
+                                     .device(core23::DeviceType::CPU)
+                                     .shape({static_cast<int64_t>(2 * num_lookup_)})
+                                     .data_type(core23::ScalarType::Pointer));
+}
+
+void NarrowKeysOperator::operator()(const std::vector<core23::Tensor>& keys,
+                                    const std::vector<core23::Tensor>& bucket_ranges,
+                                    cudaStream_t stream) {
+  HCTR_CHECK_HINT(static_cast<int>(keys.size()) == num_lookup_,
+                  "The data reader must return the keys of each lookup");
+  has_bucket_ranges_ = !bucket_ranges.empty();
+  HCTR_CHECK_HINT(!has_bucket_ranges_ || bucket_ranges.size() == keys.size(),
+                  "The data reader must return a bucket range for each lookup");
+  void** h_ptrs = h_input_ptrs_.data<void*>();
+  for (int lookup_id = 0; lookup_id < num_lookup_; ++lookup_id) {
+    HCTR_CHECK_HINT(keys[lookup_id].data_type().size() == sizeof(int64_t),
+                    "32-bit keys of the collection require 64-bit input keys");
+    h_ptrs[lookup_id] = keys[lookup_id].data();
+    h_ptrs[num_lookup_ + lookup_id] =
+        has_bucket_ranges_ ? bucket_ranges[lookup_id].data() : nullptr;
+  }
+  core23::copy_async(d_input_ptrs_, h_input_ptrs_, stream);
+
+  dim3 block(256);
+  dim3 grid(std::min<unsigned int>((batch_size_per_gpu_ * max_hotness_ + block.x - 1) / block.x,
+                                    1024),
+            num_lookup_);
+  kernels::narrow_keys_and_bucket_ranges<<<grid, block, 0, stream>>>(
+      (const int64_t**)d_input_ptrs_.data(), (uint32_t**)d_output_ptrs_.data(),
+      hotness_.data<int>(), num_lookup_, batch_size_per_gpu_, has_bucket_ranges_);
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
 ConcatKeysAndBucketRangeOperator::ConcatKeysAndBucketRangeOperator(
     std::shared_ptr<core::CoreResourceManager> core,
     const embedding::EmbeddingCollectionParam& ebc_param, size_t grouped_id)
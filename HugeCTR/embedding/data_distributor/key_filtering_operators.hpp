@@ -17,6 +17,8 @@
 
 #include <core/core.hpp>
 #include <embedding/common.hpp>
+#include <embedding/operators/perfect_hash.hpp>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -32,6 +34,10 @@ class ComputeDPBucketRangeOperator {
   void operator()(std::vector<core23::Tensor> dp_bucket_ranges, core23::Tensor keys_per_bucket,
                   int current_batch_size, cudaStream_t stream);
 
+  // Counts the keys of each bucket of ranges given by the data reader, e.g. for variable hotness.
+  void count_keys_per_bucket(const std::vector<core23::Tensor>& dp_bucket_ranges,
+                             core23::Tensor keys_per_bucket, cudaStream_t stream);
+
  private:
   core23::Tensor h_ptrs_;
   core23::Tensor d_ptrs_;
@@ -41,6 +47,136 @@ class ComputeDPBucketRangeOperator {
   core23::Tensor max_hotnesses_;
 };
 
+/**
+ * Selects either the frequent or the infrequent keys of the lookups in a group whose tables have
+ * frequent keys. Frequent keys are replaced by their index in the replicated rows of all frequent
+ * tables. The keys and bucket ranges of the other lookups are forwarded unchanged.
+ */
+class FrequentKeysFilterOperator {
+ public:
+  FrequentKeysFilterOperator(std::shared_ptr<core::CoreResourceManager> core,
+                             const embedding::EmbeddingCollectionParam &ebc_param,
+                             size_t grouped_id, bool keep_frequent);
+
+  const DataDistributionInput &operator()(const DataDistributionInput &input, cudaStream_t stream);
+
+ private:
+  bool keep_frequent_;
+  int batch_size_per_gpu_ = 0;
+  std::vector<int> h_filtered_ids_;  // per lookup, -1 if its keys are forwarded unchanged
+  int num_filtered_ = 0;
+
+  core23::Tensor filtered_lookup_ids_;   // int
+  core23::Tensor filtered_table_ids_;    // int
+  core23::Tensor frequent_key_offsets_;  // uint64_t, range of each table in frequent_keys_
+  core23::Tensor frequent_keys_;         // key_type, sorted keys of all frequent tables
+  core23::Tensor keys_per_bucket_;       // offset_type
+  core23::Tensor flat_bucket_range_;     // offset_type
+  core23::Tensor temp_scan_storage_;
+
+  std::vector<core23::Tensor> keys_;           // per filtered lookup
+  std::vector<core23::Tensor> bucket_ranges_;  // per filtered lookup
+  DataDistributionInput output_;
+};
+
+/**
+ * Replaces the keys of the lookups of tables with a static vocabulary by their row, from the
+ * minimal perfect hash of each vocabulary in device memory. Keys outside of the vocabulary are
+ * replaced by the size of the vocabulary. The keys of the other lookups and all bucket ranges are
+ * forwarded unchanged.
+ */
+class VocabularyRemapOperator {
+ public:
+  VocabularyRemapOperator(std::shared_ptr<core::CoreResourceManager> core,
+                          const embedding::EmbeddingCollectionParam &ebc_param,
+                          const std::map<int, embedding::PerfectHash> &perfect_hashes);
+
+  const DataDistributionInput &operator()(const DataDistributionInput &input, cudaStream_t stream);
+
+ private:
+  int batch_size_per_gpu_ = 0;
+  std::vector<int> h_remapped_ids_;  // per lookup, -1 if its keys are forwarded unchanged
+  int num_remapped_ = 0;
+
+  core23::Tensor remapped_lookup_ids_;  // int
+  core23::Tensor vocabulary_ids_;       // int, index of the hash of each remapped lookup
+  core23::Tensor hash_params_;          // PerfectHashParams of each table, as uint64_t
+  core23::Tensor pilots_;               // uint32_t, of all tables
+  core23::Tensor slot_keys_;            // uint64_t, of all tables
+  core23::Tensor slot_rows_;            // uint32_t, of all tables
+
+  std::vector<core23::Tensor> keys_;  // per remapped lookup
+  DataDistributionInput output_;
+};
+
+/**
+ * Computes the keys of the virtual features, which hash or cross the input features of the data
+ * reader, and returns the keys of all lookups in their order. The keys of the other lookups are
+ * the ones of their input feature. The input features have a fixed hotness, so that the keys of a
+ * virtual feature are dense as well, with the product of the hotness of its inputs per sample.
+ */
+class FeatureTransformOperator {
+ public:
+  FeatureTransformOperator(std::shared_ptr<core::CoreResourceManager> core,
+                           const embedding::EmbeddingCollectionParam &ebc_param);
+
+  const std::vector<core23::Tensor> &operator()(const std::vector<core23::Tensor> &input_keys,
+                                                cudaStream_t stream);
+
+ private:
+  int batch_size_per_gpu_ = 0;
+  int num_input_features_ = 0;
+  int max_hotness_ = 0;
+  core23::DataType key_type_;  // of the input features
+  std::vector<int> lookup_input_feature_ids_;
+  std::vector<embedding::VirtualFeatureParam> virtual_features_;
+
+  // Pointers to the keys of each input feature, and of each virtual feature.
+  core23::Tensor h_input_ptrs_;
+  core23::Tensor d_input_ptrs_;
+  core23::Tensor d_virtual_ptrs_;
+  core23::Tensor feature_params_;  // of each virtual feature, as uint64_t
+
+  std::vector<core23::Tensor> virtual_keys_;  // per virtual feature
+  std::vector<core23::Tensor> keys_;          // per lookup
+};
+
+/**
+ * Converts the 64-bit keys and bucket ranges of the data reader to the 32-bit key and offset types
+ * of a collection whose keys are rows that fit into 32 bits. The data distribution, the all-to-all
+ * and the index calculation then move and sort half of the bytes.
+ */
+class NarrowKeysOperator {
+ public:
+  NarrowKeysOperator(std::shared_ptr<core::CoreResourceManager> core,
+                     const embedding::EmbeddingCollectionParam &ebc_param);
+
+  // The bucket ranges are empty if those of the data reader are.
+  void operator()(const std::vector<core23::Tensor> &keys,
+                  const std::vector<core23::Tensor> &bucket_ranges, cudaStream_t stream);
+
+  const std::vector<core23::Tensor> &keys() const { return keys_; }
+  const std::vector<core23::Tensor> &bucket_ranges() const {
+    return has_bucket_ranges_ ? bucket_ranges_ : no_bucket_ranges_;
+  }
+
+ private:
+  int batch_size_per_gpu_ = 0;
+  int num_lookup_ = 0;
+  int max_hotness_ = 0;
+  bool has_bucket_ranges_ = false;
+
+  // Pointers to the keys and bucket ranges of each lookup, of the data reader and converted.
+  core23::Tensor h_input_ptrs_;
+  core23::Tensor d_input_ptrs_;
+  core23::Tensor d_output_ptrs_;
+  core23::Tensor hotness_;  // int
+
+  std::vector<core23::Tensor> keys_;           // uint32_t, per lookup
+  std::vector<core23::Tensor> bucket_ranges_;  // uint32_t, per lookup
+  std::vector<core23::Tensor> no_bucket_ranges_;
+};
+
 namespace mp {
 
 class LabelAndCountKeysOperator {
@@ -31,6 +31,13 @@ SparseDPDataDistributionOp::SparseDPDataDistributionOp(
       ebc_param_(ebc_param),
       batch_size_per_gpu_(ebc_param.universal_batch_size / core->get_global_gpu_count()),
       concat_keys_and_bucket_range_operator_(core, ebc_param, group_id) {
+  if (ebc_param_.grouped_lookup_params[group_id].embedding_type ==
+      embedding::EmbeddingType::FrequentSparse) {
+    // The frequent keys are replaced by the indices of their replicated rows.
+    frequent_keys_filter_ =
+        std::make_unique<FrequentKeysFilterOperator>(core, ebc_param, group_id, true);
+    return;
+  }
   if (ebc_param_.keys_preprocess_strategy_ == embedding::KeysPreprocessStrategy::AddOffset) {
     indices_converter_ = std::make_unique<embedding::KeysToIndicesConverter>(
         core, emb_table_param_list, ebc_param_, group_id);
@@ -62,7 +69,9 @@ void SparseDPDataDistributionOp::distribute(const DataDistributionInput& input,
                                             embedding::EmbeddingInput& output,
                                             cudaStream_t stream) {
   // --- copy DP keys and sparse_forward DP bucket range
-  concat_keys_and_bucket_range_operator_(input, output.keys, output.bucket_range, stream);
+  concat_keys_and_bucket_range_operator_(
+      frequent_keys_filter_ ? (*frequent_keys_filter_)(input, stream) : input, output.keys,
+      output.bucket_range, stream);
 
   DISPATCH_INTEGRAL_FUNCTION_CORE23(ebc_param_.offset_type.type(), BucketRangeType, [&] {
     BucketRangeType num_keys = 0;
@@ -78,7 +87,9 @@ void SparseDPDataDistributionOp::distribute(const DataDistributionInput& input,
 }
 
 void SparseDPDataDistributionOp::convert_indices(embedding::EmbeddingInput& output) {
-  if (ebc_param_.keys_preprocess_strategy_ == embedding::KeysPreprocessStrategy::None) return;
+  if (ebc_param_.keys_preprocess_strategy_ == embedding::KeysPreprocessStrategy::None ||
+      frequent_keys_filter_)
+    return;
   core23::Tensor num_keys_per_lookup_offset;
   compress_offset_->compute(output.bucket_range, batch_size_per_gpu_, &num_keys_per_lookup_offset);
 
@@ -184,6 +195,14 @@ SparseMPDataDistributionOp::SparseMPDataDistributionOp(
   sparse_temp_storage_ = MPTempStorage(core, ebc_param_.universal_batch_size, sample_max_nnz_,
                                        max_local_features, max_local_buckets, max_buckets_in_group,
                                        ebc_param_.key_type, ebc_param_.offset_type);
+  for (int lookup_id = 0; lookup_id < ebc_param_.num_lookup; ++lookup_id) {
+    if (ebc_param_.lookup_id_in_group(group_id, lookup_id) &&
+        ebc_param_.get_frequent_table_index(ebc_param_.lookup_params[lookup_id].table_id) >= 0) {
+      frequent_keys_filter_ =
+          std::make_unique<FrequentKeysFilterOperator>(core, ebc_param_, group_id, false);
+      break;
+    }
+  }
   if (ebc_param_.keys_preprocess_strategy_ == embedding::KeysPreprocessStrategy::AddOffset) {
     indices_converter_ = std::make_unique<embedding::KeysToIndicesConverter>(
         core, emb_table_param_list, ebc_param_, group_id);
@@ -225,7 +244,9 @@ void SparseMPDataDistributionOp::filter_before_all2all(const DataDistributionInp
                                                        embedding::EmbeddingInput& output,
                                                        cudaStream_t stream) {
   // --- Label keys for sort, and count keys per bucket & GPU ---
-  label_and_count_keys_operator_(input, label_and_count_keys_output_, stream);
+  label_and_count_keys_operator_(
+      frequent_keys_filter_ ? (*frequent_keys_filter_)(input, stream) : input,
+      label_and_count_keys_output_, stream);
 }
 
 void SparseMPDataDistributionOp::all2all_keys_per_bucket(embedding::EmbeddingInput& output,
@@ -50,7 +50,8 @@ UniformDataParallelEmbeddingMeta::UniformDataParallelEmbeddingMeta(
     h_ev_size_list_.push_back(ev_size);
     h_combiner_list_.push_back(combiner);
     if (!ebc_param.lookup_id_in_group(grouped_id, lookup_id)) continue;
-    HCTR_CHECK_HINT(ebc_param.shard_matrix[gpu_id][table_id] == 1,
+    HCTR_CHECK_HINT(group_params.embedding_type == EmbeddingType::FrequentSparse ||
+                        ebc_param.shard_matrix[gpu_id][table_id] == 1,
                     "dp table must be shared on all gpus");
     h_local_combiner_list_.push_back(combiner);
     h_local_lookup_id_list_.push_back(lookup_id);
@@ -117,7 +118,8 @@ void UniformDataParallelEmbeddingMeta::update_mutable_meta(
 
     h_hotness_list_.push_back(max_hotness);
     if (!ebc_param.lookup_id_in_group(grouped_id, lookup_id)) continue;
-    HCTR_CHECK_HINT(ebc_param.shard_matrix[gpu_id][table_id] == 1,
+    HCTR_CHECK_HINT(group_params.embedding_type == EmbeddingType::FrequentSparse ||
+                        ebc_param.shard_matrix[gpu_id][table_id] == 1,
                     "dp table must be shared on all gpus");
     h_local_hotness_list_.push_back(max_hotness);
   }
@@ -129,7 +131,10 @@ void UniformDataParallelEmbeddingMeta::update_mutable_meta(
 
 UniformDPEmbedding::UniformDPEmbedding(std::shared_ptr<CoreResourceManager> core,
                                        const EmbeddingCollectionParam& params, size_t grouped_id)
-    : core_(core), meta_(core, params, grouped_id) {
+    : core_(core),
+      meta_(core, params, grouped_id),
+      frequent_(params.grouped_lookup_params[grouped_id].embedding_type ==
+                EmbeddingType::FrequentSparse) {
   HugeCTR::CudaDeviceContext context(core->get_device_id());
 
   int num_gpus = core->get_global_gpu_count();
@@ -140,6 +145,7 @@ UniformDPEmbedding::UniformDPEmbedding(std::shared_ptr<CoreResourceManager> core
 
   // init op
   compress_offset_ = CompressOffset(core_, meta_.num_local_lookup_ + 1, offset_type);
+  prefetch_compress_offset_ = CompressOffset(core_, meta_.num_local_lookup_ + 1, offset_type);
 
   dp_model_forward_ = DPModelForward(core_);
 
@@ -185,6 +191,15 @@ UniformDPEmbedding::UniformDPEmbedding(std::shared_ptr<CoreResourceManager> core
                                        meta_.wgrad_attr.num_table,
                                        key_type};
     sort_op = segmented_sort;
+  } else if (params.sort_strategy_ == SortStrategy::Hash) {
+    HashGroupKeys hash_group_keys{core,
+                                  meta_.wgrad_attr.sorted_table_ids,
+                                  meta_.num_local_hotness_,
+                                  params.universal_batch_size / num_gpus,
+                                  meta_.wgrad_attr.num_lookup,
+                                  meta_.wgrad_attr.num_table,
+                                  key_type};
+    sort_op = hash_group_keys;
   } else {
     HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "sort strategy not supported.");
   }
@@ -195,7 +210,12 @@ UniformDPEmbedding::UniformDPEmbedding(std::shared_ptr<CoreResourceManager> core
         core, local_reduce_index_calculation, sort_op, cal_dst_ids, segmented_unique};
   } else if (params.allreduce_strategy_ == AllreduceStrategy::Sparse) {
     SparseAllreduceCalEVStartIndicesStorage sparse_allreduce_storage{
-        core, meta_.num_local_hotness_, params.universal_batch_size / num_gpus, key_type};
+        core, params, grouped_id, meta_.wgrad_attr, meta_.num_local_hotness_,
+        params.universal_batch_size / num_gpus, key_type};
+    // The local reduce writes the wgrads in the order in which they are sent to their owners.
+    WgradInitializer{core, params, grouped_id, meta_.wgrad_attr}
+        .init(local_reduce_buffer_)
+        .init_data();
     local_reduce_index_calculation_.sparse_allreduce_index_calculation = {
         core,
         local_reduce_index_calculation,
@@ -207,15 +227,16 @@ UniformDPEmbedding::UniformDPEmbedding(std::shared_ptr<CoreResourceManager> core
     HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "allreduce strategy not supported.");
   }
   local_reduce_.init(core, meta_.max_ev_size_,
-                     meta_.num_local_hotness_ * (params.universal_batch_size / num_gpus));
+                     meta_.num_local_hotness_ * (params.universal_batch_size / num_gpus),
+                     params.is_deterministic(grouped_id));
 }
 
 void UniformDPEmbedding::backward_index_calculation(const EmbeddingInput& embedding_input,
                                                     Wgrad& wgrad, int batch_size) {
   int num_gpus = core_->get_global_gpu_count();
-  local_reduce_buffer_.data = wgrad.data;
   if (meta_.allreduce_strategy_ == AllreduceStrategy::Dense ||
       meta_.allreduce_strategy_ == AllreduceStrategy::GroupDense) {
+    local_reduce_buffer_.data = wgrad.data;
     local_reduce_index_calculation_.dense_allreduce_index_calculation.cal_for_sparse_indices(
         embedding_input, wgrad.ev_start_indices, reduction_indices_, local_reduce_buffer_,
         batch_size / num_gpus);
@@ -243,23 +264,44 @@ void UniformDPEmbedding::forward(const EmbeddingInput& embedding_input, ILookup*
                                    batch_size_per_gpu);
 }
 
+void UniformDPEmbedding::frequent_forward(const EmbeddingInput& embedding_input,
+                                          ILookup* embedding_table,
+                                          EmbeddingOutput& embedding_output, int batch_size) {
+  int batch_size_per_gpu = batch_size / core_->get_global_gpu_count();
+
+  core23::Tensor num_key_per_lookup_offset;
+  compress_offset_.compute(embedding_input.bucket_range, batch_size_per_gpu,
+                           &num_key_per_lookup_offset);
+
+  embedding_table->lookup(embedding_input.keys, embedding_input.h_num_keys,
+                          num_key_per_lookup_offset, meta_.num_local_lookup_ + 1,
+                          meta_.d_local_table_id_list_, embedding_vec_);
+  dp_model_forward_.sparse_forward_accumulate(
+      embedding_vec_, embedding_input.bucket_range, embedding_input.num_keys_per_bucket,
+      meta_.d_local_lookup_id_list_, embedding_output, batch_size_per_gpu);
+}
+
+void UniformDPEmbedding::prefetch(const EmbeddingInput& embedding_input, ILookup* embedding_table,
+                                  int batch_size) {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  int batch_size_per_gpu = batch_size / core_->get_global_gpu_count();
+
+  core23::Tensor num_key_per_lookup_offset;
+  prefetch_compress_offset_.compute(embedding_input.bucket_range, batch_size_per_gpu,
+                                    &num_key_per_lookup_offset);
+
+  embedding_table->prefetch(embedding_input.keys, embedding_input.h_num_keys,
+                            num_key_per_lookup_offset, meta_.num_local_lookup_ + 1,
+                            meta_.d_local_table_id_list_);
+}
+
 void UniformDPEmbedding::dense_allreduce(embedding::Wgrad& wgrad, int batch_size) {
   allreduce_comm_.communicate(wgrad.data, wgrad.data.num_elements());
 }
 
 void UniformDPEmbedding::sparse_allreduce(embedding::Wgrad& wgrad, int batch_size) {
-  cudaStream_t stream = core_->get_local_gpu()->get_stream();
-  size_t h_num_unique_keys = 0ul;
-  HCTR_LIB_THROW(cudaMemcpyAsync(&h_num_unique_keys, wgrad.num_unique_keys.data<uint64_t>(),
-                                 sizeof(size_t), cudaMemcpyDeviceToHost, stream));
-  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
-
-  uint32_t num_ev_elements;
-  HCTR_LIB_THROW(cudaMemcpyAsync(&num_ev_elements,
-                                 wgrad.ev_start_indices.data<uint32_t>() + h_num_unique_keys,
-                                 sizeof(uint32_t), cudaMemcpyDeviceToHost, stream));
-  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
-  allreduce_comm_.communicate(wgrad.data, num_ev_elements);
+  local_reduce_index_calculation_.sparse_allreduce_index_calculation.reduce_scatter_and_allgather(
+      local_reduce_buffer_, wgrad);
 }
 
 void UniformDPEmbedding::local_reduce(const EmbeddingOutput& top_grad,
@@ -296,6 +338,9 @@ void UniformDPEmbedding::forward_per_gpu(Stage stage, const EmbeddingInput& embe
     case Stage::DPForward: {
       forward(embedding_input, embedding_table, embedding_output, batch_size);
     } break;
+    case Stage::DPFrequentForward: {
+      frequent_forward(embedding_input, embedding_table, embedding_output, batch_size);
+    } break;
     default:
       HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
                      "stage is not supported in UniformDPEmbedding::forward_per_gpu");
@@ -329,8 +374,10 @@ void UniformDPEmbedding::backward_per_gpu(Stage stage, const EmbeddingInput& emb
 }
 
 bool UniformDPEmbedding::is_valid_stage(Stage stage) const {
-  return (stage == Stage::DPForward) || (stage == Stage::DPBackwardIndexCalculation) ||
-         (stage == Stage::DPLocalReduce) || (stage == Stage::DPAllreduce);
+  // The frequent keys are looked up after the model parallel output, which they are added to.
+  return (stage == (frequent_ ? Stage::DPFrequentForward : Stage::DPForward)) ||
+         (stage == Stage::DPBackwardIndexCalculation) || (stage == Stage::DPLocalReduce) ||
+         (stage == Stage::DPAllreduce);
 }
 
 }  // namespace embedding
@@ -73,6 +73,9 @@ class UniformDPEmbedding : public IGroupedEmbeddingOp {
   Wgrad local_reduce_buffer_;
 
   CompressOffset compress_offset_;
+  // The prefetch of the next batch may overlap the forward of the current one, so it has its own
+  // offsets.
+  CompressOffset prefetch_compress_offset_;
   DPModelForward dp_model_forward_;
   AverageCombiner average_combiner_;
 
@@ -80,9 +83,16 @@ class UniformDPEmbedding : public IGroupedEmbeddingOp {
 
   core23::Tensor embedding_vec_;
 
+  // Whether this embedding looks up the replicated rows of the frequent keys of model parallel
+  // tables.
+  bool frequent_;
+
   void forward(const EmbeddingInput &embedding_input, ILookup *embedding_table,
                EmbeddingOutput &embedding_output, int batch_size);
 
+  void frequent_forward(const EmbeddingInput &embedding_input, ILookup *embedding_table,
+                        EmbeddingOutput &embedding_output, int batch_size);
+
   void backward_index_calculation(const EmbeddingInput &embedding_input, Wgrad &wgrad,
                                   int batch_size);
 
@@ -103,6 +113,9 @@ class UniformDPEmbedding : public IGroupedEmbeddingOp {
   void backward_per_gpu(Stage stage, const EmbeddingInput &embedding_input,
                         const EmbeddingOutput &top_grad, Wgrad &wgrad, int batch_size) override;
 
+  void prefetch(const EmbeddingInput &embedding_input, ILookup *embedding_table,
+                int batch_size) override;
+
   const WgradAttr &get_wgrad_attr() const override { return meta_.wgrad_attr; }
 
   bool is_valid_stage(Stage stage) const override;
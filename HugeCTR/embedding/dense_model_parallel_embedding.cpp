@@ -55,6 +55,7 @@ DenseUniformModelParallelEmbeddingMeta::DenseUniformModelParallelEmbeddingMeta(
   std::vector<int> ev_length_in_output_buffer;
   std::vector<int> h_local_table_id_list;
   std::vector<int> h_ev_size_list;
+  std::vector<char> h_local_combiner_list;
 
   for (int lookup_id = 0; lookup_id < num_lookup_; ++lookup_id) {
     if (std::find(ebc_param.grouped_lookup_params[grouped_id].lookup_ids.begin(),
@@ -69,16 +70,19 @@ DenseUniformModelParallelEmbeddingMeta::DenseUniformModelParallelEmbeddingMeta(
       local_id_in_output_buffer++;
       continue;
     }
+    // Sum and average lookups of deduplicated tables are pooled into a single output vector.
+    int output_hotness = lookup_params[lookup_id].combiner == Combiner::Concat
+                             ? lookup_params[lookup_id].max_hotness
+                             : 1;
     this->num_local_hotness_ += lookup_params[lookup_id].max_hotness;
-    this->global_hotness_ += lookup_params[lookup_id].max_hotness;
+    this->global_hotness_ += output_hotness;
     this->h_local_hotness_range_.push_back(lookup_params[lookup_id].max_hotness);
     this->h_local_hotness_.push_back(lookup_params[lookup_id].max_hotness);
-    this->global_ev_offset_ +=
-        (lookup_params[lookup_id].max_hotness * lookup_params[lookup_id].ev_size);
+    this->global_ev_offset_ += (output_hotness * lookup_params[lookup_id].ev_size);
     h_ev_size_list.push_back(lookup_params[lookup_id].ev_size);
+    h_local_combiner_list.push_back(static_cast<char>(lookup_params[lookup_id].combiner));
 
-    ev_length_in_output_buffer.push_back(lookup_params[lookup_id].max_hotness *
-                                         lookup_params[lookup_id].ev_size);
+    ev_length_in_output_buffer.push_back(output_hotness * lookup_params[lookup_id].ev_size);
 
     lookup_ids_in_embedding.push_back(local_id_in_output_buffer);
     local_id_in_output_buffer++;
@@ -115,6 +119,19 @@ DenseUniformModelParallelEmbeddingMeta::DenseUniformModelParallelEmbeddingMeta(
   model_buffer_attr.init(core, ebc_param, grouped_id);
   network_indices.init(core, this->h_local_hotness_range_, this->h_local_hotness_,
                        this->h_ev_start_indices_, this->num_local_lookup_, this->global_ev_offset_);
+  if (std::any_of(h_local_combiner_list.begin(), h_local_combiner_list.end(),
+                  [](char c) { return c != static_cast<char>(Combiner::Concat); })) {
+    HCTR_CHECK_HINT(std::all_of(h_local_combiner_list.begin(), h_local_combiner_list.end(),
+                                [](char c) { return c != static_cast<char>(Combiner::Concat); }),
+                    "Dense lookups can not mix concat and pooled combiners.");
+    network_indices.init_pooling(core, h_local_combiner_list,
+                                 ebc_param.universal_batch_size / static_cast<int>(num_gpus));
+  }
+  if (ebc_param.is_deterministic(grouped_id)) {
+    network_indices.init_deterministic(core, this->ev_size_,
+                                       static_cast<size_t>(this->num_local_hotness_) *
+                                           ebc_param.universal_batch_size);
+  }
   network_buffer_attr.init(core, ebc_param, grouped_id, this->num_local_hotness_);
   wgrad_attr.init(core, ebc_param, grouped_id);
 }
@@ -132,7 +149,8 @@ DenseUniformModelParallelEmbedding::DenseUniformModelParallelEmbedding(
 
   local_reduce_index_calculation_.init(core);
 
-  local_reduce_.init(core, meta_.ev_size_, meta_.num_local_hotness_ * params.universal_batch_size);
+  local_reduce_.init(core, meta_.ev_size_, meta_.num_local_hotness_ * params.universal_batch_size,
+                     params.is_deterministic(grouped_id));
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
   core23::TensorParams tensor_params = core23::TensorParams().device(device);
 
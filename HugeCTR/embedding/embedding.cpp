@@ -33,7 +33,8 @@ std::vector<std::unique_ptr<IGroupedEmbeddingOp>> create_grouped_embeddings(
     if (embedding_type == EmbeddingType::Dense && tps == TablePlacementStrategy::ModelParallel) {
       embeddings.push_back(
           std::make_unique<DenseUniformModelParallelEmbedding>(core, ebc_param, emb_id));
-    } else if (embedding_type == EmbeddingType::Sparse &&
+    } else if ((embedding_type == EmbeddingType::Sparse ||
+                embedding_type == EmbeddingType::FrequentSparse) &&
                tps == TablePlacementStrategy::DataParallel) {
       embeddings.push_back(std::make_unique<UniformDPEmbedding>(core, ebc_param, emb_id));
     } else if (embedding_type == EmbeddingType::Sparse &&
@@ -44,6 +45,11 @@ std::vector<std::unique_ptr<IGroupedEmbeddingOp>> create_grouped_embeddings(
     } else if (embedding_type == EmbeddingType::Sparse &&
                tps == TablePlacementStrategy::ModelParallel &&
                comm_strategy == CommunicationStrategy::Hierarchical) {
+      int grouped_table_id = ebc_param.grouped_lookup_params[emb_id].grouped_table_idx;
+      HCTR_CHECK_HINT(ebc_param.grouped_table_params[grouped_table_id].column_shard_id < 0,
+                      "hierarchical communication does not support column-wise sharding.");
+      HCTR_CHECK_HINT(ebc_param.comm_quantization_strategy_ == CommQuantizationStrategy::Disabled,
+                      "hierarchical communication does not support all-to-all quantization.");
       embeddings.push_back(std::make_unique<HierModelParallelEmbedding>(core, ebc_param, emb_id));
     } else {
       HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError, "grouped embedding create fail.");
@@ -25,6 +25,8 @@ enum class Stage {
   DPBackwardIndexCalculation,
   DPLocalReduce,
   DPAllreduce,
+  // Adds the lookups of the frequent keys of model parallel tables to the output of their shards.
+  DPFrequentForward,
 
   DenseDPForward,
   DenseDPBackwardIndexCalculation,
@@ -50,6 +52,8 @@ enum class Stage {
   DenseMPLocalReduce,
 };
 
+struct UnreducedWgrad;
+
 class IGroupedEmbeddingOp {
  public:
   virtual ~IGroupedEmbeddingOp() = default;
@@ -61,9 +65,25 @@ class IGroupedEmbeddingOp {
   virtual void backward_per_gpu(Stage stage, const EmbeddingInput &embedding_input,
                                 const EmbeddingOutput &top_grad, Wgrad &wgrad, int batch_size) = 0;
 
+  // Passes the keys of embedding_input, which a following forward will look up, to the prefetch of
+  // embedding_table. It runs on the current stream, and may overlap the work of the previous batch.
+  virtual void prefetch(const EmbeddingInput &embedding_input, ILookup *embedding_table,
+                        int batch_size) {}
+
   virtual const WgradAttr &get_wgrad_attr() const = 0;
 
+  // Skips the reduction of the wgrad in the local reduce stage, for tables which reduce the wgrad
+  // returned by get_unreduced_wgrad() in their update. Ops which do not support it ignore the call,
+  // and return nullptr from get_unreduced_wgrad().
+  virtual void enable_fused_update() {}
+
+  virtual const UnreducedWgrad *get_unreduced_wgrad() const { return nullptr; }
+
   virtual bool is_valid_stage(Stage stage) const = 0;
+
+  // Whether the stage only launches work whose sizes are fixed by the batch size, without reading
+  // counts back to the host, so that it can be captured into a CUDA graph.
+  virtual bool is_graph_capturable_stage(Stage stage) const { return false; }
 };
 
 std::vector<std::unique_ptr<IGroupedEmbeddingOp>> create_grouped_embeddings(
@@ -26,6 +26,13 @@ class ILookup {
   virtual void lookup(const core23::Tensor &keys, size_t num_keys,
                       const core23::Tensor &num_keys_per_table_offset, size_t num_table_offset,
                       const core23::Tensor &table_id_list, core23::Tensor &embedding_vec) = 0;
+
+  // Prepares the rows of keys, which a following lookup will access, e.g. by moving them closer to
+  // the gpu or inserting them, so that the lookup does not wait for them. It takes the arguments
+  // of lookup, and runs on the current stream of the core.
+  virtual void prefetch(const core23::Tensor &keys, size_t num_keys,
+                        const core23::Tensor &num_keys_per_table_offset, size_t num_table_offset,
+                        const core23::Tensor &table_id_list) {}
 };
 
 }  // namespace embedding
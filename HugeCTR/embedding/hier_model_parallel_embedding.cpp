@@ -139,6 +139,8 @@ HierModelParallelEmbedding::HierModelParallelEmbedding(std::shared_ptr<CoreResou
   auto key_type = params.key_type;
 
   compress_offset_ = CompressOffset(core, meta_.num_local_lookup_ + 1, params.offset_type);
+  prefetch_compress_offset_ =
+      CompressOffset(core, meta_.num_local_lookup_ + 1, params.offset_type);
   intra_model_forward_ = IntraModelForward{core};
   all2all_comm_ = NcclAll2AllComm(core);
   network_forward_ = NetworkForward(core);
@@ -164,6 +166,14 @@ HierModelParallelEmbedding::HierModelParallelEmbedding(std::shared_ptr<CoreResou
                                   meta_.wgrad_attr.num_lookup,
                                   meta_.wgrad_attr.num_table,
                                   key_type};
+  } else if (params.sort_strategy_ == SortStrategy::Hash) {
+    sort_op = HashGroupKeys{core,
+                            meta_.wgrad_attr.sorted_table_ids,
+                            meta_.num_local_hotness_,
+                            params.universal_batch_size,
+                            meta_.wgrad_attr.num_lookup,
+                            meta_.wgrad_attr.num_table,
+                            key_type};
   } else {
     HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "sort strategy not supported.");
   }
@@ -171,13 +181,49 @@ HierModelParallelEmbedding::HierModelParallelEmbedding(std::shared_ptr<CoreResou
                                        segmentd_unique, cal_dst_offset_mp);
 
   local_reduce_.init(core, meta_.output_attr.max_ev_size,
-                     meta_.num_local_hotness_ * params.universal_batch_size);
+                     meta_.num_local_hotness_ * params.universal_batch_size,
+                     params.is_deterministic(grouped_id));
 
   embedding_vec_ = core23::init_tensor_list<float>(
       params.universal_batch_size * meta_.num_local_hotness_, core->get_device_id());
 
   model_comm_buffer_.init(core, meta_.model_buffer_attr, params.universal_batch_size);
   network_buffer_.init(core, meta_.hier_network_buffer_attr, params.universal_batch_size);
+
+  int num_node = static_cast<int>(core->get_global_gpu_count() / core->get_local_gpu_count());
+  pipeline_hier_comm_ = num_node > 1;
+  comm_stream_ = nullptr;
+  comm_done_event_ = nullptr;
+  if (pipeline_hier_comm_) {
+    HCTR_LIB_THROW(cudaStreamCreateWithPriority(&comm_stream_, cudaStreamNonBlocking, -100));
+    reduction_done_events_.resize(num_node);
+    for (auto &event : reduction_done_events_) {
+      HCTR_LIB_THROW(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    }
+    HCTR_LIB_THROW(cudaEventCreateWithFlags(&comm_done_event_, cudaEventDisableTiming));
+  }
+}
+
+HierModelParallelEmbedding::~HierModelParallelEmbedding() {
+  if (!pipeline_hier_comm_) return;
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  for (auto &event : reduction_done_events_) {
+    cudaEventDestroy(event);
+  }
+  cudaEventDestroy(comm_done_event_);
+  cudaStreamDestroy(comm_stream_);
+}
+
+void HierModelParallelEmbedding::prefetch(const EmbeddingInput &embedding_input,
+                                          ILookup *embedding_table, int batch_size) {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  core23::Tensor num_key_per_lookup_offset;
+  prefetch_compress_offset_.compute(embedding_input.bucket_range, batch_size,
+                                    &num_key_per_lookup_offset);
+
+  embedding_table->prefetch(embedding_input.keys, embedding_input.h_num_keys,
+                            num_key_per_lookup_offset, meta_.num_local_lookup_ + 1,
+                            meta_.d_local_table_id_list_);
 }
 
 void HierModelParallelEmbedding::model_forward(const EmbeddingInput &embedding_input,
@@ -188,16 +234,50 @@ void HierModelParallelEmbedding::model_forward(const EmbeddingInput &embedding_i
   embedding_table->lookup(embedding_input.keys, embedding_input.h_num_keys,
                           num_key_per_lookup_offset, meta_.num_local_lookup_ + 1,
                           meta_.d_local_table_id_list_, embedding_vec_);
-  intra_model_forward_.intra_forward(embedding_vec_, embedding_input.bucket_range,
-                                     intra_model_comm_buffer_, batch_size);
-  gpu_barrier_->sync_all_gpus(core_->get_local_gpu()->get_stream(), core_->get_local_gpu_id());
-  intra_model_forward_.dst_reduction(intra_model_comm_buffer_, intra_reduction_buffer_, batch_size);
+  auto stream = core_->get_local_gpu()->get_stream();
+  if (!pipeline_hier_comm_) {
+    intra_model_forward_.intra_forward(embedding_vec_, embedding_input.bucket_range,
+                                       intra_model_comm_buffer_, batch_size);
+    gpu_barrier_->sync_all_gpus(stream, core_->get_local_gpu_id());
+    intra_model_forward_.dst_reduction(intra_model_comm_buffer_, intra_reduction_buffer_,
+                                       batch_size);
+    return;
+  }
+
+  // In step s, the samples of node (node_id + s) are gathered over NVLink and reduced, while the
+  // ones of the previous step are sent over IB. Nodes are visited in a ring, so that each node
+  // receives from a single node per step.
+  int num_local_gpus = static_cast<int>(core_->get_local_gpu_count());
+  int num_node = static_cast<int>(core_->get_global_gpu_count()) / num_local_gpus;
+  int node_id = static_cast<int>(core_->get_global_gpu_id()) / num_local_gpus;
+  for (int step = 0; step < num_node; ++step) {
+    int dst_node_id = (node_id + step) % num_node;
+    int src_node_id = (node_id - step + num_node) % num_node;
+
+    intra_model_forward_.intra_forward(embedding_vec_, embedding_input.bucket_range,
+                                       intra_model_comm_buffer_, batch_size, dst_node_id);
+    gpu_barrier_->sync_all_gpus(stream, core_->get_local_gpu_id());
+    intra_model_forward_.dst_reduction(intra_model_comm_buffer_, intra_reduction_buffer_,
+                                       batch_size, dst_node_id);
+
+    HCTR_LIB_THROW(cudaEventRecord(reduction_done_events_[step], stream));
+    HCTR_LIB_THROW(cudaStreamWaitEvent(comm_stream_, reduction_done_events_[step]));
+    all2all_comm_.hier_communicate(intra_reduction_buffer_.data_list[dst_node_id], dst_node_id,
+                                   network_buffer_.data_list[src_node_id], src_node_id,
+                                   comm_stream_);
+  }
+  HCTR_LIB_THROW(cudaEventRecord(comm_done_event_, comm_stream_));
 }
 
 void HierModelParallelEmbedding::network_forward(const EmbeddingInput &embedding_input,
                                                  EmbeddingOutput &embedding_output,
                                                  int batch_size) {
-  all2all_comm_.hier_communicate(intra_reduction_buffer_.data_list, network_buffer_.data_list);
+  if (pipeline_hier_comm_) {
+    // The all-to-all was issued along with the intra node reduction in model_forward.
+    HCTR_LIB_THROW(cudaStreamWaitEvent(core_->get_local_gpu()->get_stream(), comm_done_event_));
+  } else {
+    all2all_comm_.hier_communicate(intra_reduction_buffer_.data_list, network_buffer_.data_list);
+  }
   network_forward_.sparse_forward(embedding_input.num_keys_per_bucket, network_buffer_,
                                   meta_.hier_network_indices, embedding_output, batch_size);
 }
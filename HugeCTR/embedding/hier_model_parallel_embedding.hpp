@@ -63,6 +63,9 @@ class HierModelParallelEmbedding : public IGroupedEmbeddingOp {
   LocalReduce local_reduce_;
 
   CompressOffset compress_offset_;
+  // The prefetch of the next batch may overlap the forward of the current one, so it has its own
+  // offsets.
+  CompressOffset prefetch_compress_offset_;
   IntraModelForward intra_model_forward_;
   NcclAll2AllComm all2all_comm_;
   NetworkForward network_forward_;
@@ -79,6 +82,13 @@ class HierModelParallelEmbedding : public IGroupedEmbeddingOp {
 
   HugeCTR::GPUBarrier *gpu_barrier_;
 
+  // The intra node gather and reduction of the samples of each node is pipelined with the inter
+  // node transfer of the previous node, which runs on comm_stream_.
+  bool pipeline_hier_comm_;
+  cudaStream_t comm_stream_;
+  std::vector<cudaEvent_t> reduction_done_events_;
+  cudaEvent_t comm_done_event_;
+
   void model_forward(const EmbeddingInput &embedding_input, ILookup *embedding_table,
                      int batch_size);
 
@@ -97,12 +107,17 @@ class HierModelParallelEmbedding : public IGroupedEmbeddingOp {
   HierModelParallelEmbedding(std::shared_ptr<CoreResourceManager> core,
                              const EmbeddingCollectionParam &params, size_t grouped_id);
 
+  ~HierModelParallelEmbedding() override;
+
   void forward_per_gpu(Stage stage, const EmbeddingInput &embedding_input, ILookup *embedding_table,
                        EmbeddingOutput &embedding_output, int batch_size) override;
 
   void backward_per_gpu(Stage stage, const EmbeddingInput &embedding_input,
                         const EmbeddingOutput &top_grad, Wgrad &wgrad, int batch_size) override;
 
+  void prefetch(const EmbeddingInput &embedding_input, ILookup *embedding_table,
+                int batch_size) override;
+
   const WgradAttr &get_wgrad_attr() const override { return meta_.wgrad_attr; }
 
   bool is_valid_stage(Stage stage) const override;
@@ -57,7 +57,7 @@ UniformModelParallelEmbeddingMeta::UniformModelParallelEmbeddingMeta(
     h_local_num_shards_list_.push_back(num_shard);
     h_local_table_id_list_.push_back(table_id);
     h_local_lookup_id_list_.push_back(lookup_id);
-    h_local_ev_size_list_.push_back(ev_size);
+    h_local_ev_size_list_.push_back(ebc_param.get_local_ev_size(lookup_id));
   }
 
   std::partial_sum(h_ev_size_list_.begin(), h_ev_size_list_.end(),
@@ -170,10 +170,17 @@ UniformModelParallelEmbedding::UniformModelParallelEmbedding(
   auto key_type = params.key_type;
 
   compress_offset_ = CompressOffset(core, meta_.num_local_lookup_ + 1, params.offset_type);
+  prefetch_compress_offset_ =
+      CompressOffset(core, meta_.num_local_lookup_ + 1, params.offset_type);
   model_forward_ = ModelForward{core};
   all2all_comm_ = NcclAll2AllComm(core);
   network_forward_ = NetworkForward(core);
   network_backward_ = NetworkBackward(core);
+  use_comm_quantization_ = params.comm_quantization_strategy_ == CommQuantizationStrategy::FP8;
+  use_p2p_all2all_ = params.use_p2p_all2all_;
+  HCTR_CHECK_HINT(!use_p2p_all2all_ || !use_comm_quantization_,
+                  "P2P all-to-all does not support all-to-all quantization.");
+  comm_quantization_ = CommQuantization(core);
 
   reduction_indices_.init(core, meta_.num_local_hotness_, params.universal_batch_size, key_type);
   LocalReduceIndexCalculation local_reduce_index_calculation{
@@ -196,12 +203,23 @@ UniformModelParallelEmbedding::UniformModelParallelEmbedding(
                                        key_type};
     local_reduce_index_calculation_.init(core, local_reduce_index_calculation, segmented_sort,
                                          cal_dst_ids, segmented_unique, cal_dst_offset_mp);
+  } else if (params.sort_strategy_ == SortStrategy::Hash) {
+    HashGroupKeys hash_group_keys{core,
+                                  meta_.wgrad_attr.sorted_table_ids,
+                                  meta_.num_local_hotness_,
+                                  params.universal_batch_size,
+                                  meta_.wgrad_attr.num_lookup,
+                                  meta_.wgrad_attr.num_table,
+                                  key_type};
+    local_reduce_index_calculation_.init(core, local_reduce_index_calculation, hash_group_keys,
+                                         cal_dst_ids, segmented_unique, cal_dst_offset_mp);
   } else {
     HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "sort strategy not supported.");
   }
 
   local_reduce_.init(core, meta_.max_ev_size_,
-                     meta_.num_local_hotness_ * params.universal_batch_size);
+                     meta_.num_local_hotness_ * params.universal_batch_size,
+                     params.is_deterministic(grouped_id));
 
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
   core23::TensorParams tensor_params = core23::TensorParams().device(device);
@@ -211,6 +229,49 @@ UniformModelParallelEmbedding::UniformModelParallelEmbedding(
 
   model_comm_buffer_.init(core, meta_.model_buffer_attr, params.universal_batch_size);
   network_buffer_.init(core, meta_.network_buffer_attr, params.universal_batch_size);
+
+  if (use_comm_quantization_) {
+    int num_gpus = core->get_global_gpu_count();
+    QuantizedCommBufferAttr quantized_model_comm_buffer_attr;
+    quantized_model_comm_buffer_attr.init(
+        core, std::vector<std::vector<int>>(num_gpus, meta_.model_buffer_attr.h_id_to_ev_size));
+    quantized_model_comm_buffer_.init(core, quantized_model_comm_buffer_attr,
+                                      params.universal_batch_size);
+
+    std::vector<std::vector<int>> h_network_id_to_ev_size(num_gpus);
+    for (int ggpu_id = 0; ggpu_id < num_gpus; ++ggpu_id) {
+      for (int lookup_id : meta_.h_global_lookup_id_list_[ggpu_id]) {
+        h_network_id_to_ev_size[ggpu_id].push_back(params.get_local_ev_size(lookup_id));
+      }
+    }
+    QuantizedCommBufferAttr quantized_network_buffer_attr;
+    quantized_network_buffer_attr.init(core, h_network_id_to_ev_size);
+    quantized_network_buffer_.init(core, quantized_network_buffer_attr,
+                                   params.universal_batch_size);
+  }
+}
+
+void UniformModelParallelEmbedding::init_p2p_all2all(
+    const std::vector<UniformModelParallelEmbedding *> &embeddings,
+    HugeCTR::GPUBarrier *gpu_barrier) {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  int num_gpus = static_cast<int>(embeddings.size());
+  HCTR_CHECK_HINT(num_gpus == static_cast<int>(core_->get_global_gpu_count()),
+                  "P2P all-to-all requires the embeddings of all gpus of a single node.");
+  int gpu_id = core_->get_global_gpu_id();
+
+  std::vector<core23::Tensor> peer_network_buffer_list;
+  std::vector<core23::Tensor> peer_model_comm_buffer_list;
+  for (int peer_id = 0; peer_id < num_gpus; ++peer_id) {
+    peer_network_buffer_list.push_back(embeddings[peer_id]->network_buffer_.data_list[gpu_id]);
+    peer_model_comm_buffer_list.push_back(
+        embeddings[peer_id]->model_comm_buffer_.data_list[gpu_id]);
+  }
+  peer_network_buffer_.init_from_device_buffer(core_, peer_network_buffer_list,
+                                               meta_.model_buffer_attr);
+  peer_model_comm_buffer_.init_from_device_buffer(core_, peer_model_comm_buffer_list,
+                                                  meta_.network_buffer_attr);
+  gpu_barrier_ = gpu_barrier;
 }
 
 void UniformModelParallelEmbedding::model_forward(const EmbeddingInput &embedding_input,
@@ -221,14 +282,46 @@ void UniformModelParallelEmbedding::model_forward(const EmbeddingInput &embeddin
   embedding_table->lookup(embedding_input.keys, embedding_input.h_num_keys,
                           num_key_per_lookup_offset, meta_.num_local_lookup_ + 1,
                           meta_.d_local_table_id_list_, embedding_vec_);
+  if (use_p2p_all2all_) {
+    HCTR_CHECK_HINT(gpu_barrier_ != nullptr, "P2P all-to-all is not initialized.");
+    // The peers must be done with the network buffers of the previous iteration.
+    gpu_barrier_->sync_all_gpus(core_->get_local_gpu()->get_stream(), core_->get_local_gpu_id());
+    model_forward_.sparse_forward(embedding_vec_, embedding_input.bucket_range,
+                                  peer_network_buffer_, batch_size);
+    return;
+  }
   model_forward_.sparse_forward(embedding_vec_, embedding_input.bucket_range, model_comm_buffer_,
                                 batch_size);
 }
 
+void UniformModelParallelEmbedding::prefetch(const EmbeddingInput &embedding_input,
+                                             ILookup *embedding_table, int batch_size) {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  core23::Tensor num_key_per_lookup_offset;
+  prefetch_compress_offset_.compute(embedding_input.bucket_range, batch_size,
+                                    &num_key_per_lookup_offset);
+
+  embedding_table->prefetch(embedding_input.keys, embedding_input.h_num_keys,
+                            num_key_per_lookup_offset, meta_.num_local_lookup_ + 1,
+                            meta_.d_local_table_id_list_);
+}
+
 void UniformModelParallelEmbedding::network_forward(const EmbeddingInput &embedding_input,
                                                     EmbeddingOutput &embedding_output,
                                                     int batch_size) {
-  all2all_comm_.communicate(model_comm_buffer_.data_list, network_buffer_.data_list);
+  if (use_p2p_all2all_) {
+    // Wait for the stores of all peers into the network buffer.
+    gpu_barrier_->sync_all_gpus(core_->get_local_gpu()->get_stream(), core_->get_local_gpu_id());
+  } else if (use_comm_quantization_) {
+    comm_quantization_.quantize(model_comm_buffer_.data, model_comm_buffer_.attr.type,
+                                quantized_model_comm_buffer_, batch_size, false);
+    all2all_comm_.communicate(quantized_model_comm_buffer_.data_list,
+                              quantized_network_buffer_.data_list);
+    comm_quantization_.dequantize(quantized_network_buffer_, network_buffer_.data,
+                                  network_buffer_.attr.type, batch_size);
+  } else {
+    all2all_comm_.communicate(model_comm_buffer_.data_list, network_buffer_.data_list);
+  }
   network_forward_.sparse_forward(embedding_input.num_keys_per_bucket, network_buffer_,
                                   meta_.network_indices, embedding_output, batch_size);
 }
@@ -236,10 +329,29 @@ void UniformModelParallelEmbedding::network_forward(const EmbeddingInput &embedd
 void UniformModelParallelEmbedding::network_backward(const EmbeddingOutput &top_grad,
                                                      const EmbeddingInput &embedding_input,
                                                      Wgrad &wgrad, int batch_size) {
+  if (use_p2p_all2all_) {
+    auto stream = core_->get_local_gpu()->get_stream();
+    // The peers must be done with the wgrads of the previous iteration in their model comm
+    // buffers, and must have received all wgrads of this one before their local reduce.
+    gpu_barrier_->sync_all_gpus(stream, core_->get_local_gpu_id());
+    network_backward_.sparse_backward(embedding_input.num_keys_per_bucket, top_grad,
+                                      meta_.network_indices, peer_model_comm_buffer_, batch_size);
+    gpu_barrier_->sync_all_gpus(stream, core_->get_local_gpu_id());
+    return;
+  }
   network_backward_.sparse_backward(embedding_input.num_keys_per_bucket, top_grad,
                                     meta_.network_indices, network_buffer_, batch_size);
 
-  all2all_comm_.communicate(network_buffer_.data_list, model_comm_buffer_.data_list);
+  if (use_comm_quantization_) {
+    comm_quantization_.quantize(network_buffer_.data, network_buffer_.attr.type,
+                                quantized_network_buffer_, batch_size, true);
+    all2all_comm_.communicate(quantized_network_buffer_.data_list,
+                              quantized_model_comm_buffer_.data_list);
+    comm_quantization_.dequantize(quantized_model_comm_buffer_, model_comm_buffer_.data,
+                                  model_comm_buffer_.attr.type, batch_size);
+  } else {
+    all2all_comm_.communicate(network_buffer_.data_list, model_comm_buffer_.data_list);
+  }
 }
 
 void UniformModelParallelEmbedding::backward_index_calculation(
@@ -253,6 +365,11 @@ void UniformModelParallelEmbedding::backward_index_calculation(
 void UniformModelParallelEmbedding::local_reduce(Wgrad &wgrad, int batch_size) {
   HugeCTR::CudaDeviceContext context(core_->get_device_id());
 
+  if (use_fused_update_) {
+    local_reduce_.prepare_unreduced_wgrad(reduction_indices_, model_comm_buffer_, wgrad, batch_size,
+                                          unreduced_wgrad_);
+    return;
+  }
   local_reduce_.local_reduce(reduction_indices_, model_comm_buffer_, wgrad, batch_size);
 }
 
@@ -304,4 +421,11 @@ bool UniformModelParallelEmbedding::is_valid_stage(Stage stage) const {
          (stage == Stage::MPLocalReduce);
 }
 
+bool UniformModelParallelEmbedding::is_graph_capturable_stage(Stage stage) const {
+  // The all-to-alls exchange the buffers of the universal batch size, and the network side only
+  // depends on the number of keys per bucket on the device. The lookups depend on the number of
+  // keys on the host.
+  return (stage == Stage::MPNetworkdForward) || (stage == Stage::MPNetworkBackward);
+}
+
 }  // namespace embedding
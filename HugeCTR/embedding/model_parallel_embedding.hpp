@@ -17,6 +17,8 @@
 
 #include <embedding/common.hpp>
 #include <embedding/embedding.hpp>
+#include <embedding/gpu_barrier/gpu_barrier.hpp>
+#include <embedding/operators/comm_quantization.hpp>
 #include <embedding/operators/communication.hpp>
 #include <embedding/operators/compress_offset.hpp>
 #include <embedding/operators/index_calculation.hpp>
@@ -90,17 +92,38 @@ class UniformModelParallelEmbedding : public IGroupedEmbeddingOp {
   LocalReduce local_reduce_;
 
   CompressOffset compress_offset_;
+  // The prefetch of the next batch may overlap the forward of the current one, so it has its own
+  // offsets.
+  CompressOffset prefetch_compress_offset_;
   ModelForward model_forward_;
   NcclAll2AllComm all2all_comm_;
   NetworkForward network_forward_;
 
   NetworkBackward network_backward_;
 
+  bool use_fused_update_ = false;
+  UnreducedWgrad unreduced_wgrad_;
+
+  bool use_comm_quantization_;
+  CommQuantization comm_quantization_;
+
   core23::Tensor embedding_vec_;
 
   ModelCommBuffer model_comm_buffer_;
   NetworkBuffer network_buffer_;
 
+  // FP8 payloads of the model and network comm buffers, if use_comm_quantization_.
+  QuantizedCommBuffer quantized_model_comm_buffer_;
+  QuantizedCommBuffer quantized_network_buffer_;
+
+  // Views of the buffers of the peer gpus that receive the payloads of this gpu, if
+  // use_p2p_all2all_. Entry g of the model comm buffer is the network buffer of gpu g, and vice
+  // versa for the backward pass.
+  bool use_p2p_all2all_;
+  ModelCommBuffer peer_network_buffer_;
+  NetworkBuffer peer_model_comm_buffer_;
+  HugeCTR::GPUBarrier *gpu_barrier_ = nullptr;
+
   void model_forward(const EmbeddingInput &embedding_input, ILookup *embedding_table,
                      int batch_size);
 
@@ -125,9 +148,27 @@ class UniformModelParallelEmbedding : public IGroupedEmbeddingOp {
   void backward_per_gpu(Stage stage, const EmbeddingInput &embedding_input,
                         const EmbeddingOutput &top_grad, Wgrad &wgrad, int batch_size) override;
 
+  void prefetch(const EmbeddingInput &embedding_input, ILookup *embedding_table,
+                int batch_size) override;
+
   const WgradAttr &get_wgrad_attr() const override { return meta_.wgrad_attr; }
 
+  void enable_fused_update() override { use_fused_update_ = true; }
+
+  const UnreducedWgrad *get_unreduced_wgrad() const override {
+    return use_fused_update_ ? &unreduced_wgrad_ : nullptr;
+  }
+
   bool is_valid_stage(Stage stage) const override;
+
+  bool is_graph_capturable_stage(Stage stage) const override;
+
+  ModelCommBuffer *get_model_comm_buffer() { return &model_comm_buffer_; }
+
+  NetworkBuffer *get_network_buffer() { return &network_buffer_; }
+
+  void init_p2p_all2all(const std::vector<UniformModelParallelEmbedding *> &embeddings,
+                        HugeCTR::GPUBarrier *gpu_barrier);
 };
 
 }  // namespace embedding
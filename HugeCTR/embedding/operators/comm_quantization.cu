@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_fp8.h>
+
+#include <embedding/operators/comm_quantization.hpp>
+#include <embedding/operators/stochastic_rounding.cuh>
+#include <numeric>
+#include <utils.cuh>
+#include <utils.hpp>
+
+namespace embedding {
+
+namespace {
+
+constexpr float kFP8E4M3Max = 448.0f;
+constexpr float kMinScale = 1.0f / (kFP8E4M3Max * 512.0f);
+
+// Rounds v to one of the two nearest E4M3 values, with a probability proportional to its
+// proximity. E4M3 has 3 mantissa bits, and subnormals below 2^-6.
+__device__ __forceinline__ float stochastic_round_e4m3(float v, uint32_t rand) {
+  float a = fabsf(v);
+  if (a == 0.f) return v;
+  int exp;
+  frexpf(a, &exp);
+  float ulp = exp2f(static_cast<float>(max(exp - 1, -6) - 3));
+  float lower = floorf(a / ulp) * ulp;
+  float u = static_cast<float>(rand >> 8) * (1.f / 16777216.f);
+  float rounded = u < (a - lower) / ulp ? lower + ulp : lower;
+  return copysignf(fminf(rounded, kFP8E4M3Max), v);
+}
+
+// Finds the gpu of a row of lookups of all gpus. Gpus without lookups are skipped.
+__device__ __forceinline__ int find_gpu_id(const int *gpu_id_to_lookup_offset, int num_gpus,
+                                           int lookup_row) {
+  int lo = 0;
+  int hi = num_gpus;
+  while (hi - lo > 1) {
+    int mid = (lo + hi) / 2;
+    if (gpu_id_to_lookup_offset[mid] <= lookup_row) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <typename emb_t>
+__global__ void quantize_kernel(const emb_t **src_ptrs, uint8_t **dst_ptrs,
+                                const int64_t *scale_offsets, const int **id_to_ev_size_ptrs,
+                                const int **id_to_ev_start_indices_ptrs,
+                                const int *gpu_id_to_lookup_offset, int num_gpus,
+                                int batch_size_per_gpu, bool stochastic_rounding, uint32_t seed) {
+  int num_rows = gpu_id_to_lookup_offset[num_gpus] * batch_size_per_gpu;
+  int lane_id = threadIdx.x % warpSize;
+  int num_warps = gridDim.x * blockDim.x / warpSize;
+  for (int row = (blockIdx.x * blockDim.x + threadIdx.x) / warpSize; row < num_rows;
+       row += num_warps) {
+    int gpu_id = find_gpu_id(gpu_id_to_lookup_offset, num_gpus, row / batch_size_per_gpu);
+    int local_row = row - gpu_id_to_lookup_offset[gpu_id] * batch_size_per_gpu;
+    int lookup_id = local_row / batch_size_per_gpu;
+    int bid = local_row % batch_size_per_gpu;
+    int ev_size = id_to_ev_size_ptrs[gpu_id][lookup_id];
+    int64_t ev_offset =
+        static_cast<int64_t>(batch_size_per_gpu) * id_to_ev_start_indices_ptrs[gpu_id][lookup_id] +
+        static_cast<int64_t>(bid) * ev_size;
+    const emb_t *src = src_ptrs[gpu_id] + ev_offset;
+
+    float amax = 0.f;
+    for (int e = lane_id; e < ev_size; e += warpSize) {
+      amax = fmaxf(amax, fabsf(HugeCTR::TypeConvertFunc<float, emb_t>::convert(src[e])));
+    }
+    for (int mask = warpSize / 2; mask > 0; mask /= 2) {
+      amax = fmaxf(amax, __shfl_xor_sync(0xffffffff, amax, mask));
+    }
+    float scale = fmaxf(amax / kFP8E4M3Max, kMinScale);
+
+    __nv_fp8_e4m3 *dst = reinterpret_cast<__nv_fp8_e4m3 *>(dst_ptrs[gpu_id]) + ev_offset;
+    uint32_t gpu_seed = seed + static_cast<uint32_t>(gpu_id) * 0x632BE5ABu;
+    for (int e = lane_id; e < ev_size; e += warpSize) {
+      float v = HugeCTR::TypeConvertFunc<float, emb_t>::convert(src[e]) / scale;
+      if (stochastic_rounding) {
+        v = stochastic_round_e4m3(v, hash_index(gpu_seed, static_cast<uint32_t>(ev_offset + e)));
+      }
+      dst[e] = __nv_fp8_e4m3(v);
+    }
+    if (lane_id == 0) {
+      float *scales = reinterpret_cast<float *>(dst_ptrs[gpu_id] + scale_offsets[gpu_id]);
+      scales[local_row] = scale;
+    }
+  }
+}
+
+template <typename emb_t>
+__global__ void dequantize_kernel(const uint8_t **src_ptrs, emb_t **dst_ptrs,
+                                  const int64_t *scale_offsets, const int **id_to_ev_size_ptrs,
+                                  const int **id_to_ev_start_indices_ptrs,
+                                  const int *gpu_id_to_lookup_offset, int num_gpus,
+                                  int batch_size_per_gpu) {
+  int num_rows = gpu_id_to_lookup_offset[num_gpus] * batch_size_per_gpu;
+  int lane_id = threadIdx.x % warpSize;
+  int num_warps = gridDim.x * blockDim.x / warpSize;
+  for (int row = (blockIdx.x * blockDim.x + threadIdx.x) / warpSize; row < num_rows;
+       row += num_warps) {
+    int gpu_id = find_gpu_id(gpu_id_to_lookup_offset, num_gpus, row / batch_size_per_gpu);
+    int local_row = row - gpu_id_to_lookup_offset[gpu_id] * batch_size_per_gpu;
+    int lookup_id = local_row / batch_size_per_gpu;
+    int bid = local_row % batch_size_per_gpu;
+    int ev_size = id_to_ev_size_ptrs[gpu_id][lookup_id];
+    int64_t ev_offset =
+        static_cast<int64_t>(batch_size_per_gpu) * id_to_ev_start_indices_ptrs[gpu_id][lookup_id] +
+        static_cast<int64_t>(bid) * ev_size;
+
+    const __nv_fp8_e4m3 *src =
+        reinterpret_cast<const __nv_fp8_e4m3 *>(src_ptrs[gpu_id]) + ev_offset;
+    const float *scales = reinterpret_cast<const float *>(src_ptrs[gpu_id] + scale_offsets[gpu_id]);
+    float scale = scales[local_row];
+    emb_t *dst = dst_ptrs[gpu_id] + ev_offset;
+    for (int e = lane_id; e < ev_size; e += warpSize) {
+      dst[e] = HugeCTR::TypeConvertFunc<emb_t, float>::convert(static_cast<float>(src[e]) * scale);
+    }
+  }
+}
+
+}  // namespace
+
+void QuantizedCommBufferAttr::init(std::shared_ptr<CoreResourceManager> core,
+                                   const std::vector<std::vector<int>> &h_id_to_ev_size_list) {
+  HugeCTR::CudaDeviceContext context(core->get_device_id());
+  this->h_id_to_ev_size_list = h_id_to_ev_size_list;
+  this->num_gpus = static_cast<int>(h_id_to_ev_size_list.size());
+
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::BufferParams buffer_params;
+  buffer_params.unitary = false;
+  core23::TensorParams params = core23::TensorParams().device(device).buffer_params(buffer_params);
+
+  this->id_to_ev_size_list.clear();
+  this->id_to_ev_start_indices_list.clear();
+  this->h_gpu_id_to_lookup_offset = {0};
+  for (auto &h_id_to_ev_size : h_id_to_ev_size_list) {
+    std::vector<int> h_id_to_ev_start_indices{0};
+    std::partial_sum(h_id_to_ev_size.begin(), h_id_to_ev_size.end(),
+                     std::back_inserter(h_id_to_ev_start_indices));
+
+    // We can not create size 0 Tensor
+    this->id_to_ev_size_list.emplace_back(
+        params.shape({std::max<int64_t>(h_id_to_ev_size.size(), 1)})
+            .data_type(core23::ScalarType::Int32));
+    if (!h_id_to_ev_size.empty()) {
+      core23::copy_sync(this->id_to_ev_size_list.back(), h_id_to_ev_size);
+    }
+    this->id_to_ev_start_indices_list.emplace_back(
+        params.shape({static_cast<int64_t>(h_id_to_ev_start_indices.size())})
+            .data_type(core23::ScalarType::Int32));
+    core23::copy_sync(this->id_to_ev_start_indices_list.back(), h_id_to_ev_start_indices);
+
+    this->h_gpu_id_to_lookup_offset.push_back(this->h_gpu_id_to_lookup_offset.back() +
+                                              static_cast<int>(h_id_to_ev_size.size()));
+  }
+  this->id_to_ev_size =
+      core23::init_tensor_list<int32_t>(this->id_to_ev_size_list, params.device().index());
+  this->id_to_ev_start_indices =
+      core23::init_tensor_list<int32_t>(this->id_to_ev_start_indices_list, params.device().index());
+
+  this->gpu_id_to_lookup_offset =
+      core23::Tensor(params.shape({static_cast<int64_t>(h_gpu_id_to_lookup_offset.size())})
+                         .data_type(core23::ScalarType::Int32));
+  core23::copy_sync(this->gpu_id_to_lookup_offset, h_gpu_id_to_lookup_offset);
+}
+
+void QuantizedCommBuffer::init(std::shared_ptr<CoreResourceManager> core,
+                               const QuantizedCommBufferAttr &attr, int batch_size) {
+  HugeCTR::CudaDeviceContext context(core->get_device_id());
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  int64_t batch_size_per_gpu = batch_size / core->get_global_gpu_count();
+
+  this->data_list.clear();
+  this->h_scale_offsets.clear();
+  for (auto &h_id_to_ev_size : attr.h_id_to_ev_size_list) {
+    int64_t num_ev_elements =
+        batch_size_per_gpu * std::accumulate(h_id_to_ev_size.begin(), h_id_to_ev_size.end(), 0);
+    int64_t scale_offset = HugeCTR::alignTo<int64_t>(num_ev_elements, sizeof(float));
+    int64_t num_bytes = scale_offset + batch_size_per_gpu *
+                                           static_cast<int64_t>(h_id_to_ev_size.size()) *
+                                           static_cast<int64_t>(sizeof(float));
+    // Both sides of the all-to-all derive the same size, so a gpu without lookups sends 1 byte.
+    this->data_list.emplace_back(
+        params.shape({std::max<int64_t>(num_bytes, 1)}).data_type(core23::ScalarType::UInt8));
+    this->h_scale_offsets.push_back(scale_offset);
+  }
+  this->data = core23::init_tensor_list<uint8_t>(this->data_list, core->get_device_id());
+
+  this->scale_offsets = core23::Tensor(params.shape({static_cast<int64_t>(h_scale_offsets.size())})
+                                           .data_type(core23::ScalarType::Int64));
+  core23::copy_sync(this->scale_offsets, this->h_scale_offsets);
+
+  this->attr = attr;
+}
+
+CommQuantization::CommQuantization(std::shared_ptr<CoreResourceManager> core)
+    : core_(core), num_stochastic_rounding_(0) {}
+
+void CommQuantization::quantize(const core23::Tensor &src_ptrs, core23::DataType src_type,
+                                QuantizedCommBuffer &quantized_buffer, int batch_size,
+                                bool stochastic_rounding) {
+  HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+  const auto &attr = quantized_buffer.attr;
+  int batch_size_per_gpu = batch_size / core_->get_global_gpu_count();
+  if (attr.h_gpu_id_to_lookup_offset.back() == 0) return;
+
+  uint32_t seed = stochastic_rounding ? ++num_stochastic_rounding_ : 0;
+  DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(src_type.type(), emb_t, [&] {
+    constexpr int block_size = 256;
+    const int grid_size = core_->get_kernel_param().num_sms *
+                          core_->get_kernel_param().max_thread_per_block / block_size;
+    quantize_kernel<<<grid_size, block_size, 0, stream>>>(
+        (const emb_t **)src_ptrs.data(), (uint8_t **)quantized_buffer.data.data(),
+        quantized_buffer.scale_offsets.data<int64_t>(), (const int **)attr.id_to_ev_size.data(),
+        (const int **)attr.id_to_ev_start_indices.data(), attr.gpu_id_to_lookup_offset.data<int>(),
+        attr.num_gpus, batch_size_per_gpu, stochastic_rounding, seed);
+  });
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+void CommQuantization::dequantize(const QuantizedCommBuffer &quantized_buffer,
+                                  core23::Tensor &dst_ptrs, core23::DataType dst_type,
+                                  int batch_size) {
+  HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+  const auto &attr = quantized_buffer.attr;
+  int batch_size_per_gpu = batch_size / core_->get_global_gpu_count();
+  if (attr.h_gpu_id_to_lookup_offset.back() == 0) return;
+
+  DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(dst_type.type(), emb_t, [&] {
+    constexpr int block_size = 256;
+    const int grid_size = core_->get_kernel_param().num_sms *
+                          core_->get_kernel_param().max_thread_per_block / block_size;
+    dequantize_kernel<<<grid_size, block_size, 0, stream>>>(
+        (const uint8_t **)quantized_buffer.data.data(), (emb_t **)dst_ptrs.data(),
+        quantized_buffer.scale_offsets.data<int64_t>(), (const int **)attr.id_to_ev_size.data(),
+        (const int **)attr.id_to_ev_start_indices.data(), attr.gpu_id_to_lookup_offset.data<int>(),
+        attr.num_gpus, batch_size_per_gpu);
+  });
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+}  // namespace embedding
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core23/registry.hpp>
+#include <embedding/common.hpp>
+
+namespace embedding {
+using core::CoreResourceManager;
+
+struct QuantizedCommBufferAttr {
+  // ev size of each lookup whose rows are exchanged with each gpu, in the order of the
+  // unquantized comm buffer of that gpu.
+  std::vector<std::vector<int>> h_id_to_ev_size_list;
+  std::vector<core23::Tensor> id_to_ev_size_list;
+  core23::Tensor id_to_ev_size;
+
+  std::vector<core23::Tensor> id_to_ev_start_indices_list;
+  core23::Tensor id_to_ev_start_indices;
+
+  std::vector<int> h_gpu_id_to_lookup_offset;
+  core23::Tensor gpu_id_to_lookup_offset;
+
+  int num_gpus;
+
+  void init(std::shared_ptr<CoreResourceManager> core,
+            const std::vector<std::vector<int>> &h_id_to_ev_size_list);
+};
+
+// FP8 all-to-all payload of each gpu. It holds the E4M3 values in the layout of the unquantized
+// comm buffer, followed by the FP32 scale of each row at the next 4-byte boundary.
+struct QuantizedCommBuffer {
+  std::vector<core23::Tensor> data_list;
+  core23::Tensor data;
+
+  std::vector<int64_t> h_scale_offsets;
+  core23::Tensor scale_offsets;
+
+  QuantizedCommBufferAttr attr;
+
+  void init(std::shared_ptr<CoreResourceManager> core, const QuantizedCommBufferAttr &attr,
+            int batch_size);
+};
+
+class CommQuantization {
+  std::shared_ptr<CoreResourceManager> core_;
+  uint32_t num_stochastic_rounding_;
+
+ public:
+  CommQuantization() = default;
+
+  explicit CommQuantization(std::shared_ptr<CoreResourceManager> core);
+
+  // Quantizes each row of the comm buffers in src_ptrs with its own scale. Stochastic rounding
+  // keeps quantized gradients unbiased.
+  void quantize(const core23::Tensor &src_ptrs, core23::DataType src_type,
+                QuantizedCommBuffer &quantized_buffer, int batch_size, bool stochastic_rounding);
+
+  void dequantize(const QuantizedCommBuffer &quantized_buffer, core23::Tensor &dst_ptrs,
+                  core23::DataType dst_type, int batch_size);
+};
+
+}  // namespace embedding
@@ -37,6 +37,8 @@ ncclDataType_t get_nccl_dtype_from_tensor_scalar_type_core23(core23::ScalarType
       return ncclUint32;
     case core23::ScalarType::Char:
       return ncclChar;
+    case core23::ScalarType::UInt8:
+      return ncclUint8;
     default:
       HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
                      "Not supported core23::ScalarType to NcclDataType_t");
@@ -127,6 +129,25 @@ void NcclAll2AllComm::hier_communicate(const std::vector<core23::Tensor>& send_t
   HCTR_LIB_THROW(ncclGroupEnd());
 }
 
+void NcclAll2AllComm::hier_communicate(const core23::Tensor& send_tensor, int dst_node_id,
+                                       core23::Tensor& recv_tensor, int src_node_id,
+                                       cudaStream_t stream) {
+  HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
+
+  auto& comm = core_->get_nccl();
+  int num_local_gpu = core_->get_local_gpu_count();
+  int local_gpu_id = core_->get_local_gpu_id();
+
+  HCTR_LIB_THROW(ncclGroupStart());
+  ncclDataType_t nccl_dtype =
+      core23::get_nccl_dtype_from_tensor_scalar_type_core23(send_tensor.data_type().type());
+  HCTR_LIB_THROW(ncclSend(send_tensor.data(), send_tensor.num_elements(), nccl_dtype,
+                          dst_node_id * num_local_gpu + local_gpu_id, comm, stream));
+  HCTR_LIB_THROW(ncclRecv(recv_tensor.data(), recv_tensor.num_elements(), nccl_dtype,
+                          src_node_id * num_local_gpu + local_gpu_id, comm, stream));
+  HCTR_LIB_THROW(ncclGroupEnd());
+}
+
 NcclAllReduceInplaceComm::NcclAllReduceInplaceComm(std::shared_ptr<CoreResourceManager> core)
     : core_(core) {}
 
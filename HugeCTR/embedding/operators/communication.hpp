@@ -48,6 +48,11 @@ class NcclAll2AllComm {
 
   void hier_communicate(const std::vector<core23::Tensor>& send_tensors,
                         std::vector<core23::Tensor>& recv_tensors);
+
+  // One step of a pipelined hier_communicate. Sends to the gpu with the same local id in
+  // dst_node_id, and receives from the one in src_node_id.
+  void hier_communicate(const core23::Tensor& send_tensor, int dst_node_id,
+                        core23::Tensor& recv_tensor, int src_node_id, cudaStream_t stream);
 };
 
 class NcclAllReduceInplaceComm {
@@ -227,135 +227,371 @@ __global__ void table_id_to_ev_size_kernel(const int* table_ids, const uint64_t*
     ev_sizes_of_unqiue_keys[i] = table_id_to_ev_size[table_ids[i]];
   }
 }
+
+template <typename KeyType>
+__global__ void cal_owner_ids_kernel(const KeyType* keys, const int* table_ids, size_t num_keys,
+                                     int num_gpus, int* owner_ids, uint32_t* partition_ids) {
+  CUDA_1D_KERNEL_LOOP(i, num_keys) {
+    // Rehash, so that the keys of an owner still spread over all slots of its hash table.
+    uint32_t hash = HugeCTR::Hash()(HugeCTR::KeyPair<KeyType>{keys[i], table_ids[i]});
+    owner_ids[i] = static_cast<int>(MurmurHash3_32<uint32_t>::hash(hash) % num_gpus);
+    partition_ids[i] = static_cast<uint32_t>(i);
+  }
+}
+
+template <typename KeyType>
+__global__ void gather_send_keys_kernel(const KeyType* keys, const int* table_ids,
+                                        const uint32_t* sorted_partition_ids, size_t num_keys,
+                                        const int* table_id_to_ev_size, KeyType* send_keys,
+                                        int* send_table_ids, uint32_t* send_ev_sizes) {
+  CUDA_1D_KERNEL_LOOP(i, num_keys) {
+    const uint32_t id = sorted_partition_ids[i];
+    const int table_id = table_ids[id];
+    send_keys[i] = keys[id];
+    send_table_ids[i] = table_id;
+    send_ev_sizes[i] = table_id_to_ev_size[table_id];
+  }
+}
+
+__global__ void scatter_send_ev_start_indices_kernel(const uint32_t* sorted_partition_ids,
+                                                     const uint32_t* send_ev_start_indices,
+                                                     size_t num_keys, uint32_t* ev_start_indices) {
+  CUDA_1D_KERNEL_LOOP(i, num_keys) {
+    ev_start_indices[sorted_partition_ids[i]] = send_ev_start_indices[i];
+  }
+}
+
+__global__ void cal_send_counts_kernel(const int* sorted_owner_ids, size_t num_keys,
+                                       const uint32_t* send_ev_start_indices, int num_gpus,
+                                       uint64_t* send_counts) {
+  CUDA_1D_KERNEL_LOOP(gpu_id, num_gpus) {
+    auto lower_bound = [&](int owner_id) {
+      size_t first = 0, last = num_keys;
+      while (first < last) {
+        size_t mid = (first + last) / 2;
+        if (sorted_owner_ids[mid] < owner_id) {
+          first = mid + 1;
+        } else {
+          last = mid;
+        }
+      }
+      return first;
+    };
+    size_t begin = lower_bound(gpu_id);
+    size_t end = lower_bound(gpu_id + 1);
+    send_counts[2 * gpu_id] = end - begin;
+    send_counts[2 * gpu_id + 1] = send_ev_start_indices[end] - send_ev_start_indices[begin];
+  }
+}
+
+// One warp adds each received wgrad to the wgrad of its key.
+template <typename emb_t>
+__global__ void add_recv_wgrad_kernel(const emb_t* src, const uint32_t* src_ev_start_indices,
+                                      const int* table_ids, const int* table_id_to_ev_size,
+                                      const uint32_t* dst_ev_start_indices, size_t begin,
+                                      size_t end, emb_t* dst) {
+  const int lane_id = threadIdx.x % 32;
+  const size_t warp_id = (blockIdx.x * blockDim.x + threadIdx.x) / 32;
+  const size_t num_warps = (gridDim.x * blockDim.x) / 32;
+  for (size_t i = begin + warp_id; i < end; i += num_warps) {
+    const int ev_size = table_id_to_ev_size[table_ids[i]];
+    const emb_t* src_ev = src + src_ev_start_indices[i];
+    emb_t* dst_ev = dst + dst_ev_start_indices[i];
+    for (int j = lane_id; j < ev_size; j += 32) {
+      float sum = HugeCTR::TypeConvertFunc<float, emb_t>::convert(dst_ev[j]) +
+                  HugeCTR::TypeConvertFunc<float, emb_t>::convert(src_ev[j]);
+      dst_ev[j] = HugeCTR::TypeConvertFunc<emb_t, float>::convert(sum);
+    }
+  }
+}
+
+__global__ void sum_key_counts_kernel(const uint64_t* counts, int num_gpus, uint64_t* num_keys) {
+  uint64_t sum = 0;
+  for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
+    sum += counts[2 * gpu_id];
+  }
+  *num_keys = sum;
+}
+
+__global__ void cal_owner_counts_kernel(const uint64_t* num_keys, const uint32_t* ev_start_indices,
+                                        uint64_t* counts) {
+  counts[0] = *num_keys;
+  counts[1] = ev_start_indices[*num_keys];
+}
+
+int get_grid_size(const std::shared_ptr<core::CoreResourceManager>& core, size_t num_elements,
+                  int block_size) {
+  auto& kernel_param = core->get_kernel_param();
+  size_t max_grid_size = kernel_param.num_sms * (kernel_param.max_thread_per_sm / block_size);
+  return static_cast<int>(
+      std::max(1ul, std::min(max_grid_size, (num_elements + block_size - 1) / block_size)));
+}
 }  // namespace
 
 SparseAllreduceCalEVStartIndicesStorage::SparseAllreduceCalEVStartIndicesStorage(
-    std::shared_ptr<CoreResourceManager> core, int local_hotness_sum, int batch_size_per_gpu,
+    std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam& ebc_param,
+    size_t grouped_id, const WgradAttr& wgrad_attr, int local_hotness_sum, int batch_size_per_gpu,
     core23::DataType key_type) {
   core23::Device device(core23::DeviceType::GPU, core->get_device_id());
   core23::TensorParams params = core23::TensorParams().device(device);
 
   int num_gpus = core->get_global_gpu_count();
-
-  // BroadcastResult
-  broadcast_result_.allgather_num_unique_keys_ =
-      core23::Tensor(params.shape({num_gpus}).data_type(core23::ScalarType::UInt64));
-  broadcast_result_.h_allgather_num_unique_keys_ =
-      core23::Tensor(params.shape({num_gpus})
-                         .data_type(core23::ScalarType::UInt64)
-                         .device(core23::DeviceType::CPU));
-
-  broadcast_result_.allgather_unique_keys_ = core23::Tensor(
-      params.shape({local_hotness_sum * batch_size_per_gpu * num_gpus}).data_type(key_type));
-  broadcast_result_.allgather_table_ids_ =
-      core23::Tensor(params.shape({local_hotness_sum * batch_size_per_gpu * num_gpus})
-                         .data_type(core23::ScalarType::Int32));
-  broadcast_result_.num_allgather_keys_ = 0ul;
+  int64_t max_num_local_keys = static_cast<int64_t>(local_hotness_sum) * batch_size_per_gpu;
+  int64_t max_num_keys = max_num_local_keys * num_gpus;
+
+  // PartitionResult
+  partition_result_.owner_ids_ =
+      core23::Tensor(params.shape({max_num_local_keys}).data_type(core23::ScalarType::Int32));
+  partition_result_.sorted_owner_ids_ =
+      core23::Tensor(params.shape({max_num_local_keys}).data_type(core23::ScalarType::Int32));
+  partition_result_.partition_ids_ =
+      core23::Tensor(params.shape({max_num_local_keys}).data_type(core23::ScalarType::UInt32));
+  partition_result_.sorted_partition_ids_ =
+      core23::Tensor(params.shape({max_num_local_keys}).data_type(core23::ScalarType::UInt32));
+  partition_result_.send_keys_ =
+      core23::Tensor(params.shape({max_num_local_keys}).data_type(key_type));
+  partition_result_.send_table_ids_ =
+      core23::Tensor(params.shape({max_num_local_keys}).data_type(core23::ScalarType::Int32));
+  partition_result_.send_ev_start_indices_ =
+      core23::Tensor(params.shape({max_num_local_keys + 1}).data_type(core23::ScalarType::UInt32));
+  partition_result_.h_num_keys_ = 0ul;
+
+  partition_result_.send_counts_ =
+      core23::Tensor(params.shape({num_gpus * 2}).data_type(core23::ScalarType::UInt64));
+  partition_result_.h_send_counts_ = core23::Tensor(params.shape({num_gpus * 2})
+                                                        .data_type(core23::ScalarType::UInt64)
+                                                        .device(core23::DeviceType::CPU));
+  partition_result_.recv_counts_ =
+      core23::Tensor(params.shape({num_gpus * 2}).data_type(core23::ScalarType::UInt64));
+  partition_result_.h_recv_counts_ = core23::Tensor(params.shape({num_gpus * 2})
+                                                        .data_type(core23::ScalarType::UInt64)
+                                                        .device(core23::DeviceType::CPU));
+
+  // A gpu can receive and own as many keys as there are in the global batch.
+  WgradInitializer{core, ebc_param, grouped_id, wgrad_attr}
+      .init(recv_wgrad_)
+      .init_indices()
+      .init_data();
+  recv_dst_ev_start_indices_ =
+      core23::Tensor(params.shape({max_num_keys}).data_type(core23::ScalarType::UInt32));
+  WgradInitializer{core, ebc_param, grouped_id, wgrad_attr}
+      .init(owner_wgrad_)
+      .init_indices()
+      .init_data();
+
+  allgather_counts_ =
+      core23::Tensor(params.shape({num_gpus * 2}).data_type(core23::ScalarType::UInt64));
+  h_allgather_counts_ = core23::Tensor(params.shape({num_gpus * 2})
+                                           .data_type(core23::ScalarType::UInt64)
+                                           .device(core23::DeviceType::CPU));
 
   // HashTable
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type.type(), key_t, [&] {
-    hash_table_ =
-        core23::Tensor(params
-                           .shape({static_cast<int64_t>(local_hotness_sum * batch_size_per_gpu *
-                                                        num_gpus * sizeof(TableEntry<key_t>))})
-                           .data_type(core23::ScalarType::Char));
+    hash_table_ = core23::Tensor(
+        params.shape({static_cast<int64_t>(max_num_keys * sizeof(TableEntry<key_t>))})
+            .data_type(core23::ScalarType::Char));
   });
 
   // Tempstorage
   temp_storage_.mask_unique_keys_in_allgather_unique_keys_ =
-      core23::Tensor(params.shape({local_hotness_sum * batch_size_per_gpu * num_gpus})
-                         .data_type(core23::ScalarType::Int32));
+      core23::Tensor(params.shape({max_num_keys}).data_type(core23::ScalarType::Int32));
   {
     size_t temp_bytes = 0;
     cub::DeviceSelect::Flagged(nullptr, temp_bytes, (int64_t*)nullptr, (int*)nullptr,
-                               (int64_t*)nullptr, (int64_t*)nullptr,
-                               local_hotness_sum * batch_size_per_gpu * num_gpus);
+                               (int64_t*)nullptr, (int64_t*)nullptr, max_num_keys);
     temp_storage_.d_temp_select_unique_keys_in_allgather_unique_keys_ = core23::Tensor(
         params.shape({static_cast<int64_t>(temp_bytes)}).data_type(core23::ScalarType::Char));
   }
   {
     size_t temp_bytes = 0;
     cub::DeviceScan::InclusiveSum(nullptr, temp_bytes, (uint32_t*)nullptr, (uint32_t*)nullptr,
-                                  local_hotness_sum * batch_size_per_gpu * num_gpus + 1);
+                                  max_num_keys + 1);
     temp_storage_.d_temp_scan_ev_start_indices_storage_ = core23::Tensor(
         params.shape({static_cast<int64_t>(temp_bytes)}).data_type(core23::ScalarType::Char));
   }
+  {
+    size_t temp_bytes = 0;
+    cub::DeviceRadixSort::SortPairs(nullptr, temp_bytes, (int*)nullptr, (int*)nullptr,
+                                    (uint32_t*)nullptr, (uint32_t*)nullptr, max_num_local_keys);
+    temp_storage_.d_temp_sort_owner_ids_storage_ = core23::Tensor(
+        params.shape({static_cast<int64_t>(temp_bytes)}).data_type(core23::ScalarType::Char));
+  }
 }
 
-void broadcast_unique_keys(const std::shared_ptr<core::CoreResourceManager>& core,
-                           const Wgrad& local_reduce_wgrad, BroadcastResult& broadcast_result) {
+// Partitions the local unique keys by their owner, and exchanges the number of keys and wgrad
+// elements that each gpu sends to each owner.
+void partition_unique_keys(const std::shared_ptr<core::CoreResourceManager>& core,
+                           Wgrad& local_reduce_wgrad,
+                           SparseAllreducePartitionResult& partition_result,
+                           SparseAllreduceCalEVStartIndicesTempStorage& temp_storage) {
   cudaStream_t stream = core->get_local_gpu()->get_stream();
   ncclComm_t comm = core->get_nccl();
   int num_gpus = core->get_global_gpu_count();
+  int block_size = 256;
 
-  // 1. collect num_unique keys
-  HCTR_LIB_THROW(ncclAllGather(local_reduce_wgrad.num_unique_keys.data(),
-                               broadcast_result.allgather_num_unique_keys_.data(), 1, ncclUint64,
-                               comm, stream));
-  core23::copy_async(broadcast_result.h_allgather_num_unique_keys_,
-                     broadcast_result.allgather_num_unique_keys_, stream);
+  HCTR_LIB_THROW(cudaMemcpyAsync(&partition_result.h_num_keys_,
+                                 local_reduce_wgrad.num_unique_keys.data<uint64_t>(),
+                                 sizeof(size_t), cudaMemcpyDeviceToHost, stream));
   HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  size_t num_keys = partition_result.h_num_keys_;
+  int grid_size = get_grid_size(core, num_keys, block_size);
 
   auto key_type = local_reduce_wgrad.unique_keys.data_type();
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type.type(), KeyType, [&] {
+    // 1. owner of each key
+    cal_owner_ids_kernel<<<grid_size, block_size, 0, stream>>>(
+        local_reduce_wgrad.unique_keys.data<KeyType>(), local_reduce_wgrad.table_ids.data<int>(),
+        num_keys, num_gpus, partition_result.owner_ids_.data<int>(),
+        partition_result.partition_ids_.data<uint32_t>());
+
+    // 2. sort by owner. The radix sort is stable, so the keys of each owner keep their order.
+    // ATTENTION: cub radix sort requires NumItemT to be consistent
+    size_t temp_bytes = temp_storage.d_temp_sort_owner_ids_storage_.num_bytes();
+    int sort_end_bit = (int)log2(num_gpus) + 1;
+    cub::DeviceRadixSort::SortPairs(temp_storage.d_temp_sort_owner_ids_storage_.data(), temp_bytes,
+                                    partition_result.owner_ids_.data<int>(),
+                                    partition_result.sorted_owner_ids_.data<int>(),
+                                    partition_result.partition_ids_.data<uint32_t>(),
+                                    partition_result.sorted_partition_ids_.data<uint32_t>(),
+                                    static_cast<int64_t>(num_keys), 0, sort_end_bit, stream);
+
+    // 3. keys and table ids in the order of the owners
+    HCTR_LIB_THROW(cudaMemsetAsync(partition_result.send_ev_start_indices_.data(), 0,
+                                   sizeof(uint32_t), stream));
+    gather_send_keys_kernel<<<grid_size, block_size, 0, stream>>>(
+        local_reduce_wgrad.unique_keys.data<KeyType>(), local_reduce_wgrad.table_ids.data<int>(),
+        partition_result.sorted_partition_ids_.data<uint32_t>(), num_keys,
+        local_reduce_wgrad.attr.table_id_to_ev_size.data<int>(),
+        partition_result.send_keys_.data<KeyType>(), partition_result.send_table_ids_.data<int>(),
+        partition_result.send_ev_start_indices_.data<uint32_t>() + 1);
+  });
+
+  // 4. the local reduce writes the wgrads in the order in which they are sent
+  size_t scan_ev_start_indices_temp_nbytes =
+      temp_storage.d_temp_scan_ev_start_indices_storage_.num_bytes();
+  cub::DeviceScan::InclusiveSum(temp_storage.d_temp_scan_ev_start_indices_storage_.data(),
+                                scan_ev_start_indices_temp_nbytes,
+                                partition_result.send_ev_start_indices_.data<uint32_t>(),
+                                partition_result.send_ev_start_indices_.data<uint32_t>(),
+                                num_keys + 1, stream);
+  scatter_send_ev_start_indices_kernel<<<grid_size, block_size, 0, stream>>>(
+      partition_result.sorted_partition_ids_.data<uint32_t>(),
+      partition_result.send_ev_start_indices_.data<uint32_t>(), num_keys,
+      local_reduce_wgrad.ev_start_indices.data<uint32_t>());
+
+  // 5. exchange the number of keys and wgrad elements with each owner
+  cal_send_counts_kernel<<<get_grid_size(core, num_gpus, block_size), block_size, 0, stream>>>(
+      partition_result.sorted_owner_ids_.data<int>(), num_keys,
+      partition_result.send_ev_start_indices_.data<uint32_t>(), num_gpus,
+      partition_result.send_counts_.data<uint64_t>());
+  HCTR_LIB_THROW(ncclGroupStart());
+  for (int peer = 0; peer < num_gpus; ++peer) {
+    HCTR_LIB_THROW(ncclSend(partition_result.send_counts_.data<uint64_t>() + 2 * peer, 2,
+                            ncclUint64, peer, comm, stream));
+    HCTR_LIB_THROW(ncclRecv(partition_result.recv_counts_.data<uint64_t>() + 2 * peer, 2,
+                            ncclUint64, peer, comm, stream));
+  }
+  HCTR_LIB_THROW(ncclGroupEnd());
+  core23::copy_async(partition_result.h_send_counts_, partition_result.send_counts_, stream);
+  core23::copy_async(partition_result.h_recv_counts_, partition_result.recv_counts_, stream);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+// Sends the keys and table ids of each partition to their owner.
+size_t all2all_unique_keys(const std::shared_ptr<core::CoreResourceManager>& core,
+                           const SparseAllreducePartitionResult& partition_result,
+                           Wgrad& recv_wgrad) {
+  cudaStream_t stream = core->get_local_gpu()->get_stream();
+  ncclComm_t comm = core->get_nccl();
+  int num_gpus = core->get_global_gpu_count();
+
+  const uint64_t* h_send_counts = partition_result.h_send_counts_.data<uint64_t>();
+  const uint64_t* h_recv_counts = partition_result.h_recv_counts_.data<uint64_t>();
+  auto key_type = partition_result.send_keys_.data_type();
   auto nccl_key_type = core23::get_nccl_dtype_from_tensor_scalar_type_core23(key_type.type());
 
-  // 2. broadcast unique keys and table ids
+  uint64_t send_offset = 0;
+  uint64_t recv_offset = 0;
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type.type(), key_t, [&] {
     HCTR_LIB_THROW(ncclGroupStart());
-    const uint64_t* h_allgather_num_unique_keys =
-        broadcast_result.h_allgather_num_unique_keys_.data<uint64_t>();
-    uint64_t count_offset = 0;
-
-    for (int dst_gpu_id = 0; dst_gpu_id < num_gpus; ++dst_gpu_id) {
-      uint64_t num_unique_keys = h_allgather_num_unique_keys[dst_gpu_id];
-
-      HCTR_LIB_THROW(
-          ncclBroadcast(local_reduce_wgrad.unique_keys.data<key_t>(),
-                        broadcast_result.allgather_unique_keys_.data<key_t>() + count_offset,
-                        num_unique_keys, nccl_key_type, dst_gpu_id, comm, stream));
-      HCTR_LIB_THROW(ncclBroadcast(local_reduce_wgrad.table_ids.data<int>(),
-                                   broadcast_result.allgather_table_ids_.data<int>() + count_offset,
-                                   num_unique_keys, ncclInt32, dst_gpu_id, comm, stream));
-      count_offset += num_unique_keys;
+    for (int peer = 0; peer < num_gpus; ++peer) {
+      uint64_t send_num_keys = h_send_counts[2 * peer];
+      uint64_t recv_num_keys = h_recv_counts[2 * peer];
+      if (send_num_keys > 0) {
+        HCTR_LIB_THROW(ncclSend(partition_result.send_keys_.data<key_t>() + send_offset,
+                                send_num_keys, nccl_key_type, peer, comm, stream));
+        HCTR_LIB_THROW(ncclSend(partition_result.send_table_ids_.data<int>() + send_offset,
+                                send_num_keys, ncclInt32, peer, comm, stream));
+      }
+      if (recv_num_keys > 0) {
+        HCTR_LIB_THROW(ncclRecv(recv_wgrad.unique_keys.data<key_t>() + recv_offset, recv_num_keys,
+                                nccl_key_type, peer, comm, stream));
+        HCTR_LIB_THROW(ncclRecv(recv_wgrad.table_ids.data<int>() + recv_offset, recv_num_keys,
+                                ncclInt32, peer, comm, stream));
+      }
+      send_offset += send_num_keys;
+      recv_offset += recv_num_keys;
     }
-
-    broadcast_result.num_allgather_keys_ = count_offset;
     HCTR_LIB_THROW(ncclGroupEnd());
   });
+  sum_key_counts_kernel<<<1, 1, 0, stream>>>(partition_result.recv_counts_.data<uint64_t>(),
+                                             num_gpus, recv_wgrad.num_unique_keys.data<uint64_t>());
+  return recv_offset;
+}
+
+// ev_start_indices of the keys of a wgrad, from the ev sizes of their tables.
+void cal_ev_start_indices(const std::shared_ptr<core::CoreResourceManager>& core,
+                          SparseAllreduceCalEVStartIndicesTempStorage& temp_storage,
+                          Wgrad& wgrad) {
+  cudaStream_t stream = core->get_local_gpu()->get_stream();
+  auto& kernel_param = core->get_kernel_param();
+  int block_size = 256;
+  int grid_size = kernel_param.num_sms * (kernel_param.max_thread_per_sm / block_size);
+
+  HCTR_LIB_THROW(cudaMemsetAsync(wgrad.ev_start_indices.data(), 0,
+                                 wgrad.ev_start_indices.num_bytes(), stream));
+  table_id_to_ev_size_kernel<<<grid_size, block_size, 0, stream>>>(
+      wgrad.table_ids.data<int>(), wgrad.num_unique_keys.data<uint64_t>(),
+      wgrad.attr.table_id_to_ev_size.data<int>(), wgrad.ev_start_indices.data<uint32_t>() + 1);
+
+  size_t scan_ev_start_indices_temp_nbytes =
+      temp_storage.d_temp_scan_ev_start_indices_storage_.num_bytes();
+  cub::DeviceScan::InclusiveSum(temp_storage.d_temp_scan_ev_start_indices_storage_.data(),
+                                scan_ev_start_indices_temp_nbytes,
+                                wgrad.ev_start_indices.data<int>(),
+                                wgrad.ev_start_indices.data<int>(),
+                                wgrad.ev_start_indices.num_elements(), stream);
 }
 
-void cal_allreduce_wgrad(const std::shared_ptr<core::CoreResourceManager>& core,
-                         const BroadcastResult& broadcast_result,
-                         SparseAllreduceCalEVStartIndicesTempStorage& temp_storage,
-                         core23::Tensor& unique_and_sort_hash_table, Wgrad& allreduce_wgrad) {
+void cal_unique_keys_and_ev_start_indices(const std::shared_ptr<core::CoreResourceManager>& core,
+                                          const core23::Tensor& keys,
+                                          const core23::Tensor& table_ids, size_t num_keys,
+                                          SparseAllreduceCalEVStartIndicesTempStorage& temp_storage,
+                                          core23::Tensor& unique_and_sort_hash_table,
+                                          Wgrad& unique_wgrad) {
   cudaStream_t stream = core->get_local_gpu()->get_stream();
-  auto key_type = broadcast_result.allgather_unique_keys_.data_type();
+  auto key_type = keys.data_type();
   HCTR_LIB_THROW(cudaMemsetAsync(unique_and_sort_hash_table.data(), 0,
                                  unique_and_sort_hash_table.num_bytes(), stream));
-  size_t num_allgather_keys = broadcast_result.num_allgather_keys_;
 
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type.type(), KeyType, [&] {
     size_t capacity = unique_and_sort_hash_table.num_bytes() / sizeof(TableEntry<KeyType>);
 
     UniqueAndStoreLowestIdxTableView<KeyType> hash_table{
         (TableEntry<KeyType>*)unique_and_sort_hash_table.data(), capacity};
-    auto& kernel_param = core->get_kernel_param();
     int block_size = 256;
-    int grid_size = std::min(kernel_param.num_sms * (kernel_param.max_thread_per_sm / block_size),
-                             static_cast<int>(num_allgather_keys / block_size));
+    int grid_size = get_grid_size(core, num_keys, block_size);
 
     //  1. unique_and_sort_using_hash_table
     insert_allgather_keys_into_hash_table_kernel<<<grid_size, block_size, 0, stream>>>(
-        broadcast_result.allgather_unique_keys_.data<KeyType>(),
-        broadcast_result.allgather_table_ids_.data<int>(), num_allgather_keys, hash_table);
+        keys.data<KeyType>(), table_ids.data<int>(), num_keys, hash_table);
 
     // 2. mask selected unique keys
     HCTR_LIB_THROW(cudaMemsetAsync(
         temp_storage.mask_unique_keys_in_allgather_unique_keys_.data(), 0,
         temp_storage.mask_unique_keys_in_allgather_unique_keys_.num_bytes(), stream));
     mask_unique_keys_in_allgather_keys_kernel<<<grid_size, block_size, 0, stream>>>(
-        broadcast_result.allgather_unique_keys_.data<KeyType>(),
-        broadcast_result.allgather_table_ids_.data<int>(), num_allgather_keys, hash_table,
+        keys.data<KeyType>(), table_ids.data<int>(), num_keys, hash_table,
         temp_storage.mask_unique_keys_in_allgather_unique_keys_.data<int>());
 
     // 3. select unique keys / num_unique_keys / table_ids
@@ -363,34 +599,20 @@ void cal_allreduce_wgrad(const std::shared_ptr<core::CoreResourceManager>& core,
         temp_storage.d_temp_select_unique_keys_in_allgather_unique_keys_.num_bytes();
     cub::DeviceSelect::Flagged(
         temp_storage.d_temp_select_unique_keys_in_allgather_unique_keys_.data(),
-        select_unique_keys_temp_nbytes, broadcast_result.allgather_unique_keys_.data<KeyType>(),
+        select_unique_keys_temp_nbytes, keys.data<KeyType>(),
         temp_storage.mask_unique_keys_in_allgather_unique_keys_.data<int>(),
-        allreduce_wgrad.unique_keys.data<KeyType>(),
-        allreduce_wgrad.num_unique_keys.data<uint64_t>(), num_allgather_keys, stream);
+        unique_wgrad.unique_keys.data<KeyType>(), unique_wgrad.num_unique_keys.data<uint64_t>(),
+        num_keys, stream);
     cub::DeviceSelect::Flagged(
         temp_storage.d_temp_select_unique_keys_in_allgather_unique_keys_.data(),
-        select_unique_keys_temp_nbytes, broadcast_result.allgather_table_ids_.data<int>(),
+        select_unique_keys_temp_nbytes, table_ids.data<int>(),
         temp_storage.mask_unique_keys_in_allgather_unique_keys_.data<int>(),
-        allreduce_wgrad.table_ids.data<int>(), allreduce_wgrad.num_unique_keys.data<uint64_t>(),
-        num_allgather_keys, stream);
-
-    // 4. ev_start_indices
-    HCTR_LIB_THROW(cudaMemsetAsync(allreduce_wgrad.ev_start_indices.data(), 0,
-                                   allreduce_wgrad.ev_start_indices.num_bytes(), stream));
-    table_id_to_ev_size_kernel<<<grid_size, block_size, 0, stream>>>(
-        allreduce_wgrad.table_ids.data<int>(), allreduce_wgrad.num_unique_keys.data<uint64_t>(),
-        allreduce_wgrad.attr.table_id_to_ev_size.data<int>(),
-        allreduce_wgrad.ev_start_indices.data<uint32_t>() + 1);
-
-    // 5. cal_allreduce_ev_start_indices
-    size_t scan_ev_start_indices_temp_nbytes =
-        temp_storage.d_temp_scan_ev_start_indices_storage_.num_bytes();
-    cub::DeviceScan::InclusiveSum(temp_storage.d_temp_scan_ev_start_indices_storage_.data(),
-                                  scan_ev_start_indices_temp_nbytes,
-                                  allreduce_wgrad.ev_start_indices.data<int>(),
-                                  allreduce_wgrad.ev_start_indices.data<int>(),
-                                  allreduce_wgrad.ev_start_indices.num_elements(), stream);
+        unique_wgrad.table_ids.data<int>(), unique_wgrad.num_unique_keys.data<uint64_t>(),
+        num_keys, stream);
   });
+
+  // 4. ev_start_indices
+  cal_ev_start_indices(core, temp_storage, unique_wgrad);
 }
 
 void init_key_to_ev_start_indices_hash_table(const std::shared_ptr<core::CoreResourceManager>& core,
@@ -441,6 +663,56 @@ void cal_local_reduce_ev_start_indices(const std::shared_ptr<core::CoreResourceM
   });
 }
 
+// All-gathers the unique keys that each gpu owns into the keys of the all-reduced wgrad.
+void allgather_owner_keys(const std::shared_ptr<core::CoreResourceManager>& core,
+                          SparseAllreduceCalEVStartIndicesStorage& storage,
+                          Wgrad& allreduce_wgrad) {
+  cudaStream_t stream = core->get_local_gpu()->get_stream();
+  ncclComm_t comm = core->get_nccl();
+  int num_gpus = core->get_global_gpu_count();
+  int gpu_id = core->get_global_gpu_id();
+  const Wgrad& owner_wgrad = storage.owner_wgrad_;
+
+  // 1. collect the number of keys and wgrad elements of each owner
+  uint64_t* allgather_counts = storage.allgather_counts_.data<uint64_t>();
+  cal_owner_counts_kernel<<<1, 1, 0, stream>>>(owner_wgrad.num_unique_keys.data<uint64_t>(),
+                                               owner_wgrad.ev_start_indices.data<uint32_t>(),
+                                               allgather_counts + 2 * gpu_id);
+  HCTR_LIB_THROW(ncclAllGather(allgather_counts + 2 * gpu_id, allgather_counts, 2, ncclUint64,
+                               comm, stream));
+  core23::copy_async(storage.h_allgather_counts_, storage.allgather_counts_, stream);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  auto key_type = owner_wgrad.unique_keys.data_type();
+  auto nccl_key_type = core23::get_nccl_dtype_from_tensor_scalar_type_core23(key_type.type());
+
+  // 2. broadcast unique keys and table ids of each owner
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type.type(), key_t, [&] {
+    const uint64_t* h_allgather_counts = storage.h_allgather_counts_.data<uint64_t>();
+    uint64_t count_offset = 0;
+
+    HCTR_LIB_THROW(ncclGroupStart());
+    for (int root = 0; root < num_gpus; ++root) {
+      uint64_t num_unique_keys = h_allgather_counts[2 * root];
+      if (num_unique_keys > 0) {
+        HCTR_LIB_THROW(ncclBroadcast(owner_wgrad.unique_keys.data<key_t>(),
+                                     allreduce_wgrad.unique_keys.data<key_t>() + count_offset,
+                                     num_unique_keys, nccl_key_type, root, comm, stream));
+        HCTR_LIB_THROW(ncclBroadcast(owner_wgrad.table_ids.data<int>(),
+                                     allreduce_wgrad.table_ids.data<int>() + count_offset,
+                                     num_unique_keys, ncclInt32, root, comm, stream));
+      }
+      count_offset += num_unique_keys;
+    }
+    HCTR_LIB_THROW(ncclGroupEnd());
+  });
+
+  // 3. num_unique_keys / ev_start_indices. The wgrads of each owner are contiguous.
+  sum_key_counts_kernel<<<1, 1, 0, stream>>>(allgather_counts, num_gpus,
+                                             allreduce_wgrad.num_unique_keys.data<uint64_t>());
+  cal_ev_start_indices(core, storage.temp_storage_, allreduce_wgrad);
+}
+
 void SparseAllreduceIndexCalculation::cal_for_sparse_input(const EmbeddingInput& embedding_input,
                                                            ReductionIndices& reduction_indices,
                                                            Wgrad& local_reduce_wgrad,
@@ -449,18 +721,97 @@ void SparseAllreduceIndexCalculation::cal_for_sparse_input(const EmbeddingInput&
   local_reduce_index_calculation_.cal_for_sparse_input(embedding_input, segmented_sort_device_,
                                                        segmented_unique_, reduction_indices,
                                                        local_reduce_wgrad, batch_size_per_gpu);
-  if (embedding_input.h_num_keys == 0) return;
-  broadcast_unique_keys(core_, local_reduce_wgrad, cal_ev_start_indices_storage_.broadcast_result_);
+  // All gpus take part in the exchange, including those without keys.
+  auto& storage = cal_ev_start_indices_storage_;
+  partition_unique_keys(core_, local_reduce_wgrad, storage.partition_result_,
+                        storage.temp_storage_);
+
+  size_t num_recv_keys = all2all_unique_keys(core_, storage.partition_result_, storage.recv_wgrad_);
+
+  cal_unique_keys_and_ev_start_indices(core_, storage.recv_wgrad_.unique_keys,
+                                       storage.recv_wgrad_.table_ids, num_recv_keys,
+                                       storage.temp_storage_, storage.hash_table_,
+                                       storage.owner_wgrad_);
+
+  // Position of each received wgrad in the owned wgrads, and in the received ones.
+  init_key_to_ev_start_indices_hash_table(core_, storage.owner_wgrad_, storage.hash_table_);
+  Wgrad recv_dst_wgrad = storage.recv_wgrad_;
+  recv_dst_wgrad.ev_start_indices = storage.recv_dst_ev_start_indices_;
+  cal_local_reduce_ev_start_indices(core_, storage.hash_table_, recv_dst_wgrad);
+  cal_ev_start_indices(core_, storage.temp_storage_, storage.recv_wgrad_);
+
+  allgather_owner_keys(core_, storage, allreduce_wgrad);
+}
 
-  cal_allreduce_wgrad(core_, cal_ev_start_indices_storage_.broadcast_result_,
-                      cal_ev_start_indices_storage_.temp_storage_,
-                      cal_ev_start_indices_storage_.hash_table_, allreduce_wgrad);
+void SparseAllreduceIndexCalculation::reduce_scatter_and_allgather(const Wgrad& local_reduce_wgrad,
+                                                                   Wgrad& allreduce_wgrad) {
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+  ncclComm_t comm = core_->get_nccl();
+  int num_gpus = core_->get_global_gpu_count();
+  int gpu_id = core_->get_global_gpu_id();
+  auto& storage = cal_ev_start_indices_storage_;
+  Wgrad& recv_wgrad = storage.recv_wgrad_;
+  Wgrad& owner_wgrad = storage.owner_wgrad_;
+
+  const uint64_t* h_send_counts = storage.partition_result_.h_send_counts_.data<uint64_t>();
+  const uint64_t* h_recv_counts = storage.partition_result_.h_recv_counts_.data<uint64_t>();
+  const uint64_t* h_allgather_counts = storage.h_allgather_counts_.data<uint64_t>();
+  auto wgrad_type = local_reduce_wgrad.data.data_type();
+  auto nccl_wgrad_type = core23::get_nccl_dtype_from_tensor_scalar_type_core23(wgrad_type.type());
+
+  DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad_type.type(), emb_t, [&] {
+    // 1. send the local reduced wgrads to their owners
+    uint64_t send_offset = 0;
+    uint64_t recv_offset = 0;
+    HCTR_LIB_THROW(ncclGroupStart());
+    for (int peer = 0; peer < num_gpus; ++peer) {
+      uint64_t send_num_elements = h_send_counts[2 * peer + 1];
+      uint64_t recv_num_elements = h_recv_counts[2 * peer + 1];
+      if (send_num_elements > 0) {
+        HCTR_LIB_THROW(ncclSend(local_reduce_wgrad.data.data<emb_t>() + send_offset,
+                                send_num_elements, nccl_wgrad_type, peer, comm, stream));
+      }
+      if (recv_num_elements > 0) {
+        HCTR_LIB_THROW(ncclRecv(recv_wgrad.data.data<emb_t>() + recv_offset, recv_num_elements,
+                                nccl_wgrad_type, peer, comm, stream));
+      }
+      send_offset += send_num_elements;
+      recv_offset += recv_num_elements;
+    }
+    HCTR_LIB_THROW(ncclGroupEnd());
 
-  init_key_to_ev_start_indices_hash_table(core_, allreduce_wgrad,
-                                          cal_ev_start_indices_storage_.hash_table_);
+    // 2. add up the wgrads of each owned key. Each gpu sends every key at most once, so adding
+    // the wgrads of one gpu after the other needs no atomics, and is deterministic.
+    HCTR_LIB_THROW(cudaMemsetAsync(owner_wgrad.data.data(), 0,
+                                   h_allgather_counts[2 * gpu_id + 1] * sizeof(emb_t), stream));
+    int block_size = 256;
+    uint64_t key_offset = 0;
+    for (int peer = 0; peer < num_gpus; ++peer) {
+      uint64_t recv_num_keys = h_recv_counts[2 * peer];
+      if (recv_num_keys == 0) continue;
+      int grid_size = get_grid_size(core_, recv_num_keys * 32, block_size);
+      add_recv_wgrad_kernel<<<grid_size, block_size, 0, stream>>>(
+          recv_wgrad.data.data<emb_t>(), recv_wgrad.ev_start_indices.data<uint32_t>(),
+          recv_wgrad.table_ids.data<int>(), recv_wgrad.attr.table_id_to_ev_size.data<int>(),
+          storage.recv_dst_ev_start_indices_.data<uint32_t>(), key_offset,
+          key_offset + recv_num_keys, owner_wgrad.data.data<emb_t>());
+      key_offset += recv_num_keys;
+    }
 
-  cal_local_reduce_ev_start_indices(core_, cal_ev_start_indices_storage_.hash_table_,
-                                    local_reduce_wgrad);
+    // 3. broadcast the reduced wgrads of each owner
+    uint64_t ev_offset = 0;
+    HCTR_LIB_THROW(ncclGroupStart());
+    for (int root = 0; root < num_gpus; ++root) {
+      uint64_t num_elements = h_allgather_counts[2 * root + 1];
+      if (num_elements > 0) {
+        HCTR_LIB_THROW(ncclBroadcast(owner_wgrad.data.data<emb_t>(),
+                                     allreduce_wgrad.data.data<emb_t>() + ev_offset, num_elements,
+                                     nccl_wgrad_type, root, comm, stream));
+      }
+      ev_offset += num_elements;
+    }
+    HCTR_LIB_THROW(ncclGroupEnd());
+  });
 }
 
 }  // namespace embedding
@@ -52,28 +52,53 @@ struct DenseAllreduceIndexCalculation {
                              ReductionIndices& reduction_indices, Wgrad& wgrad, int batch_size);
 };
 
-struct BroadcastResult {
-  core23::Tensor allgather_num_unique_keys_;    // uint64_t, [num_gpus]
-  core23::Tensor h_allgather_num_unique_keys_;  // uint64_t, [num_gpus]
-  core23::Tensor allgather_unique_keys_;
-  core23::Tensor allgather_table_ids_;
-  size_t num_allgather_keys_;
+// Local unique keys, partitioned by the gpu that owns them by hash.
+struct SparseAllreducePartitionResult {
+  core23::Tensor owner_ids_;              // int
+  core23::Tensor sorted_owner_ids_;       // int
+  core23::Tensor partition_ids_;          // uint32_t
+  core23::Tensor sorted_partition_ids_;   // uint32_t, local unique key id of each sent key
+  core23::Tensor send_keys_;
+  core23::Tensor send_table_ids_;         // int
+  core23::Tensor send_ev_start_indices_;  // uint32_t
+  size_t h_num_keys_;
+
+  // Number of keys and of wgrad elements exchanged with each gpu, interleaved.
+  core23::Tensor send_counts_;    // uint64_t, [num_gpus * 2]
+  core23::Tensor h_send_counts_;  // uint64_t, [num_gpus * 2]
+  core23::Tensor recv_counts_;    // uint64_t, [num_gpus * 2]
+  core23::Tensor h_recv_counts_;  // uint64_t, [num_gpus * 2]
 };
 
 struct SparseAllreduceCalEVStartIndicesTempStorage {
   core23::Tensor mask_unique_keys_in_allgather_unique_keys_;  // int
   core23::Tensor d_temp_select_unique_keys_in_allgather_unique_keys_;
   core23::Tensor d_temp_scan_ev_start_indices_storage_;
+  core23::Tensor d_temp_sort_owner_ids_storage_;
 };
 
 struct SparseAllreduceCalEVStartIndicesStorage {
-  BroadcastResult broadcast_result_;
+  SparseAllreducePartitionResult partition_result_;
+
+  // Keys and wgrads received from all gpus, in the order of the gpus.
+  Wgrad recv_wgrad_;
+  core23::Tensor recv_dst_ev_start_indices_;  // uint32_t, of each received key in owner_wgrad_
+
+  // Unique keys owned by this gpu, and the sum of their wgrads over all gpus.
+  Wgrad owner_wgrad_;
+
+  // Number of keys and of wgrad elements owned by each gpu, interleaved.
+  core23::Tensor allgather_counts_;    // uint64_t, [num_gpus * 2]
+  core23::Tensor h_allgather_counts_;  // uint64_t, [num_gpus * 2]
+
   core23::Tensor hash_table_;
   SparseAllreduceCalEVStartIndicesTempStorage temp_storage_;
 
   SparseAllreduceCalEVStartIndicesStorage() = default;
 
   SparseAllreduceCalEVStartIndicesStorage(std::shared_ptr<CoreResourceManager> core,
+                                          const EmbeddingCollectionParam& ebc_param,
+                                          size_t grouped_id, const WgradAttr& wgrad_attr,
                                           int local_hotness_sum, int batch_size_per_gpu,
                                           core23::DataType key_type);
 };
@@ -87,9 +112,16 @@ struct SparseAllreduceIndexCalculation {
 
   SparseAllreduceCalEVStartIndicesStorage cal_ev_start_indices_storage_;
 
+  // Sends the local unique keys to the gpus that own them, and all-gathers the unique keys of
+  // all owners into allreduce_wgrad. The local reduce writes the wgrads of local_reduce_wgrad in
+  // the order in which they are sent.
   void cal_for_sparse_input(const EmbeddingInput& embedding_input,
                             ReductionIndices& reduction_indices, Wgrad& local_reduce_wgrad,
                             Wgrad& allreduce_wgrad, int batch_size_per_gpu);
+
+  // Reduce-scatters the local reduced wgrads to their owners, and all-gathers the reduced
+  // wgrads into allreduce_wgrad. The traffic scales with the number of global unique keys.
+  void reduce_scatter_and_allgather(const Wgrad& local_reduce_wgrad, Wgrad& allreduce_wgrad);
 };
 
 struct DPLocalReduceIndexCalculation {
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <embedding/common.hpp>
+
+namespace embedding {
+
+// MurmurHash64A of one 64-bit key.
+__host__ __device__ inline uint64_t murmur_hash_key(uint64_t key, uint64_t seed) {
+  constexpr uint64_t m = 0xc6a4a7935bd1e995ULL;
+  constexpr int r = 47;
+  uint64_t h = seed ^ (sizeof(uint64_t) * m);
+  key *= m;
+  key ^= key >> r;
+  key *= m;
+  h ^= key;
+  h *= m;
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+__host__ __device__ inline uint64_t xxhash_rotl(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+// XXH64 of one 64-bit key.
+__host__ __device__ inline uint64_t xxhash_key(uint64_t key, uint64_t seed) {
+  constexpr uint64_t p1 = 0x9e3779b185ebca87ULL;
+  constexpr uint64_t p2 = 0xc2b2ae3d27d4eb4fULL;
+  constexpr uint64_t p3 = 0x165667b19e3779f9ULL;
+  constexpr uint64_t p4 = 0x85ebca77c2b2ae63ULL;
+  constexpr uint64_t p5 = 0x27d4eb2f165667c5ULL;
+  uint64_t h = seed + p5 + sizeof(uint64_t);
+  h ^= xxhash_rotl(key * p2, 31) * p1;
+  h = xxhash_rotl(h, 27) * p1 + p4;
+  h ^= h >> 33;
+  h *= p2;
+  h ^= h >> 29;
+  h *= p3;
+  h ^= h >> 32;
+  return h;
+}
+
+__host__ __device__ inline uint64_t feature_hash_key(uint64_t key, uint64_t seed,
+                                                     FeatureHashFunction hash_function) {
+  return hash_function == FeatureHashFunction::XXHash ? xxhash_key(key, seed)
+                                                      : murmur_hash_key(key, seed);
+}
+
+// Key of a hashed feature. A num_buckets of 0 keeps the full hash.
+__host__ __device__ inline uint64_t hash_feature_key(uint64_t key, uint64_t seed,
+                                                     uint64_t num_buckets,
+                                                     FeatureHashFunction hash_function) {
+  uint64_t hash = feature_hash_key(key, seed, hash_function);
+  return num_buckets == 0 ? hash : hash % num_buckets;
+}
+
+// Key of a crossed feature. The hash of the first key seeds the hash of the second one, so that
+// crosses are not symmetric.
+__host__ __device__ inline uint64_t cross_feature_keys(uint64_t key, uint64_t cross_key,
+                                                       uint64_t seed, uint64_t num_buckets,
+                                                       FeatureHashFunction hash_function) {
+  uint64_t hash =
+      feature_hash_key(cross_key, feature_hash_key(key, seed, hash_function), hash_function);
+  return num_buckets == 0 ? hash : hash % num_buckets;
+}
+
+}  // namespace embedding
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <embedding/common.hpp>
 #include <embedding/view.hpp>
 #include <utils.cuh>
@@ -411,6 +412,51 @@ __global__ void multi_to_one_warp_per_ev_vec4_kernel(CopyDesc copy_desc) {
   }
 }
 
+// Pools embedding vectors of a compile-time size with full vec4 accesses. Vectors of less
+// than 128 elements are pooled by a part of a warp, so that all lanes load data.
+template <typename CopyDesc, int kEvSize>
+__global__ void multi_to_one_fixed_ev_vec4_kernel(CopyDesc copy_desc) {
+  using src_type = typename CopyDesc::SrcT;
+  using dst_type = typename CopyDesc::DstT;
+
+  constexpr int copy_width = 4;
+  constexpr int kWarpSize = 32;
+  static_assert(kEvSize % copy_width == 0, "ev size must be a multiple of 4.");
+  constexpr int kLanesPerEv = kEvSize / copy_width < kWarpSize ? kEvSize / copy_width : kWarpSize;
+  constexpr int kVec4PerLane = kEvSize / (copy_width * kLanesPerEv);
+
+  int lane_id = threadIdx.x % kLanesPerEv;
+  int i_ev = (blockIdx.x * blockDim.x + threadIdx.x) / kLanesPerEv;
+  if (i_ev < copy_desc.num_vec_) {
+    int average_pooling_factor = copy_desc.get_average_pooling_factor(i_ev);
+
+    int start = copy_desc.get_offset(i_ev);
+    int end = copy_desc.get_offset(i_ev + 1);
+
+    dst_type *dst_ev = copy_desc.get_dst_ptr(i_ev);
+
+    Vec4T<float> accum[kVec4PerLane];
+    for (int r = start; r < end; ++r) {
+      const src_type *src_ev = copy_desc.get_src_ptr(r);
+#pragma unroll
+      for (int i = 0; i < kVec4PerLane; ++i) {
+        Vec4T<float> src_elem;
+        src_elem.load(src_ev + copy_width * (kLanesPerEv * i + lane_id), copy_width);
+        accum[i].accumulate(src_elem);
+      }
+    }
+
+#pragma unroll
+    for (int i = 0; i < kVec4PerLane; ++i) {
+      accum[i].val.x /= average_pooling_factor;
+      accum[i].val.y /= average_pooling_factor;
+      accum[i].val.z /= average_pooling_factor;
+      accum[i].val.w /= average_pooling_factor;
+      accum[i].store(dst_ev + copy_width * (kLanesPerEv * i + lane_id), copy_width);
+    }
+  }
+}
+
 template <typename CopyDesc, int kMaxElemPerThread>
 __global__ void multi_to_one_weight_cta_per_ev_kernel(CopyDesc copy_desc) {
   using src_type = typename CopyDesc::SrcT;
@@ -1338,6 +1384,43 @@ void copy_multi_to_one(CopyDesc copy_desc, const HugeCTR::core23::KernelParams &
   }
 }
 
+// Uses the kernels specialized for uniform_ev_size, if all vectors have one of the common sizes.
+// Otherwise, falls back to the kernels for vectors of up to max_ev_size.
+template <typename CopyDesc>
+void copy_multi_to_one_uniform_ev(CopyDesc copy_desc,
+                                  const HugeCTR::core23::KernelParams &kernel_params,
+                                  int max_ev_size, int uniform_ev_size, cudaStream_t stream) {
+  constexpr int block_size = 256;
+  auto launch = [&](auto kernel, int ev_size) {
+    const int lanes_per_ev = std::min(ev_size / 4, 32);
+    const int64_t num_threads = static_cast<int64_t>(copy_desc.num_vec_) * lanes_per_ev;
+    const int grid_size = static_cast<int>((num_threads - 1) / block_size + 1);
+    kernel<<<grid_size, block_size, 0, stream>>>(copy_desc);
+  };
+  switch (copy_desc.num_vec_ > 0 ? uniform_ev_size : 0) {
+    case 8:
+      launch(multi_to_one_fixed_ev_vec4_kernel<CopyDesc, 8>, 8);
+      break;
+    case 16:
+      launch(multi_to_one_fixed_ev_vec4_kernel<CopyDesc, 16>, 16);
+      break;
+    case 32:
+      launch(multi_to_one_fixed_ev_vec4_kernel<CopyDesc, 32>, 32);
+      break;
+    case 64:
+      launch(multi_to_one_fixed_ev_vec4_kernel<CopyDesc, 64>, 64);
+      break;
+    case 128:
+      launch(multi_to_one_fixed_ev_vec4_kernel<CopyDesc, 128>, 128);
+      break;
+    case 256:
+      launch(multi_to_one_fixed_ev_vec4_kernel<CopyDesc, 256>, 256);
+      break;
+    default:
+      copy_multi_to_one(copy_desc, kernel_params, max_ev_size, stream);
+  }
+}
+
 template <typename CopyDesc>
 void copy_multi_to_one_weight(CopyDesc copy_desc, int max_ev_size, cudaStream_t stream) {
   if (max_ev_size <= 128) {
@@ -355,6 +355,80 @@ void IntraModelForward::intra_forward(const core23::Tensor &evs, const core23::T
   });
 }
 
+// Same as IntraModelForwardMultiToOneDesc, for the samples of one node. A warp pools each bag.
+template <typename emb_t, typename offset_t>
+__global__ void intra_forward_node_kernel(const offset_t *__restrict__ bucket_range_ptr,
+                                          const float **__restrict__ evs_ptr,
+                                          emb_t ***peer_data_ptr,
+                                          const int *__restrict__ id_to_ev_size_ptr,
+                                          const int *__restrict__ dst_id_to_ev_start_indices_ptr,
+                                          int num_local_lookup, int batch_size,
+                                          int batch_size_per_rail, int batch_size_per_node,
+                                          int batch_size_per_gpu, int src_gpu_id,
+                                          int num_local_gpus, int node_id) {
+  int lane_id = threadIdx.x % 32;
+  int num_warps = blockDim.x * gridDim.x / 32;
+  int num_vec = num_local_lookup * batch_size_per_node;
+
+  for (int i_vec = (blockIdx.x * blockDim.x + threadIdx.x) / 32; i_vec < num_vec;
+       i_vec += num_warps) {
+    int i_lookup = i_vec / batch_size_per_node;
+    int node_batch_id = i_vec % batch_size_per_node;
+    int batch_id = node_id * batch_size_per_node + node_batch_id;
+    int i = i_lookup * batch_size + batch_id;
+
+    int local_batch_id = node_id * batch_size_per_gpu + node_batch_id % batch_size_per_gpu;
+    int dst_gpu_id = node_batch_id / batch_size_per_gpu;
+    int ev_size = id_to_ev_size_ptr[i_lookup];
+    emb_t *dst_ev = peer_data_ptr[dst_gpu_id][src_gpu_id] +
+                    batch_size_per_rail * dst_id_to_ev_start_indices_ptr[i_lookup] +
+                    local_batch_id * ev_size;
+
+    int start = static_cast<int>(bucket_range_ptr[i]);
+    int end = static_cast<int>(bucket_range_ptr[i + 1]);
+    for (int e = lane_id; e < ev_size; e += 32) {
+      float accum = 0.f;
+      for (int r = start; r < end; ++r) {
+        accum += evs_ptr[r][e];
+      }
+      dst_ev[e] = HugeCTR::TypeConvertFunc<emb_t, float>::convert(accum);
+    }
+  }
+}
+
+void IntraModelForward::intra_forward(const core23::Tensor &evs, const core23::Tensor &bucket_range,
+                                      IntraModelCommBuffer &intra_model_comm_buffer,
+                                      int batch_size, int node_id) {
+  HugeCTR::CudaDeviceContext context(core_->get_device_id());
+  int local_gpu_id = core_->get_local_gpu_id();
+  int num_local_lookup = intra_model_comm_buffer.attr.num_local_lookup;
+  int num_local_gpus = static_cast<int>(core_->get_local_gpu_count());
+  int num_global_gpus = static_cast<int>(core_->get_global_gpu_count());
+  int batch_size_per_rail = batch_size / num_local_gpus;
+  int batch_size_per_node = batch_size / (num_global_gpus / num_local_gpus);
+  int batch_size_per_gpu = batch_size / num_global_gpus;
+  auto stream = core_->get_local_gpu()->get_stream();
+
+  if (num_local_lookup == 0) return;
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(bucket_range.data_type().type(), offset_t, [&] {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(intra_model_comm_buffer.attr.type.type(), emb_t, [&] {
+      auto peer_data_ptr = reinterpret_cast<emb_t ***>(intra_model_comm_buffer.peer_data.data());
+
+      constexpr int block_size = 256;
+      int num_vec = num_local_lookup * batch_size_per_node;
+      int grid_size = (num_vec * 32 + block_size - 1) / block_size;
+      intra_forward_node_kernel<<<grid_size, block_size, 0, stream>>>(
+          bucket_range.data<offset_t>(), (const float **)evs.data(), peer_data_ptr,
+          intra_model_comm_buffer.attr.id_to_ev_size_in_current_gpu.data<int>(),
+          intra_model_comm_buffer.attr.id_to_ev_start_indices_in_current_gpu.data<int>(),
+          num_local_lookup, batch_size, batch_size_per_rail, batch_size_per_node,
+          batch_size_per_gpu, local_gpu_id, num_local_gpus, node_id);
+      HCTR_LIB_THROW(cudaGetLastError());
+    });
+  });
+}
+
 //
 // batch_size_per_node * num_local_lookup -> num_node * batch_size_per_gpu *
 // num_network_dst_lookup_ids
@@ -364,11 +438,13 @@ struct IntraModelDstReductionMultiToOneDesc {
   using DstT = emb_t;
 
   HOST_DEVICE_INLINE int get_offset(int i) {
+    i += vec_offset;
     int bid = i / num_network_dst_lookup_ids;
     int lookup_id = i % num_network_dst_lookup_ids;
     return bid * network_offsets_ptr[num_network_dst_lookup_ids] + network_offsets_ptr[lookup_id];
   }
   HOST_DEVICE_INLINE int get_vec_length(int i) {
+    i += vec_offset;
     return dst_id_to_ev_size_ptr[i % num_network_dst_lookup_ids];
   }
   HOST_DEVICE_INLINE int get_average_pooling_factor(int i) { return 1; }
@@ -385,6 +461,7 @@ struct IntraModelDstReductionMultiToOneDesc {
     return model_comm_buffer_ptr[network_gpu_id] + ev_offset + bid * ev_size;
   }
   HOST_DEVICE_INLINE DstT *get_dst_ptr(int i) {
+    i += vec_offset;
     int bid = i / num_network_dst_lookup_ids;
     int node_id = bid / batch_size_per_gpu;
     int local_bid = bid % batch_size_per_gpu;
@@ -414,17 +491,33 @@ struct IntraModelDstReductionMultiToOneDesc {
   int batch_size_per_gpu;
   int batch_size_per_rail;
   int num_network_dst_lookup_ids;
+
+  // Index of the first vector, when only the samples of some nodes are reduced. Source indices
+  // are derived from get_offset, so they are already absolute.
+  int vec_offset;
 };
 
 void IntraModelForward::dst_reduction(const IntraModelCommBuffer &intra_model_comm_buffer,
                                       IntraModelReductionBuffer &reduction_buffer, int batch_size) {
+  int num_node = static_cast<int>(core_->get_global_gpu_count() / core_->get_local_gpu_count());
+  dst_reduction(intra_model_comm_buffer, reduction_buffer, batch_size, 0, num_node);
+}
+
+void IntraModelForward::dst_reduction(const IntraModelCommBuffer &intra_model_comm_buffer,
+                                      IntraModelReductionBuffer &reduction_buffer, int batch_size,
+                                      int node_id) {
+  dst_reduction(intra_model_comm_buffer, reduction_buffer, batch_size, node_id, 1);
+}
+
+void IntraModelForward::dst_reduction(const IntraModelCommBuffer &intra_model_comm_buffer,
+                                      IntraModelReductionBuffer &reduction_buffer, int batch_size,
+                                      int first_node_id, int num_reduced_node) {
   HugeCTR::CudaDeviceContext context(core_->get_device_id());
   HCTR_CHECK(intra_model_comm_buffer.attr.type == reduction_buffer.attr.type);
   auto emb_type = intra_model_comm_buffer.attr.type;
 
   int num_local_gpus = static_cast<int>(core_->get_local_gpu_count());
   int num_global_gpus = static_cast<int>(core_->get_global_gpu_count());
-  int num_node = num_global_gpus / num_local_gpus;
 
   int batch_size_per_gpu = batch_size / num_global_gpus;
   int batch_size_per_rail = batch_size / num_local_gpus;
@@ -439,7 +532,7 @@ void IntraModelForward::dst_reduction(const IntraModelCommBuffer &intra_model_co
 
     using CopyDesc = IntraModelDstReductionMultiToOneDesc<emb_t>;
     CopyDesc multi_to_one_desc{
-        batch_size_per_gpu * num_node * num_network_dst_lookup_ids,
+        batch_size_per_gpu * num_reduced_node * num_network_dst_lookup_ids,
         (const emb_t **)intra_model_comm_buffer.local_datas_device_view.data(),
         (emb_t **)reduction_buffer.data.data(),
         reduction_buffer.attr.indices.network_ids.data<int>(),
@@ -452,6 +545,7 @@ void IntraModelForward::dst_reduction(const IntraModelCommBuffer &intra_model_co
         batch_size_per_gpu,
         batch_size_per_rail,
         num_network_dst_lookup_ids,
+        batch_size_per_gpu * first_node_id * num_network_dst_lookup_ids,
     };
     copy_multi_to_one(multi_to_one_desc, intra_model_comm_buffer.attr.max_ev_size, stream);
   });
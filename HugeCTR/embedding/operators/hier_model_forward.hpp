@@ -95,7 +95,21 @@ struct IntraModelForward {
   void intra_forward(const core23::Tensor &evs, const core23::Tensor &bucket_range,
                      IntraModelCommBuffer &intra_model_comm_buffer, int batch_size);
 
+  // Only sends the samples of the gpus in node_id, to pipeline them with the inter node
+  // all-to-all.
+  void intra_forward(const core23::Tensor &evs, const core23::Tensor &bucket_range,
+                     IntraModelCommBuffer &intra_model_comm_buffer, int batch_size, int node_id);
+
   void dst_reduction(const IntraModelCommBuffer &intra_model_comm_buffer,
                      IntraModelReductionBuffer &reduction_buffer, int batch_size);
+
+  // Only reduces the samples of the gpus in node_id.
+  void dst_reduction(const IntraModelCommBuffer &intra_model_comm_buffer,
+                     IntraModelReductionBuffer &reduction_buffer, int batch_size, int node_id);
+
+  // Reduces the samples of the gpus in [first_node_id, first_node_id + num_reduced_node).
+  void dst_reduction(const IntraModelCommBuffer &intra_model_comm_buffer,
+                     IntraModelReductionBuffer &reduction_buffer, int batch_size,
+                     int first_node_id, int num_reduced_node);
 };
 }  // namespace embedding
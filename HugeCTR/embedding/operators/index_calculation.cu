@@ -14,8 +14,10 @@
  * limitations under the License.
  */
 
+#include <core23/scratch_arena.hpp>
 #include <cub/cub.cuh>
 #include <embedding/common.hpp>
+#include <embedding/data_distributor/data_compression_operators.cuh>
 #include <embedding/operators/dp_index_calculation.hpp>
 #include <embedding/operators/index_calculation.hpp>
 #include <embedding/operators/mp_index_calculation.hpp>
@@ -139,21 +141,6 @@ void IndexCalculationTempStorage::init(const std::shared_ptr<CoreResourceManager
 
   this->flag = core23::Tensor(params.shape({batch_size_before_filter * max_num_keys_before_filter})
                                   .data_type(core23::ScalarType::Char));
-  {
-    size_t temp_bytes = 0;
-    cub::DeviceSelect::Flagged(nullptr, temp_bytes, (uint64_t *)nullptr, (char *)nullptr,
-                               (uint64_t *)nullptr, (size_t *)nullptr,
-                               batch_size_before_filter * max_num_keys_before_filter);
-    this->temp_select_storage = core23::Tensor(
-        params.shape({static_cast<int64_t>(temp_bytes)}).data_type(core23::ScalarType::Char));
-  }
-  {
-    size_t temp_bytes = 0;
-    cub::DeviceScan::InclusiveSum(nullptr, temp_bytes, (uint64_t *)nullptr, (uint32_t *)nullptr,
-                                  batch_size_after_filter * num_lookup + 1);
-    this->temp_scan_storage = core23::Tensor(
-        params.shape({static_cast<int64_t>(temp_bytes)}).data_type(core23::ScalarType::Char));
-  }
 }
 
 template <>
@@ -206,17 +193,26 @@ void IndexCalculation<KeySelector>::filter_sparse_input(const core23::Tensor &ke
           key_selector_gpu, key_selector_gpu.keys_ptr, bucket_range_after_filter,
           temp_storage_.flag.data<char>(), result.bucket_range.num_elements() - 1);
 
-      size_t temp_scan_storage_nbytes = temp_storage_.temp_scan_storage.num_bytes();
-      cub::DeviceScan::InclusiveSum(temp_storage_.temp_scan_storage.data(),
-                                    temp_scan_storage_nbytes, bucket_range_after_filter,
-                                    bucket_range_after_filter, result.bucket_range.num_elements(),
-                                    stream);
-
-      size_t temp_select_storage_nbytes = temp_storage_.temp_select_storage.num_bytes();
-      cub::DeviceSelect::Flagged(temp_storage_.temp_select_storage.data(),
-                                 temp_select_storage_nbytes, keys_ptr,
-                                 temp_storage_.flag.data<char>(), keys_after_filter,
-                                 result.num_keys.data<size_t>(), keys.num_elements(), stream);
+      // The scan and the select run one after another, so they share the scratch memory.
+      core23::ScratchArena &arena = core23::ScratchArena::get(core_->get_device_id(), stream);
+      {
+        size_t temp_bytes = 0;
+        cub::DeviceScan::InclusiveSum(nullptr, temp_bytes, (offset_t *)nullptr,
+                                      (offset_t *)nullptr, result.bucket_range.num_elements());
+        core23::ScratchArena::Scope scratch(arena);
+        cub::DeviceScan::InclusiveSum(scratch.allocate(temp_bytes), temp_bytes,
+                                      bucket_range_after_filter, bucket_range_after_filter,
+                                      result.bucket_range.num_elements(), stream);
+      }
+      {
+        size_t temp_bytes = 0;
+        cub::DeviceSelect::Flagged(nullptr, temp_bytes, (key_t *)nullptr, (char *)nullptr,
+                                   (key_t *)nullptr, (size_t *)nullptr, keys.num_elements());
+        core23::ScratchArena::Scope scratch(arena);
+        cub::DeviceSelect::Flagged(scratch.allocate(temp_bytes), temp_bytes, keys_ptr,
+                                   temp_storage_.flag.data<char>(), keys_after_filter,
+                                   result.num_keys.data<size_t>(), keys.num_elements(), stream);
+      }
       HCTR_LIB_THROW(cudaStreamSynchronize(stream));
       result.h_num_keys = static_cast<size_t>(result.num_keys.data<uint64_t>()[0]);
     });
@@ -568,6 +564,165 @@ void IndicesSort::operator()(embedding::SortInput &input, embedding::SortOutput
   });
 }
 
+constexpr uint32_t kEmptySlot = std::numeric_limits<uint32_t>::max();
+
+// Inserts each key into the slot of its key and table, whose owner is the first key that claimed
+// it. The keys of a table are [table_range[t], table_range[t + 1]).
+template <typename key_t>
+__global__ void insert_keys_into_slots_kernel(const key_t *__restrict__ keys,
+                                              const int *__restrict__ table_range, int num_table,
+                                              uint32_t num_key, uint32_t capacity_mask,
+                                              uint32_t *slot_owners, uint32_t *group_sizes,
+                                              uint32_t *key_slots, uint32_t *key_ranks) {
+  CUDA_1D_KERNEL_LOOP(i, num_key) {
+    const key_t key = keys[i];
+    const int table_index =
+        static_cast<int>(bs_upper_bound_sub_one(table_range, num_table + 1, static_cast<int>(i)));
+    const uint32_t table_start = table_range[table_index];
+    const uint32_t table_end = table_range[table_index + 1];
+
+    uint32_t pos =
+        static_cast<uint32_t>(HugeCTR::Hash()(HugeCTR::KeyPair<key_t>{key, table_index})) &
+        capacity_mask;
+    while (true) {
+      uint32_t owner = atomicCAS(slot_owners + pos, kEmptySlot, static_cast<uint32_t>(i));
+      if (owner == kEmptySlot) owner = i;
+      if (owner >= table_start && owner < table_end && keys[owner] == key) {
+        key_slots[i] = pos;
+        key_ranks[i] = atomicAdd(group_sizes + pos, 1u);
+        break;
+      }
+      pos = (pos + 1) & capacity_mask;
+    }
+  }
+}
+
+__global__ void get_group_size_of_owners_kernel(const uint32_t *__restrict__ slot_owners,
+                                                const uint32_t *__restrict__ group_sizes,
+                                                const uint32_t *__restrict__ key_slots,
+                                                uint32_t num_key, uint32_t *group_offsets) {
+  CUDA_1D_KERNEL_LOOP(i, num_key) {
+    const uint32_t slot = key_slots[i];
+    group_offsets[i] = slot_owners[slot] == i ? group_sizes[slot] : 0;
+  }
+}
+
+// Owners precede the keys of their group within the table, so the exclusive sum of the group sizes
+// at the owners keeps each table in its range.
+template <typename key_t>
+__global__ void scatter_keys_by_group_kernel(
+    const key_t *__restrict__ keys, const uint32_t *__restrict__ src_ids,
+    const uint32_t *__restrict__ slot_owners, const uint32_t *__restrict__ key_slots,
+    const uint32_t *__restrict__ key_ranks, const uint32_t *__restrict__ group_offsets,
+    uint32_t num_key, key_t *grouped_keys, uint32_t *grouped_src_ids) {
+  CUDA_1D_KERNEL_LOOP(i, num_key) {
+    const uint32_t pos = group_offsets[slot_owners[key_slots[i]]] + key_ranks[i];
+    grouped_keys[pos] = keys[i];
+    grouped_src_ids[pos] = src_ids[i];
+  }
+}
+
+HashGroupKeys::HashGroupKeys(const std::shared_ptr<CoreResourceManager> &core,
+                             core23::Tensor sorted_table_ids, int max_num_keys, int batch_size,
+                             int num_lookup, int num_table, core23::DataType key_type)
+    : sorted_table_ids_(sorted_table_ids),
+      num_lookup_(num_lookup),
+      num_table_(num_table),
+      batch_size_(batch_size) {
+  HugeCTR::CudaDeviceContext context(core->get_device_id());
+
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  max_key_num_ = ((size_t)max_num_keys) * ((size_t)batch_size);
+  HCTR_CHECK_HINT(max_key_num_ < kEmptySlot, "HashGroupKeys supports less than 2^32 keys.");
+
+  // Keep the load factor of the hash table at most 0.5.
+  capacity_ = 1;
+  while (capacity_ < 2 * max_key_num_) capacity_ *= 2;
+  slot_owners_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(capacity_)}).data_type(core23::ScalarType::UInt32));
+  group_sizes_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(capacity_)}).data_type(core23::ScalarType::UInt32));
+  key_slots_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(max_key_num_)}).data_type(core23::ScalarType::UInt32));
+  key_ranks_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(max_key_num_)}).data_type(core23::ScalarType::UInt32));
+  group_offsets_ = core23::Tensor(
+      params.shape({static_cast<int64_t>(max_key_num_)}).data_type(core23::ScalarType::UInt32));
+  {
+    size_t temp_bytes = 0;
+    cub::DeviceScan::ExclusiveSum(nullptr, temp_bytes, (uint32_t *)nullptr, (uint32_t *)nullptr,
+                                  max_key_num_);
+    temp_scan_storage_ = core23::Tensor(
+        params.shape({static_cast<int64_t>(temp_bytes)}).data_type(core23::ScalarType::Char));
+  }
+
+  this->partitioned_table_range =
+      core23::Tensor(params.shape({num_table + 1}).data_type(core23::ScalarType::Int32));
+  {
+    size_t temp_bytes = 0;
+    LessThan select_op(std::numeric_limits<int>::max());
+    cub::DeviceSelect::If(nullptr, temp_bytes, (int *)nullptr, (int *)nullptr, (int *)nullptr,
+                          num_lookup + 1, select_op);
+    this->temp_select_storage = core23::Tensor(
+        params.shape({static_cast<int64_t>(temp_bytes)}).data_type(core23::ScalarType::Char));
+  }
+  this->d_num_selected_table_range_ =
+      core23::Tensor(params.shape({1}).data_type(core23::ScalarType::Int32));
+  this->temp_lookup_range =
+      core23::Tensor(params.shape({num_lookup + 1}).data_type(core23::ScalarType::Int32));
+}
+
+void HashGroupKeys::operator()(embedding::SortInput &input, embedding::SortOutput &output,
+                               std::shared_ptr<CoreResourceManager> core) {
+  auto stream = core->get_local_gpu()->get_stream();
+  auto &bucket_range = input.bucket_range;
+  const int block_size = 256;
+  const int grid_size =
+      core->get_kernel_param().num_sms * core->get_kernel_param().max_thread_per_block / block_size;
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(bucket_range.data_type().type(), offset_t, [&] {
+    cal_table_range_kernel<<<grid_size, block_size, 0, stream>>>(
+        bucket_range.data<offset_t>(), sorted_table_ids_.data<int>(), num_lookup_,
+        temp_lookup_range.data<int>(), batch_size_);
+  });
+  LessThan select_op(std::numeric_limits<int>::max());
+  size_t temp_storage_nbytes = temp_select_storage.num_bytes();
+  cub::DeviceSelect::If(temp_select_storage.data(), temp_storage_nbytes,
+                        temp_lookup_range.data<int>(), partitioned_table_range.data<int>(),
+                        d_num_selected_table_range_.data<int>(), temp_lookup_range.num_elements(),
+                        select_op, stream);
+
+  // Only clear the slots that this batch can use.
+  const uint32_t num_key = static_cast<uint32_t>(input.h_num_key);
+  size_t capacity = 1;
+  while (capacity < 2 * input.h_num_key) capacity *= 2;
+  capacity = std::min(capacity, capacity_);
+  HCTR_LIB_THROW(cudaMemsetAsync(slot_owners_.data(), 0xFF, capacity * sizeof(uint32_t), stream));
+  HCTR_LIB_THROW(cudaMemsetAsync(group_sizes_.data(), 0, capacity * sizeof(uint32_t), stream));
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(input.keys.data_type().type(), key_t, [&] {
+    insert_keys_into_slots_kernel<<<grid_size, block_size, 0, stream>>>(
+        input.keys.data<key_t>(), partitioned_table_range.data<int>(), num_table_, num_key,
+        static_cast<uint32_t>(capacity - 1), slot_owners_.data<uint32_t>(),
+        group_sizes_.data<uint32_t>(), key_slots_.data<uint32_t>(), key_ranks_.data<uint32_t>());
+
+    get_group_size_of_owners_kernel<<<grid_size, block_size, 0, stream>>>(
+        slot_owners_.data<uint32_t>(), group_sizes_.data<uint32_t>(), key_slots_.data<uint32_t>(),
+        num_key, group_offsets_.data<uint32_t>());
+
+    size_t temp_bytes = temp_scan_storage_.num_bytes();
+    cub::DeviceScan::ExclusiveSum(temp_scan_storage_.data(), temp_bytes,
+                                  group_offsets_.data<uint32_t>(), group_offsets_.data<uint32_t>(),
+                                  input.h_num_key, stream);
+
+    scatter_keys_by_group_kernel<<<grid_size, block_size, 0, stream>>>(
+        input.keys.data<key_t>(), input.src_ids.data<uint32_t>(), slot_owners_.data<uint32_t>(),
+        key_slots_.data<uint32_t>(), key_ranks_.data<uint32_t>(), group_offsets_.data<uint32_t>(),
+        num_key, output.sorted_keys.data<key_t>(), output.sorted_src_ids.data<uint32_t>());
+  });
+}
+
 template <typename key_t>
 __global__ void get_keys_flag(const key_t *__restrict__ sorted_keys,
                               const int *__restrict__ table_ids,
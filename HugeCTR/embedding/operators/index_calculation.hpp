@@ -20,10 +20,10 @@
 namespace embedding {
 using core::CoreResourceManager;
 
+// The temp storage of the scan and select of filter_sparse_input is taken from the scratch arena
+// of the stream.
 struct IndexCalculationTempStorage {
   core23::Tensor flag;
-  core23::Tensor temp_select_storage;
-  core23::Tensor temp_scan_storage;
 
   void init(const std::shared_ptr<CoreResourceManager> &core, int max_num_keys_before_filter,
             int max_num_keys_after_filter, int batch_size_before_filter,
@@ -128,6 +128,40 @@ struct SegmentedSortDevice {
   int batch_size_;
 };
 
+// Groups the equal keys of each table with a hash table instead of sorting them. The groups and
+// the keys within a group are in no particular order, which is enough for the local reduce.
+struct HashGroupKeys {
+ public:
+  HashGroupKeys() = default;
+
+  HashGroupKeys(const std::shared_ptr<CoreResourceManager> &core, core23::Tensor sorted_table_ids,
+                int max_num_keys, int batch_size, int num_lookup, int num_table,
+                core23::DataType key_type);
+
+  void operator()(SortInput &input, SortOutput &output, std::shared_ptr<CoreResourceManager> core);
+
+ private:
+  size_t max_key_num_;
+  size_t capacity_;
+
+  core23::Tensor temp_select_storage;
+  core23::Tensor d_num_selected_table_range_;
+  core23::Tensor temp_lookup_range;
+  core23::Tensor partitioned_table_range;
+
+  core23::Tensor slot_owners_;        // uint32_t, index of the first key of each slot
+  core23::Tensor group_sizes_;        // uint32_t, number of keys of each slot
+  core23::Tensor key_slots_;          // uint32_t
+  core23::Tensor key_ranks_;          // uint32_t, position of a key within its group
+  core23::Tensor group_offsets_;      // uint32_t
+  core23::Tensor temp_scan_storage_;  // Void
+
+  core23::Tensor sorted_table_ids_;
+  int num_lookup_;
+  int num_table_;
+  int batch_size_;
+};
+
 struct IndicesSort {
   core23::Tensor d_temp_sort_storage;
 
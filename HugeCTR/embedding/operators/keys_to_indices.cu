@@ -49,7 +49,6 @@ KeysToIndicesConverter::KeysToIndicesConverter(std::shared_ptr<CoreResourceManag
     : core_(core) {
   HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
   int global_gpu_id = core_->get_global_gpu_id();
-  int num_gpus = core_->get_global_gpu_count();
 
   const auto& grouped_lookup_param = ebc_param.grouped_lookup_params[grouped_id];
   const auto& grouped_table_param =
@@ -65,24 +64,17 @@ KeysToIndicesConverter::KeysToIndicesConverter(std::shared_ptr<CoreResourceManag
              TablePlacementStrategy::ModelParallel) {
     h_num_shards_.resize(ebc_param.shard_matrix[0].size());
     for (int table_id : grouped_table_param.table_ids) {
-      if (ebc_param.shard_matrix[global_gpu_id][table_id] == 0) continue;
-      h_local_table_ids_.push_back(table_id);
-
-      std::vector<int> shard_gpu_list;
-      for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
-        HCTR_CHECK_HINT(table_id < static_cast<int>(ebc_param.shard_matrix[gpu_id].size()),
-                        "table_id is out of range");
-        if (ebc_param.shard_matrix[gpu_id][table_id] == 1) {
-          shard_gpu_list.push_back(gpu_id);
-        }
+      HCTR_CHECK_HINT(table_id < static_cast<int>(ebc_param.shard_matrix[global_gpu_id].size()),
+                      "table_id is out of range");
+      if (!ebc_param.has_grouped_table_shard(global_gpu_id, grouped_lookup_param.grouped_table_idx,
+                                             table_id)) {
+        continue;
       }
+      h_local_table_ids_.push_back(table_id);
 
-      int num_shards = static_cast<int>(shard_gpu_list.size());
+      int shard_id, num_shards;
+      ebc_param.get_table_shard_id(global_gpu_id, table_id, &shard_id, &num_shards);
       h_num_shards_[table_id] = num_shards;
-      auto find_shard_id_iter =
-          std::find(shard_gpu_list.begin(), shard_gpu_list.end(), global_gpu_id);
-      HCTR_CHECK(find_shard_id_iter != shard_gpu_list.end());
-      int shard_id = static_cast<int>(std::distance(shard_gpu_list.begin(), find_shard_id_iter));
 
       uint64_t num_keys =
           table_params[table_id].max_vocabulary_size / num_shards +
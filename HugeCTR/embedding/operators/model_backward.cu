@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <core23/scratch_arena.hpp>
+#include <cub/cub.cuh>
 #include <embedding/operators/generic_lookup.cuh>
 #include <embedding/operators/index_calculation.hpp>
 #include <embedding/operators/model_backward.hpp>
@@ -63,8 +65,77 @@ __global__ void mp_cal_src_ptrs_same_ev_size(const T** src_ptr, const uint32_t*
   return;
 }
 
+void OrderedReduceBuffer::init(std::shared_ptr<CoreResourceManager> core, int max_ev_size,
+                               size_t max_input_num) {
+  HugeCTR::CudaDeviceContext ctx(core->get_device_id());
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+
+  // The first level has a partial row per chunk of EV_NUM elements, and each later level EV_NUM
+  // times fewer.
+  int64_t max_partial_num[2];
+  max_partial_num[0] = (max_input_num - 1) / EV_NUM + 1;
+  max_partial_num[1] = (max_partial_num[0] - 1) / EV_NUM + 1;
+  for (int i = 0; i < 2; ++i) {
+    partial_wgrad[i] = core23::Tensor(params.shape({max_partial_num[i] * max_ev_size})
+                                          .data_type(core23::ScalarType::Float));
+    partial_ev_length[i] =
+        core23::Tensor(params.shape({max_partial_num[i]}).data_type(core23::ScalarType::Int32));
+    partial_dst_ids[i] =
+        core23::Tensor(params.shape({max_partial_num[i]}).data_type(core23::ScalarType::UInt32));
+  }
+}
+
+void SortedReduceIndices::init(std::shared_ptr<CoreResourceManager> core, size_t max_input_num) {
+  HugeCTR::CudaDeviceContext ctx(core->get_device_id());
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  core23::TensorParams index_params =
+      params.shape({static_cast<int64_t>(max_input_num)}).data_type(core23::ScalarType::UInt32);
+
+  dst_ids = core23::Tensor(index_params);
+  src_ids = core23::Tensor(index_params);
+  sorted_dst_ids = core23::Tensor(index_params);
+  sorted_src_ids = core23::Tensor(index_params);
+
+  device_id = core->get_device_id();
+}
+
+template <typename offset_t>
+__global__ void init_sorted_reduce_indices_kernel(const offset_t* reverse_idx, size_t num_elements,
+                                                  uint32_t* dst_ids, uint32_t* src_ids) {
+  CUDA_1D_KERNEL_LOOP(i, num_elements) {
+    dst_ids[i] = static_cast<uint32_t>(reverse_idx[i]);
+    src_ids[i] = static_cast<uint32_t>(i);
+  }
+}
+
+void SortedReduceIndices::sort(const core23::Tensor& reverse_idx, size_t num_elements,
+                               cudaStream_t stream) const {
+  if (num_elements == 0) return;
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(reverse_idx.data_type().type(), offset_t, [&] {
+    const int block_size = 256;
+    const int grid_size = (num_elements - 1) / block_size + 1;
+    init_sorted_reduce_indices_kernel<<<grid_size, block_size, 0, stream>>>(
+        reverse_idx.data<offset_t>(), num_elements, dst_ids.data<uint32_t>(),
+        src_ids.data<uint32_t>());
+  });
+  // The radix sort is stable, so the elements of a row keep their order. Its temp storage only
+  // covers the elements of this batch.
+  size_t temp_bytes = 0;
+  cub::DeviceRadixSort::SortPairs(nullptr, temp_bytes, (uint32_t*)nullptr, (uint32_t*)nullptr,
+                                  (uint32_t*)nullptr, (uint32_t*)nullptr,
+                                  static_cast<int64_t>(num_elements), 0, sizeof(uint32_t) * 8);
+  core23::ScratchArena::Scope scratch(core23::ScratchArena::get(device_id, stream));
+  cub::DeviceRadixSort::SortPairs(scratch.allocate(temp_bytes), temp_bytes,
+                                  dst_ids.data<uint32_t>(), sorted_dst_ids.data<uint32_t>(),
+                                  src_ids.data<uint32_t>(), sorted_src_ids.data<uint32_t>(),
+                                  static_cast<int64_t>(num_elements), 0, sizeof(uint32_t) * 8,
+                                  stream);
+}
+
 void LocalReduce::init(std::shared_ptr<CoreResourceManager> core, int max_ev_size,
-                       size_t max_input_num) {
+                       size_t max_input_num, bool deterministic) {
   HugeCTR::CudaDeviceContext ctx(core->get_device_id());
 
   this->core_ = core;
@@ -115,6 +186,12 @@ void LocalReduce::init(std::shared_ptr<CoreResourceManager> core, int max_ev_siz
                          .device(device));
 
   this->partial_reduce_result_.max_input_num = max_input_num;
+
+  if (deterministic) {
+    this->partial_reduce_result_.deterministic = true;
+    this->partial_reduce_result_.ordered_buffer.init(core, max_ev_size, max_input_num);
+    this->sorted_indices_.init(core, max_input_num);
+  }
 }
 
 void LocalReduce::local_reduce(const ReductionIndices& reduction_indices,
@@ -223,6 +300,45 @@ void LocalReduce::local_reduce(const ReductionIndices& reduction_indices,
   }
 }
 
+void LocalReduce::prepare_unreduced_wgrad(const ReductionIndices& reduction_indices,
+                                          const ModelCommBuffer& src_buffer, const Wgrad& wgrad,
+                                          int batch_size, UnreducedWgrad& unreduced_wgrad) {
+  HugeCTR::CudaDeviceContext ctx(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+
+  const auto& src_buffer_attr = src_buffer.attr;
+  unreduced_wgrad = UnreducedWgrad{partial_reduce_result_.src_ptrs,
+                                   src_buffer_attr.type,
+                                   reduction_indices.ev_sizes,
+                                   reduction_indices.dst_ids,
+                                   0,
+                                   src_buffer_attr.max_ev_size,
+                                   &partial_reduce_result_};
+  if (src_buffer_attr.num_lookup == 0 || reduction_indices.num_elements == 0) return;
+  unreduced_wgrad.num_elements = reduction_indices.num_elements;
+
+  int batch_size_per_gpu = batch_size / src_buffer_attr.num_gpus;
+  HCTR_CHECK_HINT(src_buffer_attr.layout == EmbeddingLayout::FeatureMajor,
+                  "local reduce model comm buffer should be feature major");
+
+  const int* src_id_to_ev_start_indices_ptr = src_buffer_attr.id_to_ev_start_indices.data<int>();
+  const int* src_id_to_ev_size_ptr = reduction_indices.ev_sizes.data<int>();
+  const uint32_t* src_ids_ptr = reduction_indices.src_ids.data<uint32_t>();
+  DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(src_buffer_attr.type.type(), emb_t, [&] {
+    const emb_t** src_ptr = (const emb_t**)src_buffer.data.data();
+    emb_t** src_ptrs = (emb_t**)partial_reduce_result_.src_ptrs.data();
+    if (wgrad.attr.is_same_ev_size) {
+      mp_cal_src_ptrs_same_ev_size<<<core_->get_kernel_param().num_sms * 8, 256, 0, stream>>>(
+          src_ptr, src_ids_ptr, batch_size, batch_size_per_gpu, reduction_indices.num_elements,
+          wgrad.attr.same_ev_size, src_id_to_ev_start_indices_ptr, src_ptrs);
+    } else {
+      mp_cal_src_ptrs<<<core_->get_kernel_param().num_sms * 8, 256, 0, stream>>>(
+          src_ptr, src_ids_ptr, batch_size, batch_size_per_gpu, reduction_indices.num_elements,
+          src_id_to_ev_size_ptr, src_id_to_ev_start_indices_ptr, src_ptrs);
+    }
+  });
+}
+
 void dp_local_reduce_from_feature_major_top_grad(
     const HugeCTR::core23::KernelParams& kernel_params, const ReductionIndices& reduction_indices,
     const EmbeddingOutput& src_buffer, const core23::Tensor& local_lookup_ids, int num_lookup,
@@ -393,13 +509,35 @@ void LocalReduce::local_reduce(const DenseReductionIndices& reduction_indices,
             offset_t* reverse_idx_ptr = reduction_indices.model_reverse_idx->data<offset_t>();
             src_emb_t* src_ptr = (src_emb_t*)src_buffer.data.data();
             dst_emb_t* dst_ptr = (dst_emb_t*)wgrad.data.data();
-            using CopyDesc = DenseModelBackwardOneToOneAtomicDesc<src_emb_t, dst_emb_t, offset_t>;
-            CopyDesc one_to_one_atomic_desc = {num_keys, ev_size, reverse_idx_ptr, src_ptr,
-                                               dst_ptr};
             HCTR_LIB_THROW(cudaMemsetAsync(
                 wgrad.data.data(), 0,
                 reduction_indices.num_valid_dst_tensor * ev_size * wgrad.data.data_type().size(),
                 stream));
+            if (partial_reduce_result_.deterministic) {
+              // Sum the rows of each unique key in the order of the model comm buffer.
+              sorted_indices_.sort(*reduction_indices.model_reverse_idx, num_keys, stream);
+              const uint32_t* sorted_dst_ids = sorted_indices_.sorted_dst_ids.data<uint32_t>();
+              const uint32_t* sorted_src_ids = sorted_indices_.sorted_src_ids.data<uint32_t>();
+              auto sorted_desc = make_MultiToOne_reduce_new<src_emb_t, dst_emb_t>(
+                  [=] __device__() { return num_keys; }, [=] __device__(int) { return ev_size; },
+                  [=] __device__(int i) { return sorted_dst_ids[i]; },
+                  [=] __device__(int i) {
+                    return src_ptr + static_cast<int64_t>(sorted_src_ids[i]) * ev_size;
+                  },
+                  [=] __device__(int i) {
+                    return dst_ptr + static_cast<int64_t>(sorted_dst_ids[i]) * ev_size;
+                  });
+              multi_to_one_reduce_ordered(
+                  sorted_desc, [] __device__(int) { return 1.f; },
+                  [=] __device__(uint32_t dst_id) {
+                    return dst_ptr + static_cast<int64_t>(dst_id) * ev_size;
+                  },
+                  num_keys, partial_reduce_result_.ordered_buffer, ev_size, stream);
+              return;
+            }
+            using CopyDesc = DenseModelBackwardOneToOneAtomicDesc<src_emb_t, dst_emb_t, offset_t>;
+            CopyDesc one_to_one_atomic_desc = {num_keys, ev_size, reverse_idx_ptr, src_ptr,
+                                               dst_ptr};
             one_to_one_atomic(one_to_one_atomic_desc, core_->get_kernel_param(), ev_size, num_keys,
                               stream);
           });
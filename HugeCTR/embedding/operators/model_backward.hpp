@@ -27,6 +27,32 @@ struct ReductionIndices;
 struct ModelCommBuffer;
 struct DenseModelCommBuffer;
 
+// Partial rows of multi_to_one_reduce_ordered. Each level of the reduction sums chunks of EV_NUM
+// consecutive elements, and passes the last row of a chunk to the next level if that row continues
+// in the next chunk. The levels alternate between both buffers.
+struct OrderedReduceBuffer {
+  core23::Tensor partial_wgrad[2];
+  core23::Tensor partial_ev_length[2];
+  core23::Tensor partial_dst_ids[2];
+
+  void init(std::shared_ptr<CoreResourceManager> core, int max_ev_size, size_t max_input_num);
+};
+
+// Elements of a reduction into unique rows, stably sorted by their row, so that each row is
+// reduced in a fixed order instead of with atomics.
+struct SortedReduceIndices {
+  core23::Tensor dst_ids;         // uint32_t, row of each element
+  core23::Tensor src_ids;         // uint32_t, index of each element
+  core23::Tensor sorted_dst_ids;  // uint32_t
+  core23::Tensor sorted_src_ids;  // uint32_t
+  int device_id;  // the temp storage of the sort is taken from the scratch arena of the stream
+
+  void init(std::shared_ptr<CoreResourceManager> core, size_t max_input_num);
+
+  // reverse_idx holds the row of each of the num_elements elements, of any integral type.
+  void sort(const core23::Tensor &reverse_idx, size_t num_elements, cudaStream_t stream) const;
+};
+
 struct PartialReduceResult {
   core23::Tensor partial_wgrad;
   core23::Tensor partial_keys;
@@ -39,19 +65,43 @@ struct PartialReduceResult {
 
   core23::Tensor src_ptrs;
   size_t max_input_num;
+
+  // Reduces the gradients with multi_to_one_reduce_ordered instead of multi_to_one_reduce_v2.
+  bool deterministic = false;
+  OrderedReduceBuffer ordered_buffer;
+};
+
+// Rows of the model comm buffer that are reduced into the wgrad of each unique key, for tables
+// which reduce them in their update kernel.
+struct UnreducedWgrad {
+  core23::Tensor src_ptrs;  // row of each element
+  core23::DataType src_type;
+  core23::Tensor ev_sizes;
+  core23::Tensor dst_ids;  // sorted index of the unique key of each element
+  size_t num_elements;
+  int max_ev_size;
+  PartialReduceResult *partial_reduce_result;
 };
 
 class LocalReduce {
  private:
   std::shared_ptr<CoreResourceManager> core_;
   PartialReduceResult partial_reduce_result_;
+  SortedReduceIndices sorted_indices_;  // Dense mp only, if deterministic
 
  public:
-  void init(std::shared_ptr<CoreResourceManager> core, int max_ev_size, size_t max_input_num);
+  void init(std::shared_ptr<CoreResourceManager> core, int max_ev_size, size_t max_input_num,
+            bool deterministic = false);
 
   void local_reduce(const ReductionIndices &reduction_indices, const ModelCommBuffer &src_buffer,
                     Wgrad &wgrad, int batch_size);
 
+  // Only computes the rows of the elements of each unique key, which the update of the table then
+  // reduces and applies in the same pass.
+  void prepare_unreduced_wgrad(const ReductionIndices &reduction_indices,
+                               const ModelCommBuffer &src_buffer, const Wgrad &wgrad,
+                               int batch_size, UnreducedWgrad &unreduced_wgrad);
+
   void local_reduce(const ReductionIndices &reduction_indices, const EmbeddingOutput &src_buffer,
                     Wgrad &wgrad, const core23::Tensor &local_lookup_ids, int num_lookup,
                     int num_global_lookup, int batch_size);
@@ -142,8 +142,74 @@ void dp_forward_to_batch_major_output(const core23::Tensor &lookup_res,
         });
       });
 }
+template <typename emb_t, typename offset_t>
+__global__ void dp_forward_accumulate_kernel(
+    const float **__restrict__ lookup_res, const offset_t *__restrict__ bucket_range,
+    const offset_t *__restrict__ num_keys_per_bucket, const int *__restrict__ local_lookup_ids,
+    const int *__restrict__ ev_sizes, const int *__restrict__ ev_start_indices,
+    const char *__restrict__ combiners, int num_local_lookup, int num_lookup,
+    int batch_size_per_gpu, bool batch_major, emb_t *output) {
+  const int lane_id = threadIdx.x % 32;
+  const int num_warps = gridDim.x * blockDim.x / 32;
+
+  for (int i = (blockIdx.x * blockDim.x + threadIdx.x) / 32;
+       i < num_local_lookup * batch_size_per_gpu; i += num_warps) {
+    offset_t start = bucket_range[i];
+    offset_t end = bucket_range[i + 1];
+    if (start == end) continue;
+
+    int lookup_id = local_lookup_ids[i / batch_size_per_gpu];
+    int bid = i % batch_size_per_gpu;
+    int ev_size = ev_sizes[lookup_id];
+    float scale = combiners[lookup_id] == static_cast<char>(Combiner::Average)
+                      ? 1.f / num_keys_per_bucket[lookup_id * batch_size_per_gpu + bid]
+                      : 1.f;
+    emb_t *dst = batch_major ? output + bid * ev_start_indices[num_lookup] +
+                                   ev_start_indices[lookup_id]
+                             : output + batch_size_per_gpu * ev_start_indices[lookup_id] +
+                                   bid * ev_size;
+    for (int d = lane_id; d < ev_size; d += 32) {
+      float sum = 0.f;
+      for (offset_t k = start; k < end; ++k) {
+        sum += lookup_res[k][d];
+      }
+      dst[d] = HugeCTR::TypeConvertFunc<emb_t, float>::convert(
+          HugeCTR::TypeConvertFunc<float, emb_t>::convert(dst[d]) + sum * scale);
+    }
+  }
+}
 }  // namespace
 
+void DPModelForward::sparse_forward_accumulate(const core23::Tensor &lookup_res,
+                                               const core23::Tensor &dp_bucket_range,
+                                               const core23::Tensor &num_keys_per_bucket,
+                                               const core23::Tensor &local_lookup_ids,
+                                               EmbeddingOutput &embedding_output,
+                                               int batch_size_per_gpu) {
+  CudaDeviceContext ctx(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+  int num_local_lookup = local_lookup_ids.num_elements();
+  if (num_local_lookup == 0) return;
+
+  const auto &attr = embedding_output.attr;
+  int num_lookup = attr.id_to_ev_size.num_elements();
+  bool batch_major = attr.layout == EmbeddingLayout::BatchMajor;
+  const int block_size = 256;
+  const int grid_size = (num_local_lookup * batch_size_per_gpu * 32 + block_size - 1) / block_size;
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(dp_bucket_range.data_type().type(), offset_t, [&] {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(embedding_output.data.data_type().type(), emb_t, [&] {
+      dp_forward_accumulate_kernel<<<grid_size, block_size, 0, stream>>>(
+          (const float **)lookup_res.data(), dp_bucket_range.data<offset_t>(),
+          num_keys_per_bucket.data<offset_t>(), local_lookup_ids.data<int>(),
+          attr.id_to_ev_size.data<int>(), attr.id_to_ev_start_indices.data<int>(),
+          attr.id_to_combiner.data<char>(), num_local_lookup, num_lookup, batch_size_per_gpu,
+          batch_major, embedding_output.data.data<emb_t>());
+    });
+  });
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
 void DPModelForward::sparse_forward(const core23::Tensor &lookup_res,
                                     const core23::Tensor &dp_bucket_range,
                                     const core23::Tensor &local_lookup_ids,
@@ -199,8 +265,9 @@ void ModelForward::sparse_forward(const core23::Tensor &mp_ev, const core23::Ten
                      batch_size_per_gpu * id_to_ev_start_indices_ptr[i_lookup] +
                      local_batch_id * ev_size;
             });
-        copy_multi_to_one(multi_to_one_desc, core_->get_kernel_param(),
-                          model_comm_buffer.attr.max_ev_size, stream);
+        copy_multi_to_one_uniform_ev(multi_to_one_desc, core_->get_kernel_param(),
+                                     model_comm_buffer.attr.max_ev_size,
+                                     model_comm_buffer.attr.uniform_ev_size, stream);
       });
     });
   }
@@ -261,9 +328,7 @@ void ModelCommBufferAttr::init(std::shared_ptr<CoreResourceManager> core,
   for (int lookup_id = 0; lookup_id < ebc_param.num_lookup; ++lookup_id) {
     if (!ebc_param.has_table_shard(gpu_id, grouped_id, lookup_id)) continue;
 
-    const auto &lookup_params = ebc_param.lookup_params;
-    int ev_size = lookup_params[lookup_id].ev_size;
-    h_id_to_ev_size.push_back(ev_size);
+    h_id_to_ev_size.push_back(ebc_param.get_local_ev_size(lookup_id));
   }
   std::partial_sum(h_id_to_ev_size.begin(), h_id_to_ev_size.end(),
                    std::back_inserter(h_id_to_ev_start_indices));
@@ -289,6 +354,11 @@ void ModelCommBufferAttr::init(std::shared_ptr<CoreResourceManager> core,
   this->max_ev_size = h_id_to_ev_size.empty()
                           ? 0
                           : *std::max_element(h_id_to_ev_size.begin(), h_id_to_ev_size.end());
+  this->uniform_ev_size =
+      std::all_of(h_id_to_ev_size.begin(), h_id_to_ev_size.end(),
+                  [&](int ev_size) { return ev_size == this->max_ev_size; })
+          ? this->max_ev_size
+          : 0;
   this->type = ebc_param.emb_type;
 }
 
@@ -31,6 +31,14 @@ class DPModelForward {
   void sparse_forward(const core23::Tensor &lookup_res, const core23::Tensor &dp_bucket_range,
                       const core23::Tensor &local_lookup_ids, EmbeddingOutput &embedding_output,
                       int batch_size_per_gpu);
+
+  // Adds the pooled lookup results to the output. Average is taken over num_keys_per_bucket, the
+  // keys of each bucket before some of them were filtered.
+  void sparse_forward_accumulate(const core23::Tensor &lookup_res,
+                                 const core23::Tensor &dp_bucket_range,
+                                 const core23::Tensor &num_keys_per_bucket,
+                                 const core23::Tensor &local_lookup_ids,
+                                 EmbeddingOutput &embedding_output, int batch_size_per_gpu);
 };
 
 struct ModelCommBufferAttr {
@@ -46,6 +54,7 @@ struct ModelCommBufferAttr {
 
   EmbeddingLayout layout;
   int max_ev_size;
+  int uniform_ev_size;  // ev size of all local lookups, 0 if they differ
   core23::DataType type;
 
   void init(std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam &ebc_param,
@@ -305,6 +305,139 @@ void multi_to_one_reduce_v2(CopyDesc1 copy_desc1, CopyDesc2 copy_desc2,
   }
 }
 
+// One warp sums each chunk of EV_NUM consecutive elements, which are sorted by their row, in the
+// order of the elements. A row is written by the chunk of its last element: stored by the first
+// level, and added to by the later levels, which sum the partial rows passed on by the chunks that
+// the row spans. The summation order thus only depends on the position of the elements of a row.
+template <typename CopyDesc, typename ScaleFunc, int kMaxElemPerThread, int kWarpSize>
+__global__ void multi_to_one_reduce_ordered_vec4(CopyDesc copy_desc, ScaleFunc get_scale,
+                                                 bool accumulate_dst, float* partial_buffer,
+                                                 uint32_t* partial_dst_ids,
+                                                 int32_t* partial_ev_length, int max_ev_length) {
+  using src_type = typename CopyDesc::SrcT;
+  using dst_type = typename CopyDesc::DstT;
+
+  const int lane_id = threadIdx.x & 31;
+  const int chunk_id = blockIdx.x * (blockDim.x >> 5) + (threadIdx.x >> 5);
+  const int num_vec = static_cast<int>(copy_desc.num_vec());
+  const int begin = EV_NUM * chunk_id;
+  if (begin >= num_vec) return;
+  const int end = min(begin + EV_NUM, num_vec);
+  constexpr int copy_width = 4;
+
+  Vec4T<float> accum[kMaxElemPerThread];
+  uint32_t dst_id = 0;
+  int vec_length = -1;
+  for (int i = begin; i < end; ++i) {
+    // Chunks of the previous level that passed on no partial row
+    if (copy_desc.get_src_vec_length(i) == -1) continue;
+    dst_id = copy_desc.get_dst_id(i);
+    vec_length = copy_desc.get_src_vec_length(i);
+    const src_type* tmp_src = copy_desc.get_src_ptr(i);
+    const float scale = get_scale(i);
+    for (int k = 0; k < kMaxElemPerThread && 4 * kWarpSize * k + 4 * lane_id < vec_length; ++k) {
+      Vec4T<float> src_elem;
+      int idx4 = 4 * kWarpSize * k + 4 * lane_id;
+      int n = min(vec_length - idx4, copy_width);
+      src_elem.load(tmp_src + idx4, n);
+      accum[k].accumulate_multiply(src_elem, scale);
+    }
+
+    bool is_last = i + 1 == num_vec || copy_desc.get_src_vec_length(i + 1) == -1 ||
+                   copy_desc.get_dst_id(i + 1) != dst_id;
+    if (!is_last) continue;
+    dst_type* tmp_dst = copy_desc.get_dst_ptr(i);
+    for (int k = 0; k < kMaxElemPerThread && 4 * kWarpSize * k + 4 * lane_id < vec_length; ++k) {
+      int idx4 = 4 * kWarpSize * k + 4 * lane_id;
+      int n = min(vec_length - idx4, copy_width);
+      if (accumulate_dst) {
+        Vec4T<float> dst_elem;
+        dst_elem.load(tmp_dst + idx4, n);
+        dst_elem.accumulate(accum[k]);
+        dst_elem.store(tmp_dst + idx4, n);
+      } else {
+        accum[k].store(tmp_dst + idx4, n);
+      }
+      accum[k].reset();
+    }
+    vec_length = -1;
+  }
+
+  // The last row of the chunk continues in the next chunk.
+  for (int k = 0; k < kMaxElemPerThread && 4 * kWarpSize * k + 4 * lane_id < vec_length; ++k) {
+    int idx4 = 4 * kWarpSize * k + 4 * lane_id;
+    int n = min(vec_length - idx4, copy_width);
+    accum[k].store(partial_buffer + static_cast<int64_t>(chunk_id) * max_ev_length + idx4, n);
+  }
+  if (lane_id == 0) {
+    partial_ev_length[chunk_id] = vec_length;
+    partial_dst_ids[chunk_id] = dst_id;
+  }
+}
+
+// Runs a level of multi_to_one_reduce_ordered into the out-th partial buffer, and returns its
+// number of chunks.
+template <typename CopyDesc, typename ScaleFunc, int kWarpSize = 32>
+int multi_to_one_reduce_ordered_level(CopyDesc copy_desc, ScaleFunc get_scale, bool accumulate_dst,
+                                      int num_vec, const OrderedReduceBuffer& buffer, int out,
+                                      int max_ev_size, cudaStream_t stream) {
+  const int num_chunks = (num_vec - 1) / EV_NUM + 1;
+  const int block_size = WGRAD_REDUCE_BLOCK_SIZE;
+  const int grid_size = (num_chunks - 1) / (block_size / kWarpSize) + 1;
+  float* partial_wgrad = buffer.partial_wgrad[out].data<float>();
+  uint32_t* partial_dst_ids = buffer.partial_dst_ids[out].data<uint32_t>();
+  int32_t* partial_ev_length = buffer.partial_ev_length[out].data<int32_t>();
+  if (max_ev_size <= 128) {
+    multi_to_one_reduce_ordered_vec4<CopyDesc, ScaleFunc, 1, kWarpSize>
+        <<<grid_size, block_size, 0, stream>>>(copy_desc, get_scale, accumulate_dst,
+                                               partial_wgrad, partial_dst_ids, partial_ev_length,
+                                               max_ev_size);
+  } else if (max_ev_size <= 256) {
+    multi_to_one_reduce_ordered_vec4<CopyDesc, ScaleFunc, 2, kWarpSize>
+        <<<grid_size, block_size, 0, stream>>>(copy_desc, get_scale, accumulate_dst,
+                                               partial_wgrad, partial_dst_ids, partial_ev_length,
+                                               max_ev_size);
+  } else {
+    HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "HugeCTR does not support emb vector size > 256");
+  }
+  return num_chunks;
+}
+
+// Deterministic multi_to_one_reduce_v2 of the elements of copy_desc, which are sorted by their
+// row. It sums chunks of EV_NUM elements, then the partial rows of EV_NUM chunks at a time, until
+// no row spans more than a chunk. This fixed tree needs log_EV_NUM(num_elements) levels, whose
+// work shrinks by EV_NUM each, and no atomics. get_scale multiplies each element, and get_dst_row
+// returns the row of a dst id. Rows without elements are not written.
+template <typename CopyDesc, typename ScaleFunc, typename DstRowFunc>
+void multi_to_one_reduce_ordered(CopyDesc copy_desc, ScaleFunc get_scale, DstRowFunc get_dst_row,
+                                 size_t num_elements, const OrderedReduceBuffer& buffer,
+                                 int max_ev_size, cudaStream_t stream) {
+  using dst_type = typename CopyDesc::DstT;
+  if (num_elements == 0) return;
+
+  int in = 0;
+  int num_partials = multi_to_one_reduce_ordered_level(copy_desc, get_scale, false,
+                                                       static_cast<int>(num_elements), buffer, in,
+                                                       max_ev_size, stream);
+  // The partial row of the last chunk of a level is always empty.
+  while (num_partials > 1) {
+    const float* partial_wgrad = buffer.partial_wgrad[in].data<float>();
+    const uint32_t* partial_dst_ids = buffer.partial_dst_ids[in].data<uint32_t>();
+    const int32_t* partial_ev_length = buffer.partial_ev_length[in].data<int32_t>();
+    const size_t num_vec = num_partials;
+    auto partial_desc = make_MultiToOne_reduce_new<float, dst_type>(
+        [=] __device__() { return num_vec; },
+        [=] __device__(int i) { return partial_ev_length[i]; },
+        [=] __device__(int i) { return partial_dst_ids[i]; },
+        [=] __device__(int i) { return partial_wgrad + static_cast<int64_t>(i) * max_ev_size; },
+        [=] __device__(int i) { return get_dst_row(partial_dst_ids[i]); });
+    num_partials = multi_to_one_reduce_ordered_level(
+        partial_desc, [] __device__(int) { return 1.f; }, true, num_partials, buffer, 1 - in,
+        max_ev_size, stream);
+    in = 1 - in;
+  }
+}
+
 template <typename CopyDesc1>
 void multi_to_one_reduce_v2(CopyDesc1 multi_to_one_desc_first_stage,
                             const ReductionIndices& reduction_indices,
@@ -318,6 +451,17 @@ void multi_to_one_reduce_v2(CopyDesc1 multi_to_one_desc_first_stage,
   const int* table_ids_ptr = wgrad.table_ids.data<int>();
   const int* table_id_to_ev_size_ptr = wgrad.attr.table_id_to_ev_size.data<int>();
   const uint32_t* dst_ev_start_indices_ptr = wgrad.ev_start_indices.data<uint32_t>();
+  if (partial_reduce_result.deterministic) {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data.data_type().type(), grad_t, [&] {
+      grad_t* dst_ptr = wgrad.data.data<grad_t>();
+      multi_to_one_reduce_ordered(
+          multi_to_one_desc_first_stage, [] __device__(int) { return 1.f; },
+          [=] __device__(uint32_t dst_id) { return dst_ptr + dst_ev_start_indices_ptr[dst_id]; },
+          reduction_indices.num_elements, partial_reduce_result.ordered_buffer, max_ev_size,
+          stream);
+    });
+    return;
+  }
   size_t second_num = (reduction_indices.num_elements - 1) / EV_NUM + 1;
   DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data.data_type().type(), grad_t, [&] {
     grad_t* dst_ptr = wgrad.data.data<grad_t>();
@@ -339,4 +483,242 @@ void multi_to_one_reduce_v2(CopyDesc1 multi_to_one_desc_first_stage,
   });
 }
 
+// Stage 1 of multi_to_one_reduce_vec4_v2, which applies update_func to the reduced gradient of each
+// key whose elements all lie in the range of the warp, instead of storing it. Keys which cross the
+// range of a warp are reduced into dst and the partial buffer as before, and updated by
+// multi_to_one_update_partial_v2 after stage 2.
+template <typename CopyDesc, typename UpdateFunc, int kMaxElemPerThread, int kWarpSize>
+__global__ void multi_to_one_reduce_update_vec4_v2(CopyDesc copy_desc, UpdateFunc update_func,
+                                                   float* partial_buffer, uint32_t* partial_dst_ids,
+                                                   int32_t* partial_ev_length, int max_ev_length) {
+  using src_type = typename CopyDesc::SrcT;
+  using dst_type = typename CopyDesc::DstT;
+
+  const int lane_id = threadIdx.x & 31;
+  const int warp_id = threadIdx.x >> 5;
+  const int warp_num = blockDim.x >> 5;
+  int local_sample_num = EV_NUM;
+  constexpr int copy_width = 4;
+  int global_index = EV_NUM * (blockIdx.x * warp_num + warp_id);
+  {
+    if (global_index >= copy_desc.num_vec()) return;
+    local_sample_num = local_sample_num < copy_desc.num_vec() - global_index
+                           ? local_sample_num
+                           : copy_desc.num_vec() - global_index;
+  }
+
+  // whether the first key of the range started in the previous warp
+  bool is_continued = global_index > 0 && copy_desc.get_dst_id(global_index - 1) ==
+                                              copy_desc.get_dst_id(global_index);
+
+  Vec4T<float> accum[kMaxElemPerThread];
+  uint32_t tmp_dst_id;
+  int vec_length = -1;
+  for (int sp = 0; sp < local_sample_num; ++sp) {
+    {
+      tmp_dst_id = copy_desc.get_dst_id(global_index);
+      const src_type* tmp_src = copy_desc.get_src_ptr(global_index);
+      vec_length = copy_desc.get_src_vec_length(global_index);
+      for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
+        Vec4T<src_type> src_elem;
+        int idx4 = 4 * kWarpSize * i + 4 * lane_id;
+        int n = min(vec_length - idx4, copy_width);
+        src_elem.load(tmp_src + idx4, n);
+        accum[i].accumulate(src_elem);
+      }
+    }
+
+    // when key is change, update it, or write to dst if it started in the previous warp
+    if (sp < local_sample_num - 1) {
+      uint32_t new_id = copy_desc.get_dst_id(global_index + 1);
+      if (new_id != tmp_dst_id) {
+        dst_type* tmp_dst = copy_desc.get_dst_ptr(global_index);
+        for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length;
+             ++i) {
+          int idx4 = 4 * kWarpSize * i + 4 * lane_id;
+          int n = min(vec_length - idx4, copy_width);
+          if (is_continued) {
+            accum[i].store(tmp_dst + idx4, n);
+          } else {
+            update_func(tmp_dst_id, idx4, n, accum[i]);
+          }
+          accum[i].reset();
+        }
+        is_continued = false;
+      }
+    }
+    global_index++;
+  }
+
+  if (vec_length != -1) {
+    bool is_last = true;
+    dst_type* tmp_dst;
+    if (global_index < copy_desc.num_vec()) {
+      auto next_id = copy_desc.get_dst_id(global_index);
+      if (tmp_dst_id == next_id) is_last = false;
+    }
+
+    if (is_last) {
+      tmp_dst = copy_desc.get_dst_ptr(global_index - 1);
+      for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
+        int idx4 = 4 * kWarpSize * i + 4 * lane_id;
+        int n = min(vec_length - idx4, copy_width);
+        if (is_continued) {
+          accum[i].store(tmp_dst + idx4, n);
+        } else {
+          update_func(tmp_dst_id, idx4, n, accum[i]);
+        }
+        accum[i].reset();
+      }
+      if (lane_id == 0) {
+        partial_ev_length[blockIdx.x * warp_num + warp_id] = -1;
+      }
+
+    } else {
+      for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
+        int idx4 = 4 * kWarpSize * i + 4 * lane_id;
+        int n = min(vec_length - idx4, copy_width);
+        accum[i].store(partial_buffer + (blockIdx.x * warp_num + warp_id) * max_ev_length + idx4,
+                       n);
+        accum[i].reset();
+      }
+
+      if (lane_id == 0) {
+        partial_ev_length[blockIdx.x * warp_num + warp_id] = vec_length;
+        partial_dst_ids[blockIdx.x * warp_num + warp_id] = tmp_dst_id;
+      }
+    }
+  }
+
+  return;
+}
+
+// Applies update_func to the keys which cross the range of a warp, once stage 2 has reduced their
+// gradient into dst. Each key is updated by the first warp which holds a partial result of it.
+template <typename DstT, typename UpdateFunc, int kMaxElemPerThread, int kWarpSize>
+__global__ void multi_to_one_update_partial_v2(const DstT* dst,
+                                               const uint32_t* dst_ev_start_indices,
+                                               UpdateFunc update_func,
+                                               const uint32_t* partial_dst_ids,
+                                               const int32_t* partial_ev_length,
+                                               size_t num_partial) {
+  const int lane_id = threadIdx.x & 31;
+  const int warp_num = blockDim.x >> 5;
+  constexpr int copy_width = 4;
+  for (size_t w = blockIdx.x * warp_num + (threadIdx.x >> 5); w < num_partial;
+       w += gridDim.x * warp_num) {
+    int vec_length = partial_ev_length[w];
+    if (vec_length == -1) continue;
+    uint32_t dst_id = partial_dst_ids[w];
+    if (w > 0 && partial_ev_length[w - 1] != -1 && partial_dst_ids[w - 1] == dst_id) continue;
+
+    const DstT* tmp_src = dst + dst_ev_start_indices[dst_id];
+    for (int i = 0; i < kMaxElemPerThread && 4 * kWarpSize * i + 4 * lane_id < vec_length; ++i) {
+      int idx4 = 4 * kWarpSize * i + 4 * lane_id;
+      int n = min(vec_length - idx4, copy_width);
+      Vec4T<float> grad_elem;
+      grad_elem.load(tmp_src + idx4, n);
+      update_func(dst_id, idx4, n, grad_elem);
+    }
+  }
+}
+
+template <int kMaxElemPerThread, typename CopyDesc1, typename CopyDesc2, typename UpdateFunc,
+          int kWarpSize = 32>
+void multi_to_one_reduce_update_v2(CopyDesc1 copy_desc1, CopyDesc2 copy_desc2,
+                                   UpdateFunc update_func,
+                                   const HugeCTR::core23::KernelParams& kernel_params,
+                                   const typename CopyDesc2::DstT* dst,
+                                   const uint32_t* dst_ev_start_indices, float* partial_buffer,
+                                   uint32_t* partial_dst_ids, int32_t* partial_ev_length,
+                                   int max_ev_length, size_t first_stage_key_num,
+                                   size_t second_stage_key_num, cudaStream_t stream) {
+  int grid_size = (first_stage_key_num - 1) / WGRAD_REDUCE_BLOCK_SIZE + 1;
+  int block_size = WGRAD_REDUCE_BLOCK_SIZE;
+
+  multi_to_one_reduce_update_vec4_v2<CopyDesc1, UpdateFunc, kMaxElemPerThread, kWarpSize>
+      <<<grid_size, block_size, 0, stream>>>(copy_desc1, update_func, partial_buffer,
+                                             partial_dst_ids, partial_ev_length, max_ev_length);
+
+  int second_grid_size = (second_stage_key_num - 1) / WGRAD_REDUCE_BLOCK_SIZE + 1;
+  int second_local_sample = EV_NUM;
+  get_kernel_config_use_warp(kernel_params.num_sms, kernel_params.max_thread_per_sm,
+                             WGRAD_REDUCE_BLOCK_SIZE, kernel_params.warp_size, second_stage_key_num,
+                             &second_grid_size, &second_local_sample, 1);
+  if (second_local_sample < 8) second_local_sample = 8;
+  multi_to_one_reduce_final_v2<CopyDesc2, kMaxElemPerThread, kWarpSize>
+      <<<second_grid_size, block_size, 0, stream>>>(copy_desc2, second_local_sample);
+
+  int third_grid_size = (second_stage_key_num - 1) / (block_size / kWarpSize) + 1;
+  multi_to_one_update_partial_v2<typename CopyDesc2::DstT, UpdateFunc, kMaxElemPerThread,
+                                 kWarpSize><<<third_grid_size, block_size, 0, stream>>>(
+      dst, dst_ev_start_indices, update_func, partial_dst_ids, partial_ev_length,
+      second_stage_key_num);
+}
+
+// Reduces the unreduced wgrad as multi_to_one_reduce_v2 does, and applies the update of each unique
+// key in the same pass. update_func(dst_id, idx4, n, grad) updates the n <= 4 elements of the
+// embedding vector of unique key dst_id that start at idx4. Only the gradients of keys which cross
+// the range of a warp are written to wgrad.
+template <typename UpdateFunc>
+void multi_to_one_reduce_update_v2(const UnreducedWgrad& unreduced_wgrad, Wgrad& wgrad,
+                                   UpdateFunc update_func,
+                                   const HugeCTR::core23::KernelParams& kernel_params,
+                                   cudaStream_t stream) {
+  PartialReduceResult& partial_reduce_result = *unreduced_wgrad.partial_reduce_result;
+  auto partial_grad_ev_ptr = partial_reduce_result.partial_wgrad_new.data<float>();
+  auto partial_ev_length_ptr = partial_reduce_result.partial_ev_length_new.data<int32_t>();
+  auto partial_dst_id_array_ptr = partial_reduce_result.partial_dst_id_array_new.data<uint32_t>();
+
+  const int* src_id_to_ev_size_ptr = unreduced_wgrad.ev_sizes.data<int>();
+  const uint32_t* dst_ids_ptr = unreduced_wgrad.dst_ids.data<uint32_t>();
+  const uint32_t* dst_ev_start_indices_ptr = wgrad.ev_start_indices.data<uint32_t>();
+  size_t num_elements = unreduced_wgrad.num_elements;
+  int max_ev_size = unreduced_wgrad.max_ev_size;
+  size_t second_num = (num_elements - 1) / EV_NUM + 1;
+
+  DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(unreduced_wgrad.src_type.type(), emb_t, [&] {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data.data_type().type(), grad_t, [&] {
+      emb_t** src_ptrs = (emb_t**)unreduced_wgrad.src_ptrs.data();
+      grad_t* dst_ptr = wgrad.data.data<grad_t>();
+
+      auto multi_to_one_desc_first_stage = make_MultiToOne_reduce_new<emb_t, grad_t>(
+          [=] __device__() { return num_elements; },
+          [=] __device__(int i) { return src_id_to_ev_size_ptr[i]; },
+          [=] __device__(int i) { return dst_ids_ptr[i]; },
+          [=] __device__(int i) { return src_ptrs[i]; },
+          [=] __device__(int i) {
+            auto tmp_index = dst_ids_ptr[i];
+            return dst_ptr + dst_ev_start_indices_ptr[tmp_index];
+          });
+      auto multi_to_one_desc_second_stage = make_MultiToOne_reduce_new<float, grad_t>(
+          [=] __device__() { return second_num; },
+          [=] __device__(int i) { return partial_ev_length_ptr[i]; },
+          [=] __device__(int i) { return partial_dst_id_array_ptr[i]; },
+          [=] __device__(int i) { return partial_grad_ev_ptr + i * max_ev_size; },
+          [=] __device__(int i) {
+            auto tmp_index = partial_dst_id_array_ptr[i];
+            return dst_ptr + dst_ev_start_indices_ptr[tmp_index];
+          });
+
+      if (max_ev_size <= 128) {
+        multi_to_one_reduce_update_v2<1>(
+            multi_to_one_desc_first_stage, multi_to_one_desc_second_stage, update_func,
+            kernel_params, dst_ptr, dst_ev_start_indices_ptr, partial_grad_ev_ptr,
+            partial_dst_id_array_ptr, partial_ev_length_ptr, max_ev_size, num_elements, second_num,
+            stream);
+      } else if (max_ev_size <= 256) {
+        multi_to_one_reduce_update_v2<2>(
+            multi_to_one_desc_first_stage, multi_to_one_desc_second_stage, update_func,
+            kernel_params, dst_ptr, dst_ev_start_indices_ptr, partial_grad_ev_ptr,
+            partial_dst_id_array_ptr, partial_ev_length_ptr, max_ev_size, num_elements, second_num,
+            stream);
+      } else {
+        HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
+                       "HugeCTR does not support emb vector size > 256");
+      }
+    });
+  });
+}
+
 }  // namespace embedding
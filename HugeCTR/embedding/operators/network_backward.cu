@@ -16,6 +16,9 @@
 
 #include <embedding/common.hpp>
 #include <embedding/operators/generic_lookup.cuh>
+#include <embedding/operators/index_calculation.hpp>
+#include <embedding/operators/model_backward.hpp>
+#include <embedding/operators/multi_to_one_reduce_v2.cuh>
 #include <embedding/operators/network_backward.hpp>
 #include <embedding/operators/network_forward.hpp>
 #include <utils.hpp>
@@ -50,6 +53,8 @@ void network_backward_from_feature_major_top_grad(const core23::Tensor& dp_num_k
         const emb_t* top_grad_ptr = top_grad.data.data<emb_t>();
         dst_emb_t** network_comm_buffer_ptr = (dst_emb_t**)network_buffer.data.data();
         const char* combiner_ptr = top_grad_attr.id_to_combiner.data<char>();
+        const int* dst_column_offset_ptr = network_attr.dst_id_to_column_offset.data<int>();
+        const int* dst_column_size_ptr = network_attr.dst_id_to_column_size.data<int>();
         int num_network_dst_lookup_ids = network_indices.network_dst_lookup_ids.num_elements();
 
         auto one_to_multi_desc = make_MultiToOne<emb_t, dst_emb_t>(
@@ -73,7 +78,7 @@ void network_backward_from_feature_major_top_grad(const core23::Tensor& dp_num_k
             },
             [=] __device__(int i) {
               int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
-              return d_ev_size_offset_ptr[dst_lookup_id + 1] - d_ev_size_offset_ptr[dst_lookup_id];
+              return dst_column_size_ptr[dst_lookup_id];
             },
             [=] __device__(int i) {
               int bid = i / num_network_dst_lookup_ids;
@@ -81,7 +86,7 @@ void network_backward_from_feature_major_top_grad(const core23::Tensor& dp_num_k
 
               int ev_offset = d_ev_size_offset_ptr[lookup_id] * batch_size_per_gpu;
               int ev_size = d_ev_size_offset_ptr[lookup_id + 1] - d_ev_size_offset_ptr[lookup_id];
-              return top_grad_ptr + ev_offset + bid * ev_size;
+              return top_grad_ptr + ev_offset + bid * ev_size + dst_column_offset_ptr[lookup_id];
             },
             [=] __device__(int i) {
               int bid = i / network_offsets_ptr[num_network_dst_lookup_ids];
@@ -127,6 +132,8 @@ void network_backward_from_batch_major_top_grad(const core23::Tensor& dp_num_key
         const emb_t* top_grad_ptr = top_grad.data.data<emb_t>();
         dst_emb_t** network_comm_buffer_ptr = (dst_emb_t**)network_buffer.data.data();
         const char* combiner_ptr = top_grad_attr.id_to_combiner.data<char>();
+        const int* dst_column_offset_ptr = network_attr.dst_id_to_column_offset.data<int>();
+        const int* dst_column_size_ptr = network_attr.dst_id_to_column_size.data<int>();
         int num_network_dst_lookup_ids = network_indices.network_dst_lookup_ids.num_elements();
 
         auto one_to_multi_desc = make_MultiToOne<emb_t, dst_emb_t>(
@@ -150,14 +157,15 @@ void network_backward_from_batch_major_top_grad(const core23::Tensor& dp_num_key
             },
             [=] __device__(int i) {
               int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
-              return d_ev_size_offset_ptr[dst_lookup_id + 1] - d_ev_size_offset_ptr[dst_lookup_id];
+              return dst_column_size_ptr[dst_lookup_id];
             },
             [=] __device__(int i) {
               int bid = i / num_network_dst_lookup_ids;
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
 
               int ev_offset = d_ev_size_offset_ptr[num_lookup] * bid;
-              return top_grad_ptr + ev_offset + d_ev_size_offset_ptr[lookup_id];
+              return top_grad_ptr + ev_offset + d_ev_size_offset_ptr[lookup_id] +
+                     dst_column_offset_ptr[lookup_id];
             },
             [=] __device__(int i) {
               int bid = i / network_offsets_ptr[num_network_dst_lookup_ids];
@@ -260,6 +268,34 @@ struct DenseNetworkBackwardFeatureMajorOneToOneAtomicDesc {
   dst_emb_t* __restrict__ dst_ptr;
 };
 
+// Deterministic accumulation of the gradients of the dense network buffer. Element i of reverse_idx
+// adds the row get_src_ptr(i), scaled by get_scale(i), to its unique row. The elements are sorted
+// by unique row, and the rows are summed in the order of their elements.
+template <typename src_emb_t, typename dst_emb_t, typename SrcPtrFunc, typename ScaleFunc>
+void ordered_dense_network_backward(SrcPtrFunc get_src_ptr, ScaleFunc get_scale,
+                                    const core23::Tensor& reverse_idx, size_t num_elements,
+                                    const DenseNetworkIndices& network_indices, int ev_size,
+                                    dst_emb_t* network_comm_buffer, cudaStream_t stream) {
+  const auto& sorted_indices = network_indices.sorted_indices;
+  sorted_indices.sort(reverse_idx, num_elements, stream);
+  const uint32_t* sorted_dst_ids = sorted_indices.sorted_dst_ids.data<uint32_t>();
+  const uint32_t* sorted_src_ids = sorted_indices.sorted_src_ids.data<uint32_t>();
+
+  auto sorted_desc = make_MultiToOne_reduce_new<src_emb_t, dst_emb_t>(
+      [=] __device__() { return num_elements; }, [=] __device__(int) { return ev_size; },
+      [=] __device__(int i) { return sorted_dst_ids[i]; },
+      [=] __device__(int i) { return get_src_ptr(sorted_src_ids[i]); },
+      [=] __device__(int i) {
+        return network_comm_buffer + static_cast<int64_t>(sorted_dst_ids[i]) * ev_size;
+      });
+  multi_to_one_reduce_ordered(
+      sorted_desc, [=] __device__(int i) { return get_scale(sorted_src_ids[i]); },
+      [=] __device__(uint32_t dst_id) {
+        return network_comm_buffer + static_cast<int64_t>(dst_id) * ev_size;
+      },
+      num_elements, network_indices.ordered_buffer, ev_size, stream);
+}
+
 void dense_network_backward_from_feature_major_top_grad(
     const EmbeddingInput& embedding_input, const EmbeddingOutput& top_grad,
     const DenseNetworkIndices& network_indices, const HugeCTR::core23::KernelParams kernel_params,
@@ -310,6 +346,16 @@ void dense_network_backward_from_feature_major_top_grad(
                 network_buffer.data.data(), 0,
                 num_valid_network_tensor * ev_size * network_buffer.data.data_type().size(),
                 stream));
+            if (network_indices.deterministic) {
+              ordered_dense_network_backward<src_emb_t, dst_emb_t>(
+                  [=] __device__(uint32_t i) {
+                    CopyDesc desc = one_to_one_atomic_desc;
+                    return desc.get_src_ptr(i);
+                  },
+                  [] __device__(uint32_t) { return 1.f; }, reverse_idx, num_network_reverse_idx,
+                  network_indices, ev_size, network_comm_buffer_ptr, stream);
+              return;
+            }
             one_to_one_atomic(one_to_one_atomic_desc, kernel_params, ev_size,
                               num_network_reverse_idx, stream);
           });
@@ -359,6 +405,16 @@ void dense_network_backward_from_batch_major_top_grad(
                 network_buffer.data.data(), 0,
                 num_valid_network_tensor * ev_size * network_buffer.data.data_type().size(),
                 stream));
+            if (network_indices.deterministic) {
+              ordered_dense_network_backward<src_emb_t, dst_emb_t>(
+                  [=] __device__(uint32_t i) {
+                    CopyDesc desc = one_to_one_atomic_desc;
+                    return desc.get_src_ptr(i);
+                  },
+                  [] __device__(uint32_t) { return 1.f; }, reverse_idx, num_network_reverse_idx,
+                  network_indices, ev_size, network_comm_buffer_ptr, stream);
+              return;
+            }
             one_to_one_atomic(one_to_one_atomic_desc, kernel_params, ev_size,
                               num_network_reverse_idx, stream);
           });
@@ -366,6 +422,116 @@ void dense_network_backward_from_batch_major_top_grad(
   });
 }
 
+// Offset of a pooled bucket in the top gradient.
+DEVICE_INLINE int64_t pooled_top_grad_offset(int bucket_id, int batch_size_per_gpu,
+                                             const int* ev_start_indices, int ev_size,
+                                             int global_ev_offset, bool batch_major) {
+  int lookup_id = bucket_id / batch_size_per_gpu;
+  int bid = bucket_id % batch_size_per_gpu;
+  return batch_major
+             ? static_cast<int64_t>(bid) * global_ev_offset + ev_start_indices[lookup_id]
+             : static_cast<int64_t>(batch_size_per_gpu) * ev_start_indices[lookup_id] +
+                   static_cast<int64_t>(bid) * ev_size;
+}
+
+// One warp per key accumulates the gradient of its sample into the row of its unique key.
+template <typename src_emb_t, typename dst_emb_t, typename offset_t>
+__global__ void dense_pooled_network_backward_kernel(
+    const src_emb_t* __restrict__ top_grad, const offset_t* __restrict__ reverse_idx,
+    const offset_t* __restrict__ bucket_ids, size_t num_key,
+    const int* __restrict__ num_keys_per_bucket, const char* __restrict__ local_combiner,
+    const int* __restrict__ ev_start_indices, int ev_size, int batch_size_per_gpu,
+    int global_ev_offset, bool batch_major, dst_emb_t* network_comm_buffer) {
+  constexpr int kWarpSize = 32;
+  const int lane_id = threadIdx.x % kWarpSize;
+  const size_t num_warp = static_cast<size_t>(blockDim.x) * gridDim.x / kWarpSize;
+
+  for (size_t i = (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / kWarpSize;
+       i < num_key; i += num_warp) {
+    int bucket_id = static_cast<int>(bucket_ids[i]);
+    int lookup_id = bucket_id / batch_size_per_gpu;
+    float scale = local_combiner[lookup_id] == static_cast<char>(Combiner::Average)
+                      ? 1.f / num_keys_per_bucket[bucket_id]
+                      : 1.f;
+    const src_emb_t* src =
+        top_grad + pooled_top_grad_offset(bucket_id, batch_size_per_gpu, ev_start_indices,
+                                          ev_size, global_ev_offset, batch_major);
+    dst_emb_t* dst = network_comm_buffer + static_cast<int64_t>(reverse_idx[i]) * ev_size;
+    for (int idx4 = 4 * lane_id; idx4 < ev_size; idx4 += 4 * kWarpSize) {
+      int n = min(ev_size - idx4, 4);
+      Vec4T<float> src_elem;
+      src_elem.load(src + idx4, n);
+      Vec4T<float> scaled_elem;
+      scaled_elem.accumulate_multiply(src_elem, scale);
+      scaled_elem.atomic_store_accum(dst + idx4, n);
+    }
+  }
+}
+
+void dense_pooled_network_backward(const EmbeddingInput& embedding_input,
+                                   const EmbeddingOutput& top_grad,
+                                   const DenseNetworkIndices& network_indices,
+                                   const HugeCTR::core23::KernelParams& kernel_params,
+                                   DenseNetworkBuffer& network_buffer, int batch_size,
+                                   int num_gpus, cudaStream_t stream) {
+  int batch_size_per_gpu = batch_size / num_gpus;
+  int ev_size = network_buffer.attr.ev_size;
+  bool batch_major = top_grad.attr.layout == EmbeddingLayout::BatchMajor;
+  const auto& mp_input = embedding_input.dense_compression_input.model_parallel_compression_input;
+  size_t num_key = mp_input.num_network_reverse_idx;
+
+  network_indices.count_keys_per_bucket(embedding_input, batch_size_per_gpu, stream);
+  size_t num_valid_network_tensor = calc_num_valid_network_tensor(embedding_input);
+  HCTR_LIB_THROW(cudaMemsetAsync(
+      network_buffer.data.data(), 0,
+      num_valid_network_tensor * ev_size * network_buffer.data.data_type().size(), stream));
+  if (num_key == 0) return;
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(mp_input.network_reverse_idx.data_type().type(), offset_t, [&] {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(top_grad.data.data_type().type(), emb_t, [&] {
+      DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(
+          network_buffer.data.data_type().type(), dst_emb_t, [&] {
+            if (network_indices.deterministic) {
+              const emb_t* top_grad_ptr = top_grad.data.data<emb_t>();
+              const offset_t* bucket_ids = mp_input.network_dst_bucket_ids.data<offset_t>();
+              const int* num_keys_per_bucket = network_indices.num_keys_per_bucket.data<int>();
+              const char* local_combiner = network_indices.d_local_combiner.data<char>();
+              const int* ev_start_indices = network_indices.d_ev_start_indices.data<int>();
+              int global_ev_offset = network_indices.global_ev_offset;
+              ordered_dense_network_backward<emb_t, dst_emb_t>(
+                  [=] __device__(uint32_t i) {
+                    return top_grad_ptr + pooled_top_grad_offset(static_cast<int>(bucket_ids[i]),
+                                                                 batch_size_per_gpu,
+                                                                 ev_start_indices, ev_size,
+                                                                 global_ev_offset, batch_major);
+                  },
+                  [=] __device__(uint32_t i) {
+                    int bucket_id = static_cast<int>(bucket_ids[i]);
+                    int lookup_id = bucket_id / batch_size_per_gpu;
+                    return local_combiner[lookup_id] == static_cast<char>(Combiner::Average)
+                               ? 1.f / num_keys_per_bucket[bucket_id]
+                               : 1.f;
+                  },
+                  mp_input.network_reverse_idx, num_key, network_indices, ev_size,
+                  network_buffer.data.data<dst_emb_t>(), stream);
+              return;
+            }
+            const int block_size = 256;
+            const int grid_size = kernel_params.num_sms * kernel_params.max_thread_per_sm /
+                                  block_size;
+            dense_pooled_network_backward_kernel<<<grid_size, block_size, 0, stream>>>(
+                top_grad.data.data<emb_t>(), mp_input.network_reverse_idx.data<offset_t>(),
+                mp_input.network_dst_bucket_ids.data<offset_t>(), num_key,
+                network_indices.num_keys_per_bucket.data<int>(),
+                network_indices.d_local_combiner.data<char>(),
+                network_indices.d_ev_start_indices.data<int>(), ev_size, batch_size_per_gpu,
+                network_indices.global_ev_offset, batch_major,
+                network_buffer.data.data<dst_emb_t>());
+          });
+    });
+  });
+}
+
 }  // namespace
 void NetworkBackward::sparse_backward(const core23::Tensor& dp_num_keys_per_bucket,
                                       const EmbeddingOutput& top_grad,
@@ -397,7 +563,11 @@ void NetworkBackward::dense_backward(const EmbeddingInput& embedding_input,
   int gpu_id = core_->get_global_gpu_id();
   int num_gpus = core_->get_global_gpu_count();
 
-  if (top_grad.attr.layout == EmbeddingLayout::FeatureMajor) {
+  if (network_indices.pooled) {
+    dense_pooled_network_backward(embedding_input, top_grad, network_indices,
+                                  core_->get_kernel_param(), network_buffer, batch_size, num_gpus,
+                                  stream);
+  } else if (top_grad.attr.layout == EmbeddingLayout::FeatureMajor) {
     dense_network_backward_from_feature_major_top_grad(embedding_input, top_grad, network_indices,
                                                        core_->get_kernel_param(), network_buffer,
                                                        batch_size, gpu_id, num_gpus, stream);
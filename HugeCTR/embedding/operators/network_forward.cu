@@ -15,6 +15,8 @@
  */
 
 #include <embedding/operators/generic_lookup.cuh>
+#include <embedding/operators/index_calculation.hpp>
+#include <embedding/operators/multi_to_one_reduce_v2.cuh>
 #include <embedding/operators/network_forward.hpp>
 #include <utils.hpp>
 
@@ -103,11 +105,16 @@ void NetworkBufferAttr::init(std::shared_ptr<CoreResourceManager> core,
   h_id_to_ev_size.resize(num_gpus);
   for (int ggpu_id = 0; ggpu_id < num_gpus; ++ggpu_id) {
     for (int lookup_id : h_global_lookup_ids[ggpu_id]) {
-      int ev_size = ebc_param.lookup_params[lookup_id].ev_size;
-      h_id_to_ev_size[ggpu_id].push_back(ev_size);
+      h_id_to_ev_size[ggpu_id].push_back(ebc_param.get_local_ev_size(lookup_id));
     }
   }
 
+  std::vector<int> h_dst_id_to_column_offset, h_dst_id_to_column_size;
+  for (int lookup_id = 0; lookup_id < ebc_param.num_lookup; ++lookup_id) {
+    h_dst_id_to_column_offset.push_back(ebc_param.get_local_ev_offset(grouped_id, lookup_id));
+    h_dst_id_to_column_size.push_back(ebc_param.get_local_ev_size(lookup_id));
+  }
+
   std::vector<std::vector<int>> h_id_ev_start_indices;
   h_id_ev_start_indices.resize(num_gpus);
   for (int ggpu_id = 0; ggpu_id < num_gpus; ++ggpu_id) {
@@ -138,6 +145,15 @@ void NetworkBufferAttr::init(std::shared_ptr<CoreResourceManager> core,
   this->id_to_ev_start_indices =
       core23::init_tensor_list<int32_t>(this->id_to_ev_start_indices_list, params.device().index());
 
+  this->dst_id_to_column_offset =
+      core23::Tensor(params.shape({static_cast<int64_t>(h_dst_id_to_column_offset.size())})
+                         .data_type(core23::ScalarType::Int32));
+  core23::copy_sync(this->dst_id_to_column_offset, h_dst_id_to_column_offset);
+  this->dst_id_to_column_size =
+      core23::Tensor(params.shape({static_cast<int64_t>(h_dst_id_to_column_size.size())})
+                         .data_type(core23::ScalarType::Int32));
+  core23::copy_sync(this->dst_id_to_column_size, h_dst_id_to_column_size);
+
   this->gpu_id_to_max_ev_elements.clear();
   for (int ggpu_id = 0; ggpu_id < num_gpus; ++ggpu_id) {
     this->gpu_id_to_max_ev_elements.push_back(h_id_ev_start_indices[ggpu_id].back());
@@ -170,6 +186,19 @@ void NetworkBuffer::init(std::shared_ptr<CoreResourceManager> core, const Networ
     this->data = core23::init_tensor_list<emb_t>(data_list, params.device().index());
   });
 }
+
+void NetworkBuffer::init_from_device_buffer(std::shared_ptr<CoreResourceManager> core,
+                                            const std::vector<core23::Tensor>& data_buffer_list,
+                                            const NetworkBufferAttr& attr) {
+  HugeCTR::CudaDeviceContext context(core->get_device_id());
+  HCTR_CHECK(static_cast<int>(data_buffer_list.size()) == attr.num_gpus);
+
+  this->attr = attr;
+  this->data_list = data_buffer_list;
+  DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(attr.type.type(), emb_t, [&] {
+    this->data = core23::init_tensor_list<emb_t>(this->data_list, core->get_device_id());
+  });
+}
 void DenseNetworkIndices::init(std::shared_ptr<CoreResourceManager> core,
                                const std::vector<int>& h_local_hotness_range_input,
                                const std::vector<int>& h_local_hotness_input,
@@ -204,6 +233,67 @@ void DenseNetworkIndices::init(std::shared_ptr<CoreResourceManager> core,
   core23::copy_sync(this->d_ev_start_indices, this->h_ev_start_indices);
 }
 
+void DenseNetworkIndices::init_pooling(std::shared_ptr<CoreResourceManager> core,
+                                       const std::vector<char>& h_local_combiner,
+                                       int batch_size_per_gpu) {
+  HCTR_CHECK_HINT(static_cast<int>(h_local_combiner.size()) == local_lookup_num,
+                  "DenseNetworkIndices requires the combiner of each local lookup.");
+  this->pooled = true;
+
+  HugeCTR::CudaDeviceContext context(core->get_device_id());
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::BufferParams buffer_params;
+  buffer_params.unitary = false;
+  core23::TensorParams params = core23::TensorParams().device(device).buffer_params(buffer_params);
+
+  this->d_local_combiner =
+      core23::Tensor(params.shape({static_cast<int64_t>(h_local_combiner.size())})
+                         .data_type(core23::ScalarType::Char));
+  core23::copy_sync(this->d_local_combiner, h_local_combiner);
+
+  this->num_keys_per_bucket =
+      core23::Tensor(params.shape({static_cast<int64_t>(local_lookup_num) * batch_size_per_gpu})
+                         .data_type(core23::ScalarType::Int32));
+}
+
+void DenseNetworkIndices::init_deterministic(std::shared_ptr<CoreResourceManager> core,
+                                             int ev_size, size_t max_num_elements) {
+  this->deterministic = true;
+  sorted_indices.init(core, max_num_elements);
+  ordered_buffer.init(core, ev_size, max_num_elements);
+}
+
+namespace {
+
+template <typename offset_t>
+__global__ void count_keys_per_pooled_bucket_kernel(const offset_t* __restrict__ bucket_ids,
+                                                    size_t num_key, int* num_keys_per_bucket) {
+  CUDA_1D_KERNEL_LOOP(i, num_key) { atomicAdd(num_keys_per_bucket + bucket_ids[i], 1); }
+}
+
+}  // namespace
+
+void DenseNetworkIndices::count_keys_per_bucket(const EmbeddingInput& embedding_input,
+                                                int batch_size_per_gpu,
+                                                cudaStream_t stream) const {
+  const auto& mp_input = embedding_input.dense_compression_input.model_parallel_compression_input;
+  size_t num_key = mp_input.num_network_reverse_idx;
+
+  HCTR_LIB_THROW(cudaMemsetAsync(num_keys_per_bucket.data(), 0,
+                                 static_cast<size_t>(local_lookup_num) * batch_size_per_gpu *
+                                     sizeof(int),
+                                 stream));
+  if (num_key == 0) return;
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(
+      mp_input.network_dst_bucket_ids.data_type().type(), offset_t, [&] {
+        const int block_size = 256;
+        const int grid_size = (num_key - 1) / block_size + 1;
+        count_keys_per_pooled_bucket_kernel<<<grid_size, block_size, 0, stream>>>(
+            mp_input.network_dst_bucket_ids.data<offset_t>(), num_key,
+            num_keys_per_bucket.data<int>());
+      });
+}
+
 void DenseNetworkBufferAttr::init(std::shared_ptr<CoreResourceManager> core,
                                   const EmbeddingCollectionParam& ebc_param, size_t grouped_id,
                                   int max_hotness) {
@@ -265,6 +355,8 @@ void network_forward_to_batch_major_output(const core23::Tensor& dp_num_keys_per
         const emb_t** network_comm_buffer_ptr = (const emb_t**)network_comm_buffer.data();
         const int* dst_ev_start_indices_ptr = output_attr.id_to_ev_start_indices.data<int>();
         const char* dst_combiner_ptr = output_attr.id_to_combiner.data<char>();
+        const int* dst_column_offset_ptr = network_attr.dst_id_to_column_offset.data<int>();
+        const int* dst_column_size_ptr = network_attr.dst_id_to_column_size.data<int>();
         dst_emb_t* output_buffer_ptr = output_buffer.data<dst_emb_t>();
         int num_network_dst_lookup_ids = network_indices.network_dst_lookup_ids.num_elements();
 
@@ -289,8 +381,7 @@ void network_forward_to_batch_major_output(const core23::Tensor& dp_num_keys_per
             },
             [=] __device__(int i) {
               int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
-              return dst_ev_start_indices_ptr[dst_lookup_id + 1] -
-                     dst_ev_start_indices_ptr[dst_lookup_id];
+              return dst_column_size_ptr[dst_lookup_id];
             },
             [=] __device__(int i) {
               int bid = i / network_offsets_ptr[num_network_dst_lookup_ids];
@@ -309,7 +400,8 @@ void network_forward_to_batch_major_output(const core23::Tensor& dp_num_keys_per
               int lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
               int ev_offset = dst_ev_start_indices_ptr[num_lookup] * bid;
 
-              return output_buffer_ptr + ev_offset + dst_ev_start_indices_ptr[lookup_id];
+              return output_buffer_ptr + ev_offset + dst_ev_start_indices_ptr[lookup_id] +
+                     dst_column_offset_ptr[lookup_id];
             });
         copy_multi_to_one(multi_to_one_desc, kernel_params, max_ev_size, stream);
       });
@@ -344,6 +436,8 @@ void network_forward_to_feature_major_output(const core23::Tensor& dp_num_keys_p
         const emb_t** network_comm_buffer_ptr = (const emb_t**)network_comm_buffer.data();
         const int* dst_ev_start_indices_ptr = output_attr.id_to_ev_start_indices.data<int>();
         const char* dst_combiner_ptr = output_attr.id_to_combiner.data<char>();
+        const int* dst_column_offset_ptr = network_attr.dst_id_to_column_offset.data<int>();
+        const int* dst_column_size_ptr = network_attr.dst_id_to_column_size.data<int>();
         dst_emb_t* output_buffer_ptr = output_buffer.data<dst_emb_t>();
         int num_network_dst_lookup_ids = network_indices.network_dst_lookup_ids.num_elements();
 
@@ -368,8 +462,7 @@ void network_forward_to_feature_major_output(const core23::Tensor& dp_num_keys_p
             },
             [=] __device__(int i) {
               int dst_lookup_id = network_dst_lookup_ids_ptr[i % num_network_dst_lookup_ids];
-              return dst_ev_start_indices_ptr[dst_lookup_id + 1] -
-                     dst_ev_start_indices_ptr[dst_lookup_id];
+              return dst_column_size_ptr[dst_lookup_id];
             },
             [=] __device__(int i) {
               int bid = i / network_offsets_ptr[num_network_dst_lookup_ids];
@@ -390,7 +483,8 @@ void network_forward_to_feature_major_output(const core23::Tensor& dp_num_keys_p
               int ev_offset = dst_ev_start_indices_ptr[lookup_id] * batch_size_per_gpu;
               int ev_size =
                   dst_ev_start_indices_ptr[lookup_id + 1] - dst_ev_start_indices_ptr[lookup_id];
-              return output_buffer_ptr + ev_offset + bid * ev_size;
+              return output_buffer_ptr + ev_offset + bid * ev_size +
+                     dst_column_offset_ptr[lookup_id];
             });
         copy_multi_to_one(multi_to_one_desc, kernel_params, max_ev_size, stream);
       });
@@ -566,6 +660,143 @@ void dense_network_forward_to_feature_major_output(
   });
 }
 
+// Offset of a pooled bucket in the embedding output.
+DEVICE_INLINE int64_t pooled_output_offset(int bucket_id, int batch_size_per_gpu,
+                                           const int* ev_start_indices, int ev_size,
+                                           int global_ev_offset, bool batch_major) {
+  int lookup_id = bucket_id / batch_size_per_gpu;
+  int bid = bucket_id % batch_size_per_gpu;
+  return batch_major
+             ? static_cast<int64_t>(bid) * global_ev_offset + ev_start_indices[lookup_id]
+             : static_cast<int64_t>(batch_size_per_gpu) * ev_start_indices[lookup_id] +
+                   static_cast<int64_t>(bid) * ev_size;
+}
+
+template <typename dst_emb_t>
+__global__ void zero_pooled_output_kernel(const int* ev_start_indices, int num_local_lookup,
+                                          int ev_size, int batch_size_per_gpu,
+                                          int global_ev_offset, bool batch_major,
+                                          dst_emb_t* output) {
+  CUDA_1D_KERNEL_LOOP(i, static_cast<int64_t>(num_local_lookup) * batch_size_per_gpu * ev_size) {
+    int bucket_id = i / ev_size;
+    int64_t offset = pooled_output_offset(bucket_id, batch_size_per_gpu, ev_start_indices,
+                                          ev_size, global_ev_offset, batch_major);
+    output[offset + i % ev_size] = HugeCTR::TypeConvertFunc<dst_emb_t, float>::convert(0.f);
+  }
+}
+
+// One warp per key accumulates its unique row into the pooled output of its sample.
+template <typename src_emb_t, typename dst_emb_t, typename offset_t>
+__global__ void dense_pooled_network_forward_kernel(
+    const src_emb_t* __restrict__ network_comm_buffer, const offset_t* __restrict__ reverse_idx,
+    const offset_t* __restrict__ bucket_ids, size_t num_key,
+    const int* __restrict__ num_keys_per_bucket, const char* __restrict__ local_combiner,
+    const int* __restrict__ ev_start_indices, int ev_size, int batch_size_per_gpu,
+    int global_ev_offset, bool batch_major, dst_emb_t* output) {
+  constexpr int kWarpSize = 32;
+  const int lane_id = threadIdx.x % kWarpSize;
+  const size_t num_warp = static_cast<size_t>(blockDim.x) * gridDim.x / kWarpSize;
+
+  for (size_t i = (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / kWarpSize;
+       i < num_key; i += num_warp) {
+    int bucket_id = static_cast<int>(bucket_ids[i]);
+    int lookup_id = bucket_id / batch_size_per_gpu;
+    float scale = local_combiner[lookup_id] == static_cast<char>(Combiner::Average)
+                      ? 1.f / num_keys_per_bucket[bucket_id]
+                      : 1.f;
+    const src_emb_t* src = network_comm_buffer + static_cast<int64_t>(reverse_idx[i]) * ev_size;
+    dst_emb_t* dst = output + pooled_output_offset(bucket_id, batch_size_per_gpu, ev_start_indices,
+                                                   ev_size, global_ev_offset, batch_major);
+    for (int idx4 = 4 * lane_id; idx4 < ev_size; idx4 += 4 * kWarpSize) {
+      int n = min(ev_size - idx4, 4);
+      Vec4T<float> src_elem;
+      src_elem.load(src + idx4, n);
+      Vec4T<float> scaled_elem;
+      scaled_elem.accumulate_multiply(src_elem, scale);
+      scaled_elem.atomic_store_accum(dst + idx4, n);
+    }
+  }
+}
+
+void dense_pooled_network_forward(const EmbeddingInput& embedding_input,
+                                  const DenseNetworkBuffer& network_buffer,
+                                  const DenseNetworkIndices& network_indices,
+                                  const HugeCTR::core23::KernelParams& kernel_params,
+                                  EmbeddingOutput& embedding_output, int batch_size, int num_gpus,
+                                  cudaStream_t stream) {
+  int batch_size_per_gpu = batch_size / num_gpus;
+  int ev_size = network_buffer.attr.ev_size;
+  bool batch_major = embedding_output.attr.layout == EmbeddingLayout::BatchMajor;
+  const auto& mp_input = embedding_input.dense_compression_input.model_parallel_compression_input;
+  size_t num_key = mp_input.num_network_reverse_idx;
+
+  network_indices.count_keys_per_bucket(embedding_input, batch_size_per_gpu, stream);
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(mp_input.network_reverse_idx.data_type().type(), offset_t, [&] {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(network_buffer.data.data_type().type(), emb_t, [&] {
+      DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(
+          embedding_output.data.data_type().type(), dst_emb_t, [&] {
+            const int block_size = 256;
+            const int grid_size = kernel_params.num_sms * kernel_params.max_thread_per_sm /
+                                  block_size;
+            zero_pooled_output_kernel<<<grid_size, block_size, 0, stream>>>(
+                network_indices.d_ev_start_indices.data<int>(), network_indices.local_lookup_num,
+                ev_size, batch_size_per_gpu, network_indices.global_ev_offset, batch_major,
+                embedding_output.data.data<dst_emb_t>());
+            if (num_key == 0) return;
+            if (network_indices.deterministic) {
+              // Pool the rows of each sample in the order of its keys.
+              const emb_t* network_comm_buffer = network_buffer.data.data<emb_t>();
+              const offset_t* reverse_idx = mp_input.network_reverse_idx.data<offset_t>();
+              const int* num_keys_per_bucket = network_indices.num_keys_per_bucket.data<int>();
+              const char* local_combiner = network_indices.d_local_combiner.data<char>();
+              const int* ev_start_indices = network_indices.d_ev_start_indices.data<int>();
+              int global_ev_offset = network_indices.global_ev_offset;
+              dst_emb_t* output = embedding_output.data.data<dst_emb_t>();
+
+              const auto& sorted_indices = network_indices.sorted_indices;
+              sorted_indices.sort(mp_input.network_dst_bucket_ids, num_key, stream);
+              const uint32_t* sorted_bucket_ids = sorted_indices.sorted_dst_ids.data<uint32_t>();
+              const uint32_t* sorted_key_ids = sorted_indices.sorted_src_ids.data<uint32_t>();
+
+              auto get_dst_row = [=] __device__(uint32_t bucket_id) {
+                return output + pooled_output_offset(static_cast<int>(bucket_id),
+                                                     batch_size_per_gpu, ev_start_indices,
+                                                     ev_size, global_ev_offset, batch_major);
+              };
+              auto sorted_desc = make_MultiToOne_reduce_new<emb_t, dst_emb_t>(
+                  [=] __device__() { return num_key; }, [=] __device__(int) { return ev_size; },
+                  [=] __device__(int i) { return sorted_bucket_ids[i]; },
+                  [=] __device__(int i) {
+                    return network_comm_buffer +
+                           static_cast<int64_t>(reverse_idx[sorted_key_ids[i]]) * ev_size;
+                  },
+                  [=] __device__(int i) { return get_dst_row(sorted_bucket_ids[i]); });
+              multi_to_one_reduce_ordered(
+                  sorted_desc,
+                  [=] __device__(int i) {
+                    int bucket_id = static_cast<int>(sorted_bucket_ids[i]);
+                    int lookup_id = bucket_id / batch_size_per_gpu;
+                    return local_combiner[lookup_id] == static_cast<char>(Combiner::Average)
+                               ? 1.f / num_keys_per_bucket[bucket_id]
+                               : 1.f;
+                  },
+                  get_dst_row, num_key, network_indices.ordered_buffer, ev_size, stream);
+              return;
+            }
+            dense_pooled_network_forward_kernel<<<grid_size, block_size, 0, stream>>>(
+                network_buffer.data.data<emb_t>(), mp_input.network_reverse_idx.data<offset_t>(),
+                mp_input.network_dst_bucket_ids.data<offset_t>(), num_key,
+                network_indices.num_keys_per_bucket.data<int>(),
+                network_indices.d_local_combiner.data<char>(),
+                network_indices.d_ev_start_indices.data<int>(), ev_size, batch_size_per_gpu,
+                network_indices.global_ev_offset, batch_major,
+                embedding_output.data.data<dst_emb_t>());
+          });
+    });
+  });
+}
+
 }  // namespace
 
 void NetworkForward::sparse_forward(const core23::Tensor& dp_num_keys_per_bucket,
@@ -598,7 +829,11 @@ void NetworkForward::dense_forward(const EmbeddingInput& embedding_input,
   int gpu_id = core_->get_global_gpu_id();
   int num_gpus = core_->get_global_gpu_count();
 
-  if (embedding_output.attr.layout == EmbeddingLayout::FeatureMajor) {
+  if (network_indices.pooled) {
+    dense_pooled_network_forward(embedding_input, network_buffer, network_indices,
+                                 core_->get_kernel_param(), embedding_output, batch_size, num_gpus,
+                                 stream);
+  } else if (embedding_output.attr.layout == EmbeddingLayout::FeatureMajor) {
     dense_network_forward_to_feature_major_output(embedding_input, network_buffer, network_indices,
                                                   core_->get_kernel_param(), embedding_output,
                                                   batch_size, gpu_id, num_gpus, stream);
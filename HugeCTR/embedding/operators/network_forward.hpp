@@ -17,6 +17,7 @@
 
 #include <core23/registry.hpp>
 #include <embedding/common.hpp>
+#include <embedding/operators/model_backward.hpp>
 
 namespace embedding {
 using core::CoreResourceManager;
@@ -43,6 +44,11 @@ struct NetworkBufferAttr {
   std::vector<core23::Tensor> id_to_ev_start_indices_list;
   core23::Tensor id_to_ev_start_indices;
 
+  // Columns of the output of each lookup that are written by this group. These are all columns,
+  // unless the table of the lookup is split column-wise.
+  core23::Tensor dst_id_to_column_offset;
+  core23::Tensor dst_id_to_column_size;
+
   int num_gpus;
   std::vector<int> gpu_id_to_max_ev_elements;
 
@@ -61,6 +67,10 @@ struct NetworkBuffer {
 
   void init(std::shared_ptr<CoreResourceManager> core, const NetworkBufferAttr &attr,
             int batch_size);
+
+  void init_from_device_buffer(std::shared_ptr<CoreResourceManager> core,
+                               const std::vector<core23::Tensor> &data_buffer_list,
+                               const NetworkBufferAttr &attr);
 };
 
 struct DenseNetworkIndices {
@@ -75,11 +85,32 @@ struct DenseNetworkIndices {
   int local_lookup_num;
   int global_ev_offset;
 
+  // Sum and average lookups with unique keys. All keys of a sample share the bucket id
+  // local_lookup_id * batch_size_per_gpu + sample_id.
+  bool pooled = false;
+  core23::Tensor d_local_combiner;     // char
+  core23::Tensor num_keys_per_bucket;  // int, local_lookup_num * batch_size_per_gpu
+
+  // The gradients of each unique row of the network buffer are summed in a fixed order, instead
+  // of with atomics.
+  bool deterministic = false;
+  SortedReduceIndices sorted_indices;
+  OrderedReduceBuffer ordered_buffer;
+
   void init(std::shared_ptr<CoreResourceManager> core,
             const std::vector<int> &h_local_hotness_range_input,
             const std::vector<int> &h_local_hotness_input,
             const std::vector<int> &h_ev_start_indices_input, int local_lookup_num_input,
             int global_ev_offset_input);
+
+  void init_pooling(std::shared_ptr<CoreResourceManager> core,
+                    const std::vector<char> &h_local_combiner, int batch_size_per_gpu);
+
+  void init_deterministic(std::shared_ptr<CoreResourceManager> core, int ev_size,
+                          size_t max_num_elements);
+
+  void count_keys_per_bucket(const EmbeddingInput &embedding_input, int batch_size_per_gpu,
+                             cudaStream_t stream) const;
 };
 
 struct DenseNetworkBufferAttr {
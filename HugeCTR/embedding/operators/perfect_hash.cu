@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <embedding/operators/perfect_hash.cuh>
+#include <numeric>
+#include <utils.hpp>
+
+namespace embedding {
+
+namespace {
+
+constexpr uint64_t kKeysPerBucket = 4;
+constexpr uint32_t kMaxPilot = 1u << 20;
+constexpr int kMaxAttempts = 8;
+
+}  // namespace
+
+PerfectHash build_perfect_hash(const std::vector<int64_t>& keys) {
+  const uint64_t num_keys = keys.size();
+  HCTR_CHECK_HINT(num_keys > 0 && num_keys < kPerfectHashDirectSlot,
+                  "build_perfect_hash requires between 1 and 2^31 - 1 keys.");
+  {
+    std::vector<int64_t> sorted_keys = keys;
+    std::sort(sorted_keys.begin(), sorted_keys.end());
+    HCTR_CHECK_HINT(std::adjacent_find(sorted_keys.begin(), sorted_keys.end()) == sorted_keys.end(),
+                    "build_perfect_hash requires unique keys.");
+  }
+
+  PerfectHash ph;
+  ph.num_keys = num_keys;
+  ph.num_buckets = (num_keys + kKeysPerBucket - 1) / kKeysPerBucket;
+
+  std::vector<uint64_t> hashes(num_keys);
+  std::vector<uint64_t> bucket_offsets(ph.num_buckets + 1);
+  std::vector<uint32_t> bucket_keys(num_keys);  // key ids, grouped by bucket
+  std::vector<uint64_t> bucket_order(ph.num_buckets);
+  std::vector<bool> taken(num_keys);
+  std::vector<uint64_t> slots;
+
+  for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+    ph.seed = perfect_hash_mix(0x9e3779b97f4a7c15ULL * (attempt + 1));
+
+    std::fill(bucket_offsets.begin(), bucket_offsets.end(), 0);
+    for (uint64_t i = 0; i < num_keys; ++i) {
+      hashes[i] = perfect_hash_key(static_cast<uint64_t>(keys[i]), ph.seed);
+      ++bucket_offsets[perfect_hash_bucket(hashes[i], ph.num_buckets) + 1];
+    }
+    std::partial_sum(bucket_offsets.begin(), bucket_offsets.end(), bucket_offsets.begin());
+    {
+      std::vector<uint64_t> fill = bucket_offsets;
+      for (uint64_t i = 0; i < num_keys; ++i) {
+        bucket_keys[fill[perfect_hash_bucket(hashes[i], ph.num_buckets)]++] =
+            static_cast<uint32_t>(i);
+      }
+    }
+    auto bucket_size = [&](uint64_t b) { return bucket_offsets[b + 1] - bucket_offsets[b]; };
+
+    // Place the largest buckets first, while most slots are still free. Buckets of a single key
+    // take the remaining slots directly.
+    std::iota(bucket_order.begin(), bucket_order.end(), 0);
+    std::stable_sort(bucket_order.begin(), bucket_order.end(),
+                     [&](uint64_t a, uint64_t b) { return bucket_size(a) > bucket_size(b); });
+
+    ph.pilots.assign(ph.num_buckets, 0);
+    std::fill(taken.begin(), taken.end(), false);
+    uint64_t next_free_slot = 0;
+    bool placed = true;
+    for (uint64_t b : bucket_order) {
+      const uint64_t size = bucket_size(b);
+      if (size == 0) break;
+      if (size == 1) {
+        while (taken[next_free_slot]) ++next_free_slot;
+        taken[next_free_slot] = true;
+        ph.pilots[b] = kPerfectHashDirectSlot | static_cast<uint32_t>(next_free_slot);
+        continue;
+      }
+      uint32_t pilot = 0;
+      for (; pilot < kMaxPilot; ++pilot) {
+        slots.clear();
+        for (uint64_t k = bucket_offsets[b]; k < bucket_offsets[b + 1]; ++k) {
+          uint64_t slot = perfect_hash_slot(hashes[bucket_keys[k]], pilot, num_keys);
+          if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) break;
+          slots.push_back(slot);
+        }
+        if (slots.size() == size) break;
+      }
+      if (pilot == kMaxPilot) {
+        placed = false;
+        break;
+      }
+      for (uint64_t slot : slots) {
+        taken[slot] = true;
+      }
+      ph.pilots[b] = pilot;
+    }
+    if (!placed) continue;
+
+    ph.slot_keys.resize(num_keys);
+    ph.slot_rows.resize(num_keys);
+    for (uint64_t i = 0; i < num_keys; ++i) {
+      uint64_t bucket = perfect_hash_bucket(hashes[i], ph.num_buckets);
+      uint64_t slot = perfect_hash_slot(hashes[i], ph.pilots[bucket], num_keys);
+      ph.slot_keys[slot] = static_cast<uint64_t>(keys[i]);
+      ph.slot_rows[slot] = static_cast<uint32_t>(i);
+    }
+    return ph;
+  }
+  HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError,
+                 "build_perfect_hash failed to place all keys, try again with fewer keys.");
+  return ph;
+}
+
+}  // namespace embedding
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <embedding/operators/perfect_hash.hpp>
+
+namespace embedding {
+
+// Finalizer of splitmix64.
+__host__ __device__ inline uint64_t perfect_hash_mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// Maps a hash uniformly to [0, n) without a division.
+__host__ __device__ inline uint64_t perfect_hash_reduce(uint64_t hash, uint64_t n) {
+#ifdef __CUDA_ARCH__
+  return __umul64hi(hash, n);
+#else
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(hash) * n) >> 64);
+#endif
+}
+
+__host__ __device__ inline uint64_t perfect_hash_key(uint64_t key, uint64_t seed) {
+  return perfect_hash_mix(key ^ seed);
+}
+
+__host__ __device__ inline uint64_t perfect_hash_bucket(uint64_t hash, uint64_t num_buckets) {
+  return perfect_hash_reduce(hash, num_buckets);
+}
+
+__host__ __device__ inline uint64_t perfect_hash_slot(uint64_t hash, uint32_t pilot,
+                                                      uint64_t num_keys) {
+  if (pilot & kPerfectHashDirectSlot) {
+    return pilot & ~kPerfectHashDirectSlot;
+  }
+  return perfect_hash_reduce(perfect_hash_mix(hash ^ perfect_hash_mix(pilot)), num_keys);
+}
+
+}  // namespace embedding
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace embedding {
+
+// Pilots with this bit set hold the slot of their single key, instead of a displacement.
+constexpr uint32_t kPerfectHashDirectSlot = 1u << 31;
+
+/**
+ * Minimal perfect hash of a static vocabulary, built with hash and displace (PTHash). The keys are
+ * hashed into buckets of 4 keys on average, and every bucket stores the pilot that displaces its
+ * keys into free slots of [0, num_keys). Slots are verified against the key they were built for,
+ * so that keys outside of the vocabulary are detected.
+ */
+struct PerfectHash {
+  uint64_t seed = 0;
+  uint64_t num_keys = 0;
+  uint64_t num_buckets = 0;
+  std::vector<uint32_t> pilots;     // per bucket
+  std::vector<uint64_t> slot_keys;  // key of each slot
+  std::vector<uint32_t> slot_rows;  // position of the key of each slot in the vocabulary
+};
+
+// Device view of the hash of one table, whose pilots and slots are concatenated with the other
+// tables at the given offsets.
+struct PerfectHashParams {
+  uint64_t seed;
+  uint64_t num_keys;
+  uint64_t num_buckets;
+  uint64_t pilot_offset;
+  uint64_t slot_offset;
+};
+static_assert(sizeof(PerfectHashParams) == 5 * sizeof(uint64_t), "copied as uint64_t");
+
+// Builds the hash of unique keys on the host. Throws if the keys are not unique.
+PerfectHash build_perfect_hash(const std::vector<int64_t>& keys);
+
+}  // namespace embedding
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_fp16.h>
+
+#include <cstdint>
+
+namespace embedding {
+
+// Counter-based random number of an element. The same seed and index give the same number on
+// every gpu, so that replicated values stay identical after rounding.
+__device__ __forceinline__ uint32_t hash_index(uint32_t seed, uint32_t index) {
+  uint32_t h = seed ^ (index * 0x9E3779B9u);
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return h;
+}
+
+// Rounds v to one of the two nearest FP16 values, with a probability proportional to its
+// proximity. The random bits are added to the 13 mantissa bits that FP16 drops, before truncation.
+// FP16 subnormals drop more bits, which are truncated.
+__device__ __forceinline__ __half stochastic_round_half(float v, uint32_t rand) {
+  if (!isfinite(v)) return __float2half(v);
+  uint32_t bits = __float_as_uint(v);
+  bits = (bits + (rand & 0x1FFFu)) & ~0x1FFFu;
+  return __float2half_rz(__uint_as_float(bits));
+}
+
+}  // namespace embedding
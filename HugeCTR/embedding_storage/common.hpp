@@ -68,6 +68,57 @@ struct InitParams {
   }
 };
 
+enum class EvictionPolicy { Disabled, LRU, LFU, TTL };
+
+// Bounds the number of keys of a dynamic table. Every check_interval updates, a table with more
+// than max_num_keys keys evicts its least recently (LRU, TTL) or least frequently (LFU) looked up
+// keys, until evict_to_ratio * max_num_keys keys are left. With TTL, keys which were not looked up
+// in the last ttl iterations are evicted as well. Evicted keys can be spilled to host memory, and
+// are restored when they are looked up again.
+struct EvictionParams {
+  EvictionPolicy policy;
+  int64_t max_num_keys;  // 0 means unbounded
+  int64_t ttl;
+  double evict_to_ratio;
+  int check_interval;
+  bool spill_to_host;
+
+  EvictionParams(EvictionPolicy policy = EvictionPolicy::Disabled, int64_t max_num_keys = 0,
+                 int64_t ttl = 0, double evict_to_ratio = 0.9, int check_interval = 100,
+                 bool spill_to_host = false)
+      : policy(policy),
+        max_num_keys(max_num_keys),
+        ttl(ttl),
+        evict_to_ratio(evict_to_ratio),
+        check_interval(check_interval),
+        spill_to_host(spill_to_host) {
+    HCTR_CHECK_HINT(max_num_keys >= 0, "max_num_keys should be >= 0");
+    HCTR_CHECK_HINT(policy != EvictionPolicy::TTL || ttl > 0,
+                    "eviction policy TTL should specify ttl");
+    HCTR_CHECK_HINT(evict_to_ratio > 0 && evict_to_ratio <= 1,
+                    "evict_to_ratio should be in (0, 1]");
+    HCTR_CHECK_HINT(check_interval > 0, "check_interval should be > 0");
+  }
+};
+
+enum class CompositionalCombiner { Disabled, Sum, Mul };
+
+// Represents a static table by two smaller tables, to save memory. Row i of a shard of the table
+// combines row i / num_remainder_rows of a quotient table and row i % num_remainder_rows of a
+// remainder table element-wise, so that the shard of n rows only stores about
+// n / num_remainder_rows + num_remainder_rows rows.
+struct CompositionalParams {
+  CompositionalCombiner combiner;
+  int num_remainder_rows;
+
+  CompositionalParams(CompositionalCombiner combiner = CompositionalCombiner::Disabled,
+                      int num_remainder_rows = 0)
+      : combiner(combiner), num_remainder_rows(num_remainder_rows) {
+    HCTR_CHECK_HINT(combiner == CompositionalCombiner::Disabled || num_remainder_rows > 0,
+                    "compositional tables should specify num_remainder_rows > 0");
+  }
+};
+
 struct EmbeddingTableParam {
   int table_id;
   int max_vocabulary_size;  // -1 means dynamic
@@ -75,16 +126,27 @@ struct EmbeddingTableParam {
 
   HugeCTR::OptParams opt_param;
   InitParams init_param;
+  EvictionParams eviction_param;  // Only used by dynamic tables
+  // If positive, the static table is kept in pinned host memory, and this many of its rows are
+  // cached on the gpus. 0 keeps the whole table on the gpus.
+  int num_gpu_cached_rows = 0;
+  CompositionalParams compositional_param;  // Only used by static tables
 
   EmbeddingTableParam() = default;
 
   EmbeddingTableParam(int table_id, int max_vocabulary_size, int ev_size,
-                      HugeCTR::OptParams opt_param, InitParams init_param = InitParams()) {
+                      HugeCTR::OptParams opt_param, InitParams init_param = InitParams(),
+                      EvictionParams eviction_param = EvictionParams(),
+                      int num_gpu_cached_rows = 0,
+                      CompositionalParams compositional_param = CompositionalParams()) {
     this->table_id = table_id;
     this->max_vocabulary_size = max_vocabulary_size;
     this->ev_size = ev_size;
     this->opt_param = opt_param;
     this->init_param = init_param;
+    this->eviction_param = eviction_param;
+    this->num_gpu_cached_rows = num_gpu_cached_rows;
+    this->compositional_param = compositional_param;
   }
 };
 }  // namespace embedding
@@ -0,0 +1,525 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <core23/data_type_helpers.cuh>
+#include <cub/cub.cuh>
+#include <embedding/view.hpp>
+#include <embedding_storage/compositional_embedding.hpp>
+#include <utils.cuh>
+#include <utils.hpp>
+
+namespace embedding {
+
+namespace {
+
+constexpr int num_load_floats = 4;
+constexpr int disabled_combiner = static_cast<int>(CompositionalCombiner::Disabled);
+constexpr int mul_combiner = static_cast<int>(CompositionalCombiner::Mul);
+
+// Finds the stored rows of the keys, which are rows of the tables of the group.
+struct CompositionalRows {
+  const uint64_t *num_key_per_table_offset;
+  const uint64_t *num_row_per_table_offset;
+  int64_t num_table_offset;
+  const uint64_t *num_quotient_rows;
+  const uint64_t *num_remainder_rows;
+  const int *combiners;
+  const uint64_t *emb_table_ev_offset;
+  const int *ev_sizes;
+
+  // Returns the local table of the key, and its quotient and remainder row. The quotient row of a
+  // table which is not compositional is its only row.
+  DEVICE_INLINE int64_t find(uint64_t key, uint64_t *quotient_row, uint64_t *remainder_row) const {
+    const int64_t t = bs_upper_bound_sub_one(num_key_per_table_offset, num_table_offset, key);
+    const uint64_t row = key - num_key_per_table_offset[t];
+    const uint64_t num_remainder = num_remainder_rows[t];
+    if (num_remainder == 0) {
+      *quotient_row = num_row_per_table_offset[t] + row;
+      *remainder_row = *quotient_row;
+    } else {
+      *quotient_row = num_row_per_table_offset[t] + row / num_remainder;
+      *remainder_row = num_row_per_table_offset[t] + num_quotient_rows[t] + row % num_remainder;
+    }
+    return t;
+  }
+
+  DEVICE_INLINE uint64_t ev_start(int64_t t, uint64_t row) const {
+    return emb_table_ev_offset[t] + (row - num_row_per_table_offset[t]) * ev_sizes[t];
+  }
+};
+
+// One warp per key. The results of tables which are not compositional point to their rows.
+template <typename key_t>
+__global__ void compositional_lookup_kernel(const key_t *keys, size_t num_keys,
+                                            CompositionalRows rows, const float *emb_table,
+                                            int stride, float *vectors, float **emb_vec) {
+  const int lane_id = threadIdx.x % warpSize;
+  const size_t num_warps = static_cast<size_t>(gridDim.x) * blockDim.x / warpSize;
+  for (size_t k = (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / warpSize;
+       k < num_keys; k += num_warps) {
+    uint64_t quotient_row, remainder_row;
+    const int64_t t = rows.find(static_cast<uint64_t>(keys[k]), &quotient_row, &remainder_row);
+    const float *quotient_ev = emb_table + rows.ev_start(t, quotient_row);
+    const int combiner = rows.combiners[t];
+    if (combiner == disabled_combiner) {
+      if (lane_id == 0) {
+        emb_vec[k] = const_cast<float *>(quotient_ev);
+      }
+      continue;
+    }
+
+    const float *remainder_ev = emb_table + rows.ev_start(t, remainder_row);
+    const int ev_size = rows.ev_sizes[t];
+    float *dst = vectors + k * stride;
+    for (int i = lane_id; i < ev_size; i += warpSize) {
+      dst[i] = combiner == mul_combiner ? quotient_ev[i] * remainder_ev[i]
+                                        : quotient_ev[i] + remainder_ev[i];
+    }
+    if (lane_id == 0) {
+      emb_vec[k] = dst;
+    }
+  }
+}
+
+// One warp per key. Adds the wgrad of the key to the wgrad of its stored rows, and flags them.
+template <typename key_t, typename wgrad_t>
+__global__ void compositional_accumulate_wgrad_kernel(const key_t *keys, const uint64_t *num_keys,
+                                                      const uint32_t *ev_start_indices,
+                                                      const wgrad_t *wgrad, CompositionalRows rows,
+                                                      const float *emb_table, float *row_wgrad,
+                                                      uint8_t *row_flags) {
+  const int lane_id = threadIdx.x % warpSize;
+  const size_t num_warps = static_cast<size_t>(gridDim.x) * blockDim.x / warpSize;
+  const uint64_t n = *num_keys;
+  for (size_t k = (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / warpSize; k < n;
+       k += num_warps) {
+    uint64_t quotient_row, remainder_row;
+    const int64_t t = rows.find(static_cast<uint64_t>(keys[k]), &quotient_row, &remainder_row);
+    const uint64_t quotient_start = rows.ev_start(t, quotient_row);
+    const uint64_t remainder_start = rows.ev_start(t, remainder_row);
+    const int combiner = rows.combiners[t];
+    const int ev_size = rows.ev_sizes[t];
+    const wgrad_t *g = wgrad + ev_start_indices[k];
+    if (lane_id == 0) {
+      row_flags[quotient_row] = 1;
+      row_flags[remainder_row] = 1;
+    }
+
+    for (int i = lane_id; i < ev_size; i += warpSize) {
+      const float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]);
+      if (combiner == disabled_combiner) {
+        atomicAdd(row_wgrad + quotient_start + i, gi);
+      } else if (combiner == mul_combiner) {
+        // The gradient of a factor is the product of the gradient and the other factor.
+        atomicAdd(row_wgrad + quotient_start + i, gi * emb_table[remainder_start + i]);
+        atomicAdd(row_wgrad + remainder_start + i, gi * emb_table[quotient_start + i]);
+      } else {
+        atomicAdd(row_wgrad + quotient_start + i, gi);
+        atomicAdd(row_wgrad + remainder_start + i, gi);
+      }
+    }
+  }
+}
+
+// Prepares the arguments of the update of the selected stored rows, and clears their flags.
+template <typename key_t>
+__global__ void compositional_prepare_rows_kernel(const key_t *rows, const uint64_t *num_rows,
+                                                  CompositionalRows row_finder,
+                                                  const int *table_ids, int *row_table_ids,
+                                                  uint32_t *row_ev_start_indices,
+                                                  uint8_t *row_flags) {
+  CUDA_1D_KERNEL_LOOP_T(uint64_t, i, *num_rows) {
+    const uint64_t row = static_cast<uint64_t>(rows[i]);
+    const int64_t t = bs_upper_bound_sub_one(row_finder.num_row_per_table_offset,
+                                             row_finder.num_table_offset, row);
+    row_table_ids[i] = table_ids[t];
+    row_ev_start_indices[i] = static_cast<uint32_t>(row_finder.ev_start(t, row));
+    row_flags[row] = 0;
+  }
+}
+
+// One warp per selected stored row.
+__global__ void compositional_clear_wgrad_kernel(const uint64_t *num_rows,
+                                                 const uint32_t *row_ev_start_indices,
+                                                 const int *row_table_ids, const int *table_ids,
+                                                 int64_t num_tables, const int *ev_sizes,
+                                                 float *row_wgrad) {
+  const int lane_id = threadIdx.x % warpSize;
+  const size_t num_warps = static_cast<size_t>(gridDim.x) * blockDim.x / warpSize;
+  const uint64_t n = *num_rows;
+  for (uint64_t k = (static_cast<uint64_t>(blockIdx.x) * blockDim.x + threadIdx.x) / warpSize;
+       k < n; k += num_warps) {
+    const int64_t t = bs_upper_bound_sub_one(table_ids, num_tables, row_table_ids[k]);
+    float *wgrad = row_wgrad + row_ev_start_indices[k];
+    for (int i = lane_id; i < ev_sizes[t]; i += warpSize) {
+      wgrad[i] = 0.f;
+    }
+  }
+}
+
+}  // namespace
+
+CompositionalEmbeddingTable::CompositionalEmbeddingTable(
+    const HugeCTR::GPUResource &gpu_resource, std::shared_ptr<CoreResourceManager> core,
+    const std::vector<EmbeddingTableParam> &table_params, const EmbeddingCollectionParam &ebc_param,
+    size_t grouped_id, const HugeCTR::OptParams &opt_param)
+    : core_(core) {
+  CudaDeviceContext ctx(core_->get_device_id());
+  const auto &grouped_table_param = ebc_param.grouped_table_params[grouped_id];
+  HCTR_CHECK_HINT(ebc_param.table_storage_type_ == TableStorageType::FP32,
+                  "compositional embedding tables only support FP32 weights.");
+  HCTR_CHECK_HINT(grouped_table_param.column_shard_id < 0,
+                  "compositional embedding tables do not support column-wise sharding.");
+  const int global_gpu_id = core_->get_global_gpu_id();
+
+  // The stored rows of each local table are the rows of a table of a data parallel group, so that
+  // each gpu stores the rows of its own shards.
+  std::vector<EmbeddingTableParam> row_table_params = table_params;
+  std::vector<int> local_table_ids;
+  h_num_key_per_table_offset_.push_back(0);
+  for (int table_id : grouped_table_param.table_ids) {
+    int shard_id = 0;
+    int num_shards = 1;
+    if (grouped_table_param.table_placement_strategy == TablePlacementStrategy::ModelParallel) {
+      if (!ebc_param.has_grouped_table_shard(global_gpu_id, grouped_id, table_id)) {
+        continue;
+      }
+      ebc_param.get_table_shard_id(global_gpu_id, table_id, &shard_id, &num_shards);
+    }
+    const auto &table_param = table_params[table_id];
+    const int64_t max_vocabulary_size = table_param.max_vocabulary_size;
+    const uint64_t num_keys =
+        max_vocabulary_size > shard_id ? (max_vocabulary_size - shard_id - 1) / num_shards + 1 : 0;
+
+    const auto &compositional_param = table_param.compositional_param;
+    CompositionalCombiner combiner = compositional_param.combiner;
+    uint64_t num_quotient_rows = num_keys;
+    uint64_t num_remainder_rows = 0;
+    if (combiner != CompositionalCombiner::Disabled && num_keys > 0) {
+      num_remainder_rows =
+          std::min(static_cast<uint64_t>(compositional_param.num_remainder_rows), num_keys);
+      num_quotient_rows = HugeCTR::ceildiv(num_keys, num_remainder_rows);
+    } else {
+      combiner = CompositionalCombiner::Disabled;
+    }
+
+    auto &row_table_param = row_table_params[table_id];
+    row_table_param.max_vocabulary_size = static_cast<int>(num_quotient_rows + num_remainder_rows);
+    if (combiner != CompositionalCombiner::Disabled) {
+      HCTR_CHECK_HINT(
+          table_param.init_param.initializer_type != HugeCTR::Initializer_t::Sinusoidal,
+          "compositional embedding tables do not support the sinusoidal initializer, table ",
+          table_id);
+      // Keep the combined rows within the bounds of the default initializer of the whole table.
+      if (table_param.init_param.initializer_type == HugeCTR::Initializer_t::Default) {
+        const float up_bound = sqrt(1.f / max_vocabulary_size);
+        row_table_param.init_param =
+            InitParams(table_param.ev_size, HugeCTR::Initializer_t::Uniform,
+                       combiner == CompositionalCombiner::Mul ? sqrt(up_bound) : up_bound / 2);
+      }
+    }
+
+    local_table_ids.push_back(table_id);
+    h_table_ids_.push_back(table_id);
+    h_num_key_per_table_offset_.push_back(h_num_key_per_table_offset_.back() + num_keys);
+    h_num_quotient_rows_.push_back(num_quotient_rows);
+    h_num_remainder_rows_.push_back(num_remainder_rows);
+    h_combiners_.push_back(static_cast<int>(combiner));
+    h_shard_ids_.push_back(shard_id);
+    h_num_shards_.push_back(num_shards);
+  }
+
+  EmbeddingCollectionParam row_ebc_param = ebc_param;
+  row_ebc_param.grouped_table_params.emplace_back(TablePlacementStrategy::DataParallel,
+                                                  local_table_ids);
+  table_ = std::make_unique<RaggedStaticEmbeddingTable>(
+      gpu_resource, core, row_table_params, row_ebc_param,
+      row_ebc_param.grouped_table_params.size() - 1, opt_param);
+  h_num_row_per_table_offset_.assign(table_->h_num_key_per_table_offset_.begin(),
+                                     table_->h_num_key_per_table_offset_.end());
+  HCTR_CHECK_HINT(table_->emb_table_size_ <= std::numeric_limits<uint32_t>::max(),
+                  "the stored rows of a compositional embedding table exceed the range of the "
+                  "wgrad indices.");
+  stride_ = HugeCTR::alignTo(table_->max_ev_size_, num_load_floats);
+
+  core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  auto to_tensor = [&](const auto &vec, core23::ScalarType type) {
+    core23::Tensor tensor(params.shape({static_cast<int64_t>(vec.size())}).data_type(type));
+    core23::copy_sync(tensor, vec);
+    return tensor;
+  };
+  num_key_per_table_offset_ = to_tensor(h_num_key_per_table_offset_, core23::ScalarType::UInt64);
+  num_row_per_table_offset_ = to_tensor(h_num_row_per_table_offset_, core23::ScalarType::UInt64);
+  num_quotient_rows_ = to_tensor(h_num_quotient_rows_, core23::ScalarType::UInt64);
+  num_remainder_rows_ = to_tensor(h_num_remainder_rows_, core23::ScalarType::UInt64);
+  combiners_ = to_tensor(h_combiners_, core23::ScalarType::Int32);
+
+  const int64_t num_rows = std::max<int64_t>(h_num_row_per_table_offset_.back(), 1);
+  row_wgrad_ = core23::Tensor(
+      params.shape({std::max<int64_t>(table_->emb_table_size_, 1)}).data_type(
+          core23::ScalarType::Float));
+  row_flags_ = core23::Tensor(params.shape({num_rows}).data_type(core23::ScalarType::UInt8));
+  rows_ = core23::Tensor(params.shape({num_rows}).data_type(ebc_param.key_type));
+  num_rows_ = core23::Tensor(params.shape({1}).data_type(core23::ScalarType::UInt64));
+  row_table_ids_ = core23::Tensor(params.shape({num_rows}).data_type(core23::ScalarType::Int32));
+  row_ev_start_indices_ =
+      core23::Tensor(params.shape({num_rows}).data_type(core23::ScalarType::UInt32));
+  HCTR_LIB_THROW(cudaMemset(row_wgrad_.data(), 0, row_wgrad_.num_bytes()));
+  HCTR_LIB_THROW(cudaMemset(row_flags_.data(), 0, row_flags_.num_bytes()));
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(ebc_param.key_type.type(), key_t, [&] {
+    size_t temp_storage_bytes = 0;
+    cub::CountingInputIterator<key_t> counting(0);
+    HCTR_LIB_THROW(cub::DeviceSelect::Flagged(nullptr, temp_storage_bytes, counting,
+                                              (uint8_t *)nullptr, (key_t *)nullptr,
+                                              (uint64_t *)nullptr, num_rows));
+    select_temp_storage_ =
+        core23::Tensor(params.shape({std::max<int64_t>(temp_storage_bytes, 1)})
+                           .data_type(core23::ScalarType::Char));
+  });
+
+  size_t num_stored_rows = h_num_row_per_table_offset_.back();
+  HCTR_LOG_S(INFO, ROOT) << "Compositional embedding table of grouped table " << grouped_id
+                         << " on GPU " << core_->get_device_id() << " stores " << num_stored_rows
+                         << " rows for its " << key_num() << " rows" << std::endl;
+}
+
+std::vector<size_t> CompositionalEmbeddingTable::key_num_per_table() const {
+  std::vector<size_t> key_num;
+  for (size_t i = 0; i + 1 < h_num_key_per_table_offset_.size(); ++i) {
+    key_num.push_back(h_num_key_per_table_offset_[i + 1] - h_num_key_per_table_offset_[i]);
+  }
+  return key_num;
+}
+
+void CompositionalEmbeddingTable::lookup(const core23::Tensor &keys, size_t num_keys,
+                                         const core23::Tensor &id_space_offset,
+                                         size_t num_id_space_offset,
+                                         const core23::Tensor &id_space,
+                                         core23::Tensor &embedding_vec) {
+  if (num_keys == 0) {
+    return;
+  }
+  CudaDeviceContext ctx(core_->get_device_id());
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+
+  const int64_t num_elements = static_cast<int64_t>(num_keys) * stride_;
+  core23::Tensor &lookup_buffer = lookup_buffers_[stream];
+  if (lookup_buffer.empty() || lookup_buffer.num_elements() < num_elements) {
+    // The previous buffer may still be read by earlier work of the stream.
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+    lookup_buffer = core23::Tensor(core23::TensorParams()
+                                       .device(device)
+                                       .shape({num_elements})
+                                       .data_type(core23::ScalarType::Float));
+  }
+
+  CompositionalRows rows{num_key_per_table_offset_.data<uint64_t>(),
+                         num_row_per_table_offset_.data<uint64_t>(),
+                         num_key_per_table_offset_.num_elements(),
+                         num_quotient_rows_.data<uint64_t>(),
+                         num_remainder_rows_.data<uint64_t>(),
+                         combiners_.data<int>(),
+                         table_->emb_table_ev_offset_.data<uint64_t>(),
+                         table_->local_ev_size_list_.data<int>()};
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(keys.data_type().type(), key_t, [&] {
+    constexpr int block_size = 256;
+    const auto &kernel_param = core_->get_kernel_param();
+    const int grid_size = std::min(
+        HugeCTR::ceildiv(static_cast<int>(num_keys), block_size / 32),
+        HugeCTR::ceildiv(kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size));
+    compositional_lookup_kernel<<<grid_size, block_size, 0, stream>>>(
+        keys.data<key_t>(), num_keys, rows, table_->emb_table_.data<float>(), stride_,
+        lookup_buffer.data<float>(), static_cast<float **>(embedding_vec.data()));
+    HCTR_LIB_THROW(cudaPeekAtLastError());
+  });
+}
+
+void CompositionalEmbeddingTable::update(const core23::Tensor &unique_keys,
+                                         const core23::Tensor &num_unique_keys,
+                                         const core23::Tensor &table_ids,
+                                         const core23::Tensor &ev_start_indices,
+                                         const core23::Tensor &wgrad) {
+  CudaDeviceContext ctx(core_->get_device_id());
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+  if (h_table_ids_.empty()) return;
+  HCTR_CHECK(num_unique_keys.data_type() == core23::ScalarType::UInt64);
+  HCTR_CHECK(ev_start_indices.data_type() == core23::ScalarType::UInt32);
+
+  CompositionalRows rows{num_key_per_table_offset_.data<uint64_t>(),
+                         num_row_per_table_offset_.data<uint64_t>(),
+                         num_key_per_table_offset_.num_elements(),
+                         num_quotient_rows_.data<uint64_t>(),
+                         num_remainder_rows_.data<uint64_t>(),
+                         combiners_.data<int>(),
+                         table_->emb_table_ev_offset_.data<uint64_t>(),
+                         table_->local_ev_size_list_.data<int>()};
+  constexpr int block_size = 256;
+  const auto &kernel_param = core_->get_kernel_param();
+  const int grid_size =
+      HugeCTR::ceildiv(kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size);
+
+  // The wgrad of the stored rows is reduced before the optimizer reads them.
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(unique_keys.data_type().type(), key_t, [&] {
+    DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data_type().type(), wgrad_t, [&] {
+      compositional_accumulate_wgrad_kernel<<<grid_size, block_size, 0, stream>>>(
+          unique_keys.data<key_t>(), num_unique_keys.data<uint64_t>(),
+          ev_start_indices.data<uint32_t>(), wgrad.data<wgrad_t>(), rows,
+          table_->emb_table_.data<float>(), row_wgrad_.data<float>(), row_flags_.data<uint8_t>());
+      HCTR_LIB_THROW(cudaPeekAtLastError());
+    });
+
+    size_t temp_storage_bytes = select_temp_storage_.num_bytes();
+    cub::CountingInputIterator<key_t> counting(0);
+    HCTR_LIB_THROW(cub::DeviceSelect::Flagged(
+        select_temp_storage_.data(), temp_storage_bytes, counting, row_flags_.data<uint8_t>(),
+        rows_.data<key_t>(), num_rows_.data<uint64_t>(), row_flags_.num_elements(), stream));
+    compositional_prepare_rows_kernel<<<grid_size, block_size, 0, stream>>>(
+        rows_.data<key_t>(), num_rows_.data<uint64_t>(), rows, table_->table_ids_.data<int>(),
+        row_table_ids_.data<int>(), row_ev_start_indices_.data<uint32_t>(),
+        row_flags_.data<uint8_t>());
+    HCTR_LIB_THROW(cudaPeekAtLastError());
+  });
+
+  table_->update(rows_, num_rows_, row_table_ids_, row_ev_start_indices_, row_wgrad_);
+
+  compositional_clear_wgrad_kernel<<<grid_size, block_size, 0, stream>>>(
+      num_rows_.data<uint64_t>(), row_ev_start_indices_.data<uint32_t>(),
+      row_table_ids_.data<int>(), table_->table_ids_.data<int>(), table_->table_ids_.num_elements(),
+      table_->local_ev_size_list_.data<int>(), row_wgrad_.data<float>());
+  HCTR_LIB_THROW(cudaPeekAtLastError());
+}
+
+void CompositionalEmbeddingTable::assign(const core23::Tensor &unique_key, size_t num_unique_key,
+                                         const core23::Tensor &num_unique_key_per_table_offset,
+                                         size_t num_table_offset,
+                                         const core23::Tensor &table_id_list,
+                                         core23::Tensor &embeding_vector,
+                                         const core23::Tensor &embedding_vector_offset) {
+  HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
+                 "compositional embedding tables cannot be assigned embedding vectors.");
+}
+
+void CompositionalEmbeddingTable::load(core23::Tensor &keys, core23::Tensor &id_space_offset,
+                                       core23::Tensor &embedding_table,
+                                       core23::Tensor &ev_size_list, core23::Tensor &id_space) {
+  HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
+                 "compositional embedding tables cannot load embedding vectors.");
+}
+
+void CompositionalEmbeddingTable::load_by_id(core23::Tensor *h_keys_tensor,
+                                             core23::Tensor *h_embedding_table, int table_id) {
+  HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
+                 "compositional embedding tables cannot load embedding vectors.");
+}
+
+std::vector<float> CompositionalEmbeddingTable::combined_rows(size_t table_index) const {
+  const uint64_t ev_offset = table_->h_emb_table_ev_offset_[table_index];
+  const int ev_size = table_->h_local_ev_sizes_[table_index];
+  std::vector<float> stored_rows(table_->h_size_per_table_[table_index]);
+  HCTR_LIB_THROW(cudaMemcpy(stored_rows.data(), table_->emb_table_.data<float>() + ev_offset,
+                            sizeof(float) * stored_rows.size(), cudaMemcpyDeviceToHost));
+
+  const uint64_t num_keys =
+      h_num_key_per_table_offset_[table_index + 1] - h_num_key_per_table_offset_[table_index];
+  const uint64_t num_quotient_rows = h_num_quotient_rows_[table_index];
+  const uint64_t num_remainder_rows = h_num_remainder_rows_[table_index];
+  const int combiner = h_combiners_[table_index];
+  if (combiner == disabled_combiner) {
+    return stored_rows;
+  }
+  std::vector<float> rows(num_keys * ev_size);
+  for (uint64_t row = 0; row < num_keys; ++row) {
+    const float *quotient_ev = &stored_rows[(row / num_remainder_rows) * ev_size];
+    const float *remainder_ev =
+        &stored_rows[(num_quotient_rows + row % num_remainder_rows) * ev_size];
+    for (int i = 0; i < ev_size; ++i) {
+      rows[row * ev_size + i] = combiner == mul_combiner ? quotient_ev[i] * remainder_ev[i]
+                                                         : quotient_ev[i] + remainder_ev[i];
+    }
+  }
+  return rows;
+}
+
+void CompositionalEmbeddingTable::dump(core23::Tensor *keys, core23::Tensor *id_space_offset,
+                                       core23::Tensor *embedding_table,
+                                       core23::Tensor *ev_size_list, core23::Tensor *id_space) {
+  CudaDeviceContext ctx(core_->get_device_id());
+  core23::Device device(core23::DeviceType::CPU);
+  core23::TensorParams params = core23::TensorParams().device(device);
+
+  std::vector<float> rows;
+  for (size_t i = 0; i < h_table_ids_.size(); ++i) {
+    const std::vector<float> table_rows = combined_rows(i);
+    rows.insert(rows.end(), table_rows.begin(), table_rows.end());
+  }
+
+  *keys = core23::Tensor(params.shape({static_cast<int64_t>(key_num())})
+                             .data_type(table_->keys_.data_type()));
+  *id_space_offset =
+      core23::Tensor(params.shape({static_cast<int64_t>(h_num_key_per_table_offset_.size())})
+                         .data_type(table_->num_key_per_table_offset_.data_type()));
+  *embedding_table = core23::Tensor(
+      params.shape({static_cast<int64_t>(rows.size())}).data_type(core23::ScalarType::Float));
+  *ev_size_list = core23::Tensor(params.shape({table_->local_ev_size_list_.num_elements()})
+                                     .data_type(table_->local_ev_size_list_.data_type()));
+  *id_space = core23::Tensor(params.shape({table_->table_ids_.num_elements()})
+                                 .data_type(table_->table_ids_.data_type()));
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(keys->data_type().type(), key_t, [&] {
+    key_t *h_keys = keys->data<key_t>();
+    for (size_t i = 0; i < h_table_ids_.size(); ++i) {
+      for (uint64_t row = h_num_key_per_table_offset_[i]; row < h_num_key_per_table_offset_[i + 1];
+           ++row) {
+        h_keys[row] = static_cast<key_t>((row - h_num_key_per_table_offset_[i]) * h_num_shards_[i] +
+                                         h_shard_ids_[i]);
+      }
+    }
+  });
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(id_space_offset->data_type().type(), index_t, [&] {
+    std::transform(h_num_key_per_table_offset_.begin(), h_num_key_per_table_offset_.end(),
+                   id_space_offset->data<index_t>(),
+                   [](uint64_t offset) { return static_cast<index_t>(offset); });
+  });
+  std::copy(rows.begin(), rows.end(), embedding_table->data<float>());
+  core23::copy_sync(*ev_size_list, table_->local_ev_size_list_);
+  core23::copy_sync(*id_space, table_->table_ids_);
+}
+
+void CompositionalEmbeddingTable::dump_by_id(core23::Tensor *h_keys_tensor,
+                                             core23::Tensor *h_embedding_table, int table_id) {
+  auto it = std::find(h_table_ids_.begin(), h_table_ids_.end(), table_id);
+  HCTR_CHECK_HINT(it != h_table_ids_.end(), "Error: Wrong table id");
+  const size_t table_index = it - h_table_ids_.begin();
+  CudaDeviceContext ctx(core_->get_device_id());
+
+  const std::vector<float> rows = combined_rows(table_index);
+  const uint64_t num_keys =
+      h_num_key_per_table_offset_[table_index + 1] - h_num_key_per_table_offset_[table_index];
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(h_keys_tensor->data_type().type(), key_t, [&] {
+    key_t *h_keys = h_keys_tensor->data<key_t>();
+    for (uint64_t row = 0; row < num_keys; ++row) {
+      h_keys[row] =
+          static_cast<key_t>(row * h_num_shards_[table_index] + h_shard_ids_[table_index]);
+    }
+  });
+  std::copy(rows.begin(), rows.end(), h_embedding_table->data<float>());
+}
+
+}  // namespace embedding
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <embedding_storage/ragged_static_embedding.hpp>
+#include <map>
+#include <memory>
+
+namespace embedding {
+
+// Static table whose compositional tables are stored as their quotient and remainder rows, see
+// CompositionalParams. The other tables of the group are stored as usual. The stored rows are the
+// rows of an inner data parallel table, so that its optimizers update them. Lookups combine the
+// two rows of each key of a compositional table into a buffer. Updates reduce the wgrad of the
+// keys into the wgrad of the stored rows, and then apply the optimizer to these rows.
+class CompositionalEmbeddingTable final : public IGroupedEmbeddingTable {
+  std::shared_ptr<CoreResourceManager> core_;
+  std::unique_ptr<RaggedStaticEmbeddingTable> table_;
+
+  // Of each local table: its rows on this gpu, and the first stored row and the number of quotient
+  // rows and remainder rows of them. Tables which are not compositional have no remainder rows.
+  std::vector<int> h_table_ids_;
+  std::vector<uint64_t> h_num_key_per_table_offset_;
+  std::vector<uint64_t> h_num_row_per_table_offset_;
+  std::vector<uint64_t> h_num_quotient_rows_;
+  std::vector<uint64_t> h_num_remainder_rows_;
+  std::vector<int> h_combiners_;  // CompositionalCombiner
+  // Row i of the shard of a table on this gpu is key i * num_shards + shard_id of the table.
+  std::vector<int> h_shard_ids_;
+  std::vector<int> h_num_shards_;
+  core23::Tensor num_key_per_table_offset_;
+  core23::Tensor num_row_per_table_offset_;
+  core23::Tensor num_quotient_rows_;
+  core23::Tensor num_remainder_rows_;
+  core23::Tensor combiners_;
+  // Rows in the lookup results are padded to 4 floats, for vectorized loads.
+  int stride_;
+
+  // The combined rows of the lookup results, one buffer per stream. A buffer is reused once the
+  // earlier work of its stream, which consumes the previous lookup, has completed.
+  std::map<cudaStream_t, core23::Tensor> lookup_buffers_;
+
+  // The wgrad of the stored rows, and whether a row has one. Both are cleared after the update.
+  core23::Tensor row_wgrad_;
+  core23::Tensor row_flags_;
+  core23::Tensor rows_;
+  core23::Tensor num_rows_;
+  core23::Tensor row_table_ids_;
+  core23::Tensor row_ev_start_indices_;
+  core23::Tensor select_temp_storage_;
+
+  // Combines the stored rows of all rows of a local table on the host.
+  std::vector<float> combined_rows(size_t table_index) const;
+
+ public:
+  CompositionalEmbeddingTable(const HugeCTR::GPUResource &gpu_resource,
+                              std::shared_ptr<CoreResourceManager> core,
+                              const std::vector<EmbeddingTableParam> &table_params,
+                              const EmbeddingCollectionParam &ebc_param, size_t grouped_id,
+                              const HugeCTR::OptParams &opt_param);
+
+  void lookup(const core23::Tensor &keys, size_t num_keys, const core23::Tensor &id_space_offset,
+              size_t num_id_space_offset, const core23::Tensor &id_space,
+              core23::Tensor &embedding_vec) override;
+
+  void update(const core23::Tensor &unique_keys, const core23::Tensor &num_unique_keys,
+              const core23::Tensor &table_ids, const core23::Tensor &ev_start_indices,
+              const core23::Tensor &wgrad) override;
+
+  // The stored rows cannot be derived from the rows of the table, so it cannot be assigned or
+  // loaded.
+  void assign(const core23::Tensor &unique_key, size_t num_unique_key,
+              const core23::Tensor &num_unique_key_per_table_offset, size_t num_table_offset,
+              const core23::Tensor &table_id_list, core23::Tensor &embeding_vector,
+              const core23::Tensor &embedding_vector_offset) override;
+
+  void load(core23::Tensor &keys, core23::Tensor &id_space_offset, core23::Tensor &embedding_table,
+            core23::Tensor &ev_size_list, core23::Tensor &id_space) override;
+
+  // Dumps the combined rows, so that the table can be served like any other table.
+  void dump(core23::Tensor *keys, core23::Tensor *id_space_offset, core23::Tensor *embedding_table,
+            core23::Tensor *ev_size_list, core23::Tensor *id_space) override;
+
+  void dump_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
+                  int table_id) override;
+
+  void load_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
+                  int table_id) override;
+
+  // The size and capacity are the ones of the stored rows, and the keys the ones of the table.
+  size_t size() const override { return table_->size(); }
+
+  size_t capacity() const override { return table_->capacity(); }
+
+  size_t key_num() const override { return h_num_key_per_table_offset_.back(); }
+
+  std::vector<size_t> size_per_table() const override { return table_->size_per_table(); }
+
+  std::vector<size_t> capacity_per_table() const override { return table_->capacity_per_table(); }
+
+  std::vector<size_t> key_num_per_table() const override;
+
+  std::vector<int> table_ids() const override { return h_table_ids_; }
+
+  std::vector<int> table_evsize() const override { return table_->table_evsize(); }
+
+  void clear() override { table_->clear(); }
+
+  void set_learning_rate(float lr) override { table_->set_learning_rate(lr); }
+
+  void set_device_learning_rate(const float *lr_ptr) override {
+    table_->set_device_learning_rate(lr_ptr);
+  }
+};
+
+}  // namespace embedding
@@ -17,10 +17,12 @@
 #include <cuda_runtime_api.h>
 #include <curand_kernel.h>
 
+#include <algorithm>
 #include <cub/cub.cuh>
 #include <dynamic_embedding_table/dynamic_embedding_table.hpp>
 #include <embedding_storage/dynamic_embedding.hpp>
 #include <embedding_storage/optimizers.cuh>
+#include <limits>
 #include <utils.cuh>
 
 namespace embedding {
@@ -32,6 +34,36 @@ constexpr det::DynamicEmbeddingTable<KeyT, ValueT> *cast_table(void *t) noexcept
   return reinterpret_cast<det::DynamicEmbeddingTable<KeyT, ValueT> *>(t);
 }
 
+// The metadata of a key are the iteration of its last lookup and its lookup count, stored as
+// uint32_t in a float table.
+constexpr size_t kMetaDim = 2;
+
+__global__ void touch_meta_kernel(float **meta_ptrs, size_t num_keys, uint32_t iteration) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < num_keys;
+       i += blockDim.x * gridDim.x) {
+    uint32_t *meta = reinterpret_cast<uint32_t *>(meta_ptrs[i]);
+    meta[0] = iteration;
+    atomicAdd(&meta[1], 1u);
+  }
+}
+
+__global__ void eviction_score_kernel(const float *meta, size_t num_keys, int score_index,
+                                      uint32_t *scores) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < num_keys;
+       i += blockDim.x * gridDim.x) {
+    scores[i] = reinterpret_cast<const uint32_t *>(meta)[i * kMetaDim + score_index];
+  }
+}
+
+__global__ void count_less_kernel(const uint32_t *scores, size_t num_keys, uint32_t bound,
+                                  unsigned long long *count) {
+  size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  int block_count = __syncthreads_count(i < num_keys && scores[i] < bound);
+  if (threadIdx.x == 0 && block_count > 0) {
+    atomicAdd(count, static_cast<unsigned long long>(block_count));
+  }
+}
+
 }  // namespace
 
 DynamicEmbeddingTable::DynamicEmbeddingTable(const HugeCTR::GPUResource &gpu_resource,
@@ -67,16 +99,36 @@ DynamicEmbeddingTable::DynamicEmbeddingTable(const HugeCTR::GPUResource &gpu_res
         new det::DynamicEmbeddingTable<key_t, float>(dim_per_class.size(), dim_per_class.data());
     cast_table<key_t, float>(table_)->initialize(stream);
 
-    // Some optimizers contain state, which will be contained in `table_opt_states_`.
+    // Some optimizers contain state, which will be contained in `table_opt_states_`. FP16 states
+    // are packed into the float values of its rows.
     dim_per_class.clear();
     for (auto table_id : table_ids) {
       auto &emb_table_param = table_params[table_id];
-      dim_per_class.push_back(emb_table_param.ev_size * opt_param.num_parameters_per_weight());
+      dim_per_class.push_back(
+          HugeCTR::ceildiv(opt_param.state_bytes_per_row(emb_table_param.ev_size), sizeof(float)));
     }
+    opt_state_dim_per_class_ = dim_per_class;
     table_opt_states_ = new det::DynamicEmbeddingTable<key_t, float>(dim_per_class.size(),
                                                                      dim_per_class.data(), "zeros");
     cast_table<key_t, float>(table_opt_states_)->initialize(stream);
 
+    // Tables with an eviction policy track the lookups of their keys in `table_meta_`.
+    use_eviction_ = false;
+    for (auto table_id : table_ids) {
+      eviction_params_.push_back(table_params[table_id].eviction_param);
+      use_eviction_ |= eviction_params_.back().policy != EvictionPolicy::Disabled;
+    }
+    table_meta_ = nullptr;
+    if (use_eviction_) {
+      dim_per_class.assign(table_ids.size(), kMetaDim);
+      table_meta_ = new det::DynamicEmbeddingTable<key_t, float>(dim_per_class.size(),
+                                                                 dim_per_class.data(), "zeros");
+      cast_table<key_t, float>(table_meta_)->initialize(stream);
+    }
+    iteration_ = 1;
+    spilled_rows_.resize(table_ids.size());
+    eviction_stats_.resize(table_ids.size());
+
     // Allocate tensor lists to grab information as we run advanced optimzers.
     size_t max_total_hotness = 0;
     for (const LookupParam &lookup_params : ebc_param.lookup_params) {
@@ -88,6 +140,14 @@ DynamicEmbeddingTable::DynamicEmbeddingTable(const HugeCTR::GPUResource &gpu_res
 
     weight_view_ = std::make_unique<core23::Tensor>(core23::init_tensor_list<float>(
         ebc_param.universal_batch_size * max_total_hotness, core_->get_device_id()));
+
+    prefetch_view_ = std::make_unique<core23::Tensor>(core23::init_tensor_list<float>(
+        ebc_param.universal_batch_size * max_total_hotness, core_->get_device_id()));
+
+    if (use_eviction_) {
+      meta_view_ = std::make_unique<core23::Tensor>(core23::init_tensor_list<float>(
+          ebc_param.universal_batch_size * max_total_hotness, core_->get_device_id()));
+    }
   });
 
   // Await GPU.
@@ -131,6 +191,24 @@ void DynamicEmbeddingTable::lookup(const core23::Tensor &keys, size_t num_keys,
                                    const core23::Tensor &id_space_offset,
                                    size_t num_id_space_offset, const core23::Tensor &id_space_list,
                                    core23::Tensor &emb_vec) {
+  lookup_impl(keys, num_keys, id_space_offset, num_id_space_offset, id_space_list, emb_vec, true);
+}
+
+void DynamicEmbeddingTable::prefetch(const core23::Tensor &keys, size_t num_keys,
+                                     const core23::Tensor &id_space_offset,
+                                     size_t num_id_space_offset,
+                                     const core23::Tensor &id_space_list) {
+  HCTR_CHECK_HINT(num_keys <= static_cast<size_t>(prefetch_view_->num_elements()),
+                  "DynamicEmbeddingTable prefetch of more keys than a batch.");
+  lookup_impl(keys, num_keys, id_space_offset, num_id_space_offset, id_space_list,
+              *prefetch_view_, false);
+}
+
+void DynamicEmbeddingTable::lookup_impl(const core23::Tensor &keys, size_t num_keys,
+                                        const core23::Tensor &id_space_offset,
+                                        size_t num_id_space_offset,
+                                        const core23::Tensor &id_space_list,
+                                        core23::Tensor &emb_vec, bool touch_keys) {
   CudaDeviceContext ctx(core_->get_device_id());
   cudaStream_t stream = core_->get_local_gpu()->get_stream();
   HCTR_CHECK(keys.data_type() == key_type_);
@@ -148,14 +226,25 @@ void DynamicEmbeddingTable::lookup(const core23::Tensor &keys, size_t num_keys,
     }
   });
   if (num_keys > 0) {
+    if (use_eviction_) {
+      restore_spilled_keys(keys.data(), mapped_id_space_list.data(), id_space_offset_cpu.data(),
+                           num_id_space_offset - 1, stream);
+    }
     DISPATCH_INTEGRAL_FUNCTION_CORE23(keys.data_type().type(), key_t, [&] {
       auto table = cast_table<key_t, float>(table_);
 
+      // A prefetch on another stream may insert keys at the same time. The writers synchronize
+      // their stream before they release the lock, so the inserts are ordered with them.
+      const std::lock_guard lock(write_mutex_);
       table->lookup_unsafe(keys.data<key_t>(), (float **)emb_vec.data(), num_keys,
                            mapped_id_space_list.data(), id_space_offset_cpu.data(),
                            num_id_space_offset - 1, stream);
       HCTR_LIB_THROW(cudaStreamSynchronize(stream));
     });
+    if (use_eviction_ && touch_keys) {
+      touch(keys.data(), mapped_id_space_list.data(), id_space_offset_cpu.data(),
+            num_id_space_offset - 1, stream);
+    }
   }
 }
 
@@ -200,6 +289,7 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
     size_t num_table = mapped_unique_table_ids.size();
     // Request exclusive access to avoid update race.
     const std::lock_guard lock(write_mutex_);
+    const float lr = lr_ptr_ ? 1.f : opt_param_.lr;
 
     // FIXME: use another buffer
     DISPATCH_INTEGRAL_FUNCTION_CORE23(unique_keys.data_type().type(), key_t, [&] {
@@ -218,17 +308,14 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
                                  num_unique_keys_cpu, mapped_unique_table_ids.data(),
                                  table_range_cpu.data(), num_table, stream);
 
-            const float lambda2_plus_beta_div_lr = opt_param_.hyperparams.ftrl.lambda2 +
-                                                   opt_param_.hyperparams.ftrl.beta / opt_param_.lr;
-
             constexpr int block_size = 256;
             const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
 
             ftrl_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
-                opt_param_.hyperparams.ftrl.lambda1, lambda2_plus_beta_div_lr,
-                (float **)opt_state_view_->data(), (float **)weight_view_->data(),
-                opt_param_.scaler, wgrad_ptr);
+                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr, lr_ptr_,
+                opt_param_.hyperparams.ftrl.lambda1, opt_param_.hyperparams.ftrl.lambda2,
+                opt_param_.hyperparams.ftrl.beta, (float **)opt_state_view_->data(),
+                (float **)weight_view_->data(), opt_param_.scaler, wgrad_ptr);
           } break;
 
           case HugeCTR::Optimizer_t::Adam: {
@@ -238,13 +325,28 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
                 mapped_unique_table_ids.data(), table_range_cpu.data(), num_table, stream);
 
             ++opt_param_.hyperparams.adam.times;
-            const float lr_scaled_bias = opt_param_.lr * opt_param_.hyperparams.adam.bias();
+            const float lr_scaled_bias = lr * opt_param_.hyperparams.adam.bias();
 
             constexpr int block_size = 256;
             const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
 
-            adam_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr_scaled_bias,
+            if (opt_param_.is_lazy_adam()) {
+              auto kernel = opt_param_.hyperparams.adam.half_state
+                                ? lazy_adam_update_grad_kernel<wgrad_t, __half>
+                                : lazy_adam_update_grad_kernel<wgrad_t, float>;
+              kernel<<<grid_size, block_size, 0, stream>>>(
+                  ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr_scaled_bias, lr_ptr_,
+                  opt_param_.hyperparams.adam.beta1, opt_param_.hyperparams.adam.beta2,
+                  static_cast<int>(opt_param_.hyperparams.adam.times),
+                  (float **)opt_state_view_->data(), opt_param_.hyperparams.adam.epsilon,
+                  opt_param_.scaler, wgrad_ptr);
+              break;
+            }
+            auto kernel = opt_param_.hyperparams.adam.half_state
+                              ? adam_update_grad_kernel<wgrad_t, __half>
+                              : adam_update_grad_kernel<wgrad_t, float>;
+            kernel<<<grid_size, block_size, 0, stream>>>(
+                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr_scaled_bias, lr_ptr_,
                 opt_param_.hyperparams.adam.beta1, opt_param_.hyperparams.adam.beta2,
                 (float **)opt_state_view_->data(), opt_param_.hyperparams.adam.epsilon,
                 opt_param_.scaler, wgrad_ptr);
@@ -260,7 +362,7 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
             const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
 
             rms_prop_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr, lr_ptr_,
                 opt_param_.hyperparams.rmsprop.beta, (float **)opt_state_view_->data(),
                 opt_param_.hyperparams.rmsprop.epsilon, opt_param_.scaler, wgrad_ptr);
           } break;
@@ -274,8 +376,11 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
             constexpr int block_size = 256;
             const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
 
-            ada_grad_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+            auto kernel = opt_param_.hyperparams.adagrad.row_wise
+                              ? row_wise_ada_grad_update_grad_kernel<wgrad_t>
+                              : ada_grad_update_grad_kernel<wgrad_t>;
+            kernel<<<grid_size, block_size, 0, stream>>>(
+                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr, lr_ptr_,
                 (float **)opt_state_view_->data(), opt_param_.hyperparams.adagrad.epsilon,
                 opt_param_.scaler, wgrad_ptr);
           } break;
@@ -290,7 +395,7 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
             const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
 
             momentum_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr, lr_ptr_,
                 opt_param_.hyperparams.momentum.factor, (float **)opt_state_view_->data(),
                 opt_param_.scaler, wgrad_ptr);
           } break;
@@ -305,7 +410,7 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
             const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
 
             nesterov_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr, lr_ptr_,
                 opt_param_.hyperparams.nesterov.mu, (float **)opt_state_view_->data(),
                 opt_param_.scaler, wgrad_ptr);
           } break;
@@ -315,7 +420,7 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
             const int grid_size = (static_cast<int64_t>(num_unique_keys_cpu) - 1) / block_size + 1;
 
             sgd_update_grad_kernel<<<grid_size, block_size, 0, stream>>>(
-                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, opt_param_.lr,
+                ev_start_indices.data<uint32_t>(), num_unique_keys_cpu, lr, lr_ptr_,
                 opt_param_.scaler, wgrad_ptr);
           } break;
 
@@ -333,6 +438,15 @@ void DynamicEmbeddingTable::update(const core23::Tensor &unique_keys,
         HCTR_LIB_THROW(cudaStreamSynchronize(stream));
       });
     });
+
+    ++iteration_;
+    for (size_t i = 0; i < eviction_params_.size(); ++i) {
+      const EvictionParams &eviction_param = eviction_params_[i];
+      if (eviction_param.policy != EvictionPolicy::Disabled &&
+          iteration_ % eviction_param.check_interval == 0) {
+        evict_by_policy(i, stream);
+      }
+    }
   }
 }
 
@@ -372,6 +486,10 @@ void DynamicEmbeddingTable::assign(const core23::Tensor &keys, size_t num_keys,
                             num_table_offset - 1, stream);
       HCTR_LIB_THROW(cudaStreamSynchronize(stream));
     });
+    if (use_eviction_) {
+      touch(keys.data(), mapped_id_space_list.data(), id_space_offset_cpu.data(),
+            num_table_offset - 1, stream);
+    }
   }
 }
 
@@ -429,6 +547,58 @@ void DynamicEmbeddingTable::dump_by_id(core23::Tensor *h_keys_tensor,
   });
 }
 
+size_t DynamicEmbeddingTable::dump_pruned_by_id(core23::Tensor *h_keys_tensor,
+                                                core23::Tensor *h_embedding_table, int table_id,
+                                                uint32_t min_lookup_count,
+                                                uint32_t max_idle_iterations) {
+  dump_by_id(h_keys_tensor, h_embedding_table, table_id);
+  const size_t table_index =
+      find(h_table_ids_.begin(), h_table_ids_.end(), table_id) - h_table_ids_.begin();
+  const size_t num_keys = key_num_per_table()[table_index];
+  if (eviction_params_[table_index].policy == EvictionPolicy::Disabled ||
+      (min_lookup_count == 0 && max_idle_iterations == 0)) {
+    return num_keys;
+  }
+
+  CudaDeviceContext ctx(core_->get_device_id());
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+  size_t num_dumped = 0;
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(h_keys_tensor->data_type().type(), key_t, [&] {
+    key_t *h_keys = h_keys_tensor->data<key_t>();
+    float *h_values = h_embedding_table->data<float>();
+    std::vector<uint32_t> h_meta(num_keys * kMetaDim);
+    key_t *d_keys;
+    float *d_meta;
+    HCTR_LIB_THROW(cudaMalloc(&d_keys, sizeof(key_t) * num_keys));
+    HCTR_LIB_THROW(cudaMalloc(&d_meta, sizeof(float) * num_keys * kMetaDim));
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_keys, h_keys, sizeof(key_t) * num_keys,
+                                   cudaMemcpyHostToDevice, stream));
+    cast_table<key_t, float>(table_meta_)
+        ->lookup_by_index(table_index, d_keys, d_meta, num_keys, stream);
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_meta.data(), d_meta, sizeof(float) * num_keys * kMetaDim,
+                                   cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    HCTR_LIB_THROW(cudaFree(d_keys));
+    HCTR_LIB_THROW(cudaFree(d_meta));
+
+    // Moves the kept rows to the front.
+    const size_t ev_size = dim_per_class_[table_index];
+    for (size_t i = 0; i < num_keys; ++i) {
+      const uint32_t last_lookup = h_meta[i * kMetaDim];
+      const uint32_t num_lookups = h_meta[i * kMetaDim + 1];
+      if (num_lookups < min_lookup_count ||
+          (max_idle_iterations > 0 && iteration_ - last_lookup > max_idle_iterations)) {
+        continue;
+      }
+      h_keys[num_dumped] = h_keys[i];
+      std::copy(h_values + i * ev_size, h_values + (i + 1) * ev_size,
+                h_values + num_dumped * ev_size);
+      ++num_dumped;
+    }
+  });
+  return num_dumped;
+}
+
 void DynamicEmbeddingTable::load_by_id(core23::Tensor *h_keys_tensor,
                                        core23::Tensor *h_embedding_table, int table_id) {
   CudaDeviceContext ctx(core_->get_device_id());
@@ -466,6 +636,11 @@ void DynamicEmbeddingTable::load_by_id(core23::Tensor *h_keys_tensor,
                                    cudaMemcpyHostToDevice, stream));
 
     table->scatter_update_by_index(table_index, d_keys, d_values, key_num, stream);
+    if (use_eviction_) {
+      const size_t id_space = table_index;
+      const size_t id_space_offsets[2] = {0, key_num};
+      touch(d_keys, &id_space, id_space_offsets, 1, stream);
+    }
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
     HCTR_LIB_THROW(cudaFree(d_keys));
     HCTR_LIB_THROW(cudaFree(d_values));
@@ -551,8 +726,15 @@ void DynamicEmbeddingTable::clear() {
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
     auto table = cast_table<key_t, float>(table_);
     table->clear(stream);
+    if (use_eviction_) {
+      cast_table<key_t, float>(table_meta_)->clear(stream);
+    }
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
   });
+  for (size_t i = 0; i < spilled_rows_.size(); ++i) {
+    spilled_rows_[i].clear();
+    eviction_stats_[i].num_spilled = 0;
+  }
 }
 
 void DynamicEmbeddingTable::evict(const core23::Tensor &keys, size_t num_keys,
@@ -581,8 +763,252 @@ void DynamicEmbeddingTable::evict(const core23::Tensor &keys, size_t num_keys,
     auto table = cast_table<key_t, float>(table_);
     table->remove(keys.data<key_t>(), num_keys, mapped_id_space_list.data(),
                   id_space_offset_cpu.data(), num_id_space_offset, stream);
+    if (use_eviction_) {
+      cast_table<key_t, float>(table_meta_)
+          ->remove(keys.data<key_t>(), num_keys, mapped_id_space_list.data(),
+                   id_space_offset_cpu.data(), num_id_space_offset, stream);
+    }
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
   });
 }
 
+void DynamicEmbeddingTable::touch(const void *keys, const size_t *id_spaces,
+                                  const size_t *id_space_offsets, size_t num_id_spaces,
+                                  cudaStream_t stream) {
+  const size_t max_num_keys = meta_view_->num_elements();
+  float **meta_ptrs = (float **)meta_view_->data();
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
+    auto table_meta = cast_table<key_t, float>(table_meta_);
+    for (size_t i = 0; i < num_id_spaces; ++i) {
+      const size_t id_space = id_spaces[i];
+      if (eviction_params_[id_space].policy == EvictionPolicy::Disabled) continue;
+
+      // Loaded tables can be larger than a batch, so keys are touched in chunks.
+      for (size_t offset = id_space_offsets[i]; offset < id_space_offsets[i + 1];
+           offset += max_num_keys) {
+        const size_t num_keys = std::min(max_num_keys, id_space_offsets[i + 1] - offset);
+        const size_t chunk_offsets[2] = {0, num_keys};
+        table_meta->lookup_unsafe(reinterpret_cast<const key_t *>(keys) + offset, meta_ptrs,
+                                  num_keys, &id_space, chunk_offsets, 1, stream);
+
+        constexpr int block_size = 256;
+        const int grid_size = (static_cast<int64_t>(num_keys) - 1) / block_size + 1;
+        touch_meta_kernel<<<grid_size, block_size, 0, stream>>>(meta_ptrs, num_keys, iteration_);
+        HCTR_LIB_THROW(cudaGetLastError());
+      }
+    }
+  });
+}
+
+void DynamicEmbeddingTable::restore_spilled_keys(const void *keys, const size_t *id_spaces,
+                                                 const size_t *id_space_offsets,
+                                                 size_t num_id_spaces, cudaStream_t stream) {
+  bool has_spilled_rows = false;
+  for (size_t i = 0; i < num_id_spaces; ++i) {
+    has_spilled_rows |= !spilled_rows_[id_spaces[i]].empty();
+  }
+  if (!has_spilled_rows) return;
+
+  const std::lock_guard lock(write_mutex_);
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
+    const size_t num_keys = id_space_offsets[num_id_spaces];
+    std::vector<key_t> h_keys(num_keys);
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_keys.data(), keys, sizeof(key_t) * num_keys,
+                                   cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+    auto table = cast_table<key_t, float>(table_);
+    auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
+    for (size_t i = 0; i < num_id_spaces; ++i) {
+      const size_t id_space = id_spaces[i];
+      auto &spilled_rows = spilled_rows_[id_space];
+      if (spilled_rows.empty()) continue;
+
+      const size_t ev_size = dim_per_class_[id_space];
+      const size_t opt_state_size = opt_state_dim_per_class_[id_space];
+      std::vector<key_t> restored_keys;
+      std::vector<float> restored_values;
+      std::vector<float> restored_opt_states;
+      for (size_t k = id_space_offsets[i]; k < id_space_offsets[i + 1]; ++k) {
+        auto it = spilled_rows.find(static_cast<int64_t>(h_keys[k]));
+        if (it == spilled_rows.end()) continue;
+        restored_keys.push_back(h_keys[k]);
+        restored_values.insert(restored_values.end(), it->second.begin(),
+                               it->second.begin() + ev_size);
+        restored_opt_states.insert(restored_opt_states.end(), it->second.begin() + ev_size,
+                                   it->second.end());
+        spilled_rows.erase(it);
+      }
+      const size_t num_restored = restored_keys.size();
+      if (num_restored == 0) continue;
+
+      key_t *d_keys;
+      float *d_values;
+      HCTR_LIB_THROW(cudaMalloc(&d_keys, sizeof(key_t) * num_restored));
+      HCTR_LIB_THROW(cudaMalloc(&d_values, sizeof(float) * num_restored *
+                                               std::max(ev_size, opt_state_size)));
+      HCTR_LIB_THROW(cudaMemcpyAsync(d_keys, restored_keys.data(), sizeof(key_t) * num_restored,
+                                     cudaMemcpyHostToDevice, stream));
+      HCTR_LIB_THROW(cudaMemcpyAsync(d_values, restored_values.data(),
+                                     sizeof(float) * restored_values.size(),
+                                     cudaMemcpyHostToDevice, stream));
+      table->scatter_update_by_index(id_space, d_keys, d_values, num_restored, stream);
+      if (opt_state_size > 0) {
+        HCTR_LIB_THROW(cudaMemcpyAsync(d_values, restored_opt_states.data(),
+                                       sizeof(float) * restored_opt_states.size(),
+                                       cudaMemcpyHostToDevice, stream));
+        table_opt_states->scatter_update_by_index(id_space, d_keys, d_values, num_restored,
+                                                  stream);
+      }
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+      HCTR_LIB_THROW(cudaFree(d_keys));
+      HCTR_LIB_THROW(cudaFree(d_values));
+
+      eviction_stats_[id_space].num_restored += num_restored;
+      eviction_stats_[id_space].num_spilled = spilled_rows.size();
+    }
+  });
+}
+
+void DynamicEmbeddingTable::evict_by_policy(size_t local_id_space, cudaStream_t stream) {
+  const EvictionParams &eviction_param = eviction_params_[local_id_space];
+  const size_t max_num_keys = eviction_param.max_num_keys > 0
+                                  ? static_cast<size_t>(eviction_param.max_num_keys)
+                                  : std::numeric_limits<size_t>::max();
+  const bool use_ttl = eviction_param.policy == EvictionPolicy::TTL &&
+                       iteration_ > static_cast<uint64_t>(eviction_param.ttl);
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type_.type(), key_t, [&] {
+    auto table = cast_table<key_t, float>(table_);
+    auto table_opt_states = cast_table<key_t, float>(table_opt_states_);
+    auto table_meta = cast_table<key_t, float>(table_meta_);
+
+    const size_t num_keys = table_meta->size_per_class()[local_id_space] / kMetaDim;
+    if (num_keys == 0 || (num_keys <= max_num_keys && !use_ttl)) return;
+
+    // Sort the keys by their last lookup, or by their lookup count.
+    key_t *d_keys, *d_sorted_keys;
+    float *d_meta;
+    uint32_t *d_scores, *d_sorted_scores;
+    unsigned long long *d_num_expired;
+    HCTR_LIB_THROW(cudaMalloc(&d_keys, sizeof(key_t) * num_keys));
+    HCTR_LIB_THROW(cudaMalloc(&d_sorted_keys, sizeof(key_t) * num_keys));
+    HCTR_LIB_THROW(cudaMalloc(&d_meta, sizeof(float) * num_keys * kMetaDim));
+    HCTR_LIB_THROW(cudaMalloc(&d_scores, sizeof(uint32_t) * num_keys));
+    HCTR_LIB_THROW(cudaMalloc(&d_sorted_scores, sizeof(uint32_t) * num_keys));
+    HCTR_LIB_THROW(cudaMalloc(&d_num_expired, sizeof(unsigned long long)));
+
+    table_meta->eXport(local_id_space, d_keys, d_meta, num_keys, stream);
+    constexpr int block_size = 256;
+    const int grid_size = (static_cast<int64_t>(num_keys) - 1) / block_size + 1;
+    const int score_index = eviction_param.policy == EvictionPolicy::LFU ? 1 : 0;
+    eviction_score_kernel<<<grid_size, block_size, 0, stream>>>(d_meta, num_keys, score_index,
+                                                                d_scores);
+    HCTR_LIB_THROW(cudaGetLastError());
+
+    size_t temp_storage_bytes = 0;
+    HCTR_LIB_THROW(cub::DeviceRadixSort::SortPairs(nullptr, temp_storage_bytes, d_scores,
+                                                   d_sorted_scores, d_keys, d_sorted_keys,
+                                                   num_keys, 0, sizeof(uint32_t) * 8, stream));
+    void *d_temp_storage;
+    HCTR_LIB_THROW(cudaMalloc(&d_temp_storage, temp_storage_bytes));
+    HCTR_LIB_THROW(cub::DeviceRadixSort::SortPairs(d_temp_storage, temp_storage_bytes, d_scores,
+                                                   d_sorted_scores, d_keys, d_sorted_keys,
+                                                   num_keys, 0, sizeof(uint32_t) * 8, stream));
+
+    size_t num_evict = num_keys > max_num_keys
+                           ? num_keys - static_cast<size_t>(eviction_param.evict_to_ratio *
+                                                            static_cast<double>(max_num_keys))
+                           : 0;
+    unsigned long long num_expired = 0;
+    if (use_ttl) {
+      HCTR_LIB_THROW(cudaMemsetAsync(d_num_expired, 0, sizeof(unsigned long long), stream));
+      const uint32_t bound = iteration_ - static_cast<uint32_t>(eviction_param.ttl);
+      count_less_kernel<<<grid_size, block_size, 0, stream>>>(d_sorted_scores, num_keys, bound,
+                                                              d_num_expired);
+      HCTR_LIB_THROW(cudaGetLastError());
+      HCTR_LIB_THROW(cudaMemcpyAsync(&num_expired, d_num_expired, sizeof(unsigned long long),
+                                     cudaMemcpyDeviceToHost, stream));
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+      num_evict = std::max(num_evict, static_cast<size_t>(num_expired));
+    }
+
+    if (num_evict > 0) {
+      EvictionStats &stats = eviction_stats_[local_id_space];
+      if (eviction_param.spill_to_host) {
+        const size_t ev_size = dim_per_class_[local_id_space];
+        const size_t opt_state_size = opt_state_dim_per_class_[local_id_space];
+        float *d_values;
+        HCTR_LIB_THROW(
+            cudaMalloc(&d_values, sizeof(float) * num_evict * (ev_size + opt_state_size)));
+        table->lookup_by_index(local_id_space, d_sorted_keys, d_values, num_evict, stream);
+        if (opt_state_size > 0) {
+          table_opt_states->lookup_by_index(local_id_space, d_sorted_keys,
+                                            d_values + num_evict * ev_size, num_evict, stream);
+        }
+        std::vector<key_t> h_keys(num_evict);
+        std::vector<float> h_values(num_evict * (ev_size + opt_state_size));
+        HCTR_LIB_THROW(cudaMemcpyAsync(h_keys.data(), d_sorted_keys, sizeof(key_t) * num_evict,
+                                       cudaMemcpyDeviceToHost, stream));
+        HCTR_LIB_THROW(cudaMemcpyAsync(h_values.data(), d_values, sizeof(float) * h_values.size(),
+                                       cudaMemcpyDeviceToHost, stream));
+        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+        HCTR_LIB_THROW(cudaFree(d_values));
+
+        auto &spilled_rows = spilled_rows_[local_id_space];
+        const float *h_opt_states = h_values.data() + num_evict * ev_size;
+        for (size_t i = 0; i < num_evict; ++i) {
+          std::vector<float> &row = spilled_rows[static_cast<int64_t>(h_keys[i])];
+          row.assign(h_values.begin() + i * ev_size, h_values.begin() + (i + 1) * ev_size);
+          row.insert(row.end(), h_opt_states + i * opt_state_size,
+                     h_opt_states + (i + 1) * opt_state_size);
+        }
+        stats.num_spilled = spilled_rows.size();
+      }
+
+      const size_t id_space_offsets[2] = {0, num_evict};
+      table->remove(d_sorted_keys, num_evict, &local_id_space, id_space_offsets, 1, stream);
+      table_opt_states->remove(d_sorted_keys, num_evict, &local_id_space, id_space_offsets, 1,
+                               stream);
+      table_meta->remove(d_sorted_keys, num_evict, &local_id_space, id_space_offsets, 1, stream);
+
+      ++stats.num_eviction_runs;
+      stats.num_evicted += num_evict;
+      stats.num_expired += num_expired;
+      HCTR_LOG(INFO, WORLD,
+               "Dynamic embedding table %d evicted %zu keys (%llu expired), %zu keys left, %zu "
+               "keys spilled to host.\n",
+               h_table_ids_[local_id_space], num_evict, num_expired, num_keys - num_evict,
+               stats.num_spilled);
+    }
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    HCTR_LIB_THROW(cudaFree(d_keys));
+    HCTR_LIB_THROW(cudaFree(d_sorted_keys));
+    HCTR_LIB_THROW(cudaFree(d_meta));
+    HCTR_LIB_THROW(cudaFree(d_scores));
+    HCTR_LIB_THROW(cudaFree(d_sorted_scores));
+    HCTR_LIB_THROW(cudaFree(d_num_expired));
+    HCTR_LIB_THROW(cudaFree(d_temp_storage));
+  });
+}
+
+void DynamicEmbeddingTable::evict_by_policy() {
+  if (!use_eviction_) return;
+  CudaDeviceContext ctx(core_->get_device_id());
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+
+  const std::lock_guard lock(write_mutex_);
+  for (size_t i = 0; i < eviction_params_.size(); ++i) {
+    if (eviction_params_[i].policy != EvictionPolicy::Disabled) {
+      evict_by_policy(i, stream);
+    }
+  }
+}
+
+std::vector<EvictionStats> DynamicEmbeddingTable::eviction_stats_per_table() const {
+  const std::lock_guard lock(write_mutex_);
+  return eviction_stats_;
+}
+
 }  // namespace embedding
@@ -18,11 +18,20 @@
 #include <embedding_storage/embedding_table.hpp>
 #include <map>
 #include <mutex>
+#include <unordered_map>
 
 namespace embedding {
 
 using HugeCTR::CudaDeviceContext;
 
+struct EvictionStats {
+  size_t num_eviction_runs = 0;  // Evictions which removed at least one key
+  size_t num_evicted = 0;        // Keys evicted since the construction of the table
+  size_t num_expired = 0;        // Keys evicted because of their TTL
+  size_t num_spilled = 0;        // Evicted keys currently held in host memory
+  size_t num_restored = 0;       // Spilled keys which were looked up again
+};
+
 class DynamicEmbeddingTable final : public IDynamicEmbeddingTable {
   std::shared_ptr<CoreResourceManager> core_;
   core23::DataType key_type_;
@@ -35,10 +44,41 @@ class DynamicEmbeddingTable final : public IDynamicEmbeddingTable {
   std::vector<int> h_table_ids_;
 
   HugeCTR::OptParams opt_param_;
+  // Learning rate on the gpu, which replaces opt_param_.lr if it is set.
+  const float *lr_ptr_ = nullptr;
   void *table_opt_states_;
+  std::vector<size_t> opt_state_dim_per_class_;
 
   std::unique_ptr<core23::Tensor> opt_state_view_;
   std::unique_ptr<core23::Tensor> weight_view_;
+  // Row pointers of the keys inserted by prefetch, which are discarded.
+  std::unique_ptr<core23::Tensor> prefetch_view_;
+
+  // Eviction state of each local id space. The metadata of a key is the iteration of its last
+  // lookup and its lookup count.
+  std::vector<EvictionParams> eviction_params_;
+  bool use_eviction_;
+  void *table_meta_;
+  std::unique_ptr<core23::Tensor> meta_view_;
+  uint32_t iteration_;
+  // Weights followed by the optimizer states of each spilled key.
+  std::vector<std::unordered_map<int64_t, std::vector<float>>> spilled_rows_;
+  std::vector<EvictionStats> eviction_stats_;
+
+  void touch(const void *keys, const size_t *id_spaces, const size_t *id_space_offsets,
+             size_t num_id_spaces, cudaStream_t stream);
+
+  void restore_spilled_keys(const void *keys, const size_t *id_spaces,
+                            const size_t *id_space_offsets, size_t num_id_spaces,
+                            cudaStream_t stream);
+
+  void evict_by_policy(size_t local_id_space, cudaStream_t stream);
+
+  // Points emb_vec to the rows of keys, and inserts the missing keys. Only touch_keys counts it as
+  // a lookup for the eviction policy.
+  void lookup_impl(const core23::Tensor &keys, size_t num_keys,
+                   const core23::Tensor &id_space_offset, size_t num_id_space_offset,
+                   const core23::Tensor &id_space_list, core23::Tensor &emb_vec, bool touch_keys);
 
  public:
   DynamicEmbeddingTable(const HugeCTR::GPUResource &gpu_resource,
@@ -55,6 +95,11 @@ class DynamicEmbeddingTable final : public IDynamicEmbeddingTable {
               size_t num_id_space_offset, const core23::Tensor &id_space,
               core23::Tensor &embedding_vec) override;
 
+  // Restores the spilled keys and inserts the new keys of a following lookup, so that it only
+  // finds rows.
+  void prefetch(const core23::Tensor &keys, size_t num_keys, const core23::Tensor &id_space_offset,
+                size_t num_id_space_offset, const core23::Tensor &id_space_list) override;
+
   void update(const core23::Tensor &unique_keys, const core23::Tensor &num_unique_keys,
               const core23::Tensor &table_ids, const core23::Tensor &ev_start_indices,
               const core23::Tensor &wgrad) override;
@@ -73,6 +118,11 @@ class DynamicEmbeddingTable final : public IDynamicEmbeddingTable {
   void dump_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
                   int table_id) override;
 
+  // Prunes by the lookup metadata of the tables with an eviction policy.
+  size_t dump_pruned_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
+                           int table_id, uint32_t min_lookup_count,
+                           uint32_t max_idle_iterations) override;
+
   void load_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
                   int table_id) override;
 
@@ -98,6 +148,13 @@ class DynamicEmbeddingTable final : public IDynamicEmbeddingTable {
              size_t num_id_space_offset, const core23::Tensor &id_space_list) override;
 
   void set_learning_rate(float lr) override { opt_param_.lr = lr; }
+
+  void set_device_learning_rate(const float *lr_ptr) override { lr_ptr_ = lr_ptr; }
+
+  // Applies the eviction policy of each table now, regardless of its check_interval.
+  void evict_by_policy();
+
+  std::vector<EvictionStats> eviction_stats_per_table() const;
 };
 
 }  // namespace embedding
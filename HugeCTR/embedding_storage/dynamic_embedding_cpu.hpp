@@ -118,8 +118,13 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
 
       const size_t ev_size = table_params.at(table_id).ev_size;
       weights_.emplace_back(std::make_unique<WeightIDSpace>(ev_size));
-      opt_states_.emplace_back(
-          std::make_unique<OptStateIDSpace>(ev_size * opt_param.num_parameters_per_weight()));
+      // The CPU reference keeps all states in FP32, including the step counter of lazy Adam.
+      const size_t state_dim{opt_param.optimizer == HugeCTR::Optimizer_t::AdaGrad &&
+                                     opt_param.hyperparams.adagrad.row_wise
+                                 ? 1
+                                 : ev_size * opt_param.num_parameters_per_weight() +
+                                       (opt_param.is_lazy_adam() ? 1 : 0)};
+      opt_states_.emplace_back(std::make_unique<OptStateIDSpace>(state_dim));
     }
   }
 
@@ -285,9 +290,17 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
           const float beta1 = opt_param_.hyperparams.adam.beta1;
           const float beta2 = opt_param_.hyperparams.adam.beta2;
           const float epsilon = opt_param_.hyperparams.adam.epsilon;
-          for (uint32_t i = 0; i < k.size(); ++i) {
-            adam_update_grad(i, g_off.data(), lr_scaled_bias, beta1, beta2, s.data(), epsilon,
-                             scaler, g.data());
+          if (opt_param_.is_lazy_adam()) {
+            const int step = static_cast<int>(opt_param_.hyperparams.adam.times);
+            for (uint32_t i = 0; i < k.size(); ++i) {
+              lazy_adam_update_grad(i, g_off.data(), lr_scaled_bias, beta1, beta2, step, s.data(),
+                                    epsilon, scaler, g.data());
+            }
+          } else {
+            for (uint32_t i = 0; i < k.size(); ++i) {
+              adam_update_grad(i, g_off.data(), lr_scaled_bias, beta1, beta2, s.data(), epsilon,
+                               scaler, g.data());
+            }
           }
         } break;
 
@@ -305,8 +318,15 @@ class DynamicEmbeddingTableCPU final : public IDynamicEmbeddingTable {
           std::vector<float*> s = gather_opt_states(k, is_off, is);
 
           const float epsilon = opt_param_.hyperparams.adagrad.epsilon;
-          for (uint32_t i = 0; i < k.size(); ++i) {
-            ada_grad_update_grad(i, g_off.data(), lr, s.data(), epsilon, scaler, g.data());
+          if (opt_param_.hyperparams.adagrad.row_wise) {
+            for (uint32_t i = 0; i < k.size(); ++i) {
+              row_wise_ada_grad_update_grad(i, g_off.data(), lr, s.data(), epsilon, scaler,
+                                            g.data());
+            }
+          } else {
+            for (uint32_t i = 0; i < k.size(); ++i) {
+              ada_grad_update_grad(i, g_off.data(), lr, s.data(), epsilon, scaler, g.data());
+            }
           }
         } break;
 
@@ -14,8 +14,11 @@
  * limitations under the License.
  */
 
+#include <cmath>
+#include <embedding_storage/compositional_embedding.hpp>
 #include <embedding_storage/dynamic_embedding.hpp>
 #include <embedding_storage/embedding_table.hpp>
+#include <embedding_storage/host_cached_embedding.hpp>
 #include <embedding_storage/ragged_static_embedding.hpp>
 
 namespace embedding {
@@ -34,6 +37,29 @@ std::vector<std::unique_ptr<IGroupedEmbeddingTable>> create_grouped_embedding_ta
     return false;
   };
 
+  auto is_host_cached_embedding_table = [&](const std::vector<int> &table_ids) {
+    size_t num_host_cached_tables = 0;
+    for (int table_id : table_ids) {
+      if (emb_table_param_list[table_id].num_gpu_cached_rows > 0) {
+        ++num_host_cached_tables;
+      }
+    }
+    HCTR_CHECK_HINT(num_host_cached_tables == 0 || num_host_cached_tables == table_ids.size(),
+                    "grouped embedding table does not support grouping embedding tables in host "
+                    "memory with embedding tables on the gpus.");
+    return num_host_cached_tables > 0;
+  };
+
+  auto is_compositional_embedding_table = [&](const std::vector<int> &table_ids) {
+    for (int table_id : table_ids) {
+      if (emb_table_param_list[table_id].compositional_param.combiner !=
+          CompositionalCombiner::Disabled) {
+        return true;
+      }
+    }
+    return false;
+  };
+
   auto get_opt_params = [&](const std::vector<int> &table_ids) {
     int first_table_id = table_ids[0];
     for (int table_id : table_ids) {
@@ -60,10 +86,25 @@ std::vector<std::unique_ptr<IGroupedEmbeddingTable>> create_grouped_embedding_ta
     HugeCTR::OptParams opt_params = get_opt_params(table_ids);
 
     if (is_dynamic_embedding_table(table_ids)) {
+      HCTR_CHECK_HINT(ebc_param.grouped_table_params[grouped_table_id].column_shard_id < 0,
+                      "dynamic embedding tables do not support column-wise sharding.");
+      HCTR_CHECK_HINT(ebc_param.table_storage_type_ == TableStorageType::FP32,
+                      "dynamic embedding tables only support FP32 weights.");
       // ebc_param.is_dynamic = true;
       embedding_table_list.push_back(std::make_unique<DynamicEmbeddingTable>(
           *resource_manager->get_local_gpu(local_gpu_id), core, emb_table_param_list, ebc_param,
           grouped_table_id, opt_params));
+    } else if (is_host_cached_embedding_table(table_ids)) {
+      HCTR_CHECK_HINT(ebc_param.grouped_table_params[grouped_table_id].table_placement_strategy ==
+                          TablePlacementStrategy::ModelParallel,
+                      "embedding tables in host memory only support model parallel placement.");
+      embedding_table_list.push_back(std::make_unique<HostCachedEmbeddingTable>(
+          *resource_manager->get_local_gpu(local_gpu_id), core, emb_table_param_list, ebc_param,
+          grouped_table_id, opt_params));
+    } else if (is_compositional_embedding_table(table_ids)) {
+      embedding_table_list.push_back(std::make_unique<CompositionalEmbeddingTable>(
+          *resource_manager->get_local_gpu(local_gpu_id), core, emb_table_param_list, ebc_param,
+          grouped_table_id, opt_params));
     } else {
       embedding_table_list.push_back(std::make_unique<RaggedStaticEmbeddingTable>(
           *resource_manager->get_local_gpu(local_gpu_id), core, emb_table_param_list, ebc_param,
@@ -73,4 +114,41 @@ std::vector<std::unique_ptr<IGroupedEmbeddingTable>> create_grouped_embedding_ta
   return embedding_table_list;
 }
 
+std::unique_ptr<RaggedStaticEmbeddingTable> create_frequent_embedding_table(
+    std::shared_ptr<HugeCTR::ResourceManager> resource_manager,
+    std::shared_ptr<CoreResourceManager> core, const EmbeddingCollectionParam &ebc_param,
+    const std::vector<EmbeddingTableParam> &emb_table_param_list) {
+  const auto &freq_keys_data = ebc_param.sparse_freq_keys_data;
+  HCTR_CHECK_HINT(!freq_keys_data.table_ids.empty(), "no frequent keys.");
+  int local_gpu_id = core->get_local_gpu_id();
+
+  std::vector<EmbeddingTableParam> frequent_table_params = emb_table_param_list;
+  const HugeCTR::OptParams &opt_params =
+      emb_table_param_list[freq_keys_data.table_ids[0]].opt_param;
+  for (size_t i = 0; i < freq_keys_data.table_ids.size(); ++i) {
+    auto &table_param = frequent_table_params[freq_keys_data.table_ids[i]];
+    HCTR_CHECK_HINT(table_param.max_vocabulary_size > 0,
+                    "frequent keys require a table with max_vocabulary_size, table ",
+                    table_param.table_id);
+    HCTR_CHECK_HINT(table_param.opt_param == opt_params,
+                    "frequent keys require the same optimizer for all their tables.");
+    HCTR_CHECK_HINT(table_param.init_param.initializer_type != HugeCTR::Initializer_t::Sinusoidal,
+                    "frequent keys do not support the sinusoidal initializer, table ",
+                    table_param.table_id);
+    // Keep the distribution of the initial weights of the whole table.
+    if (table_param.init_param.initializer_type == HugeCTR::Initializer_t::Default) {
+      table_param.init_param = InitParams(table_param.ev_size, HugeCTR::Initializer_t::Uniform,
+                                          sqrt(1.f / table_param.max_vocabulary_size));
+    }
+    table_param.max_vocabulary_size = static_cast<int>(freq_keys_data.h_frequent_keys[i].size());
+  }
+
+  EmbeddingCollectionParam frequent_ebc_param = ebc_param;
+  frequent_ebc_param.grouped_table_params.emplace_back(TablePlacementStrategy::DataParallel,
+                                                       freq_keys_data.table_ids);
+  return std::make_unique<RaggedStaticEmbeddingTable>(
+      *resource_manager->get_local_gpu(local_gpu_id), core, frequent_table_params,
+      frequent_ebc_param, frequent_ebc_param.grouped_table_params.size() - 1, opt_params);
+}
+
 }  // namespace embedding
@@ -21,6 +21,9 @@
 
 namespace embedding {
 
+struct UnreducedWgrad;
+class RaggedStaticEmbeddingTable;
+
 // per gpu object
 class IGroupedEmbeddingTable : public ILookup {
  public:
@@ -30,6 +33,15 @@ class IGroupedEmbeddingTable : public ILookup {
                       const core23::Tensor &table_ids, const core23::Tensor &ev_start_indices,
                       const core23::Tensor &wgrad) = 0;
 
+  // Whether the table can reduce the wgrad of a model parallel embedding in its update kernel.
+  virtual bool support_fused_update() const { return false; }
+
+  // Reduces the unreduced wgrad into the unique keys of wgrad and applies the optimizer in the same
+  // pass, so that most of the reduced gradients never leave the registers.
+  virtual void fused_update(const UnreducedWgrad &unreduced_wgrad, Wgrad &wgrad) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "fused_update is not supported by this table");
+  }
+
   virtual void assign(const core23::Tensor &unique_key, size_t num_unique_key,
                       const core23::Tensor &num_unique_key_per_table_offset,
                       size_t num_table_offset, const core23::Tensor &table_id_list,
@@ -47,6 +59,17 @@ class IGroupedEmbeddingTable : public ILookup {
   virtual void dump_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
                           int table_id) = 0;
 
+  // Dumps the rows of table_id like dump_by_id, without the rows looked up fewer than
+  // min_lookup_count times, or not within the last max_idle_iterations iterations if it is
+  // positive. The dumped rows come first, and their number is returned. Tables which do not count
+  // the lookups of their rows dump all of them.
+  virtual size_t dump_pruned_by_id(core23::Tensor *h_keys_tensor,
+                                   core23::Tensor *h_embedding_table, int table_id,
+                                   uint32_t min_lookup_count, uint32_t max_idle_iterations) {
+    dump_by_id(h_keys_tensor, h_embedding_table, table_id);
+    return h_keys_tensor->num_elements();
+  }
+
   virtual void load_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
                           int table_id) = 0;
 
@@ -69,6 +92,13 @@ class IGroupedEmbeddingTable : public ILookup {
   virtual void clear() = 0;
 
   virtual void set_learning_rate(float lr) = 0;
+
+  // Makes the updates read the learning rate from lr_ptr on the gpu of the table, e.g. the one of
+  // a GpuLearningRateScheduler, instead of the one of set_learning_rate(). nullptr undoes it.
+  virtual void set_device_learning_rate(const float *lr_ptr) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall,
+                   "set_device_learning_rate is not supported by this table");
+  }
 };
 
 class IDynamicEmbeddingTable : public IGroupedEmbeddingTable {
@@ -83,4 +113,12 @@ std::vector<std::unique_ptr<IGroupedEmbeddingTable>> create_grouped_embedding_ta
     const EmbeddingCollectionParam &embedding_collection_param,
     const std::vector<EmbeddingTableParam> &emb_table_param_list);
 
+// Creates the replicated rows of the frequent keys of model parallel tables. Row i of a table
+// holds its i-th smallest frequent key.
+std::unique_ptr<RaggedStaticEmbeddingTable> create_frequent_embedding_table(
+    std::shared_ptr<HugeCTR::ResourceManager> resource_manager,
+    std::shared_ptr<CoreResourceManager> core,
+    const EmbeddingCollectionParam &embedding_collection_param,
+    const std::vector<EmbeddingTableParam> &emb_table_param_list);
+
 }  // namespace embedding
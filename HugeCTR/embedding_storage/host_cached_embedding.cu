@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <embedding/view.hpp>
+#include <embedding_storage/host_cached_embedding.hpp>
+#include <utils.cuh>
+#include <utils.hpp>
+
+namespace embedding {
+
+namespace {
+
+constexpr int num_load_floats = 4;
+
+template <typename key_t>
+__global__ void host_cached_prepare_keys_kernel(const key_t *keys, size_t num_keys,
+                                                long long *cache_keys, int stride, float *vectors,
+                                                float **emb_vec) {
+  CUDA_1D_KERNEL_LOOP_T(size_t, i, num_keys) {
+    cache_keys[i] = static_cast<long long>(keys[i]);
+    if (emb_vec) {
+      emb_vec[i] = vectors + i * stride;
+    }
+  }
+}
+
+// One warp per key. The key of a row is its row in the grouped table, so its table is the last
+// one whose first row is not after it.
+template <typename index_t>
+__global__ void host_cached_fetch_rows_kernel(
+    const long long *keys, const size_t *num_keys, const index_t *emb_table_id_space_offset,
+    int64_t num_id_space_offset, const float *emb_table, const uint64_t *emb_table_ev_offset,
+    const int *local_ev_size_list, int stride, float *vectors, const uint64_t *index,
+    float *scattered_vectors) {
+  const int lane_id = threadIdx.x % warpSize;
+  const size_t num_warps = static_cast<size_t>(gridDim.x) * blockDim.x / warpSize;
+  const size_t n = *num_keys;
+  for (size_t k = (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / warpSize; k < n;
+       k += num_warps) {
+    const index_t key = static_cast<index_t>(keys[k]);
+    const int64_t local_id_space_idx =
+        bs_upper_bound_sub_one(emb_table_id_space_offset, num_id_space_offset, key);
+    const uint64_t start = static_cast<uint64_t>(emb_table_id_space_offset[local_id_space_idx]);
+    const int ev_size = local_ev_size_list[local_id_space_idx];
+
+    const float *src = emb_table + emb_table_ev_offset[local_id_space_idx] +
+                       (static_cast<uint64_t>(key) - start) * ev_size;
+    float *dst = vectors + k * stride;
+    float *scattered_dst = index ? scattered_vectors + index[k] * stride : nullptr;
+    for (int i = lane_id; i < ev_size; i += warpSize) {
+      const float w = src[i];
+      dst[i] = w;
+      if (scattered_dst) {
+        scattered_dst[i] = w;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+HostCachedEmbeddingTable::HostCachedEmbeddingTable(
+    const HugeCTR::GPUResource &gpu_resource, std::shared_ptr<CoreResourceManager> core,
+    const std::vector<EmbeddingTableParam> &table_params, const EmbeddingCollectionParam &ebc_param,
+    size_t grouped_id, const HugeCTR::OptParams &opt_param)
+    : core_(core),
+      table_(std::make_unique<RaggedStaticEmbeddingTable>(gpu_resource, core, table_params,
+                                                          ebc_param, grouped_id, opt_param, true)) {
+  CudaDeviceContext ctx(core_->get_device_id());
+  HCTR_CHECK_HINT(ebc_param.table_storage_type_ == TableStorageType::FP32,
+                  "embedding tables in host memory only support FP32 weights.");
+  stride_ = HugeCTR::alignTo(table_->max_ev_size_, num_load_floats);
+
+  // Each shard caches the share of its rows that the table caches.
+  size_t num_cached_rows = 0;
+  for (size_t i = 0; i < table_->h_table_ids_.size(); ++i) {
+    const auto &table_param = table_params[table_->h_table_ids_[i]];
+    num_cached_rows += HugeCTR::ceildiv<size_t>(
+        static_cast<size_t>(table_param.num_gpu_cached_rows) * table_->h_num_key_per_table_[i],
+        table_param.max_vocabulary_size);
+  }
+  capacity_in_set_ =
+      std::max<size_t>(HugeCTR::ceildiv<size_t>(num_cached_rows, SET_ASSOCIATIVITY * SLAB_SIZE), 1);
+  cache_ = std::make_unique<Cache>(capacity_in_set_, stride_);
+
+  HCTR_LIB_THROW(cudaEventCreateWithFlags(&prefetch_event_, cudaEventDisableTiming));
+  HCTR_LIB_THROW(cudaEventCreateWithFlags(&update_event_, cudaEventDisableTiming));
+  HCTR_LOG_S(INFO, ROOT) << "Embedding table of grouped table " << grouped_id << " on GPU "
+                         << core_->get_device_id() << " is in host memory, and caches "
+                         << capacity_in_set_ * SET_ASSOCIATIVITY * SLAB_SIZE << " of its "
+                         << table_->key_num() << " rows on the GPU" << std::endl;
+}
+
+HostCachedEmbeddingTable::~HostCachedEmbeddingTable() {
+  CudaDeviceContext ctx(core_->get_device_id());
+  cache_.reset();
+  HCTR_LIB_CHECK_(cudaEventDestroy(prefetch_event_));
+  HCTR_LIB_CHECK_(cudaEventDestroy(update_event_));
+}
+
+void HostCachedEmbeddingTable::reserve(Workspace &workspace, size_t num_keys,
+                                       cudaStream_t stream) {
+  if (static_cast<int64_t>(num_keys) <= workspace.capacity) {
+    return;
+  }
+  // The previous buffers may still be read by earlier work of the stream.
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  const int64_t capacity = static_cast<int64_t>(num_keys);
+  core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+  workspace.capacity = capacity;
+  workspace.keys = core23::Tensor(params.shape({capacity}).data_type(core23::ScalarType::Int64));
+  workspace.vectors =
+      core23::Tensor(params.shape({capacity * stride_}).data_type(core23::ScalarType::Float));
+  workspace.missing_index =
+      core23::Tensor(params.shape({capacity}).data_type(core23::ScalarType::UInt64));
+  workspace.missing_keys =
+      core23::Tensor(params.shape({capacity}).data_type(core23::ScalarType::Int64));
+  workspace.missing_vectors =
+      core23::Tensor(params.shape({capacity * stride_}).data_type(core23::ScalarType::Float));
+  workspace.num_missing = core23::Tensor(params.shape({1}).data_type(core23::ScalarType::UInt64));
+}
+
+void HostCachedEmbeddingTable::prepare_keys(const core23::Tensor &keys, size_t num_keys,
+                                            Workspace &workspace, core23::Tensor *emb_vec,
+                                            cudaStream_t stream) {
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(keys.data_type().type(), key_t, [&] {
+    constexpr int block_size = 256;
+    const int grid_size = HugeCTR::ceildiv(static_cast<int>(num_keys), block_size);
+    host_cached_prepare_keys_kernel<<<grid_size, block_size, 0, stream>>>(
+        keys.data<key_t>(), num_keys, workspace.keys.data<long long>(), stride_,
+        workspace.vectors.data<float>(),
+        emb_vec ? static_cast<float **>(emb_vec->data()) : nullptr);
+    HCTR_LIB_THROW(cudaPeekAtLastError());
+  });
+}
+
+void HostCachedEmbeddingTable::fetch_rows(const long long *keys, const size_t *d_num_keys,
+                                          size_t num_keys, float *vectors, const uint64_t *index,
+                                          float *scattered_vectors, cudaStream_t stream) {
+  const auto &offsets = table_->num_key_per_table_offset_;
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(offsets.data_type().type(), index_t, [&] {
+    constexpr int block_size = 256;
+    const auto &kernel_param = core_->get_kernel_param();
+    const int grid_size = std::min(
+        HugeCTR::ceildiv(static_cast<int>(num_keys), block_size / 32),
+        HugeCTR::ceildiv(kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size));
+    host_cached_fetch_rows_kernel<<<grid_size, block_size, 0, stream>>>(
+        keys, d_num_keys, offsets.data<index_t>(), offsets.num_elements(),
+        table_->emb_table_.data<float>(), table_->emb_table_ev_offset_.data<uint64_t>(),
+        table_->local_ev_size_list_.data<int>(), stride_, vectors, index, scattered_vectors);
+    HCTR_LIB_THROW(cudaPeekAtLastError());
+  });
+}
+
+void HostCachedEmbeddingTable::reset_cache() {
+  CudaDeviceContext ctx(core_->get_device_id());
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  cache_.reset();
+  cache_ = std::make_unique<Cache>(capacity_in_set_, stride_);
+}
+
+void HostCachedEmbeddingTable::lookup(const core23::Tensor &keys, size_t num_keys,
+                                      const core23::Tensor &id_space_offset,
+                                      size_t num_id_space_offset, const core23::Tensor &id_space,
+                                      core23::Tensor &embedding_vec) {
+  if (num_keys == 0) {
+    return;
+  }
+  CudaDeviceContext ctx(core_->get_device_id());
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+  Workspace &workspace = lookup_workspaces_[stream];
+  reserve(workspace, num_keys, stream);
+
+  // The hits are written to the rows of the workspace, which the results point to, by the query.
+  // The misses are copied there from host memory, and inserted into the cache.
+  prepare_keys(keys, num_keys, workspace, &embedding_vec, stream);
+  auto *num_missing = static_cast<size_t *>(workspace.num_missing.data());
+  cache_->Query(workspace.keys.data<long long>(), num_keys, workspace.vectors.data<float>(),
+                workspace.missing_index.data<uint64_t>(), workspace.missing_keys.data<long long>(),
+                num_missing, stream);
+  fetch_rows(workspace.missing_keys.data<long long>(), num_missing, num_keys,
+             workspace.missing_vectors.data<float>(), workspace.missing_index.data<uint64_t>(),
+             workspace.vectors.data<float>(), stream);
+  cache_->ReplaceWithDeviceLen(workspace.missing_keys.data<long long>(), num_missing, num_keys,
+                               workspace.missing_vectors.data<float>(), stream);
+}
+
+void HostCachedEmbeddingTable::prefetch(const core23::Tensor &keys, size_t num_keys,
+                                        const core23::Tensor &id_space_offset,
+                                        size_t num_id_space_offset,
+                                        const core23::Tensor &id_space) {
+  if (num_keys == 0) {
+    return;
+  }
+  CudaDeviceContext ctx(core_->get_device_id());
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+  reserve(prefetch_workspace_, num_keys, stream);
+  HCTR_LIB_THROW(cudaStreamWaitEvent(stream, update_event_));
+
+  Workspace &workspace = prefetch_workspace_;
+  prepare_keys(keys, num_keys, workspace, nullptr, stream);
+  auto *num_missing = static_cast<size_t *>(workspace.num_missing.data());
+  cache_->Query(workspace.keys.data<long long>(), num_keys, workspace.vectors.data<float>(),
+                workspace.missing_index.data<uint64_t>(), workspace.missing_keys.data<long long>(),
+                num_missing, stream);
+  fetch_rows(workspace.missing_keys.data<long long>(), num_missing, num_keys,
+             workspace.missing_vectors.data<float>(), nullptr, nullptr, stream);
+  cache_->ReplaceWithDeviceLen(workspace.missing_keys.data<long long>(), num_missing, num_keys,
+                               workspace.missing_vectors.data<float>(), stream);
+  HCTR_LIB_THROW(cudaEventRecord(prefetch_event_, stream));
+}
+
+void HostCachedEmbeddingTable::update(const core23::Tensor &unique_keys,
+                                      const core23::Tensor &num_unique_keys,
+                                      const core23::Tensor &table_ids,
+                                      const core23::Tensor &ev_start_indices,
+                                      const core23::Tensor &wgrad) {
+  CudaDeviceContext ctx(core_->get_device_id());
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+  HCTR_LIB_THROW(cudaStreamWaitEvent(stream, prefetch_event_));
+  table_->update(unique_keys, num_unique_keys, table_ids, ev_start_indices, wgrad);
+
+  // The cache can only overwrite its rows with a number of keys that is known on the host.
+  uint64_t num_keys = 0;
+  HCTR_LIB_THROW(cudaMemcpyAsync(&num_keys, num_unique_keys.data(), sizeof(uint64_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  if (num_keys > 0) {
+    reserve(update_workspace_, num_keys, stream);
+    Workspace &workspace = update_workspace_;
+    prepare_keys(unique_keys, num_keys, workspace, nullptr, stream);
+    const auto *d_num_keys = static_cast<const size_t *>(num_unique_keys.data());
+    fetch_rows(workspace.keys.data<long long>(), d_num_keys, num_keys,
+               workspace.vectors.data<float>(), nullptr, nullptr, stream);
+    cache_->Update(workspace.keys.data<long long>(), num_keys, workspace.vectors.data<float>(),
+                   stream);
+  }
+  HCTR_LIB_THROW(cudaEventRecord(update_event_, stream));
+}
+
+void HostCachedEmbeddingTable::assign(const core23::Tensor &unique_key, size_t num_unique_key,
+                                      const core23::Tensor &num_unique_key_per_table_offset,
+                                      size_t num_table_offset, const core23::Tensor &table_id_list,
+                                      core23::Tensor &embeding_vector,
+                                      const core23::Tensor &embedding_vector_offset) {
+  table_->assign(unique_key, num_unique_key, num_unique_key_per_table_offset, num_table_offset,
+                 table_id_list, embeding_vector, embedding_vector_offset);
+  reset_cache();
+}
+
+void HostCachedEmbeddingTable::load(core23::Tensor &keys, core23::Tensor &id_space_offset,
+                                    core23::Tensor &embedding_table, core23::Tensor &ev_size_list,
+                                    core23::Tensor &id_space) {
+  table_->load(keys, id_space_offset, embedding_table, ev_size_list, id_space);
+  reset_cache();
+}
+
+void HostCachedEmbeddingTable::dump(core23::Tensor *keys, core23::Tensor *id_space_offset,
+                                    core23::Tensor *embedding_table, core23::Tensor *ev_size_list,
+                                    core23::Tensor *id_space) {
+  table_->dump(keys, id_space_offset, embedding_table, ev_size_list, id_space);
+}
+
+void HostCachedEmbeddingTable::dump_by_id(core23::Tensor *h_keys_tensor,
+                                          core23::Tensor *h_embedding_table, int table_id) {
+  table_->dump_by_id(h_keys_tensor, h_embedding_table, table_id);
+}
+
+void HostCachedEmbeddingTable::load_by_id(core23::Tensor *h_keys_tensor,
+                                          core23::Tensor *h_embedding_table, int table_id) {
+  table_->load_by_id(h_keys_tensor, h_embedding_table, table_id);
+  reset_cache();
+}
+
+void HostCachedEmbeddingTable::clear() {
+  table_->clear();
+  reset_cache();
+}
+
+}  // namespace embedding
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <embedding_storage/ragged_static_embedding.hpp>
+#include <limits>
+#include <map>
+#include <memory>
+#include <nv_gpu_cache.hpp>
+
+namespace embedding {
+
+// Static table whose rows and optimizer states are in pinned host memory, for tables that do not
+// fit into the gpus. A set-associative gpu cache holds the recently used rows, whose cache key is
+// their row in the grouped table. Lookups are stream ordered: the rows that miss the cache are
+// read from host memory and inserted into it. The optimizer updates the host rows, which are then
+// written through to the rows in the cache, so that evicting a row never needs a write back.
+class HostCachedEmbeddingTable final : public IGroupedEmbeddingTable {
+  using Cache = gpu_cache::gpu_cache<long long, uint64_t, std::numeric_limits<long long>::max(),
+                                     SET_ASSOCIATIVITY, SLAB_SIZE>;
+
+  // Buffers of the cache accesses of one stream, for up to capacity keys.
+  struct Workspace {
+    int64_t capacity = 0;
+    core23::Tensor keys;             // long long
+    core23::Tensor vectors;          // capacity x stride
+    core23::Tensor missing_index;    // uint64_t
+    core23::Tensor missing_keys;     // long long
+    core23::Tensor missing_vectors;  // capacity x stride
+    core23::Tensor num_missing;      // 1 size_t
+  };
+
+  std::shared_ptr<CoreResourceManager> core_;
+  std::unique_ptr<RaggedStaticEmbeddingTable> table_;
+  size_t capacity_in_set_;
+  // Rows in the cache and in the lookup results are padded to 4 floats, for vectorized loads.
+  int stride_;
+  std::unique_ptr<Cache> cache_;
+
+  // The lookup results point into the workspace of their stream, which is reused once the earlier
+  // work of the stream, which consumes the previous lookup, has completed.
+  std::map<cudaStream_t, Workspace> lookup_workspaces_;
+  Workspace prefetch_workspace_;
+  Workspace update_workspace_;
+  // A prefetch must not read a row while an update writes it, and the other way round, or the
+  // cache could keep a stale row. Each of them waits for the last event of the other.
+  cudaEvent_t prefetch_event_;
+  cudaEvent_t update_event_;
+
+  void reserve(Workspace &workspace, size_t num_keys, cudaStream_t stream);
+
+  // Converts keys into cache keys and, if emb_vec is not empty, points it to the rows of the
+  // workspace.
+  void prepare_keys(const core23::Tensor &keys, size_t num_keys, Workspace &workspace,
+                    core23::Tensor *emb_vec, cudaStream_t stream);
+
+  // Copies the host rows of the num_keys keys, whose number on the gpu is d_num_keys, into the
+  // rows of vectors. If index is not null, they are also copied to the rows index of
+  // scattered_vectors.
+  void fetch_rows(const long long *keys, const size_t *d_num_keys, size_t num_keys,
+                  float *vectors, const uint64_t *index, float *scattered_vectors,
+                  cudaStream_t stream);
+
+  // Drops all cached rows, e.g. after the host rows were overwritten.
+  void reset_cache();
+
+ public:
+  HostCachedEmbeddingTable(const HugeCTR::GPUResource &gpu_resource,
+                           std::shared_ptr<CoreResourceManager> core,
+                           const std::vector<EmbeddingTableParam> &table_params,
+                           const EmbeddingCollectionParam &ebc_param, size_t grouped_id,
+                           const HugeCTR::OptParams &opt_param);
+
+  ~HostCachedEmbeddingTable() override;
+
+  void lookup(const core23::Tensor &keys, size_t num_keys, const core23::Tensor &id_space_offset,
+              size_t num_id_space_offset, const core23::Tensor &id_space,
+              core23::Tensor &embedding_vec) override;
+
+  void update(const core23::Tensor &unique_keys, const core23::Tensor &num_unique_keys,
+              const core23::Tensor &table_ids, const core23::Tensor &ev_start_indices,
+              const core23::Tensor &wgrad) override;
+
+  void assign(const core23::Tensor &unique_key, size_t num_unique_key,
+              const core23::Tensor &num_unique_key_per_table_offset, size_t num_table_offset,
+              const core23::Tensor &table_id_list, core23::Tensor &embeding_vector,
+              const core23::Tensor &embedding_vector_offset) override;
+
+  void load(core23::Tensor &keys, core23::Tensor &id_space_offset, core23::Tensor &embedding_table,
+            core23::Tensor &ev_size_list, core23::Tensor &id_space) override;
+
+  void dump(core23::Tensor *keys, core23::Tensor *id_space_offset, core23::Tensor *embedding_table,
+            core23::Tensor *ev_size_list, core23::Tensor *id_space) override;
+
+  void dump_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
+                  int table_id) override;
+
+  void load_by_id(core23::Tensor *h_keys_tensor, core23::Tensor *h_embedding_table,
+                  int table_id) override;
+
+  size_t size() const override { return table_->size(); }
+
+  size_t capacity() const override { return table_->capacity(); }
+
+  size_t key_num() const override { return table_->key_num(); }
+
+  std::vector<size_t> size_per_table() const override { return table_->size_per_table(); }
+
+  std::vector<size_t> capacity_per_table() const override { return table_->capacity_per_table(); }
+
+  std::vector<size_t> key_num_per_table() const override { return table_->key_num_per_table(); }
+
+  std::vector<int> table_ids() const override { return table_->table_ids(); }
+
+  std::vector<int> table_evsize() const override { return table_->table_evsize(); }
+
+  void clear() override;
+
+  void set_learning_rate(float lr) override { table_->set_learning_rate(lr); }
+
+  void set_device_learning_rate(const float *lr_ptr) override {
+    table_->set_device_learning_rate(lr_ptr);
+  }
+
+  // Inserts the rows of keys that are not cached yet, on the current stream of the core, which is
+  // usually not the one of lookup and update.
+  void prefetch(const core23::Tensor &keys, size_t num_keys, const core23::Tensor &id_space_offset,
+                size_t num_id_space_offset, const core23::Tensor &id_space) override;
+};
+
+}  // namespace embedding
@@ -15,6 +15,7 @@
  */
 #pragma once
 #include <core23/data_type_helpers.cuh>
+#include <utils.cuh>
 
 namespace embedding {
 namespace {
@@ -26,9 +27,10 @@ namespace {
  */
 template <typename wgrad_t>
 __global__ void sgd_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                       float scaler, wgrad_t* g) {
+                                       const float* lr_ptr, float scaler, wgrad_t* g) {
   uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
   if (tid >= num_ev) return;
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
@@ -48,10 +50,11 @@ __global__ void sgd_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_
  */
 template <typename wgrad_t>
 __global__ void momentum_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                            float momentum_decay, float** state_tensors,
-                                            float scaler, wgrad_t* g) {
+                                            const float* lr_ptr, float momentum_decay,
+                                            float** state_tensors, float scaler, wgrad_t* g) {
   uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
   if (tid >= num_ev) return;
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
@@ -76,10 +79,11 @@ __global__ void momentum_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
  */
 template <typename wgrad_t>
 __global__ void nesterov_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                            float momentum_decay, float** state_tensors,
-                                            float scaler, wgrad_t* g) {
+                                            const float* lr_ptr, float momentum_decay,
+                                            float** state_tensors, float scaler, wgrad_t* g) {
   uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
   if (tid >= num_ev) return;
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
@@ -105,10 +109,11 @@ __global__ void nesterov_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
  */
 template <typename wgrad_t>
 __global__ void ada_grad_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                            float** state_tensors, float epsilon, float scaler,
-                                            wgrad_t* g) {
+                                            const float* lr_ptr, float** state_tensors,
+                                            float epsilon, float scaler, wgrad_t* g) {
   uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
   if (tid >= num_ev) return;
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
@@ -123,6 +128,40 @@ __global__ void ada_grad_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
   }
 }
 
+/**
+ * Row-wise AdaGrad
+ * ----------------
+ * g_i = g_i / s
+ * v = v + mean(g_i^2)
+ * g_i = -eta * g_i / (sqrt(v) + epsilon)
+ */
+template <typename wgrad_t>
+__global__ void row_wise_ada_grad_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                                     float lr, const float* lr_ptr,
+                                                     float** state_tensors, float epsilon,
+                                                     float scaler, wgrad_t* g) {
+  uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+  if (tid >= num_ev) return;
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
+
+  uint32_t start = ev_offsets[tid];
+  uint32_t end = ev_offsets[tid + 1];
+
+  float sum_gi_squared = 0.f;
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
+    sum_gi_squared += gi * gi;
+  }
+  float* v = state_tensors[tid];
+  float vi = *v = *v + sum_gi_squared / (end - start);
+
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
+
+    g[i] = core23::TypeConverter<wgrad_t, float>::value(-lr * gi / (sqrtf(vi) + epsilon));
+  }
+}
+
 /**
  * RMSProp
  * -------
@@ -132,10 +171,11 @@ __global__ void ada_grad_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
  */
 template <typename wgrad_t>
 __global__ void rms_prop_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                            float beta, float** state_tensors, float epsilon,
-                                            float scaler, wgrad_t* g) {
+                                            const float* lr_ptr, float beta, float** state_tensors,
+                                            float epsilon, float scaler, wgrad_t* g) {
   uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
   if (tid >= num_ev) return;
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
@@ -161,25 +201,80 @@ __global__ void rms_prop_update_grad_kernel(const uint32_t* ev_offsets, uint32_t
  * v_i_debiased = v_i / (1 - beta_2^t)
  *
  * g_i = -eta * m_i_debiased / (sqrt(v_i_debiased) + epsilon)
+ *
+ * The moments are stored as state_t, which packs them into the float state tensors if FP16.
  */
-template <typename wgrad_t>
+template <typename wgrad_t, typename state_t = float>
 __global__ void adam_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
-                                        float lr_scaled_bias, float beta1, float beta2,
-                                        float** state_tensors, float epsilon, float scaler,
-                                        wgrad_t* g) {
+                                        float lr_scaled_bias, const float* lr_ptr, float beta1,
+                                        float beta2, float** state_tensors, float epsilon,
+                                        float scaler, wgrad_t* g) {
   uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
   if (tid >= num_ev) return;
+  lr_scaled_bias = HugeCTR::scale_by_device_lr(lr_scaled_bias, lr_ptr);
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
 
-  float* m = state_tensors[tid] - start;
-  float* v = m + end - start;
+  state_t* m = reinterpret_cast<state_t*>(state_tensors[tid]) - start;
+  state_t* v = m + end - start;
+
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
+    float mi = beta1 * core23::TypeConverter<float, state_t>::value(m[i]) + (1.f - beta1) * gi;
+    float vi =
+        beta2 * core23::TypeConverter<float, state_t>::value(v[i]) + (1.f - beta2) * gi * gi;
+    m[i] = core23::TypeConverter<state_t, float>::value(mi);
+    v[i] = core23::TypeConverter<state_t, float>::value(vi);
+
+    g[i] =
+        core23::TypeConverter<wgrad_t, float>::value(-lr_scaled_bias * mi / (sqrtf(vi) + epsilon));
+  }
+}
+
+/**
+ * Lazy Adam
+ * ---------
+ * g_i = g_i / s
+ * k = t - last_step
+ * m_i = beta_1^k * m_i + (1 - beta_1) * g_i
+ * v_i = beta_2^k * v_i + (1 - beta_2) * g_i^2
+ *
+ * g_i = -eta * bias(t) * m_i / (sqrt(v_i) + epsilon)
+ *
+ * The moments decay over the steps that skipped the row. Its int32 step counter follows the
+ * moments in the state tensors.
+ */
+template <typename wgrad_t, typename state_t = float>
+__global__ void lazy_adam_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev,
+                                             float lr_scaled_bias, const float* lr_ptr,
+                                             float beta1, float beta2, int step,
+                                             float** state_tensors, float epsilon, float scaler,
+                                             wgrad_t* g) {
+  uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
+  if (tid >= num_ev) return;
+  lr_scaled_bias = HugeCTR::scale_by_device_lr(lr_scaled_bias, lr_ptr);
+
+  uint32_t start = ev_offsets[tid];
+  uint32_t end = ev_offsets[tid + 1];
+
+  state_t* m = reinterpret_cast<state_t*>(state_tensors[tid]) - start;
+  state_t* v = m + end - start;
+  int* last_step = reinterpret_cast<int*>(v + end);
+
+  const int skipped = step - *last_step;
+  *last_step = step;
+  const float beta1_pow_skipped = powf(beta1, skipped);
+  const float beta2_pow_skipped = powf(beta2, skipped);
 
   for (uint32_t i = start; i < end; ++i) {
     float gi = core23::TypeConverter<float, wgrad_t>::value(g[i]) / scaler;
-    float mi = m[i] = beta1 * m[i] + (1.f - beta1) * gi;
-    float vi = v[i] = beta2 * v[i] + (1.f - beta2) * gi * gi;
+    float mi = beta1_pow_skipped * core23::TypeConverter<float, state_t>::value(m[i]) +
+               (1.f - beta1) * gi;
+    float vi = beta2_pow_skipped * core23::TypeConverter<float, state_t>::value(v[i]) +
+               (1.f - beta2) * gi * gi;
+    m[i] = core23::TypeConverter<state_t, float>::value(mi);
+    v[i] = core23::TypeConverter<state_t, float>::value(vi);
 
     g[i] =
         core23::TypeConverter<wgrad_t, float>::value(-lr_scaled_bias * mi / (sqrtf(vi) + epsilon));
@@ -201,11 +296,13 @@ __global__ void adam_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num
  */
 template <typename wgrad_t>
 __global__ void ftrl_update_grad_kernel(const uint32_t* ev_offsets, uint32_t num_ev, float lr,
-                                        float lambda1, float lambda2_plus_beta_div_lr,
-                                        float** state_tensors, float** weight_tensors, float scaler,
-                                        wgrad_t* g) {
+                                        const float* lr_ptr, float lambda1, float lambda2,
+                                        float beta, float** state_tensors, float** weight_tensors,
+                                        float scaler, wgrad_t* g) {
   uint32_t tid = blockIdx.x * blockDim.x + threadIdx.x;
   if (tid >= num_ev) return;
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
+  const float lambda2_plus_beta_div_lr = lambda2 + beta / lr;
 
   uint32_t start = ev_offsets[tid];
   uint32_t end = ev_offsets[tid + 1];
@@ -106,6 +106,34 @@ inline void ada_grad_update_grad(uint32_t idx, const uint32_t* ev_offsets, float
   }
 }
 
+/**
+ * Row-wise AdaGrad
+ * ----------------
+ * g_i = g_i / s
+ * v = v + mean(g_i^2)
+ * g_i = -eta * g_i / (sqrt(v) + epsilon)
+ */
+inline void row_wise_ada_grad_update_grad(uint32_t idx, const uint32_t* ev_offsets, float lr,
+                                          float** state_tensors, float epsilon, float scaler,
+                                          float* g) {
+  const uint32_t start = ev_offsets[idx];
+  const uint32_t end = ev_offsets[idx + 1];
+
+  float sum_gi_squared = 0.f;
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = g[i] / scaler;
+    sum_gi_squared += gi * gi;
+  }
+  float* v = state_tensors[idx];
+  float vi = *v = *v + sum_gi_squared / (end - start);
+
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = g[i] / scaler;
+
+    g[i] = -lr * gi / (std::sqrt(vi) + epsilon);
+  }
+}
+
 /**
  * RMSProp
  * -------
@@ -158,6 +186,42 @@ inline void adam_update_grad(uint32_t idx, const uint32_t* ev_offsets, float lr_
   }
 }
 
+/**
+ * Lazy Adam
+ * ---------
+ * g_i = g_i / s
+ * k = t - last_step
+ * m_i = beta_1^k * m_i + (1 - beta_1) * g_i
+ * v_i = beta_2^k * v_i + (1 - beta_2) * g_i^2
+ *
+ * g_i = -eta * bias(t) * m_i / (sqrt(v_i) + epsilon)
+ *
+ * The step counter follows the moments, and is kept as a float.
+ */
+inline void lazy_adam_update_grad(uint32_t idx, const uint32_t* ev_offsets, float lr_scaled_bias,
+                                  float beta1, float beta2, int step, float** state_tensors,
+                                  float epsilon, float scaler, float* g) {
+  const uint32_t start = ev_offsets[idx];
+  const uint32_t end = ev_offsets[idx + 1];
+
+  float* m = state_tensors[idx] - start;
+  float* v = m + end - start;
+  float* last_step = v + end;
+
+  const int skipped = step - static_cast<int>(*last_step);
+  *last_step = static_cast<float>(step);
+  const float beta1_pow_skipped = std::pow(beta1, skipped);
+  const float beta2_pow_skipped = std::pow(beta2, skipped);
+
+  for (uint32_t i = start; i < end; ++i) {
+    float gi = g[i] / scaler;
+    float mi = m[i] = beta1_pow_skipped * m[i] + (1.f - beta1) * gi;
+    float vi = v[i] = beta2_pow_skipped * v[i] + (1.f - beta2) * gi * gi;
+
+    g[i] = -lr_scaled_bias * mi / (std::sqrt(vi) + epsilon);
+  }
+}
+
 /**
  * FTRL
  * ----
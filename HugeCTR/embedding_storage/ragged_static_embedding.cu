@@ -19,10 +19,15 @@
 
 #include <data_simulator.hpp>
 #include <embedding/operators/generic_lookup.cuh>
+#include <embedding/operators/index_calculation.hpp>
+#include <embedding/operators/model_backward.hpp>
+#include <embedding/operators/multi_to_one_reduce_v2.cuh>
+#include <embedding/operators/stochastic_rounding.cuh>
 #include <embedding/view.hpp>
 #include <embedding_storage/ragged_static_embedding.hpp>
 #include <numeric>
 #include <utils.cuh>
+#include <utils.hpp>
 
 namespace embedding {
 
@@ -47,6 +52,40 @@ __global__ void ragged_static_embedding_table_lookup_kernel(
   }
 }
 
+// Converts the FP16 rows of the keys into FP32 rows of the lookup buffer, and returns pointers to
+// them. Each warp converts one row.
+template <typename key_t, typename offset_t, typename index_t>
+__global__ void ragged_static_embedding_table_lookup_half_kernel(
+    const key_t *keys, size_t num_keys, const offset_t *id_space_offset, size_t num_id_space_offset,
+    const int *id_space_list, const int *local_id_space_list, size_t num_local_id_space_list,
+    const index_t *emb_table_id_space_offset, const __half *emb_table,
+    const uint64_t *emb_table_ev_offset, const int *local_ev_size_list, int lookup_buffer_stride,
+    float *lookup_buffer, float **emb_vec) {
+  const int lane_id = threadIdx.x % warpSize;
+  const size_t num_warps = static_cast<size_t>(gridDim.x) * blockDim.x / warpSize;
+  for (size_t k = (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / warpSize;
+       k < num_keys; k += num_warps) {
+    int64_t id_space_idx =
+        bs_upper_bound_sub_one(id_space_offset, num_id_space_offset, static_cast<offset_t>(k));
+    int id_space = id_space_list[id_space_idx];
+    int64_t local_id_space_idx =
+        bs_upper_bound_sub_one(local_id_space_list, num_local_id_space_list, id_space);
+
+    uint64_t start = (uint64_t)emb_table_id_space_offset[local_id_space_idx];
+    uint64_t ev_offset = emb_table_ev_offset[local_id_space_idx];
+    int ev_size = local_ev_size_list[local_id_space_idx];
+
+    const __half *src = emb_table + ev_offset + ((uint64_t)keys[k] - start) * ev_size;
+    float *dst = lookup_buffer + k * lookup_buffer_stride;
+    for (int i = lane_id; i < ev_size; i += warpSize) {
+      dst[i] = __half2float(src[i]);
+    }
+    if (lane_id == 0) {
+      emb_vec[k] = dst;
+    }
+  }
+}
+
 template <typename key_t, typename index_t>
 struct RaggedKeyToIndicesFunc {
   int *local_table_ids;
@@ -78,12 +117,55 @@ struct OptimizierInput {
   int ev_id;
   float lr;
   float scaler;
+  uint32_t seed;  // Of the stochastic rounding of FP16 weights
 };
 
+// The weights of FP16 tables are updated in FP32, and rounded stochastically when they are stored.
+// The random number of a weight depends on the seed and its index in the table.
+template <typename wgrad_t>
+DEVICE_INLINE float load_weight(const OptimizierInput<wgrad_t> &input, const float *ev) {
+  return ev[input.ev_id];
+}
+
+template <typename wgrad_t>
+DEVICE_INLINE float load_weight(const OptimizierInput<wgrad_t> &input, const __half *ev) {
+  return __half2float(ev[input.ev_id]);
+}
+
+template <typename wgrad_t>
+DEVICE_INLINE void store_weight(const OptimizierInput<wgrad_t> &input, float *ev, float w) {
+  ev[input.ev_id] = w;
+}
+
+template <typename wgrad_t>
+DEVICE_INLINE void store_weight(const OptimizierInput<wgrad_t> &input, __half *ev, float w) {
+  const uint64_t index = input.ev_start_indices + input.ev_id;
+  ev[input.ev_id] = stochastic_round_half(w, hash_index(input.seed, static_cast<uint32_t>(index)));
+}
+
+template <typename wgrad_t>
+DEVICE_INLINE void store_weight4(const OptimizierInput<wgrad_t> &input, float *ev,
+                                 Vec4T<float> &w) {
+  w.store(ev + input.ev_id, 4);
+}
+
+template <typename wgrad_t>
+DEVICE_INLINE void store_weight4(const OptimizierInput<wgrad_t> &input, __half *ev,
+                                 Vec4T<float> &w) {
+  const uint32_t index = static_cast<uint32_t>(input.ev_start_indices + input.ev_id);
+  Vec4T<__half> h;
+  h.value.h[0].x = stochastic_round_half(w.val.x, hash_index(input.seed, index));
+  h.value.h[0].y = stochastic_round_half(w.val.y, hash_index(input.seed, index + 1));
+  h.value.h[1].x = stochastic_round_half(w.val.z, hash_index(input.seed, index + 2));
+  h.value.h[1].y = stochastic_round_half(w.val.w, hash_index(input.seed, index + 3));
+  h.store(ev + input.ev_id, 4);
+}
+
 constexpr int num_load_floats = 4;
 template <typename wgrad_t>
 struct SGDOptimizer {
-  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, float *ev) {
+  template <typename emb_t>
+  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, emb_t *ev) {
     Vec4T<float> gi;
     gi.load(input.wgrad + input.ev_id, 4);
     Vec4T<float> ev_plus_gi;
@@ -94,14 +176,13 @@ struct SGDOptimizer {
     ret.val.z = -input.lr * gi.val.z / input.scaler;
     ret.val.w = -input.lr * gi.val.w / input.scaler;
     ev_plus_gi.accumulate(ret);
-    ev_plus_gi.store(ev + input.ev_id, 4);
+    store_weight4(input, ev, ev_plus_gi);
   }
 
-  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, float *ev) {
-    ev[input.ev_id] =
-        ev[input.ev_id] -
-        input.lr * (HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[input.ev_id]) /
-                    input.scaler);
+  template <typename emb_t>
+  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, emb_t *ev) {
+    float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[input.ev_id]);
+    store_weight(input, ev, load_weight(input, ev) - input.lr * (gi / input.scaler));
   }
 };
 
@@ -110,7 +191,8 @@ struct AdaGradOptimizer {
   acc_t *v;
   float epsilon;
 
-  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, float *ev) {
+  template <typename emb_t>
+  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, emb_t *ev) {
     Vec4T<float> vi;
     vi.load(v + input.ev_start_indices + input.ev_id, 4);
     Vec4T<float> gi;
@@ -136,10 +218,11 @@ struct AdaGradOptimizer {
 
     ev_plus_gi.accumulate(gi);
 
-    ev_plus_gi.store(ev + input.ev_id, 4);
+    store_weight4(input, ev, ev_plus_gi);
   }
 
-  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, float *ev) {
+  template <typename emb_t>
+  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, emb_t *ev) {
     float vi =
         HugeCTR::TypeConvertFunc<float, acc_t>::convert(v[input.ev_start_indices + input.ev_id]);
     float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[input.ev_id]);
@@ -148,7 +231,80 @@ struct AdaGradOptimizer {
 
     gi = -input.lr * gi / (sqrtf(vi) + epsilon);
     v[input.ev_start_indices + input.ev_id] = HugeCTR::TypeConvertFunc<acc_t, float>::convert(vi);
-    ev[input.ev_id] += gi;
+    store_weight(input, ev, load_weight(input, ev) + gi);
+  }
+};
+
+/**
+ * Adam
+ * ----
+ * m_i = beta_1 * m_i + (1 - beta_1) * g_i
+ * v_i = beta_2 * v_i + (1 - beta_2) * g_i^2
+ * w_i = w_i - lr * bias * m_i / (sqrt(v_i) + epsilon)
+ *
+ * The moments are kept in opt_t, which is FP16 with AdamOptHyperParams::half_state.
+ */
+template <typename wgrad_t, typename opt_t>
+struct AdamOptimizer {
+  opt_t *m;
+  opt_t *v;
+
+  float beta1;
+  float beta2;
+  float epsilon;
+  float bias;
+
+  template <typename emb_t>
+  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, emb_t *ev) {
+    Vec4T<float> mi;
+    mi.load(m + input.ev_start_indices + input.ev_id, 4);
+    Vec4T<float> vi;
+    vi.load(v + input.ev_start_indices + input.ev_id, 4);
+    Vec4T<float> gi;
+    gi.load(input.wgrad + input.ev_id, 4);
+    Vec4T<float> ev_plus_gi;
+    ev_plus_gi.load(ev + input.ev_id, 4);
+
+    gi.val.x = gi.val.x / input.scaler;
+    gi.val.y = gi.val.y / input.scaler;
+    gi.val.z = gi.val.z / input.scaler;
+    gi.val.w = gi.val.w / input.scaler;
+    mi.val.x = beta1 * mi.val.x + (1.f - beta1) * gi.val.x;
+    mi.val.y = beta1 * mi.val.y + (1.f - beta1) * gi.val.y;
+    mi.val.z = beta1 * mi.val.z + (1.f - beta1) * gi.val.z;
+    mi.val.w = beta1 * mi.val.w + (1.f - beta1) * gi.val.w;
+    vi.val.x = beta2 * vi.val.x + (1.f - beta2) * gi.val.x * gi.val.x;
+    vi.val.y = beta2 * vi.val.y + (1.f - beta2) * gi.val.y * gi.val.y;
+    vi.val.z = beta2 * vi.val.z + (1.f - beta2) * gi.val.z * gi.val.z;
+    vi.val.w = beta2 * vi.val.w + (1.f - beta2) * gi.val.w * gi.val.w;
+
+    gi.val.x = -input.lr * bias * mi.val.x / (sqrtf(vi.val.x) + epsilon);
+    gi.val.y = -input.lr * bias * mi.val.y / (sqrtf(vi.val.y) + epsilon);
+    gi.val.z = -input.lr * bias * mi.val.z / (sqrtf(vi.val.z) + epsilon);
+    gi.val.w = -input.lr * bias * mi.val.w / (sqrtf(vi.val.w) + epsilon);
+
+    mi.store(m + input.ev_start_indices + input.ev_id, 4);
+    vi.store(v + input.ev_start_indices + input.ev_id, 4);
+
+    ev_plus_gi.accumulate(gi);
+
+    store_weight4(input, ev, ev_plus_gi);
+  }
+
+  template <typename emb_t>
+  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, emb_t *ev) {
+    float mi =
+        HugeCTR::TypeConvertFunc<float, opt_t>::convert(m[input.ev_start_indices + input.ev_id]);
+    float vi =
+        HugeCTR::TypeConvertFunc<float, opt_t>::convert(v[input.ev_start_indices + input.ev_id]);
+    float gi = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(input.wgrad[input.ev_id]);
+    gi = gi / input.scaler;
+    mi = beta1 * mi + (1.f - beta1) * gi;
+    vi = beta2 * vi + (1.f - beta2) * gi * gi;
+
+    m[input.ev_start_indices + input.ev_id] = HugeCTR::TypeConvertFunc<opt_t, float>::convert(mi);
+    v[input.ev_start_indices + input.ev_id] = HugeCTR::TypeConvertFunc<opt_t, float>::convert(vi);
+    store_weight(input, ev, load_weight(input, ev) - input.lr * bias * mi / (sqrtf(vi) + epsilon));
   }
 };
 
@@ -176,7 +332,8 @@ struct FtrlOptimizer {
     w = (sgn(z) * lambda_1 - z) / ((beta + sqrt(n)) / lr + lambda_2)
   ```
    */
-  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, float *ev) {
+  template <typename emb_t>
+  DEVICE_INLINE void update4(const OptimizierInput<wgrad_t> &input, emb_t *ev) {
     float lambda2_plus_beta_div_lr = lambda2 + beta / input.lr;
     Vec4T<float> zi;
     zi.load(z + input.ev_start_indices + input.ev_id, 4);
@@ -241,10 +398,11 @@ struct FtrlOptimizer {
 
     ni.store(n + input.ev_start_indices + input.ev_id, 4);
     zi.store(z + input.ev_start_indices + input.ev_id, 4);
-    weight.store(ev + input.ev_id, 4);
+    store_weight4(input, ev, weight);
   }
 
-  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, float *ev) {
+  template <typename emb_t>
+  DEVICE_INLINE void update(const OptimizierInput<wgrad_t> &input, emb_t *ev) {
     float lambda2_plus_beta_div_lr = lambda2 + beta / input.lr;
     float ni =
         HugeCTR::TypeConvertFunc<float, opt_t>::convert(n[input.ev_start_indices + input.ev_id]);
@@ -258,24 +416,26 @@ struct FtrlOptimizer {
     float sqrt_ni_new = sqrtf(ni + FLT_EPSILON);
 
     float sigma = (sqrt_ni_new - sqrt_ni) / input.lr;
-    zi = zi + gi - sigma * ev[input.ev_id];
+    zi = zi + gi - sigma * load_weight(input, ev);
 
     float p = (1.f - 2.f * signbit(zi)) * lambda1 - zi;
     float q = sqrt_ni_new / input.lr + lambda2_plus_beta_div_lr;
 
     n[input.ev_start_indices + input.ev_id] = HugeCTR::TypeConvertFunc<opt_t, float>::convert(ni);
     z[input.ev_start_indices + input.ev_id] = HugeCTR::TypeConvertFunc<opt_t, float>::convert(zi);
-    ev[input.ev_id] = p / q * signbit(lambda1 - abs(zi));
+    store_weight(input, ev, p / q * signbit(lambda1 - abs(zi)));
   }
 };
 
-template <typename key_t, typename index_t, typename wgrad_t, typename OptimizerFunc,
-          typename KeyToIndicesFunc>
+template <typename key_t, typename index_t, typename wgrad_t, typename table_t,
+          typename OptimizerFunc, typename KeyToIndicesFunc>
 __global__ void update4_kernel(const key_t *keys, const size_t *num_keys_ptr, const int *table_ids,
                                const wgrad_t *grad_ev, const uint32_t *ev_start_indices,
-                               KeyToIndicesFunc key_to_indices_func, float *emb_table,
-                               OptimizerFunc optimizer, float lr, float scaler) {
+                               KeyToIndicesFunc key_to_indices_func, table_t *emb_table,
+                               OptimizerFunc optimizer, float lr, const float *lr_ptr, float scaler,
+                               uint32_t seed) {
   if (*num_keys_ptr == 0) return;
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
   size_t num_steps = (*num_keys_ptr - 1) / (blockDim.x * gridDim.x) + 1;
   for (size_t step = 0; step < num_steps; step++) {
     size_t tid = step * blockDim.x * gridDim.x + (size_t)blockIdx.x * blockDim.x + threadIdx.x;
@@ -298,11 +458,11 @@ __global__ void update4_kernel(const key_t *keys, const size_t *num_keys_ptr, co
           grad_ev + __shfl_sync(0xffffffff, grad_ev_offset_frag, lane_id);
       uint64_t ev_start_indices_v =
           __shfl_sync(0xffffffff, emb_table_ev_start_indices_frag, lane_id);
-      float *ev = emb_table + ev_start_indices_v;
+      table_t *ev = emb_table + ev_start_indices_v;
 
       for (int i = threadIdx.x % warpSize; i < ev_size / num_load_floats; i += warpSize) {
-        OptimizierInput<wgrad_t> input{grad_ev_for_update, ev_start_indices_v, i * num_load_floats,
-                                       lr, scaler};
+        OptimizierInput<wgrad_t> input{
+            grad_ev_for_update, ev_start_indices_v, i * num_load_floats, lr, scaler, seed};
         optimizer.update4(input, ev);
         // float4 gi = optimizer.update4(input, ev);
       }
@@ -310,13 +470,164 @@ __global__ void update4_kernel(const key_t *keys, const size_t *num_keys_ptr, co
   }
 }
 
-template <typename key_t, typename index_t, typename emb_t, typename OptimizerFunc,
+/**
+ * Row-wise AdaGrad
+ * ----------------
+ * v = v + mean(g_i^2)
+ * w_i = w_i - lr * g_i / (sqrt(v) + epsilon)
+ *
+ * Each warp updates the embedding vector of one key, and its single accumulator.
+ */
+template <typename key_t, typename wgrad_t, typename table_t, typename KeyToIndicesFunc>
+__global__ void row_wise_adagrad_update_kernel(const key_t *keys, const size_t *num_keys_ptr,
+                                               const int *table_ids, const wgrad_t *grad_ev,
+                                               const uint32_t *ev_start_indices,
+                                               KeyToIndicesFunc key_to_indices_func,
+                                               table_t *emb_table, float *v, float epsilon,
+                                               float lr, const float *lr_ptr, float scaler,
+                                               uint32_t seed) {
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
+  const int lane_id = threadIdx.x % warpSize;
+  const size_t num_warps = static_cast<size_t>(gridDim.x) * blockDim.x / warpSize;
+  for (size_t k = (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / warpSize;
+       k < *num_keys_ptr; k += num_warps) {
+    key_t key = keys[k];
+    uint64_t emb_table_ev_start_indices;
+    int ev_size;
+    key_to_indices_func(key, table_ids[k], &emb_table_ev_start_indices, &ev_size);
+    const wgrad_t *gi = grad_ev + ev_start_indices[k];
+    table_t *ev = emb_table + emb_table_ev_start_indices;
+
+    float sum_gi_squared = 0.f;
+    for (int i = lane_id; i < ev_size; i += warpSize) {
+      float g = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(gi[i]) / scaler;
+      sum_gi_squared += g * g;
+    }
+    for (int offset = warpSize / 2; offset > 0; offset /= 2) {
+      sum_gi_squared += __shfl_xor_sync(0xffffffff, sum_gi_squared, offset);
+    }
+
+    // Keys of a ragged table are the indices of its rows.
+    float vi;
+    if (lane_id == 0) {
+      vi = v[key] + sum_gi_squared / ev_size;
+      v[key] = vi;
+    }
+    vi = __shfl_sync(0xffffffff, vi, 0);
+
+    const float lr_div_sqrt_vi = lr / (sqrtf(vi) + epsilon);
+    for (int i = lane_id; i < ev_size; i += warpSize) {
+      float g = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(gi[i]) / scaler;
+      OptimizierInput<wgrad_t> input{gi, emb_table_ev_start_indices, i, lr, scaler, seed};
+      store_weight(input, ev, load_weight(input, ev) - lr_div_sqrt_vi * g);
+    }
+  }
+}
+
+/**
+ * Lazy Adam
+ * ---------
+ * k = t - last_step
+ * m_i = beta_1^k * m_i + (1 - beta_1) * g_i
+ * v_i = beta_2^k * v_i + (1 - beta_2) * g_i^2
+ * w_i = w_i - lr * bias(t) * m_i / (sqrt(v_i) + epsilon)
+ *
+ * The moments decay over the k - 1 steps that skipped the row, as if it had zero gradients there,
+ * so that the bias of the global step t corrects them exactly. Each warp updates the embedding
+ * vector of one key, and its step counter.
+ */
+template <typename key_t, typename wgrad_t, typename table_t, typename opt_t,
           typename KeyToIndicesFunc>
+__global__ void lazy_adam_update_kernel(const key_t *keys, const size_t *num_keys_ptr,
+                                        const int *table_ids, const wgrad_t *grad_ev,
+                                        const uint32_t *ev_start_indices,
+                                        KeyToIndicesFunc key_to_indices_func, table_t *emb_table,
+                                        opt_t *m, opt_t *v, int *last_step, int step, float beta1,
+                                        float beta2, float epsilon, float bias, float lr,
+                                        const float *lr_ptr, float scaler, uint32_t seed) {
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
+  const int lane_id = threadIdx.x % warpSize;
+  const size_t num_warps = static_cast<size_t>(gridDim.x) * blockDim.x / warpSize;
+  for (size_t k = (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / warpSize;
+       k < *num_keys_ptr; k += num_warps) {
+    key_t key = keys[k];
+    uint64_t emb_table_ev_start_indices;
+    int ev_size;
+    key_to_indices_func(key, table_ids[k], &emb_table_ev_start_indices, &ev_size);
+    const wgrad_t *gi = grad_ev + ev_start_indices[k];
+    table_t *ev = emb_table + emb_table_ev_start_indices;
+
+    // Keys of a ragged table are the indices of its rows.
+    int skipped;
+    if (lane_id == 0) {
+      skipped = step - last_step[key];
+      last_step[key] = step;
+    }
+    skipped = __shfl_sync(0xffffffff, skipped, 0);
+    const float beta1_pow_skipped = powf(beta1, skipped);
+    const float beta2_pow_skipped = powf(beta2, skipped);
+
+    for (int i = lane_id; i < ev_size; i += warpSize) {
+      const uint64_t idx = emb_table_ev_start_indices + i;
+      float g = HugeCTR::TypeConvertFunc<float, wgrad_t>::convert(gi[i]) / scaler;
+      float mi = beta1_pow_skipped * HugeCTR::TypeConvertFunc<float, opt_t>::convert(m[idx]) +
+                 (1.f - beta1) * g;
+      float vi = beta2_pow_skipped * HugeCTR::TypeConvertFunc<float, opt_t>::convert(v[idx]) +
+                 (1.f - beta2) * g * g;
+      m[idx] = HugeCTR::TypeConvertFunc<opt_t, float>::convert(mi);
+      v[idx] = HugeCTR::TypeConvertFunc<opt_t, float>::convert(vi);
+
+      OptimizierInput<wgrad_t> input{gi, emb_table_ev_start_indices, i, lr, scaler, seed};
+      store_weight(input, ev, load_weight(input, ev) - lr * bias * mi / (sqrtf(vi) + epsilon));
+    }
+  }
+}
+
+// Applies the optimizer to up to 4 elements of the reduced gradient of a unique key, while they are
+// still in the registers of the reduce kernel.
+template <typename key_t, typename table_t, typename OptimizerFunc, typename KeyToIndicesFunc>
+struct FusedUpdateFunc {
+  const key_t *keys;
+  const int *table_ids;
+  KeyToIndicesFunc key_to_indices_func;
+  table_t *emb_table;
+  OptimizerFunc optimizer;
+  float lr;
+  const float *lr_ptr;
+  float scaler;
+  uint32_t seed;
+  bool use_vectorized_kernel;
+
+  DEVICE_INLINE void operator()(uint32_t dst_id, int idx4, int n, const Vec4T<float> &grad) {
+    uint64_t ev_start_indices;
+    int ev_size;
+    key_to_indices_func(keys[dst_id], table_ids[dst_id], &ev_start_indices, &ev_size);
+    table_t *ev = emb_table + ev_start_indices + idx4;
+
+    alignas(16) float gi[num_load_floats];
+    *reinterpret_cast<float4 *>(gi) = grad.val;
+    const float scaled_lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
+    if (use_vectorized_kernel && n == num_load_floats) {
+      OptimizierInput<float> input{gi, ev_start_indices + idx4, 0, scaled_lr, scaler, seed};
+      optimizer.update4(input, ev);
+    } else {
+      for (int i = 0; i < n; ++i) {
+        OptimizierInput<float> input{gi, ev_start_indices + idx4, i, scaled_lr, scaler, seed};
+        optimizer.update(input, ev);
+      }
+    }
+  }
+};
+
+template <typename key_t, typename index_t, typename emb_t, typename table_t,
+          typename OptimizerFunc, typename KeyToIndicesFunc>
 __global__ void update_kernel(const key_t *keys, const uint64_t *num_keys_ptr, const int *table_ids,
                               const emb_t *grad_ev, const uint32_t *ev_start_indices,
-                              KeyToIndicesFunc key_to_indices_func, float *emb_table,
-                              OptimizerFunc optimizer, float lr, float scaler) {
+                              KeyToIndicesFunc key_to_indices_func, table_t *emb_table,
+                              OptimizerFunc optimizer, float lr, const float *lr_ptr, float scaler,
+                              uint32_t seed) {
   if (*num_keys_ptr == 0) return;
+  lr = HugeCTR::scale_by_device_lr(lr, lr_ptr);
   uint64_t num_steps = (*num_keys_ptr - 1) / (blockDim.x * gridDim.x) + 1;
   for (size_t step = 0; step < num_steps; step++) {
     uint64_t tid = step * blockDim.x * gridDim.x + (size_t)blockIdx.x * blockDim.x + threadIdx.x;
@@ -339,24 +650,56 @@ __global__ void update_kernel(const key_t *keys, const uint64_t *num_keys_ptr, c
           grad_ev + __shfl_sync(0xffffffff, grad_ev_offset_frag, lane_id);
       uint64_t ev_start_indices_v =
           __shfl_sync(0xffffffff, emb_table_ev_start_indices_frag, lane_id);
-      float *ev = emb_table + ev_start_indices_v;
+      table_t *ev = emb_table + ev_start_indices_v;
 
       for (int i = threadIdx.x % warpSize; i < ev_size; i += warpSize) {
-        OptimizierInput<emb_t> input{grad_ev_for_update, ev_start_indices_v, i, lr, scaler};
+        OptimizierInput<emb_t> input{grad_ev_for_update, ev_start_indices_v, i, lr, scaler, seed};
         optimizer.update(input, ev);
       }
     }
   }
 }
 
+// Launches the element-wise update of an optimizer on the weights of the table, in their type.
+template <typename key_t, typename index_t, typename wgrad_t, typename KeyToIndicesFunc,
+          typename OptimizerFunc>
+void launch_update_kernel(const core23::Tensor &unique_keys, const core23::Tensor &num_unique_keys,
+                          const core23::Tensor &table_ids, const core23::Tensor &wgrad,
+                          const core23::Tensor &ev_start_indices,
+                          KeyToIndicesFunc key_to_indices_func, core23::Tensor &emb_table,
+                          OptimizerFunc optimizer, float lr, const float *lr_ptr, float scaler,
+                          uint32_t seed, bool use_vectorized_kernel, int grid_size, int block_size,
+                          cudaStream_t stream) {
+  DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(emb_table.data_type().type(), table_t, [&] {
+    auto kernel =
+        use_vectorized_kernel
+            ? update4_kernel<key_t, index_t, wgrad_t, table_t, OptimizerFunc, KeyToIndicesFunc>
+            : update_kernel<key_t, index_t, wgrad_t, table_t, OptimizerFunc, KeyToIndicesFunc>;
+    kernel<<<grid_size, block_size, 0, stream>>>(
+        unique_keys.data<key_t>(), num_unique_keys.data<size_t>(), table_ids.data<int>(),
+        wgrad.data<wgrad_t>(), ev_start_indices.data<uint32_t>(), key_to_indices_func,
+        emb_table.data<table_t>(), optimizer, lr, lr_ptr, scaler, seed);
+  });
+}
+
 }  // namespace
 
 RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
     const HugeCTR::GPUResource &gpu_resource, std::shared_ptr<CoreResourceManager> core,
     const std::vector<EmbeddingTableParam> &table_params, const EmbeddingCollectionParam &ebc_param,
-    size_t grouped_id, const HugeCTR::OptParams &opt_param)
-    : core_(core), emb_table_size_(0), use_vectorized_kernel_{true}, opt_param_(opt_param) {
+    size_t grouped_id, const HugeCTR::OptParams &opt_param, bool host_resident)
+    : core_(core),
+      emb_table_size_(0),
+      use_vectorized_kernel_{true},
+      max_ev_size_{0},
+      opt_param_(opt_param),
+      num_updates_{0} {
   CudaDeviceContext ctx(core_->get_device_id());
+  // Device of the tensors that scale with the vocabulary. Host resident tables are in pinned host
+  // memory, which the kernels access directly.
+  const core23::Device storage_device =
+      host_resident ? core23::Device(core23::DeviceType::CPU)
+                    : core23::Device(core23::DeviceType::GPU, core_->get_device_id());
   int global_gpu_id = core_->get_global_gpu_id();
   int num_gpus = core_->get_global_gpu_count();
   HCTR_CHECK_HINT(num_gpus == static_cast<int>(ebc_param.shard_matrix.size()),
@@ -367,7 +710,8 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
   auto emb_type = ebc_param.emb_type;
   const auto &grouped_table_param = ebc_param.grouped_table_params[grouped_id];
   for (const auto &table_param : table_params) {
-    use_vectorized_kernel_ &= (table_param.ev_size % num_load_floats == 0);
+    int ev_size = table_param.ev_size / ebc_param.get_num_column_shards(table_param.table_id);
+    use_vectorized_kernel_ &= (ev_size % num_load_floats == 0);
   }
 
   DISPATCH_INTEGRAL_FUNCTION_CORE23(key_type.type(), key_t, [&] {
@@ -397,25 +741,16 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
       } else if (grouped_table_param.table_placement_strategy ==
                  TablePlacementStrategy::ModelParallel) {
         for (int table_id : grouped_table_param.table_ids) {
-          std::vector<int> shard_gpu_list;
-          for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
-            HCTR_CHECK_HINT(table_id < static_cast<int>(ebc_param.shard_matrix[gpu_id].size()),
-                            "table_id is out of range");
-            if (ebc_param.shard_matrix[gpu_id][table_id] == 1) {
-              shard_gpu_list.push_back(gpu_id);
-            }
-          }
-          int num_shards = static_cast<int>(shard_gpu_list.size());
-          auto find_shard_id_iter =
-              std::find(shard_gpu_list.begin(), shard_gpu_list.end(), global_gpu_id);
-          if (find_shard_id_iter == shard_gpu_list.end()) {
+          HCTR_CHECK_HINT(table_id < static_cast<int>(ebc_param.shard_matrix[global_gpu_id].size()),
+                          "table_id is out of range");
+          if (!ebc_param.has_grouped_table_shard(global_gpu_id, grouped_id, table_id)) {
             continue;
           }
           uint64_t num_key = 0;
           h_table_ids_.push_back(table_id);
           h_table_max_vocabulary_size_.push_back(table_params[table_id].max_vocabulary_size);
-          int shard_id =
-              static_cast<int>(std::distance(shard_gpu_list.begin(), find_shard_id_iter));
+          int shard_id, num_shards;
+          ebc_param.get_table_shard_id(global_gpu_id, table_id, &shard_id, &num_shards);
           for (int64_t k = 0; k < table_params[table_id].max_vocabulary_size; ++k) {
             if (k % num_shards == shard_id) {
               h_key_list.push_back(k);
@@ -423,12 +758,14 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
             }
           }
 
+          // Column shards hold all rows, and a slice of their embedding vectors.
+          int ev_size = table_params[table_id].ev_size / ebc_param.get_num_column_shards(table_id);
           h_num_key_per_table_.push_back(num_key);
           h_num_key_per_table_offset.push_back(num_key);
-          uint64_t segment_emb_table_size = num_key * table_params[table_id].ev_size;
+          uint64_t segment_emb_table_size = num_key * ev_size;
           h_size_per_table_.push_back(segment_emb_table_size);
           h_emb_table_ev_offset_.push_back(segment_emb_table_size);
-          h_local_ev_sizes_.push_back(table_params[table_id].ev_size);
+          h_local_ev_sizes_.push_back(ev_size);
           emb_table_size_ += segment_emb_table_size;
         }
       }
@@ -440,19 +777,26 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
       for (auto tmp_offset : h_num_key_per_table_offset) {
         h_num_key_per_table_offset_.push_back(static_cast<size_t>(tmp_offset));
       }
+      for (int ev_size : h_local_ev_sizes_) {
+        max_ev_size_ = std::max(max_ev_size_, ev_size);
+      }
 
       core23::Device device(core23::DeviceType::GPU, core->get_device_id());
       core23::TensorParams params = core23::TensorParams().device(device);
+      core23::TensorParams storage_params = core23::TensorParams().device(storage_device);
 
       table_ids_ = core23::Tensor(params.shape({static_cast<int64_t>(h_table_ids_.size())})
                                       .data_type(core23::ScalarType::Int32));
       keys_ = core23::Tensor(
-          params.shape({static_cast<int64_t>(h_key_list.size())}).data_type(key_type));
+          storage_params.shape({static_cast<int64_t>(h_key_list.size())}).data_type(key_type));
       num_key_per_table_offset_ =
           core23::Tensor(params.shape({static_cast<int64_t>(h_num_key_per_table_offset.size())})
                              .data_type(index_type));
-      emb_table_ = core23::Tensor(params.shape({static_cast<int64_t>(emb_table_size_)})
-                                      .data_type(core23::ScalarType::Float));
+      emb_table_ = core23::Tensor(storage_params.shape({static_cast<int64_t>(emb_table_size_)})
+                                      .data_type(ebc_param.table_storage_type_ ==
+                                                         TableStorageType::FP16
+                                                     ? core23::ScalarType::Half
+                                                     : core23::ScalarType::Float));
       emb_table_ev_offset_ =
           core23::Tensor(params.shape({static_cast<int64_t>(h_emb_table_ev_offset_.size())})
                              .data_type(core23::ScalarType::UInt64));
@@ -470,9 +814,11 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
 
   if (opt_param.optimizer == HugeCTR::Optimizer_t::AdaGrad) {
     DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(emb_type.type(), emb_t, [&] {
-      core23::Device device(core23::DeviceType::GPU, core->get_device_id());
-      core23::TensorParams params = core23::TensorParams().device(device);
-      auto accum_tensor = core23::Tensor(params.shape({static_cast<int64_t>(emb_table_size_)})
+      core23::TensorParams params = core23::TensorParams().device(storage_device);
+      const size_t num_accum = opt_param.hyperparams.adagrad.row_wise
+                                   ? h_num_key_per_table_offset_.back()
+                                   : emb_table_size_;
+      auto accum_tensor = core23::Tensor(params.shape({static_cast<int64_t>(num_accum)})
                                              .data_type(core23::ScalarType::Float));
 
       HCTR_LIB_THROW(cudaMemset(accum_tensor.data(), 0, accum_tensor.num_bytes()));
@@ -481,8 +827,7 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
   }
   if (opt_param.optimizer == HugeCTR::Optimizer_t::Ftrl) {
     DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(emb_type.type(), emb_t, [&] {
-      core23::Device device(core23::DeviceType::GPU, core->get_device_id());
-      core23::TensorParams params = core23::TensorParams().device(device);
+      core23::TensorParams params = core23::TensorParams().device(storage_device);
       auto z_tensor = core23::Tensor(params.shape({static_cast<int64_t>(emb_table_size_)})
                                          .data_type(core23::ScalarType::Float));
       auto n_tensor = core23::Tensor(params.shape({static_cast<int64_t>(emb_table_size_)})
@@ -493,18 +838,53 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
       opt_buffer_ = FtrlOptBuffer{z_tensor, n_tensor};
     });
   }
+  if (opt_param.optimizer == HugeCTR::Optimizer_t::Adam) {
+    core23::TensorParams params =
+        core23::TensorParams()
+            .device(storage_device)
+            .shape({static_cast<int64_t>(emb_table_size_)})
+            .data_type(opt_param.hyperparams.adam.half_state ? core23::ScalarType::Half
+                                                             : core23::ScalarType::Float);
+    auto m_tensor = core23::Tensor(params);
+    auto v_tensor = core23::Tensor(params);
+
+    HCTR_LIB_THROW(cudaMemset(m_tensor.data(), 0, m_tensor.num_bytes()));
+    HCTR_LIB_THROW(cudaMemset(v_tensor.data(), 0, v_tensor.num_bytes()));
+    core23::Tensor step_tensor;
+    if (opt_param.is_lazy_adam()) {
+      step_tensor = core23::Tensor(
+          params.shape({static_cast<int64_t>(h_num_key_per_table_offset_.back())})
+              .data_type(core23::ScalarType::Int32));
+      HCTR_LIB_THROW(cudaMemset(step_tensor.data(), 0, step_tensor.num_bytes()));
+    }
+    opt_buffer_ = AdamOptBuffer{m_tensor, v_tensor, step_tensor};
+  }
 
   for (size_t i = 0; i < h_table_ids_.size(); i++) {
     int table_id = h_table_ids_[i];
     std::function<void(const curandGenerator_t &)> init_table_functor;
+    size_t offset = h_emb_table_ev_offset_[i];
+    size_t num_elements = h_emb_table_ev_offset_[i + 1] - h_emb_table_ev_offset_[i];
+
+    // FP16 tables are initialized in FP32, and then rounded to nearest.
+    core23::Tensor init_buffer;
+    float *init_weights;
+    if (emb_table_.data_type() == core23::ScalarType::Half) {
+      core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+      init_buffer = core23::Tensor(core23::TensorParams()
+                                       .device(device)
+                                       .shape({static_cast<int64_t>(num_elements)})
+                                       .data_type(core23::ScalarType::Float));
+      init_weights = init_buffer.data<float>();
+    } else {
+      init_weights = emb_table_.data<float>() + offset;
+    }
 
     if (table_params[table_id].init_param.initializer_type == HugeCTR::Initializer_t::Default) {
       init_table_functor = [&](const curandGenerator_t &generator) {
         float up_bound = sqrt(1.f / h_table_max_vocabulary_size_[i]);
-        size_t offset = h_emb_table_ev_offset_[i];
-        size_t num_elements = h_emb_table_ev_offset_[i + 1] - h_emb_table_ev_offset_[i];
 
-        HugeCTR::UniformGenerator::fill(emb_table_.data<float>() + offset, num_elements, -up_bound,
+        HugeCTR::UniformGenerator::fill(init_weights, num_elements, -up_bound,
                                         up_bound, gpu_resource.get_sm_count(), generator,
                                         gpu_resource.get_stream());
       };
@@ -512,10 +892,8 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
                HugeCTR::Initializer_t::Uniform) {
       init_table_functor = [&](const curandGenerator_t &generator) {
         float up_bound = table_params[table_id].init_param.uniform_params.up_bound;
-        size_t offset = h_emb_table_ev_offset_[i];
-        size_t num_elements = h_emb_table_ev_offset_[i + 1] - h_emb_table_ev_offset_[i];
 
-        HugeCTR::UniformGenerator::fill(emb_table_.data<float>() + offset, num_elements, -up_bound,
+        HugeCTR::UniformGenerator::fill(init_weights, num_elements, -up_bound,
                                         up_bound, gpu_resource.get_sm_count(), generator,
                                         gpu_resource.get_stream());
       };
@@ -525,13 +903,11 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
         const SinusoidalParams &sinus_params = table_params[table_id].init_param.sinusoidal_params;
         int max_sequence_len = sinus_params.max_sequence_len;
         int ev_size = sinus_params.ev_size;
-        size_t offset = h_emb_table_ev_offset_[i];
-        size_t num_elements = h_emb_table_ev_offset_[i + 1] - h_emb_table_ev_offset_[i];
 
         HCTR_CHECK_HINT(max_sequence_len * ev_size == static_cast<int>(num_elements),
                         "max_sequent_len * ev_size ", max_sequence_len * ev_size,
                         " should equal to num_elements ", num_elements);
-        HugeCTR::SinusoidalGenerator::fill(emb_table_.data<float>() + offset, num_elements, ev_size,
+        HugeCTR::SinusoidalGenerator::fill(init_weights, num_elements, ev_size,
                                            max_sequence_len, gpu_resource.get_sm_count(),
                                            gpu_resource.get_stream());
       };
@@ -545,6 +921,11 @@ RaggedStaticEmbeddingTable::RaggedStaticEmbeddingTable(
     } else {
       init_table_functor(gpu_resource.get_replica_variant_curand_generator());
     }
+    if (emb_table_.data_type() == core23::ScalarType::Half) {
+      HugeCTR::convert_array_on_device(emb_table_.data<__half>() + offset, init_weights,
+                                       num_elements, gpu_resource.get_stream());
+      HCTR_LIB_THROW(cudaStreamSynchronize(gpu_resource.get_stream()));
+    }
   }
 }
 
@@ -557,6 +938,10 @@ void RaggedStaticEmbeddingTable::lookup(const core23::Tensor &keys, size_t num_k
   cudaStream_t stream = core_->get_local_gpu()->get_stream();
 
   if (num_keys == 0) return;
+  if (emb_table_.data_type() == core23::ScalarType::Half) {
+    lookup_half(keys, num_keys, id_space_offset, num_id_space_offset, id_space_list, emb_vec);
+    return;
+  }
   DISPATCH_INTEGRAL_FUNCTION_CORE23(keys.data_type().type(), key_t, [&] {
     DISPATCH_INTEGRAL_FUNCTION_CORE23(id_space_offset.data_type().type(), offset_t, [&] {
       DISPATCH_INTEGRAL_FUNCTION_CORE23(num_key_per_table_offset_.data_type().type(), index_t, [&] {
@@ -575,6 +960,48 @@ void RaggedStaticEmbeddingTable::lookup(const core23::Tensor &keys, size_t num_k
   });
 }
 
+void RaggedStaticEmbeddingTable::lookup_half(const core23::Tensor &keys, size_t num_keys,
+                                             const core23::Tensor &id_space_offset,
+                                             size_t num_id_space_offset,
+                                             const core23::Tensor &id_space_list,
+                                             core23::Tensor &emb_vec) {
+  cudaStream_t stream = core_->get_local_gpu()->get_stream();
+
+  // Rows are padded to 4 floats, for the vectorized loads of the lookup results.
+  const int stride = HugeCTR::alignTo(max_ev_size_, num_load_floats);
+  const int64_t num_elements = static_cast<int64_t>(num_keys) * stride;
+  core23::Tensor &lookup_buffer = lookup_buffers_[stream];
+  if (lookup_buffer.empty() || lookup_buffer.num_elements() < num_elements) {
+    // The previous buffer may still be read by earlier work of the stream.
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+    lookup_buffer = core23::Tensor(core23::TensorParams()
+                                       .device(device)
+                                       .shape({num_elements})
+                                       .data_type(core23::ScalarType::Float));
+  }
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(keys.data_type().type(), key_t, [&] {
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(id_space_offset.data_type().type(), offset_t, [&] {
+      DISPATCH_INTEGRAL_FUNCTION_CORE23(num_key_per_table_offset_.data_type().type(), index_t, [&] {
+        constexpr int block_size = 256;
+        const auto &kernel_param = core_->get_kernel_param();
+        const int grid_size = std::min(
+            HugeCTR::ceildiv(static_cast<int>(num_keys), block_size / 32),
+            HugeCTR::ceildiv(kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size));
+        ragged_static_embedding_table_lookup_half_kernel<<<grid_size, block_size, 0, stream>>>(
+            keys.data<key_t>(), num_keys, id_space_offset.data<offset_t>(), num_id_space_offset,
+            id_space_list.data<int>(), table_ids_.data<int>(), table_ids_.num_elements(),
+            num_key_per_table_offset_.data<index_t>(), emb_table_.data<__half>(),
+            emb_table_ev_offset_.data<uint64_t>(), local_ev_size_list_.data<int>(), stride,
+            lookup_buffer.data<float>(), static_cast<float **>(emb_vec.data()));
+
+        HCTR_LIB_THROW(cudaPeekAtLastError());
+      });
+    });
+  });
+}
+
 void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
                                         const core23::Tensor &num_unique_keys,
                                         const core23::Tensor &table_ids,
@@ -589,6 +1016,8 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
   HCTR_CHECK(num_unique_keys.data_type() == core23::ScalarType::UInt64);
   HCTR_CHECK(table_ids.data_type() == core23::ScalarType::Int32);
   HCTR_CHECK(ev_start_indices.data_type() == core23::ScalarType::UInt32);
+  const uint32_t seed = ++num_updates_;
+  const float lr = lr_ptr_ ? 1.f : opt_param_.lr;
 
   if (opt_param_.optimizer == HugeCTR::Optimizer_t::SGD) {
     DISPATCH_INTEGRAL_FUNCTION_CORE23(unique_keys.data_type().type(), key_t, [&] {
@@ -607,15 +1036,10 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
           const auto &kernel_param = core_->get_kernel_param();
           const int grid_size =
               HugeCTR::ceildiv(kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size);
-          auto kernel = use_vectorized_kernel_
-                            ? update4_kernel<key_t, index_t, wgrad_t, decltype(optimizer),
-                                             decltype(key_to_indices_func)>
-                            : update_kernel<key_t, index_t, wgrad_t, decltype(optimizer),
-                                            decltype(key_to_indices_func)>;
-          kernel<<<grid_size, block_size, 0, stream>>>(
-              unique_keys.data<key_t>(), num_unique_keys.data<size_t>(), table_ids.data<int>(),
-              wgrad.data<wgrad_t>(), ev_start_indices.data<uint32_t>(), key_to_indices_func,
-              emb_table_.data<float>(), optimizer, opt_param_.lr, opt_param_.scaler);
+          launch_update_kernel<key_t, index_t, wgrad_t>(
+              unique_keys, num_unique_keys, table_ids, wgrad, ev_start_indices, key_to_indices_func,
+              emb_table_, optimizer, lr, lr_ptr_, opt_param_.scaler, seed, use_vectorized_kernel_,
+              grid_size, block_size, stream);
         });
       });
     });
@@ -642,16 +1066,24 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
                 const auto &kernel_param = core_->get_kernel_param();
                 const int grid_size = HugeCTR::ceildiv(
                     kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size);
-                auto kernel = use_vectorized_kernel_
-                                  ? update4_kernel<key_t, index_t, wgrad_t, decltype(optimizer),
-                                                   decltype(key_to_indices_func)>
-                                  : update_kernel<key_t, index_t, wgrad_t, decltype(optimizer),
-                                                  decltype(key_to_indices_func)>;
-                kernel<<<grid_size, block_size, 0, stream>>>(
-                    unique_keys.data<key_t>(), num_unique_keys.data<size_t>(),
-                    table_ids.data<int>(), wgrad.data<wgrad_t>(), ev_start_indices.data<uint32_t>(),
-                    key_to_indices_func, emb_table_.data<float>(), optimizer, opt_param_.lr,
-                    opt_param_.scaler);
+                if (opt_param_.hyperparams.adagrad.row_wise) {
+                  DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(
+                      emb_table_.data_type().type(), table_t, [&] {
+                        row_wise_adagrad_update_kernel<<<grid_size, block_size, 0, stream>>>(
+                            unique_keys.data<key_t>(), num_unique_keys.data<size_t>(),
+                            table_ids.data<int>(), wgrad.data<wgrad_t>(),
+                            ev_start_indices.data<uint32_t>(), key_to_indices_func,
+                            emb_table_.data<table_t>(),
+                            adagrad_opt_buffer->opt_accum_tensor.data<float>(),
+                            opt_param_.hyperparams.adagrad.epsilon, lr, lr_ptr_,
+                            opt_param_.scaler, seed);
+                      });
+                  return;
+                }
+                launch_update_kernel<key_t, index_t, wgrad_t>(
+                    unique_keys, num_unique_keys, table_ids, wgrad, ev_start_indices,
+                    key_to_indices_func, emb_table_, optimizer, lr, lr_ptr_, opt_param_.scaler,
+                    seed, use_vectorized_kernel_, grid_size, block_size, stream);
               });
         });
       });
@@ -680,16 +1112,61 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
                 const auto &kernel_param = core_->get_kernel_param();
                 const int grid_size = HugeCTR::ceildiv(
                     kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size);
-                auto kernel = use_vectorized_kernel_
-                                  ? update4_kernel<key_t, index_t, wgrad_t, decltype(optimizer),
-                                                   decltype(key_to_indices_func)>
-                                  : update_kernel<key_t, index_t, wgrad_t, decltype(optimizer),
-                                                  decltype(key_to_indices_func)>;
-                kernel<<<grid_size, block_size, 0, stream>>>(
-                    unique_keys.data<key_t>(), num_unique_keys.data<size_t>(),
-                    table_ids.data<int>(), wgrad.data<wgrad_t>(), ev_start_indices.data<uint32_t>(),
-                    key_to_indices_func, emb_table_.data<float>(), optimizer, opt_param_.lr,
-                    opt_param_.scaler);
+                launch_update_kernel<key_t, index_t, wgrad_t>(
+                    unique_keys, num_unique_keys, table_ids, wgrad, ev_start_indices,
+                    key_to_indices_func, emb_table_, optimizer, lr, lr_ptr_, opt_param_.scaler,
+                    seed, use_vectorized_kernel_, grid_size, block_size, stream);
+              });
+        });
+      });
+    });
+  } else if (opt_param_.optimizer == HugeCTR::Optimizer_t::Adam) {
+    ++opt_param_.hyperparams.adam.times;
+    const float bias = opt_param_.hyperparams.adam.bias();
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(unique_keys.data_type().type(), key_t, [&] {
+      DISPATCH_INTEGRAL_FUNCTION_CORE23(num_key_per_table_offset_.data_type().type(), index_t, [&] {
+        DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(wgrad.data_type().type(), wgrad_t, [&] {
+          auto adam_opt_buffer = std::get_if<AdamOptBuffer>(&opt_buffer_);
+          HCTR_CHECK_HINT(adam_opt_buffer != nullptr, "Adam Opt Buffer not initialized.");
+          DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(
+              adam_opt_buffer->opt_m_tensor.data_type().type(), opt_t, [&] {
+                RaggedKeyToIndicesFunc<key_t, index_t> key_to_indices_func{
+                    table_ids_.data<int>(),
+                    local_ev_size_list_.data<int>(),
+                    table_ids_.num_elements(),
+                    num_key_per_table_offset_.data<index_t>(),
+                    emb_table_ev_offset_.data<uint64_t>(),
+                };
+                AdamOptimizer<wgrad_t, opt_t> optimizer{
+                    adam_opt_buffer->opt_m_tensor.data<opt_t>(),
+                    adam_opt_buffer->opt_v_tensor.data<opt_t>(), opt_param_.hyperparams.adam.beta1,
+                    opt_param_.hyperparams.adam.beta2, opt_param_.hyperparams.adam.epsilon, bias};
+
+                constexpr int block_size = 256;
+                const auto &kernel_param = core_->get_kernel_param();
+                const int grid_size = HugeCTR::ceildiv(
+                    kernel_param.num_sms * kernel_param.max_thread_per_sm, block_size);
+                if (opt_param_.is_lazy_adam()) {
+                  DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(
+                      emb_table_.data_type().type(), table_t, [&] {
+                        lazy_adam_update_kernel<<<grid_size, block_size, 0, stream>>>(
+                            unique_keys.data<key_t>(), num_unique_keys.data<size_t>(),
+                            table_ids.data<int>(), wgrad.data<wgrad_t>(),
+                            ev_start_indices.data<uint32_t>(), key_to_indices_func,
+                            emb_table_.data<table_t>(), adam_opt_buffer->opt_m_tensor.data<opt_t>(),
+                            adam_opt_buffer->opt_v_tensor.data<opt_t>(),
+                            adam_opt_buffer->opt_step_tensor.data<int>(),
+                            static_cast<int>(opt_param_.hyperparams.adam.times),
+                            opt_param_.hyperparams.adam.beta1, opt_param_.hyperparams.adam.beta2,
+                            opt_param_.hyperparams.adam.epsilon, bias, lr, lr_ptr_,
+                            opt_param_.scaler, seed);
+                      });
+                  return;
+                }
+                launch_update_kernel<key_t, index_t, wgrad_t>(
+                    unique_keys, num_unique_keys, table_ids, wgrad, ev_start_indices,
+                    key_to_indices_func, emb_table_, optimizer, lr, lr_ptr_, opt_param_.scaler,
+                    seed, use_vectorized_kernel_, grid_size, block_size, stream);
               });
         });
       });
@@ -698,4 +1175,91 @@ void RaggedStaticEmbeddingTable::update(const core23::Tensor &unique_keys,
     HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "optimizer not implemented");
   }
 }
+
+bool RaggedStaticEmbeddingTable::support_fused_update() const {
+  // Row-wise AdaGrad reduces over the whole row before its update, and lazy Adam updates the step
+  // counter of the row.
+  return opt_param_.optimizer == HugeCTR::Optimizer_t::SGD ||
+         (opt_param_.optimizer == HugeCTR::Optimizer_t::AdaGrad &&
+          !opt_param_.hyperparams.adagrad.row_wise) ||
+         opt_param_.optimizer == HugeCTR::Optimizer_t::Ftrl ||
+         (opt_param_.optimizer == HugeCTR::Optimizer_t::Adam && !opt_param_.is_lazy_adam());
+}
+
+void RaggedStaticEmbeddingTable::fused_update(const UnreducedWgrad &unreduced_wgrad,
+                                              Wgrad &wgrad) {
+  CudaDeviceContext context(core_->get_device_id());
+  auto stream = core_->get_local_gpu()->get_stream();
+  if (h_table_max_vocabulary_size_.empty() || unreduced_wgrad.num_elements == 0) return;
+
+  HCTR_CHECK_HINT(support_fused_update(), "optimizer not supported by fused_update");
+  HCTR_CHECK(wgrad.table_ids.data_type() == core23::ScalarType::Int32);
+  HCTR_CHECK(wgrad.ev_start_indices.data_type() == core23::ScalarType::UInt32);
+
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(wgrad.unique_keys.data_type().type(), key_t, [&] {
+    DISPATCH_INTEGRAL_FUNCTION_CORE23(num_key_per_table_offset_.data_type().type(), index_t, [&] {
+      RaggedKeyToIndicesFunc<key_t, index_t> key_to_indices_func{
+          table_ids_.data<int>(),
+          local_ev_size_list_.data<int>(),
+          table_ids_.num_elements(),
+          num_key_per_table_offset_.data<index_t>(),
+          emb_table_ev_offset_.data<uint64_t>(),
+      };
+      const uint32_t seed = ++num_updates_;
+      const float lr = lr_ptr_ ? 1.f : opt_param_.lr;
+      auto reduce_update = [&](auto optimizer) {
+        DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(emb_table_.data_type().type(), table_t, [&] {
+          FusedUpdateFunc<key_t, table_t, decltype(optimizer), decltype(key_to_indices_func)>
+              update_func{wgrad.unique_keys.data<key_t>(),
+                          wgrad.table_ids.data<int>(),
+                          key_to_indices_func,
+                          emb_table_.data<table_t>(),
+                          optimizer,
+                          lr,
+                          lr_ptr_,
+                          opt_param_.scaler,
+                          seed,
+                          use_vectorized_kernel_};
+          multi_to_one_reduce_update_v2(unreduced_wgrad, wgrad, update_func,
+                                        core_->get_kernel_param(), stream);
+        });
+      };
+
+      if (opt_param_.optimizer == HugeCTR::Optimizer_t::SGD) {
+        reduce_update(SGDOptimizer<float>{});
+      } else if (opt_param_.optimizer == HugeCTR::Optimizer_t::AdaGrad) {
+        auto adagrad_opt_buffer = std::get_if<AdaGradOptBuffer>(&opt_buffer_);
+        HCTR_CHECK_HINT(adagrad_opt_buffer != nullptr, "Adagrad Opt Buffer not initialized.");
+        DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(
+            adagrad_opt_buffer->opt_accum_tensor.data_type().type(), acc_t, [&] {
+              reduce_update(AdaGradOptimizer<float, acc_t>{
+                  adagrad_opt_buffer->opt_accum_tensor.data<acc_t>(),
+                  opt_param_.hyperparams.adagrad.epsilon});
+            });
+      } else if (opt_param_.optimizer == HugeCTR::Optimizer_t::Ftrl) {
+        auto ftrl_opt_buffer = std::get_if<FtrlOptBuffer>(&opt_buffer_);
+        HCTR_CHECK_HINT(ftrl_opt_buffer != nullptr, "Ftrl Opt Buffer not initialized.");
+        DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(
+            ftrl_opt_buffer->opt_z_tensor.data_type().type(), opt_t, [&] {
+              reduce_update(FtrlOptimizer<float, opt_t>{
+                  ftrl_opt_buffer->opt_z_tensor.data<opt_t>(),
+                  ftrl_opt_buffer->opt_n_tensor.data<opt_t>(), opt_param_.hyperparams.ftrl.beta,
+                  opt_param_.hyperparams.ftrl.lambda1, opt_param_.hyperparams.ftrl.lambda2});
+            });
+      } else if (opt_param_.optimizer == HugeCTR::Optimizer_t::Adam) {
+        auto adam_opt_buffer = std::get_if<AdamOptBuffer>(&opt_buffer_);
+        HCTR_CHECK_HINT(adam_opt_buffer != nullptr, "Adam Opt Buffer not initialized.");
+        ++opt_param_.hyperparams.adam.times;
+        DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(
+            adam_opt_buffer->opt_m_tensor.data_type().type(), opt_t, [&] {
+              reduce_update(AdamOptimizer<float, opt_t>{
+                  adam_opt_buffer->opt_m_tensor.data<opt_t>(),
+                  adam_opt_buffer->opt_v_tensor.data<opt_t>(), opt_param_.hyperparams.adam.beta1,
+                  opt_param_.hyperparams.adam.beta2, opt_param_.hyperparams.adam.epsilon,
+                  opt_param_.hyperparams.adam.bias()});
+            });
+      }
+    });
+  });
+}
 }  // namespace embedding
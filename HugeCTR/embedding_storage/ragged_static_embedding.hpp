@@ -17,23 +17,35 @@
 
 #include <core23/registry.hpp>
 #include <embedding_storage/embedding_table.hpp>
+#include <map>
 #include <variant>
 
 namespace embedding {
 using HugeCTR::CudaDeviceContext;
 
+// One accumulator per element, or per row with row-wise AdaGrad.
 struct AdaGradOptBuffer {
   core23::Tensor opt_accum_tensor;
 };
 
+// Lazy Adam also keeps the last step of each row, which is 0 before its first update.
+struct AdamOptBuffer {
+  core23::Tensor opt_m_tensor;
+  core23::Tensor opt_v_tensor;
+  core23::Tensor opt_step_tensor;
+};
+
 struct FtrlOptBuffer {
   core23::Tensor opt_z_tensor;
   core23::Tensor opt_n_tensor;
 };
 
-using OptBuffer = std::variant<AdaGradOptBuffer, FtrlOptBuffer>;
+using OptBuffer = std::variant<AdaGradOptBuffer, FtrlOptBuffer, AdamOptBuffer>;
 
 class RaggedStaticEmbeddingTable final : public IGroupedEmbeddingTable {
+  friend class HostCachedEmbeddingTable;
+  friend class CompositionalEmbeddingTable;
+
   std::shared_ptr<CoreResourceManager> core_;
 
   std::vector<size_t> h_num_key_per_table_;
@@ -49,20 +61,33 @@ class RaggedStaticEmbeddingTable final : public IGroupedEmbeddingTable {
   core23::Tensor keys_;
   core23::Tensor num_key_per_table_offset_;
 
-  core23::Tensor emb_table_;
+  core23::Tensor emb_table_;            // FP32, or FP16 with TableStorageType::FP16
   core23::Tensor emb_table_ev_offset_;  // num_local_id_space + 1
   core23::Tensor local_ev_size_list_;   // num_local_id_space
   bool use_vectorized_kernel_;
+  int max_ev_size_;
 
   HugeCTR::OptParams opt_param_;
+  // Learning rate on the gpu, which replaces opt_param_.lr if it is set.
+  const float *lr_ptr_ = nullptr;
   OptBuffer opt_buffer_;
 
+  // Seed of the stochastic rounding of FP16 weights. It is the same on all gpus.
+  uint32_t num_updates_;
+  // FP32 copies of the FP16 rows returned by lookup, one buffer per stream. A buffer is reused once
+  // the earlier work of its stream, which consumes the previous lookup, has completed.
+  std::map<cudaStream_t, core23::Tensor> lookup_buffers_;
+
+  void lookup_half(const core23::Tensor &keys, size_t num_keys,
+                   const core23::Tensor &id_space_offset, size_t num_id_space_offset,
+                   const core23::Tensor &id_space, core23::Tensor &embedding_vec);
+
  public:
   RaggedStaticEmbeddingTable(const HugeCTR::GPUResource &gpu_resource,
                              std::shared_ptr<CoreResourceManager> core,
                              const std::vector<EmbeddingTableParam> &table_params,
                              const EmbeddingCollectionParam &ebc_param, size_t grouped_id,
-                             const HugeCTR::OptParams &opt_param);
+                             const HugeCTR::OptParams &opt_param, bool host_resident = false);
 
   void lookup(const core23::Tensor &keys, size_t num_keys, const core23::Tensor &id_space_offset,
               size_t num_id_space_offset, const core23::Tensor &id_space,
@@ -72,6 +97,10 @@ class RaggedStaticEmbeddingTable final : public IGroupedEmbeddingTable {
               const core23::Tensor &table_ids, const core23::Tensor &ev_start_indices,
               const core23::Tensor &wgrad) override;
 
+  bool support_fused_update() const override;
+
+  void fused_update(const UnreducedWgrad &unreduced_wgrad, Wgrad &wgrad) override;
+
   void assign(const core23::Tensor &unique_key, size_t num_unique_key,
               const core23::Tensor &num_unique_key_per_table_offset, size_t num_table_offset,
               const core23::Tensor &table_id_list, core23::Tensor &embeding_vector,
@@ -108,6 +137,8 @@ class RaggedStaticEmbeddingTable final : public IGroupedEmbeddingTable {
   void clear() override;
 
   void set_learning_rate(float lr) override { opt_param_.lr = lr; }
+
+  void set_device_learning_rate(const float *lr_ptr) override { lr_ptr_ = lr_ptr; }
 };
 
 }  // namespace embedding
@@ -16,6 +16,7 @@
 
 #include <curand_kernel.h>
 
+#include <algorithm>
 #include <data_simulator.hpp>
 #include <embedding/operators/generic_lookup.cuh>
 #include <embedding/view.hpp>
@@ -25,12 +26,12 @@
 
 namespace embedding {
 
-template <typename key_t, typename index_t, typename emb_t>
+template <typename key_t, typename index_t, typename emb_t, typename table_t>
 __global__ void embedding_insert_kernel(
     const key_t *keys, size_t num_keys, const uint32_t *id_space_offset, size_t num_id_space_offset,
     const emb_t *embedding_vector, const uint32_t *embedding_vector_offset,
     const int *id_space_list, const int *local_id_space_list, size_t num_local_id_space_list,
-    const key_t *key_location, const index_t *emb_table_id_space_offset, float *emb_table,
+    const key_t *key_location, const index_t *emb_table_id_space_offset, table_t *emb_table,
     const uint64_t *emb_table_ev_offset, const int *local_ev_size_list) {
   uint32_t tid = threadIdx.x + blockIdx.x * blockDim.x;
   if (tid >= num_keys) return;
@@ -55,15 +56,16 @@ __global__ void embedding_insert_kernel(
   const emb_t *ev_for_insert = embedding_vector + embedding_vector_offset[tid];
   for (int i = 0; i < ev_size; ++i) {
     float ei = HugeCTR::TypeConvertFunc<float, emb_t>::convert(ev_for_insert[i]);
-    emb_table[ev_offset + idx * ev_size + i] = ei;
+    emb_table[ev_offset + idx * ev_size + i] =
+        HugeCTR::TypeConvertFunc<table_t, float>::convert(ei);
   }
 }
 
-template <typename key_t, typename index_t, typename emb_t>
+template <typename key_t, typename index_t, typename emb_t, typename table_t>
 __global__ void embedding_insert_by_tableindex_kernel(
-    const key_t *insert_keys, size_t num_keys, const key_t *keys_table,
+    const key_t *insert_keys, size_t num_keys, const key_t *keys_table, size_t num_table_keys,
     const index_t *num_key_per_table_offset, const emb_t *insert_embedding_values,
-    float *embedding_table, int table_index, size_t max_vocabulary_size,
+    table_t *embedding_table, int table_index, size_t max_vocabulary_size,
     const uint64_t *embedding_table_offsets, const int *table_ev_size_list) {
   uint32_t tid = threadIdx.x + blockIdx.x * blockDim.x;
   if (tid >= num_keys) return;
@@ -73,17 +75,17 @@ __global__ void embedding_insert_by_tableindex_kernel(
   assert(insert_key < max_vocabulary_size);
   assert(insert_key >= 0);
   index_t key_offset = num_key_per_table_offset[table_index];
-  uint64_t idx =
-      static_cast<uint64_t>(bs_upper_bound_sub_one(keys_table + key_offset, num_keys, insert_key));
+  uint64_t idx = static_cast<uint64_t>(
+      bs_upper_bound_sub_one(keys_table + key_offset, num_table_keys, insert_key));
   uint64_t embedding_value_offset = embedding_table_offsets[table_index];
-  float *tmp_embedding_table = embedding_table + embedding_value_offset;
+  table_t *tmp_embedding_table = embedding_table + embedding_value_offset;
   uint64_t input_offset = (uint64_t)tid * (uint64_t)embedding_vector_size;
   uint64_t output_offset = (uint64_t)idx * (uint64_t)embedding_vector_size;
 
   for (uint64_t i = 0; i < embedding_vector_size; ++i) {
     float ei =
         HugeCTR::TypeConvertFunc<float, emb_t>::convert(insert_embedding_values[input_offset + i]);
-    tmp_embedding_table[output_offset + i] = ei;
+    tmp_embedding_table[output_offset + i] = HugeCTR::TypeConvertFunc<table_t, float>::convert(ei);
   }
 }
 
@@ -100,7 +102,7 @@ void RaggedStaticEmbeddingTable::assign(const core23::Tensor &keys, size_t num_k
         num_key_per_table_offset_.data_type().type(), index_t, [&] {
           auto stream = core_->get_local_gpu()->get_stream();
 
-          {
+          DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(emb_table_.data_type().type(), table_t, [&] {
             constexpr int block_size = 256;
             int grid_size = (static_cast<int64_t>(num_keys) - 1) / block_size + 1;
             embedding_insert_kernel<<<grid_size, block_size, 0, stream>>>(
@@ -108,9 +110,9 @@ void RaggedStaticEmbeddingTable::assign(const core23::Tensor &keys, size_t num_k
                 num_table_offset, embeding_vector.data<float>(),
                 embedding_vector_offset.data<uint32_t>(), table_id_list.data<int>(),
                 table_ids_.data<int>(), table_ids_.num_elements(), keys_.data<key_t>(),
-                num_key_per_table_offset_.data<index_t>(), emb_table_.data<float>(),
+                num_key_per_table_offset_.data<index_t>(), emb_table_.data<table_t>(),
                 emb_table_ev_offset_.data<uint64_t>(), local_ev_size_list_.data<int>());
-          }
+          });
         });
   });
 }
@@ -130,8 +132,9 @@ void RaggedStaticEmbeddingTable::dump(core23::Tensor *keys, core23::Tensor *id_s
   *id_space_offset = core23::Tensor(params.shape({num_key_per_table_offset_.num_elements()})
                                         .data_type(num_key_per_table_offset_.data_type()));
 
-  *embedding_table =
-      core23::Tensor(params.shape({emb_table_.num_elements()}).data_type(emb_table_.data_type()));
+  // FP16 weights are dumped as FP32.
+  *embedding_table = core23::Tensor(
+      params.shape({emb_table_.num_elements()}).data_type(core23::ScalarType::Float));
 
   *ev_size_list = core23::Tensor(params.shape({local_ev_size_list_.num_elements()})
                                      .data_type(local_ev_size_list_.data_type()));
@@ -141,7 +144,14 @@ void RaggedStaticEmbeddingTable::dump(core23::Tensor *keys, core23::Tensor *id_s
 
   core23::copy_sync(*keys, keys_);
   core23::copy_sync(*id_space_offset, num_key_per_table_offset_);
-  core23::copy_sync(*embedding_table, emb_table_);
+  if (emb_table_.data_type() == core23::ScalarType::Half) {
+    std::vector<__half> h_emb_table(emb_table_.num_elements());
+    core23::copy_sync(h_emb_table, emb_table_);
+    std::transform(h_emb_table.begin(), h_emb_table.end(), embedding_table->data<float>(),
+                   [](const __half &w) { return __half2float(w); });
+  } else {
+    core23::copy_sync(*embedding_table, emb_table_);
+  }
   core23::copy_sync(*ev_size_list, local_ev_size_list_);
   core23::copy_sync(*id_space, table_ids_);
 }
@@ -162,14 +172,25 @@ void RaggedStaticEmbeddingTable::dump_by_id(core23::Tensor *h_keys_tensor,
     d_keys += h_num_key_per_table_offset_[table_index];
     key_t *h_keys = (key_t *)h_keys_tensor->data();
     HCTR_LIB_THROW(cudaMemcpy(h_keys, d_keys, sizeof(key_t) * h_num_key_per_table_[table_index],
-                              cudaMemcpyDeviceToHost));
+                              cudaMemcpyDefault));
 
-    float *d_embedding_vector = (float *)emb_table_.data();
-    d_embedding_vector += h_emb_table_ev_offset_[table_index];
     float *h_embedding_vector = (float *)h_embedding_table->data();
-    HCTR_LIB_THROW(cudaMemcpy(h_embedding_vector, d_embedding_vector,
-                              sizeof(float) * h_size_per_table_[table_index],
-                              cudaMemcpyDeviceToHost));
+    if (emb_table_.data_type() == core23::ScalarType::Half) {
+      const __half *d_embedding_vector =
+          emb_table_.data<__half>() + h_emb_table_ev_offset_[table_index];
+      std::vector<__half> h_half_embedding_vector(h_size_per_table_[table_index]);
+      HCTR_LIB_THROW(cudaMemcpy(h_half_embedding_vector.data(), d_embedding_vector,
+                                sizeof(__half) * h_size_per_table_[table_index],
+                                cudaMemcpyDefault));
+      std::transform(h_half_embedding_vector.begin(), h_half_embedding_vector.end(),
+                     h_embedding_vector, [](const __half &w) { return __half2float(w); });
+    } else {
+      float *d_embedding_vector = (float *)emb_table_.data();
+      d_embedding_vector += h_emb_table_ev_offset_[table_index];
+      HCTR_LIB_THROW(cudaMemcpy(h_embedding_vector, d_embedding_vector,
+                                sizeof(float) * h_size_per_table_[table_index],
+                                cudaMemcpyDefault));
+    }
   });
 }
 
@@ -202,16 +223,16 @@ void RaggedStaticEmbeddingTable::load_by_id(core23::Tensor *h_keys_tensor,
           size_t num_keys = h_keys_tensor->num_elements();
           size_t table_keys = h_num_key_per_table_[table_index];
 
-          {
+          DISPATCH_FLOAT_AND_HALF_FUNCTION_CORE23(emb_table_.data_type().type(), table_t, [&] {
             constexpr int block_size = 256;
             int grid_size =
                 (static_cast<int64_t>(h_keys_tensor->num_elements()) - 1) / block_size + 1;
             embedding_insert_by_tableindex_kernel<<<grid_size, block_size>>>(
-                (key_t *)d_keys.data(), num_keys, keys_.data<key_t>(),
+                (key_t *)d_keys.data(), num_keys, keys_.data<key_t>(), table_keys,
                 num_key_per_table_offset_.data<index_t>(), (float *)d_embedding_vector.data(),
-                emb_table_.data<float>(), table_index, max_vocabulary_size,
+                emb_table_.data<table_t>(), table_index, max_vocabulary_size,
                 emb_table_ev_offset_.data<uint64_t>(), local_ev_size_list_.data<int>());
-          }
+          });
         });
   });
 }
@@ -166,6 +166,7 @@ struct EmbeddingParameterInfo {
   std::unordered_map<int, size_t> table_key_nums;  // store all table's key numbers
   std::unordered_map<int, size_t>
       table_embedding_vector_lengths;  // store all table's embedding vector lengths
+  int num_manifests = 0;  // ranks that listed their chunks of the tables, 0 for one file per table
 
   // only for train dump,other parts don't need this variable
   int embedding_collection_id = 0;
@@ -14,7 +14,11 @@
  * limitations under the License.
  */
 
+#include <deque>
 #include <embedding_storage/weight_io/parameter_IO.hpp>
+#include <future>
+#include <numeric>
+#include <unordered_set>
 
 using namespace HugeCTR;
 namespace embedding {
@@ -66,6 +70,7 @@ void EmbeddingParameterIO::load_metadata(const std::string& parameters_folder_pa
   } else if (buffer_head[2] == 1) {
     epi.embedding_value_type = core23::ScalarType::Half;
   }
+  epi.num_manifests = buffer_head[3];
   epi.max_embedding_vector_length = buffer_head[4];
 
   for (int i = 0; i < epi.table_nums; ++i) {
@@ -95,6 +100,11 @@ void EmbeddingParameterIO::get_parameter_info_from_model(
   for (int i = 0; i < collections_num; ++i) {
     EmbeddingCollectionParam tmp_ebc_param = embedding_collections_[i]->ebc_param_;
     std::vector<std::vector<int>> tmp_shard_matrix = tmp_ebc_param.shard_matrix;
+    for (const auto& grouped_table_param : tmp_ebc_param.grouped_table_params) {
+      HCTR_CHECK_HINT(grouped_table_param.column_shard_id < 0,
+                      "embedding collections with column-wise sharded tables cannot be dumped or "
+                      "loaded yet.");
+    }
     struct EmbeddingParameterInfo tmp_epi;
     tmp_epi.embedding_collection_id = i;
     tmp_epi.table_nums = tmp_ebc_param.num_table;
@@ -178,11 +188,13 @@ void EmbeddingParameterIO::get_parameter_info_from_model(
 
 void EmbeddingParameterIO::dump_metadata(const std::string& parameters_folder_path,
                                          const struct EmbeddingParameterInfo& epi,
-                                         const std::vector<int>& table_ids) {
+                                         const std::vector<int>& table_ids, int num_manifests) {
   int myrank = resource_manager_->get_process_id();
   // for now we can write binary first , we can change it to HDF5 in future;
   auto file_system = get_fs_object(parameters_folder_path, SparseFSType::FS);
-  file_system->delete_dir(parameters_folder_path);
+  if (num_manifests == 0) {
+    file_system->delete_dir(parameters_folder_path);
+  }
   file_system->make_dir(parameters_folder_path);
   std::string ebc_path = parameters_folder_path + "/embedding_collection_" +
                          std::to_string(epi.embedding_collection_id);
@@ -230,6 +242,7 @@ void EmbeddingParameterIO::dump_metadata(const std::string& parameters_folder_pa
   } else if (epi.embedding_value_type.type() == core23::ScalarType::Half) {
     buffer_head[2] = 1;
   }
+  buffer_head[3] = num_manifests;
 
   int start_index = 5;
   for (auto table_id : table_ids_update) {
@@ -445,6 +458,214 @@ void EmbeddingParameterIO::dump_embedding_weight(const std::string& parameters_f
   });
 }
 
+bool EmbeddingParameterIO::begin_sharded_dump(const std::string& parameters_folder_path,
+                                              bool incremental, HugeCTR::CompressionCodec codec) {
+  const bool delta = checkpoint_writer_.begin(parameters_folder_path, incremental);
+  checkpoint_writer_.set_compression(codec);
+  if (!delta) {
+    if (resource_manager_->get_process_id() == 0) {
+      get_fs_object(parameters_folder_path, SparseFSType::FS)->delete_dir(parameters_folder_path);
+    }
+#ifdef ENABLE_MPI
+    HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
+#endif
+  }
+  return delta;
+}
+
+size_t EmbeddingParameterIO::dump_local_rows_(const struct EmbeddingParameterInfo& epi,
+                                              int table_id, std::vector<char>& keys,
+                                              std::vector<float>& weights,
+                                              uint32_t min_lookup_count,
+                                              uint32_t max_idle_iterations) {
+  EmbeddingCollection* tmp_ebc = embedding_collections_[epi.embedding_collection_id];
+  auto& group_embedding_tables = tmp_ebc->embedding_tables_;
+  int group_index = -1;
+  for (int group_id = 0; group_id < group_embedding_tables[0].size(); ++group_id) {
+    const auto& group_table_ids = tmp_ebc->ebc_param_.grouped_table_params[group_id].table_ids;
+    if (std::find(group_table_ids.begin(), group_table_ids.end(), table_id) !=
+        group_table_ids.end()) {
+      group_index = group_id;
+      break;
+    }
+  }
+  if (group_index == -1) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError, "can't find table id in any grouped tables");
+  }
+
+  std::vector<int> local_gpu_ids;
+  int parallel_mode = epi.gemb_distribution->get_parallel(table_id);
+  if (parallel_mode == 1) {
+    // Every GPU holds the whole table, so the first GPU of the first rank writes it.
+    if (resource_manager_->get_process_id() == 0) {
+      local_gpu_ids.push_back(0);
+    }
+  } else if (parallel_mode == 2) {
+    for (int local_gpu_id = 0; local_gpu_id < core_list_.size(); ++local_gpu_id) {
+      local_gpu_ids.push_back(local_gpu_id);
+    }
+  } else {
+    HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError,
+                   "For now , 3G embedding don't support this parallel model");
+  }
+
+  const size_t key_bytes = epi.key_type.size();
+  const size_t ev_length = epi.table_embedding_vector_lengths.at(table_id);
+  keys.clear();
+  weights.clear();
+  for (int local_gpu_id : local_gpu_ids) {
+    HugeCTR::CudaDeviceContext context(core_list_[local_gpu_id]->get_device_id());
+    int global_gpu_id = core_list_[local_gpu_id]->get_global_gpu_id();
+    size_t num_keys = epi.gemb_distribution->get(global_gpu_id, table_id);
+    if (num_keys == 0) continue;
+
+    core23::Device device(core23::DeviceType::CPU);
+    core23::TensorParams params = core23::TensorParams().device(device);
+    core23::Tensor key_tensor_tmp{
+        params.shape({static_cast<int64_t>(num_keys)}).data_type(epi.key_type)};
+    core23::Tensor weight_tensor_tmp{params.shape({static_cast<int64_t>(num_keys * ev_length)})
+                                         .data_type(epi.embedding_value_type)};
+    num_keys = group_embedding_tables[local_gpu_id][group_index]->dump_pruned_by_id(
+        &key_tensor_tmp, &weight_tensor_tmp, table_id, min_lookup_count, max_idle_iterations);
+    const char* key_ptr = static_cast<const char*>(key_tensor_tmp.data());
+    const float* weight_ptr = weight_tensor_tmp.data<float>();
+    keys.insert(keys.end(), key_ptr, key_ptr + num_keys * key_bytes);
+    weights.insert(weights.end(), weight_ptr, weight_ptr + num_keys * ev_length);
+  }
+  return keys.size() / key_bytes;
+}
+
+void EmbeddingParameterIO::dump_embedding_weight_sharded(const std::string& parameters_folder_path,
+                                                         struct EmbeddingParameterInfo& epi,
+                                                         const std::vector<int>& table_ids,
+                                                         int num_threads) {
+  int myrank = resource_manager_->get_process_id();
+  std::string ebc_path = parameters_folder_path + "/embedding_collection_" +
+                         std::to_string(epi.embedding_collection_id);
+  auto file_system = HugeCTR::FileSystemBuilder::build_unique_by_path(ebc_path);
+  file_system->create_dir(ebc_path);
+
+  std::vector<int> table_ids_update = table_ids;
+  if (table_ids_update.empty()) {
+    for (int table_id = 0; table_id < epi.table_nums; ++table_id) {
+      table_ids_update.push_back(table_id);
+    }
+  }
+
+  std::vector<char> keys;
+  std::vector<float> weights;
+  for (int table_id : table_ids_update) {
+    if (table_id < 0 || table_id >= epi.table_nums) {
+      HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError, "Input table id is out of range");
+    }
+    size_t num_keys = dump_local_rows_(epi, table_id, keys, weights);
+    checkpoint_writer_.write_table(ebc_path, epi.embedding_collection_id, table_id, myrank,
+                                   keys.data(), epi.key_type.size(), weights.data(),
+                                   epi.table_embedding_vector_lengths.at(table_id), num_keys,
+                                   num_threads);
+  }
+  checkpoint_writer_.write_manifest(ebc_path, epi.embedding_collection_id, myrank);
+}
+
+size_t EmbeddingParameterIO::export_sparse_model(const std::string& sparse_model_path,
+                                                 const struct EmbeddingParameterInfo& epi,
+                                                 int table_id, uint32_t min_lookup_count,
+                                                 uint32_t max_idle_iterations,
+                                                 HugeCTR::CompressionCodec codec) {
+  if (table_id < 0 || table_id >= epi.table_nums) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError, "Input table id is out of range");
+  }
+  const int nrank = resource_manager_->get_num_process();
+  const int myrank = resource_manager_->get_process_id();
+  if (myrank == 0) {
+    auto file_system = get_fs_object(sparse_model_path, SparseFSType::FS);
+    file_system->delete_dir(sparse_model_path);
+    file_system->make_dir(sparse_model_path);
+  }
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
+#endif
+
+  std::vector<char> keys;
+  std::vector<float> weights;
+  const size_t num_keys =
+      dump_local_rows_(epi, table_id, keys, weights, min_lookup_count, max_idle_iterations);
+  // The HPS reads int64 keys, whatever the key type of the model.
+  std::vector<long long> hps_keys(num_keys);
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(epi.key_type.type(), key_t, [&] {
+    const key_t* key_ptr = reinterpret_cast<const key_t*>(keys.data());
+    std::transform(key_ptr, key_ptr + num_keys, hps_keys.begin(),
+                   [](key_t key) { return static_cast<long long>(key); });
+  });
+
+  std::vector<size_t> offset_per_rank(nrank, 0);
+  offset_per_rank[myrank] = num_keys;
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(MPI_Allgather(&num_keys, 1, MPI_SIZE_T, offset_per_rank.data(), 1, MPI_SIZE_T,
+                               MPI_COMM_WORLD));
+#endif
+  const size_t num_total_keys =
+      std::accumulate(offset_per_rank.begin(), offset_per_rank.end(), size_t{0});
+  std::exclusive_scan(offset_per_rank.begin(), offset_per_rank.end(), offset_per_rank.begin(),
+                      size_t{0});
+
+  const size_t ev_length = epi.table_embedding_vector_lengths.at(table_id);
+  const size_t key_offset = offset_per_rank[myrank];
+  auto file_system = get_fs_object(sparse_model_path);
+  file_system->write_to(sparse_model_path + "/key", hps_keys.data(), key_offset * sizeof(long long),
+                        num_keys * sizeof(long long), false);
+  if (codec == HugeCTR::CompressionCodec::None) {
+    file_system->write_to(sparse_model_path + "/emb_vector", weights.data(),
+                          key_offset * ev_length * sizeof(float), weights.size() * sizeof(float),
+                          false);
+    return num_total_keys;
+  }
+
+  // Every rank needs the page index of all ranks to place its pages after the file head, which the
+  // first rank writes.
+  std::vector<HugeCTR::CompressedPages> parts(nrank);
+  parts[myrank] = HugeCTR::compress_pages(weights.data(), weights.size() * sizeof(float), codec);
+  std::vector<int> num_pages_per_rank(nrank, 0);
+  num_pages_per_rank[myrank] = parts[myrank].uncompressed_bytes.size();
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(MPI_Allgather(&num_pages_per_rank[myrank], 1, MPI_INT, num_pages_per_rank.data(),
+                               1, MPI_INT, MPI_COMM_WORLD));
+  std::vector<int> page_offset_per_rank(nrank, 0);
+  std::exclusive_scan(num_pages_per_rank.begin(), num_pages_per_rank.end(),
+                      page_offset_per_rank.begin(), 0);
+  const int num_total_pages = page_offset_per_rank.back() + num_pages_per_rank.back();
+  std::vector<uint64_t> uncompressed_bytes(num_total_pages), compressed_bytes(num_total_pages);
+  HCTR_MPI_THROW(MPI_Allgatherv(parts[myrank].uncompressed_bytes.data(), num_pages_per_rank[myrank],
+                                MPI_UINT64_T, uncompressed_bytes.data(), num_pages_per_rank.data(),
+                                page_offset_per_rank.data(), MPI_UINT64_T, MPI_COMM_WORLD));
+  HCTR_MPI_THROW(MPI_Allgatherv(parts[myrank].compressed_bytes.data(), num_pages_per_rank[myrank],
+                                MPI_UINT64_T, compressed_bytes.data(), num_pages_per_rank.data(),
+                                page_offset_per_rank.data(), MPI_UINT64_T, MPI_COMM_WORLD));
+  for (int rank = 0; rank < nrank; ++rank) {
+    if (rank == myrank) continue;
+    parts[rank].codec = codec;
+    auto first = page_offset_per_rank[rank], last = first + num_pages_per_rank[rank];
+    parts[rank].uncompressed_bytes.assign(uncompressed_bytes.begin() + first,
+                                          uncompressed_bytes.begin() + last);
+    parts[rank].compressed_bytes.assign(compressed_bytes.begin() + first,
+                                        compressed_bytes.begin() + last);
+  }
+#endif
+  const std::vector<char> head = HugeCTR::get_compressed_file_head(parts);
+  size_t data_offset = head.size();
+  for (int rank = 0; rank < myrank; ++rank) {
+    data_offset += HugeCTR::get_compressed_file_bytes(parts[rank]);
+  }
+  const std::string vector_path =
+      sparse_model_path + "/emb_vector" + HugeCTR::get_compressed_file_suffix(codec);
+  if (myrank == 0) {
+    file_system->write_to(vector_path, head.data(), 0, head.size(), false);
+  }
+  file_system->write_to(vector_path, parts[myrank].data.data(), data_offset,
+                        parts[myrank].data.size(), false);
+  return num_total_keys;
+}
+
 void EmbeddingParameterIO::dump_opt_state(const std::string& parameters_folder_path,
                                           struct EmbeddingParameterInfo& epi,
                                           const std::vector<int>& table_ids) {
@@ -475,6 +696,11 @@ void EmbeddingParameterIO::load_embedding_weight(
     core23::Tensor& embedding_weights, embeddingFilter key_select,
     std::shared_ptr<core::CoreResourceManager> core_resource,
     const core23::DataType& target_key_type, const core23::DataType& target_value_type) {
+  if (epi.num_manifests > 0) {
+    load_sharded_embedding_weight_(epi, fs_table_id, keys, embedding_weights, key_select,
+                                   target_key_type, target_value_type);
+    return;
+  }
   auto file_system = get_fs_object(epi.parameter_folder_path, SparseFSType::FS);
   std::string ebc_path = epi.parameter_folder_path + "/embedding_collection_" +
                          std::to_string(epi.embedding_collection_id);
@@ -521,7 +747,7 @@ void EmbeddingParameterIO::load_embedding_weight(
     float* weight_tensor_ptr = weight_tensor_tmp.data<float>();
     float* embedding_weights_ptr = embedding_weights.data<float>();
 
-    file_system->read_from(ebc_weight_path, weight_tensor_ptr, key_num * ev_length * sizeof(key_t),
+    file_system->read_from(ebc_weight_path, weight_tensor_ptr, key_num * ev_length * sizeof(float),
                            FileHeadNbytes);
     size_t tmp_target_key_offset = 0;
     // TODO::need use openmp optimize
@@ -540,6 +766,269 @@ void EmbeddingParameterIO::load_embedding_weight(
   });
 }
 
+void EmbeddingParameterIO::load_sharded_embedding_weight_(
+    const struct EmbeddingParameterInfo& epi, int fs_table_id, core23::Tensor& keys,
+    core23::Tensor& embedding_weights, embeddingFilter key_select,
+    const core23::DataType& target_key_type, const core23::DataType& target_value_type) {
+  auto chunks = read_checkpoint_chunks(epi.parameter_folder_path, epi.num_manifests, fs_table_id);
+  auto file_system = HugeCTR::FileSystemBuilder::build_unique_by_path(epi.parameter_folder_path);
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(epi.key_type.type(), key_t, [&] {
+    size_t ev_length = epi.table_embedding_vector_lengths.at(fs_table_id);
+    size_t key_num = 0;
+    for (const auto& chunk : chunks) {
+      key_num += chunk.num_keys;
+    }
+    std::vector<key_t> file_keys(key_num);
+    std::vector<float> file_weights(key_num * ev_length);
+    size_t offset = 0;
+    for (const auto& chunk : chunks) {
+      file_system->read(epi.parameter_folder_path + "/" + chunk.key_file, &file_keys[offset],
+                        chunk.num_keys * sizeof(key_t), 0);
+      const std::string weight_path = epi.parameter_folder_path + "/" + chunk.weight_file;
+      const size_t weight_bytes = chunk.num_keys * ev_length * sizeof(float);
+      if (HugeCTR::get_file_compression_codec(weight_path) == HugeCTR::CompressionCodec::None) {
+        file_system->read(weight_path, &file_weights[offset * ev_length], weight_bytes, 0);
+      } else {
+        HugeCTR::CompressedFileReader(*file_system, weight_path)
+            .read(*file_system, &file_weights[offset * ev_length], weight_bytes, 0);
+      }
+      offset += chunk.num_keys;
+    }
+
+    // Deltas are listed after the chunks they update, so the last row of each key is loaded.
+    std::vector<size_t> target_rows;
+    std::unordered_set<key_t> loaded_keys;
+    for (size_t i = key_num; i-- > 0;) {
+      if (key_select((size_t)file_keys[i]) && loaded_keys.insert(file_keys[i]).second) {
+        target_rows.push_back(i);
+      }
+    }
+
+    core23::Device device(core23::DeviceType::CPU);
+    core23::TensorParams params = core23::TensorParams().device(device);
+    keys = core23::Tensor(
+        params.shape({static_cast<int64_t>(target_rows.size())}).data_type(target_key_type));
+    embedding_weights =
+        core23::Tensor(params.shape({static_cast<int64_t>(target_rows.size() * ev_length)})
+                           .data_type(target_value_type));
+    key_t* keys_ptr = keys.data<key_t>();
+    float* embedding_weights_ptr = embedding_weights.data<float>();
+    for (size_t i = 0; i < target_rows.size(); ++i) {
+      keys_ptr[i] = file_keys[target_rows[i]];
+      memcpy(embedding_weights_ptr + i * ev_length, &file_weights[target_rows[i] * ev_length],
+             ev_length * sizeof(float));
+    }
+  });
+}
+
+void EmbeddingParameterIO::load_embedding_table(const struct EmbeddingParameterInfo& epi,
+                                                int fs_table_id, int ebc_id, int model_table_id,
+                                                int num_threads, size_t chunk_bytes) {
+  EmbeddingCollection* tmp_ebc = embedding_collections_.at(ebc_id);
+  auto& tmp_ebc_param = tmp_ebc->ebc_param_;
+  HCTR_CHECK_HINT(epi.key_type == tmp_ebc_param.key_type,
+                  "The key type of the sparse model does not match the embedding collection");
+
+  int target_grouped_id = -1;
+  TablePlacementStrategy target_placement;
+  for (int grouped_id = 0; grouped_id < tmp_ebc_param.grouped_table_params.size(); ++grouped_id) {
+    auto& tmp_table_ids = tmp_ebc_param.grouped_table_params[grouped_id].table_ids;
+    if (std::find(tmp_table_ids.begin(), tmp_table_ids.end(), model_table_id) !=
+        tmp_table_ids.end()) {
+      target_grouped_id = grouped_id;
+      target_placement = tmp_ebc_param.grouped_table_params[grouped_id].table_placement_strategy;
+      break;
+    }
+  }
+  if (target_grouped_id == -1) {
+    HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput,
+                   "can not find table_id in model table_ids,please check your input");
+  }
+
+  auto core_list = core_list_;
+  const int num_local_gpus = static_cast<int>(core_list.size());
+  auto load_rows = [=](int local_gpu_id) {
+    return [=](core23::Tensor& keys, core23::Tensor& embedding_weights) {
+      HugeCTR::CudaDeviceContext context(core_list[local_gpu_id]->get_device_id());
+      tmp_ebc->embedding_tables_[local_gpu_id][target_grouped_id]->load_by_id(
+          &keys, &embedding_weights, model_table_id);
+    };
+  };
+  std::vector<ChunkTarget> targets;
+  if (target_placement == TablePlacementStrategy::DataParallel) {
+    auto load_all_rows = [=](core23::Tensor& keys, core23::Tensor& embedding_weights) {
+      for (int local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
+        load_rows(local_gpu_id)(keys, embedding_weights);
+      }
+    };
+    targets.push_back({[](size_t key) { return true; }, load_all_rows});
+  } else if (target_placement == TablePlacementStrategy::ModelParallel) {
+    std::vector<int> shard_gpu_list;
+    for (int gpu_id = 0; gpu_id < resource_manager_->get_global_gpu_count(); ++gpu_id) {
+      HCTR_CHECK_HINT(model_table_id < static_cast<int>(tmp_ebc_param.shard_matrix[gpu_id].size()),
+                      "table_id is out of range");
+      if (tmp_ebc_param.shard_matrix[gpu_id][model_table_id] == 1) {
+        shard_gpu_list.push_back(gpu_id);
+      }
+    }
+    const size_t num_shards = shard_gpu_list.size();
+    for (int local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
+      size_t global_id = resource_manager_->get_gpu_global_id_from_local_id(local_gpu_id);
+      auto shard_iter = std::find(shard_gpu_list.begin(), shard_gpu_list.end(), global_id);
+      if (shard_iter == shard_gpu_list.end()) {
+        continue;
+      }
+      const size_t shard_id = std::distance(shard_gpu_list.begin(), shard_iter);
+      targets.push_back(
+          {[=](size_t key) { return key % num_shards == shard_id; }, load_rows(local_gpu_id)});
+    }
+    int frequent_index = tmp_ebc_param.get_frequent_table_index(model_table_id);
+    if (frequent_index >= 0) {
+      const auto& frequent_keys =
+          tmp_ebc_param.sparse_freq_keys_data.h_frequent_keys[frequent_index];
+      auto frequent_filter = [&](size_t key) {
+        return std::binary_search(frequent_keys.begin(), frequent_keys.end(),
+                                  static_cast<int64_t>(key));
+      };
+      auto load_frequent_rows = [=](core23::Tensor& keys, core23::Tensor& embedding_weights) {
+        tmp_ebc->load_frequent_rows(model_table_id, keys, embedding_weights);
+      };
+      targets.push_back({frequent_filter, load_frequent_rows});
+    }
+  } else {
+    HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError, "unsupported parallel mode");
+  }
+
+  stream_embedding_weight_(epi, fs_table_id, targets, num_threads, chunk_bytes);
+}
+
+void EmbeddingParameterIO::stream_embedding_weight_(const struct EmbeddingParameterInfo& epi,
+                                                    int fs_table_id,
+                                                    const std::vector<ChunkTarget>& targets,
+                                                    int num_threads, size_t chunk_bytes) {
+  const size_t key_bytes = epi.key_type.size();
+  const size_t ev_length = epi.table_embedding_vector_lengths.at(fs_table_id);
+  const size_t row_bytes = ev_length * sizeof(float);
+  const size_t rows_per_chunk = std::max<size_t>(1, chunk_bytes / row_bytes);
+
+  // Chunks of consecutive rows of one key file and one weight file, in load order.
+  struct Segment {
+    std::string key_file;
+    std::string weight_file;
+    size_t key_offset;
+    size_t weight_offset;
+    size_t num_keys;
+    // Shared by the segments of a compressed weight file, whose offsets are uncompressed ones.
+    std::shared_ptr<const HugeCTR::CompressedFileReader> compressed_weights;
+  };
+  std::vector<Segment> segments;
+  auto index_reader = HugeCTR::FileSystemBuilder::build_unique_by_path(epi.parameter_folder_path);
+  auto add_segments = [&](const std::string& key_file, const std::string& weight_file,
+                          size_t head_bytes, size_t num_keys) {
+    std::shared_ptr<const HugeCTR::CompressedFileReader> compressed_weights;
+    if (HugeCTR::get_file_compression_codec(weight_file) != HugeCTR::CompressionCodec::None) {
+      compressed_weights =
+          std::make_shared<const HugeCTR::CompressedFileReader>(*index_reader, weight_file);
+    }
+    for (size_t begin = 0; begin < num_keys; begin += rows_per_chunk) {
+      const size_t num_chunk_keys = std::min(rows_per_chunk, num_keys - begin);
+      segments.push_back({key_file, weight_file, head_bytes + begin * key_bytes,
+                          head_bytes + begin * row_bytes, num_chunk_keys, compressed_weights});
+    }
+  };
+  if (epi.num_manifests > 0) {
+    // Deltas are listed after the chunks they update, so the last row of each key is loaded.
+    for (const auto& chunk :
+         read_checkpoint_chunks(epi.parameter_folder_path, epi.num_manifests, fs_table_id)) {
+      add_segments(epi.parameter_folder_path + "/" + chunk.key_file,
+                   epi.parameter_folder_path + "/" + chunk.weight_file, 0, chunk.num_keys);
+    }
+  } else {
+    auto file_system = get_fs_object(epi.parameter_folder_path, SparseFSType::FS);
+    std::string ebc_key_path = epi.parameter_folder_path + "/key" + std::to_string(fs_table_id);
+    std::string ebc_weight_path =
+        epi.parameter_folder_path + "/weight" + std::to_string(fs_table_id);
+    size_t key_num = (file_system->get_file_size(ebc_key_path) - FileHeadNbytes) / key_bytes;
+    size_t weight_num = (file_system->get_file_size(ebc_weight_path) - FileHeadNbytes) / row_bytes;
+    if (key_num != weight_num) {
+      HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput,
+                     "Error: key num is not equal with embedding vector num");
+    }
+    add_segments(ebc_key_path, ebc_weight_path, FileHeadNbytes, key_num);
+  }
+
+  // A reader is only given another chunk after its last one was taken.
+  const size_t num_readers = std::max(num_threads, 1);
+  std::vector<std::unique_ptr<HugeCTR::FileSystem>> readers;
+  for (size_t i = 0; i < num_readers; ++i) {
+    readers.push_back(HugeCTR::FileSystemBuilder::build_unique_by_path(epi.parameter_folder_path));
+  }
+  struct ChunkData {
+    std::vector<char> keys;
+    std::vector<float> weights;
+  };
+  auto read_chunk = [&](size_t s) {
+    const Segment& segment = segments[s];
+    auto& reader = readers[s % num_readers];
+    ChunkData data;
+    data.keys.resize(segment.num_keys * key_bytes);
+    data.weights.resize(segment.num_keys * ev_length);
+    reader->read(segment.key_file, data.keys.data(), data.keys.size(), segment.key_offset);
+    if (segment.compressed_weights) {
+      segment.compressed_weights->read(*reader, data.weights.data(), segment.num_keys * row_bytes,
+                                       segment.weight_offset);
+    } else {
+      reader->read(segment.weight_file, data.weights.data(), segment.num_keys * row_bytes,
+                   segment.weight_offset);
+    }
+    return data;
+  };
+  std::deque<std::future<ChunkData>> reads;
+  size_t next_segment = 0;
+  auto read_ahead = [&] {
+    for (; next_segment < segments.size() && reads.size() < num_readers; ++next_segment) {
+      reads.push_back(std::async(std::launch::async, read_chunk, next_segment));
+    }
+  };
+
+  core23::Device device(core23::DeviceType::CPU);
+  core23::TensorParams params = core23::TensorParams().device(device);
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(epi.key_type.type(), key_t, [&] {
+    read_ahead();
+    std::vector<size_t> rows;
+    for (size_t s = 0; s < segments.size(); ++s) {
+      ChunkData data = reads.front().get();
+      reads.pop_front();
+      read_ahead();
+
+      const key_t* chunk_keys = reinterpret_cast<const key_t*>(data.keys.data());
+      for (const auto& target : targets) {
+        rows.clear();
+        for (size_t i = 0; i < segments[s].num_keys; ++i) {
+          if (target.key_select((size_t)chunk_keys[i])) {
+            rows.push_back(i);
+          }
+        }
+        if (rows.empty()) continue;
+
+        core23::Tensor keys(
+            params.shape({static_cast<int64_t>(rows.size())}).data_type(epi.key_type));
+        core23::Tensor embedding_weights(
+            params.shape({static_cast<int64_t>(rows.size() * ev_length)})
+                .data_type(core23::ScalarType::Float));
+        key_t* keys_ptr = keys.data<key_t>();
+        float* embedding_weights_ptr = embedding_weights.data<float>();
+        for (size_t i = 0; i < rows.size(); ++i) {
+          keys_ptr[i] = chunk_keys[rows[i]];
+          memcpy(embedding_weights_ptr + i * ev_length, &data.weights[rows[i] * ev_length],
+                 row_bytes);
+        }
+        target.load(keys, embedding_weights);
+      }
+    }
+  });
+}
+
 void EmbeddingParameterIO::load_opt_state(const struct EmbeddingParameterInfo& epi, int fs_table_id,
                                           core23::Tensor& keys, core23::Tensor& optimizer_buffer,
                                           embeddingFilter key_select,
@@ -18,7 +18,9 @@
 #include <core/hctr_impl/hctr_backend.hpp>
 #include <embedding_storage/weight_io/data_info.hpp>
 #include <embedding_storage/weight_io/fs_interface.hpp>
+#include <embedding_storage/weight_io/sharded_checkpoint.hpp>
 #include <embeddings/embedding_collection.hpp>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -46,6 +48,16 @@ class EmbeddingParameterIO {
                              const core23::DataType& target_key_type,
                              const core23::DataType& target_value_type);
 
+  /**
+   * Loads the rows of fs_table_id into table model_table_id of the embedding collection ebc_id,
+   * and into its frequent rows if it has any. The rows are streamed in chunks of at most
+   * chunk_bytes of weights. num_threads threads read the next chunks while the current one is
+   * inserted into the local GPUs that hold its rows, so at most num_threads + 1 chunks are held in
+   * host memory.
+   */
+  void load_embedding_table(const struct EmbeddingParameterInfo& epi, int fs_table_id, int ebc_id,
+                            int model_table_id, int num_threads, size_t chunk_bytes = 256 << 20);
+
   void load_opt_state(const struct EmbeddingParameterInfo& epi, int fs_table_id,
                       core23::Tensor& keys, core23::Tensor& optimizer_buffer,
                       embeddingFilter key_select,
@@ -56,14 +68,41 @@ class EmbeddingParameterIO {
   void get_parameter_info_from_model(const std::string& path,
                                      std::vector<struct EmbeddingParameterInfo>& epis);
 
+  // With num_manifests, the tables are chunked and the folder is cleared by begin_sharded_dump.
   void dump_metadata(const std::string& parameters_folder_path,
                      const struct EmbeddingParameterInfo& epi,
-                     const std::vector<int>& table_ids = std::vector<int>());
+                     const std::vector<int>& table_ids = std::vector<int>(), int num_manifests = 0);
 
   void dump_embedding_weight(const std::string& parameters_folder_path,
                              struct EmbeddingParameterInfo& epi,
                              const std::vector<int>& table_ids = std::vector<int>());
 
+  /**
+   * Starts a dump of chunked tables, see ShardedCheckpointWriter, and returns whether it is a
+   * delta of the last dump. Otherwise the folder is cleared. The weight files of the dump are
+   * compressed with codec.
+   */
+  bool begin_sharded_dump(const std::string& parameters_folder_path, bool incremental,
+                          HugeCTR::CompressionCodec codec = HugeCTR::CompressionCodec::None);
+
+  // Writes the chunks of the tables held by this rank with num_threads threads, and its manifest.
+  void dump_embedding_weight_sharded(const std::string& parameters_folder_path,
+                                     struct EmbeddingParameterInfo& epi,
+                                     const std::vector<int>& table_ids, int num_threads);
+
+  /**
+   * Writes table_id as a sparse model of the HPS, i.e. its int64 keys to sparse_model_path/key
+   * and its rows to sparse_model_path/emb_vector. The rows are pruned like by
+   * IGroupedEmbeddingTable::dump_pruned_by_id, so that the model only holds the rows that are
+   * worth serving. Returns the number of rows written by all ranks. With a compression codec, the
+   * rows are written to a compressed file, e.g. sparse_model_path/emb_vector.bitcomp, of which
+   * each rank writes its pages.
+   */
+  size_t export_sparse_model(
+      const std::string& sparse_model_path, const struct EmbeddingParameterInfo& epi,
+      int table_id, uint32_t min_lookup_count, uint32_t max_idle_iterations,
+      HugeCTR::CompressionCodec codec = HugeCTR::CompressionCodec::None);
+
   void dump_opt_state(const std::string& parameters_folder_path, struct EmbeddingParameterInfo& epi,
                       const std::vector<int>& table_ids = std::vector<int>());
 
@@ -74,10 +113,34 @@ class EmbeddingParameterIO {
   void write_file_head(const std::string& path, EmbeddingFileType file_type, int table_id,
                        std::shared_ptr<EmbeddingWeightIO>& fs);
 
+  // Dumps the rows of table_id that this rank writes, from its first GPU for data parallel tables.
+  // The rows are pruned like by IGroupedEmbeddingTable::dump_pruned_by_id.
+  size_t dump_local_rows_(const struct EmbeddingParameterInfo& epi, int table_id,
+                          std::vector<char>& keys, std::vector<float>& weights,
+                          uint32_t min_lookup_count = 0, uint32_t max_idle_iterations = 0);
+
+  void load_sharded_embedding_weight_(const struct EmbeddingParameterInfo& epi, int fs_table_id,
+                                      core23::Tensor& keys, core23::Tensor& embedding_weights,
+                                      embeddingFilter key_select,
+                                      const core23::DataType& target_key_type,
+                                      const core23::DataType& target_value_type);
+
+  struct ChunkTarget {
+    embeddingFilter key_select;
+    std::function<void(core23::Tensor& keys, core23::Tensor& embedding_weights)> load;
+  };
+
+  // Reads the rows of fs_table_id in file order, and loads the rows of each chunk that a target
+  // selects into it.
+  void stream_embedding_weight_(const struct EmbeddingParameterInfo& epi, int fs_table_id,
+                                const std::vector<ChunkTarget>& targets, int num_threads,
+                                size_t chunk_bytes);
+
  private:
   std::vector<EmbeddingCollection*> embedding_collections_;
   HugeCTR::ResourceManager* resource_manager_ = nullptr;
   std::vector<std::shared_ptr<core::CoreResourceManager>> core_list_;
+  ShardedCheckpointWriter checkpoint_writer_;
 };
 
 }  // namespace embedding
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <omp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <common.hpp>
+#include <cstring>
+#include <embedding_storage/weight_io/sharded_checkpoint.hpp>
+#include <future>
+#include <io/filesystem.hpp>
+#include <sstream>
+
+namespace embedding {
+
+namespace {
+
+uint64_t get_row_fingerprint(const char* data, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ull ^ size;
+  for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, data + i, std::min(sizeof(uint64_t), size - i));
+    hash = (hash ^ word) * 0x100000001b3ull;
+    hash ^= hash >> 29;
+  }
+  return hash;
+}
+
+uint64_t get_key_bits(const char* key, size_t key_bytes) {
+  uint64_t bits = 0;
+  memcpy(&bits, key, key_bytes);
+  return bits;
+}
+
+}  // namespace
+
+std::string get_manifest_name(int rank) { return "manifest" + std::to_string(rank); }
+
+bool ShardedCheckpointWriter::begin(const std::string& parameters_folder_path, bool incremental) {
+  delta_ = incremental && incremental_ && parameters_folder_path == path_;
+  if (delta_) {
+    sequence_++;
+  } else {
+    tables_.clear();
+    sequence_ = 0;
+  }
+  path_ = parameters_folder_path;
+  incremental_ = incremental;
+  return delta_;
+}
+
+void ShardedCheckpointWriter::write_table(const std::string& ebc_path, int ebc_id, int table_id,
+                                          int rank, const char* keys, size_t key_bytes,
+                                          const float* weights, size_t ev_length, size_t num_keys,
+                                          int num_threads) {
+  auto& table = tables_[{ebc_id, table_id}];
+  const size_t row_bytes = ev_length * sizeof(float);
+  const char* weight_bytes = reinterpret_cast<const char*>(weights);
+
+  // Rows to write, all of them unless this is a delta.
+  std::vector<size_t> rows;
+  if (incremental_) {
+    std::vector<uint64_t> fingerprints(num_keys);
+#pragma omp parallel for num_threads(std::max(num_threads, 1))
+    for (size_t i = 0; i < num_keys; ++i) {
+      fingerprints[i] = get_row_fingerprint(weight_bytes + i * row_bytes, row_bytes);
+    }
+    table.fingerprints.reserve(num_keys);
+    for (size_t i = 0; i < num_keys; ++i) {
+      auto [it, inserted] = table.fingerprints.try_emplace(
+          get_key_bits(keys + i * key_bytes, key_bytes), fingerprints[i]);
+      if (inserted || it->second != fingerprints[i]) {
+        it->second = fingerprints[i];
+        if (delta_) rows.push_back(i);
+      }
+    }
+  }
+  const size_t num_rows = delta_ ? rows.size() : num_keys;
+  if (num_rows == 0) {
+    return;
+  }
+
+  const size_t rows_per_chunk = std::max<size_t>(1, chunk_bytes_ / row_bytes);
+  const size_t num_chunks = (num_rows + rows_per_chunk - 1) / rows_per_chunk;
+  const size_t first_chunk = table.chunks.size();
+  for (size_t c = 0; c < num_chunks; ++c) {
+    const std::string suffix = std::to_string(table_id) + "_r" + std::to_string(rank) + "_s" +
+                               std::to_string(sequence_) + "_c" + std::to_string(c);
+    const size_t num_chunk_rows = std::min(rows_per_chunk, num_rows - c * rows_per_chunk);
+    table.chunks.push_back({table_id, num_chunk_rows, "key" + suffix,
+                            "weight" + suffix + HugeCTR::get_compressed_file_suffix(codec_)});
+  }
+
+  std::atomic<size_t> next_chunk{0};
+  auto write_chunks = [&] {
+    auto file_system = HugeCTR::FileSystemBuilder::build_unique_by_path(ebc_path);
+    std::vector<char> key_buffer, weight_buffer;
+    for (size_t c = next_chunk++; c < num_chunks; c = next_chunk++) {
+      const auto& chunk = table.chunks[first_chunk + c];
+      const size_t begin = c * rows_per_chunk;
+      const char* chunk_keys = keys + begin * key_bytes;
+      const char* chunk_weights = weight_bytes + begin * row_bytes;
+      if (delta_) {
+        key_buffer.resize(chunk.num_keys * key_bytes);
+        weight_buffer.resize(chunk.num_keys * row_bytes);
+        for (size_t i = 0; i < chunk.num_keys; ++i) {
+          const size_t row = rows[begin + i];
+          memcpy(key_buffer.data() + i * key_bytes, keys + row * key_bytes, key_bytes);
+          memcpy(weight_buffer.data() + i * row_bytes, weight_bytes + row * row_bytes, row_bytes);
+        }
+        chunk_keys = key_buffer.data();
+        chunk_weights = weight_buffer.data();
+      }
+      file_system->write(ebc_path + "/" + chunk.key_file, chunk_keys, chunk.num_keys * key_bytes,
+                         true);
+      if (codec_ == HugeCTR::CompressionCodec::None) {
+        file_system->write(ebc_path + "/" + chunk.weight_file, chunk_weights,
+                           chunk.num_keys * row_bytes, true);
+      } else {
+        HugeCTR::write_compressed_file(*file_system, ebc_path + "/" + chunk.weight_file,
+                                       chunk_weights, chunk.num_keys * row_bytes, codec_);
+      }
+    }
+  };
+
+  const size_t num_writers = std::min<size_t>(std::max(num_threads, 1), num_chunks);
+  std::vector<std::future<void>> writers;
+  for (size_t i = 0; i < num_writers; ++i) {
+    writers.push_back(std::async(std::launch::async, write_chunks));
+  }
+  for (auto& writer : writers) {
+    writer.get();
+  }
+}
+
+void ShardedCheckpointWriter::write_manifest(const std::string& ebc_path, int ebc_id, int rank) {
+  std::ostringstream manifest;
+  for (const auto& [ids, table] : tables_) {
+    if (ids.first != ebc_id) continue;
+    for (const auto& chunk : table.chunks) {
+      manifest << chunk.table_id << ' ' << chunk.num_keys << ' ' << chunk.key_file << ' '
+               << chunk.weight_file << '\n';
+    }
+  }
+  const std::string content = manifest.str();
+  auto file_system = HugeCTR::FileSystemBuilder::build_unique_by_path(ebc_path);
+  file_system->write(ebc_path + "/" + get_manifest_name(rank), content.data(), content.size(),
+                     true);
+}
+
+std::vector<CheckpointChunk> read_checkpoint_chunks(const std::string& ebc_path,
+                                                    int num_manifests, int table_id) {
+  auto file_system = HugeCTR::FileSystemBuilder::build_unique_by_path(ebc_path);
+  std::vector<CheckpointChunk> chunks;
+  for (int rank = 0; rank < num_manifests; ++rank) {
+    const std::string manifest_path = ebc_path + "/" + get_manifest_name(rank);
+    std::string content(file_system->get_file_size(manifest_path), '\0');
+    file_system->read(manifest_path, content.data(), content.size(), 0);
+
+    std::istringstream manifest(content);
+    CheckpointChunk chunk;
+    while (manifest >> chunk.table_id >> chunk.num_keys >> chunk.key_file >> chunk.weight_file) {
+      if (chunk.table_id == table_id) {
+        chunks.push_back(chunk);
+      }
+    }
+    if (!manifest.eof()) {
+      HCTR_OWN_THROW(HugeCTR::Error_t::BrokenFile, "Invalid manifest: " + manifest_path);
+    }
+  }
+  return chunks;
+}
+
+}  // namespace embedding
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <io/compressed_file.hpp>
+#include <map>
+#include <parallel_hashmap/phmap.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace embedding {
+
+// A key file and a weight file of consecutive rows, relative to the embedding collection folder.
+struct CheckpointChunk {
+  int table_id;
+  size_t num_keys;
+  std::string key_file;
+  std::string weight_file;
+};
+
+/**
+ * Writes the table shards of a rank as chunks of at most chunk_bytes of weights, without file
+ * heads. Each thread writes its chunks through its own FileSystem, so that a rank writes or
+ * uploads several files at the same time. The manifest of a rank lists its chunks in the order in
+ * which they are loaded, and a key is loaded from the last chunk that holds it.
+ *
+ * An incremental dump to the folder of the last dump, if that was incremental too, only writes
+ * the rows that are new or changed since. The writer keeps a fingerprint of each row for that,
+ * and lists the new chunks after the chunks of the earlier dumps. Keys removed from the tables
+ * stay in the checkpoint until the next full dump.
+ *
+ * With a compression codec, the weight files are compressed files, see HugeCTR::CompressionCodec,
+ * whose names end with the suffix of the codec. The key files are not compressed.
+ */
+class ShardedCheckpointWriter {
+ public:
+  explicit ShardedCheckpointWriter(size_t chunk_bytes = 256 << 20) : chunk_bytes_(chunk_bytes) {}
+
+  /**
+   * Starts a dump to parameters_folder_path, and returns whether it is a delta of the last one.
+   * Otherwise the chunks of the earlier dumps are forgotten.
+   */
+  bool begin(const std::string& parameters_folder_path, bool incremental);
+
+  // The codec of the weight files of the next chunks.
+  void set_compression(HugeCTR::CompressionCodec codec) { codec_ = codec; }
+
+  /**
+   * Writes the rows of a table held by this rank to ebc_path.
+   *
+   * @param keys num_keys keys of key_bytes bytes
+   * @param weights num_keys rows of ev_length floats
+   */
+  void write_table(const std::string& ebc_path, int ebc_id, int table_id, int rank,
+                   const char* keys, size_t key_bytes, const float* weights, size_t ev_length,
+                   size_t num_keys, int num_threads);
+
+  // Writes the manifest of the chunks of all tables of the collection that this rank wrote.
+  void write_manifest(const std::string& ebc_path, int ebc_id, int rank);
+
+ private:
+  struct TableState {
+    std::vector<CheckpointChunk> chunks;
+    phmap::flat_hash_map<uint64_t, uint64_t> fingerprints;  // By key, only if incremental
+  };
+
+  const size_t chunk_bytes_;
+  HugeCTR::CompressionCodec codec_ = HugeCTR::CompressionCodec::None;
+  std::string path_;
+  bool incremental_ = false;
+  bool delta_ = false;
+  size_t sequence_ = 0;
+  std::map<std::pair<int, int>, TableState> tables_;  // By collection and table id
+};
+
+std::string get_manifest_name(int rank);
+
+// Returns the chunks of table_id listed in the manifests of num_manifests ranks, in load order.
+std::vector<CheckpointChunk> read_checkpoint_chunks(const std::string& ebc_path,
+                                                    int num_manifests, int table_id);
+
+}  // namespace embedding
@@ -25,7 +25,7 @@
 #include <vector>
 
 namespace HugeCTR {
-enum class AllReduceAlgo { ONESHOT, NCCL };
+enum class AllReduceAlgo { ONESHOT, NCCL, HIERARCHICAL };
 
 class AllReduceInPlaceComm {
  public:
@@ -54,6 +54,9 @@ class AllReduceInPlaceComm {
   static std::shared_ptr<AllReduceInPlaceComm> create_nccl(
       size_t num_process, bool use_mixed_precision,
       const std::vector<std::shared_ptr<GPUResource>>& gpu_resources);
+  static std::shared_ptr<AllReduceInPlaceComm> create_hierarchical(
+      size_t num_process, bool use_mixed_precision,
+      const std::vector<std::shared_ptr<GPUResource>>& gpu_resources);
   static std::shared_ptr<AllReduceInPlaceComm> create_oneshot(
       size_t num_process, bool use_mixed_precision,
       const std::vector<std::shared_ptr<GPUResource>>& gpu_resources);
@@ -153,4 +156,41 @@ class NCCLARInplaceComm : public AllReduceInPlaceComm {
   size_t num_procs_ = 1;
   size_t num_gpus_ = 1;
 };
+
+/**
+ * Two-level all-reduce built from NCCL collectives: a reduce-scatter among the GPUs of the node,
+ * an all-reduce of the shard of each GPU among the GPUs of the same local rank on all nodes, and
+ * an all-gather among the GPUs of the node. On a rail-optimized network, the GPUs of the same
+ * local rank share a rail, so each rail only carries 1 / (number of local GPUs) of the data.
+ */
+template <typename T>
+class HierarchicalARInplaceComm : public AllReduceInPlaceComm {
+ public:
+  virtual Handle register_coll() final;
+  virtual void set_coll_buf(Handle coll, void* ar_ptr, size_t ar_size, size_t device_id) final;
+  virtual void register_coll_buf(Handle coll) final;
+  virtual void update_size(Handle coll, const size_t ar_size) final;
+  virtual void all_reduce(Handle coll, cudaStream_t stream, size_t device_id) final;
+
+  HierarchicalARInplaceComm(size_t num_procs,
+                            const std::vector<std::shared_ptr<GPUResource>>& gpu_resources);
+  ~HierarchicalARInplaceComm();
+
+ private:
+  struct ARContextPerGPU {
+    void* ar_ptr_ = NULL;
+  };
+
+  struct ARContext {
+    std::vector<ARContextPerGPU> ctx_;
+    size_t ar_size_ = 0;
+  };
+
+  const std::vector<std::shared_ptr<GPUResource>>& gpu_resources_;
+  std::vector<std::unique_ptr<ARContext>> ar_ctx_;
+  std::vector<ncclComm_t> node_comms_;  // The GPUs of this node, by local id.
+  std::vector<ncclComm_t> rail_comms_;  // The GPUs of the same local id on all nodes.
+  size_t num_procs_ = 1;
+  size_t num_gpus_ = 1;
+};
 }  // namespace HugeCTR
@@ -71,11 +71,11 @@ enum class CommunicationType;
 
 }  // namespace hybrid_embedding
 
-enum class Check_t { Sum, None, Unknown };
+enum class Check_t { Sum, None, SumDeferred, Unknown };
 
 enum class DataReaderSparse_t { Distributed, Localized };
 
-enum class DataReaderType_t { Norm, Raw, Parquet, RawAsync };
+enum class DataReaderType_t { Norm, Raw, Parquet, RawAsync, InMemory };
 
 enum class SourceType_t { FileList, Mmap, Parquet };
 
@@ -96,6 +96,8 @@ enum class Optimizer_t {
   Nesterov,
   MomentumSGD,
   SGD,
+  LAMB,
+  LARS,
   DEFAULT,
   NOT_INITIALIZED
 };
@@ -111,7 +113,16 @@ enum class Regularizer_t { L1, L2, None };
 
 enum class Alignment_t { Auto, None };
 
-enum class GroupLayer_t { GroupFusedInnerProduct };
+// Precision of the dense wgrad all-reduce of FP32 training. The wgrad is rounded to FP16 or BF16
+// before the all-reduce, and the rounding error is added to the wgrad of the next iteration.
+enum class WgradCompression_t { Disabled, FP16, BF16 };
+
+// Kernel interface of the file reads of the multi-hot AsyncDataReader. IOUringSQPoll polls the
+// submissions from a kernel thread, so that submitting reads requires no system calls. GDS reads
+// into device memory with GPUDirect Storage.
+enum class IOBackend_t { AIO, IOUring, IOUringSQPoll, GDS };
+
+enum class GroupLayer_t { GroupFusedInnerProduct, GroupExpertMLP };
 
 enum class Layer_t {
   BatchNorm,
@@ -151,6 +162,10 @@ enum class Layer_t {
   Cast,
   ElementwiseMultiply,
   SequenceMask,
+  FusedElementwise,
+  FusedAddLayerNorm,
+  GroupedMLP,
+  InBatchSoftmaxLoss,
   Unknown
 };
 
@@ -197,10 +212,29 @@ struct AsyncParam {
   Alignment_t aligned_type;
   bool multi_hot_reader;
   bool is_dense_float;
+  IOBackend_t io_backend;  // Only used by the multi-hot reader
+  int shuffle_window;      // Only used by the multi-hot reader
+  // Reader state file of Model::save_data_reader_state to resume training from, if not empty.
+  // Only used by the multi-hot reader.
+  std::string resume_state;
+  // Vocabulary sizes and power-law exponents of the features of the synthetic data that the
+  // multi-hot reader generates instead of reading the source files, if not empty.
+  std::vector<long long> synthetic_vocabulary_sizes;
+  std::vector<float> synthetic_alphas;
+  // Max number of keys of the token_budget_slots in a train batch, whose number of samples then
+  // varies up to the batch size, if positive. Only used by the multi-hot reader of variable-length
+  // files.
+  long long token_budget;
+  std::vector<int> token_budget_slots;
 
   AsyncParam(int num_threads, int num_batches_per_thread, int max_num_requests_per_thread,
              int io_depth, int io_alignment, bool shuffle, Alignment_t aligned_type,
-             bool multi_hot_reader, bool is_dense_float)
+             bool multi_hot_reader, bool is_dense_float,
+             IOBackend_t io_backend = IOBackend_t::AIO, int shuffle_window = 1,
+             const std::string& resume_state = "",
+             const std::vector<long long>& synthetic_vocabulary_sizes = {},
+             const std::vector<float>& synthetic_alphas = {}, long long token_budget = 0,
+             const std::vector<int>& token_budget_slots = {})
       : num_threads(num_threads),
         num_batches_per_thread(num_batches_per_thread),
         max_num_requests_per_thread(max_num_requests_per_thread),
@@ -209,7 +243,14 @@ struct AsyncParam {
         shuffle(shuffle),
         aligned_type(aligned_type),
         multi_hot_reader(multi_hot_reader),
-        is_dense_float(is_dense_float) {}
+        is_dense_float(is_dense_float),
+        io_backend(io_backend),
+        shuffle_window(shuffle_window),
+        resume_state(resume_state),
+        synthetic_vocabulary_sizes(synthetic_vocabulary_sizes),
+        synthetic_alphas(synthetic_alphas),
+        token_budget(token_budget),
+        token_budget_slots(token_budget_slots) {}
 };
 
 struct HybridEmbeddingParam {
@@ -221,6 +262,8 @@ struct HybridEmbeddingParam {
   double efficiency_bandwidth_ratio;
   hybrid_embedding::CommunicationType communication_type;
   hybrid_embedding::HybridEmbeddingType hybrid_embedding_type;
+  std::string statistics_file;
+  size_t recalibration_interval = 0;
 };
 
 typedef struct DataSetHeader_ {
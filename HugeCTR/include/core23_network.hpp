@@ -17,6 +17,7 @@
 
 #include <core23/tensor_container.hpp>
 #include <cpu_resource.hpp>
+#include <functional>
 #include <gpu_learning_rate_scheduler.hpp>
 #include <gpu_resource.hpp>
 #include <layer.hpp>
@@ -127,6 +128,11 @@ class Core23TempNetwork final {
    */
   void download_params_to_host(float* weight);
 
+  /**
+   * Writing opt states to cpu buffer of get_opt_states_size_in_byte() bytes.
+   */
+  void download_opt_states_to_host(char* h_opt_states);
+
   /**
    * Read parameters from cpu buffer.
    */
@@ -148,7 +154,35 @@ class Core23TempNetwork final {
   void exchange_wgrad();
 
   /**
-   * Update parameters.
+   * Split the wgrad buffer of wgrad_size bytes at wgrad_buffer into buckets for reducing it during
+   * backward. Consecutive layers in backward order are grouped until their wgrads span at least
+   * bucket_size bytes, and the bucket boundaries are aligned to alignment bytes. Returns the byte
+   * ranges of the buckets in backward order, which together cover the whole buffer, or nothing if
+   * the wgrads don't lie in the buffer in the order of the layers.
+   */
+  std::vector<std::pair<size_t, size_t>> make_wgrad_buckets(const void* wgrad_buffer,
+                                                            size_t wgrad_size, size_t bucket_size,
+                                                            size_t alignment);
+
+  /**
+   * Call allreduce(bucket, stream) for each bucket of make_wgrad_buckets() as soon as the backward
+   * of its layers is done, on a stream of its own. train() waits for the all-reduces before it
+   * returns.
+   */
+  void enable_wgrad_buckets(std::function<void(size_t, cudaStream_t)> allreduce);
+
+  /**
+   * Run the layers of independent branches, e.g. the towers of a multi-task model, on up to
+   * num_streams streams. Two layers depend on each other if their input and output tensors
+   * overlap, and a layer waits for the layers it depends on with events. All streams are joined
+   * after forward and backward, so that the network can still be captured into a CUDA graph.
+   * Returns the number of streams of the train forward.
+   */
+  size_t enable_concurrent_branches(size_t num_streams);
+
+  /**
+   * Update parameters. With a sharded optimizer, each GPU updates its shard, and the shards are
+   * then all gathered into the weights of all GPUs.
    */
   void update_params();
 
@@ -165,6 +199,12 @@ class Core23TempNetwork final {
     lr_sched_ = lr_sched;
   }
 
+  /**
+   * Scale the gradients of the train losses by the float at loss_scale and skip the updates while
+   * the int at skip_update is not 0. Both lie on the GPU of the network.
+   */
+  void set_dynamic_loss_scale(const float* loss_scale, const int* skip_update);
+
   /**
    * initialize layer by layer
    */
@@ -196,14 +236,44 @@ class Core23TempNetwork final {
                            const std::map<std::string, float>& label_weights);
   void set_raw_metrics(metrics::Core23MultiLossMetricMap&& raw_metrics);
   void set_optimizer(std::unique_ptr<Optimizer> optimizer);
-  void create_and_set_optimizer(const OptParams& opt_params);
+  /**
+   * With num_shards > 1, the optimizer only updates the shard of the flat weights of this GPU, see
+   * get_dense_optimizer_shard(), so that only the states of the shard are kept. Its wgrad must have
+   * been reduced into the shard, and the dense optimizer states can't be dumped or loaded then.
+   */
+  void create_and_set_optimizer(const OptParams& opt_params, size_t num_shards = 1);
 
  private:
   friend class Model;
 
   void conv_weight_(std::optional<core23::TensorContainer<__half, 1, 1>>& target_opt,
                     const std::optional<core23::TensorContainer<float, 1, 1>>& source_opt);
+  // Converts the FP16 copy of the train weights after they are set outside of an update, if the
+  // optimizer keeps it up to date.
+  void update_train_weight_half_();
+  void create_and_set_sharded_optimizer_(const OptParams& opt_params, size_t num_shards);
+  void all_gather_weights_();
   void prop_layers(const std::vector<Layer*>& layers, bool fprop, bool train);
+  void bprop_with_wgrad_buckets_(const std::vector<Layer*>& layers);
+
+  // A layer of a forward or backward in the order the layers are run, on one of the streams.
+  struct BranchStep {
+    size_t layer;
+    size_t stream;  // 0 for the current stream of the GPU
+    std::vector<size_t> wait_steps;
+    bool record;  // whether a step on another stream waits for this one
+  };
+  struct BranchPlan {
+    std::vector<BranchStep> steps;
+    size_t num_streams;
+    std::vector<cudaEvent_t> step_events;
+    cudaEvent_t fork_event;
+    std::vector<cudaEvent_t> join_events;
+  };
+  BranchPlan make_branch_plan_(const std::vector<Layer*>& layers, bool fprop, size_t num_streams,
+                               const std::string& name);
+  void run_branch_plan_(const BranchPlan& plan, const std::vector<Layer*>& layers, bool fprop,
+                        bool train);
 
   void set_losses_common(const std::map<std::string, std::unique_ptr<ILoss>>& losses,
                          const std::map<std::string, float>& label_weights,
@@ -240,6 +310,20 @@ class Core23TempNetwork final {
   bool use_mixed_precision_;
 
   std::shared_ptr<GpuLearningRateScheduler> lr_sched_;
+
+  size_t num_optimizer_shards_ = 1;
+
+  // Index of the train layer after whose backward each wgrad bucket is reduced.
+  std::vector<size_t> wgrad_bucket_layers_;
+  std::function<void(size_t, cudaStream_t)> wgrad_bucket_allreduce_;
+  cudaStream_t wgrad_bucket_stream_;
+  std::vector<cudaEvent_t> wgrad_bucket_events_;
+  cudaEvent_t wgrad_buckets_done_event_;
+
+  std::vector<std::string> branch_stream_names_;
+  std::optional<BranchPlan> train_fprop_plan_;
+  std::optional<BranchPlan> train_bprop_plan_;
+  std::optional<BranchPlan> eval_fprop_plan_;
 };
 
 }  // namespace HugeCTR
@@ -19,6 +19,7 @@
 
 // For the tensor bags
 #include <atomic>
+#include <core23/pinned_host_arena.hpp>
 #include <core23/tensor.hpp>
 #include <tensor2.hpp>
 #include <vector>
@@ -43,7 +44,8 @@ struct InternalBatchBuffer {
   int raw_device_id;
 
   std::vector<char*> dev_data;
-  char* raw_host_ptr = nullptr;
+  core23::PinnedHostBuffer host_buffer;
+  char* raw_host_ptr = nullptr;  // Data of host_buffer
   char* host_data;
 
   std::atomic<BufferStatus> status;
@@ -68,8 +70,6 @@ struct InternalBatchBuffer {
     for (auto ptr : dev_data) {
       HCTR_LIB_CHECK_(cudaFree(ptr));
     }
-    HCTR_LIB_CHECK_(cudaHostUnregister(raw_host_ptr));
-    free(raw_host_ptr);
   }
 };
 
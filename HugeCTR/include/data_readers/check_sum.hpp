@@ -15,12 +15,35 @@
  */
 #pragma once
 
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
 #include <common.hpp>
+#include <condition_variable>
 #include <data_readers/checker.hpp>
 #include <data_readers/source.hpp>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace HugeCTR {
 
+/**
+ * Adds the bytes of ptr to accum. The sum is kept in a local, so that the loop is vectorized,
+ * which it is not when every step stores to a char that ptr may alias.
+ */
+inline char sum_bytes(const char* ptr, size_t num_bytes, char accum) {
+  unsigned char sum = static_cast<unsigned char>(accum);
+  for (size_t i = 0; i < num_bytes; i++) {
+    sum += static_cast<unsigned char>(ptr[i]);
+  }
+  return static_cast<char>(sum);
+}
+
 class CheckSum : public Checker {
  private:
   const int MAX_TRY_{10};
@@ -51,9 +74,7 @@ class CheckSum : public Checker {
         HCTR_OWN_THROW(Error_t::BrokenFile, os.str());
       } else {
         Checker::src_.read(ptr, bytes_to_read);
-        for (unsigned int i = 0; i < bytes_to_read; i++) {
-          accum_ += ptr[i];
-        }
+        accum_ = sum_bytes(ptr, bytes_to_read, accum_);
         // do checksum when counter_ == 0.
         if (counter_ == 0) {
           char check_sum = 0;
@@ -96,4 +117,153 @@ class CheckSum : public Checker {
   }
 };
 
+/**
+ * Reads the same files as CheckSum, but verifies the checksums on a low-priority thread.
+ * The blocks read are copied to batches of about batch_bytes_, which the verifier thread checks
+ * while the reading goes on. Reading never fails on a mismatch: the file is reported in the
+ * log instead. When the verifier falls behind by max_pending_batches_, the new batches are
+ * skipped, so that only a sample of the data is verified.
+ */
+class DeferredCheckSum : public Checker {
+ private:
+  struct Batch {
+    std::string file_name;
+    std::vector<char> bytes;
+    std::vector<std::pair<size_t, char>> blocks; /**< end offset in bytes and checksum */
+  };
+
+  static constexpr size_t batch_bytes_{4 << 20};
+  static constexpr size_t max_pending_batches_{4};
+  const int MAX_TRY_{10};
+  int counter_; /**< bytes left in the current block */
+  Batch batch_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Batch> pending_batches_;
+  bool stop_{false};
+  std::atomic<size_t> num_skipped_batches_{0};
+  std::thread verifier_;
+
+  void submit_batch() {
+    // the bytes of an unfinished block cannot be verified
+    batch_.bytes.resize(batch_.blocks.empty() ? 0 : batch_.blocks.back().first);
+    if (!batch_.blocks.empty()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (pending_batches_.size() < max_pending_batches_) {
+        pending_batches_.push_back(std::move(batch_));
+        batch_.file_name = pending_batches_.back().file_name;
+        cv_.notify_one();
+      } else {
+        num_skipped_batches_++;
+      }
+    }
+    batch_.bytes.clear();
+    batch_.blocks.clear();
+    batch_.bytes.reserve(batch_bytes_);
+  }
+
+  void verify() {
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), 19);
+    while (true) {
+      Batch batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_ || !pending_batches_.empty(); });
+        if (pending_batches_.empty()) {
+          return;
+        }
+        batch = std::move(pending_batches_.front());
+        pending_batches_.pop_front();
+      }
+      size_t num_bad_blocks = 0;
+      size_t begin = 0;
+      for (const auto& [end, check_sum] : batch.blocks) {
+        if (sum_bytes(batch.bytes.data() + begin, end - begin, 0) != check_sum) {
+          num_bad_blocks++;
+        }
+        begin = end;
+      }
+      if (num_bad_blocks > 0) {
+        HCTR_LOG_S(ERROR, WORLD) << "Error_t::DataCheckError in " << num_bad_blocks << " of "
+                                 << batch.blocks.size() << " blocks of " << batch.file_name
+                                 << std::endl;
+      }
+    }
+  }
+
+ public:
+  DeferredCheckSum(Source& src) : Checker(src), counter_(0) {
+    batch_.bytes.reserve(batch_bytes_);
+    verifier_ = std::thread([this]() { verify(); });
+  }
+
+  ~DeferredCheckSum() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_one();
+    verifier_.join();
+    if (num_skipped_batches_ > 0) {
+      HCTR_LOG_S(INFO, WORLD) << num_skipped_batches_
+                              << " batches of blocks were read without checksum verification"
+                              << std::endl;
+    }
+  }
+
+  /**
+   * Read "bytes_to_read" byte to the memory associated to ptr.
+   * The checksum of the block is verified later, so it never returns `DataCheckError`.
+   * @param ptr pointer to user located buffer
+   * @param bytes_to_read bytes to read
+   * @return `OutOfBound` `Success` `BrokenFile`
+   */
+  Error_t read(char* ptr, size_t bytes_to_read) noexcept {
+    try {
+      if (counter_ == 0) {
+        Checker::src_.read(reinterpret_cast<char*>(&counter_), sizeof(int));
+      }
+      counter_ -= bytes_to_read;
+      if (counter_ < 0) {
+        std::ostringstream os;
+        os << "counter_ " << counter_ << "< 0";
+        HCTR_OWN_THROW(Error_t::BrokenFile, os.str());
+      }
+      Checker::src_.read(ptr, bytes_to_read);
+      batch_.bytes.insert(batch_.bytes.end(), ptr, ptr + bytes_to_read);
+      if (counter_ == 0) {
+        char check_sum = 0;
+        Checker::src_.read(reinterpret_cast<char*>(&check_sum), sizeof(char));
+        batch_.blocks.emplace_back(batch_.bytes.size(), check_sum);
+        if (batch_.bytes.size() >= batch_bytes_) {
+          submit_batch();
+        }
+      }
+      return Error_t::Success;
+    } catch (const std::runtime_error& rt_err) {
+      HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+      return Error_t::BrokenFile;
+    }
+  }
+
+  /**
+   * Start a new file to read.
+   * @return `FileCannotOpen` or `UnspecificError`
+   */
+  Error_t next_source(long long expected_next_source_items) {
+    submit_batch();
+    counter_ = 0;
+    for (int i = MAX_TRY_; i > 0; i--) {
+      Error_t flag_eof = Checker::src_.next_source(expected_next_source_items);
+      if (flag_eof == Error_t::Success || flag_eof == Error_t::EndOfFile) {
+        batch_.file_name = Checker::src_.get_current_file_name();
+        return flag_eof;
+      }
+    }
+    HCTR_OWN_THROW(Error_t::FileCannotOpen,
+                   "Checker::src_.next_source() == Error_t::Success failed");
+    return Error_t::FileCannotOpen;  // to elimate compile error
+  }
+};
+
 }  // namespace HugeCTR
@@ -15,7 +15,12 @@
  */
 #pragma once
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <atomic>
+#include <climits>
 #include <common.hpp>
 // TODO remove me
 #include <data_reader.hpp>
@@ -27,6 +32,30 @@ namespace HugeCTR {
 
 enum class BufferState : int { FileEOF, Reading, ReadyForRead, Writing, ReadyForWrite };
 
+static_assert(sizeof(std::atomic<BufferState>) == sizeof(int) &&
+                  std::atomic<BufferState>::is_always_lock_free,
+              "The buffer states are waited on as futex words.");
+
+// The reader workers, the collector and the training thread hand the buffers over to each other
+// through their states. Instead of polling, a thread waiting for another state sleeps on the
+// futex of the state, and is woken up by store_buffer_state. The wait times out after
+// buffer_state_wait_timeout_ns, so that the waiting threads still see their loop flags.
+constexpr long buffer_state_wait_timeout_ns = 1000000;
+
+// Returns once state is no longer old, or after the timeout.
+inline void wait_buffer_state_change(const std::atomic<BufferState>& state,
+                                     const BufferState old) {
+  const timespec timeout{0, buffer_state_wait_timeout_ns};
+  syscall(SYS_futex, reinterpret_cast<const int*>(&state), FUTEX_WAIT_PRIVATE,
+          static_cast<int>(old), &timeout, nullptr, 0);
+}
+
+inline void store_buffer_state(std::atomic<BufferState>& state, const BufferState value) {
+  state.store(value);
+  syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr,
+          nullptr, 0);
+}
+
 // TODO remove me
 struct ThreadBuffer {
   std::vector<SparseTensorBag> device_sparse_buffers;  // same number as embedding number
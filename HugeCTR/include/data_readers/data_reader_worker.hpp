@@ -55,6 +55,9 @@ class DataReaderWorker : public IDataReaderWorker {
       case Check_t::Sum:
         checker_ = std::make_shared<CheckSum>(*source_);
         break;
+      case Check_t::SumDeferred:
+        checker_ = std::make_shared<DeferredCheckSum>(*source_);
+        break;
       case Check_t::None:
         checker_ = std::make_shared<CheckNone>(*source_);
         break;
@@ -68,7 +71,7 @@ class DataReaderWorker : public IDataReaderWorker {
     create_checker();
 
     is_eof_ = false;
-    buffer23_->state.store(BufferState::ReadyForWrite);
+    store_buffer_state(buffer23_->state, BufferState::ReadyForWrite);
   }
 
   /**
@@ -59,7 +59,8 @@ static void consumer_thread_func_(const std::shared_ptr<IDataReaderWorker>& data
                                   const std::shared_ptr<std::atomic<bool>>& p_loop_flag,
                                   int device_id, volatile bool* end_flag = nullptr) {
   try {
-    CudaDeviceContext context(device_id);
+    // read_a_batch() works on host buffers as well, so it runs on the node of the GPU
+    CudaCPUDeviceContext context(device_id);
     while (!p_loop_flag->load() && !*end_flag) {
       usleep(2);
     }
@@ -80,15 +80,15 @@ class IDataReaderWorker {
   bool wait_until_h2d_ready() {
     BufferState expected = BufferState::ReadyForWrite;
     if (buffer_) {
-      while (!buffer_->state.compare_exchange_weak(expected, BufferState::Writing)) {
+      while (!buffer_->state.compare_exchange_strong(expected, BufferState::Writing)) {
+        wait_buffer_state_change(buffer_->state, expected);
         expected = BufferState::ReadyForWrite;
-        usleep(2);
         if (!loop_flag_->load()) return false;  // in case main thread exit
       }
     } else {
-      while (!buffer23_->state.compare_exchange_weak(expected, BufferState::Writing)) {
+      while (!buffer23_->state.compare_exchange_strong(expected, BufferState::Writing)) {
+        wait_buffer_state_change(buffer23_->state, expected);
         expected = BufferState::ReadyForWrite;
-        usleep(2);
         if (!loop_flag_->load()) return false;  // in case main thread exit
       }
     }
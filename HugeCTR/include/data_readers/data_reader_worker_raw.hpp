@@ -52,7 +52,7 @@ class DataReaderWorkerRaw : public IDataReaderWorker {
  public:
   void post_set_source() override {
     is_eof_ = false;
-    buffer23_->state.store(BufferState::ReadyForWrite);
+    store_buffer_state(buffer23_->state, BufferState::ReadyForWrite);
   }
 
   /**
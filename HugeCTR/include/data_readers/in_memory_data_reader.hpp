@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <core23/tensor.hpp>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <resource_manager.hpp>
+#include <scheduleable.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * A batch pushed to an InMemoryDataReader, as the tensors of each local gpu. The tensors are in
+ * host memory or in the memory of their gpu, and owner keeps their memory alive until the batch
+ * has been consumed. A batch without labels marks the end of the data, see
+ * InMemoryDataReader::finish.
+ */
+struct InMemoryBatch {
+  std::vector<core23::Tensor> labels;               // [batch_size_per_gpu, label_dim] float
+  std::vector<core23::Tensor> dense;                // [batch_size_per_gpu, dense_dim]
+  std::vector<std::vector<core23::Tensor>> sparse;  // [gpu][feature] [batch_size_per_gpu, hotness]
+  std::shared_ptr<void> owner;
+};
+
+/**
+ * Reads the batches that are pushed to it, e.g. from a stream that holds them in memory, instead
+ * of files. The batches wait in a bounded queue, so that push blocks while the queue is full and a
+ * read blocks while it is empty. The sparse values of device batches are used in place, and the
+ * ones of host batches are copied into staging buffers. The labels and the dense features are
+ * copied into the input tensors of the network, which are bound when it is built.
+ *
+ * Batches are full and their features have a fixed hotness, like the ones of fixed-length
+ * multi-hot files. With fixed_buffers, e.g. for cuda graphs, which capture the addresses of the
+ * sparse values, all sparse values are copied into the same staging buffers instead.
+ */
+template <typename SparseType>
+class InMemoryDataReader : public SchedulableDataReader, public SparseValueReader {
+ public:
+  InMemoryDataReader(const std::shared_ptr<ResourceManager>& resource_manager, size_t batch_size,
+                     const std::vector<DataReaderSparseParam>& params, size_t label_dim,
+                     size_t dense_dim, bool mixed_precision, size_t queue_capacity,
+                     bool fixed_buffers);
+  ~InMemoryDataReader();
+
+  /**
+   * Queues a batch, after checking its tensors, and blocks while the queue is full. It is thread
+   * safe, and the batches are read in the order of their pushes.
+   */
+  void push(InMemoryBatch batch);
+
+  // Ends the data, e.g. an epoch: the read after the batches pushed before returns 0.
+  void finish();
+
+  long long read_a_batch_to_device_delay_release() override;
+  long long read_a_batch_to_device() override;
+  void ready_to_collect() override {}
+
+  long long get_current_batchsize_per_device(size_t local_id) override;
+  long long get_current_batchsize() override { return current_batch_size_; }
+  long long get_full_batchsize() const override { return batch_size_; }
+  bool current_batch_incomplete() const override { return current_batch_size_ != batch_size_; }
+  TensorScalarType get_scalar_type() const override;
+  bool is_started() const override { return true; }
+  void start() override {}
+
+  bool is_batch_cached() const override { return false; }
+  size_t get_current_inflight_id() const override { return 0; }
+  cudaStream_t get_split_3_way_stream(int raw_device_id) const override {
+    return s3w_streams_.at(raw_device_id);
+  }
+  cudaStream_t get_d2d_stream(int raw_device_id) const override {
+    return d2d_streams_.at(raw_device_id);
+  }
+  void set_schedule_streams(cudaStream_t s3w_stream, cudaStream_t d2d_stream,
+                            int raw_device_id) override;
+  void schedule_split_3_way_here(cudaStream_t stream, int raw_device_id, bool from_graph) override;
+  void schedule_d2d_here(cudaStream_t stream, int raw_device_id, bool from_graph) override;
+  void schedule_here(cudaStream_t stream, int raw_device_id) override {}
+  void schedule_here_graph(cudaStream_t stream, int raw_device_id) override {}
+  void update_schedule_graph(int raw_device_id) override {}
+  void stream_wait_sparse_tensors(cudaStream_t stream, int raw_device_id, bool from_graph) override;
+  void stream_wait_dense_tensors(cudaStream_t stream, int raw_device_id, bool from_graph) override;
+
+  std::vector<core23::Tensor> get_label_tensor23s() const override { return label_tensors_; }
+  std::vector<core23::Tensor> get_dense_tensor23s() const override { return dense_tensors_; }
+  std::vector<std::vector<core23::Tensor>>& get_current_sparse_values() override {
+    return current_sparse_values_;
+  }
+  std::vector<std::vector<core23::Tensor>>& get_current_dp_bucket_ranges() override {
+    return current_dp_bucket_ranges_;
+  }
+
+  // There are no files to read.
+  void create_drwg_norm(std::string file_list, Check_t check_type,
+                        bool start_reading_from_beginning = true) override {}
+  void create_drwg_raw(std::string file_name, long long num_samples, bool float_label_dense,
+                       bool data_shuffle, bool start_reading_from_beginning = true) override {}
+#ifndef DISABLE_CUDF
+  void create_drwg_parquet(std::string file_list, bool strict_order_of_batches,
+                           const std::vector<long long> slot_offset,
+                           bool start_reading_from_beginning = true,
+                           long long max_samples_per_group = 0, int label_dense_num = 0,
+                           int label_dense_dim = 0) override {}
+#endif
+  void set_source(std::string file_list = std::string()) override {}
+
+ private:
+  // A batch which was read, and its slot of the staging buffers and the release events.
+  struct ReadBatch {
+    InMemoryBatch batch;
+    size_t slot;
+  };
+
+  // Releases the retired batches whose reads have completed, and waits for the oldest ones until
+  // at most max_batches are left.
+  void release_batches(size_t max_batches);
+
+  const std::shared_ptr<ResourceManager> resource_manager_;
+  size_t batch_size_, batch_size_per_dev_;
+  size_t label_dim_, dense_dim_;
+  bool mixed_precision_;
+  bool fixed_buffers_;
+  std::vector<int> nnz_per_slot_;
+  size_t current_batch_size_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<InMemoryBatch> queue_;
+  size_t queue_capacity_;
+
+  // The current batch, and the earlier ones which may still be read on the gpus. A batch is
+  // released once the events of its slot, recorded when the next batch is read, have completed.
+  std::optional<ReadBatch> current_batch_;
+  std::deque<ReadBatch> retired_batches_;
+  size_t num_batches_read_ = 0;
+  std::vector<std::vector<std::vector<core23::Tensor>>> staging_values_;  // [slot][gpu][feature]
+  std::vector<std::vector<cudaEvent_t>> release_events_;                  // [slot][gpu]
+
+  std::vector<core23::Tensor> label_tensors_;
+  std::vector<core23::Tensor> dense_tensors_;
+  std::vector<std::vector<core23::Tensor>> current_sparse_values_;  // [gpu][feature]
+  std::vector<std::vector<core23::Tensor>> current_dp_bucket_ranges_;
+
+  std::vector<cudaEvent_t> split_schedule_events_;
+  std::vector<cudaEvent_t> d2d_schedule_events_;
+  std::vector<cudaStream_t> s3w_streams_;
+  std::vector<cudaStream_t> d2d_streams_;
+};
+
+}  // namespace HugeCTR
@@ -15,8 +15,11 @@
  */
 #pragma once
 
+#include <core23/pinned_host_arena.hpp>
 #include <core23/tensor.hpp>
 #include <data_readers/multi_hot/detail/data_reader_impl.hpp>
+#include <data_readers/multi_hot/synthetic_format.hpp>
+#include <data_readers/multi_hot/variable_format.hpp>
 #include <scheduleable.hpp>
 #include <sparse_tensor.hpp>
 #include <tensor2.hpp>
@@ -25,7 +28,7 @@ namespace MultiHot {
 
 namespace core23_reader {
 template <typename SparseType>
-class AsyncDataReader : public SchedulableDataReader {
+class AsyncDataReader : public SchedulableDataReader, public SparseValueReader {
   using LabelType = float;
   using InputType = int;
 
@@ -35,7 +38,11 @@ class AsyncDataReader : public SchedulableDataReader {
                   size_t num_threads_per_file, size_t num_batches_per_thread,
                   const std::vector<DataReaderSparseParam>& params, size_t label_dim,
                   size_t dense_dim, bool mixed_precision, bool shuffle,
-                  bool schedule_uploads = false, bool is_dense_float = false);
+                  bool schedule_uploads = false, bool is_dense_float = false,
+                  IOBackend_t io_backend = IOBackend_t::AIO, size_t shuffle_window = 1,
+                  const ReaderPosition& start_position = {},
+                  const SyntheticSource& synthetic_source = {},
+                  const TokenBudget& token_budget = {});
 
   long long read_a_batch_to_device_delay_release() override;
   long long get_full_batchsize() const override;
@@ -68,6 +75,8 @@ class AsyncDataReader : public SchedulableDataReader {
   void update_schedule_graph(int raw_device_id) override;
 
   size_t get_max_batches_inflight() const;
+  // State of the next batch, num_prefetched batches earlier, to resume reading from it.
+  ReaderState get_state(size_t num_prefetched = 0) const;
   bool is_mixed_precision();
   // TODO: need to get rid of this, pass the dims directly from Model to the HybridEmbedding
   void get_dimensions(size_t& label_dim, size_t& dense_dim, size_t& sparse_dim,
@@ -84,7 +93,8 @@ class AsyncDataReader : public SchedulableDataReader {
   std::vector<SparseTensor23> get_value_tensor23s() const;
 
   std::vector<std::vector<SparseTensor23>> get_current_sparse_tensor23s() const;
-  std::vector<std::vector<core23::Tensor>>& get_current_sparse_values();
+  std::vector<std::vector<core23::Tensor>>& get_current_sparse_values() override;
+  std::vector<std::vector<core23::Tensor>>& get_current_dp_bucket_ranges() override;
   bool is_batch_cached() const { return current_batch_cached_; }
   size_t get_current_inflight_id() const { return inflight_id_; }  // TODO: remove?
 
@@ -115,6 +125,8 @@ class AsyncDataReader : public SchedulableDataReader {
     std::vector<core23::Tensor> sparse_tensor_ptrs;
     std::vector<std::vector<SparseTensor23>> sparse_tensors;
     std::vector<std::vector<core23::Tensor>> sparse_values;  // check out from sparse_tensors
+    std::vector<core23::Tensor> sparse_row_offset_ptrs;      // variable-length files only
+    std::vector<std::vector<core23::Tensor>> row_offsets;    // variable-length files only
   };
 
   void assign_dense_and_label_tensors(core23::Tensor label_tensor, core23::Tensor dense_tensor,
@@ -122,10 +134,14 @@ class AsyncDataReader : public SchedulableDataReader {
 
   void init_batch_tensors(size_t num_inflight);
 
+  void split_variable_batch(const DataReaderImpl::Batch& batch, int raw_device_id,
+                            BatchTensors& batch_tensors, cudaStream_t stream);
+
   const std::shared_ptr<ResourceManager> resource_manager_;
   std::unique_ptr<DataReaderImpl> reader_impl_;
   size_t sample_size_items_, current_batch_size_;  // current global batch size
   bool mixed_precision_;
+  bool shuffle_;
   size_t batch_size_, batch_size_per_dev_;
   size_t label_dim_, dense_dim_, sparse_dim_;
   std::vector<int> nnz_per_slot_;
@@ -140,6 +156,7 @@ class AsyncDataReader : public SchedulableDataReader {
   std::vector<std::vector<SparseTensor23>> current_sparse_tensors_;  // [gpu][categorical_feature]
   std::vector<std::vector<core23::Tensor>>
       current_sparse_values_;  // the value tensor is checked out from current_sparse_tensors_
+  std::vector<std::vector<core23::Tensor>> current_dp_bucket_ranges_;
 
   bool current_batch_cached_ = false;
 
@@ -158,6 +175,27 @@ class AsyncDataReader : public SchedulableDataReader {
   std::vector<core23::Tensor> max_hotness_tensors_;
   bool is_dense_float_;
   std::vector<core23::Tensor> temp_tensors_;
+
+  // Samples of packed files are unpacked into unpacked_tensors_ before the split.
+  bool packed_ = false;
+  size_t file_sample_size_bytes_;
+  std::vector<core23::Tensor> unpacked_tensors_;
+  std::vector<core23::Tensor> item_bit_offset_tensors_;
+  std::vector<core23::Tensor> key_bits_tensors_;
+
+  // Samples of variable-length files are located by sample_offsets_, and split into CSR tensors.
+  bool variable_ = false;
+  std::shared_ptr<const std::vector<uint64_t>> sample_offsets_;
+  std::vector<core23::Tensor> sample_offset_tensors_;  // word offsets in the local batch
+  std::vector<core23::PinnedHostBuffer> h_sample_offsets_;
+  std::vector<cudaEvent_t> sample_offsets_events_;  // h_sample_offsets_ can be overwritten
+
+  // Synthetic samples are generated into unpacked_tensors_ instead of being read, without end.
+  bool synthetic_ = false;
+  uint64_t synthetic_seed_ = 0;
+  size_t synthetic_batch_id_ = 0;
+  std::vector<core23::Tensor> key_vocabulary_size_tensors_;
+  std::vector<core23::Tensor> key_alpha_tensors_;
 };
 
 };  // namespace core23_reader
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <core23/pinned_host_arena.hpp>
 #include <data_readers/multi_hot/detail/batch_locations.hpp>
 #include <data_readers/multi_hot/detail/io_context.hpp>
 #include <data_readers/multi_hot/detail/time_helper.hpp>
@@ -62,6 +63,9 @@ class BatchFileReader {
     uint8_t* data = nullptr;
     size_t shard_size_bytes = 0;
     size_t batch_size_bytes = 0;
+    size_t first_sample = 0;   // Only set for variable-size samples
+    size_t shard_samples = 0;  // Only set for variable-size samples
+    size_t batch_samples = 0;  // Only set for variable-size samples
     size_t slot_id = 0;
     size_t batch_id = 0;
     size_t batch_i = 0;
@@ -74,7 +78,8 @@ class BatchFileReader {
   };
 
   BatchFileReader(const std::string& fname, size_t slot, size_t max_batches_inflight,
-                  std::unique_ptr<IBatchLocations> batch_locations);
+                  std::unique_ptr<IBatchLocations> batch_locations,
+                  IOBackend_t io_backend = IOBackend_t::AIO, size_t first_batch = 0);
   BatchFileReader(const BatchFileReader& other) = delete;
   ~BatchFileReader();
 
@@ -104,7 +109,8 @@ class BatchFileReader {
   std::unique_ptr<IOContext> io_ctx_;
 
   int fd_;
-  size_t buf_size_ = 0;  // used for numa_free
+  size_t buf_size_ = 0;
+  std::vector<core23::PinnedHostBuffer> host_buffers_;  // Batch buffers, unless read to device
   std::atomic<size_t> num_inflight_ = {0};
 };
 }  // namespace HugeCTR
\ No newline at end of file
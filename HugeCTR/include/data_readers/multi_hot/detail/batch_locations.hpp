@@ -34,6 +34,10 @@ struct BatchDescriptor {
   size_t offset;
   size_t shard_size_bytes;
   size_t batch_size_bytes;
+  // Samples of the shard and of the batch, only set by IndexedBatchLocations.
+  size_t first_sample = 0;
+  size_t shard_samples = 0;
+  size_t batch_samples = 0;
 };
 
 /**
@@ -46,9 +50,12 @@ class IBatchLocations {
   using iterator = BatchForwardIterator;
 
   virtual iterator begin() = 0;
+  // First batch whose position in the global iteration order is at least first_batch
+  virtual iterator begin_at(size_t first_batch) = 0;
   virtual iterator end() = 0;
   virtual size_t count() = 0;
   virtual size_t get_batch_size_bytes() const = 0;
+  virtual size_t get_max_shard_size_bytes() const = 0;
   virtual std::vector<std::unique_ptr<IBatchLocations>> distribute(size_t n) const = 0;
   virtual std::vector<std::unique_ptr<IBatchLocations>> shard(
       size_t n, size_t min_batch_size_bytes) const = 0;
@@ -82,6 +89,8 @@ class BatchLocations : public IBatchLocations {
 
   size_t get_batch_size_bytes() const { return batch_size_bytes_; }
 
+  size_t get_max_shard_size_bytes() const { return shard_size_bytes_; }
+
   std::vector<std::unique_ptr<IBatchLocations>> distribute(size_t n) const {
     std::vector<std::unique_ptr<IBatchLocations>> batch_locations;
     for (size_t i = 0; i < n; ++i) {
@@ -117,6 +126,11 @@ class BatchLocations : public IBatchLocations {
 
   IBatchLocations::iterator begin() { return IBatchLocations::iterator(this, 0ul); }
 
+  IBatchLocations::iterator begin_at(size_t first_batch) {
+    auto it = std::lower_bound(order_.begin(), order_.end(), first_batch);
+    return IBatchLocations::iterator(this, static_cast<size_t>(it - order_.begin()));
+  }
+
   IBatchLocations::iterator end() { return IBatchLocations::iterator(this, ids_.size()); }
 
   size_t count() { return this->end() - this->begin(); }
@@ -131,7 +145,7 @@ class BatchLocations : public IBatchLocations {
     desc.offset = desc.offset >= end_offset_ ? SIZE_MAX : desc.offset;
 
     // size can be clamped by end of file, end of batch, or end of shard.
-    size_t batch_end = (batch_id + 1) * batch_size_bytes_;
+    size_t batch_end = start_offset_ + (batch_id + 1) * batch_size_bytes_;
     size_t shard_end = desc.offset + shard_size_bytes_;
     size_t size = std::min(end_offset_, std::min(batch_end, shard_end)) - desc.offset;
     desc.shard_size_bytes = desc.offset >= end_offset_ ? 0 : size;
@@ -150,4 +164,144 @@ class BatchLocations : public IBatchLocations {
   std::vector<size_t> order_;  // global iteration order
 };
 
+/**
+ * @brief Provides the batch locations of variable-size samples from the offsets of the samples.
+ * Batches and their shards hold a fixed number of samples, so their sizes in bytes vary, unless
+ * the first samples of the batches are given, e.g. of batches with a budget of keys. Batches then
+ * hold up to batch_size samples, and their first shards are full like those of the last batch.
+ */
+class IndexedBatchLocations : public IBatchLocations {
+ public:
+  /**
+   * @param sample_offsets Offsets of the samples in the file, followed by the end of the last one
+   * @param batch_size Number of samples per batch, or max number with batch_first_samples
+   * @param batch_first_samples First samples of the batches, followed by the number of samples
+   */
+  IndexedBatchLocations(std::shared_ptr<const std::vector<uint64_t>> sample_offsets,
+                        size_t batch_size, bool shuffle = false, unsigned long long seed = 0,
+                        std::shared_ptr<const std::vector<size_t>> batch_first_samples = nullptr)
+      : sample_offsets_(std::move(sample_offsets)),
+        num_samples_(sample_offsets_->size() - 1),
+        batch_size_(batch_size),
+        shard_samples_(batch_size),
+        shard_id_(0),
+        batch_first_samples_(batch_first_samples ? std::move(batch_first_samples)
+                                                 : fixed_batch_first_samples()),
+        ids_(batch_first_samples_->size() - 1),
+        order_(ids_.size()) {
+    std::iota(ids_.begin(), ids_.end(), 0);
+    std::iota(order_.begin(), order_.end(), 0);
+
+    if (shuffle) {
+      std::mt19937 gen(seed);
+      std::shuffle(ids_.begin(), ids_.end(), gen);
+    }
+    max_shard_size_bytes_ = compute_max_shard_size_bytes();
+  }
+
+  // Largest shard of this reader, which is all a read buffer needs to hold.
+  size_t get_batch_size_bytes() const { return max_shard_size_bytes_; }
+
+  size_t get_max_shard_size_bytes() const { return max_shard_size_bytes_; }
+
+  std::vector<std::unique_ptr<IBatchLocations>> distribute(size_t n) const {
+    std::vector<std::unique_ptr<IBatchLocations>> batch_locations;
+    for (size_t i = 0; i < n; ++i) {
+      auto other = new IndexedBatchLocations(*this);
+      other->ids_.clear();
+      other->order_.clear();
+      batch_locations.emplace_back(other);
+    }
+
+    // round-robin distribute batches between threads
+    for (size_t i = 0; i < ids_.size(); ++i) {
+      auto other = static_cast<IndexedBatchLocations*>(batch_locations[i % n].get());
+      other->ids_.emplace_back(ids_[i]);
+      other->order_.emplace_back(order_[i]);
+    }
+    return batch_locations;
+  }
+
+  // Shards hold batch_size / n samples, min_batch_size_bytes does not apply to them.
+  std::vector<std::unique_ptr<IBatchLocations>> shard(size_t n, size_t min_batch_size_bytes) const {
+    std::vector<std::unique_ptr<IBatchLocations>> batch_locations;
+    for (size_t i = 0; i < n; ++i) {
+      auto other = new IndexedBatchLocations(*this);
+      other->shard_samples_ = batch_size_ / n;
+      other->shard_id_ = i;
+      other->max_shard_size_bytes_ = other->compute_max_shard_size_bytes();
+      batch_locations.emplace_back(other);
+    }
+    return batch_locations;
+  }
+
+  IBatchLocations::iterator begin() { return IBatchLocations::iterator(this, 0ul); }
+
+  IBatchLocations::iterator begin_at(size_t first_batch) {
+    auto it = std::lower_bound(order_.begin(), order_.end(), first_batch);
+    return IBatchLocations::iterator(this, static_cast<size_t>(it - order_.begin()));
+  }
+
+  IBatchLocations::iterator end() { return IBatchLocations::iterator(this, ids_.size()); }
+
+  size_t count() { return this->end() - this->begin(); }
+
+ private:
+  std::shared_ptr<const std::vector<size_t>> fixed_batch_first_samples() const {
+    auto first_samples = std::make_shared<std::vector<size_t>>();
+    for (size_t first = 0; first < num_samples_; first += batch_size_) {
+      first_samples->push_back(first);
+    }
+    first_samples->push_back(num_samples_);
+    return first_samples;
+  }
+
+  // Sample range [first, last) of a shard of a batch.
+  std::pair<size_t, size_t> shard_range(size_t batch_id) const {
+    const size_t batch_end = (*batch_first_samples_)[batch_id + 1];
+    const size_t first =
+        std::min(batch_end, (*batch_first_samples_)[batch_id] + shard_id_ * shard_samples_);
+    return {first, std::min(batch_end, first + shard_samples_)};
+  }
+
+  size_t compute_max_shard_size_bytes() const {
+    const auto& offsets = *sample_offsets_;
+    size_t max_size = 0;
+    for (size_t batch_id = 0; batch_id < ids_.size(); ++batch_id) {
+      const auto [first, last] = shard_range(batch_id);
+      max_size = std::max<size_t>(max_size, offsets[last] - offsets[first]);
+    }
+    return max_size;
+  }
+
+  BatchDescriptor at(size_t i) {
+    const auto& offsets = *sample_offsets_;
+    size_t batch_id = ids_[i % ids_.size()];
+    const auto [first, last] = shard_range(batch_id);
+    const size_t batch_first = (*batch_first_samples_)[batch_id];
+    const size_t batch_end = (*batch_first_samples_)[batch_id + 1];
+
+    BatchDescriptor desc;
+    desc.i = order_[i % order_.size()];
+    desc.id = batch_id;
+    desc.offset = first < last ? offsets[first] : SIZE_MAX;
+    desc.shard_size_bytes = offsets[last] - offsets[first];
+    desc.batch_size_bytes = offsets[batch_end] - offsets[batch_first];
+    desc.first_sample = first;
+    desc.shard_samples = last - first;
+    desc.batch_samples = batch_end - batch_first;
+    return desc;
+  }
+
+  std::shared_ptr<const std::vector<uint64_t>> sample_offsets_;
+  size_t num_samples_;
+  size_t batch_size_;
+  size_t shard_samples_;
+  size_t shard_id_;
+  size_t max_shard_size_bytes_;
+  std::shared_ptr<const std::vector<size_t>> batch_first_samples_;
+  std::vector<size_t> ids_;    // for shuffle
+  std::vector<size_t> order_;  // global iteration order
+};
+
 }  // namespace HugeCTR
\ No newline at end of file
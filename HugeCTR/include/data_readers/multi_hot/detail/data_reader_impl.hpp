@@ -20,9 +20,11 @@
 #include <data_readers/multi_hot/detail/batch_file_reader.hpp>
 #include <data_readers/multi_hot/detail/device_transfer.hpp>
 #include <data_readers/multi_hot/detail/system_latch.hpp>
+#include <data_readers/multi_hot/reader_state.hpp>
 #include <future>
 #include <memory>
 #include <optional>
+#include <random>
 #include <resource_manager.hpp>
 #include <thread>
 #include <unordered_map>
@@ -37,6 +39,13 @@ struct FileSource {
   std::string name;
   size_t sample_size_bytes;
   size_t slot_id;
+  size_t header_size_bytes = 0;  // Bytes before the first sample
+  // Offsets of variable-size samples in the file and the end of the last one, sample_size_bytes
+  // is then their max size.
+  std::shared_ptr<const std::vector<uint64_t>> sample_offsets;
+  // First samples of the batches of variable-size samples and the number of samples, if the
+  // batches do not hold the batch size.
+  std::shared_ptr<const std::vector<size_t>> batch_first_samples;
 };
 
 enum BatchState {
@@ -86,6 +95,19 @@ class DataReaderImpl {
 
     size_t get_batch_size_bytes() const { return local_batches[0].io_batches[0]->batch_size_bytes; }
 
+    // Sample range of a local batch, and samples of the batch, for variable-size samples.
+    size_t get_local_first_sample(size_t device_id) const {
+      assert(device_id < local_batches.size());
+      return local_batches[device_id].io_batches[0]->first_sample;
+    }
+
+    size_t get_local_batch_samples(size_t device_id) const {
+      assert(device_id < local_batches.size());
+      return local_batches[device_id].io_batches[0]->shard_samples;
+    }
+
+    size_t get_batch_samples() const { return local_batches[0].io_batches[0]->batch_samples; }
+
    private:
     struct LocalBatch {
       std::vector<const BatchFileReader::Batch*> io_batches;  // [slot]
@@ -124,11 +146,15 @@ class DataReaderImpl {
    *                                input_5.bin | 0 0 0 0       input_5.bin | 1 0 0 0
    *                                input_6.bin | 0 0 0 0       input_6.bin | 0 1 0 0
    *                                input_7.bin | 0 0 0 0       input_7.bin | 0 0 0 1
+   * @param shuffle_window Number of consecutive batches whose samples are shuffled together on
+   *                       each GPU, after they are uploaded. 1 disables the sample shuffle.
+   * @param start_position Batch at which the first epoch starts, e.g. to resume a saved position
    */
   DataReaderImpl(const std::vector<FileSource>& source_files,
                  const std::shared_ptr<ResourceManager>& resource_manager, size_t batch_size,
                  size_t num_threads_per_file, size_t num_batches_per_thread, bool shuffle,
-                 bool schedule_uploads);
+                 bool schedule_uploads, IOBackend_t io_backend = IOBackend_t::AIO,
+                 size_t shuffle_window = 1, const ReaderPosition& start_position = {});
   ~DataReaderImpl();
 
   void start();
@@ -143,6 +169,11 @@ class DataReaderImpl {
 
   size_t get_total_inflight_batches() const;
 
+  size_t get_num_batches() const { return num_batches_; }
+
+  // Position of the next batch returned by get_batch(), num_prefetched batches earlier.
+  ReaderPosition get_position(size_t num_prefetched = 0) const;
+
  private:
   Batch& get_parent(size_t batch_i);
 
@@ -150,6 +181,8 @@ class DataReaderImpl {
 
   void upload_batches(size_t device_id);
 
+  void shuffle_samples(size_t device_id, const std::vector<Batch*>& group, cudaStream_t stream);
+
   std::unique_ptr<IBatchLocations> configure_locations(FileSource source, size_t batch_size,
                                                        bool shuffle) const;
 
@@ -167,6 +200,9 @@ class DataReaderImpl {
   std::shared_ptr<ResourceManager> resource_manager_;
   size_t batch_i_ = 0;
   size_t num_batches_ = 0;
+  size_t epoch_ = 0;
+  size_t start_batch_ = 0;
+  unsigned long long seed_ = 0;  // of the batch shuffle
   volatile bool running_ = false;
   bool schedule_uploads_ = false;
   Batch* last_batch_ = nullptr;
@@ -182,6 +218,21 @@ class DataReaderImpl {
 
   std::vector<cudaStream_t> callback_streams_;
   std::vector<cudaEvent_t> callback_events_;
+
+  // Buffers of the sample shuffle across the batches of a group, one per local GPU
+  struct ShuffleBuffers {
+    std::vector<uint8_t*> samples;  // [slot], shuffled samples of the group
+    uint32_t* perm;
+    const uint32_t** srcs;  // [slot][batch]
+    uint32_t* offsets;
+    uint32_t* h_perm;
+    const uint32_t** h_srcs;
+    uint32_t* h_offsets;
+    std::mt19937 gen;
+  };
+  size_t shuffle_window_ = 1;
+  std::vector<size_t> sample_size_bytes_;  // [slot]
+  std::vector<ShuffleBuffers> shuffle_buffers_;
 };
 
 }  // namespace MultiHot
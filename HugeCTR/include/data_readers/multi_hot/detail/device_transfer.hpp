@@ -29,9 +29,10 @@ class DeviceTransfer {
 
   size_t get_device_id() const { return upload_gpu_; }
 
+  // The source is pinned host memory, or device memory if the file reads go to the device.
   void execute(const cudaStream_t& stream) {
     HCTR_LIB_THROW(
-        cudaMemcpyAsync(upload_dst_, upload_src_, size_bytes_, cudaMemcpyHostToDevice, stream));
+        cudaMemcpyAsync(upload_dst_, upload_src_, size_bytes_, cudaMemcpyDefault, stream));
   }
 
  private:
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cufile.h>
+
+#include <data_readers/multi_hot/detail/io_context.hpp>
+#include <unordered_map>
+
+namespace HugeCTR {
+
+/**
+ * IOContext on GPUDirect Storage. The buffers of the requests are device memory of the current
+ * device, into which cuFile DMAs the reads straight from NVMe, without a bounce through host
+ * memory. Requests queued by submit are passed to the cuFile batch API in a single call by
+ * collect. Files must be registered, buffers should be so that cuFile does not map them again
+ * for each read.
+ */
+class GDSContext : public IOContext {
+ public:
+  explicit GDSContext(size_t io_depth);
+  ~GDSContext();
+
+  void submit(const IORequest& request);
+  const std::vector<IOEvent>& collect(size_t min_reqs, size_t timeout_us);
+  size_t get_alignment() const;
+  bool reads_to_device() const { return true; }
+
+  void register_files(const std::vector<int>& fds);
+  void register_buffers(const std::vector<IOBuffer>& buffers);
+
+ private:
+  size_t io_depth_ = 0;
+  size_t num_inflight_ = 0;
+  CUfileBatchHandle_t batch_;
+  std::unordered_map<int, CUfileHandle_t> file_handles_;
+  std::vector<IOBuffer> registered_buffers_;
+  std::vector<CUfileIOParams_t> unsubmitted_;
+  std::vector<CUfileIOEvents_t> tmp_cufile_events_;
+  std::vector<IOEvent> tmp_events_;  // prevent dynamic memory allocation
+};
+
+}  // namespace HugeCTR
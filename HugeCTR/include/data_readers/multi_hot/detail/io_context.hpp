@@ -15,7 +15,9 @@
  */
 #pragma once
 
+#include <common.hpp>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace HugeCTR {
@@ -36,6 +38,7 @@ struct IORequest {
   size_t size;
   size_t offset;
   void* user_data;
+  bool write = false;  // Writes data to the file instead of reading it
 };
 
 // class IOReadRequest : public IORequest {
@@ -48,12 +51,26 @@ struct IOEvent {
   void* user_data;
 };
 
+struct IOBuffer {
+  uint8_t* data;
+  size_t size;
+};
+
 class IOContext {
  public:
   virtual ~IOContext() = default;
   virtual void submit(const IORequest& request) = 0;
   virtual const std::vector<IOEvent>& collect(size_t min_reqs, size_t timeout_us) = 0;
   virtual size_t get_alignment() const = 0;
+  // Whether the buffers of the requests are device memory of the current device.
+  virtual bool reads_to_device() const { return false; }
+
+  // Registers the files and buffers of the requests with the kernel, if the context supports it,
+  // so that they are not looked up and pinned again for each request. Called before any submit.
+  virtual void register_files(const std::vector<int>& fds) {}
+  virtual void register_buffers(const std::vector<IOBuffer>& buffers) {}
 };
 
+std::unique_ptr<IOContext> create_io_context(IOBackend_t backend, size_t io_depth);
+
 }  // namespace HugeCTR
\ No newline at end of file
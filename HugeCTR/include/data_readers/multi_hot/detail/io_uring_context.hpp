@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <liburing.h>
+
+#include <data_readers/multi_hot/detail/io_context.hpp>
+
+namespace HugeCTR {
+
+/**
+ * IOContext on io_uring. Reads into registered buffers use the fixed buffer reads, whose pages
+ * stay pinned, and registered files skip the file table lookup of each read. Submissions are
+ * queued by submit and passed to the kernel in a single call by collect. With sqpoll, a kernel
+ * thread polls the submission queue instead.
+ */
+class IOUringContext : public IOContext {
+ public:
+  IOUringContext(size_t io_depth, bool sqpoll);
+  ~IOUringContext();
+
+  void submit(const IORequest& request);
+  const std::vector<IOEvent>& collect(size_t min_reqs, size_t timeout_us);
+  size_t get_alignment() const;
+
+  void register_files(const std::vector<int>& fds);
+  void register_buffers(const std::vector<IOBuffer>& buffers);
+
+ private:
+  static IOError errno_to_enum(int err);
+
+  size_t io_depth_ = 0;
+  size_t num_inflight_ = 0;
+  size_t num_unsubmitted_ = 0;
+  bool sqpoll_ = false;
+  io_uring ring_;
+  std::vector<int> registered_fds_;
+  std::vector<IOBuffer> registered_buffers_;
+  std::vector<IOEvent> tmp_events_;  // prevent dynamic memory allocation
+  std::vector<io_uring_cqe*> tmp_cqes_;
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+/**
+ * Gathers the samples of a group of batches into dst, in the order of perm. Sample i of the
+ * group is row i - src_offsets[k] of srcs[k], for src_offsets[k] <= i < src_offsets[k + 1].
+ *
+ * @param dst Output of num_samples * sample_words words
+ * @param srcs Device array of the num_srcs batches
+ * @param src_offsets Device array of the num_srcs + 1 first samples of each batch
+ * @param perm Device array of the num_samples group samples to gather
+ */
+void gather_samples(uint32_t* dst, const uint32_t* const* srcs, const uint32_t* src_offsets,
+                    int num_srcs, const uint32_t* perm, uint32_t num_samples, size_t sample_words,
+                    cudaStream_t stream);
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+/**
+ * Packed multi-hot files start with this header, followed by samples of sample_size_bytes. The
+ * bits of a sample hold label_dim FP32 labels, dense_dim FP16 dense features, and the hotness[j]
+ * keys of each feature j with key_bits[j] bits, from the least significant bit of its first
+ * 32-bit word on. Samples are padded to 32 bits. Keys stay fixed-width, so that batches are
+ * located and sharded like those of the raw format.
+ */
+constexpr size_t kPackedHeaderBytes = 4096;
+constexpr size_t kPackedMaxFeatures = 500;
+constexpr char kPackedMagic[8] = {'H', 'C', 'T', 'R', 'P', 'A', 'K', '1'};
+
+struct PackedFileHeader {
+  char magic[8];
+  uint32_t label_dim;
+  uint32_t dense_dim;
+  uint32_t num_features;
+  uint32_t sample_size_bytes;
+  uint32_t hotness[kPackedMaxFeatures];
+  uint32_t key_bits[kPackedMaxFeatures];
+};
+static_assert(sizeof(PackedFileHeader) <= kPackedHeaderBytes);
+
+// Returns whether fname is a packed file, and reads its header if so.
+inline bool read_packed_header(const std::string& fname, PackedFileHeader& header) {
+  std::ifstream file(fname, std::ifstream::binary);
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+  return std::memcmp(header.magic, kPackedMagic, sizeof(kPackedMagic)) == 0;
+}
+
+/**
+ * Unpacks samples into the raw layout of the multi-hot reader, with FP32 dense features.
+ *
+ * @param dst num_samples samples of num_items_per_sample 32-bit words
+ * @param src num_samples packed samples of packed_words 32-bit words
+ * @param item_bit_offsets Device array of the bit offsets of the labels, dense features and keys
+ * @param item_bits Device array of the bits of the keys, one per key
+ */
+template <typename SparseType>
+void unpack_samples(int* dst, const uint32_t* src, int64_t num_samples, int packed_words,
+                    int label_dim, int dense_dim, int num_keys, const uint32_t* item_bit_offsets,
+                    const int* key_bits, cudaStream_t stream);
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+/**
+ * Position of a reader in the batch order of its epochs. Each batch is sharded over all GPUs when
+ * the reader is created, so a position stays valid when a job is restarted on another number of
+ * GPUs, as long as the global batch size and the shuffle seed are kept.
+ */
+struct ReaderPosition {
+  size_t epoch = 0;
+  size_t batch = 0;                        // Next batch, in the order of the epoch
+  std::optional<unsigned long long> seed;  // Shuffle seed, the replica uniform seed if not set
+};
+
+struct ReaderState {
+  static constexpr int version = 1;
+
+  ReaderPosition position;
+  size_t batch_size = 0;
+  size_t num_batches = 0;
+  bool shuffle = false;
+};
+
+void save_reader_state(const std::string& file_name, const ReaderState& state);
+
+ReaderState load_reader_state(const std::string& file_name);
+
+/**
+ * Position at which a reader of batch_size resumes a saved state. If the batch size changed, the
+ * samples are only in the same order without shuffle, and the position is rounded down to the
+ * batch that holds the next sample of the state.
+ */
+ReaderPosition resume_position(const ReaderState& state, size_t batch_size, bool shuffle);
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
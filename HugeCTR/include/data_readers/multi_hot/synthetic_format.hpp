@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+/**
+ * Generates samples on the device instead of reading them from files, to measure the throughput
+ * of a model without its input pipeline. The keys of feature j are drawn from
+ * [0, vocabulary_sizes[j]) with a power law of exponent alphas[j], so that key 0 is the most
+ * frequent one, or uniformly if alphas[j] is 0. Both have one entry per feature.
+ */
+struct SyntheticSource {
+  std::vector<long long> vocabulary_sizes;
+  std::vector<float> alphas;
+  uint64_t seed = 0;
+
+  bool enabled() const { return !vocabulary_sizes.empty(); }
+};
+
+/**
+ * Generates samples in the raw layout of the multi-hot reader: label_dim labels of 0 or 1,
+ * dense_dim FP32 dense features in [0, 1), and num_keys keys. The samples only depend on the seed
+ * and their index, so every GPU generates its shard without communication.
+ *
+ * @param dst num_samples samples of 32-bit words
+ * @param key_vocabulary_sizes Device array of the vocabulary size of the feature of each key
+ * @param key_alphas Device array of the power-law exponent of the feature of each key
+ * @param first_sample Global index of the first sample
+ */
+template <typename SparseType>
+void generate_synthetic_samples(int* dst, int64_t num_samples, int label_dim, int dense_dim,
+                                int num_keys, const long long* key_vocabulary_sizes,
+                                const float* key_alphas, uint64_t seed, uint64_t first_sample,
+                                cudaStream_t stream);
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+/**
+ * Variable-length multi-hot files start with this header, followed by num_samples samples and
+ * the index of their byte offsets. A sample holds label_dim labels and dense_dim dense features
+ * of 32 bits like the raw format, then the int32 number of keys of each feature, and the keys of
+ * each feature with key_bytes bytes. No feature has more keys than its max_hotness. The index at
+ * index_offset holds num_samples + 1 uint64 offsets of the samples from the end of the header.
+ */
+constexpr size_t kVariableHeaderBytes = 4096;
+constexpr size_t kVariableMaxFeatures = 500;
+constexpr char kVariableMagic[8] = {'H', 'C', 'T', 'R', 'V', 'A', 'R', '1'};
+
+// Batches that hold at most max_tokens keys of the features slots, e.g. of the sequences.
+struct TokenBudget {
+  uint64_t max_tokens = 0;
+  std::vector<int> slots;
+
+  bool enabled() const { return max_tokens > 0; }
+};
+
+struct VariableFileHeader {
+  char magic[8];
+  uint32_t label_dim;
+  uint32_t dense_dim;
+  uint32_t num_features;
+  uint32_t key_bytes;
+  uint64_t num_samples;
+  uint64_t index_offset;
+  uint32_t max_hotness[kVariableMaxFeatures];
+};
+static_assert(sizeof(VariableFileHeader) <= kVariableHeaderBytes);
+
+// Returns whether fname is a variable-length file, and reads its header if so.
+inline bool read_variable_header(const std::string& fname, VariableFileHeader& header) {
+  std::ifstream file(fname, std::ifstream::binary);
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+  return std::memcmp(header.magic, kVariableMagic, sizeof(kVariableMagic)) == 0;
+}
+
+// Reads the sample index, rebased to offsets from the beginning of the file.
+inline std::shared_ptr<const std::vector<uint64_t>> read_variable_index(
+    const std::string& fname, const VariableFileHeader& header) {
+  auto offsets = std::make_shared<std::vector<uint64_t>>(header.num_samples + 1);
+  std::ifstream file(fname, std::ifstream::binary);
+  file.seekg(header.index_offset);
+  if (!file.read(reinterpret_cast<char*>(offsets->data()), offsets->size() * sizeof(uint64_t))) {
+    return nullptr;
+  }
+  for (auto& offset : *offsets) {
+    offset += kVariableHeaderBytes;
+  }
+  return offsets;
+}
+
+/**
+ * Reads the number of keys of the features feature_ids in each sample, from the samples at
+ * offsets, which are contiguous. The file is read sequentially in chunks of chunk_bytes.
+ */
+inline std::shared_ptr<const std::vector<uint32_t>> read_variable_num_keys(
+    const std::string& fname, const VariableFileHeader& header,
+    const std::vector<uint64_t>& offsets, const std::vector<int>& feature_ids,
+    size_t chunk_bytes = 64 << 20) {
+  const size_t num_samples = offsets.size() - 1;
+  const size_t counts_offset = (header.label_dim + header.dense_dim) * sizeof(uint32_t);
+  auto num_keys = std::make_shared<std::vector<uint32_t>>(num_samples);
+  std::ifstream file(fname, std::ifstream::binary);
+  std::vector<char> chunk;
+  uint64_t chunk_offset = 0;
+  for (size_t i = 0; i < num_samples; ++i) {
+    const uint64_t counts_begin = offsets[i] + counts_offset;
+    const uint64_t counts_end = counts_begin + header.num_features * sizeof(int32_t);
+    if (counts_begin < chunk_offset || counts_end > chunk_offset + chunk.size()) {
+      chunk_offset = counts_begin;
+      chunk.resize(std::max<uint64_t>(chunk_bytes, counts_end - counts_begin));
+      chunk.resize(std::min<uint64_t>(chunk.size(), offsets.back() - chunk_offset));
+      file.seekg(chunk_offset);
+      if (!file.read(chunk.data(), chunk.size())) {
+        return nullptr;
+      }
+    }
+    const char* counts = chunk.data() + (counts_begin - chunk_offset);
+    for (const int fea_id : feature_ids) {
+      int32_t count;
+      std::memcpy(&count, counts + fea_id * sizeof(int32_t), sizeof(count));
+      (*num_keys)[i] += static_cast<uint32_t>(count);
+    }
+  }
+  return num_keys;
+}
+
+/**
+ * Forms batches of consecutive samples that hold at most batch_size samples and at most
+ * token_budget keys, unless a single sample exceeds it. Returns the first samples of the batches,
+ * followed by the number of samples.
+ */
+inline std::shared_ptr<const std::vector<size_t>> get_token_budget_batches(
+    const std::vector<uint32_t>& num_keys, size_t batch_size, uint64_t token_budget) {
+  auto first_samples = std::make_shared<std::vector<size_t>>();
+  uint64_t batch_keys = 0;
+  size_t batch_samples = 0;
+  for (size_t i = 0; i < num_keys.size(); ++i) {
+    if (batch_samples == 0 || batch_samples == batch_size ||
+        batch_keys + num_keys[i] > token_budget) {
+      first_samples->push_back(i);
+      batch_keys = 0;
+      batch_samples = 0;
+    }
+    batch_keys += num_keys[i];
+    ++batch_samples;
+  }
+  first_samples->push_back(num_keys.size());
+  return first_samples;
+}
+
+/**
+ * Splits variable-length samples into the label, dense and CSR sparse tensors. The row offsets
+ * of each feature are padded with its number of keys past the num_samples valid samples, up to
+ * batch_size_per_dev, like the bucket ranges of the data distributor.
+ *
+ * @param samples Samples of a local batch, of 32-bit words
+ * @param sample_offsets Device array of the num_samples + 1 word offsets of the samples
+ * @param sparse_values Device array of the value pointers of the features
+ * @param sparse_row_offsets Device array of the row offset pointers of the features
+ */
+template <typename DenseType, typename SparseType>
+void split_variable_samples(const int* samples, const uint32_t* sample_offsets, int num_samples,
+                            int batch_size_per_dev, float* label, int label_dim, DenseType* dense,
+                            int dense_dim, SparseType** sparse_values,
+                            SparseType** sparse_row_offsets, int sparse_dim, bool is_dense_float,
+                            cudaStream_t stream);
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
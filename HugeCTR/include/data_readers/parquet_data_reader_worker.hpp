@@ -129,9 +129,9 @@ class ParquetDataReaderWorker : public IDataReaderWorker,
   void post_set_source() override {
     is_eof_ = false;
     if (buffer_)
-      buffer_->state.store(BufferState::ReadyForWrite);
+      store_buffer_state(buffer_->state, BufferState::ReadyForWrite);
     else {
-      buffer23_->state.store(BufferState::ReadyForWrite);
+      store_buffer_state(buffer23_->state, BufferState::ReadyForWrite);
     }
     global_row_group_id_ = 0;
   }
@@ -46,6 +46,8 @@ class RowGroupReadingThread {
   long long local_row_group_id_;  // reset for new file
 
   std::unique_ptr<cudf::table> cached_df_;
+  // Next row group, decoded while the consumers still copy the current one
+  std::unique_ptr<cudf::table> prefetched_df_;
 
   std::map<int, int>& dense_idx_to_parquet_col_;
   std::map<int, int>& categorical_idx_parquet_col_;
@@ -64,6 +66,8 @@ class RowGroupReadingThread {
       std::vector<std::shared_ptr<std::atomic<int>>>& accomplished_workers);
 
   ~RowGroupReadingThread();
+  // decode the next row group, before the producer buffer becomes writeable
+  Error_t prefetch_one_read_group();
   // wait until num_workers_consume_ workers has copied from df_container_producer_[worker_id_]
   Error_t get_one_read_group(const std::vector<DataReaderSparseParam>& params,
                              std::vector<size_t>& dense_dim_array,
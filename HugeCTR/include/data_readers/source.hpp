@@ -47,6 +47,8 @@ class Source {
 
   virtual long long get_num_of_items_in_source() { return 0; }
 
+  virtual std::string get_current_file_name() { return ""; }
+
   virtual bool is_open() noexcept = 0;
 };
 
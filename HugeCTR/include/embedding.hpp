@@ -40,6 +40,11 @@ class IEmbedding {
   virtual GpuLearningRateSchedulers get_learning_rate_schedulers() const {
     return GpuLearningRateSchedulers();
   }
+  // Makes update_params() read the learning rate of each local GPU from its scheduler.
+  virtual void set_learning_rate_schedulers(const GpuLearningRateSchedulers& lr_scheds) {
+    HCTR_OWN_THROW(Error_t::IllegalCall,
+                   "The embedding doesn't support learning rate scheduling on the GPU");
+  }
   virtual size_t get_params_num() const = 0;
   virtual size_t get_vocabulary_size() const = 0;
   virtual size_t get_max_vocabulary_size() const = 0;
@@ -34,7 +34,8 @@ class EmbeddingTrainingCache {
                          std::shared_ptr<ResourceManager> resource_manager,
                          bool use_mixed_precision, bool is_i64_key,
                          std::vector<std::string> local_paths,
-                         std::vector<HMemCacheConfig> hmem_cache_configs) {
+                         std::vector<HMemCacheConfig> hmem_cache_configs,
+                         const WritebackConfig& writeback_config = {}) {
     std::vector<SparseEmbeddingHashParams> embedding_params;
     if (is_i64_key) {
       for (auto& embedding : embeddings) {
@@ -43,7 +44,7 @@ class EmbeddingTrainingCache {
       }
       impl_base_.reset(new EmbeddingTrainingCacheImpl<long long>(
           ps_types, embeddings, embedding_params, sparse_embedding_files, resource_manager,
-          local_paths, hmem_cache_configs));
+          local_paths, hmem_cache_configs, writeback_config));
     } else {
       for (auto& embedding : embeddings) {
         const auto& param = embedding->get_embedding_params();
@@ -51,7 +52,7 @@ class EmbeddingTrainingCache {
       }
       impl_base_.reset(new EmbeddingTrainingCacheImpl<unsigned>(
           ps_types, embeddings, embedding_params, sparse_embedding_files, resource_manager,
-          local_paths, hmem_cache_configs));
+          local_paths, hmem_cache_configs, writeback_config));
     }
   }
 
@@ -61,6 +62,12 @@ class EmbeddingTrainingCache {
 
   void update(std::string& keyset_file) { impl_base_->update(keyset_file); }
 
+  void prefetch(std::vector<std::string>& keyset_file_list) {
+    impl_base_->prefetch(keyset_file_list);
+  }
+
+  void prefetch(std::string& keyset_file) { impl_base_->prefetch(keyset_file); }
+
   std::vector<std::pair<std::vector<long long>, std::vector<float>>> get_incremental_model(
       const std::vector<long long>& keys_to_load) {
     return impl_base_->get_incremental_model(keys_to_load);
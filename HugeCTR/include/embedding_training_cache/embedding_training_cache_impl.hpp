@@ -20,7 +20,9 @@
 #include <embedding_training_cache/parameter_server_manager.hpp>
 #include <embeddings/distributed_slot_sparse_embedding_hash.hpp>
 #include <embeddings/localized_slot_sparse_embedding_hash.hpp>
+#include <future>
 #include <iterator>
+#include <unordered_map>
 
 namespace HugeCTR {
 
@@ -29,6 +31,8 @@ class EmbeddingTrainingCacheImplBase {
   virtual void dump() = 0;
   virtual void update(std::vector<std::string>&) = 0;
   virtual void update(std::string&) = 0;
+  virtual void prefetch(std::vector<std::string>&) = 0;
+  virtual void prefetch(std::string&) = 0;
   virtual void update_sparse_model_file() = 0;
   virtual std::vector<std::pair<std::vector<long long>, std::vector<float>>> get_incremental_model(
       const std::vector<long long>&) = 0;
@@ -40,6 +44,19 @@ class EmbeddingTrainingCacheImpl : public EmbeddingTrainingCacheImplBase {
   std::vector<std::shared_ptr<IEmbedding>> embeddings_;
   ParameterServerManager<TypeKey> ps_manager_;
 
+  // The pass staged by prefetch(), with a buffer bag for each embedding.
+  struct StagedPass {
+    std::vector<std::string> keyset_file_list;
+    std::vector<std::vector<TypeKey>> keysets;
+    std::vector<size_t> hit_sizes;
+    // Row of each key of the keysets in the buffer bags, or SIZE_MAX if it is not in the PS.
+    std::vector<std::unordered_map<TypeKey, size_t>> rows;
+  };
+  std::vector<BufferBag> staged_buf_bags_;
+  StagedPass staged_pass_;
+  // Declared after the buffers, so that its destruction first waits for the staging.
+  std::future<void> prefetch_;
+
   size_t get_max_embedding_size_() {
     size_t max_embedding_size = 0;
     for (auto& one_embedding : embeddings_) {
@@ -56,6 +73,28 @@ class EmbeddingTrainingCacheImpl : public EmbeddingTrainingCacheImplBase {
    */
   void load_(std::vector<std::string>& keyset_file_list);
 
+  /**
+   * @brief Pull the embeddings of the keysets into staged_buf_bags_.
+   */
+  void stage_(std::vector<std::string> keyset_file_list);
+
+  /**
+   * @brief Wait for the staging of prefetch() and rethrow its errors.
+   */
+  void wait_for_prefetch_();
+
+  /**
+   * @brief Copy the dumped embeddings of the staged keys of embedding i into its staged buffer
+   *        bag, so that it holds the trained values of the keys of both passes.
+   */
+  void merge_dumped_rows_(size_t i, size_t dump_size);
+
+  /**
+   * @brief Dump the embeddings and load the staged pass, which only updates the rows of the keys
+   *        of both passes.
+   */
+  void switch_to_staged_pass_();
+
  public:
   EmbeddingTrainingCacheImpl(std::vector<TrainPSType_t>& ps_types,
                              std::vector<std::shared_ptr<IEmbedding>>& embeddings,
@@ -63,7 +102,8 @@ class EmbeddingTrainingCacheImpl : public EmbeddingTrainingCacheImplBase {
                              std::vector<std::string>& sparse_embedding_files,
                              std::shared_ptr<ResourceManager> resource_manager,
                              std::vector<std::string>& local_paths,
-                             std::vector<HMemCacheConfig>& hmem_cache_configs);
+                             std::vector<HMemCacheConfig>& hmem_cache_configs,
+                             const WritebackConfig& writeback_config = {});
 
   EmbeddingTrainingCacheImpl(const EmbeddingTrainingCacheImpl&) = delete;
   EmbeddingTrainingCacheImpl& operator=(const EmbeddingTrainingCacheImpl&) = delete;
@@ -89,6 +129,17 @@ class EmbeddingTrainingCacheImpl : public EmbeddingTrainingCacheImplBase {
    */
   void update(std::string& keyset_file) override;
 
+  /**
+   * @brief Stages the embeddings of the next pass from the PS into host memory in the
+   *        background, while the current pass trains. The next update() with the same keysets
+   *        then only synchronizes the keys of both passes with the trained embeddings. It
+   *        requires a second host buffer of each embedding for the staged pass.
+   * @param keyset_file_list The file list storing keyset files of the next pass.
+   */
+  void prefetch(std::vector<std::string>& keyset_file_list) override;
+
+  void prefetch(std::string& keyset_file) override;
+
   std::vector<std::pair<std::vector<long long>, std::vector<float>>> get_incremental_model(
       const std::vector<long long>& keys_to_load) override;
 
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <parallel_hashmap/phmap.h>
+
 #include <embedding_training_cache/hmem_cache/sparse_model_file_ts.hpp>
 
 namespace HugeCTR {
@@ -24,48 +26,79 @@ struct HMemCacheConfig {
   double target_hit_rate;
   size_t max_num_evict;
   size_t block_capacity;
+  // Rows pulled at least this many times stay in host memory when their block is evicted.
+  size_t hot_row_min_access{2};
 
   HMemCacheConfig() {}
-  HMemCacheConfig(size_t _num_cached_pass, double _target_hit_rate, size_t _max_num_evict)
+  HMemCacheConfig(size_t _num_cached_pass, double _target_hit_rate, size_t _max_num_evict,
+                  size_t _hot_row_min_access = 2)
       : num_cached_pass(_num_cached_pass),
         target_hit_rate(_target_hit_rate),
-        max_num_evict(_max_num_evict) {}
+        max_num_evict(_max_num_evict),
+        hot_row_min_access(_hot_row_min_access) {}
 };
 
 template <typename TypeKey>
 class HMemCache {
  public:
-  using HashTableType = typename SparseModelFileTS<TypeKey>::HashTableType;
   size_t static const end_flag{SparseModelFileTS<TypeKey>::end_flag};
+  // The index is partitioned by key, so that each thread updates one partition.
+  size_t static constexpr num_partitions{32};
 
  private:
   int const num_block_;
   double const target_hit_rate_;
   size_t const max_num_evict_;
   size_t const block_capacity_;
+  size_t const hot_row_min_access_;
 
   const bool use_slot_id_;
   const size_t emb_vec_size_;
   const size_t vec_per_line_;
   std::shared_ptr<ResourceManager> resource_manager_;
 
-  std::vector<HashTableType> key_idx_maps_;
+  // Keys of the lines of each block.
+  std::vector<std::vector<TypeKey>> block_keys_;
   std::vector<std::vector<size_t>> slot_ids_;
   std::vector<std::vector<std::vector<float>>> cache_datas_;
+  // Number of pulls of each line, halved each time the line outlives the eviction of its block.
+  std::vector<std::vector<uint32_t>> access_counts_;
+  // Line (blk_idx * block_capacity_ + line_idx) of the newest block holding each key.
+  std::vector<phmap::flat_hash_map<TypeKey, size_t>> index_;
 
   bool is_full_{false};
   int head_id_{-1};
 
   std::shared_ptr<SparseModelFileTS<TypeKey>> sparse_model_file_ptr_;
 
-  size_t find_(TypeKey key);
+  static size_t partition_of_(TypeKey key) {
+    // Top 5 bits of a Fibonacci hash, to also spread keys of a regular stride.
+    static_assert(num_partitions == 32);
+    return (static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 59;
+  }
+  size_t find_(TypeKey key) const;
   std::pair<int, size_t> cascade_find_(TypeKey key);
 
+  /**
+   * @brief Replace the evicted keys of block blk_idx with keys in the index. Only the entries of
+   *        the evicted keys that still point to blk_idx are removed, as newer blocks may hold them.
+   *        The keys are put into the lines from first_line on.
+   */
+  void update_index_(std::vector<TypeKey> const &evicted_keys, int blk_idx, TypeKey const *keys,
+                     size_t len, size_t first_line = 0);
+
+  /**
+   * @brief Move the hot lines of the evicted block, which is in the temp buffer, into the free
+   *        lines of block blk_idx behind its first num_used lines. Only lines that no newer block
+   *        holds are moved, the hottest first. Returns the number of moved lines.
+   */
+  size_t retain_hot_lines_(int blk_idx, size_t num_used);
+
  public:
   HMemCache(size_t num_cached_pass, double target_hit_rate, size_t max_num_evict,
             size_t max_vocabulary_size, std::string sparse_model_file, std::string local_path,
             bool use_slot_id, Optimizer_t opt_type, size_t emb_vec_size,
-            std::shared_ptr<ResourceManager> resource_manager);
+            std::shared_ptr<ResourceManager> resource_manager, size_t hot_row_min_access = 2);
 
   std::pair<std::vector<long long>, std::vector<float>> read(long long const *key_ptr, size_t len);
   void read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr, std::vector<float *> &data_ptrs);
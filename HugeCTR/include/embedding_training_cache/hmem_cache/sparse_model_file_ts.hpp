@@ -100,7 +100,7 @@ class SparseModelFileTS {
    *                  states. data_ptrs[0] is for the embedding vector, and
    *                  data_ptrs[1~data_ptrs.size()-1] are for the opt state(s).
    */
-  void dump_update(HashTableType &dump_key_idx_map, std::vector<size_t> &slot_id_vec,
+  void dump_update(std::vector<TypeKey> const &dump_keys, std::vector<size_t> &slot_id_vec,
                    std::vector<std::vector<float>> &data_vecs);
 
   void dump_update(std::vector<size_t> const &ssd_idx_vec, std::vector<size_t> const &mem_idx_vec,
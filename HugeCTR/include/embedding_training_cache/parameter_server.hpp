@@ -43,7 +43,8 @@ class ParameterServer {
   ParameterServer(TrainPSType_t ps_type, const std::string &sparse_model_file,
                   Embedding_t embedding_type, Optimizer_t opt_type, size_t emb_vec_size,
                   std::shared_ptr<ResourceManager> resource_manager, std::string local_path = "./",
-                  HMemCacheConfig hmem_cache_config = HMemCacheConfig());
+                  HMemCacheConfig hmem_cache_config = HMemCacheConfig(),
+                  const WritebackConfig &writeback_config = {});
 
   ParameterServer(const ParameterServer &) = delete;
   ParameterServer &operator=(const ParameterServer &) = delete;
@@ -56,6 +57,15 @@ class ParameterServer {
    */
   void load_keyset_from_file(std::string keyset_file);
 
+  /**
+   * @brief Read a keyset from SSD without storing it in keyset_. Unlike
+   *        load_keyset_from_file, it doesn't synchronize the ranks.
+   * @param keyset_file The file storing keyset to be read.
+   */
+  std::vector<TypeKey> read_keyset_from_file(const std::string &keyset_file);
+
+  void set_keyset(std::vector<TypeKey> &&keyset) { keyset_ = std::move(keyset); }
+
   /**
    * @brief Pull embedding vectors from the sparse embedding model according to
    *        keyset_. It only loads embedding vectors that their corresponding
@@ -65,6 +75,11 @@ class ParameterServer {
    */
   void pull(BufferBag &buf_bag, size_t &hit_size);
 
+  /**
+   * @brief Pull embedding vectors of the given keys instead of keyset_.
+   */
+  void pull(std::vector<TypeKey> &keys, BufferBag &buf_bag, size_t &hit_size);
+
   std::pair<std::vector<long long>, std::vector<float>> pull(
       const std::vector<long long> &keys_to_load);
 
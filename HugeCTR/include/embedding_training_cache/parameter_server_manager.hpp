@@ -26,6 +26,8 @@ template <typename TypeKey>
 class ParameterServerManager {
   std::vector<std::shared_ptr<ParameterServer<TypeKey>>> ps_;
   BufferBag buf_bag_;
+  size_t buffer_size_;
+  size_t max_vec_size_;
 
  public:
   ParameterServerManager(std::vector<TrainPSType_t>& ps_types,
@@ -34,7 +36,8 @@ class ParameterServerManager {
                          std::vector<SparseEmbeddingHashParams>& embedding_params,
                          size_t buffer_size, std::shared_ptr<ResourceManager> resource_manager,
                          std::vector<std::string>& local_paths,
-                         std::vector<HMemCacheConfig>& hmem_cache_configs);
+                         std::vector<HMemCacheConfig>& hmem_cache_configs,
+                         const WritebackConfig& writeback_config = {});
 
   ParameterServerManager(const ParameterServerManager&) = delete;
   ParameterServerManager& operator=(const ParameterServerManager&) = delete;
@@ -45,6 +48,12 @@ class ParameterServerManager {
 
   BufferBag& get_buffer_bag() { return buf_bag_; }
 
+  /**
+   * @brief Allocate another host buffer for the keys, slot_id, embedding vectors and optimizer
+   *        states of a pass. It shares the device buffers of get_buffer_bag().
+   */
+  BufferBag create_staging_buffer_bag();
+
   void update_sparse_model_file() {
     for (auto& ps : ps_) ps->flush_emb_tbl_to_ssd();
   }
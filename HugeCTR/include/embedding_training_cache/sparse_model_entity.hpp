@@ -34,7 +34,8 @@ class SparseModelEntity {
 
  public:
   SparseModelEntity(const std::string &sparse_model_file, Embedding_t embedding_type,
-                    size_t emb_vec_size, std::shared_ptr<ResourceManager> resource_manager);
+                    size_t emb_vec_size, std::shared_ptr<ResourceManager> resource_manager,
+                    const WritebackConfig &writeback_config = {});
 
   /**
    * @brief Load embedding features (embedding vectors) through provided keys
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <embedding_training_cache/sparse_model_writeback.hpp>
 #include <memory>
 #include <resource_manager.hpp>
 #include <unordered_map>
@@ -42,14 +43,18 @@ class SparseModelFile {
   bool is_distributed_;
   size_t emb_vec_size_;
   std::shared_ptr<ResourceManager> resource_manager_;
+  WritebackConfig writeback_config_;
+  std::unique_ptr<SparseModelWriteback> writeback_;
 
   void map_embedding_to_memory_();
   void sync_mmaped_embedding_with_disk_();
   void unmap_embedding_from_memory_();
+  SparseModelWriteback* get_writeback_();
 
  public:
   SparseModelFile(const std::string& sparse_model_file, Embedding_t embedding_type,
-                  size_t emb_vec_size, std::shared_ptr<ResourceManager> resource_manager);
+                  size_t emb_vec_size, std::shared_ptr<ResourceManager> resource_manager,
+                  const WritebackConfig& writeback_config = {});
 
   HashTableType& get_key_index_map() { return key_idx_map_; }
 
@@ -79,10 +84,17 @@ class SparseModelFile {
    * @param vec_indices The memory indices of vectors in vecs. These indices are corresponding to
    *                    embedding vectors mapping by keys.
    * @param vecs Array storing the embedding vectors to be dumped.
+   * With a writeback budget, the vectors are copied and written in the background, see
+   * wait_for_writeback().
    */
   void dump_exist_vec_by_key(const std::vector<TypeKey>& keys,
                              const std::vector<size_t>& vec_indices, const float* vecs);
 
+  // Blocks until the vectors dumped in the background are on disk.
+  void wait_for_writeback() {
+    if (writeback_) writeback_->wait();
+  }
+
   /**
    * @brief Append <key, emb_vector> (distributed embedding) or <key, slot_id, emb_vector> (
    *        localized embedding) to disk.
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <common.hpp>
+#include <condition_variable>
+#include <data_readers/multi_hot/detail/io_context.hpp>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace HugeCTR {
+
+struct WritebackConfig {
+  // Bytes of queued rows above which writes block, 0 to write through mmap instead.
+  size_t dirty_budget_bytes = 0;
+  IOBackend_t io_backend = IOBackend_t::AIO;
+};
+
+/**
+ * Writes rows of a file of fixed-size rows in the background with O_DIRECT, through the IO
+ * contexts of the multi-hot reader, so that the writes neither go through nor evict the page
+ * cache. The queued rows are copied, and write() only blocks while the queued bytes exceed the
+ * dirty budget. The writer sorts the rows of each write by offset and coalesces them into aligned
+ * extents. Extents that the rows don't cover completely are read before they are written, and the
+ * unaligned tail of the file is written through the page cache.
+ */
+class SparseModelWriteback {
+ public:
+  SparseModelWriteback(const std::string& file_name, size_t row_size_bytes,
+                       const WritebackConfig& config, size_t io_depth = 16,
+                       size_t extent_size_bytes = 1 << 20);
+  ~SparseModelWriteback();
+
+  SparseModelWriteback(const SparseModelWriteback&) = delete;
+  SparseModelWriteback& operator=(const SparseModelWriteback&) = delete;
+
+  /**
+   * Queues row src_rows[i] of src to row rows[i] of the file. A row written several times
+   * holds its last value.
+   */
+  void write(const std::vector<size_t>& rows, const std::vector<size_t>& src_rows,
+             const float* src);
+
+  // Blocks until the queued rows are on disk, and rethrows the errors of the writer.
+  void wait();
+
+ private:
+  struct Batch {
+    std::vector<size_t> rows;
+    std::vector<char> data;
+  };
+  struct Extent {
+    uint8_t* buffer;
+    size_t begin;
+    size_t end;  // Aligned end of the blocks written with O_DIRECT
+    size_t first_row;
+    size_t last_row;  // Inclusive
+    bool reading = false;
+  };
+
+  void run_();
+  void write_batch_(Batch& batch);
+  void copy_rows_(const Batch& batch, const std::vector<size_t>& order, const Extent& extent);
+  void submit_(Extent& extent, bool is_write);
+  void complete_(size_t min_reqs, const Batch& batch, const std::vector<size_t>& order);
+
+  const std::string file_name_;
+  const size_t row_size_bytes_;
+  const size_t dirty_budget_bytes_;
+  const size_t extent_size_bytes_;
+  int direct_fd_ = -1;
+  int buffered_fd_ = -1;
+  std::unique_ptr<IOContext> io_ctx_;
+  size_t alignment_;
+  uint8_t* buffers_ = nullptr;
+  std::vector<Extent> extents_;
+  std::vector<Extent*> free_extents_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Batch> queue_;
+  size_t dirty_bytes_ = 0;
+  bool writing_ = false;
+  bool stop_ = false;
+  std::exception_ptr error_;
+  std::thread thread_;
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Key statistics of a table, as computed by tools/dataset_stats over a whole dataset.
+ */
+struct TableKeyStats {
+  int64_t num_keys;        // Keys of all samples
+  double num_unique_keys;  // HyperLogLog estimate of the distinct keys
+  // Number of samples with each number of keys
+  std::map<int64_t, int64_t> pooling_factor_histogram;
+  // Approximate most frequent keys with their counts, in descending order of counts
+  std::vector<std::pair<int64_t, int64_t>> top_keys;
+
+  double mean_pooling_factor(int64_t num_samples) const {
+    return num_samples > 0 ? static_cast<double>(num_keys) / num_samples : 0;
+  }
+};
+
+struct DatasetStats {
+  static constexpr int version{1};
+
+  int64_t num_samples;
+  std::map<std::string, TableKeyStats> tables;  // By table name
+};
+
+/**
+ * Loads a stats file of tools/dataset_stats. Throws if it cannot be read, or has another version.
+ */
+DatasetStats load_dataset_stats(const std::string& file_name);
+
+/**
+ * Writes a stats file in the format of tools/dataset_stats. It is written next to file_name and
+ * renamed, so that readers never see a partial file.
+ */
+void save_dataset_stats(const DatasetStats& stats, const std::string& file_name);
+
+}  // namespace HugeCTR
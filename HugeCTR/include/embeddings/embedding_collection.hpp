@@ -23,6 +23,9 @@
 #include <embedding/operators/transpose_input.hpp>
 #include <embedding_storage/embedding_table.hpp>
 #include <embedding_storage/ragged_static_embedding.hpp>
+#include <embeddings/dataset_stats.hpp>
+#include <embeddings/shard_planner.hpp>
+#include <functional>
 #include <include/exchange_wgrad.hpp>
 #include <include/network_buffer_channels.hpp>
 #include <optimizer.hpp>
@@ -37,9 +40,13 @@ class EmbeddingTableConfig {
 
   EmbeddingTableConfig() {}
 
-  EmbeddingTableConfig(const std::string &name, int max_vocabulary_size, int ev_size,
-                       std::optional<HugeCTR::OptParams> opt_param_or_empty,
-                       std::optional<::embedding::InitParams> init_param_or_empty)
+  EmbeddingTableConfig(
+      const std::string &name, int max_vocabulary_size, int ev_size,
+      std::optional<HugeCTR::OptParams> opt_param_or_empty,
+      std::optional<::embedding::InitParams> init_param_or_empty,
+      std::optional<::embedding::EvictionParams> eviction_param_or_empty = {},
+      int num_gpu_cached_rows = 0,
+      std::optional<::embedding::CompositionalParams> compositional_param_or_empty = {})
       : name(name) {
     HugeCTR::OptParams opt_param;
     if (opt_param_or_empty.has_value()) {
@@ -53,8 +60,32 @@ class EmbeddingTableConfig {
       init_param = init_param_or_empty.value();
     }
 
-    this->table_param =
-        ::embedding::EmbeddingTableParam{-1, max_vocabulary_size, ev_size, opt_param, init_param};
+    ::embedding::EvictionParams eviction_param;
+    if (eviction_param_or_empty.has_value()) {
+      eviction_param = eviction_param_or_empty.value();
+      HCTR_CHECK_HINT(
+          max_vocabulary_size < 0 || eviction_param.policy == ::embedding::EvictionPolicy::Disabled,
+          "Eviction is only supported by dynamic tables, whose max_vocabulary_size is -1.");
+    }
+
+    HCTR_CHECK_HINT(num_gpu_cached_rows == 0 || max_vocabulary_size > 0,
+                    "Only static tables, which have a max_vocabulary_size, can be kept in host "
+                    "memory with num_gpu_cached_rows.");
+    HCTR_CHECK_HINT(num_gpu_cached_rows >= 0, "num_gpu_cached_rows must not be negative.");
+
+    ::embedding::CompositionalParams compositional_param;
+    if (compositional_param_or_empty.has_value()) {
+      compositional_param = compositional_param_or_empty.value();
+      HCTR_CHECK_HINT(
+          compositional_param.combiner == ::embedding::CompositionalCombiner::Disabled ||
+              (max_vocabulary_size > 0 && num_gpu_cached_rows == 0),
+          "Only static tables on the gpus, which have a max_vocabulary_size and no "
+          "num_gpu_cached_rows, can be compositional.");
+    }
+
+    this->table_param = ::embedding::EmbeddingTableParam{
+        -1, max_vocabulary_size, ev_size, opt_param, init_param, eviction_param,
+        num_gpu_cached_rows, compositional_param};
   }
 };
 
@@ -78,6 +109,32 @@ class EmbeddingCollectionConfig {
 
   std::vector<ShardStrategy> shard_strategy_;
   std::vector<std::vector<std::string>> shard_matrix_;
+  // If set, the shard matrix and strategy are planned when the collection is added to the model.
+  std::optional<ShardPlannerParams> shard_planner_params_;
+  // Keys of model parallel tables whose rows are replicated on all GPUs, by table name.
+  std::map<std::string, std::vector<int64_t>> frequent_keys_;
+  // Model parallel tables whose keys are deduplicated before the all-to-all, by table name.
+  std::vector<std::string> unique_key_tables_;
+  // Tables whose gradients are reduced in a fixed order, by table name.
+  std::vector<std::string> deterministic_tables_;
+  // Number of streams that the grouped lookups compute on, and the stream priority of the groups
+  // of each table, by table name.
+  int num_lookup_streams_ = 1;
+  std::map<std::string, int> stream_priorities_;
+  // Keyset files of the tables whose keys are remapped to their rows by a perfect hash, by table
+  // name.
+  std::map<std::string, std::string> static_vocabulary_files_;
+  // Features that hash or cross input features on the gpus, by name. They are the bottom names of
+  // the lookups of their keys.
+  struct VirtualFeatureConfig {
+    std::vector<std::string> bottom_names;
+    ::embedding::FeatureHashFunction hash_function;
+    int64_t num_buckets;
+    int64_t seed;
+  };
+  std::map<std::string, VirtualFeatureConfig> virtual_features_;
+  // Whether the 64-bit input keys of static tables are converted to 32-bit keys and offsets.
+  bool use_32bit_keys_ = false;
 
   ::embedding::EmbeddingLayout output_layout_;
 
@@ -85,21 +142,42 @@ class EmbeddingCollectionConfig {
   ::embedding::KeysPreprocessStrategy keys_preprocess_strategy_;
   ::embedding::AllreduceStrategy allreduce_strategy_;
   ::embedding::CommunicationStrategy comm_strategy_;
+  ::embedding::CommQuantizationStrategy comm_quantization_strategy_;
+  ::embedding::TableStorageType table_storage_type_;
+  bool use_p2p_all2all_;
 
   std::string batch_major_output_name_;
 
   // if we need more configuration about EmbeddingCollection
   EmbeddingCollectionConfig(bool use_exclusive_keys,
-                            ::embedding::CommunicationStrategy comm_strategy)
+                            ::embedding::CommunicationStrategy comm_strategy,
+                            ::embedding::CommQuantizationStrategy comm_quantization_strategy =
+                                ::embedding::CommQuantizationStrategy::Disabled,
+                            ::embedding::TableStorageType table_storage_type =
+                                ::embedding::TableStorageType::FP32,
+                            bool use_hash_local_reduce = false, bool use_p2p_all2all = false)
       : output_layout_(::embedding::EmbeddingLayout::FeatureMajor),
-        sort_strategy_(use_exclusive_keys ? ::embedding::SortStrategy::Radix
-                                          : ::embedding::SortStrategy::Segmented),
+        sort_strategy_(use_hash_local_reduce ? ::embedding::SortStrategy::Hash
+                       : use_exclusive_keys  ? ::embedding::SortStrategy::Radix
+                                             : ::embedding::SortStrategy::Segmented),
         keys_preprocess_strategy_(::embedding::KeysPreprocessStrategy::AddOffset),
         allreduce_strategy_(::embedding::AllreduceStrategy::Dense),
-        comm_strategy_(comm_strategy) {
+        comm_strategy_(comm_strategy),
+        comm_quantization_strategy_(comm_quantization_strategy),
+        table_storage_type_(table_storage_type),
+        use_p2p_all2all_(use_p2p_all2all) {
     if (comm_strategy_ == ::embedding::CommunicationStrategy::Hierarchical) {
       HCTR_LOG(INFO, ROOT, "Using Hier Communication Strategy\n");
     }
+    HCTR_CHECK_HINT(
+        comm_quantization_strategy_ == ::embedding::CommQuantizationStrategy::Disabled ||
+            comm_strategy_ == ::embedding::CommunicationStrategy::Uniform,
+        "All-to-all quantization requires the uniform communication strategy.");
+    HCTR_CHECK_HINT(
+        !use_p2p_all2all_ ||
+            (comm_strategy_ == ::embedding::CommunicationStrategy::Uniform &&
+             comm_quantization_strategy_ == ::embedding::CommQuantizationStrategy::Disabled),
+        "P2P all-to-all requires the uniform communication strategy without quantization.");
   }
 
   void embedding_lookup(const EmbeddingTableConfig &emb_table_config,
@@ -160,6 +238,91 @@ class EmbeddingCollectionConfig {
 
     shard_matrix_ = shard_matrix;
     shard_strategy_ = shard_strategy;
+    shard_planner_params_.reset();
+  }
+
+  void auto_shard(const ShardPlannerParams &shard_planner_params) {
+    shard_matrix_.clear();
+    shard_strategy_.clear();
+
+    shard_planner_params_ = shard_planner_params;
+  }
+
+  void replicate_frequent_keys(const std::map<std::string, std::vector<int64_t>> &frequent_keys) {
+    frequent_keys_ = frequent_keys;
+  }
+
+  // Replicates the num_keys most frequent keys of each table of a tools/dataset_stats file.
+  void replicate_frequent_keys(const std::string &dataset_stats,
+                               const std::map<std::string, int> &num_keys) {
+    const DatasetStats stats{load_dataset_stats(dataset_stats)};
+    std::map<std::string, std::vector<int64_t>> frequent_keys;
+    for (const auto &[table_name, n] : num_keys) {
+      const auto it{stats.tables.find(table_name)};
+      HCTR_CHECK_HINT(it != stats.tables.end(), "Table ", table_name, " is not in ",
+                      dataset_stats);
+      const auto &top_keys{it->second.top_keys};
+      HCTR_CHECK_HINT(n <= static_cast<int>(top_keys.size()), dataset_stats, " only has ",
+                      top_keys.size(), " frequent keys of table ", table_name);
+      for (int i = 0; i < n; ++i) {
+        frequent_keys[table_name].push_back(top_keys[i].first);
+      }
+    }
+    replicate_frequent_keys(frequent_keys);
+  }
+
+  void deduplicate_keys(const std::vector<std::string> &table_names) {
+    unique_key_tables_ = table_names;
+  }
+
+  void deterministic_reduction(const std::vector<std::string> &table_names) {
+    HCTR_CHECK_HINT(sort_strategy_ != ::embedding::SortStrategy::Hash,
+                    "Deterministic reduction requires use_hash_local_reduce=False, since the hash "
+                    "local reduce does not preserve the order of the keys.");
+    deterministic_tables_ = table_names;
+  }
+
+  void lookup_streams(int num_streams, const std::map<std::string, int> &stream_priorities) {
+    HCTR_CHECK_HINT(num_streams >= 1, "lookup_streams requires at least 1 stream.");
+    num_lookup_streams_ = num_streams;
+    stream_priorities_ = stream_priorities;
+  }
+
+  void static_vocabulary(const std::map<std::string, std::string> &keyset_files) {
+    static_vocabulary_files_ = keyset_files;
+  }
+
+  void feature_hash(const std::string &top_name, const std::string &bottom_name,
+                    const std::string &hash_function, int64_t num_buckets, int64_t seed) {
+    add_virtual_feature(top_name, {bottom_name}, hash_function, num_buckets, seed);
+  }
+
+  void feature_cross(const std::string &top_name, const std::vector<std::string> &bottom_names,
+                     const std::string &hash_function, int64_t num_buckets, int64_t seed) {
+    HCTR_CHECK_HINT(bottom_names.size() == 2, "feature_cross error, ", top_name,
+                    " must cross 2 features.");
+    add_virtual_feature(top_name, bottom_names, hash_function, num_buckets, seed);
+  }
+
+  void use_32bit_keys() { use_32bit_keys_ = true; }
+
+ private:
+  void add_virtual_feature(const std::string &top_name,
+                           const std::vector<std::string> &bottom_names,
+                           const std::string &hash_function_str, int64_t num_buckets,
+                           int64_t seed) {
+    ::embedding::FeatureHashFunction hash_function;
+    if (hash_function_str == "murmur") {
+      hash_function = ::embedding::FeatureHashFunction::Murmur;
+    } else if (hash_function_str == "xxhash") {
+      hash_function = ::embedding::FeatureHashFunction::XXHash;
+    } else {
+      HCTR_OWN_THROW(Error_t::WrongInput, hash_function_str + " is not supported.");
+    }
+    HCTR_CHECK_HINT(num_buckets >= 0, "The num_buckets of ", top_name, " must not be negative.");
+    HCTR_CHECK_HINT(virtual_features_.find(top_name) == virtual_features_.end(),
+                    "Duplicate virtual feature: ", top_name);
+    virtual_features_[top_name] = {bottom_names, hash_function, num_buckets, seed};
   }
 };
 
@@ -245,7 +408,7 @@ inline std::vector<::embedding::GroupedTableParam> create_grouped_embedding_para
   for (auto &shard_strategy : config.shard_strategy_) {
     auto placement_strategy_string = get_table_place_strategy(shard_strategy);
     ::embedding::TablePlacementStrategy placement_strategy;
-    if (placement_strategy_string == "mp") {
+    if (placement_strategy_string == "mp" || placement_strategy_string == "mp_column") {
       placement_strategy = ::embedding::TablePlacementStrategy::ModelParallel;
     } else if (placement_strategy_string == "dp") {
       placement_strategy = ::embedding::TablePlacementStrategy::DataParallel;
@@ -263,6 +426,30 @@ inline std::vector<::embedding::GroupedTableParam> create_grouped_embedding_para
     }
     // require ordered
     std::sort(table_ids.begin(), table_ids.end());
+    if (placement_strategy_string == "mp_column") {
+      // Split each table column-wise over the GPUs that it is placed on. Column shard i of all
+      // tables is grouped, so that the GPUs of each group receive all keys of its tables.
+      std::map<int, int> table_id_to_num_column_shards;
+      for (const auto &shard_on_each_gpu : config.shard_matrix_) {
+        for (const auto &name : shard_on_each_gpu) {
+          if (table_name_to_id_dict.find(name) != table_name_to_id_dict.end()) {
+            table_id_to_num_column_shards[table_name_to_id_dict.at(name)] += 1;
+          }
+        }
+      }
+      for (int column_shard_id = 0;; ++column_shard_id) {
+        std::vector<int> column_shard_table_ids;
+        for (int table_id : table_ids) {
+          if (table_id_to_num_column_shards[table_id] > column_shard_id) {
+            column_shard_table_ids.push_back(table_id);
+          }
+        }
+        if (column_shard_table_ids.empty()) break;
+        grouped_embedding_params.emplace_back(placement_strategy, column_shard_table_ids,
+                                              column_shard_id);
+      }
+      continue;
+    }
     ::embedding::GroupedTableParam grouped_emb_param{placement_strategy, table_ids};
     grouped_embedding_params.push_back(std::move(grouped_emb_param));
   }
@@ -295,11 +482,25 @@ class EmbeddingCollection {
 
   void init_peer_buffer(std::vector<std::shared_ptr<CoreResourceManager>> core);
 
+  void init_p2p_all2all(std::vector<std::shared_ptr<CoreResourceManager>> core);
+
+  // Whether the groups of a stage only compute on their own buffers, so that they can run
+  // concurrently. Stages with collectives or GPU barriers must run in the same order on all GPUs.
+  bool is_concurrent_stage(Stage stage) const;
+
+  // Runs a stage for each group that it is valid for. Concurrent stages run on the lookup streams,
+  // which fork from and join into the current stream.
+  void run_grouped_stage(Stage stage, int gpu_id, const EmbeddingCollectionParam &ebc_param,
+                         const std::vector<std::unique_ptr<IGroupedEmbeddingOp>> &embeddings,
+                         const std::function<void(size_t)> &run_group);
+
   IGroupedEmbeddingTable *get_table(int gpu_id, size_t grouped_id) {
     int grouped_table_id = ebc_param_.grouped_lookup_params[grouped_id].grouped_table_idx;
     if (grouped_table_id == -1) {
       HCTR_CHECK(ebc_param_.grouped_lookup_params[grouped_id].embedding_type ==
-                 EmbeddingType::FrequentDense);
+                     EmbeddingType::FrequentDense ||
+                 ebc_param_.grouped_lookup_params[grouped_id].embedding_type ==
+                     EmbeddingType::FrequentSparse);
       return frequent_embedding_tables_[gpu_id].get();
     }
 
@@ -326,6 +527,11 @@ class EmbeddingCollection {
   void cache_ddl_output(int gpu_id, const HugeCTR::DataDistributor::Result &input,
                         HugeCTR::DataDistributor::Result &output, int batch_size);
 
+  // Lets the tables prepare the rows of input, the keys of a following batch, e.g. by moving them
+  // into the gpu caches of tables in host memory or inserting them into dynamic tables. It runs on
+  // the current stream, and may overlap the forward and backward of the current batch.
+  void prefetch_per_gpu(int gpu_id, const HugeCTR::DataDistributor::Result &input, int batch_size);
+
   void forward_per_gpu(Stage stage, bool is_train, int gpu_id,
                        const HugeCTR::DataDistributor::Result &input, core23::Tensor &output_buffer,
                        int batch_size);
@@ -341,10 +547,16 @@ class EmbeddingCollection {
 
   void update_per_gpu(int gpu_id, embedding::TablePlacementStrategy tps);
 
+  // Whether every training embedding of each of the stages can be captured into a CUDA graph.
+  bool is_graph_capturable(const std::vector<Stage> &stages) const;
+
   void update_per_gpu(int gpu_id);
 
   void set_learning_rate(float lr);
 
+  // Makes the tables of each local gpu read their learning rate from its scheduler.
+  void set_learning_rate_schedulers(const GpuLearningRateSchedulers &lr_scheds);
+
   std::vector<std::vector<IGroupedEmbeddingTable *>> get_grouped_embedding_tables() {
     std::vector<std::vector<IGroupedEmbeddingTable *>> grouped_embedding_tables;
     grouped_embedding_tables.resize(embedding_tables_.size());
@@ -361,6 +573,14 @@ class EmbeddingCollection {
   size_t get_grouped_wgrad_length() { return grouped_allreduce_length_; };
 
   void bind_grouped_wgrad_ptr();
+
+  // The replicated rows of the frequent keys are trained instead of their rows in the model
+  // parallel tables. Copies them to these tables, e.g. before they are dumped.
+  void flush_frequent_rows();
+
+  // Loads the rows of the frequent keys of a table into their replicas on all local GPUs. keys and
+  // weights are host tensors, as loaded by EmbeddingParameterIO.
+  void load_frequent_rows(int table_id, core23::Tensor &keys, core23::Tensor &weights);
 };
 
 }  // namespace embedding
@@ -52,6 +52,11 @@ class BatchIndices {
     return infrequent_selection_[raw_device_id];
   }
 
+  // Categories of the batch, once compute() has run.
+  const Tensor2<dtype>& get_samples(int raw_device_id) const {
+    return data_[raw_device_id].samples;
+  }
+
  private:
   size_t num_slots_ = 0;
   std::shared_ptr<ResourceManager> resource_manager_;
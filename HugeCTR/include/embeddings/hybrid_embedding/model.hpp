@@ -94,7 +94,7 @@ struct Model {
                                std::shared_ptr<GeneralBuffer2<CudaAllocator>> buf);
   void init_hybrid_model(const CalibrationData &calibration, Statistics<dtype> &statistics,
                          const Data<dtype> &data, Tensor2<dtype> &tmp_categories,
-                         cudaStream_t stream);
+                         cudaStream_t stream, bool count_samples = true);
 };
 
 }  // namespace hybrid_embedding
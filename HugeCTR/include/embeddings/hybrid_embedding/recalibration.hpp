@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <embeddings/hybrid_embedding/calibration_data.hpp>
+#include <embeddings/hybrid_embedding/statistics_file.hpp>
+#include <embeddings/hybrid_embedding/utils.hpp>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace hybrid_embedding {
+
+///
+/// Recalibrates the hybrid model in the background while training, to follow the drift of the
+/// key distribution. Every recalibration window of train batches, as many batches as the
+/// statistics at startup are sampled, and their categories are counted by the thread pool. At the
+/// end of the window, the frequent categories that the counts call for are compared with the ones
+/// of the model, and the counts are written to the statistics file, which the next start loads.
+/// The running model isn't changed, because the frequent and infrequent embeddings would have to
+/// be redistributed.
+///
+template <typename dtype>
+class Recalibration {
+ public:
+  Recalibration(size_t interval, size_t num_iterations_statistics, size_t batch_size,
+                const std::vector<size_t> &table_sizes, const CalibrationData &calibration,
+                CommunicationType communication_type, size_t num_networks,
+                size_t max_num_frequent_categories, const std::vector<dtype> &frequent_categories,
+                const std::string &statistics_file, int device_id);
+  ~Recalibration();
+
+  Recalibration(const Recalibration &) = delete;
+  Recalibration &operator=(const Recalibration &) = delete;
+
+  ///
+  /// Called once per train batch with its categories on the device. If the batch is sampled, they
+  /// are copied in stream order, and counted in the background. A sample is skipped while the
+  /// previous one is still being counted, so the training never waits.
+  ///
+  void sample(const dtype *d_categories, size_t num_categories, cudaStream_t stream);
+
+ private:
+  const size_t sampling_interval_;
+  const size_t num_batches_per_window_;
+  const size_t batch_size_;
+  const size_t num_iterations_statistics_;
+  const std::vector<size_t> table_sizes_;
+  const dtype num_categories_;
+  const size_t num_networks_;
+  const size_t max_num_frequent_categories_;
+  const std::unordered_set<dtype> frequent_categories_;
+  const std::string statistics_file_;
+  const int device_id_;
+  const double count_threshold_;  // For the counts of num_iterations_statistics batches
+
+  size_t num_batches_ = 0;
+  dtype *h_categories_ = nullptr;  // Pinned
+  size_t capacity_ = 0;
+  cudaEvent_t copied_;
+  std::future<void> task_;
+
+  // Only touched by the task.
+  std::unordered_map<dtype, uint64_t> counts_;
+  const size_t max_num_counts_;
+  uint64_t num_counted_ = 0;
+  size_t num_sampled_batches_ = 0;
+
+  void count_(size_t num_categories);
+  void recalibrate_(size_t num_batches);
+};
+
+}  // namespace hybrid_embedding
+
+}  // namespace HugeCTR
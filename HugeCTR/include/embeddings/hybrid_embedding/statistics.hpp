@@ -109,6 +109,9 @@ struct Statistics {
                                 uint32_t *counts_sorted, uint32_t &num_unique_categories,
                                 cudaStream_t stream);
   void sort_categories_by_count(const Tensor2<dtype> &samples, cudaStream_t stream);
+  // Takes categories which are already sorted by count, e.g. from a statistics file.
+  void set_categories_by_count(const std::vector<dtype> &categories,
+                               const std::vector<uint32_t> &counts, cudaStream_t stream);
   void calculate_frequent_and_infrequent_categories(
       dtype *frequent_categories, dtype *infrequent_categories, dtype *category_location,
       const size_t num_frequent, const size_t num_infrequent, cudaStream_t stream);
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace hybrid_embedding {
+
+// Categories with their number of occurrences.
+template <typename dtype>
+using CategoryCounts = std::vector<std::pair<dtype, uint64_t>>;
+
+///
+/// Reads the top keys of a stats file of tools/dataset_stats as categories. The keys of table
+/// table_<i> belong to slot i, and are offset by the sizes of the tables before it. The counts
+/// are scaled to num_samples samples, and keys which are not in their table are dropped. The
+/// categories are returned in descending order of counts.
+///
+template <typename dtype>
+CategoryCounts<dtype> load_category_counts(const std::string &file_name,
+                                           const std::vector<size_t> &table_sizes,
+                                           size_t num_samples);
+
+///
+/// Writes the counts of the categories of num_samples samples as a stats file of
+/// tools/dataset_stats, which load_category_counts reads back. Only the max_num_top_keys most
+/// frequent categories are listed as top keys, but all of them count as unique keys.
+///
+template <typename dtype>
+void save_category_counts(const std::string &file_name, CategoryCounts<dtype> counts,
+                          const std::vector<size_t> &table_sizes, size_t num_samples,
+                          size_t max_num_top_keys);
+
+}  // namespace hybrid_embedding
+
+}  // namespace HugeCTR
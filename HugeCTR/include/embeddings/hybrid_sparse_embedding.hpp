@@ -26,9 +26,11 @@
 #include <embeddings/hybrid_embedding/indices_container.hpp>
 #include <embeddings/hybrid_embedding/infrequent_embedding.hpp>
 #include <embeddings/hybrid_embedding/model.hpp>
+#include <embeddings/hybrid_embedding/recalibration.hpp>
 #include <embeddings/hybrid_embedding/statistics.hpp>
 #include <embeddings/hybrid_embedding/utils.hpp>
 #include <gpu_barrier.hpp>
+#include <memory>
 #include <queue>
 #include <random>
 #include <resource_manager.hpp>
@@ -59,6 +61,9 @@ struct HybridSparseEmbeddingParams {
   double efficiency_bandwidth_ratio;
   hybrid_embedding::HybridEmbeddingType hybrid_embedding_type;
   OptParams opt_params;  // optimizer params
+  // Statistics in the format of tools/dataset_stats, loaded if it exists, and saved otherwise.
+  std::string statistics_file;
+  size_t recalibration_interval = 0;  // Train batches per background recalibration (0 = off)
 };
 
 ///
@@ -101,6 +106,9 @@ class HybridSparseEmbedding : public SchedulableEmbeding {
   std::vector<Data<dtype>> data_statistics_;
   std::vector<CalibrationData> calibration_;
   std::vector<Statistics<dtype>> statistics_;
+  bool load_statistics_ = false;  // From the statistics file, instead of the init data.
+  std::unique_ptr<Recalibration<dtype>> recalibration_;  // On the master process only.
+  bool train_batch_assigned_ = false;
 
   // added by kefeng
   // std::vector<CudaPreAllocator> pre_alloc_bufs_;
@@ -210,6 +218,8 @@ class HybridSparseEmbedding : public SchedulableEmbeding {
 
   // TODO: consider to merge it with init_params
   void init_model(const SparseTensors<dtype>& data, size_t& wgrad_offset);
+  // Whether init_model uses the data, or the statistics file.
+  bool needs_init_data() const { return !load_statistics_; }
 
   void setup_buffered_indices(bool is_train, core23_reader::AsyncReader<dtype>* data_reader);
 
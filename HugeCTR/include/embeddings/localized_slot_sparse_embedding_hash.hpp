@@ -362,6 +362,12 @@ class LocalizedSlotSparseEmbeddingHash : public IEmbedding {
     }
   }
 
+  void set_learning_rate_schedulers(const GpuLearningRateSchedulers& lr_scheds) override {
+    for (size_t id = 0; id < embedding_optimizers_.size(); id++) {
+      embedding_optimizers_[id].set_learning_rate_scheduler(lr_scheds[id]);
+    }
+  }
+
   /**
    * Initialize the embedding table
    */
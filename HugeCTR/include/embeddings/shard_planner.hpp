@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <embedding/common.hpp>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Hardware and workload statistics that drive the automatic sharding of an embedding collection.
+ * Bandwidths are given per GPU in GB/s.
+ */
+struct ShardPlannerParams {
+  double hbm_budget_gb;         // HBM of each GPU for the embedding tables, 0 if unconstrained.
+  double hbm_bandwidth;         // Bandwidth of embedding lookups and updates.
+  double intra_node_bandwidth;  // Bandwidth between GPUs of the same node (NVLink).
+  double inter_node_bandwidth;  // Bandwidth between GPUs of different nodes (InfiniBand).
+  // Average number of keys per sample of each table, if lower than the hotness of its input.
+  std::map<std::string, double> pooling_factors;
+  // Expected number of rows of tables without a max_vocabulary_size.
+  std::map<std::string, int64_t> num_rows;
+  bool allow_data_parallel;  // Whether small tables may be replicated on all GPUs.
+  // Stats file of tools/dataset_stats, for the pooling factors and rows not given above.
+  std::string dataset_stats;
+
+  ShardPlannerParams(double hbm_budget_gb = 0, double hbm_bandwidth = 1500,
+                     double intra_node_bandwidth = 150, double inter_node_bandwidth = 25,
+                     const std::map<std::string, double>& pooling_factors = {},
+                     const std::map<std::string, int64_t>& num_rows = {},
+                     bool allow_data_parallel = true, const std::string& dataset_stats = "")
+      : hbm_budget_gb(hbm_budget_gb),
+        hbm_bandwidth(hbm_bandwidth),
+        intra_node_bandwidth(intra_node_bandwidth),
+        inter_node_bandwidth(inter_node_bandwidth),
+        pooling_factors(pooling_factors),
+        num_rows(num_rows),
+        allow_data_parallel(allow_data_parallel),
+        dataset_stats(dataset_stats) {}
+};
+
+struct ShardPlan {
+  std::vector<std::vector<int>> shard_matrix;  // num_gpus * num_table
+  std::vector<::embedding::GroupedTableParam> grouped_table_params;
+  std::vector<double> gpu_cost;  // Estimated embedding time of each GPU per iteration, in s
+};
+
+/**
+ * Places the tables of an embedding collection from a cost model of the lookup work, the
+ * all-to-all and all-reduce traffic, and the HBM usage of each table. Tables whose gradient
+ * all-reduce is cheaper than their share of the model parallel work are replicated (DP). The
+ * others are model parallel (MP), and split row-wise over as many GPUs as needed to fit into the
+ * HBM budget and to not exceed the average load of a GPU. The shards are then assigned to the
+ * least loaded GPUs, from the most to the least expensive table.
+ *
+ * @param table_params Tables of the collection, with their optimizer.
+ * @param lookup_params Lookups of the collection, with their max_hotness.
+ * @param batch_size Global batch size.
+ * @param emb_type_size Size of a value of the embedding output and gradient.
+ * @param weight_type_size Size of a weight of the tables with a max_vocabulary_size.
+ */
+ShardPlan plan_shards(const ShardPlannerParams& params,
+                      const std::unordered_map<std::string, int>& table_name_to_id_dict,
+                      const std::vector<::embedding::EmbeddingTableParam>& table_params,
+                      const std::vector<::embedding::LookupParam>& lookup_params, int batch_size,
+                      int num_nodes, int num_gpus_per_node, size_t emb_type_size,
+                      ::embedding::AllreduceStrategy allreduce_strategy,
+                      size_t weight_type_size = sizeof(float));
+
+}  // namespace HugeCTR
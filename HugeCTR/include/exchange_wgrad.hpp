@@ -26,12 +26,38 @@ using BuffPtr = std::shared_ptr<BufferBlock2<T>>;
 template <typename T>
 using BuffPtrs = std::vector<BuffPtr<T>>;
 
+/**
+ * The range [offset, offset + count) of the shard of the GPU of global id rank, when num_elements
+ * are sharded across num_ranks GPUs. Each GPU has num_elements / num_ranks elements at the place of
+ * its rank, so that they are reduce-scattered and all-gathered in place, and the last one also has
+ * the rest.
+ */
+inline std::pair<size_t, size_t> get_dense_optimizer_shard(size_t num_elements, size_t rank,
+                                                           size_t num_ranks) {
+  const size_t count = num_elements / num_ranks;
+  const size_t rest = rank + 1 == num_ranks ? num_elements - count * num_ranks : 0;
+  return {rank * count, count + rest};
+}
+
 class ExchangeWgrad {
  public:
   virtual void init_ar_comm(const std::vector<void*>& ptr, size_t sizes) = 0;
   virtual void allocate() = 0;
   virtual void update_embed_wgrad_size(size_t size) = 0;
   virtual void allreduce(size_t device_id, cudaStream_t stream) = 0;
+  /**
+   * Reduce the buffer passed to init_ar_comm() in buckets of byte ranges [offset, offset + size),
+   * which allreduce_bucket() reduces one by one, instead of in allreduce(). The buckets must cover
+   * the whole buffer. Returns false if the exchange can't be bucketed.
+   */
+  virtual bool init_buckets(const std::vector<std::pair<size_t, size_t>>& buckets) = 0;
+  virtual void allreduce_bucket(size_t bucket, size_t device_id, cudaStream_t stream) = 0;
+  /**
+   * Reduce each GPU's shard of the first num_elements of the buffer passed to init_ar_comm() into
+   * only that GPU in allreduce(), see get_dense_optimizer_shard(). The rest of the buffer is not
+   * reduced. Returns false if the exchange can't be sharded.
+   */
+  virtual bool init_shards(size_t num_elements) = 0;
 };
 
 template <typename TypeFP>
@@ -43,16 +69,42 @@ class NetworkExchangeWgrad : public ExchangeWgrad {
   void init_ar_comm(const std::vector<void*>& ptr, size_t size) final;
   void update_embed_wgrad_size(size_t size) final;
   void allreduce(size_t device_id, cudaStream_t stream);
-  NetworkExchangeWgrad(const std::shared_ptr<ResourceManager>& resource_manager);
+  bool init_buckets(const std::vector<std::pair<size_t, size_t>>& buckets) final;
+  void allreduce_bucket(size_t bucket, size_t device_id, cudaStream_t stream) final;
+  bool init_shards(size_t num_elements) final;
+  /**
+   * With a compression other than Disabled, the FP32 wgrad is rounded to FP16 or BF16, all reduced
+   * with NCCL in that precision and widened again. The rounding error of each GPU is kept in a
+   * residual, which is added to the wgrad before it is rounded in the next iteration.
+   */
+  NetworkExchangeWgrad(const std::shared_ptr<ResourceManager>& resource_manager,
+                       WgradCompression_t compression = WgradCompression_t::Disabled);
   ~NetworkExchangeWgrad() = default;
 
  private:
+  void init_compression_(const std::vector<void*>& ptr);
+  void compressed_allreduce_(size_t offset, size_t size, size_t device_id, cudaStream_t stream);
+  void reduce_scatter_(size_t device_id, cudaStream_t stream);
+
   BuffPtrs<TypeFP> network_wgrad_buffs_;
   BuffPtrs<TypeFP> null_wgrad_buffs_;
   std::vector<std::shared_ptr<GeneralBuffer2<CudaAllocator>>> bufs_;
   std::shared_ptr<ResourceManager> resource_manager_;
 
   AllReduceInPlaceComm::Handle ar_handle_;
+  std::vector<void*> ar_ptrs_;
+  std::vector<AllReduceInPlaceComm::Handle> bucket_handles_;
+  std::vector<std::pair<size_t, size_t>> buckets_;
+
+  WgradCompression_t compression_;
+  std::vector<void*> wgrad_ptrs_;
+  std::vector<std::shared_ptr<GeneralBuffer2<CudaAllocator>>> compression_bufs_;
+  // 16-bit storage of both FP16 and BF16 wgrads.
+  std::vector<Tensor2<__half>> compressed_wgrads_;
+  std::vector<Tensor2<float>> wgrad_residuals_;
+
+  // The number of elements that are reduce-scattered, or 0 if they are all reduced.
+  size_t shard_num_elements_ = 0;
 
   size_t network_wgrad_size_ = 0;
   size_t num_gpus_ = 0;
@@ -67,6 +119,9 @@ class GroupedExchangeWgrad : public ExchangeWgrad {
   void init_ar_comm(const std::vector<void*>& ptr, size_t size) final;
   void update_embed_wgrad_size(size_t size) final;
   void allreduce(size_t device_id, cudaStream_t stream);
+  bool init_buckets(const std::vector<std::pair<size_t, size_t>>& buckets) final;
+  void allreduce_bucket(size_t bucket, size_t device_id, cudaStream_t stream) final;
+  bool init_shards(size_t num_elements) final;
   GroupedExchangeWgrad(const std::shared_ptr<ResourceManager>& resource_manager);
   ~GroupedExchangeWgrad() = default;
 
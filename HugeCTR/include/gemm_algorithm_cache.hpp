@@ -0,0 +1,79 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Process wide cache of the GEMM algorithms that search_algorithm() of the layers picked. A key
+ * names the GPU architecture, the cuBLAS version, the GEMM and its shape, data type and epilogue.
+ * Its value is the chosen algorithms as bytes. With a file, the entries are loaded from it and
+ * save() writes the new ones back, so later runs on the same kind of GPU skip the search.
+ */
+class GemmAlgorithmCache {
+ public:
+  static GemmAlgorithmCache& get();
+
+  // Loads the entries of file. It is created by save() if it doesn't exist yet.
+  void set_file(const std::string& file);
+  // Writes all entries to the file, if there is one and entries were added since it was loaded.
+  void save();
+
+  // Key of a GEMM on the current device. params are the shape, data type, epilogue and so on.
+  static std::string make_key(const std::string& gemm, const std::vector<int64_t>& params);
+  template <typename... Params>
+  static std::string make_key(const std::string& gemm, Params... params) {
+    return make_key(gemm, std::vector<int64_t>{static_cast<int64_t>(params)...});
+  }
+
+  // Copies the algorithms of key into algos. Returns false if there is no such entry.
+  template <typename... Algos>
+  bool find(const std::string& key, Algos&... algos) {
+    std::string value;
+    if (!find_(key, &value) || value.size() != (sizeof(Algos) + ... + 0)) {
+      return false;
+    }
+    const char* src = value.data();
+    ((std::memcpy(&algos, src, sizeof(Algos)), src += sizeof(Algos)), ...);
+    return true;
+  }
+
+  template <typename... Algos>
+  void insert(const std::string& key, const Algos&... algos) {
+    std::string value((sizeof(Algos) + ... + 0), '\0');
+    char* dst = value.data();
+    ((std::memcpy(dst, &algos, sizeof(Algos)), dst += sizeof(Algos)), ...);
+    insert_(key, std::move(value));
+  }
+
+ private:
+  bool find_(const std::string& key, std::string* value);
+  void insert_(const std::string& key, std::string&& value);
+
+  std::mutex mutex_;
+  std::string file_;
+  std::unordered_map<std::string, std::string> entries_;
+  bool modified_ = false;
+};
+
+}  // namespace HugeCTR
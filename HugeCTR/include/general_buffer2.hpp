@@ -17,8 +17,11 @@
 
 #include <cuda_runtime_api.h>
 
+#include <core23/pinned_host_arena.hpp>
+#include <map>
 #include <memory>
 #include <numeric>
+#include <string>
 #include <tensor2.hpp>
 
 namespace HugeCTR {
@@ -39,6 +42,25 @@ class CudaHostAllocator {
   void deallocate(void *ptr) const { HCTR_LIB_THROW(cudaFreeHost(ptr)); }
 };
 
+// Pinned host memory that is lent to a consumer by the core23::PinnedHostArena.
+class ArenaHostAllocator {
+ public:
+  explicit ArenaHostAllocator(const std::string &consumer = "default")
+      : consumer_(consumer),
+        buffers_(std::make_shared<std::map<void *, core23::PinnedHostBuffer>>()) {}
+  void *allocate(size_t size) const {
+    core23::PinnedHostBuffer buffer{core23::PinnedHostArena::instance().acquire(consumer_, size)};
+    void *ptr{buffer.data()};
+    buffers_->emplace(ptr, std::move(buffer));
+    return ptr;
+  }
+  void deallocate(void *ptr) const { buffers_->erase(ptr); }
+
+ private:
+  std::string consumer_;
+  std::shared_ptr<std::map<void *, core23::PinnedHostBuffer>> buffers_;
+};
+
 class CudaManagedAllocator {
  public:
   void *allocate(size_t size) const {
@@ -23,8 +23,20 @@ namespace HugeCTR {
 template <typename KeyType, typename ValType>
 class HashTableContainer;
 
+namespace static_map {
+template <typename KeyType, typename ValType>
+class StaticMap;
+}  // namespace static_map
+
+/**
+ * Storage of a HashTable. StaticMap is an open addressing table in device memory that is probed
+ * by cooperative groups, and packs 32-bit keys with their values into 64-bit slots.
+ * ConcurrentUnorderedMap is the cudf concurrent_unordered_map in managed memory.
+ */
+enum class HashTableBackend { StaticMap, ConcurrentUnorderedMap };
+
 /**
- * The HashTable class is wrapped by cudf library for hash table operations on single GPU.
+ * The HashTable class wraps a hash table backend for hash table operations on single GPU.
  * In this class, we implement the GPU version of the common used operations of hash table,
  * such as insert() / get() / set() / dump()...
  */
@@ -37,8 +49,10 @@ class HashTable {
    * The constructor of HashTable.
    * @param capacity the number of <key,value> pairs in the hash table.
    * @param count the existed number of <key,value> pairs in the hash table.
+   * @param backend the storage of the hash table.
    */
-  HashTable(size_t capacity, size_t count = 0);
+  HashTable(size_t capacity, size_t count = 0,
+            HashTableBackend backend = HashTableBackend::StaticMap);
 
   /**
    * The destructor of HashTable.
@@ -182,6 +196,8 @@ class HashTable {
 
   HashTableContainer<KeyType, ValType>* container_; /**< The object of the Table class which is
        defined in the concurrent_unordered_map class. */
+  static_map::StaticMap<KeyType, ValType>* static_map_; /**< The table of the StaticMap backend,
+       which is used instead of container_ if it is not null. */
 
   // Counter for value index
   size_t* d_counter_; /**< The device counter for value index. */
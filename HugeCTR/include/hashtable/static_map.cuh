@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cooperative_groups.h>
+#include <thrust/pair.h>
+
+#include <algorithm>
+#include <common.hpp>
+#include <limits>
+#include <type_traits>
+
+namespace HugeCTR {
+
+namespace static_map {
+
+namespace cg = cooperative_groups;
+
+// Number of threads that probe a window of as many consecutive slots together.
+inline constexpr int tile_size{4};
+
+/**
+ * A 32-bit key and a 32-bit value packed into one 64-bit slot, which is read with one load. A slot
+ * whose key is claimed holds the empty value until its value is stored.
+ */
+template <typename KeyType, typename ValType>
+struct PackedSlot {
+  using slot_type = unsigned long long;
+  static constexpr KeyType empty_key{std::numeric_limits<KeyType>::max()};
+  static constexpr ValType empty_value{std::numeric_limits<ValType>::max()};
+  static constexpr uint32_t packed_empty_value{std::numeric_limits<uint32_t>::max()};
+  // Values must be less than that.
+  static constexpr size_t max_num_values{packed_empty_value};
+
+  __host__ __device__ static slot_type pack(const KeyType key, const uint32_t value) {
+    return static_cast<slot_type>(key) << 32 | value;
+  }
+  __host__ __device__ static slot_type empty_slot() {
+    return pack(empty_key, packed_empty_value);
+  }
+
+  __device__ static thrust::pair<KeyType, ValType> load(const slot_type* const slot) {
+    const slot_type word = *reinterpret_cast<const volatile slot_type*>(slot);
+    const uint32_t value = static_cast<uint32_t>(word);
+    return {static_cast<KeyType>(word >> 32),
+            value == packed_empty_value ? empty_value : static_cast<ValType>(value)};
+  }
+  // Claims the slot for key if it is empty, and returns the key it held before.
+  __device__ static KeyType claim(slot_type* const slot, const KeyType key) {
+    return static_cast<KeyType>(atomicCAS(slot, empty_slot(), pack(key, packed_empty_value)) >>
+                                32);
+  }
+  __device__ static void store_value(slot_type* const slot, const KeyType key,
+                                     const ValType value) {
+    atomicExch(slot, pack(key, static_cast<uint32_t>(value)));
+  }
+};
+
+/**
+ * A 64-bit key and a 64-bit value in a 16-byte slot. The key is claimed with a CAS and the value
+ * is stored after it, so that a slot whose key is claimed holds the empty value until then.
+ */
+template <typename KeyType, typename ValType>
+struct PairSlot {
+  struct alignas(16) slot_type {
+    KeyType key;
+    ValType value;
+  };
+  static constexpr KeyType empty_key{std::numeric_limits<KeyType>::max()};
+  static constexpr ValType empty_value{std::numeric_limits<ValType>::max()};
+  static constexpr size_t max_num_values{std::numeric_limits<ValType>::max()};
+
+  __host__ __device__ static slot_type empty_slot() { return {empty_key, empty_value}; }
+
+  __device__ static thrust::pair<KeyType, ValType> load(const slot_type* const slot) {
+    const volatile slot_type* const s = slot;
+    const KeyType key = s->key;
+    return {key, s->value};
+  }
+  __device__ static KeyType claim(slot_type* const slot, const KeyType key) {
+    return static_cast<KeyType>(atomicCAS(reinterpret_cast<unsigned long long*>(&slot->key),
+                                          static_cast<unsigned long long>(empty_key),
+                                          static_cast<unsigned long long>(key)));
+  }
+  __device__ static void store_value(slot_type* const slot, const KeyType, const ValType value) {
+    atomicExch(reinterpret_cast<unsigned long long*>(&slot->value),
+               static_cast<unsigned long long>(value));
+  }
+};
+
+template <typename KeyType, typename ValType>
+using Slot = std::conditional_t<sizeof(KeyType) == 4 && sizeof(ValType) <= 8,
+                                PackedSlot<KeyType, ValType>, PairSlot<KeyType, ValType>>;
+
+__host__ __device__ inline uint64_t mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * Device side of a StaticMap, which is passed to the kernels by value. Each key is looked up by a
+ * tile of tile_size threads, which compare the keys of a window of tile_size slots at once. The
+ * windows are probed with double hashing, where the step is odd, so that all windows are visited.
+ * As keys are never erased, a window with an empty slot ends the probing.
+ */
+template <typename KeyType, typename ValType>
+struct StaticMapView {
+  using Slot = static_map::Slot<KeyType, ValType>;
+  using slot_type = typename Slot::slot_type;
+
+  slot_type* slots;
+  size_t window_mask;
+
+  __device__ size_t initial_window(const KeyType key) const {
+    return mix(static_cast<uint64_t>(key)) & window_mask;
+  }
+  __device__ size_t window_step(const KeyType key) const {
+    return (mix(static_cast<uint64_t>(key) ^ 0x9e3779b97f4a7c15ull) | 1) & window_mask;
+  }
+
+  // Value of the key in lane src, which waits for a concurrent insertion to store it.
+  template <typename Tile>
+  __device__ ValType read_value(const Tile& tile, const slot_type* const slot, ValType value,
+                                const int src) const {
+    if (static_cast<int>(tile.thread_rank()) == src) {
+      while (value == Slot::empty_value) {
+        value = Slot::load(slot).second;
+      }
+    }
+    return tile.shfl(value, src);
+  }
+
+  // Returns the value of key, or Slot::empty_value if it is not in the map.
+  template <typename Tile>
+  __device__ ValType find(const Tile& tile, const KeyType key) const {
+    size_t window = initial_window(key);
+    const size_t step = window_step(key);
+    for (size_t probe = 0; probe <= window_mask; ++probe) {
+      const slot_type* const slot = slots + window * tile_size + tile.thread_rank();
+      const auto kv = Slot::load(slot);
+      const unsigned int found = tile.ballot(kv.first == key);
+      if (found) {
+        return read_value(tile, slot, kv.second, __ffs(found) - 1);
+      }
+      if (tile.any(kv.first == Slot::empty_key)) {
+        break;
+      }
+      window = (window + step) & window_mask;
+    }
+    return Slot::empty_value;
+  }
+
+  /**
+   * Returns the value of key. A key that is not in the map is inserted with the value that
+   * new_value() returns in one thread of the tile. With overwrite, the value of a key that is in
+   * the map is replaced with it as well. It returns Slot::empty_value if the map is full.
+   */
+  template <typename Tile, typename NewValue>
+  __device__ ValType insert(const Tile& tile, const KeyType key, const NewValue& new_value,
+                            const bool overwrite) {
+    size_t window = initial_window(key);
+    const size_t step = window_step(key);
+    for (size_t probe = 0; probe <= window_mask; ++probe) {
+      slot_type* const slot = slots + window * tile_size + tile.thread_rank();
+      const auto kv = Slot::load(slot);
+      unsigned int found = tile.ballot(kv.first == key);
+      unsigned int empty = tile.ballot(kv.first == Slot::empty_key);
+      // The empty slots of the window are claimed in order, until one is claimed for key.
+      while (!found && empty) {
+        const int src = __ffs(empty) - 1;
+        KeyType previous = Slot::empty_key;
+        if (static_cast<int>(tile.thread_rank()) == src) {
+          previous = Slot::claim(slot, key);
+        }
+        previous = tile.shfl(previous, src);
+        if (previous == Slot::empty_key) {
+          ValType value = Slot::empty_value;
+          if (static_cast<int>(tile.thread_rank()) == src) {
+            value = new_value();
+            Slot::store_value(slot, key, value);
+          }
+          return tile.shfl(value, src);
+        }
+        if (previous == key) {
+          found = 1u << src;
+        }
+        empty &= empty - 1;
+      }
+      if (found) {
+        const int src = __ffs(found) - 1;
+        if (!overwrite) {
+          return read_value(tile, slot, kv.second, src);
+        }
+        ValType value = Slot::empty_value;
+        if (static_cast<int>(tile.thread_rank()) == src) {
+          value = new_value();
+          Slot::store_value(slot, key, value);
+        }
+        return tile.shfl(value, src);
+      }
+      window = (window + step) & window_mask;
+    }
+    return Slot::empty_value;
+  }
+};
+
+template <typename slot_type>
+__global__ void fill_slots_kernel(slot_type* const slots, const size_t num_slots,
+                                  const slot_type empty_slot) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < num_slots;
+       i += blockDim.x * gridDim.x) {
+    slots[i] = empty_slot;
+  }
+}
+
+/**
+ * Open addressing hash map in device memory, with a fixed number of slots that is a power of 2
+ * multiple of tile_size. Keys can be inserted concurrently with lookups, but not erased.
+ */
+template <typename KeyType, typename ValType>
+class StaticMap {
+ public:
+  using View = StaticMapView<KeyType, ValType>;
+  using Slot = typename View::Slot;
+  using slot_type = typename View::slot_type;
+
+  // It has at least min_num_slots slots, which are empty.
+  explicit StaticMap(const size_t min_num_slots) {
+    size_t num_windows = 1;
+    while (num_windows * tile_size < min_num_slots) {
+      num_windows <<= 1;
+    }
+    view_.window_mask = num_windows - 1;
+    HCTR_LIB_THROW(cudaMalloc(&view_.slots, num_slots() * sizeof(slot_type)));
+    clear(0);
+    HCTR_LIB_THROW(cudaStreamSynchronize(0));
+  }
+  ~StaticMap() { cudaFree(view_.slots); }
+
+  StaticMap(const StaticMap&) = delete;
+  StaticMap& operator=(const StaticMap&) = delete;
+
+  const View& view() const { return view_; }
+  size_t num_slots() const { return (view_.window_mask + 1) * tile_size; }
+
+  void clear(const cudaStream_t stream) {
+    constexpr int block_size = 256;
+    const int grid_size = static_cast<int>(std::min<size_t>((num_slots() - 1) / block_size + 1,
+                                                            std::numeric_limits<int>::max()));
+    fill_slots_kernel<<<grid_size, block_size, 0, stream>>>(view_.slots, num_slots(),
+                                                            Slot::empty_slot());
+  }
+
+ private:
+  View view_;
+};
+
+}  // namespace static_map
+
+}  // namespace HugeCTR
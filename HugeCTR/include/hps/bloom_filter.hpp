@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <common.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Blocked Bloom filter. All probes for a key fall into a single 512 bit block (= 1 cache line), so
+ * that queries cost at most one cache miss. Inserts and queries can be issued concurrently by any
+ * number of threads. Keys can not be removed. Hence, \p may_contain never yields false negatives,
+ * but the false positive rate increases if more than \p capacity keys are inserted.
+ */
+class BloomFilter final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(BloomFilter);
+
+  BloomFilter() = delete;
+
+  /**
+   * Construct a new BloomFilter object.
+   *
+   * @param capacity Number of keys that the filter is expected to hold.
+   * @param bits_per_key Size of the filter relative to \p capacity .
+   */
+  BloomFilter(size_t capacity, size_t bits_per_key);
+
+  /**
+   * @return Size of the filter in bytes.
+   */
+  size_t size_in_bytes() const { return words_.size() * sizeof(uint64_t); }
+
+  /**
+   * Adds \p key to the filter.
+   */
+  void insert(uint64_t key);
+
+  /**
+   * Adds \p num_keys keys to the filter.
+   */
+  template <typename Key>
+  void insert(const size_t num_keys, const Key* const keys) {
+    for (const Key* k{keys}; k != &keys[num_keys]; ++k) {
+      insert(static_cast<uint64_t>(*k));
+    }
+  }
+
+  /**
+   * @return \p false if \p key was certainly never inserted.
+   */
+  bool may_contain(uint64_t key) const;
+
+ private:
+  static constexpr size_t words_per_block{512 / 64};
+
+  const size_t num_blocks_;
+  const uint32_t num_probes_;
+  std::vector<std::atomic<uint64_t>> words_;
+
+  size_t block_index_(uint64_t h) const;
+};
+
+}  // namespace HugeCTR
@@ -22,9 +22,11 @@
 #include <common.hpp>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <hps/inference_utils.hpp>
 #include <string>
 #include <thread_pool.hpp>
+#include <unordered_map>
 #include <vector>
 
 namespace HugeCTR {
@@ -170,6 +172,32 @@ class DatabaseBackendBase {
       char* values, size_t value_stride, const DatabaseMissCallback& on_miss,
       const std::chrono::nanoseconds& time_budget = std::chrono::nanoseconds::zero());
 
+  /**
+   * Asynchronous variant of \p fetch (direct indexing). Returns immediately. The lookup is
+   * processed in the background. Hence, all arguments must remain valid until the returned future
+   * has been waited on, and \p on_miss may be invoked concurrently from different threads. The
+   * default implementation runs \p fetch in a worker thread.
+   *
+   * @return Future for the number of keys that were successfully retrieved from this database.
+   * Errors are forwarded through the future.
+   */
+  virtual std::future<size_t> fetch_async(
+      const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+      size_t value_stride, const DatabaseMissCallback& on_miss,
+      const std::chrono::nanoseconds& time_budget = std::chrono::nanoseconds::zero());
+
+  /**
+   * Asynchronous variant of \p fetch (indirect indexing). Same rules as for the direct indexing
+   * variant apply.
+   *
+   * @return Future for the number of keys that were successfully retrieved from this database.
+   * Errors are forwarded through the future.
+   */
+  virtual std::future<size_t> fetch_async(
+      const std::string& table_name, size_t num_indices, const size_t* indices, const Key* keys,
+      char* values, size_t value_stride, const DatabaseMissCallback& on_miss,
+      const std::chrono::nanoseconds& time_budget = std::chrono::nanoseconds::zero());
+
   /**
    * Attempt to remove a table and all associated values from the underlying database.
    *
@@ -236,6 +264,24 @@ class DatabaseBackendBase {
 
   virtual size_t load_dump_sst(const std::string& table_name, const std::string& path);
 
+  /**
+   * Loads the contents of multiple SST files into a table. The key ranges of the files may overlap.
+   * Implementations may take ownership of the files. Hence, they must not be modified afterwards.
+   *
+   * @param table_name The destination table into which to insert the data.
+   * @param paths File system paths of the SST files.
+   */
+  virtual size_t load_dump_sst(const std::string& table_name,
+                               const std::vector<std::string>& paths);
+
+ protected:
+  // Runs \p task in the worker pool that serves asynchronous fetches (shared by all backends).
+  static std::future<size_t> submit_fetch_(std::function<size_t()> task);
+
+  // Combines the futures for several parts of a fetch. Errors are only forwarded once all parts
+  // have completed. Hence, no part can still be writing to the output at that point.
+  static std::future<size_t> join_fetches_(std::vector<std::future<size_t>>&& parts);
+
  private:
   const size_t max_batch_size_;  // Temporary, until find a better solution.
 };
@@ -301,13 +347,23 @@ struct VolatileBackendParams : public DatabaseBackendParams {
       DatabaseOverflowPolicy_t::EvictRandom};  // Policy to use in case an overflow has been
                                                // detected.
   double overflow_resolution_target{0.8};  // Target margin after applying overflow handling policy.
+  std::unordered_map<std::string, size_t>
+      table_overflow_margins;  // Overrides `overflow_margin` for tables that are named `<key>` or
+                               // `<key>.<suffix>` (most specific key wins).
 
   inline size_t overflow_resolution_margin() const {
+    return overflow_resolution_margin(overflow_margin);
+  }
+
+  inline size_t overflow_resolution_margin(const size_t overflow_margin) const {
     const size_t margin = static_cast<size_t>(
         static_cast<double>(overflow_margin) * overflow_resolution_target + 0.5);
     HCTR_CHECK(margin <= overflow_margin);
     return margin;
   }
+
+  // Overflow margin that applies to the partitions of a specific table.
+  size_t table_overflow_margin(const std::string& table_name) const;
 };
 
 template <typename Key, typename Params>
@@ -319,19 +375,15 @@ class VolatileBackend : public DatabaseBackend<Key, Params> {
 
   VolatileBackend() = delete;
 
-  VolatileBackend(const Params& params)
-      : Base(params), overflow_resolution_margin_{params.overflow_resolution_margin()} {}
+  VolatileBackend(const Params& params) : Base(params) {}
 
   virtual ~VolatileBackend() = default;
 
-  size_t capacity(const std::string& table_name) const override final {
-    const size_t part_margin = this->params_.overflow_margin;
+  size_t capacity(const std::string& table_name) const override {
+    const size_t part_margin = this->params_.table_overflow_margin(table_name);
     const size_t total_margin = part_margin * this->params_.num_partitions;
     return std::max(total_margin, part_margin);
   }
-
- protected:
-  const size_t overflow_resolution_margin_;
 };
 
 struct PersistentBackendParams : public DatabaseBackendParams {};
@@ -15,9 +15,16 @@
  */
 #pragma once
 
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+#include <cuda_fp8.h>
 #include <rocksdb/db.h>
 
+#include <algorithm>
+#include <core23/logger.hpp>
 #include <cstdint>
+#include <cstring>
+#include <hps/inference_utils.hpp>
 #include <type_traits>
 
 namespace HugeCTR {
@@ -58,6 +65,12 @@ inline uint64_t rrxmrrxmsx_0(uint64_t x) {
   return x ^ x >> 28;
 }
 
+/**
+ * Saturation limit for the access counters of the `EvictClock` overflow policy. Each time the clock
+ * hand passes an entry, its counter is decremented. Entries are evicted once their counter is 0.
+ */
+inline constexpr uint64_t clock_max_access_count{3};
+
 #ifdef HCTR_HPS_KEY_TO_PART_INDEX_
 #error HCTR_HPS_KEY_TO_PART_INDEX_ already defined. Potential naming conflict!
 #endif
@@ -289,6 +302,116 @@ inline uint64_t rrxmrrxmsx_0(uint64_t x) {
     HCTR_CHECK_HINT(status.ok(), "RocksDB error: ", status.ToString()); \
   } while (0)
 
+/**
+ * Size of a value with \p value_size bytes after encoding it for storage or transmission. Non-raw
+ * encodings assume that values are vectors of `float`.
+ */
+inline size_t db_encoded_value_size(const DatabaseValueEncoding_t encoding,
+                                    const size_t value_size) {
+  if (encoding == DatabaseValueEncoding_t::Raw) {
+    return value_size;
+  }
+  HCTR_CHECK_HINT(value_size % sizeof(float) == 0, "The ", hctr_enum_to_c_str(encoding),
+                  " value encoding requires values to be float vectors!");
+  const size_t element_size{encoding == DatabaseValueEncoding_t::Float8 ? sizeof(__nv_fp8_e4m3)
+                                                                        : sizeof(uint16_t)};
+  return value_size / sizeof(float) * element_size;
+}
+
+/**
+ * Inverse of \p db_encoded_value_size .
+ */
+inline size_t db_decoded_value_size(const DatabaseValueEncoding_t encoding,
+                                    const size_t encoded_size) {
+  if (encoding == DatabaseValueEncoding_t::Raw) {
+    return encoded_size;
+  }
+  const size_t element_size{encoding == DatabaseValueEncoding_t::Float8 ? sizeof(__nv_fp8_e4m3)
+                                                                        : sizeof(uint16_t)};
+  HCTR_CHECK(encoded_size % element_size == 0);
+  return encoded_size / element_size * sizeof(float);
+}
+
+/**
+ * Encodes a value for storage or transmission. \p dst must provide space for
+ * \p db_encoded_value_size(encoding, value_size) bytes. Values need not be aligned.
+ */
+inline void db_encode_value(const DatabaseValueEncoding_t encoding, const char* const src,
+                            const size_t value_size, char* const dst) {
+  const size_t n{value_size / sizeof(float)};
+  switch (encoding) {
+    case DatabaseValueEncoding_t::Raw: {
+      std::copy_n(src, value_size, dst);
+    } break;
+    case DatabaseValueEncoding_t::Float16: {
+      for (size_t i{0}; i < n; ++i) {
+        float f;
+        std::memcpy(&f, &src[i * sizeof(float)], sizeof(float));
+        const __half h{__float2half_rn(f)};
+        std::memcpy(&dst[i * sizeof(__half)], &h, sizeof(__half));
+      }
+    } break;
+    case DatabaseValueEncoding_t::BFloat16: {
+      for (size_t i{0}; i < n; ++i) {
+        float f;
+        std::memcpy(&f, &src[i * sizeof(float)], sizeof(float));
+        const __nv_bfloat16 h{__float2bfloat16_rn(f)};
+        std::memcpy(&dst[i * sizeof(__nv_bfloat16)], &h, sizeof(__nv_bfloat16));
+      }
+    } break;
+    case DatabaseValueEncoding_t::Float8: {
+      for (size_t i{0}; i < n; ++i) {
+        float f;
+        std::memcpy(&f, &src[i * sizeof(float)], sizeof(float));
+        const __nv_fp8_e4m3 h{f};  // Saturates to the finite range.
+        std::memcpy(&dst[i * sizeof(__nv_fp8_e4m3)], &h, sizeof(__nv_fp8_e4m3));
+      }
+    } break;
+    default:
+      HCTR_DIE("Unsupported value encoding!");
+  }
+}
+
+/**
+ * Decodes a value that was encoded by \p db_encode_value . \p dst must provide space for
+ * \p db_decoded_value_size(encoding, encoded_size) bytes.
+ */
+inline void db_decode_value(const DatabaseValueEncoding_t encoding, const char* const src,
+                            const size_t encoded_size, char* const dst) {
+  const size_t n{db_decoded_value_size(encoding, encoded_size) / sizeof(float)};
+  switch (encoding) {
+    case DatabaseValueEncoding_t::Raw: {
+      std::copy_n(src, encoded_size, dst);
+    } break;
+    case DatabaseValueEncoding_t::Float16: {
+      for (size_t i{0}; i < n; ++i) {
+        __half h;
+        std::memcpy(&h, &src[i * sizeof(__half)], sizeof(__half));
+        const float f{__half2float(h)};
+        std::memcpy(&dst[i * sizeof(float)], &f, sizeof(float));
+      }
+    } break;
+    case DatabaseValueEncoding_t::BFloat16: {
+      for (size_t i{0}; i < n; ++i) {
+        __nv_bfloat16 h;
+        std::memcpy(&h, &src[i * sizeof(__nv_bfloat16)], sizeof(__nv_bfloat16));
+        const float f{__bfloat162float(h)};
+        std::memcpy(&dst[i * sizeof(float)], &f, sizeof(float));
+      }
+    } break;
+    case DatabaseValueEncoding_t::Float8: {
+      for (size_t i{0}; i < n; ++i) {
+        __nv_fp8_e4m3 h;
+        std::memcpy(&h, &src[i * sizeof(__nv_fp8_e4m3)], sizeof(__nv_fp8_e4m3));
+        const float f{static_cast<float>(h)};
+        std::memcpy(&dst[i * sizeof(float)], &f, sizeof(float));
+      }
+    } break;
+    default:
+      HCTR_DIE("Unsupported value encoding!");
+  }
+}
+
 // TODO: Remove me!
 #pragma GCC diagnostic pop
 
@@ -20,10 +20,13 @@
 #include <hps/embedding_cache_base.hpp>
 #include <hps/embedding_cache_gpu.hpp>
 #include <hps/inference_utils.hpp>
+#include <hps/lookup_metrics.hpp>
 #include <hps/memory_pool.hpp>
 #include <hps/unique_op/unique_op.hpp>
+#include <atomic>
 #include <memory>
 #include <nv_gpu_cache.hpp>
+#include <shared_mutex>
 #include <thread_pool.hpp>
 
 namespace HugeCTR {
@@ -46,6 +49,14 @@ class EmbeddingCache : public EmbeddingCacheBase,
                                   size_t num_keys, float hit_rate_threshold, cudaStream_t stream);
   virtual void lookup_from_device(size_t table_id, float* d_vectors, MemoryBlock* memory_block,
                                   size_t num_keys, float hit_rate_threshold, cudaStream_t stream);
+  virtual void lookup_from_device_grouped(const std::vector<const void*>& d_keys_per_table,
+                                          const std::vector<float*>& d_vectors_per_table,
+                                          const std::vector<size_t>& num_keys_per_table,
+                                          float hit_rate_threshold, cudaStream_t stream);
+  virtual void lookup_from_device_pooled(size_t table_id, float* d_pooled_vectors,
+                                         const void* d_keys, size_t num_keys,
+                                         const PoolingRows& rows, float hit_rate_threshold,
+                                         cudaStream_t stream);
   virtual void insert(size_t table_id, EmbeddingCacheWorkspace& workspace_handler,
                       cudaStream_t stream);
 
@@ -59,6 +70,7 @@ class EmbeddingCache : public EmbeddingCacheBase,
   virtual void refresh(size_t table_id, const void* d_keys, const void* d_vectors, size_t length,
                        cudaStream_t stream);
   virtual void finalize();
+  virtual void rebalance_capacity(cudaStream_t stream);
 
   virtual EmbeddingCacheWorkspace create_workspace();
   virtual void destroy_workspace(EmbeddingCacheWorkspace&);
@@ -78,9 +90,55 @@ class EmbeddingCache : public EmbeddingCacheBase,
  private:
   static const size_t BLOCK_SIZE_ = 64;
 
+  // Looks up the keys in the workspace of memory_block. Writes one vector per key to d_vectors, or
+  // one pooled vector per row if rows is set.
+  void lookup_from_device_(size_t table_id, float* d_vectors, MemoryBlock* memory_block,
+                           size_t num_keys, float hit_rate_threshold, const PoolingRows* rows,
+                           cudaStream_t stream);
+
+  // Variant of lookup_from_device_ that enqueues the entire miss handling into stream.
+  void lookup_stream_ordered_(size_t table_id, float* d_vectors, MemoryBlock* memory_block,
+                              size_t num_keys, const PoolingRows* rows, cudaStream_t stream);
+
+  // Expands the vectors of the unique keys into d_vectors, or pools them by rows.
+  void write_output_(size_t table_id, const EmbeddingCacheWorkspace& workspace_handler,
+                     float* d_vectors, size_t num_keys, const PoolingRows* rows,
+                     cudaStream_t stream);
+
+  // Replays the cached CUDA graph of the lookup. Returns false if any of the keys missed.
+  bool lookup_with_graph_(size_t table_id, float* d_vectors,
+                          EmbeddingCacheWorkspace& workspace_handler, size_t num_keys,
+                          cudaStream_t stream);
+
+  // Allocates the GPU embedding cache of a table with num_set sets.
+  std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>> create_gpu_cache_(size_t table_id,
+                                                                           size_t num_set);
+
+  // Allocates an nv_gpu_cache, or shares it with other processes if shared_cache_dir_ is set. The
+  // owner writes the IPC handle of a table into its handle file, which the others open read-only.
+  template <typename value_type>
+  std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>> create_nv_cache_(size_t table_id,
+                                                                          size_t num_set);
+
+  // Whether the caches are opened from the IPC handles of another process, which inserts into them.
+  bool read_only_cache_() const {
+    return !cache_config_.shared_cache_dir_.empty() && !cache_config_.shared_cache_owner_;
+  }
+
+  // Replaces the cache of a table by one with num_set sets, and moves over its content.
+  void resize_gpu_cache_(size_t table_id, size_t num_set, cudaStream_t stream);
+
+  // Accumulates the lookup statistics used by rebalance_capacity.
+  void record_lookup_(size_t table_id, size_t num_queried_keys, size_t num_missing_keys) {
+    table_stats_[table_id].num_queried_keys.fetch_add(num_queried_keys, std::memory_order_relaxed);
+    table_stats_[table_id].num_missing_keys.fetch_add(num_missing_keys, std::memory_order_relaxed);
+  }
+
+  template <typename value_type>
   using NVCache =
       gpu_cache::gpu_cache<TypeHashKey, uint64_t, std::numeric_limits<TypeHashKey>::max(),
-                           SET_ASSOCIATIVITY, SLAB_SIZE>;
+                           SET_ASSOCIATIVITY, SLAB_SIZE, MurmurHash3_32<TypeHashKey>,
+                           Mod_Hash<TypeHashKey, size_t>, value_type>;
   using UniqueOp =
       unique_op::unique_op<TypeHashKey, uint64_t, std::numeric_limits<TypeHashKey>::max(),
                            std::numeric_limits<uint64_t>::max()>;
@@ -94,6 +152,22 @@ class EmbeddingCache : public EmbeddingCacheBase,
   // The shared thread-safe embedding cache
   std::vector<std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>>> gpu_emb_caches_;
 
+  // Held exclusively while gpu_emb_caches_ are resized, and shared by all other cache accesses
+  std::shared_mutex resize_mutex_;
+
+  // Upper bound of num_set_in_cache_, i.e. enough sets to cache the entire table
+  std::vector<size_t> max_num_set_in_cache_;
+
+  // Number of times the caches have been resized, which invalidates captured lookup graphs
+  std::vector<size_t> cache_generation_;
+
+  // Lookup statistics of each table since the last rebalancing
+  struct TableStats {
+    std::atomic<size_t> num_queried_keys{0};
+    std::atomic<size_t> num_missing_keys{0};
+  };
+  std::unique_ptr<TableStats[]> table_stats_;
+
   // streams for asynchronous parameter server insert threads
   std::vector<cudaStream_t> insert_streams_;
 
@@ -111,6 +185,11 @@ class EmbeddingCache : public EmbeddingCacheBase,
 
   // benchmark profiler
   std::unique_ptr<profiler> ec_profiler_;
+
+  // Always-on latency histograms of the cache query and miss compaction stages, 1 per table
+  std::vector<LatencyHistogram*> query_latency_;
+  std::vector<LatencyHistogram*> compaction_latency_;
+  std::vector<LatencyHistogram*> workspace_wait_latency_;
 };
 
 }  // namespace HugeCTR
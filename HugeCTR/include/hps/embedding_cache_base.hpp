@@ -41,6 +41,22 @@ class EmbeddingCacheBase {
                                   size_t num_keys, float hit_rate_threshold,
                                   cudaStream_t stream) = 0;
 
+  // Looks up the keys of all tables at once. The default implementation calls lookup_from_device
+  // for one table after another.
+  virtual void lookup_from_device_grouped(const std::vector<const void*>& d_keys_per_table,
+                                          const std::vector<float*>& d_vectors_per_table,
+                                          const std::vector<size_t>& num_keys_per_table,
+                                          float hit_rate_threshold, cudaStream_t stream);
+
+  // Looks up the keys of rows and writes the sum or mean of the vectors of each row to
+  // d_pooled_vectors, [rows.num_rows, emb_vec_size]. num_keys is rows.d_row_offsets[rows.num_rows].
+  // The default implementation looks up one vector per key into a temporary buffer, and pools them
+  // afterwards.
+  virtual void lookup_from_device_pooled(size_t table_id, float* d_pooled_vectors,
+                                         const void* d_keys, size_t num_keys,
+                                         const PoolingRows& rows, float hit_rate_threshold,
+                                         cudaStream_t stream);
+
   virtual void insert(size_t table_id, EmbeddingCacheWorkspace& workspace_handler,
                       cudaStream_t stream) = 0;
   virtual void init(const size_t table_id, EmbeddingCacheRefreshspace& refreshspace_handler,
@@ -54,6 +70,11 @@ class EmbeddingCacheBase {
                        cudaStream_t stream) = 0;
   virtual void finalize() = 0;
 
+  // Redistributes the device memory of the cache among the tables according to the lookups since
+  // the last call. Invoked at the beginning of each refresh cycle. The default implementation
+  // keeps the capacity of all tables.
+  virtual void rebalance_capacity(cudaStream_t stream);
+
   virtual EmbeddingCacheWorkspace create_workspace() = 0;
   virtual void destroy_workspace(EmbeddingCacheWorkspace&) = 0;
   virtual EmbeddingCacheRefreshspace create_refreshspace() = 0;
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime_api.h>
+
+#include <hps/embedding_cache.hpp>
+#include <hps/embedding_cache_base.hpp>
+#include <hps/inference_utils.hpp>
+#include <memory>
+#include <mutex>
+#include <static_table.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Embedding cache that pins the hottest keys of each table in a static hash table, and backs the
+ * remaining keys with a dynamic embedding cache. Lookups probe the static table first, which
+ * neither locks nor evicts, and only forward the absent keys to the dynamic cache. The static
+ * tables are filled by \p init with host buffers. To refresh sweeps, the pinned keys of a table
+ * appear as additional sets behind the sets of the dynamic cache.
+ */
+template <typename TypeHashKey>
+class HybridEmbeddingCache : public EmbeddingCacheBase {
+ public:
+  virtual ~HybridEmbeddingCache();
+  HybridEmbeddingCache(const InferenceParams& inference_params,
+                       const parameter_server_config& ps_config,
+                       HierParameterServerBase* const parameter_server);
+  HybridEmbeddingCache(HybridEmbeddingCache const&) = delete;
+  HybridEmbeddingCache& operator=(HybridEmbeddingCache const&) = delete;
+
+  virtual void lookup(size_t table_id, float* d_vectors, const void* h_keys, size_t num_keys,
+                      float hit_rate_threshold, cudaStream_t stream);
+  virtual void lookup_from_device(size_t table_id, float* d_vectors, const void* d_keys,
+                                  size_t num_keys, float hit_rate_threshold, cudaStream_t stream);
+  virtual void insert(size_t table_id, EmbeddingCacheWorkspace& workspace_handler,
+                      cudaStream_t stream);
+
+  virtual void init(const size_t table_id, EmbeddingCacheRefreshspace& refreshspace_handler,
+                    cudaStream_t stream);
+  // Pins the given keys in the static table.
+  virtual void init(const size_t table_id, void* h_refresh_embeddingcolumns_,
+                    void* h_refresh_emb_vec_, float* h_quant_scales, size_t h_length_,
+                    cudaStream_t stream) override;
+  virtual void dump(size_t table_id, void* d_keys, size_t* d_length, size_t start_index,
+                    size_t end_index, cudaStream_t stream);
+  virtual void refresh(size_t table_id, const void* d_keys, const void* d_vectors, size_t length,
+                       cudaStream_t stream);
+  virtual void finalize();
+  virtual void rebalance_capacity(cudaStream_t stream);
+
+  virtual EmbeddingCacheWorkspace create_workspace();
+  virtual void destroy_workspace(EmbeddingCacheWorkspace&);
+  virtual EmbeddingCacheRefreshspace create_refreshspace();
+  virtual void destroy_refreshspace(EmbeddingCacheRefreshspace&);
+
+  virtual const embedding_cache_config& get_cache_config() { return cache_config_; }
+  virtual const std::vector<cudaStream_t>& get_refresh_streams() {
+    return tail_->get_refresh_streams();
+  }
+  virtual const std::vector<cudaStream_t>& get_insert_streams() {
+    return tail_->get_insert_streams();
+  }
+  virtual int get_device_id() { return tail_->get_device_id(); }
+  virtual bool use_gpu_embedding_cache() { return tail_->use_gpu_embedding_cache(); }
+  virtual void set_profiler(int iteration, int warmup, bool enable_bench) {
+    tail_->set_profiler(iteration, warmup, enable_bench);
+  };
+  virtual void profiler_print() { tail_->profiler_print(); };
+
+ private:
+  using HotTable = gpu_cache::static_table<TypeHashKey, float, float>;
+
+  static const size_t BLOCK_SIZE_ = 64;
+
+  // Device buffers to forward the keys that are absent from the static table
+  struct Scratch {
+    TypeHashKey* d_keys;          // Keys of lookups from host memory
+    TypeHashKey* d_missing_keys;  // Keys that are absent from the static table
+    uint64_t* d_missing_index;    // Position of each absent key in the lookup
+    float* d_missing_emb_vec;     // Embedding vectors returned by the dynamic cache
+    size_t* d_missing_len;
+    size_t* h_missing_len;
+  };
+
+  // Copies the configuration of the dynamic cache, and adds the sets of the pinned keys.
+  void update_cache_config_();
+
+  Scratch* acquire_scratch_();
+  void release_scratch_(Scratch* scratch);
+
+  void lookup_hybrid_(size_t table_id, float* d_vectors, const TypeHashKey* d_keys,
+                      size_t num_keys, float hit_rate_threshold, Scratch& scratch,
+                      cudaStream_t stream);
+
+  // Dynamic embedding cache for the keys that are not pinned
+  std::shared_ptr<EmbeddingCache<TypeHashKey>> tail_;
+
+  // Static tables of the pinned keys, 1 per embedding table
+  std::vector<std::unique_ptr<HotTable>> hot_tables_;
+  std::vector<size_t> num_hot_keys_;
+  std::vector<std::vector<TypeHashKey>> pinned_keys_;
+  TypeHashKey* d_pin_keys_buffer_;
+
+  // The cache configuration
+  embedding_cache_config cache_config_;
+
+  // Capacity of the scratch buffers
+  size_t max_num_keys_;
+  size_t max_embedding_size_;
+
+  std::mutex scratch_mutex_;
+  std::vector<std::unique_ptr<Scratch>> scratch_pool_;
+  std::vector<Scratch*> idle_scratch_;
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime_api.h>
+
+#include <hps/embedding_cache_base.hpp>
+#include <hps/inference_utils.hpp>
+#include <memory>
+#include <mutex>
+#include <thread_pool.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * View of a group of embedding caches, one per device, that split the keys among them. Each key is
+ * only cached by the shard it hashes to. Lookups of keys owned by other shards are served by
+ * these shards directly from and into the memory of the calling device, which requires peer
+ * access between all devices (see \p enable_peer_access ). All other operations, such as refresh
+ * and workspace management, only concern the local shard.
+ */
+template <typename TypeHashKey>
+class ShardedEmbeddingCache : public EmbeddingCacheBase {
+ public:
+  /**
+   * Enables peer access between all \p devices .
+   *
+   * @return \p false if any pair of devices cannot access each other.
+   */
+  static bool enable_peer_access(const std::vector<int>& devices);
+
+  virtual ~ShardedEmbeddingCache();
+  ShardedEmbeddingCache(const std::vector<std::shared_ptr<EmbeddingCacheBase>>& shards,
+                        size_t shard_id);
+  ShardedEmbeddingCache(ShardedEmbeddingCache const&) = delete;
+  ShardedEmbeddingCache& operator=(ShardedEmbeddingCache const&) = delete;
+
+  virtual void lookup(size_t table_id, float* d_vectors, const void* h_keys, size_t num_keys,
+                      float hit_rate_threshold, cudaStream_t stream);
+  virtual void lookup_from_device(size_t table_id, float* d_vectors, const void* d_keys,
+                                  size_t num_keys, float hit_rate_threshold, cudaStream_t stream);
+  virtual void insert(size_t table_id, EmbeddingCacheWorkspace& workspace_handler,
+                      cudaStream_t stream);
+
+  virtual void init(const size_t table_id, EmbeddingCacheRefreshspace& refreshspace_handler,
+                    cudaStream_t stream);
+  virtual void init(const size_t table_id, void* h_refresh_embeddingcolumns_,
+                    void* h_refresh_emb_vec_, float* h_quant_scales, size_t h_length_,
+                    cudaStream_t stream) override;
+  virtual void dump(size_t table_id, void* d_keys, size_t* d_length, size_t start_index,
+                    size_t end_index, cudaStream_t stream);
+  virtual void refresh(size_t table_id, const void* d_keys, const void* d_vectors, size_t length,
+                       cudaStream_t stream);
+  virtual void finalize();
+  virtual void rebalance_capacity(cudaStream_t stream);
+
+  virtual EmbeddingCacheWorkspace create_workspace();
+  virtual void destroy_workspace(EmbeddingCacheWorkspace&);
+  virtual EmbeddingCacheRefreshspace create_refreshspace();
+  virtual void destroy_refreshspace(EmbeddingCacheRefreshspace&);
+
+  virtual const embedding_cache_config& get_cache_config() { return local_()->get_cache_config(); }
+  virtual const std::vector<cudaStream_t>& get_refresh_streams() {
+    return local_()->get_refresh_streams();
+  }
+  virtual const std::vector<cudaStream_t>& get_insert_streams() {
+    return local_()->get_insert_streams();
+  }
+  virtual int get_device_id() { return local_()->get_device_id(); }
+  virtual bool use_gpu_embedding_cache() { return local_()->use_gpu_embedding_cache(); }
+  virtual void set_profiler(int iteration, int warmup, bool enable_bench) {
+    local_()->set_profiler(iteration, warmup, enable_bench);
+  };
+  virtual void profiler_print() { local_()->profiler_print(); };
+
+ private:
+  static const size_t BLOCK_SIZE_ = 64;
+
+  // Device buffers to split a lookup among the shards
+  struct Scratch {
+    TypeHashKey* d_keys;          // Keys of lookups from host memory
+    TypeHashKey* d_shard_keys;    // Keys grouped by shard
+    uint64_t* d_shard_index;      // Position of each grouped key in the lookup
+    float* d_shard_emb_vec;       // Embedding vectors returned by the shards
+    size_t* d_shard_offset;       // Start of the keys of each shard, size = # of shards + 1
+    size_t* d_shard_cursor;       // Insertion point of each shard during partitioning
+    size_t* h_shard_offset;       // Host copy of d_shard_offset
+  };
+
+  EmbeddingCacheBase* local_() const { return shards_[shard_id_].get(); }
+
+  Scratch* acquire_scratch_();
+  void release_scratch_(Scratch* scratch);
+
+  void lookup_sharded_(size_t table_id, float* d_vectors, const TypeHashKey* d_keys,
+                       size_t num_keys, float hit_rate_threshold, Scratch& scratch,
+                       cudaStream_t stream);
+
+  // The embedding caches of all devices, and the index of the one on this device
+  const std::vector<std::shared_ptr<EmbeddingCacheBase>> shards_;
+  const size_t shard_id_;
+
+  // Capacity of the scratch buffers
+  size_t max_num_keys_;
+  size_t max_embedding_size_;
+
+  // Streams to look up the keys of each remote shard, on the device of that shard
+  std::vector<cudaStream_t> shard_streams_;
+
+  // Threads that wait for the lookups of the remote shards
+  ThreadPool lookup_workers_;
+
+  std::mutex scratch_mutex_;
+  std::vector<std::unique_ptr<Scratch>> scratch_pool_;
+  std::vector<Scratch*> idle_scratch_;
+};
+
+}  // namespace HugeCTR
@@ -99,6 +99,9 @@ class EmbeddingCacheStoch : public EmbeddingCacheBase,
   // The shared thread-safe embedding cache
   std::vector<std::unique_ptr<ecache::EmbedCacheBase<TypeHashKey>>> gpu_emb_caches_;
 
+  // Admission policy for replacing keys in each embedding cache, empty if every key is admitted
+  std::vector<std::unique_ptr<gpu_cache::admission_filter<TypeHashKey>>> admission_filters_;
+
   // streams for asynchronous parameter server insert threads
   std::vector<cudaStream_t> insert_streams_;
 
@@ -128,8 +131,18 @@ class EmbeddingCacheStoch : public EmbeddingCacheBase,
     ModifyContextHandle modify_handle_;
     LookupContextHandle lookup_handle_;
     cudaEvent_t modify_event_;
+    // Buffers for the missing keys that pass the admission filter
+    TypeHashKey* d_admitted_embeddingcolumns_;
+    TypeHashKey* h_admitted_embeddingcolumns_;
+    float* d_admitted_emb_vec_;
+    size_t* d_admitted_length_;
+    size_t* h_admitted_length_;
   };
 
+  // Filters the missing keys of a workspace before they are replaced into the cache
+  bool has_admission_filter() const { return !admission_filters_.empty(); }
+  size_t admit(size_t table_id, EmbeddingCacheWorkspace& workspace_handler, cudaStream_t stream);
+
   struct RefreshPrivateData {
     TypeHashKey* ptr_;
     ModifyContextHandle modify_handle_;
@@ -159,7 +172,6 @@ class EmbeddingCacheStoch : public EmbeddingCacheBase,
 
   using WriteLock = std::unique_lock<std::shared_mutex>;
   using ReadLock = std::shared_lock<std::shared_mutex>;
-  const bool m_bUnique = false;
 };
 
 }  // namespace HugeCTR
@@ -20,11 +20,16 @@
 #include <condition_variable>
 #include <core/memory.hpp>
 #include <deque>
+#include <filesystem>
 #include <functional>
 #include <hps/database_backend.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
 #include <thread>
 #include <thread_pool.hpp>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -37,6 +42,14 @@ namespace HugeCTR {
 struct HashMapBackendParams final : public VolatileBackendParams {
   size_t allocation_rate{256L * 1024 *
                          1024};  // Number of additional bytes to allocate per allocation cycle.
+  bool numa_aware{false};  // Bind the value pages of each partition to a NUMA node, and process
+                           // partitions using threads pinned to the node that owns them.
+  size_t huge_page_size{0};  // Back value pages with huge pages of this size (0 = disabled; valid
+                             // sizes are 2 MiB and 1 GiB).
+  std::string snapshot_path;  // Directory for partition snapshots (empty = disabled). Existing
+                              // snapshots are restored on startup.
+  std::chrono::milliseconds snapshot_interval{
+      0};  // Interval at which snapshots are written in the background (0 = only on destruction).
 };
 
 /**
@@ -59,6 +72,8 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
    */
   HashMapBackend(const HashMapBackendParams& params);
 
+  virtual ~HashMapBackend();
+
   bool is_shared() const override final { return false; }
 
   const char* get_name() const override { return "HashMapBackend"; }
@@ -90,17 +105,43 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
 
   size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
 
+  /**
+   * Writes a snapshot of all tables to `snapshot_path`. Partitions are written one at a time.
+   * While a partition is being written, only inserts and evictions in that partition are blocked.
+   *
+   * @return The number of entries written.
+   */
+  size_t snapshot();
+
  protected:
-#if 1
-  // Better performance on most systems.
-  using CharAllocator = AlignedAllocator<char>;
+  /**
+   * Allocator for value pages. Without huge pages, behaves like \p AlignedAllocator . Otherwise,
+   * maps memory from the huge page pool (hugetlbfs), or, if exhausted, falls back to transparent
+   * huge pages.
+   */
+  struct CharAllocator {
+    using value_type = char;
+    static constexpr size_t alignment{AlignedAllocator<char>::alignment};
+
+    // Only needed to satisfy std::allocator_traits, since this is not a template.
+    template <typename U>
+    struct rebind {
+      static_assert(std::is_same_v<U, char>);
+      using other = CharAllocator;
+    };
+
+    size_t huge_page_size{0};
+
+    [[nodiscard]] char* allocate(size_t n) const;
+
+    void deallocate(char* p, size_t n) const noexcept;
+
+    inline bool operator==(const CharAllocator& other) const {
+      return huge_page_size == other.huge_page_size;
+    }
+    inline bool operator!=(const CharAllocator& other) const { return !operator==(other); }
+  };
   static constexpr size_t value_page_alignment{CharAllocator::alignment};
-#else
-  using CharAllocator = std::allocator<char>;
-  // __STDCPP_DEFAULT_NEW_ALIGNMENT__ is actually 16 with current GCC. But we use sizeof(char) here
-  // which equates to have no padding.
-  static constexpr size_t value_page_alignment{sizeof(char)};
-#endif
   static_assert(value_page_alignment > 0);
 
   using ValuePage = std::vector<char, CharAllocator>;
@@ -119,29 +160,81 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
   struct Partition final {
     const uint32_t value_size;
     const size_t allocation_rate;
+    const size_t overflow_margin;
+    const size_t overflow_resolution_margin;
+    const int numa_node;  // NUMA node that owns this partition (-1 = no particular node).
+
+    // Access control (per partition). Readers only contend with writers of the same partition.
+    mutable std::shared_mutex read_write_guard;
 
     // Pooled payload storage.
     std::vector<ValuePage> value_pages;
     std::vector<ValuePtr> value_slots;
 
+    // Value pages that were restored from a snapshot. These are private file mappings. Hence,
+    // values are paged in from the snapshot upon first access, and copied upon first write.
+    std::vector<std::shared_ptr<char>> snapshot_pages;
+
     // Key -> Payload map.
     phmap::flat_hash_map<Key, Payload> entries;
 
+    // Entry at which the `EvictClock` overflow policy resumes its sweep.
+    std::optional<Key> clock_hand;
+
     Partition() = delete;
 
-    Partition(const uint32_t value_size, const HashMapBackendParams& params)
-        : value_size{value_size}, allocation_rate{params.allocation_rate} {}
+    Partition(const uint32_t value_size, const HashMapBackendParams& params,
+              const size_t overflow_margin, const int numa_node)
+        : value_size{value_size},
+          allocation_rate{params.allocation_rate},
+          overflow_margin{overflow_margin},
+          overflow_resolution_margin{params.overflow_resolution_margin(overflow_margin)},
+          numa_node{numa_node} {}
   };
 
+  // Partitions are not movable (they own a mutex). Hence, we use a deque for stable addresses.
+  using PartitionList = std::deque<Partition>;
+
   // Actual data.
   CharAllocator char_allocator_;
-  std::unordered_map<std::string, std::vector<Partition>> tables_;
+  std::unordered_map<std::string, PartitionList> tables_;
 
-  // Access control.
+  // Access control. Only guards the table directory. Exclusive access is only required to create
+  // or drop tables. Operations on the contents of tables are guarded by the partition locks.
   mutable std::shared_mutex read_write_guard_;
 
+  // NUMA-aware placement (one thread pool per NUMA node; empty if disabled).
+  std::vector<std::unique_ptr<ThreadPool>> numa_thread_pools_;
+
+  // Background snapshots.
+  std::thread snapshot_thread_;
+  std::mutex snapshot_guard_;  // Serializes snapshots.
+  std::mutex snapshot_thread_guard_;
+  std::condition_variable snapshot_thread_semaphore_;
+  bool snapshot_thread_terminate_{false};
+
+  inline ThreadPool& get_thread_pool_(const Partition& part) const {
+    return part.numa_node < 0 ? ThreadPool::get()
+                              : *numa_thread_pools_[static_cast<size_t>(part.numa_node)];
+  }
+
+  // Create the partitions for a table, if it does not exist yet (acquires exclusive access).
+  void create_table_(const std::string& table_name, uint32_t value_size);
+
+  // Allocate another value page for the partition, and fill up the free value slots.
+  void allocate_value_page_(Partition& part);
+
   // Overflow resolution.
   size_t resolve_overflow_(const std::string& table_name, size_t part_index, Partition& part);
+
+  // Snapshot a single partition (the caller must hold a shared lock of the partition).
+  size_t snapshot_partition_(const std::filesystem::path& path, const Partition& part) const;
+
+  // Restore all tables from `snapshot_path`.
+  void restore_snapshots_();
+
+  // Restore a single table. Returns the number of entries restored.
+  size_t restore_table_(const std::string& table_name, const std::filesystem::path& dir);
 };
 
 // TODO: Remove me!
@@ -15,6 +15,9 @@
  */
 #pragma once
 
+#include <parallel_hashmap/phmap.h>
+
+#include <array>
 #include <hps/database_backend_detail.hpp>
 #include <hps/inference_utils.hpp>
 #include <thread_pool.hpp>
@@ -72,30 +75,115 @@ namespace HugeCTR {
 
 /**
  * HashMap Backend / Fetch
+ *
+ * Keys are looked up in blocks to overlap memory accesses. For each block, we first compute all
+ * hashes and prefetch the buckets. Then we probe the buckets and prefetch the values. Finally, the
+ * values are gathered.
+ */
+inline constexpr size_t hash_map_fetch_block_size{16};
+
+/**
+ * Computes the hash of \p key and prefetches the associated bucket (if \p map is a hash map).
+ */
+template <typename Map, typename Key>
+inline size_t hash_map_prefetch_bucket(const Map& map, const Key& key) {
+  return 0;
+}
+
+template <typename K, typename V, typename Key>
+inline size_t hash_map_prefetch_bucket(const phmap::flat_hash_map<K, V>& map, const Key& key) {
+  const size_t hash{map.hash_function()(key)};
+  map.prefetch_hash(hash);
+  return hash;
+}
+
+/**
+ * Looks up \p key using the hash precomputed by \p hash_map_prefetch_bucket .
+ */
+template <typename Map, typename Key>
+inline auto hash_map_find(Map& map, const Key& key, const size_t hash) {
+  return map.find(key);
+}
+
+template <typename K, typename V, typename Key>
+inline auto hash_map_find(phmap::flat_hash_map<K, V>& map, const Key& key, const size_t hash) {
+  return map.find(key, hash);
+}
+
+/**
+ * Prefetches all cache lines occupied by a value.
  */
+inline void hash_map_prefetch_value(const char* const value, const size_t value_size) {
+  for (size_t i{0}; i < value_size; i += 64) {
+    __builtin_prefetch(&value[i]);
+  }
+}
+
+#ifdef HCTR_HPS_HASH_MAP_FETCH_BLOCK_
+#error HCTR_HPS_HASH_MAP_FETCH_BLOCK_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_HASH_MAP_FETCH_BLOCK_(...)                                                   \
+  do {                                                                                        \
+    static_assert(std::is_same_v<decltype(miss_count), size_t>);                              \
+    static_assert(std::is_invocable_v<decltype(on_miss), size_t>);                            \
+    static_assert(std::is_same_v<decltype(value_stride), const size_t>);                      \
+    static_assert(std::is_same_v<decltype(values), char* const>);                             \
+    static_assert(std::is_same_v<decltype(num_pending), size_t>);                             \
+                                                                                              \
+    /* Pass 1: Hash keys and prefetch buckets. */                                             \
+    std::array<size_t, hash_map_fetch_block_size> hashes;                                     \
+    for (size_t j{0}; j < num_pending; ++j) {                                                 \
+      hashes[j] = hash_map_prefetch_bucket(part.entries, *pending[j]);                        \
+    }                                                                                         \
+                                                                                              \
+    /* Pass 2: Probe buckets and prefetch values. */                                          \
+    std::array<decltype(part.entries.end()), hash_map_fetch_block_size> its;                  \
+    for (size_t j{0}; j < num_pending; ++j) {                                                 \
+      its[j] = hash_map_find(part.entries, *pending[j], hashes[j]);                           \
+      if (its[j] != part.entries.end()) {                                                     \
+        hash_map_prefetch_value(&*its[j]->second.value, part.value_size);                     \
+      }                                                                                       \
+    }                                                                                         \
+                                                                                              \
+    /* Pass 3: Gather values. */                                                              \
+    for (size_t j{0}; j < num_pending; ++j) {                                                 \
+      const Key* const k{pending[j]};                                                         \
+      if (its[j] != part.entries.end()) {                                                     \
+        Payload& payload{its[j]->second};                                                     \
+                                                                                              \
+        /* Race-conditions here are deliberately ignored because insignificant in practice. */ \
+        __VA_ARGS__;                                                                          \
+        std::copy_n(payload.value, part.value_size, &values[(k - keys) * value_stride]);      \
+      } else {                                                                                \
+        on_miss(k - keys);                                                                    \
+        ++miss_count;                                                                         \
+      }                                                                                       \
+    }                                                                                         \
+    num_pending = 0;                                                                          \
+  } while (0)
+
 #ifdef HCTR_HPS_HASH_MAP_FETCH_IMPL_
 #error HCTR_HPS_HASH_MAP_FETCH_IMPL_ already defined. Potential naming conflict!
 #endif
-#define HCTR_HPS_HASH_MAP_FETCH_IMPL_(...)                                                   \
-  do {                                                                                       \
-    static_assert(std::is_same_v<decltype(miss_count), size_t>);                             \
-    static_assert(std::is_invocable_v<decltype(on_miss), size_t>);                           \
-    static_assert(std::is_same_v<decltype(value_stride), const size_t>);                     \
-    static_assert(std::is_same_v<decltype(k), const Key*> ||                                 \
-                  std::is_same_v<decltype(k), const Key* const>);                            \
-    static_assert(std::is_same_v<decltype(values), char* const>);                            \
-                                                                                             \
-    const auto& it{part.entries.find(*k)};                                                   \
-    if (it != part.entries.end()) {                                                          \
-      Payload& payload{it->second};                                                          \
-                                                                                             \
-      /* Race-conditions here are deliberately ignored because insignificant in practice. */ \
-      __VA_ARGS__;                                                                           \
-      std::copy_n(payload.value, part.value_size, &values[(k - keys) * value_stride]);       \
-    } else {                                                                                 \
-      on_miss(k - keys);                                                                     \
-      ++miss_count;                                                                          \
-    }                                                                                        \
+#define HCTR_HPS_HASH_MAP_FETCH_IMPL_(...)                        \
+  do {                                                            \
+    static_assert(std::is_same_v<decltype(k), const Key*> ||      \
+                  std::is_same_v<decltype(k), const Key* const>); \
+                                                                  \
+    pending[num_pending++] = k;                                   \
+    if (num_pending == hash_map_fetch_block_size) {               \
+      HCTR_HPS_HASH_MAP_FETCH_BLOCK_(__VA_ARGS__);                \
+    }                                                             \
+  } while (0)
+
+#ifdef HCTR_HPS_HASH_MAP_CLOCK_TICK_
+#error HCTR_HPS_HASH_MAP_CLOCK_TICK_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_HASH_MAP_CLOCK_TICK_()                  \
+  do {                                                   \
+    if (payload.access_count < clock_max_access_count) { \
+      ++payload.access_count;                            \
+    }                                                    \
   } while (0)
 
 #ifdef HCTR_HPS_HASH_MAP_FETCH_
@@ -105,16 +193,27 @@ namespace HugeCTR {
   [&]() {                                                                                     \
     static_assert(std::is_same_v<decltype(overflow_policy), const DatabaseOverflowPolicy_t>); \
                                                                                               \
+    const Key* pending[hash_map_fetch_block_size];                                            \
+    size_t num_pending{0};                                                                    \
+                                                                                              \
     switch (overflow_policy) {                                                                \
       case DatabaseOverflowPolicy_t::EvictRandom: {                                           \
         HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_HASH_MAP_FETCH_IMPL_());                            \
+        HCTR_HPS_HASH_MAP_FETCH_BLOCK_();                                                     \
       } break;                                                                                \
       case DatabaseOverflowPolicy_t::EvictLeastUsed: {                                        \
         HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_HASH_MAP_FETCH_IMPL_(++payload.access_count));      \
+        HCTR_HPS_HASH_MAP_FETCH_BLOCK_(++payload.access_count);                               \
       } break;                                                                                \
       case DatabaseOverflowPolicy_t::EvictOldest: {                                           \
         const time_t now{std::time(nullptr)};                                                 \
         HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_HASH_MAP_FETCH_IMPL_(payload.last_access = now));   \
+        HCTR_HPS_HASH_MAP_FETCH_BLOCK_(payload.last_access = now);                            \
+      } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictClock: {                                            \
+        HCTR_HPS_DB_APPLY_(MODE,                                                              \
+                           HCTR_HPS_HASH_MAP_FETCH_IMPL_(HCTR_HPS_HASH_MAP_CLOCK_TICK_()));   \
+        HCTR_HPS_HASH_MAP_FETCH_BLOCK_(HCTR_HPS_HASH_MAP_CLOCK_TICK_());                      \
       } break;                                                                                \
     }                                                                                         \
     return true;                                                                              \
@@ -144,21 +243,7 @@ namespace HugeCTR {
     if (res.second) {                                                                        \
       /* If no free space, allocate another buffer, and fill pointer queue. */               \
       if (part.value_slots.empty()) {                                                        \
-        const size_t stride{(value_size + value_page_alignment - 1) / value_page_alignment * \
-                            value_page_alignment};                                           \
-        const size_t num_values{part.allocation_rate / stride};                              \
-        HCTR_CHECK(num_values > 0);                                                          \
-                                                                                             \
-        /* Get more memory. */                                                               \
-        part.value_pages.emplace_back(num_values* stride, char_allocator_);                  \
-        ValuePage& value_page{part.value_pages.back()};                                      \
-                                                                                             \
-        /* Stock up slot references. */                                                      \
-        part.value_slots.reserve(part.value_slots.size() + num_values);                      \
-        for (auto it{value_page.end()}; it != value_page.begin();) {                         \
-          it -= stride;                                                                      \
-          part.value_slots.emplace_back(&*it);                                               \
-        }                                                                                    \
+        allocate_value_page_(part);                                                          \
       }                                                                                      \
                                                                                              \
       /* Fetch storage slot. */                                                              \
@@ -191,10 +276,35 @@ namespace HugeCTR {
         const time_t now{std::time(nullptr)};                                                 \
         HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_HASH_MAP_INSERT_IMPL_(payload.last_access = now));  \
       } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictClock: {                                            \
+        /* Only reset new entries. Updates retain their access count. */                      \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_HASH_MAP_INSERT_IMPL_(if (res.second) {             \
+                             payload.access_count = 0;                                        \
+                           }));                                                               \
+      } break;                                                                                \
     }                                                                                         \
     return true;                                                                              \
   }()
 
+/**
+ * Same as HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_, but dispatches each partition to the thread pool
+ * that is associated with its NUMA node.
+ */
+#ifdef HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_
+#error HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_(...)                                 \
+  do {                                                                                \
+    std::vector<std::future<void>> tasks;                                             \
+    tasks.reserve(num_partitions);                                                    \
+                                                                                      \
+    for (size_t part_index{0}; part_index < num_partitions; ++part_index) {           \
+      ThreadPool& pool{get_thread_pool_(parts[part_index])};                          \
+      tasks.emplace_back(pool.submit([&, part_index]() { __VA_ARGS__; }));            \
+    }                                                                                 \
+    ThreadPool::await(tasks.begin(), tasks.end());                                    \
+  } while (0)
+
 // TODO: Remove me!
 #pragma GCC diagnostic pop
 
@@ -16,6 +16,8 @@
 #pragma once
 
 #include <common.hpp>
+#include <condition_variable>
+#include <hps/bloom_filter.hpp>
 #include <hps/database_backend.hpp>
 #include <hps/embedding_cache_base.hpp>
 #include <hps/hier_parameter_server_base.hpp>
@@ -24,9 +26,12 @@
 #include <hps/message.hpp>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -41,6 +46,8 @@ class HierParameterServer : public HierParameterServerBase {
   HierParameterServer& operator=(HierParameterServer const&) = delete;
 
   virtual void update_database_per_model(const InferenceParams& inference_params);
+  virtual void apply_delta_per_model(const std::string& model_name,
+                                     const std::vector<std::string>& delta_model_files);
   virtual void create_embedding_cache_per_model(InferenceParams& inference_params);
   virtual void init_ec(InferenceParams& inference_params,
                        std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>> embedding_cache_map);
@@ -55,6 +62,8 @@ class HierParameterServer : public HierParameterServerBase {
   virtual void free_buffer(void* p);
   virtual void lookup(const void* h_keys, size_t length, float* h_vectors,
                       const std::string& model_name, size_t table_id);
+  virtual void lookup(const std::vector<const void*>& h_keys, const std::vector<size_t>& lengths,
+                      const std::vector<float*>& h_vectors, const std::string& model_name);
   virtual void refresh_embedding_cache(const std::string& model_name, int device_id);
   virtual void insert_embedding_cache(size_t table_id,
                                       std::shared_ptr<EmbeddingCacheBase> embedding_cache,
@@ -75,11 +84,131 @@ class HierParameterServer : public HierParameterServerBase {
   std::unique_ptr<DatabaseBackendBase<TypeHashKey>> volatile_db_;
   bool volatile_db_initialize_after_startup_;
   double volatile_db_cache_rate_;
+  std::string volatile_db_key_frequency_path_;
   bool volatile_db_cache_missed_embeddings_;
+  double volatile_db_cache_missed_embeddings_rate_;
+  bool volatile_db_cache_missed_embeddings_doorkeeper_;
   mutable ThreadPool volatile_db_async_inserter_{"vdb inserter", 1};
 
+  // Admission filters for missed embeddings (per table). A key is only elevated to the volatile
+  // database once it missed at least twice. Filters are reset after `capacity` first-time misses.
+  struct Doorkeeper final {
+    static constexpr size_t capacity{1 << 20};
+    BloomFilter filter{capacity, 8};
+    std::atomic<size_t> num_keys{0};
+  };
+  std::unordered_map<std::string, std::shared_ptr<Doorkeeper>> doorkeepers_;
+  mutable std::shared_mutex doorkeepers_guard_;
+
   std::unique_ptr<DatabaseBackendBase<TypeHashKey>> persistent_db_;
   bool persistent_db_initialize_after_startup_;
+  std::string persistent_db_sst_staging_path_;  // If set, bulk-ingest models via SST files.
+  size_t persistent_db_num_threads_;
+  size_t persistent_db_bloom_filter_bits_per_key_;
+
+  // Negative caches for the persistent database (per table). Keys that the filter of a table rules
+  // out are not forwarded to the persistent database. Tables without a filter forward all keys.
+  std::unordered_map<std::string, std::shared_ptr<BloomFilter>> persistent_db_filters_;
+  mutable std::shared_mutex persistent_db_filters_guard_;
+
+  // Double-buffered model updates. Lookups pin the active version of a model for their duration.
+  // Once no lookup refers to a replaced version any longer, its tables can be dropped.
+  struct ModelVersion final {
+    size_t version;
+  };
+  bool double_buffered_update_;
+  std::mutex released_model_versions_guard_;
+  std::condition_variable released_model_versions_cv_;  // Notified once a version is released.
+  std::unordered_map<std::string, std::shared_ptr<const ModelVersion>> model_versions_;
+  mutable std::shared_mutex model_versions_guard_;
+
+  // Guards (re-)creating the real-time update subscribers.
+  std::mutex update_source_guard_;
+
+  // Keys of each table that were updated since the last refresh of the GPU embedding cache on a
+  // device (see `UpdateSourceParams::incremental_cache_refresh`). Once more keys were updated than
+  // the cache can hold, the next refresh falls back to sweeping the entire cache.
+  struct DirtyKeys final {
+    std::unordered_set<TypeHashKey> keys;
+    size_t max_num_keys;
+    bool overflow{false};
+  };
+  std::unordered_map<std::string, std::map<int, DirtyKeys>> dirty_keys_;
+  std::mutex dirty_keys_guard_;
+
+  // Creates a model version that notifies `released_model_versions_cv_` once its last reference is
+  // released.
+  std::shared_ptr<const ModelVersion> make_model_version_(size_t version);
+
+  std::shared_ptr<const ModelVersion> get_model_version_(const std::string& model_name) const;
+
+  // Table name under which a specific version of table is stored (version 0 = unversioned).
+  static std::string make_versioned_tag_name_(const std::string& tag_name, size_t version);
+
+  // Maps the name of a table to the table that stores the active model version. The returned
+  // version must be held while accessing the table.
+  std::pair<std::string, std::shared_ptr<const ModelVersion>> resolve_tag_name_(
+      const std::string& tag_name) const;
+
+  // Migrates the embeddings of keys that missed the volatile database (i.e., `keys[indices[i]]`)
+  // to the volatile database (asynchronously).
+  void elevate_missed_embeddings_(const std::string& tag_name,
+                                  const std::shared_ptr<const ModelVersion>& model_version,
+                                  const TypeHashKey* keys, const float* vectors,
+                                  size_t embedding_size, const std::vector<size_t>& indices);
+
+  // Reads the key-frequency histogram of a table, and returns the (at most) `max_num_keys` most
+  // frequently accessed keys. Returns an empty set if no histogram is available.
+  std::unordered_set<TypeHashKey> load_hot_keys_(const std::string& model_name,
+                                                 const std::string& table_name,
+                                                 size_t max_num_keys) const;
+
+  // Computes the overflow margins of the individual volatile database tables (see
+  // `VolatileDatabaseParams::table_overflow_margins` and `shared_overflow_margin`).
+  std::unordered_map<std::string, size_t> make_table_overflow_margins_(
+      const VolatileDatabaseParams& conf) const;
+
+  // Applies sampling and the doorkeeper to missed keys (i.e., `keys[indices[i]]`). Returns the
+  // indices of the keys that should be elevated to the volatile database.
+  const std::vector<size_t>& admit_missed_embeddings_(const std::string& tag_name,
+                                                      const TypeHashKey* keys,
+                                                      const std::vector<size_t>& indices,
+                                                      std::vector<size_t>& buffer);
+
+  void erase_doorkeepers_(const std::vector<std::string>& tag_names);
+
+  std::shared_ptr<BloomFilter> get_persistent_db_filter_(const std::string& tag_name) const;
+
+  void erase_persistent_db_filters_(const std::vector<std::string>& tag_names);
+
+  // Fills the embeddings of keys that missed the volatile database (i.e., `keys[indices[i]]`), but
+  // are certainly absent from the persistent database with default values. Returns the indices of
+  // the keys that must still be queried (`indices` itself, if the table has no filter).
+  const std::vector<size_t>& filter_persistent_db_misses_(const std::string& tag_name,
+                                                          const TypeHashKey* keys,
+                                                          const std::vector<size_t>& indices,
+                                                          const DatabaseMissCallback& fill_default,
+                                                          std::vector<size_t>& buffer) const;
+
+  // Loads a table of a model into the databases, as the given version. Returns its number of keys.
+  size_t load_table_into_databases_(const InferenceParams& inference_params, size_t table_id,
+                                    size_t version);
+
+  // Upserts the delta sparse model files of a model into the active version of its tables.
+  void apply_delta_(const InferenceParams& inference_params,
+                    const std::vector<std::string>& delta_model_files);
+
+  // Records updated keys of a table for the next refresh of its GPU embedding caches.
+  void mark_dirty_keys_(const std::string& tag_name, size_t num_pairs, const TypeHashKey* keys);
+
+  // Moves the keys of a table that were updated since the last refresh on a device to `keys`.
+  // Returns `false` if updates are not tracked for this table, or if they overflowed.
+  bool take_dirty_keys_(const std::string& tag_name, int device_id,
+                        std::vector<TypeHashKey>& keys);
+
+  // Overwrites the embeddings of keys that are resident in the GPU embedding caches of a table.
+  void refresh_embedding_cache_(const std::string& tag_name, size_t num_pairs,
+                                const TypeHashKey* keys, const char* values, size_t value_size);
 
   // Realtime data ingestion.
   std::unique_ptr<MessageSource<TypeHashKey>> volatile_db_source_;
@@ -40,12 +40,25 @@ class HierParameterServerBase {
 
   static std::shared_ptr<HierParameterServerBase> create(const std::string& hps_json_config_file);
 
+  /**
+   * Returns the parameter server of this process that already serves the models of \p ps_config ,
+   * or creates it if none of these models is loaded yet. This lets the plugins and backends of one
+   * process share the embedding tables and caches of a model, instead of loading them once each.
+   * A live parameter server must serve all models of \p ps_config on all of their devices.
+   */
+  static std::shared_ptr<HierParameterServerBase> get_or_create(
+      const parameter_server_config& ps_config);
+
   // TODO: remove this static method after merging hugectr_inference_backend
   static std::shared_ptr<HierParameterServerBase> create(
       const parameter_server_config& ps_config,
       const std::vector<InferenceParams>& inference_params_array);
 
   virtual void update_database_per_model(const InferenceParams& inference_params) = 0;
+  // Upserts the rows of delta sparse model files, one per table like the sparse model files of the
+  // model, into its databases and the GPU embedding caches that hold them. Empty files are skipped.
+  virtual void apply_delta_per_model(const std::string& model_name,
+                                     const std::vector<std::string>& delta_model_files) = 0;
   virtual void create_embedding_cache_per_model(InferenceParams& inference_params) = 0;
   virtual void init_ec(
       InferenceParams& inference_params,
@@ -61,6 +74,10 @@ class HierParameterServerBase {
   virtual void free_buffer(void* p) = 0;
   virtual void lookup(const void* h_keys, size_t length, float* h_vectors,
                       const std::string& model_name, size_t table_id) = 0;
+  // Same as calling lookup for tables 0, 1, ... of a model. But the database queries for different
+  // tables overlap.
+  virtual void lookup(const std::vector<const void*>& h_keys, const std::vector<size_t>& lengths,
+                      const std::vector<float*>& h_vectors, const std::string& model_name) = 0;
   virtual void refresh_embedding_cache(const std::string& model_name, int device_id) = 0;
   virtual void insert_embedding_cache(size_t table_id,
                                       std::shared_ptr<EmbeddingCacheBase> embedding_cache,
@@ -49,6 +49,8 @@ enum class DatabaseType_t {
   HashMap,
   ParallelHashMap,
   MultiProcessHashMap,
+  SlabHashMap,
+  TieredHashMap,
   RedisCluster,
   RocksDB,
 };
@@ -56,6 +58,13 @@ enum class DatabaseOverflowPolicy_t {
   EvictRandom,
   EvictLeastUsed,
   EvictOldest,
+  EvictClock,
+};
+enum class DatabaseValueEncoding_t {
+  Raw,
+  Float16,
+  BFloat16,
+  Float8,
 };
 enum class UpdateSourceType_t {
   Null,
@@ -66,7 +75,9 @@ enum class EmbeddingCacheType_t {
   Static,
   UVM,
   Stochastic,
+  Hybrid,
 };
+enum class PoolingCombiner_t { Sum, Mean };
 
 constexpr const char* hctr_enum_to_c_str(const DatabaseType_t value) {
   // Remark: Dependent functions assume lower-case, and underscore separated.
@@ -79,6 +90,10 @@ constexpr const char* hctr_enum_to_c_str(const DatabaseType_t value) {
       return "parallel_hash_map";
     case DatabaseType_t::MultiProcessHashMap:
       return "multi_process_hash_map";
+    case DatabaseType_t::SlabHashMap:
+      return "slab_hash_map";
+    case DatabaseType_t::TieredHashMap:
+      return "tiered_hash_map";
     case DatabaseType_t::RedisCluster:
       return "redis_cluster";
     case DatabaseType_t::RocksDB:
@@ -98,6 +113,8 @@ constexpr const char* hctr_enum_to_c_str(const EmbeddingCacheType_t value) {
       return "uvm";
     case EmbeddingCacheType_t::Stochastic:
       return "stochastic";
+    case EmbeddingCacheType_t::Hybrid:
+      return "hybrid";
     default:
       return "dynamic";
   }
@@ -112,10 +129,27 @@ constexpr const char* hctr_enum_to_c_str(const DatabaseOverflowPolicy_t value) {
       return "evict_least_used";
     case DatabaseOverflowPolicy_t::EvictOldest:
       return "evict_oldest";
+    case DatabaseOverflowPolicy_t::EvictClock:
+      return "evict_clock";
     default:
       return "<unknown DatabaseOverflowPolicy_t value>";
   }
 }
+constexpr const char* hctr_enum_to_c_str(const DatabaseValueEncoding_t value) {
+  // Remark: Dependent functions assume lower-case, and underscore separated.
+  switch (value) {
+    case DatabaseValueEncoding_t::Raw:
+      return "raw";
+    case DatabaseValueEncoding_t::Float16:
+      return "float16";
+    case DatabaseValueEncoding_t::BFloat16:
+      return "bfloat16";
+    case DatabaseValueEncoding_t::Float8:
+      return "float8";
+    default:
+      return "<unknown DatabaseValueEncoding_t value>";
+  }
+}
 constexpr const char* hctr_enum_to_c_str(const UpdateSourceType_t value) {
   // Remark: Dependent functions assume lower-case, and underscore separated.
   switch (value) {
@@ -134,6 +168,9 @@ inline std::ostream& operator<<(std::ostream& os, DatabaseType_t value) {
 inline std::ostream& operator<<(std::ostream& os, DatabaseOverflowPolicy_t value) {
   return os << hctr_enum_to_c_str(value);
 }
+inline std::ostream& operator<<(std::ostream& os, DatabaseValueEncoding_t value) {
+  return os << hctr_enum_to_c_str(value);
+}
 inline std::ostream& operator<<(std::ostream& os, UpdateSourceType_t value) {
   return os << hctr_enum_to_c_str(value);
 }
@@ -148,6 +185,8 @@ UpdateSourceType_t get_hps_updatesource_type(const nlohmann::json& json, const s
                                              UpdateSourceType_t default_value);
 DatabaseOverflowPolicy_t get_hps_overflow_policy(const nlohmann::json& json, const std::string& key,
                                                  DatabaseOverflowPolicy_t default_value);
+DatabaseValueEncoding_t get_hps_value_encoding(const nlohmann::json& json, const std::string& key,
+                                               DatabaseValueEncoding_t default_value);
 EmbeddingCacheType_t get_hps_embeddingcache_type(const nlohmann::json& json, const std::string& key,
                                                  EmbeddingCacheType_t default_value);
 
@@ -160,13 +199,26 @@ struct VolatileDatabaseParams {
   std::string password;
   size_t num_partitions{16};
   size_t allocation_rate{256L * 1024 * 1024};  // Only used with HashMap type backends.
+  bool numa_aware{false};  // Only used with HashMap type backends.
+  size_t huge_page_size{0};  // Only used with HashMap type backends (0 = disabled).
+  std::string snapshot_path;  // Only used with HashMap type backends (empty = disabled).
+  size_t snapshot_interval_ms{0};  // Only used with HashMap type backends (0 = only on exit).
   size_t shared_memory_size{
       16L * 1024 * 1024 *
       1024};  // Size-limit of the shared memory (only for Multi-Process hashmap).
   std::string shared_memory_name{
       "hctr_mp_hash_map_database"};  // Name of the shared memory (only for Multi-Process hashmap).
   bool shared_memory_auto_remove{true};
+  bool short_read_locks{false};    // Only used with Multi-Process hashmap.
+  std::string spill_path{"/tmp"};  // Only used with Tiered hashmap (directory for spill logs).
+  size_t spill_queue_depth{128};   // Only used with Tiered hashmap.
+  size_t spill_promotion_threshold{2};  // Only used with Tiered hashmap.
+  double spill_compaction_ratio{0.5};   // Only used with Tiered hashmap.
   size_t num_node_connections{5};  // Only used with Redis backend.
+  size_t num_pipelined_batches{4};  // Only used with Redis backend.
+  size_t near_cache_size{0};        // Only used with Redis backend (0 = disabled).
+  DatabaseValueEncoding_t value_encoding{
+      DatabaseValueEncoding_t::Raw};  // Only used with Redis backend.
   size_t max_batch_size{64L * 1024};
 
   bool enable_tls{false};
@@ -179,11 +231,19 @@ struct VolatileDatabaseParams {
   size_t overflow_margin{std::numeric_limits<size_t>::max()};
   DatabaseOverflowPolicy_t overflow_policy{DatabaseOverflowPolicy_t::EvictRandom};
   double overflow_resolution_target{0.8};
+  std::map<std::string, size_t>
+      table_overflow_margins;  // Overrides per model ("<model>") or table ("<model>.<table>").
+  size_t shared_overflow_margin{0};  // If > 0, split among all other tables (by weight).
+  std::map<std::string, double> table_overflow_weights;  // Shares of `shared_overflow_margin`.
 
   // Caching behavior related.
   bool initialize_after_startup{true};
   double initial_cache_rate{1.0};
+  std::string key_frequency_path;  // Key-frequency histograms to guide the initial caching.
   bool cache_missed_embeddings{false};
+  double cache_missed_embeddings_rate{1.0};  // Fraction of missed embeddings that is admitted.
+  bool cache_missed_embeddings_doorkeeper{false};  // Only admit keys that missed repeatedly.
+  bool double_buffered_update{false};  // Load model updates into shadow tables, then switch over.
 
   // Real-time update mechanism related.
   std::vector<std::string> update_filters{{"^hps_.+$"}};  // Should be a regex for Kafka.
@@ -193,16 +253,26 @@ struct VolatileDatabaseParams {
       DatabaseType_t type,
       // Backend specific.
       const std::string& address, const std::string& user_name, const std::string& password,
-      size_t num_partitions, size_t allocation_rate, size_t shared_memory_size,
-      const std::string& shared_memory_name, bool shared_memory_auto_remove,
-      size_t num_node_connections, size_t max_batch_size, bool enable_tls,
+      size_t num_partitions, size_t allocation_rate, bool numa_aware, size_t huge_page_size,
+      const std::string& snapshot_path, size_t snapshot_interval_ms, size_t shared_memory_size,
+      const std::string& shared_memory_name, bool shared_memory_auto_remove, bool short_read_locks,
+      const std::string& spill_path,
+      size_t spill_queue_depth, size_t spill_promotion_threshold, double spill_compaction_ratio,
+      size_t num_node_connections,
+      size_t num_pipelined_batches, size_t near_cache_size,
+      DatabaseValueEncoding_t value_encoding, size_t max_batch_size, bool enable_tls,
       const std::string& tls_ca_certificate, const std::string& tls_client_certificate,
       const std::string& tls_client_key, const std::string& tls_server_name_identification,
       // Overflow handling related.
       size_t overflow_margin, DatabaseOverflowPolicy_t overflow_policy,
       double overflow_resolution_target,
+      const std::map<std::string, size_t>& table_overflow_margins, size_t shared_overflow_margin,
+      const std::map<std::string, double>& table_overflow_weights,
       // Caching behavior related.
-      bool initialize_after_startup, double initial_cache_rate, bool cache_missed_embeddings,
+      bool initialize_after_startup, double initial_cache_rate,
+      const std::string& key_frequency_path, bool cache_missed_embeddings,
+      double cache_missed_embeddings_rate, bool cache_missed_embeddings_doorkeeper,
+      bool double_buffered_update,
       // Real-time update mechanism related.
       const std::vector<std::string>& update_filters);
 
@@ -218,9 +288,11 @@ struct PersistentDatabaseParams {
   size_t num_threads{16};  // 16 = Default for RocksDB.
   bool read_only{false};
   size_t max_batch_size{64L * 1024};
+  size_t block_cache_size{16L * 1024 * 1024};
 
   // Caching behavior related.
   bool initialize_after_startup{true};
+  size_t bloom_filter_bits_per_key{0};  // Negative cache in front of the database (0 = disabled).
 
   // Real-time update mechanism related.
   std::vector<std::string> update_filters{{"^hps_.+$"}};  // Should be a regex for Kafka.
@@ -229,9 +301,9 @@ struct PersistentDatabaseParams {
   PersistentDatabaseParams(DatabaseType_t type,
                            // Backend specific.
                            const std::string& path, size_t num_threads, bool read_only,
-                           size_t max_batch_size,
+                           size_t max_batch_size, size_t block_cache_size,
                            // Caching behavior related.
-                           bool initialize_after_startup,
+                           bool initialize_after_startup, size_t bloom_filter_bits_per_key,
                            // Real-time update mechanism related.
                            const std::vector<std::string>& update_filters);
 
@@ -250,13 +322,21 @@ struct UpdateSourceParams {
   size_t max_batch_size{8 * 1024};
   size_t failure_backoff_ms{50};
   size_t max_commit_interval{32};
+  size_t coalescing_window_ms{0};  // Deduplicate updates over this window (0 = disabled).
+
+  // Embedding cache related.
+  bool refresh_embedding_cache{false};  // Push updates of resident keys to GPU embedding caches.
+  bool incremental_cache_refresh{false};  // Limit cache refreshes to keys updated since the last.
 
   UpdateSourceParams() {}
   UpdateSourceParams(UpdateSourceType_t type,
                      // Backend specific.
                      const std::string& brokers, size_t metadata_refresh_interval_ms,
                      size_t receive_buffer_size, size_t poll_timeout_ms, size_t max_batch_size,
-                     size_t failure_backoff_ms, size_t max_commit_interval);
+                     size_t failure_backoff_ms, size_t max_commit_interval,
+                     size_t coalescing_window_ms,
+                     // Embedding cache related.
+                     bool refresh_embedding_cache, bool incremental_cache_refresh);
 
   bool operator==(const UpdateSourceParams& p) const;
   bool operator!=(const UpdateSourceParams& p) const;
@@ -311,6 +391,49 @@ struct InferenceParams {
   bool init_ec;
   bool enable_pagelock;
   bool fp8_quant;
+  // Storage format of the values in the dynamic GPU embedding cache.
+  DatabaseValueEncoding_t embedding_cache_value_encoding;
+  // Resolve embedding cache misses in stream order, without blocking the calling thread.
+  bool stream_ordered_lookup;
+  // Replay the embedding cache lookup as a CUDA graph, as long as all keys hit the cache.
+  bool use_cuda_graph_lookup;
+  // Deduplicate the keys of each table lookup on the device before querying the embedding cache.
+  bool deduplicate_keys;
+  // Admit missing keys into the GPU embedding cache only after they missed this many times.
+  size_t embedding_cache_admission_threshold;
+  // Redistribute the GPU embedding cache capacity among the tables during each refresh cycle.
+  bool adaptive_cache_sizing;
+  // Query the dynamic GPU embedding cache without locking its slabsets.
+  bool lock_free_cache_query;
+  // Split the keys among the dynamic GPU embedding caches of all deployed devices.
+  bool sharded_embedding_cache;
+  // Fraction of the keys of each table that the hybrid embedding cache pins in a static table.
+  float hot_key_percentage;
+  // Fraction of the host-resident keys of each UVM table that may be promoted to device memory.
+  float uvm_promotion_percentage;
+  // Merge the concurrent requests of an inference session that arrive within this window.
+  size_t micro_batching_window_us;
+  // Batch sizes below max_batchsize for which the inference session builds a dense network each.
+  std::vector<size_t> cuda_graph_batch_sizes;
+  // Return the FP8 embeddings of the static embedding cache with their per-row scales.
+  bool fp8_output;
+  // File of the GEMM algorithm cache that the algorithm search reads and writes back.
+  std::string algorithm_cache_file;
+  // Number of worker buffers up to which the memory pool grows when it is empty (0 = no growth).
+  int max_number_of_worker_buffers_in_pool;
+  // ONNX model of the dense network, which an inference session runs as a TensorRT engine.
+  std::string tensorrt_onnx_file;
+  // File in which the TensorRT engine is cached.
+  std::string tensorrt_engine_file;
+  // Directory in which the CUDA IPC handles of GPU embedding caches shared among processes are.
+  std::string shared_embedding_cache_dir;
+  // Whether this process owns the shared GPU embedding caches, or opens them read-only.
+  bool shared_embedding_cache_owner;
+  // Delta sparse models of the changed rows of each table, which are applied in order after the
+  // sparse model files are loaded.
+  std::vector<std::vector<std::string>> delta_sparse_model_files;
+  // Maximum number of tables that are loaded into the databases at the same time during startup.
+  int init_thread_pool_size;
 
   InferenceParams(const std::string& model_name, size_t max_batchsize, float hit_rate_threshold,
                   const std::string& dense_model_file,
@@ -338,7 +461,23 @@ struct InferenceParams {
                   const EmbeddingCacheType_t embedding_cache_type = EmbeddingCacheType_t::Dynamic,
                   bool use_context_stream = true, bool fuse_embedding_table = false,
                   bool use_hctr_cache_implementation = true, bool init_ec = true,
-                  bool enable_pagelock = false, bool fp8_quant = false);
+                  bool enable_pagelock = false, bool fp8_quant = false,
+                  DatabaseValueEncoding_t embedding_cache_value_encoding =
+                      DatabaseValueEncoding_t::Raw,
+                  bool stream_ordered_lookup = false, bool use_cuda_graph_lookup = false,
+                  bool deduplicate_keys = true, size_t embedding_cache_admission_threshold = 0,
+                  bool adaptive_cache_sizing = false, bool lock_free_cache_query = false,
+                  bool sharded_embedding_cache = false, float hot_key_percentage = 0.1,
+                  float uvm_promotion_percentage = 0.0, size_t micro_batching_window_us = 0,
+                  const std::vector<size_t>& cuda_graph_batch_sizes = {},
+                  bool fp8_output = false, const std::string& algorithm_cache_file = "",
+                  int max_number_of_worker_buffers_in_pool = 0,
+                  const std::string& tensorrt_onnx_file = "",
+                  const std::string& tensorrt_engine_file = "",
+                  const std::string& shared_embedding_cache_dir = "",
+                  bool shared_embedding_cache_owner = true,
+                  const std::vector<std::vector<std::string>>& delta_sparse_model_files = {},
+                  int init_thread_pool_size = 8);
 };
 
 struct parameter_server_config {
@@ -393,6 +532,8 @@ struct parameter_server_config {
 struct inference_memory_pool_size_config {
   std::map<std::string, int> num_woker_buffer_size_per_model;
   std::map<std::string, int> num_refresh_buffer_size_per_model;
+  // Number of worker buffers up to which the pool of a model may grow; 0 disables the growth.
+  std::map<std::string, int> max_num_worker_buffer_size_per_model;
 };
 
 struct embedding_cache_config {
@@ -400,6 +541,7 @@ struct embedding_cache_config {
   float cache_size_percentage_;
   float cache_refresh_percentage_per_iteration = 0.1;
   size_t num_set_in_refresh_workspace_;
+  size_t max_num_keys_in_refresh_workspace_;
   std::vector<float> default_value_for_each_table;
   std::string model_name_;        // Which model this cache belongs to
   int cuda_dev_id_;               // Which CUDA device this cache belongs to
@@ -414,6 +556,15 @@ struct embedding_cache_config {
                                      // will query from a embedding table
   bool use_hctr_cache_implementation;  // if true - use the nv_gpu_cache implementation else use
                                        // embedding_cache lib
+  DatabaseValueEncoding_t value_encoding_;  // Storage format of the values in the nv_gpu_cache
+  bool stream_ordered_lookup_;    // Resolve misses in stream order instead of synchronizing
+  bool use_cuda_graph_lookup_;    // Replay the all-hit lookup of each table as a CUDA graph
+  bool deduplicate_keys_;         // Query the embedding cache only with the unique keys
+  uint32_t admission_threshold_;  // # of misses before a key is admitted, <= 1 admits every key
+  bool adaptive_cache_sizing_;    // Rebalance num_set_in_cache_ by the observed misses
+  bool lock_free_query_;          // Query the nv_gpu_cache without acquiring the set mutexes
+  std::string shared_cache_dir_;  // Share the nv_gpu_caches among processes via CUDA IPC, if set
+  bool shared_cache_owner_;       // Create and write the shared caches, or open them read-only
 };
 
 struct EmbeddingCacheWorkspace {
@@ -451,6 +602,8 @@ struct EmbeddingCacheWorkspace {
   double* h_hit_rate_;        // The hit rate for each emb_table on host, size = # of emb_table
   bool use_gpu_embedding_cache_;     // whether to use gpu embedding cache
   std::vector<void*> private_data_;  // per embedding cache implementation private data (C-Style)
+  std::vector<void*> lookup_graph_;  // The captured all-hit lookup for each emb_table (C-Style),
+                                     // size = # of emb_table
 };
 
 struct EmbeddingCacheRefreshspace {
@@ -466,6 +619,13 @@ void merge_emb_vec_async(float* d_vals_merge_dst_ptr, const float* d_vals_retrie
                          const uint64_t* d_missing_index_ptr, const size_t missing_len,
                          const size_t emb_vec_size, const size_t block_size, cudaStream_t stream);
 
+// Same as above, but merges only the first *d_missing_len_ptr (<= max_missing_len) vectors, where
+// d_missing_len_ptr resides in device memory.
+void merge_emb_vec_async(float* d_vals_merge_dst_ptr, const float* d_vals_retrieved_ptr,
+                         const uint64_t* d_missing_index_ptr, const size_t* d_missing_len_ptr,
+                         const size_t max_missing_len, const size_t emb_vec_size,
+                         const size_t block_size, cudaStream_t stream);
+
 void fill_default_emb_vec_async(float* d_vals_merge_dst_ptr, const float default_emb_vec,
                                 const uint64_t* d_missing_index_ptr, const size_t missing_len,
                                 const size_t emb_vec_size, const size_t block_size,
@@ -476,4 +636,40 @@ void decompress_emb_vec_async(const float* d_unique_src_ptr, const uint64_t* d_u
                               const size_t emb_vec_size, const size_t block_size,
                               cudaStream_t stream);
 
+// The rows of a pooled lookup. The vectors of the keys [d_row_offsets[r], d_row_offsets[r + 1])
+// are combined into output row r, and empty rows are zero. d_row_offsets holds num_rows + 1
+// elements in device memory.
+struct PoolingRows {
+  const int64_t* d_row_offsets;
+  size_t num_rows;
+  PoolingCombiner_t combiner;
+};
+
+// Same as decompress_emb_vec_async, but writes the sum or mean of the vectors of each row of
+// d_row_offsets instead of one vector per key. If d_unique_index_ptr is nullptr, the vector of key
+// k is row k of d_unique_src_ptr.
+void pool_emb_vec_async(const float* d_unique_src_ptr, const uint64_t* d_unique_index_ptr,
+                        const int64_t* d_row_offsets, const size_t num_rows,
+                        const size_t emb_vec_size, const bool mean, float* d_pooled_dst_ptr,
+                        const size_t block_size, cudaStream_t stream);
+
+// Groups the keys by the shard (device) that caches them. The keys of shard s and their index in
+// d_keys end up in [d_shard_offset[s], d_shard_offset[s + 1]) of d_shard_keys and d_shard_index.
+// d_shard_offset holds num_shards + 1 elements, d_shard_cursor num_shards.
+template <typename TypeHashKey>
+void partition_keys_by_shard_async(const TypeHashKey* d_keys, const size_t num_keys,
+                                   const size_t num_shards, TypeHashKey* d_shard_keys,
+                                   uint64_t* d_shard_index, size_t* d_shard_offset,
+                                   size_t* d_shard_cursor, const size_t block_size,
+                                   cudaStream_t stream);
+
+// Compacts the <k,v> pairs that belong to shard_id, in no particular order.
+template <typename TypeHashKey>
+void select_shard_emb_vec_async(const TypeHashKey* d_keys, const float* d_emb_vec,
+                                const size_t len, const size_t emb_vec_size,
+                                const size_t num_shards, const size_t shard_id,
+                                TypeHashKey* d_shard_keys, float* d_shard_emb_vec,
+                                size_t* d_shard_len, const size_t block_size,
+                                cudaStream_t stream);
+
 }  // namespace HugeCTR
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include <rdkafka.h>
 
 #include <condition_variable>
+#include <hps/inference_utils.hpp>
 #include <hps/message.hpp>
 #include <thread>
 
@@ -34,6 +35,11 @@ struct KafkaMessageSinkParams : public MessageSinkParams {
   size_t num_send_buffers = 1024;  // Maximum number of send buffers.
   bool await_connection =
       false;  // Awaits a handshake with the broker by attempting to queue an empty message.
+  bool columnar_format = false;  // Send messages in the versioned columnar format (sorted and
+                                 // delta-encoded keys, followed by the values).
+  DatabaseValueEncoding_t value_encoding =
+      DatabaseValueEncoding_t::Raw;  // Compresses values (only applies to the columnar format).
+  std::string compression_codec = "none";  // Kafka compression codec (e.g., "lz4" or "zstd").
 };
 
 /**
@@ -92,6 +98,12 @@ class KafkaMessageSink final : public MessageSink<Key, KafkaMessageSinkParams> {
   void blocking_produce(rd_kafka_topic_t* topic, char* send_buffer, size_t payload_length,
                         size_t key_group);
 
+  /**
+   * Internally called by \p post to emit key/value pairs in the columnar format.
+   */
+  void post_columnar(rd_kafka_topic_t* topic, size_t num_pairs, const Key* keys,
+                     const char* values, uint32_t value_size);
+
  protected:
   rd_kafka_t* rk_;
 
@@ -160,6 +172,9 @@ class KafkaMessageSource final : public MessageSource<Key> {
    * @param failure_backoff_ms In case something bad happened, wait this number of milliseconds.
    * @param max_commit_interval Regardless of the amount of values that are available, after this
    * many messages have been decoded, invoke the callback and commit.
+   * @param coalescing_window_ms If > 0, updates for the same topic are held back for this many
+   * milliseconds (unless \p max_batch_size is reached). Within that window, repeated updates of a
+   * key are deduplicated (last writer wins), and \p max_commit_interval is ignored.
    */
   KafkaMessageSource(const std::string& brokers = "127.0.0.1:9092",
                      const std::string& consumer_group_id = "",
@@ -167,7 +182,7 @@ class KafkaMessageSource final : public MessageSource<Key> {
                      size_t metadata_refresh_interval_ms = 30'000,
                      size_t receive_buffer_size = 256 * 1024, size_t poll_timeout_ms = 500,
                      size_t max_batch_size = 8 * 1024, size_t failure_backoff_ms = 50,
-                     size_t max_commit_interval = 32);
+                     size_t max_commit_interval = 32, size_t coalescing_window_ms = 0);
 
   virtual ~KafkaMessageSource();
 
@@ -187,6 +202,7 @@ class KafkaMessageSource final : public MessageSource<Key> {
   const size_t max_batch_size_;
   const std::chrono::milliseconds failure_backoff_ms_;
   const size_t max_commit_interval_;
+  const std::chrono::milliseconds coalescing_window_ms_;
 
  private:
   bool terminate_ = false;
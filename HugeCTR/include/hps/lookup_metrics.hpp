@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+
+namespace HugeCTR {
+
+/**
+ * Stages of an embedding lookup, whose latencies are recorded by \p LookupMetrics .
+ */
+enum class LookupStage_t {
+  WorkspaceWait,   // Wait for a workspace of the memory pool
+  CacheQuery,      // Query of the embedding cache
+  MissCompaction,  // Merge of the missing embedding vectors into the output
+  VDBFetch,        // Fetch from the volatile database
+  PDBFetch,        // Fetch from the persistent database
+  H2DCopy,         // Copy of the fetched embedding vectors to the device
+  Insert           // Insertion of the fetched embedding vectors into the embedding cache
+};
+constexpr size_t num_lookup_stages{7};
+
+const char* lookup_stage_name(LookupStage_t stage);
+
+/**
+ * Histogram of latencies with exponential buckets, from 1 us to 2^(num_buckets - 2) us, plus one
+ * bucket for everything above. Observations only increment relaxed atomic counters. These are
+ * split into shards, so that each thread mostly writes to its own cache lines.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t num_buckets{24};
+
+  struct Snapshot {
+    std::array<uint64_t, num_buckets> counts{};  // Non-cumulative count of each bucket
+    uint64_t count{0};
+    uint64_t sum_us{0};
+  };
+
+  // Upper bound of a bucket in microseconds. The last bucket has no bound.
+  static constexpr uint64_t bucket_bound_us(const size_t bucket) { return uint64_t{1} << bucket; }
+
+  void observe(uint64_t latency_us);
+  void observe_since(const std::chrono::steady_clock::time_point start) {
+    const auto elapsed{std::chrono::steady_clock::now() - start};
+    observe(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+  }
+
+  Snapshot snapshot() const;
+
+ private:
+  static constexpr size_t num_shards_{16};
+
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, num_buckets> counts{};
+    std::atomic<uint64_t> sum_us{0};
+  };
+  std::array<Shard, num_shards_> shards_;
+};
+
+/**
+ * Measures the time from its construction to its destruction into a histogram.
+ */
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram& histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedLatency() { histogram_.observe_since(start_); }
+  ScopedLatency(ScopedLatency const&) = delete;
+  ScopedLatency& operator=(ScopedLatency const&) = delete;
+
+ private:
+  LatencyHistogram& histogram_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * Process-wide registry of the lookup stage latencies, per model and embedding table. Unlike the
+ * benchmark \p profiler , it is always enabled. Histograms are never removed, so components that
+ * record latencies at a high rate can keep references to them, and avoid the registry lock.
+ */
+class LookupMetrics {
+ public:
+  using Visitor = std::function<void(const std::string& model_name, size_t table_id,
+                                     LookupStage_t stage, const LatencyHistogram::Snapshot&)>;
+
+  static LookupMetrics& instance();
+
+  // Returns the histogram of a stage, and creates it upon first use.
+  LatencyHistogram& histogram(const std::string& model_name, size_t table_id, LookupStage_t stage);
+
+  // Calls the visitor with the current state of each histogram, ordered by model, table and stage.
+  void visit(const Visitor& visitor) const;
+
+  // Renders all histograms in the Prometheus/OpenMetrics text exposition format.
+  std::string to_openmetrics() const;
+
+ private:
+  LookupMetrics() = default;
+
+  mutable std::shared_mutex mutex_;
+  std::map<std::tuple<std::string, size_t, LookupStage_t>, std::unique_ptr<LatencyHistogram>>
+      histograms_;
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <hps/lookup_session_base.hpp>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Coalesces the lookups that concurrent threads make from host keys into host vectors into
+ * batched lookups of a \p LookupSessionBase . Each table has a worker thread, which waits until
+ * it has max_batchsize * maxnum_catfeature_query_per_table_per_sample keys, or until the oldest
+ * pending lookup waited for max_delay, and then looks them all up at once.
+ */
+class BatchedLookupSession {
+ public:
+  BatchedLookupSession(const std::shared_ptr<LookupSessionBase>& lookup_session,
+                       std::chrono::microseconds max_delay);
+  ~BatchedLookupSession();
+  BatchedLookupSession(const BatchedLookupSession&) = delete;
+  BatchedLookupSession& operator=(const BatchedLookupSession&) = delete;
+
+  /**
+   * Looks up num_keys keys of table table_id, and blocks until their vectors are in h_vectors.
+   * Lookups of more keys than fit into one batch are split.
+   */
+  void lookup(const void* h_keys, float* h_vectors, size_t num_keys, size_t table_id);
+
+  size_t key_size() const { return key_size_; }
+  size_t num_tables() const { return tables_.size(); }
+  size_t vector_size(const size_t table_id) const { return tables_[table_id]->vector_size; }
+
+ private:
+  struct Request {
+    const void* h_keys;
+    float* h_vectors;
+    size_t num_keys;
+    std::chrono::steady_clock::time_point arrival;
+    std::promise<void> done;
+  };
+
+  struct Table {
+    size_t vector_size;
+    size_t max_num_keys;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Request*> pending;
+    size_t num_pending_keys{0};
+
+    // Pinned staging buffers of a batch, and the device output of the lookup session.
+    char* h_keys{nullptr};
+    float* h_vectors{nullptr};
+    float* d_vectors{nullptr};
+
+    std::thread worker;
+  };
+
+  void run(size_t table_id);
+
+  std::shared_ptr<LookupSessionBase> lookup_session_;
+  int device_id_;
+  size_t key_size_;
+  std::chrono::microseconds max_delay_;
+  std::vector<std::unique_ptr<Table>> tables_;
+  std::atomic<bool> stop_{false};
+};
+
+/**
+ * TCP server for the lookups of \p RemoteLookupClient , in the protocol of remote_lookup.hpp.
+ * Each connection has a thread, and the connections are assigned to the sessions (one per
+ * deployed device) round-robin. The connections of one session are batched together.
+ */
+class LookupServer {
+ public:
+  LookupServer(const std::vector<std::shared_ptr<BatchedLookupSession>>& sessions,
+               uint16_t port);
+  ~LookupServer();
+  LookupServer(const LookupServer&) = delete;
+  LookupServer& operator=(const LookupServer&) = delete;
+
+  uint16_t port() const { return port_; }
+
+  // Accepts connections until shutdown() is called.
+  void serve();
+
+  // Makes serve() return, and closes all connections. Can be called from any thread.
+  void shutdown();
+
+  // Number of connection threads that have not been joined yet.
+  size_t num_connection_threads();
+
+ private:
+  void serve_connection(int socket, BatchedLookupSession& session);
+
+  // Joins the threads of the connections that have been closed. Requires holding mutex_.
+  void join_closed_connections();
+
+  std::vector<std::shared_ptr<BatchedLookupSession>> sessions_;
+  int listen_socket_{-1};
+  uint16_t port_;
+  std::atomic<bool> stop_{false};
+
+  std::mutex mutex_;
+  std::vector<int> sockets_;
+  std::vector<std::thread> connections_;
+  std::vector<std::thread::id> closed_connections_;
+};
+
+}  // namespace HugeCTR
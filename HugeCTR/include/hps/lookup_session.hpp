@@ -52,6 +52,12 @@ class LookupSession : public LookupSessionBase {
   virtual void lookup_from_device(const std::vector<const void*>& d_keys_per_table,
                                   const std::vector<float*>& d_vectors_per_table,
                                   const std::vector<size_t>& num_keys_per_table) override final;
+  virtual void lookup_from_device_pooled(const void* d_keys, size_t num_keys,
+                                         const PoolingRows& rows, float* d_pooled_vectors,
+                                         size_t table_id) override final;
+  virtual void lookup_from_device_pooled(const void* d_keys, size_t num_keys,
+                                         const PoolingRows& rows, float* d_pooled_vectors,
+                                         size_t table_id, cudaStream_t stream) override final;
 
   virtual const InferenceParams get_inference_params() const override { return inference_params_; }
   virtual void set_profiler(int iteration, int warmup, bool enable_bench) {
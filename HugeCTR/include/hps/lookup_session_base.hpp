@@ -50,6 +50,15 @@ class LookupSessionBase {
   virtual void lookup_from_device(const std::vector<const void*>& d_keys_per_table,
                                   const std::vector<float*>& d_vectors_per_table,
                                   const std::vector<size_t>& num_keys_per_table) = 0;
+  // Looks up the keys of the rows of one table, and writes the sum or mean of the vectors of each
+  // row to d_pooled_vectors, [rows.num_rows, emb_vec_size], instead of one vector per key. num_keys
+  // is rows.d_row_offsets[rows.num_rows].
+  virtual void lookup_from_device_pooled(const void* d_keys, size_t num_keys,
+                                         const PoolingRows& rows, float* d_pooled_vectors,
+                                         size_t table_id) = 0;
+  virtual void lookup_from_device_pooled(const void* d_keys, size_t num_keys,
+                                         const PoolingRows& rows, float* d_pooled_vectors,
+                                         size_t table_id, cudaStream_t stream) = 0;
   virtual const InferenceParams get_inference_params() const = 0;
 
   static std::shared_ptr<LookupSessionBase> create(
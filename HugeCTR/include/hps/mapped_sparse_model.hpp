@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace HugeCTR {
+
+/**
+ * Head of a sparse model file that is memory mapped and used without parsing. It is followed by
+ * page aligned sections: the keys as long long in ascending order, the embedding vectors in the
+ * same order, and an optional open addressing hash index. Each slot of the index holds the row of
+ * a key plus one, or 0 if it is empty. All offsets are in bytes from the start of the file.
+ */
+struct MappedSparseModelHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t key_size;
+  uint64_t num_keys;
+  uint64_t embedding_vec_size;
+  uint64_t keys_offset;
+  uint64_t vectors_offset;
+  uint64_t index_offset;
+  uint64_t index_num_slots;  // 0 without an index, otherwise a power of 2
+};
+
+// Name of the mapped sparse model within the folder of a sparse model.
+inline constexpr const char* mapped_sparse_model_file_name{"mapped_model"};
+
+/**
+ * Writes the keys and vectors to a mapped sparse model on the local file system. A key that
+ * appears more than once keeps its last vector.
+ *
+ * @param path File system path of the mapped sparse model.
+ * @param keys num_keys keys.
+ * @param vectors num_keys vectors of embedding_vec_size floats.
+ * @param hash_index Whether to add a hash index, which find() uses instead of a binary search.
+ */
+void write_mapped_sparse_model(const std::string& path, const long long* keys,
+                               const float* vectors, size_t num_keys, size_t embedding_vec_size,
+                               bool hash_index);
+
+/**
+ * Writes the mapped sparse model of the key and emb_vector files of a sparse model folder. It is
+ * put into the same folder, where the model loader of the HPS prefers it.
+ */
+void convert_to_mapped_sparse_model(const std::string& sparse_model, bool hash_index = true);
+
+/**
+ * Read-only memory mapping of a mapped sparse model. The pages are shared with other processes
+ * that map the same file, and are only read from disk when they are accessed.
+ */
+class MappedSparseModel {
+ public:
+  explicit MappedSparseModel(const std::string& path);
+  ~MappedSparseModel();
+
+  MappedSparseModel(const MappedSparseModel&) = delete;
+  MappedSparseModel& operator=(const MappedSparseModel&) = delete;
+
+  size_t num_keys() const { return header_->num_keys; }
+  size_t embedding_vec_size() const { return header_->embedding_vec_size; }
+  const long long* keys() const;
+  const float* vectors() const;
+
+  // Returns the vector of key, or nullptr if the model doesn't hold it.
+  const float* find(long long key) const;
+
+ private:
+  std::string path_;
+  void* data_;
+  size_t size_;
+  const MappedSparseModelHeader* header_;
+};
+
+}  // namespace HugeCTR
@@ -17,6 +17,8 @@
 
 #include <cuda_runtime_api.h>
 
+#include <algorithm>
+#include <atomic>
 #include <core23/logger.hpp>
 #include <hps/embedding_cache.hpp>
 #include <iostream>
@@ -34,99 +36,96 @@ class MemoryPool;
 
 class MemoryBlock {
  public:
-  MemoryBlock* pNext;  // next mem block
+  std::atomic<MemoryBlock*> pNext;  // next free mem block
   EmbeddingCacheWorkspace worker_buffer;
   EmbeddingCacheRefreshspace refresh_buffer;
   bool bUsed;        // occupied
   bool bBelong;      // belong to current pool
   MemoryPool* pMem;  // belong to which pool
+  size_t nIndex;     // position in the _Alloc of its pool
   MemoryBlock() {
     this->bBelong = false;
     this->bUsed = false;
     this->pMem = nullptr;
     this->pNext = nullptr;
+    this->nIndex = 0;
   };
 };
+
+/**
+ * Pool of the workspaces of an embedding cache. The free blocks form a lock-free (Treiber) stack,
+ * whose head packs the position of the top block with a version tag, so that a block that is
+ * popped and pushed again between the load and the CAS of another thread (ABA) cannot corrupt it.
+ * If the stack is empty, the pool creates more blocks, up to nMaxBlock. Only then AllocMemory()
+ * returns nullptr, and the callers have to retry.
+ */
 class MemoryPool {
  public:
   MemoryPool(size_t nBlock, std::shared_ptr<EmbeddingCacheBase> embedding_cache,
-             CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER) {
-    _nBlock = nBlock;
-    _pHeader = nullptr;
-    _pBuffer = nullptr;
+             CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER, size_t nMaxBlock = 0) {
+    HCTR_THROW_IF(nBlock > MAX_MEMORY_SIZE, Error_t::WrongInput,
+                  "The memory pool size must be at most ", MAX_MEMORY_SIZE, ", but is ", nBlock);
+    _nBlock = 0;
+    _nInitBlock = std::max<size_t>(nBlock, 1);
+    _nMaxBlock = std::min<size_t>(std::max(_nInitBlock, nMaxBlock), MAX_MEMORY_SIZE);
+    _head = 0;
     _embedding_cache = embedding_cache;
     _device_id = embedding_cache->get_cache_config().cuda_dev_id_;
     _cache_type = cache_type;
     InitMemory(cache_type);
   }
   static MemoryPool* create(size_t nBlock, std::shared_ptr<EmbeddingCacheBase> embedding_cache,
-                            CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER) {
-    return (new MemoryPool(nBlock, embedding_cache, cache_type));
+                            CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER,
+                            size_t nMaxBlock = 0) {
+    return (new MemoryPool(nBlock, embedding_cache, cache_type, nMaxBlock));
   }
   virtual ~MemoryPool() {
-    for (size_t i = 0; i < _nBlock; i++) {
-      if (_Alloc[i] != nullptr) {
-        delete _Alloc[i];
-      }
+    const size_t nBlock = _nBlock.load(std::memory_order_acquire);
+    for (size_t i = 0; i < nBlock; i++) {
+      delete _Alloc[i];
     }
   }
   void* AllocMemory() {
-    std::lock_guard<std::mutex> lock(_mutex);
-    MemoryBlock* pRes = nullptr;
-    if (_pHeader == nullptr) {
-      HCTR_LOG(WARNING, WORLD, "memory pool is empty\n");
-    } else {
-      pRes = _pHeader;
-      _pHeader = _pHeader->pNext;
-      pRes->bUsed = true;
+    MemoryBlock* pRes = _Pop();
+    if (pRes == nullptr && _nBlock.load(std::memory_order_acquire) < _nMaxBlock) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      // Another thread may have grown the pool, or returned a block, while we waited.
+      pRes = _Pop();
+      const size_t nBlock = _nBlock.load(std::memory_order_relaxed);
+      if (pRes == nullptr && nBlock < _nMaxBlock) {
+        pRes = _CreateBlock(nBlock);
+        _nBlock.store(nBlock + 1, std::memory_order_release);
+        HCTR_LOG_S(INFO, WORLD) << "Grew the memory pool of device " << _device_id << " to "
+                                << nBlock + 1 << " of at most " << _nMaxBlock << " buffers"
+                                << std::endl;
+      }
     }
+    if (pRes == nullptr) {
+      if (!_bExhausted.exchange(true, std::memory_order_relaxed)) {
+        HCTR_LOG_S(WARNING, WORLD) << "The memory pool of device " << _device_id << " is empty ("
+                                   << _nMaxBlock << " buffers), lookups have to wait"
+                                   << std::endl;
+      }
+      return nullptr;
+    }
+    pRes->bUsed = true;
     return (void*)(pRes);
   }
 
   void InitMemory(CACHE_SPACE_TYPE space_type = CACHE_SPACE_TYPE::WORKER) {
-    CudaDeviceContext dev_restorer{_device_id};
-    if (_pBuffer) return;
-    _Alloc[0] = (MemoryBlock*)(new MemoryBlock());
-    _pBuffer = _Alloc[0];
-    _pHeader = _pBuffer;
-    _pHeader->bUsed = false;
-    _pHeader->bBelong = true;
-    if (space_type == CACHE_SPACE_TYPE::WORKER) {
-      EmbeddingCacheWorkspace worker_buffer = _embedding_cache->create_workspace();
-      _pHeader->worker_buffer = (worker_buffer);
-    }
-    if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
-      EmbeddingCacheRefreshspace refresh_buffer = _embedding_cache->create_refreshspace();
-      _pHeader->refresh_buffer = (refresh_buffer);
-    }
-    _pHeader->pMem = this;
-    MemoryBlock* tmp1 = _pHeader;
-    for (size_t i = 1; i < _nBlock; i++) {
-      _Alloc[i] = (MemoryBlock*)(new MemoryBlock());
-      _Alloc[i]->bUsed = false;
-      _Alloc[i]->pNext = NULL;
-      if (space_type == CACHE_SPACE_TYPE::WORKER) {
-        EmbeddingCacheWorkspace worker_buffer = _embedding_cache->create_workspace();
-        _Alloc[i]->worker_buffer = (worker_buffer);
-      }
-      if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
-        EmbeddingCacheRefreshspace refresh_buffer = _embedding_cache->create_refreshspace();
-        _Alloc[i]->refresh_buffer = (refresh_buffer);
-      }
-      _Alloc[i]->bBelong = true;
-      _Alloc[i]->pMem = this;
-      tmp1->pNext = _Alloc[i];
-      tmp1 = _Alloc[i];
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_nBlock.load(std::memory_order_relaxed) > 0) return;
+    for (size_t i = 0; i < _nInitBlock; i++) {
+      _Push(_CreateBlock(i));
+      _nBlock.store(i + 1, std::memory_order_release);
     }
   }
 
   void FreeMemory(void* p) {
-    std::lock_guard<std::mutex> lock(_mutex);
     MemoryBlock* pBlock = (MemoryBlock*)p;
     if (pBlock->bBelong) {
       pBlock->bUsed = false;
-      pBlock->pNext = _pHeader;
-      _pHeader = pBlock;
+      _Push(pBlock);
     }
     return;
   }
@@ -134,25 +133,74 @@ class MemoryPool {
   void DestoryMemoryPool(CACHE_SPACE_TYPE space_type = CACHE_SPACE_TYPE::WORKER) {
     std::lock_guard<std::mutex> lock(_mutex);
     CudaDeviceContext dev_restorer{_device_id};
-    for (size_t i = 0; i < _nBlock; i++) {
-      if (_Alloc[i] != NULL) {
-        if (space_type == CACHE_SPACE_TYPE::WORKER) {
-          _embedding_cache->destroy_workspace(((MemoryBlock*)(_Alloc[i]))->worker_buffer);
-        }
-        if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
-          _embedding_cache->destroy_refreshspace(((MemoryBlock*)(_Alloc[i]))->refresh_buffer);
-        }
+    const size_t nBlock = _nBlock.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < nBlock; i++) {
+      if (space_type == CACHE_SPACE_TYPE::WORKER) {
+        _embedding_cache->destroy_workspace(_Alloc[i]->worker_buffer);
+      }
+      if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
+        _embedding_cache->destroy_refreshspace(_Alloc[i]->refresh_buffer);
       }
     }
   }
 
+ private:
+  // The head of the free stack holds the index + 1 of the top block (0 if the stack is empty) in
+  // its lower half, and the version tag, which every successful CAS increments, in its upper half.
+  static uint64_t _HeadIndex(uint64_t head) { return head & 0xffffffffu; }
+  static uint64_t _NextHead(uint64_t head, const MemoryBlock* pTop) {
+    const uint64_t index = pTop == nullptr ? 0 : pTop->nIndex + 1;
+    return ((head >> 32) + 1) << 32 | index;
+  }
+
+  MemoryBlock* _Pop() {
+    uint64_t head = _head.load(std::memory_order_acquire);
+    while (_HeadIndex(head) != 0) {
+      MemoryBlock* pTop = _Alloc[_HeadIndex(head) - 1];
+      MemoryBlock* pNext = pTop->pNext.load(std::memory_order_relaxed);
+      if (_head.compare_exchange_weak(head, _NextHead(head, pNext), std::memory_order_acquire,
+                                      std::memory_order_acquire)) {
+        return pTop;
+      }
+    }
+    return nullptr;
+  }
+
+  void _Push(MemoryBlock* pBlock) {
+    uint64_t head = _head.load(std::memory_order_relaxed);
+    do {
+      pBlock->pNext.store(_HeadIndex(head) == 0 ? nullptr : _Alloc[_HeadIndex(head) - 1],
+                          std::memory_order_relaxed);
+    } while (!_head.compare_exchange_weak(head, _NextHead(head, pBlock), std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  // Creates the block at position i of _Alloc, which the caller must publish through _nBlock.
+  MemoryBlock* _CreateBlock(size_t i) {
+    CudaDeviceContext dev_restorer{_device_id};
+    MemoryBlock* pBlock = new MemoryBlock();
+    if (_cache_type == CACHE_SPACE_TYPE::WORKER) {
+      pBlock->worker_buffer = _embedding_cache->create_workspace();
+    }
+    if (_cache_type == CACHE_SPACE_TYPE::REFRESHER) {
+      pBlock->refresh_buffer = _embedding_cache->create_refreshspace();
+    }
+    pBlock->bBelong = true;
+    pBlock->pMem = this;
+    pBlock->nIndex = i;
+    _Alloc[i] = pBlock;
+    return pBlock;
+  }
+
  public:
-  MemoryBlock* _pBuffer;
-  MemoryBlock* _pHeader;
   std::shared_ptr<EmbeddingCacheBase> _embedding_cache;
   int _device_id;
-  size_t _nBlock;
-  std::mutex _mutex;
+  std::atomic<size_t> _nBlock;  // number of created blocks
+  size_t _nInitBlock;
+  size_t _nMaxBlock;
+  std::atomic<uint64_t> _head;
+  std::atomic<bool> _bExhausted{false};
+  std::mutex _mutex;  // serializes the creation and destruction of blocks
   MemoryBlock* _Alloc[MAX_MEMORY_SIZE];
   CACHE_SPACE_TYPE _cache_type;
 };
@@ -245,10 +293,11 @@ class ManagerPool {
   void _create_memory_pool_per_model(
       std::string model_name, int pool_size,
       std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>> embedding_cache_map,
-      CACHE_SPACE_TYPE space_type) {
+      CACHE_SPACE_TYPE space_type, int max_pool_size = 0) {
     std::map<int64_t, std::shared_ptr<MemoryPool>> device_mempool;
     for (auto& f : embedding_cache_map) {
-      MemoryPool* tempmemorypool = MemoryPool::create(pool_size, f.second, space_type);
+      MemoryPool* tempmemorypool =
+          MemoryPool::create(pool_size, f.second, space_type, std::max(max_pool_size, 0));
       device_mempool[f.first] = std::shared_ptr<MemoryPool>(tempmemorypool);
     }
     if (space_type == CACHE_SPACE_TYPE::WORKER) {
@@ -265,9 +314,13 @@ class ManagerPool {
     std::map<std::string, std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>>>::iterator iter;
     for (iter = _model_cache_map.begin(); iter != _model_cache_map.end(); ++iter) {
       std::map<int64_t, std::shared_ptr<MemoryPool>> device_mempool;
+      const int max_pool_size =
+          space_type == CACHE_SPACE_TYPE::WORKER
+              ? _memory_pool_config.max_num_worker_buffer_size_per_model[iter->first]
+              : 0;
       for (auto& f : iter->second) {
-        MemoryPool* tempmemorypool =
-            MemoryPool::create(num_cache_per_model[iter->first], f.second, space_type);
+        MemoryPool* tempmemorypool = MemoryPool::create(
+            num_cache_per_model[iter->first], f.second, space_type, std::max(max_pool_size, 0));
         device_mempool[f.first] = std::shared_ptr<MemoryPool>(tempmemorypool);
       }
       (*model_cache_pool_map)[iter->first] = device_mempool;
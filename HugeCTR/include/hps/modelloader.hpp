@@ -20,10 +20,13 @@
 
 #include <cstdint>
 #include <hps/database_backend.hpp>
+#include <hps/mapped_sparse_model.hpp>
 #include <hps/quantize.hpp>
+#include <io/compressed_file.hpp>
 #include <io/filesystem.hpp>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <string>
@@ -146,6 +149,21 @@ class IModelLoader {
   virtual std::pair<void*, size_t> getvectors(size_t iteration, size_t emb_size,
                                               bool fp8_quant = false) = 0;
 
+  /**
+   * Writes all embeddings of the loaded table into SST files that can be ingested into a RocksDB
+   * database. Each iteration is split into \p num_threads files that are written in parallel. The
+   * entries of each file are sorted by the binary representation of their keys (i.e., RocksDB's
+   * default bytewise ordering).
+   *
+   * @param path Directory in which the SST files should be created.
+   * @param emb_size Embedding vector size.
+   * @param num_threads Number of SST files that are written in parallel.
+   *
+   * @return File system paths of the SST files.
+   */
+  virtual std::vector<std::string> dump_sst(const std::string& path, size_t emb_size,
+                                            size_t num_threads) = 0;
+
   virtual void* get_cache_keys() = 0;
   virtual void* get_caceh_vecs() = 0;
   virtual size_t get_cache_key_count() = 0;
@@ -158,7 +176,11 @@ class IModelLoader {
 
 /**
  * Implementations of read/parse embedding from legacy format model file, which is general format
- * for hugectr model file.
+ * for hugectr model file. A mapped_model file in a local sparse model without a meta file is
+ * memory mapped and read instead of the key and emb_vector files, so that full iterations are
+ * handed out without copies and the pages are shared by all processes that load the model. A
+ * sparse model without an emb_vector file may have a compressed one, e.g. emb_vector.bitcomp,
+ * whose pages are decompressed on the gpu as they are read, see HugeCTR::CompressedFileReader.
  *
  * @tparam TKey The data-type that is used for keys in this database.
  * @tparam TKey The data-type that is used for keys in this database.
@@ -174,7 +196,13 @@ class RawModelLoader : public IModelLoader {
   size_t key_num_iteration = 0;
   std::shared_ptr<HugeCTR::Quantize<float, __nv_fp8_e4m3>> quantizer_;
   cudaStream_t stream;
+  // Used instead of the key and emb_vector files if the sparse model has a mapped model.
+  std::unique_ptr<MappedSparseModel> mapped_model_;
+  // Used instead of the emb_vector file if the sparse model only has a compressed one.
+  std::unique_ptr<CompressedFileReader> compressed_vectors_;
   virtual void load_emb(const std::string& table_name, const std::string& path);
+  void read_keys(TKey* keys, size_t offset, size_t num_keys);
+  void read_vectors(TValue* vectors, size_t offset, size_t num_elements);
 
  public:
   RawModelLoader();
@@ -193,6 +221,8 @@ class RawModelLoader : public IModelLoader {
   virtual std::pair<void*, size_t> getkeys(size_t iteration);
   virtual std::pair<void*, size_t> getvectors(size_t iteration, size_t emb_size,
                                               bool fp8_quant = false);
+  virtual std::vector<std::string> dump_sst(const std::string& path, size_t emb_size,
+                                            size_t num_threads);
   virtual void* get_cache_keys();
   virtual void* get_caceh_vecs();
   virtual size_t get_cache_key_count();
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <boost/interprocess/containers/flat_map.hpp>
 #include <boost/interprocess/containers/string.hpp>
 #include <boost/interprocess/containers/vector.hpp>
@@ -24,6 +25,7 @@
 #include <boost/unordered_map.hpp>
 #include <core/macro.hpp>
 #include <hps/database_backend.hpp>
+#include <thread>
 
 namespace HugeCTR {
 
@@ -41,6 +43,8 @@ struct MultiProcessHashMapBackendParams final : public VolatileBackendParams {
   std::chrono::nanoseconds heart_beat_frequency{std::chrono::milliseconds{
       100}};               // Frequency at which we tick up the heart-beat frequency counter.
   bool auto_remove{true};  // Remove SHM if this is the last process to detach from the SHM.
+  size_t huge_page_size{0};  // Advise the OS to back the SHM with huge pages (0 = disabled).
+  bool short_read_locks{false};  // Readers only lock to probe, then copy and validate the values.
 };
 
 template <typename Key>
@@ -109,6 +113,54 @@ class MultiProcessHashMapBackend final
  protected:
   static constexpr size_t value_page_alignment{1};
 
+  /**
+   * Sequence counter (seqlock). Writers, which are always serialized through the shared memory
+   * mutex, make it odd while modifying the guarded data. Readers do not lock. They remember the
+   * (even) counter value, and retry if it changed until they are done.
+   */
+  struct SequenceCounter final {
+    std::atomic<uint64_t> value{0};
+
+    SequenceCounter() = default;
+    SequenceCounter(const SequenceCounter& that) : value{that.value.load()} {}
+    SequenceCounter& operator=(const SequenceCounter& that) {
+      value = that.value.load();
+      return *this;
+    }
+
+    inline void begin_write() {
+      value.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+    inline void end_write() { value.fetch_add(1, std::memory_order_release); }
+
+    // @return \p false if a write is in progress.
+    inline bool try_begin_read(uint64_t& seq) const {
+      seq = value.load(std::memory_order_acquire);
+      return !(seq & 1);
+    }
+    inline uint64_t begin_read() const {
+      uint64_t seq;
+      while (!try_begin_read(seq)) {
+        std::this_thread::yield();
+      }
+      return seq;
+    }
+    inline bool is_unchanged(const uint64_t seq) const {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return value.load(std::memory_order_relaxed) == seq;
+    }
+  };
+
+  struct SequenceWriteGuard final {
+    SequenceCounter& counter;
+
+    HCTR_DISALLOW_COPY_AND_MOVE(SequenceWriteGuard);
+
+    SequenceWriteGuard(SequenceCounter& counter) : counter{counter} { counter.begin_write(); }
+    ~SequenceWriteGuard() { counter.end_write(); }
+  };
+
   using ValuePage = SharedVector<char>;
   using ValuePtr = boost::interprocess::offset_ptr<char>;
 
@@ -126,6 +178,7 @@ class MultiProcessHashMapBackend final
     uint32_t value_size;
     size_t allocation_rate;
     size_t overflow_margin;
+    size_t overflow_resolution_margin;
     DatabaseOverflowPolicy_t overflow_policy;
     double overflow_resolution_target;
 
@@ -136,13 +189,20 @@ class MultiProcessHashMapBackend final
     // Key -> Payload map.
     SharedFlatMap<Key, Payload> entries;
 
+    // Position at which the `EvictClock` overflow policy resumes its sweep.
+    size_t clock_hand{0};
+
+    // Incremented before and after each modification (for readers with short locks).
+    SequenceCounter seq;
+
     Partition() = delete;
 
     Partition(const uint32_t value_size, const MultiProcessHashMapBackendParams& params,
-              Segment& segment)
+              const size_t overflow_margin, Segment& segment)
         : value_size{value_size},
           allocation_rate{params.allocation_rate},
-          overflow_margin{params.overflow_margin},
+          overflow_margin{overflow_margin},
+          overflow_resolution_margin{params.overflow_resolution_margin(overflow_margin)},
           overflow_policy{params.overflow_policy},
           overflow_resolution_target{params.overflow_resolution_target},
           value_pages(segment.get_allocator<ValuePage>()),
@@ -160,6 +220,7 @@ class MultiProcessHashMapBackend final
 
     // Actual data.
     SharedMap<SharedString, SharedVector<Partition>> tables;
+    SequenceCounter tables_seq;  // Incremented before and after creating/dropping tables.
 
     HCTR_DISALLOW_COPY_AND_MOVE(SharedMemory);
 
@@ -184,6 +245,22 @@ class MultiProcessHashMapBackend final
   std::thread heart_;
   bool is_process_connected_() const;
 
+  // Locates a table without allocating shared memory. Requires holding the lock.
+  SharedVector<Partition>* find_table_(const std::string& table_name) const;
+
+  // Variants of `fetch` that only hold the sharable lock while probing (see `short_read_locks`).
+  size_t fetch_with_short_locks_(const std::string& table_name, size_t num_keys, const Key* keys,
+                                 char* values, size_t value_stride,
+                                 const DatabaseMissCallback& on_miss,
+                                 const std::chrono::nanoseconds& time_budget);
+  size_t fetch_with_short_locks_(const std::string& table_name, size_t num_indices,
+                                 const size_t* indices, const Key* keys, char* values,
+                                 size_t value_stride, const DatabaseMissCallback& on_miss,
+                                 const std::chrono::nanoseconds& time_budget);
+
+  // Allocate another value page for the partition, and fill up the free value slots.
+  void allocate_value_page_(Partition& part);
+
   // Overflow resolution.
   size_t resolve_overflow_(const std::string& table_name, size_t part_index, Partition& part);
 };
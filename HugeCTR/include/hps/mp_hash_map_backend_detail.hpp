@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <hps/database_backend_detail.hpp>
+#include <hps/hash_map_backend_detail.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+/**
+ * MultiProcessHashMap Backend / Short read locks
+ *
+ * Readers hold the sharable lock of the shared memory only while they probe the map of a batch,
+ * because the flat map, the value pages and the table directory can move during a write. Only the
+ * copies of the values from the value pages, which are plain data inside the segment, proceed
+ * without the lock. They are validated against the sequence counter of the partition afterwards,
+ * and the batch is repeated if a writer interfered. If a table was created or dropped during the
+ * lookup, the remaining keys are skipped (same as exceeding the time budget). Access statistics are
+ * not updated, because the readers do not own the values that they copy.
+ */
+#ifdef HCTR_HPS_MP_HASH_MAP_CHECK_TABLES_
+#error HCTR_HPS_MP_HASH_MAP_CHECK_TABLES_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_MP_HASH_MAP_CHECK_TABLES_(MODE, MISS_OP)                                   \
+  do {                                                                                      \
+    static_assert(std::is_same_v<decltype(tables_seq), uint64_t>);                          \
+                                                                                            \
+    if (!sm_->tables_seq.is_unchanged(tables_seq)) {                                        \
+      HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Table ", table_name,                  \
+                 ": Tables were created or dropped during lookup. Skipping remaining keys.\n"); \
+                                                                                            \
+      HCTR_HPS_DB_HANDLE_TIMEOUT_##MODE##_(MISS_OP);                                        \
+    }                                                                                       \
+  } while (0)
+
+/**
+ * Must be evaluated under the sharable lock. Aborts the batch if tables were created or dropped, as
+ * \p part might be gone.
+ */
+#ifdef HCTR_HPS_MP_HASH_MAP_BEGIN_READ_
+#error HCTR_HPS_MP_HASH_MAP_BEGIN_READ_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_MP_HASH_MAP_BEGIN_READ_()                \
+  do {                                                    \
+    if (!sm_->tables_seq.is_unchanged(tables_seq)) {      \
+      return false;                                       \
+    }                                                     \
+  } while (0)
+
+/**
+ * Confirms that no writer touched the partition since the probe. The directory is checked last,
+ * so that \p part was still alive while its counter was read.
+ */
+#ifdef HCTR_HPS_MP_HASH_MAP_END_READ_
+#error HCTR_HPS_MP_HASH_MAP_END_READ_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_MP_HASH_MAP_END_READ_() \
+  (part.seq.is_unchanged(part_seq) && sm_->tables_seq.is_unchanged(tables_seq))
+
+/**
+ * Rewinds a batch, so that it can be repeated.
+ */
+#ifdef HCTR_HPS_MP_HASH_MAP_REWIND_
+#error HCTR_HPS_MP_HASH_MAP_REWIND_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_MP_HASH_MAP_REWIND_(IT)                     \
+  do {                                                       \
+    IT = batch_begin;                                        \
+    if constexpr (!std::is_const_v<decltype(batch_size)>) { \
+      batch_size = 0;                                        \
+    }                                                        \
+  } while (0)
+
+/**
+ * MultiProcessHashMap Backend / Fetch (short read locks)
+ */
+#ifdef HCTR_HPS_MP_HASH_MAP_PROBE_IMPL_
+#error HCTR_HPS_MP_HASH_MAP_PROBE_IMPL_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_MP_HASH_MAP_PROBE_IMPL_()                        \
+  do {                                                            \
+    static_assert(std::is_same_v<decltype(k), const Key*> ||      \
+                  std::is_same_v<decltype(k), const Key* const>); \
+                                                                  \
+    const auto& it{part.entries.find(*k)};                        \
+    if (it != part.entries.end()) {                               \
+      const char* const value{it->second.value.get()};            \
+      hash_map_prefetch_value(value, value_size);                 \
+      batch_values.emplace_back(k, value);                        \
+    } else {                                                      \
+      batch_values.emplace_back(k, nullptr);                      \
+    }                                                             \
+  } while (0)
+
+#ifdef HCTR_HPS_MP_HASH_MAP_FETCH_
+#error HCTR_HPS_MP_HASH_MAP_FETCH_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_MP_HASH_MAP_FETCH_(MODE, IT)                                                  \
+  [&]() {                                                                                      \
+    static_assert(std::is_same_v<decltype(value_stride), const size_t>);                       \
+    static_assert(std::is_same_v<decltype(values), char* const>);                              \
+    static_assert(std::is_same_v<decltype(miss_count), size_t>);                               \
+    static_assert(std::is_invocable_v<decltype(on_miss), size_t>);                             \
+                                                                                               \
+    const auto batch_begin{IT};                                                                \
+    std::vector<std::pair<const Key*, const char*>> batch_values;                              \
+    uint64_t part_seq;                                                                         \
+    uint32_t value_size;                                                                       \
+    while (true) {                                                                             \
+      /* Pass 1: Probe the map and prefetch the values. Writers are excluded meanwhile, so     \
+       * that the map and the value pointers are stable. */                                    \
+      {                                                                                        \
+        const boost::interprocess::sharable_lock lock(sm_->read_write_guard);                  \
+        HCTR_HPS_MP_HASH_MAP_BEGIN_READ_();                                                    \
+        part_seq = part.seq.begin_read();                                                      \
+        value_size = part.value_size;                                                          \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_MP_HASH_MAP_PROBE_IMPL_());                          \
+      }                                                                                        \
+                                                                                               \
+      /* Pass 2: Gather the values without the lock. A writer may recycle or tear them. Hence, \
+       * the batch is repeated unless the partition remained unchanged. */                     \
+      for (const auto& [k, value] : batch_values) {                                            \
+        if (value) {                                                                           \
+          std::copy_n(value, value_size, &values[(k - keys) * value_stride]);                  \
+        }                                                                                      \
+      }                                                                                        \
+      if (HCTR_HPS_MP_HASH_MAP_END_READ_()) {                                                  \
+        break;                                                                                 \
+      }                                                                                        \
+                                                                                               \
+      HCTR_HPS_MP_HASH_MAP_REWIND_(IT);                                                        \
+      batch_values.clear();                                                                    \
+    }                                                                                          \
+                                                                                               \
+    /* Only report misses once the batch is known to be consistent. */                         \
+    for (const auto& [k, value] : batch_values) {                                              \
+      if (!value) {                                                                            \
+        on_miss(k - keys);                                                                     \
+        ++miss_count;                                                                          \
+      }                                                                                        \
+    }                                                                                          \
+    return true;                                                                               \
+  }()
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
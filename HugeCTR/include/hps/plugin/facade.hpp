@@ -44,6 +44,13 @@ class Facade final {
   void forward(const char* model_name, const int32_t table_id, const int32_t global_replica_id,
                const size_t num_keys, const size_t emb_vec_size, const void* d_keys,
                void* d_vectors, bool i64_input_tensor, cudaStream_t context_stream);
+
+  void forward(const char* model_name, const int32_t global_replica_id,
+               const std::vector<size_t>& num_keys_per_table,
+               const std::vector<size_t>& emb_vec_size_per_table,
+               const std::vector<const void*>& d_keys_per_table,
+               const std::vector<void*>& d_vectors_per_table, bool i64_input_tensor,
+               cudaStream_t context_stream);
 };
 
 }  // namespace HierarchicalParameterServer
\ No newline at end of file
@@ -45,6 +45,14 @@ class LookupManager final {
                const void* values_ptr, void* emb_vector_ptr, bool i64_input_tensor,
                cudaStream_t context_stream);
 
+  // Looks up all embedding tables of the model at once, one entry per table in each vector.
+  void forward(const std::string& model_name, const int32_t global_replica_id,
+               const std::vector<size_t>& num_keys_per_table,
+               const std::vector<size_t>& emb_vec_size_per_table,
+               const std::vector<const void*>& values_ptr_per_table,
+               const std::vector<void*>& emb_vector_ptr_per_table, bool i64_input_tensor,
+               cudaStream_t context_stream);
+
   bool init_check(parameter_server_config& ps_config, const int32_t global_batch_size,
                   const int32_t num_replicas_in_sync, pluginType_t plugin_type) const;
 
@@ -54,6 +62,7 @@ class LookupManager final {
  private:
   LookupManager();
   bool initialized_;
+  pluginType_t plugin_type_;
   std::shared_ptr<HierParameterServerBase> parameter_server_;
   std::map<std::string, std::map<size_t, std::shared_ptr<LookupSessionBase>>> lookup_session_map_;
 };
@@ -18,6 +18,7 @@
 #include <sw/redis++/redis++.h>
 
 #include <hps/database_backend.hpp>
+#include <hps/slab_hash_map_backend.hpp>
 #include <memory>
 
 namespace HugeCTR {
@@ -35,6 +36,10 @@ struct RedisClusterBackendParams final : public VolatileBackendParams {
 
   size_t num_node_connections{5};  // Maximum number of simultaneous connections that are formed
                                    // with the same redis server node.
+  size_t num_pipelined_batches{4};  // Maximum number of `max_batch_size` sized batches that are
+                                    // pipelined into a single round trip during `fetch`.
+  DatabaseValueEncoding_t value_encoding{
+      DatabaseValueEncoding_t::Raw};  // Encoding of values in Redis (non-raw = float values only).
 
   bool enable_tls{
       false};  // If true, connections formed with server nodes will be secured using SSL/TLS.
@@ -44,12 +49,19 @@ struct RedisClusterBackendParams final : public VolatileBackendParams {
   std::string client_key{"client_key.pem"};           // Private key to use for this client.
   std::string server_name_identification{
       "redis.localhost"};  // SNI to request (can deviate from connection address).
+
+  size_t near_cache_size{0};  // Maximum number of entries per table that are kept in the memory of
+                              // this process, in front of Redis (0 = disabled).
 };
 
 /**
  * \p DatabaseBackend implementation that connects to a Redis to store/retrieve information (i.e.
  * distributed storage).
  *
+ * Optionally, a bounded near-cache in the local memory answers the fetches of hot keys without a
+ * round trip. Inserts and evictions through this backend invalidate the affected entries of the
+ * near-cache. Changes that other processes make to Redis directly are not observed.
+ *
  * @tparam Key The data-type that is used for keys in this database.
  */
 template <typename Key>
@@ -104,6 +116,26 @@ class RedisClusterBackend final : public VolatileBackend<Key, RedisClusterBacken
   size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
 
  protected:
+  size_t fetch_remote_(const std::string& table_name, size_t num_keys, const Key* keys,
+                       char* values, size_t value_stride, const DatabaseMissCallback& on_miss,
+                       const std::chrono::nanoseconds& time_budget);
+
+  size_t fetch_remote_(const std::string& table_name, size_t num_indices, const size_t* indices,
+                       const Key* keys, char* values, size_t value_stride,
+                       const DatabaseMissCallback& on_miss,
+                       const std::chrono::nanoseconds& time_budget);
+
+  /**
+   * Fetches the keys from the near-cache, then the remaining keys from Redis, and admits the
+   * latter into the near-cache.
+   *
+   * @param indices The indices of the keys to fetch, or nullptr to fetch keys [0, num_indices).
+   */
+  size_t fetch_through_near_cache_(const std::string& table_name, size_t num_indices,
+                                   const size_t* indices, const Key* keys, char* values,
+                                   size_t value_stride, const DatabaseMissCallback& on_miss,
+                                   const std::chrono::nanoseconds& time_budget);
+
   /**
    * Called internally during `insert` if insertion causes an overflow situation.
    */
@@ -146,6 +178,7 @@ class RedisClusterBackend final : public VolatileBackend<Key, RedisClusterBacken
 
  protected:
   std::unique_ptr<sw::redis::RedisCluster> redis_;
+  std::unique_ptr<SlabHashMapBackend<Key>> near_cache_;
 
   // Worker used to update timestamps and carry out overflow handling.
   mutable ThreadPool background_worker_{"redis bg worker", 1};
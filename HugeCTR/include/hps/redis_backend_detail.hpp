@@ -19,6 +19,8 @@
 
 #include <charconv>
 #include <core23/logger.hpp>
+#include <cstring>
+#include <hps/inference_utils.hpp>
 #include <iterator>
 #include <type_traits>
 #include <vector>
@@ -211,7 +213,9 @@ class RedisDirectValueInserter final
                                   char* const values, const size_t value_stride,
                                   const std::function<void(size_t)>& on_miss, size_t& miss_count,
                                   const DatabaseOverflowPolicy_t overflow_policy,
-                                  std::shared_ptr<std::vector<Key>>& touched_keys)
+                                  const DatabaseValueEncoding_t value_encoding,
+                                  std::shared_ptr<std::vector<Key>>& touched_keys,
+                                  const size_t k_views_offset = 0)
       : keys{keys},
         k_views{&k_views},
         values{values},
@@ -219,13 +223,16 @@ class RedisDirectValueInserter final
         on_miss{&on_miss},
         miss_count(&miss_count),
         overflow_policy{overflow_policy},
-        touched_keys{&touched_keys} {}
+        value_encoding{value_encoding},
+        touched_keys{&touched_keys},
+        index{k_views_offset} {}
 
   inline RedisDirectValueInserter& operator=(sw::redis::Optional<sw::redis::StringView>&& v_view) {
     const Key* const k{reinterpret_cast<const Key*>(k_views->at(index++).data())};
     if (v_view) {
-      HCTR_CHECK(v_view->size() <= value_stride);
-      std::copy(v_view->begin(), v_view->end(), &values[(k - keys) * value_stride]);
+      HCTR_CHECK(db_decoded_value_size(value_encoding, v_view->size()) <= value_stride);
+      db_decode_value(value_encoding, v_view->data(), v_view->size(),
+                      &values[(k - keys) * value_stride]);
 
       if (overflow_policy != DatabaseOverflowPolicy_t::EvictRandom) {
         if (!*touched_keys) {
@@ -253,6 +260,7 @@ class RedisDirectValueInserter final
   const std::function<void(size_t)>* const on_miss;
   size_t* const miss_count;
   const DatabaseOverflowPolicy_t overflow_policy;
+  const DatabaseValueEncoding_t value_encoding;
   std::shared_ptr<std::vector<Key>>* touched_keys;
   size_t index{0};
 };
@@ -270,24 +278,37 @@ class RedisBinFileInserter final
   RedisBinFileInserter() = delete;
 
   inline RedisBinFileInserter(const std::vector<sw::redis::StringView>& k_views,
-                              uint32_t& value_size, std::ofstream& file, size_t& num_entries)
-      : k_views{&k_views}, value_size{&value_size}, file{&file}, num_entries{&num_entries} {}
+                              const DatabaseValueEncoding_t value_encoding, uint32_t& value_size,
+                              std::ofstream& file, size_t& num_entries)
+      : k_views{&k_views},
+        value_encoding{value_encoding},
+        value_size{&value_size},
+        file{&file},
+        num_entries{&num_entries} {}
 
   inline RedisBinFileInserter& operator=(sw::redis::Optional<sw::redis::StringView>&& v_view) {
     if (v_view) {
+      const size_t decoded_size{db_decoded_value_size(value_encoding, v_view->size())};
+
       // Write value_size field if not already written.
       if (*value_size) {
-        HCTR_CHECK(v_view->size() == *value_size);
+        HCTR_CHECK(decoded_size == *value_size);
       } else {
-        HCTR_CHECK(v_view->size() != 0);
-        *value_size = static_cast<uint32_t>(v_view->size());
+        HCTR_CHECK(decoded_size != 0);
+        *value_size = static_cast<uint32_t>(decoded_size);
         file->write(reinterpret_cast<const char*>(value_size), sizeof(uint32_t));
       }
 
       // Write the pair.
       const sw::redis::StringView& k_view{k_views->at(index)};
       file->write(k_view.data(), k_view.size());
-      file->write(v_view->data(), v_view->size());
+      if (value_encoding == DatabaseValueEncoding_t::Raw) {
+        file->write(v_view->data(), v_view->size());
+      } else {
+        buffer.resize(decoded_size);
+        db_decode_value(value_encoding, v_view->data(), v_view->size(), buffer.data());
+        file->write(buffer.data(), buffer.size());
+      }
       ++(*num_entries);
     } else {
       HCTR_LOG_C(WARNING, WORLD, "The database was modified while dumping!\n");
@@ -303,10 +324,12 @@ class RedisBinFileInserter final
 
  protected:
   const std::vector<sw::redis::StringView>* const k_views;
+  const DatabaseValueEncoding_t value_encoding;
   uint32_t* const value_size;
   std::ofstream* const file;
   size_t* const num_entries;
   size_t index{0};
+  std::vector<char> buffer;
 };
 
 /**
@@ -355,62 +378,59 @@ class RedisBinFileInserter final
 
 /**
  * Redis Backend / Fetch
+ *
+ * Each batch is queued as a separate `HMGET` command into the pipeline `pipe`. Hence, several
+ * batches for the same partition are in flight during a single round trip to the server node.
  */
-#ifdef HCTR_HPS_REDIS_FETCH_
-#error HCTR_HPS_REDIS_FETCH_ already defined. Potential naming conflict!
+#ifdef HCTR_HPS_REDIS_FETCH_QUEUE_
+#error HCTR_HPS_REDIS_FETCH_QUEUE_ already defined. Potential naming conflict!
 #endif
-#if 0
-#define HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS() std::vector<sw::redis::Optional<std::string>> v_views
-#define HCTR_HPS_REDIS_FETCH_(MODE)                                                                \
+#define HCTR_HPS_REDIS_FETCH_QUEUE_(MODE)                                                          \
   [&]() {                                                                                          \
-    static_assert(std::is_same_v<decltype(miss_count), size_t>);                                   \
     static_assert(std::is_same_v<decltype(k_views), std::vector<sw::redis::StringView>>);          \
+    static_assert(std::is_same_v<decltype(k_views_offsets), std::vector<size_t>>);                 \
                                                                                                    \
-    k_views.clear();                                                                               \
+    const size_t k_views_offset{k_views.size()};                                                   \
     HCTR_HPS_DB_APPLY_(MODE, k_views.emplace_back(reinterpret_cast<const char*>(k), sizeof(Key))); \
                                                                                                    \
-    v_views.clear();                                                                               \
-    v_views.reserve(k_views.size());                                                               \
-    redis_->hmget(hkey_v, k_views.begin(), k_views.end(), std::back_inserter(v_views));            \
-                                                                                                   \
-    for (auto v_it{v_views.begin()}; v_it != v_views.end(); ++v_it) {                              \
-      const Key* const k{reinterpret_cast<const Key*>(k_views[v_it - v_views.begin()].data())};    \
-      const sw::redis::Optional<std::string>& v_view{*v_it};                                       \
-      if (v_view) {                                                                                \
-        HCTR_CHECK(v_view->size() <= value_stride);                                                \
-        std::copy(v_view->begin(), v_view->end(), &values[(k - keys) * value_stride]);             \
-                                                                                                   \
-        if (this->params_.overflow_policy != DatabaseOverflowPolicy_t::EvictRandom) {              \
-          if (!touched_keys) {                                                                     \
-            touched_keys = std::make_shared<std::vector<Key>>();                                   \
-          }                                                                                        \
-          touched_keys->emplace_back(keys[k - keys]);                                              \
-        }                                                                                          \
-      } else {                                                                                     \
-        on_miss(k - keys);                                                                         \
-        ++miss_count;                                                                              \
-      }                                                                                            \
-    }                                                                                              \
+    pipe.hmget(hkey_v, k_views.begin() + k_views_offset, k_views.end());                           \
+    k_views_offsets.emplace_back(k_views_offset);                                                  \
     return true;                                                                                   \
   }()
-#else
-#define HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS() \
-  do {                                        \
+
+#ifdef HCTR_HPS_REDIS_FETCH_EXEC_
+#error HCTR_HPS_REDIS_FETCH_EXEC_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_REDIS_FETCH_EXEC_()                                                              \
+  do {                                                                                            \
+    static_assert(std::is_same_v<decltype(miss_count), size_t>);                                  \
+                                                                                                  \
+    sw::redis::QueuedReplies replies{pipe.exec()};                                                \
+    for (size_t idx{0}; idx < replies.size(); ++idx) {                                            \
+      replies.get(idx, RedisDirectValueInserter<Key>(keys, k_views, values, value_stride, on_miss, \
+                                                     miss_count, this->params_.overflow_policy,   \
+                                                     this->params_.value_encoding, touched_keys,  \
+                                                     k_views_offsets[idx]));                      \
+    }                                                                                             \
   } while (0)
-#define HCTR_HPS_REDIS_FETCH_(MODE)                                                                \
-  [&]() {                                                                                          \
-    static_assert(std::is_same_v<decltype(k_views), std::vector<sw::redis::StringView>>);          \
-                                                                                                   \
-    k_views.clear();                                                                               \
-    HCTR_HPS_DB_APPLY_(MODE, k_views.emplace_back(reinterpret_cast<const char*>(k), sizeof(Key))); \
-                                                                                                   \
-    redis_->hmget(                                                                                 \
-        hkey_v, k_views.begin(), k_views.end(),                                                    \
-        RedisDirectValueInserter<Key>(keys, k_views, values, value_stride, on_miss, miss_count,    \
-                                      this->params_.overflow_policy, touched_keys));               \
-    return true;                                                                                   \
-  }()
+
+#ifdef HCTR_HPS_REDIS_INSERT_VALUE_VIEW_
+#error HCTR_HPS_REDIS_INSERT_VALUE_VIEW_ already defined. Potential naming conflict!
 #endif
+#define HCTR_HPS_REDIS_INSERT_VALUE_VIEW_()                                     \
+  [&]() -> sw::redis::StringView {                                              \
+    static_assert(std::is_same_v<decltype(v_buffer), std::vector<char>>);       \
+    static_assert(std::is_same_v<decltype(encoded_value_size), const size_t>);  \
+                                                                                \
+    const char* const v{&values[(k - keys) * value_stride]};                    \
+    if (this->params_.value_encoding == DatabaseValueEncoding_t::Raw) {         \
+      return {v, value_size};                                                   \
+    }                                                                           \
+                                                                                \
+    char* const v_encoded{&v_buffer[kv_views.size() * encoded_value_size]};     \
+    db_encode_value(this->params_.value_encoding, v, value_size, v_encoded);    \
+    return {v_encoded, encoded_value_size};                                     \
+  }()
 
 #ifdef HCTR_HPS_REDIS_INSERT_
 #error HCTR_HPS_REDIS_INSERT_ already defined. Potential naming conflict!
@@ -439,14 +459,14 @@ class RedisBinFileInserter final
             MODE, kv_views.emplace_back(                                                       \
                       std::piecewise_construct,                                                \
                       std::forward_as_tuple(reinterpret_cast<const char*>(k), sizeof(Key)),    \
-                      std::forward_as_tuple(&values[(k - keys) * value_stride], value_size))); \
+                      std::forward_as_tuple(HCTR_HPS_REDIS_INSERT_VALUE_VIEW_())));            \
       } break;                                                                                 \
       case DatabaseOverflowPolicy_t::EvictLeastUsed: {                                         \
         HCTR_HPS_DB_APPLY_(MODE, {                                                             \
           kv_views.emplace_back(                                                               \
               std::piecewise_construct,                                                        \
               std::forward_as_tuple(reinterpret_cast<const char*>(k), sizeof(Key)),            \
-              std::forward_as_tuple(&values[(k - keys) * value_stride], value_size));          \
+              std::forward_as_tuple(HCTR_HPS_REDIS_INSERT_VALUE_VIEW_()));                     \
           pipe.hincrby(hkey_m, {reinterpret_cast<const char*>(k), sizeof(Key)}, 1);            \
         });                                                                                    \
       } break;                                                                                 \
@@ -456,7 +476,7 @@ class RedisBinFileInserter final
           kv_views.emplace_back(                                                               \
               std::piecewise_construct,                                                        \
               std::forward_as_tuple(reinterpret_cast<const char*>(k), sizeof(Key)),            \
-              std::forward_as_tuple(&values[(k - keys) * value_stride], value_size));          \
+              std::forward_as_tuple(HCTR_HPS_REDIS_INSERT_VALUE_VIEW_()));                     \
           km_views.emplace_back(                                                               \
               std::piecewise_construct,                                                        \
               std::forward_as_tuple(reinterpret_cast<const char*>(k), sizeof(Key)),            \
@@ -464,6 +484,8 @@ class RedisBinFileInserter final
         });                                                                                    \
         pipe.hset(hkey_m, km_views.begin(), km_views.end());                                   \
       } break;                                                                                 \
+      default:                                                                                 \
+        HCTR_DIE("Unsupported overflow policy!");                                              \
     }                                                                                          \
     pipe.hset(hkey_v, kv_views.begin(), kv_views.end());                                       \
     pipe.hlen(hkey_v);                                                                         \
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Wire protocol of the HPS lookup server, and the client for it. This header only depends on
+// POSIX sockets, so that ranking hosts without CUDA or the HPS libraries can include it.
+
+namespace HugeCTR {
+
+namespace remote_lookup {
+
+constexpr uint32_t request_magic{0x48505331};  // "HPS1"
+
+/**
+ * A request is a \p RequestHeader followed by num_keys keys of key_size bytes each. All fields
+ * are in the byte order of the hosts, which must be the same on both sides.
+ */
+struct RequestHeader {
+  uint32_t magic;
+  uint32_t table_id;
+  uint32_t key_size;  // 8 for int64 keys, 4 for uint32 keys
+  uint32_t reserved;
+  uint64_t num_keys;
+};
+
+enum class Status_t : uint32_t { Success = 0, Error = 1 };
+
+/**
+ * A reply is a \p ReplyHeader followed by payload_size bytes. On success, the payload are the
+ * num_keys * vector_size embedding vectors of the request, as floats. Otherwise, the payload is
+ * the error message and vector_size is 0.
+ */
+struct ReplyHeader {
+  Status_t status;
+  uint32_t vector_size;
+  uint64_t payload_size;
+};
+
+// Writes size bytes to the socket, and returns false if the peer is gone.
+inline bool send_all(const int socket, const void* const data, const size_t size) {
+  const char* ptr{static_cast<const char*>(data)};
+  for (size_t sent{0}; sent < size;) {
+    const ssize_t n{::send(socket, ptr + sent, size - sent, MSG_NOSIGNAL)};
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    sent += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// Reads size bytes from the socket, and returns false if the peer closed it before.
+inline bool recv_all(const int socket, void* const data, const size_t size) {
+  char* ptr{static_cast<char*>(data)};
+  for (size_t received{0}; received < size;) {
+    const ssize_t n{::recv(socket, ptr + received, size - received, 0)};
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    received += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+}  // namespace remote_lookup
+
+/**
+ * Client of a remote HPS lookup server. It keeps one connection, over which its lookups are
+ * serialized; threads that look up concurrently should each have their own client, so that the
+ * server can batch their requests. Errors are thrown as std::runtime_error.
+ */
+class RemoteLookupClient {
+ public:
+  RemoteLookupClient(const std::string& host, const uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses{nullptr};
+    const int rc{::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses)};
+    if (rc != 0) {
+      throw std::runtime_error("Cannot resolve HPS lookup server " + host + ": " +
+                               ::gai_strerror(rc));
+    }
+    for (const addrinfo* address{addresses}; address; address = address->ai_next) {
+      socket_ = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+      if (socket_ < 0) {
+        continue;
+      }
+      if (::connect(socket_, address->ai_addr, address->ai_addrlen) == 0) {
+        break;
+      }
+      ::close(socket_);
+      socket_ = -1;
+    }
+    ::freeaddrinfo(addresses);
+    if (socket_ < 0) {
+      throw std::runtime_error("Cannot connect to HPS lookup server " + host + ":" +
+                               std::to_string(port));
+    }
+    // Requests are small and latency bound, so they must not wait for Nagle's algorithm.
+    const int one{1};
+    ::setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+
+  ~RemoteLookupClient() {
+    if (socket_ >= 0) {
+      ::close(socket_);
+    }
+  }
+
+  RemoteLookupClient(const RemoteLookupClient&) = delete;
+  RemoteLookupClient& operator=(const RemoteLookupClient&) = delete;
+
+  /**
+   * Looks up the embedding vectors of num_keys keys of table table_id, and returns them one after
+   * the other. The key type must match the i64_input_key setting of the model on the server.
+   */
+  template <typename TypeKey>
+  std::vector<float> lookup(const TypeKey* const keys, const size_t num_keys,
+                            const size_t table_id) {
+    static_assert(sizeof(TypeKey) == 4 || sizeof(TypeKey) == 8, "Keys must have 4 or 8 bytes");
+    const remote_lookup::RequestHeader request{remote_lookup::request_magic,
+                                               static_cast<uint32_t>(table_id),
+                                               static_cast<uint32_t>(sizeof(TypeKey)), 0,
+                                               static_cast<uint64_t>(num_keys)};
+    if (!remote_lookup::send_all(socket_, &request, sizeof(request)) ||
+        !remote_lookup::send_all(socket_, keys, sizeof(TypeKey) * num_keys)) {
+      throw std::runtime_error("Lost the connection to the HPS lookup server");
+    }
+
+    remote_lookup::ReplyHeader reply;
+    if (!remote_lookup::recv_all(socket_, &reply, sizeof(reply))) {
+      throw std::runtime_error("Lost the connection to the HPS lookup server");
+    }
+    if (reply.status != remote_lookup::Status_t::Success) {
+      std::string message(reply.payload_size, '\0');
+      if (!remote_lookup::recv_all(socket_, message.data(), message.size())) {
+        throw std::runtime_error("Lost the connection to the HPS lookup server");
+      }
+      throw std::runtime_error("HPS lookup server: " + message);
+    }
+    if (reply.payload_size != sizeof(float) * num_keys * reply.vector_size) {
+      throw std::runtime_error("Malformed reply of the HPS lookup server");
+    }
+    std::vector<float> vectors(num_keys * reply.vector_size);
+    if (!remote_lookup::recv_all(socket_, vectors.data(), reply.payload_size)) {
+      throw std::runtime_error("Lost the connection to the HPS lookup server");
+    }
+    return vectors;
+  }
+
+ private:
+  int socket_{-1};
+};
+
+}  // namespace HugeCTR
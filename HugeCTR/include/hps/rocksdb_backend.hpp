@@ -34,6 +34,7 @@ struct RocksDBBackendParams final : public PersistentBackendParams {
   bool read_only{
       false};  // If \p true will open the database in \p read-only mode. This allows simultaneously
                // querying the same RocksDB database from multiple clients.
+  size_t block_cache_size{16L * 1024 * 1024};  // Capacity of the block cache shared by all tables.
 };
 
 /**
@@ -79,6 +80,16 @@ class RocksDBBackend final : public PersistentBackend<Key, RocksDBBackendParams>
                const DatabaseMissCallback& on_miss,
                const std::chrono::nanoseconds& time_budget) override;
 
+  std::future<size_t> fetch_async(const std::string& table_name, size_t num_keys, const Key* keys,
+                                  char* values, size_t value_stride,
+                                  const DatabaseMissCallback& on_miss,
+                                  const std::chrono::nanoseconds& time_budget) override;
+
+  std::future<size_t> fetch_async(const std::string& table_name, size_t num_indices,
+                                  const size_t* indices, const Key* keys, char* values,
+                                  size_t value_stride, const DatabaseMissCallback& on_miss,
+                                  const std::chrono::nanoseconds& time_budget) override;
+
   size_t evict(const std::string& table_name) override;
 
   size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
@@ -91,6 +102,9 @@ class RocksDBBackend final : public PersistentBackend<Key, RocksDBBackendParams>
 
   size_t load_dump_sst(const std::string& table_name, const std::string& path) override;
 
+  size_t load_dump_sst(const std::string& table_name,
+                       const std::vector<std::string>& paths) override;
+
  protected:
   inline rocksdb::ColumnFamilyHandle* get_column_handle_(const std::string& table_name) const {
     const auto& it{column_handles_.find(table_name)};
@@ -112,6 +126,7 @@ class RocksDBBackend final : public PersistentBackend<Key, RocksDBBackendParams>
   std::unique_ptr<rocksdb::DB> db_;
   std::unordered_map<std::string, rocksdb::ColumnFamilyHandle*> column_handles_;
 
+  std::shared_ptr<rocksdb::Cache> block_cache_;
   rocksdb::ColumnFamilyOptions column_family_options_;
   rocksdb::ReadOptions read_options_;
   rocksdb::WriteOptions write_options_;
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core/memory.hpp>
+#include <cstring>
+#include <deque>
+#include <hps/database_backend.hpp>
+#include <hps/database_backend_detail.hpp>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+struct SlabHashMapBackendParams final : public VolatileBackendParams {
+  double max_load_factor{0.75};  // Grow the slab of a partition once this ratio of slots is used.
+};
+
+/**
+ * \p DatabaseBackend implementation that stores key/value pairs in the local CPU memory. Unlike
+ * \p HashMapBackend , each partition is a single open-addressed slab of fixed-width slots that hold
+ * the key, the access metadata and the value inline. Hence, lookups resolve without chasing a
+ * pointer to a separately allocated value. Since empty slots also reserve space for a value, this
+ * layout is most efficient for tables with small values.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class SlabHashMapBackend final : public VolatileBackend<Key, SlabHashMapBackendParams> {
+ public:
+  using Base = VolatileBackend<Key, SlabHashMapBackendParams>;
+
+  HCTR_DISALLOW_COPY_AND_MOVE(SlabHashMapBackend);
+
+  SlabHashMapBackend() = delete;
+
+  /**
+   * Construct a new parallelized SlabHashMapBackend object.
+   */
+  SlabHashMapBackend(const SlabHashMapBackendParams& params);
+
+  bool is_shared() const override final { return false; }
+
+  const char* get_name() const override { return "SlabHashMapBackend"; }
+
+  size_t size(const std::string& table_name) const override;
+
+  size_t contains(const std::string& table_name, size_t num_keys, const Key* keys,
+                  const std::chrono::nanoseconds& time_budget) const override;
+
+  size_t insert(const std::string& table_name, size_t num_pairs, const Key* keys,
+                const char* values, uint32_t value_size, size_t value_stride) override;
+
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+               size_t value_stride, const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, char* values, size_t value_stride,
+               const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t evict(const std::string& table_name) override;
+
+  size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
+
+  std::vector<std::string> find_tables(const std::string& model_name) override;
+
+  size_t dump_bin(const std::string& table_name, std::ofstream& file) override;
+
+  size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
+
+ protected:
+  // Leading part of every slot. The value immediately follows the header.
+  struct SlotHeader final {
+    Key key;
+    uint64_t meta;  // Occupied flag + access count or last access time (depends on policy).
+  };
+  static constexpr uint64_t occupied_flag{UINT64_C(1) << 63};
+  static constexpr size_t slot_alignment{alignof(SlotHeader)};
+
+  using Slab = std::vector<char, AlignedAllocator<char>>;
+
+  struct Partition final {
+    const uint32_t value_size;
+    const size_t slot_size;
+    const double max_load_factor;
+    const size_t overflow_margin;
+    const size_t overflow_resolution_margin;
+
+    // Access control (per partition). Readers only contend with writers of the same partition.
+    mutable std::shared_mutex read_write_guard;
+
+    // Open-addressed slots (linear probing).
+    Slab slots;
+    size_t capacity{0};
+    size_t size{0};
+
+    // Slot at which the `EvictClock` overflow policy resumes its sweep.
+    size_t clock_hand{0};
+
+    Partition() = delete;
+
+    Partition(const uint32_t value_size, const SlabHashMapBackendParams& params,
+              const size_t overflow_margin)
+        : value_size{value_size},
+          slot_size{(sizeof(SlotHeader) + value_size + slot_alignment - 1) / slot_alignment *
+                    slot_alignment},
+          max_load_factor{params.max_load_factor},
+          overflow_margin{overflow_margin},
+          overflow_resolution_margin{params.overflow_resolution_margin(overflow_margin)} {}
+
+    inline char* slot(const size_t index) { return &slots[index * slot_size]; }
+    inline const char* slot(const size_t index) const { return &slots[index * slot_size]; }
+
+    inline SlotHeader& header(const size_t index) {
+      return *reinterpret_cast<SlotHeader*>(slot(index));
+    }
+    inline const SlotHeader& header(const size_t index) const {
+      return *reinterpret_cast<const SlotHeader*>(slot(index));
+    }
+
+    inline char* value(const size_t index) { return &slot(index)[sizeof(SlotHeader)]; }
+    inline const char* value(const size_t index) const {
+      return &slot(index)[sizeof(SlotHeader)];
+    }
+
+    inline bool is_occupied(const size_t index) const {
+      return header(index).meta & occupied_flag;
+    }
+
+    /**
+     * Slot where the probe sequence for \p key starts. Uses the upper bits of the hash (range
+     * reduction by multiplication), because the lower bits also select the partition.
+     */
+    inline size_t home(const Key& key) const {
+      return static_cast<size_t>((static_cast<unsigned __int128>(rrxmrrxmsx_0(key)) * capacity) >>
+                                 64);
+    }
+
+    inline size_t next(const size_t index) const {
+      return index + 1 == capacity ? 0 : index + 1;
+    }
+
+    /**
+     * Locates \p key , starting the probe at slot \p index , which must be \p home(key) .
+     *
+     * @return The slot occupied by \p key , or \p capacity if not found.
+     */
+    inline size_t find(const Key& key, size_t index) const {
+      if (!capacity) {
+        return capacity;
+      }
+      while (is_occupied(index)) {
+        if (header(index).key == key) {
+          return index;
+        }
+        index = next(index);
+      }
+      return capacity;
+    }
+
+    inline size_t find(const Key& key) const { return find(key, home(key)); }
+
+    /**
+     * Locates \p key , or claims a free slot for it (may grow the slab).
+     *
+     * @return The slot occupied by \p key , and whether it was freshly claimed.
+     */
+    std::pair<size_t, bool> try_emplace(const Key& key);
+
+    /**
+     * Frees the slot at \p index . Following slots of the same cluster are shifted backward to keep
+     * all probe sequences intact (no tombstones required).
+     */
+    void erase(size_t index);
+
+    // Relocates all entries into a slab with the given number of slots.
+    void rehash(size_t new_capacity);
+  };
+
+  // Partitions are not movable (they own a mutex). Hence, we use a deque for stable addresses.
+  using PartitionList = std::deque<Partition>;
+
+  // Actual data.
+  std::unordered_map<std::string, PartitionList> tables_;
+
+  // Access control. Only guards the table directory. Exclusive access is only required to create
+  // or drop tables. Operations on the contents of tables are guarded by the partition locks.
+  mutable std::shared_mutex read_write_guard_;
+
+  // Create the partitions for a table, if it does not exist yet (acquires exclusive access).
+  void create_table_(const std::string& table_name, uint32_t value_size);
+
+  // Overflow resolution.
+  size_t resolve_overflow_(const std::string& table_name, size_t part_index, Partition& part);
+};
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <hps/database_backend_detail.hpp>
+#include <hps/hash_map_backend_detail.hpp>
+#include <hps/inference_utils.hpp>
+#include <type_traits>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+/**
+ * SlabHashMap Backend / Contains
+ */
+#ifdef HCTR_HPS_SLAB_HASH_MAP_CONTAINS_
+#error HCTR_HPS_SLAB_HASH_MAP_CONTAINS_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_SLAB_HASH_MAP_CONTAINS_(MODE)                             \
+  [&]() {                                                                  \
+    HCTR_HPS_DB_APPLY_(MODE, hit_count += part.find(*k) != part.capacity); \
+    return true;                                                           \
+  }()
+
+/**
+ * SlabHashMap Backend / Evict
+ */
+#ifdef HCTR_HPS_SLAB_HASH_MAP_EVICT_K_
+#error HCTR_HPS_SLAB_HASH_MAP_EVICT_K_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_SLAB_HASH_MAP_EVICT_K_()                           \
+  do {                                                              \
+    static_assert(std::is_same_v<decltype(num_deletions), size_t>); \
+    static_assert(std::is_same_v<decltype(k), const Key*> ||        \
+                  std::is_same_v<decltype(k), const Key* const>);   \
+                                                                    \
+    const size_t index{part.find(*k)};                              \
+    if (index != part.capacity) {                                   \
+      part.erase(index);                                            \
+      ++num_deletions;                                              \
+    }                                                               \
+  } while (0)
+
+#ifdef HCTR_HPS_SLAB_HASH_MAP_EVICT_
+#error HCTR_HPS_SLAB_HASH_MAP_EVICT_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_SLAB_HASH_MAP_EVICT_(MODE)                      \
+  [&]() {                                                        \
+    HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_SLAB_HASH_MAP_EVICT_K_()); \
+    return true;                                                 \
+  }()
+
+/**
+ * SlabHashMap Backend / Fetch
+ *
+ * Same blocking scheme as the HashMap backend. But since values are stored inline, prefetching the
+ * home slot of a key already covers the value. So, two passes suffice.
+ */
+#ifdef HCTR_HPS_SLAB_HASH_MAP_FETCH_BLOCK_
+#error HCTR_HPS_SLAB_HASH_MAP_FETCH_BLOCK_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_SLAB_HASH_MAP_FETCH_BLOCK_(...)                                               \
+  do {                                                                                         \
+    static_assert(std::is_same_v<decltype(miss_count), size_t>);                               \
+    static_assert(std::is_invocable_v<decltype(on_miss), size_t>);                             \
+    static_assert(std::is_same_v<decltype(value_stride), const size_t>);                       \
+    static_assert(std::is_same_v<decltype(values), char* const>);                              \
+    static_assert(std::is_same_v<decltype(num_pending), size_t>);                              \
+                                                                                               \
+    /* Pass 1: Locate and prefetch home slots. */                                              \
+    std::array<size_t, hash_map_fetch_block_size> homes;                                       \
+    for (size_t j{0}; j < num_pending; ++j) {                                                  \
+      homes[j] = part.home(*pending[j]);                                                       \
+      if (part.capacity) {                                                                     \
+        hash_map_prefetch_value(part.slot(homes[j]), part.slot_size);                          \
+      }                                                                                        \
+    }                                                                                          \
+                                                                                               \
+    /* Pass 2: Probe slots and gather values. */                                               \
+    for (size_t j{0}; j < num_pending; ++j) {                                                  \
+      const Key* const k{pending[j]};                                                          \
+      const size_t index{part.find(*k, homes[j])};                                             \
+      if (index != part.capacity) {                                                            \
+        SlotHeader& header{part.header(index)};                                                \
+                                                                                               \
+        /* Race-conditions here are deliberately ignored because insignificant in practice. */ \
+        __VA_ARGS__;                                                                           \
+        std::copy_n(part.value(index), part.value_size, &values[(k - keys) * value_stride]);   \
+      } else {                                                                                 \
+        on_miss(k - keys);                                                                     \
+        ++miss_count;                                                                          \
+      }                                                                                        \
+    }                                                                                          \
+    num_pending = 0;                                                                           \
+  } while (0)
+
+#ifdef HCTR_HPS_SLAB_HASH_MAP_FETCH_IMPL_
+#error HCTR_HPS_SLAB_HASH_MAP_FETCH_IMPL_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_SLAB_HASH_MAP_FETCH_IMPL_(...)                   \
+  do {                                                            \
+    static_assert(std::is_same_v<decltype(k), const Key*> ||      \
+                  std::is_same_v<decltype(k), const Key* const>); \
+                                                                  \
+    pending[num_pending++] = k;                                   \
+    if (num_pending == hash_map_fetch_block_size) {               \
+      HCTR_HPS_SLAB_HASH_MAP_FETCH_BLOCK_(__VA_ARGS__);           \
+    }                                                             \
+  } while (0)
+
+#ifdef HCTR_HPS_SLAB_HASH_MAP_CLOCK_TICK_
+#error HCTR_HPS_SLAB_HASH_MAP_CLOCK_TICK_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_SLAB_HASH_MAP_CLOCK_TICK_()                       \
+  do {                                                             \
+    if ((header.meta & ~occupied_flag) < clock_max_access_count) { \
+      ++header.meta;                                               \
+    }                                                              \
+  } while (0)
+
+#ifdef HCTR_HPS_SLAB_HASH_MAP_FETCH_
+#error HCTR_HPS_SLAB_HASH_MAP_FETCH_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_SLAB_HASH_MAP_FETCH_(MODE)                                                   \
+  [&]() {                                                                                     \
+    static_assert(std::is_same_v<decltype(overflow_policy), const DatabaseOverflowPolicy_t>); \
+                                                                                              \
+    const Key* pending[hash_map_fetch_block_size];                                            \
+    size_t num_pending{0};                                                                    \
+                                                                                              \
+    switch (overflow_policy) {                                                                \
+      case DatabaseOverflowPolicy_t::EvictRandom: {                                           \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_SLAB_HASH_MAP_FETCH_IMPL_());                       \
+        HCTR_HPS_SLAB_HASH_MAP_FETCH_BLOCK_();                                                \
+      } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictLeastUsed: {                                        \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_SLAB_HASH_MAP_FETCH_IMPL_(++header.meta));          \
+        HCTR_HPS_SLAB_HASH_MAP_FETCH_BLOCK_(++header.meta);                                   \
+      } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictOldest: {                                           \
+        const uint64_t meta{occupied_flag | static_cast<uint64_t>(std::time(nullptr))};       \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_SLAB_HASH_MAP_FETCH_IMPL_(header.meta = meta));     \
+        HCTR_HPS_SLAB_HASH_MAP_FETCH_BLOCK_(header.meta = meta);                              \
+      } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictClock: {                                            \
+        HCTR_HPS_DB_APPLY_(                                                                   \
+            MODE, HCTR_HPS_SLAB_HASH_MAP_FETCH_IMPL_(HCTR_HPS_SLAB_HASH_MAP_CLOCK_TICK_()));  \
+        HCTR_HPS_SLAB_HASH_MAP_FETCH_BLOCK_(HCTR_HPS_SLAB_HASH_MAP_CLOCK_TICK_());            \
+      } break;                                                                                \
+    }                                                                                         \
+    return true;                                                                              \
+  }()
+
+/**
+ * SlabHashMap Backend / Insert
+ */
+#ifdef HCTR_HPS_SLAB_HASH_MAP_INSERT_IMPL_
+#error HCTR_HPS_SLAB_HASH_MAP_INSERT_IMPL_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_SLAB_HASH_MAP_INSERT_IMPL_(...)                                        \
+  do {                                                                                  \
+    static_assert(std::is_same_v<decltype(num_inserts), size_t>);                       \
+    static_assert(std::is_same_v<decltype(value_size), const uint32_t>);                \
+    static_assert(std::is_same_v<decltype(value_stride), const size_t>);                \
+    static_assert(std::is_same_v<decltype(k), const Key*> ||                            \
+                  std::is_same_v<decltype(k), const Key* const>);                       \
+    static_assert(std::is_same_v<decltype(values), const char* const>);                 \
+                                                                                        \
+    const auto& res{part.try_emplace(*k)};                                              \
+    SlotHeader& header{part.header(res.first)};                                         \
+                                                                                        \
+    __VA_ARGS__;                                                                        \
+                                                                                        \
+    /* If new insertion. */                                                             \
+    if (res.second) {                                                                   \
+      ++num_inserts;                                                                    \
+    }                                                                                   \
+                                                                                        \
+    std::copy_n(&values[(k - keys) * value_stride], value_size, part.value(res.first)); \
+  } while (0)
+
+#ifdef HCTR_HPS_SLAB_HASH_MAP_INSERT_
+#error HCTR_HPS_SLAB_HASH_MAP_INSERT_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_SLAB_HASH_MAP_INSERT_(MODE)                                                  \
+  [&]() {                                                                                     \
+    static_assert(std::is_same_v<decltype(overflow_policy), const DatabaseOverflowPolicy_t>); \
+                                                                                              \
+    switch (overflow_policy) {                                                                \
+      case DatabaseOverflowPolicy_t::EvictRandom: {                                           \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_SLAB_HASH_MAP_INSERT_IMPL_());                      \
+      } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictLeastUsed: {                                        \
+        HCTR_HPS_DB_APPLY_(MODE,                                                              \
+                           HCTR_HPS_SLAB_HASH_MAP_INSERT_IMPL_(header.meta = occupied_flag)); \
+      } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictOldest: {                                           \
+        const uint64_t meta{occupied_flag | static_cast<uint64_t>(std::time(nullptr))};       \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_SLAB_HASH_MAP_INSERT_IMPL_(header.meta = meta));    \
+      } break;                                                                                \
+      case DatabaseOverflowPolicy_t::EvictClock: {                                            \
+        /* New slots start with an access count of 0. Updates retain their access count. */   \
+        HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_SLAB_HASH_MAP_INSERT_IMPL_());                      \
+      } break;                                                                                \
+    }                                                                                         \
+    return true;                                                                              \
+  }()
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
@@ -83,6 +83,9 @@ class StaticTable : public EmbeddingCacheBase,
 
   void* d_insert_keys_buffer_;
 
+  // Return the stored FP8 embeddings and their scales, instead of dequantizing them
+  bool fp8_output_;
+
   // The parameter server that it is bound to
   HierParameterServerBase* parameter_server_;
 
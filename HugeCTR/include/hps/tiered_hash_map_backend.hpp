@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <parallel_hashmap/phmap.h>
+
+#include <core/memory.hpp>
+#include <deque>
+#include <hps/database_backend.hpp>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+struct TieredHashMapBackendParams final : public VolatileBackendParams {
+  size_t allocation_rate{256L * 1024 *
+                         1024};  // Number of additional bytes to allocate per allocation cycle.
+  std::string spill_path{"/tmp"};  // Directory (ideally on a local NVMe drive) for the spill logs.
+  size_t spill_queue_depth{128};   // Maximum number of spill reads in flight per thread.
+  uint64_t spill_promotion_threshold{2};  // Accesses after which spilled entries return to memory.
+  double spill_compaction_ratio{0.5};     // Compact a spill log once this share is outdated.
+};
+
+/**
+ * \p DatabaseBackend implementation that stores the hot fraction of each table in the local CPU
+ * memory, using the same layout as \p HashMapBackend . Once a partition holds more than
+ * \p overflow_margin entries, the least used entries are not discarded, but demoted to an
+ * append-only log on local storage (the spill tier). Spilled entries are read using io_uring, and
+ * are promoted back to memory after being accessed \p spill_promotion_threshold times. Hence,
+ * tables can be much larger than the available memory, while hot entries are still served at
+ * memory speed.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class TieredHashMapBackend final : public VolatileBackend<Key, TieredHashMapBackendParams> {
+ public:
+  using Base = VolatileBackend<Key, TieredHashMapBackendParams>;
+
+  HCTR_DISALLOW_COPY_AND_MOVE(TieredHashMapBackend);
+
+  TieredHashMapBackend() = delete;
+
+  /**
+   * Construct a new parallelized TieredHashMapBackend object.
+   */
+  TieredHashMapBackend(const TieredHashMapBackendParams& params);
+
+  bool is_shared() const override final { return false; }
+
+  const char* get_name() const override { return "TieredHashMapBackend"; }
+
+  // The spill tier is only bounded by the available storage.
+  size_t capacity(const std::string& table_name) const override final {
+    return std::numeric_limits<size_t>::max();
+  }
+
+  size_t size(const std::string& table_name) const override;
+
+  size_t contains(const std::string& table_name, size_t num_keys, const Key* keys,
+                  const std::chrono::nanoseconds& time_budget) const override;
+
+  size_t insert(const std::string& table_name, size_t num_pairs, const Key* keys,
+                const char* values, uint32_t value_size, size_t value_stride) override;
+
+  size_t fetch(const std::string& table_name, size_t num_keys, const Key* keys, char* values,
+               size_t value_stride, const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t fetch(const std::string& table_name, size_t num_indices, const size_t* indices,
+               const Key* keys, char* values, size_t value_stride,
+               const DatabaseMissCallback& on_miss,
+               const std::chrono::nanoseconds& time_budget) override;
+
+  size_t evict(const std::string& table_name) override;
+
+  size_t evict(const std::string& table_name, size_t num_keys, const Key* keys) override;
+
+  std::vector<std::string> find_tables(const std::string& model_name) override;
+
+  size_t dump_bin(const std::string& table_name, std::ofstream& file) override;
+
+  size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
+
+ protected:
+  static constexpr size_t value_page_alignment{AlignedAllocator<char>::alignment};
+
+  using ValuePage = std::vector<char, AlignedAllocator<char>>;
+  using ValuePtr = char*;
+
+  // Data-structure that will be associated with every key in memory.
+  struct Payload final {
+    uint64_t access_count;
+    ValuePtr value;
+  };
+  using Entry = std::pair<const Key, Payload>;
+
+  // Data-structure that will be associated with every spilled key.
+  struct SpillEntry final {
+    uint64_t access_count;
+    uint64_t offset;  // Position of the value in the spill log.
+  };
+
+  // Spilled entry that was fetched often enough to be moved back to memory.
+  struct Promotion final {
+    Key key;
+    uint64_t offset;
+    const char* value;  // Copy of the value (in the output buffer of `fetch`).
+  };
+
+  struct Partition final {
+    const uint32_t value_size;
+    const size_t allocation_rate;
+    const size_t overflow_margin;
+    const size_t overflow_resolution_margin;
+
+    // Access control (per partition). Readers only contend with writers of the same partition.
+    mutable std::shared_mutex read_write_guard;
+
+    // Memory tier: Pooled payload storage.
+    std::vector<ValuePage> value_pages;
+    std::vector<ValuePtr> value_slots;
+
+    // Memory tier: Key -> Payload map.
+    phmap::flat_hash_map<Key, Payload> entries;
+
+    // Spill tier: Append-only log. The file is unlinked upon creation, so that the OS reclaims the
+    // storage once the descriptor is closed.
+    int spill_fd{-1};
+    uint64_t spill_size{0};     // Bytes written to the log.
+    uint64_t spill_garbage{0};  // Bytes in the log that belong to outdated values.
+
+    // Spill tier: Key -> SpillEntry map.
+    phmap::flat_hash_map<Key, SpillEntry> spilled;
+
+    HCTR_DISALLOW_COPY_AND_MOVE(Partition);
+
+    Partition() = delete;
+
+    Partition(uint32_t value_size, const TieredHashMapBackendParams& params,
+              size_t overflow_margin);
+
+    ~Partition();
+  };
+
+  // Partitions are not movable (they own a mutex). Hence, we use a deque for stable addresses.
+  using PartitionList = std::deque<Partition>;
+
+  // Actual data.
+  std::unordered_map<std::string, PartitionList> tables_;
+
+  // Access control. Only guards the table directory. Exclusive access is only required to create
+  // or drop tables. Operations on the contents of tables are guarded by the partition locks.
+  mutable std::shared_mutex read_write_guard_;
+
+  // Create the partitions for a table, if it does not exist yet (acquires exclusive access).
+  void create_table_(const std::string& table_name, uint32_t value_size);
+
+  // Allocate another value page for the partition, and fill up the free value slots.
+  void allocate_value_page_(Partition& part);
+
+  // Insert a pair into the memory tier (supersedes the spilled value, if any).
+  bool insert_(Partition& part, const Key& key, const char* value);
+
+  // Move spilled entries back to the memory tier (acquires exclusive access to the partition).
+  size_t promote_(const std::string& table_name, size_t part_index, Partition& part,
+                  const std::vector<Promotion>& promotions);
+
+  // Overflow resolution (demotes the least used entries to the spill tier).
+  size_t resolve_overflow_(const std::string& table_name, size_t part_index, Partition& part);
+
+  // Rewrite the spill log without outdated values, if the garbage ratio has been exceeded.
+  void compact_spill_(const std::string& table_name, size_t part_index, Partition& part);
+};
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <hps/database_backend_detail.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+/**
+ * Value that needs to be read from a spill log.
+ */
+struct TieredHashMapSpillRead final {
+  uint64_t offset;
+  char* value;
+};
+
+/**
+ * Reads all \p reads ( \p value_size bytes each) from the spill log \p fd . Reads are submitted
+ * to io_uring in groups of up to \p queue_depth . Falls back to \p pread , if io_uring is not
+ * available.
+ */
+void tiered_hash_map_read_spilled(int fd, uint32_t value_size,
+                                  const std::vector<TieredHashMapSpillRead>& reads,
+                                  size_t queue_depth);
+
+/**
+ * Writes \p num_bytes from \p data at \p offset to the spill log \p fd .
+ */
+void tiered_hash_map_write_spilled(int fd, uint64_t offset, const char* data, size_t num_bytes);
+
+/**
+ * TieredHashMap Backend / Contains
+ */
+#ifdef HCTR_HPS_TIERED_HASH_MAP_CONTAINS_
+#error HCTR_HPS_TIERED_HASH_MAP_CONTAINS_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_TIERED_HASH_MAP_CONTAINS_(MODE)                                         \
+  [&]() {                                                                                \
+    HCTR_HPS_DB_APPLY_(MODE, hit_count += part.entries.find(*k) != part.entries.end() || \
+                                          part.spilled.find(*k) != part.spilled.end());  \
+    return true;                                                                         \
+  }()
+
+/**
+ * TieredHashMap Backend / Evict
+ */
+#ifdef HCTR_HPS_TIERED_HASH_MAP_EVICT_K_
+#error HCTR_HPS_TIERED_HASH_MAP_EVICT_K_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_TIERED_HASH_MAP_EVICT_K_()                         \
+  do {                                                              \
+    static_assert(std::is_same_v<decltype(num_deletions), size_t>); \
+    static_assert(std::is_same_v<decltype(k), const Key*> ||        \
+                  std::is_same_v<decltype(k), const Key* const>);   \
+                                                                    \
+    const auto& it{part.entries.find(*k)};                          \
+    if (it != part.entries.end()) {                                 \
+      /* Stash pointer and reference in map. */                     \
+      part.value_slots.emplace_back(it->second.value);              \
+      part.entries.erase(it);                                       \
+      ++num_deletions;                                              \
+    } else {                                                        \
+      /* Log storage is reclaimed during the next compaction. */    \
+      const auto& s_it{part.spilled.find(*k)};                      \
+      if (s_it != part.spilled.end()) {                             \
+        part.spilled.erase(s_it);                                   \
+        part.spill_garbage += part.value_size;                      \
+        ++num_deletions;                                            \
+      }                                                             \
+    }                                                               \
+  } while (0)
+
+#ifdef HCTR_HPS_TIERED_HASH_MAP_EVICT_
+#error HCTR_HPS_TIERED_HASH_MAP_EVICT_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_TIERED_HASH_MAP_EVICT_(MODE)                      \
+  [&]() {                                                          \
+    HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_TIERED_HASH_MAP_EVICT_K_()); \
+    return true;                                                   \
+  }()
+
+/**
+ * TieredHashMap Backend / Fetch
+ *
+ * Values in memory are copied right away. Reads for spilled values are collected, and submitted
+ * together once the batch has been processed, so that the storage device sees a deep queue.
+ */
+#ifdef HCTR_HPS_TIERED_HASH_MAP_FETCH_K_
+#error HCTR_HPS_TIERED_HASH_MAP_FETCH_K_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_TIERED_HASH_MAP_FETCH_K_()                                                \
+  do {                                                                                     \
+    static_assert(std::is_same_v<decltype(miss_count), size_t>);                           \
+    static_assert(std::is_invocable_v<decltype(on_miss), size_t>);                         \
+    static_assert(std::is_same_v<decltype(value_stride), const size_t>);                   \
+    static_assert(std::is_same_v<decltype(values), char* const>);                          \
+    static_assert(std::is_same_v<decltype(k), const Key*> ||                               \
+                  std::is_same_v<decltype(k), const Key* const>);                          \
+                                                                                           \
+    char* const value{&values[(k - keys) * value_stride]};                                 \
+                                                                                           \
+    /* Race-conditions on access counts are deliberately ignored because insignificant. */ \
+    const auto& it{part.entries.find(*k)};                                                 \
+    if (it != part.entries.end()) {                                                        \
+      Payload& payload{it->second};                                                        \
+      ++payload.access_count;                                                              \
+      std::copy_n(payload.value, part.value_size, value);                                  \
+    } else {                                                                               \
+      const auto& s_it{part.spilled.find(*k)};                                             \
+      if (s_it != part.spilled.end()) {                                                    \
+        SpillEntry& entry{s_it->second};                                                   \
+        spill_reads.push_back({entry.offset, value});                                      \
+        if (++entry.access_count >= this->params_.spill_promotion_threshold) {             \
+          promotions.push_back({*k, entry.offset, value});                                 \
+        }                                                                                  \
+      } else {                                                                             \
+        on_miss(k - keys);                                                                 \
+        ++miss_count;                                                                      \
+      }                                                                                    \
+    }                                                                                      \
+  } while (0)
+
+#ifdef HCTR_HPS_TIERED_HASH_MAP_FETCH_
+#error HCTR_HPS_TIERED_HASH_MAP_FETCH_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_TIERED_HASH_MAP_FETCH_(MODE)                                                  \
+  [&]() {                                                                                      \
+    static_assert(std::is_same_v<decltype(spill_reads), std::vector<TieredHashMapSpillRead>>); \
+    static_assert(std::is_same_v<decltype(promotions), std::vector<Promotion>>);               \
+                                                                                               \
+    HCTR_HPS_DB_APPLY_(MODE, HCTR_HPS_TIERED_HASH_MAP_FETCH_K_());                             \
+    if (!spill_reads.empty()) {                                                                \
+      tiered_hash_map_read_spilled(part.spill_fd, part.value_size, spill_reads,                \
+                                   this->params_.spill_queue_depth);                           \
+      spill_reads.clear();                                                                     \
+    }                                                                                          \
+    return true;                                                                               \
+  }()
+
+/**
+ * TieredHashMap Backend / Insert
+ */
+#ifdef HCTR_HPS_TIERED_HASH_MAP_INSERT_
+#error HCTR_HPS_TIERED_HASH_MAP_INSERT_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_TIERED_HASH_MAP_INSERT_(MODE)                                                \
+  [&]() {                                                                                     \
+    static_assert(std::is_same_v<decltype(num_inserts), size_t>);                             \
+    static_assert(std::is_same_v<decltype(value_stride), const size_t>);                      \
+    static_assert(std::is_same_v<decltype(values), const char* const>);                       \
+                                                                                              \
+    HCTR_HPS_DB_APPLY_(MODE,                                                                  \
+                       num_inserts += insert_(part, *k, &values[(k - keys) * value_stride])); \
+    return true;                                                                              \
+  }()
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
@@ -15,11 +15,17 @@
  */
 #pragma once
 
+#include <chrono>
 #include <common.hpp>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <hps/embedding_cache_base.hpp>
 #include <inference/inference_session_base.hpp>
 #include <inference/preallocated_buffer2.hpp>
+#include <inference/tensorrt_dense_network.hpp>
 #include <metrics.hpp>
+#include <mutex>
 #include <network.hpp>
 #include <parser.hpp>
 #include <pipeline.hpp>
@@ -60,10 +66,81 @@ class InferenceSession : public InferenceSessionBase {
 
   Pipeline predict_network_pipeline_;
 
+  // Replaces network_ if tensorrt_onnx_file is set, with the buffers of its inputs
+  std::unique_ptr<TensorRTDenseNetwork> tensorrt_network_;
+  std::vector<const void*> tensorrt_inputs_;
+
+  // Dense network of a batch size below max_batchsize, see cuda_graph_batch_sizes
+  struct BatchSizeBucket {
+    explicit BatchSizeBucket(const nlohmann::json& config) : parser(config) {}
+
+    size_t batch_size;
+    InferenceParser parser;
+    core23::Tensor dense_input_tensorbag;
+    std::vector<std::shared_ptr<core23::Tensor>> row_ptrs_tensors;
+    std::vector<std::shared_ptr<core23::Tensor>> embedding_features_tensors;
+    std::vector<size_t> embedding_table_slot_size;
+    std::vector<TensorEntry> tensor_entries;
+    std::vector<std::shared_ptr<Layer>> embedding_feature_combiners;
+    std::unique_ptr<Network> network;
+    Pipeline predict_network_pipeline;
+  };
+
+  // Smaller batch sizes in ascending order
+  std::vector<std::unique_ptr<BatchSizeBucket>> batch_size_buckets_;
+  // Row pointers that are padded to the batch size of a bucket
+  int* d_padded_row_ptrs_{nullptr};
+
+  // A predict call that waits to be merged into a micro-batch
+  struct PendingRequest {
+    float* d_dense;
+    void* keys;
+    bool key_on_device;
+    int* d_row_ptrs;
+    float* d_output;
+    int num_samples;
+    bool table_major_key_layout;
+    std::chrono::steady_clock::time_point arrival_time;
+    bool done{false};
+    std::exception_ptr error;
+  };
+
+  // Micro-batching of concurrent calls if micro_batching_window_us > 0
+  std::mutex batch_mutex_;
+  std::condition_variable batch_cv_;
+  std::deque<PendingRequest*> pending_requests_;
+  bool batch_in_flight_{false};
+
+  // Merged inputs and outputs of a micro-batch
+  float* d_batch_dense_{nullptr};
+  int* d_batch_row_ptrs_{nullptr};
+  float* d_batch_output_{nullptr};
+  void* h_batch_keys_{nullptr};
+  void* d_batch_keys_{nullptr};
+
+  // Loads the dense model parameters, and prepares the network to predict.
+  void initialize_network_(Network& network);
+  Pipeline create_predict_pipeline_(Network* network, bool capture_graph);
+  void create_batch_size_buckets_();
+  void create_tensorrt_network_();
+
   void predict_impl(float* d_dense, void* keys, bool key_on_device, int* d_row_ptrs,
                     float* d_output, int num_samples, int num_embedding_tables,
                     bool table_major_key_layout);
 
+  void predict_from_host_(float* d_dense, void* h_embeddingcolumns, int* d_row_ptrs,
+                          float* d_output, int num_samples, bool table_major_key_layout);
+  void predict_from_device_(float* d_dense, void* d_embeddingcolumns, int* d_row_ptrs,
+                            float* d_output, int num_samples, bool table_major_key_layout);
+
+  /**
+   * Queues a call, and waits until a micro-batch that contains it completes. The first waiting
+   * call leads the next micro-batch: it waits for the window to close, and runs the batch.
+   */
+  void predict_batched_(PendingRequest& request);
+  // Merges the inputs of the requests, runs them as one call, and scatters the predictions.
+  void run_micro_batch_(const std::vector<PendingRequest*>& requests);
+
  protected:
   InferenceParser inference_parser_;
   InferenceParams inference_params_;
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime_api.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Runs the dense network of an inference session as a TensorRT engine. The engine is built from
+ * the ONNX model that hugectr2onnx exports with convert_embedding=False, whose inputs are the
+ * dense features and the outputs of the embedding layers, and whose outputs are the predictions.
+ * The batch dimension of the engine is dynamic, up to max_batchsize. With an engine file, the
+ * built engine is serialized to it, and later sessions load it instead of building it again, as
+ * long as it is newer than the ONNX model and was built by the same TensorRT version.
+ * Requires HugeCTR to be compiled with ENABLE_TENSORRT.
+ */
+class TensorRTDenseNetwork {
+ public:
+  /**
+   * @param half_inputs whether the dense features and embeddings are __half rather than float,
+   * as with use_mixed_precision. The engine then also runs its layers in FP16 where TensorRT
+   * finds them faster.
+   */
+  TensorRTDenseNetwork(const std::string& onnx_file, const std::string& engine_file,
+                       size_t max_batchsize, bool half_inputs, int device_id);
+  ~TensorRTDenseNetwork();
+  TensorRTDenseNetwork(const TensorRTDenseNetwork&) = delete;
+  TensorRTDenseNetwork& operator=(const TensorRTDenseNetwork&) = delete;
+
+  // Names of the inputs, which are the names of the tensors in the HugeCTR model graph.
+  const std::vector<std::string>& input_names() const;
+
+  /**
+   * Predicts num_samples samples. inputs are the device buffers of input_names(), in the same
+   * order. The predictions of all outputs are written to d_output, sample by sample.
+   */
+  void predict(const std::vector<const void*>& inputs, float* d_output, size_t num_samples,
+               cudaStream_t stream);
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace HugeCTR
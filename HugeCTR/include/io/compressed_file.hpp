@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <io/filesystem.hpp>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Codecs of the nvCOMP compressed files. Only None is available without ENABLE_NVCOMP.
+ *
+ * A compressed file holds its data as independently compressed pages: a head, the uncompressed
+ * and compressed bytes of each page, and then the compressed pages, each padded to 8 bytes. Pages
+ * are compressed and decompressed by batches on the gpu, and a read only decompresses the pages
+ * that overlap the bytes that it reads.
+ */
+enum class CompressionCodec { None, LZ4, Zstd, Bitcomp };
+
+// Parses "", "none", "lz4", "zstd" or "bitcomp".
+CompressionCodec get_compression_codec(const std::string& name);
+
+// The suffix of the name of compressed files, e.g. ".lz4", and "" for None.
+std::string get_compressed_file_suffix(CompressionCodec codec);
+
+// The codec of path by its suffix.
+CompressionCodec get_file_compression_codec(const std::string& path);
+
+/**
+ * Returns path if its file exists, and otherwise path followed by the suffix of the first codec
+ * whose compressed file exists, or an empty string if there is none.
+ */
+std::string find_maybe_compressed_file(FileSystem& file_system, const std::string& path);
+
+// Data compressed in pages, see CompressionCodec.
+struct CompressedPages {
+  CompressionCodec codec = CompressionCodec::None;
+  std::vector<uint64_t> uncompressed_bytes;
+  std::vector<uint64_t> compressed_bytes;
+  std::vector<char> data;  // The padded pages
+};
+
+// Compresses size bytes of host data on the current gpu, in pages of page_bytes.
+CompressedPages compress_pages(const void* data, size_t size, CompressionCodec codec,
+                               size_t page_bytes = 64 << 10);
+
+/**
+ * Returns the head of a compressed file with the pages of parts, which are written after it in
+ * order. This lets each process write its part of a file, see get_compressed_file_bytes.
+ */
+std::vector<char> get_compressed_file_head(const std::vector<CompressedPages>& parts);
+
+// The bytes of the pages of a part with their padding, by its page index, so that its data is not
+// needed.
+size_t get_compressed_file_bytes(const CompressedPages& part);
+
+// Compresses data and writes it to path, which is overwritten.
+void write_compressed_file(FileSystem& file_system, const std::string& path, const void* data,
+                           size_t size, CompressionCodec codec);
+
+/**
+ * Reads ranges of the uncompressed data of a compressed file. The head and the page index are
+ * read once, so that many reads of a file do not read them again.
+ */
+class CompressedFileReader {
+ public:
+  CompressedFileReader(FileSystem& file_system, const std::string& path);
+
+  CompressionCodec codec() const { return codec_; }
+
+  // The number of uncompressed bytes.
+  size_t size() const { return page_offsets_.back(); }
+
+  /**
+   * Reads size bytes at offset of the uncompressed data into the host buffer, through file_system,
+   * which need not be the one of the constructor, on the current gpu. It is thread safe.
+   */
+  void read(FileSystem& file_system, void* buffer, size_t size, size_t offset) const;
+
+ private:
+  std::string path_;
+  CompressionCodec codec_;
+  size_t max_page_bytes_;
+  // The uncompressed offset and the file offset of each page, and one past the last one.
+  std::vector<uint64_t> page_offsets_;
+  std::vector<uint64_t> file_offsets_;
+  std::vector<uint64_t> compressed_bytes_;
+};
+
+}  // namespace HugeCTR
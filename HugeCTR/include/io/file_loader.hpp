@@ -17,6 +17,7 @@
 
 #include <common.hpp>
 #include <fstream>
+#include <future>
 #include <io/filesystem.hpp>
 #include <memory>
 #include <string>
@@ -34,6 +35,10 @@ class FileLoader {
   int fd_;        /**< File descriptor for mapped file */
   std::ifstream in_file_stream_; /**< file stream of data set file */
   char* data_;                   /**< loaded data */
+  std::string prefetch_file_name_; /**< the file that is read in the background **/
+  std::future<Error_t> prefetch_;  /**< completion of the background read **/
+  char* prefetch_data_;            /**< data of the background read **/
+  size_t prefetch_file_size_;      /**< size of the file that is read in the background **/
 
   /**
    * @brief private helper function to get the current file information
@@ -43,6 +48,38 @@ class FileLoader {
    */
   Error_t set_file(const std::string& file_name) noexcept;
 
+  /**
+   * @brief private helper function to map a local file to CPU memory
+   *
+   * @param path
+   * @return 'Success', 'BrokenFile'
+   */
+  Error_t map_file(const std::string& path) noexcept;
+
+  /**
+   * @brief private helper function to read a remote file with concurrent ranged reads, and to
+   * write it into the cache directory
+   *
+   * @param file_name
+   * @param data allocated buffer with the file content
+   * @param file_size
+   * @return 'Success', 'BrokenFile', 'FileCannotOpen'
+   */
+  Error_t fetch(const std::string& file_name, char*& data, size_t& file_size) noexcept;
+
+  /**
+   * @brief private helper function to get the path of a remote file in the cache directory
+   *
+   * @param file_name
+   * @return the path, or an empty string if there is no cache directory
+   */
+  std::string get_cache_path(const std::string& file_name) const;
+
+  /**
+   * @brief private helper function to wait for the background read, and to free its data
+   */
+  void discard_prefetch() noexcept;
+
  public:
   FileLoader(const DataSourceParams& data_source_params);
 
@@ -56,6 +93,15 @@ class FileLoader {
    */
   Error_t load(const std::string& file_name) noexcept;
 
+  /**
+   * @brief Start to read a file in the background, so that loading it next does not wait for the
+   * file system. Only one remote file is read in the background at a time. Local files are read
+   * ahead into the page cache by the kernel.
+   *
+   * @param file_name
+   */
+  void prefetch(const std::string& file_name) noexcept;
+
   /**
    * @brief clean the loaded data and set corresponding flags
    *
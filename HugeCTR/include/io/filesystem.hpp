@@ -15,11 +15,29 @@
  */
 #pragma once
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace HugeCTR {
+
+// A range of a file to read into buffer, see FileSystem::batch_read().
+struct FileReadRequest {
+  std::string path;
+  void* buffer;
+  size_t buffer_size;
+  size_t offset;
+};
+
+// Data to write to a file, see FileSystem::batch_write().
+struct FileWriteRequest {
+  std::string path;
+  const void* data;
+  size_t data_size;
+  bool overwrite;
+};
+
 class FileSystem {
  public:
   FileSystem() = default;
@@ -115,6 +133,41 @@ class FileSystem {
    * @param target_dir
    */
   virtual void batch_upload(const std::string& source_dir, const std::string& target_dir) = 0;
+
+  /**
+   * @brief Starts a read() on a worker of a thread pool that is shared by all file systems. The
+   * file system and the buffer must outlive the returned future.
+   *
+   * @return Future number of successfully read bytes, or the exception thrown by read().
+   */
+  virtual std::future<int> read_async(const std::string& path, void* buffer, size_t buffer_size,
+                                      size_t offset);
+
+  /**
+   * @brief Starts a write() on a worker of a thread pool that is shared by all file systems. The
+   * file system and the data must outlive the returned future.
+   *
+   * @return Future number of successfully written bytes, or the exception thrown by write().
+   */
+  virtual std::future<int> write_async(const std::string& path, const void* data,
+                                       size_t data_size, bool overwrite);
+
+  /**
+   * @brief Issues the reads at the same time and waits for all of them. If a read fails, the first
+   * exception is rethrown once all reads have finished.
+   *
+   * @return Number of successfully read bytes of each request.
+   */
+  virtual std::vector<int> batch_read(const std::vector<FileReadRequest>& requests);
+
+  /**
+   * @brief Issues the writes to different files at the same time and waits for all of them. Writes
+   * to the same file are issued in the order of the requests, so that appends stay in order. If a
+   * write fails, the first exception is rethrown once all writes have finished.
+   *
+   * @return Number of successfully written bytes of each request.
+   */
+  virtual std::vector<int> batch_write(const std::vector<FileWriteRequest>& requests);
 };
 
 enum class FileSystemType_t { Local, HDFS, S3, GCS, Other };
@@ -123,10 +176,24 @@ struct DataSourceParams {
   FileSystemType_t type;
   std::string server;
   int port;
-
-  DataSourceParams(const FileSystemType_t type, const std::string& server, const int port)
-      : type(type), server(server), port(port){};
-  DataSourceParams() : type(FileSystemType_t::Local), server("localhost"), port(9000){};
+  // Reads of files from remote file systems are split into ranged reads of read_chunk_size_mb,
+  // of which num_read_threads are in flight at the same time.
+  int num_read_threads;
+  int read_chunk_size_mb;
+  // Local directory into which remote files are written after they are read, and from which they
+  // are mapped when read again. Not used if empty.
+  std::string cache_dir;
+
+  DataSourceParams(const FileSystemType_t type, const std::string& server, const int port,
+                   const int num_read_threads = 8, const int read_chunk_size_mb = 16,
+                   const std::string& cache_dir = "")
+      : type(type),
+        server(server),
+        port(port),
+        num_read_threads(num_read_threads),
+        read_chunk_size_mb(read_chunk_size_mb),
+        cache_dir(cache_dir){};
+  DataSourceParams() : DataSourceParams(FileSystemType_t::Local, "localhost", 9000){};
 };
 
 class FileSystemBuilder {
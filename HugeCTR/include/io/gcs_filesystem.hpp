@@ -21,6 +21,7 @@
 #include <io/filesystem.hpp>
 #endif
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -59,6 +60,11 @@ struct GCSConfigs {
   std::string scheme;
   std::string default_bucket;
   std::optional<double> retry_limit_time;
+  // Files larger than part_size are uploaded as parts that are composed into one object, and
+  // downloaded in ranges of part_size bytes, of which max_concurrency are transferred at the same
+  // time.
+  size_t part_size = 64 << 20;
+  int max_concurrency = 8;
 
   GCSConfigs();
 
@@ -100,7 +106,21 @@ class GCSFileSystem final : public FileSystem {
   void batch_upload(const std::string& source_dir, const std::string& target_dir) override;
 
  private:
+  // Reads up to nbytes at offset with one ranged request, and returns the number of bytes read.
+  size_t read_range_(const GCSPath& gcs_path, void* buffer, size_t nbytes, size_t offset);
+
+  /**
+   * Uploads size bytes to gcs_path as temporary objects of part_size_ bytes, which are composed
+   * into the object and deleted. get_part(offset, nbytes, buffer) returns the bytes of a part,
+   * which it may read into buffer.
+   */
+  void composite_upload_(
+      const GCSPath& gcs_path, size_t size,
+      const std::function<const char*(size_t, size_t, std::vector<char>&)>& get_part);
+
   std::unique_ptr<google::cloud::storage::Client> client_;
+  size_t part_size_;
+  int max_concurrency_;
 };
 #endif
 
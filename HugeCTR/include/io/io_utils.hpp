@@ -15,8 +15,15 @@
  */
 #pragma once
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
 #include <core23/logger.hpp>
+#include <exception>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <nlohmann/json.hpp>
 #include <regex>
 #include <string>
@@ -74,6 +81,74 @@ class IOUtils {
     std::regex pattern_b("^https:\\/\\/storage.cloud.google.com\\/*([\\w\\W]+)*");
     return regex_match(url, pattern_a) || regex_match(url, pattern_b);
   }
+
+  /**
+   * Calls fn(part, offset, part_bytes) for the parts of part_size bytes of size bytes, from up to
+   * max_concurrency threads. If fn throws, the remaining parts are skipped and the first exception
+   * is rethrown once all threads have finished.
+   */
+  static void for_each_part(const size_t size, const size_t part_size, const int max_concurrency,
+                            const std::function<void(size_t, size_t, size_t)>& fn) {
+    const size_t num_parts = std::max<size_t>((size + part_size - 1) / part_size, 1);
+    std::atomic<size_t> next_part{0};
+    const auto transfer_parts = [&]() {
+      try {
+        for (size_t part = next_part++; part < num_parts; part = next_part++) {
+          const size_t offset = part * part_size;
+          fn(part, offset, std::min(part_size, size - offset));
+        }
+      } catch (...) {
+        next_part = num_parts;
+        throw;
+      }
+    };
+
+    const size_t num_threads = std::min<size_t>(std::max(max_concurrency, 1), num_parts);
+    std::vector<std::future<void>> threads;
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back(std::async(std::launch::async, transfer_parts));
+    }
+    std::exception_ptr error;
+    try {
+      transfer_parts();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    for (auto& thread : threads) {
+      try {
+        thread.get();
+      } catch (...) {
+        if (!error) error = std::current_exception();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // pread()/pwrite() of exactly size bytes, which are split into several calls if needed.
+  static void pread_fully(const int fd, void* const buffer, const size_t size,
+                          const size_t offset) {
+    for (size_t done = 0; done < size;) {
+      const ssize_t n = pread(fd, static_cast<char*>(buffer) + done, size - done, offset + done);
+      if (n <= 0) {
+        HCTR_OWN_THROW(Error_t::BrokenFile, "Cannot read the local file.");
+      }
+      done += n;
+    }
+  }
+
+  static void pwrite_fully(const int fd, const void* const data, const size_t size,
+                           const size_t offset) {
+    for (size_t done = 0; done < size;) {
+      const ssize_t n =
+          pwrite(fd, static_cast<const char*>(data) + done, size - done, offset + done);
+      if (n <= 0) {
+        HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot write the local file.");
+      }
+      done += n;
+    }
+  }
 };
 
 }  // namespace HugeCTR
\ No newline at end of file
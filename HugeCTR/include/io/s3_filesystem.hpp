@@ -21,6 +21,7 @@
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
 #include <aws/s3/S3Client.h>
 
+#include <functional>
 #include <io/filesystem.hpp>
 #include <io/s3_utils.hpp>
 #include <memory>
@@ -51,6 +52,11 @@ struct S3Configs {
 
   S3CredentialsType credentials_type = S3CredentialsType::Default;
 
+  // Files larger than part_size are uploaded in parts and downloaded in ranges of part_size bytes,
+  // of which max_concurrency are transferred at the same time. S3 requires parts of at least 5 MB.
+  size_t part_size = 64 << 20;
+  int max_concurrency = 8;
+
   bool ready_to_connect = false;
 
   S3Configs();
@@ -115,7 +121,20 @@ class S3FileSystem final : public FileSystem {
   void batch_upload(const std::string& source_dir, const std::string& target_dir) override;
 
  private:
+  // Reads up to nbytes at offset with one ranged request, and returns the number of bytes read.
+  size_t read_range_(const S3Path& s3_path, void* buffer, size_t nbytes, size_t offset);
+
+  /**
+   * Uploads size bytes to s3_path in parts of part_size_ bytes. get_part(offset, nbytes, buffer)
+   * returns the bytes of a part, which it may read into buffer.
+   */
+  void multipart_upload_(
+      const S3Path& s3_path, size_t size,
+      const std::function<const char*(size_t, size_t, std::vector<char>&)>& get_part);
+
   std::unique_ptr<Aws::S3::S3Client> client_;
+  size_t part_size_;
+  int max_concurrency_;
 };
 #endif
 }  // namespace HugeCTR
\ No newline at end of file
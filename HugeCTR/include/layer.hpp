@@ -69,6 +69,18 @@ class Layer {
 
   virtual std::string get_no_trained_params_in_string() { return std::string(); }
 
+  /*
+   * The tensors that fprop reads and bprop writes the gradients of, and vice versa for the
+   * output tensors.
+   */
+  const std::vector<core23::Tensor>& get_core23_input_tensors() const { return input_tensors_; }
+  const std::vector<core23::Tensor>& get_core23_output_tensors() const { return output_tensors_; }
+
+  /*
+   * The other tensors that fprop or bprop use, if their memory is shared with other layers.
+   */
+  virtual std::vector<core23::Tensor> get_core23_workspace_tensors() const { return {}; }
+
   virtual std::vector<TensorBag2> get_tensors_for_non_trainable_params() {
     return std::vector<TensorBag2>();
   }
@@ -0,0 +1,101 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+#pragma once
+
+#include <cublasLt.h>
+#include <cuda_fp16.h>
+#include <cuda_fp8.h>
+
+#include <common.hpp>
+
+namespace HugeCTR {
+
+constexpr float FP8_E4M3_MAX_NORM = 448.0f;
+constexpr float FP8_E5M2_MAX_NORM = 57344.0f;
+// Number of iterations whose amax decides the scale of an FP8 tensor.
+constexpr int FP8_AMAX_HISTORY_LEN = 16;
+
+/**
+ * Delayed scaling state of an FP8 tensor, which lives in device memory so that the quantization
+ * kernels and cuBLASLt read the scales without a host round trip. A tensor is quantized with the
+ * scale of the amaxes of the previous iterations, while the amax of the current iteration is
+ * collected for the next update.
+ */
+struct Fp8ScalingState {
+  float amax_history[FP8_AMAX_HISTORY_LEN];
+  float amax;       // amax of the current iteration
+  float scale;      // fp8 = value * scale
+  float scale_inv;  // value = fp8 * scale_inv
+  float fp8_max;
+  int step;
+};
+
+// Scale 1 and an empty history.
+Fp8ScalingState make_fp8_scaling_state(float fp8_max);
+
+/**
+ * Pushes the amax of the current iteration of each state into its history, and sets the scale of
+ * the next iteration to fp8_max / amax, where amax is the max of the history.
+ */
+void update_fp8_scaling_states(Fp8ScalingState* states, int num_states, cudaStream_t stream);
+
+/**
+ * Quantizes the rows x cols row-major matrix in with the scale of state. The result goes to out
+ * and, if out_t is not nullptr, its transpose to out_t.
+ *
+ * @param relu_mask If not nullptr, in is first multiplied by (relu_mask > 0), the backward of
+ * ReLU.
+ * @param update_amax Whether to max-reduce the amax of in into state->amax.
+ * @param col_sum If not nullptr, the column sums of in are added to it, which gives the bias
+ * gradient when in is the gradient of a fully connected layer.
+ */
+template <typename Fp8T>
+void quantize_fp8(const __half* in, const __half* relu_mask, Fp8T* out, Fp8T* out_t, int64_t rows,
+                  int64_t cols, Fp8ScalingState* state, bool update_amax, float* col_sum,
+                  cudaStream_t stream);
+
+/**
+ * D = alpha * op(A) * B * scale_a * scale_b + beta * D in column-major order, where the FP8 A is
+ * k x m and transposed, the FP8 B is k x n, and D is m x n in FP16. Hopper and Ada only support
+ * FP8 GEMMs in this TN layout.
+ */
+struct CublasFp8Gemm {
+  cublasLtMatmulDesc_t cublas_op_desc = NULL;
+  cublasLtMatrixLayout_t cublas_mat_a_desc = NULL;
+  cublasLtMatrixLayout_t cublas_mat_b_desc = NULL;
+  cublasLtMatrixLayout_t cublas_mat_c_desc = NULL;
+  cublasLtMatmulPreference_t cublas_preference = NULL;
+  cublasLtMatmulAlgo_t algo;
+  size_t cublaslt_workspace_size = 1024 * 1024 * 8;
+  void* cublaslt_workspace = nullptr;
+
+  /**
+   * @param a_scale_inv, b_scale_inv Device pointers to the inverse scales of A and B.
+   * @param bias_ptr If not nullptr, the bias of the m rows of D is fused into the epilogue.
+   * @param fast_accum Whether to accumulate in the reduced precision of the FP8 tensor cores,
+   * which only suits the forward pass.
+   */
+  void init(int64_t m, int64_t n, int64_t k, cudaDataType a_type, cudaDataType b_type,
+            const float* a_scale_inv, const float* b_scale_inv, const __half* bias_ptr,
+            Activation_t act, bool fast_accum, cublasLtHandle_t cublaslt_handle);
+
+  void operator()(const void* mat_a, const void* mat_b, float beta, __half* mat_d,
+                  cublasLtHandle_t cublaslt_handle, cudaStream_t stream) const;
+
+  ~CublasFp8Gemm();
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,66 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+#pragma once
+
+#include <cublasLt.h>
+
+#include <common.hpp>
+
+namespace HugeCTR {
+
+/**
+ * Operand of a CublasGroupedGemm: a column-major rows x cols matrix per group, with the leading
+ * dim ld, and the groups stride elements apart. A stride of 0 shares the matrix among the groups.
+ */
+struct GroupedGemmOperand {
+  int64_t rows;
+  int64_t cols;
+  int64_t ld;
+  int64_t stride;
+};
+
+/**
+ * D_g = op_a(A_g) * op_b(B_g) + beta * D_g for each of the num_groups groups, in one cuBLASLt
+ * launch with a strided batch. If bias_ptr is not nullptr, the bias of the rows of D_g, which
+ * are bias_stride elements apart among the groups, is fused into the epilogue with act.
+ */
+struct CublasGroupedGemm {
+  cublasLtMatmulDesc_t cublas_op_desc = NULL;
+  cublasLtMatrixLayout_t cublas_mat_a_desc = NULL;
+  cublasLtMatrixLayout_t cublas_mat_b_desc = NULL;
+  cublasLtMatrixLayout_t cublas_mat_d_desc = NULL;
+  cublasLtMatmulPreference_t cublas_preference = NULL;
+  cublasLtMatmulAlgo_t algo;
+  size_t cublaslt_workspace_size = 1024 * 1024 * 8;
+  void* cublaslt_workspace = nullptr;
+
+  /**
+   * @param a, b, d The stored operands, so that a and b are transposed by op_a and op_b.
+   * @param data_type The type of all the operands, and of the bias.
+   * @param enable_tf32_compute Whether FP32 GEMMs may use TF32 tensor cores.
+   */
+  void init(cublasOperation_t op_a, cublasOperation_t op_b, const GroupedGemmOperand& a,
+            const GroupedGemmOperand& b, const GroupedGemmOperand& d, int num_groups,
+            cudaDataType data_type, bool enable_tf32_compute, const void* bias_ptr,
+            int64_t bias_stride, Activation_t act, cublasLtHandle_t cublaslt_handle);
+
+  void operator()(const void* mat_a, const void* mat_b, float beta, void* mat_d,
+                  cublasLtHandle_t cublaslt_handle, cudaStream_t stream) const;
+
+  ~CublasGroupedGemm();
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,83 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+#pragma once
+
+#include <trainable_layer.hpp>
+
+namespace HugeCTR {
+
+/**
+ * LayerNorm of residual + dropout(x), the post-normalization of a transformer block, in the
+ * fprop and bprop kernels of a single layer. A warp normalizes a row, which it keeps in
+ * registers if the hidden dim is at most 1024. The fprop saves the dropout mask as bits and the
+ * mean and rstd of each row, so that the bprop only reads the inputs, the output gradient and
+ * these, and writes the gradients of x and residual in place.
+ */
+template <typename T>
+class Core23TempFusedAddLayerNormLayer : public Core23TempTrainableLayer<T> {
+  using Base = Core23TempTrainableLayer<T>;
+
+ public:
+  struct Params {
+    double eps;         /**< small value to avoid divide-by-zero error*/
+    float dropout_rate; /**< 0 for no dropout*/
+  };
+  /**
+   * @param x_tensor the input tensor which dropout is applied to
+   * @param residual_tensor the residual which is added to dropout(x), with the same shape
+   * @param out_tensor the output tensor which has the same shape as the inputs
+   * @param seed the seed of the dropout masks
+   */
+  Core23TempFusedAddLayerNormLayer(
+      const core23::Tensor& x_tensor, const core23::Tensor& residual_tensor,
+      const core23::Tensor& out_tensor, const Params& params, uint64_t seed,
+      const std::shared_ptr<GPUResource>& gpu_resource,
+      std::vector<Initializer_t> initializer_types = std::vector<Initializer_t>());
+
+  void initialize() override;
+  void fprop(bool is_train) override;
+  void bprop() override;
+
+ private:
+  /**
+   * Gamma is initialized to 1s while Beta is 0ed.
+   */
+  std::unique_ptr<DataSimulator> get_default_initializer(const int index) override;
+
+  const Params params_;
+  const uint64_t seed_;
+  int64_t rows_;
+  int64_t hidden_dim_;
+  int num_warps_;
+  bool is_train_;
+
+  core23::Tensor gamma_;
+  core23::Tensor beta_;
+  core23::Tensor gamma_grad_;
+  core23::Tensor beta_grad_;
+
+  // 32 bit words of the dropout mask of each lane of each row, with the lanes innermost
+  core23::Tensor mask_;
+  core23::Tensor mean_;
+  core23::Tensor rstd_;
+  // gamma and beta gradients of the rows of each warp, which a second kernel sums up
+  core23::Tensor partial_gamma_grad_;
+  core23::Tensor partial_beta_grad_;
+  // Counts the training iterations on the device, for CUDA graphs to draw new dropout masks.
+  core23::Tensor iteration_;
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,71 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+#pragma once
+
+#include <layer.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+enum class FusedElementwiseOp_t { Add, Sub, Multiply, Relu, Sigmoid, Dropout };
+
+/**
+ * An op of the chain of a FusedElementwiseLayer. Its operands are the result of the previous op,
+ * except for the first op, and num_inputs input tensors of the layer starting at first_input. The
+ * result of the previous op is the operand at chain_pos among them.
+ */
+struct FusedElementwiseOp {
+  FusedElementwiseOp_t type;
+  int first_input;
+  int num_inputs;
+  int chain_pos;
+  float dropout_rate;
+};
+
+constexpr int FUSED_ELEMENTWISE_MAX_OPS = 16;
+constexpr int FUSED_ELEMENTWISE_MAX_INPUTS = 16;
+
+/**
+ * Layer which runs a chain of elementwise layers in one kernel, so that the intermediate tensors
+ * are neither written nor read. The bprop recomputes the chain from the inputs, which are intact
+ * until it writes their gradients, and backpropagates through it in the same kernel. All the
+ * tensors must have the same shape.
+ */
+template <typename T>
+class FusedElementwiseLayer : public Layer {
+ public:
+  /**
+   * @param ops The chain; dropout masks use a different seed for each layer and iteration.
+   */
+  FusedElementwiseLayer(const std::vector<core23::Tensor>& input_tensors,
+                        const core23::Tensor& output_tensor,
+                        const std::vector<FusedElementwiseOp>& ops, uint64_t seed,
+                        const std::shared_ptr<GPUResource>& gpu_resource);
+
+  void initialize() override;
+  void fprop(bool is_train) override;
+  void bprop() override;
+
+ private:
+  std::vector<FusedElementwiseOp> ops_;
+  uint64_t seed_;
+  // Counts the training iterations on the device, so that each replay of a CUDA graph draws new
+  // dropout masks. Left empty without Dropout ops.
+  core23::Tensor iteration_;
+  bool is_train_;
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,106 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+#pragma once
+
+#include <layers/functors/grouped_gemm_functors.hpp>
+#include <trainable_layer.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * The MLPs of num_experts same-shaped experts, as in MMoE and multi-task towers, with a GEMM per
+ * layer and pass for all the experts. The experts share the 2D input, so the first layer is a
+ * single GEMM of the concatenated kernels, and the deeper layers are strided batched cuBLASLt
+ * GEMMs. The activations of all the experts are [batch_size, num_experts, num_outputs], and the
+ * kernel of a layer is [input_size, num_experts * num_outputs], with the columns by expert.
+ * All the layers have a bias, the hidden layers use ReLU, and the last one uses act.
+ */
+template <typename T>
+class Core23TempGroupedMLPLayer : public Core23TempTrainableLayer<T> {
+ public:
+  /**
+   * @param bottom_tensor the input of all the experts, [batch_size, input_size]
+   * @param top_tensor the outputs, [batch_size, num_experts, num_outputs.back()]
+   * @param num_outputs the output size of each layer of an expert
+   * @param act the activation of the last layer, which is Relu or None
+   * @param skip_dgrad whether the gradient of the bottom is not needed
+   */
+  Core23TempGroupedMLPLayer(
+      const core23::Tensor& bottom_tensor, const core23::Tensor& top_tensor, int64_t num_experts,
+      const std::vector<int64_t>& num_outputs, Activation_t act,
+      const std::shared_ptr<GPUResource>& gpu_resource,
+      std::vector<Initializer_t> initializer_types = std::vector<Initializer_t>(),
+      bool skip_dgrad = false, bool enable_tf32_compute = false);
+
+  Core23TempGroupedMLPLayer(const Core23TempGroupedMLPLayer&) = delete;
+  Core23TempGroupedMLPLayer& operator=(const Core23TempGroupedMLPLayer&) = delete;
+
+  void initialize() override;
+  void fprop(bool is_train) override;
+  void bprop() override;
+
+  /*
+   * Interfaces for unit tests to debug
+   */
+  auto& get_kernel(int index) { return kernels_[index]; }
+  auto& get_bias(int index) { return biases_[index]; }
+  auto& get_kernel_grad(int index) { return kernels_grad_[index]; }
+  auto& get_bias_grad(int index) { return biases_grad_[index]; }
+
+ private:
+  std::unique_ptr<DataSimulator> get_uniform_initializer(const int index) override;
+  std::unique_ptr<DataSimulator> get_xavier_uniform_initializer(const int index) override;
+  std::unique_ptr<DataSimulator> get_xavier_norm_initializer(const int index) override;
+  std::unique_ptr<DataSimulator> get_default_initializer(const int index) override;
+
+  // The input size of each expert in layer i
+  int64_t get_input_size(int i) const {
+    return i == 0 ? this->input_tensors_[0].shape().size(1) : num_outputs_[i - 1];
+  }
+  const core23::Tensor& get_layer_input(int i) const {
+    return i == 0 ? this->input_tensors_[0] : hiddens_[i - 1];
+  }
+  const core23::Tensor& get_layer_output(int i) const {
+    return i == num_layers_ - 1 ? this->output_tensors_[0] : hiddens_[i];
+  }
+
+  const int64_t num_experts_;
+  const std::vector<int64_t> num_outputs_;
+  const int num_layers_;
+  const Activation_t act_;
+  const bool skip_dgrad_;
+  const bool enable_tf32_compute_;
+  int64_t batch_size_;
+
+  std::vector<core23::Tensor> kernels_;
+  std::vector<core23::Tensor> biases_;
+  std::vector<core23::Tensor> kernels_grad_;
+  std::vector<core23::Tensor> biases_grad_;
+
+  // The outputs of the hidden layers, which the bprop replaces with their gradients
+  std::vector<core23::Tensor> hiddens_;
+  // The gradient of a hidden layer before the ReLU is applied
+  core23::Tensor dgrad_scratch_;
+  // A copy of the top the bprop applies the ReLU of the last layer with
+  core23::Tensor last_out_;
+  // batch_size 1s, which reduce the gradients of the biases in a GEMM
+  core23::Tensor ones_;
+
+  std::vector<CublasGroupedGemm> fprop_gemms_, dgrad_gemms_, wgrad_gemms_, bgrad_gemms_;
+};
+
+}  // namespace HugeCTR
@@ -134,9 +134,36 @@ class Core23TempGRULayer : public Core23TempTrainableLayer<T> {
   Core23TempGRULayer(const core23::Tensor &in_tensor, const core23::Tensor &out_tensor,
                      int64_t hiddenSize, int64_t batch_size, int64_t SeqLength,
                      int64_t embedding_vec_size, const std::shared_ptr<GPUResource> &gpu_resource,
-                     std::vector<Initializer_t> initializer_types = std::vector<Initializer_t>());
+                     std::vector<Initializer_t> initializer_types = std::vector<Initializer_t>(),
+                     bool allow_mixed_precision_math = false);
+  /**
+   * Ctor of Core23TempGRULayer with variable sequence lengths.
+   * @param in_tensors the input tensor, optionally followed by a (batch_size, 1) tensor of the
+   * sequence length of each sample. The steps after the length of a sample are ignored and their
+   * outputs are filled with 0.
+   * @param allow_mixed_precision_math whether cuDNN may run the float GRU on half tensor cores
+   */
+  Core23TempGRULayer(const std::vector<core23::Tensor> &in_tensors,
+                     const core23::Tensor &out_tensor, int64_t hiddenSize, int64_t batch_size,
+                     int64_t SeqLength, int64_t embedding_vec_size,
+                     const std::shared_ptr<GPUResource> &gpu_resource,
+                     std::vector<Initializer_t> initializer_types = std::vector<Initializer_t>(),
+                     bool allow_mixed_precision_math = false);
+  ~Core23TempGRULayer() override;
+
+  Core23TempGRULayer(const Core23TempGRULayer &) = delete;
+  Core23TempGRULayer &operator=(const Core23TempGRULayer &) = delete;
+
+  bool is_persistent() const { return algo_ == CUDNN_RNN_ALGO_PERSIST_STATIC; }
 
  private:
+  cudnnStatus_t set_rnn_descriptor(cudnnRNNAlgo_t algo);
+  void set_data_descriptors();
+
+  bool variable_length_ = false;
+  cudnnRNNAlgo_t algo_ = CUDNN_RNN_ALGO_STANDARD;
+  cudnnMathType_t math_type_ = CUDNN_TENSOR_OP_MATH;
+  T padding_fill_ = T(0);
   int *seqLengthArray = nullptr;
   int *devSeqLengthArray = nullptr;
   void *weightSpace = nullptr;
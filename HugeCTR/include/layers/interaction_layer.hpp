@@ -47,6 +47,12 @@ class InteractionLayer : public Layer {
 
   bool separate_Y_and_dY_;
 
+  /*
+   * Whether the FP32 layer computes only the lower triangle of the interactions in one kernel that
+   * writes the output directly, instead of the concat, batched GEMM and gather of the generic path.
+   */
+  bool use_fused_fp32_ = false;
+
   Tensors2<T> internal_tensors_;
   std::vector<core23::Tensor> intermediate_tensors_;
 
@@ -106,6 +112,11 @@ class InteractionLayer : public Layer {
    */
   void bprop_generic();
   void bprop() override;
+  /**
+   * The fused forward and backward passes, see use_fused_fp32_
+   */
+  void fprop_fused(bool is_train);
+  void bprop_fused();
   Tensor2<T>& get_internal(size_t i) { return internal_tensors_[i]; };
   core23::Tensor& get_intermediate(int64_t i) { return intermediate_tensors_[i]; };
 };
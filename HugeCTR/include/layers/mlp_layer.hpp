@@ -20,6 +20,7 @@
 
 #include <functional>
 #include <layer.hpp>
+#include <layers/functors/fp8_gemm_functors.hpp>
 #include <layers/functors/fused_fc_layer_functors.hpp>
 #include <trainable_layer.hpp>
 #include <vector>
@@ -118,6 +119,7 @@ class Core23TempMLPLayer : public Core23TempTrainableLayer<T> {
   bool fuse_wb_;
   bool enable_tf32_compute_;
   bool skip_head_dgrad_;
+  bool use_fp8_;
 
   bool event_overlap_created_;
   cudaEvent_t event_overlap_;
@@ -125,6 +127,25 @@ class Core23TempMLPLayer : public Core23TempTrainableLayer<T> {
   std::vector<CublasFusedFCLayerAlgo<T>> layer_algo_;
   FusedFCLayerFunctors<T> layer_functors_;
 
+  /*
+   * FP8 GEMMs. Each layer keeps the E4M3 bottom and kernel and the E5M2 top gradient, each with
+   * its transpose, as the transposes are the B and A operands of the wgrad and fprop GEMMs.
+   * fp8_states_ holds the scaling states of the bottom, kernel and top gradient of each layer.
+   */
+  std::vector<core23::Tensor> fp8_bottoms_, fp8_bottoms_t_;
+  std::vector<core23::Tensor> fp8_kernels_, fp8_kernels_t_;
+  std::vector<core23::Tensor> fp8_grad_tops_, fp8_grad_tops_t_;
+  std::vector<core23::Tensor> fp8_db_sums_;
+  core23::Tensor fp8_states_;
+  std::vector<CublasFp8Gemm> fp8_fprop_gemms_, fp8_wgrad_gemms_, fp8_dgrad_gemms_;
+
+  Fp8ScalingState* get_fp8_state(int layer, int operand) {
+    return fp8_states_.data<Fp8ScalingState>() + layer * 3 + operand;
+  }
+  void fprop_fp8(bool is_train);
+  void bprop_fp8();
+  void initialize_fp8();
+
   std::unique_ptr<DataSimulator> get_uniform_initializer(const int index) override;
   std::unique_ptr<DataSimulator> get_xavier_uniform_initializer(const int index) override;
   std::unique_ptr<DataSimulator> get_xavier_norm_initializer(const int index) override;
@@ -138,7 +159,7 @@ class Core23TempMLPLayer : public Core23TempTrainableLayer<T> {
                      const std::vector<Activation_t>& acts, const std::vector<bool>& use_bias,
                      std::vector<Initializer_t> initializer_types = std::vector<Initializer_t>(),
                      bool skip_head_dgrad = false, bool async_wgrad = false, bool fuse_wb = false,
-                     bool enable_tf32_compute = false);
+                     bool enable_tf32_compute = false, bool use_fp8 = false);
 
   Core23TempMLPLayer(const Core23TempMLPLayer& C) = delete;
   Core23TempMLPLayer& operator=(const Core23TempMLPLayer&);
@@ -306,6 +306,11 @@ class Core23TempMultiCrossLayer : public Core23TempTrainableLayer<T> {
   bool async_wgrad_ = false;
   cudaStream_t wgrad_stream_;
   cudaEvent_t event_fork_;
+  // x0 is read by every cell of the stack, so it is kept in the persisting part of the L2 while
+  // the stack runs. Empty if the device has no persisting L2.
+  cudaAccessPolicyWindow x0_window_{};
+
+  void set_x0_window_(cudaStream_t stream, bool persisting);
 
  public:
   /**
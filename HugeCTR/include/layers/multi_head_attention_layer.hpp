@@ -31,7 +31,8 @@ class MultiHeadAttentionLayer : public Layer {
   MultiHeadAttentionLayer(const std::vector<core23::Tensor>& input_tensors,
                           std::vector<core23::Tensor>& output_tensors, int num_attention_heads,
                           bool transpose_b, const std::shared_ptr<GPUResource>& gpu_resource,
-                          bool use_mixed_precision, bool enable_tf32_compute);
+                          bool use_mixed_precision, bool enable_tf32_compute,
+                          bool recompute_activations = false);
   /**
    * Ctor of MultiHeadAttentionLayer.
    * @param in_tensor the input tensor
@@ -57,6 +58,12 @@ class MultiHeadAttentionLayer : public Layer {
    */
   void bprop() override;
 
+  /*
+   * With recompute_activations, the intermediates are in the recompute workspace, where bprop
+   * recomputes them from the inputs instead of keeping them from fprop.
+   */
+  std::vector<core23::Tensor> get_core23_workspace_tensors() const override;
+
   std::vector<T>& get_debug_vector() { return debug_vector_; };
 
  private:
@@ -72,12 +79,21 @@ class MultiHeadAttentionLayer : public Layer {
    * stores the axis.
    */
 
+  // Steps 1 to 3 of fprop, up to the softmax of the scores.
+  void fprop_scores_();
+  void copy_fprop_activations_();
+  // Flash attention with a tiled online softmax, for heads of at most 128 dims.
+  void fused_fprop_();
+  void fused_bprop_();
+
   bool enable_tf32_compute_;
   bool use_mixed_precision_;
   int64_t num_;
   int64_t dims_;
   bool transpose_b_;
   int64_t num_head_;
+  bool recompute_activations_;
+  bool use_fused_;
   Tensor2<T> fprop_inputA_;
   Tensor2<T> query_buf_;
   Tensor2<T> key_buf_;
@@ -91,6 +107,8 @@ class MultiHeadAttentionLayer : public Layer {
   core23::Tensor attention_value_4d_;
   core23::Tensor attention_score_4d_;
   core23::Tensor attention_softmax_4d_;
+  core23::Tensor softmax_lse_tensor_;
+  core23::Tensor softmax_delta_tensor_;
 
   // masked_softmax_layer_ xor softmax_layer_
   std::unique_ptr<core23::MaskedSoftmaxLayer<T>> masked_softmax_layer_;
@@ -18,6 +18,7 @@
 #include <functional>
 #include <general_buffer2.hpp>
 #include <regularizer.hpp>
+#include <utility>
 #include <vector>
 
 namespace HugeCTR {
@@ -31,9 +32,13 @@ class ILoss {
   virtual int get_device_id() const = 0;
   virtual float regularizer_compute_rterm() = 0;
   virtual void regularizer_initialize_wgrad(bool is_train) = 0;
+  // Leaves the wgrad term of the regularizer to the optimizer if fused, and returns the type and
+  // coefficient it needs for that, see FusedUpdateParams.
+  virtual std::pair<Regularizer_t, float> fuse_regularizer_wgrad(bool fused) = 0;
 
   virtual float get_label_weight() const = 0;
   virtual void set_label_weight(float new_weight) = 0;
+  virtual void set_loss_scale(const float* loss_scale) = 0;
 
   virtual const Tensors2<float>& get_loss_tensors_old() const = 0;
   virtual const std::vector<core23::Tensor>& get_loss_tensors() const = 0;
@@ -56,6 +61,7 @@ class Loss : public ILoss {
   std::shared_ptr<GPUResource> gpu_resource_;
   int total_gpu_count_;
   float scaler_;
+  const float* loss_scale_{nullptr};
 
   /**
    * label_tensors_old_: stores the label information during the training process.
@@ -112,6 +118,7 @@ class Loss : public ILoss {
  protected:
   bool gen_loss_summary_;
   int get_total_gpu_count() const { return total_gpu_count_; }
+  const float* get_loss_scale() const { return loss_scale_; }
   const GPUResource& get_gpu() const { return *gpu_resource_; }
 
   bool use_old_tensor{false};
@@ -149,10 +156,17 @@ class Loss : public ILoss {
 
   float regularizer_compute_rterm();
   void regularizer_initialize_wgrad(bool is_train);
+  std::pair<Regularizer_t, float> fuse_regularizer_wgrad(bool fused) override;
 
   float get_label_weight() const override { return label_weight; }
   void set_label_weight(float new_weight) override { label_weight = new_weight; }
 
+  /**
+   * Scale the gradients by the float at loss_scale on the device instead of the scaler, so that
+   * the scale can be adjusted without rebuilding the network. nullptr restores the scaler.
+   */
+  void set_loss_scale(const float* loss_scale) override { loss_scale_ = loss_scale; }
+
   const Tensors2<float>& get_loss_tensors_old() const override { return loss_tensors_old_; }
   const std::vector<core23::Tensor>& get_loss_tensors() const override { return loss_tensors_; }
 };
@@ -217,4 +231,33 @@ class MultiCrossEntropyLoss : public Loss<T> {
                         float scaler = 1.f, bool gen_loss_summary = true);
 };
 
+/**
+ * Softmax loss of retrieval models with in-batch negatives. The input of each sample is its query
+ * embedding followed by its item embedding. Each query is scored against the items of all the
+ * samples in the local batch by their dot products, and its own item is the positive. The
+ * batch x batch logits are computed tile by tile in both passes, and never stored.
+ *
+ * Column 0 of the label marks the samples that count as queries. If the label has a second
+ * column, it holds the sampling probability of the item, whose log is subtracted from the logits
+ * of the item to correct the sampling bias. In evaluation the input is left unchanged, so that the
+ * in-batch ranking metrics can use it as their prediction.
+ */
+template <typename T>
+class InBatchSoftmaxLoss : public Loss<T> {
+ private:
+  int label_dim_;
+  core23::Tensor lse_;
+  core23::Tensor grad_;
+
+ public:
+  void do_compute(T* input, const float* label, float* loss, int batch_size, int feature_dim,
+                  float scaler, float rterm, float label_weight, bool is_train,
+                  cudaStream_t stream) override final;
+  InBatchSoftmaxLoss(const core23::Tensor& label_tensor, const core23::Tensor& input_tensor,
+                     const core23::Tensor& loss_tensor,
+                     const std::shared_ptr<Regularizer<T>>& regularizer,
+                     const std::shared_ptr<GPUResource>& gpu_resource, int total_gpu_count,
+                     float scaler = 1.f, bool gen_loss_summary = true);
+};
+
 }  // namespace HugeCTR
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <condition_variable>
+#include <core23/details/virtual_cuda_allocator.hpp>
 #include <core23/tensor.hpp>
 #include <general_buffer2.hpp>
 #include <map>
@@ -33,7 +34,7 @@ namespace metrics {
 
 using CountType = u_int32_t;
 enum class RawType { Loss, Pred, Label };
-enum class Type { AUC, AverageLoss, HitRate, NDCG, SMAPE };
+enum class Type { AUC, AverageLoss, HitRate, NDCG, SMAPE, ApproxAUC, RecallAtK, NDCGAtK };
 
 using RawMetricMap = std::map<RawType, TensorBag2>;
 using Core23RawMetricMap = std::map<RawType, core23::Tensor>;
@@ -46,12 +47,38 @@ void get_raw_metric_as_host_float_tensor(Core23RawMetricMap metric_map, RawType
 void get_raw_metric_as_host_float_tensor(RawMetricMap metric_map, RawType raw_type,
                                          bool mixed_precision, float* rst, size_t num);
 
+// Work of the metrics that the fused evaluation epilogue does in one pass over the predictions.
+// Each part is taken by at most one metric.
+struct FusedMetricTerms {
+  bool loss = false;
+  bool hit_rate = false;
+  int num_hit_rate_samples = 0;
+  bool smape = false;
+  int num_smape_samples = 0;
+  bool histograms = false;
+  int num_histogram_elems = 0;
+  int num_classes = 1;
+  int num_bins = 0;
+  float pred_min = 0.0f;
+  float pred_max = 1.0f;
+  CountType* pos_histograms = nullptr;
+  CountType* neg_histograms = nullptr;
+};
+
+// Sums of the fused evaluation epilogue on one GPU, which are copied to the host at once.
+struct FusedMetricSums {
+  float loss;
+  int hit_rate_checked;
+  int hit_rate_hits;
+  float smape_error;
+};
+
 class Metric {
  public:
   static std::unique_ptr<Metric> Create(const Type type, bool use_mixed_precision,
                                         int batch_size_eval, int n_batches, int label_dim,
                                         const std::shared_ptr<ResourceManager>& resource_manager,
-                                        bool use_old_tensor = false);
+                                        bool use_old_tensor = false, int top_k = 10);
   Metric();
   virtual ~Metric();
   virtual void local_reduce(int local_gpu_id, RawMetricMap raw_metrics) = 0;
@@ -65,12 +92,42 @@ class Metric {
   virtual std::string name() const = 0;
   void set_current_batch_size(int batch_size) { current_batch_size_ = batch_size; }
 
+  // Adds the work of local_reduce to the terms of the fused evaluation epilogue, and returns
+  // whether it did. Otherwise the metric reduces by itself.
+  virtual bool add_fused_terms(int local_gpu_id, FusedMetricTerms& terms) { return false; }
+  // Takes the sums of the fused evaluation epilogue in place of local_reduce.
+  virtual void take_fused_sums(int local_gpu_id, const FusedMetricSums& sums) {}
+
  protected:
   int current_batch_size_;
 };
 
 using Metrics = std::vector<std::unique_ptr<metrics::Metric>>;
 
+/**
+ * Evaluation epilogue that runs local_reduce of all metrics. The loss, HitRate, SMAPE and the
+ * ApproxAUC histograms are computed by one kernel, which reads each prediction and label once,
+ * and their sums come back to the host with one copy. The other metrics reduce by themselves.
+ */
+class FusedLocalReduce {
+ public:
+  // The metrics are not owned, and must outlive the epilogue.
+  FusedLocalReduce(const std::vector<Metric*>& metrics,
+                   const std::shared_ptr<ResourceManager>& resource_manager);
+  ~FusedLocalReduce();
+
+  FusedLocalReduce(const FusedLocalReduce&) = delete;
+  FusedLocalReduce& operator=(const FusedLocalReduce&) = delete;
+
+  void local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics);
+
+ private:
+  std::vector<Metric*> metrics_;
+  std::shared_ptr<ResourceManager> resource_manager_;
+  std::vector<FusedMetricSums*> d_sums_;
+  std::vector<FusedMetricSums*> h_sums_;
+};
+
 template <typename T>
 class AverageLoss : public Metric {
  public:
@@ -82,6 +139,8 @@ class AverageLoss : public Metric {
   void global_reduce(int n_nets) override;
   float finalize_metric() override;
   std::string name() const override { return "AverageLoss"; };
+  bool add_fused_terms(int local_gpu_id, FusedMetricTerms& terms) override;
+  void take_fused_sums(int local_gpu_id, const FusedMetricSums& sums) override;
 
  private:
   std::shared_ptr<ResourceManager> resource_manager_;
@@ -103,6 +162,8 @@ class HitRate : public Metric {
   void global_reduce(int n_nets) override;
   float finalize_metric() override;
   std::string name() const override { return "HitRate"; };
+  bool add_fused_terms(int local_gpu_id, FusedMetricTerms& terms) override;
+  void take_fused_sums(int local_gpu_id, const FusedMetricSums& sums) override;
 
  private:
   void free_all();
@@ -133,6 +194,8 @@ class SMAPE : public Metric {
   void global_reduce(int n_nets) override;
   float finalize_metric() override;
   std::string name() const override { return "SMAPE"; }
+  bool add_fused_terms(int local_gpu_id, FusedMetricTerms& terms) override;
+  void take_fused_sums(int local_gpu_id, const FusedMetricSums& sums) override;
 
  private:
   void free_all();
@@ -165,19 +228,9 @@ class ReallocBuffer {
   size_t num_elements_;
   T* ptr_;
 
-  // Explicit virtual memory management
-  CUmemAllocationProp prop_;
+  // MMAP buffers grow in place within the virtual addresses that the allocator reserves for them.
   const std::vector<CUmemAccessDesc>* access_desc_;  // Virtual memory access descriptor
-  std::vector<std::pair<CUmemGenericAllocationHandle, size_t>> pm_handles_;
-  std::vector<std::pair<CUdeviceptr, size_t>> vm_ranges_;    // Virtual allocation info
-  std::vector<std::pair<CUdeviceptr, size_t>> mmap_ranges_;  // Memmap VA->PA info
-
-  size_t chunk_size_;
-  void get_aligned_size(size_t& size) const {
-    size = ((size + chunk_size_ - 1) / chunk_size_) * chunk_size_;
-  }
-  void realloc_ptr_mmap(void** ptr, size_t old_size, size_t new_size);
-  void release_mmap_memory();
+  std::shared_ptr<core23::VirtualCUDAAllocator> vm_allocator_;
 };
 
 class AUCStorageOld {
@@ -456,6 +509,90 @@ class AUC : public Metric {
   std::vector<float> per_class_aucs_;
 };
 
+/**
+ * AUC from histograms of the predictions of the positive and of the negative samples of each
+ * class. The histograms take O(num_bins) memory however many samples are evaluated, and are summed
+ * over all GPUs by one all-reduce. The samples in the same bin count as ties, so the error is at
+ * most half of the fraction of positive-negative pairs that share a bin.
+ */
+template <typename T>
+class ApproxAUC : public Metric {
+ public:
+  using PredType = T;
+  using LabelType = float;
+  ApproxAUC(int batch_size_per_gpu, int label_dim,
+            const std::shared_ptr<ResourceManager>& resource_manager);
+  ~ApproxAUC() override;
+
+  void local_reduce(int local_gpu_id, RawMetricMap raw_metrics) override;
+  void local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) override;
+  void global_reduce(int n_nets) override;
+  float finalize_metric() override;
+  std::string name() const override { return "ApproxAUC"; };
+  std::vector<float> get_per_class_metric() const override { return per_class_aucs_; }
+  bool add_fused_terms(int local_gpu_id, FusedMetricTerms& terms) override;
+
+ private:
+  void update_histograms(int local_gpu_id, const PredType* preds, const LabelType* labels);
+
+  const float pred_min_ = 0.0f;
+  const float pred_max_ = 1.0f;
+  const int num_bins_ = 1 << 20;
+
+  std::shared_ptr<ResourceManager> resource_manager_;
+  int batch_size_per_gpu_;
+  size_t num_classes_;
+  int num_local_gpus_;
+
+  // Per local GPU, the num_classes_ histograms of the positive samples followed by the ones of
+  // the negative samples.
+  std::vector<CountType*> histograms_;
+  std::vector<CountType> h_histograms_;
+  std::vector<float> per_class_aucs_;
+};
+
+/**
+ * Recall@K or NDCG@K of a two-tower retrieval model with in-batch negatives. The predictions of a
+ * sample are its query embedding followed by its item embedding, of label_dim / 2 elements each.
+ * Each query is scored by dot product against all items of the batch on its GPU, and its own item
+ * is the only relevant one, so both metrics only depend on the rank of that item. A tiled kernel
+ * counts the items that score higher without storing the scores, so nothing is sorted or copied
+ * to the host before finalize_metric. Queries whose first label is 0 have no positive item and
+ * are skipped.
+ */
+template <typename T>
+class InBatchRanking : public Metric {
+ public:
+  using PredType = T;
+  using LabelType = float;
+  InBatchRanking(Type type, int top_k, int batch_size_per_gpu, int label_dim,
+                 const std::shared_ptr<ResourceManager>& resource_manager);
+  ~InBatchRanking() override;
+
+  void local_reduce(int local_gpu_id, RawMetricMap raw_metrics) override;
+  void local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) override;
+  void global_reduce(int n_nets) override;
+  float finalize_metric() override;
+  std::string name() const override;
+
+ private:
+  void update_ranks(int local_gpu_id, const PredType* preds, const LabelType* labels);
+
+  const Type type_;
+  const int top_k_;
+  std::shared_ptr<ResourceManager> resource_manager_;
+  int batch_size_per_gpu_;
+  int label_dim_;
+  int num_local_gpus_;
+
+  // Per local GPU, the score of the relevant item of each query, and the number of items that
+  // rank above it.
+  std::vector<float*> pos_scores_;
+  std::vector<int*> ranks_;
+  // Per local GPU, the sum of the metric over the queries, and their number.
+  std::vector<double*> sums_;
+};
+
 class NDCGStorageOld {
  public:
   void alloc_main(size_t num_local_samples, size_t num_bins, size_t num_partitions,
@@ -29,25 +29,24 @@ using WeightHalfTensors = core23::TensorContainer<__half, 1, 1>;
 template <typename T>
 using WgradTensors = core23::TensorContainer<T, 1, 1>;
 
+template <typename DType, typename Range>
+std::vector<core23::Tensor> get_trainable_tensor_vector(Layer* layer, Range range) {
+  if (auto trainable_layer = dynamic_cast<Core23TempTrainableLayer<DType>*>(layer)) {
+    return range(trainable_layer);
+  }
+  if (auto trainable_layer = dynamic_cast<Core23TempTrainableLayer<DType, true>*>(layer)) {
+    return range(trainable_layer);
+  }
+  return {};
+}
+
 template <typename DType, typename Range>
 std::vector<core23::Tensor> get_trainable_tensor_vector(
     const std::vector<std::unique_ptr<Layer>>& layers, Range range) {
   std::vector<core23::Tensor> param_tensors;
-  auto op = [&param_tensors, range](auto trainable_layer) {
-    if (trainable_layer) {
-      for (auto& param_tensor : range(trainable_layer)) {
-        param_tensors.push_back(param_tensor);
-      }
-      return true;
-    } else {
-      return false;
-    }
-  };
   for (auto& layer : layers) {
-    auto trainable_layer = dynamic_cast<Core23TempTrainableLayer<DType>*>(layer.get());
-    if (!op(trainable_layer)) {
-      auto trainable_layer = dynamic_cast<Core23TempTrainableLayer<DType, true>*>(layer.get());
-      op(trainable_layer);
+    for (auto& param_tensor : get_trainable_tensor_vector<DType>(layer.get(), range)) {
+      param_tensors.push_back(param_tensor);
     }
   }
   return param_tensors;
@@ -54,6 +54,7 @@ struct AdamOptHyperParams {
   float beta1 = 0.9f;
   float beta2 = 0.999f;
   float epsilon = 1e-7f;
+  bool half_state = false;  // Keep the moments of embedding tables in FP16.
 
   inline float bias() const {
     return std::sqrt(1 - std::pow(beta2, times)) / (1 - std::pow(beta1, times));
@@ -61,7 +62,7 @@ struct AdamOptHyperParams {
 
   bool operator==(const AdamOptHyperParams& other) const {
     return (times == other.times) && (beta1 == other.beta1) && (beta2 == other.beta2) &&
-           (epsilon == other.epsilon);
+           (epsilon == other.epsilon) && (half_state == other.half_state);
   }
 
   bool operator!=(const AdamOptHyperParams& other) const { return !(*this == other); }
@@ -85,9 +86,11 @@ struct AdaGradOptHyperParams {
 
   float initial_accu_value = 0.f;
   float epsilon = 1e-7f;
+  bool row_wise = false;  // Keep a single accumulator per row of embedding tables.
 
   bool operator==(const AdaGradOptHyperParams& other) const {
-    return (initial_accu_value == other.initial_accu_value) && (epsilon == other.epsilon);
+    return (initial_accu_value == other.initial_accu_value) && (epsilon == other.epsilon) &&
+           (row_wise == other.row_wise);
   }
 
   bool operator!=(const AdaGradOptHyperParams& other) const { return !(*this == other); }
@@ -125,6 +128,40 @@ struct SGDOptHyperParams {
   bool operator!=(const SGDOptHyperParams& other) const { return !(*this == other); }
 };
 
+// LAMB (arXiv:1904.00962), for the dense layers only
+struct LAMBOptHyperParams {
+  static constexpr size_t num_parameters_per_weight = 2;
+
+  float beta1 = 0.9f;
+  float beta2 = 0.999f;
+  float epsilon = 1e-6f;
+  float weight_decay = 0.01f;
+
+  bool operator==(const LAMBOptHyperParams& other) const {
+    return (beta1 == other.beta1) && (beta2 == other.beta2) && (epsilon == other.epsilon) &&
+           (weight_decay == other.weight_decay);
+  }
+
+  bool operator!=(const LAMBOptHyperParams& other) const { return !(*this == other); }
+};
+
+// LARS (arXiv:1708.03888) with momentum, for the dense layers only
+struct LARSOptHyperParams {
+  static constexpr size_t num_parameters_per_weight = 1;
+
+  float momentum = 0.9f;
+  float trust_coefficient = 0.001f;
+  float epsilon = 1e-7f;
+  float weight_decay = 0.f;
+
+  bool operator==(const LARSOptHyperParams& other) const {
+    return (momentum == other.momentum) && (trust_coefficient == other.trust_coefficient) &&
+           (epsilon == other.epsilon) && (weight_decay == other.weight_decay);
+  }
+
+  bool operator!=(const LARSOptHyperParams& other) const { return !(*this == other); }
+};
+
 // TODO: use union type should be better ???
 struct OptHyperParams {
   FtrlOptHyperParams ftrl;
@@ -134,11 +171,14 @@ struct OptHyperParams {
   MomentumSGDOptHyperParams momentum;
   NesterovOptHyperParams nesterov;
   SGDOptHyperParams sgd;
+  LAMBOptHyperParams lamb;
+  LARSOptHyperParams lars;
 
   bool operator==(const OptHyperParams& other) const {
     return (ftrl == other.ftrl) && (adam == other.adam) && (rmsprop == other.rmsprop) &&
            (adagrad == other.adagrad) && (momentum == other.momentum) &&
-           (nesterov == other.nesterov) && (sgd == other.sgd);
+           (nesterov == other.nesterov) && (sgd == other.sgd) && (lamb == other.lamb) &&
+           (lars == other.lars);
   }
 
   bool operator!=(const OptHyperParams& other) const { return !(*this == other); }
@@ -169,6 +209,10 @@ struct OptParams {
         return NesterovOptHyperParams::num_parameters_per_weight;
       case Optimizer_t::SGD:
         return SGDOptHyperParams::num_parameters_per_weight;
+      case Optimizer_t::LAMB:
+        return LAMBOptHyperParams::num_parameters_per_weight;
+      case Optimizer_t::LARS:
+        return LARSOptHyperParams::num_parameters_per_weight;
       default:
         HCTR_OWN_THROW(Error_t::NotInitialized, "OptParams not correctly initialized.");
         return 0;
@@ -177,6 +221,26 @@ struct OptParams {
 
   inline size_t num_parameters_per_weight() const { return num_parameters_per_weight(optimizer); }
 
+  // Lazy Adam of the embedding collection tables, which keeps the last step of each row, and decays
+  // the moments of a row over the steps that skipped it.
+  inline bool is_lazy_adam() const {
+    return optimizer == Optimizer_t::Adam && update_type == Update_t::LazyGlobal;
+  }
+
+  // Bytes of the optimizer states of an embedding vector of ev_size elements. Row-wise AdaGrad
+  // keeps a single accumulator per vector, Adam can keep its moments in FP16, and lazy Adam adds
+  // an int32 step counter.
+  inline size_t state_bytes_per_row(size_t ev_size) const {
+    if (optimizer == Optimizer_t::AdaGrad && hyperparams.adagrad.row_wise) {
+      return sizeof(float);
+    }
+    const size_t state_size{optimizer == Optimizer_t::Adam && hyperparams.adam.half_state
+                                ? sizeof(__half)
+                                : sizeof(float)};
+    return ev_size * num_parameters_per_weight() * state_size +
+           (is_lazy_adam() ? sizeof(int32_t) : 0);
+  }
+
   bool operator==(const OptParams& other) const {
     return (optimizer == other.optimizer) && (lr == other.lr) &&
            (hyperparams == other.hyperparams) && (update_type == other.update_type) &&
@@ -197,6 +261,18 @@ class OptParamsPy {
   OptParamsPy(Optimizer_t optimizer_type, Update_t update_t, OptHyperParams opt_hyper_params);
 };
 
+/**
+ * Work that the update kernels of the dense optimizers do in their pass over the weights, which
+ * would otherwise read the weights once more each: the wgrad term of an L1 or L2 regularizer,
+ * regularizer_coefficient * sign(w_i) or regularizer_coefficient * w_i, which is added to the wgrad
+ * before its division by the scaler, and the FP16 copy of the updated weights.
+ */
+struct FusedUpdateParams {
+  Regularizer_t regularizer;
+  float regularizer_coefficient;
+  __half* weight_half;  // nullptr without an FP16 copy
+};
+
 /**
  * @brief Base class for all optimizers
  */
@@ -296,6 +372,41 @@ class Optimizer {
     gpu_learning_rate_scheduler_ = sched;
   }
 
+  /**
+   * The learning rate of the update kernels, which scale get_host_learning_rate() by the float at
+   * get_device_learning_rate() with scale_by_device_lr(). With a GPU scheduler, the host part is 1
+   * and the learning rate is only read on the device, so that the update can be graph captured.
+   */
+  float get_host_learning_rate() const { return gpu_learning_rate_scheduler_ ? 1.f : lr_; }
+  const float* get_device_learning_rate() const {
+    return gpu_learning_rate_scheduler_ ? gpu_learning_rate_scheduler_->get_learning_rate()
+                                        : nullptr;
+  }
+
+  /**
+   * Skip the updates while the int at skip_update on the device is not 0, e.g. after an overflow
+   * of the scaled gradients. nullptr never skips them.
+   */
+  void set_skip_update_flag(const int* skip_update) { skip_update_ = skip_update; }
+
+  /**
+   * Adds the wgrad term of the regularizer of the network in update(), see FusedUpdateParams.
+   * Regularizer_t::None stops it.
+   */
+  void set_fused_regularizer(Regularizer_t regularizer, float coefficient) {
+    fused_regularizer_ = regularizer;
+    fused_regularizer_coefficient_ = coefficient;
+  }
+
+  /**
+   * Makes update() also write the FP16 copies of the weights, which the layers read in mixed
+   * precision, so that the network doesn't convert them before each forward.
+   */
+  void set_weight_half_tensors(const WeightHalfTensors& weight_half_tensors) {
+    fused_weight_half_tensors_ = weight_half_tensors;
+  }
+  virtual bool updates_weight_half() const { return fused_weight_half_tensors_.has_value(); }
+
   const Optimizer_t& get_optimizer_type() { return optimizer_type_; }
 
  protected:
@@ -305,10 +416,21 @@ class Optimizer {
   float lr_;  // learning rate
   const float scaler_;
   Optimizer_t optimizer_type_;
+  const int* skip_update_{nullptr};
 
   std::shared_ptr<GpuLearningRateScheduler> gpu_learning_rate_scheduler_;
 
+  Regularizer_t fused_regularizer_{Regularizer_t::None};
+  float fused_regularizer_coefficient_{0.f};
+  std::optional<WeightHalfTensors> fused_weight_half_tensors_;
+
   int get_device_id() const { return gpu_resource_->get_device_id(); }
+
+  FusedUpdateParams get_fused_update_params() {
+    __half* weight_half =
+        fused_weight_half_tensors_ ? fused_weight_half_tensors_->flatten().data() : nullptr;
+    return {fused_regularizer_, fused_regularizer_coefficient_, weight_half};
+  }
 };
 
 struct SparseEmbeddingHashParams;
@@ -359,6 +481,7 @@ class EmbeddingOptimizer {
                                                                 counter of the count of hash table
                                                                 value indexes in update_params(). */
   SparseEmbeddingHashParams& param;
+  std::shared_ptr<GpuLearningRateScheduler> lr_sched_;
 
  public:
   OptimizerTensor<TypeEmbeddingComp> opt_tensors_;
@@ -370,6 +493,11 @@ class EmbeddingOptimizer {
 
   void reset(GPUResource const& local_gpu) { initialize(local_gpu); }
 
+  // Reads the learning rate of the updates from the device memory of sched.
+  void set_learning_rate_scheduler(const std::shared_ptr<GpuLearningRateScheduler>& sched) {
+    lr_sched_ = sched;
+  }
+
   void update(size_t batch_size, size_t slot_num, size_t embedding_vec_size,
               size_t max_vocabulary_size_per_gpu, size_t nnz,
               const Tensor2<TypeHashKey>& row_offset, Tensor2<size_t>& hash_value_index,
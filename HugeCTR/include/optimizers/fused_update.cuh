@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optimizer.hpp>
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+// Adds the wgrad term of the fused regularizer of weight wi to its wgrad gi, which is still scaled.
+__forceinline__ __device__ float add_fused_regularizer(const FusedUpdateParams& params, float gi,
+                                                       float wi) {
+  switch (params.regularizer) {
+    case Regularizer_t::L1:
+      return gi + (wi > 0.f ? params.regularizer_coefficient : -params.regularizer_coefficient);
+    case Regularizer_t::L2:
+      return gi + params.regularizer_coefficient * wi;
+    default:
+      return gi;
+  }
+}
+
+// Stores the updated weight i, and its FP16 copy if there is one.
+__forceinline__ __device__ void store_fused_weight(const FusedUpdateParams& params, float* weight,
+                                                   size_t i, float wi) {
+  weight[i] = wi;
+  if (params.weight_half) {
+    params.weight_half[i] = __float2half(wi);
+  }
+}
+
+}  // namespace HugeCTR
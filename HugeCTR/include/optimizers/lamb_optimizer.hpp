@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optimizers/layer_wise_optimizer.hpp>
+
+namespace HugeCTR {
+
+/**
+ * LAMB optimizer of the dense layers
+ */
+template <typename T>
+class LAMBOptimizer : public LayerWiseOptimizer {
+ public:
+  /**
+   * Constructor of LAMBOptimizer.
+   * names of hyper-parameters are the same as in Algorithm 2 of LAMB paper (arXiv:1904.00962)
+   * @param weight_tensors a list of dense layer weight tensors
+   * @param wgrad_tensors gradient for weight tensors
+   * @param gpu_resource the GPU where update kernel is launched
+   * @param learning_rate learning rate, eta in LAMB paper
+   * @param beta1 beta1 in LAMB paper
+   * @param beta2 beta2 in LAMB paper
+   * @param epsilon epsilon in LAMB paper
+   * @param weight_decay weight decay rate, lambda in LAMB paper
+   */
+  LAMBOptimizer(std::optional<WeightTensors> weight_tensors,
+                std::optional<WgradTensors<T>> wgrad_tensors,
+                const std::shared_ptr<GPUResource>& gpu_resource, float learning_rate = 0.001,
+                float beta1 = 0.9, float beta2 = 0.999, float epsilon = 1e-6,
+                float weight_decay = 0.01, float scaler = 1.f);
+
+  void initialize() override;
+
+  /**
+   * update the weights using gradient
+   */
+  void update() override;
+
+  std::vector<core23::Tensor> get_opt_state_tensors() override { return {m_tensor_, v_tensor_}; }
+
+ private:
+  std::optional<WgradTensors<T>> wgrad_tensors_;
+  core23::Tensor m_tensor_;
+  core23::Tensor v_tensor_;
+  uint64_t t_;
+  const float beta1_;
+  const float beta2_;
+  const float epsilon_;
+  const float weight_decay_;
+};
+
+}  // namespace HugeCTR
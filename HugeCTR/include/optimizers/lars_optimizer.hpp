@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optimizers/layer_wise_optimizer.hpp>
+
+namespace HugeCTR {
+
+/**
+ * LARS optimizer of the dense layers, with momentum
+ */
+template <typename T>
+class LARSOptimizer : public LayerWiseOptimizer {
+ public:
+  /**
+   * Constructor of LARSOptimizer.
+   * names of hyper-parameters are the same as in Algorithm 1 of LARS paper (arXiv:1708.03888)
+   * @param weight_tensors a list of dense layer weight tensors
+   * @param wgrad_tensors gradient for weight tensors
+   * @param gpu_resource the GPU where update kernel is launched
+   * @param learning_rate global learning rate, gamma in LARS paper
+   * @param momentum momentum m in LARS paper
+   * @param trust_coefficient trust coefficient eta in LARS paper
+   * @param epsilon added to the denominator of the local learning rate
+   * @param weight_decay weight decay beta in LARS paper
+   */
+  LARSOptimizer(std::optional<WeightTensors> weight_tensors,
+                std::optional<WgradTensors<T>> wgrad_tensors,
+                const std::shared_ptr<GPUResource>& gpu_resource, float learning_rate,
+                float momentum = 0.9, float trust_coefficient = 0.001, float epsilon = 1e-7,
+                float weight_decay = 0.f, float scaler = 1.f);
+
+  void initialize() override;
+
+  /**
+   * update the weights using gradient
+   */
+  void update() override;
+
+  std::vector<core23::Tensor> get_opt_state_tensors() override { return {momentum_tensor_}; }
+
+ private:
+  std::optional<WgradTensors<T>> wgrad_tensors_;
+  core23::Tensor momentum_tensor_;
+  const float momentum_;
+  const float trust_coefficient_;
+  const float epsilon_;
+  const float weight_decay_;
+};
+
+}  // namespace HugeCTR
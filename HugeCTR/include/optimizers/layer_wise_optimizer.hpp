@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <optimizer.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Base class of the optimizers that scale the update of each layer by a trust ratio of norms,
+ * e.g. LAMB and LARS. Each weight tensor of the contiguous weight buffer is a layer. The norms of
+ * all layers are computed with one segmented reduction, see layer_wise_update.cuh.
+ */
+class LayerWiseOptimizer : public Optimizer {
+ public:
+  LayerWiseOptimizer(std::optional<WeightTensors> weight_tensors,
+                     const std::shared_ptr<GPUResource>& gpu_resource, float learning_rate,
+                     float scaler);
+
+  /**
+   * Finds the layers in the weight buffer. It must be called after the weights are allocated.
+   */
+  void initialize() override;
+
+ protected:
+  dim3 get_layer_wise_grid_dim(size_t block_dim) const;
+  // The first and one past the last element of each layer in the flattened weights.
+  const int64_t* get_layer_ranges() const { return layer_ranges_.data<int64_t>(); }
+  // Zeroes the two square sums of each layer before a reduction, and returns them.
+  float* reset_square_sums();
+
+ private:
+  std::vector<int64_t> h_layer_ranges_;
+  int64_t max_layer_size_;
+  core23::Tensor layer_ranges_;
+  core23::Tensor square_sums_;
+};
+
+}  // namespace HugeCTR
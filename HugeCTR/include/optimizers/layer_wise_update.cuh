@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+/**
+ * Kernels of the LayerWiseOptimizer. They run on LayerWiseOptimizer::get_layer_wise_grid_dim(),
+ * which has a row of blocks per layer, and the blocks of a row stride over their layer.
+ */
+
+// Adds the squares of the two values that op(i) returns for each element i of a layer to the two
+// square sums of the layer.
+template <typename Op>
+__global__ void layer_wise_square_sum_kernel(const int64_t* layer_ranges, Op op,
+                                             float* square_sums, const int* skip_update) {
+  if (skip_update && *skip_update) {
+    return;
+  }
+  const int64_t begin = layer_ranges[2 * blockIdx.y];
+  const int64_t end = layer_ranges[2 * blockIdx.y + 1];
+  float sum_x = 0.f;
+  float sum_y = 0.f;
+  for (int64_t i = begin + blockIdx.x * blockDim.x + threadIdx.x; i < end;
+       i += gridDim.x * blockDim.x) {
+    const float2 values = op(i);
+    sum_x += values.x * values.x;
+    sum_y += values.y * values.y;
+  }
+  sum_x = blockReduceSum(sum_x);
+  // blockReduceSum() reuses its shared memory.
+  __syncthreads();
+  sum_y = blockReduceSum(sum_y);
+  if (threadIdx.x == 0) {
+    atomicAdd(square_sums + 2 * blockIdx.y, sum_x);
+    atomicAdd(square_sums + 2 * blockIdx.y + 1, sum_y);
+  }
+}
+
+// Calls op(i, norm_x, norm_y) for each element i of a layer, with the two norms of the layer.
+template <typename Op>
+__global__ void layer_wise_update_kernel(const int64_t* layer_ranges, Op op,
+                                         const float* square_sums, const int* skip_update) {
+  if (skip_update && *skip_update) {
+    return;
+  }
+  const int64_t begin = layer_ranges[2 * blockIdx.y];
+  const int64_t end = layer_ranges[2 * blockIdx.y + 1];
+  const float norm_x = sqrtf(square_sums[2 * blockIdx.y]);
+  const float norm_y = sqrtf(square_sums[2 * blockIdx.y + 1]);
+  for (int64_t i = begin + blockIdx.x * blockDim.x + threadIdx.x; i < end;
+       i += gridDim.x * blockDim.x) {
+    op(i, norm_x, norm_y);
+  }
+}
+
+}  // namespace HugeCTR
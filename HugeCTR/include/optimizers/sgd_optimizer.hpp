@@ -58,6 +58,9 @@ class SGDOptimizer : public Optimizer {
    */
   void update() override;
 
+  // The update kernel keeps its own FP16 copy of the weights with mixed precision.
+  bool updates_weight_half() const override { return use_mixed_precision_; }
+
  private:
   Tensor2<T> wgrad_;
   Tensor2<__half> weight_main_half_;
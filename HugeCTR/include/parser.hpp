@@ -83,6 +83,10 @@ struct Solver {
   std::map<metrics::Type, float> metrics_spec;
   bool i64_input_key;
   bool use_algorithm_search;
+  std::string algorithm_cache_file;
+  bool fuse_elementwise_layers;
+  bool fuse_add_layer_norm_layers;
+  bool plan_activation_memory;
   bool use_cuda_graph;
   bool gen_loss_summary;
   bool train_intra_iteration_overlap;
@@ -92,11 +96,26 @@ struct Solver {
   bool use_embedding_collection;
   AllReduceAlgo all_reduce_algo;
   bool grouped_all_reduce;
+  size_t dense_wgrad_bucket_size_mb = 0;
+  WgradCompression_t dense_wgrad_compression = WgradCompression_t::Disabled;
+  bool shard_dense_optimizer = false;
+  size_t gradient_accumulation_steps = 1;
+  bool dynamic_loss_scaling = false;
+  size_t loss_scale_growth_interval = 2000;
+  size_t dense_branch_streams = 1;
+  bool overlap_eval = false;
+  bool gpu_learning_rate_scheduling = false;
   size_t num_iterations_statistics;
   bool perf_logging;
   bool drop_incomplete_batch;
   std::string kafka_brokers;
+  bool kafka_columnar_format = false;
+  DatabaseValueEncoding_t kafka_value_encoding = DatabaseValueEncoding_t::Raw;
+  std::string kafka_compression_codec = "none";
   DataSourceParams data_source_params;
+  bool export_mapped_sparse_model = false;
+  size_t step_time_report_interval = 0;
+  float straggler_threshold = 0.1f;
   std::vector<std::shared_ptr<TrainingCallback>> training_callbacks;
   Solver() {}
 };
@@ -220,7 +239,9 @@ const std::map<std::string, Layer_t> LAYER_TYPE_MAP = {
     {"Reshape", Layer_t::Reshape},
     {"Sigmoid", Layer_t::Sigmoid},
     {"Slice", Layer_t::Slice},
-    {"SequenceMask", Layer_t::SequenceMask}};
+    {"SequenceMask", Layer_t::SequenceMask},
+    {"GroupedMLP", Layer_t::GroupedMLP},
+    {"InBatchSoftmaxLoss", Layer_t::InBatchSoftmaxLoss}};
 const std::map<std::string, Layer_t> LAYER_TYPE_MAP_MP = {
     {"Add", Layer_t::Add},
     {"BatchNorm", Layer_t::BatchNorm},
@@ -246,7 +267,9 @@ const std::map<std::string, Layer_t> LAYER_TYPE_MAP_MP = {
     {"Reshape", Layer_t::Reshape},
     {"Sigmoid", Layer_t::Sigmoid},
     {"Slice", Layer_t::Slice},
-    {"SequenceMask", Layer_t::SequenceMask}};
+    {"SequenceMask", Layer_t::SequenceMask},
+    {"GroupedMLP", Layer_t::GroupedMLP},
+    {"InBatchSoftmaxLoss", Layer_t::InBatchSoftmaxLoss}};
 const std::map<std::string, Embedding_t> EMBEDDING_TYPE_MAP = {
     {"DistributedSlotSparseEmbeddingHash", Embedding_t::DistributedSlotSparseEmbeddingHash},
     {"LocalizedSlotSparseEmbeddingHash", Embedding_t::LocalizedSlotSparseEmbeddingHash},
@@ -258,7 +281,9 @@ const std::map<std::string, Initializer_t> INITIALIZER_TYPE_MAP = {
     {"XavierUniform", Initializer_t::XavierUniform},
     {"Zero", Initializer_t::Zero}};
 static const std::map<std::string, AllReduceAlgo> ALLREDUCE_ALGO_MAP = {
-    {"Oneshot", AllReduceAlgo::ONESHOT}, {"NCCL", AllReduceAlgo::NCCL}};
+    {"Oneshot", AllReduceAlgo::ONESHOT},
+    {"NCCL", AllReduceAlgo::NCCL},
+    {"Hierarchical", AllReduceAlgo::HIERARCHICAL}};
 
 static const std::map<std::string, Optimizer_t> OPTIMIZER_TYPE_MAP = {
     {"Ftrl", Optimizer_t::Ftrl},
@@ -267,7 +292,9 @@ static const std::map<std::string, Optimizer_t> OPTIMIZER_TYPE_MAP = {
     {"AdaGrad", Optimizer_t::AdaGrad},
     {"MomentumSGD", Optimizer_t::MomentumSGD},
     {"Nesterov", Optimizer_t::Nesterov},
-    {"SGD", Optimizer_t::SGD}};
+    {"SGD", Optimizer_t::SGD},
+    {"LAMB", Optimizer_t::LAMB},
+    {"LARS", Optimizer_t::LARS}};
 
 static const std::map<std::string, Update_t> UPDATE_TYPE_MAP = {
     {"Local", Update_t::Local}, {"Global", Update_t::Global}, {"LazyGlobal", Update_t::LazyGlobal}};
@@ -20,6 +20,7 @@
 
 #include <collectives/all_reduce_comm.hpp>
 #include <common.hpp>
+#include <core23/pinned_host_arena.hpp>
 #include <device_map.hpp>
 #include <embeddings/hybrid_embedding/utils.hpp>
 #include <hps/inference_utils.hpp>
@@ -57,6 +58,7 @@ void CommonPybind(pybind11::module& m) {
       .export_values();
   pybind11::enum_<HugeCTR::Check_t>(m, "Check_t")
       .value("Sum", HugeCTR::Check_t::Sum)
+      .value("SumDeferred", HugeCTR::Check_t::SumDeferred)
       .value("Non", HugeCTR::Check_t::None)
       .export_values();
   pybind11::enum_<HugeCTR::DataReaderSparse_t>(m, "DataReaderSparse_t")
@@ -68,6 +70,7 @@ void CommonPybind(pybind11::module& m) {
       .value("Raw", HugeCTR::DataReaderType_t::Raw)
       .value("Parquet", HugeCTR::DataReaderType_t::Parquet)
       .value("RawAsync", HugeCTR::DataReaderType_t::RawAsync)
+      .value("InMemory", HugeCTR::DataReaderType_t::InMemory)
       .export_values();
   pybind11::enum_<HugeCTR::FileSystemType_t>(m, "FileSystemType_t")
       .value("Local", HugeCTR::FileSystemType_t::Local)
@@ -103,6 +106,7 @@ void CommonPybind(pybind11::module& m) {
       .export_values();
   pybind11::enum_<HugeCTR::GroupLayer_t>(m, "GroupLayer_t")
       .value("GroupFusedInnerProduct", HugeCTR::GroupLayer_t::GroupFusedInnerProduct)
+      .value("GroupExpertMLP", HugeCTR::GroupLayer_t::GroupExpertMLP)
       .export_values();
   pybind11::enum_<HugeCTR::Layer_t>(m, "Layer_t")
       .value("BatchNorm", HugeCTR::Layer_t::BatchNorm)
@@ -120,6 +124,7 @@ void CommonPybind(pybind11::module& m) {
       .value("MLP", HugeCTR::Layer_t::MLP)
       .value("Interaction", HugeCTR::Layer_t::Interaction)
       .value("MultiCrossEntropyLoss", HugeCTR::Layer_t::MultiCrossEntropyLoss)
+      .value("InBatchSoftmaxLoss", HugeCTR::Layer_t::InBatchSoftmaxLoss)
       .value("ReLU", HugeCTR::Layer_t::ReLU)
       .value("ReLUHalf", HugeCTR::Layer_t::ReLUHalf)
       .value("Sigmoid", HugeCTR::Layer_t::Sigmoid)
@@ -154,22 +159,37 @@ void CommonPybind(pybind11::module& m) {
       .value("Auto", HugeCTR::Alignment_t::Auto)
       .value("Non", HugeCTR::Alignment_t::None)
       .export_values();
+  pybind11::enum_<HugeCTR::IOBackend_t>(m, "IOBackend_t")
+      .value("AIO", HugeCTR::IOBackend_t::AIO)
+      .value("IOUring", HugeCTR::IOBackend_t::IOUring)
+      .value("IOUringSQPoll", HugeCTR::IOBackend_t::IOUringSQPoll)
+      .value("GDS", HugeCTR::IOBackend_t::GDS)
+      .export_values();
   pybind11::class_<HugeCTR::AsyncParam>(m, "AsyncParam")
-      .def(pybind11::init<int, int, int, int, int, bool, Alignment_t, bool, bool>(),
+      .def(pybind11::init<int, int, int, int, int, bool, Alignment_t, bool, bool, IOBackend_t,
+                          int, const std::string&, const std::vector<long long>&,
+                          const std::vector<float>&, long long, const std::vector<int>&>(),
            pybind11::arg("num_threads"), pybind11::arg("num_batches_per_thread"),
            pybind11::arg("max_num_requests_per_thread") = 0, pybind11::arg("io_depth") = 0,
            pybind11::arg("io_alignment") = 0, pybind11::arg("shuffle"),
            pybind11::arg("aligned_type") = Alignment_t::None,
-           pybind11::arg("multi_hot_reader") = true, pybind11::arg("is_dense_float") = true);
+           pybind11::arg("multi_hot_reader") = true, pybind11::arg("is_dense_float") = true,
+           pybind11::arg("io_backend") = IOBackend_t::AIO, pybind11::arg("shuffle_window") = 1,
+           pybind11::arg("resume_state") = "",
+           pybind11::arg("synthetic_vocabulary_sizes") = std::vector<long long>(),
+           pybind11::arg("synthetic_alphas") = std::vector<float>(),
+           pybind11::arg("token_budget") = 0,
+           pybind11::arg("token_budget_slots") = std::vector<int>());
   pybind11::class_<HugeCTR::HybridEmbeddingParam>(m, "HybridEmbeddingParam")
       .def(pybind11::init<size_t, int64_t, double, double, double, double,
                           hybrid_embedding::CommunicationType,
-                          hybrid_embedding::HybridEmbeddingType>(),
+                          hybrid_embedding::HybridEmbeddingType, std::string, size_t>(),
            pybind11::arg("max_num_frequent_categories"),
            pybind11::arg("max_num_infrequent_samples"), pybind11::arg("p_dup_max"),
            pybind11::arg("max_all_reduce_bandwidth"), pybind11::arg("max_all_to_all_bandwidth"),
            pybind11::arg("efficiency_bandwidth_ratio"), pybind11::arg("communication_type"),
-           pybind11::arg("hybrid_embedding_type"));
+           pybind11::arg("hybrid_embedding_type"), pybind11::arg("statistics_file") = "",
+           pybind11::arg("recalibration_interval") = 0);
   pybind11::enum_<HugeCTR::LrPolicy_t>(m, "LrPolicy_t")
       .value("fixed", HugeCTR::LrPolicy_t::fixed)
       .export_values();
@@ -181,6 +201,8 @@ void CommonPybind(pybind11::module& m) {
       .value("MomentumSGD", HugeCTR::Optimizer_t::MomentumSGD)
       .value("Nesterov", HugeCTR::Optimizer_t::Nesterov)
       .value("SGD", HugeCTR::Optimizer_t::SGD)
+      .value("LAMB", HugeCTR::Optimizer_t::LAMB)
+      .value("LARS", HugeCTR::Optimizer_t::LARS)
       .export_values();
   pybind11::enum_<HugeCTR::Update_t>(m, "Update_t")
       .value("Local", HugeCTR::Update_t::Local)
@@ -213,6 +235,9 @@ void CommonPybind(pybind11::module& m) {
       .value("HitRate", HugeCTR::metrics::Type::HitRate)
       .value("NDCG", HugeCTR::metrics::Type::NDCG)
       .value("SMAPE", HugeCTR::metrics::Type::SMAPE)
+      .value("ApproxAUC", HugeCTR::metrics::Type::ApproxAUC)
+      .value("RecallAtK", HugeCTR::metrics::Type::RecallAtK)
+      .value("NDCGAtK", HugeCTR::metrics::Type::NDCGAtK)
       .export_values();
   pybind11::enum_<HugeCTR::DeviceMap::Layout>(m, "DeviceLayout")
       .value("LocalFirst", HugeCTR::DeviceMap::Layout::LOCAL_FIRST)
@@ -221,6 +246,12 @@ void CommonPybind(pybind11::module& m) {
   pybind11::enum_<HugeCTR::AllReduceAlgo>(m, "AllReduceAlgo")
       .value("OneShot", HugeCTR::AllReduceAlgo::ONESHOT)
       .value("NCCL", HugeCTR::AllReduceAlgo::NCCL)
+      .value("Hierarchical", HugeCTR::AllReduceAlgo::HIERARCHICAL)
+      .export_values();
+  pybind11::enum_<HugeCTR::WgradCompression_t>(m, "WgradCompression")
+      .value("Disabled", HugeCTR::WgradCompression_t::Disabled)
+      .value("FP16", HugeCTR::WgradCompression_t::FP16)
+      .value("BF16", HugeCTR::WgradCompression_t::BF16)
       .export_values();
   pybind11::enum_<HugeCTR::hybrid_embedding::HybridEmbeddingType>(m, "HybridEmbeddingType")
       .value("Distributed", HugeCTR::hybrid_embedding::HybridEmbeddingType::Distributed)
@@ -255,6 +286,10 @@ void CommonPybind(pybind11::module& m) {
              HugeCTR::DatabaseType_t::ParallelHashMap)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::MultiProcessHashMap),
              HugeCTR::DatabaseType_t::MultiProcessHashMap)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::SlabHashMap),
+             HugeCTR::DatabaseType_t::SlabHashMap)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::TieredHashMap),
+             HugeCTR::DatabaseType_t::TieredHashMap)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::RedisCluster),
              HugeCTR::DatabaseType_t::RedisCluster)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseType_t::RocksDB),
@@ -267,6 +302,18 @@ void CommonPybind(pybind11::module& m) {
              HugeCTR::DatabaseOverflowPolicy_t::EvictLeastUsed)
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseOverflowPolicy_t::EvictOldest),
              HugeCTR::DatabaseOverflowPolicy_t::EvictOldest)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseOverflowPolicy_t::EvictClock),
+             HugeCTR::DatabaseOverflowPolicy_t::EvictClock)
+      .export_values();
+  pybind11::enum_<HugeCTR::DatabaseValueEncoding_t>(m, "DatabaseValueEncoding_t")
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseValueEncoding_t::Raw),
+             HugeCTR::DatabaseValueEncoding_t::Raw)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseValueEncoding_t::Float16),
+             HugeCTR::DatabaseValueEncoding_t::Float16)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseValueEncoding_t::BFloat16),
+             HugeCTR::DatabaseValueEncoding_t::BFloat16)
+      .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::DatabaseValueEncoding_t::Float8),
+             HugeCTR::DatabaseValueEncoding_t::Float8)
       .export_values();
   pybind11::enum_<HugeCTR::UpdateSourceType_t>(m, "UpdateSourceType_t")
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::UpdateSourceType_t::Null),
@@ -274,6 +321,13 @@ void CommonPybind(pybind11::module& m) {
       .value(HugeCTR::hctr_enum_to_c_str(HugeCTR::UpdateSourceType_t::KafkaMessageQueue),
              HugeCTR::UpdateSourceType_t::KafkaMessageQueue)
       .export_values();
+  m.def(
+      "set_pinned_host_quota",
+      [](const std::string& consumer, const int64_t quota_bytes) {
+        core23::PinnedHostArena::instance().set_quota(consumer, quota_bytes);
+      },
+      pybind11::arg("consumer"), pybind11::arg("quota_bytes"));
+  m.def("trim_pinned_host_memory", []() { core23::PinnedHostArena::instance().trim(); });
 }
 
 }  // namespace python_lib
@@ -28,11 +28,17 @@ void DataSourcePybind(pybind11::module &m) {
   pybind11::module data = m.def_submodule("data", "data submodule of hugectr");
   pybind11::class_<HugeCTR::DataSourceParams, std::shared_ptr<HugeCTR::DataSourceParams>>(
       data, "DataSourceParams")
-      .def(pybind11::init<FileSystemType_t, const std::string &, const int>(),
-           pybind11::arg("source"), pybind11::arg("server"), pybind11::arg("port"))
+      .def(pybind11::init<FileSystemType_t, const std::string &, const int, const int, const int,
+                          const std::string &>(),
+           pybind11::arg("source"), pybind11::arg("server"), pybind11::arg("port"),
+           pybind11::arg("num_read_threads") = 8, pybind11::arg("read_chunk_size_mb") = 16,
+           pybind11::arg("cache_dir") = "")
       .def_readwrite("source", &HugeCTR::DataSourceParams::type)
       .def_readwrite("server", &HugeCTR::DataSourceParams::server)
-      .def_readwrite("port", &HugeCTR::DataSourceParams::port);
+      .def_readwrite("port", &HugeCTR::DataSourceParams::port)
+      .def_readwrite("num_read_threads", &HugeCTR::DataSourceParams::num_read_threads)
+      .def_readwrite("read_chunk_size_mb", &HugeCTR::DataSourceParams::read_chunk_size_mb)
+      .def_readwrite("cache_dir", &HugeCTR::DataSourceParams::cache_dir);
 }
 }  // namespace python_lib
 }  // namespace HugeCTR
\ No newline at end of file
@@ -26,23 +26,74 @@ namespace HugeCTR {
 namespace python_lib {
 
 void EmbeddingCollectionPybind(pybind11::module &m) {
+  pybind11::enum_<::embedding::EvictionPolicy>(m, "EvictionPolicy")
+      .value("Disabled", ::embedding::EvictionPolicy::Disabled)
+      .value("LRU", ::embedding::EvictionPolicy::LRU)
+      .value("LFU", ::embedding::EvictionPolicy::LFU)
+      .value("TTL", ::embedding::EvictionPolicy::TTL)
+      .export_values();
+  pybind11::class_<::embedding::EvictionParams, std::shared_ptr<::embedding::EvictionParams>>(
+      m, "EvictionParams")
+      .def(pybind11::init<::embedding::EvictionPolicy, int64_t, int64_t, double, int, bool>(),
+           pybind11::arg("policy") = ::embedding::EvictionPolicy::Disabled,
+           pybind11::arg("max_num_keys") = 0, pybind11::arg("ttl") = 0,
+           pybind11::arg("evict_to_ratio") = 0.9, pybind11::arg("check_interval") = 100,
+           pybind11::arg("spill_to_host") = false);
+  pybind11::enum_<::embedding::CompositionalCombiner>(m, "CompositionalCombiner")
+      .value("Disabled", ::embedding::CompositionalCombiner::Disabled)
+      .value("Sum", ::embedding::CompositionalCombiner::Sum)
+      .value("Mul", ::embedding::CompositionalCombiner::Mul);
+  pybind11::class_<::embedding::CompositionalParams,
+                   std::shared_ptr<::embedding::CompositionalParams>>(m, "CompositionalParams")
+      .def(pybind11::init<::embedding::CompositionalCombiner, int>(),
+           pybind11::arg("combiner") = ::embedding::CompositionalCombiner::Disabled,
+           pybind11::arg("num_remainder_rows") = 0);
   pybind11::class_<EmbeddingTableConfig, std::shared_ptr<EmbeddingTableConfig>>(
       m, "EmbeddingTableConfig")
       .def(pybind11::init<const std::string &, int, int, std::optional<OptParams>,
-                          std::optional<embedding::InitParams>>(),
+                          std::optional<embedding::InitParams>,
+                          std::optional<embedding::EvictionParams>, int,
+                          std::optional<embedding::CompositionalParams>>(),
            pybind11::arg("name"), pybind11::arg("max_vocabulary_size"), pybind11::arg("ev_size"),
            pybind11::arg("opt_params_or_empty") = std::nullopt,
-           pybind11::arg("init_param_or_empty") = std::nullopt);
+           pybind11::arg("init_param_or_empty") = std::nullopt,
+           pybind11::arg("eviction_params_or_empty") = std::nullopt,
+           pybind11::arg("num_gpu_cached_rows") = 0,
+           pybind11::arg("compositional_params_or_empty") = std::nullopt);
   pybind11::enum_<::embedding::CommunicationStrategy>(m, "CommunicationStrategy")
       .value("Uniform", ::embedding::CommunicationStrategy::Uniform)
       .value("Hierarchical", ::embedding::CommunicationStrategy::Hierarchical)
       .export_values();
+  pybind11::enum_<::embedding::CommQuantizationStrategy>(m, "CommQuantizationStrategy")
+      .value("Disabled", ::embedding::CommQuantizationStrategy::Disabled)
+      .value("FP8", ::embedding::CommQuantizationStrategy::FP8)
+      .export_values();
+  pybind11::enum_<::embedding::TableStorageType>(m, "TableStorageType")
+      .value("FP32", ::embedding::TableStorageType::FP32)
+      .value("FP16", ::embedding::TableStorageType::FP16)
+      .export_values();
+  pybind11::class_<HugeCTR::ShardPlannerParams, std::shared_ptr<HugeCTR::ShardPlannerParams>>(
+      m, "ShardPlannerParams")
+      .def(pybind11::init<double, double, double, double, const std::map<std::string, double> &,
+                          const std::map<std::string, int64_t> &, bool, const std::string &>(),
+           pybind11::arg("hbm_budget_gb") = 0, pybind11::arg("hbm_bandwidth") = 1500,
+           pybind11::arg("intra_node_bandwidth") = 150, pybind11::arg("inter_node_bandwidth") = 25,
+           pybind11::arg("pooling_factors") = std::map<std::string, double>{},
+           pybind11::arg("num_rows") = std::map<std::string, int64_t>{},
+           pybind11::arg("allow_data_parallel") = true, pybind11::arg("dataset_stats") = "");
   pybind11::class_<HugeCTR::EmbeddingCollectionConfig,
                    std::shared_ptr<HugeCTR::EmbeddingCollectionConfig>>(m,
                                                                         "EmbeddingCollectionConfig")
-      .def(pybind11::init<bool, ::embedding::CommunicationStrategy>(),
+      .def(pybind11::init<bool, ::embedding::CommunicationStrategy,
+                          ::embedding::CommQuantizationStrategy, ::embedding::TableStorageType,
+                          bool, bool>(),
            pybind11::arg("use_exclusive_keys") = false,
-           pybind11::arg("comm_strategy") = ::embedding::CommunicationStrategy::Uniform)
+           pybind11::arg("comm_strategy") = ::embedding::CommunicationStrategy::Uniform,
+           pybind11::arg("comm_quantization_strategy") =
+               ::embedding::CommQuantizationStrategy::Disabled,
+           pybind11::arg("table_storage_type") = ::embedding::TableStorageType::FP32,
+           pybind11::arg("use_hash_local_reduce") = false,
+           pybind11::arg("use_p2p_all2all") = false)
       .def("embedding_lookup",
            pybind11::overload_cast<const EmbeddingTableConfig &, const std::string &,
                                    const std::string &, const std::string &>(
@@ -57,7 +108,35 @@ void EmbeddingCollectionPybind(pybind11::module &m) {
            pybind11::arg("table_config"), pybind11::arg("bottom_name"), pybind11::arg("top_name"),
            pybind11::arg("combiner"))
       .def("shard", &HugeCTR::EmbeddingCollectionConfig::shard, pybind11::arg("shard_matrix"),
-           pybind11::arg("shard_strategy"));
+           pybind11::arg("shard_strategy"))
+      .def("auto_shard", &HugeCTR::EmbeddingCollectionConfig::auto_shard,
+           pybind11::arg("shard_planner_params") = ShardPlannerParams{})
+      .def("replicate_frequent_keys",
+           pybind11::overload_cast<const std::map<std::string, std::vector<int64_t>> &>(
+               &HugeCTR::EmbeddingCollectionConfig::replicate_frequent_keys),
+           pybind11::arg("frequent_keys"))
+      .def("replicate_frequent_keys",
+           pybind11::overload_cast<const std::string &, const std::map<std::string, int> &>(
+               &HugeCTR::EmbeddingCollectionConfig::replicate_frequent_keys),
+           pybind11::arg("dataset_stats"), pybind11::arg("num_keys"))
+      .def("deduplicate_keys", &HugeCTR::EmbeddingCollectionConfig::deduplicate_keys,
+           pybind11::arg("table_names"))
+      .def("deterministic_reduction", &HugeCTR::EmbeddingCollectionConfig::deterministic_reduction,
+           pybind11::arg("table_names"))
+      .def("lookup_streams", &HugeCTR::EmbeddingCollectionConfig::lookup_streams,
+           pybind11::arg("num_streams"),
+           pybind11::arg("stream_priorities") = std::map<std::string, int>{})
+      .def("static_vocabulary", &HugeCTR::EmbeddingCollectionConfig::static_vocabulary,
+           pybind11::arg("keyset_files"))
+      .def("feature_hash", &HugeCTR::EmbeddingCollectionConfig::feature_hash,
+           pybind11::arg("top_name"), pybind11::arg("bottom_name"),
+           pybind11::arg("hash_function") = "murmur", pybind11::arg("num_buckets") = 0,
+           pybind11::arg("seed") = 0)
+      .def("feature_cross", &HugeCTR::EmbeddingCollectionConfig::feature_cross,
+           pybind11::arg("top_name"), pybind11::arg("bottom_names"),
+           pybind11::arg("hash_function") = "murmur", pybind11::arg("num_buckets") = 0,
+           pybind11::arg("seed") = 0)
+      .def("use_32bit_keys", &HugeCTR::EmbeddingCollectionConfig::use_32bit_keys);
 }
 
 }  // namespace python_lib
@@ -76,13 +76,15 @@ auto check_sparse_models = [](std::vector<std::string>& sparse_models) {
 
 }
 
-HMemCacheConfig CreateHMemCache(size_t num_blocks, double target_hit_rate, size_t max_num_evict) {
-  return HMemCacheConfig(num_blocks, target_hit_rate, max_num_evict);
+HMemCacheConfig CreateHMemCache(size_t num_blocks, double target_hit_rate, size_t max_num_evict,
+                                size_t hot_row_min_access) {
+  return HMemCacheConfig(num_blocks, target_hit_rate, max_num_evict, hot_row_min_access);
 }
 
 std::shared_ptr<EmbeddingTrainingCacheParams> CreateETC(
     std::vector<TrainPSType_t>& ps_types, std::vector<std::string>& sparse_models,
-    std::vector<std::string>& local_paths, std::vector<HMemCacheConfig>& hcache_configs) {
+    std::vector<std::string>& local_paths, std::vector<HMemCacheConfig>& hcache_configs,
+    bool prefetch_next_pass, size_t writeback_budget_mb, IOBackend_t writeback_io_backend) {
   std::shared_ptr<EmbeddingTrainingCacheParams> etc_params;
   check_sparse_models(sparse_models);
 
@@ -123,20 +125,27 @@ std::shared_ptr<EmbeddingTrainingCacheParams> CreateETC(
     }
   }
 
-  etc_params.reset(
-      new EmbeddingTrainingCacheParams(ps_types, sparse_models, local_paths, hcache_configs));
+  WritebackConfig writeback_config;
+  writeback_config.dirty_budget_bytes = writeback_budget_mb << 20;
+  writeback_config.io_backend = writeback_io_backend;
+  etc_params.reset(new EmbeddingTrainingCacheParams(ps_types, sparse_models, local_paths,
+                                                    hcache_configs, prefetch_next_pass,
+                                                    writeback_config));
   return etc_params;
 }
 
 void EmbeddingTrainingCachePybind(pybind11::module& m) {
   m.def("CreateHMemCache", &HugeCTR::python_lib::CreateHMemCache, pybind11::arg("num_blocks"),
-        pybind11::arg("target_hit_rate"), pybind11::arg("max_num_evict"));
+        pybind11::arg("target_hit_rate"), pybind11::arg("max_num_evict"),
+        pybind11::arg("hot_row_min_access") = 2);
   pybind11::class_<HugeCTR::HMemCacheConfig, std::shared_ptr<HugeCTR::HMemCacheConfig>>(
       m, "HMemCacheConfig");
   m.def("CreateETC", &HugeCTR::python_lib::CreateETC, pybind11::arg("ps_types"),
         pybind11::arg("sparse_models") = std::vector<std::string>(),
         pybind11::arg("local_paths") = std::vector<std::string>(),
-        pybind11::arg("hmem_cache_configs") = std::vector<HMemCacheConfig>());
+        pybind11::arg("hmem_cache_configs") = std::vector<HMemCacheConfig>(),
+        pybind11::arg("prefetch_next_pass") = false, pybind11::arg("writeback_budget_mb") = 0,
+        pybind11::arg("writeback_io_backend") = IOBackend_t::AIO);
   pybind11::class_<HugeCTR::EmbeddingTrainingCacheParams,
                    std::shared_ptr<HugeCTR::EmbeddingTrainingCacheParams>>(
       m, "EmbeddingTrainingCacheParams");
@@ -148,6 +157,13 @@ void EmbeddingTrainingCachePybind(pybind11::module& m) {
       .def("update",
            pybind11::overload_cast<std::vector<std::string>&>(
                &HugeCTR::EmbeddingTrainingCache::update),
+           pybind11::arg("keyset_file_list"))
+      .def("prefetch",
+           pybind11::overload_cast<std::string&>(&HugeCTR::EmbeddingTrainingCache::prefetch),
+           pybind11::arg("keyset_file"))
+      .def("prefetch",
+           pybind11::overload_cast<std::vector<std::string>&>(
+               &HugeCTR::EmbeddingTrainingCache::prefetch),
            pybind11::arg("keyset_file_list"));
 }
 
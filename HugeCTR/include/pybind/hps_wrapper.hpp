@@ -22,6 +22,7 @@
 
 #include <hps/embedding_cache.hpp>
 #include <hps/hier_parameter_server.hpp>
+#include <hps/lookup_metrics.hpp>
 #include <hps/lookup_session.hpp>
 #include <pybind/hpsconversion.hpp>
 
@@ -98,7 +99,7 @@ HPS::HPS(const std::string& hps_json_config_file) : ps_config_{hps_json_config_f
 HPS::HPS(parameter_server_config& ps_config) : ps_config_(ps_config) { initialize(); }
 
 void HPS::initialize() {
-  parameter_server_ = HierParameterServerBase::create(ps_config_);
+  parameter_server_ = HierParameterServerBase::get_or_create(ps_config_);
   for (auto& inference_params : ps_config_.inference_params_array) {
     std::map<int64_t, std::shared_ptr<LookupSessionBase>> lookup_sessions;
     for (const auto& device_id : inference_params.deployed_devices) {
@@ -300,6 +301,10 @@ void HPSPybind(pybind11::module& m) {
       .def("lookup_fromdlpack", &HugeCTR::python_lib::HPS::lookup_fromdlpack, pybind11::arg("keys"),
            pybind11::arg("out_tensor"), pybind11::arg("model_name"), pybind11::arg("table_id"),
            pybind11::arg("device_id") = 0);
+
+  infer.def(
+      "lookup_metrics", []() { return LookupMetrics::instance().to_openmetrics(); },
+      "Returns the latency histograms of the HPS lookup stages in the OpenMetrics text format.");
 }
 
 }  // namespace python_lib
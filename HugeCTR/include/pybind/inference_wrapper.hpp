@@ -57,6 +57,7 @@ class InferenceSessionPy : public InferenceSession {
                               const std::vector<long long>& embeddingcolumns,
                               const std::vector<int>& row_ptrs);
   void refresh_embedding_cache();
+  void apply_delta_sparse_model(const std::vector<std::string>& delta_model_files);
 
  private:
   void initialize();
@@ -432,6 +433,11 @@ void InferenceSessionPy::refresh_embedding_cache() {
                                              inference_params_.device_id);
 }
 
+void InferenceSessionPy::apply_delta_sparse_model(
+    const std::vector<std::string>& delta_model_files) {
+  parameter_server_->apply_delta_per_model(inference_params_.model_name, delta_model_files);
+}
+
 std::shared_ptr<InferenceSessionPy> CreateInferenceSession(
     const std::string& model_config_path, const InferenceParams& inference_params) {
   std::vector<std::string> model_config_path_array{model_config_path};
@@ -456,12 +462,19 @@ void InferencePybind(pybind11::module& m) {
           pybind11::init<DatabaseType_t,
                          // Backend specific.
                          const std::string&, const std::string&, const std::string&, size_t, size_t,
-                         size_t, const std::string&, bool, size_t, size_t, bool, const std::string&,
+                         bool, size_t, const std::string&, size_t, size_t, const std::string&, bool,
+                         bool, const std::string&,
+                         size_t, size_t, double, size_t, size_t, size_t, DatabaseValueEncoding_t,
+                         size_t,
+                         bool,
+                         const std::string&,
                          const std::string&, const std::string&, const std::string&,
                          // Overflow handling related.
                          size_t, DatabaseOverflowPolicy_t, double,
+                         const std::map<std::string, size_t>&, size_t,
+                         const std::map<std::string, double>&,
                          // Caching behavior related.
-                         bool, double, bool,
+                         bool, double, const std::string&, bool, double, bool, bool,
                          // Real-time update mechanism related.
                          const std::vector<std::string>&>(),
           pybind11::arg("type") = DatabaseType_t::ParallelHashMap,
@@ -470,10 +483,18 @@ void InferencePybind(pybind11::module& m) {
           pybind11::arg("password") = "",
           pybind11::arg("num_partitions") = std::min(16u, std::thread::hardware_concurrency()),
           pybind11::arg("allocation_rate") = 256L * 1024L * 1024L,
+          pybind11::arg("numa_aware") = false, pybind11::arg("huge_page_size") = 0,
+          pybind11::arg("snapshot_path") = "", pybind11::arg("snapshot_interval_ms") = 0,
           pybind11::arg("shared_memory_size") = 16L * 1024L * 1024L * 1024L,
           pybind11::arg("shared_memory_name") = "hctr_mp_hash_map_database",
           pybind11::arg("shared_memory_auto_remove") = true,
-          pybind11::arg("num_node_connections") = 5, pybind11::arg("max_batch_size") = 64L * 1024L,
+          pybind11::arg("short_read_locks") = false, pybind11::arg("spill_path") = "/tmp",
+          pybind11::arg("spill_queue_depth") = 128, pybind11::arg("spill_promotion_threshold") = 2,
+          pybind11::arg("spill_compaction_ratio") = 0.5,
+          pybind11::arg("num_node_connections") = 5, pybind11::arg("num_pipelined_batches") = 4,
+          pybind11::arg("near_cache_size") = 0,
+          pybind11::arg("value_encoding") = DatabaseValueEncoding_t::Raw,
+          pybind11::arg("max_batch_size") = 64L * 1024L,
           pybind11::arg("enable_tls") = false,
           pybind11::arg("tls_ca_certificate") = "cacertbundle.crt",
           pybind11::arg("tls_client_certificate") = "client_cert.pem",
@@ -483,10 +504,16 @@ void InferencePybind(pybind11::module& m) {
           pybind11::arg("overflow_margin") = std::numeric_limits<size_t>::max(),
           pybind11::arg("overflow_policy") = DatabaseOverflowPolicy_t::EvictRandom,
           pybind11::arg("overflow_resolution_target") = 0.8,
+          pybind11::arg("table_overflow_margins") = std::map<std::string, size_t>{},
+          pybind11::arg("shared_overflow_margin") = 0,
+          pybind11::arg("table_overflow_weights") = std::map<std::string, double>{},
           // Caching behavior related.
           pybind11::arg("initialize_after_startup") = true,
-          pybind11::arg("initial_cache_rate") = 1.0,
+          pybind11::arg("initial_cache_rate") = 1.0, pybind11::arg("key_frequency_path") = "",
           pybind11::arg("cache_missed_embeddings") = false,
+          pybind11::arg("cache_missed_embeddings_rate") = 1.0,
+          pybind11::arg("cache_missed_embeddings_doorkeeper") = false,
+          pybind11::arg("double_buffered_update") = false,
           // Real-time update mechanism related.
           pybind11::arg("update_filters") = std::vector<std::string>{"^hps_.+$"});
 
@@ -495,9 +522,9 @@ void InferencePybind(pybind11::module& m) {
                                                                        "PersistentDatabaseParams")
       .def(pybind11::init<DatabaseType_t,
                           // Backend specific.
-                          const std::string&, size_t, bool, size_t,
+                          const std::string&, size_t, bool, size_t, size_t,
                           // Caching behavior related.
-                          bool,
+                          bool, size_t,
                           // Real-time update mechanism related.
                           const std::vector<std::string>&>(),
            pybind11::arg("backend") = DatabaseType_t::Disabled,
@@ -505,8 +532,10 @@ void InferencePybind(pybind11::module& m) {
            pybind11::arg("path") = (std::filesystem::temp_directory_path() / "rocksdb").string(),
            pybind11::arg("num_threads") = 16, pybind11::arg("read_only") = false,
            pybind11::arg("max_batch_size") = 64L * 1024L,
+           pybind11::arg("block_cache_size") = 16L * 1024L * 1024L,
            // Caching behavior related.
            pybind11::arg("initialize_after_startup") = true,
+           pybind11::arg("bloom_filter_bits_per_key") = 0,
            // Real-time update mechanism related.
            pybind11::arg("update_filters") = std::vector<std::string>{"^hps_.+$"});
 
@@ -514,20 +543,28 @@ void InferencePybind(pybind11::module& m) {
       infer, "UpdateSourceParams")
       .def(pybind11::init<UpdateSourceType_t,
                           // Backend specific.
-                          const std::string&, size_t, size_t, size_t, size_t, size_t, size_t>(),
+                          const std::string&, size_t, size_t, size_t, size_t, size_t, size_t,
+                          size_t,
+                          // Embedding cache related.
+                          bool, bool>(),
            pybind11::arg("type") = UpdateSourceType_t::Null,
            // Backend specific.
            pybind11::arg("brokers") = "127.0.0.1:9092",
            pybind11::arg("metadata_refresh_interval_ms") = 30'000,
            pybind11::arg("receive_buffer_size") = 256 * 1024,
            pybind11::arg("poll_timeout_ms") = 500, pybind11::arg("max_batch_size") = 8 * 1024,
-           pybind11::arg("failure_backoff_ms") = 50, pybind11::arg("max_commit_interval") = 32);
+           pybind11::arg("failure_backoff_ms") = 50, pybind11::arg("max_commit_interval") = 32,
+           pybind11::arg("coalescing_window_ms") = 0,
+           // Embedding cache related.
+           pybind11::arg("refresh_embedding_cache") = false,
+           pybind11::arg("incremental_cache_refresh") = false);
 
   pybind11::enum_<EmbeddingCacheType_t>(infer, "EmbeddingCacheType_t")
       .value("Dynamic", EmbeddingCacheType_t::Dynamic)
       .value("UVM", EmbeddingCacheType_t::UVM)
       .value("Static", EmbeddingCacheType_t::Static)
       .value(hctr_enum_to_c_str(EmbeddingCacheType_t::Stochastic), EmbeddingCacheType_t::Stochastic)
+      .value(hctr_enum_to_c_str(EmbeddingCacheType_t::Hybrid), EmbeddingCacheType_t::Hybrid)
       .export_values();
 
   pybind11::class_<HugeCTR::InferenceParams, std::shared_ptr<HugeCTR::InferenceParams>>(
@@ -543,7 +580,12 @@ void InferencePybind(pybind11::module& m) {
                           const float, const float, const std::vector<size_t>&,
                           const std::vector<size_t>&, const std::vector<std::string>&,
                           const std::string&, const size_t, const size_t, const std::string&, bool,
-                          const EmbeddingCacheType_t&, bool, bool, bool, bool, bool, bool>(),
+                          const EmbeddingCacheType_t&, bool, bool, bool, bool, bool, bool,
+                          DatabaseValueEncoding_t, bool, bool, bool, size_t, bool, bool, bool,
+                          float, float, size_t, const std::vector<size_t>&, bool,
+                          const std::string&, int, const std::string&, const std::string&,
+                          const std::string&, bool,
+                          const std::vector<std::vector<std::string>>&, int>(),
 
            pybind11::arg("model_name"), pybind11::arg("max_batchsize"),
            pybind11::arg("hit_rate_threshold"), pybind11::arg("dense_model_file"),
@@ -575,7 +617,26 @@ void InferencePybind(pybind11::module& m) {
            pybind11::arg("use_context_stream") = true,
            pybind11::arg("fuse_embedding_table") = false,
            pybind11::arg("use_hctr_cache_implementation") = true, pybind11::arg("init_ec") = true,
-           pybind11::arg("enable_pagelock") = false, pybind11::arg("fp8_quant") = false);
+           pybind11::arg("enable_pagelock") = false, pybind11::arg("fp8_quant") = false,
+           pybind11::arg("embedding_cache_value_encoding") = DatabaseValueEncoding_t::Raw,
+           pybind11::arg("stream_ordered_lookup") = false,
+           pybind11::arg("use_cuda_graph_lookup") = false,
+           pybind11::arg("deduplicate_keys") = true,
+           pybind11::arg("embedding_cache_admission_threshold") = 0,
+           pybind11::arg("adaptive_cache_sizing") = false,
+           pybind11::arg("lock_free_cache_query") = false,
+           pybind11::arg("sharded_embedding_cache") = false,
+           pybind11::arg("hot_key_percentage") = 0.1,
+           pybind11::arg("uvm_promotion_percentage") = 0.0,
+           pybind11::arg("micro_batching_window_us") = 0,
+           pybind11::arg("cuda_graph_batch_sizes") = std::vector<size_t>{},
+           pybind11::arg("fp8_output") = false, pybind11::arg("algorithm_cache_file") = "",
+           pybind11::arg("max_number_of_worker_buffers_in_pool") = 0,
+           pybind11::arg("tensorrt_onnx_file") = "", pybind11::arg("tensorrt_engine_file") = "",
+           pybind11::arg("shared_embedding_cache_dir") = "",
+           pybind11::arg("shared_embedding_cache_owner") = true,
+           pybind11::arg("delta_sparse_model_files") = std::vector<std::vector<std::string>>{},
+           pybind11::arg("init_thread_pool_size") = 8);
 
   infer.def("CreateInferenceSession", &HugeCTR::python_lib::CreateInferenceSession,
             pybind11::arg("model_config_path"), pybind11::arg("inference_params"));
@@ -604,7 +665,10 @@ void InferencePybind(pybind11::module& m) {
            pybind11::arg("dense_feature"), pybind11::arg("embeddingcolumns"),
            pybind11::arg("row_ptrs"))
       .def("refresh_embedding_cache",
-           &HugeCTR::python_lib::InferenceSessionPy::refresh_embedding_cache);
+           &HugeCTR::python_lib::InferenceSessionPy::refresh_embedding_cache)
+      .def("apply_delta_sparse_model",
+           &HugeCTR::python_lib::InferenceSessionPy::apply_delta_sparse_model,
+           pybind11::arg("delta_model_files"));
   pybind11::class_<HugeCTR::InferenceModel, std::shared_ptr<HugeCTR::InferenceModel>>(
       infer, "InferenceModel")
       .def(pybind11::init<const std::string&, const InferenceParams&>(),
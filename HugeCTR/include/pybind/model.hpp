@@ -18,12 +18,14 @@
 #include <common.hpp>
 #include <core23_helper.hpp>
 #include <core23_network.hpp>
+#include <data_readers/in_memory_data_reader.hpp>
 #include <embedding.hpp>
 #include <embedding/data_distributor/data_distributor.hpp>
 #include <embedding_storage/weight_io/parameter_IO.hpp>
 #include <embedding_training_cache/embedding_training_cache.hpp>
 #include <embeddings/embedding_collection.hpp>
 #include <exchange_wgrad.hpp>
+#include <future>
 #include <graph_wrapper.hpp>
 #include <hps/hier_parameter_server.hpp>
 #include <hps/kafka_message.hpp>
@@ -36,8 +38,10 @@
 #include <parser.hpp>
 #include <pipeline.hpp>
 #include <pybind/common_helpers.hpp>
+#include <step_timer.hpp>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <utility>
 #include <utils.hpp>
 
@@ -82,7 +86,11 @@ std::map<Layer_t, std::string> LAYER_TYPE_TO_STRING = {
     {Layer_t::ElementwiseMultiply, "ElementwiseMultiply"},
     {Layer_t::MultiCross, "MultiCross"},
     {Layer_t::MLP, "MLP"},
-    {Layer_t::SequenceMask, "SequenceMask"}};
+    {Layer_t::SequenceMask, "SequenceMask"},
+    {Layer_t::FusedElementwise, "FusedElementwise"},
+    {Layer_t::FusedAddLayerNorm, "FusedAddLayerNorm"},
+    {Layer_t::GroupedMLP, "GroupedMLP"},
+    {Layer_t::InBatchSoftmaxLoss, "InBatchSoftmaxLoss"}};
 
 std::map<Layer_t, std::string> LAYER_TYPE_TO_STRING_MP = {
     {Layer_t::BatchNorm, "BatchNorm"},
@@ -109,13 +117,18 @@ std::map<Layer_t, std::string> LAYER_TYPE_TO_STRING_MP = {
     {Layer_t::FusedInnerProduct, "FusedInnerProduct"},
     {Layer_t::MultiCross, "MultiCross"},
     {Layer_t::MLP, "MLP"},
-    {Layer_t::SequenceMask, "SequenceMask"}};
+    {Layer_t::SequenceMask, "SequenceMask"},
+    {Layer_t::FusedElementwise, "FusedElementwise"},
+    {Layer_t::FusedAddLayerNorm, "FusedAddLayerNorm"},
+    {Layer_t::GroupedMLP, "GroupedMLP"},
+    {Layer_t::InBatchSoftmaxLoss, "InBatchSoftmaxLoss"}};
 
 std::set<Layer_t> TRAINABLE_LAYERS = {Layer_t::InnerProduct, Layer_t::FusedInnerProduct,
                                       Layer_t::MultiCross,   Layer_t::WeightMultiply,
                                       Layer_t::BatchNorm,    Layer_t::LayerNorm,
                                       Layer_t::GRU,          Layer_t::MultiHeadAttention,
-                                      Layer_t::MLP};
+                                      Layer_t::MLP,          Layer_t::FusedAddLayerNorm,
+                                      Layer_t::GroupedMLP};
 
 std::map<Embedding_t, std::string> EMBEDDING_TYPE_TO_STRING = {
     {Embedding_t::DistributedSlotSparseEmbeddingHash, "DistributedSlotSparseEmbeddingHash"},
@@ -134,7 +147,9 @@ std::map<Initializer_t, std::string> INITIALIZER_TYPE_TO_STRING = {
     {Initializer_t::Zero, "Zero"}};
 
 std::map<AllReduceAlgo, std::string> ALLREDUCE_ALGO_TO_STRING = {
-    {AllReduceAlgo::ONESHOT, "OneShot"}, {AllReduceAlgo::NCCL, "NCCL"}};
+    {AllReduceAlgo::ONESHOT, "OneShot"},
+    {AllReduceAlgo::NCCL, "NCCL"},
+    {AllReduceAlgo::HIERARCHICAL, "Hierarchical"}};
 
 std::map<hybrid_embedding::CommunicationType, std::string> HE_COMM_TYPE_TO_STRING = {
     {hybrid_embedding::CommunicationType::IB_NVLink_Hier, "IB_NVLink_Hierarchical"},
@@ -228,18 +243,25 @@ struct EmbeddingTrainingCacheParams {
   std::vector<std::string> local_paths;
   std::vector<HMemCacheConfig> hmem_cache_configs;
   std::vector<std::string> incremental_keyset_files;
+  // Whether fit() stages the next pass while the current one trains.
+  bool prefetch_next_pass;
+  // How the Staged PS writes the updated vectors back to the sparse models.
+  WritebackConfig writeback_config;
   EmbeddingTrainingCacheParams(std::vector<TrainPSType_t>& _ps_types,
                                std::vector<std::string>& _sparse_models,
                                std::vector<std::string>& _local_paths,
-                               std::vector<HMemCacheConfig>& _hmem_cache_configs);
+                               std::vector<HMemCacheConfig>& _hmem_cache_configs,
+                               bool _prefetch_next_pass = false,
+                               const WritebackConfig& _writeback_config = {});
   EmbeddingTrainingCacheParams();
 };
 
 struct DenseLayerComputeConfig {
   bool async_wgrad;
   bool fuse_wb;
+  bool use_fp8;
   DenseLayerComputeConfig();
-  DenseLayerComputeConfig(bool async_wgrad, bool fuse_wb);
+  DenseLayerComputeConfig(bool async_wgrad, bool fuse_wb, bool use_fp8);
 };
 
 struct DenseLayer {
@@ -273,6 +295,7 @@ struct DenseLayer {
   int max_sequence_len_to;
   int num_attention_heads;
   bool transpose_b;
+  bool recompute_activations;
   std::vector<float> target_weight_vec;
   bool use_regularizer;
   Regularizer_t regularizer_type;
@@ -292,6 +315,12 @@ struct DenseLayer {
   int dim;
   std::vector<int64_t> index;
 
+  // fused elementwise layer param: the chain which the layer runs
+  std::vector<DenseLayer> fused_layers;
+
+  // grouped mlp layer param: the number of experts, which num_outputs and act_type describe
+  size_t num_experts = 1;
+
   DenseLayer(Layer_t layer_type, std::vector<std::string>& bottom_names,
              std::vector<std::string>& top_names, float factor = 1.0, float eps = 0.00001,
              Initializer_t gamma_init_type = Initializer_t::Default,
@@ -316,7 +345,7 @@ struct DenseLayer {
              std::vector<bool> biases = std::vector<bool>(),
              DenseLayerComputeConfig compute_config = DenseLayerComputeConfig(),
              const std::vector<int64_t>& reshape_out_dimension = {}, int dim = 0,
-             const std::vector<int64_t>& index = {});
+             const std::vector<int64_t>& index = {}, bool recompute_activations = false);
 };
 
 struct GroupDenseLayer {
@@ -325,9 +354,10 @@ struct GroupDenseLayer {
   std::vector<std::string> top_name_list;
   std::vector<size_t> num_outputs;
   Activation_t last_act_type;
+  size_t num_experts;
   GroupDenseLayer(GroupLayer_t group_layer_type, std::vector<std::string>& bottom_name_list,
                   std::vector<std::string>& top_name_list, std::vector<size_t>& num_outputs,
-                  Activation_t last_act_type = Activation_t::Relu);
+                  Activation_t last_act_type = Activation_t::Relu, size_t num_experts = 1);
 };
 
 class CopyOp {
@@ -371,8 +401,8 @@ void add_input(Input& input, DataReaderParams& reader_params,
                std::shared_ptr<IDataReader>& evaluate_data_reader,
                std::shared_ptr<IDataReader>& init_data_reader, size_t batch_size,
                size_t batch_size_eval, bool use_mixed_precision, bool repeat_dataset,
-               bool train_intra_iteration_overlap, size_t num_iterations_statistics,
-               const std::shared_ptr<ResourceManager>);
+               bool train_intra_iteration_overlap, bool use_cuda_graph,
+               size_t num_iterations_statistics, const std::shared_ptr<ResourceManager>);
 
 template <typename TypeKey, typename TypeFP>
 void add_sparse_embedding(
@@ -402,6 +432,32 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
 void calculate_tensor_dimensions(std::map<std::string, std::vector<int>>& tensor_shape_info_raw,
                                  DenseLayer& dense_layer);
 
+/**
+ * Replaces each LayerNorm of the sum of an Add layer, and optionally of a Dropout layer before one
+ * of its bottoms, by a FusedAddLayerNorm layer if no other layer reads the intermediate tensors.
+ * The gamma and beta of the LayerNorm keep their place among the weights.
+ */
+std::vector<DenseLayer> fuse_add_layer_norm_layers(const std::vector<DenseLayer>& dense_layers);
+
+/**
+ * Replaces the chains of Add, Sub, ElementwiseMultiply, ReLU, Sigmoid and Dropout layers in
+ * dense_layers by FusedElementwise layers. A layer extends the chain whose last layer computes one
+ * of its bottoms if no other layer reads that tensor.
+ */
+std::vector<DenseLayer> fuse_elementwise_layers(const std::vector<DenseLayer>& dense_layers,
+                                                bool use_mixed_precision);
+
+/**
+ * Sets the lifetimes of the tensors in the blobs buffer channel that the dense layers pass to each
+ * other, in steps of the execution of the layers, so that the buffer shares the memory of the
+ * tensors that are never used at the same time. The fprop of layer i is step i. In training, the
+ * bprop of layer i is step 2 * num_layers - 1 - i, in which it reads the gradient of its tops back
+ * from them. The tensors which are read outside the dense layers, e.g., by the losses, keep their
+ * memory for the whole iteration, and must be called with all the steps.
+ */
+void plan_activation_lifetimes(const std::vector<DenseLayer>& dense_layers,
+                               const std::vector<TensorEntity>& tensor_entities, bool is_train);
+
 void init_optimizer_params(OptParams& opt_params, const Solver& solver,
                            const std::shared_ptr<OptParamsPy>& opt_params_py);
 
@@ -451,7 +507,7 @@ class Model final {
   void summary();
 
   void fit(int num_epochs, int max_iter, int display, int eval_interval, int snapshot,
-           std::string snapshot_prefix);
+           std::string snapshot_prefix, bool snapshot_async = false);
 
   void set_source(std::vector<std::string> source, std::vector<std::string> keyset,
                   std::string eval_source);
@@ -464,6 +520,9 @@ class Model final {
 
   std::vector<std::pair<std::string, float>> get_eval_metrics();
 
+  // Device, tag, current and peak bytes of each tag of the memory usage of the tensors.
+  std::vector<std::tuple<std::string, std::string, int64_t, int64_t>> get_memory_usage();
+
   Error_t get_current_loss(float* loss);
 
   Error_t download_params_to_files(std::string prefix, int iter);
@@ -539,7 +598,8 @@ class Model final {
   }
 
   bool use_gpu_learning_rate_scheduling() const {
-    return !embeddings_.empty() && !embeddings_[0]->get_learning_rate_schedulers().empty();
+    return solver_.gpu_learning_rate_scheduling ||
+           (!embeddings_.empty() && !embeddings_[0]->get_learning_rate_schedulers().empty());
   }
 
   void load_dense_weights(const std::string& dense_model_file);
@@ -547,8 +607,29 @@ class Model final {
   void load_sparse_weights(const std::map<std::string, std::string>& sparse_embedding_files_maps);
   void load_dense_optimizer_states(const std::string& dense_opt_states_file);
   void load_sparse_optimizer_states(const std::vector<std::string>& sparse_opt_states_files);
-  void embedding_load(const std::string& path, const std::vector<std::string>& table_names);
-  void embedding_dump(const std::string& path, const std::vector<std::string>& table_names);
+  /**
+   * Loads the tables of the embedding collections from path. The rows are streamed in chunks that
+   * num_threads threads read ahead, see embedding::EmbeddingParameterIO::load_embedding_table.
+   */
+  void embedding_load(const std::string& path, const std::vector<std::string>& table_names,
+                      int num_threads = 1);
+  /**
+   * Dumps the tables of the embedding collections to path. With more than one thread,
+   * incremental or a compression codec ("lz4", "zstd" or "bitcomp"), the tables are written as
+   * chunks, see embedding::ShardedCheckpointWriter.
+   */
+  void embedding_dump(const std::string& path, const std::vector<std::string>& table_names,
+                      int num_threads = 1, bool incremental = false,
+                      const std::string& compression = "");
+  /**
+   * Writes each table of the embedding collections as a sparse model of the HPS to
+   * path/<table name>. The rows of dynamic tables with an eviction policy are pruned by their
+   * lookups, see embedding::IGroupedEmbeddingTable::dump_pruned_by_id. The rows are compressed
+   * with the compression codec, if any.
+   */
+  void embedding_export(const std::string& path, const std::vector<std::string>& table_names,
+                        uint32_t min_lookup_count = 0, uint32_t max_idle_iterations = 0,
+                        const std::string& compression = "");
   void load_sparse_optimizer_states(
       const std::map<std::string, std::string>& sparse_opt_states_files_map);
   void freeze_embedding() {
@@ -580,6 +661,22 @@ class Model final {
   std::vector<std::pair<std::vector<long long>, std::vector<float>>>& get_incremental_model();
   void dump_incremental_model_2kafka();
 
+  /**
+   * Saves the position of the train data reader of the multi-hot RawAsync reader, from which
+   * AsyncParam::resume_state restarts training. The batch prefetched beyond the last trained one
+   * is not counted, so the position is the next batch to train.
+   */
+  void save_data_reader_state(const std::string& file_name);
+
+  /**
+   * Pushes a batch to the train or the evaluation reader of the InMemory reader type, and blocks
+   * while its queue is full, see InMemoryDataReader::push. It can be called while fit runs.
+   */
+  void push_batch(InMemoryBatch batch, bool is_train = true);
+
+  // Ends the data of the train or the evaluation reader, e.g. the epoch of fit in epoch mode.
+  void finish_batches(bool is_train = true);
+
   std::tuple<size_t, size_t, std::vector<size_t>, int> get_tensor_info_by_name(
       const std::string& tensor_name, Tensor_t tensor_type);
 
@@ -661,9 +758,24 @@ class Model final {
       resource_manager_; /**< GPU resources include handles and streams etc.*/
   std::shared_ptr<embedding::EmbeddingParameterIO> embedding_para_io_;
   metrics::Metrics metrics_; /**< evaluation metrics. */
+  // Runs local_reduce of metrics_ after each evaluation batch.
+  std::unique_ptr<metrics::FusedLocalReduce> fused_local_reduce_;
 
   std::shared_ptr<IDataReader> init_data_reader_;
   std::shared_ptr<ExchangeWgrad> exchange_wgrad_;
+  // Dense wgrad of the micro-batches of solver_.gradient_accumulation_steps, summed over all but
+  // the last micro-batch of an update.
+  std::vector<void*> accumulated_wgrad_ptrs_;
+  std::vector<std::shared_ptr<GeneralBuffer2<CudaAllocator>>> wgrad_accumulator_bufs_;
+  std::vector<Tensor2<float>> wgrad_accumulators_;
+  size_t accumulation_step_{0};
+  // Loss scale of solver_.dynamic_loss_scaling on each GPU, and the overflow flag that skips the
+  // update followed by the number of updates since the last overflow.
+  std::vector<void*> loss_scaled_wgrad_ptrs_;
+  size_t loss_scaled_wgrad_count_{0};
+  std::vector<std::shared_ptr<GeneralBuffer2<CudaAllocator>>> loss_scale_bufs_;
+  std::vector<Tensor2<float>> loss_scales_;
+  std::vector<Tensor2<int>> loss_scale_states_;
   bool embedding_dependent_;
   bool high_level_eval_;
   HugeCTR::Timer timer_log;
@@ -673,6 +785,8 @@ class Model final {
   std::shared_ptr<DataDistributor> train_data_distributor_, eval_data_distributor_;
 
   std::vector<std::shared_ptr<TrainingCallback>> training_callbacks_;
+  // Phase times of solver_.step_time_report_interval, which the training pipelines report.
+  std::unique_ptr<StepTimer> step_timer_;
 
   Error_t download_dense_params_to_files_(std::string weights_file,
                                           std::string dense_opt_states_file);
@@ -680,6 +794,21 @@ class Model final {
   Error_t download_sparse_params_to_files_(const std::vector<std::string>& embedding_files,
                                            const std::vector<std::string>& sparse_opt_state_files);
 
+  /**
+   * Takes a snapshot like download_params_to_files(), but only copies the dense weights and
+   * optimizer states to pinned host memory, and writes them in the background. The sparse tables
+   * are still dumped at the iteration boundary, as their dump is collective over the ranks, except
+   * that the embedding training cache writes its file back in the background.
+   */
+  Error_t download_params_to_files_async_(std::string prefix, int iter);
+
+  // Waits for the dense files of the last asynchronous snapshot to be written.
+  Error_t wait_for_snapshot_();
+
+  std::future<Error_t> snapshot_writer_;
+  char* snapshot_staging_{nullptr}; /**< pinned dense weights and optimizer states. */
+  size_t snapshot_staging_size_{0};
+
   template <typename TypeEmbeddingComp>
   std::shared_ptr<EmbeddingTrainingCache> create_embedding_training_cache_(
       const std::vector<TrainPSType_t>& ps_types,
@@ -687,6 +816,25 @@ class Model final {
       const std::vector<std::string>& local_paths,
       const std::vector<HMemCacheConfig>& hmem_cache_configs);
   void init_params_for_dense_();
+  // The number of GPUs across which the dense optimizer is sharded, 1 if it isn't.
+  size_t get_num_dense_optimizer_shards_() const;
+  void init_wgrad_buckets_(const std::vector<void*>& wgrad_buffer_ptrs, size_t wgrad_buffer_size);
+  void init_wgrad_accumulation_(const std::vector<void*>& wgrad_buffer_ptrs,
+                                size_t wgrad_buffer_size);
+  // Adds the dense wgrad of the micro-batch to the accumulators. Returns true if it was the last
+  // micro-batch of the update, whose wgrad is then replaced with the mean of all micro-batches.
+  bool accumulate_wgrad_();
+  void init_dynamic_loss_scaling_(const std::vector<void*>& wgrad_buffer_ptrs,
+                                  size_t wgrad_buffer_size);
+  // Rescale the gradients from the dynamic loss scale to the scaler and flag non-finite ones. The
+  // top gradients of the embeddings are checked before their backward, and their non-finite values
+  // are zeroed, as the embedding updates are not skipped. The flags of all GPUs are combined with
+  // the check of the dense wgrad after its all-reduce.
+  void unscale_embedding_grads_();
+  void unscale_dense_wgrad_(size_t device_id);
+  // Halves the loss scale after an overflow, and doubles it after
+  // solver_.loss_scale_growth_interval updates without one.
+  void update_loss_scale_(size_t device_id);
   void init_params_for_sparse_();
   void init_embedding_training_cache_(const std::vector<TrainPSType_t>& ps_types,
                                       const std::vector<std::string>& sparse_embedding_files,
@@ -752,10 +900,14 @@ class Model final {
 
   Graph graph_;
 
+  // Stream of the evaluation network when solver_.overlap_eval is set.
+  static constexpr const char* overlapped_eval_stream_name = "overlapped_eval";
+
   void create_copy_ops_for_network_input(const std::string& dense_name,
                                          const std::string& label_name, bool is_train);
   bool is_scheduled_datareader() {
-    return (reader_params_.data_reader_type == DataReaderType_t::RawAsync);
+    return (reader_params_.data_reader_type == DataReaderType_t::RawAsync ||
+            reader_params_.data_reader_type == DataReaderType_t::InMemory);
   }
   bool is_scheduled_embedding() {
     return (embeddings_.size() == 1 &&
@@ -780,6 +932,12 @@ class Model final {
   void evaluate_pipeline(size_t current_batch_size);
   void train_pipeline_with_ebc();
   void evaluate_pipeline_with_ebc();
+  long long read_eval_batch_();
+  void lookup_eval_embeddings_();
+  // Runs the evaluation network, on the overlapped evaluation stream with solver_.overlap_eval.
+  void run_eval_network_();
+  // Blocks the host until the overlapped evaluation that was launched last has finished.
+  void wait_for_overlapped_eval_();
 };
 
 }  // namespace HugeCTR
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <hps/dlpack.h>
+#include <optional>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -25,6 +27,72 @@ namespace HugeCTR {
 
 namespace python_lib {
 
+/**
+ * Binds a tensor with __dlpack__, e.g. a torch or cupy tensor, or a DLPack capsule to a core23
+ * tensor without a copy. The capsule is consumed, and its managed tensor is deleted with the last
+ * copy of the owner that is added to owners.
+ */
+core23::Tensor tensor_from_dlpack(pybind11::object obj,
+                                  std::vector<std::shared_ptr<void>> &owners) {
+  if (pybind11::hasattr(obj, "__dlpack__")) {
+    obj = obj.attr("__dlpack__")();
+  }
+  HCTR_THROW_IF(!PyCapsule_IsValid(obj.ptr(), "dltensor"), Error_t::WrongInput,
+                "Expected a tensor with __dlpack__ or a DLPack capsule. Note that DLPack capsules "
+                "can be consumed only once");
+  auto dlmt = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(obj.ptr(), "dltensor"));
+  PyCapsule_SetName(obj.ptr(), "used_dltensor");
+  owners.emplace_back(dlmt, [](DLManagedTensor *tensor) {
+    if (tensor->deleter) {
+      // The deleters of the producers may release python objects.
+      pybind11::gil_scoped_acquire gil;
+      tensor->deleter(tensor);
+    }
+  });
+
+  const DLTensor &dl_tensor = dlmt->dl_tensor;
+  std::vector<int64_t> shape(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+  if (dl_tensor.strides) {
+    int64_t stride = 1;
+    for (int dim = dl_tensor.ndim - 1; dim >= 0; --dim) {
+      HCTR_THROW_IF(shape[dim] > 1 && dl_tensor.strides[dim] != stride, Error_t::WrongInput,
+                    "DLPack tensors must be contiguous");
+      stride *= shape[dim];
+    }
+  }
+
+  const DLDataType &dtype = dl_tensor.dtype;
+  HCTR_THROW_IF(dtype.lanes != 1, Error_t::WrongInput, "DLPack tensors must have one lane");
+  std::optional<core23::DataType> data_type;
+  if (dtype.code == kDLFloat && dtype.bits == 32) {
+    data_type = core23::ScalarType::Float;
+  } else if (dtype.code == kDLFloat && dtype.bits == 16) {
+    data_type = core23::ScalarType::Half;
+  } else if (dtype.code == kDLInt && dtype.bits == 32) {
+    data_type = core23::ScalarType::Int32;
+  } else if (dtype.code == kDLInt && dtype.bits == 64) {
+    data_type = core23::ScalarType::Int64;
+  } else if (dtype.code == kDLUInt && dtype.bits == 32) {
+    data_type = core23::ScalarType::UInt32;
+  } else if (dtype.code == kDLUInt && dtype.bits == 64) {
+    data_type = core23::ScalarType::UInt64;
+  }
+  HCTR_THROW_IF(!data_type, Error_t::WrongInput, "Unsupported DLPack data type, code ",
+                static_cast<int>(dtype.code), " bits ", static_cast<int>(dtype.bits));
+
+  const DLDeviceType device_type = dl_tensor.device.device_type;
+  HCTR_THROW_IF(device_type != kDLCPU && device_type != kDLCUDAHost && device_type != kDLCUDA,
+                Error_t::WrongInput, "Unsupported DLPack device type ",
+                static_cast<int>(device_type));
+  const core23::Device device =
+      device_type == kDLCUDA
+          ? core23::Device(core23::DeviceType::GPU,
+                           static_cast<core23::DeviceIndex>(dl_tensor.device.device_id))
+          : core23::Device(core23::DeviceType::CPU);
+  return core23::Tensor::bind(static_cast<char *>(dl_tensor.data) + dl_tensor.byte_offset, shape,
+                              *data_type, device);
+}
+
 void ModelPybind(pybind11::module &m) {
   pybind11::class_<HugeCTR::DataReaderParams, std::shared_ptr<HugeCTR::DataReaderParams>>(
       m, "DataReaderParams")
@@ -80,10 +148,11 @@ void ModelPybind(pybind11::module &m) {
            pybind11::arg("hybrid_embedding_param") =
                HybridEmbeddingParam{1, -1, 0.01, 1.3e11, 2.6e11, 1.0,
                                     hybrid_embedding::CommunicationType::NVLink_SingleNode,
-                                    hybrid_embedding::HybridEmbeddingType::Distributed});
+                                    hybrid_embedding::HybridEmbeddingType::Distributed, "",
+                                    0});
   pybind11::class_<HugeCTR::DenseLayerComputeConfig>(m, "DenseLayerComputeConfig")
-      .def(pybind11::init<bool, bool>(), pybind11::arg("async_wgrad") = false,
-           pybind11::arg("fuse_wb") = false);
+      .def(pybind11::init<bool, bool, bool>(), pybind11::arg("async_wgrad") = false,
+           pybind11::arg("fuse_wb") = false, pybind11::arg("use_fp8") = false);
   pybind11::class_<HugeCTR::DenseLayer, std::shared_ptr<HugeCTR::DenseLayer>>(m, "DenseLayer")
       .def(pybind11::init<Layer_t, std::vector<std::string> &, std::vector<std::string> &, float,
                           float, Initializer_t, Initializer_t, float, float, size_t, Initializer_t,
@@ -93,7 +162,7 @@ void ModelPybind(pybind11::module &m) {
                           int, bool, std::vector<float> &, bool, Regularizer_t, float, FcPosition_t,
                           Activation_t, std::vector<size_t>, bool, std::vector<Activation_t>,
                           std::vector<bool>, DenseLayerComputeConfig, const std::vector<int64_t> &,
-                          int, const std::vector<int64_t> &>(),
+                          int, const std::vector<int64_t> &, bool>(),
            pybind11::arg("layer_type"), pybind11::arg("bottom_names"), pybind11::arg("top_names"),
            pybind11::arg("factor") = 1.0, pybind11::arg("eps") = 0.00001,
            pybind11::arg("gamma_init_type") = Initializer_t::Default,
@@ -123,15 +192,16 @@ void ModelPybind(pybind11::module &m) {
            pybind11::arg("biases") = std::vector<bool>(),
            pybind11::arg("compute_config") = DenseLayerComputeConfig(),
            pybind11::arg("shape") = std::vector<int64_t>(), pybind11::arg("dim") = 0,
-           pybind11::arg("index") = std::vector<int64_t>());
+           pybind11::arg("index") = std::vector<int64_t>(),
+           pybind11::arg("recompute_activations") = false);
 
   pybind11::class_<HugeCTR::GroupDenseLayer, std::shared_ptr<HugeCTR::GroupDenseLayer>>(
       m, "GroupDenseLayer")
       .def(pybind11::init<GroupLayer_t, std::vector<std::string> &, std::vector<std::string> &,
-                          std::vector<size_t> &, Activation_t>(),
+                          std::vector<size_t> &, Activation_t, size_t>(),
            pybind11::arg("group_layer_type"), pybind11::arg("bottom_name_list"),
            pybind11::arg("top_name_list"), pybind11::arg("num_outputs"),
-           pybind11::arg("last_act_type") = Activation_t::Relu);
+           pybind11::arg("last_act_type") = Activation_t::Relu, pybind11::arg("num_experts") = 1);
   pybind11::class_<HugeCTR::Model, std::shared_ptr<HugeCTR::Model>>(m, "Model")
       .def(pybind11::init<const Solver &, const DataReaderParams &, std::shared_ptr<OptParamsPy> &,
                           std::shared_ptr<EmbeddingTrainingCacheParams> &>(),
@@ -147,7 +217,8 @@ void ModelPybind(pybind11::module &m) {
       .def("fit", &HugeCTR::Model::fit, pybind11::arg("num_epochs") = 0,
            pybind11::arg("max_iter") = 2000, pybind11::arg("display") = 200,
            pybind11::arg("eval_interval") = 1000, pybind11::arg("snapshot") = 10000,
-           pybind11::arg("snapshot_prefix") = "")
+           pybind11::arg("snapshot_prefix") = "", pybind11::arg("snapshot_async") = false,
+           pybind11::call_guard<pybind11::gil_scoped_release>())
       .def("set_source",
            pybind11::overload_cast<std::vector<std::string>, std::vector<std::string>, std::string>(
                &HugeCTR::Model::set_source),
@@ -182,14 +253,17 @@ void ModelPybind(pybind11::module &m) {
            pybind11::overload_cast<const std::map<std::string, std::string> &>(
                &HugeCTR::Model::load_sparse_weights),
            pybind11::arg("sparse_embedding_files_map"))
-      .def("embedding_load",
-           pybind11::overload_cast<const std::string &, const std::vector<std::string> &>(
-               &HugeCTR::Model::embedding_load),
-           pybind11::arg("path"), pybind11::arg("table_names") = std::vector<std::string>())
-      .def("embedding_dump",
-           pybind11::overload_cast<const std::string &, const std::vector<std::string> &>(
-               &HugeCTR::Model::embedding_dump),
-           pybind11::arg("path"), pybind11::arg("table_names") = std::vector<std::string>())
+      .def("embedding_load", &HugeCTR::Model::embedding_load, pybind11::arg("path"),
+           pybind11::arg("table_names") = std::vector<std::string>(),
+           pybind11::arg("num_threads") = 1)
+      .def("embedding_dump", &HugeCTR::Model::embedding_dump, pybind11::arg("path"),
+           pybind11::arg("table_names") = std::vector<std::string>(),
+           pybind11::arg("num_threads") = 1, pybind11::arg("incremental") = false,
+           pybind11::arg("compression") = "")
+      .def("embedding_export", &HugeCTR::Model::embedding_export, pybind11::arg("path"),
+           pybind11::arg("table_names") = std::vector<std::string>(),
+           pybind11::arg("min_lookup_count") = 0, pybind11::arg("max_idle_iterations") = 0,
+           pybind11::arg("compression") = "")
       .def("load_dense_optimizer_states", &HugeCTR::Model::load_dense_optimizer_states,
            pybind11::arg("dense_opt_states_file"))
       .def("load_sparse_optimizer_states",
@@ -210,8 +284,37 @@ void ModelPybind(pybind11::module &m) {
       .def("add", pybind11::overload_cast<const EmbeddingCollectionConfig &>(&HugeCTR::Model::add),
            pybind11::arg("ebc_config"))
       .def("set_learning_rate", &HugeCTR::Model::set_learning_rate, pybind11::arg("lr"))
-      .def("train", &HugeCTR::Model::train)
-      .def("eval", &HugeCTR::Model::eval)
+      .def("train", &HugeCTR::Model::train, pybind11::call_guard<pybind11::gil_scoped_release>())
+      .def("eval", &HugeCTR::Model::eval, pybind11::call_guard<pybind11::gil_scoped_release>())
+      .def(
+          "push_batch",
+          [](HugeCTR::Model &self, const std::vector<pybind11::object> &labels,
+             const std::vector<pybind11::object> &dense,
+             const std::vector<std::vector<pybind11::object>> &sparse, bool is_train) {
+            auto owners = std::make_shared<std::vector<std::shared_ptr<void>>>();
+            InMemoryBatch batch;
+            for (const auto &label : labels) {
+              batch.labels.push_back(tensor_from_dlpack(label, *owners));
+            }
+            for (const auto &one_dense : dense) {
+              batch.dense.push_back(tensor_from_dlpack(one_dense, *owners));
+            }
+            for (const auto &features : sparse) {
+              std::vector<core23::Tensor> values;
+              for (const auto &feature : features) {
+                values.push_back(tensor_from_dlpack(feature, *owners));
+              }
+              batch.sparse.push_back(values);
+            }
+            batch.owner = owners;
+            // Training can go on while the queue is full.
+            pybind11::gil_scoped_release release;
+            self.push_batch(std::move(batch), is_train);
+          },
+          pybind11::arg("labels"), pybind11::arg("dense"), pybind11::arg("sparse"),
+          pybind11::arg("is_train") = true)
+      .def("finish_batches", &HugeCTR::Model::finish_batches, pybind11::arg("is_train") = true,
+           pybind11::call_guard<pybind11::gil_scoped_release>())
       .def("start_data_reading", &HugeCTR::Model::start_data_reading)
       .def("get_current_loss",
            [](HugeCTR::Model &self) {
@@ -220,6 +323,7 @@ void ModelPybind(pybind11::module &m) {
              return loss;
            })
       .def("get_eval_metrics", &HugeCTR::Model::get_eval_metrics)
+      .def("get_memory_usage", &HugeCTR::Model::get_memory_usage)
       .def("get_incremental_model",
            [](HugeCTR::Model &self) {
              auto inc_sparse_model = self.get_incremental_model();
@@ -248,6 +352,8 @@ void ModelPybind(pybind11::module &m) {
              return array_inc_sparse_model;
            })
       .def("dump_incremental_model_2kafka", &HugeCTR::Model::dump_incremental_model_2kafka)
+      .def("save_data_reader_state", &HugeCTR::Model::save_data_reader_state,
+           pybind11::arg("file_name"))
       .def("save_params_to_files", &HugeCTR::Model::download_params_to_files,
            pybind11::arg("prefix"), pybind11::arg("iter") = 0)
       .def("get_embedding_training_cache", &HugeCTR::Model::get_embedding_training_cache)
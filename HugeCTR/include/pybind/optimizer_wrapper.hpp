@@ -27,7 +27,9 @@ namespace python_lib {
 std::shared_ptr<OptParamsPy> CreateOptimizer(Optimizer_t optimizer_type, Update_t update_type,
                                              float beta, float lambda1, float lambda2, float beta1,
                                              float beta2, float epsilon, float initial_accu_value,
-                                             float momentum_factor, bool atomic_update) {
+                                             float momentum_factor, bool atomic_update,
+                                             bool row_wise, bool half_state, float weight_decay,
+                                             float trust_coefficient) {
   std::shared_ptr<OptParamsPy> opt_params;
   OptHyperParams opt_hyper_params;
   opt_hyper_params.ftrl.beta = beta;
@@ -36,11 +38,21 @@ std::shared_ptr<OptParamsPy> CreateOptimizer(Optimizer_t optimizer_type, Update_
   opt_hyper_params.adam.beta1 = beta1;
   opt_hyper_params.adam.beta2 = beta2;
   opt_hyper_params.adam.epsilon = epsilon;
+  opt_hyper_params.adam.half_state = half_state;
   opt_hyper_params.adagrad.initial_accu_value = initial_accu_value;
   opt_hyper_params.adagrad.epsilon = epsilon;
+  opt_hyper_params.adagrad.row_wise = row_wise;
   opt_hyper_params.momentum.factor = momentum_factor;
   opt_hyper_params.nesterov.mu = momentum_factor;
   opt_hyper_params.sgd.atomic_update = atomic_update;
+  opt_hyper_params.lamb.beta1 = beta1;
+  opt_hyper_params.lamb.beta2 = beta2;
+  opt_hyper_params.lamb.epsilon = epsilon;
+  opt_hyper_params.lamb.weight_decay = weight_decay;
+  opt_hyper_params.lars.momentum = momentum_factor;
+  opt_hyper_params.lars.trust_coefficient = trust_coefficient;
+  opt_hyper_params.lars.epsilon = epsilon;
+  opt_hyper_params.lars.weight_decay = weight_decay;
   opt_params.reset(new OptParamsPy(optimizer_type, update_type, opt_hyper_params));
   return opt_params;
 }
@@ -53,7 +65,9 @@ void OptimizerPybind(pybind11::module& m) {
         pybind11::arg("lambda1") = 0.f, pybind11::arg("lambda2") = 0.f,
         pybind11::arg("beta1") = 0.9, pybind11::arg("beta2") = 0.999,
         pybind11::arg("epsilon") = 0.0000001, pybind11::arg("initial_accu_value") = 0.f,
-        pybind11::arg("momentum_factor") = 0.0, pybind11::arg("atomic_update") = true);
+        pybind11::arg("momentum_factor") = 0.0, pybind11::arg("atomic_update") = true,
+        pybind11::arg("row_wise") = false, pybind11::arg("half_state") = false,
+        pybind11::arg("weight_decay") = 0.f, pybind11::arg("trust_coefficient") = 0.001);
 }
 
 }  // namespace python_lib
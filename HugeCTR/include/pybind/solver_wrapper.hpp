@@ -31,12 +31,21 @@ std::unique_ptr<Solver> CreateSolver(
     int max_eval_batches, int batchsize_eval, int batchsize,
     const std::vector<std::vector<int>>& vvgpu, bool repeat_dataset, bool use_mixed_precision,
     bool enable_tf32_compute, float scaler, std::map<metrics::Type, float> metrics_spec,
-    bool i64_input_key, bool use_algorithm_search, bool use_cuda_graph, bool gen_loss_summary,
+    bool i64_input_key, bool use_algorithm_search, const std::string& algorithm_cache_file,
+    bool fuse_elementwise_layers, bool fuse_add_layer_norm_layers, bool plan_activation_memory,
+    bool use_cuda_graph, bool gen_loss_summary,
     bool train_intra_iteration_overlap, bool train_inter_iteration_overlap,
     bool eval_intra_iteration_overlap, bool eval_inter_iteration_overlap,
     DeviceMap::Layout device_layout, bool use_embedding_collection, AllReduceAlgo all_reduce_algo,
-    bool grouped_all_reduce, size_t num_iterations_statistics, bool perf_logging,
-    bool drop_incomplete_batch, std::string& kafka_brokers,
+    bool grouped_all_reduce, size_t dense_wgrad_bucket_size_mb,
+    WgradCompression_t dense_wgrad_compression, bool shard_dense_optimizer,
+    size_t gradient_accumulation_steps, bool dynamic_loss_scaling,
+    size_t loss_scale_growth_interval, size_t dense_branch_streams, bool overlap_eval,
+    bool gpu_learning_rate_scheduling, size_t num_iterations_statistics,
+    bool perf_logging, bool drop_incomplete_batch, std::string& kafka_brokers,
+    bool kafka_columnar_format, DatabaseValueEncoding_t kafka_value_encoding,
+    const std::string& kafka_compression_codec, bool export_mapped_sparse_model,
+    size_t step_time_report_interval, float straggler_threshold,
     const std::vector<std::shared_ptr<TrainingCallback>>& training_callbacks) {
   if (use_mixed_precision && enable_tf32_compute) {
     HCTR_OWN_THROW(Error_t::WrongInput,
@@ -68,6 +77,10 @@ std::unique_ptr<Solver> CreateSolver(
   solver->metrics_spec = metrics_spec;
   solver->i64_input_key = i64_input_key;
   solver->use_algorithm_search = use_algorithm_search;
+  solver->algorithm_cache_file = algorithm_cache_file;
+  solver->fuse_elementwise_layers = fuse_elementwise_layers;
+  solver->fuse_add_layer_norm_layers = fuse_add_layer_norm_layers;
+  solver->plan_activation_memory = plan_activation_memory;
   solver->use_cuda_graph = use_cuda_graph;
   solver->gen_loss_summary = gen_loss_summary;
   solver->train_intra_iteration_overlap = train_intra_iteration_overlap;
@@ -78,10 +91,38 @@ std::unique_ptr<Solver> CreateSolver(
   solver->use_embedding_collection = use_embedding_collection;
   solver->all_reduce_algo = all_reduce_algo;
   solver->grouped_all_reduce = grouped_all_reduce;
+  solver->dense_wgrad_bucket_size_mb = dense_wgrad_bucket_size_mb;
+  solver->dense_wgrad_compression = dense_wgrad_compression;
+  solver->shard_dense_optimizer = shard_dense_optimizer;
+  if (gradient_accumulation_steps == 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "gradient_accumulation_steps must be greater than 0");
+  }
+  solver->gradient_accumulation_steps = gradient_accumulation_steps;
+  if (dynamic_loss_scaling && (scaler < 1.f || loss_scale_growth_interval == 0)) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "dynamic_loss_scaling requires scaler >= 1 and loss_scale_growth_interval > 0");
+  }
+  solver->dynamic_loss_scaling = dynamic_loss_scaling;
+  solver->loss_scale_growth_interval = loss_scale_growth_interval;
+  if (dense_branch_streams == 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "dense_branch_streams must be greater than 0");
+  }
+  solver->dense_branch_streams = dense_branch_streams;
+  solver->overlap_eval = overlap_eval;
+  solver->gpu_learning_rate_scheduling = gpu_learning_rate_scheduling;
   solver->num_iterations_statistics = num_iterations_statistics;
   solver->perf_logging = perf_logging;
   solver->drop_incomplete_batch = drop_incomplete_batch;
   solver->kafka_brokers = kafka_brokers;
+  solver->kafka_columnar_format = kafka_columnar_format;
+  solver->kafka_value_encoding = kafka_value_encoding;
+  solver->kafka_compression_codec = kafka_compression_codec;
+  solver->export_mapped_sparse_model = export_mapped_sparse_model;
+  if (straggler_threshold < 0.f) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "straggler_threshold must not be negative");
+  }
+  solver->step_time_report_interval = step_time_report_interval;
+  solver->straggler_threshold = straggler_threshold;
   solver->training_callbacks = training_callbacks;
   return solver;
 }
@@ -109,6 +150,10 @@ void SolverPybind(pybind11::module& m) {
       .def_readonly("metrics_spec", &HugeCTR::Solver::metrics_spec)
       .def_readonly("i64_input_key", &HugeCTR::Solver::i64_input_key)
       .def_readonly("use_algorithm_search", &HugeCTR::Solver::use_algorithm_search)
+      .def_readonly("algorithm_cache_file", &HugeCTR::Solver::algorithm_cache_file)
+      .def_readonly("fuse_elementwise_layers", &HugeCTR::Solver::fuse_elementwise_layers)
+      .def_readonly("fuse_add_layer_norm_layers", &HugeCTR::Solver::fuse_add_layer_norm_layers)
+      .def_readonly("plan_activation_memory", &HugeCTR::Solver::plan_activation_memory)
       .def_readonly("use_cuda_graph", &HugeCTR::Solver::use_cuda_graph)
       .def_readonly("gen_loss_summary", &HugeCTR::Solver::gen_loss_summary)
       .def_readonly("train_intra_iteration_overlap",
@@ -120,9 +165,22 @@ void SolverPybind(pybind11::module& m) {
       .def_readonly("device_layout", &HugeCTR::Solver::device_layout)
       .def_readonly("all_reduce_algo", &HugeCTR::Solver::all_reduce_algo)
       .def_readonly("grouped_all_reduce", &HugeCTR::Solver::grouped_all_reduce)
+      .def_readonly("dense_wgrad_bucket_size_mb", &HugeCTR::Solver::dense_wgrad_bucket_size_mb)
+      .def_readonly("dense_wgrad_compression", &HugeCTR::Solver::dense_wgrad_compression)
+      .def_readonly("shard_dense_optimizer", &HugeCTR::Solver::shard_dense_optimizer)
+      .def_readonly("gradient_accumulation_steps", &HugeCTR::Solver::gradient_accumulation_steps)
+      .def_readonly("dynamic_loss_scaling", &HugeCTR::Solver::dynamic_loss_scaling)
+      .def_readonly("loss_scale_growth_interval", &HugeCTR::Solver::loss_scale_growth_interval)
+      .def_readonly("dense_branch_streams", &HugeCTR::Solver::dense_branch_streams)
+      .def_readonly("overlap_eval", &HugeCTR::Solver::overlap_eval)
+      .def_readonly("gpu_learning_rate_scheduling",
+                    &HugeCTR::Solver::gpu_learning_rate_scheduling)
       .def_readonly("num_iterations_statistics", &HugeCTR::Solver::num_iterations_statistics)
       .def_readonly("perf_logging", &HugeCTR::Solver::perf_logging)
       .def_readonly("drop_incomplete_batch", &HugeCTR::Solver::drop_incomplete_batch)
+      .def_readonly("export_mapped_sparse_model", &HugeCTR::Solver::export_mapped_sparse_model)
+      .def_readonly("step_time_report_interval", &HugeCTR::Solver::step_time_report_interval)
+      .def_readonly("straggler_threshold", &HugeCTR::Solver::straggler_threshold)
       .def_readonly("training_callbacks", &HugeCTR::Solver::training_callbacks);
   m.def("CreateSolver", &HugeCTR::python_lib::CreateSolver, pybind11::arg("model_name") = "",
         pybind11::arg("seed") = 0, pybind11::arg("lr_policy") = LrPolicy_t::fixed,
@@ -136,7 +194,11 @@ void SolverPybind(pybind11::module& m) {
         pybind11::arg("enable_tf32_compute") = false, pybind11::arg("scaler") = 1.f,
         pybind11::arg("metrics_spec") = std::map<metrics::Type, float>({{metrics::Type::AUC, 1.f}}),
         pybind11::arg("i64_input_key") = false, pybind11::arg("use_algorithm_search") = true,
-        pybind11::arg("use_cuda_graph") = true, pybind11::arg("gen_loss_summary") = true,
+        pybind11::arg("algorithm_cache_file") = "",
+        pybind11::arg("fuse_elementwise_layers") = true,
+        pybind11::arg("fuse_add_layer_norm_layers") = true,
+        pybind11::arg("plan_activation_memory") = true, pybind11::arg("use_cuda_graph") = true,
+        pybind11::arg("gen_loss_summary") = true,
         pybind11::arg("train_intra_iteration_overlap") = false,
         pybind11::arg("train_inter_iteration_overlap") = false,
         pybind11::arg("eval_intra_iteration_overlap") = false,
@@ -145,8 +207,22 @@ void SolverPybind(pybind11::module& m) {
         pybind11::arg("use_embedding_collection") = false,
         pybind11::arg("all_reduce_algo") = AllReduceAlgo::NCCL,
         pybind11::arg("grouped_all_reduce") = false,
+        pybind11::arg("dense_wgrad_bucket_size_mb") = 0,
+        pybind11::arg("dense_wgrad_compression") = WgradCompression_t::Disabled,
+        pybind11::arg("shard_dense_optimizer") = false,
+        pybind11::arg("gradient_accumulation_steps") = 1,
+        pybind11::arg("dynamic_loss_scaling") = false,
+        pybind11::arg("loss_scale_growth_interval") = 2000,
+        pybind11::arg("dense_branch_streams") = 1, pybind11::arg("overlap_eval") = false,
+        pybind11::arg("gpu_learning_rate_scheduling") = false,
         pybind11::arg("num_iterations_statistics") = 20, pybind11::arg("perf_logging") = false,
         pybind11::arg("drop_incomplete_batch") = true, pybind11::arg("kafka_brockers") = "",
+        pybind11::arg("kafka_columnar_format") = false,
+        pybind11::arg("kafka_value_encoding") = DatabaseValueEncoding_t::Raw,
+        pybind11::arg("kafka_compression_codec") = "none",
+        pybind11::arg("export_mapped_sparse_model") = false,
+        pybind11::arg("step_time_report_interval") = 0,
+        pybind11::arg("straggler_threshold") = 0.1f,
         pybind11::arg("training_callbacks") = std::vector<std::shared_ptr<TrainingCallback>>());
 }
 
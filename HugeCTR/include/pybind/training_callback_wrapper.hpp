@@ -16,6 +16,7 @@
 #pragma once
 
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 
 #include <training_callback.hpp>
 
@@ -76,12 +77,25 @@ struct PyTrainingCallback : public TrainingCallback {
   bool on_eval_end(int current_iter, const std::map<std::string, float>& eval_results) override {
     PYBIND11_OVERRIDE_PURE(bool, TrainingCallback, on_eval_end, current_iter, eval_results);
   }
+  void on_step_time_report(int current_iter, const StepTimeReport& report) override {
+    PYBIND11_OVERRIDE(void, TrainingCallback, on_step_time_report, current_iter, report);
+  }
 };
 
 void TrainingCallbackPybind(pybind11::module& m) {
+  pybind11::class_<StepTimeReport>(m, "StepTimeReport")
+      .def_readonly("iteration", &StepTimeReport::iteration)
+      .def_readonly("phases", &StepTimeReport::phases)
+      .def_readonly("gpu_phase_ms", &StepTimeReport::gpu_phase_ms)
+      .def_readonly("gpu_step_ms", &StepTimeReport::gpu_step_ms)
+      .def_readonly("median_step_ms", &StepTimeReport::median_step_ms)
+      .def_readonly("stragglers", &StepTimeReport::stragglers)
+      .def_readonly("straggling_phases", &StepTimeReport::straggling_phases);
   pybind11::class_<TrainingCallback, PyTrainingCallback, std::shared_ptr<TrainingCallback>>
       training_callback_wrap(m, "TrainingCallback");
-  training_callback_wrap.def(pybind11::init<>());
+  training_callback_wrap.def(pybind11::init<>())
+      .def("on_step_time_report", &TrainingCallback::on_step_time_report,
+           pybind11::arg("current_iter"), pybind11::arg("report"));
 }
 
 }  // namespace python_lib
@@ -0,0 +1,37 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+#pragma once
+
+#include <core23/tensor_params.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Tensor params that put the intermediates of a layer, which recomputes them in bprop instead of
+ * keeping them from fprop, into the recompute workspace of their device. The workspace is shared
+ * by all such layers, since a layer only needs its intermediates within one fprop or bprop. Each
+ * call makes a new buffer channel whose allocator hands out the workspace, so it must be called
+ * for all the layers before the buffer of any of them is allocated.
+ *
+ * @param params Params of the intermediates, whose buffer and allocator params are replaced.
+ * @param num_bytes The size of each of the intermediates, which all use the returned params.
+ */
+core23::TensorParams GetRecomputeWorkspaceTensorParams(const core23::TensorParams& params,
+                                                       const std::vector<int64_t>& num_bytes);
+
+}  // namespace HugeCTR
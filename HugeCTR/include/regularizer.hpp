@@ -79,6 +79,18 @@ class Regularizer {
    */
   float get_rterm() const { return h_rterm_; }
 
+  /*
+   * Type of the regularizer and the coefficient of its wgrad term, which an optimizer that adds
+   * the term in its update needs. See FusedUpdateParams.
+   */
+  virtual Regularizer_t get_type() const { return Regularizer_t::None; }
+  virtual float get_wgrad_coefficient() const { return 0.f; }
+
+  /*
+   * Leave the wgrad term to the optimizer, so that initialize_wgrad only zeroes the wgrad.
+   */
+  void fuse_wgrad_into_optimizer(bool fused) { wgrad_fused_ = fused; }
+
  protected:
   int get_batch_size() const { return batch_size_; }
   int get_device_id() const { return gpu_resource_->get_device_id(); }
@@ -112,6 +124,7 @@ class Regularizer {
   int batch_size_;
   float h_rterm_;
   std::shared_ptr<GPUResource> gpu_resource_;
+  bool wgrad_fused_{false};
 };
 
 }  // namespace HugeCTR
@@ -56,6 +56,11 @@ class L1Regularizer : public Regularizer<T> {
    */
   ~L1Regularizer() override {}
 
+  Regularizer_t get_type() const override { return Regularizer_t::L1; }
+  float get_wgrad_coefficient() const override {
+    return lambda_ / Regularizer<T>::get_batch_size();
+  }
+
  private:
   /*
    * Calculate rterm based on the absolute sum and scale it with lambda / (batch_size)
@@ -60,6 +60,11 @@ class L2Regularizer : public Regularizer<T> {
    */
   ~L2Regularizer() override {}
 
+  Regularizer_t get_type() const override { return Regularizer_t::L2; }
+  float get_wgrad_coefficient() const override {
+    return lambda_ / Regularizer<T>::get_batch_size();
+  }
+
  private:
   /*
    * Calculate rterm based on the dot product and scale it with lambda / (2 * batch_size)
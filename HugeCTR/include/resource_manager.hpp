@@ -46,6 +46,8 @@ class ResourceManager : public ResourceManagerBase {
   virtual bool all_p2p_enabled() const = 0;
 
   virtual DeviceMap::Layout get_device_layout() const = 0;
+  // NUMA node of the CPUs nearest to the GPU, or -1 if it is unknown.
+  virtual int get_local_gpu_numa_node(size_t local_gpu_id) const = 0;
 
   virtual const std::shared_ptr<rmm::mr::device_memory_resource>&
   get_device_rmm_device_memory_resource(int local_gpu_id) const = 0;
@@ -108,6 +108,7 @@ class ResourceManagerCore : public ResourceManager {
   bool all_p2p_enabled() const override;
 
   DeviceMap::Layout get_device_layout() const override { return device_map_.get_device_layout(); }
+  int get_local_gpu_numa_node(size_t local_gpu_id) const override;
 
   const std::shared_ptr<rmm::mr::device_memory_resource>& get_device_rmm_device_memory_resource(
       int local_gpu_id) const override;
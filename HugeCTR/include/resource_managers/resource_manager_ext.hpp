@@ -93,6 +93,9 @@ class ResourceManagerExt : public ResourceManager {
   bool all_p2p_enabled() const override { return core_->all_p2p_enabled(); }
 
   DeviceMap::Layout get_device_layout() const override { return core_->get_device_layout(); }
+  int get_local_gpu_numa_node(size_t local_gpu_id) const override {
+    return core_->get_local_gpu_numa_node(local_gpu_id);
+  }
 
   const std::shared_ptr<rmm::mr::device_memory_resource>& get_device_rmm_device_memory_resource(
       int local_gpu_id) const override {
@@ -46,6 +46,18 @@ class SchedulableDataReader : public IDataReader {
   virtual std::vector<core23::Tensor> get_dense_tensor23s() const = 0;
 };
 
+// Readers whose sparse values are distributed to the embedding collection as they are read.
+class SparseValueReader {
+ public:
+  virtual ~SparseValueReader() = default;
+
+  // The values of each feature of the current batch, by local gpu.
+  virtual std::vector<std::vector<core23::Tensor>>& get_current_sparse_values() = 0;
+  // Row offsets of the features of variable-length batches, for the bucket ranges of the data
+  // distributor. Empty for fixed hotness, whose bucket ranges are computed from the batch size.
+  virtual std::vector<std::vector<core23::Tensor>>& get_current_dp_bucket_ranges() = 0;
+};
+
 class SchedulableEmbeding : public IEmbedding {
  public:
   virtual ~SchedulableEmbeding() = default;
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "core23/data_type.hpp"
+#include "core23/low_level_primitives.hpp"
 #include "core23/tensor.hpp"
 #include "core23/tensor_operations.hpp"
 #include "data_readers/csr.hpp"
@@ -138,7 +139,14 @@ struct SparseTensorHelper {
   template <typename T>
   static void copy_async(SparseTensor23 &dst, const CSR23<T> &src,
                          core23::CUDAStream stream = core23::CUDAStream()) {
-    core23::copy_async(dst.get_value_tensor(), src.get_value_tensor(), stream);
+    // Only the values in use are copied, which are usually far fewer than the capacity of src.
+    HCTR_THROW_IF(dst.get_value_tensor().data_type() != src.get_value_tensor().data_type(),
+                  Error_t::IllegalCall, "Source and destination values have different types.");
+    HCTR_THROW_IF(src.get_num_values() > dst.max_nnz(), Error_t::OutOfBound,
+                  "The destination cannot hold the values of the source.");
+    core23::copy_async(dst.get_value_ptr(), src.get_value_tensor().data(),
+                       src.get_num_values() * sizeof(T), dst.get_value_tensor().device(),
+                       src.get_value_tensor().device(), stream);
     core23::copy_async(dst.get_rowoffset_tensor(), src.get_row_offset_tensor(), stream);
     *dst.get_nnz_ptr() = src.get_num_values();
   }
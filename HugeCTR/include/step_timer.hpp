@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime.h>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <resource_manager.hpp>
+#include <training_callback.hpp>
+#include <vector>
+
+namespace HugeCTR {
+
+// Phase of a training iteration whose time is reported per GPU.
+enum class StepPhase : size_t { ReaderWait, Forward, AllToAll, Backward, AllReduce, Update };
+inline constexpr size_t num_step_phases{6};
+
+const char* get_step_phase_name(StepPhase phase);
+
+/**
+ * Per GPU timer of the phases of training iterations, which finds the stragglers of multi-node
+ * training. The phases are timed with CUDA events on the stream they run on, in one of every
+ * report_interval / 10 iterations. The events are read back at the start of the iteration after,
+ * so that the host runs ahead of the GPUs in the other ones. A phase that is captured into a CUDA
+ * graph records its events with every replay. The host time spent waiting for the data reader is
+ * counted for all the GPUs of the process.
+ *
+ * Every report_interval iterations, the mean phase times of all GPUs are reduced to the master
+ * process. A GPU is a straggler if one of its phases takes longer than the median of that phase
+ * over all GPUs by more than threshold times the median step time. As the collectives make the
+ * other GPUs wait for it, its straggling phase is the one with the largest excess.
+ */
+class StepTimer {
+ public:
+  // A report_interval of 0 turns the timer off.
+  StepTimer(const std::shared_ptr<ResourceManager>& resource_manager, size_t report_interval,
+            float threshold);
+  ~StepTimer();
+
+  StepTimer(const StepTimer&) = delete;
+  StepTimer& operator=(const StepTimer&) = delete;
+
+  bool is_enabled() const { return report_interval_ > 0; }
+
+  /**
+   * Starts the next iteration on all processes. It returns the report of the iterations since
+   * the previous one on the master process, if one is due.
+   */
+  std::optional<StepTimeReport> begin_iteration();
+
+  // Times a phase that is launched to the current stream of a local GPU within its scope.
+  class Scope {
+   public:
+    Scope(StepTimer* timer, size_t local_gpu_id, StepPhase phase);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    StepTimer* timer_{nullptr};
+    size_t local_gpu_id_;
+    cudaStream_t stream_;
+    cudaEvent_t end_;
+    bool captured_;
+  };
+
+  // Times a phase that the host waits for within its scope.
+  class HostScope {
+   public:
+    HostScope(StepTimer* timer, StepPhase phase);
+    ~HostScope();
+
+    HostScope(const HostScope&) = delete;
+    HostScope& operator=(const HostScope&) = delete;
+
+   private:
+    StepTimer* timer_{nullptr};
+    StepPhase phase_;
+    std::chrono::steady_clock::time_point begin_;
+  };
+
+ private:
+  struct Record {
+    StepPhase phase;
+    cudaEvent_t begin;
+    cudaEvent_t end;
+  };
+
+  // Events of local_gpu_id for a phase, which are kept if they are recorded into a CUDA graph.
+  Record& acquire_record(size_t local_gpu_id, StepPhase phase, bool captured);
+  void collect();
+  std::optional<StepTimeReport> report();
+
+  std::shared_ptr<ResourceManager> resource_manager_;
+  size_t report_interval_;
+  size_t sample_interval_;
+  float threshold_;
+
+  int64_t iteration_{-1};
+  int64_t window_begin_{0};
+  bool sampling_{false};
+  size_t num_samples_{0};
+
+  // The records of sampled iterations and of graphs, and the number of the former in use.
+  std::vector<std::vector<Record>> records_;
+  std::vector<std::vector<Record>> captured_records_;
+  std::vector<size_t> num_records_;
+  // Milliseconds of the phases of each local GPU, and of the host, over the sampled iterations.
+  std::vector<std::array<double, num_step_phases>> gpu_ms_;
+  std::array<double, num_step_phases> host_ms_{};
+};
+
+}  // namespace HugeCTR
@@ -29,26 +29,55 @@
 
 namespace HugeCTR {
 
+/**
+ * Pool of workers that each take tasks from a queue of their own, and steal them from the queues
+ * of the other workers once their own queue runs dry. Tasks submitted by a worker of the pool go
+ * to its own queue, and the other tasks are spread over the queues round robin, so that the
+ * workers and the submitters rarely contend for the same lock.
+ *
+ * Each queue holds the tasks of every priority separately. A worker runs all foreground tasks it
+ * can find before it starts a background task.
+ */
 class ThreadPool final {
  public:
   HCTR_DISALLOW_COPY_AND_MOVE(ThreadPool);
 
+  enum class Priority {
+    Foreground,  // Latency critical, like lookups.
+    Background   // Deferred, like inserts and refreshes.
+  };
+
   ThreadPool(const std::string& name);
 
   ThreadPool(const std::string& name, size_t num_workers);
 
+  /**
+   * Creates a thread pool whose workers are pinned to the CPUs of a NUMA node, and prefer to
+   * allocate memory from that node. If \p num_workers is 0, one worker per CPU of that node is
+   * created.
+   */
+  ThreadPool(const std::string& name, size_t num_workers, int numa_node);
+
   virtual ~ThreadPool();
 
   inline const std::string& name() const { return name_; }
 
+  inline int numa_node() const { return numa_node_; }
+
   inline size_t size() const { return workers_.size(); }
 
   bool idle() const;
 
   void await_idle() const;
 
+  /**
+   * Submits a task with the priority of the task that the calling thread runs, or foreground if it
+   * doesn't run one. Hence, the work that a background task fans out stays in the background.
+   */
   std::future<void> submit(std::function<void()> task);
 
+  std::future<void> submit(std::function<void()> task, Priority priority);
+
   static ThreadPool& get();
 
   template <typename Iterator>
@@ -60,17 +89,32 @@ class ThreadPool final {
 
  private:
   const std::string name_;
+  const int numa_node_;  // NUMA node to which workers are pinned (-1 = not pinned).
   std::vector<std::thread> workers_;
 
-  mutable std::mutex barrier_;  // Must be obtained to ensure exclusive access.
+  static constexpr size_t num_priorities_ = 2;
+
+  struct WorkerQueue {
+    std::mutex barrier;
+    std::deque<std::packaged_task<void()>> packages[num_priorities_];
+    std::atomic<size_t> num_packages[num_priorities_] = {};  // Read without the barrier.
+  };
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::atomic<size_t> next_queue_{0};  // Queue of the next submission from outside the pool.
+
+  // Tasks that were submitted, but have not finished yet.
+  std::atomic<size_t> num_pending_packages_{0};
+  std::atomic<size_t> num_sleeping_workers_{0};
+
+  mutable std::mutex barrier_;  // Guards the sleep and idle states.
   mutable std::condition_variable
       submit_sempahore_;  // Triggered on submission. Workers wait for this.
-  mutable std::condition_variable idle_semaphore_;  // Trigger
+  mutable std::condition_variable idle_semaphore_;  // Triggered once all tasks finished.
+
+  std::atomic<bool> terminate_{false};  // Signals the workers that termination is imminent.
 
-  bool terminate_ = false;  // Used to signal to the workers that termination is imminent.
-  size_t num_idle_workers_ = 0;
-  std::deque<std::packaged_task<void()>>
-      packages_;  // Work packages that have not been processed yet.
+  // Takes the next task of the worker from its own queue, or from another one.
+  bool take_(size_t thread_index, std::packaged_task<void()>& package, Priority& priority);
 
   void run_(const size_t thread_index);
 };
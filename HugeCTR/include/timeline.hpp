@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+// Category of a range of the timeline, which is its NVTX category as well.
+enum class TraceCategory : uint32_t {
+  Iteration = 1,
+  DataReader,
+  Embedding,
+  Network,
+  Communication,
+  Optimizer
+};
+
+/**
+ * Recorder of the ranges of sampled training iterations, which writes them as a Chrome trace that
+ * chrome://tracing and Perfetto open. It is configured by the environment, so that it can be
+ * turned on in production without a rebuild:
+ *
+ *   HUGECTR_TRACE_FILE        Path of the trace, where %r is replaced by the process rank.
+ *                             Nothing is recorded without it.
+ *   HUGECTR_TRACE_INTERVAL    Every how many iterations one is sampled, 1000 by default.
+ *   HUGECTR_TRACE_ITERATIONS  Number of sampled iterations, 10 by default.
+ *
+ * The timestamps are taken on the host. The range of asynchronous GPU work only measures its
+ * launch, unless the range waits for it. The NVTX ranges are there for Nsight Systems regardless
+ * of the sampling.
+ */
+class Timeline {
+ public:
+  static Timeline& get();
+
+  Timeline(const Timeline&) = delete;
+  Timeline& operator=(const Timeline&) = delete;
+
+  // Replaces the configuration of the environment. An empty path turns the recording off.
+  void configure(const std::string& path, int64_t interval, int64_t num_iterations);
+  void set_rank(int rank);
+
+  // Starts the next iteration, which is recorded if it is sampled.
+  void begin_iteration();
+  // Ends the iteration, and writes the trace if it was recorded.
+  void end_iteration();
+
+  bool is_recording() const { return recording_.load(std::memory_order_relaxed); }
+  // Microseconds since the recorder was created.
+  int64_t now_us() const;
+  void record(TraceCategory category, const char* name, int64_t begin_us, int64_t end_us);
+
+ private:
+  struct Event {
+    TraceCategory category;
+    const char* name;
+    int64_t begin_us;
+    int64_t end_us;
+    int thread_id;
+    int64_t iteration;
+  };
+
+  Timeline();
+  void write_trace();
+
+  std::mutex mutex_;
+  std::string path_;
+  int rank_{0};
+  int64_t interval_{1000};
+  int64_t num_iterations_{10};
+  int64_t iteration_{-1};
+  int64_t num_recorded_iterations_{0};
+  int64_t iteration_begin_us_{0};
+  std::atomic<bool> recording_{false};
+  std::vector<Event> events_;
+};
+
+/**
+ * Scoped NVTX range of a category, which is recorded into the timeline as well while an
+ * iteration is sampled. name must outlive the recorder, e.g. be a string literal.
+ */
+class TraceRange {
+ public:
+  TraceRange(TraceCategory category, const char* name);
+  ~TraceRange();
+
+  TraceRange(const TraceRange&) = delete;
+  TraceRange& operator=(const TraceRange&) = delete;
+
+ private:
+  TraceCategory category_;
+  const char* name_;
+  int64_t begin_us_;  // -1 if the range is not recorded
+};
+
+// Scope of a training iteration in the timeline.
+class TraceIteration {
+ public:
+  TraceIteration() { Timeline::get().begin_iteration(); }
+  ~TraceIteration() { Timeline::get().end_iteration(); }
+
+  TraceIteration(const TraceIteration&) = delete;
+  TraceIteration& operator=(const TraceIteration&) = delete;
+};
+
+}  // namespace HugeCTR
@@ -15,14 +15,36 @@
  */
 #pragma once
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace HugeCTR {
 
+/**
+ * Mean time of the phases of a training iteration on each GPU over the iterations since the
+ * previous report, and the GPUs that straggle.
+ */
+struct StepTimeReport {
+  int iteration;
+  std::vector<std::string> phases;
+  // Milliseconds of each phase, and of the step, by global GPU id.
+  std::vector<std::vector<float>> gpu_phase_ms;
+  std::vector<float> gpu_step_ms;
+  float median_step_ms;
+  // Global ids of the straggling GPUs, and the phase each of them straggles in.
+  std::vector<int> stragglers;
+  std::vector<std::string> straggling_phases;
+};
+
 struct TrainingCallback {
   virtual ~TrainingCallback() = default;
   virtual void on_training_start() = 0;
   virtual void on_training_end(int curent_iter) = 0;
   virtual bool on_eval_start(int current_iter) = 0;
   virtual bool on_eval_end(int current_iter, const std::map<std::string, float>& eval_results) = 0;
+  // Called on the master process with the reports of solver.step_time_report_interval.
+  virtual void on_step_time_report(int current_iter, const StepTimeReport& report) {}
 };
 
 }  // namespace HugeCTR
\ No newline at end of file
@@ -57,6 +57,12 @@ __inline__ __device__ uint64_t atomic_add(uint64_t *address, uint64_t val) {
 
 namespace HugeCTR {
 
+// Learning rate of an optimizer update: the host part lr, scaled by the learning rate that a
+// GpuLearningRateScheduler keeps at lr_ptr on the device unless lr_ptr is nullptr.
+__forceinline__ __device__ float scale_by_device_lr(float lr, const float *lr_ptr) {
+  return lr_ptr ? lr * *lr_ptr : lr;
+}
+
 template <typename T>
 struct TypeFunc;
 
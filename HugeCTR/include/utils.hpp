@@ -262,6 +262,7 @@ class CudaCPUDeviceContext {
     numa_node_to_device_ids_.clear();
 
     auto cpu_mask = numa_allocate_cpumask();
+    auto run_nodes = numa_get_run_node_mask();
 
     auto select_node = [](const bitmask* nvml_cpus) -> int {
       for (int cpu = 0; cpu < numa_num_possible_cpus(); cpu++) {
@@ -285,6 +286,20 @@ class CudaCPUDeviceContext {
         device_id_to_numa_node_[device_id] = node;
         HCTR_LOG_S(INFO, ROOT) << "  GPU " << device_id << " -> "
                                << " node " << node << std::endl;
+        // The threads of the GPU can't be moved to its node if the CPU binding of the process
+        // excludes it, e.g. with one process per socket and a CUDA_VISIBLE_DEVICES that doesn't
+        // match.
+        if (node < 0) {
+          HCTR_LOG_S(WARNING, WORLD) << "The NUMA node of GPU " << device_id
+                                     << " is unknown, so its threads are not pinned" << std::endl;
+        } else if (!numa_bitmask_isbitset(run_nodes, node)) {
+          HCTR_LOG_S(WARNING, WORLD)
+              << "GPU " << device_id << " is attached to NUMA node " << node
+              << ", on which this process may not run. Its reader and communication threads run "
+                 "on a remote node. Check CUDA_VISIBLE_DEVICES and the CPU binding of the "
+                 "launcher."
+              << std::endl;
+        }
 
         if (numa_node_to_device_ids_.count(node) == 0) {
           numa_node_to_device_ids_[node] = std::vector<int>{device_id};
@@ -294,6 +309,7 @@ class CudaCPUDeviceContext {
       }
     }
 
+    numa_bitmask_free(run_nodes);
     numa_bitmask_free(cpu_mask);
   }
 
@@ -30,6 +30,16 @@ std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create_nccl(
   }
 }
 
+std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create_hierarchical(
+    size_t num_process, bool use_mixed_precision,
+    const std::vector<std::shared_ptr<GPUResource>>& gpu_resources) {
+  if (use_mixed_precision) {
+    return std::make_shared<HierarchicalARInplaceComm<__half>>(num_process, gpu_resources);
+  } else {
+    return std::make_shared<HierarchicalARInplaceComm<float>>(num_process, gpu_resources);
+  }
+}
+
 std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create_oneshot(
     size_t num_process, bool use_mixed_precision,
     const std::vector<std::shared_ptr<GPUResource>>& gpu_resources) {
@@ -65,9 +75,14 @@ std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create_oneshot(
 std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create(
     size_t num_process, AllReduceAlgo algo, bool use_mixed_precision,
     const std::vector<std::shared_ptr<GPUResource>>& gpu_resources, IbComm* ib_comm) {
-  return (algo == AllReduceAlgo::ONESHOT)
-             ? create_oneshot(num_process, use_mixed_precision, gpu_resources, ib_comm)
-             : create_nccl(num_process, use_mixed_precision, gpu_resources);
+  switch (algo) {
+    case AllReduceAlgo::ONESHOT:
+      return create_oneshot(num_process, use_mixed_precision, gpu_resources, ib_comm);
+    case AllReduceAlgo::HIERARCHICAL:
+      return create_hierarchical(num_process, use_mixed_precision, gpu_resources);
+    default:
+      return create_nccl(num_process, use_mixed_precision, gpu_resources);
+  }
 }
 
 #else
@@ -75,9 +90,14 @@ std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create(
 std::shared_ptr<AllReduceInPlaceComm> AllReduceInPlaceComm::create(
     size_t num_process, AllReduceAlgo algo, bool use_mixed_precision,
     const std::vector<std::shared_ptr<GPUResource>>& gpu_resources) {
-  return (algo == AllReduceAlgo::ONESHOT)
-             ? create_oneshot(num_process, use_mixed_precision, gpu_resources)
-             : create_nccl(num_process, use_mixed_precision, gpu_resources);
+  switch (algo) {
+    case AllReduceAlgo::ONESHOT:
+      return create_oneshot(num_process, use_mixed_precision, gpu_resources);
+    case AllReduceAlgo::HIERARCHICAL:
+      return create_hierarchical(num_process, use_mixed_precision, gpu_resources);
+    default:
+      return create_nccl(num_process, use_mixed_precision, gpu_resources);
+  }
 }
 
 #endif
@@ -425,4 +445,134 @@ void NCCLARInplaceComm<T>::all_reduce(AllReduceInPlaceComm::Handle coll, cudaStr
 template class NCCLARInplaceComm<__half>;
 template class NCCLARInplaceComm<float>;
 
+template <typename T>
+HierarchicalARInplaceComm<T>::HierarchicalARInplaceComm(
+    size_t num_procs, const std::vector<std::shared_ptr<GPUResource>>& gpu_resources)
+    : gpu_resources_(gpu_resources), num_procs_(num_procs), num_gpus_(gpu_resources.size()) {
+  std::vector<int> device_list;
+  for (const auto& gpu_resource : gpu_resources_) {
+    device_list.push_back(gpu_resource->get_device_id());
+  }
+  node_comms_.resize(num_gpus_);
+  HCTR_LIB_THROW(
+      ncclCommInitAll(node_comms_.data(), static_cast<int>(num_gpus_), device_list.data()));
+
+  if (num_procs_ > 1) {
+#ifdef ENABLE_MPI
+    // A rail pairs the GPUs of the same local id, so all nodes need the same number of GPUs.
+    int num_gpus = static_cast<int>(num_gpus_);
+    int min_num_gpus = 0;
+    int max_num_gpus = 0;
+    HCTR_MPI_THROW(MPI_Allreduce(&num_gpus, &min_num_gpus, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD));
+    HCTR_MPI_THROW(MPI_Allreduce(&num_gpus, &max_num_gpus, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD));
+    if (min_num_gpus != max_num_gpus) {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "Hierarchical all-reduce requires the same number of GPUs in each process");
+    }
+
+    int process_id = 0;
+    HCTR_MPI_THROW(MPI_Comm_rank(MPI_COMM_WORLD, &process_id));
+    std::vector<ncclUniqueId> rail_ids(num_gpus_);
+    if (process_id == 0) {
+      for (auto& rail_id : rail_ids) {
+        HCTR_LIB_THROW(ncclGetUniqueId(&rail_id));
+      }
+    }
+    const int rail_ids_size = static_cast<int>(rail_ids.size() * sizeof(ncclUniqueId));
+    HCTR_MPI_THROW(MPI_Bcast(rail_ids.data(), rail_ids_size, MPI_BYTE, 0, MPI_COMM_WORLD));
+
+    rail_comms_.resize(num_gpus_);
+    CudaDeviceContext context;
+    HCTR_LIB_THROW(ncclGroupStart());
+    for (size_t g = 0; g < num_gpus_; g++) {
+      context.set_device(device_list[g]);
+      HCTR_LIB_THROW(ncclCommInitRank(&rail_comms_[g], static_cast<int>(num_procs_), rail_ids[g],
+                                      process_id));
+    }
+    HCTR_LIB_THROW(ncclGroupEnd());
+#else
+    HCTR_OWN_THROW(Error_t::WrongInput, "Hierarchical multi-node is not supported without MPI");
+#endif
+  }
+}
+
+template <typename T>
+HierarchicalARInplaceComm<T>::~HierarchicalARInplaceComm() {
+  for (auto& comm : rail_comms_) {
+    ncclCommDestroy(comm);
+  }
+  for (auto& comm : node_comms_) {
+    ncclCommDestroy(comm);
+  }
+}
+
+template <typename T>
+AllReduceInPlaceComm::Handle HierarchicalARInplaceComm<T>::register_coll() {
+  ar_ctx_.emplace_back(std::make_unique<ARContext>());
+  Handle handle = (Handle)(ar_ctx_.size() - 1);
+  auto& ar_ctx_g = ar_ctx_[handle];
+  ar_ctx_g->ctx_.resize(num_gpus_);
+
+  return handle;
+}
+
+template <typename T>
+void HierarchicalARInplaceComm<T>::set_coll_buf(Handle coll, void* ar_ptr, size_t ar_size,
+                                                size_t g) {
+  auto& ctx = ar_ctx_[coll];
+  auto& ctx_g = ctx->ctx_[g];
+  ctx_g.ar_ptr_ = ar_ptr;
+  if ((ctx->ar_size_ != 0) && (ctx->ar_size_ != ar_size)) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "AR size mismatch");
+  }
+  ctx->ar_size_ = ar_size;
+}
+
+template <typename T>
+void HierarchicalARInplaceComm<T>::update_size(Handle coll, const size_t ar_size) {
+  auto& ctx = ar_ctx_[coll];
+  ctx->ar_size_ = ar_size;
+}
+
+template <typename T>
+void HierarchicalARInplaceComm<T>::register_coll_buf(Handle coll) {}
+
+template <typename T>
+void HierarchicalARInplaceComm<T>::all_reduce(AllReduceInPlaceComm::Handle coll,
+                                              cudaStream_t stream, size_t g) {
+  auto& ctx = ar_ctx_[coll];
+  T* const ar_ptr = static_cast<T*>(ctx->ctx_[g].ar_ptr_);
+  const size_t count = ctx->ar_size_ / sizeof(T);
+  const size_t shard_count = count / num_gpus_;
+  const auto data_type = NcclDataType<T>::getType();
+
+  if (shard_count > 0) {
+    // In place, as the shard of local id g starts at element g * shard_count.
+    T* const shard_ptr = ar_ptr + g * shard_count;
+    HCTR_LIB_THROW(ncclReduceScatter(ar_ptr, shard_ptr, shard_count, data_type, ncclSum,
+                                     node_comms_[g], stream));
+    if (!rail_comms_.empty()) {
+      HCTR_LIB_THROW(ncclAllReduce(shard_ptr, shard_ptr, shard_count, data_type, ncclSum,
+                                   rail_comms_[g], stream));
+    }
+    HCTR_LIB_THROW(
+        ncclAllGather(shard_ptr, ar_ptr, shard_count, data_type, node_comms_[g], stream));
+  }
+
+  // The elements that don't split evenly among the GPUs of the node.
+  const size_t tail_count = count - shard_count * num_gpus_;
+  if (tail_count > 0) {
+    T* const tail_ptr = ar_ptr + shard_count * num_gpus_;
+    HCTR_LIB_THROW(
+        ncclAllReduce(tail_ptr, tail_ptr, tail_count, data_type, ncclSum, node_comms_[g], stream));
+    if (!rail_comms_.empty()) {
+      HCTR_LIB_THROW(ncclAllReduce(tail_ptr, tail_ptr, tail_count, data_type, ncclSum,
+                                   rail_comms_[g], stream));
+    }
+  }
+}
+
+template class HierarchicalARInplaceComm<__half>;
+template class HierarchicalARInplaceComm<float>;
+
 }  // namespace HugeCTR
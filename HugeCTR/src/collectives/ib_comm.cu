@@ -43,6 +43,28 @@ static void* proxy_thread_func(void* cfg) {
 }
 
 // Helpers
+namespace {
+
+// Whether the port is in the comma separated list of HUGECTR_IB_HCA, whose entries are a device
+// name, which selects all of its ports, or a device name and a port, as in mlx5_0:1.
+bool is_selected_ib_port(const char* hca_list, const std::string& dev_name, int port) {
+  if (!hca_list || *hca_list == '\0') {
+    return true;
+  }
+  std::istringstream is(hca_list);
+  std::string entry;
+  while (std::getline(is, entry, ',')) {
+    const size_t colon = entry.find(':');
+    if (entry.substr(0, colon) == dev_name &&
+        (colon == std::string::npos || std::atoi(entry.c_str() + colon + 1) == port)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
 void IbComm::detect_ib_devs() {
   // Init hwloc topology
   hwloc_topology_init(&topo_);
@@ -55,6 +77,7 @@ void IbComm::detect_ib_devs() {
 
   HCTR_CHECK_(dev_list && num_devices > 0, "IB Verbs get device list failed!");
 
+  const char* hca_list = getenv("HUGECTR_IB_HCA");
   std::vector<bool> is_ib;
   // Get hwloc devices and final ib devs
   for (int d = 0; d < num_devices; d++) {
@@ -86,6 +109,7 @@ void IbComm::detect_ib_devs() {
       if (port_attr.link_layer != IBV_LINK_LAYER_INFINIBAND &&
           port_attr.link_layer != IBV_LINK_LAYER_ETHERNET)
         continue;
+      if (!is_selected_ib_port(hca_list, dev_name, port)) continue;
 
       if (port_attr.link_layer == IBV_LINK_LAYER_INFINIBAND) {
         is_IB = true;
@@ -95,7 +119,6 @@ void IbComm::detect_ib_devs() {
         is_ib.push_back(false);
       }
 
-      // TODO: Check against user specified device list.
       ib_dev_list_.emplace_back();
       ib_dev_list_.back().dev_name = dev_name;
       ib_dev_list_.back().dev_port_id = port;
@@ -110,13 +133,15 @@ void IbComm::detect_ib_devs() {
     auto tmp_iter = ib_dev_list_.begin();
     for (size_t i = 0; i < is_ib.size(); i++) {
       if (is_ib[i] == false) {
-        ib_dev_list_.erase(tmp_iter);
+        tmp_iter = ib_dev_list_.erase(tmp_iter);
       } else {
         tmp_iter++;
       }
     }
   }
   ibv_free_device_list(dev_list);
+  HCTR_CHECK_(!ib_dev_list_.empty(), "No active IB port found. HUGECTR_IB_HCA: ",
+              hca_list ? hca_list : "");
 }
 
 void IbComm::print_obj(size_t my_rank, std::string obj_name, hwloc_obj_t obj) {
@@ -225,8 +250,9 @@ void IbComm::calculate_gpu_nic_affinity() {
 
   // print_distance_matrix(my_proc_, gpu_nic_dist);
 
-  // Calculate affinities. Only supports at max one NIC per GPU
-  // If we need to support more than one NIC per GPU in future, we can replicate the gpu devs.
+  // Calculate affinities. Only supports at max one NIC per GPU, because each proxy thread drives
+  // one NIC. With more NICs than GPUs, each GPU gets a NIC of its own, so that the GPUs are spread
+  // over all rails instead of sharing the nearest NIC.
   size_t max_nics = ib_dev_list_.size();
   gpu_nic_affinity_.resize(num_gpus_, max_nics);
   if (num_gpus_ >= ib_dev_list_.size()) {
@@ -243,6 +269,7 @@ void IbComm::calculate_gpu_nic_affinity() {
         }
       }
       gpu_nic_affinity_[min_gpu] = current_nic;
+      ib_dev_list_[current_nic].num_gpus_assigned++;
       current_nic = (current_nic + 1) % ib_dev_list_.size();
     }
   } else {
@@ -257,6 +284,7 @@ void IbComm::calculate_gpu_nic_affinity() {
         }
       }
       gpu_nic_affinity_[g] = min_nic;
+      ib_dev_list_[min_nic].num_gpus_assigned++;
     }
   }
 
@@ -267,6 +295,28 @@ void IbComm::calculate_gpu_nic_affinity() {
       HCTR_LOG_S(INFO, ROOT) << "GPU-NIC affinity " << g << "-" << ib_dev.dev_name << ":"
                              << ib_dev.dev_port_id << std::endl;
     }
+    for (const auto& ib_dev : ib_dev_list_) {
+      if (ib_dev.num_gpus_assigned == 0) {
+        HCTR_LOG_S(INFO, ROOT) << "NIC " << ib_dev.dev_name << ":" << ib_dev.dev_port_id
+                               << " is not used, because there are more NICs than GPUs"
+                               << std::endl;
+      }
+    }
+  }
+  // The proxy thread of a GPU runs on the NUMA node of the GPU, and posts to the NIC from there.
+  for (size_t g = 0; g < num_gpus_; g++) {
+    const auto& ib_dev = ib_dev_list_[gpu_nic_affinity_[g]];
+    const hwloc_obj_t nic_ancestor = hwloc_get_non_io_ancestor_obj(topo_, ib_dev.hwloc_obj);
+    const int nic_node =
+        nic_ancestor && nic_ancestor->nodeset ? hwloc_bitmap_first(nic_ancestor->nodeset) : -1;
+    const auto gpu_node_it = CudaCPUDeviceContext::device_id_to_numa_node_.find(device_list_[g]);
+    if (nic_node >= 0 && gpu_node_it != CudaCPUDeviceContext::device_id_to_numa_node_.end() &&
+        gpu_node_it->second >= 0 && gpu_node_it->second != nic_node) {
+      HCTR_LOG_S(WARNING, WORLD) << "GPU " << device_list_[g] << " on NUMA node "
+                                 << gpu_node_it->second << " uses NIC " << ib_dev.dev_name
+                                 << " on NUMA node " << nic_node
+                                 << ". Its traffic crosses the CPU interconnect." << std::endl;
+    }
   }
   // Check gpu nic affinities of other nodes and warn if mismatch
   char(**gpu_nic_affinity_names)[IBV_SYSFS_NAME_MAX];
@@ -16,12 +16,15 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <core23_network.hpp>
+#include <exchange_wgrad.hpp>
 #include <io/filesystem.hpp>
 #include <network_helpers.hpp>
 #include <nlohmann/json.hpp>
 #include <parser.hpp>
 #include <regularizer.hpp>
+#include <timeline.hpp>
 #include <trainable_layer.hpp>
 
 namespace HugeCTR {
@@ -41,7 +44,7 @@ Core23TempNetwork::Core23TempNetwork(const std::shared_ptr<CPUResource>& cpu_res
 // associated with each layer
 void Core23TempNetwork::train(int64_t current_batchsize) {
   // forward
-  if (use_mixed_precision_) {
+  if (use_mixed_precision_ && !optimizer_->updates_weight_half()) {
     conv_weight_(train_weight_tensor_half_, train_weight_tensor_);
   }
 
@@ -59,7 +62,11 @@ void Core23TempNetwork::train(int64_t current_batchsize) {
 
   train_losses_.begin()->second->regularizer_initialize_wgrad(true);  // Only 1 regularizer for now
 
-  prop_layers(train_layers_ptr, false, true);
+  if (wgrad_bucket_allreduce_) {
+    bprop_with_wgrad_buckets_(train_layers_ptr);
+  } else {
+    prop_layers(train_layers_ptr, false, true);
+  }
 
   return;
 }
@@ -176,6 +183,7 @@ void Core23TempNetwork::upload_params_to_device(const std::string& model_file) {
   fs->read(model_file, params.get(), train_weight_tensor_->num_bytes(), 0);
   HCTR_LIB_THROW(cudaMemcpy(train_weight_tensor_->data(), params.get(),
                             train_weight_tensor_->num_bytes(), cudaMemcpyHostToDevice));
+  update_train_weight_half_();
   return;
 }
 
@@ -232,17 +240,32 @@ void Core23TempNetwork::download_params_to_host(float* weight) {
   return;
 }
 
+void Core23TempNetwork::download_opt_states_to_host(char* h_opt_states) {
+  CudaDeviceContext context(get_device_id());
+  if (opt_tensor_->empty()) {
+    return;
+  }
+
+  HCTR_LIB_THROW(cudaMemcpy(h_opt_states, opt_tensor_->data(), opt_tensor_->num_bytes(),
+                            cudaMemcpyDeviceToHost));
+
+  return;
+}
+
 void Core23TempNetwork::upload_params_to_device(float* params) {
   CudaDeviceContext context(get_device_id());
 
   HCTR_LIB_THROW(cudaMemcpy(train_weight_tensor_->data(), params, train_weight_tensor_->num_bytes(),
                             cudaMemcpyHostToDevice));
+  update_train_weight_half_();
 
   return;
 }
 
 void Core23TempNetwork::upload_opt_states_to_device(char* h_opt_states) {
   CudaDeviceContext context(get_device_id());
+  HCTR_CHECK_HINT(num_optimizer_shards_ == 1,
+                  "The dense optimizer states are sharded across the GPUs and can't be loaded");
 
   size_t src_size_in_byte = opt_tensor_->num_bytes();
 
@@ -258,9 +281,11 @@ void Core23TempNetwork::init_params(size_t index) {
   for (auto& layer : train_layers_) {
     layer->init_params(cpu_resource_->get_replica_uniform_curand_generator(index));
   }
+  update_train_weight_half_();
 }
 
 void Core23TempNetwork::exchange_wgrad() {
+  TraceRange range(TraceCategory::Communication, "exchange_wgrad");
   CudaDeviceContext context(get_device_id());
   if (use_mixed_precision_) {
     HCTR_LIB_THROW(ncclAllReduce((const void*)wgrad_tensor_half_->data(),
@@ -275,10 +300,51 @@ void Core23TempNetwork::exchange_wgrad() {
 }
 
 void Core23TempNetwork::update_params() {
+  TraceRange range(TraceCategory::Optimizer, "optimizer_update");
   optimizer_->update();
+  if (num_optimizer_shards_ > 1) {
+    all_gather_weights_();
+  }
   return;
 }
 
+void Core23TempNetwork::all_gather_weights_() {
+  TraceRange range(TraceCategory::Communication, "all_gather_weights");
+  CudaDeviceContext context(get_device_id());
+  const size_t num_elements = train_weight_tensor_->num_elements();
+  const size_t count = num_elements / num_optimizer_shards_;
+  const size_t rest = num_elements - count * num_optimizer_shards_;
+  float* weights = train_weight_tensor_->data();
+  auto stream = gpu_resource_->get_stream();
+
+  // The FP32 weights are gathered, since they are the ones that are dumped and evaluated.
+  HCTR_LIB_THROW(ncclGroupStart());
+  if (count > 0) {
+    const float* shard = weights + gpu_resource_->get_global_id() * count;
+    HCTR_LIB_THROW(
+        ncclAllGather(shard, weights, count, ncclFloat, gpu_resource_->get_nccl(), stream));
+  }
+  if (rest > 0) {
+    float* rest_weights = weights + count * num_optimizer_shards_;
+    HCTR_LIB_THROW(ncclBroadcast(rest_weights, rest_weights, rest, ncclFloat,
+                                 num_optimizer_shards_ - 1, gpu_resource_->get_nccl(), stream));
+  }
+  HCTR_LIB_THROW(ncclGroupEnd());
+  update_train_weight_half_();
+}
+
+void Core23TempNetwork::set_dynamic_loss_scale(const float* loss_scale, const int* skip_update) {
+  for (auto& [name, loss] : train_losses_) {
+    loss->set_loss_scale(loss_scale);
+  }
+  optimizer_->set_skip_update_flag(skip_update);
+  // The optimizer cannot scale the fused regularizer term like the rest of the wgrad.
+  if (loss_scale) {
+    train_losses_.begin()->second->fuse_regularizer_wgrad(false);
+    optimizer_->set_fused_regularizer(Regularizer_t::None, 0.f);
+  }
+}
+
 void Core23TempNetwork::initialize(bool is_train) {
   CudaDeviceContext context(get_device_id());
   for (auto& layer : train_layers_) {
@@ -385,7 +451,11 @@ void Core23TempNetwork::set_optimizer(std::unique_ptr<Optimizer> optimizer) {
   optimizer_ = std::move(optimizer);
 }
 
-void Core23TempNetwork::create_and_set_optimizer(const OptParams& opt_params) {
+void Core23TempNetwork::create_and_set_optimizer(const OptParams& opt_params, size_t num_shards) {
+  if (num_shards > 1) {
+    create_and_set_sharded_optimizer_(opt_params, num_shards);
+    return;
+  }
   if (use_mixed_precision_) {
     auto weight_tensors = get_master_weight_tensor_vector<__half>(train_layers_);
     auto weight_half_tensors = get_weight_tensor_vector<__half>(train_layers_);
@@ -401,11 +471,67 @@ void Core23TempNetwork::create_and_set_optimizer(const OptParams& opt_params) {
         Optimizer::Create<float>(opt_params, weight_tensors, weight_half_tensors, wgrad_tensors,
                                  opt_params.scaler, gpu_resource_, use_mixed_precision_);
   }
+  if (!train_losses_.empty()) {
+    auto [regularizer, coefficient] = train_losses_.begin()->second->fuse_regularizer_wgrad(true);
+    optimizer_->set_fused_regularizer(regularizer, coefficient);
+  }
   auto opt_tensors = optimizer_->get_opt_state_tensors();
   int64_t num_opt_tensors = opt_tensors.size();
   opt_tensor_.emplace(opt_tensors, core23::Shape({num_opt_tensors}));
 }
 
+void Core23TempNetwork::create_and_set_sharded_optimizer_(const OptParams& opt_params,
+                                                         size_t num_shards) {
+  if (opt_params.optimizer == Optimizer_t::LAMB || opt_params.optimizer == Optimizer_t::LARS) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "LAMB and LARS need whole layers and can't be sharded");
+  }
+  const int64_t num_elements = train_weight_tensor_->num_elements();
+  const int64_t num_wgrad_elements = use_mixed_precision_ ? wgrad_tensor_half_->num_elements()
+                                                          : wgrad_tensor_->num_elements();
+  HCTR_CHECK_HINT(num_elements == num_wgrad_elements,
+                  "The flat weights and wgrad must have the same layout to be sharded");
+  const auto shard = get_dense_optimizer_shard(num_elements, gpu_resource_->get_global_id(),
+                                               num_shards);
+  core23::Device device(core23::DeviceType::GPU, get_device_id());
+  const core23::Shape shape({static_cast<int64_t>(shard.second)});
+
+  // Views of the shard of the flat weights and wgrad, which an element-wise optimizer updates like
+  // the weights of a single layer, so that it only keeps the states of the shard.
+  auto weight_tensors = std::vector<core23::Tensor>{core23::Tensor::bind(
+      train_weight_tensor_->data() + shard.first, shape, core23::ScalarType::Float, device)};
+  if (use_mixed_precision_) {
+    auto weight_half_tensors = std::vector<core23::Tensor>{
+        core23::Tensor::bind(train_weight_tensor_half_->data() + shard.first, shape,
+                             core23::ScalarType::Half, device)};
+    auto wgrad_tensors = std::vector<core23::Tensor>{core23::Tensor::bind(
+        wgrad_tensor_half_->data() + shard.first, shape, core23::ScalarType::Half, device)};
+    optimizer_ =
+        Optimizer::Create<__half>(opt_params, weight_tensors, weight_half_tensors, wgrad_tensors,
+                                  opt_params.scaler, gpu_resource_, use_mixed_precision_);
+  } else {
+    auto weight_half_tensors = std::vector<core23::Tensor>();
+    auto wgrad_tensors = std::vector<core23::Tensor>{core23::Tensor::bind(
+        wgrad_tensor_->data() + shard.first, shape, core23::ScalarType::Float, device)};
+    optimizer_ =
+        Optimizer::Create<float>(opt_params, weight_tensors, weight_half_tensors, wgrad_tensors,
+                                 opt_params.scaler, gpu_resource_, use_mixed_precision_);
+  }
+  if (!train_losses_.empty()) {
+    auto [regularizer, coefficient] = train_losses_.begin()->second->fuse_regularizer_wgrad(true);
+    optimizer_->set_fused_regularizer(regularizer, coefficient);
+  }
+  num_optimizer_shards_ = num_shards;
+  // Each GPU only has the states of its shard, which aren't dumped.
+  opt_tensor_.emplace(std::vector<core23::Tensor>(), core23::Shape({0}));
+}
+
+void Core23TempNetwork::update_train_weight_half_() {
+  // Otherwise train() converts the weights before each forward anyway.
+  if (use_mixed_precision_ && optimizer_ && optimizer_->updates_weight_half()) {
+    conv_weight_(train_weight_tensor_half_, train_weight_tensor_);
+  }
+}
+
 void Core23TempNetwork::conv_weight_(
     std::optional<core23::TensorContainer<__half, 1, 1>>& target_opt,
     const std::optional<core23::TensorContainer<float, 1, 1>>& source_opt) {
@@ -423,6 +549,11 @@ void Core23TempNetwork::conv_weight_(
 }
 
 void Core23TempNetwork::prop_layers(const std::vector<Layer*>& layers, bool fprop, bool train) {
+  const auto& plan = fprop ? (train ? train_fprop_plan_ : eval_fprop_plan_) : train_bprop_plan_;
+  if (plan) {
+    run_branch_plan_(*plan, layers, fprop, train);
+    return;
+  }
   if (fprop) {
     for (auto& layer : layers) {
       layer->fprop(train);
@@ -434,6 +565,220 @@ void Core23TempNetwork::prop_layers(const std::vector<Layer*>& layers, bool fpro
   }
 }
 
+void Core23TempNetwork::bprop_with_wgrad_buckets_(const std::vector<Layer*>& layers) {
+  auto stream = gpu_resource_->get_stream();
+  size_t bucket = 0;
+  for (size_t i = layers.size(); i-- > 0;) {
+    layers[i]->bprop();
+    if (bucket < wgrad_bucket_layers_.size() && wgrad_bucket_layers_[bucket] == i) {
+      HCTR_LIB_THROW(cudaEventRecord(wgrad_bucket_events_[bucket], stream));
+      HCTR_LIB_THROW(cudaStreamWaitEvent(wgrad_bucket_stream_, wgrad_bucket_events_[bucket]));
+      wgrad_bucket_allreduce_(bucket, wgrad_bucket_stream_);
+      bucket++;
+    }
+  }
+  // Joining the streams here also keeps a captured CUDA graph valid.
+  HCTR_LIB_THROW(cudaEventRecord(wgrad_buckets_done_event_, wgrad_bucket_stream_));
+  HCTR_LIB_THROW(cudaStreamWaitEvent(stream, wgrad_buckets_done_event_));
+}
+
+size_t Core23TempNetwork::enable_concurrent_branches(size_t num_streams) {
+  CudaDeviceContext context(get_device_id());
+  // The streams are made now, as they can't be while a CUDA graph is captured.
+  branch_stream_names_.assign(1, "");
+  for (size_t s = 1; s < num_streams; s++) {
+    branch_stream_names_.push_back("dense_branch_" + std::to_string(s));
+    gpu_resource_->get_stream(branch_stream_names_.back());
+  }
+  auto make_plan = [&](std::optional<BranchPlan>& plan,
+                       const std::vector<std::unique_ptr<Layer>>& layers, bool fprop,
+                       const std::string& name) {
+    std::vector<Layer*> layers_ptr;
+    std::transform(layers.begin(), layers.end(), std::back_inserter(layers_ptr),
+                   [](const std::unique_ptr<Layer>& layer) { return layer.get(); });
+    plan = make_branch_plan_(layers_ptr, fprop, num_streams, name);
+    if (plan->num_streams < 2) {
+      plan.reset();
+    }
+  };
+  make_plan(train_fprop_plan_, train_layers_, true, "train_fprop");
+  make_plan(train_bprop_plan_, train_layers_, false, "train_bprop");
+  make_plan(eval_fprop_plan_, evaluate_layers_, true, "eval_fprop");
+  return train_fprop_plan_ ? train_fprop_plan_->num_streams : 1;
+}
+
+Core23TempNetwork::BranchPlan Core23TempNetwork::make_branch_plan_(
+    const std::vector<Layer*>& layers, bool fprop, size_t num_streams, const std::string& name) {
+  const size_t num_layers = layers.size();
+  std::vector<std::vector<std::pair<uintptr_t, uintptr_t>>> ranges(num_layers);
+  for (size_t i = 0; i < num_layers; i++) {
+    const auto workspace_tensors = layers[i]->get_core23_workspace_tensors();
+    for (const auto* tensors : {&layers[i]->get_core23_input_tensors(),
+                                &layers[i]->get_core23_output_tensors(), &workspace_tensors}) {
+      for (const auto& tensor : *tensors) {
+        if (!tensor.empty()) {
+          auto const ptr = reinterpret_cast<uintptr_t>(tensor.data());
+          ranges[i].emplace_back(ptr, ptr + tensor.num_bytes());
+        }
+      }
+    }
+  }
+  // Layers that don't list their tensors, e.g. the ones built from the old tensors, depend on all
+  // others.
+  auto depends = [&](size_t a, size_t b) {
+    if (ranges[a].empty() || ranges[b].empty()) {
+      return true;
+    }
+    for (auto const& [a_begin, a_end] : ranges[a]) {
+      for (auto const& [b_begin, b_end] : ranges[b]) {
+        if (a_begin < b_end && b_begin < a_end) {
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+
+  // A step continues the stream of a step it depends on that is the last one of its stream, and
+  // otherwise starts on a new stream, or on the stream that has been idle the longest.
+  BranchPlan plan;
+  plan.num_streams = 0;
+  std::vector<size_t> last_steps;
+  for (size_t s = 0; s < num_layers; s++) {
+    BranchStep step;
+    step.layer = fprop ? s : num_layers - 1 - s;
+    step.record = false;
+    std::map<size_t, size_t> depended_steps;  // the last step on each stream
+    for (size_t p = 0; p < s; p++) {
+      if (depends(step.layer, plan.steps[p].layer)) {
+        depended_steps[plan.steps[p].stream] = p;
+      }
+    }
+    auto continued = std::find_if(depended_steps.begin(), depended_steps.end(),
+                                  [&](const auto& d) { return last_steps[d.first] == d.second; });
+    if (continued != depended_steps.end()) {
+      step.stream = continued->first;
+    } else if (last_steps.size() < num_streams) {
+      step.stream = last_steps.size();
+      last_steps.push_back(s);
+    } else {
+      step.stream = std::min_element(last_steps.begin(), last_steps.end()) - last_steps.begin();
+    }
+    for (auto const& [stream, p] : depended_steps) {
+      if (stream != step.stream) {
+        step.wait_steps.push_back(p);
+        plan.steps[p].record = true;
+      }
+    }
+    last_steps[step.stream] = s;
+    plan.steps.push_back(std::move(step));
+  }
+  plan.num_streams = last_steps.size();
+
+  for (size_t s = 0; s < plan.steps.size(); s++) {
+    plan.step_events.push_back(plan.steps[s].record
+                                   ? gpu_resource_->get_event(name + "_" + std::to_string(s))
+                                   : nullptr);
+  }
+  plan.fork_event = gpu_resource_->get_event(name + "_fork");
+  for (size_t stream = 0; stream < plan.num_streams; stream++) {
+    plan.join_events.push_back(gpu_resource_->get_event(name + "_join_" + std::to_string(stream)));
+  }
+  return plan;
+}
+
+void Core23TempNetwork::run_branch_plan_(const BranchPlan& plan, const std::vector<Layer*>& layers,
+                                         bool fprop, bool train) {
+  const cudaStream_t stream = gpu_resource_->get_stream();
+  HCTR_LIB_THROW(cudaEventRecord(plan.fork_event, stream));
+  std::vector<bool> forked(plan.num_streams, false);
+  for (size_t s = 0; s < plan.steps.size(); s++) {
+    const auto& step = plan.steps[s];
+    std::optional<StreamContext> context;
+    if (step.stream > 0) {
+      context.emplace(gpu_resource_, branch_stream_names_[step.stream]);
+      if (!forked[step.stream]) {
+        HCTR_LIB_THROW(cudaStreamWaitEvent(gpu_resource_->get_stream(), plan.fork_event));
+        forked[step.stream] = true;
+      }
+    }
+    for (size_t p : step.wait_steps) {
+      HCTR_LIB_THROW(cudaStreamWaitEvent(gpu_resource_->get_stream(), plan.step_events[p]));
+    }
+    if (fprop) {
+      layers[step.layer]->fprop(train);
+    } else {
+      layers[step.layer]->bprop();
+    }
+    if (step.record) {
+      HCTR_LIB_THROW(cudaEventRecord(plan.step_events[s], gpu_resource_->get_stream()));
+    }
+  }
+  // Joining the streams here also keeps a captured CUDA graph valid.
+  for (size_t branch = 1; branch < plan.num_streams; branch++) {
+    if (forked[branch]) {
+      StreamContext context(gpu_resource_, branch_stream_names_[branch]);
+      HCTR_LIB_THROW(cudaEventRecord(plan.join_events[branch], gpu_resource_->get_stream()));
+      HCTR_LIB_THROW(cudaStreamWaitEvent(stream, plan.join_events[branch]));
+    }
+  }
+}
+
+std::vector<std::pair<size_t, size_t>> Core23TempNetwork::make_wgrad_buckets(
+    const void* wgrad_buffer, size_t wgrad_size, size_t bucket_size, size_t alignment) {
+  auto const base = reinterpret_cast<uintptr_t>(wgrad_buffer);
+  auto get_wgrads = [](auto& layer) -> auto{ return layer->get_wgrads(); };
+
+  // The buckets are made from the end of the buffer to its start. A boundary is aligned up, so
+  // that the wgrad before it goes to the next bucket, which is reduced later.
+  std::vector<std::pair<size_t, size_t>> buckets;
+  wgrad_bucket_layers_.clear();
+  size_t bucket_begin = wgrad_size;
+  size_t lowest = wgrad_size;
+  for (size_t i = train_layers_.size(); i-- > 0;) {
+    auto wgrads = use_mixed_precision_
+                      ? get_trainable_tensor_vector<__half>(train_layers_[i].get(), get_wgrads)
+                      : get_trainable_tensor_vector<float>(train_layers_[i].get(), get_wgrads);
+    for (auto& wgrad : wgrads) {
+      auto const ptr = reinterpret_cast<uintptr_t>(wgrad.data());
+      if (wgrad.empty() || ptr < base || ptr >= base + wgrad_size) {
+        // e.g. the FP32 wgrads of mixed precision layers, which aren't exchanged.
+        continue;
+      }
+      size_t const offset = ptr - base;
+      if (offset + static_cast<size_t>(wgrad.num_bytes()) > bucket_begin) {
+        wgrad_bucket_layers_.clear();
+        return {};
+      }
+      lowest = std::min(lowest, offset);
+    }
+    size_t const aligned = (lowest + alignment - 1) / alignment * alignment;
+    if (i > 0 && aligned < bucket_begin && bucket_begin - aligned >= bucket_size) {
+      buckets.emplace_back(aligned, bucket_begin - aligned);
+      wgrad_bucket_layers_.push_back(i);
+      bucket_begin = aligned;
+    }
+  }
+  if (bucket_begin > 0) {
+    buckets.emplace_back(0, bucket_begin);
+    wgrad_bucket_layers_.push_back(0);
+  }
+  return buckets;
+}
+
+void Core23TempNetwork::enable_wgrad_buckets(
+    std::function<void(size_t, cudaStream_t)> allreduce) {
+  CudaDeviceContext context(get_device_id());
+  wgrad_bucket_stream_ = gpu_resource_->get_stream("wgrad_bucket_allreduce");
+  wgrad_bucket_events_.clear();
+  for (size_t bucket = 0; bucket < wgrad_bucket_layers_.size(); bucket++) {
+    wgrad_bucket_events_.push_back(
+        gpu_resource_->get_event("wgrad_bucket_" + std::to_string(bucket)));
+  }
+  wgrad_buckets_done_event_ = gpu_resource_->get_event("wgrad_buckets_done");
+  wgrad_bucket_allreduce_ = std::move(allreduce);
+}
+
 void Core23TempNetwork::set_losses_common(
     const std::map<std::string, std::unique_ptr<ILoss>>& losses,
     const std::map<std::string, float>& label_weights,
@@ -23,10 +23,13 @@ namespace HugeCTR {
 
 namespace {
 
+// The slots of all samples are combined in parallel. The feature vectors of a slot are added up
+// one after another, so that the innermost loop streams through a contiguous vector.
 template <typename TypeEmbedding>
 void embedding_feature_combine_cpu(const float* input, TypeEmbedding* output, const int* row_ptrs,
                                    int batch_size, int slot_num, int embedding_vec_size,
                                    EmbeddingFeatureCombiner_t combiner_type) {
+#pragma omp parallel for collapse(2)
   for (int i = 0; i < batch_size; i++) {
     for (int j = 0; j < slot_num; j++) {
       int feature_row_index = i * slot_num + j;
@@ -34,22 +37,33 @@ void embedding_feature_combine_cpu(const float* input, TypeEmbedding* output, co
       int feature_num =
           row_ptrs[feature_row_index + 1] - row_offset;  // num of feature vectors in one slot
 
+      TypeEmbedding* out_row = output + static_cast<size_t>(feature_row_index) * embedding_vec_size;
+#pragma omp simd
       for (int k = 0; k < embedding_vec_size; k++) {
-        float tmp = 0.0f;
-        for (int l = 0; l < feature_num; l++) {
-          tmp += input[(row_offset + l) * embedding_vec_size + k];
-        }  // end for l
-        if (combiner_type == EmbeddingFeatureCombiner_t::Mean) tmp /= feature_num;
-        output[feature_row_index * embedding_vec_size + k] = tmp;
-      }  // end for k
-    }    // end for j
-  }      // end for i
+        out_row[k] = 0.0f;
+      }
+      for (int l = 0; l < feature_num; l++) {
+        const float* in_row = input + static_cast<size_t>(row_offset + l) * embedding_vec_size;
+#pragma omp simd
+        for (int k = 0; k < embedding_vec_size; k++) {
+          out_row[k] += in_row[k];
+        }
+      }  // end for l
+      if (combiner_type == EmbeddingFeatureCombiner_t::Mean) {
+#pragma omp simd
+        for (int k = 0; k < embedding_vec_size; k++) {
+          out_row[k] /= feature_num;
+        }
+      }
+    }  // end for j
+  }    // end for i
 }
 
 template <>
 void embedding_feature_combine_cpu(const float* input, __half* output, const int* row_ptrs,
                                    int batch_size, int slot_num, int embedding_vec_size,
                                    EmbeddingFeatureCombiner_t combiner_type) {
+#pragma omp parallel for collapse(2)
   for (int i = 0; i < batch_size; i++) {
     for (int j = 0; j < slot_num; j++) {
       int feature_row_index = i * slot_num + j;
@@ -86,7 +86,10 @@ void InferenceSessionCPU<TypeHashKey>::predict(float* h_dense, void* h_embedding
                               num_samples, inference_parser_.slot_num_for_tables);
   }
 
-  // parameter server lookup
+  // parameter server lookup (all tables at once, so that database queries can overlap)
+  std::vector<const void*> keys_per_table(num_embedding_tables);
+  std::vector<size_t> num_keys_per_table(num_embedding_tables);
+  std::vector<float*> vectors_per_table(num_embedding_tables);
   size_t acc_vectors_offset{0};
   size_t acc_row_ptrs_offset{0};
   size_t acc_keys_offset{0};
@@ -95,19 +98,19 @@ void InferenceSessionCPU<TypeHashKey>::predict(float* h_dense, void* h_embedding
     acc_row_ptrs_offset += num_samples * inference_parser_.slot_num_for_tables[i] + 1;
     num_keys = h_row_ptrs[acc_row_ptrs_offset - 1];
     if (inference_params_.i64_input_key) {
-      parameter_server_->lookup(static_cast<const long long*>(h_keys_) + acc_keys_offset, num_keys,
-                                h_embedding_vectors_ + acc_vectors_offset,
-                                inference_params_.model_name, i);
+      keys_per_table[i] = static_cast<const long long*>(h_keys_) + acc_keys_offset;
     } else {
-      parameter_server_->lookup(static_cast<const unsigned int*>(h_keys_) + acc_keys_offset,
-                                num_keys, h_embedding_vectors_ + acc_vectors_offset,
-                                inference_params_.model_name, i);
+      keys_per_table[i] = static_cast<const unsigned int*>(h_keys_) + acc_keys_offset;
     }
+    num_keys_per_table[i] = num_keys;
+    vectors_per_table[i] = h_embedding_vectors_ + acc_vectors_offset;
     acc_keys_offset += num_keys;
     acc_vectors_offset += inference_params_.max_batchsize *
                           inference_parser_.max_feature_num_for_tables[i] *
                           inference_parser_.embed_vec_size_for_tables[i];
   }
+  parameter_server_->lookup(keys_per_table, num_keys_per_table, vectors_per_table,
+                            inference_params_.model_name);
 
   // copy dense input to dense tensor
   auto dense_dims = dense_input_tensor_.get_dimensions();
@@ -19,6 +19,7 @@
 #include <functional>
 #include <string>
 #include <utils.hpp>
+#include <vector>
 
 namespace HugeCTR {
 
@@ -26,56 +27,61 @@ namespace {
 
 constexpr float eps = 1e-4;  // Epsilon for CPU computation
 
+inline float to_float(float val) { return val; }
+inline float to_float(__half val) { return __half2float(val); }
+
+template <typename T>
+inline T from_float(float val);
+template <>
+inline float from_float<float>(float val) {
+  return val;
+}
+template <>
+inline __half from_float<__half>(float val) {
+  return __float2half(val);
+}
+
+// The statistics are accumulated row by row, so that the innermost loops stream through
+// contiguous features and can be vectorized. Each feature still sums its rows in order. The
+// normalization of the rows is independent, and runs in parallel.
 template <typename T>
 void batch_norm_fprop_cpu(const float* gamma, const float* beta, const T* in, T* out,
                           int batch_size, int num_feature) {
-  for (int j = 0; j < num_feature; j++) {
-    float mean = 0.0f;
-    for (int i = 0; i < batch_size; i++) {
-      int idx = i * num_feature + j;
-      mean += in[idx];
-    }
-    mean /= batch_size;
-
-    float var = 0.0f;
-    for (int i = 0; i < batch_size; i++) {
-      int idx = i * num_feature + j;
-      float diff = in[idx] - mean;
-      var += (diff * diff);
-    }
-    var /= batch_size;
-
-    for (int i = 0; i < batch_size; i++) {
-      int idx = i * num_feature + j;
-      float in_norm = (in[idx] - mean) / sqrt(var + eps);
-      out[idx] = gamma[j] * in_norm + beta[j];
+  std::vector<float> mean(num_feature, 0.0f);
+  std::vector<float> var(num_feature, 0.0f);
+  for (int i = 0; i < batch_size; i++) {
+    const T* in_row = in + static_cast<size_t>(i) * num_feature;
+#pragma omp simd
+    for (int j = 0; j < num_feature; j++) {
+      mean[j] += to_float(in_row[j]);
     }
   }
-}
-
-template <>
-void batch_norm_fprop_cpu<__half>(const float* gamma, const float* beta, const __half* in,
-                                  __half* out, int batch_size, int num_feature) {
+#pragma omp simd
   for (int j = 0; j < num_feature; j++) {
-    float mean = 0.0f;
-    for (int i = 0; i < batch_size; i++) {
-      int idx = i * num_feature + j;
-      mean += __half2float(in[idx]);
-    }
-    mean /= batch_size;
+    mean[j] /= batch_size;
+  }
 
-    float var = 0.0f;
-    for (int i = 0; i < batch_size; i++) {
-      int idx = i * num_feature + j;
-      float diff = __half2float(in[idx]) - mean;
-      var += (diff * diff);
+  for (int i = 0; i < batch_size; i++) {
+    const T* in_row = in + static_cast<size_t>(i) * num_feature;
+#pragma omp simd
+    for (int j = 0; j < num_feature; j++) {
+      float diff = to_float(in_row[j]) - mean[j];
+      var[j] += (diff * diff);
     }
-    var /= batch_size;
+  }
+  std::vector<float> std_dev(num_feature);
+  for (int j = 0; j < num_feature; j++) {
+    std_dev[j] = sqrt(var[j] / batch_size + eps);
+  }
 
-    for (int i = 0; i < batch_size; i++) {
-      int idx = i * num_feature + j;
-      float in_norm = (__half2float(in[idx]) - mean) / sqrt(var + eps);
-      out[idx] = __float2half(gamma[j] * in_norm + beta[j]);
+#pragma omp parallel for
+  for (int i = 0; i < batch_size; i++) {
+    const T* in_row = in + static_cast<size_t>(i) * num_feature;
+    T* out_row = out + static_cast<size_t>(i) * num_feature;
+#pragma omp simd
+    for (int j = 0; j < num_feature; j++) {
+      float in_norm = (to_float(in_row[j]) - mean[j]) / std_dev[j];
+      out_row[j] = from_float<T>(gamma[j] * in_norm + beta[j]);
     }
   }
 }
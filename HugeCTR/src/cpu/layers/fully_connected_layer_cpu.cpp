@@ -22,19 +22,35 @@ namespace HugeCTR {
 
 namespace {
 
-void cpu_mm(float* a, float* b, float* c, int m, int k, int n) {
+// Rows are computed in parallel. Within a row, the loop over kk is hoisted above the loop over j,
+// so that the innermost loop streams through contiguous rows of b and c, and can be vectorized.
+// Each output still accumulates its products in the order of kk.
+void cpu_mm(const float* a, const float* b, float* c, int m, int k, int n) {
+#pragma omp parallel for
   for (int i = 0; i < m; ++i) {
+    float* c_row = c + static_cast<size_t>(i) * n;
+#pragma omp simd
     for (int j = 0; j < n; ++j) {
-      c[i * n + j] = 0.0f;
-      for (int kk = 0; kk < k; ++kk) c[i * n + j] += a[i * k + kk] * b[kk * n + j];
+      c_row[j] = 0.0f;
+    }
+    for (int kk = 0; kk < k; ++kk) {
+      const float a_ik = a[static_cast<size_t>(i) * k + kk];
+      const float* b_row = b + static_cast<size_t>(kk) * n;
+#pragma omp simd
+      for (int j = 0; j < n; ++j) {
+        c_row[j] += a_ik * b_row[j];
+      }
     }
   }
 }
 
-void cpu_add_bias(float* out, float* bias, int m, int n) {
+void cpu_add_bias(float* out, const float* bias, int m, int n) {
+#pragma omp parallel for
   for (int i = 0; i < m; ++i) {
+    float* out_row = out + static_cast<size_t>(i) * n;
+#pragma omp simd
     for (int j = 0; j < n; ++j) {
-      out[i * n + j] += bias[j];
+      out_row[j] += bias[j];
     }
   }
 }
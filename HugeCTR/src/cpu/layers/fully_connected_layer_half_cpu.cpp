@@ -23,6 +23,7 @@ namespace {
 
 void cpu_mm(__half* c, const __half* a, bool transpose_a, const __half* b, bool transpose_b, int m,
             int k, int n) {
+#pragma omp parallel for
   for (int i = 0; i < m; ++i) {
     for (int j = 0; j < n; ++j) {
       float sum = 0.0f;
@@ -37,6 +38,7 @@ void cpu_mm(__half* c, const __half* a, bool transpose_a, const __half* b, bool
 }
 
 void cpu_add_bias(__half* top, const __half* bias, int m, int n) {
+#pragma omp parallel for
   for (int i = 0; i < m; ++i) {
     for (int j = 0; j < n; ++j) {
       top[i * n + j] = top[i * n + j] + bias[j];
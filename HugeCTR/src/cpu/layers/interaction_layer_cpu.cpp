@@ -45,8 +45,9 @@ struct __align__(8) half4 {
 template <typename T>
 void concat_cpu(size_t height, size_t in_width, size_t out_width, size_t n_ins, size_t n_emb,
                 bool fprop, T *h_concat, T *h_in_mlp, T *h_in_emb) {
-  for (size_t ni = 0; ni < n_ins; ni++) {
-    for (size_t h = 0; h < height; h++) {
+#pragma omp parallel for
+  for (size_t h = 0; h < height; h++) {
+    for (size_t ni = 0; ni < n_ins; ni++) {
       size_t in_idx_base = (ni == 0) ? h * in_width : h * in_width * n_emb;
       for (size_t w = 0; w < in_width; w++) {
         size_t in_idx = in_idx_base + w;
@@ -65,19 +66,23 @@ void concat_cpu(size_t height, size_t in_width, size_t out_width, size_t n_ins,
   }
 }
 
+// The interaction matrix is symmetric, so only its upper triangle is computed and mirrored.
 template <typename T>
 void matmul_cpu(size_t height, size_t in_width, size_t n_ins, T *h_concat, T *h_mat) {
+#pragma omp parallel for
   for (size_t p = 0; p < height; p++) {
     size_t concat_stride = n_ins * in_width * p;
     size_t mat_stride = n_ins * n_ins * p;
     for (size_t m = 0; m < n_ins; m++) {
-      for (size_t n = 0; n < n_ins; n++) {
+      const T *row_m = h_concat + concat_stride + m * in_width;
+      for (size_t n = m; n < n_ins; n++) {
+        const T *row_n = h_concat + concat_stride + n * in_width;
         float accum = 0.0f;
         for (size_t k = 0; k < in_width; k++) {
-          accum += __half2float(h_concat[concat_stride + m * in_width + k] *
-                                h_concat[concat_stride + n * in_width + k]);
+          accum += __half2float(row_m[k] * row_n[k]);
         }
         h_mat[mat_stride + m * n_ins + n] = accum;
+        h_mat[mat_stride + n * n_ins + m] = accum;
       }
     }
   }
@@ -87,6 +92,7 @@ template <typename T>
 void gather_concat_cpu(size_t height, size_t in_width, size_t n_ins, T *h_in_mlp, T *h_mat,
                        T *h_ref) {
   size_t out_len = in_width + (n_ins * (n_ins + 1) / 2 - n_ins) + 1;
+#pragma omp parallel for
   for (size_t p = 0; p < height; p++) {
     size_t cur_idx = 0;
     size_t out_stride = p * out_len;
@@ -22,50 +22,33 @@ namespace HugeCTR {
 
 namespace {
 
-void matrix_vec_mul(float* out, const float* in_m, const float* in_v, size_t h, size_t w) {
-  for (size_t j = 0; j < h; j++) {
-    out[j] = 0.0f;
-    for (size_t i = 0; i < w; i++) {
-      size_t k = j * w + i;
-      out[j] += in_m[k] * in_v[i];
-    }
-  }
-}
-
-void row_scaling(float* out, const float* in_m, const float* in_v, size_t h, size_t w) {
-  for (size_t j = 0; j < h; j++) {
-    for (size_t i = 0; i < w; i++) {
-      size_t k = j * w + i;
-      out[k] = in_m[k] * in_v[j];
-    }
-  }
-}
-
-void matrix_add(float* out, const float* in_m_1, const float* in_m_2, size_t h, size_t w) {
-  for (size_t j = 0; j < h; j++) {
-    for (size_t i = 0; i < w; i++) {
-      size_t k = j * w + i;
-      out[k] = in_m_1[k] + in_m_2[k];
-    }
-  }
-}
-
-void matrix_vec_add(float* out, const float* in_m, const float* in_v, size_t h, size_t w) {
-  for (size_t j = 0; j < h; j++) {
-    for (size_t i = 0; i < w; i++) {
-      size_t k = j * w + i;
-      out[k] = in_m[k] + in_v[i];
-    }
-  }
-}
-
+// Each row goes through all steps of a layer at once, while it is in cache, and the rows of a
+// layer are independent of each other:
+// hidden = x_l . kernel, x_{l+1} = x_0 * hidden + x_l + bias
 void multi_cross_fprop_cpu(int layers, size_t batchsize, size_t w, float** h_outputs,
                            float* h_input, float** h_hiddens, float** h_kernels, float** h_biases) {
   for (int i = 0; i < layers; i++) {
-    matrix_vec_mul(h_hiddens[i], i == 0 ? h_input : h_outputs[i - 1], h_kernels[i], batchsize, w);
-    row_scaling(h_outputs[i], h_input, h_hiddens[i], batchsize, w);
-    matrix_add(h_outputs[i], h_outputs[i], i == 0 ? h_input : h_outputs[i - 1], batchsize, w);
-    matrix_vec_add(h_outputs[i], h_outputs[i], h_biases[i], batchsize, w);
+    const float* h_prev = i == 0 ? h_input : h_outputs[i - 1];
+    const float* kernel = h_kernels[i];
+    const float* bias = h_biases[i];
+#pragma omp parallel for
+    for (size_t j = 0; j < batchsize; j++) {
+      const float* x0 = h_input + j * w;
+      const float* xl = h_prev + j * w;
+      float* out = h_outputs[i] + j * w;
+
+      float hidden = 0.0f;
+#pragma omp simd reduction(+ : hidden)
+      for (size_t k = 0; k < w; k++) {
+        hidden += xl[k] * kernel[k];
+      }
+      h_hiddens[i][j] = hidden;
+
+#pragma omp simd
+      for (size_t k = 0; k < w; k++) {
+        out[k] = x0[k] * hidden + xl[k] + bias[k];
+      }
+    }
   }
 }
 
@@ -23,8 +23,12 @@ namespace HugeCTR {
 
 namespace {
 
+// Below this number of elements, spawning threads costs more than it saves
+constexpr int parallel_threshold = 1 << 16;
+
 template <typename T>
 void relu_cpu(T* top, const T* bottom, int len) {
+#pragma omp parallel for simd if (len >= parallel_threshold)
   for (int i = 0; i < len; ++i) {
     if (bottom[i] > T(0.)) {
       top[i] = bottom[i];
@@ -68,11 +68,12 @@ ThreadAsyncReader::ThreadAsyncReader(std::string fname, const ResourceManager* r
   max_num_blocks_per_batch_ = batch_size_bytes_ / params_.io_block_size + 2;
   size_t pinned_size = 0;
   for (auto buf : dest_buffers_) {
-    buf->raw_host_ptr = (char*)aligned_alloc(params_.io_alignment,
-                                             max_num_blocks_per_batch_ * params_.io_block_size);
-    HCTR_LIB_THROW(
-        cudaHostRegister(buf->raw_host_ptr, max_num_blocks_per_batch_ * params_.io_block_size, 0));
-    assert((size_t)buf->raw_host_ptr % params_.io_alignment == 0);
+    // Arena buffers are page-aligned, which covers the usual IO alignments.
+    buf->host_buffer = core23::PinnedHostArena::instance().acquire(
+        "data_reader", max_num_blocks_per_batch_ * params_.io_block_size);
+    buf->raw_host_ptr = static_cast<char*>(buf->host_buffer.data());
+    HCTR_CHECK_HINT((size_t)buf->raw_host_ptr % params_.io_alignment == 0,
+                    "io_alignment must not exceed the page size");
 
     HCTR_LIB_THROW(cudaEventCreateWithFlags(&buf->event, cudaEventDisableTiming));
 
@@ -49,21 +49,21 @@ void DataCollector<T>::BackgroundDataCollectorThread::start() {
     }
 
     if ((current_src_buffer->state.load() == BufferState::Reading ||
-         current_src_buffer->state.compare_exchange_weak(src_expected, BufferState::Reading)) &&
+         current_src_buffer->state.compare_exchange_strong(src_expected, BufferState::Reading)) &&
         (dst_buffer->state.load() == BufferState::Writing ||
-         dst_buffer->state.compare_exchange_weak(dst_expected, BufferState::Writing))) {
+         dst_buffer->state.compare_exchange_strong(dst_expected, BufferState::Writing))) {
       assert(current_src_buffer->state.load() == BufferState::Reading);
       assert(dst_buffer->state.load() == BufferState::Writing);
 
       if (current_src_buffer->current_batch_size == 0) {
         worker_status_[counter_] = 1;
         eof_worker_num_ += 1;
-        current_src_buffer->state.store(BufferState::FileEOF);
+        store_buffer_state(current_src_buffer->state, BufferState::FileEOF);
       }
       if (static_cast<size_t>(eof_worker_num_) != thread_buffers_.size() &&
           current_src_buffer->current_batch_size == 0) {
         counter_ = (counter_ + 1) % thread_buffers_.size();
-        dst_buffer->state.store(BufferState::ReadyForWrite);
+        store_buffer_state(dst_buffer->state, BufferState::ReadyForWrite);
         continue;
       }
       dst_buffer->current_batch_size = current_src_buffer->current_batch_size;
@@ -71,7 +71,7 @@ void DataCollector<T>::BackgroundDataCollectorThread::start() {
         // P2P
         broadcast<T>(current_src_buffer, dst_buffer, last_batch_nnz_, resource_manager_);
 
-        current_src_buffer->state.store(BufferState::ReadyForWrite);
+        store_buffer_state(current_src_buffer->state, BufferState::ReadyForWrite);
         counter_ = (counter_ + 1) % thread_buffers_.size();
       } else {
         memset(worker_status_.data(), 0, sizeof(char) * worker_status_.size());
@@ -79,9 +79,17 @@ void DataCollector<T>::BackgroundDataCollectorThread::start() {
         counter_ = 0;
       }
 
-      dst_buffer->state.store(BufferState::ReadyForRead);
+      store_buffer_state(dst_buffer->state, BufferState::ReadyForRead);
     } else {
-      usleep(2);
+      // the source buffer stays in Reading once it is taken, so only one of them is waited on
+      const auto src_state = current_src_buffer->state.load();
+      const auto dst_state = dst_buffer->state.load();
+      if (src_state != BufferState::Reading && src_state != BufferState::ReadyForRead) {
+        wait_buffer_state_change(current_src_buffer->state, src_state);
+      } else if (src_state == BufferState::Reading && dst_state != BufferState::Writing &&
+                 dst_state != BufferState::ReadyForWrite) {
+        wait_buffer_state_change(dst_buffer->state, dst_state);
+      }
     }
   }
 }
@@ -131,9 +139,9 @@ DataCollector<T>::~DataCollector() {
 template <typename T>
 long long DataCollector<T>::read_a_batch_to_device() {
   BufferState expected = BufferState::ReadyForRead;
-  while (!broadcast_buffer_->state.compare_exchange_weak(expected, BufferState::Reading)) {
+  while (!broadcast_buffer_->state.compare_exchange_strong(expected, BufferState::Reading)) {
+    wait_buffer_state_change(broadcast_buffer_->state, expected);
     expected = BufferState::ReadyForRead;
-    usleep(2);
   }
   long long current_batch_size = broadcast_buffer_->current_batch_size;
   if (current_batch_size != 0) {
@@ -194,7 +202,7 @@ long long DataCollector<T>::read_a_batch_to_device() {
     }
     nvtxRangePop();
   } else {
-    broadcast_buffer_->state.store(BufferState::ReadyForWrite);
+    store_buffer_state(broadcast_buffer_->state, BufferState::ReadyForWrite);
   }
   return current_batch_size;
 }
@@ -206,7 +214,7 @@ void DataCollector<T>::finalize_batch() {
     CudaDeviceContext ctx(resource_manager_->get_local_gpu(id)->get_device_id());
     HCTR_LIB_THROW(cudaStreamSynchronize(resource_manager_->get_local_gpu(id)->get_stream()));
   }
-  broadcast_buffer_->state.store(BufferState::ReadyForWrite);
+  store_buffer_state(broadcast_buffer_->state, BufferState::ReadyForWrite);
 }
 };  // namespace core23_reader
 template class core23_reader::DataCollector<long long>;
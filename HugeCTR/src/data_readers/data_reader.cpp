@@ -84,7 +84,7 @@ DataReader<TypeKey>::DataReader(int batchsize, size_t label_dim, int dense_dim,
     // allocate eagerly
     current_thread_buffer->device_dense_buffers.data();
 
-    current_thread_buffer->state.store(BufferState::ReadyForWrite);
+    store_buffer_state(current_thread_buffer->state, BufferState::ReadyForWrite);
     current_thread_buffer->current_batch_size = 0;
     current_thread_buffer->batch_size = batchsize;
     current_thread_buffer->param_num = params.size();
@@ -100,7 +100,7 @@ DataReader<TypeKey>::DataReader(int batchsize, size_t label_dim, int dense_dim,
   broadcast_buffer_->is_fixed_length.reserve(local_gpu_count * params.size());
   broadcast_buffer_->dense_tensors.reserve(local_gpu_count);
   broadcast_buffer_->finish_broadcast_events.resize(local_gpu_count);
-  broadcast_buffer_->state.store(BufferState::ReadyForWrite);
+  store_buffer_state(broadcast_buffer_->state, BufferState::ReadyForWrite);
   broadcast_buffer_->current_batch_size = 0;
   broadcast_buffer_->param_num = params.size();
 
@@ -14,17 +14,17 @@
  * limitations under the License.
  */
 
-#include <nvToolsExt.h>
-
 #include <data_readers/data_reader_worker.hpp>
 #include <fstream>
+#include <optional>
+#include <timeline.hpp>
 
 namespace HugeCTR {
 
 namespace core23_reader {
 template <typename T>
 void DataReaderWorker<T>::read_new_file() {
-  nvtxRangePushA("read_new_file");
+  TraceRange range(TraceCategory::DataReader, "read_new_file");
   constexpr int MAX_TRY = 10;
   for (int i = 0; i < MAX_TRY; i++) {
     if (checker_->next_source(1) == Error_t::EndOfFile) {
@@ -34,7 +34,8 @@ void DataReaderWorker<T>::read_new_file() {
     Error_t err = checker_->read(reinterpret_cast<char*>(&data_set_header_), sizeof(DataSetHeader));
     current_record_index_ = 0;
     if (!(data_set_header_.error_check == 0 && check_type_ == Check_t::None) &&
-        !(data_set_header_.error_check == 1 && check_type_ == Check_t::Sum)) {
+        !(data_set_header_.error_check == 1 &&
+          (check_type_ == Check_t::Sum || check_type_ == Check_t::SumDeferred))) {
       HCTR_LOG_S(ERROR, WORLD) << "DataHeaderError " << HCTR_LOCATION() << std::endl;
       continue;
     }
@@ -43,12 +44,10 @@ void DataReaderWorker<T>::read_new_file() {
       continue;
     }
     if (err == Error_t::Success) {
-      nvtxRangePop();
       return;
     }
   }
   HCTR_OWN_THROW(Error_t::BrokenFile, "failed to read a file");
-  nvtxRangePop();
 }
 
 template <typename T>
@@ -109,7 +108,9 @@ void DataReaderWorker<T>::read_a_batch() {
   int label_dense_dim = label_dim + dense_dim;
   int batch_size_start_idx = buffer23_->batch_size_start_idx;
   int batch_size_end_idx = buffer23_->batch_size_end_idx;
-  nvtxRangePushA("read_a_batch_to_host");
+  // Ends before the h2d, and with each of the early returns.
+  std::optional<TraceRange> host_range;
+  host_range.emplace(TraceCategory::DataReader, "read_a_batch_to_host");
 
   try {
     if (!checker_->is_open()) {
@@ -125,10 +126,11 @@ void DataReaderWorker<T>::read_a_batch() {
       buffer23_->current_batch_size = 0;
       assert(buffer23_->state.load() == BufferState::Writing);
       is_eof_ = true;
-      buffer23_->state.store(BufferState::ReadyForRead);
+      store_buffer_state(buffer23_->state, BufferState::ReadyForRead);
 
-      while (buffer23_->state.load() != BufferState::ReadyForWrite) {
-        usleep(2);
+      for (auto state = buffer23_->state.load(); state != BufferState::ReadyForWrite;
+           state = buffer23_->state.load()) {
+        wait_buffer_state_change(buffer23_->state, state);
         if (!loop_flag_->load()) return;  // in case main thread exit
       }
       return;  // need this return to run from beginning
@@ -240,13 +242,13 @@ void DataReaderWorker<T>::read_a_batch() {
   for (auto& each_csr : host_sparse_buffer_) {
     each_csr.new_row();
   }
-  nvtxRangePop();
+  host_range.reset();
 
   // do h2d
   // wait buffer and schedule
 
   if (!wait_until_h2d_ready()) return;
-  nvtxRangePushA("h2d");
+  TraceRange h2d_range(TraceCategory::DataReader, "h2d");
   buffer23_->current_batch_size = current_batch_size;
   {
     CudaCPUDeviceContext context(gpu_resource_->get_device_id());
@@ -271,8 +273,7 @@ void DataReaderWorker<T>::read_a_batch() {
     HCTR_LIB_THROW(cudaStreamSynchronize(gpu_resource_->get_memcpy_stream()));
   }
   assert(buffer23_->state.load() == BufferState::Writing);
-  buffer23_->state.store(BufferState::ReadyForRead);
-  nvtxRangePop();
+  store_buffer_state(buffer23_->state, BufferState::ReadyForRead);
 }
 }  // namespace core23_reader
 
@@ -76,10 +76,11 @@ void DataReaderWorkerRaw<T>::read_a_batch() {
       buffer23_->current_batch_size = 0;
       assert(buffer23_->state.load() == BufferState::Writing);
       is_eof_ = true;
-      buffer23_->state.store(BufferState::ReadyForRead);
+      store_buffer_state(buffer23_->state, BufferState::ReadyForRead);
 
-      while (buffer23_->state.load() != BufferState::ReadyForWrite) {
-        usleep(2);
+      for (auto state = buffer23_->state.load(); state != BufferState::ReadyForWrite;
+           state = buffer23_->state.load()) {
+        wait_buffer_state_change(buffer23_->state, state);
         if (!loop_flag_->load()) return;
       }
       return;
@@ -193,7 +194,7 @@ void DataReaderWorkerRaw<T>::read_a_batch() {
   }
 
   assert(buffer23_->state.load() == BufferState::Writing);
-  buffer23_->state.store(BufferState::ReadyForRead);
+  store_buffer_state(buffer23_->state, BufferState::ReadyForRead);
 
   return;
 }
@@ -123,6 +123,14 @@ Error_t ParquetFileSource::next_source(long long expected_num_row_group) noexcep
     if (err != Error_t::Success) {
       return err;
     }
+    // Read the following file while this one is consumed.
+    const std::string prefetch_file_name{
+        sequential_file_consumption_
+            ? file_list_.get_a_file_with_id(counter_, repeat_)
+            : file_list_.get_a_file_with_id(offset_ + counter_ * stride_, repeat_)};
+    if (!prefetch_file_name.empty() && prefetch_file_name != file_name_) {
+      file_loader_->prefetch(prefetch_file_name);
+    }
     parquet_args_ = cudf_io::parquet_reader_options::builder(cudf_io::source_info{
         file_loader_->get_loaded_data(), file_loader_->get_current_file_size()});
     curr_row_idx_ = 0;  // set row to zero id
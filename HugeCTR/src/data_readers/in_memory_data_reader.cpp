@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common.hpp>
+#include <core23/tensor_operations.hpp>
+#include <data_readers/in_memory_data_reader.hpp>
+#include <tensor2.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+// The current batch and the two batches before it may be read on the gpus, as the pipeline reads
+// the next batch while the current one is trained.
+constexpr size_t kNumSlots = 3;
+
+// Keys of the same width are taken whatever their sign, as e.g. torch tensors have no uint32.
+bool is_key_type(const core23::DataType& data_type, const core23::DataType& key_type) {
+  const bool is_integer =
+      data_type == core23::ScalarType::Int32 || data_type == core23::ScalarType::UInt32 ||
+      data_type == core23::ScalarType::Int64 || data_type == core23::ScalarType::UInt64 ||
+      data_type == core23::ScalarType::LongLong;
+  return is_integer && data_type.size() == key_type.size();
+}
+
+}  // namespace
+
+template <typename SparseType>
+InMemoryDataReader<SparseType>::InMemoryDataReader(
+    const std::shared_ptr<ResourceManager>& resource_manager, size_t batch_size,
+    const std::vector<DataReaderSparseParam>& params, size_t label_dim, size_t dense_dim,
+    bool mixed_precision, size_t queue_capacity, bool fixed_buffers)
+    : resource_manager_(resource_manager),
+      batch_size_(batch_size),
+      batch_size_per_dev_(batch_size / resource_manager->get_global_gpu_count()),
+      label_dim_(label_dim),
+      dense_dim_(dense_dim),
+      mixed_precision_(mixed_precision),
+      fixed_buffers_(fixed_buffers),
+      queue_capacity_(queue_capacity),
+      staging_values_(fixed_buffers ? 1 : kNumSlots),
+      release_events_(kNumSlots),
+      current_sparse_values_(resource_manager->get_local_gpu_count()),
+      current_dp_bucket_ranges_(resource_manager->get_local_gpu_count()),
+      split_schedule_events_(resource_manager->get_local_gpu_count()),
+      d2d_schedule_events_(resource_manager->get_local_gpu_count()),
+      s3w_streams_(resource_manager->get_local_gpu_count()),
+      d2d_streams_(resource_manager->get_local_gpu_count()) {
+  HCTR_CHECK_HINT(batch_size_ % resource_manager_->get_global_gpu_count() == 0,
+                  "The batch size of the InMemory data reader must be a multiple of the number "
+                  "of gpus");
+  HCTR_CHECK_HINT(params.size() == 1 && params[0].is_fixed_length,
+                  "The InMemory data reader needs one sparse input with a fixed hotness");
+  HCTR_CHECK_HINT(queue_capacity_ > 0, "The InMemory data reader needs a queue");
+  nnz_per_slot_ = params[0].nnz_per_slot;
+
+  for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
+    const auto local_gpu = resource_manager_->get_local_gpu(i);
+    const int gpu_id = local_gpu->get_device_id();
+    CudaDeviceContext ctx(gpu_id);
+    const core23::Device device(core23::DeviceType::GPU, static_cast<int8_t>(gpu_id));
+
+    HCTR_LIB_THROW(cudaEventCreateWithFlags(&split_schedule_events_[i], cudaEventDisableTiming));
+    HCTR_LIB_THROW(cudaEventCreateWithFlags(&d2d_schedule_events_[i], cudaEventDisableTiming));
+    for (auto& events : release_events_) {
+      cudaEvent_t event;
+      HCTR_LIB_THROW(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+      events.push_back(event);
+    }
+
+    // set default stream
+    s3w_streams_[i] = local_gpu->get_stream();
+    d2d_streams_[i] = local_gpu->get_stream();
+
+    label_tensors_.emplace_back(core23::TensorParams()
+                                    .shape({static_cast<int64_t>(batch_size_per_dev_),
+                                            static_cast<int64_t>(label_dim_)})
+                                    .data_type(core23::ScalarType::Float)
+                                    .device(device));
+    dense_tensors_.emplace_back(
+        core23::TensorParams()
+            .shape({static_cast<int64_t>(batch_size_per_dev_), static_cast<int64_t>(dense_dim_)})
+            .data_type(mixed_precision_ ? core23::ScalarType::Half : core23::ScalarType::Float)
+            .device(device));
+    core23::zeros_sync(dense_tensors_.back());
+
+    for (auto& slot_values : staging_values_) {
+      std::vector<core23::Tensor> values;
+      for (const int hotness : nnz_per_slot_) {
+        values.emplace_back(core23::TensorParams()
+                                .shape({static_cast<int64_t>(batch_size_per_dev_), hotness})
+                                .data_type(core23::ToScalarType<SparseType>::value)
+                                .device(device));
+        // allocate eagerly
+        values.back().data();
+      }
+      slot_values.push_back(values);
+    }
+    // Needed for the data distributor on construction
+    current_sparse_values_[i] = staging_values_[0][i];
+  }
+}
+
+template <typename SparseType>
+void InMemoryDataReader<SparseType>::push(InMemoryBatch batch) {
+  const size_t num_local_gpus = resource_manager_->get_local_gpu_count();
+  HCTR_THROW_IF(batch.labels.size() != num_local_gpus || batch.dense.size() != num_local_gpus ||
+                    batch.sparse.size() != num_local_gpus,
+                Error_t::WrongInput, "A batch needs the tensors of each of the ", num_local_gpus,
+                " local gpus");
+  const core23::DataType dense_type =
+      mixed_precision_ ? core23::ScalarType::Half : core23::ScalarType::Float;
+  for (size_t i = 0; i < num_local_gpus; i++) {
+    const int gpu_id = resource_manager_->get_local_gpu(i)->get_device_id();
+    auto check = [&](const core23::Tensor& tensor, size_t num_items, bool is_valid_type,
+                     core23::DataType data_type, const std::string& name) {
+      const auto num_elements = static_cast<int64_t>(batch_size_per_dev_ * num_items);
+      HCTR_THROW_IF(tensor.num_elements() != num_elements || !is_valid_type, Error_t::WrongInput,
+                    "The ", name, " of local gpu ", i, " need ", batch_size_per_dev_, " x ",
+                    num_items, " items of ", data_type.name());
+      HCTR_THROW_IF(tensor.device().type() == core23::DeviceType::GPU &&
+                        tensor.device().index() != gpu_id,
+                    Error_t::WrongInput, "The ", name, " of local gpu ", i,
+                    " are on another gpu");
+    };
+    check(batch.labels[i], label_dim_, batch.labels[i].data_type() == core23::ScalarType::Float,
+          core23::ScalarType::Float, "labels");
+    check(batch.dense[i], dense_dim_, batch.dense[i].data_type() == dense_type, dense_type,
+          "dense features");
+    HCTR_THROW_IF(batch.sparse[i].size() != nnz_per_slot_.size(), Error_t::WrongInput,
+                  "A batch needs the sparse values of each of the ", nnz_per_slot_.size(),
+                  " features");
+    const core23::DataType key_type = core23::ToScalarType<SparseType>::value;
+    for (size_t fea_id = 0; fea_id < nnz_per_slot_.size(); ++fea_id) {
+      const core23::Tensor& values = batch.sparse[i][fea_id];
+      check(values, nnz_per_slot_[fea_id], is_key_type(values.data_type(), key_type), key_type,
+            "values of feature " + std::to_string(fea_id));
+    }
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return queue_.size() < queue_capacity_; });
+    queue_.push_back(std::move(batch));
+  }
+  not_empty_.notify_one();
+}
+
+template <typename SparseType>
+void InMemoryDataReader<SparseType>::finish() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return queue_.size() < queue_capacity_; });
+    queue_.emplace_back();
+  }
+  not_empty_.notify_one();
+}
+
+template <typename SparseType>
+void InMemoryDataReader<SparseType>::release_batches(size_t max_batches) {
+  while (!retired_batches_.empty()) {
+    const bool wait = retired_batches_.size() > max_batches;
+    for (const cudaEvent_t event : release_events_[retired_batches_.front().slot]) {
+      if (wait) {
+        HCTR_LIB_THROW(cudaEventSynchronize(event));
+      } else {
+        const cudaError_t status = cudaEventQuery(event);
+        if (status == cudaErrorNotReady) {
+          return;
+        }
+        HCTR_LIB_THROW(status);
+      }
+    }
+    retired_batches_.pop_front();
+  }
+}
+
+template <typename SparseType>
+long long InMemoryDataReader<SparseType>::read_a_batch_to_device_delay_release() {
+  InMemoryBatch batch;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return !queue_.empty(); });
+    batch = std::move(queue_.front());
+    queue_.pop_front();
+  }
+  not_full_.notify_one();
+
+  if (batch.labels.empty()) {  // end of the data
+    current_batch_size_ = 0;
+    return 0;
+  }
+
+  // The slot of the batch kNumSlots reads before is reused, once its reads have completed.
+  release_batches(kNumSlots - 2);
+  const size_t slot = num_batches_read_++ % kNumSlots;
+  const size_t staging_slot = fixed_buffers_ ? 0 : slot;
+
+  int num_local_gpus = resource_manager_->get_local_gpu_count();
+#pragma omp parallel for num_threads(num_local_gpus)
+  for (int i = 0; i < num_local_gpus; i++) {
+    auto local_gpu = resource_manager_->get_local_gpu(i);
+    CudaCPUDeviceContext ctx(local_gpu->get_device_id());
+
+    const cudaStream_t& stream = s3w_streams_[i];
+
+    // schedule at correct place in iteration
+    HCTR_LIB_THROW(cudaStreamWaitEvent(stream, split_schedule_events_[i]));
+
+    for (size_t fea_id = 0; fea_id < nnz_per_slot_.size(); ++fea_id) {
+      const core23::Tensor& values = batch.sparse[i][fea_id];
+      if (values.device().type() == core23::DeviceType::GPU && !fixed_buffers_) {
+        // The values are used in place, as keys of the shape of the staging buffers.
+        const core23::Tensor& staged = staging_values_[0][i][fea_id];
+        current_sparse_values_[i][fea_id] = core23::Tensor::bind(
+            values.data(), staged.shape(), staged.data_type(), values.device());
+      } else {
+        const core23::Tensor& staged = staging_values_[staging_slot][i][fea_id];
+        HCTR_LIB_THROW(cudaMemcpyAsync(staged.data(), values.data(), values.num_bytes(),
+                                       cudaMemcpyDefault, stream));
+        current_sparse_values_[i][fea_id] = staged;
+      }
+    }
+
+    auto sparse_ready_event = local_gpu->get_event("sparse_tensors_ready");
+    HCTR_LIB_THROW(cudaEventRecord(sparse_ready_event, stream));
+
+    auto d2d_stream = d2d_streams_[i];
+
+    HCTR_LIB_THROW(cudaStreamWaitEvent(d2d_stream, sparse_ready_event));
+
+    // we are safe to overwrite
+    HCTR_LIB_THROW(cudaStreamWaitEvent(d2d_stream, d2d_schedule_events_[i]));
+
+    // The previous batch is no longer read after this point.
+    if (current_batch_) {
+      HCTR_LIB_THROW(cudaEventRecord(release_events_[current_batch_->slot][i], d2d_stream));
+    }
+
+    HCTR_LIB_THROW(cudaMemcpyAsync(label_tensors_[i].data(), batch.labels[i].data(),
+                                   label_tensors_[i].num_bytes(), cudaMemcpyDefault, d2d_stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(dense_tensors_[i].data(), batch.dense[i].data(),
+                                   dense_tensors_[i].num_bytes(), cudaMemcpyDefault, d2d_stream));
+
+    auto tensors_ready_event = local_gpu->get_event("bottom_MLP_tensors_ready");
+    HCTR_LIB_THROW(cudaEventRecord(tensors_ready_event, d2d_stream));
+  }
+
+  if (current_batch_) {
+    retired_batches_.push_back(std::move(*current_batch_));
+  }
+  current_batch_ = ReadBatch{std::move(batch), slot};
+  current_batch_size_ = batch_size_;
+  return current_batch_size_;
+}
+
+template <typename SparseType>
+long long InMemoryDataReader<SparseType>::read_a_batch_to_device() {
+  auto result = read_a_batch_to_device_delay_release();
+  ready_to_collect();
+  return result;
+}
+
+template <typename SparseType>
+long long InMemoryDataReader<SparseType>::get_current_batchsize_per_device(size_t local_id) {
+  return current_batch_size_ ? batch_size_per_dev_ : 0;
+}
+
+template <typename SparseType>
+TensorScalarType InMemoryDataReader<SparseType>::get_scalar_type() const {
+  return TensorScalarTypeFunc<SparseType>::get_type();
+}
+
+template <typename SparseType>
+void InMemoryDataReader<SparseType>::set_schedule_streams(cudaStream_t s3w_stream,
+                                                          cudaStream_t d2d_stream,
+                                                          int raw_device_id) {
+  s3w_streams_[raw_device_id] = s3w_stream;
+  d2d_streams_[raw_device_id] = d2d_stream;
+}
+
+template <typename SparseType>
+void InMemoryDataReader<SparseType>::schedule_split_3_way_here(cudaStream_t stream,
+                                                               int raw_device_id,
+                                                               bool from_graph) {
+  unsigned int flags = from_graph ? cudaEventRecordExternal : 0;
+  HCTR_LIB_THROW(cudaEventRecordWithFlags(split_schedule_events_[raw_device_id], stream, flags));
+}
+
+template <typename SparseType>
+void InMemoryDataReader<SparseType>::schedule_d2d_here(cudaStream_t stream, int raw_device_id,
+                                                       bool from_graph) {
+  unsigned int flags = from_graph ? cudaEventRecordExternal : 0;
+  HCTR_LIB_THROW(cudaEventRecordWithFlags(d2d_schedule_events_[raw_device_id], stream, flags));
+}
+
+template <typename SparseType>
+void InMemoryDataReader<SparseType>::stream_wait_sparse_tensors(cudaStream_t stream,
+                                                                int raw_device_id,
+                                                                bool from_graph) {
+  auto gpu = resource_manager_->get_local_gpu(raw_device_id);
+  const auto flags = from_graph ? cudaEventWaitExternal : 0;
+  HCTR_LIB_THROW(cudaStreamWaitEvent(stream, gpu->get_event("sparse_tensors_ready"), flags));
+}
+
+template <typename SparseType>
+void InMemoryDataReader<SparseType>::stream_wait_dense_tensors(cudaStream_t stream,
+                                                               int raw_device_id,
+                                                               bool from_graph) {
+  auto gpu = resource_manager_->get_local_gpu(raw_device_id);
+  const auto flags = from_graph ? cudaEventWaitExternal : 0;
+  HCTR_LIB_THROW(cudaStreamWaitEvent(stream, gpu->get_event("bottom_MLP_tensors_ready"), flags));
+}
+
+template <typename SparseType>
+InMemoryDataReader<SparseType>::~InMemoryDataReader() {
+  // The batches must not be released while the gpus may still read them.
+  for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
+    CudaDeviceContext ctx(resource_manager_->get_local_gpu(i)->get_device_id());
+    cudaDeviceSynchronize();
+    cudaEventDestroy(split_schedule_events_[i]);
+    cudaEventDestroy(d2d_schedule_events_[i]);
+    for (auto& events : release_events_) {
+      cudaEventDestroy(events[i]);
+    }
+  }
+}
+
+template class InMemoryDataReader<uint32_t>;
+template class InMemoryDataReader<long long>;
+}  // namespace HugeCTR
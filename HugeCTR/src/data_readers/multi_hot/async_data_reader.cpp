@@ -20,7 +20,10 @@
 #include <data_readers/async_reader/async_reader_adapter.hpp>
 #include <data_readers/async_reader/async_reader_common.hpp>
 #include <data_readers/multi_hot/async_data_reader.hpp>
+#include <data_readers/multi_hot/packed_format.hpp>
 #include <data_readers/multi_hot/split_batch.hpp>
+#include <data_readers/multi_hot/synthetic_format.hpp>
+#include <data_readers/multi_hot/variable_format.hpp>
 #include <inference/preallocated_buffer2.hpp>
 #include <resource_manager.hpp>
 #include <tensor2.hpp>
@@ -34,9 +37,12 @@ AsyncDataReader<SparseType>::AsyncDataReader(
     std::vector<FileSource> data_files, const std::shared_ptr<ResourceManager>& resource_manager,
     size_t batch_size, size_t num_threads_per_file, size_t num_batches_per_thread,
     const std::vector<DataReaderSparseParam>& params, size_t label_dim, size_t dense_dim,
-    bool mixed_precision, bool shuffle, bool schedule_uploads, bool is_dense_float)
+    bool mixed_precision, bool shuffle, bool schedule_uploads, bool is_dense_float,
+    IOBackend_t io_backend, size_t shuffle_window, const ReaderPosition& start_position,
+    const SyntheticSource& synthetic_source, const TokenBudget& token_budget)
     : resource_manager_(resource_manager),
       mixed_precision_(mixed_precision),
+      shuffle_(shuffle),
       batch_size_(batch_size),
       batch_size_per_dev_(batch_size / resource_manager->get_global_gpu_count()),
       completion_events_(resource_manager->get_local_gpu_count()),
@@ -45,8 +51,11 @@ AsyncDataReader<SparseType>::AsyncDataReader(
       d2d_schedule_events_(resource_manager->get_local_gpu_count()),
       s3w_streams_(resource_manager->get_local_gpu_count()),
       d2d_streams_(resource_manager->get_local_gpu_count()),
+      current_dp_bucket_ranges_(resource_manager->get_local_gpu_count()),
       cache_buffers_(false),
-      is_dense_float_(is_dense_float) {
+      is_dense_float_(is_dense_float),
+      synthetic_(synthetic_source.enabled()),
+      synthetic_seed_(synthetic_source.seed) {
   assert(batch_size_ % resource_manager_->get_global_gpu_count() == 0);
   assert(params.size() == 1);
   static_assert(sizeof(LabelType) == sizeof(InputType));
@@ -77,11 +86,130 @@ AsyncDataReader<SparseType>::AsyncDataReader(
   dense_dim_ = dense_dim_align8;
   sparse_dim_ = sparse_dim;
 
-  data_files[0].sample_size_bytes = sample_size_items_ * sizeof(InputType);
+  file_sample_size_bytes_ = sample_size_items_ * sizeof(InputType);
+
+  // Synthetic samples are generated in the raw layout on the device, with float dense features.
+  std::vector<long long> key_vocabulary_sizes;
+  std::vector<float> key_alphas;
+  if (synthetic_) {
+    HCTR_CHECK_HINT(synthetic_source.vocabulary_sizes.size() == nnz_per_slot_.size() &&
+                        synthetic_source.alphas.size() == nnz_per_slot_.size(),
+                    "The synthetic data needs a vocabulary size and an alpha for each of the ",
+                    nnz_per_slot_.size(), " features");
+    for (size_t fea_id = 0; fea_id < nnz_per_slot_.size(); ++fea_id) {
+      HCTR_CHECK_HINT(synthetic_source.vocabulary_sizes[fea_id] > 0 &&
+                          synthetic_source.alphas[fea_id] >= 0.f,
+                      "Invalid vocabulary size or alpha of synthetic feature ", fea_id);
+      key_vocabulary_sizes.insert(key_vocabulary_sizes.end(), nnz_per_slot_[fea_id],
+                                  synthetic_source.vocabulary_sizes[fea_id]);
+      key_alphas.insert(key_alphas.end(), nnz_per_slot_[fea_id], synthetic_source.alphas[fea_id]);
+    }
+    is_dense_float_ = true;
+    HCTR_LOG(INFO, ROOT, "Generating synthetic samples of %zu features with seed %llu\n",
+             nnz_per_slot_.size(), static_cast<unsigned long long>(synthetic_seed_));
+  }
+
+  // Packed files are unpacked into the raw layout on the device. Their dense features are stored
+  // after the log transform, so they are float.
+  PackedFileHeader header;
+  std::vector<uint32_t> item_bit_offsets;
+  std::vector<int> key_bits;
+  packed_ = !synthetic_ && read_packed_header(data_files[0].name, header);
+  if (packed_) {
+    HCTR_CHECK_HINT(header.label_dim == label_dim && header.dense_dim == dense_dim &&
+                        header.num_features == nnz_per_slot_.size(),
+                    "The dimensions of the packed file ", data_files[0].name,
+                    " do not match the data reader params");
+    uint32_t bit_offset = 0;
+    for (size_t i = 0; i < label_dim; ++i, bit_offset += 32) {
+      item_bit_offsets.push_back(bit_offset);
+    }
+    for (size_t i = 0; i < dense_dim; ++i, bit_offset += 16) {
+      item_bit_offsets.push_back(bit_offset);
+    }
+    for (size_t fea_id = 0; fea_id < nnz_per_slot_.size(); ++fea_id) {
+      const int bits = static_cast<int>(header.key_bits[fea_id]);
+      HCTR_CHECK_HINT(static_cast<int>(header.hotness[fea_id]) == nnz_per_slot_[fea_id] &&
+                          bits > 0 && bits <= static_cast<int>(sizeof(SparseType) * 8),
+                      "The packed keys of feature ", fea_id, " of ", data_files[0].name,
+                      " do not match the data reader params");
+      for (int i = 0; i < nnz_per_slot_[fea_id]; ++i, bit_offset += bits) {
+        item_bit_offsets.push_back(bit_offset);
+        key_bits.push_back(bits);
+      }
+    }
+    HCTR_CHECK_HINT((bit_offset + 31) / 32 * sizeof(uint32_t) == header.sample_size_bytes,
+                    "Invalid sample size of the packed file ", data_files[0].name);
+    file_sample_size_bytes_ = header.sample_size_bytes;
+    data_files[0].header_size_bytes = kPackedHeaderBytes;
+    is_dense_float_ = true;
+    HCTR_LOG(INFO, ROOT, "Reading packed samples of %zu bytes (%zu bytes unpacked)\n",
+             file_sample_size_bytes_, sample_size_items_ * sizeof(InputType));
+  }
 
-  reader_impl_.reset(new DataReaderImpl(data_files, resource_manager, batch_size,
-                                        num_threads_per_file, num_batches_per_thread, shuffle,
-                                        schedule_uploads));
+  // Variable-length files are read from the index of their samples. The keys of a feature are
+  // concatenated, so hotness is the max per sample.
+  VariableFileHeader variable_header;
+  variable_ = !synthetic_ && read_variable_header(data_files[0].name, variable_header);
+  if (variable_) {
+    HCTR_CHECK_HINT(variable_header.label_dim == label_dim &&
+                        variable_header.dense_dim == dense_dim &&
+                        variable_header.num_features == nnz_per_slot_.size() &&
+                        variable_header.key_bytes == sizeof(SparseType),
+                    "The dimensions of the variable-length file ", data_files[0].name,
+                    " do not match the data reader params");
+    for (size_t fea_id = 0; fea_id < nnz_per_slot_.size(); ++fea_id) {
+      const int max_hotness = static_cast<int>(variable_header.max_hotness[fea_id]);
+      HCTR_CHECK_HINT(max_hotness <= nnz_per_slot_[fea_id], "Feature ", fea_id, " of ",
+                      data_files[0].name, " has up to ", max_hotness,
+                      " keys, more than its hotness ", nnz_per_slot_[fea_id]);
+    }
+    sample_offsets_ = read_variable_index(data_files[0].name, variable_header);
+    HCTR_CHECK_HINT(sample_offsets_ != nullptr, "Cannot read the sample index of ",
+                    data_files[0].name);
+    size_t max_sample_size_bytes = 0;
+    for (size_t i = 0; i < variable_header.num_samples; ++i) {
+      const size_t sample_size_bytes = (*sample_offsets_)[i + 1] - (*sample_offsets_)[i];
+      HCTR_CHECK_HINT(sample_size_bytes % sizeof(InputType) == 0, "Invalid size of sample ", i,
+                      " of ", data_files[0].name);
+      max_sample_size_bytes = std::max(max_sample_size_bytes, sample_size_bytes);
+    }
+    file_sample_size_bytes_ = max_sample_size_bytes;
+    data_files[0].header_size_bytes = kVariableHeaderBytes;
+    data_files[0].sample_offsets = sample_offsets_;
+    HCTR_LOG(INFO, ROOT, "Reading %zu variable-length samples of %.1f bytes on average\n",
+             static_cast<size_t>(variable_header.num_samples),
+             static_cast<double>(sample_offsets_->back() - sample_offsets_->front()) /
+                 std::max<uint64_t>(variable_header.num_samples, 1));
+  }
+
+  // Batches of a token budget hold consecutive samples up to the budget, and are read like the
+  // incomplete last batch of a file.
+  if (token_budget.enabled()) {
+    HCTR_CHECK_HINT(variable_, "A token budget requires variable-length files");
+    HCTR_CHECK_HINT(!token_budget.slots.empty(), "A token budget requires the slots it counts");
+    for (const int fea_id : token_budget.slots) {
+      HCTR_CHECK_HINT(fea_id >= 0 && fea_id < static_cast<int>(nnz_per_slot_.size()),
+                      "Invalid slot of the token budget: ", fea_id);
+    }
+    auto num_keys = read_variable_num_keys(data_files[0].name, variable_header, *sample_offsets_,
+                                           token_budget.slots);
+    HCTR_CHECK_HINT(num_keys != nullptr, "Cannot read the samples of ", data_files[0].name);
+    data_files[0].batch_first_samples =
+        get_token_budget_batches(*num_keys, batch_size, token_budget.max_tokens);
+    const size_t num_batches = data_files[0].batch_first_samples->size() - 1;
+    HCTR_LOG(INFO, ROOT, "Reading %zu batches of %.1f samples on average, with %llu tokens\n",
+             num_batches,
+             static_cast<double>(num_keys->size()) / std::max<size_t>(num_batches, 1),
+             static_cast<unsigned long long>(token_budget.max_tokens));
+  }
+  if (!synthetic_) {
+    data_files[0].sample_size_bytes = file_sample_size_bytes_;
+    reader_impl_.reset(new DataReaderImpl(data_files, resource_manager, batch_size,
+                                          num_threads_per_file, num_batches_per_thread, shuffle,
+                                          schedule_uploads, io_backend, shuffle_window,
+                                          start_position));
+  }
 
   for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
     auto local_gpu = resource_manager_->get_local_gpu(i);
@@ -122,6 +250,69 @@ AsyncDataReader<SparseType>::AsyncDataReader(
     bucket_position_tensors_.emplace_back(bucket_position_tensor);
     max_hotness_tensors_.emplace_back(max_hotness_tensor);
 
+    if (packed_ || synthetic_) {
+      core23::Tensor unpacked_tensor(
+          core23::TensorParams()
+              .shape({static_cast<int64_t>(batch_size_per_dev_),
+                      static_cast<int64_t>(sample_size_items_)})
+              .data_type(core23::ToScalarType<InputType>::value)
+              .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+      unpacked_tensors_.emplace_back(unpacked_tensor);
+    }
+
+    if (synthetic_) {
+      core23::Tensor key_vocabulary_size_tensor(
+          core23::TensorParams()
+              .shape({static_cast<int64_t>(total_nnz_)})
+              .data_type(core23::ScalarType::Int64)
+              .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+      core23::Tensor key_alpha_tensor(
+          core23::TensorParams()
+              .shape({static_cast<int64_t>(total_nnz_)})
+              .data_type(core23::ScalarType::Float)
+              .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+      HCTR_LIB_THROW(cudaMemcpy(key_vocabulary_size_tensor.data(), key_vocabulary_sizes.data(),
+                                total_nnz_ * sizeof(long long), cudaMemcpyHostToDevice));
+      HCTR_LIB_THROW(cudaMemcpy(key_alpha_tensor.data(), key_alphas.data(),
+                                total_nnz_ * sizeof(float), cudaMemcpyHostToDevice));
+      key_vocabulary_size_tensors_.emplace_back(key_vocabulary_size_tensor);
+      key_alpha_tensors_.emplace_back(key_alpha_tensor);
+    }
+
+    if (packed_) {
+      core23::Tensor item_bit_offset_tensor(
+          core23::TensorParams()
+              .shape({static_cast<int64_t>(item_bit_offsets.size())})
+              .data_type(core23::ScalarType::UInt32)
+              .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+      core23::Tensor key_bits_tensor(
+          core23::TensorParams()
+              .shape({static_cast<int64_t>(key_bits.size())})
+              .data_type(core23::ScalarType::Int32)
+              .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+      HCTR_LIB_THROW(cudaMemcpy(item_bit_offset_tensor.data(), item_bit_offsets.data(),
+                                item_bit_offsets.size() * sizeof(uint32_t),
+                                cudaMemcpyHostToDevice));
+      HCTR_LIB_THROW(cudaMemcpy(key_bits_tensor.data(), key_bits.data(),
+                                key_bits.size() * sizeof(int), cudaMemcpyHostToDevice));
+      item_bit_offset_tensors_.emplace_back(item_bit_offset_tensor);
+      key_bits_tensors_.emplace_back(key_bits_tensor);
+    }
+
+    if (variable_) {
+      core23::Tensor sample_offset_tensor(
+          core23::TensorParams()
+              .shape({static_cast<int64_t>(batch_size_per_dev_ + 1)})
+              .data_type(core23::ScalarType::UInt32)
+              .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+      sample_offset_tensors_.emplace_back(sample_offset_tensor);
+      h_sample_offsets_.emplace_back(core23::PinnedHostArena::instance().acquire(
+          "data_reader", (batch_size_per_dev_ + 1) * sizeof(uint32_t)));
+      cudaEvent_t sample_offsets_event;
+      HCTR_LIB_THROW(cudaEventCreateWithFlags(&sample_offsets_event, cudaEventDisableTiming));
+      sample_offsets_events_.push_back(sample_offsets_event);
+    }
+
     // set default stream
     s3w_streams_[i] = local_gpu->get_stream();
     d2d_streams_[i] = local_gpu->get_stream();
@@ -241,6 +432,25 @@ void AsyncDataReader<SparseType>::init_batch_tensors(size_t num_inflight) {
         *device_sparse_tensors[fea_id].get_nnz_ptr() = batch_size_per_dev_ * hotness;
       }
 
+      // The split of variable-length samples writes the row offsets of each feature.
+      if (variable_) {
+        core23::Tensor temp_sparse_row_offset_ptrs(
+            core23::TensorParams()
+                .shape({static_cast<int64_t>(sparse_dim_), 1ll})
+                .data_type(core23::ScalarType::UInt64)
+                .device({core23::DeviceType::GPU, static_cast<int8_t>(gpu_id)}));
+        std::vector<core23::Tensor> row_offsets;
+        for (size_t fea_id = 0; fea_id < sparse_dim_; ++fea_id) {
+          auto row_offset_ptr = device_sparse_tensors[fea_id].get_rowoffset_ptr();
+          HCTR_LIB_THROW(cudaMemcpy(
+              reinterpret_cast<SparseType**>(temp_sparse_row_offset_ptrs.data()) + fea_id,
+              &row_offset_ptr, sizeof(SparseType*), cudaMemcpyHostToDevice));
+          row_offsets.push_back(device_sparse_tensors[fea_id].get_rowoffset_tensor());
+        }
+        batch_tensors.sparse_row_offset_ptrs.emplace_back(temp_sparse_row_offset_ptrs);
+        batch_tensors.row_offsets.emplace_back(row_offsets);
+      }
+
       batch_tensors.sparse_tensors.emplace_back(device_sparse_tensors);
       batch_tensors.sparse_tensor_ptrs.emplace_back(temp_sparse_tensor_ptrs);
       batch_tensors.sparse_values.emplace_back(device_values_tensors);
@@ -249,27 +459,37 @@ void AsyncDataReader<SparseType>::init_batch_tensors(size_t num_inflight) {
   // Needed for get_value_tensors() on construction
   // current_sparse_tensors_ = inflight_batch_tensors_.at(0).sparse_tensors;
   current_sparse_values_ = inflight_batch_tensors_.at(0).sparse_values;
+  if (variable_) {
+    current_dp_bucket_ranges_ = inflight_batch_tensors_.at(0).row_offsets;
+  }
 }
 
 template <typename SparseType>
 long long AsyncDataReader<SparseType>::read_a_batch_to_device_delay_release() {
-  const DataReaderImpl::Batch& batch = reader_impl_->get_batch();
+  // Synthetic batches are always complete, and are not read by the reader_impl_.
+  const DataReaderImpl::Batch* batch = synthetic_ ? nullptr : &reader_impl_->get_batch();
+  const size_t current_batch_id =
+      synthetic_ ? synthetic_batch_id_++ : static_cast<size_t>(batch->get_id());
 
   const size_t slot_id = 0;  // TODO: multi-hot
 
   if (cache_buffers_) {
     // TODO: replace with cache policy like LRU when number of batches exceeds what we can store
-    inflight_id_ = batch.get_id();
+    inflight_id_ = current_batch_id;
   } else {
     inflight_id_ = (inflight_id_ + 1) % inflight_batch_tensors_.size();  // FIFO
   }
 
   BatchTensors& batch_tensors = inflight_batch_tensors_.at(inflight_id_);
 
-  size_t current_batch_id = static_cast<size_t>(batch.get_id());
-  current_batch_size_ = batch.get_batch_size_bytes() / (sample_size_items_ * sizeof(InputType));
+  current_batch_size_ = synthetic_ ? batch_size_
+                        : variable_ ? batch->get_batch_samples()
+                                    : batch->get_batch_size_bytes() / file_sample_size_bytes_;
   // current_sparse_tensors_ = batch_tensors.sparse_tensors;
   current_sparse_values_ = batch_tensors.sparse_values;
+  if (variable_) {
+    current_dp_bucket_ranges_ = batch_tensors.row_offsets;
+  }
   current_batch_cached_ = (current_batch_id == batch_tensors.tag) && cache_buffers_;
 
   int num_local_gpus = resource_manager_->get_local_gpu_count();
@@ -282,17 +502,46 @@ long long AsyncDataReader<SparseType>::read_a_batch_to_device_delay_release() {
     const cudaStream_t& stream = s3w_streams_[i];
 
     size_t current_batch_size_per_device =
-        batch.get_local_batch_size_bytes(i, slot_id) / (sample_size_items_ * sizeof(InputType));
+        synthetic_  ? batch_size_per_dev_
+        : variable_ ? batch->get_local_batch_samples(i)
+                    : batch->get_local_batch_size_bytes(i, slot_id) / file_sample_size_bytes_;
 
     // schedule at correct place in iteration
     HCTR_LIB_THROW(cudaStreamWaitEvent(stream, split_schedule_events_[i]));
 
     if (!current_batch_cached_) {  // data can be cached for eval
 
-      // >0 check because when batch is incomplete not all devices may have data-parallel shard
-      if (static_cast<int64_t>(current_batch_size_per_device) > 0) {
-        auto ptr_wrap = std::make_shared<RawPtrWrapper>(
-            reinterpret_cast<InputType*>(batch.get_device_data(i, slot_id)));
+      if (variable_) {
+        // Split on all devices, to pad the row offsets of the shards without samples.
+        split_variable_batch(*batch, i, batch_tensors, stream);
+      } else if (static_cast<int64_t>(current_batch_size_per_device) > 0) {
+        // >0 check because when batch is incomplete not all devices may have data-parallel shard
+        InputType* samples = nullptr;
+        if (synthetic_) {
+          const size_t global_gpu_id = resource_manager_->get_gpu_global_id_from_local_id(i);
+          const uint64_t first_sample =
+              current_batch_id * batch_size_ + global_gpu_id * batch_size_per_dev_;
+          generate_synthetic_samples<SparseType>(
+              unpacked_tensors_[i].data<InputType>(),
+              static_cast<int64_t>(current_batch_size_per_device), static_cast<int>(label_dim_),
+              static_cast<int>(dense_dim_), static_cast<int>(total_nnz_),
+              key_vocabulary_size_tensors_[i].data<long long>(),
+              key_alpha_tensors_[i].data<float>(), synthetic_seed_, first_sample, stream);
+          samples = unpacked_tensors_[i].data<InputType>();
+        } else {
+          samples = reinterpret_cast<InputType*>(batch->get_device_data(i, slot_id));
+        }
+        if (packed_) {
+          unpack_samples<SparseType>(
+              unpacked_tensors_[i].data<InputType>(), reinterpret_cast<const uint32_t*>(samples),
+              static_cast<int64_t>(current_batch_size_per_device),
+              static_cast<int>(file_sample_size_bytes_ / sizeof(uint32_t)),
+              static_cast<int>(label_dim_), static_cast<int>(dense_dim_),
+              static_cast<int>(total_nnz_), item_bit_offset_tensors_[i].data<uint32_t>(),
+              key_bits_tensors_[i].data<int>(), stream);
+          samples = unpacked_tensors_[i].data<InputType>();
+        }
+        auto ptr_wrap = std::make_shared<RawPtrWrapper>(samples);
 
         if (mixed_precision_) {
           split_3_way_feat_major<__half, SparseType>(
@@ -342,13 +591,55 @@ long long AsyncDataReader<SparseType>::read_a_batch_to_device_delay_release() {
 
     // batch.device_data can be reused. Needs to be called after D2D because cudaStreamAddCallback
     // has latency and will delay execution of D2D.
-    reader_impl_->device_release_last_batch_here(d2d_stream, i);
+    if (!synthetic_) {
+      reader_impl_->device_release_last_batch_here(d2d_stream, i);
+    }
   }
 
   batch_tensors.tag = current_batch_id;
   return current_batch_size_;
 }
 
+template <typename SparseType>
+void AsyncDataReader<SparseType>::split_variable_batch(const DataReaderImpl::Batch& batch,
+                                                       int raw_device_id,
+                                                       BatchTensors& batch_tensors,
+                                                       cudaStream_t stream) {
+  const size_t first_sample = batch.get_local_first_sample(raw_device_id);
+  const size_t num_samples = batch.get_local_batch_samples(raw_device_id);
+  const auto& offsets = *sample_offsets_;
+
+  // Word offsets of the samples in the local batch. The previous upload must be complete before
+  // its staging buffer is overwritten.
+  auto h_sample_offsets = static_cast<uint32_t*>(h_sample_offsets_[raw_device_id].data());
+  HCTR_LIB_THROW(cudaEventSynchronize(sample_offsets_events_[raw_device_id]));
+  for (size_t i = 0; i <= num_samples; ++i) {
+    const uint64_t offset_bytes = offsets[first_sample + i] - offsets[first_sample];
+    h_sample_offsets[i] = static_cast<uint32_t>(offset_bytes / sizeof(InputType));
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(sample_offset_tensors_[raw_device_id].data(), h_sample_offsets,
+                                 (num_samples + 1) * sizeof(uint32_t), cudaMemcpyHostToDevice,
+                                 stream));
+  HCTR_LIB_THROW(cudaEventRecord(sample_offsets_events_[raw_device_id], stream));
+
+  const int* samples = reinterpret_cast<const int*>(batch.get_device_data(raw_device_id, 0));
+  auto split = [&](auto* dense) {
+    split_variable_samples(
+        samples, sample_offset_tensors_[raw_device_id].data<uint32_t>(),
+        static_cast<int>(num_samples), static_cast<int>(batch_size_per_dev_),
+        batch_tensors.label_tensors[raw_device_id].data<LabelType>(), static_cast<int>(label_dim_),
+        dense, static_cast<int>(dense_dim_),
+        reinterpret_cast<SparseType**>(batch_tensors.sparse_tensor_ptrs[raw_device_id].data()),
+        reinterpret_cast<SparseType**>(batch_tensors.sparse_row_offset_ptrs[raw_device_id].data()),
+        static_cast<int>(sparse_dim_), is_dense_float_, stream);
+  };
+  if (mixed_precision_) {
+    split(batch_tensors.dense_tensors[raw_device_id].data<__half>());
+  } else {
+    split(batch_tensors.dense_tensors[raw_device_id].data<float>());
+  }
+}
+
 template <typename SparseType>
 void AsyncDataReader<SparseType>::set_schedule_streams(cudaStream_t s3w_stream,
                                                        cudaStream_t d2d_stream, int raw_device_id) {
@@ -433,22 +724,41 @@ void AsyncDataReader<SparseType>::schedule_d2d_here(cudaStream_t stream, int raw
 
 template <typename SparseType>
 void AsyncDataReader<SparseType>::schedule_here(cudaStream_t stream, int raw_device_id) {
-  reader_impl_->schedule_upload_here(raw_device_id, stream, false);
+  if (reader_impl_) {
+    reader_impl_->schedule_upload_here(raw_device_id, stream, false);
+  }
 }
 
 template <typename SparseType>
 void AsyncDataReader<SparseType>::schedule_here_graph(cudaStream_t stream, int raw_device_id) {
-  reader_impl_->schedule_upload_here(raw_device_id, stream, true);
+  if (reader_impl_) {
+    reader_impl_->schedule_upload_here(raw_device_id, stream, true);
+  }
 }
 
 template <typename SparseType>
 void AsyncDataReader<SparseType>::update_schedule_graph(int raw_device_id) {
-  reader_impl_->upload_notify(raw_device_id);
+  if (reader_impl_) {
+    reader_impl_->upload_notify(raw_device_id);
+  }
 }
 
 template <typename SparseType>
 size_t AsyncDataReader<SparseType>::get_max_batches_inflight() const {
-  return reader_impl_->get_total_inflight_batches();
+  return reader_impl_ ? reader_impl_->get_total_inflight_batches() : 1;
+}
+
+template <typename SparseType>
+ReaderState AsyncDataReader<SparseType>::get_state(size_t num_prefetched) const {
+  if (synthetic_) {
+    HCTR_OWN_THROW(Error_t::IllegalCall, "Synthetic data readers have no state to save");
+  }
+  ReaderState state;
+  state.position = reader_impl_->get_position(num_prefetched);
+  state.batch_size = batch_size_;
+  state.num_batches = reader_impl_->get_num_batches();
+  state.shuffle = shuffle_;
+  return state;
 }
 
 template <typename SparseType>
@@ -490,7 +800,9 @@ bool AsyncDataReader<SparseType>::is_started() const {
 }
 template <typename SparseType>
 void AsyncDataReader<SparseType>::start() {
-  reader_impl_->start();
+  if (reader_impl_) {
+    reader_impl_->start();
+  }
 }
 template <typename SparseType>
 std::vector<core23::Tensor> AsyncDataReader<SparseType>::get_dense_tensor23s() const {
@@ -512,6 +824,11 @@ std::vector<std::vector<core23::Tensor>>& AsyncDataReader<SparseType>::get_curre
   return current_sparse_values_;
 }
 template <typename SparseType>
+std::vector<std::vector<core23::Tensor>>&
+AsyncDataReader<SparseType>::get_current_dp_bucket_ranges() {
+  return current_dp_bucket_ranges_;
+}
+template <typename SparseType>
 std::vector<std::vector<SparseTensor<SparseType>>>
 AsyncDataReader<SparseType>::get_value_tensor_buffers() const {
   throw std::runtime_error("Deprecated");
@@ -547,6 +864,9 @@ AsyncDataReader<SparseType>::~AsyncDataReader() {
   for (auto& e : schedule_events_) {
     cudaEventDestroy(e);
   }
+  for (auto& e : sample_offsets_events_) {
+    cudaEventDestroy(e);
+  }
 }
 
 };  // namespace core23_reader
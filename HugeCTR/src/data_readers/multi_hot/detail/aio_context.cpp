@@ -53,7 +53,11 @@ void AIOContext::submit(const IORequest& request) {
   size_t aligned_offset = (request.offset / get_alignment()) * get_alignment();
   size_t size = round_up(request.size + (request.offset - aligned_offset), get_alignment());
 
-  io_prep_pread(cb, request.fd, request.data, size, aligned_offset);
+  if (request.write) {
+    io_prep_pwrite(cb, request.fd, request.data, size, aligned_offset);
+  } else {
+    io_prep_pread(cb, request.fd, request.data, size, aligned_offset);
+  }
   cb->data = request.user_data;
 
   iocb* cblist[] = {cb};
@@ -15,33 +15,40 @@
  */
 
 #include <fcntl.h>
-#include <numa.h>
 #include <unistd.h>
 
 #include <common.hpp>
-#include <data_readers/multi_hot/detail/aio_context.hpp>
 #include <data_readers/multi_hot/detail/batch_file_reader.hpp>
 
 namespace HugeCTR {
 
 BatchFileReader::BatchFileReader(const std::string& fname, size_t slot, size_t max_batches_inflight,
-                                 std::unique_ptr<IBatchLocations> batch_locations)
+                                 std::unique_ptr<IBatchLocations> batch_locations,
+                                 IOBackend_t io_backend, size_t first_batch)
     : slot_id_(slot)
       // having multiple IOs in-flight to the same location will break data reader
       ,
       max_batches_inflight_(std::min(max_batches_inflight, batch_locations->count())),
       free_batches_(max_batches_inflight_),
       batch_locations_(std::move(batch_locations)),
-      batch_locations_iterator_(batch_locations_->begin()),
-      io_ctx_(new AIOContext(max_batches_inflight_)),
-      buf_size_(batch_locations_->get_batch_size_bytes() + io_ctx_->get_alignment()) {
+      batch_locations_iterator_(batch_locations_->begin_at(first_batch)),
+      io_ctx_(create_io_context(io_backend, max_batches_inflight_)),
+      // Room for the misaligned start and the aligned end of the reads
+      buf_size_(batch_locations_->get_batch_size_bytes() + 2 * io_ctx_->get_alignment()) {
   tmp_completed_batches_.reserve(max_batches_inflight_);
   empty_batches_.reserve(max_batches_inflight_);
 
   for (size_t i = 0; i < max_batches_inflight_; ++i) {
-    uint8_t* data = (uint8_t*)numa_alloc_local(
-        buf_size_);  // aligned_alloc(io_ctx_->get_alignment(), buf_size);
-    HCTR_LIB_THROW(cudaHostRegister(data, buf_size_, 0));
+    uint8_t* data = nullptr;
+    if (io_ctx_->reads_to_device()) {
+      // The device transfer of the batches becomes a device to device copy.
+      HCTR_LIB_THROW(cudaMalloc(&data, buf_size_));
+    } else {
+      // Page-aligned on the NUMA node of this thread, and pinned once for all readers.
+      host_buffers_.push_back(
+          core23::PinnedHostArena::instance().acquire("data_reader", buf_size_));
+      data = static_cast<uint8_t*>(host_buffers_.back().data());
+    }
 
     batches_.emplace_back(this, data, slot);
   }
@@ -54,18 +61,27 @@ BatchFileReader::BatchFileReader(const std::string& fname, size_t slot, size_t m
   if (fd_ == -1) {
     throw std::runtime_error("No such file: " + fname);
   };
+
+  std::vector<IOBuffer> buffers;
+  for (auto& batch : batches_) {
+    buffers.push_back({batch.aligned_data, buf_size_});
+  }
+  io_ctx_->register_files({fd_});
+  io_ctx_->register_buffers(buffers);
 }
 
 BatchFileReader::~BatchFileReader() {
   // Call destructor on IO context to wait for in-flight IOs to complete first before we
   // free our buffers
+  const bool device_buffers = io_ctx_->reads_to_device();
   io_ctx_.reset();
 
-  for (auto& batch : batches_) {
-    cudaHostUnregister(batch.aligned_data);
-    numa_free(batch.aligned_data, buf_size_);
-    // free(batch.aligned_data);
+  if (device_buffers) {
+    for (auto& batch : batches_) {
+      cudaFree(batch.aligned_data);
+    }
   }
+  host_buffers_.clear();
   close(fd_);
 }
 
@@ -100,6 +116,9 @@ void BatchFileReader::submit_reads() {
 
       batch->shard_size_bytes = descriptor.shard_size_bytes;
       batch->batch_size_bytes = descriptor.batch_size_bytes;
+      batch->first_sample = descriptor.first_sample;
+      batch->shard_samples = descriptor.shard_samples;
+      batch->batch_samples = descriptor.batch_samples;
       batch->batch_id = descriptor.id;
       batch->batch_i = descriptor.i;
       batch->start_time = 0.f;
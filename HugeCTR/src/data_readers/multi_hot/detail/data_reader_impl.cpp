@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <data_readers/multi_hot/detail/data_reader_impl.hpp>
+#include <data_readers/multi_hot/detail/shuffle_samples.hpp>
 #include <filesystem>
+#include <numeric>
 #include <set>
 
 namespace HugeCTR {
@@ -25,11 +28,21 @@ namespace MultiHot {
 DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
                                const std::shared_ptr<ResourceManager>& resource_manager,
                                size_t batch_size, size_t num_reader_threads_per_device,
-                               size_t num_batches_per_thread, bool shuffle, bool schedule_uploads)
-    : resource_manager_(resource_manager), schedule_uploads_(schedule_uploads) {
+                               size_t num_batches_per_thread, bool shuffle, bool schedule_uploads,
+                               IOBackend_t io_backend, size_t shuffle_window,
+                               const ReaderPosition& start_position)
+    : resource_manager_(resource_manager),
+      epoch_(start_position.epoch),
+      start_batch_(start_position.batch),
+      seed_(start_position.seed.value_or(
+          resource_manager->get_local_cpu()->get_replica_uniform_seed())),
+      schedule_uploads_(schedule_uploads),
+      shuffle_window_(std::max(shuffle_window, 1ul)) {
   const size_t local_gpu_count = resource_manager->get_local_gpu_count();
   const size_t global_gpu_count = resource_manager->get_global_gpu_count();
   const size_t num_slots = source_files.size();
+  std::vector<size_t> local_batch_size_bytes_per_slot;
+  batch_i_ = start_batch_;
 
   for (auto source : source_files) {
     if (batch_size % global_gpu_count) {
@@ -42,12 +55,22 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
     } else if (num_batches_ != locations->count()) {
       throw std::invalid_argument("files do not contain the same number of batches");
     }
+    if (start_batch_ >= num_batches_) {
+      throw std::invalid_argument("start batch " + std::to_string(start_batch_) +
+                                  " exceeds the number of batches of " + source.name);
+    }
 
     // TODO: refactor this for dynamic pooling
     const size_t local_batch_size_bytes =
         (batch_size / global_gpu_count) * source.sample_size_bytes;
 
     auto device_locations = locations->shard(global_gpu_count, local_batch_size_bytes);
+    size_t max_local_batch_size_bytes = 0;
+    for (const auto& device_location : device_locations) {
+      max_local_batch_size_bytes =
+          std::max(max_local_batch_size_bytes, device_location->get_max_shard_size_bytes());
+    }
+    local_batch_size_bytes_per_slot.push_back(max_local_batch_size_bytes);
 
     for (size_t i = 0; i < local_gpu_count; ++i) {
       // move thread to correct numa
@@ -59,8 +82,9 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
           device_locations[global_gpu_id]->distribute(num_reader_threads_per_device);
 
       for (size_t thread = 0; thread < thread_locations.size(); ++thread) {
-        auto reader = new BatchFileReader(source.name, source.slot_id, num_batches_per_thread,
-                                          std::move(thread_locations[thread]));
+        auto reader =
+            new BatchFileReader(source.name, source.slot_id, num_batches_per_thread,
+                                std::move(thread_locations[thread]), io_backend, start_batch_);
         file_readers_[i].emplace_back(reader);
       }
     }
@@ -71,6 +95,28 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
 
   // Init batches
   batch_buffers_.resize(num_inflight_batches);
+
+  if (shuffle_window_ > 1) {
+    // All batches of a group must be in flight at the same time.
+    if (shuffle_window_ > num_inflight_batches) {
+      throw std::invalid_argument(
+          "shuffle window exceeds the number of in-flight batches (num_threads * "
+          "num_batches_per_thread)");
+    }
+    // Uploads of a group are not consumed before the last one, so they cannot wait for credits.
+    if (schedule_uploads) {
+      throw std::invalid_argument("shuffle window cannot be used with scheduled uploads");
+    }
+    for (auto source : source_files) {
+      if (source.sample_offsets) {
+        throw std::invalid_argument("shuffle window cannot be used with variable-size samples");
+      }
+      if (source.sample_size_bytes % sizeof(uint32_t)) {
+        throw std::invalid_argument("sample size must be a multiple of 4 bytes to shuffle samples");
+      }
+      sample_size_bytes_.push_back(source.sample_size_bytes);
+    }
+  }
   for (size_t i = 0; i < batch_buffers_.size(); ++i) {
     auto batch = std::make_unique<Batch>();
 
@@ -91,9 +137,8 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
       local_batch.num_transfers = 0;
 
       // Allocate buffer for each slot
-      for (auto source : source_files) {
+      for (size_t local_batch_size_bytes : local_batch_size_bytes_per_slot) {
         uint8_t* ptr = nullptr;
-        size_t local_batch_size_bytes = (batch_size / global_gpu_count) * source.sample_size_bytes;
         HCTR_LIB_THROW(cudaMalloc(&ptr, local_batch_size_bytes));
         HCTR_LIB_THROW(cudaMemset(ptr, 0, local_batch_size_bytes));
         local_batch.device_data.push_back(ptr);
@@ -105,6 +150,29 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
     batch_buffers_[i] = std::move(batch);
   }
 
+  if (shuffle_window_ > 1) {
+    const size_t max_group_samples = shuffle_window_ * (batch_size / global_gpu_count);
+    for (size_t i = 0; i < local_gpu_count; ++i) {
+      CudaDeviceContext ctx(resource_manager->get_local_gpu(i)->get_device_id());
+      ShuffleBuffers buffers;
+      for (size_t sample_size_bytes : sample_size_bytes_) {
+        uint8_t* ptr = nullptr;
+        HCTR_LIB_THROW(cudaMalloc(&ptr, max_group_samples * sample_size_bytes));
+        buffers.samples.push_back(ptr);
+      }
+      HCTR_LIB_THROW(cudaMalloc(&buffers.perm, max_group_samples * sizeof(uint32_t)));
+      HCTR_LIB_THROW(cudaMalloc(&buffers.srcs, num_slots * shuffle_window_ * sizeof(uint32_t*)));
+      HCTR_LIB_THROW(cudaMalloc(&buffers.offsets, (shuffle_window_ + 1) * sizeof(uint32_t)));
+      HCTR_LIB_THROW(cudaMallocHost(&buffers.h_perm, max_group_samples * sizeof(uint32_t)));
+      HCTR_LIB_THROW(
+          cudaMallocHost(&buffers.h_srcs, num_slots * shuffle_window_ * sizeof(uint32_t*)));
+      HCTR_LIB_THROW(cudaMallocHost(&buffers.h_offsets, (shuffle_window_ + 1) * sizeof(uint32_t)));
+      buffers.gen.seed(resource_manager->get_local_cpu()->get_replica_uniform_seed() +
+                       resource_manager->get_local_gpu(i)->get_global_id());
+      shuffle_buffers_.push_back(std::move(buffers));
+    }
+  }
+
   pending_transfers_.resize(resource_manager->get_local_gpu_count());
 
   for (size_t i = 0; i < resource_manager->get_local_gpu_count(); ++i) {
@@ -144,17 +212,34 @@ DataReaderImpl::~DataReaderImpl() {
   //  HCTR_LOG(DEBUG, WORLD, "DataReaderImpl Batch Latency, min: %.4f, avg: %.4f, max: %.4f\n",
   //           io_stats.batch_min_latency, io_stats.batch_avg_latency, io_stats.batch_max_latency);
   // TODO: free GPU mem
+  for (size_t i = 0; i < shuffle_buffers_.size(); ++i) {
+    CudaDeviceContext ctx(resource_manager_->get_local_gpu(i)->get_device_id());
+    auto& buffers = shuffle_buffers_[i];
+    for (auto ptr : buffers.samples) {
+      cudaFree(ptr);
+    }
+    cudaFree(buffers.perm);
+    cudaFree(buffers.srcs);
+    cudaFree(buffers.offsets);
+    cudaFreeHost(buffers.h_perm);
+    cudaFreeHost(buffers.h_srcs);
+    cudaFreeHost(buffers.h_offsets);
+  }
 }
 
 std::unique_ptr<IBatchLocations> DataReaderImpl::configure_locations(FileSource source,
                                                                      size_t batch_size,
                                                                      bool shuffle) const {
+  if (source.sample_offsets) {
+    return std::make_unique<IndexedBatchLocations>(source.sample_offsets, batch_size, shuffle,
+                                                   seed_, source.batch_first_samples);
+  }
+
   const size_t file_size = std::filesystem::file_size(source.name);
-  assert(file_size > 0);
+  assert(file_size > source.header_size_bytes);
 
   auto locations = std::make_unique<BatchLocations>(
-      batch_size * source.sample_size_bytes, 0, file_size, shuffle,
-      resource_manager_->get_local_cpu()->get_replica_uniform_seed());
+      batch_size * source.sample_size_bytes, source.header_size_bytes, file_size, shuffle, seed_);
   return locations;
 }
 
@@ -175,7 +260,7 @@ void DataReaderImpl::start() {
 #endif
 
   // Make sure first batch is ready to consume
-  while (batch_buffers_[0]->state != BatchState::READY_TO_CONSUME) {
+  while (batch_buffers_[batch_i_ % batch_buffers_.size()]->state != BatchState::READY_TO_CONSUME) {
     // spin
   }
 }
@@ -196,6 +281,9 @@ const DataReaderImpl::Batch& DataReaderImpl::get_batch() {
   compute_batch_stats(batch);
 
   batch_i_ = (batch_i_ + 1) % num_batches_;
+  if (batch_i_ == 0) {
+    epoch_++;
+  }
 
   last_batch_ = batch;
   return *last_batch_;
@@ -226,6 +314,18 @@ void DataReaderImpl::upload_notify(int raw_device_id) {
 
 size_t DataReaderImpl::get_total_inflight_batches() const { return batch_buffers_.size(); }
 
+ReaderPosition DataReaderImpl::get_position(size_t num_prefetched) const {
+  ReaderPosition position{epoch_, batch_i_, seed_};
+  for (size_t i = 0; i < num_prefetched && (position.epoch > 0 || position.batch > 0); ++i) {
+    if (position.batch == 0) {
+      position.epoch--;
+      position.batch = num_batches_;
+    }
+    position.batch--;
+  }
+  return position;
+}
+
 // QUEUE_SIZE (num_inflight_batches): 4
 
 // BATCH_IDS READER A (numa 0):   0 1 2 3 4 0 1 2 3 4
@@ -301,7 +401,8 @@ void DataReaderImpl::upload_batches(size_t device_id) {
 
   cudaStream_t& stream = placement_streams_[device_id];
 
-  size_t batch_i = 0;
+  size_t batch_i = start_batch_;
+  std::vector<Batch*> group;
 
   while (running_) {
     // Process uploads in order
@@ -337,13 +438,26 @@ void DataReaderImpl::upload_batches(size_t device_id) {
       // set num_transfers to 0 to prevent uploading this local batch again.
       local_batch.num_transfers = 0;
 
+      // Groups end with the epoch, so that the incomplete batch keeps its size.
+      group.push_back(batch);
+      if (group.size() < shuffle_window_ && batch_i + 1 < num_batches_) {
+        batch_i = (batch_i + 1) % num_batches_;
+        continue;
+      }
+      if (group.size() > 1) {
+        shuffle_samples(device_id, group, stream);
+      }
+
       // necessary for decrement of num_completed_uploads because it is checked on the host
       HCTR_LIB_THROW(cudaStreamSynchronize(stream));
 
       // all devices have uploaded their local batch, main thread can now consume
-      if (++batch->num_completed_uploads == batch->local_batches.size()) {
-        batch->state.store(BatchState::READY_TO_CONSUME, std::memory_order_release);
+      for (Batch* uploaded_batch : group) {
+        if (++uploaded_batch->num_completed_uploads == uploaded_batch->local_batches.size()) {
+          uploaded_batch->state.store(BatchState::READY_TO_CONSUME, std::memory_order_release);
+        }
       }
+      group.clear();
 
       batch_i = (batch_i + 1) % num_batches_;  // move to next batch
     } else {
@@ -354,6 +468,53 @@ void DataReaderImpl::upload_batches(size_t device_id) {
   HCTR_LIB_THROW(cudaStreamDestroy(stream));
 }
 
+// The group is gathered into the shuffle buffer in the order of a random permutation, and copied
+// back into the batches in place of their own samples. Each batch keeps its size.
+void DataReaderImpl::shuffle_samples(size_t device_id, const std::vector<Batch*>& group,
+                                     cudaStream_t stream) {
+  auto& buffers = shuffle_buffers_[device_id];
+  const size_t num_slots = sample_size_bytes_.size();
+  const size_t group_size = group.size();
+
+  uint32_t num_samples = 0;
+  for (size_t k = 0; k < group_size; ++k) {
+    const auto& local_batch = group[k]->local_batches[device_id];
+    buffers.h_offsets[k] = num_samples;
+    num_samples += local_batch.io_batches[0]->shard_size_bytes / sample_size_bytes_[0];
+    for (size_t slot = 0; slot < num_slots; ++slot) {
+      buffers.h_srcs[slot * group_size + k] =
+          reinterpret_cast<const uint32_t*>(local_batch.device_data[slot]);
+    }
+  }
+  buffers.h_offsets[group_size] = num_samples;
+  std::iota(buffers.h_perm, buffers.h_perm + num_samples, 0u);
+  std::shuffle(buffers.h_perm, buffers.h_perm + num_samples, buffers.gen);
+
+  // The host buffers are reused after the stream is synchronized at the end of the group.
+  HCTR_LIB_THROW(cudaMemcpyAsync(buffers.perm, buffers.h_perm, num_samples * sizeof(uint32_t),
+                                 cudaMemcpyHostToDevice, stream));
+  HCTR_LIB_THROW(cudaMemcpyAsync(buffers.srcs, buffers.h_srcs,
+                                 num_slots * group_size * sizeof(uint32_t*),
+                                 cudaMemcpyHostToDevice, stream));
+  HCTR_LIB_THROW(cudaMemcpyAsync(buffers.offsets, buffers.h_offsets,
+                                 (group_size + 1) * sizeof(uint32_t), cudaMemcpyHostToDevice,
+                                 stream));
+
+  for (size_t slot = 0; slot < num_slots; ++slot) {
+    const size_t sample_size_bytes = sample_size_bytes_[slot];
+    gather_samples(reinterpret_cast<uint32_t*>(buffers.samples[slot]),
+                   buffers.srcs + slot * group_size, buffers.offsets, static_cast<int>(group_size),
+                   buffers.perm, num_samples, sample_size_bytes / sizeof(uint32_t), stream);
+    for (size_t k = 0; k < group_size; ++k) {
+      const size_t batch_samples = buffers.h_offsets[k + 1] - buffers.h_offsets[k];
+      HCTR_LIB_THROW(cudaMemcpyAsync(
+          group[k]->local_batches[device_id].device_data[slot],
+          buffers.samples[slot] + buffers.h_offsets[k] * sample_size_bytes,
+          batch_samples * sample_size_bytes, cudaMemcpyDeviceToDevice, stream));
+    }
+  }
+}
+
 void DataReaderImpl::release_batch_callback(cudaStream_t stream, cudaError_t status,
                                             void* user_data) {
   auto batch = reinterpret_cast<Batch*>(user_data);
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef ENABLE_GDS
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <ctime>
+#include <data_readers/multi_hot/detail/gds_context.hpp>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace HugeCTR {
+
+#define round_up(x, y) ((((x) + ((y)-1)) / (y)) * (y))
+
+namespace {
+
+void check_cufile(const CUfileError_t& status, const std::string& what) {
+  if (status.err != CU_FILE_SUCCESS) {
+    throw std::runtime_error(what + " failed: " + CUFILE_ERRSTR(status.err));
+  }
+}
+
+// The driver is shared by all contexts of the process, and closed at exit.
+void open_cufile_driver() {
+  static std::once_flag once;
+  std::call_once(once, [] { check_cufile(cuFileDriverOpen(), "cuFileDriverOpen"); });
+}
+
+}  // namespace
+
+GDSContext::GDSContext(size_t io_depth) : io_depth_(io_depth), tmp_cufile_events_(io_depth) {
+  tmp_events_.reserve(io_depth);
+  unsubmitted_.reserve(io_depth);
+
+  open_cufile_driver();
+  check_cufile(cuFileBatchIOSetUp(&batch_, io_depth), "cuFileBatchIOSetUp");
+}
+
+GDSContext::~GDSContext() {
+  // app can't exit with requests in-flight
+  (void)collect(num_inflight_ + unsubmitted_.size(), 1e6);  // wait 1s
+  assert(num_inflight_ == 0);
+  cuFileBatchIODestroy(batch_);
+
+  for (const auto& buffer : registered_buffers_) {
+    cuFileBufDeregister(buffer.data);
+  }
+  for (const auto& [fd, handle] : file_handles_) {
+    cuFileHandleDeregister(handle);
+  }
+}
+
+void GDSContext::register_files(const std::vector<int>& fds) {
+  for (int fd : fds) {
+    CUfileDescr_t descr;
+    memset(&descr, 0, sizeof(descr));
+    descr.handle.fd = fd;
+    descr.type = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+
+    CUfileHandle_t handle;
+    check_cufile(cuFileHandleRegister(&handle, &descr), "cuFileHandleRegister");
+    file_handles_.emplace(fd, handle);
+  }
+}
+
+void GDSContext::register_buffers(const std::vector<IOBuffer>& buffers) {
+  assert(registered_buffers_.empty() && num_inflight_ == 0);
+  for (const auto& buffer : buffers) {
+    check_cufile(cuFileBufRegister(buffer.data, buffer.size, 0), "cuFileBufRegister");
+    registered_buffers_.push_back(buffer);
+  }
+}
+
+void GDSContext::submit(const IORequest& request) {
+  assert(num_inflight_ + unsubmitted_.size() < io_depth_);
+  const auto it = file_handles_.find(request.fd);
+  if (it == file_handles_.end()) {
+    throw std::runtime_error("GDS reads require a registered file");
+  }
+
+  // For O_DIRECT, offsets and sizes need to be aligned
+  size_t aligned_offset = (request.offset / get_alignment()) * get_alignment();
+  size_t size = round_up(request.size + (request.offset - aligned_offset), get_alignment());
+
+  // Reads into registered buffers are given relative to the registered base pointer.
+  uint8_t* base = request.data;
+  for (const auto& buffer : registered_buffers_) {
+    if (request.data >= buffer.data && request.data + size <= buffer.data + buffer.size) {
+      base = buffer.data;
+      break;
+    }
+  }
+
+  CUfileIOParams_t params;
+  memset(&params, 0, sizeof(params));
+  params.mode = CUFILE_BATCH;
+  params.u.batch.devPtr_base = base;
+  params.u.batch.devPtr_offset = request.data - base;
+  params.u.batch.file_offset = aligned_offset;
+  params.u.batch.size = size;
+  params.fh = it->second;
+  params.opcode = request.write ? CUFILE_WRITE : CUFILE_READ;
+  params.cookie = request.user_data;
+  unsubmitted_.push_back(params);
+}
+
+const std::vector<IOEvent>& GDSContext::collect(size_t min_reqs, size_t timeout_us) {
+  if (!unsubmitted_.empty()) {
+    check_cufile(cuFileBatchIOSubmit(batch_, unsubmitted_.size(), unsubmitted_.data(), 0),
+                 "cuFileBatchIOSubmit");
+    num_inflight_ += unsubmitted_.size();
+    unsubmitted_.clear();
+  }
+
+  tmp_events_.clear();
+  if (num_inflight_ == 0) {
+    return tmp_events_;
+  }
+
+  timespec timeout = {static_cast<time_t>(timeout_us / 1000000),
+                      static_cast<long>(timeout_us % 1000000) * 1000};
+  unsigned num_completed = io_depth_;
+  check_cufile(cuFileBatchIOGetStatus(batch_, std::min(min_reqs, num_inflight_), &num_completed,
+                                      tmp_cufile_events_.data(), &timeout),
+               "cuFileBatchIOGetStatus");
+  num_inflight_ -= num_completed;
+
+  for (unsigned i = 0; i < num_completed; ++i) {
+    const CUfileIOEvents_t& cufile_event = tmp_cufile_events_[i];
+    if (cufile_event.status != CUFILE_COMPLETE) {
+      throw std::runtime_error("cuFileBatchIOGetStatus returned failed event, status: " +
+                               std::to_string(cufile_event.status));
+    }
+
+    IOEvent event;
+    event.error = IOError::IO_SUCCESS;
+    event.user_data = cufile_event.cookie;
+
+    tmp_events_.emplace_back(event);
+  }
+
+  return tmp_events_;
+}
+
+size_t GDSContext::get_alignment() const {
+  return 4096;  // O_DIRECT requirement
+}
+
+}  // namespace HugeCTR
+
+#endif
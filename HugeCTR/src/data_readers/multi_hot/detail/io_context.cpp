@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <data_readers/multi_hot/detail/aio_context.hpp>
+#include <data_readers/multi_hot/detail/io_context.hpp>
+#ifdef ENABLE_GDS
+#include <data_readers/multi_hot/detail/gds_context.hpp>
+#endif
+#ifdef ENABLE_IO_URING
+#include <data_readers/multi_hot/detail/io_uring_context.hpp>
+#endif
+
+namespace HugeCTR {
+
+std::unique_ptr<IOContext> create_io_context(IOBackend_t backend, size_t io_depth) {
+  switch (backend) {
+    case IOBackend_t::AIO:
+      return std::make_unique<AIOContext>(io_depth);
+    case IOBackend_t::IOUring:
+    case IOBackend_t::IOUringSQPoll:
+#ifdef ENABLE_IO_URING
+      return std::make_unique<IOUringContext>(io_depth, backend == IOBackend_t::IOUringSQPoll);
+#else
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "Please install liburing and compile HugeCTR with ENABLE_IO_URING to use the "
+                     "io_uring backend.");
+#endif
+    case IOBackend_t::GDS:
+#ifdef ENABLE_GDS
+      return std::make_unique<GDSContext>(io_depth);
+#else
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "Please install GPUDirect Storage and compile HugeCTR with ENABLE_GDS to use "
+                     "the GDS backend.");
+#endif
+    default:
+      HCTR_OWN_THROW(Error_t::WrongInput, "Unknown IO backend.");
+  }
+  return nullptr;
+}
+
+}  // namespace HugeCTR
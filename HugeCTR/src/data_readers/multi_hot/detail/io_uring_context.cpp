@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef ENABLE_IO_URING
+
+#include <sys/uio.h>
+
+#include <cassert>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <data_readers/multi_hot/detail/io_uring_context.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace HugeCTR {
+
+#define round_up(x, y) ((((x) + ((y)-1)) / (y)) * (y))
+
+namespace {
+
+// Time the kernel thread keeps polling without submissions before it sleeps.
+constexpr unsigned sq_thread_idle_ms = 1000;
+
+}  // namespace
+
+IOUringContext::IOUringContext(size_t io_depth, bool sqpoll)
+    : io_depth_(io_depth), sqpoll_(sqpoll), tmp_cqes_(io_depth) {
+  tmp_events_.reserve(io_depth);
+
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  if (sqpoll_) {
+    params.flags |= IORING_SETUP_SQPOLL;
+    params.sq_thread_idle = sq_thread_idle_ms;
+  }
+  int ret = io_uring_queue_init_params(io_depth, &ring_, &params);
+  if (ret < 0) {
+    throw std::runtime_error("io_uring_queue_init failed: " + std::string(strerror(-ret)) +
+                             (sqpoll_ ? ". SQPOLL requires Linux 5.11, or CAP_SYS_ADMIN before."
+                                      : ""));
+  }
+}
+
+IOUringContext::~IOUringContext() {
+  // app can't exit with requests in-flight
+  (void)collect(num_inflight_ + num_unsubmitted_, 1e6);  // wait 1s
+  assert(num_inflight_ == 0);
+  io_uring_queue_exit(&ring_);
+}
+
+void IOUringContext::register_files(const std::vector<int>& fds) {
+  assert(registered_fds_.empty() && num_inflight_ == 0);
+  int ret = io_uring_register_files(&ring_, fds.data(), fds.size());
+  if (ret < 0) {
+    throw std::runtime_error("io_uring_register_files failed: " + std::string(strerror(-ret)));
+  }
+  registered_fds_ = fds;
+}
+
+void IOUringContext::register_buffers(const std::vector<IOBuffer>& buffers) {
+  assert(registered_buffers_.empty() && num_inflight_ == 0);
+  std::vector<iovec> iovecs;
+  for (const auto& buffer : buffers) {
+    iovecs.push_back({buffer.data, buffer.size});
+  }
+  int ret = io_uring_register_buffers(&ring_, iovecs.data(), iovecs.size());
+  if (ret < 0) {
+    // Registered buffers count against RLIMIT_MEMLOCK. Plain reads still work without them.
+    HCTR_LOG_S(WARNING, WORLD) << "io_uring_register_buffers failed: " << strerror(-ret)
+                               << ", reading without registered buffers" << std::endl;
+    return;
+  }
+  registered_buffers_ = buffers;
+}
+
+void IOUringContext::submit(const IORequest& request) {
+  io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    throw std::runtime_error("io_uring submission queue full");
+  }
+
+  // For O_DIRECT, offsets and sizes need to be aligned
+  size_t aligned_offset = (request.offset / get_alignment()) * get_alignment();
+  size_t size = round_up(request.size + (request.offset - aligned_offset), get_alignment());
+
+  int buf_index = -1;
+  for (size_t i = 0; i < registered_buffers_.size(); ++i) {
+    const auto& buffer = registered_buffers_[i];
+    if (request.data >= buffer.data && request.data + size <= buffer.data + buffer.size) {
+      buf_index = static_cast<int>(i);
+      break;
+    }
+  }
+  int fd = request.fd;
+  bool fixed_file = false;
+  for (size_t i = 0; i < registered_fds_.size(); ++i) {
+    if (registered_fds_[i] == request.fd) {
+      fd = static_cast<int>(i);
+      fixed_file = true;
+      break;
+    }
+  }
+
+  if (request.write) {
+    if (buf_index >= 0) {
+      io_uring_prep_write_fixed(sqe, fd, request.data, size, aligned_offset, buf_index);
+    } else {
+      io_uring_prep_write(sqe, fd, request.data, size, aligned_offset);
+    }
+  } else if (buf_index >= 0) {
+    io_uring_prep_read_fixed(sqe, fd, request.data, size, aligned_offset, buf_index);
+  } else {
+    io_uring_prep_read(sqe, fd, request.data, size, aligned_offset);
+  }
+  if (fixed_file) {
+    sqe->flags |= IOSQE_FIXED_FILE;
+  }
+  io_uring_sqe_set_data(sqe, request.user_data);
+  num_unsubmitted_++;
+}
+
+const std::vector<IOEvent>& IOUringContext::collect(size_t min_reqs, size_t timeout_us) {
+  if (num_unsubmitted_ > 0) {
+    int ret = io_uring_submit(&ring_);
+    if (ret < 0) {
+      throw std::runtime_error("io_uring_submit failed: " + std::string(strerror(-ret)));
+    }
+    num_inflight_ += num_unsubmitted_;
+    num_unsubmitted_ = 0;
+  }
+
+  if (min_reqs > 0) {
+    __kernel_timespec timeout;
+    timeout.tv_sec = timeout_us / 1000000;
+    timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+    io_uring_cqe* cqe = nullptr;
+    int ret = io_uring_wait_cqes(&ring_, &cqe, min_reqs, &timeout, nullptr);
+    if (ret < 0 && ret != -ETIME && ret != -EINTR) {
+      throw std::runtime_error("io_uring_wait_cqes failed: " + std::string(strerror(-ret)));
+    }
+  }
+
+  unsigned num_completed = io_uring_peek_batch_cqe(&ring_, tmp_cqes_.data(), io_depth_);
+  num_inflight_ -= num_completed;
+
+  tmp_events_.clear();
+  for (unsigned i = 0; i < num_completed; ++i) {
+    io_uring_cqe* cqe = tmp_cqes_[i];
+    int ret = cqe->res;
+
+    if (ret < 0) {
+      throw std::runtime_error("io_uring returned failed event: " + std::string(strerror(-ret)));
+    }
+
+    IOEvent event;
+    event.error = ret < 0 ? errno_to_enum(-ret) : IOError::IO_SUCCESS;
+    event.user_data = io_uring_cqe_get_data(cqe);
+
+    tmp_events_.emplace_back(event);
+  }
+  io_uring_cq_advance(&ring_, num_completed);
+
+  return tmp_events_;
+}
+
+IOError IOUringContext::errno_to_enum(int err) {
+  switch (err) {
+    case 0:
+      return IOError::IO_SUCCESS;
+    case EAGAIN:
+      return IOError::IO_EAGAIN;
+    case EBADF:
+      return IOError::IO_EBADF;
+    case EFAULT:
+      return IOError::IO_EFAULT;
+    case EINVAL:
+      return IOError::IO_EINVAL;
+    case EINTR:
+      return IOError::IO_EINTR;
+    default:
+      return IOError::IO_UNKNOWN;
+  }
+}
+
+size_t IOUringContext::get_alignment() const {
+  return 4096;  // O_DIRECT requirement
+}
+
+}  // namespace HugeCTR
+
+#endif
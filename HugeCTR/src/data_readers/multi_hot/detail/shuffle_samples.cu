@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <data_readers/multi_hot/detail/shuffle_samples.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+namespace {
+
+__global__ void gather_samples_kernel(uint32_t* dst, const uint32_t* const* srcs,
+                                      const uint32_t* src_offsets, int num_srcs,
+                                      const uint32_t* perm, uint32_t num_samples,
+                                      size_t sample_words) {
+  const size_t num_words = num_samples * sample_words;
+  for (size_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < num_words;
+       idx += blockDim.x * gridDim.x) {
+    const size_t sample = idx / sample_words;
+    const size_t word = idx % sample_words;
+    const uint32_t src_sample = perm[sample];
+
+    // Groups hold a handful of batches, so a linear search is cheap.
+    int src = 0;
+    while (src + 1 < num_srcs && src_offsets[src + 1] <= src_sample) {
+      ++src;
+    }
+    const size_t row = src_sample - src_offsets[src];
+    dst[idx] = srcs[src][row * sample_words + word];
+  }
+}
+
+}  // namespace
+
+void gather_samples(uint32_t* dst, const uint32_t* const* srcs, const uint32_t* src_offsets,
+                    int num_srcs, const uint32_t* perm, uint32_t num_samples, size_t sample_words,
+                    cudaStream_t stream) {
+  const size_t num_words = num_samples * sample_words;
+  if (num_words == 0) {
+    return;
+  }
+  constexpr int block_size = 256;
+  const int grid_size =
+      static_cast<int>(std::min<size_t>((num_words + block_size - 1) / block_size, 1 << 16));
+  gather_samples_kernel<<<grid_size, block_size, 0, stream>>>(dst, srcs, src_offsets, num_srcs,
+                                                              perm, num_samples, sample_words);
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
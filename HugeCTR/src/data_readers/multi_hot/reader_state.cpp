@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common.hpp>
+#include <cstdio>
+#include <data_readers/multi_hot/reader_state.hpp>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+void save_reader_state(const std::string& file_name, const ReaderState& state) {
+  nlohmann::json config;
+  config["version"] = ReaderState::version;
+  config["epoch"] = state.position.epoch;
+  config["batch"] = state.position.batch;
+  config["seed"] = state.position.seed.value_or(0);
+  config["batch_size"] = state.batch_size;
+  config["num_batches"] = state.num_batches;
+  config["shuffle"] = state.shuffle;
+
+  // Written next to the final file and renamed, so that a preempted job never leaves a torn state.
+  const std::string tmp_file_name = file_name + ".tmp";
+  {
+    std::ofstream file_stream(tmp_file_name);
+    if (!file_stream.is_open()) {
+      HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open reader state file " + tmp_file_name);
+    }
+    file_stream << config.dump(2) << std::endl;
+    if (!file_stream.good()) {
+      HCTR_OWN_THROW(Error_t::UnspecificError, "Cannot write reader state file " + tmp_file_name);
+    }
+  }
+  if (std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+    HCTR_OWN_THROW(Error_t::UnspecificError, "Cannot rename reader state file " + tmp_file_name);
+  }
+}
+
+ReaderState load_reader_state(const std::string& file_name) {
+  std::ifstream file_stream(file_name);
+  if (!file_stream.is_open()) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open reader state file " + file_name);
+  }
+  ReaderState state;
+  try {
+    nlohmann::json config;
+    file_stream >> config;
+    const int version{config.at("version").get<int>()};
+    if (version != ReaderState::version) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Reader state file " + file_name + " has version " +
+                                              std::to_string(version) + ", but version " +
+                                              std::to_string(ReaderState::version) +
+                                              " is required.");
+    }
+    state.position.epoch = config.at("epoch").get<size_t>();
+    state.position.batch = config.at("batch").get<size_t>();
+    state.position.seed = config.at("seed").get<unsigned long long>();
+    state.batch_size = config.at("batch_size").get<size_t>();
+    state.num_batches = config.at("num_batches").get<size_t>();
+    state.shuffle = config.at("shuffle").get<bool>();
+  } catch (const nlohmann::json::exception& err) {
+    HCTR_OWN_THROW(Error_t::BrokenFile, "Invalid reader state file " + file_name + ": " +
+                                            err.what());
+  }
+  return state;
+}
+
+ReaderPosition resume_position(const ReaderState& state, size_t batch_size, bool shuffle) {
+  HCTR_CHECK_HINT(state.shuffle == shuffle,
+                  "The reader state was saved with shuffle = ", state.shuffle ? "True" : "False",
+                  ", it cannot be resumed with shuffle = ", shuffle ? "True" : "False");
+  if (state.batch_size == batch_size) {
+    return state.position;
+  }
+  HCTR_CHECK_HINT(!shuffle, "The reader state was saved with a batch size of ", state.batch_size,
+                  ", shuffled batches cannot be resumed with a batch size of ", batch_size);
+  ReaderPosition position = state.position;
+  position.batch = state.position.batch * state.batch_size / batch_size;
+  return position;
+}
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <cub/cub.cuh>
+#include <data_readers/multi_hot/variable_format.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+namespace {
+
+constexpr int kScanBlockSize = 256;
+
+// Copies the labels and dense features, and stores the number of keys of each sample at the
+// row offset of the next one. Samples past num_samples have no keys.
+template <typename DenseType, typename SparseType>
+__global__ void split_variable_dense_kernel(const int* __restrict samples,
+                                            const uint32_t* __restrict sample_offsets,
+                                            int num_samples, int batch_size_per_dev, float* label,
+                                            int label_dim, DenseType* dense, int dense_dim,
+                                            SparseType** sparse_row_offsets, int sparse_dim,
+                                            bool is_dense_float) {
+  const int num_items = label_dim + dense_dim + sparse_dim;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+       idx < static_cast<int64_t>(batch_size_per_dev) * num_items;
+       idx += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    const int sample = idx / num_items;
+    const int item = idx % num_items;
+    if (sample >= num_samples) {
+      if (item >= label_dim + dense_dim) {
+        sparse_row_offsets[item - label_dim - dense_dim][sample + 1] = 0;
+      }
+      continue;
+    }
+    const int data = samples[sample_offsets[sample] + item];
+    if (item < label_dim) {
+      label[sample * label_dim + item] = static_cast<float>(data);
+    } else if (item < label_dim + dense_dim) {
+      const float value = is_dense_float ? __int_as_float(data) : logf(data + 1.f);
+      dense[sample * dense_dim + item - label_dim] = static_cast<DenseType>(value);
+    } else {
+      sparse_row_offsets[item - label_dim - dense_dim][sample + 1] = static_cast<SparseType>(data);
+    }
+  }
+}
+
+// Turns the numbers of keys of a feature into its row offsets, one block per feature.
+template <typename SparseType>
+__global__ void scan_row_offsets_kernel(SparseType** sparse_row_offsets, int batch_size_per_dev) {
+  using BlockScan = cub::BlockScan<SparseType, kScanBlockSize>;
+  __shared__ typename BlockScan::TempStorage temp_storage;
+
+  SparseType* row_offsets = sparse_row_offsets[blockIdx.x];
+  SparseType carry = 0;
+  for (int begin = 0; begin < batch_size_per_dev; begin += kScanBlockSize) {
+    const int i = begin + threadIdx.x + 1;
+    SparseType value = i <= batch_size_per_dev ? row_offsets[i] : 0;
+    SparseType tile_sum;
+    BlockScan(temp_storage).InclusiveSum(value, value, tile_sum);
+    if (i <= batch_size_per_dev) {
+      row_offsets[i] = value + carry;
+    }
+    carry += tile_sum;
+    __syncthreads();
+  }
+  if (threadIdx.x == 0) {
+    row_offsets[0] = 0;
+  }
+}
+
+// Copies the keys of each sample and feature to their row offset.
+template <typename SparseType>
+__global__ void scatter_variable_keys_kernel(const int* __restrict samples,
+                                             const uint32_t* __restrict sample_offsets,
+                                             int num_samples, int label_dim, int dense_dim,
+                                             SparseType** sparse_values,
+                                             SparseType** sparse_row_offsets, int sparse_dim) {
+  constexpr int key_words = sizeof(SparseType) / sizeof(int);
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+       idx < static_cast<int64_t>(num_samples) * sparse_dim;
+       idx += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    const int sample = idx / sparse_dim;
+    const int fea_id = idx % sparse_dim;
+    const int* nnz = samples + sample_offsets[sample] + label_dim + dense_dim;
+    int key_begin = 0;
+    for (int i = 0; i < fea_id; ++i) {
+      key_begin += nnz[i];
+    }
+    const int* src = nnz + sparse_dim + key_begin * key_words;
+    // Keys are only 4-byte aligned in the sample, so they are copied word by word.
+    int* dst = reinterpret_cast<int*>(sparse_values[fea_id] + sparse_row_offsets[fea_id][sample]);
+    for (int w = 0; w < nnz[fea_id] * key_words; ++w) {
+      dst[w] = src[w];
+    }
+  }
+}
+
+int grid_size_of(int64_t num_items, int block_size) {
+  return static_cast<int>(std::min<int64_t>((num_items + block_size - 1) / block_size, 1 << 16));
+}
+
+}  // namespace
+
+template <typename DenseType, typename SparseType>
+void split_variable_samples(const int* samples, const uint32_t* sample_offsets, int num_samples,
+                            int batch_size_per_dev, float* label, int label_dim, DenseType* dense,
+                            int dense_dim, SparseType** sparse_values,
+                            SparseType** sparse_row_offsets, int sparse_dim, bool is_dense_float,
+                            cudaStream_t stream) {
+  constexpr int block_size = 256;
+  const int64_t num_items =
+      static_cast<int64_t>(batch_size_per_dev) * (label_dim + dense_dim + sparse_dim);
+  split_variable_dense_kernel<<<grid_size_of(num_items, block_size), block_size, 0, stream>>>(
+      samples, sample_offsets, num_samples, batch_size_per_dev, label, label_dim, dense,
+      dense_dim, sparse_row_offsets, sparse_dim, is_dense_float);
+  scan_row_offsets_kernel<<<sparse_dim, kScanBlockSize, 0, stream>>>(sparse_row_offsets,
+                                                                     batch_size_per_dev);
+  if (num_samples > 0) {
+    const int64_t num_pairs = static_cast<int64_t>(num_samples) * sparse_dim;
+    scatter_variable_keys_kernel<<<grid_size_of(num_pairs, block_size), block_size, 0, stream>>>(
+        samples, sample_offsets, num_samples, label_dim, dense_dim, sparse_values,
+        sparse_row_offsets, sparse_dim);
+  }
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+#define INSTANTIATE_SPLIT_VARIABLE(DENSE_T, SPARSE_T)                                          \
+  template void split_variable_samples<DENSE_T, SPARSE_T>(                                     \
+      const int* samples, const uint32_t* sample_offsets, int num_samples,                     \
+      int batch_size_per_dev, float* label, int label_dim, DENSE_T* dense, int dense_dim,      \
+      SPARSE_T** sparse_values, SPARSE_T** sparse_row_offsets, int sparse_dim,                 \
+      bool is_dense_float, cudaStream_t stream)
+
+INSTANTIATE_SPLIT_VARIABLE(float, uint32_t);
+INSTANTIATE_SPLIT_VARIABLE(__half, uint32_t);
+INSTANTIATE_SPLIT_VARIABLE(float, long long);
+INSTANTIATE_SPLIT_VARIABLE(__half, long long);
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <data_readers/multi_hot/synthetic_format.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+namespace {
+
+// splitmix64 of a counter, so that every item is drawn independently of the others.
+__device__ __forceinline__ uint64_t synthetic_hash(uint64_t seed, uint64_t counter) {
+  uint64_t z = seed + (counter + 1) * 0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+// Uniform in [0, 1) from the high 53 bits.
+__device__ __forceinline__ double synthetic_uniform(uint64_t bits) {
+  return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Inverse CDF of the power law x^-alpha on [1, vocabulary_size + 1), shifted to the keys.
+__device__ __forceinline__ long long synthetic_key(double u, long long vocabulary_size,
+                                                   float alpha) {
+  const double upper = static_cast<double>(vocabulary_size) + 1.0;
+  double x;
+  if (alpha == 0.f) {
+    x = 1.0 + u * (upper - 1.0);
+  } else if (fabs(alpha - 1.f) < 1e-6f) {
+    x = pow(upper, u);
+  } else {
+    const double exponent = 1.0 - alpha;
+    x = pow((pow(upper, exponent) - 1.0) * u + 1.0, 1.0 / exponent);
+  }
+  const long long key = static_cast<long long>(floor(x)) - 1;
+  return min(max(key, 0ll), vocabulary_size - 1);
+}
+
+template <typename SparseType>
+__global__ void generate_synthetic_samples_kernel(int* dst, int64_t num_samples, int label_dim,
+                                                  int dense_dim, int num_keys,
+                                                  const long long* key_vocabulary_sizes,
+                                                  const float* key_alphas, uint64_t seed,
+                                                  uint64_t first_sample) {
+  constexpr int key_words = sizeof(SparseType) / sizeof(int);
+  const int num_items = label_dim + dense_dim + num_keys;
+  const int dst_words = label_dim + dense_dim + num_keys * key_words;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < num_samples * num_items;
+       idx += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    const int64_t sample = idx / num_items;
+    const int item = idx % num_items;
+    const uint64_t bits = synthetic_hash(seed, (first_sample + sample) * num_items + item);
+    int* out = dst + sample * dst_words;
+
+    if (item < label_dim) {
+      out[item] = static_cast<int>(bits >> 63);
+    } else if (item < label_dim + dense_dim) {
+      out[item] = __float_as_int(static_cast<float>(synthetic_uniform(bits)));
+    } else {
+      const int key = item - label_dim - dense_dim;
+      const uint64_t value = static_cast<uint64_t>(
+          synthetic_key(synthetic_uniform(bits), key_vocabulary_sizes[key], key_alphas[key]));
+      // Keys are only 4-byte aligned in the raw layout, so they are written word by word.
+      int* key_out = out + label_dim + dense_dim + key * key_words;
+      key_out[0] = static_cast<int>(value & 0xffffffffu);
+      if (key_words > 1) {
+        key_out[1] = static_cast<int>(value >> 32);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename SparseType>
+void generate_synthetic_samples(int* dst, int64_t num_samples, int label_dim, int dense_dim,
+                                int num_keys, const long long* key_vocabulary_sizes,
+                                const float* key_alphas, uint64_t seed, uint64_t first_sample,
+                                cudaStream_t stream) {
+  const int64_t num_items = num_samples * (label_dim + dense_dim + num_keys);
+  if (num_items == 0) {
+    return;
+  }
+  constexpr int block_size = 256;
+  const int grid_size =
+      static_cast<int>(std::min<int64_t>((num_items + block_size - 1) / block_size, 1 << 16));
+  generate_synthetic_samples_kernel<SparseType><<<grid_size, block_size, 0, stream>>>(
+      dst, num_samples, label_dim, dense_dim, num_keys, key_vocabulary_sizes, key_alphas, seed,
+      first_sample);
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+template void generate_synthetic_samples<uint32_t>(int*, int64_t, int, int, int, const long long*,
+                                                   const float*, uint64_t, uint64_t, cudaStream_t);
+template void generate_synthetic_samples<long long>(int*, int64_t, int, int, int,
+                                                    const long long*, const float*, uint64_t,
+                                                    uint64_t, cudaStream_t);
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <data_readers/multi_hot/packed_format.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+namespace MultiHot {
+
+namespace {
+
+__device__ __forceinline__ uint64_t extract_bits(const uint32_t* words, uint32_t bit_offset,
+                                                 int bits) {
+  const uint32_t word = bit_offset / 32;
+  const int shift = bit_offset % 32;
+  uint64_t value = static_cast<uint64_t>(words[word]) >> shift;
+  // Only read the words that hold the bits, so that the last sample is not read past its end.
+  if (shift + bits > 32) {
+    value |= static_cast<uint64_t>(words[word + 1]) << (32 - shift);
+  }
+  if (shift + bits > 64) {
+    value |= static_cast<uint64_t>(words[word + 2]) << (64 - shift);
+  }
+  return bits >= 64 ? value : value & ((uint64_t{1} << bits) - 1);
+}
+
+template <typename SparseType>
+__global__ void unpack_samples_kernel(int* dst, const uint32_t* src, int64_t num_samples,
+                                      int packed_words, int label_dim, int dense_dim, int num_keys,
+                                      const uint32_t* item_bit_offsets, const int* key_bits) {
+  constexpr int key_words = sizeof(SparseType) / sizeof(int);
+  const int num_items = label_dim + dense_dim + num_keys;
+  const int dst_words = label_dim + dense_dim + num_keys * key_words;
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < num_samples * num_items;
+       idx += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    const int64_t sample = idx / num_items;
+    const int item = idx % num_items;
+    const uint32_t* packed = src + sample * packed_words;
+    int* out = dst + sample * dst_words;
+    const uint32_t bit_offset = item_bit_offsets[item];
+
+    if (item < label_dim) {
+      out[item] = static_cast<int>(packed[bit_offset / 32]);
+    } else if (item < label_dim + dense_dim) {
+      const uint16_t bits = static_cast<uint16_t>(extract_bits(packed, bit_offset, 16));
+      __half_raw raw;
+      raw.x = bits;
+      const float dense = __half2float(__half(raw));
+      out[item] = __float_as_int(dense);
+    } else {
+      const int key = item - label_dim - dense_dim;
+      const uint64_t value = extract_bits(packed, bit_offset, key_bits[key]);
+      // Keys are only 4-byte aligned in the raw layout, so they are written word by word.
+      int* key_out = out + label_dim + dense_dim + key * key_words;
+      key_out[0] = static_cast<int>(value & 0xffffffffu);
+      if (key_words > 1) {
+        key_out[1] = static_cast<int>(value >> 32);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename SparseType>
+void unpack_samples(int* dst, const uint32_t* src, int64_t num_samples, int packed_words,
+                    int label_dim, int dense_dim, int num_keys, const uint32_t* item_bit_offsets,
+                    const int* key_bits, cudaStream_t stream) {
+  const int64_t num_items = num_samples * (label_dim + dense_dim + num_keys);
+  if (num_items == 0) {
+    return;
+  }
+  constexpr int block_size = 256;
+  const int grid_size =
+      static_cast<int>(std::min<int64_t>((num_items + block_size - 1) / block_size, 1 << 16));
+  unpack_samples_kernel<SparseType><<<grid_size, block_size, 0, stream>>>(
+      dst, src, num_samples, packed_words, label_dim, dense_dim, num_keys, item_bit_offsets,
+      key_bits);
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+template void unpack_samples<uint32_t>(int*, const uint32_t*, int64_t, int, int, int, int,
+                                       const uint32_t*, const int*, cudaStream_t);
+template void unpack_samples<long long>(int*, const uint32_t*, int64_t, int, int, int, int,
+                                        const uint32_t*, const int*, cudaStream_t);
+
+}  // namespace MultiHot
+}  // namespace HugeCTR
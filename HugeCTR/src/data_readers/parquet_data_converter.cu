@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <common.hpp>
 #include <cstring>
 #include <cub/cub.cuh>
@@ -30,23 +31,6 @@ __device__ __forceinline__ unsigned int __mylaneid() {
   asm volatile("mov.u32 %0, %laneid;" : "=r"(laneid));
   return laneid;
 }
-//  type of row_offset : int32_t
-template <typename T>
-__device__ __forceinline__ T *upper_bound(T *start, T *end, T target) {
-  T left = 0;
-  T right = end - start;
-
-  while (left < right) {
-    T mid = (left + right) >> 1;
-    T val = *(start + mid);
-    if (val > target) {
-      right = mid;
-    } else {
-      left = mid + 1;
-    }
-  }
-  return start + left;
-}
 
 __device__ __forceinline__ unsigned int abs(unsigned int x) { return x; }
 
@@ -190,69 +174,35 @@ void __global__ offset_kernel__(int64_t *row_offsets_src, int view_offset, int n
   }
 }
 //! note that type of input row_offsets_src is int32_t, input slot_value_src is T
-//! output row_offsets_dst & slot_value_out is T
+//! output row_offset_dst & slot_value_dst is T
+// Each group of group_size threads copies the keys of a (sample, slot) straight from the list
+// column to their CSR offset, adding the offset of the slot, so that all slots take a single pass.
 template <typename ValueType, typename IndexType>
-void __global__ value_kernel_without_shared_mem__(int64_t *row_offsets_src, int64_t *slot_value_src,
-                                                  ValueType *dev_slot_offset_ptr, int view_offset,
-                                                  int num_params, int param_id, int slots_num,
-                                                  int64_t *row_offset_dst, int64_t *slot_value_out,
-                                                  int batchsize) {
-  // #samples = blockDim.x;
-  const int sample_num = blockDim.x;
-  const int total_dim = slots_num;
-  const int tid = threadIdx.x;
-
-  int sample_start = min(static_cast<int>(sample_num * blockIdx.x), static_cast<int>(batchsize));
-  int sample_end =
-      min(static_cast<int>(sample_num * (blockIdx.x + 1)), static_cast<int>(batchsize));
-  for (int i = 0; i < total_dim; i++) {
-    int64_t addr = row_offsets_src[i];
-    int32_t *row_offsets_in = reinterpret_cast<int32_t *>(addr);
-    addr = slot_value_src[i];
-    ValueType *value_in = reinterpret_cast<ValueType *>(addr);
-    int32_t row_start, row_end;
-    int32_t proceeded_nnz = view_offset;
-
+void __global__ value_kernel__(const int64_t *row_offsets_src, const int64_t *slot_value_src,
+                               const ValueType *dev_slot_offset_ptr, int view_offset,
+                               int slots_num, const IndexType *row_offset_dst,
+                               ValueType *slot_value_dst, int batchsize, int group_size) {
+  const int64_t num_groups = static_cast<int64_t>(batchsize) * slots_num;
+  const int64_t group_stride = static_cast<int64_t>(gridDim.x) * blockDim.x / group_size;
+  const int lane = threadIdx.x % group_size;
+  for (int64_t group = (static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x) / group_size;
+       group < num_groups; group += group_stride) {
+    const int sample_id = static_cast<int>(group / slots_num);
+    const int slot_id = static_cast<int>(group % slots_num);
+    const int32_t *row_offsets_in = reinterpret_cast<const int32_t *>(row_offsets_src[slot_id]);
+    const ValueType *value_in = reinterpret_cast<const ValueType *>(slot_value_src[slot_id]);
+
+    // s-hot columns hold a key per sample, m-hot ones the list offsets of cudf
+    int32_t row_start = view_offset + sample_id;
+    int32_t row_end = row_start + 1;
     if (row_offsets_in) {
-      proceeded_nnz = row_offsets_in[view_offset];
-      row_offsets_in += view_offset;
-      row_start = row_offsets_in[sample_start] - proceeded_nnz;
-      row_end = row_offsets_in[sample_end] - proceeded_nnz;
-    } else {
-      row_start = sample_start;
-      row_end = sample_end;
+      row_start = row_offsets_in[view_offset + sample_id];
+      row_end = row_offsets_in[view_offset + sample_id + 1];
     }
-    value_in += proceeded_nnz;
-    int buffer_id = param_id;
-    addr = row_offset_dst[buffer_id];
-    IndexType *row_offset_write = reinterpret_cast<IndexType *>(addr);
-
-    // load to reg and store to global memory directly
-    for (int row_idx = tid + row_start; row_idx < row_end; row_idx += blockDim.x) {
-      int sample_id;
-      if (row_offsets_in) {
-        sample_id =
-            static_cast<int>(upper_bound(row_offsets_in + sample_start, row_offsets_in + sample_end,
-                                         row_idx + proceeded_nnz) -
-                             row_offsets_in - 1);
-      } else {
-        sample_id = row_idx;
-      }
-      unsigned int idx_to_buffers = sample_id * slots_num + i;
-
-      IndexType dst_offset = static_cast<IndexType>(0);
-      // m-hot
-      if (row_offsets_in) {
-        dst_offset = row_offset_write[idx_to_buffers];
-        int slot_id = static_cast<int32_t>(row_idx) + proceeded_nnz - row_offsets_in[sample_id];
-        dst_offset += slot_id;
-      } else {  // s-hot
-        dst_offset = row_offset_write[idx_to_buffers];
-      }
-
-      addr = slot_value_out[buffer_id];
-      ValueType *value_write = reinterpret_cast<ValueType *>(addr);
-      value_write[dst_offset] = value_in[row_idx] + dev_slot_offset_ptr[i];
+    ValueType *value_write = slot_value_dst + row_offset_dst[group] - row_start;
+    const ValueType slot_offset = dev_slot_offset_ptr[slot_id];
+    for (int32_t row_idx = row_start + lane; row_idx < row_end; row_idx += group_size) {
+      value_write[row_idx] = value_in[row_idx] + slot_offset;
     }
   }
 }
@@ -343,55 +293,32 @@ size_t convert_parquet_cat_columns(
     std::vector<void *> &csr_value_buffers, std::vector<void *> &csr_row_offset_buffers,
     int64_t *dev_ptr_staging, T *dev_slot_offset_ptr, std::deque<rmm::device_buffer> &rmm_buffers,
     rmm::mr::device_memory_resource *mr, cudaStream_t task_stream) {
-  size_t pinned_staging_elements_used = 0;
   size_t size_of_col_ptrs = cat_column_data_ptr.size() * sizeof(int64_t *);
 
-  // prepare for value input
-  std::memcpy(dev_ptr_staging, cat_column_data_ptr.data(), size_of_col_ptrs);
-  pinned_staging_elements_used += cat_column_data_ptr.size();
-
-  rmm_buffers.emplace_back(size_of_col_ptrs, task_stream, mr);
-  rmm::device_buffer &dev_in_column_ptr = rmm_buffers.back();
-  HCTR_LIB_THROW(cudaMemcpyAsync(dev_in_column_ptr.data(), dev_ptr_staging, size_of_col_ptrs,
-                                 cudaMemcpyHostToDevice, task_stream));
-
+  // The column and csr pointers are staged back to back and copied at once:
+  // [value columns][row_offset columns][csr values][csr row offsets]
   int64_t *pinned_csr_offset_in_buffer =
       reinterpret_cast<int64_t *>((size_t)(dev_ptr_staging) + size_of_col_ptrs);
-
-  // prepare for row_offset input
-  std::memcpy(pinned_csr_offset_in_buffer, cat_column_row_offset_ptr.data(), size_of_col_ptrs);
-  pinned_staging_elements_used += cat_column_row_offset_ptr.size();
-
-  rmm_buffers.emplace_back(size_of_col_ptrs, task_stream, mr);
-  rmm::device_buffer &dev_csr_offset_in_buffer = rmm_buffers.back();
-  HCTR_LIB_THROW(cudaMemcpyAsync(dev_csr_offset_in_buffer.data(), pinned_csr_offset_in_buffer,
-                                 size_of_col_ptrs, cudaMemcpyHostToDevice, task_stream));
-
-  size_t size_of_csr_pointers = num_params * sizeof(int64_t);
-
   int64_t *pinned_csr_val_out_buffer =
       reinterpret_cast<int64_t *>((size_t)(dev_ptr_staging) + 2 * size_of_col_ptrs);
+  int64_t *pinned_csr_row_offset_buffer = pinned_csr_val_out_buffer + num_params;
+  std::memcpy(dev_ptr_staging, cat_column_data_ptr.data(), size_of_col_ptrs);
+  std::memcpy(pinned_csr_offset_in_buffer, cat_column_row_offset_ptr.data(), size_of_col_ptrs);
   for (int i = 0; i < num_params; i++) {
     pinned_csr_val_out_buffer[i] = (int64_t)csr_value_buffers[i];
-  }
-  pinned_staging_elements_used += num_params;
-
-  rmm_buffers.emplace_back(size_of_csr_pointers, task_stream, mr);
-  rmm::device_buffer &dev_csr_value_ptr = rmm_buffers.back();
-  HCTR_LIB_THROW(cudaMemcpyAsync(dev_csr_value_ptr.data(), pinned_csr_val_out_buffer,
-                                 size_of_csr_pointers, cudaMemcpyHostToDevice, task_stream));
-
-  int64_t *pinned_csr_row_offset_buffer = reinterpret_cast<int64_t *>(
-      (size_t)(dev_ptr_staging) + 2 * size_of_col_ptrs + size_of_csr_pointers);
-  for (int i = 0; i < num_params; i++) {
     pinned_csr_row_offset_buffer[i] = (int64_t)csr_row_offset_buffers[i];
   }
-  pinned_staging_elements_used += num_params;
+  size_t pinned_staging_elements_used = 2 * (cat_column_data_ptr.size() + num_params);
 
-  rmm_buffers.emplace_back(size_of_csr_pointers, task_stream, mr);
-  rmm::device_buffer &dev_csr_row_offset_ptr = rmm_buffers.back();
-  HCTR_LIB_THROW(cudaMemcpyAsync(dev_csr_row_offset_ptr.data(), pinned_csr_row_offset_buffer,
-                                 size_of_csr_pointers, cudaMemcpyHostToDevice, task_stream));
+  rmm_buffers.emplace_back(pinned_staging_elements_used * sizeof(int64_t), task_stream, mr);
+  rmm::device_buffer &dev_ptrs = rmm_buffers.back();
+  HCTR_LIB_THROW(cudaMemcpyAsync(dev_ptrs.data(), dev_ptr_staging,
+                                 pinned_staging_elements_used * sizeof(int64_t),
+                                 cudaMemcpyHostToDevice, task_stream));
+  int64_t *dev_in_column_ptr = reinterpret_cast<int64_t *>(dev_ptrs.data());
+  int64_t *dev_csr_offset_in_buffer = dev_in_column_ptr + cat_column_data_ptr.size();
+  int64_t *dev_csr_row_offset_ptr =
+      dev_in_column_ptr + 2 * cat_column_data_ptr.size() + num_params;
   {
     int block_size = (sizeof(IndexType) == 8) ? 128 : 256;
     dim3 block(block_size, 1, 1);
@@ -403,38 +330,36 @@ size_t convert_parquet_cat_columns(
       HCTR_OWN_THROW(Error_t::OutOfMemory, "Parquet Converter: Not enough shared memory available");
 
     offset_kernel__<IndexType><<<grid, block, smem_size, task_stream>>>(
-        reinterpret_cast<int64_t *>(dev_csr_offset_in_buffer.data()), view_offset, num_params,
-        param_id, num_slots, reinterpret_cast<int64_t *>(dev_csr_row_offset_ptr.data()),
-        batch_size);
+        dev_csr_offset_in_buffer, view_offset, num_params, param_id, num_slots,
+        dev_csr_row_offset_ptr, batch_size);
     int buffer_id = param_id;
+    IndexType *csr_row_offsets = reinterpret_cast<IndexType *>(csr_row_offset_buffers[buffer_id]);
     void *d_temp_storage = NULL;
     size_t temp_storage_bytes = 0;
     int64_t prefix_sum_items = num_slots * batch_size + 1;
-    HCTR_LIB_THROW(cub::DeviceScan::InclusiveSum(
-        d_temp_storage, temp_storage_bytes,
-        reinterpret_cast<IndexType *>(pinned_csr_row_offset_buffer[buffer_id]),
-        reinterpret_cast<IndexType *>(pinned_csr_row_offset_buffer[buffer_id]), prefix_sum_items,
-        task_stream));
+    HCTR_LIB_THROW(cub::DeviceScan::InclusiveSum(d_temp_storage, temp_storage_bytes,
+                                                 csr_row_offsets, csr_row_offsets,
+                                                 prefix_sum_items, task_stream));
     rmm_buffers.emplace_back(temp_storage_bytes, task_stream, mr);
     rmm::device_buffer &cub_tmp_storage = rmm_buffers.back();
-    HCTR_LIB_THROW(cub::DeviceScan::InclusiveSum(
-        cub_tmp_storage.data(), temp_storage_bytes,
-        reinterpret_cast<IndexType *>(pinned_csr_row_offset_buffer[buffer_id]),
-        reinterpret_cast<IndexType *>(pinned_csr_row_offset_buffer[buffer_id]), prefix_sum_items,
-        task_stream));
-
-    int num_keys = 512;
-
-    int samples_per_block = (num_keys - 1) / max_nnz + 1;
-    int block_per_grid = (batch_size - 1) / samples_per_block + 1;
-
-    value_kernel_without_shared_mem__<T, IndexType>
-        <<<block_per_grid, samples_per_block, 0, task_stream>>>(
-            reinterpret_cast<int64_t *>(dev_csr_offset_in_buffer.data()),
-            reinterpret_cast<int64_t *>(dev_in_column_ptr.data()), dev_slot_offset_ptr, view_offset,
-            num_params, param_id, num_slots,
-            reinterpret_cast<int64_t *>(dev_csr_row_offset_ptr.data()),
-            reinterpret_cast<int64_t *>(dev_csr_value_ptr.data()), batch_size);
+    HCTR_LIB_THROW(cub::DeviceScan::InclusiveSum(cub_tmp_storage.data(), temp_storage_bytes,
+                                                 csr_row_offsets, csr_row_offsets,
+                                                 prefix_sum_items, task_stream));
+
+    // groups of up to a warp per (sample, slot), by the max nnz of the slots
+    int group_size = 1;
+    while (group_size < max_nnz && group_size < 32) {
+      group_size *= 2;
+    }
+    const int64_t num_groups = static_cast<int64_t>(batch_size) * num_slots;
+    dim3 value_grid(
+        std::min<int64_t>((num_groups * group_size - 1) / block_size + 1, 65535), 1, 1);
+    if (num_groups > 0) {
+      value_kernel__<T, IndexType><<<value_grid, block, 0, task_stream>>>(
+          dev_csr_offset_in_buffer, dev_in_column_ptr, dev_slot_offset_ptr, view_offset, num_slots,
+          csr_row_offsets, reinterpret_cast<T *>(csr_value_buffers[buffer_id]), batch_size,
+          group_size);
+    }
 
     HCTR_LIB_THROW(cudaGetLastError());
   }
@@ -79,6 +79,8 @@ void ParquetDataReaderWorker<T>::do_h2d() {
       }
     }
     // no eof, normal row_group
+    // Decode the row group while the consumers still copy the previous one.
+    row_group_reader_->prefetch_one_read_group();
     if (!row_group_reader_->wait_until_writeable()) {
       return;
     }
@@ -157,9 +159,10 @@ void ParquetDataReaderWorker<T>::read_a_batch() {
               assert(buffer23_->state.load() == BufferState::Writing);
               // notify data collector the empty batch, it will switch state to
               // BufferState::ReadyForWrite
-              buffer23_->state.store(BufferState::ReadyForRead);
-              while (buffer23_->state.load() != BufferState::ReadyForWrite) {
-                usleep(2);
+              store_buffer_state(buffer23_->state, BufferState::ReadyForRead);
+              for (auto state = buffer23_->state.load(); state != BufferState::ReadyForWrite;
+                   state = buffer23_->state.load()) {
+                wait_buffer_state_change(buffer23_->state, state);
                 if (!loop_flag_->load()) {
                   return;
                 }
@@ -334,7 +337,7 @@ void ParquetDataReaderWorker<T>::read_a_batch() {
       HCTR_LIB_THROW(cudaStreamSynchronize(task_stream_));
       HCTR_LIB_THROW(cudaStreamSynchronize(dense_stream_));
     }
-    buffer23_->state.store(BufferState::ReadyForRead);
+    store_buffer_state(buffer23_->state, BufferState::ReadyForRead);
   } catch (const core23::RuntimeError& rt_err) {
     if (rt_err.error == Error_t::EndOfFile) {
       return;
@@ -163,18 +163,33 @@ void RowGroupReadingThread<T>::set_this_producer_status(BufferState stat) {
   this->producer_buffer_stats_[worker_id_]->store(stat);
 };
 
-// params input, others are output
 template <typename T>
-Error_t RowGroupReadingThread<T>::get_one_read_group(
-    const std::vector<DataReaderSparseParam>& params, std::vector<size_t>& dense_dim_array,
-    std::vector<int>& one_hot_slot_id, std::vector<int>& sparse_nnz_array) {
+Error_t RowGroupReadingThread<T>::prefetch_one_read_group() {
+  if (prefetched_df_) {
+    return Error_t::Success;
+  }
   if (!source_->is_open()) {
     return Error_t::EndOfFile;
   }
   CudaDeviceContext ctx(device_id_);
   auto tbl_w_metadata = source_->read_group(this->local_row_group_id_, this->memory_resource_);
   this->local_row_group_id_ += this->strict_order_of_batches_ ? this->num_workers_ : 1;
-  tbl_w_metadata.tbl.swap(this->cached_df_);
+  prefetched_df_ = std::move(tbl_w_metadata.tbl);
+  return Error_t::Success;
+}
+
+// params input, others are output
+template <typename T>
+Error_t RowGroupReadingThread<T>::get_one_read_group(
+    const std::vector<DataReaderSparseParam>& params, std::vector<size_t>& dense_dim_array,
+    std::vector<int>& one_hot_slot_id, std::vector<int>& sparse_nnz_array) {
+  Error_t err = prefetch_one_read_group();
+  if (err != Error_t::Success) {
+    return err;
+  }
+  CudaDeviceContext ctx(device_id_);
+  prefetched_df_.swap(this->cached_df_);
+  prefetched_df_.reset();
   cudf::table_view data_view = cached_df_->view();
   dump_table_data_to(data_view, dense_idx_to_parquet_col_, categorical_idx_parquet_col_, params,
                      df_container_producer_[this->worker_id_], dense_dim_array, one_hot_slot_id,
@@ -194,6 +209,7 @@ void RowGroupReadingThread<T>::reset_source(ParquetFileSource* source) {
 template <typename T>
 RowGroupReadingThread<T>::~RowGroupReadingThread() {
   CudaDeviceContext ctx(device_id_);
+  this->prefetched_df_.reset();
   this->cached_df_.reset();
   this->stop();
 }
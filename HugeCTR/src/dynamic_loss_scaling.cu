@@ -0,0 +1,80 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+namespace {
+
+// Beyond 2^24 the scaled gradients of FP16 are mostly infinite anyway.
+constexpr float max_loss_scale = 16777216.f;
+
+template <typename T>
+__global__ void unscale_and_check_kernel(T* grad, size_t count, const float* loss_scale,
+                                         float scaler, int* overflow, bool zero_non_finite) {
+  const float factor = scaler / *loss_scale;
+  bool non_finite = false;
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < count; i += blockDim.x * gridDim.x) {
+    const float value = TypeConvertFunc<float, T>::convert(grad[i]);
+    if (isfinite(value)) {
+      grad[i] = TypeConvertFunc<T, float>::convert(value * factor);
+    } else {
+      non_finite = true;
+      if (zero_non_finite) {
+        grad[i] = TypeConvertFunc<T, float>::convert(0.f);
+      }
+    }
+  }
+  if (__syncthreads_or(non_finite) && threadIdx.x == 0) {
+    *overflow = 1;
+  }
+}
+
+__global__ void update_loss_scale_kernel(float* loss_scale, int* state, int growth_interval) {
+  int* overflow = state;
+  int* good_steps = state + 1;
+  if (*overflow) {
+    *loss_scale = fmaxf(*loss_scale * 0.5f, 1.f);
+    *good_steps = 0;
+  } else if (++*good_steps >= growth_interval) {
+    *loss_scale = fminf(*loss_scale * 2.f, max_loss_scale);
+    *good_steps = 0;
+  }
+  *overflow = 0;
+}
+
+}  // namespace
+
+void unscale_and_check_gpu(size_t grid, size_t block, void* grad, size_t count,
+                           const float* loss_scale, float scaler, int* overflow,
+                           bool zero_non_finite, bool half, cudaStream_t stream) {
+  if (half) {
+    unscale_and_check_kernel<<<grid, block, 0, stream>>>(
+        static_cast<__half*>(grad), count, loss_scale, scaler, overflow, zero_non_finite);
+  } else {
+    unscale_and_check_kernel<<<grid, block, 0, stream>>>(
+        static_cast<float*>(grad), count, loss_scale, scaler, overflow, zero_non_finite);
+  }
+}
+
+void update_loss_scale_gpu(float* loss_scale, int* state, int growth_interval,
+                           cudaStream_t stream) {
+  update_loss_scale_kernel<<<1, 1, 0, stream>>>(loss_scale, state, growth_interval);
+}
+
+}  // namespace HugeCTR
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <cstring>
 #include <embedding_training_cache/embedding_training_cache_impl.hpp>
 #include <sstream>
 #include <string>
@@ -38,11 +39,11 @@ EmbeddingTrainingCacheImpl<TypeKey>::EmbeddingTrainingCacheImpl(
     std::vector<SparseEmbeddingHashParams>& embedding_params,
     std::vector<std::string>& sparse_embedding_files,
     std::shared_ptr<ResourceManager> resource_manager, std::vector<std::string>& local_paths,
-    std::vector<HMemCacheConfig>& hmem_cache_configs)
+    std::vector<HMemCacheConfig>& hmem_cache_configs, const WritebackConfig& writeback_config)
     : embeddings_(embeddings),
       ps_manager_(ps_types, sparse_embedding_files, get_embedding_type(embeddings),
                   embedding_params, get_max_embedding_size_(), resource_manager, local_paths,
-                  hmem_cache_configs) {}
+                  hmem_cache_configs, writeback_config) {}
 
 template <typename TypeKey>
 void EmbeddingTrainingCacheImpl<TypeKey>::load_(std::vector<std::string>& keyset_file_list) {
@@ -65,9 +66,129 @@ void EmbeddingTrainingCacheImpl<TypeKey>::load_(std::vector<std::string>& keyset
   }
 }
 
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::stage_(std::vector<std::string> keyset_file_list) {
+  StagedPass staged_pass;
+  for (size_t i = 0; i < ps_manager_.get_size(); i++) {
+    auto ptr_ps = ps_manager_.get_parameter_server(i);
+    auto keyset = ptr_ps->read_keyset_from_file(keyset_file_list[i]);
+
+    size_t hit_size = 0;
+    BufferBag& buf_bag = staged_buf_bags_[i];
+    ptr_ps->pull(keyset, buf_bag, hit_size);
+
+    std::unordered_map<TypeKey, size_t> rows;
+    rows.reserve(keyset.size());
+    for (auto key : keyset) {
+      rows.emplace(key, SIZE_MAX);
+    }
+    const TypeKey* key_ptr = Tensor2<TypeKey>::stretch_from(buf_bag.keys).get_ptr();
+    for (size_t row = 0; row < hit_size; row++) {
+      rows[key_ptr[row]] = row;
+    }
+    staged_pass.keysets.push_back(std::move(keyset));
+    staged_pass.hit_sizes.push_back(hit_size);
+    staged_pass.rows.push_back(std::move(rows));
+  }
+  staged_pass.keyset_file_list = std::move(keyset_file_list);
+  staged_pass_ = std::move(staged_pass);
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::wait_for_prefetch_() {
+  if (prefetch_.valid()) {
+    prefetch_.get();
+  }
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::merge_dumped_rows_(size_t i, size_t dump_size) {
+  BufferBag& dumped = ps_manager_.get_buffer_bag();
+  BufferBag& staged = staged_buf_bags_[i];
+  auto& rows = staged_pass_.rows[i];
+  size_t& hit_size = staged_pass_.hit_sizes[i];
+  const size_t vec_size = embeddings_[i]->get_embedding_params().embedding_vec_size;
+
+  const TypeKey* dumped_keys = Tensor2<TypeKey>::stretch_from(dumped.keys).get_ptr();
+  const size_t* dumped_slot_ids = Tensor2<size_t>::stretch_from(dumped.slot_id).get_ptr();
+  TypeKey* staged_keys = Tensor2<TypeKey>::stretch_from(staged.keys).get_ptr();
+  size_t* staged_slot_ids = Tensor2<size_t>::stretch_from(staged.slot_id).get_ptr();
+
+  size_t num_merged = 0;
+  for (size_t j = 0; j < dump_size; j++) {
+    auto it = rows.find(dumped_keys[j]);
+    if (it == rows.end()) continue;
+    // Keys that were new in the current pass are appended to the staged rows.
+    if (it->second == SIZE_MAX) it->second = hit_size++;
+    const size_t row = it->second;
+
+    staged_keys[row] = dumped_keys[j];
+    staged_slot_ids[row] = dumped_slot_ids[j];
+    memcpy(staged.embedding.get_ptr() + row * vec_size, dumped.embedding.get_ptr() + j * vec_size,
+           vec_size * sizeof(float));
+    for (size_t k = 0; k < staged.opt_states.size(); k++) {
+      memcpy(staged.opt_states[k].get_ptr() + row * vec_size,
+             dumped.opt_states[k].get_ptr() + j * vec_size, vec_size * sizeof(float));
+    }
+    num_merged++;
+  }
+  HCTR_LOG_S(INFO, ROOT) << "Synchronized " << num_merged << " of " << dump_size
+                         << " keys with the prefetched pass" << std::endl;
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::switch_to_staged_pass_() {
+  for (size_t i = 0; i < embeddings_.size(); i++) {
+    auto ptr_ps = ps_manager_.get_parameter_server(i);
+
+    size_t dump_size = 0;
+    embeddings_[i]->dump_parameters(ps_manager_.get_buffer_bag(), &dump_size);
+    merge_dumped_rows_(i, dump_size);
+    ptr_ps->push(ps_manager_.get_buffer_bag(), dump_size);
+  }
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
+#endif
+  for (auto& embedding : embeddings_) {
+    embedding->reset();
+    embedding->reset_optimizer();
+  }
+  for (size_t i = 0; i < embeddings_.size(); i++) {
+    ps_manager_.get_parameter_server(i)->set_keyset(std::move(staged_pass_.keysets[i]));
+    embeddings_[i]->load_parameters(staged_buf_bags_[i], staged_pass_.hit_sizes[i]);
+  }
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::prefetch(std::vector<std::string>& keyset_file_list) {
+  try {
+    if (keyset_file_list.size() != embeddings_.size()) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "num of keyset_file and num of embeddings don't equal");
+    }
+    wait_for_prefetch_();
+    staged_pass_ = StagedPass();
+    while (staged_buf_bags_.size() < embeddings_.size()) {
+      staged_buf_bags_.push_back(ps_manager_.create_staging_buffer_bag());
+    }
+    // Only reads the PS, which the current pass doesn't touch until the next update().
+    prefetch_ = std::async(std::launch::async, &EmbeddingTrainingCacheImpl::stage_, this,
+                           keyset_file_list);
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+    throw;
+  }
+}
+
+template <typename TypeKey>
+void EmbeddingTrainingCacheImpl<TypeKey>::prefetch(std::string& keyset_file) {
+  std::vector<std::string> keyset_file_list(embeddings_.size(), keyset_file);
+  prefetch(keyset_file_list);
+}
+
 template <typename TypeKey>
 void EmbeddingTrainingCacheImpl<TypeKey>::dump() {
   try {
+    wait_for_prefetch_();
     for (size_t i = 0; i < embeddings_.size(); i++) {
       auto ptr_ps = ps_manager_.get_parameter_server(i);
 
@@ -90,12 +211,19 @@ void EmbeddingTrainingCacheImpl<TypeKey>::update(std::vector<std::string>& keyse
 #ifndef KEY_HIT_RATIO
     HCTR_LOG(INFO, ROOT, "Preparing embedding table for next pass\n");
 #endif
-    dump();
-    for (auto& embedding : embeddings_) {
-      embedding->reset();
-      embedding->reset_optimizer();
+    wait_for_prefetch_();
+    if (!staged_pass_.keyset_file_list.empty() &&
+        staged_pass_.keyset_file_list == keyset_file_list) {
+      switch_to_staged_pass_();
+    } else {
+      dump();
+      for (auto& embedding : embeddings_) {
+        embedding->reset();
+        embedding->reset_optimizer();
+      }
+      load_(keyset_file_list);
     }
-    load_(keyset_file_list);
+    staged_pass_ = StagedPass();
 #ifdef ENABLE_MPI
     HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
 #endif
@@ -117,6 +245,7 @@ EmbeddingTrainingCacheImpl<TypeKey>::get_incremental_model(
     const std::vector<long long>& keys_to_load) {
   std::vector<std::pair<std::vector<long long>, std::vector<float>>> inc_model;
   size_t dump_size{0};
+  wait_for_prefetch_();
 
   for (size_t i = 0; i < embeddings_.size(); i++) {
     auto ptr_ps{ps_manager_.get_parameter_server(i)};
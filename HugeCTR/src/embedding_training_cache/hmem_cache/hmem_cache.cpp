@@ -18,6 +18,7 @@
 #include <tqdm.h>
 
 #include <HugeCTR/include/optimizer.hpp>
+#include <algorithm>
 #include <cstddef>
 #include <embedding_training_cache/hmem_cache/hmem_cache.hpp>
 #include <execution>
@@ -26,17 +27,10 @@
 namespace HugeCTR {
 
 template <typename TypeKey>
-size_t HMemCache<TypeKey>::find_(TypeKey key) {
-  if (!is_full_ && head_id_ == -1) return end_flag;
-  auto num_blk{is_full_ ? num_block_ : (head_id_ + 1)};
-  for (int cnt{0}; cnt < num_blk; cnt++) {
-    auto blk_idx{(head_id_ + num_block_ - cnt) % num_block_};
-    auto it{key_idx_maps_[blk_idx].find(key)};
-    if (it != key_idx_maps_[blk_idx].end()) {
-      return (blk_idx * block_capacity_ + it->second);
-    }
-  }
-  return end_flag;
+size_t HMemCache<TypeKey>::find_(TypeKey key) const {
+  auto const &partition{index_[partition_of_(key)]};
+  auto it{partition.find(key)};
+  return (it != partition.end()) ? it->second : end_flag;
 }
 
 template <typename TypeKey>
@@ -48,16 +42,107 @@ std::pair<int, size_t> HMemCache<TypeKey>::cascade_find_(TypeKey key) {
   return std::make_pair(-1, 0);
 }
 
+template <typename TypeKey>
+void HMemCache<TypeKey>::update_index_(std::vector<TypeKey> const &evicted_keys, int blk_idx,
+                                       TypeKey const *keys, size_t len, size_t first_line) {
+  auto const num_thread{24};
+  // Group the positions of the evicted and new keys by partition.
+  std::vector<std::vector<std::vector<size_t>>> sub_evicted_idx(
+      num_thread, std::vector<std::vector<size_t>>(num_partitions));
+  std::vector<std::vector<std::vector<size_t>>> sub_key_idx(
+      num_thread, std::vector<std::vector<size_t>>(num_partitions));
+#pragma omp parallel num_threads(num_thread)
+  {
+    auto const tid{static_cast<size_t>(omp_get_thread_num())};
+    auto group = [&](auto const *src, size_t src_len, auto &dst) {
+      auto sub_chunk_size{src_len / num_thread};
+      auto const idx{sub_chunk_size * tid};
+      if (tid == num_thread - 1) sub_chunk_size += (src_len % num_thread);
+      for (size_t i{idx}; i < idx + sub_chunk_size; i++) {
+        dst[tid][partition_of_(src[i])].push_back(i);
+      }
+    };
+    group(evicted_keys.data(), evicted_keys.size(), sub_evicted_idx);
+    group(keys, len, sub_key_idx);
+  }
+
+  size_t const blk_begin{blk_idx * block_capacity_};
+  size_t const blk_end{blk_begin + block_capacity_};
+#pragma omp parallel for num_threads(num_partitions)
+  for (size_t part = 0; part < num_partitions; part++) {
+    auto &partition{index_[part]};
+    for (size_t tid{0}; tid < num_thread; tid++) {
+      for (auto i : sub_evicted_idx[tid][part]) {
+        auto it{partition.find(evicted_keys[i])};
+        if (it != partition.end() && it->second >= blk_begin && it->second < blk_end) {
+          partition.erase(it);
+        }
+      }
+    }
+    for (size_t tid{0}; tid < num_thread; tid++) {
+      for (auto i : sub_key_idx[tid][part]) {
+        partition.insert_or_assign(keys[i], blk_begin + first_line + i);
+      }
+    }
+  }
+}
+
+template <typename TypeKey>
+size_t HMemCache<TypeKey>::retain_hot_lines_(int blk_idx, size_t num_used) {
+  auto const &evicted_keys{block_keys_[num_block_]};
+  auto const &evicted_counts{access_counts_[num_block_]};
+  size_t const num_free{block_capacity_ - num_used};
+  if (hot_row_min_access_ == 0 || num_free == 0) return 0;
+
+  // A line whose key lost its index entry in update_index_() was the newest copy of the key.
+  std::vector<char> is_hot(evicted_keys.size());
+#pragma omp parallel for num_threads(24)
+  for (size_t line = 0; line < evicted_keys.size(); line++) {
+    is_hot[line] =
+        evicted_counts[line] >= hot_row_min_access_ && find_(evicted_keys[line]) == end_flag;
+  }
+  std::vector<size_t> hot_lines;
+  for (size_t line{0}; line < is_hot.size(); line++) {
+    if (is_hot[line]) hot_lines.push_back(line);
+  }
+  if (hot_lines.size() > num_free) {
+    std::nth_element(hot_lines.begin(), hot_lines.begin() + num_free, hot_lines.end(),
+                     [&](size_t a, size_t b) { return evicted_counts[a] > evicted_counts[b]; });
+    hot_lines.resize(num_free);
+  }
+  if (hot_lines.empty()) return 0;
+
+  auto &keys{block_keys_[blk_idx]};
+  keys.resize(num_used + hot_lines.size());
+#pragma omp parallel for num_threads(24)
+  for (size_t cnt = 0; cnt < hot_lines.size(); cnt++) {
+    size_t const src_idx{hot_lines[cnt]};
+    size_t const dst_idx{num_used + cnt};
+    keys[dst_idx] = evicted_keys[src_idx];
+    if (use_slot_id_) slot_ids_[blk_idx][dst_idx] = slot_ids_[num_block_][src_idx];
+    for (size_t i{0}; i < vec_per_line_; i++) {
+      float const *src_ptr{cache_datas_[num_block_][i].data() + src_idx * emb_vec_size_};
+      float *dst_ptr{cache_datas_[blk_idx][i].data() + dst_idx * emb_vec_size_};
+      memcpy(dst_ptr, src_ptr, emb_vec_size_ * sizeof(float));
+    }
+    access_counts_[blk_idx][dst_idx] = evicted_counts[src_idx] / 2;
+  }
+  update_index_({}, blk_idx, keys.data() + num_used, hot_lines.size(), num_used);
+  return hot_lines.size();
+}
+
 template <typename TypeKey>
 HMemCache<TypeKey>::HMemCache(size_t num_cached_pass, double target_hit_rate, size_t max_num_evict,
                               size_t max_vocabulary_size, std::string sparse_model_file,
                               std::string local_path, bool use_slot_id, Optimizer_t opt_type,
                               size_t emb_vec_size,
-                              std::shared_ptr<ResourceManager> resource_manager)
+                              std::shared_ptr<ResourceManager> resource_manager,
+                              size_t hot_row_min_access)
     : num_block_{static_cast<int>(num_cached_pass)},
       target_hit_rate_{target_hit_rate},
       max_num_evict_{max_num_evict},
       block_capacity_{max_vocabulary_size},
+      hot_row_min_access_{hot_row_min_access},
       use_slot_id_{use_slot_id},
       emb_vec_size_{emb_vec_size},
       vec_per_line_{1 + OptParams::num_parameters_per_weight(opt_type)},
@@ -65,12 +150,14 @@ HMemCache<TypeKey>::HMemCache(size_t num_cached_pass, double target_hit_rate, si
       sparse_model_file_ptr_(std::make_shared<SparseModelFileTS<TypeKey>>(
           sparse_model_file, local_path, use_slot_id, opt_type, emb_vec_size, resource_manager)) {
   // +1 is reserved for a temp buffer
-  key_idx_maps_.resize(num_block_ + 1);
+  block_keys_.resize(num_block_ + 1);
   slot_ids_.resize(num_block_ + 1);
   cache_datas_.resize(num_block_ + 1);
+  access_counts_.resize(num_block_ + 1);
+  index_.resize(num_partitions);
 #pragma omp parallel for num_threads(num_block_ + 1)
   for (auto i = 0; i < num_block_ + 1; i++) {
-    key_idx_maps_[i].reserve(block_capacity_);
+    block_keys_[i].reserve(block_capacity_);
     if (use_slot_id_) {
       slot_ids_[i].resize(block_capacity_);
     }
@@ -78,6 +165,7 @@ HMemCache<TypeKey>::HMemCache(size_t num_cached_pass, double target_hit_rate, si
     for (auto &cache_data : cache_datas_[i]) {
       cache_data.resize(block_capacity_ * emb_vec_size_);
     }
+    access_counts_[i].resize(block_capacity_);
   }
 }
 
@@ -173,10 +261,13 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
   auto const tail_id{(head_id_ + 1) % num_block_};
   auto hit_rate{(len != 0) ? (1.0 * keys_vec[0].size() / len) : 0.};
 
+  // Lines loaded from the SSD start over with one pull.
+  std::vector<uint32_t> access_counts(len, 1);
 #pragma omp parallel for num_threads(24)
   for (size_t cnt = 0; cnt < idx_vecs[0].size(); cnt++) {
     size_t blk_idx{idx_vecs[0][cnt] / block_capacity_};
     size_t line_idx{idx_vecs[0][cnt] % block_capacity_};
+    access_counts[cnt] = access_counts_[blk_idx][line_idx] + 1;
     if (use_slot_id_) {
       slot_id_ptr[cnt] = slot_ids_[blk_idx][line_idx];
     }
@@ -194,14 +285,16 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
     {
       if (!is_full_ || (hit_rate < target_hit_rate_ && pass_counter < max_num_evict_)) {
         if (is_full_) {
-          std::swap(key_idx_maps_[tail_id], key_idx_maps_[num_block_]);
+          std::swap(block_keys_[tail_id], block_keys_[num_block_]);
           std::swap(slot_ids_[tail_id], slot_ids_[num_block_]);
           std::swap(cache_datas_[tail_id], cache_datas_[num_block_]);
+          std::swap(access_counts_[tail_id], access_counts_[num_block_]);
+        } else {
+          block_keys_[num_block_].clear();
         }
-        key_idx_maps_[tail_id].clear();
-        for (size_t i{0}; i < len; i++) {
-          key_idx_maps_[tail_id].insert({key_ptr[i], i});
-        }
+        update_index_(block_keys_[num_block_], tail_id, key_ptr, len);
+        block_keys_[tail_id].assign(key_ptr, key_ptr + len);
+        std::copy(access_counts.begin(), access_counts.end(), access_counts_[tail_id].begin());
         bool is_empty{idx_vecs[0].size() == 0};
         if (use_slot_id_ && !is_empty) {
           size_t *src_ptr{slot_id_ptr};
@@ -241,9 +334,13 @@ void HMemCache<TypeKey>::read(TypeKey *key_ptr, size_t &len, size_t *slot_id_ptr
 
   if (!is_full_ || (hit_rate < target_hit_rate_ && pass_counter < max_num_evict_)) {
     if (is_full_) {
-      sparse_model_file_ptr_->dump_update(key_idx_maps_[num_block_], slot_ids_[num_block_],
+      // Hot lines are still written back, but stay in the cache instead of being reloaded.
+      auto const num_retained{retain_hot_lines_(tail_id, len)};
+      sparse_model_file_ptr_->dump_update(block_keys_[num_block_], slot_ids_[num_block_],
                                           cache_datas_[num_block_]);
       pass_counter++;
+      HCTR_LOG_S(INFO, WORLD) << "HMEM-Cache PS: Retained " << num_retained
+                              << " hot rows of the evicted pass" << std::endl;
     }
     head_id_ = tail_id;
     if (!is_full_ && (head_id_ == num_block_ - 1)) {
@@ -373,7 +470,7 @@ void HMemCache<TypeKey>::sync_to_ssd() {
   }
   for (auto cnt{0}; cnt < num_blk; cnt++) {
     auto blk_idx{(tail_id + cnt) % num_block_};
-    sparse_model_file_ptr_->dump_update(key_idx_maps_[blk_idx], slot_ids_[blk_idx],
+    sparse_model_file_ptr_->dump_update(block_keys_[blk_idx], slot_ids_[blk_idx],
                                         cache_datas_[blk_idx]);
     if (resource_manager_->is_master_process()) {
       bar.progress(cnt + 1, num_blk);
@@ -522,30 +522,21 @@ void SparseModelFileTS<TypeKey>::load(std::vector<size_t> const& mem_src_idx, si
 }
 
 template <typename TypeKey>
-void SparseModelFileTS<TypeKey>::dump_update(HashTableType& dump_key_idx_map,
+void SparseModelFileTS<TypeKey>::dump_update(std::vector<TypeKey> const& dump_keys,
                                              std::vector<size_t>& slot_id_vec,
                                              std::vector<std::vector<float>>& data_vecs) {
   try {
-    if (dump_key_idx_map.size() == 0) return;
+    if (dump_keys.size() == 0) return;
     if (!mmap_handler_.mapped_to_file_) {
       mmap_to_memory_();
     }
     if (data_vecs.size() != mmap_handler_.mmaped_ptrs_.size()) {
       HCTR_OWN_THROW(Error_t::WrongInput, "Num of data files and pointers doesn't equal");
     }
-    std::vector<TypeKey> keys_vec;
-    keys_vec.reserve(dump_key_idx_map.size());
-    std::vector<size_t> mem_idx_vec;
-    mem_idx_vec.reserve(dump_key_idx_map.size());
-    std::for_each(dump_key_idx_map.begin(), dump_key_idx_map.end(), [&](auto& pair) {
-      keys_vec.push_back(pair.first);
-      mem_idx_vec.push_back(pair.second);
-    });
-
     size_t const num_thread(24);
     std::vector<std::vector<std::vector<size_t>>> sub_idx_vecs(num_thread,
                                                                std::vector<std::vector<size_t>>(2));
-    size_t len{keys_vec.size()};
+    size_t len{dump_keys.size()};
 #pragma omp parallel num_threads(num_thread)
     {
       size_t const tid(omp_get_thread_num());
@@ -557,11 +548,11 @@ void SparseModelFileTS<TypeKey>::dump_update(HashTableType& dump_key_idx_map,
         sub_idx_vecs[tid][i].reserve(sub_chunk_size);
       }
       for (size_t i{idx}; i < idx + sub_chunk_size; i++) {
-        auto it{key_idx_map_.find(keys_vec[i])};
+        auto it{key_idx_map_.find(dump_keys[i])};
         if (it == key_idx_map_.end()) {
           HCTR_OWN_THROW(Error_t::WrongInput, "key not found");
         } else {
-          sub_idx_vecs[tid][0].push_back(mem_idx_vec[i]);
+          sub_idx_vecs[tid][0].push_back(i);
           sub_idx_vecs[tid][1].push_back(it->second);
         }
       }
@@ -39,36 +39,28 @@ ParameterServer<TypeKey>::ParameterServer(TrainPSType_t ps_type,
                                           Embedding_t embedding_type, Optimizer_t opt_type,
                                           size_t emb_vec_size,
                                           std::shared_ptr<ResourceManager> resource_manager,
-                                          std::string local_path, HMemCacheConfig hmem_cache_config)
+                                          std::string local_path, HMemCacheConfig hmem_cache_config,
+                                          const WritebackConfig& writeback_config)
     : ps_type_(ps_type),
       use_slot_id_(embedding_type == Embedding_t::LocalizedSlotSparseEmbeddingHash ||
                    embedding_type == Embedding_t::LocalizedSlotSparseEmbeddingOneHot) {
   if (ps_type_ != TrainPSType_t::Cached) {
-    sparse_model_entity_.reset(new SparseModelEntity<TypeKey>(sparse_model_file, embedding_type,
-                                                              emb_vec_size, resource_manager));
+    sparse_model_entity_.reset(new SparseModelEntity<TypeKey>(
+        sparse_model_file, embedding_type, emb_vec_size, resource_manager, writeback_config));
     (void)opt_type;
   } else {
     hmem_cache_.reset(new HMemCache<TypeKey>(
         hmem_cache_config.num_cached_pass, hmem_cache_config.target_hit_rate,
         hmem_cache_config.max_num_evict, hmem_cache_config.block_capacity, sparse_model_file,
-        local_path, use_slot_id_, opt_type, emb_vec_size, resource_manager));
+        local_path, use_slot_id_, opt_type, emb_vec_size, resource_manager,
+        hmem_cache_config.hot_row_min_access));
   }
 }
 
 template <typename TypeKey>
 void ParameterServer<TypeKey>::load_keyset_from_file(std::string keyset_file) {
   try {
-    std::ifstream keyset_stream;
-    size_t file_size_in_byte = 0;
-    open_and_get_size(keyset_file, keyset_stream, file_size_in_byte);
-
-    if (file_size_in_byte == 0) {
-      HCTR_OWN_THROW(Error_t::WrongInput, keyset_file + " is empty");
-    }
-
-    size_t num_keys_in_file = file_size_in_byte / sizeof(TypeKey);
-    keyset_.resize(num_keys_in_file);
-    keyset_stream.read((char*)keyset_.data(), file_size_in_byte);
+    keyset_ = read_keyset_from_file(keyset_file);
 #ifdef ENABLE_MPI
     HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
 #endif
@@ -78,13 +70,36 @@ void ParameterServer<TypeKey>::load_keyset_from_file(std::string keyset_file) {
   }
 }
 
+template <typename TypeKey>
+std::vector<TypeKey> ParameterServer<TypeKey>::read_keyset_from_file(
+    const std::string& keyset_file) {
+  std::ifstream keyset_stream;
+  size_t file_size_in_byte = 0;
+  open_and_get_size(keyset_file, keyset_stream, file_size_in_byte);
+
+  if (file_size_in_byte == 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, keyset_file + " is empty");
+  }
+
+  size_t num_keys_in_file = file_size_in_byte / sizeof(TypeKey);
+  std::vector<TypeKey> keyset(num_keys_in_file);
+  keyset_stream.read((char*)keyset.data(), file_size_in_byte);
+  return keyset;
+}
+
 template <typename TypeKey>
 void ParameterServer<TypeKey>::pull(BufferBag& buf_bag, size_t& hit_size) {
-  if (keyset_.empty()) {
+  pull(keyset_, buf_bag, hit_size);
+}
+
+template <typename TypeKey>
+void ParameterServer<TypeKey>::pull(std::vector<TypeKey>& keys, BufferBag& buf_bag,
+                                    size_t& hit_size) {
+  if (keys.empty()) {
     HCTR_OWN_THROW(Error_t::WrongInput, "keyset is empty");
   }
   if (ps_type_ != TrainPSType_t::Cached) {
-    sparse_model_entity_->load_vec_by_key(keyset_, buf_bag, hit_size);
+    sparse_model_entity_->load_vec_by_key(keys, buf_bag, hit_size);
   } else {
     TypeKey* key_ptr{Tensor2<TypeKey>::stretch_from(buf_bag.keys).get_ptr()};
     size_t* slot_id_ptr{use_slot_id_ ? Tensor2<size_t>::stretch_from(buf_bag.slot_id).get_ptr()
@@ -94,8 +109,8 @@ void ParameterServer<TypeKey>::pull(BufferBag& buf_bag, size_t& hit_size) {
     for (auto& opt_state : buf_bag.opt_states) {
       data_ptrs.push_back(opt_state.get_ptr());
     }
-    memcpy(key_ptr, keyset_.data(), keyset_.size() * sizeof(TypeKey));
-    hit_size = keyset_.size();
+    memcpy(key_ptr, keys.data(), keys.size() * sizeof(TypeKey));
+    hit_size = keys.size();
     hmem_cache_->read(key_ptr, hit_size, slot_id_ptr, data_ptrs);
   }
 }
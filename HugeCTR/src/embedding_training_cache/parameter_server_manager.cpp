@@ -25,7 +25,8 @@ ParameterServerManager<TypeKey>::ParameterServerManager(
     std::vector<Embedding_t> embedding_types,
     std::vector<SparseEmbeddingHashParams>& embedding_params, size_t buffer_size,
     std::shared_ptr<ResourceManager> resource_manager, std::vector<std::string>& local_paths,
-    std::vector<HMemCacheConfig>& hmem_cache_configs) {
+    std::vector<HMemCacheConfig>& hmem_cache_configs, const WritebackConfig& writeback_config)
+    : buffer_size_(buffer_size) {
   try {
     if (sparse_embedding_files.size() == 0)
       HCTR_OWN_THROW(Error_t::WrongInput,
@@ -62,7 +63,7 @@ ParameterServerManager<TypeKey>::ParameterServerManager(
           ps_.push_back(std::make_shared<ParameterServer<TypeKey>>(
               ps_types[i], sparse_embedding_files[i], embedding_types[i],
               embedding_params[i].opt_params.optimizer, embedding_params[i].embedding_vec_size,
-              resource_manager));
+              resource_manager, "./", HMemCacheConfig(), writeback_config));
           break;
         }
         case TrainPSType_t::Cached: {
@@ -97,6 +98,7 @@ ParameterServerManager<TypeKey>::ParameterServerManager(
         embedding_params.begin(), embedding_params.end(),
         [](auto const& a, auto const& b) { return a.embedding_vec_size < b.embedding_vec_size; });
     size_t const max_vec_size{it->embedding_vec_size};
+    max_vec_size_ = max_vec_size;
 
     it = std::max_element(embedding_params.begin(), embedding_params.end(),
                           [](auto const& a, auto const& b) {
@@ -112,7 +114,8 @@ ParameterServerManager<TypeKey>::ParameterServerManager(
         embedding_types.begin(), embedding_types.end(),
         [](auto type) { return type == Embedding_t::LocalizedSlotSparseEmbeddingOneHot; })};
 
-    auto host_blobs_buff{GeneralBuffer2<CudaHostAllocator>::create()};
+    auto host_blobs_buff{
+        GeneralBuffer2<ArenaHostAllocator>::create(ArenaHostAllocator("embedding_training_cache"))};
     Tensor2<TypeKey> tensor_keys;
     Tensor2<size_t> tensor_slot_id;
     host_blobs_buff->reserve({buffer_size}, &tensor_keys);
@@ -167,6 +170,26 @@ ParameterServerManager<TypeKey>::ParameterServerManager(
   }
 }
 
+template <typename TypeKey>
+BufferBag ParameterServerManager<TypeKey>::create_staging_buffer_bag() {
+  BufferBag buf_bag{buf_bag_};
+  auto host_blobs_buff{
+      GeneralBuffer2<ArenaHostAllocator>::create(ArenaHostAllocator("embedding_training_cache"))};
+  Tensor2<TypeKey> tensor_keys;
+  Tensor2<size_t> tensor_slot_id;
+  host_blobs_buff->reserve({buffer_size_}, &tensor_keys);
+  host_blobs_buff->reserve({buffer_size_}, &tensor_slot_id);
+  host_blobs_buff->reserve({buffer_size_, max_vec_size_}, &(buf_bag.embedding));
+  for (auto& opt_state : buf_bag.opt_states) {
+    host_blobs_buff->reserve({buffer_size_, max_vec_size_}, &opt_state);
+  }
+  host_blobs_buff->allocate();
+
+  buf_bag.keys = tensor_keys.shrink();
+  buf_bag.slot_id = tensor_slot_id.shrink();
+  return buf_bag;
+}
+
 template class ParameterServerManager<long long>;
 template class ParameterServerManager<unsigned>;
 
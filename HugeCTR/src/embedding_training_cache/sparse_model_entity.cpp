@@ -131,12 +131,13 @@ namespace HugeCTR {
 template <typename TypeKey>
 SparseModelEntity<TypeKey>::SparseModelEntity(const std::string &sparse_model_file,
                                               Embedding_t embedding_type, size_t emb_vec_size,
-                                              std::shared_ptr<ResourceManager> resource_manager)
+                                              std::shared_ptr<ResourceManager> resource_manager,
+                                              const WritebackConfig &writeback_config)
     : is_distributed_(embedding_type == Embedding_t::DistributedSlotSparseEmbeddingHash),
       emb_vec_size_(emb_vec_size),
       resource_manager_(resource_manager),
       sparse_model_file_(SparseModelFile<TypeKey>(sparse_model_file, embedding_type, emb_vec_size,
-                                                  resource_manager)) {
+                                                  resource_manager, writeback_config)) {
   sparse_model_file_.load_emb_tbl_to_mem(exist_key_idx_mapping_, host_emb_tabel_);
 }
 
@@ -390,6 +391,10 @@ void SparseModelEntity<TypeKey>::flush_emb_tbl_to_ssd() {
         sparse_model_file_.append_new_vec_and_key(new_keys, new_slots.data(), new_vec_idx,
                                                   host_emb_tabel_.data());
 #ifdef ENABLE_MPI
+        // The ranks share the file, so the next one must find the vectors of this one on disk.
+        if (num_proc > 1) {
+          sparse_model_file_.wait_for_writeback();
+        }
       }
       HCTR_MPI_THROW(MPI_Barrier(MPI_COMM_WORLD));
     }
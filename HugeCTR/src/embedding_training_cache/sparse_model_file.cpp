@@ -127,13 +127,28 @@ void SparseModelFile<TypeKey>::unmap_embedding_from_memory_() {
   }
 }
 
+template <typename TypeKey>
+SparseModelWriteback* SparseModelFile<TypeKey>::get_writeback_() {
+  if (writeback_config_.dirty_budget_bytes == 0) {
+    return nullptr;
+  }
+  // Created on the first dump, once the master process has created the file.
+  if (!writeback_) {
+    writeback_ = std::make_unique<SparseModelWriteback>(
+        mmap_handler_.get_vec_file(), emb_vec_size_ * sizeof(float), writeback_config_);
+  }
+  return writeback_.get();
+}
+
 template <typename TypeKey>
 SparseModelFile<TypeKey>::SparseModelFile(const std::string& sparse_model_file,
                                           Embedding_t embedding_type, size_t emb_vec_size,
-                                          std::shared_ptr<ResourceManager> resource_manager)
+                                          std::shared_ptr<ResourceManager> resource_manager,
+                                          const WritebackConfig& writeback_config)
     : is_distributed_(embedding_type == Embedding_t::DistributedSlotSparseEmbeddingHash),
       emb_vec_size_(emb_vec_size),
-      resource_manager_(resource_manager) {
+      resource_manager_(resource_manager),
+      writeback_config_(writeback_config) {
   try {
     mmap_handler_.emb_tbl_.reset(new EmbeddingTableFile(sparse_model_file));
     if (!std::filesystem::exists(mmap_handler_.get_folder_name())) {
@@ -229,6 +244,7 @@ void SparseModelFile<TypeKey>::load_exist_vec_by_key(const std::vector<TypeKey>&
     vecs.resize(keys.size() * emb_vec_size_);
     const size_t emb_vec_size_in_byte = emb_vec_size_ * sizeof(float);
 
+    wait_for_writeback();
     map_embedding_to_memory_();
 #pragma omp parallel num_threads(8)
     {
@@ -267,6 +283,16 @@ void SparseModelFile<TypeKey>::dump_exist_vec_by_key(const std::vector<TypeKey>&
     }
     if (keys.size() == 0) return;
 
+    if (auto writeback = get_writeback_()) {
+      std::vector<size_t> rows(keys.size());
+#pragma omp parallel for num_threads(8)
+      for (size_t i = 0; i < keys.size(); i++) {
+        rows[i] = key_idx_map_.at(keys[i]).second;
+      }
+      writeback->write(rows, vec_indices, vecs);
+      return;
+    }
+
     const size_t emb_vec_size_in_byte = emb_vec_size_ * sizeof(float);
 
     map_embedding_to_memory_();
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <omp.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <embedding_training_cache/sparse_model_writeback.hpp>
+#include <numeric>
+
+namespace HugeCTR {
+
+SparseModelWriteback::SparseModelWriteback(const std::string& file_name, size_t row_size_bytes,
+                                           const WritebackConfig& config, size_t io_depth,
+                                           size_t extent_size_bytes)
+    : file_name_(file_name),
+      row_size_bytes_(row_size_bytes),
+      dirty_budget_bytes_(config.dirty_budget_bytes),
+      extent_size_bytes_(extent_size_bytes) {
+  if (config.io_backend == IOBackend_t::GDS) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "The GDS backend cannot write back host memory");
+  }
+  direct_fd_ = open(file_name.c_str(), O_RDWR | O_DIRECT);
+  buffered_fd_ = open(file_name.c_str(), O_WRONLY);
+  if (direct_fd_ == -1 || buffered_fd_ == -1) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open the file: " + file_name);
+  }
+
+  io_ctx_ = create_io_context(config.io_backend, io_depth);
+  alignment_ = io_ctx_->get_alignment();
+  if (extent_size_bytes_ % alignment_ != 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "The extent size must be a multiple of the alignment");
+  }
+  const size_t buffers_size = io_depth * extent_size_bytes_;
+  buffers_ = static_cast<uint8_t*>(std::aligned_alloc(alignment_, buffers_size));
+  if (buffers_ == nullptr) {
+    HCTR_OWN_THROW(Error_t::OutOfMemory, "Cannot allocate the writeback buffers");
+  }
+
+  extents_.resize(io_depth);
+  for (size_t i = 0; i < io_depth; ++i) {
+    extents_[i].buffer = buffers_ + i * extent_size_bytes_;
+    free_extents_.push_back(&extents_[i]);
+  }
+  io_ctx_->register_files({direct_fd_});
+  io_ctx_->register_buffers({{buffers_, buffers_size}});
+
+  thread_ = std::thread(&SparseModelWriteback::run_, this);
+}
+
+SparseModelWriteback::~SparseModelWriteback() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  if (error_) {
+    try {
+      std::rethrow_exception(error_);
+    } catch (const std::exception& err) {
+      HCTR_LOG_S(ERROR, WORLD) << "Writeback of " << file_name_ << " failed: " << err.what()
+                               << std::endl;
+    }
+  }
+
+  io_ctx_.reset();
+  std::free(buffers_);
+  close(direct_fd_);
+  close(buffered_fd_);
+}
+
+void SparseModelWriteback::write(const std::vector<size_t>& rows,
+                                 const std::vector<size_t>& src_rows, const float* src) {
+  if (rows.size() != src_rows.size()) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "rows.size() != src_rows.size()");
+  }
+  const char* src_bytes = reinterpret_cast<const char*>(src);
+  // Batches of half the budget, so that one batch is copied while the other is written.
+  const size_t max_rows = std::max<size_t>(1, dirty_budget_bytes_ / 2 / row_size_bytes_);
+  for (size_t begin = 0; begin < rows.size(); begin += max_rows) {
+    const size_t num_rows = std::min(max_rows, rows.size() - begin);
+    const size_t num_bytes = num_rows * row_size_bytes_;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] {
+        return error_ || dirty_bytes_ == 0 || dirty_bytes_ + num_bytes <= dirty_budget_bytes_;
+      });
+      if (error_) {
+        std::rethrow_exception(error_);
+      }
+      dirty_bytes_ += num_bytes;
+    }
+
+    Batch batch;
+    batch.rows.assign(rows.begin() + begin, rows.begin() + begin + num_rows);
+    batch.data.resize(num_bytes);
+#pragma omp parallel for num_threads(8)
+    for (size_t i = 0; i < num_rows; ++i) {
+      memcpy(batch.data.data() + i * row_size_bytes_,
+             src_bytes + src_rows[begin + i] * row_size_bytes_, row_size_bytes_);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(std::move(batch));
+    }
+    cv_.notify_all();
+  }
+}
+
+void SparseModelWriteback::wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&] { return error_ || (queue_.empty() && !writing_); });
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void SparseModelWriteback::run_() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      break;
+    }
+    Batch batch = std::move(queue_.front());
+    queue_.pop_front();
+    writing_ = true;
+    lock.unlock();
+
+    std::exception_ptr error;
+    try {
+      write_batch_(batch);
+      if (fdatasync(direct_fd_) != 0) {
+        HCTR_OWN_THROW(Error_t::UnspecificError, "fdatasync failed: " + file_name_);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    writing_ = false;
+    dirty_bytes_ -= batch.data.size();
+    if (error) {
+      // Later rows may depend on the failed ones, so they are dropped.
+      error_ = error;
+      for (const auto& queued : queue_) {
+        dirty_bytes_ -= queued.data.size();
+      }
+      queue_.clear();
+    }
+    cv_.notify_all();
+  }
+}
+
+void SparseModelWriteback::copy_rows_(const Batch& batch, const std::vector<size_t>& order,
+                                      const Extent& extent) {
+  for (size_t k = extent.first_row; k <= extent.last_row; ++k) {
+    const size_t row_begin = batch.rows[order[k]] * row_size_bytes_;
+    const size_t part_begin = std::max(row_begin, extent.begin);
+    const size_t part_end = std::min(row_begin + row_size_bytes_, extent.end);
+    memcpy(extent.buffer + (part_begin - extent.begin),
+           batch.data.data() + order[k] * row_size_bytes_ + (part_begin - row_begin),
+           part_end - part_begin);
+  }
+}
+
+void SparseModelWriteback::submit_(Extent& extent, bool is_write) {
+  IORequest request{direct_fd_, extent.buffer, extent.end - extent.begin, extent.begin, &extent,
+                    is_write};
+  io_ctx_->submit(request);
+}
+
+void SparseModelWriteback::complete_(size_t min_reqs, const Batch& batch,
+                                     const std::vector<size_t>& order) {
+  size_t num_completed = 0;
+  do {
+    const auto& events = io_ctx_->collect(min_reqs - std::min(num_completed, min_reqs), 100000);
+    for (const auto& event : events) {
+      if (event.error != IOError::IO_SUCCESS) {
+        HCTR_OWN_THROW(Error_t::UnspecificError, "Writeback IO failed: " + file_name_);
+      }
+      Extent* extent = static_cast<Extent*>(event.user_data);
+      if (extent->reading) {
+        // The blocks around the rows were read, so the extent can now be written.
+        extent->reading = false;
+        copy_rows_(batch, order, *extent);
+        submit_(*extent, true);
+      } else {
+        free_extents_.push_back(extent);
+      }
+      num_completed++;
+    }
+  } while (num_completed < min_reqs);
+}
+
+void SparseModelWriteback::write_batch_(Batch& batch) {
+  // Rows by offset, keeping only the last write of each row.
+  std::vector<size_t> order(batch.rows.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t a, size_t b) { return batch.rows[a] < batch.rows[b]; });
+  size_t num_unique = 0;
+  for (size_t k = 0; k < order.size(); ++k) {
+    if (k + 1 == order.size() || batch.rows[order[k]] != batch.rows[order[k + 1]]) {
+      order[num_unique++] = order[k];
+    }
+  }
+  order.resize(num_unique);
+  if (order.empty()) {
+    return;
+  }
+
+  struct stat file_stat;
+  if (fstat(direct_fd_, &file_stat) != 0) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot stat the file: " + file_name_);
+  }
+  const size_t file_size = file_stat.st_size;
+  if ((batch.rows[order.back()] + 1) * row_size_bytes_ > file_size) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Writeback row beyond the end of " + file_name_);
+  }
+  // The last partial block can't be written with O_DIRECT without extending the file.
+  const size_t direct_limit = file_size / alignment_ * alignment_;
+
+  auto row_begin = [&](size_t k) { return batch.rows[order[k]] * row_size_bytes_; };
+  size_t cursor = 0;  // Bytes before it are covered by submitted extents
+  size_t i = 0;
+  while (i < order.size()) {
+    const size_t begin = std::max(row_begin(i) / alignment_ * alignment_, cursor);
+    if (begin >= direct_limit) {
+      for (; i < order.size(); ++i) {
+        const size_t part_begin = std::max(row_begin(i), cursor);
+        const size_t part_size = row_begin(i) + row_size_bytes_ - part_begin;
+        const char* src = batch.data.data() + order[i] * row_size_bytes_ + row_size_bytes_ -
+                          part_size;
+        if (pwrite(buffered_fd_, src, part_size, part_begin) != static_cast<ssize_t>(part_size)) {
+          HCTR_OWN_THROW(Error_t::UnspecificError, "Writeback pwrite failed: " + file_name_);
+        }
+      }
+      break;
+    }
+
+    while (free_extents_.empty()) {
+      complete_(1, batch, order);
+    }
+    Extent* extent = free_extents_.back();
+    free_extents_.pop_back();
+
+    const size_t limit = std::min(begin + extent_size_bytes_, direct_limit);
+    size_t covered = 0;
+    size_t last = i;
+    for (size_t j = i; j < order.size() && row_begin(j) < limit; ++j) {
+      covered += std::min(row_begin(j) + row_size_bytes_, limit) - std::max(row_begin(j), begin);
+      last = j;
+      if (row_begin(j) + row_size_bytes_ > limit) {
+        break;
+      }
+    }
+    extent->begin = begin;
+    const size_t end = std::min(row_begin(last) + row_size_bytes_, limit);
+    extent->end = (end + alignment_ - 1) / alignment_ * alignment_;
+    extent->first_row = i;
+    extent->last_row = last;
+    cursor = extent->end;
+    // A row that continues past the extent is also the first row of the next one.
+    i = row_begin(last) + row_size_bytes_ > extent->end ? last : last + 1;
+
+    if (covered == extent->end - extent->begin) {
+      copy_rows_(batch, order, *extent);
+      submit_(*extent, true);
+    } else {
+      extent->reading = true;
+      submit_(*extent, false);
+    }
+    complete_(0, batch, order);
+  }
+
+  while (free_extents_.size() < extents_.size()) {
+    complete_(1, batch, order);
+  }
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common.hpp>
+#include <cstdio>
+#include <embeddings/dataset_stats.hpp>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace HugeCTR {
+
+DatasetStats load_dataset_stats(const std::string& file_name) {
+  std::ifstream file_stream(file_name);
+  if (!file_stream.is_open()) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open dataset stats file " + file_name);
+  }
+  nlohmann::json config;
+  try {
+    file_stream >> config;
+  } catch (const nlohmann::json::exception& err) {
+    HCTR_OWN_THROW(Error_t::BrokenFile, "Cannot parse dataset stats file " + file_name + ": " +
+                                            err.what());
+  }
+
+  DatasetStats stats;
+  try {
+    const int version{config.at("version").get<int>()};
+    if (version != DatasetStats::version) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Dataset stats file " + file_name + " has version " +
+                                              std::to_string(version) + ", but version " +
+                                              std::to_string(DatasetStats::version) +
+                                              " is required.");
+    }
+    stats.num_samples = config.at("num_samples").get<int64_t>();
+    for (const auto& table : config.at("tables")) {
+      TableKeyStats& table_stats{stats.tables[table.at("name").get<std::string>()]};
+      table_stats.num_keys = table.at("num_keys").get<int64_t>();
+      table_stats.num_unique_keys = table.at("num_unique_keys").get<double>();
+      for (const auto& [pooling_factor, count] : table.at("pooling_factor_histogram").items()) {
+        table_stats.pooling_factor_histogram[std::stoll(pooling_factor)] = count.get<int64_t>();
+      }
+      for (const auto& entry : table.at("top_keys")) {
+        table_stats.top_keys.emplace_back(entry.at(0).get<int64_t>(), entry.at(1).get<int64_t>());
+      }
+    }
+  } catch (const nlohmann::json::exception& err) {
+    HCTR_OWN_THROW(Error_t::BrokenFile, "Invalid dataset stats file " + file_name + ": " +
+                                            err.what());
+  }
+  return stats;
+}
+
+void save_dataset_stats(const DatasetStats& stats, const std::string& file_name) {
+  nlohmann::json config;
+  config["version"] = DatasetStats::version;
+  config["num_samples"] = stats.num_samples;
+  nlohmann::json tables = nlohmann::json::array();
+  for (const auto& [name, table_stats] : stats.tables) {
+    nlohmann::json table;
+    table["name"] = name;
+    table["num_keys"] = table_stats.num_keys;
+    table["num_unique_keys"] = table_stats.num_unique_keys;
+    nlohmann::json histogram = nlohmann::json::object();
+    for (const auto& [pooling_factor, count] : table_stats.pooling_factor_histogram) {
+      histogram[std::to_string(pooling_factor)] = count;
+    }
+    table["pooling_factor_histogram"] = histogram;
+    nlohmann::json top_keys = nlohmann::json::array();
+    for (const auto& [key, count] : table_stats.top_keys) {
+      top_keys.push_back({key, count});
+    }
+    table["top_keys"] = top_keys;
+    tables.push_back(table);
+  }
+  config["tables"] = tables;
+
+  const std::string tmp_file_name = file_name + ".tmp";
+  {
+    std::ofstream file_stream(tmp_file_name);
+    if (!file_stream.is_open()) {
+      HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open dataset stats file " + tmp_file_name);
+    }
+    file_stream << config.dump(2) << std::endl;
+    if (!file_stream.good()) {
+      HCTR_OWN_THROW(Error_t::UnspecificError, "Cannot write dataset stats file " + tmp_file_name);
+    }
+  }
+  if (std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0) {
+    HCTR_OWN_THROW(Error_t::UnspecificError, "Cannot rename dataset stats file " + tmp_file_name);
+  }
+}
+
+}  // namespace HugeCTR
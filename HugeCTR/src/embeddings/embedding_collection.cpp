@@ -43,8 +43,26 @@ EmbeddingCollection::EmbeddingCollection(
 
     embedding_tables_.push_back(create_grouped_embedding_tables(resource_manager, core[gpu_id],
                                                                 ebc_param_, emb_table_param_list));
+    if (!ebc_param_.sparse_freq_keys_data.table_ids.empty()) {
+      frequent_embedding_tables_.push_back(create_frequent_embedding_table(
+          resource_manager, core[gpu_id], ebc_param_, emb_table_param_list));
+    }
     embeddings_.push_back(create_grouped_embeddings(core[gpu_id], ebc_param_));
     eval_embeddings_.push_back(create_grouped_embeddings(core[gpu_id], eval_ebc_param_));
+
+    // Model parallel tables that support it reduce the wgrad in their update kernel, unless their
+    // reduction has to be deterministic.
+    for (size_t grouped_id = 0; grouped_id < embeddings_[gpu_id].size(); ++grouped_id) {
+      const auto &grouped_lookup_param = ebc_param_.grouped_lookup_params[grouped_id];
+      if (grouped_lookup_param.table_placement_strategy != TablePlacementStrategy::ModelParallel ||
+          grouped_lookup_param.embedding_type != EmbeddingType::Sparse ||
+          ebc_param_.is_deterministic(grouped_id)) {
+        continue;
+      }
+      if (get_table(gpu_id, grouped_id)->support_fused_update()) {
+        embeddings_[gpu_id][grouped_id]->enable_fused_update();
+      }
+    }
   }
 
   init_embedding_output_attrs(core);
@@ -104,6 +122,15 @@ void EmbeddingCollection::init_wgrad(std::vector<std::shared_ptr<CoreResourceMan
                     [](int vocabulary_size) {
                       HCTR_CHECK_HINT(vocabulary_size > 0, "vocabuary_size should > 0.");
                     });
+      // The replicas of the frequent keys only hold their rows.
+      if (ebc_param_.grouped_lookup_params[grouped_id].embedding_type ==
+          EmbeddingType::FrequentSparse) {
+        const auto &freq_keys_data = ebc_param_.sparse_freq_keys_data;
+        for (size_t i = 0; i < freq_keys_data.table_ids.size(); ++i) {
+          table_id_to_vocabulary_size[freq_keys_data.table_ids[i]] =
+              static_cast<int>(freq_keys_data.h_frequent_keys[i].size());
+        }
+      }
 
       int use_core23 = 1;
       if (getenv("HUGECTR_CORE23_NETWORK")) {
@@ -170,6 +197,10 @@ void EmbeddingCollection::init_wgrad(std::vector<std::shared_ptr<CoreResourceMan
 
 void EmbeddingCollection::init_peer_buffer(std::vector<std::shared_ptr<CoreResourceManager>> core) {
   // collective init peer buffer
+  if (ebc_param_.use_p2p_all2all_) {
+    init_p2p_all2all(core);
+    return;
+  }
   if (ebc_param_.comm_strategy_ != CommunicationStrategy::Hierarchical) return;
   HCTR_CHECK(resource_manager_->all_p2p_enabled());
   int num_gpus = resource_manager_->get_local_gpu_count();
@@ -207,6 +238,43 @@ void EmbeddingCollection::init_peer_buffer(std::vector<std::shared_ptr<CoreResou
   }
 }
 
+void EmbeddingCollection::init_p2p_all2all(std::vector<std::shared_ptr<CoreResourceManager>> core) {
+  HCTR_CHECK_HINT(ebc_param_.comm_strategy_ == CommunicationStrategy::Uniform,
+                  "P2P all-to-all requires the uniform communication strategy.");
+  HCTR_CHECK_HINT(resource_manager_->get_num_process() == 1 &&
+                      resource_manager_->get_local_gpu_count() ==
+                          resource_manager_->get_global_gpu_count(),
+                  "P2P all-to-all is only supported on a single node.");
+  HCTR_CHECK_HINT(resource_manager_->all_p2p_enabled(),
+                  "P2P all-to-all requires peer access between all gpus.");
+  int num_gpus = resource_manager_->get_local_gpu_count();
+
+  gpu_barrier_ = std::make_unique<HugeCTR::GPUBarrier>(
+      resource_manager_->get_local_gpu_count(), resource_manager_->get_local_gpu_device_id_list());
+
+  auto init_uniform_embedding =
+      [&](std::vector<std::vector<std::unique_ptr<IGroupedEmbeddingOp>>> &embeddings,
+          size_t grouped_id) {
+        std::vector<UniformModelParallelEmbedding *> mp_embeddings;
+        for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
+          mp_embeddings.push_back(
+              dynamic_cast<UniformModelParallelEmbedding *>(embeddings[gpu_id][grouped_id].get()));
+        }
+        for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
+          mp_embeddings[gpu_id]->init_p2p_all2all(mp_embeddings, gpu_barrier_.get());
+        }
+      };
+
+  for (size_t grouped_id = 0; grouped_id < ebc_param_.grouped_lookup_params.size(); ++grouped_id) {
+    if (ebc_param_.grouped_lookup_params[grouped_id].table_placement_strategy ==
+            TablePlacementStrategy::ModelParallel &&
+        ebc_param_.grouped_lookup_params[grouped_id].embedding_type == EmbeddingType::Sparse) {
+      init_uniform_embedding(embeddings_, grouped_id);
+      init_uniform_embedding(eval_embeddings_, grouped_id);
+    }
+  }
+}
+
 void EmbeddingCollection::cache_ddl_output(int gpu_id,
                                            const HugeCTR::DataDistributor::Result &input,
                                            HugeCTR::DataDistributor::Result &output,
@@ -226,7 +294,8 @@ void EmbeddingCollection::cache_ddl_output(int gpu_id,
     dst_result.h_num_keys = src_result.h_num_keys;
 
     auto &grouped_lookup_params = ebc_param_.grouped_lookup_params[grouped_id];
-    if (grouped_lookup_params.embedding_type == EmbeddingType::Sparse) {
+    if (grouped_lookup_params.embedding_type == EmbeddingType::Sparse ||
+        grouped_lookup_params.embedding_type == EmbeddingType::FrequentSparse) {
       core23::copy_async(dst_result.bucket_range, src_result.bucket_range, stream);
       core23::copy_async(dst_result.num_keys_per_bucket, src_result.num_keys_per_bucket, stream);
     }
@@ -269,20 +338,102 @@ void EmbeddingCollection::cache_ddl_output(int gpu_id,
   }
 }
 
+bool EmbeddingCollection::is_graph_capturable(const std::vector<Stage> &stages) const {
+  for (const auto &embeddings : embeddings_) {
+    for (const auto &embedding : embeddings) {
+      for (Stage stage : stages) {
+        if (embedding->is_valid_stage(stage) && !embedding->is_graph_capturable_stage(stage)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool EmbeddingCollection::is_concurrent_stage(Stage stage) const {
+  switch (stage) {
+    case Stage::DPForward:
+    case Stage::DenseMPModelForward:
+    case Stage::DenseMPBackwardIndexCalculation:
+    case Stage::MPBackwardIndexCalculation:
+    case Stage::HierMPBackwardIndexCalculation:
+    case Stage::DPLocalReduce:
+    case Stage::DenseMPLocalReduce:
+    case Stage::MPLocalReduce:
+    case Stage::HierMPLocalReduce:
+      return true;
+    case Stage::MPModelForward:
+      // The P2P all-to-all synchronizes all GPUs before it writes into their buffers.
+      return !ebc_param_.use_p2p_all2all_;
+    case Stage::DPBackwardIndexCalculation:
+      // The sparse all-reduce exchanges the unique keys of each group.
+      return ebc_param_.allreduce_strategy_ != AllreduceStrategy::Sparse;
+    default:
+      return false;
+  }
+}
+
+void EmbeddingCollection::run_grouped_stage(
+    Stage stage, int gpu_id, const EmbeddingCollectionParam &ebc_param,
+    const std::vector<std::unique_ptr<IGroupedEmbeddingOp>> &embeddings,
+    const std::function<void(size_t)> &run_group) {
+  std::vector<size_t> grouped_ids;
+  for (size_t grouped_id = 0; grouped_id < embeddings.size(); ++grouped_id) {
+    if (embeddings[grouped_id]->is_valid_stage(stage)) grouped_ids.push_back(grouped_id);
+  }
+  if (ebc_param.num_lookup_streams_ <= 1 || grouped_ids.size() <= 1 ||
+      !is_concurrent_stage(stage)) {
+    for (size_t grouped_id : grouped_ids) {
+      run_group(grouped_id);
+    }
+    return;
+  }
+
+  auto local_gpu = resource_manager_->get_local_gpu(gpu_id);
+  const std::string stream_name = local_gpu->get_current_stream_name();
+  cudaStream_t stream = local_gpu->get_stream();
+  cudaEvent_t fork_event = local_gpu->get_event(stream_name + "_lookup_fork");
+  HCTR_LIB_THROW(cudaEventRecord(fork_event, stream));
+
+  // The groups are dealt to the streams round-robin. A stream only runs groups of one priority.
+  std::vector<std::string> lookup_stream_names;
+  for (size_t i = 0; i < grouped_ids.size(); ++i) {
+    size_t grouped_id = grouped_ids[i];
+    int priority = ebc_param.get_stream_priority(grouped_id);
+    std::string lookup_stream_name = stream_name + "_lookup_" +
+                                     std::to_string(i % ebc_param.num_lookup_streams_) + "_" +
+                                     std::to_string(priority);
+    HugeCTR::StreamContext context(local_gpu, lookup_stream_name, priority);
+    if (std::find(lookup_stream_names.begin(), lookup_stream_names.end(), lookup_stream_name) ==
+        lookup_stream_names.end()) {
+      HCTR_LIB_THROW(cudaStreamWaitEvent(local_gpu->get_stream(), fork_event));
+      lookup_stream_names.push_back(lookup_stream_name);
+    }
+    run_group(grouped_id);
+  }
+
+  for (const auto &lookup_stream_name : lookup_stream_names) {
+    cudaEvent_t join_event = local_gpu->get_event(lookup_stream_name + "_join");
+    HCTR_LIB_THROW(cudaEventRecord(join_event, local_gpu->get_stream(lookup_stream_name)));
+    HCTR_LIB_THROW(cudaStreamWaitEvent(stream, join_event));
+  }
+}
+
 void EmbeddingCollection::forward_per_gpu(Stage stage, bool is_train, int gpu_id,
                                           const HugeCTR::DataDistributor::Result &input,
                                           core23::Tensor &output_buffer, int batch_size) {
   auto &embeddings = is_train ? embeddings_[gpu_id] : eval_embeddings_[gpu_id];
 
-  for (size_t grouped_id = 0; grouped_id < embeddings.size(); ++grouped_id) {
-    if (!embeddings[grouped_id]->is_valid_stage(stage)) continue;
-
+  auto forward_group = [&](size_t grouped_id) {
     ILookup *lookup = dynamic_cast<ILookup *>(get_table(gpu_id, grouped_id));
     EmbeddingOutput embedding_output{output_buffer, embedding_output_attrs[gpu_id][grouped_id]};
 
     embeddings[grouped_id]->forward_per_gpu(stage, input[grouped_id], lookup, embedding_output,
                                             batch_size);
-  }
+  };
+  run_grouped_stage(stage, gpu_id, is_train ? ebc_param_ : eval_ebc_param_, embeddings,
+                    forward_group);
 }
 
 void EmbeddingCollection::forward_per_gpu(bool is_train, int gpu_id,
@@ -298,6 +449,7 @@ void EmbeddingCollection::forward_per_gpu(bool is_train, int gpu_id,
   } else {
     HCTR_OWN_THROW(HugeCTR::Error_t::IllegalCall, "comm strategy not supported in forward_per_gpu");
   }
+  stages.push_back(Stage::DPFrequentForward);
 
   for (auto stage : stages) {
     forward_per_gpu(stage, is_train, gpu_id, input, output_buffer, batch_size);
@@ -307,13 +459,11 @@ void EmbeddingCollection::forward_per_gpu(bool is_train, int gpu_id,
 void EmbeddingCollection::backward_per_gpu(Stage stage, int gpu_id,
                                            const HugeCTR::DataDistributor::Result &input,
                                            const core23::Tensor &top_grad, int batch_size) {
-  for (size_t grouped_id = 0; grouped_id < embeddings_[gpu_id].size(); ++grouped_id) {
-    if (!embeddings_[gpu_id][grouped_id]->is_valid_stage(stage)) continue;
-
+  run_grouped_stage(stage, gpu_id, ebc_param_, embeddings_[gpu_id], [&](size_t grouped_id) {
     EmbeddingOutput top_grad_buffer{top_grad, embedding_output_attrs[gpu_id][grouped_id]};
     embeddings_[gpu_id][grouped_id]->backward_per_gpu(stage, input[grouped_id], top_grad_buffer,
                                                       wgrad_list_[gpu_id][grouped_id], batch_size);
-  }
+  });
 }
 
 void EmbeddingCollection::backward_per_gpu(int gpu_id,
@@ -341,12 +491,27 @@ void EmbeddingCollection::backward_per_gpu(int gpu_id,
   }
 }
 
+void EmbeddingCollection::prefetch_per_gpu(int gpu_id,
+                                           const HugeCTR::DataDistributor::Result &input,
+                                           int batch_size) {
+  HugeCTR::CudaDeviceContext context(resource_manager_->get_local_gpu(gpu_id)->get_device_id());
+  for (size_t grouped_id = 0; grouped_id < input.size(); ++grouped_id) {
+    if (ebc_param_.grouped_lookup_params[grouped_id].grouped_table_idx == -1) continue;
+    embeddings_[gpu_id][grouped_id]->prefetch(input[grouped_id], get_table(gpu_id, grouped_id),
+                                              batch_size);
+  }
+}
+
 void EmbeddingCollection::update_per_gpu(int gpu_id, embedding::TablePlacementStrategy tps) {
   for (size_t grouped_id = 0; grouped_id < embeddings_[gpu_id].size(); ++grouped_id) {
     if (ebc_param_.grouped_lookup_params[grouped_id].table_placement_strategy != tps) continue;
     auto &wgrad = wgrad_list_[gpu_id][grouped_id];
 
     auto table = get_table(gpu_id, grouped_id);
+    if (auto unreduced_wgrad = embeddings_[gpu_id][grouped_id]->get_unreduced_wgrad()) {
+      table->fused_update(*unreduced_wgrad, wgrad);
+      continue;
+    }
     table->update(wgrad.unique_keys, wgrad.num_unique_keys, wgrad.table_ids, wgrad.ev_start_indices,
                   wgrad.data);
   }
@@ -370,6 +535,20 @@ void EmbeddingCollection::set_learning_rate(float lr) {
   }
 }
 
+void EmbeddingCollection::set_learning_rate_schedulers(
+    const GpuLearningRateSchedulers &lr_scheds) {
+  HCTR_CHECK(lr_scheds.size() == embedding_tables_.size());
+  for (size_t gpu_id = 0; gpu_id < embedding_tables_.size(); ++gpu_id) {
+    const float *lr_ptr = lr_scheds[gpu_id]->get_learning_rate();
+    for (auto &t : embedding_tables_[gpu_id]) {
+      t->set_device_learning_rate(lr_ptr);
+    }
+    if (gpu_id < frequent_embedding_tables_.size()) {
+      frequent_embedding_tables_[gpu_id]->set_device_learning_rate(lr_ptr);
+    }
+  }
+}
+
 void EmbeddingCollection::bind_grouped_wgrad_ptr() {
   if (ebc_param_.allreduce_strategy_ != AllreduceStrategy::GroupDense) return;
   int num_gpus = static_cast<int>(wgrad_list_.size());
@@ -392,4 +571,87 @@ void EmbeddingCollection::bind_grouped_wgrad_ptr() {
   }
 }
 
+void EmbeddingCollection::flush_frequent_rows() {
+  const auto &freq_keys_data = ebc_param_.sparse_freq_keys_data;
+  int num_gpus = static_cast<int>(frequent_embedding_tables_.size());
+  core23::TensorParams params = core23::TensorParams().device(core23::DeviceType::CPU);
+
+  for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
+    HugeCTR::CudaDeviceContext context(resource_manager_->get_local_gpu(gpu_id)->get_device_id());
+    int global_gpu_id =
+        static_cast<int>(resource_manager_->get_gpu_global_id_from_local_id(gpu_id));
+    for (size_t i = 0; i < freq_keys_data.table_ids.size(); ++i) {
+      int table_id = freq_keys_data.table_ids[i];
+      const auto &frequent_keys = freq_keys_data.h_frequent_keys[i];
+      if (ebc_param_.shard_matrix[global_gpu_id][table_id] == 0) continue;
+      int grouped_table_id = -1;
+      for (size_t j = 0; j < ebc_param_.grouped_table_params.size(); ++j) {
+        const auto &table_ids = ebc_param_.grouped_table_params[j].table_ids;
+        if (std::find(table_ids.begin(), table_ids.end(), table_id) != table_ids.end()) {
+          grouped_table_id = static_cast<int>(j);
+        }
+      }
+      int shard_id, num_shards;
+      ebc_param_.get_table_shard_id(global_gpu_id, table_id, &shard_id, &num_shards);
+
+      int64_t num_frequent_keys = static_cast<int64_t>(frequent_keys.size());
+      int ev_size = emb_table_param_list_[table_id].ev_size;
+      core23::Tensor h_indices(params.shape({num_frequent_keys}).data_type(ebc_param_.key_type));
+      core23::Tensor h_weights(
+          params.shape({num_frequent_keys * ev_size}).data_type(core23::ScalarType::Float));
+      frequent_embedding_tables_[gpu_id]->dump_by_id(&h_indices, &h_weights, table_id);
+
+      DISPATCH_INTEGRAL_FUNCTION_CORE23(ebc_param_.key_type.type(), key_t, [&] {
+        const key_t *indices = h_indices.data<key_t>();
+        const float *weights = h_weights.data<float>();
+        std::vector<key_t> shard_keys;
+        std::vector<float> shard_weights;
+        for (int64_t k = 0; k < num_frequent_keys; ++k) {
+          key_t key = static_cast<key_t>(frequent_keys[indices[k]]);
+          if (key % num_shards != shard_id) continue;
+          shard_keys.push_back(key);
+          shard_weights.insert(shard_weights.end(), weights + k * ev_size,
+                               weights + (k + 1) * ev_size);
+        }
+        if (shard_keys.empty()) return;
+        core23::Tensor h_shard_keys(params.shape({static_cast<int64_t>(shard_keys.size())})
+                                        .data_type(ebc_param_.key_type));
+        core23::Tensor h_shard_weights(
+            params.shape({static_cast<int64_t>(shard_weights.size())})
+                .data_type(core23::ScalarType::Float));
+        std::copy(shard_keys.begin(), shard_keys.end(), h_shard_keys.data<key_t>());
+        std::copy(shard_weights.begin(), shard_weights.end(), h_shard_weights.data<float>());
+        embedding_tables_[gpu_id][grouped_table_id]->load_by_id(&h_shard_keys, &h_shard_weights,
+                                                                table_id);
+      });
+    }
+  }
+}
+
+void EmbeddingCollection::load_frequent_rows(int table_id, core23::Tensor &keys,
+                                             core23::Tensor &weights) {
+  int index = ebc_param_.get_frequent_table_index(table_id);
+  if (index < 0 || keys.num_elements() == 0) return;
+  const auto &frequent_keys = ebc_param_.sparse_freq_keys_data.h_frequent_keys[index];
+
+  // The replicas are indexed by the position of each key in the sorted frequent keys.
+  core23::Tensor indices(core23::TensorParams()
+                             .device(core23::DeviceType::CPU)
+                             .shape({keys.num_elements()})
+                             .data_type(keys.data_type()));
+  DISPATCH_INTEGRAL_FUNCTION_CORE23(keys.data_type().type(), key_t, [&] {
+    for (int64_t k = 0; k < keys.num_elements(); ++k) {
+      int64_t key = static_cast<int64_t>(keys.data<key_t>()[k]);
+      auto it = std::lower_bound(frequent_keys.begin(), frequent_keys.end(), key);
+      HCTR_CHECK_HINT(it != frequent_keys.end() && *it == key,
+                      "load_frequent_rows requires frequent keys only.");
+      indices.data<key_t>()[k] = static_cast<key_t>(it - frequent_keys.begin());
+    }
+  });
+  for (size_t gpu_id = 0; gpu_id < frequent_embedding_tables_.size(); ++gpu_id) {
+    HugeCTR::CudaDeviceContext context(resource_manager_->get_local_gpu(gpu_id)->get_device_id());
+    frequent_embedding_tables_[gpu_id]->load_by_id(&indices, &weights, table_id);
+  }
+}
+
 }  // namespace embedding
@@ -92,14 +92,19 @@ void Model<dtype>::init_params_and_reserve(CommunicationType communication_type_
 
 /// init_model calculates the optimal number of frequent categories
 /// given the calibration of the all-to-all and all-reduce.
+/// Unless count_samples is set, the statistics already hold the sorted
+/// categories, e.g. from a statistics file, and data.samples is unused.
 template <typename dtype>
 void Model<dtype>::init_hybrid_model(const CalibrationData &calibration,
                                      Statistics<dtype> &statistics, const Data<dtype> &data,
-                                     Tensor2<dtype> &tmp_categories, cudaStream_t stream) {
+                                     Tensor2<dtype> &tmp_categories, cudaStream_t stream,
+                                     bool count_samples) {
   dtype *frequent_categories_ptr = tmp_categories.get_ptr();  // tmp_categories.get_ptr();
   // list the top categories sorted by count
-  const Tensor2<dtype> &samples = data.samples;
-  statistics.sort_categories_by_count(samples, stream);
+  if (count_samples) {
+    const Tensor2<dtype> &samples = data.samples;
+    statistics.sort_categories_by_count(samples, stream);
+  }
 
   /* Calculate table offsets, i.e cumulative sum of the table sizes */
   std::vector<dtype> h_table_offsets(data.table_sizes.size() + 1);
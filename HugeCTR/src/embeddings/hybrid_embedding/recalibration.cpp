@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <common.hpp>
+#include <embeddings/hybrid_embedding/recalibration.hpp>
+#include <numeric>
+#include <thread_pool.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace hybrid_embedding {
+
+namespace {
+
+// Gain in the probability of being frequent from which the drift is reported as a warning.
+constexpr double drift_warning_threshold{0.01};
+
+}  // namespace
+
+template <typename dtype>
+Recalibration<dtype>::Recalibration(
+    const size_t interval, const size_t num_iterations_statistics, const size_t batch_size,
+    const std::vector<size_t> &table_sizes, const CalibrationData &calibration,
+    const CommunicationType communication_type, const size_t num_networks,
+    const size_t max_num_frequent_categories, const std::vector<dtype> &frequent_categories,
+    const std::string &statistics_file, const int device_id)
+    : sampling_interval_(std::max<size_t>(interval / std::max<size_t>(num_iterations_statistics, 1),
+                                          1)),
+      num_batches_per_window_(std::max<size_t>(interval / sampling_interval_, 1)),
+      batch_size_(batch_size),
+      num_iterations_statistics_(num_iterations_statistics),
+      table_sizes_(table_sizes),
+      num_categories_(static_cast<dtype>(
+          std::accumulate(table_sizes.begin(), table_sizes.end(), static_cast<size_t>(0)))),
+      num_networks_(num_networks),
+      max_num_frequent_categories_(max_num_frequent_categories),
+      frequent_categories_(frequent_categories.begin(), frequent_categories.end()),
+      statistics_file_(statistics_file),
+      device_id_(device_id),
+      count_threshold_(ModelInitializationFunctors<dtype>::calculate_threshold(
+          communication_type, calibration.p_dup_max, calibration.max_all_to_all_bandwidth,
+          calibration.max_all_reduce_bandwidth, calibration.efficiency_bandwidth_ratio,
+          calibration.num_nodes, batch_size, num_networks, num_iterations_statistics,
+          table_sizes.size())),
+      max_num_counts_(std::max<size_t>(4 * frequent_categories.size(), 1 << 20)) {
+  CudaDeviceContext context(device_id_);
+  HCTR_LIB_THROW(cudaEventCreateWithFlags(&copied_, cudaEventDisableTiming));
+}
+
+template <typename dtype>
+Recalibration<dtype>::~Recalibration() {
+  if (task_.valid()) {
+    task_.wait();
+  }
+  CudaDeviceContext context(device_id_);
+  cudaEventDestroy(copied_);
+  if (h_categories_) {
+    cudaFreeHost(h_categories_);
+  }
+}
+
+template <typename dtype>
+void Recalibration<dtype>::sample(const dtype *d_categories, const size_t num_categories,
+                                  cudaStream_t stream) {
+  const size_t batch = num_batches_++;
+  if (batch % sampling_interval_ != 0) {
+    return;
+  }
+  if (task_.valid()) {
+    if (task_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return;
+    }
+    task_.get();
+  }
+
+  CudaDeviceContext context(device_id_);
+  if (num_categories > capacity_) {
+    if (h_categories_) {
+      HCTR_LIB_THROW(cudaFreeHost(h_categories_));
+    }
+    HCTR_LIB_THROW(cudaMallocHost(&h_categories_, num_categories * sizeof(dtype)));
+    capacity_ = num_categories;
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(h_categories_, d_categories, num_categories * sizeof(dtype),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaEventRecord(copied_, stream));
+
+  task_ = ThreadPool::get().submit(
+      [this, num_categories, num_batches = batch + 1] {
+        // The recalibration is advisory, so its errors must not stop the training.
+        try {
+          HCTR_LIB_THROW(cudaEventSynchronize(copied_));
+          count_(num_categories);
+          if (++num_sampled_batches_ == num_batches_per_window_) {
+            recalibrate_(num_batches);
+            counts_.clear();
+            num_counted_ = 0;
+            num_sampled_batches_ = 0;
+          }
+        } catch (const std::exception &error) {
+          HCTR_LOG_S(WARNING, ROOT) << "Hybrid embedding recalibration failed: " << error.what()
+                                    << std::endl;
+        }
+      },
+      ThreadPool::Priority::Background);
+}
+
+template <typename dtype>
+void Recalibration<dtype>::count_(const size_t num_categories) {
+  for (size_t i = 0; i < num_categories; ++i) {
+    // Skips the padding of incomplete batches, and the garbage of a batch which the reader has
+    // already overwritten.
+    const dtype category = h_categories_[i];
+    if (static_cast<size_t>(category) < static_cast<size_t>(num_categories_)) {
+      ++counts_[category];
+      ++num_counted_;
+    }
+  }
+
+  // Only the most frequent categories are kept, like the top keys of tools/dataset_stats.
+  if (counts_.size() > 2 * max_num_counts_) {
+    CategoryCounts<dtype> counts(counts_.begin(), counts_.end());
+    std::nth_element(
+        counts.begin(), counts.begin() + max_num_counts_, counts.end(),
+        [](const auto &a, const auto &b) { return a.second > b.second; });
+    counts_ = std::unordered_map<dtype, uint64_t>(counts.begin(),
+                                                  counts.begin() + max_num_counts_);
+  }
+}
+
+template <typename dtype>
+void Recalibration<dtype>::recalibrate_(const size_t num_batches) {
+  if (num_counted_ == 0) {
+    return;
+  }
+  CategoryCounts<dtype> counts(counts_.begin(), counts_.end());
+  std::sort(counts.begin(), counts.end(),
+            [](const auto &a, const auto &b) { return a.second > b.second; });
+
+  uint64_t num_current_frequent = 0;
+  for (const auto &[category, count] : counts) {
+    if (frequent_categories_.count(category)) {
+      num_current_frequent += count;
+    }
+  }
+
+  // The threshold is for the counts of the startup statistics.
+  const double scale{static_cast<double>(batch_size_ * num_iterations_statistics_ *
+                                         table_sizes_.size()) /
+                     static_cast<double>(num_counted_)};
+  size_t num_frequent = 0;
+  while (num_frequent < counts.size() &&
+         static_cast<double>(counts[num_frequent].second) * scale >= count_threshold_) {
+    ++num_frequent;
+  }
+  // Rounded like in ModelInitializationFunctors::calculate_num_frequent_categories.
+  if (num_frequent > 0) {
+    num_frequent = ((num_frequent - 1) / num_networks_ + 1) * num_networks_;
+  }
+  if (num_frequent > counts.size()) {
+    num_frequent -= num_networks_;
+  }
+  num_frequent = std::min(num_frequent, max_num_frequent_categories_);
+  uint64_t num_recalibrated_frequent = 0;
+  for (size_t i = 0; i < num_frequent; ++i) {
+    num_recalibrated_frequent += counts[i].second;
+  }
+
+  const double current_probability{static_cast<double>(num_current_frequent) /
+                                   static_cast<double>(num_counted_)};
+  const double recalibrated_probability{static_cast<double>(num_recalibrated_frequent) /
+                                        static_cast<double>(num_counted_)};
+  if (recalibrated_probability - current_probability > drift_warning_threshold) {
+    HCTR_LOG_S(WARNING, ROOT) << "Hybrid embedding keys drifted after " << num_batches
+                              << " train batches: the " << frequent_categories_.size()
+                              << " frequent categories cover " << current_probability
+                              << " of the samples, " << num_frequent
+                              << " recalibrated ones would cover " << recalibrated_probability
+                              << ". Restart with the statistics_file to apply them." << std::endl;
+  } else {
+    HCTR_LOG_S(INFO, ROOT) << "Hybrid embedding recalibrated after " << num_batches
+                           << " train batches: the " << frequent_categories_.size()
+                           << " frequent categories cover " << current_probability
+                           << " of the samples, " << num_frequent
+                           << " recalibrated ones would cover " << recalibrated_probability
+                           << std::endl;
+  }
+
+  if (!statistics_file_.empty()) {
+    save_category_counts(statistics_file_, std::move(counts), table_sizes_,
+                         num_counted_ / table_sizes_.size(), max_num_frequent_categories_);
+  }
+}
+
+template class Recalibration<uint32_t>;
+template class Recalibration<long long>;
+
+}  // namespace hybrid_embedding
+
+}  // namespace HugeCTR
@@ -22,6 +22,7 @@
 #include <embeddings/hybrid_embedding/data.hpp>
 #include <embeddings/hybrid_embedding/select.cuh>
 #include <embeddings/hybrid_embedding/statistics.hpp>
+#include <embeddings/hybrid_embedding/utils.hpp>
 #include <iostream>
 #include <string>
 #include <tensor2.hpp>
@@ -182,6 +183,20 @@ void Statistics<dtype>::sort_categories_by_count(const Tensor2<dtype> &samples,
   counts_sorted.reset_shape({num_unique_categories, 1});
 }
 
+template <typename dtype>
+void Statistics<dtype>::set_categories_by_count(const std::vector<dtype> &categories,
+                                                const std::vector<uint32_t> &counts,
+                                                cudaStream_t stream) {
+  HCTR_CHECK_HINT(categories.size() == counts.size() && categories.size() <= num_samples,
+                  "Expected at most ", num_samples, " categories with one count each, but got ",
+                  categories.size(), " categories and ", counts.size(), " counts");
+  num_unique_categories = categories.size();
+  upload_tensor(categories, categories_sorted, stream);
+  upload_tensor(counts, counts_sorted, stream);
+  categories_sorted.reset_shape({num_unique_categories, 1});
+  counts_sorted.reset_shape({num_unique_categories, 1});
+}
+
 template <typename dtype>
 struct InfrequentSelectOp {
   const dtype *category_location;
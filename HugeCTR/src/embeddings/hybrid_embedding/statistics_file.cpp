@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <common.hpp>
+#include <embeddings/dataset_stats.hpp>
+#include <embeddings/hybrid_embedding/statistics_file.hpp>
+
+namespace HugeCTR {
+
+namespace hybrid_embedding {
+
+namespace {
+
+std::string get_table_name(const size_t slot) { return "table_" + std::to_string(slot); }
+
+template <typename dtype>
+void sort_by_count(CategoryCounts<dtype> &counts) {
+  std::sort(counts.begin(), counts.end(), [](const auto &a, const auto &b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  });
+}
+
+}  // namespace
+
+template <typename dtype>
+CategoryCounts<dtype> load_category_counts(const std::string &file_name,
+                                           const std::vector<size_t> &table_sizes,
+                                           const size_t num_samples) {
+  const DatasetStats stats{load_dataset_stats(file_name)};
+  if (stats.num_samples <= 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Dataset stats file " + file_name + " has no samples");
+  }
+  const double scale{static_cast<double>(num_samples) / static_cast<double>(stats.num_samples)};
+
+  CategoryCounts<dtype> counts;
+  size_t table_offset = 0;
+  for (size_t slot = 0; slot < table_sizes.size(); ++slot) {
+    const auto it{stats.tables.find(get_table_name(slot))};
+    if (it == stats.tables.end()) {
+      HCTR_LOG_S(WARNING, ROOT) << "Dataset stats file " << file_name << " has no table "
+                                << get_table_name(slot) << ", its keys are all infrequent"
+                                << std::endl;
+    } else {
+      for (const auto &[key, count] : it->second.top_keys) {
+        const auto scaled_count{static_cast<uint64_t>(std::llround(count * scale))};
+        if (key >= 0 && static_cast<size_t>(key) < table_sizes[slot] && scaled_count > 0) {
+          counts.emplace_back(static_cast<dtype>(table_offset + key), scaled_count);
+        }
+      }
+    }
+    table_offset += table_sizes[slot];
+  }
+  sort_by_count(counts);
+  return counts;
+}
+
+template <typename dtype>
+void save_category_counts(const std::string &file_name, CategoryCounts<dtype> counts,
+                          const std::vector<size_t> &table_sizes, const size_t num_samples,
+                          const size_t max_num_top_keys) {
+  DatasetStats stats;
+  stats.num_samples = num_samples;
+  std::vector<TableKeyStats *> tables;
+  std::vector<size_t> table_ends;
+  for (size_t slot = 0; slot < table_sizes.size(); ++slot) {
+    // Each slot has exactly one key per sample.
+    TableKeyStats &table_stats{stats.tables[get_table_name(slot)]};
+    table_stats.num_keys = num_samples;
+    table_stats.num_unique_keys = 0;
+    table_stats.pooling_factor_histogram[1] = num_samples;
+    tables.push_back(&table_stats);
+    table_ends.push_back((slot > 0 ? table_ends.back() : 0) + table_sizes[slot]);
+  }
+
+  sort_by_count(counts);
+  for (size_t i = 0; i < counts.size(); ++i) {
+    const auto category{static_cast<size_t>(counts[i].first)};
+    const size_t slot =
+        std::upper_bound(table_ends.begin(), table_ends.end(), category) - table_ends.begin();
+    if (slot == table_sizes.size()) {
+      continue;
+    }
+    TableKeyStats &table_stats{*tables[slot]};
+    table_stats.num_unique_keys += 1;
+    if (i < max_num_top_keys) {
+      const size_t table_offset = table_ends[slot] - table_sizes[slot];
+      table_stats.top_keys.emplace_back(category - table_offset, counts[i].second);
+    }
+  }
+  save_dataset_stats(stats, file_name);
+}
+
+template CategoryCounts<uint32_t> load_category_counts(const std::string &,
+                                                       const std::vector<size_t> &, size_t);
+template CategoryCounts<long long> load_category_counts(const std::string &,
+                                                        const std::vector<size_t> &, size_t);
+template void save_category_counts(const std::string &, CategoryCounts<uint32_t>,
+                                   const std::vector<size_t> &, size_t, size_t);
+template void save_category_counts(const std::string &, CategoryCounts<long long>,
+                                   const std::vector<size_t> &, size_t, size_t);
+
+}  // namespace hybrid_embedding
+
+}  // namespace HugeCTR
@@ -26,8 +26,11 @@
 #include <embeddings/hybrid_embedding/infrequent_embedding.hpp>
 #include <embeddings/hybrid_embedding/model.hpp>
 #include <embeddings/hybrid_embedding/statistics.hpp>
+#include <embeddings/hybrid_embedding/statistics_file.hpp>
 #include <embeddings/hybrid_embedding/utils.hpp>
 #include <embeddings/hybrid_sparse_embedding.hpp>
+#include <filesystem>
+#include <limits>
 #include <tensor2.hpp>
 #include <vector>
 
@@ -376,6 +379,14 @@ HybridSparseEmbedding<dtype, emtype>::HybridSparseEmbedding(
       }
     }
 
+    // Statistics from file spare the init data, but all processes must agree on using them.
+    int load_statistics = !embedding_params_.statistics_file.empty() &&
+                          std::filesystem::exists(embedding_params_.statistics_file);
+#ifdef ENABLE_MPI
+    HCTR_MPI_THROW(MPI_Bcast(&load_statistics, 1, MPI_INT, 0, MPI_COMM_WORLD));
+#endif
+    load_statistics_ = load_statistics;
+
     // Setup default indices
     train_batch_indices_.emplace_back(model_, train_input_tensors, resource_manager_,
                                       get_batch_size(true), embedding_params_.slot_size_array,
@@ -397,6 +408,26 @@ template <typename dtype, typename emtype>
 void HybridSparseEmbedding<dtype, emtype>::init_model(const SparseTensors<dtype> &data,
                                                       size_t &wgrad_offset_in_bytes) {
   size_t local_gpu_count = resource_manager_->get_local_gpu_count();
+  const size_t num_samples_statistics =
+      get_batch_size(true) * embedding_params_.num_iterations_statistics;
+
+  std::vector<dtype> h_categories_sorted;
+  std::vector<uint32_t> h_counts_sorted;
+  if (load_statistics_) {
+    HCTR_LOG_S(INFO, ROOT) << "Loading hybrid embedding statistics from "
+                           << embedding_params_.statistics_file << std::endl;
+    const auto counts = load_category_counts<dtype>(
+        embedding_params_.statistics_file, embedding_params_.slot_size_array,
+        num_samples_statistics);
+    const size_t num_unique_categories =
+        std::min(counts.size(), static_cast<size_t>(statistics_[0].num_samples));
+    for (size_t i = 0; i < num_unique_categories; ++i) {
+      h_categories_sorted.push_back(counts[i].first);
+      h_counts_sorted.push_back(static_cast<uint32_t>(
+          std::min<uint64_t>(counts[i].second, std::numeric_limits<uint32_t>::max())));
+    }
+  }
+
 #pragma omp parallel for num_threads(local_gpu_count)
   for (size_t id = 0; id < local_gpu_count; ++id) {
     int cur_device = get_local_gpu(id).get_device_id();
@@ -406,9 +437,13 @@ void HybridSparseEmbedding<dtype, emtype>::init_model(const SparseTensors<dtype>
     buf->reserve({(size_t)statistics_[id].num_categories, 1}, &tmp_categories);
     buf->allocate();
     auto stream = get_local_gpu(id).get_stream();
-    data_statistics_[id].data_to_unique_categories(data[id].get_value_tensor(), stream);
+    if (load_statistics_) {
+      statistics_[id].set_categories_by_count(h_categories_sorted, h_counts_sorted, stream);
+    } else {
+      data_statistics_[id].data_to_unique_categories(data[id].get_value_tensor(), stream);
+    }
     model_[id].init_hybrid_model(calibration_[id], statistics_[id], data_statistics_[id],
-                                 tmp_categories, stream);
+                                 tmp_categories, stream, !load_statistics_);
     get_frequent_embedding_data(id).initialize_embedding_vectors(data_statistics_[id].table_sizes,
                                                                  wgrad_offset_in_bytes);
 
@@ -431,6 +466,35 @@ void HybridSparseEmbedding<dtype, emtype>::init_model(const SparseTensors<dtype>
           "Found too many frequent categories, please increase 'max_num_frequent_categories'");
     }
   }
+  if (resource_manager_->is_master_process()) {
+    CudaDeviceContext context(get_local_gpu(0).get_device_id());
+    auto stream = get_local_gpu(0).get_stream();
+    if (!embedding_params_.statistics_file.empty() && !load_statistics_) {
+      download_tensor(h_categories_sorted, statistics_[0].categories_sorted, stream);
+      download_tensor(h_counts_sorted, statistics_[0].counts_sorted, stream);
+      CategoryCounts<dtype> counts;
+      for (size_t i = 0; i < h_categories_sorted.size(); ++i) {
+        counts.emplace_back(h_categories_sorted[i], h_counts_sorted[i]);
+      }
+      save_category_counts(embedding_params_.statistics_file, std::move(counts),
+                           embedding_params_.slot_size_array, num_samples_statistics,
+                           embedding_params_.max_num_frequent_categories);
+      HCTR_LOG_S(INFO, ROOT) << "Saved hybrid embedding statistics to "
+                             << embedding_params_.statistics_file << std::endl;
+    }
+    // The batches of all GPUs are the same, so the first GPU samples them.
+    if (embedding_params_.recalibration_interval > 0) {
+      std::vector<dtype> h_frequent_categories;
+      download_tensor(h_frequent_categories, model_[0].frequent_categories, stream);
+      recalibration_ = std::make_unique<Recalibration<dtype>>(
+          embedding_params_.recalibration_interval, embedding_params_.num_iterations_statistics,
+          get_batch_size(true), embedding_params_.slot_size_array, calibration_[0],
+          embedding_params_.communication_type, resource_manager_->get_global_gpu_count(),
+          embedding_params_.max_num_frequent_categories, h_frequent_categories,
+          embedding_params_.statistics_file, get_local_gpu(0).get_device_id());
+    }
+  }
+
   // free statistics_ memory
   // statistics_.clear();
   data_statistics_.clear();
@@ -504,6 +568,12 @@ void HybridSparseEmbedding<dtype, emtype>::forward(bool is_train) {
     freq_forward(is_train, i, true);
     infreq_network_forward(is_train, i);
   }
+
+  if (is_train && recalibration_) {
+    const auto &samples = train_batch_indices_.at(train_inflight_id_).get_samples(0);
+    recalibration_->sample(samples.get_ptr(), current_train_batch_size_ * get_slot_num(),
+                           get_local_gpu(0).get_stream());
+  }
 }
 
 template <typename dtype, typename emtype>
@@ -591,6 +661,14 @@ template <typename dtype, typename emtype>
 void HybridSparseEmbedding<dtype, emtype>::assign_input_tensors(bool is_train, size_t batch_size,
                                                                 size_t inflight_id, bool cached) {
   if (is_train) {
+    // The indices of the previous train batch were computed by the previous iteration, which the
+    // stream of the first GPU waits for.
+    if (recalibration_ && train_batch_assigned_) {
+      const auto &samples = train_batch_indices_.at(train_inflight_id_).get_samples(0);
+      recalibration_->sample(samples.get_ptr(), current_train_batch_size_ * get_slot_num(),
+                             get_local_gpu(0).get_stream());
+    }
+    train_batch_assigned_ = true;
     train_inflight_id_ = inflight_id;
     current_train_batch_size_ = batch_size;
     current_train_batch_cached_ = cached;
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <embeddings/dataset_stats.hpp>
+#include <embeddings/shard_planner.hpp>
+#include <limits>
+#include <numeric>
+#include <optimizer.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr double GB{1e9};
+
+// Cost model inputs of a single table
+struct TableCost {
+  int table_id;
+  std::string name;
+  bool dynamic;
+  double num_rows;
+  double bytes;        // Weights and optimizer states
+  double lookup_time;  // Lookup and update of all its keys in the global batch
+  double a2a_time;     // Forward and backward all-to-all of its output by a single GPU
+  double dp_time;      // Lookup and all-reduce time of each GPU, if replicated
+  int num_shards;
+};
+
+}  // namespace
+
+ShardPlan plan_shards(const ShardPlannerParams& params,
+                      const std::unordered_map<std::string, int>& table_name_to_id_dict,
+                      const std::vector<::embedding::EmbeddingTableParam>& table_params,
+                      const std::vector<::embedding::LookupParam>& lookup_params,
+                      const int batch_size, const int num_nodes, const int num_gpus_per_node,
+                      const size_t emb_type_size,
+                      const ::embedding::AllreduceStrategy allreduce_strategy,
+                      const size_t weight_type_size) {
+  const int num_table{static_cast<int>(table_params.size())};
+  const int num_gpus{num_nodes * num_gpus_per_node};
+  HCTR_CHECK_HINT(num_gpus > 0, "plan_shards requires at least 1 GPU.");
+  HCTR_CHECK_HINT(params.hbm_bandwidth > 0 && params.intra_node_bandwidth > 0 &&
+                      params.inter_node_bandwidth > 0,
+                  "plan_shards requires positive bandwidths.");
+
+  std::vector<std::string> table_names(num_table);
+  for (const auto& [name, id] : table_name_to_id_dict) {
+    table_names.at(id) = name;
+  }
+
+  // Time to send a byte to all other GPUs, one G-th of them each. The share of the own GPU is free.
+  const double intra_share{static_cast<double>(num_gpus_per_node - 1) / num_gpus};
+  const double inter_share{static_cast<double>(num_gpus - num_gpus_per_node) / num_gpus};
+  const double a2a_time_per_byte{intra_share / (params.intra_node_bandwidth * GB) +
+                                 inter_share / (params.inter_node_bandwidth * GB)};
+  // Ring all-reduces are bound by the slowest link.
+  const double allreduce_bandwidth{
+      (num_nodes > 1 ? params.inter_node_bandwidth : params.intra_node_bandwidth) * GB};
+
+  // Accumulate the work of the lookups of each table.
+  std::vector<double> keys_per_sample(num_table, 0), output_per_sample(num_table, 0);
+  for (const auto& lookup_param : lookup_params) {
+    const int table_id{lookup_param.table_id};
+    double pooling_factor{static_cast<double>(lookup_param.max_hotness)};
+    const auto it{params.pooling_factors.find(table_names[table_id])};
+    if (it != params.pooling_factors.end()) {
+      pooling_factor = std::min(it->second, pooling_factor);
+    }
+    keys_per_sample[table_id] += pooling_factor;
+    output_per_sample[table_id] += lookup_param.combiner == ::embedding::Combiner::Concat
+                                       ? lookup_param.max_hotness * lookup_param.ev_size
+                                       : lookup_param.ev_size;
+  }
+
+  // Measured statistics replace the max hotness and the unknown rows, unless they were given.
+  std::map<std::string, int64_t> num_rows{params.num_rows};
+  if (!params.dataset_stats.empty()) {
+    const DatasetStats stats{load_dataset_stats(params.dataset_stats)};
+    for (int table_id = 0; table_id < num_table; ++table_id) {
+      const auto it{stats.tables.find(table_names[table_id])};
+      if (it == stats.tables.end()) {
+        continue;
+      }
+      if (params.pooling_factors.find(it->first) == params.pooling_factors.end()) {
+        keys_per_sample[table_id] = std::min(keys_per_sample[table_id],
+                                             it->second.mean_pooling_factor(stats.num_samples));
+      }
+      num_rows.emplace(it->first, static_cast<int64_t>(std::ceil(it->second.num_unique_keys)));
+    }
+  }
+
+  std::vector<TableCost> tables;
+  for (const auto& table_param : table_params) {
+    const int table_id{table_param.table_id};
+    TableCost t;
+    t.table_id = table_id;
+    t.name = table_names[table_id];
+    t.dynamic = table_param.max_vocabulary_size < 0;
+    t.num_rows = table_param.max_vocabulary_size;
+    if (t.dynamic) {
+      const auto it{num_rows.find(t.name)};
+      t.num_rows = it != num_rows.end() ? static_cast<double>(it->second) : 0;
+    }
+    const double state_bytes{
+        static_cast<double>(table_param.opt_param.state_bytes_per_row(table_param.ev_size))};
+    // Dynamic tables always keep FP32 weights.
+    const double weight_bytes{static_cast<double>(
+        table_param.ev_size * (t.dynamic ? sizeof(float) : weight_type_size))};
+    t.bytes = t.num_rows * (weight_bytes + state_bytes);
+
+    // Keys are read in the forward pass, and read and written in the backward pass.
+    const double key_bytes{static_cast<double>(batch_size) * keys_per_sample[table_id] *
+                           weight_bytes};
+    t.lookup_time = 3 * key_bytes * (1 + state_bytes / weight_bytes) / (params.hbm_bandwidth * GB);
+    t.a2a_time = 2. * batch_size * output_per_sample[table_id] * emb_type_size * a2a_time_per_byte;
+
+    // Dense all-reduces exchange the whole table, sparse ones only the gradients of the batch.
+    const double wgrad_bytes{
+        allreduce_strategy == ::embedding::AllreduceStrategy::Sparse
+            ? static_cast<double>(batch_size) * keys_per_sample[table_id] * table_param.ev_size *
+                  emb_type_size
+            : t.num_rows * table_param.ev_size * emb_type_size};
+    t.dp_time = t.lookup_time / num_gpus +
+                2. * (num_gpus - 1) / num_gpus * wgrad_bytes / allreduce_bandwidth;
+    t.num_shards = 1;
+    tables.push_back(t);
+  }
+
+  const double hbm_budget{params.hbm_budget_gb > 0 ? params.hbm_budget_gb * GB
+                                                   : std::numeric_limits<double>::infinity()};
+
+  // Replicate the tables whose all-reduce costs less than their share of the MP work, starting
+  // with the smallest. Dense all-reduces require a fixed number of rows.
+  std::vector<TableCost*> dp_tables, mp_tables;
+  std::vector<TableCost*> by_size;
+  for (TableCost& t : tables) {
+    by_size.push_back(&t);
+  }
+  std::sort(by_size.begin(), by_size.end(),
+            [](const TableCost* a, const TableCost* b) { return a->bytes < b->bytes; });
+  double dp_bytes{0}, dp_time{0};
+  for (TableCost* t : by_size) {
+    const bool replicable{params.allow_data_parallel && !t->dynamic && num_gpus > 1};
+    if (replicable && t->dp_time * num_gpus <= t->lookup_time + t->a2a_time &&
+        dp_bytes + t->bytes <= 0.5 * hbm_budget) {
+      dp_bytes += t->bytes;
+      dp_time += t->dp_time;
+      dp_tables.push_back(t);
+    } else {
+      mp_tables.push_back(t);
+    }
+  }
+
+  // Split MP tables row-wise if they do not fit into a GPU, or exceed the average load. Tables
+  // larger than the average HBM usage of a GPU are split too, once the HBM is mostly used.
+  // Otherwise, the GPUs that hold them would have no room left to balance the load.
+  const double mp_hbm_budget{hbm_budget - dp_bytes};
+  double mp_time{0}, mp_bytes{0};
+  for (const TableCost* t : mp_tables) {
+    mp_time += t->lookup_time + t->a2a_time;
+    mp_bytes += t->bytes;
+  }
+  const double target_time{mp_time / num_gpus};
+  const double shard_bytes_limit{mp_bytes > 0.5 * mp_hbm_budget * num_gpus
+                                     ? std::min(mp_hbm_budget, mp_bytes / num_gpus)
+                                     : mp_hbm_budget};
+  for (TableCost* t : mp_tables) {
+    const double min_shards{std::ceil(t->bytes / mp_hbm_budget)};
+    HCTR_CHECK_HINT(min_shards <= num_gpus, "plan_shards error, table ", t->name, " requires ",
+                    min_shards, " shards to fit into HBM, but there are only ", num_gpus,
+                    " GPUs.\n");
+    // Every shard outputs all samples, so only the lookup time shrinks with more shards.
+    const double max_shards{static_cast<double>(num_gpus)};
+    double num_shards{std::min(max_shards, std::ceil(t->bytes / shard_bytes_limit))};
+    if (target_time > t->a2a_time) {
+      const double load_shards{std::ceil(t->lookup_time / (target_time - t->a2a_time))};
+      num_shards = std::max(num_shards, std::min(max_shards, load_shards));
+    }
+    t->num_shards = static_cast<int>(std::max({num_shards, min_shards, 1.}));
+  }
+
+  // Assign the shards of the most expensive tables first, each to the least loaded GPUs.
+  std::sort(mp_tables.begin(), mp_tables.end(), [](const TableCost* a, const TableCost* b) {
+    return a->lookup_time + a->num_shards * a->a2a_time >
+           b->lookup_time + b->num_shards * b->a2a_time;
+  });
+  ShardPlan plan;
+  plan.shard_matrix.assign(num_gpus, std::vector<int>(num_table, 0));
+  plan.gpu_cost.assign(num_gpus, dp_time);
+  std::vector<double> gpu_bytes(num_gpus, dp_bytes);
+  for (const TableCost* t : dp_tables) {
+    for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
+      plan.shard_matrix[gpu_id][t->table_id] = 1;
+    }
+  }
+  std::vector<int> gpu_ids;
+  for (TableCost* t : mp_tables) {
+    // Use more, smaller shards if too few GPUs have room left.
+    for (;; ++t->num_shards) {
+      gpu_ids.clear();
+      for (int gpu_id = 0; gpu_id < num_gpus; ++gpu_id) {
+        if (gpu_bytes[gpu_id] + t->bytes / t->num_shards <= hbm_budget) {
+          gpu_ids.push_back(gpu_id);
+        }
+      }
+      if (static_cast<int>(gpu_ids.size()) >= t->num_shards) {
+        break;
+      }
+      HCTR_CHECK_HINT(t->num_shards < num_gpus, "plan_shards error, table ", t->name,
+                      " does not fit into the remaining HBM budget.\n");
+    }
+    const double shard_bytes{t->bytes / t->num_shards};
+    const double shard_time{t->lookup_time / t->num_shards + t->a2a_time};
+
+    std::stable_sort(gpu_ids.begin(), gpu_ids.end(), [&](const int a, const int b) {
+      return plan.gpu_cost[a] < plan.gpu_cost[b];
+    });
+    for (int i = 0; i < t->num_shards; ++i) {
+      const int gpu_id{gpu_ids[i]};
+      plan.shard_matrix[gpu_id][t->table_id] = 1;
+      plan.gpu_cost[gpu_id] += shard_time;
+      gpu_bytes[gpu_id] += shard_bytes;
+    }
+  }
+
+  // Group all tables of the same placement, so that each strategy is executed once.
+  auto table_ids = [](const std::vector<TableCost*>& group) {
+    std::vector<int> ids;
+    for (const TableCost* t : group) {
+      ids.push_back(t->table_id);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  };
+  if (!mp_tables.empty()) {
+    plan.grouped_table_params.emplace_back(::embedding::TablePlacementStrategy::ModelParallel,
+                                           table_ids(mp_tables));
+  }
+  if (!dp_tables.empty()) {
+    plan.grouped_table_params.emplace_back(::embedding::TablePlacementStrategy::DataParallel,
+                                           table_ids(dp_tables));
+  }
+
+  const double max_cost{*std::max_element(plan.gpu_cost.begin(), plan.gpu_cost.end())};
+  const double mean_cost{std::accumulate(plan.gpu_cost.begin(), plan.gpu_cost.end(), 0.) /
+                         num_gpus};
+  size_t num_split_tables{0};
+  for (const TableCost* t : mp_tables) {
+    num_split_tables += t->num_shards > 1 ? 1 : 0;
+  }
+  HCTR_LOG(INFO, ROOT,
+           "Shard plan: %zu model parallel tables (%zu split row-wise), %zu data parallel tables. "
+           "Estimated embedding time per iteration: max %.3f ms, mean %.3f ms, imbalance %.2f.\n",
+           mp_tables.size(), num_split_tables, dp_tables.size(), max_cost * 1e3, mean_cost * 1e3,
+           mean_cost > 0 ? max_cost / mean_cost : 1.);
+  return plan;
+}
+
+}  // namespace HugeCTR
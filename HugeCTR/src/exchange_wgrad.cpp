@@ -14,15 +14,32 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <core23/logger.hpp>
 #include <exchange_wgrad.hpp>
+#include <timeline.hpp>
+#include <type_traits>
 #include <utils.hpp>
 
 namespace HugeCTR {
 
+void compress_wgrad_gpu(size_t grid, size_t block, void* dst, float* residual, const float* wgrad,
+                        size_t count, bool bf16, cudaStream_t stream);
+void decompress_wgrad_gpu(size_t grid, size_t block, float* wgrad, const void* src, size_t count,
+                          bool bf16, cudaStream_t stream);
+
 template <typename T>
 NetworkExchangeWgrad<T>::NetworkExchangeWgrad(
-    const std::shared_ptr<ResourceManager>& resource_manager)
-    : resource_manager_(resource_manager), num_gpus_(resource_manager->get_local_gpu_count()) {
+    const std::shared_ptr<ResourceManager>& resource_manager, WgradCompression_t compression)
+    : resource_manager_(resource_manager),
+      compression_(compression),
+      num_gpus_(resource_manager->get_local_gpu_count()) {
+  if (std::is_same_v<T, __half> && compression_ != WgradCompression_t::Disabled) {
+    HCTR_LOG_S(WARNING, ROOT)
+        << "The wgrad of mixed precision training is already 16 bit and isn't compressed"
+        << std::endl;
+    compression_ = WgradCompression_t::Disabled;
+  }
   bufs_.resize(num_gpus_, NULL);
   network_wgrad_buffs_.resize(num_gpus_, NULL);
   null_wgrad_buffs_.resize(num_gpus_, NULL);
@@ -38,12 +55,16 @@ NetworkExchangeWgrad<T>::NetworkExchangeWgrad(
 template <typename T>
 void NetworkExchangeWgrad<T>::init_ar_comm(const std::vector<void*>& ptr, size_t sizes) {
   network_wgrad_size_ = sizes;
+  ar_ptrs_ = ptr;
   auto ar_comm = resource_manager_->get_ar_comm();
   for (size_t g = 0; g < num_gpus_; g++) {
     HCTR_CHECK_HINT(ptr[g], "buffer does not exist");
     ar_comm->set_coll_buf(ar_handle_, ptr[g], network_wgrad_size_, g);
   }
   ar_comm->register_coll_buf(ar_handle_);
+  if (compression_ != WgradCompression_t::Disabled) {
+    init_compression_(ptr);
+  }
 }
 template <typename T>
 void NetworkExchangeWgrad<T>::allocate() {
@@ -60,10 +81,53 @@ void NetworkExchangeWgrad<T>::allocate() {
   }
 
   auto ar_comm = resource_manager_->get_ar_comm();
+  std::vector<void*> ptr(num_gpus_);
   for (size_t g = 0; g < num_gpus_; g++) {
-    ar_comm->set_coll_buf(ar_handle_, bufs_[g]->get_ptr(), network_wgrad_size_, g);
+    ptr[g] = bufs_[g]->get_ptr();
+    ar_comm->set_coll_buf(ar_handle_, ptr[g], network_wgrad_size_, g);
   }
   ar_comm->register_coll_buf(ar_handle_);
+  if (compression_ != WgradCompression_t::Disabled) {
+    init_compression_(ptr);
+  }
+}
+
+template <typename T>
+void NetworkExchangeWgrad<T>::init_compression_(const std::vector<void*>& ptr) {
+  wgrad_ptrs_ = ptr;
+  const size_t num_elements = network_wgrad_size_ / sizeof(float);
+  compression_bufs_.resize(num_gpus_);
+  compressed_wgrads_.resize(num_gpus_);
+  wgrad_residuals_.resize(num_gpus_);
+  for (size_t g = 0; g < num_gpus_; g++) {
+    auto& gpu_resource = resource_manager_->get_local_gpu(g);
+    CudaDeviceContext context(gpu_resource->get_device_id());
+    compression_bufs_[g] = GeneralBuffer2<CudaAllocator>::create();
+    compression_bufs_[g]->reserve({num_elements}, &compressed_wgrads_[g]);
+    compression_bufs_[g]->reserve({num_elements}, &wgrad_residuals_[g]);
+    compression_bufs_[g]->allocate();
+    HCTR_LIB_THROW(cudaMemset(wgrad_residuals_[g].get_ptr(), 0,
+                              wgrad_residuals_[g].get_size_in_bytes()));
+  }
+}
+
+template <typename T>
+void NetworkExchangeWgrad<T>::compressed_allreduce_(size_t offset, size_t size, size_t device_id,
+                                                    cudaStream_t stream) {
+  const auto& gpu_resource = resource_manager_->get_local_gpu(device_id);
+  const size_t begin = offset / sizeof(float);
+  const size_t count = size / sizeof(float);
+  float* wgrad = static_cast<float*>(wgrad_ptrs_[device_id]) + begin;
+  __half* compressed = compressed_wgrads_[device_id].get_ptr() + begin;
+  float* residual = wgrad_residuals_[device_id].get_ptr() + begin;
+  const bool bf16 = compression_ == WgradCompression_t::BF16;
+
+  constexpr size_t block = 256;
+  const size_t grid = std::min((count + block - 1) / block, gpu_resource->get_sm_count() * 8);
+  compress_wgrad_gpu(grid, block, compressed, residual, wgrad, count, bf16, stream);
+  HCTR_LIB_THROW(ncclAllReduce(compressed, compressed, count, bf16 ? ncclBfloat16 : ncclHalf,
+                               ncclSum, gpu_resource->get_nccl(), stream));
+  decompress_wgrad_gpu(grid, block, wgrad, compressed, count, bf16, stream);
 }
 
 template <typename T>
@@ -73,10 +137,94 @@ void NetworkExchangeWgrad<T>::update_embed_wgrad_size(size_t size) {
 
 template <typename T>
 void NetworkExchangeWgrad<T>::allreduce(size_t device_id, cudaStream_t stream) {
+  TraceRange range(TraceCategory::Communication, "exchange_wgrad");
+  if (!buckets_.empty()) {
+    // Already reduced by allreduce_bucket() during backward.
+    return;
+  }
+  if (compression_ != WgradCompression_t::Disabled) {
+    compressed_allreduce_(0, network_wgrad_size_, device_id, stream);
+    return;
+  }
+  if (shard_num_elements_ > 0) {
+    reduce_scatter_(device_id, stream);
+    return;
+  }
   auto ar_comm = resource_manager_->get_ar_comm();
   ar_comm->all_reduce(ar_handle_, stream, device_id);
 }
 
+template <typename T>
+void NetworkExchangeWgrad<T>::reduce_scatter_(size_t device_id, cudaStream_t stream) {
+  const auto& gpu_resource = resource_manager_->get_local_gpu(device_id);
+  const size_t num_ranks = resource_manager_->get_global_gpu_count();
+  const size_t count = shard_num_elements_ / num_ranks;
+  const size_t rest = shard_num_elements_ - count * num_ranks;
+  const ncclDataType_t data_type = std::is_same_v<T, __half> ? ncclHalf : ncclFloat;
+  T* wgrad = static_cast<T*>(ar_ptrs_[device_id]);
+
+  HCTR_LIB_THROW(ncclGroupStart());
+  if (count > 0) {
+    T* shard = wgrad + gpu_resource->get_global_id() * count;
+    HCTR_LIB_THROW(ncclReduceScatter(wgrad, shard, count, data_type, ncclSum,
+                                     gpu_resource->get_nccl(), stream));
+  }
+  if (rest > 0) {
+    // The rest, which doesn't divide among all GPUs, belongs to the last one.
+    T* rest_wgrad = wgrad + count * num_ranks;
+    HCTR_LIB_THROW(ncclReduce(rest_wgrad, rest_wgrad, rest, data_type, ncclSum, num_ranks - 1,
+                              gpu_resource->get_nccl(), stream));
+  }
+  HCTR_LIB_THROW(ncclGroupEnd());
+}
+
+template <typename T>
+bool NetworkExchangeWgrad<T>::init_buckets(const std::vector<std::pair<size_t, size_t>>& buckets) {
+  // Only the buffer of init_ar_comm() is bucketed, not the one of allocate().
+  if (ar_ptrs_.empty() || buckets.empty() || shard_num_elements_ > 0) {
+    return false;
+  }
+  buckets_ = buckets;
+  if (compression_ != WgradCompression_t::Disabled) {
+    // The compressed buckets are all reduced with NCCL directly.
+    return true;
+  }
+  auto ar_comm = resource_manager_->get_ar_comm();
+  for (const auto& [offset, size] : buckets) {
+    auto handle = ar_comm->register_coll();
+    for (size_t g = 0; g < num_gpus_; g++) {
+      ar_comm->set_coll_buf(handle, static_cast<char*>(ar_ptrs_[g]) + offset, size, g);
+    }
+    ar_comm->register_coll_buf(handle);
+    bucket_handles_.push_back(handle);
+  }
+  return true;
+}
+
+template <typename T>
+void NetworkExchangeWgrad<T>::allreduce_bucket(size_t bucket, size_t device_id,
+                                               cudaStream_t stream) {
+  TraceRange range(TraceCategory::Communication, "exchange_wgrad_bucket");
+  if (compression_ != WgradCompression_t::Disabled) {
+    const auto& [offset, size] = buckets_.at(bucket);
+    compressed_allreduce_(offset, size, device_id, stream);
+    return;
+  }
+  auto ar_comm = resource_manager_->get_ar_comm();
+  ar_comm->all_reduce(bucket_handles_.at(bucket), stream, device_id);
+}
+
+template <typename T>
+bool NetworkExchangeWgrad<T>::init_shards(size_t num_elements) {
+  // The compressed and the bucketed reductions reduce the whole buffer.
+  if (ar_ptrs_.empty() || compression_ != WgradCompression_t::Disabled || !buckets_.empty() ||
+      num_elements == 0 || num_elements * sizeof(T) > network_wgrad_size_) {
+    return false;
+  }
+  shard_num_elements_ = num_elements;
+  return true;
+}
+
 template <typename T>
 GroupedExchangeWgrad<T>::GroupedExchangeWgrad(
     const std::shared_ptr<ResourceManager>& resource_manager)
@@ -141,10 +289,30 @@ void GroupedExchangeWgrad<T>::update_embed_wgrad_size(size_t size) {
 
 template <typename T>
 void GroupedExchangeWgrad<T>::allreduce(size_t device_id, cudaStream_t stream) {
+  TraceRange range(TraceCategory::Communication, "exchange_wgrad");
   auto ar_comm = resource_manager_->get_ar_comm();
   ar_comm->all_reduce(ar_handle_, stream, device_id);
 }
 
+template <typename T>
+bool GroupedExchangeWgrad<T>::init_buckets(const std::vector<std::pair<size_t, size_t>>& buckets) {
+  // The embedding wgrad is reduced together with the network wgrad, so the reduction can't start
+  // before the embedding backward.
+  return false;
+}
+
+template <typename T>
+void GroupedExchangeWgrad<T>::allreduce_bucket(size_t bucket, size_t device_id,
+                                               cudaStream_t stream) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Grouped wgrad exchange can't reduce in buckets!");
+}
+
+template <typename T>
+bool GroupedExchangeWgrad<T>::init_shards(size_t num_elements) {
+  // The embedding wgrad is all reduced together with the network wgrad.
+  return false;
+}
+
 template class NetworkExchangeWgrad<__half>;
 template class NetworkExchangeWgrad<float>;
 template class GroupedExchangeWgrad<__half>;
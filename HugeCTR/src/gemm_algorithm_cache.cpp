@@ -0,0 +1,130 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cublasLt.h>
+#include <cuda_runtime.h>
+
+#include <common.hpp>
+#include <core23/logger.hpp>
+#include <cstdio>
+#include <fstream>
+#include <gemm_algorithm_cache.hpp>
+#include <sstream>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr char hex_digits[] = "0123456789abcdef";
+
+// Adds the entries of the file to entries that it doesn't hold yet. One entry per line: the key
+// and its value as hex digits.
+void read_entries(const std::string& file,
+                  std::unordered_map<std::string, std::string>& entries) {
+  std::ifstream in(file);
+  std::string line;
+  while (std::getline(in, line)) {
+    const size_t space = line.find(' ');
+    if (line.empty() || line[0] == '#' || space == std::string::npos ||
+        (line.size() - space - 1) % 2 != 0) {
+      continue;
+    }
+    std::string value((line.size() - space - 1) / 2, '\0');
+    for (size_t i = 0; i < value.size(); ++i) {
+      value[i] = static_cast<char>(std::stoi(line.substr(space + 1 + 2 * i, 2), nullptr, 16));
+    }
+    entries.emplace(line.substr(0, space), std::move(value));
+  }
+}
+
+}  // namespace
+
+GemmAlgorithmCache& GemmAlgorithmCache::get() {
+  static GemmAlgorithmCache cache;
+  return cache;
+}
+
+void GemmAlgorithmCache::set_file(const std::string& file) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file == file_) {
+    return;
+  }
+  file_ = file;
+  read_entries(file_, entries_);
+  HCTR_LOG_S(INFO, ROOT) << entries_.size() << " GEMM algorithms are cached after reading "
+                         << file_ << std::endl;
+}
+
+void GemmAlgorithmCache::save() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (file_.empty() || !modified_) {
+    return;
+  }
+  // Keep the entries that other processes have written in the meantime.
+  read_entries(file_, entries_);
+
+  const std::string tmp_file = file_ + ".tmp";
+  std::ofstream out(tmp_file, std::ofstream::trunc);
+  out << "# HugeCTR GEMM algorithm cache" << std::endl;
+  for (const auto& [key, value] : entries_) {
+    out << key << ' ';
+    for (const char c : value) {
+      out << hex_digits[(c >> 4) & 0xf] << hex_digits[c & 0xf];
+    }
+    out << std::endl;
+  }
+  out.close();
+  if (!out || std::rename(tmp_file.c_str(), file_.c_str()) != 0) {
+    HCTR_LOG_S(WARNING, ROOT) << "Cannot write the GEMM algorithm cache " << file_ << std::endl;
+    return;
+  }
+  modified_ = false;
+}
+
+std::string GemmAlgorithmCache::make_key(const std::string& gemm,
+                                         const std::vector<int64_t>& params) {
+  int device = 0;
+  int cc_major = 0;
+  int cc_minor = 0;
+  HCTR_LIB_THROW(cudaGetDevice(&device));
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&cc_major, cudaDevAttrComputeCapabilityMajor, device));
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&cc_minor, cudaDevAttrComputeCapabilityMinor, device));
+
+  std::ostringstream key;
+  key << "sm" << cc_major << cc_minor << "_cublasLt" << cublasLtGetVersion() << '_' << gemm;
+  for (const int64_t param : params) {
+    key << '_' << param;
+  }
+  return key.str();
+}
+
+bool GemmAlgorithmCache::find_(const std::string& key, std::string* value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  *value = it->second;
+  return true;
+}
+
+void GemmAlgorithmCache::insert_(const std::string& key, std::string&& value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[key] = std::move(value);
+  modified_ = true;
+}
+
+}  // namespace HugeCTR
@@ -18,6 +18,7 @@
 
 #include <hashtable/cudf/concurrent_unordered_map.cuh>
 #include <hashtable/nv_hashtable.hpp>
+#include <hashtable/static_map.cuh>
 
 namespace HugeCTR {
 
@@ -162,6 +163,142 @@ __global__ void dump_kernel(KeyType* d_key, ValType* d_val, const Table* table,
   }
 }
 
+namespace cg = cooperative_groups;
+
+// Index of the key that the tile of static_map::tile_size threads of the thread looks up.
+__device__ __forceinline__ size_t get_static_map_key_index() {
+  return (static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x) / static_map::tile_size;
+}
+
+template <typename KeyType, typename ValType>
+__global__ void static_map_insert_kernel(static_map::StaticMapView<KeyType, ValType> map,
+                                         const KeyType* const keys, const ValType* const vals,
+                                         size_t len) {
+  const auto tile = cg::tiled_partition<static_map::tile_size>(cg::this_thread_block());
+  const size_t i = get_static_map_key_index();
+  if (i < len) {
+    const ValType val = vals[i];
+    const ValType it = map.insert(tile, keys[i], [=] { return val; }, true);
+    assert(it != static_map::Slot<KeyType, ValType>::empty_value &&
+           "error: insert fails: table is full");
+  }
+}
+
+template <typename KeyType, typename ValType>
+__global__ void static_map_search_kernel(const static_map::StaticMapView<KeyType, ValType> map,
+                                         const KeyType* const keys, ValType* const vals,
+                                         size_t len) {
+  const auto tile = cg::tiled_partition<static_map::tile_size>(cg::this_thread_block());
+  const size_t i = get_static_map_key_index();
+  if (i < len) {
+    const ValType val = map.find(tile, keys[i]);
+    assert(val != static_map::Slot<KeyType, ValType>::empty_value && "error: can't find key");
+    if (tile.thread_rank() == 0) {
+      vals[i] = val;
+    }
+  }
+}
+
+template <typename KeyType, typename ValType>
+__global__ void static_map_get_insert_kernel(static_map::StaticMapView<KeyType, ValType> map,
+                                             const KeyType* const keys, ValType* const vals,
+                                             size_t len, size_t* d_counter) {
+  const auto tile = cg::tiled_partition<static_map::tile_size>(cg::this_thread_block());
+  const size_t i = get_static_map_key_index();
+  if (i < len) {
+    const ValType val = map.insert(
+        tile, keys[i],
+        [=] {
+          return static_cast<ValType>(
+              atomicAdd(reinterpret_cast<unsigned long long*>(d_counter), 1ull));
+        },
+        false);
+    assert(val != static_map::Slot<KeyType, ValType>::empty_value &&
+           "error: get_insert fails: table is full");
+    if (tile.thread_rank() == 0) {
+      vals[i] = val;
+    }
+  }
+}
+
+template <typename KeyType, typename ValType>
+__global__ void static_map_get_mark_kernel(const static_map::StaticMapView<KeyType, ValType> map,
+                                           const KeyType* const keys, ValType* const vals,
+                                           size_t len) {
+  const auto tile = cg::tiled_partition<static_map::tile_size>(cg::this_thread_block());
+  const size_t i = get_static_map_key_index();
+  if (i < len) {
+    // A missing key has the empty value, which is the marker.
+    const ValType val = map.find(tile, keys[i]);
+    if (tile.thread_rank() == 0) {
+      vals[i] = val;
+    }
+  }
+}
+
+template <typename KeyType, typename ValType>
+__global__ void static_map_size_kernel(const static_map::StaticMapView<KeyType, ValType> map,
+                                       const size_t num_slots, size_t* container_size) {
+  using Slot = static_map::Slot<KeyType, ValType>;
+  __shared__ unsigned int block_acc;
+
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (threadIdx.x == 0) {
+    block_acc = 0;
+  }
+  __syncthreads();
+
+  if (i < num_slots && Slot::load(map.slots + i).first != Slot::empty_key) {
+    atomicAdd(&block_acc, 1u);
+  }
+  __syncthreads();
+
+  if (threadIdx.x == 0) {
+    atomicAdd(reinterpret_cast<unsigned long long*>(container_size),
+              static_cast<unsigned long long>(block_acc));
+  }
+}
+
+template <typename KeyType, typename ValType>
+__global__ void static_map_dump_kernel(KeyType* d_key, ValType* d_val,
+                                       const static_map::StaticMapView<KeyType, ValType> map,
+                                       const size_t num_slots, size_t* d_dump_counter) {
+  using Slot = static_map::Slot<KeyType, ValType>;
+  extern __shared__ unsigned char s[];
+  KeyType* block_result_key = reinterpret_cast<KeyType*>(s);
+  ValType* block_result_val = reinterpret_cast<ValType*>(block_result_key + blockDim.x);
+  __shared__ unsigned int block_acc;
+  __shared__ size_t global_acc;
+
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (threadIdx.x == 0) {
+    block_acc = 0;
+  }
+  __syncthreads();
+
+  // The occupied slots of the block are gathered in shared memory, and then stored together.
+  if (i < num_slots) {
+    const auto kv = Slot::load(map.slots + i);
+    if (kv.first != Slot::empty_key) {
+      const unsigned int local_index = atomicAdd(&block_acc, 1u);
+      block_result_key[local_index] = kv.first;
+      block_result_val[local_index] = kv.second;
+    }
+  }
+  __syncthreads();
+
+  if (threadIdx.x == 0) {
+    global_acc = atomicAdd(reinterpret_cast<unsigned long long*>(d_dump_counter),
+                           static_cast<unsigned long long>(block_acc));
+  }
+  __syncthreads();
+
+  if (threadIdx.x < block_acc) {
+    d_key[global_acc + threadIdx.x] = block_result_key[threadIdx.x];
+    d_val[global_acc + threadIdx.x] = block_result_val[threadIdx.x];
+  }
+}
+
 }  // namespace
 
 template <typename KeyType, typename ValType>
@@ -174,9 +311,18 @@ class HashTableContainer
 };
 
 template <typename KeyType, typename ValType>
-HashTable<KeyType, ValType>::HashTable(size_t capacity, size_t count) : capacity_(capacity) {
-  container_ =
-      new HashTableContainer<KeyType, ValType>(static_cast<size_t>(capacity / LOAD_FACTOR));
+HashTable<KeyType, ValType>::HashTable(size_t capacity, size_t count, HashTableBackend backend)
+    : capacity_(capacity), container_(nullptr), static_map_(nullptr) {
+  if (backend == HashTableBackend::StaticMap) {
+    HCTR_CHECK_HINT(capacity <= static_map::Slot<KeyType, ValType>::max_num_values,
+                    "The capacity of the StaticMap hash table must not exceed ",
+                    static_map::Slot<KeyType, ValType>::max_num_values, ": ", capacity);
+    static_map_ = new static_map::StaticMap<KeyType, ValType>(
+        static_cast<size_t>(capacity / LOAD_FACTOR));
+  } else {
+    container_ =
+        new HashTableContainer<KeyType, ValType>(static_cast<size_t>(capacity / LOAD_FACTOR));
+  }
 
   // Allocate device-side counter and copy user input to it
   HCTR_LIB_THROW(cudaMalloc((void**)&d_counter_, sizeof(size_t)));
@@ -188,6 +334,7 @@ template <typename KeyType, typename ValType>
 HashTable<KeyType, ValType>::~HashTable() {
   try {
     delete container_;
+    delete static_map_;
     // De-allocate device-side counter
     HCTR_LIB_THROW(cudaFree(d_counter_));
     HCTR_LIB_THROW(cudaFree(d_container_size_));
@@ -202,6 +349,12 @@ void HashTable<KeyType, ValType>::insert(const KeyType* d_keys, const ValType* d
   if (len == 0) {
     return;
   }
+  if (static_map_) {
+    const int grid_size = (len * static_map::tile_size - 1) / BLOCK_SIZE_ + 1;
+    static_map_insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(static_map_->view(), d_keys,
+                                                                    d_vals, len);
+    return;
+  }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
   insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(container_, d_keys, d_vals, len);
 }
@@ -212,6 +365,12 @@ void HashTable<KeyType, ValType>::get_insert(const KeyType* d_keys, ValType* d_v
   if (len == 0) {
     return;
   }
+  if (static_map_) {
+    const int grid_size = (len * static_map::tile_size - 1) / BLOCK_SIZE_ + 1;
+    static_map_get_insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        static_map_->view(), d_keys, d_vals, len, d_counter_);
+    return;
+  }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
   get_insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(container_, d_keys, d_vals, len,
                                                            d_counter_);
@@ -223,6 +382,12 @@ void HashTable<KeyType, ValType>::get_mark(const KeyType* d_keys, ValType* d_val
   if (len == 0) {
     return;
   }
+  if (static_map_) {
+    const int grid_size = (len * static_map::tile_size - 1) / BLOCK_SIZE_ + 1;
+    static_map_get_mark_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(static_map_->view(), d_keys,
+                                                                      d_vals, len);
+    return;
+  }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
   get_mark_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(container_, d_keys, d_vals, len);
 }
@@ -233,6 +398,12 @@ void HashTable<KeyType, ValType>::get(const KeyType* d_keys, ValType* d_vals, si
   if (len == 0) {
     return;
   }
+  if (static_map_) {
+    const int grid_size = (len * static_map::tile_size - 1) / BLOCK_SIZE_ + 1;
+    static_map_search_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(static_map_->view(), d_keys,
+                                                                    d_vals, len);
+    return;
+  }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
   search_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(container_, d_keys, d_vals, len);
 }
@@ -242,14 +413,19 @@ size_t HashTable<KeyType, ValType>::get_size(cudaStream_t stream) const {
   /* size variable on Host and device, total capacity of the hashtable */
   size_t container_size;
 
-  const size_t hash_capacity = container_->size();
+  const size_t hash_capacity = get_capacity();
 
   /* grid_size and allocating/initializing variable on dev, launching kernel*/
   const int grid_size = (hash_capacity - 1) / BLOCK_SIZE_ + 1;
 
   HCTR_LIB_THROW(cudaMemsetAsync(d_container_size_, 0, sizeof(size_t), stream));
-  size_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(container_, hash_capacity, d_container_size_,
-                                                     empty_key);
+  if (static_map_) {
+    static_map_size_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+        static_map_->view(), hash_capacity, d_container_size_);
+  } else {
+    size_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(container_, hash_capacity,
+                                                       d_container_size_, empty_key);
+  }
   HCTR_LIB_THROW(cudaMemcpyAsync(&container_size, d_container_size_, sizeof(size_t),
                                  cudaMemcpyDeviceToHost, stream));
   HCTR_LIB_THROW(cudaStreamSynchronize(stream));
@@ -269,7 +445,8 @@ size_t HashTable<KeyType, ValType>::get_value_head(cudaStream_t stream) const {
 template <typename KeyType, typename ValType>
 void HashTable<KeyType, ValType>::dump(KeyType* d_key, ValType* d_val, size_t* d_dump_counter,
                                        cudaStream_t stream) const {
-  size_t search_length = static_cast<size_t>(capacity_ / LOAD_FACTOR);
+  size_t search_length =
+      static_map_ ? static_map_->num_slots() : static_cast<size_t>(capacity_ / LOAD_FACTOR);
   // Before we call the kernel, set the global counter to 0
   HCTR_LIB_THROW(cudaMemset(d_dump_counter, 0, sizeof(size_t)));
   // grid size according to the searching length.
@@ -277,28 +454,33 @@ void HashTable<KeyType, ValType>::dump(KeyType* d_key, ValType* d_val, size_t* d
   // dump_kernel: dump bucket container_[0, search_length) to d_key and d_val, and report
   // how many buckets are dumped in d_dump_counter.
   size_t shared_size = sizeof(*d_key) * BLOCK_SIZE_ + sizeof(*d_val) * BLOCK_SIZE_;
-  dump_kernel<<<grid_size, BLOCK_SIZE_, shared_size, stream>>>(
-      d_key, d_val, container_, 0, search_length, d_dump_counter, empty_key);
+  if (static_map_) {
+    static_map_dump_kernel<<<grid_size, BLOCK_SIZE_, shared_size, stream>>>(
+        d_key, d_val, static_map_->view(), search_length, d_dump_counter);
+  } else {
+    dump_kernel<<<grid_size, BLOCK_SIZE_, shared_size, stream>>>(
+        d_key, d_val, container_, 0, search_length, d_dump_counter, empty_key);
+  }
 }
 
 template <typename KeyType, typename ValType>
 void HashTable<KeyType, ValType>::set(const KeyType* d_keys, const ValType* d_vals, size_t len,
                                       cudaStream_t stream) {
-  if (len == 0) {
-    return;
-  }
-  const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
-  insert_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(container_, d_keys, d_vals, len);
+  insert(d_keys, d_vals, len, stream);
 }
 
 template <typename KeyType, typename ValType>
 size_t HashTable<KeyType, ValType>::get_capacity() const {
-  return (container_->size());
+  return static_map_ ? static_map_->num_slots() : container_->size();
 }
 
 template <typename KeyType, typename ValType>
 void HashTable<KeyType, ValType>::clear(cudaStream_t stream) {
-  container_->clear_async(stream);
+  if (static_map_) {
+    static_map_->clear(stream);
+  } else {
+    container_->clear_async(stream);
+  }
   set_value_head(0, stream);
 }
 
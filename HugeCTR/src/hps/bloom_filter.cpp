@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <hps/bloom_filter.hpp>
+#include <hps/database_backend_detail.hpp>
+
+namespace HugeCTR {
+
+// TODO: Remove me!
+#pragma GCC diagnostic push
+#pragma GCC diagnostic error "-Wconversion"
+
+static constexpr uint32_t bloom_filter_max_num_probes{16};
+
+BloomFilter::BloomFilter(const size_t capacity, const size_t bits_per_key)
+    : num_blocks_{std::max((capacity * bits_per_key + 511) / 512, static_cast<size_t>(1))},
+      // Optimal number of probes is (bits / keys) * ln(2).
+      num_probes_{std::clamp(
+          static_cast<uint32_t>(std::lround(static_cast<double>(bits_per_key) * std::log(2.0))),
+          static_cast<uint32_t>(1), bloom_filter_max_num_probes)},
+      words_(num_blocks_ * words_per_block) {}
+
+// The block is chosen using the upper bits of the hash. Probes within the block are derived from
+// the lower bits by double hashing.
+size_t BloomFilter::block_index_(const uint64_t h) const {
+  return static_cast<size_t>(
+      (static_cast<unsigned __int128>(h) * static_cast<unsigned __int128>(num_blocks_)) >> 64);
+}
+
+void BloomFilter::insert(const uint64_t key) {
+  const uint64_t h{rrxmrrxmsx_0(key)};
+  std::atomic<uint64_t>* const block{&words_[block_index_(h) * words_per_block]};
+
+  uint32_t probe{static_cast<uint32_t>(h)};
+  const uint32_t step{static_cast<uint32_t>(h >> 32) | 1};
+  for (uint32_t i{0}; i != num_probes_; ++i, probe += step) {
+    block[(probe >> 6) % words_per_block].fetch_or(UINT64_C(1) << (probe & 63),
+                                                   std::memory_order_relaxed);
+  }
+}
+
+bool BloomFilter::may_contain(const uint64_t key) const {
+  const uint64_t h{rrxmrrxmsx_0(key)};
+  const std::atomic<uint64_t>* const block{&words_[block_index_(h) * words_per_block]};
+
+  uint32_t probe{static_cast<uint32_t>(h)};
+  const uint32_t step{static_cast<uint32_t>(h >> 32) | 1};
+  for (uint32_t i{0}; i != num_probes_; ++i, probe += step) {
+    if (!(block[(probe >> 6) % words_per_block].load(std::memory_order_relaxed) &
+          (UINT64_C(1) << (probe & 63)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// TODO: Remove me!
+#pragma GCC diagnostic pop
+
+}  // namespace HugeCTR
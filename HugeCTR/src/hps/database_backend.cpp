@@ -20,6 +20,7 @@
 #include <fstream>
 #include <hps/database_backend.hpp>
 #include <hps/database_backend_detail.hpp>
+#include <memory>
 #include <sstream>
 
 // TODO: Remove me!
@@ -61,6 +62,54 @@ size_t DatabaseBackendBase<Key>::fetch(const std::string& table_name, size_t num
   return 0;
 }
 
+template <typename Key>
+std::future<size_t> DatabaseBackendBase<Key>::fetch_async(
+    const std::string& table_name, const size_t num_keys, const Key* const keys,
+    char* const values, const size_t value_stride, const DatabaseMissCallback& on_miss,
+    const std::chrono::nanoseconds& time_budget) {
+  return submit_fetch_([=, &on_miss]() {
+    return fetch(table_name, num_keys, keys, values, value_stride, on_miss, time_budget);
+  });
+}
+
+template <typename Key>
+std::future<size_t> DatabaseBackendBase<Key>::fetch_async(
+    const std::string& table_name, const size_t num_indices, const size_t* const indices,
+    const Key* const keys, char* const values, const size_t value_stride,
+    const DatabaseMissCallback& on_miss, const std::chrono::nanoseconds& time_budget) {
+  return submit_fetch_([=, &on_miss]() {
+    return fetch(table_name, num_indices, indices, keys, values, value_stride, on_miss,
+                 time_budget);
+  });
+}
+
+template <typename Key>
+std::future<size_t> DatabaseBackendBase<Key>::submit_fetch_(std::function<size_t()> task) {
+  // Separate from the default pool, because many backends use the default pool to parallelize
+  // `fetch` internally. Waiting for these tasks from within the default pool could deadlock.
+  static ThreadPool workers{"db async fetch"};
+
+  auto package{std::make_shared<std::packaged_task<size_t()>>(std::move(task))};
+  std::future<size_t> result{package->get_future()};
+  workers.submit([package]() { (*package)(); });
+  return result;
+}
+
+template <typename Key>
+std::future<size_t> DatabaseBackendBase<Key>::join_fetches_(
+    std::vector<std::future<size_t>>&& parts) {
+  return std::async(std::launch::deferred, [parts{std::move(parts)}]() mutable {
+    for (std::future<size_t>& part : parts) {
+      part.wait();
+    }
+    size_t hit_count{0};
+    for (std::future<size_t>& part : parts) {
+      hit_count += part.get();
+    }
+    return hit_count;
+  });
+}
+
 template <typename Key>
 size_t DatabaseBackendBase<Key>::evict(const std::vector<std::string>& table_names) {
   size_t n{0};
@@ -256,9 +305,31 @@ size_t DatabaseBackendBase<Key>::load_dump_sst(const std::string& table_name,
   return hit_count;
 }
 
+template <typename Key>
+size_t DatabaseBackendBase<Key>::load_dump_sst(const std::string& table_name,
+                                               const std::vector<std::string>& paths) {
+  size_t hit_count{0};
+  for (const std::string& path : paths) {
+    hit_count += load_dump_sst(table_name, path);
+  }
+  return hit_count;
+}
+
 template class DatabaseBackendBase<unsigned int>;
 template class DatabaseBackendBase<long long>;
 
+size_t VolatileBackendParams::table_overflow_margin(const std::string& table_name) const {
+  // Strip name components until we find an override.
+  for (size_t n{table_name.size()}; n != std::string::npos && n;
+       n = table_name.rfind('.', n - 1)) {
+    const auto it{table_overflow_margins.find(table_name.substr(0, n))};
+    if (it != table_overflow_margins.end()) {
+      return it->second;
+    }
+  }
+  return overflow_margin;
+}
+
 DatabaseBackendError::DatabaseBackendError(const std::string& backend, const size_t partition,
                                            const std::string& what)
     : backend_{backend}, partition_{partition}, what_{what} {}
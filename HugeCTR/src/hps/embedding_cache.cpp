@@ -15,7 +15,12 @@
  */
 
 #include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <hps/embedding_cache.hpp>
+#include <hps/embedding_cache_hybrid.hpp>
 #include <hps/embedding_cache_stoch.hpp>
 #include <hps/hier_parameter_server.hpp>
 #include <hps/memory_pool.hpp>
@@ -24,11 +29,29 @@
 #include <io/filesystem.hpp>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <thread>
 #include <utils.hpp>
 
 namespace HugeCTR {
 
+namespace {
+
+constexpr uint32_t shared_cache_file_magic{0x48534543};  // "HSEC"
+
+// Content of the file through which the owner of a shared GPU embedding cache publishes it.
+struct SharedCacheFileHeader {
+  uint32_t magic;
+  uint32_t key_size;
+  uint32_t value_size;
+  uint32_t reserved;
+  uint64_t num_set;
+  uint64_t embedding_vec_size;
+  cudaIpcMemHandle_t handle;
+};
+
+}  // namespace
+
 template <typename TypeHashKey>
 static void parameter_server_insert_thread_func_(
     const size_t table_id, HierParameterServerBase* const parameter_server,
@@ -57,9 +80,39 @@ static void parameter_server_insert_thread_func_(
   }
 }
 
+// Inserts the missing keys of several tables that share the same memory_block.
+template <typename TypeHashKey>
+static void parameter_server_insert_thread_func_(
+    const std::vector<size_t>& table_ids, HierParameterServerBase* const parameter_server,
+    std::shared_ptr<EmbeddingCacheBase> embedding_cache, MemoryBlock* const memory_block,
+    const std::vector<cudaStream_t>& streams, std::mutex& stream_mutex) {
+  try {
+    std::lock_guard<std::mutex> lock(stream_mutex);
+    // Set the device context
+    CudaDeviceContext dev_restorer{embedding_cache->get_device_id()};
+    // Insert data.
+    for (const size_t table_id : table_ids) {
+      parameter_server->insert_embedding_cache(table_id, embedding_cache,
+                                               memory_block->worker_buffer, streams[table_id]);
+    }
+    // Await completion.
+    for (const size_t table_id : table_ids) {
+      HCTR_LIB_THROW(cudaStreamSynchronize(streams[table_id]));
+    }
+    // Cleanup.
+    parameter_server->free_buffer(memory_block);
+  } catch (const std::runtime_error& rt_err) {
+    parameter_server->free_buffer(memory_block);
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+  }
+}
+
 std::shared_ptr<EmbeddingCacheBase> EmbeddingCacheBase::create(
     const InferenceParams& inference_params, const parameter_server_config& ps_config,
     HierParameterServerBase* const parameter_server) {
+  HCTR_CHECK_HINT(!inference_params.fp8_output ||
+                      inference_params.embedding_cache_type == EmbeddingCacheType_t::Static,
+                  "fp8_output is only supported by the static embedding cache");
   if (inference_params.embedding_cache_type == EmbeddingCacheType_t::Static) {
     if (inference_params.i64_input_key) {
       if (inference_params.fp8_quant) {
@@ -93,6 +146,15 @@ std::shared_ptr<EmbeddingCacheBase> EmbeddingCacheBase::create(
       return std::make_shared<UvmTable<unsigned int>>(inference_params, ps_config,
                                                       parameter_server);
     }
+  } else if (inference_params.embedding_cache_type == EmbeddingCacheType_t::Hybrid &&
+             inference_params.use_gpu_embedding_cache) {
+    if (inference_params.i64_input_key) {
+      return std::make_shared<HybridEmbeddingCache<long long>>(inference_params, ps_config,
+                                                               parameter_server);
+    } else {
+      return std::make_shared<HybridEmbeddingCache<unsigned int>>(inference_params, ps_config,
+                                                                  parameter_server);
+    }
   } else if (inference_params.embedding_cache_type == EmbeddingCacheType_t::Stochastic) {
     if (inference_params.i64_input_key) {
       return std::make_shared<EmbeddingCacheStoch<long long>>(inference_params, ps_config,
@@ -114,6 +176,48 @@ std::shared_ptr<EmbeddingCacheBase> EmbeddingCacheBase::create(
 
 EmbeddingCacheBase::~EmbeddingCacheBase() = default;
 
+void EmbeddingCacheBase::rebalance_capacity(cudaStream_t stream) {}
+
+void EmbeddingCacheBase::lookup_from_device_grouped(
+    const std::vector<const void*>& d_keys_per_table,
+    const std::vector<float*>& d_vectors_per_table, const std::vector<size_t>& num_keys_per_table,
+    const float hit_rate_threshold, cudaStream_t stream) {
+  for (size_t table_id{0}; table_id < d_keys_per_table.size(); ++table_id) {
+    lookup_from_device(table_id, d_vectors_per_table[table_id], d_keys_per_table[table_id],
+                       num_keys_per_table[table_id], hit_rate_threshold, stream);
+  }
+}
+
+void EmbeddingCacheBase::lookup_from_device_pooled(const size_t table_id,
+                                                   float* const d_pooled_vectors,
+                                                   const void* const d_keys, const size_t num_keys,
+                                                   const PoolingRows& rows,
+                                                   const float hit_rate_threshold,
+                                                   cudaStream_t stream) {
+  const size_t emb_vec_size = get_cache_config().embedding_vec_size_[table_id];
+  float* d_vectors;
+  HCTR_LIB_THROW(cudaMallocAsync(reinterpret_cast<void**>(&d_vectors),
+                                 std::max<size_t>(num_keys, 1) * emb_vec_size * sizeof(float),
+                                 stream));
+  lookup_from_device(table_id, d_vectors, d_keys, num_keys, hit_rate_threshold, stream);
+  pool_emb_vec_async(d_vectors, nullptr, rows.d_row_offsets, rows.num_rows, emb_vec_size,
+                     rows.combiner == PoolingCombiner_t::Mean, d_pooled_vectors, 64, stream);
+  HCTR_LIB_THROW(cudaFreeAsync(d_vectors, stream));
+}
+
+static size_t nv_cache_element_size(const DatabaseValueEncoding_t encoding) {
+  switch (encoding) {
+    case DatabaseValueEncoding_t::Float16:
+      return sizeof(__half);
+    case DatabaseValueEncoding_t::BFloat16:
+      return sizeof(__nv_bfloat16);
+    case DatabaseValueEncoding_t::Float8:
+      return sizeof(__nv_fp8_e4m3);
+    default:
+      return sizeof(float);
+  }
+}
+
 template <typename TypeHashKey>
 EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_params,
                                             const parameter_server_config& ps_config,
@@ -135,9 +239,43 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
       inference_params.cache_refresh_percentage_per_iteration;
   cache_config_.default_value_for_each_table = inference_params.default_value_for_each_table;
   cache_config_.model_name_ = inference_params.model_name;
+  for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+    LookupMetrics& metrics{LookupMetrics::instance()};
+    query_latency_.emplace_back(
+        &metrics.histogram(cache_config_.model_name_, i, LookupStage_t::CacheQuery));
+    compaction_latency_.emplace_back(
+        &metrics.histogram(cache_config_.model_name_, i, LookupStage_t::MissCompaction));
+    workspace_wait_latency_.emplace_back(
+        &metrics.histogram(cache_config_.model_name_, i, LookupStage_t::WorkspaceWait));
+  }
   cache_config_.cuda_dev_id_ = inference_params.device_id;
   cache_config_.use_gpu_embedding_cache_ = inference_params.use_gpu_embedding_cache;
   cache_config_.use_hctr_cache_implementation = inference_params.use_hctr_cache_implementation;
+  cache_config_.value_encoding_ = inference_params.use_hctr_cache_implementation
+                                      ? inference_params.embedding_cache_value_encoding
+                                      : DatabaseValueEncoding_t::Raw;
+  cache_config_.stream_ordered_lookup_ = inference_params.stream_ordered_lookup;
+  cache_config_.use_cuda_graph_lookup_ =
+      inference_params.use_cuda_graph_lookup && !inference_params.stream_ordered_lookup;
+  // Misses of the dynamic cache are always resolved per unique key.
+  cache_config_.deduplicate_keys_ = true;
+  // Only the nv_gpu_cache implementation filters the keys to admit.
+  cache_config_.admission_threshold_ =
+      inference_params.use_hctr_cache_implementation
+          ? static_cast<uint32_t>(inference_params.embedding_cache_admission_threshold)
+          : 0;
+  cache_config_.adaptive_cache_sizing_ = inference_params.adaptive_cache_sizing;
+  cache_config_.lock_free_query_ =
+      inference_params.use_hctr_cache_implementation && inference_params.lock_free_cache_query;
+  cache_config_.shared_cache_dir_ = inference_params.shared_embedding_cache_dir;
+  cache_config_.shared_cache_owner_ = inference_params.shared_embedding_cache_owner;
+  if (!cache_config_.shared_cache_dir_.empty()) {
+    HCTR_THROW_IF(!inference_params.use_hctr_cache_implementation, Error_t::WrongInput,
+                  "Only the HugeCTR embedding cache implementation can be shared among processes");
+    HCTR_THROW_IF(inference_params.adaptive_cache_sizing, Error_t::WrongInput,
+                  "Embedding caches shared among processes cannot be resized, so they do not "
+                  "support adaptive_cache_sizing");
+  }
   auto b2s = [](const char val) { return val ? "True" : "False"; };
   HCTR_LOG(INFO, ROOT, "Model name: %s\n", inference_params.model_name.c_str());
   HCTR_LOG(INFO, ROOT, "Max batch size: %lu\n", inference_params.max_batchsize);
@@ -147,7 +285,17 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
            b2s(inference_params.use_gpu_embedding_cache), inference_params.cache_size_percentage);
   HCTR_LOG(INFO, ROOT, "Embedding cache type: %s\n",
            hctr_enum_to_c_str(inference_params.embedding_cache_type));
+  HCTR_LOG(INFO, ROOT, "Embedding cache value encoding: %s\n",
+           hctr_enum_to_c_str(cache_config_.value_encoding_));
   HCTR_LOG(INFO, ROOT, "Use I64 input key: %s\n", b2s(inference_params.i64_input_key));
+  HCTR_LOG(INFO, ROOT, "Stream-ordered lookup: %s\n", b2s(cache_config_.stream_ordered_lookup_));
+  HCTR_LOG(INFO, ROOT, "CUDA graph lookup: %s\n", b2s(cache_config_.use_cuda_graph_lookup_));
+  HCTR_LOG(INFO, ROOT, "Embedding cache admission threshold: %u\n",
+           cache_config_.admission_threshold_);
+  HCTR_LOG(INFO, ROOT, "Adaptive cache sizing: %s\n", b2s(cache_config_.adaptive_cache_sizing_));
+  HCTR_LOG(INFO, ROOT, "Lock-free cache query: %s\n", b2s(cache_config_.lock_free_query_));
+  HCTR_LOG(INFO, ROOT, "Shared embedding cache directory: %s, owner: %s\n",
+           cache_config_.shared_cache_dir_.c_str(), b2s(cache_config_.shared_cache_owner_));
   HCTR_LOG(INFO, ROOT, "Configured cache hit rate threshold: %f\n",
            inference_params.hit_rate_threshold);
   HCTR_LOG(INFO, ROOT, "The size of thread pool: %u\n",
@@ -184,10 +332,19 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
   // Query the size of all embedding tables and calculate the size of each embedding cache
   if (cache_config_.use_gpu_embedding_cache_) {
     cache_config_.num_set_in_cache_.reserve(cache_config_.num_emb_table_);
+    max_num_set_in_cache_.reserve(cache_config_.num_emb_table_);
+    // The cache size percentage refers to float embeddings. Narrower value encodings fit
+    // proportionally more embeddings into the same amount of device memory.
+    const size_t encoding_ratio{sizeof(float) /
+                                nv_cache_element_size(cache_config_.value_encoding_)};
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
       const size_t row_num = ps_config.embedding_key_count_.at(inference_params.model_name)[i];
       size_t num_feature_in_cache = static_cast<size_t>(
           static_cast<double>(cache_config_.cache_size_percentage_) * static_cast<double>(row_num));
+      if (encoding_ratio > 1) {
+        num_feature_in_cache = std::min(num_feature_in_cache * encoding_ratio,
+                                        std::max(num_feature_in_cache, row_num));
+      }
       if (num_feature_in_cache < SLAB_SIZE * SET_ASSOCIATIVITY) {
         num_feature_in_cache = SLAB_SIZE * SET_ASSOCIATIVITY;
         HCTR_LOG(INFO, ROOT,
@@ -198,7 +355,12 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
       cache_config_.num_set_in_cache_.emplace_back(
           (num_feature_in_cache + SLAB_SIZE * SET_ASSOCIATIVITY - 1) /
           (SLAB_SIZE * SET_ASSOCIATIVITY));
+      max_num_set_in_cache_.emplace_back(
+          std::max((row_num + SLAB_SIZE * SET_ASSOCIATIVITY - 1) / (SLAB_SIZE * SET_ASSOCIATIVITY),
+                   cache_config_.num_set_in_cache_[i]));
     }
+    cache_generation_.resize(cache_config_.num_emb_table_, 0);
+    table_stats_ = std::make_unique<TableStats[]>(cache_config_.num_emb_table_);
   }
 
   // Construct gpu embedding cache, 1 per embedding table
@@ -210,13 +372,7 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
     // Allocate resources.
     gpu_emb_caches_.reserve(cache_config_.num_emb_table_);
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
-      if (cache_config_.use_hctr_cache_implementation) {
-        gpu_emb_caches_.emplace_back(std::make_unique<NVCache>(
-            cache_config_.num_set_in_cache_[i], cache_config_.embedding_vec_size_[i]));
-      } else {
-        gpu_emb_caches_.emplace_back(std::make_unique<EmbeddingCacheWrapper<TypeHashKey>>(
-            cache_config_.num_set_in_cache_[i], cache_config_.embedding_vec_size_[i]));
-      }
+      gpu_emb_caches_.emplace_back(create_gpu_cache_(i, cache_config_.num_set_in_cache_[i]));
     }
 
     insert_streams_.reserve(cache_config_.num_emb_table_);
@@ -235,6 +391,94 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
   }
 }
 
+template <typename TypeHashKey>
+std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>>
+EmbeddingCache<TypeHashKey>::create_gpu_cache_(const size_t table_id, const size_t num_set) {
+  const size_t vec_size{cache_config_.embedding_vec_size_[table_id]};
+  if (!cache_config_.use_hctr_cache_implementation) {
+    return std::make_unique<EmbeddingCacheWrapper<TypeHashKey>>(num_set, vec_size);
+  }
+
+  switch (cache_config_.value_encoding_) {
+    case DatabaseValueEncoding_t::Raw:
+      return create_nv_cache_<float>(table_id, num_set);
+    case DatabaseValueEncoding_t::Float16:
+      return create_nv_cache_<__half>(table_id, num_set);
+    case DatabaseValueEncoding_t::BFloat16:
+      return create_nv_cache_<__nv_bfloat16>(table_id, num_set);
+    case DatabaseValueEncoding_t::Float8:
+      return create_nv_cache_<__nv_fp8_e4m3>(table_id, num_set);
+    default:
+      break;
+  }
+  HCTR_DIE("Unsupported embedding cache value encoding!");
+  return nullptr;
+}
+
+template <typename TypeHashKey>
+template <typename value_type>
+std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>>
+EmbeddingCache<TypeHashKey>::create_nv_cache_(const size_t table_id, const size_t num_set) {
+  const size_t vec_size{cache_config_.embedding_vec_size_[table_id]};
+  const uint32_t threshold{cache_config_.admission_threshold_};
+  const bool lock_free{cache_config_.lock_free_query_};
+  if (cache_config_.shared_cache_dir_.empty()) {
+    return std::make_unique<NVCache<value_type>>(num_set, vec_size, threshold, lock_free);
+  }
+
+  // The file is named by the PCI bus ID, since processes may see the GPU under other ordinals.
+  char bus_id[32];
+  HCTR_LIB_THROW(cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), cache_config_.cuda_dev_id_));
+  const std::string path{(std::filesystem::path(cache_config_.shared_cache_dir_) /
+                          (cache_config_.model_name_ + "." + bus_id + "." +
+                           std::to_string(table_id) + ".ipc"))
+                             .string()};
+
+  if (cache_config_.shared_cache_owner_) {
+    auto cache{std::make_unique<NVCache<value_type>>(num_set, vec_size, threshold, lock_free)};
+    const SharedCacheFileHeader header{shared_cache_file_magic,
+                                       sizeof(TypeHashKey),
+                                       sizeof(value_type),
+                                       0,
+                                       num_set,
+                                       vec_size,
+                                       cache->GetIpcHandle()};
+    // Other processes may read the file at any time, so it is replaced atomically.
+    const std::string tmp_path{path + ".tmp"};
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (!out || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      HCTR_OWN_THROW(Error_t::FileCannotOpen,
+                     "Cannot write the shared embedding cache handle: " + path);
+    }
+    HCTR_LOG_S(INFO, ROOT) << "Shared the embedding cache of table " << table_id << " via " << path
+                           << std::endl;
+    return cache;
+  }
+
+  SharedCacheFileHeader header;
+  std::ifstream in(path, std::ios::binary);
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen,
+                   "Cannot read the shared embedding cache handle, the owner process must be "
+                   "started first: " +
+                       path);
+  }
+  HCTR_THROW_IF(header.magic != shared_cache_file_magic ||
+                    header.key_size != sizeof(TypeHashKey) ||
+                    header.value_size != sizeof(value_type) ||
+                    header.embedding_vec_size != vec_size,
+                Error_t::WrongInput, "The shared embedding cache ", path,
+                " does not match the key type, value encoding or embedding size of table ",
+                table_id);
+  // The capacity is the one of the owner, which may have used another cache_size_percentage.
+  cache_config_.num_set_in_cache_[table_id] = header.num_set;
+  return std::make_unique<NVCache<value_type>>(header.num_set, vec_size, header.handle,
+                                               lock_free);
+}
+
 template <typename TypeHashKey>
 EmbeddingCache<TypeHashKey>::~EmbeddingCache() {
   if (cache_config_.use_gpu_embedding_cache_) {
@@ -262,10 +506,12 @@ void EmbeddingCache<TypeHashKey>::lookup(size_t const table_id, float* const d_v
                                          float const hit_rate_threshold, cudaStream_t stream) {
   MemoryBlock* memory_block = nullptr;
   BaseUnit* start = profiler::start();
+  const auto wait_start{std::chrono::steady_clock::now()};
   while (memory_block == nullptr) {
     memory_block = reinterpret_cast<struct MemoryBlock*>(parameter_server_->apply_buffer(
         cache_config_.model_name_, cache_config_.cuda_dev_id_, CACHE_SPACE_TYPE::WORKER));
   }
+  workspace_wait_latency_[table_id]->observe_since(wait_start);
   ec_profiler_->end(start, "Apply for workspace from the memory pool for Embedding Cache Lookup");
   EmbeddingCacheWorkspace workspace_handler = memory_block->worker_buffer;
   if (cache_config_.use_gpu_embedding_cache_) {
@@ -308,10 +554,12 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
                                                      cudaStream_t stream) {
   MemoryBlock* memory_block = nullptr;
   BaseUnit* start = profiler::start();
+  const auto wait_start{std::chrono::steady_clock::now()};
   while (memory_block == nullptr) {
     memory_block = reinterpret_cast<struct MemoryBlock*>(parameter_server_->apply_buffer(
         cache_config_.model_name_, cache_config_.cuda_dev_id_, CACHE_SPACE_TYPE::WORKER));
   }
+  workspace_wait_latency_[table_id]->observe_since(wait_start);
   ec_profiler_->end(
       start, "Apply for workspace from the memory pool for Embedding Cache Lookup_from_device");
   EmbeddingCacheWorkspace workspace_handler = memory_block->worker_buffer;
@@ -346,17 +594,79 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
   }
 }
 
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::lookup_from_device_pooled(
+    const size_t table_id, float* const d_pooled_vectors, const void* const d_keys,
+    const size_t num_keys, const PoolingRows& rows, const float hit_rate_threshold,
+    cudaStream_t stream) {
+  // Without the GPU embedding cache, the parameter server returns one vector per key anyway.
+  if (!cache_config_.use_gpu_embedding_cache_) {
+    EmbeddingCacheBase::lookup_from_device_pooled(table_id, d_pooled_vectors, d_keys, num_keys,
+                                                  rows, hit_rate_threshold, stream);
+    return;
+  }
+  MemoryBlock* memory_block = nullptr;
+  BaseUnit* start = profiler::start();
+  const auto wait_start{std::chrono::steady_clock::now()};
+  while (memory_block == nullptr) {
+    memory_block = reinterpret_cast<struct MemoryBlock*>(parameter_server_->apply_buffer(
+        cache_config_.model_name_, cache_config_.cuda_dev_id_, CACHE_SPACE_TYPE::WORKER));
+  }
+  workspace_wait_latency_[table_id]->observe_since(wait_start);
+  ec_profiler_->end(
+      start, "Apply for workspace from the memory pool for Embedding Cache Lookup_from_device");
+  EmbeddingCacheWorkspace workspace_handler = memory_block->worker_buffer;
+
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(cache_config_.cuda_dev_id_);
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.d_embeddingcolumns_[table_id], d_keys,
+                                 num_keys * sizeof(TypeHashKey), cudaMemcpyDeviceToDevice,
+                                 stream));
+  start = profiler::start();
+  lookup_from_device_(table_id, d_pooled_vectors, memory_block, num_keys, hit_rate_threshold,
+                      &rows, stream);
+  ec_profiler_->end(start, "Lookup and pool the embedding keys from Embedding Cache");
+}
+
 template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, float* const d_vectors,
                                                      MemoryBlock* memory_block,
                                                      size_t const num_keys,
                                                      float const hit_rate_threshold,
                                                      cudaStream_t stream) {
+  lookup_from_device_(table_id, d_vectors, memory_block, num_keys, hit_rate_threshold, nullptr,
+                      stream);
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::lookup_from_device_(
+    const size_t table_id, float* const d_vectors, MemoryBlock* const memory_block,
+    const size_t num_keys, const float hit_rate_threshold, const PoolingRows* const rows,
+    cudaStream_t stream) {
+  std::shared_lock<std::shared_mutex> resize_lock(resize_mutex_);
   EmbeddingCacheWorkspace workspace_handler = memory_block->worker_buffer;
-  if (cache_config_.use_gpu_embedding_cache_) {
+  if (cache_config_.use_gpu_embedding_cache_ && cache_config_.stream_ordered_lookup_) {
+    CudaDeviceContext dev_restorer;
+    dev_restorer.check_device(cache_config_.cuda_dev_id_);
+    lookup_stream_ordered_(table_id, d_vectors, memory_block, num_keys, rows, stream);
+  } else if (cache_config_.use_gpu_embedding_cache_) {
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
     BaseUnit* start = profiler::start();
+    // All keys hit: Done after a single graph launch. Otherwise, redo the lookup step by step. The
+    // captured graph writes one vector per key, hence pooled lookups always go step by step.
+    if (cache_config_.use_cuda_graph_lookup_ && !rows) {
+      const bool all_hit{
+          lookup_with_graph_(table_id, d_vectors, workspace_handler, num_keys, stream)};
+      ec_profiler_->end(start, "Lookup the embedding keys with CUDA graph");
+      if (all_hit) {
+        workspace_handler.h_hit_rate_[table_id] = 1.0;
+        record_lookup_(table_id, num_keys, 0);
+        parameter_server_->free_buffer(memory_block);
+        return;
+      }
+      start = profiler::start();
+    }
     // Unique
     static_cast<UniqueOp*>(workspace_handler.unique_op_obj_[table_id])
         ->unique(static_cast<TypeHashKey*>(workspace_handler.d_embeddingcolumns_[table_id]),
@@ -374,17 +684,20 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
     const size_t query_length = workspace_handler.h_unique_length_[table_id];
     const size_t task_per_warp_tile = (query_length < 1000000) ? 1 : 32;
     start = profiler::start();
-    gpu_emb_caches_[table_id]->Query(
-        static_cast<TypeHashKey*>(workspace_handler.d_unique_output_embeddingcolumns_[table_id]),
-        workspace_handler.h_unique_length_[table_id], workspace_handler.d_hit_emb_vec_[table_id],
-        workspace_handler.d_missing_index_[table_id],
-        static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
-        workspace_handler.d_missing_length_ + table_id, stream, task_per_warp_tile);
-    HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_missing_length_ + table_id,
-                                   workspace_handler.d_missing_length_ + table_id, sizeof(size_t),
-                                   cudaMemcpyDeviceToHost, stream));
-    // Set async flag
-    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    {
+      const ScopedLatency latency(*query_latency_[table_id]);
+      gpu_emb_caches_[table_id]->Query(
+          static_cast<TypeHashKey*>(workspace_handler.d_unique_output_embeddingcolumns_[table_id]),
+          workspace_handler.h_unique_length_[table_id], workspace_handler.d_hit_emb_vec_[table_id],
+          workspace_handler.d_missing_index_[table_id],
+          static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
+          workspace_handler.d_missing_length_ + table_id, stream, task_per_warp_tile);
+      HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_missing_length_ + table_id,
+                                     workspace_handler.d_missing_length_ + table_id,
+                                     sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+      // Set async flag
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    }
     ec_profiler_->end(start, "Native Embedding Cache Query API");
     if (workspace_handler.h_unique_length_[table_id] == 0) {
       workspace_handler.h_hit_rate_[table_id] = 1.0;
@@ -393,11 +706,16 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
           1.0 - (static_cast<double>(workspace_handler.h_missing_length_[table_id]) /
                  static_cast<double>(workspace_handler.h_unique_length_[table_id]));
     }
+    record_lookup_(table_id, workspace_handler.h_unique_length_[table_id],
+                   workspace_handler.h_missing_length_[table_id]);
 
     bool async_insert_flag{workspace_handler.h_hit_rate_[table_id] >= hit_rate_threshold};
     start = profiler::start(workspace_handler.h_hit_rate_[table_id], ProfilerType_t::Occupancy);
     ec_profiler_->end(start, "The hit rate of Embedding Cache", ProfilerType_t::Occupancy);
 
+    // Filling in the missing vectors completes with the decompression below.
+    std::chrono::steady_clock::time_point compaction_start;
+
     // Handle the missing keys mode 1: synchronous
     if (!async_insert_flag) {
       start = profiler::start();
@@ -406,6 +724,7 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
       // Wait for memory copy to complete
       HCTR_LIB_THROW(cudaStreamSynchronize(stream));
       ec_profiler_->end(start, "Missing key synchronization insert into Embedding Cache");
+      compaction_start = std::chrono::steady_clock::now();
       start = profiler::start();
       merge_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
                           workspace_handler.d_missing_emb_vec_[table_id],
@@ -417,6 +736,7 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
     }
     // mode 2: Asynchronous
     else {
+      compaction_start = std::chrono::steady_clock::now();
       start = profiler::start();
       fill_default_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
                                  cache_config_.default_value_for_each_table[table_id],
@@ -427,24 +747,25 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
                         ProfilerType_t::Timeliness, stream);
     }
     start = profiler::start();
-    // Decompress the hit emb_vec buffer to output buffer
-    decompress_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
-                             workspace_handler.d_unique_output_index_[table_id], d_vectors,
-                             num_keys, cache_config_.embedding_vec_size_[table_id], BLOCK_SIZE_,
-                             stream);
+    // Decompress or pool the hit emb_vec buffer to output buffer
+    write_output_(table_id, workspace_handler, d_vectors, num_keys, rows, stream);
     // Clear the unique op object to be ready for next lookup
     static_cast<UniqueOp*>(workspace_handler.unique_op_obj_[table_id])->clear(stream);
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    compaction_latency_[table_id]->observe_since(compaction_start);
     ec_profiler_->end(start, "decompress/deunique output from Embedding Cache");
 
-    // Handle the missing keys, mode 2: synchronous
-    if (async_insert_flag) {
+    // Handle the missing keys, mode 2: synchronous. Only the owner of a shared cache inserts.
+    if (async_insert_flag && !read_only_cache_()) {
       std::lock_guard<std::mutex> lock(mutex_);
-      insert_workers_.submit([this, self(this->shared_from_this()), table_id, memory_block]() {
-        parameter_server_insert_thread_func_<TypeHashKey>(table_id, parameter_server_, self,
-                                                          memory_block, insert_streams_[table_id],
-                                                          stream_mutex_);
-      });
+      insert_workers_.submit(
+          [this, self(this->shared_from_this()), table_id, memory_block]() {
+            std::shared_lock<std::shared_mutex> resize_lock(resize_mutex_);
+            parameter_server_insert_thread_func_<TypeHashKey>(
+                table_id, parameter_server_, self, memory_block, insert_streams_[table_id],
+                stream_mutex_);
+          },
+          ThreadPool::Priority::Background);
     } else {
       parameter_server_->free_buffer(memory_block);
     }
@@ -455,12 +776,383 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
   }
 }
 
+// Executable graph of the all-hit lookup of one table, bound to a workspace.
+struct LookupGraph {
+  cudaStream_t capture_stream{nullptr};
+  cudaGraph_t graph{nullptr};
+  cudaGraphExec_t graph_exec{nullptr};
+  // The graph is only valid for the arguments it was captured with.
+  float* d_vectors{nullptr};
+  size_t num_keys{0};
+  size_t cache_generation{0};
+
+  void reset() {
+    if (graph_exec) {
+      HCTR_LIB_THROW(cudaGraphExecDestroy(graph_exec));
+      graph_exec = nullptr;
+    }
+    if (graph) {
+      HCTR_LIB_THROW(cudaGraphDestroy(graph));
+      graph = nullptr;
+    }
+  }
+};
+
+template <typename TypeHashKey>
+bool EmbeddingCache<TypeHashKey>::lookup_with_graph_(const size_t table_id,
+                                                     float* const d_vectors,
+                                                     EmbeddingCacheWorkspace& workspace_handler,
+                                                     const size_t num_keys, cudaStream_t stream) {
+  LookupGraph& lookup_graph = *static_cast<LookupGraph*>(workspace_handler.lookup_graph_[table_id]);
+
+  if (!lookup_graph.graph_exec || lookup_graph.d_vectors != d_vectors ||
+      lookup_graph.num_keys != num_keys ||
+      lookup_graph.cache_generation != cache_generation_[table_id]) {
+    lookup_graph.reset();
+
+    // The capture stream belongs to the workspace. Hence, concurrent lookups never share it.
+    cudaStream_t capture_stream = lookup_graph.capture_stream;
+    const size_t emb_vec_size = cache_config_.embedding_vec_size_[table_id];
+    UniqueOp* const unique_op = static_cast<UniqueOp*>(workspace_handler.unique_op_obj_[table_id]);
+    TypeHashKey* const d_unique_keys =
+        static_cast<TypeHashKey*>(workspace_handler.d_unique_output_embeddingcolumns_[table_id]);
+    size_t* const d_unique_length = workspace_handler.d_unique_length_ + table_id;
+    size_t* const d_missing_length = workspace_handler.d_missing_length_ + table_id;
+
+    HCTR_LIB_THROW(cudaStreamBeginCapture(capture_stream, cudaStreamCaptureModeThreadLocal));
+    unique_op->unique(static_cast<TypeHashKey*>(workspace_handler.d_embeddingcolumns_[table_id]),
+                      num_keys, workspace_handler.d_unique_output_index_[table_id],
+                      d_unique_keys, d_unique_length, capture_stream);
+    const size_t task_per_warp_tile = (num_keys < 1000000) ? 1 : 32;
+    gpu_emb_caches_[table_id]->QueryWithDeviceLen(
+        d_unique_keys, d_unique_length, num_keys, workspace_handler.d_hit_emb_vec_[table_id],
+        workspace_handler.d_missing_index_[table_id],
+        static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
+        d_missing_length, capture_stream, task_per_warp_tile);
+    HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_missing_length_ + table_id,
+                                   d_missing_length, sizeof(size_t), cudaMemcpyDeviceToHost,
+                                   capture_stream));
+    decompress_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
+                             workspace_handler.d_unique_output_index_[table_id], d_vectors,
+                             num_keys, emb_vec_size, BLOCK_SIZE_, capture_stream);
+    unique_op->clear(capture_stream);
+    HCTR_LIB_THROW(cudaStreamEndCapture(capture_stream, &lookup_graph.graph));
+    HCTR_LIB_THROW(
+        cudaGraphInstantiateWithFlags(&lookup_graph.graph_exec, lookup_graph.graph, 0));
+
+    lookup_graph.d_vectors = d_vectors;
+    lookup_graph.num_keys = num_keys;
+    lookup_graph.cache_generation = cache_generation_[table_id];
+  }
+
+  HCTR_LIB_THROW(cudaGraphLaunch(lookup_graph.graph_exec, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  return workspace_handler.h_missing_length_[table_id] == 0;
+}
+
+// Enqueues fn into stream. Like any CUDA host function, fn must not call the CUDA API.
+static void launch_host_func(cudaStream_t stream, std::function<void()> fn) {
+  auto fn_ptr{std::make_unique<std::function<void()>>(std::move(fn))};
+  HCTR_LIB_THROW(cudaLaunchHostFunc(
+      stream,
+      [](void* const user_data) {
+        const std::unique_ptr<std::function<void()>> fn{
+            static_cast<std::function<void()>*>(user_data)};
+        (*fn)();
+      },
+      fn_ptr.get()));
+  fn_ptr.release();
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::lookup_stream_ordered_(const size_t table_id,
+                                                         float* const d_vectors,
+                                                         MemoryBlock* const memory_block,
+                                                         const size_t num_keys,
+                                                         const PoolingRows* const rows,
+                                                         cudaStream_t stream) {
+  EmbeddingCacheWorkspace& workspace_handler = memory_block->worker_buffer;
+  const size_t emb_vec_size = cache_config_.embedding_vec_size_[table_id];
+  UniqueOp* const unique_op = static_cast<UniqueOp*>(workspace_handler.unique_op_obj_[table_id]);
+  TypeHashKey* const d_unique_keys =
+      static_cast<TypeHashKey*>(workspace_handler.d_unique_output_embeddingcolumns_[table_id]);
+  TypeHashKey* const d_missing_keys =
+      static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]);
+  size_t* const d_unique_length = workspace_handler.d_unique_length_ + table_id;
+  size_t* const d_missing_length = workspace_handler.d_missing_length_ + table_id;
+
+  // Unique and query. The number of unique and missing keys remains on the device, and num_keys
+  // serves as their upper bound for all subsequent launches and copies.
+  unique_op->unique(static_cast<TypeHashKey*>(workspace_handler.d_embeddingcolumns_[table_id]),
+                    num_keys, workspace_handler.d_unique_output_index_[table_id], d_unique_keys,
+                    d_unique_length, stream);
+  const size_t task_per_warp_tile = (num_keys < 1000000) ? 1 : 32;
+  gpu_emb_caches_[table_id]->QueryWithDeviceLen(
+      d_unique_keys, d_unique_length, num_keys, workspace_handler.d_hit_emb_vec_[table_id],
+      workspace_handler.d_missing_index_[table_id], d_missing_keys, d_missing_length, stream,
+      task_per_warp_tile);
+
+  // Fetch the missing keys from the parameter server once they have arrived on the host.
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_unique_length_ + table_id, d_unique_length,
+                                 sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_missing_length_ + table_id,
+                                 d_missing_length, sizeof(size_t), cudaMemcpyDeviceToHost,
+                                 stream));
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_missing_embeddingcolumns_[table_id],
+                                 d_missing_keys, num_keys * sizeof(TypeHashKey),
+                                 cudaMemcpyDeviceToHost, stream));
+  launch_host_func(stream, [this, table_id, memory_block, emb_vec_size]() {
+    EmbeddingCacheWorkspace& workspace_handler = memory_block->worker_buffer;
+    const size_t unique_length = workspace_handler.h_unique_length_[table_id];
+    const size_t missing_length = workspace_handler.h_missing_length_[table_id];
+    workspace_handler.h_hit_rate_[table_id] =
+        unique_length ? 1.0 - static_cast<double>(missing_length) /
+                                  static_cast<double>(unique_length)
+                      : 1.0;
+    record_lookup_(table_id, unique_length, missing_length);
+    try {
+      parameter_server_->lookup(workspace_handler.h_missing_embeddingcolumns_[table_id],
+                                missing_length, workspace_handler.h_missing_emb_vec_[table_id],
+                                cache_config_.model_name_, table_id);
+    } catch (const std::exception& e) {
+      HCTR_LOG_S(ERROR, WORLD) << e.what() << std::endl;
+      std::fill_n(workspace_handler.h_missing_emb_vec_[table_id], missing_length * emb_vec_size,
+                  cache_config_.default_value_for_each_table[table_id]);
+    }
+  });
+
+  // Merge the fetched vectors and insert them into the cache.
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.d_missing_emb_vec_[table_id],
+                                 workspace_handler.h_missing_emb_vec_[table_id],
+                                 num_keys * emb_vec_size * sizeof(float), cudaMemcpyHostToDevice,
+                                 stream));
+  merge_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
+                      workspace_handler.d_missing_emb_vec_[table_id],
+                      workspace_handler.d_missing_index_[table_id], d_missing_length, num_keys,
+                      emb_vec_size, BLOCK_SIZE_, stream);
+  if (!read_only_cache_()) {
+    gpu_emb_caches_[table_id]->ReplaceWithDeviceLen(d_missing_keys, d_missing_length, num_keys,
+                                                    workspace_handler.d_missing_emb_vec_[table_id],
+                                                    stream);
+  }
+
+  // Decompress or pool the hit emb_vec buffer to output buffer
+  write_output_(table_id, workspace_handler, d_vectors, num_keys, rows, stream);
+  unique_op->clear(stream);
+
+  // Return the workspace after the stream has finished using it.
+  launch_host_func(stream, [self(this->shared_from_this()), memory_block]() {
+    self->parameter_server_->free_buffer(memory_block);
+  });
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::write_output_(const size_t table_id,
+                                                const EmbeddingCacheWorkspace& workspace_handler,
+                                                float* const d_vectors, const size_t num_keys,
+                                                const PoolingRows* const rows,
+                                                cudaStream_t stream) {
+  const size_t emb_vec_size = cache_config_.embedding_vec_size_[table_id];
+  if (rows) {
+    // Each row reads the vectors of its keys from the unique buffer, so that the vectors of the
+    // individual keys are never materialized.
+    pool_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
+                       workspace_handler.d_unique_output_index_[table_id], rows->d_row_offsets,
+                       rows->num_rows, emb_vec_size, rows->combiner == PoolingCombiner_t::Mean,
+                       d_vectors, BLOCK_SIZE_, stream);
+  } else {
+    decompress_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
+                             workspace_handler.d_unique_output_index_[table_id], d_vectors,
+                             num_keys, emb_vec_size, BLOCK_SIZE_, stream);
+  }
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::lookup_from_device_grouped(
+    const std::vector<const void*>& d_keys_per_table,
+    const std::vector<float*>& d_vectors_per_table, const std::vector<size_t>& num_keys_per_table,
+    const float hit_rate_threshold, cudaStream_t stream) {
+  // The stream-ordered and CUDA graph lookups work on individual tables.
+  if (!cache_config_.use_gpu_embedding_cache_ || cache_config_.stream_ordered_lookup_ ||
+      cache_config_.use_cuda_graph_lookup_) {
+    EmbeddingCacheBase::lookup_from_device_grouped(d_keys_per_table, d_vectors_per_table,
+                                                   num_keys_per_table, hit_rate_threshold, stream);
+    return;
+  }
+  std::shared_lock<std::shared_mutex> resize_lock(resize_mutex_);
+  const size_t num_tables = cache_config_.num_emb_table_;
+  HCTR_CHECK_HINT(d_keys_per_table.size() == num_tables &&
+                      d_vectors_per_table.size() == num_tables &&
+                      num_keys_per_table.size() == num_tables,
+                  "Grouped lookups must cover all embedding tables.");
+
+  MemoryBlock* memory_block = nullptr;
+  BaseUnit* start = profiler::start();
+  const auto wait_start{std::chrono::steady_clock::now()};
+  while (memory_block == nullptr) {
+    memory_block = reinterpret_cast<struct MemoryBlock*>(parameter_server_->apply_buffer(
+        cache_config_.model_name_, cache_config_.cuda_dev_id_, CACHE_SPACE_TYPE::WORKER));
+  }
+  // The lookups of all tables waited for this workspace.
+  for (LatencyHistogram* const latency : workspace_wait_latency_) {
+    latency->observe_since(wait_start);
+  }
+  ec_profiler_->end(
+      start, "Apply for workspace from the memory pool for Embedding Cache Lookup_from_device");
+  EmbeddingCacheWorkspace& workspace_handler = memory_block->worker_buffer;
+
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(cache_config_.cuda_dev_id_);
+
+  // Unique
+  start = profiler::start();
+  for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.d_embeddingcolumns_[table_id],
+                                   d_keys_per_table[table_id],
+                                   num_keys_per_table[table_id] * sizeof(TypeHashKey),
+                                   cudaMemcpyDeviceToDevice, stream));
+    static_cast<UniqueOp*>(workspace_handler.unique_op_obj_[table_id])
+        ->unique(static_cast<TypeHashKey*>(workspace_handler.d_embeddingcolumns_[table_id]),
+                 num_keys_per_table[table_id], workspace_handler.d_unique_output_index_[table_id],
+                 static_cast<TypeHashKey*>(
+                     workspace_handler.d_unique_output_embeddingcolumns_[table_id]),
+                 workspace_handler.d_unique_length_ + table_id, stream);
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_unique_length_,
+                                 workspace_handler.d_unique_length_, num_tables * sizeof(size_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  ec_profiler_->end(start, "Deduplicate the input embedding key for Embedding Cache");
+
+  // Query all tables with a single grouped kernel.
+  start = profiler::start();
+  std::vector<gpu_cache::gpu_cache_query_task<TypeHashKey>> query_tasks;
+  query_tasks.reserve(num_tables);
+  size_t max_query_length{0};
+  for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+    query_tasks.push_back(
+        {gpu_emb_caches_[table_id].get(),
+         static_cast<TypeHashKey*>(workspace_handler.d_unique_output_embeddingcolumns_[table_id]),
+         nullptr, workspace_handler.h_unique_length_[table_id],
+         workspace_handler.d_hit_emb_vec_[table_id], workspace_handler.d_missing_index_[table_id],
+         static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
+         workspace_handler.d_missing_length_ + table_id});
+    max_query_length = std::max(max_query_length, workspace_handler.h_unique_length_[table_id]);
+  }
+  const size_t task_per_warp_tile = (max_query_length < 1000000) ? 1 : 32;
+  gpu_emb_caches_[0]->QueryGrouped(query_tasks.data(), query_tasks.size(), stream,
+                                   task_per_warp_tile);
+  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.h_missing_length_,
+                                 workspace_handler.d_missing_length_, num_tables * sizeof(size_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  ec_profiler_->end(start, "Native Embedding Cache Query API");
+
+  // Classify the tables by how their missing keys are handled.
+  std::vector<size_t> sync_tables;
+  std::vector<size_t> async_tables;
+  for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+    const size_t unique_length = workspace_handler.h_unique_length_[table_id];
+    const size_t missing_length = workspace_handler.h_missing_length_[table_id];
+    workspace_handler.h_hit_rate_[table_id] =
+        unique_length ? 1.0 - static_cast<double>(missing_length) /
+                                  static_cast<double>(unique_length)
+                      : 1.0;
+    record_lookup_(table_id, unique_length, missing_length);
+    if (missing_length == 0) {
+      continue;
+    }
+    if (workspace_handler.h_hit_rate_[table_id] >= hit_rate_threshold) {
+      async_tables.push_back(table_id);
+    } else {
+      sync_tables.push_back(table_id);
+    }
+  }
+
+  // Handle the missing keys mode 1: synchronous
+  if (!sync_tables.empty()) {
+    start = profiler::start();
+    for (const size_t table_id : sync_tables) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(
+          workspace_handler.h_missing_embeddingcolumns_[table_id],
+          workspace_handler.d_missing_embeddingcolumns_[table_id],
+          workspace_handler.h_missing_length_[table_id] * sizeof(TypeHashKey),
+          cudaMemcpyDeviceToHost, stream));
+    }
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+    std::vector<gpu_cache::gpu_cache_replace_task<TypeHashKey>> replace_tasks;
+    replace_tasks.reserve(sync_tables.size());
+    for (const size_t table_id : sync_tables) {
+      const size_t missing_length = workspace_handler.h_missing_length_[table_id];
+      const size_t emb_vec_size = cache_config_.embedding_vec_size_[table_id];
+      parameter_server_->lookup(workspace_handler.h_missing_embeddingcolumns_[table_id],
+                                missing_length, workspace_handler.h_missing_emb_vec_[table_id],
+                                cache_config_.model_name_, table_id);
+      HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.d_missing_emb_vec_[table_id],
+                                     workspace_handler.h_missing_emb_vec_[table_id],
+                                     missing_length * emb_vec_size * sizeof(float),
+                                     cudaMemcpyHostToDevice, stream));
+      merge_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
+                          workspace_handler.d_missing_emb_vec_[table_id],
+                          workspace_handler.d_missing_index_[table_id], missing_length,
+                          emb_vec_size, BLOCK_SIZE_, stream);
+      replace_tasks.push_back(
+          {gpu_emb_caches_[table_id].get(),
+           static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
+           nullptr, missing_length, workspace_handler.d_missing_emb_vec_[table_id]});
+    }
+    if (!read_only_cache_()) {
+      gpu_emb_caches_[0]->ReplaceGrouped(replace_tasks.data(), replace_tasks.size(), stream);
+    }
+    ec_profiler_->end(start, "Missing key synchronization insert into Embedding Cache",
+                      ProfilerType_t::Timeliness, stream);
+  }
+  // mode 2: Asynchronous
+  for (const size_t table_id : async_tables) {
+    fill_default_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
+                               cache_config_.default_value_for_each_table[table_id],
+                               workspace_handler.d_missing_index_[table_id],
+                               workspace_handler.h_missing_length_[table_id],
+                               cache_config_.embedding_vec_size_[table_id], BLOCK_SIZE_, stream);
+  }
+
+  start = profiler::start();
+  for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+    // Decompress the hit emb_vec buffer to output buffer
+    decompress_emb_vec_async(workspace_handler.d_hit_emb_vec_[table_id],
+                             workspace_handler.d_unique_output_index_[table_id],
+                             d_vectors_per_table[table_id], num_keys_per_table[table_id],
+                             cache_config_.embedding_vec_size_[table_id], BLOCK_SIZE_, stream);
+    // Clear the unique op object to be ready for next lookup
+    static_cast<UniqueOp*>(workspace_handler.unique_op_obj_[table_id])->clear(stream);
+  }
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  ec_profiler_->end(start, "decompress/deunique output from Embedding Cache");
+
+  // Handle the missing keys, mode 2: asynchronous. Only the owner of a shared cache inserts.
+  if (!async_tables.empty() && !read_only_cache_()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert_workers_.submit(
+        [this, self(this->shared_from_this()), async_tables(std::move(async_tables)),
+         memory_block]() {
+          std::shared_lock<std::shared_mutex> resize_lock(resize_mutex_);
+          parameter_server_insert_thread_func_<TypeHashKey>(async_tables, parameter_server_, self,
+                                                            memory_block, insert_streams_,
+                                                            stream_mutex_);
+        },
+        ThreadPool::Priority::Background);
+  } else {
+    parameter_server_->free_buffer(memory_block);
+  }
+}
+
 template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::insert(const size_t table_id,
                                          EmbeddingCacheWorkspace& workspace_handler,
                                          cudaStream_t stream) {
-  // If GPU embedding cache is enabled
-  if (cache_config_.use_gpu_embedding_cache_) {
+  // If GPU embedding cache is enabled, and this process inserts into it
+  if (cache_config_.use_gpu_embedding_cache_ && !read_only_cache_()) {
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
     gpu_emb_caches_[table_id]->Replace(
@@ -474,11 +1166,12 @@ template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::init(const size_t table_id,
                                        EmbeddingCacheRefreshspace& refreshspace_handler,
                                        cudaStream_t stream) {
-  // If GPU embedding cache is enabled
-  if (cache_config_.use_gpu_embedding_cache_) {
+  // If GPU embedding cache is enabled, and this process inserts into it
+  if (cache_config_.use_gpu_embedding_cache_ && !read_only_cache_()) {
+    std::shared_lock<std::shared_mutex> resize_lock(resize_mutex_);
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
-    gpu_emb_caches_[table_id]->Replace(
+    gpu_emb_caches_[table_id]->Preload(
         static_cast<TypeHashKey*>(refreshspace_handler.d_refresh_embeddingcolumns_),
         *refreshspace_handler.h_length_, refreshspace_handler.d_refresh_emb_vec_, stream);
   }
@@ -495,6 +1188,7 @@ void EmbeddingCache<TypeHashKey>::dump(const size_t table_id, void* const d_keys
                                        const size_t end_index, cudaStream_t stream) {
   // If GPU embedding cache is enabled
   if (cache_config_.use_gpu_embedding_cache_) {
+    std::shared_lock<std::shared_mutex> resize_lock(resize_mutex_);
     // Check for corner case
     if (start_index >= cache_config_.num_set_in_cache_[table_id]) {
       HCTR_OWN_THROW(Error_t::WrongInput, "Error: Invalid value for start_index.");
@@ -517,12 +1211,13 @@ template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::refresh(const size_t table_id, const void* const d_keys,
                                           const void* const d_vectors, const size_t length,
                                           cudaStream_t stream) {
-  // If GPU embedding cache is enabled
-  if (cache_config_.use_gpu_embedding_cache_) {
+  // If GPU embedding cache is enabled, and this process refreshes it
+  if (cache_config_.use_gpu_embedding_cache_ && !read_only_cache_()) {
     // Check for corner case
     if (length == 0) {
       return;
     }
+    std::shared_lock<std::shared_mutex> resize_lock(resize_mutex_);
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
     BaseUnit* start = profiler::start();
@@ -547,6 +1242,128 @@ void EmbeddingCache<TypeHashKey>::finalize() {
   }
 }
 
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::resize_gpu_cache_(const size_t table_id, const size_t num_set,
+                                                    cudaStream_t stream) {
+  std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>> new_cache{
+      create_gpu_cache_(table_id, num_set)};
+
+  // Move the cached pairs over, a few sets at a time to bound the temporary buffers.
+  const size_t old_num_set = cache_config_.num_set_in_cache_[table_id];
+  const size_t emb_vec_size = cache_config_.embedding_vec_size_[table_id];
+  const size_t stride_set = std::min(old_num_set, static_cast<size_t>(1024));
+  const size_t max_num_keys = stride_set * SLAB_SIZE * SET_ASSOCIATIVITY;
+  TypeHashKey* d_keys;
+  float* d_vectors;
+  uint64_t* d_missing_index;
+  TypeHashKey* d_missing_keys;
+  size_t* d_lengths;
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&d_keys), max_num_keys * sizeof(TypeHashKey)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&d_vectors),
+                            max_num_keys * emb_vec_size * sizeof(float)));
+  HCTR_LIB_THROW(
+      cudaMalloc(reinterpret_cast<void**>(&d_missing_index), max_num_keys * sizeof(uint64_t)));
+  HCTR_LIB_THROW(
+      cudaMalloc(reinterpret_cast<void**>(&d_missing_keys), max_num_keys * sizeof(TypeHashKey)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&d_lengths), 2 * sizeof(size_t)));
+
+  size_t num_keys;
+  for (size_t idx_set = 0; idx_set < old_num_set; idx_set += stride_set) {
+    const size_t end_idx = std::min(idx_set + stride_set, old_num_set);
+    gpu_emb_caches_[table_id]->Dump(d_keys, d_lengths, idx_set, end_idx, stream);
+    HCTR_LIB_THROW(
+        cudaMemcpyAsync(&num_keys, d_lengths, sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    if (num_keys == 0) {
+      continue;
+    }
+    gpu_emb_caches_[table_id]->Query(d_keys, num_keys, d_vectors, d_missing_index, d_missing_keys,
+                                     d_lengths + 1, stream);
+    new_cache->Preload(d_keys, num_keys, d_vectors, stream);
+  }
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  HCTR_LIB_THROW(cudaFree(d_keys));
+  HCTR_LIB_THROW(cudaFree(d_vectors));
+  HCTR_LIB_THROW(cudaFree(d_missing_index));
+  HCTR_LIB_THROW(cudaFree(d_missing_keys));
+  HCTR_LIB_THROW(cudaFree(d_lengths));
+
+  gpu_emb_caches_[table_id] = std::move(new_cache);
+  cache_config_.num_set_in_cache_[table_id] = num_set;
+  ++cache_generation_[table_id];
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::rebalance_capacity(cudaStream_t stream) {
+  if (!cache_config_.use_gpu_embedding_cache_ || !cache_config_.adaptive_cache_sizing_ ||
+      cache_config_.num_emb_table_ < 2) {
+    return;
+  }
+  const size_t num_tables = cache_config_.num_emb_table_;
+
+  // Keep all lookups, insertions and refreshes out while the caches are being swapped.
+  std::unique_lock<std::shared_mutex> resize_lock(resize_mutex_);
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(cache_config_.cuda_dev_id_);
+  // Stream-ordered lookups may still have queries and replacements in flight.
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+
+  // Each table is charged for its misses by the number of values they have to transfer.
+  const size_t elem_size = nv_cache_element_size(cache_config_.value_encoding_);
+  std::vector<size_t> bytes_per_set(num_tables);
+  std::vector<double> miss_costs(num_tables);
+  double budget{0};
+  double total_miss_cost{0};
+  for (size_t i = 0; i < num_tables; i++) {
+    bytes_per_set[i] = SLAB_SIZE * SET_ASSOCIATIVITY *
+                       (cache_config_.embedding_vec_size_[i] * elem_size + sizeof(TypeHashKey) +
+                        sizeof(uint64_t));
+    budget += static_cast<double>(cache_config_.num_set_in_cache_[i] * bytes_per_set[i]);
+    const size_t num_queried_keys = table_stats_[i].num_queried_keys.exchange(0);
+    const size_t num_missing_keys = table_stats_[i].num_missing_keys.exchange(0);
+    miss_costs[i] = static_cast<double>(num_missing_keys * cache_config_.embedding_vec_size_[i]);
+    total_miss_cost += miss_costs[i];
+    HCTR_LOG(INFO, ROOT, "Embedding cache of table %s: %zu sets, hit rate %f since last refresh\n",
+             cache_config_.embedding_table_name_[i].c_str(), cache_config_.num_set_in_cache_[i],
+             num_queried_keys ? 1.0 - static_cast<double>(num_missing_keys) /
+                                          static_cast<double>(num_queried_keys)
+                              : 1.0);
+  }
+  if (total_miss_cost <= 0) {
+    return;
+  }
+
+  // Move half way from the current split of device memory towards the split of the miss cost. Too
+  // small changes are not worth migrating the cache.
+  std::vector<size_t> target_num_set(num_tables);
+  for (size_t i = 0; i < num_tables; i++) {
+    const size_t num_set = cache_config_.num_set_in_cache_[i];
+    const double share{0.5 * static_cast<double>(num_set * bytes_per_set[i]) / budget +
+                       0.5 * miss_costs[i] / total_miss_cost};
+    target_num_set[i] = std::clamp(
+        static_cast<size_t>(share * budget / static_cast<double>(bytes_per_set[i])),
+        static_cast<size_t>(1), max_num_set_in_cache_[i]);
+    const size_t delta = target_num_set[i] > num_set ? target_num_set[i] - num_set
+                                                     : num_set - target_num_set[i];
+    if (delta * 10 < num_set) {
+      target_num_set[i] = num_set;
+    }
+  }
+
+  // Shrink first, so that the device memory is released before it is claimed by the other tables.
+  for (const bool grow : {false, true}) {
+    for (size_t i = 0; i < num_tables; i++) {
+      const size_t num_set = cache_config_.num_set_in_cache_[i];
+      if (grow ? target_num_set[i] > num_set : target_num_set[i] < num_set) {
+        HCTR_LOG(INFO, ROOT, "Resizing the embedding cache of table %s from %zu to %zu sets\n",
+                 cache_config_.embedding_table_name_[i].c_str(), num_set, target_num_set[i]);
+        resize_gpu_cache_(i, target_num_set[i], stream);
+      }
+    }
+  }
+}
+
 template <typename TypeHashKey>
 EmbeddingCacheWorkspace EmbeddingCache<TypeHashKey>::create_workspace() {
   EmbeddingCacheWorkspace workspace_handler;
@@ -649,6 +1466,14 @@ EmbeddingCacheWorkspace EmbeddingCache<TypeHashKey>::create_workspace() {
     HCTR_LIB_THROW(cudaHostAlloc(reinterpret_cast<void**>(&workspace_handler.h_hit_rate_),
                                  cache_config_.num_emb_table_ * sizeof(double),
                                  cudaHostAllocPortable));
+    if (cache_config_.use_cuda_graph_lookup_) {
+      for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+        LookupGraph* const lookup_graph = new LookupGraph;
+        HCTR_LIB_THROW(
+            cudaStreamCreateWithFlags(&lookup_graph->capture_stream, cudaStreamNonBlocking));
+        workspace_handler.lookup_graph_.push_back(lookup_graph);
+      }
+    }
   }
   return workspace_handler;
 }
@@ -705,6 +1530,13 @@ void EmbeddingCache<TypeHashKey>::destroy_workspace(EmbeddingCacheWorkspace& wor
     workspace_handler.h_missing_length_ = nullptr;
     HCTR_LIB_THROW(cudaFreeHost(workspace_handler.h_hit_rate_));
     workspace_handler.h_hit_rate_ = nullptr;
+    for (void* const p : workspace_handler.lookup_graph_) {
+      LookupGraph* const lookup_graph = static_cast<LookupGraph*>(p);
+      lookup_graph->reset();
+      HCTR_LIB_THROW(cudaStreamDestroy(lookup_graph->capture_stream));
+      delete lookup_graph;
+    }
+    workspace_handler.lookup_graph_.clear();
   }
 }
 
@@ -724,6 +1556,7 @@ EmbeddingCacheRefreshspace EmbeddingCache<TypeHashKey>::create_refreshspace() {
     cache_config_.num_set_in_refresh_workspace_ =
         (max_num_key_in_buffer + SLAB_SIZE * SET_ASSOCIATIVITY - 1) /
         (SLAB_SIZE * SET_ASSOCIATIVITY);
+    cache_config_.max_num_keys_in_refresh_workspace_ = max_num_key_in_buffer;
 
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <hps/embedding_cache_hybrid.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+template <typename TypeHashKey>
+HybridEmbeddingCache<TypeHashKey>::HybridEmbeddingCache(
+    const InferenceParams& inference_params, const parameter_server_config& ps_config,
+    HierParameterServerBase* const parameter_server)
+    : EmbeddingCacheBase(),
+      tail_(std::make_shared<EmbeddingCache<TypeHashKey>>(inference_params, ps_config,
+                                                          parameter_server)) {
+  const embedding_cache_config& cache_config = tail_->get_cache_config();
+  max_num_keys_ = *std::max_element(cache_config.max_query_len_per_emb_table_.begin(),
+                                    cache_config.max_query_len_per_emb_table_.end());
+  max_embedding_size_ = *std::max_element(cache_config.embedding_vec_size_.begin(),
+                                          cache_config.embedding_vec_size_.end());
+
+  // This is the only two places to set the cuda context in hybrid embedding cache
+  CudaDeviceContext dev_restorer;
+  dev_restorer.set_device(cache_config.cuda_dev_id_);
+
+  // Allocate the static tables.
+  for (size_t i = 0; i < cache_config.num_emb_table_; i++) {
+    const size_t row_num = ps_config.embedding_key_count_.at(inference_params.model_name)[i];
+    const size_t num_hot_keys = std::max(
+        static_cast<size_t>(static_cast<double>(inference_params.hot_key_percentage) *
+                            static_cast<double>(row_num)),
+        static_cast<size_t>(1));
+    HCTR_LOG(INFO, ROOT, "Hybrid embedding cache pins up to %zu keys of table %zu.\n",
+             num_hot_keys, i);
+    hot_tables_.emplace_back(std::make_unique<HotTable>(
+        num_hot_keys, cache_config.embedding_vec_size_[i],
+        cache_config.default_value_for_each_table[i], inference_params.enable_pagelock));
+    num_hot_keys_.push_back(num_hot_keys);
+  }
+  pinned_keys_.resize(cache_config.num_emb_table_);
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&d_pin_keys_buffer_),
+                            *std::max_element(num_hot_keys_.begin(), num_hot_keys_.end()) *
+                                sizeof(TypeHashKey)));
+  update_cache_config_();
+}
+
+template <typename TypeHashKey>
+HybridEmbeddingCache<TypeHashKey>::~HybridEmbeddingCache() {
+  // This is the only two places to set the cuda context in hybrid embedding cache
+  CudaDeviceContext dev_restorer;
+  dev_restorer.set_device(tail_->get_device_id());
+  cudaFree(d_pin_keys_buffer_);
+  for (const auto& scratch : scratch_pool_) {
+    cudaFree(scratch->d_keys);
+    cudaFree(scratch->d_missing_keys);
+    cudaFree(scratch->d_missing_index);
+    cudaFree(scratch->d_missing_emb_vec);
+    cudaFree(scratch->d_missing_len);
+    cudaFreeHost(scratch->h_missing_len);
+  }
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::update_cache_config_() {
+  cache_config_ = tail_->get_cache_config();
+  if (!cache_config_.use_gpu_embedding_cache_) {
+    return;
+  }
+  for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+    cache_config_.num_set_in_cache_[i] +=
+        (pinned_keys_[i].size() + SLAB_SIZE * SET_ASSOCIATIVITY - 1) /
+        (SLAB_SIZE * SET_ASSOCIATIVITY);
+  }
+}
+
+template <typename TypeHashKey>
+typename HybridEmbeddingCache<TypeHashKey>::Scratch*
+HybridEmbeddingCache<TypeHashKey>::acquire_scratch_() {
+  const std::lock_guard<std::mutex> lock(scratch_mutex_);
+  if (!idle_scratch_.empty()) {
+    Scratch* const scratch = idle_scratch_.back();
+    idle_scratch_.pop_back();
+    return scratch;
+  }
+
+  // Allocate another set of buffers for each concurrent lookup.
+  auto scratch = std::make_unique<Scratch>();
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_keys),
+                            max_num_keys_ * sizeof(TypeHashKey)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_missing_keys),
+                            max_num_keys_ * sizeof(TypeHashKey)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_missing_index),
+                            max_num_keys_ * sizeof(uint64_t)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_missing_emb_vec),
+                            max_num_keys_ * max_embedding_size_ * sizeof(float)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_missing_len), sizeof(size_t)));
+  HCTR_LIB_THROW(cudaHostAlloc(reinterpret_cast<void**>(&scratch->h_missing_len), sizeof(size_t),
+                               cudaHostAllocPortable));
+  scratch_pool_.emplace_back(std::move(scratch));
+  return scratch_pool_.back().get();
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::release_scratch_(Scratch* const scratch) {
+  const std::lock_guard<std::mutex> lock(scratch_mutex_);
+  idle_scratch_.push_back(scratch);
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::lookup_hybrid_(const size_t table_id,
+                                                       float* const d_vectors,
+                                                       const TypeHashKey* const d_keys,
+                                                       const size_t num_keys,
+                                                       const float hit_rate_threshold,
+                                                       Scratch& scratch, cudaStream_t stream) {
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(tail_->get_device_id());
+
+  // Probe the static table, which writes the embeddings of all pinned keys.
+  hot_tables_[table_id]->Query(d_keys, num_keys, d_vectors, scratch.d_missing_keys,
+                               scratch.d_missing_index, scratch.d_missing_len, stream);
+  HCTR_LIB_THROW(cudaMemcpyAsync(scratch.h_missing_len, scratch.d_missing_len, sizeof(size_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  const size_t missing_len = *scratch.h_missing_len;
+  if (missing_len == 0) {
+    return;
+  }
+
+  // Look up the remaining keys in the dynamic cache, and merge them into the result.
+  const size_t emb_vec_size = tail_->get_cache_config().embedding_vec_size_[table_id];
+  tail_->lookup_from_device(table_id, scratch.d_missing_emb_vec, scratch.d_missing_keys,
+                            missing_len, hit_rate_threshold, stream);
+  merge_emb_vec_async(d_vectors, scratch.d_missing_emb_vec, scratch.d_missing_index, missing_len,
+                      emb_vec_size, BLOCK_SIZE_, stream);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::lookup(const size_t table_id, float* const d_vectors,
+                                               const void* const h_keys, const size_t num_keys,
+                                               const float hit_rate_threshold,
+                                               cudaStream_t stream) {
+  if (num_keys == 0) {
+    return;
+  }
+  HCTR_CHECK_HINT(num_keys <= max_num_keys_,
+                  "The number of keys exceeds the maximum query length of the embedding cache.");
+  Scratch* const scratch = acquire_scratch_();
+  HCTR_LIB_THROW(cudaMemcpyAsync(scratch->d_keys, h_keys, num_keys * sizeof(TypeHashKey),
+                                 cudaMemcpyHostToDevice, stream));
+  lookup_hybrid_(table_id, d_vectors, scratch->d_keys, num_keys, hit_rate_threshold, *scratch,
+                 stream);
+  release_scratch_(scratch);
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::lookup_from_device(const size_t table_id,
+                                                           float* const d_vectors,
+                                                           const void* const d_keys,
+                                                           const size_t num_keys,
+                                                           const float hit_rate_threshold,
+                                                           cudaStream_t stream) {
+  if (num_keys == 0) {
+    return;
+  }
+  HCTR_CHECK_HINT(num_keys <= max_num_keys_,
+                  "The number of keys exceeds the maximum query length of the embedding cache.");
+  Scratch* const scratch = acquire_scratch_();
+  lookup_hybrid_(table_id, d_vectors, static_cast<const TypeHashKey*>(d_keys), num_keys,
+                 hit_rate_threshold, *scratch, stream);
+  release_scratch_(scratch);
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::insert(const size_t table_id,
+                                               EmbeddingCacheWorkspace& workspace_handler,
+                                               cudaStream_t stream) {
+  tail_->insert(table_id, workspace_handler, stream);
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::init(const size_t table_id,
+                                             EmbeddingCacheRefreshspace& refreshspace_handler,
+                                             cudaStream_t stream) {
+  tail_->init(table_id, refreshspace_handler, stream);
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::init(const size_t table_id,
+                                             void* const h_refresh_embeddingcolumns_,
+                                             void* const h_refresh_emb_vec_,
+                                             float* const h_quant_scales, const size_t h_length_,
+                                             cudaStream_t stream) {
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(tail_->get_device_id());
+
+  // The static table cannot evict keys, so keys beyond its capacity are left to the dynamic cache.
+  std::vector<TypeHashKey>& pinned_keys = pinned_keys_[table_id];
+  const size_t length = std::min(h_length_, num_hot_keys_[table_id] - pinned_keys.size());
+  if (length < h_length_) {
+    HCTR_LOG(WARNING, ROOT, "The static table of table %zu is full. %zu keys are not pinned.\n",
+             table_id, h_length_ - length);
+  }
+  if (length == 0) {
+    return;
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(d_pin_keys_buffer_, h_refresh_embeddingcolumns_,
+                                 length * sizeof(TypeHashKey), cudaMemcpyHostToDevice, stream));
+  hot_tables_[table_id]->Add(d_pin_keys_buffer_, length, static_cast<float*>(h_refresh_emb_vec_),
+                             h_quant_scales, stream);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  const TypeHashKey* const h_keys = static_cast<const TypeHashKey*>(h_refresh_embeddingcolumns_);
+  pinned_keys.insert(pinned_keys.end(), h_keys, &h_keys[length]);
+  update_cache_config_();
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::dump(const size_t table_id, void* const d_keys,
+                                             size_t* const d_length, const size_t start_index,
+                                             const size_t end_index, cudaStream_t stream) {
+  const size_t num_tail_sets = tail_->get_cache_config().num_set_in_cache_[table_id];
+  if (end_index <= num_tail_sets) {
+    tail_->dump(table_id, d_keys, d_length, start_index, end_index, stream);
+    return;
+  }
+  if (start_index >= end_index || end_index > cache_config_.num_set_in_cache_[table_id]) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Error: Invalid value for end_index.");
+  }
+
+  // Dump the sets of the dynamic cache first, and append the pinned keys of the remaining sets.
+  size_t length = 0;
+  if (start_index < num_tail_sets) {
+    tail_->dump(table_id, d_keys, d_length, start_index, num_tail_sets, stream);
+    HCTR_LIB_THROW(
+        cudaMemcpyAsync(&length, d_length, sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+  const std::vector<TypeHashKey>& pinned_keys = pinned_keys_[table_id];
+  const size_t begin = (std::max(start_index, num_tail_sets) - num_tail_sets) * SLAB_SIZE *
+                       SET_ASSOCIATIVITY;
+  const size_t end = std::min((end_index - num_tail_sets) * SLAB_SIZE * SET_ASSOCIATIVITY,
+                              pinned_keys.size());
+  if (begin < end) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(static_cast<TypeHashKey*>(d_keys) + length, &pinned_keys[begin],
+                                   (end - begin) * sizeof(TypeHashKey), cudaMemcpyHostToDevice,
+                                   stream));
+    length += end - begin;
+  }
+  HCTR_LIB_THROW(
+      cudaMemcpyAsync(d_length, &length, sizeof(size_t), cudaMemcpyHostToDevice, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::refresh(const size_t table_id, const void* const d_keys,
+                                                const void* const d_vectors, const size_t length,
+                                                cudaStream_t stream) {
+  if (length == 0) {
+    return;
+  }
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(tail_->get_device_id());
+  hot_tables_[table_id]->Update(static_cast<const TypeHashKey*>(d_keys), length,
+                                static_cast<const float*>(d_vectors), stream);
+  tail_->refresh(table_id, d_keys, d_vectors, length, stream);
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::finalize() {
+  tail_->finalize();
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::rebalance_capacity(cudaStream_t stream) {
+  tail_->rebalance_capacity(stream);
+  update_cache_config_();
+}
+
+template <typename TypeHashKey>
+EmbeddingCacheWorkspace HybridEmbeddingCache<TypeHashKey>::create_workspace() {
+  return tail_->create_workspace();
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::destroy_workspace(
+    EmbeddingCacheWorkspace& workspace_handler) {
+  tail_->destroy_workspace(workspace_handler);
+}
+
+template <typename TypeHashKey>
+EmbeddingCacheRefreshspace HybridEmbeddingCache<TypeHashKey>::create_refreshspace() {
+  return tail_->create_refreshspace();
+}
+
+template <typename TypeHashKey>
+void HybridEmbeddingCache<TypeHashKey>::destroy_refreshspace(
+    EmbeddingCacheRefreshspace& refreshspace_handler) {
+  tail_->destroy_refreshspace(refreshspace_handler);
+}
+
+template class HybridEmbeddingCache<long long>;
+template class HybridEmbeddingCache<unsigned int>;
+
+}  // namespace HugeCTR
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <future>
+#include <hps/embedding_cache_sharded.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+template <typename TypeHashKey>
+bool ShardedEmbeddingCache<TypeHashKey>::enable_peer_access(const std::vector<int>& devices) {
+  for (const int device : devices) {
+    for (const int peer : devices) {
+      int can_access_peer{0};
+      if (device != peer) {
+        HCTR_LIB_THROW(cudaDeviceCanAccessPeer(&can_access_peer, device, peer));
+        if (!can_access_peer) {
+          HCTR_LOG(WARNING, ROOT, "Device %d cannot access the memory of device %d.\n", device,
+                   peer);
+          return false;
+        }
+      }
+    }
+  }
+
+  for (const int device : devices) {
+    CudaDeviceContext context(device);
+    for (const int peer : devices) {
+      if (device != peer) {
+        const cudaError_t err{cudaDeviceEnablePeerAccess(peer, 0)};
+        if (err == cudaErrorPeerAccessAlreadyEnabled) {
+          // Clear the error state.
+          cudaGetLastError();
+        } else {
+          HCTR_LIB_THROW(err);
+        }
+      }
+    }
+  }
+  return true;
+}
+
+template <typename TypeHashKey>
+ShardedEmbeddingCache<TypeHashKey>::ShardedEmbeddingCache(
+    const std::vector<std::shared_ptr<EmbeddingCacheBase>>& shards, const size_t shard_id)
+    : EmbeddingCacheBase(),
+      shards_(shards),
+      shard_id_(shard_id),
+      lookup_workers_("EC shard", shards.size()) {
+  HCTR_CHECK_HINT(shard_id_ < shards_.size(), "Invalid shard id.");
+  const embedding_cache_config& cache_config = local_()->get_cache_config();
+  max_num_keys_ = *std::max_element(cache_config.max_query_len_per_emb_table_.begin(),
+                                    cache_config.max_query_len_per_emb_table_.end());
+  max_embedding_size_ = *std::max_element(cache_config.embedding_vec_size_.begin(),
+                                          cache_config.embedding_vec_size_.end());
+
+  shard_streams_.resize(shards_.size(), nullptr);
+  for (size_t i = 0; i < shards_.size(); i++) {
+    if (i != shard_id_) {
+      CudaDeviceContext context(shards_[i]->get_device_id());
+      HCTR_LIB_THROW(cudaStreamCreateWithFlags(&shard_streams_[i], cudaStreamNonBlocking));
+    }
+  }
+  HCTR_LOG(INFO, ROOT, "Embedding cache on device %d is shard %zu of %zu.\n",
+           local_()->get_device_id(), shard_id_, shards_.size());
+}
+
+template <typename TypeHashKey>
+ShardedEmbeddingCache<TypeHashKey>::~ShardedEmbeddingCache() {
+  for (size_t i = 0; i < shards_.size(); i++) {
+    if (shard_streams_[i]) {
+      CudaDeviceContext context(shards_[i]->get_device_id());
+      cudaStreamDestroy(shard_streams_[i]);
+    }
+  }
+
+  CudaDeviceContext context(local_()->get_device_id());
+  for (const auto& scratch : scratch_pool_) {
+    cudaFree(scratch->d_keys);
+    cudaFree(scratch->d_shard_keys);
+    cudaFree(scratch->d_shard_index);
+    cudaFree(scratch->d_shard_emb_vec);
+    cudaFree(scratch->d_shard_offset);
+    cudaFree(scratch->d_shard_cursor);
+    cudaFreeHost(scratch->h_shard_offset);
+  }
+}
+
+template <typename TypeHashKey>
+typename ShardedEmbeddingCache<TypeHashKey>::Scratch*
+ShardedEmbeddingCache<TypeHashKey>::acquire_scratch_() {
+  const std::lock_guard<std::mutex> lock(scratch_mutex_);
+  if (!idle_scratch_.empty()) {
+    Scratch* const scratch = idle_scratch_.back();
+    idle_scratch_.pop_back();
+    return scratch;
+  }
+
+  // Allocate another set of buffers for each concurrent lookup. They are plain device
+  // allocations, because memory from stream-ordered pools is not accessible by peers.
+  const size_t num_shards = shards_.size();
+  auto scratch = std::make_unique<Scratch>();
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_keys),
+                            max_num_keys_ * sizeof(TypeHashKey)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_shard_keys),
+                            max_num_keys_ * sizeof(TypeHashKey)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_shard_index),
+                            max_num_keys_ * sizeof(uint64_t)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_shard_emb_vec),
+                            max_num_keys_ * max_embedding_size_ * sizeof(float)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_shard_offset),
+                            (num_shards + 1) * sizeof(size_t)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&scratch->d_shard_cursor),
+                            num_shards * sizeof(size_t)));
+  HCTR_LIB_THROW(cudaHostAlloc(reinterpret_cast<void**>(&scratch->h_shard_offset),
+                               (num_shards + 1) * sizeof(size_t), cudaHostAllocPortable));
+  scratch_pool_.emplace_back(std::move(scratch));
+  return scratch_pool_.back().get();
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::release_scratch_(Scratch* const scratch) {
+  const std::lock_guard<std::mutex> lock(scratch_mutex_);
+  idle_scratch_.push_back(scratch);
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::lookup_sharded_(const size_t table_id,
+                                                         float* const d_vectors,
+                                                         const TypeHashKey* const d_keys,
+                                                         const size_t num_keys,
+                                                         const float hit_rate_threshold,
+                                                         Scratch& scratch, cudaStream_t stream) {
+  const size_t num_shards = shards_.size();
+  const size_t emb_vec_size = local_()->get_cache_config().embedding_vec_size_[table_id];
+
+  // Group the keys by shard.
+  partition_keys_by_shard_async(d_keys, num_keys, num_shards, scratch.d_shard_keys,
+                                scratch.d_shard_index, scratch.d_shard_offset,
+                                scratch.d_shard_cursor, BLOCK_SIZE_, stream);
+  HCTR_LIB_THROW(cudaMemcpyAsync(scratch.h_shard_offset, scratch.d_shard_offset,
+                                 (num_shards + 1) * sizeof(size_t), cudaMemcpyDeviceToHost,
+                                 stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  // The remote shards read their keys from and write their vectors to the memory of this device.
+  std::vector<std::future<void>> remote_lookups;
+  for (size_t i = 0; i < num_shards; i++) {
+    const size_t offset = scratch.h_shard_offset[i];
+    const size_t length = scratch.h_shard_offset[i + 1] - offset;
+    if (i == shard_id_ || length == 0) {
+      continue;
+    }
+    remote_lookups.emplace_back(lookup_workers_.submit([this, i, table_id, offset, length,
+                                                        emb_vec_size, hit_rate_threshold,
+                                                        &scratch]() {
+      CudaDeviceContext context(shards_[i]->get_device_id());
+      shards_[i]->lookup_from_device(table_id, scratch.d_shard_emb_vec + offset * emb_vec_size,
+                                     scratch.d_shard_keys + offset, length, hit_rate_threshold,
+                                     shard_streams_[i]);
+      HCTR_LIB_THROW(cudaStreamSynchronize(shard_streams_[i]));
+    }));
+  }
+
+  // In the meantime, look up the keys of this device.
+  const size_t local_offset = scratch.h_shard_offset[shard_id_];
+  const size_t local_length = scratch.h_shard_offset[shard_id_ + 1] - local_offset;
+  if (local_length > 0) {
+    local_()->lookup_from_device(table_id, scratch.d_shard_emb_vec + local_offset * emb_vec_size,
+                                 scratch.d_shard_keys + local_offset, local_length,
+                                 hit_rate_threshold, stream);
+  }
+  for (auto& remote_lookup : remote_lookups) {
+    remote_lookup.get();
+  }
+
+  // Restore the order of the lookup.
+  merge_emb_vec_async(d_vectors, scratch.d_shard_emb_vec, scratch.d_shard_index, num_keys,
+                      emb_vec_size, BLOCK_SIZE_, stream);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::lookup(const size_t table_id, float* const d_vectors,
+                                                const void* const h_keys, const size_t num_keys,
+                                                const float hit_rate_threshold,
+                                                cudaStream_t stream) {
+  if (num_keys == 0) {
+    return;
+  }
+  HCTR_CHECK_HINT(num_keys <= max_num_keys_,
+                  "The number of keys exceeds the maximum query length of the embedding cache.");
+  Scratch* const scratch = acquire_scratch_();
+  HCTR_LIB_THROW(cudaMemcpyAsync(scratch->d_keys, h_keys, num_keys * sizeof(TypeHashKey),
+                                 cudaMemcpyHostToDevice, stream));
+  lookup_sharded_(table_id, d_vectors, scratch->d_keys, num_keys, hit_rate_threshold, *scratch,
+                  stream);
+  release_scratch_(scratch);
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::lookup_from_device(const size_t table_id,
+                                                            float* const d_vectors,
+                                                            const void* const d_keys,
+                                                            const size_t num_keys,
+                                                            const float hit_rate_threshold,
+                                                            cudaStream_t stream) {
+  if (num_keys == 0) {
+    return;
+  }
+  HCTR_CHECK_HINT(num_keys <= max_num_keys_,
+                  "The number of keys exceeds the maximum query length of the embedding cache.");
+  Scratch* const scratch = acquire_scratch_();
+  lookup_sharded_(table_id, d_vectors, static_cast<const TypeHashKey*>(d_keys), num_keys,
+                  hit_rate_threshold, *scratch, stream);
+  release_scratch_(scratch);
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::insert(const size_t table_id,
+                                                EmbeddingCacheWorkspace& workspace_handler,
+                                                cudaStream_t stream) {
+  local_()->insert(table_id, workspace_handler, stream);
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::init(const size_t table_id,
+                                              EmbeddingCacheRefreshspace& refreshspace_handler,
+                                              cudaStream_t stream) {
+  // Only warm up the local shard with the keys that it owns.
+  const size_t length = *refreshspace_handler.h_length_;
+  if (length == 0) {
+    return;
+  }
+  const size_t emb_vec_size = local_()->get_cache_config().embedding_vec_size_[table_id];
+  EmbeddingCacheRefreshspace shard_refreshspace = refreshspace_handler;
+  size_t shard_length;
+  HCTR_LIB_THROW(cudaMalloc(&shard_refreshspace.d_refresh_embeddingcolumns_,
+                            length * sizeof(TypeHashKey)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&shard_refreshspace.d_refresh_emb_vec_),
+                            length * emb_vec_size * sizeof(float)));
+  HCTR_LIB_THROW(
+      cudaMalloc(reinterpret_cast<void**>(&shard_refreshspace.d_length_), sizeof(size_t)));
+  shard_refreshspace.h_length_ = &shard_length;
+
+  select_shard_emb_vec_async(
+      static_cast<const TypeHashKey*>(refreshspace_handler.d_refresh_embeddingcolumns_),
+      refreshspace_handler.d_refresh_emb_vec_, length, emb_vec_size, shards_.size(), shard_id_,
+      static_cast<TypeHashKey*>(shard_refreshspace.d_refresh_embeddingcolumns_),
+      shard_refreshspace.d_refresh_emb_vec_, shard_refreshspace.d_length_, BLOCK_SIZE_, stream);
+  HCTR_LIB_THROW(cudaMemcpyAsync(&shard_length, shard_refreshspace.d_length_, sizeof(size_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  local_()->init(table_id, shard_refreshspace, stream);
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  HCTR_LIB_THROW(cudaFree(shard_refreshspace.d_refresh_embeddingcolumns_));
+  HCTR_LIB_THROW(cudaFree(shard_refreshspace.d_refresh_emb_vec_));
+  HCTR_LIB_THROW(cudaFree(shard_refreshspace.d_length_));
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::init(const size_t table_id,
+                                              void* const h_refresh_embeddingcolumns_,
+                                              void* const h_refresh_emb_vec_,
+                                              float* const h_quant_scales, const size_t h_length_,
+                                              cudaStream_t stream) {
+  local_()->init(table_id, h_refresh_embeddingcolumns_, h_refresh_emb_vec_, h_quant_scales,
+                 h_length_, stream);
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::dump(const size_t table_id, void* const d_keys,
+                                              size_t* const d_length, const size_t start_index,
+                                              const size_t end_index, cudaStream_t stream) {
+  local_()->dump(table_id, d_keys, d_length, start_index, end_index, stream);
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::refresh(const size_t table_id, const void* const d_keys,
+                                                 const void* const d_vectors, const size_t length,
+                                                 cudaStream_t stream) {
+  local_()->refresh(table_id, d_keys, d_vectors, length, stream);
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::finalize() {
+  lookup_workers_.await_idle();
+  local_()->finalize();
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::rebalance_capacity(cudaStream_t stream) {
+  local_()->rebalance_capacity(stream);
+}
+
+template <typename TypeHashKey>
+EmbeddingCacheWorkspace ShardedEmbeddingCache<TypeHashKey>::create_workspace() {
+  return local_()->create_workspace();
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::destroy_workspace(
+    EmbeddingCacheWorkspace& workspace_handler) {
+  local_()->destroy_workspace(workspace_handler);
+}
+
+template <typename TypeHashKey>
+EmbeddingCacheRefreshspace ShardedEmbeddingCache<TypeHashKey>::create_refreshspace() {
+  return local_()->create_refreshspace();
+}
+
+template <typename TypeHashKey>
+void ShardedEmbeddingCache<TypeHashKey>::destroy_refreshspace(
+    EmbeddingCacheRefreshspace& refreshspace_handler) {
+  local_()->destroy_refreshspace(refreshspace_handler);
+}
+
+template class ShardedEmbeddingCache<long long>;
+template class ShardedEmbeddingCache<unsigned int>;
+
+}  // namespace HugeCTR
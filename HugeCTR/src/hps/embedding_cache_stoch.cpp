@@ -46,12 +46,24 @@ static void parameter_server_insert_thread_func_2_(
     std::uniform_real_distribution<float> dist;
     float hist = dist(private_data->rd_);
     if (hist > workspace_handler.h_hit_rate_[table_id]) {
-      embedding_cache->Replace(
-          table_id,
-          static_cast<TypeHashKey*>(workspace_handler.h_missing_embeddingcolumns_[table_id]),
-          workspace_handler.h_missing_length_[table_id],
-          workspace_handler.d_missing_emb_vec_[table_id], workspace_handler.h_hit_rate_[table_id],
-          private_data->modify_handle_, private_data->modify_event_, stream);
+      if (embedding_cache->has_admission_filter()) {
+        const size_t admitted_length = embedding_cache->admit(table_id, workspace_handler, stream);
+        if (admitted_length > 0) {
+          embedding_cache->Replace(table_id, private_data->h_admitted_embeddingcolumns_,
+                                   admitted_length, private_data->d_admitted_emb_vec_,
+                                   workspace_handler.h_hit_rate_[table_id],
+                                   private_data->modify_handle_, private_data->modify_event_,
+                                   stream);
+        }
+      } else {
+        embedding_cache->Replace(
+            table_id,
+            static_cast<TypeHashKey*>(workspace_handler.h_missing_embeddingcolumns_[table_id]),
+            workspace_handler.h_missing_length_[table_id],
+            workspace_handler.d_missing_emb_vec_[table_id],
+            workspace_handler.h_hit_rate_[table_id], private_data->modify_handle_,
+            private_data->modify_event_, stream);
+      }
     }
 
     parameter_server->free_buffer(memory_block);
@@ -81,6 +93,9 @@ EmbeddingCacheStoch<TypeHashKey>::EmbeddingCacheStoch(
       b2s(inference_params.use_hctr_cache_implementation), inference_params.cache_size_percentage);
   HCTR_LOG(INFO, ROOT, "Use static table: %s\n", b2s(inference_params.use_static_table));
   HCTR_LOG(INFO, ROOT, "Use I64 input key: %s\n", b2s(inference_params.i64_input_key));
+  HCTR_LOG(INFO, ROOT, "Deduplicate keys: %s\n", b2s(inference_params.deduplicate_keys));
+  HCTR_LOG(INFO, ROOT, "Embedding cache admission threshold: %zu\n",
+           inference_params.embedding_cache_admission_threshold);
   HCTR_LOG(INFO, ROOT, "Configured cache hit rate threshold: %f\n",
            inference_params.hit_rate_threshold);
   HCTR_LOG(INFO, ROOT, "The size of thread pool: %u\n",
@@ -106,6 +121,14 @@ EmbeddingCacheStoch<TypeHashKey>::EmbeddingCacheStoch(
   cache_config_.cuda_dev_id_ = inference_params.device_id;
   cache_config_.use_gpu_embedding_cache_ = inference_params.use_gpu_embedding_cache;
   cache_config_.use_hctr_cache_implementation = inference_params.use_hctr_cache_implementation;
+  cache_config_.deduplicate_keys_ = inference_params.deduplicate_keys;
+  cache_config_.admission_threshold_ =
+      static_cast<uint32_t>(inference_params.embedding_cache_admission_threshold);
+  // The slot pools of the stochastic cache are sized once and not rebalanced.
+  cache_config_.adaptive_cache_sizing_ = false;
+  cache_config_.lock_free_query_ = false;
+  cache_config_.shared_cache_dir_.clear();
+  cache_config_.shared_cache_owner_ = true;
   if (ps_config.embedding_vec_size_.find(inference_params.model_name) ==
           ps_config.embedding_vec_size_.end() ||
       ps_config.emb_table_name_.find(inference_params.model_name) ==
@@ -173,6 +196,15 @@ EmbeddingCacheStoch<TypeHashKey>::EmbeddingCacheStoch(
       lookup_handle_map_vec_.emplace_back(lookup_map);
     }
 
+    if (cache_config_.admission_threshold_ > 1) {
+      admission_filters_.reserve(cache_config_.num_emb_table_);
+      for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+        admission_filters_.emplace_back(std::make_unique<gpu_cache::admission_filter<TypeHashKey>>(
+            SLAB_SIZE * SET_ASSOCIATIVITY * cache_config_.num_set_in_cache_[i],
+            cache_config_.admission_threshold_));
+      }
+    }
+
     insert_streams_.reserve(cache_config_.num_emb_table_);
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
       cudaStream_t stream;
@@ -283,6 +315,7 @@ EmbeddingCacheStoch<TypeHashKey>::~EmbeddingCacheStoch() {
     }
     refresh_private_data_.clear();
 
+    admission_filters_.clear();
     gpu_emb_caches_.clear();
 
     // clear vectors
@@ -369,7 +402,7 @@ void EmbeddingCacheStoch<TypeHashKey>::lookup_from_device(
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
     BaseUnit* start = profiler::start();
     // Unique
-    const bool m_bUnique = false;
+    const bool m_bUnique{cache_config_.deduplicate_keys_};
     if (m_bUnique) {
       static_cast<UniqueOp*>(workspace_handler.unique_op_obj_[table_id])
           ->unique(static_cast<TypeHashKey*>(workspace_handler.d_embeddingcolumns_[table_id]),
@@ -437,17 +470,20 @@ void EmbeddingCacheStoch<TypeHashKey>::lookup_from_device(
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
     if (insert_flag) {
       std::lock_guard<std::mutex> lock(mutex_);
-      insert_workers_.submit([this, self(this->shared_from_this()), table_id, memory_block]() {
-        parameter_server_insert_thread_func_2_<TypeHashKey>(table_id, parameter_server_, self,
-                                                            memory_block, insert_streams_[table_id],
-                                                            stream_mutex_);
-      });
+      insert_workers_.submit(
+          [this, self(this->shared_from_this()), table_id, memory_block]() {
+            parameter_server_insert_thread_func_2_<TypeHashKey>(
+                table_id, parameter_server_, self, memory_block, insert_streams_[table_id],
+                stream_mutex_);
+          },
+          ThreadPool::Priority::Background);
     }
     // Wait for memory copy to complete
 
     ec_profiler_->end(start, "Missing key synchronization insert into Embedding Cache");
     start = profiler::start();
-    merge_emb_vec_async(d_vectors, workspace_handler.d_missing_emb_vec_[table_id],
+    merge_emb_vec_async(m_bUnique ? workspace_handler.d_hit_emb_vec_[table_id] : d_vectors,
+                        workspace_handler.d_missing_emb_vec_[table_id],
                         workspace_handler.d_missing_index_[table_id],
                         workspace_handler.h_missing_length_[table_id],
                         cache_config_.embedding_vec_size_[table_id], BLOCK_SIZE_, stream);
@@ -500,6 +536,36 @@ void EmbeddingCacheStoch<TypeHashKey>::Replace(const size_t table_id, const Type
   }
 }
 
+template <typename TypeHashKey>
+size_t EmbeddingCacheStoch<TypeHashKey>::admit(const size_t table_id,
+                                               EmbeddingCacheWorkspace& workspace_handler,
+                                               cudaStream_t stream) {
+  CudaDeviceContext dev_restorer;
+  dev_restorer.check_device(cache_config_.cuda_dev_id_);
+  WorkspacePrivateData* private_data =
+      reinterpret_cast<WorkspacePrivateData*>(workspace_handler.private_data_[table_id]);
+
+  admission_filters_[table_id]->Filter(
+      static_cast<TypeHashKey*>(workspace_handler.d_missing_embeddingcolumns_[table_id]),
+      workspace_handler.h_missing_length_[table_id],
+      workspace_handler.d_missing_emb_vec_[table_id], cache_config_.embedding_vec_size_[table_id],
+      private_data->d_admitted_embeddingcolumns_, private_data->d_admitted_emb_vec_,
+      private_data->d_admitted_length_, stream);
+  HCTR_LIB_THROW(cudaMemcpyAsync(private_data->h_admitted_length_,
+                                 private_data->d_admitted_length_, sizeof(size_t),
+                                 cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  // The ecache Modify API consumes the keys from host memory
+  const size_t admitted_length = *private_data->h_admitted_length_;
+  HCTR_LIB_THROW(cudaMemcpyAsync(private_data->h_admitted_embeddingcolumns_,
+                                 private_data->d_admitted_embeddingcolumns_,
+                                 admitted_length * sizeof(TypeHashKey), cudaMemcpyDeviceToHost,
+                                 stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  return admitted_length;
+}
+
 // insert
 template <typename TypeHashKey>
 void EmbeddingCacheStoch<TypeHashKey>::insert(const size_t table_id,
@@ -690,6 +756,28 @@ EmbeddingCacheWorkspace EmbeddingCacheStoch<TypeHashKey>::create_workspace() {
                                               cache_config_.max_query_len_per_emb_table_[i]);
       gpu_emb_caches_[i]->LookupContextCreate(private_data_ptr->lookup_handle_, nullptr, 0);
       HCTR_LIB_THROW(cudaEventCreate(&private_data_ptr->modify_event_));
+      private_data_ptr->d_admitted_embeddingcolumns_ = nullptr;
+      private_data_ptr->h_admitted_embeddingcolumns_ = nullptr;
+      private_data_ptr->d_admitted_emb_vec_ = nullptr;
+      private_data_ptr->d_admitted_length_ = nullptr;
+      private_data_ptr->h_admitted_length_ = nullptr;
+      if (has_admission_filter()) {
+        const size_t max_query_len = cache_config_.max_query_len_per_emb_table_[i];
+        HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(
+                                      &private_data_ptr->d_admitted_embeddingcolumns_),
+                                  max_query_len * sizeof(TypeHashKey)));
+        HCTR_LIB_THROW(cudaHostAlloc(reinterpret_cast<void**>(
+                                         &private_data_ptr->h_admitted_embeddingcolumns_),
+                                     max_query_len * sizeof(TypeHashKey), cudaHostAllocPortable));
+        HCTR_LIB_THROW(cudaMalloc(
+            reinterpret_cast<void**>(&private_data_ptr->d_admitted_emb_vec_),
+            max_query_len * cache_config_.embedding_vec_size_[i] * sizeof(float)));
+        HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&private_data_ptr->d_admitted_length_),
+                                  sizeof(size_t)));
+        HCTR_LIB_THROW(
+            cudaHostAlloc(reinterpret_cast<void**>(&private_data_ptr->h_admitted_length_),
+                          sizeof(size_t), cudaHostAllocPortable));
+      }
       workspace_handler.private_data_.push_back(private_data_ptr);
     }
   }
@@ -751,6 +839,13 @@ void EmbeddingCacheStoch<TypeHashKey>::destroy_workspace(
       gpu_emb_caches_[i]->LookupContextDestroy(private_data_ptr->lookup_handle_);
       HCTR_LIB_THROW(cudaEventSynchronize(private_data_ptr->modify_event_));
       HCTR_LIB_THROW(cudaEventDestroy(private_data_ptr->modify_event_));
+      if (has_admission_filter()) {
+        HCTR_LIB_THROW(cudaFree(private_data_ptr->d_admitted_embeddingcolumns_));
+        HCTR_LIB_THROW(cudaFreeHost(private_data_ptr->h_admitted_embeddingcolumns_));
+        HCTR_LIB_THROW(cudaFree(private_data_ptr->d_admitted_emb_vec_));
+        HCTR_LIB_THROW(cudaFree(private_data_ptr->d_admitted_length_));
+        HCTR_LIB_THROW(cudaFreeHost(private_data_ptr->h_admitted_length_));
+      }
       delete private_data_ptr;
     }
   }
@@ -773,6 +868,7 @@ EmbeddingCacheRefreshspace EmbeddingCacheStoch<TypeHashKey>::create_refreshspace
     cache_config_.num_set_in_refresh_workspace_ =
         (max_num_key_in_buffer + SLAB_SIZE * SET_ASSOCIATIVITY - 1) /
         (SLAB_SIZE * SET_ASSOCIATIVITY);
+    cache_config_.max_num_keys_in_refresh_workspace_ = max_num_key_in_buffer;
 
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
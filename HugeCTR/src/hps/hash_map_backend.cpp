@@ -14,14 +14,25 @@
  * limitations under the License.
  */
 
+#include <fcntl.h>
+#include <numa.h>
+#include <numaif.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <atomic>
+#include <cerrno>
 #include <core23/logger.hpp>
 #include <cstring>
 #include <execution>
+#include <filesystem>
+#include <fstream>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hash_map_backend_detail.hpp>
 #include <hps/hier_parameter_server_base.hpp>
+#include <mutex>
 #include <random>
 
 // TODO: Remove me!
@@ -29,9 +40,166 @@
 
 namespace HugeCTR {
 
+namespace {
+
+/**
+ * Number of huge pages of the specified size currently available in the system's pool.
+ */
+size_t num_free_huge_pages(const size_t huge_page_size) {
+  std::ifstream file{std::filesystem::path{"/sys/kernel/mm/hugepages"} /
+                     ("hugepages-" + std::to_string(huge_page_size / 1024) + "kB") /
+                     "free_hugepages"};
+  size_t num_pages{0};
+  if (file) {
+    file >> num_pages;
+  }
+  return num_pages;
+}
+
+/**
+ * Snapshot file layout (one file per partition):
+ *
+ *   HashMapSnapshotHeader
+ *   uint64_t meta[num_entries]   (`Payload::access_count` / `Payload::last_access`)
+ *   Key keys[num_entries]
+ *   <padding>
+ *   char values[num_entries][value_stride]   (starting at `values_offset`, page aligned)
+ */
+struct HashMapSnapshotHeader final {
+  uint64_t magic;
+  uint32_t key_size;
+  uint32_t value_size;
+  uint64_t value_stride;
+  uint64_t num_partitions;
+  uint64_t num_entries;
+  uint64_t values_offset;
+};
+
+constexpr uint64_t hash_map_snapshot_magic{0x3170616e53534850};  // "HPSSnap1"
+
+}  // namespace
+
+template <typename Key>
+char* HashMapBackend<Key>::CharAllocator::allocate(const size_t n) const {
+  if (!huge_page_size) {
+    return AlignedAllocator<char>::allocate(n);
+  }
+
+  // Mappings always span entire huge pages.
+  const size_t size{(n + huge_page_size - 1) / huge_page_size * huge_page_size};
+
+  // Attempt to reserve explicit huge pages.
+  const int huge_page_flag{static_cast<int>(__builtin_ctzll(huge_page_size)) << MAP_HUGE_SHIFT};
+  void* p{mmap(nullptr, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_page_flag, -1, 0)};
+
+  // Fall back to transparent huge pages.
+  if (p == MAP_FAILED) {
+    static std::once_flag warn_once;
+    std::call_once(warn_once, [&]() {
+      HCTR_LOG_C(WARNING, WORLD, "Unable to reserve ", size, " bytes from the huge page pool (",
+                 huge_page_size, " bytes per page). Falling back to transparent huge pages.\n");
+    });
+
+    p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    madvise(p, size, MADV_HUGEPAGE);
+  }
+  return static_cast<char*>(p);
+}
+
+template <typename Key>
+void HashMapBackend<Key>::CharAllocator::deallocate(char* const p, const size_t n) const noexcept {
+  if (!huge_page_size) {
+    AlignedAllocator<char>::deallocate(p, n);
+    return;
+  }
+
+  const size_t size{(n + huge_page_size - 1) / huge_page_size * huge_page_size};
+  munmap(p, size);
+}
+
 template <typename Key>
 HashMapBackend<Key>::HashMapBackend(const HashMapBackendParams& params) : Base(params) {
+  if (params.huge_page_size) {
+    HCTR_CHECK_HINT(params.huge_page_size == 2L * 1024 * 1024 ||
+                        params.huge_page_size == 1024L * 1024 * 1024,
+                    "Unsupported huge page size (", params.huge_page_size,
+                    " bytes). Must be 2 MiB or 1 GiB.");
+    char_allocator_.huge_page_size = params.huge_page_size;
+
+    const size_t num_pages{num_free_huge_pages(params.huge_page_size)};
+    if (num_pages) {
+      HCTR_LOG_C(INFO, WORLD, get_name(), " backend; ", num_pages, " huge pages of ",
+                 params.huge_page_size, " bytes are available.\n");
+    } else {
+      HCTR_LOG_C(WARNING, WORLD, get_name(), " backend; No huge pages of ", params.huge_page_size,
+                 " bytes are reserved. Will use transparent huge pages instead.\n");
+    }
+  }
+
+  if (params.numa_aware) {
+    if (numa_available() < 0) {
+      HCTR_LOG_C(WARNING, WORLD, get_name(),
+                 " backend; NUMA-aware placement was requested, but NUMA is not supported by this "
+                 "system. Falling back to default placement.\n");
+    } else {
+      const int num_nodes{numa_num_configured_nodes()};
+      for (int node{0}; node < num_nodes; ++node) {
+        numa_thread_pools_.emplace_back(
+            std::make_unique<ThreadPool>("hps_numa" + std::to_string(node), 0, node));
+      }
+      HCTR_LOG_C(INFO, WORLD, get_name(), " backend; Distributing partitions across ", num_nodes,
+                 " NUMA nodes.\n");
+    }
+  }
+
   HCTR_LOG_C(DEBUG, WORLD, "Created blank database backend in local memory!\n");
+
+  if (!params.snapshot_path.empty()) {
+    restore_snapshots_();
+
+    if (params.snapshot_interval.count() > 0) {
+      snapshot_thread_ = std::thread([this]() {
+        const auto terminate{[this]() { return snapshot_thread_terminate_; }};
+        std::unique_lock lock(snapshot_thread_guard_);
+        while (!snapshot_thread_semaphore_.wait_for(lock, this->params_.snapshot_interval,
+                                                    terminate)) {
+          lock.unlock();
+          try {
+            snapshot();
+          } catch (DatabaseBackendError& e) {
+            HCTR_LOG_C(ERROR, WORLD, get_name(), " backend; Snapshot failed: ", e.to_string(),
+                       '\n');
+          }
+          lock.lock();
+        }
+      });
+    }
+  }
+}
+
+template <typename Key>
+HashMapBackend<Key>::~HashMapBackend() {
+  if (snapshot_thread_.joinable()) {
+    {
+      const std::lock_guard lock(snapshot_thread_guard_);
+      snapshot_thread_terminate_ = true;
+    }
+    snapshot_thread_semaphore_.notify_all();
+    snapshot_thread_.join();
+  }
+
+  // Final snapshot, so that a graceful restart does not lose recent updates.
+  if (!this->params_.snapshot_path.empty()) {
+    try {
+      snapshot();
+    } catch (DatabaseBackendError& e) {
+      HCTR_LOG_C(ERROR, WORLD, get_name(), " backend; Snapshot failed: ", e.to_string(), '\n');
+    }
+  }
 }
 
 template <typename Key>
@@ -43,10 +211,13 @@ size_t HashMapBackend<Key>::size(const std::string& table_name) const {
   if (tables_it == tables_.end()) {
     return 0;
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
 
   return std::accumulate(parts.begin(), parts.end(), UINT64_C(0),
-                         [](const size_t a, const Partition& b) { return a + b.entries.size(); });
+                         [](const size_t a, const Partition& b) {
+                           const std::shared_lock part_lock(b.read_write_guard);
+                           return a + b.entries.size();
+                         });
 }
 
 template <typename Key>
@@ -61,7 +232,7 @@ size_t HashMapBackend<Key>::contains(const std::string& table_name, const size_t
   if (tables_it == tables_.end()) {
     return Base::contains(table_name, num_keys, keys, time_budget);
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
 
   const Key* const keys_end{&keys[num_keys]};
   const size_t num_partitions{parts.size()};
@@ -75,6 +246,7 @@ size_t HashMapBackend<Key>::contains(const std::string& table_name, const size_t
   } else if (num_keys == 1 || num_partitions == 1) {
     const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
     const Partition& part{parts[part_index]};
+    const std::shared_lock part_lock(part.read_write_guard);
 
     // Step through keys batch-by-batch.
     std::chrono::nanoseconds elapsed;
@@ -94,8 +266,9 @@ size_t HashMapBackend<Key>::contains(const std::string& table_name, const size_t
     std::atomic<size_t> joint_hit_count{0};
     std::atomic<size_t> joint_skip_count{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       const Partition& part{parts[part_index]};
+      const std::shared_lock part_lock(part.read_write_guard);
 
       size_t hit_count{0};
 
@@ -132,19 +305,17 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
                                    const uint32_t value_size, const size_t value_stride) {
   HCTR_CHECK(value_size <= value_stride);
 
-  const std::unique_lock lock(read_write_guard_);
+  std::shared_lock lock(read_write_guard_);
 
   // Locate the partitions, or create them, if they do not exist yet.
-  const auto& tables_it{tables_.try_emplace(table_name).first};
-  std::vector<Partition>& parts{tables_it->second};
-  if (parts.empty()) {
-    HCTR_CHECK(value_size > 0 && value_size <= this->params_.allocation_rate);
-
-    parts.reserve(this->params_.num_partitions);
-    while (parts.size() < this->params_.num_partitions) {
-      parts.emplace_back(value_size, this->params_);
-    }
+  auto tables_it{tables_.find(table_name)};
+  while (tables_it == tables_.end()) {
+    lock.unlock();
+    create_table_(table_name, value_size);
+    lock.lock();
+    tables_it = tables_.find(table_name);
   }
+  PartitionList& parts{tables_it->second};
 
   const Key* const keys_end{&keys[num_pairs]};
   const size_t num_partitions{parts.size()};
@@ -159,11 +330,12 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
     const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
     Partition& part{parts[part_index]};
     HCTR_CHECK(part.value_size == value_size);
+    const std::unique_lock part_lock(part.read_write_guard);
 
     // Step through batch-by-batch.
     for (const Key* k{keys}; k != keys_end;) {
       // Check overflow condition.
-      if (part.entries.size() >= this->params_.overflow_margin) {
+      if (part.entries.size() >= part.overflow_margin) {
         resolve_overflow_(table_name, part_index, part);
       }
 
@@ -180,9 +352,10 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
   } else {
     std::atomic<size_t> joint_num_inserts{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       Partition& part{parts[part_index]};
       HCTR_CHECK(part.value_size == value_size);
+      const std::unique_lock part_lock(part.read_write_guard);
 
       size_t num_inserts{0};
 
@@ -190,7 +363,7 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
       size_t num_batches{0};
       for (const Key* k{keys}; k != keys_end; ++num_batches) {
         // Check overflow condition.
-        if (part.entries.size() >= this->params_.overflow_margin) {
+        if (part.entries.size() >= part.overflow_margin) {
           resolve_overflow_(table_name, part_index, part);
         }
 
@@ -229,7 +402,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
   if (tables_it == tables_.end()) {
     return Base::fetch(table_name, num_keys, keys, values, value_stride, on_miss, time_budget);
   }
-  std::vector<Partition>& parts{tables_it->second};
+  PartitionList& parts{tables_it->second};
 
   const Key* const keys_end{&keys[num_keys]};
   const size_t num_partitions{parts.size()};
@@ -245,6 +418,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
     Partition& part{parts[part_index]};
     HCTR_CHECK(part.value_size <= value_stride);
+    const std::shared_lock part_lock(part.read_write_guard);
 
     // Step through input batch-by-batch.
     std::chrono::nanoseconds elapsed;
@@ -264,9 +438,10 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     std::atomic<size_t> joint_miss_count{0};
     std::atomic<size_t> joint_skip_count{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       Partition& part{parts[part_index]};
       HCTR_CHECK(part.value_size <= value_stride);
+      const std::shared_lock part_lock(part.read_write_guard);
 
       size_t miss_count{0};
 
@@ -314,7 +489,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     return Base::fetch(table_name, num_indices, indices, keys, values, value_stride, on_miss,
                        time_budget);
   }
-  std::vector<Partition>& parts{tables_it->second};
+  PartitionList& parts{tables_it->second};
 
   const size_t* const indices_end{&indices[num_indices]};
   const size_t num_partitions{parts.size()};
@@ -330,6 +505,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
     Partition& part{parts[part_index]};
     HCTR_CHECK(part.value_size <= value_stride);
+    const std::shared_lock part_lock(part.read_write_guard);
 
     // Step through input batch-by-batch.
     std::chrono::nanoseconds elapsed;
@@ -349,9 +525,10 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     std::atomic<size_t> joint_miss_count{0};
     std::atomic<size_t> joint_skip_count{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       Partition& part{parts[part_index]};
       HCTR_CHECK(part.value_size <= value_stride);
+      const std::shared_lock part_lock(part.read_write_guard);
 
       size_t miss_count{0};
 
@@ -393,7 +570,7 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name) {
   if (tables_it == tables_.end()) {
     return 0;
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
 
   // Count items and erase.
   size_t num_deletions{0};
@@ -402,6 +579,13 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name) {
   }
   tables_.erase(tables_it);
 
+  // Drop the snapshot as well. Otherwise, the table would reappear after a restart.
+  if (!this->params_.snapshot_path.empty()) {
+    std::error_code ec;
+    std::filesystem::remove_all(std::filesystem::path{this->params_.snapshot_path} / table_name,
+                                ec);
+  }
+
   HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
              " entries.\n");
   return num_deletions;
@@ -410,14 +594,14 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name) {
 template <typename Key>
 size_t HashMapBackend<Key>::evict(const std::string& table_name, const size_t num_keys,
                                   const Key* const keys) {
-  const std::unique_lock lock(read_write_guard_);
+  const std::shared_lock lock(read_write_guard_);
 
   // Locate the partitions.
   const auto& tables_it{tables_.find(table_name)};
   if (tables_it == tables_.end()) {
     return 0;
   }
-  std::vector<Partition>& parts{tables_it->second};
+  PartitionList& parts{tables_it->second};
 
   const Key* const keys_end{&keys[num_keys]};
   const size_t num_partitions{parts.size()};
@@ -430,6 +614,7 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name, const size_t nu
   } else if (num_keys == 1 || num_partitions == 1) {
     const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
     Partition& part{parts[part_index]};
+    const std::unique_lock part_lock(part.read_write_guard);
 
     // Step through input batch-by-batch.
     for (const Key* k{keys}; k != keys_end;) {
@@ -444,8 +629,9 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name, const size_t nu
   } else {
     std::atomic<size_t> joint_num_deletions{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       Partition& part{parts[part_index]};
+      const std::unique_lock part_lock(part.read_write_guard);
 
       size_t num_deletions{0};
 
@@ -496,7 +682,7 @@ size_t HashMapBackend<Key>::dump_bin(const std::string& table_name, std::ofstrea
   if (tables_it == tables_.end()) {
     return 0;
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
 
   // Store value size.
   const uint32_t value_size{parts.empty() ? 0 : parts.front().value_size};
@@ -506,6 +692,7 @@ size_t HashMapBackend<Key>::dump_bin(const std::string& table_name, std::ofstrea
   size_t num_entries{0};
 
   for (const Partition& part : parts) {
+    const std::shared_lock part_lock(part.read_write_guard);
     for (const Entry& entry : part.entries) {
       file.write(reinterpret_cast<const char*>(&entry.first), sizeof(Key));
       file.write(entry.second.value, value_size);
@@ -525,7 +712,14 @@ size_t HashMapBackend<Key>::dump_sst(const std::string& table_name, rocksdb::Sst
   if (tables_it == tables_.end()) {
     return 0;
   }
-  const std::vector<Partition>& parts{tables_it->second};
+  const PartitionList& parts{tables_it->second};
+
+  // Entries are referenced until written. So we must hold all partition locks until the end.
+  std::vector<std::shared_lock<std::shared_mutex>> part_locks;
+  part_locks.reserve(parts.size());
+  for (const Partition& part : parts) {
+    part_locks.emplace_back(part.read_write_guard);
+  }
 
   // Sort keys by value.
   std::vector<const Entry*> entries;
@@ -555,6 +749,129 @@ size_t HashMapBackend<Key>::dump_sst(const std::string& table_name, rocksdb::Sst
   return entries.size();
 }
 
+template <typename Key>
+size_t HashMapBackend<Key>::snapshot() {
+  HCTR_CHECK_HINT(!this->params_.snapshot_path.empty(), "Snapshots are disabled.");
+  const std::lock_guard snapshot_lock(snapshot_guard_);
+  const auto begin{std::chrono::high_resolution_clock::now()};
+
+  std::vector<std::string> table_names;
+  {
+    const std::shared_lock lock(read_write_guard_);
+    table_names.reserve(tables_.size());
+    for (const auto& table : tables_) {
+      table_names.emplace_back(table.first);
+    }
+  }
+
+  size_t num_entries{0};
+  for (const std::string& table_name : table_names) {
+    // The table directory may only change while we are not writing the table.
+    const std::shared_lock lock(read_write_guard_);
+    const auto& tables_it{tables_.find(table_name)};
+    if (tables_it == tables_.end()) {
+      continue;
+    }
+    const PartitionList& parts{tables_it->second};
+
+    const std::filesystem::path dir{std::filesystem::path{this->params_.snapshot_path} /
+                                    table_name};
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+      throw DatabaseBackendError(get_name(), 0,
+                                 "Unable to create directory '" + dir.string() + "'.");
+    }
+
+    for (size_t part_index{0}; part_index != parts.size(); ++part_index) {
+      const Partition& part{parts[part_index]};
+      const std::filesystem::path path{dir / std::to_string(part_index)};
+      const std::filesystem::path tmp_path{path.string() + ".tmp"};
+
+      // Write to a temporary file first, so that a crash never leaves a partial snapshot behind.
+      {
+        const std::shared_lock part_lock(part.read_write_guard);
+        num_entries += snapshot_partition_(tmp_path, part);
+      }
+      std::filesystem::rename(tmp_path, path, ec);
+      if (ec) {
+        throw DatabaseBackendError(get_name(), part_index,
+                                   "Unable to replace snapshot '" + path.string() + "'.");
+      }
+    }
+  }
+
+  const auto elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() - begin)};
+  HCTR_LOG_C(INFO, WORLD, get_name(), " backend; Wrote snapshot of ", table_names.size(),
+             " tables (", num_entries, " entries) in ", elapsed.count(), " ms.\n");
+  return num_entries;
+}
+
+template <typename Key>
+void HashMapBackend<Key>::create_table_(const std::string& table_name, const uint32_t value_size) {
+  const std::unique_lock lock(read_write_guard_);
+
+  PartitionList& parts{tables_.try_emplace(table_name).first->second};
+  if (parts.empty()) {
+    HCTR_CHECK(value_size > 0 && value_size <= this->params_.allocation_rate);
+
+    const size_t overflow_margin{this->params_.table_overflow_margin(table_name)};
+    while (parts.size() < this->params_.num_partitions) {
+      // Assign partitions round-robin to NUMA nodes.
+      const int numa_node{numa_thread_pools_.empty()
+                              ? -1
+                              : static_cast<int>(parts.size() % numa_thread_pools_.size())};
+      parts.emplace_back(value_size, this->params_, overflow_margin, numa_node);
+    }
+  }
+}
+
+template <typename Key>
+void HashMapBackend<Key>::allocate_value_page_(Partition& part) {
+  const size_t stride{(part.value_size + value_page_alignment - 1) / value_page_alignment *
+                      value_page_alignment};
+
+  // With huge pages, round up to fill entire pages.
+  size_t page_size{part.allocation_rate};
+  if (char_allocator_.huge_page_size) {
+    const size_t huge_page_size{char_allocator_.huge_page_size};
+    page_size = (page_size + huge_page_size - 1) / huge_page_size * huge_page_size;
+  }
+  const size_t num_values{page_size / stride};
+  HCTR_CHECK(num_values > 0);
+
+  // Get more memory.
+  ValuePage& value_page{part.value_pages.emplace_back(num_values * stride, char_allocator_)};
+
+  // Migrate the page to the NUMA node that owns the partition. Only whole OS pages can be moved.
+  if (part.numa_node >= 0) {
+    const uintptr_t os_page_size{static_cast<uintptr_t>(sysconf(_SC_PAGESIZE))};
+    const uintptr_t first{(reinterpret_cast<uintptr_t>(value_page.data()) + os_page_size - 1) &
+                          ~(os_page_size - 1)};
+    const uintptr_t last{reinterpret_cast<uintptr_t>(value_page.data() + value_page.size()) &
+                         ~(os_page_size - 1)};
+
+    if (first < last) {
+      bitmask* const node_mask{numa_allocate_nodemask()};
+      numa_bitmask_setbit(node_mask, static_cast<unsigned int>(part.numa_node));
+      if (mbind(reinterpret_cast<void*>(first), last - first, MPOL_BIND, node_mask->maskp,
+                node_mask->size + 1, MPOL_MF_MOVE) != 0) {
+        HCTR_LOG_C(WARNING, WORLD, get_name(), " backend; Unable to bind value page to NUMA node ",
+                   part.numa_node, " (errno = ", errno, ").\n");
+      }
+      numa_free_nodemask(node_mask);
+    }
+  }
+
+  // Stock up slot references.
+  part.value_slots.reserve(part.value_slots.size() + num_values);
+  for (auto it{value_page.end()}; it != value_page.begin();) {
+    it -= stride;
+    part.value_slots.emplace_back(&*it);
+  }
+}
+
 template <typename Key>
 size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
                                               const size_t part_index, Partition& part) {
@@ -584,16 +901,15 @@ size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
         const size_t batch_size{std::min<size_t>(keys.end() - k_it, max_batch_size)};
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                   " is overflowing (size = ", part.entries.size(), " > ",
-                   this->params_.overflow_margin, "): Attempting to evict ", batch_size,
-                   " RANDOM key/value pairs!\n");
+                   " is overflowing (size = ", part.entries.size(), " > ", part.overflow_margin,
+                   "): Attempting to evict ", batch_size, " RANDOM key/value pairs!\n");
 
         // Call erase, until we reached the target amount.
         for (const auto& batch_end{k_it + batch_size}; k_it != batch_end; ++k_it) {
           const Key* const k{&*k_it};
           HCTR_HPS_HASH_MAP_EVICT_K_();
         }
-        if (part.entries.size() <= this->overflow_resolution_margin_) {
+        if (part.entries.size() <= part.overflow_resolution_margin) {
           break;
         }
       }
@@ -617,15 +933,14 @@ size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
         const size_t batch_size{std::min<size_t>(keys_metas.end() - km_it, max_batch_size)};
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                   " is overflowing (size = ", part.entries.size(), " > ",
-                   this->params_.overflow_margin, "): Attempting to evict ", batch_size,
-                   " LEAST USED key/value pairs!\n");
+                   " is overflowing (size = ", part.entries.size(), " > ", part.overflow_margin,
+                   "): Attempting to evict ", batch_size, " LEAST USED key/value pairs!\n");
 
         for (const auto& batch_end{km_it + batch_size}; km_it != batch_end; ++km_it) {
           const Key* const k{&km_it->first};
           HCTR_HPS_HASH_MAP_EVICT_K_();
         }
-        if (part.entries.size() <= this->overflow_resolution_margin_) {
+        if (part.entries.size() <= part.overflow_resolution_margin) {
           break;
         }
       }
@@ -667,24 +982,227 @@ size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
         const size_t batch_size{std::min<size_t>(keys_metas.end() - km_it, max_batch_size)};
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                   " is overflowing (size = ", part.entries.size(), " > ",
-                   this->params_.overflow_margin, "): Attempting to evict ", batch_size,
-                   " OLDEST key/value pairs!\n");
+                   " is overflowing (size = ", part.entries.size(), " > ", part.overflow_margin,
+                   "): Attempting to evict ", batch_size, " OLDEST key/value pairs!\n");
 
         for (const auto& batch_end{km_it + batch_size}; km_it != batch_end; ++km_it) {
           const Key* const k{&km_it->first};
           HCTR_HPS_HASH_MAP_EVICT_K_();
         }
-        if (part.entries.size() <= this->overflow_resolution_margin_) {
+        if (part.entries.size() <= part.overflow_resolution_margin) {
           break;
         }
       }
     } break;
+
+    case DatabaseOverflowPolicy_t::EvictClock: {
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 " is overflowing (size = ", part.entries.size(), " > ", part.overflow_margin,
+                 "): Sweeping CLOCK to evict ",
+                 part.entries.size() - part.overflow_resolution_margin, " key/value pairs!\n");
+
+      // Resume where the previous sweep stopped. Erasing does not invalidate other iterators.
+      auto it{part.clock_hand ? part.entries.find(*part.clock_hand) : part.entries.end()};
+      while (part.entries.size() > part.overflow_resolution_margin) {
+        if (it == part.entries.end()) {
+          it = part.entries.begin();
+        }
+
+        Payload& payload{it->second};
+        if (payload.access_count) {
+          // Referenced since last pass. Give the entry another chance.
+          --payload.access_count;
+          ++it;
+        } else {
+          part.value_slots.emplace_back(payload.value);
+          part.entries.erase(it++);
+          ++num_deletions;
+        }
+      }
+
+      if (it == part.entries.end()) {
+        part.clock_hand.reset();
+      } else {
+        part.clock_hand = it->first;
+      }
+    } break;
   }
 
   return num_deletions;
 }
 
+template <typename Key>
+size_t HashMapBackend<Key>::snapshot_partition_(const std::filesystem::path& path,
+                                                const Partition& part) const {
+  const size_t os_page_size{static_cast<size_t>(sysconf(_SC_PAGESIZE))};
+  const size_t stride{(part.value_size + value_page_alignment - 1) / value_page_alignment *
+                      value_page_alignment};
+  const size_t num_entries{part.entries.size()};
+
+  HashMapSnapshotHeader header;
+  header.magic = hash_map_snapshot_magic;
+  header.key_size = sizeof(Key);
+  header.value_size = part.value_size;
+  header.value_stride = stride;
+  header.num_partitions = this->params_.num_partitions;
+  header.num_entries = num_entries;
+  header.values_offset =
+      (sizeof(HashMapSnapshotHeader) + num_entries * (sizeof(uint64_t) + sizeof(Key)) +
+       os_page_size - 1) /
+      os_page_size * os_page_size;
+
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(HashMapSnapshotHeader));
+  for (const Entry& entry : part.entries) {
+    file.write(reinterpret_cast<const char*>(&entry.second.access_count), sizeof(uint64_t));
+  }
+  for (const Entry& entry : part.entries) {
+    file.write(reinterpret_cast<const char*>(&entry.first), sizeof(Key));
+  }
+
+  const std::vector<char> padding(std::max<size_t>(os_page_size, stride), 0);
+  const size_t header_size{static_cast<size_t>(file.tellp())};
+  file.write(padding.data(), static_cast<std::streamsize>(header.values_offset - header_size));
+  for (const Entry& entry : part.entries) {
+    file.write(entry.second.value, part.value_size);
+    file.write(padding.data(), static_cast<std::streamsize>(stride - part.value_size));
+  }
+
+  file.close();
+  if (!file) {
+    throw DatabaseBackendError(get_name(), 0, "Unable to write snapshot '" + path.string() + "'.");
+  }
+  return num_entries;
+}
+
+template <typename Key>
+void HashMapBackend<Key>::restore_snapshots_() {
+  const std::filesystem::path root{this->params_.snapshot_path};
+  std::error_code ec;
+  if (!std::filesystem::is_directory(root, ec)) {
+    HCTR_LOG_C(INFO, WORLD, get_name(), " backend; No snapshots found in '", root.string(),
+               "'.\n");
+    return;
+  }
+
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  size_t num_tables{0};
+  size_t num_entries{0};
+
+  for (const std::filesystem::directory_entry& dir : std::filesystem::directory_iterator{root}) {
+    if (!dir.is_directory()) {
+      continue;
+    }
+    const std::string table_name{dir.path().filename().string()};
+
+    try {
+      num_entries += restore_table_(table_name, dir.path());
+      ++num_tables;
+    } catch (DatabaseBackendError& e) {
+      HCTR_LOG_C(WARNING, WORLD, get_name(), " backend; Unable to restore table '", table_name,
+                 "' from snapshot: ", e.to_string(), '\n');
+
+      // Drop partially restored tables, but keep the snapshot for inspection.
+      const std::unique_lock lock(read_write_guard_);
+      tables_.erase(table_name);
+    }
+  }
+
+  const auto elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() - begin)};
+  HCTR_LOG_C(INFO, WORLD, get_name(), " backend; Restored ", num_tables, " tables (", num_entries,
+             " entries) from snapshots in ", elapsed.count(), " ms.\n");
+}
+
+template <typename Key>
+size_t HashMapBackend<Key>::restore_table_(const std::string& table_name,
+                                           const std::filesystem::path& dir) {
+  const size_t num_partitions{this->params_.num_partitions};
+
+  // Map all partitions and validate their headers before touching the table.
+  struct MappedPartition final {
+    std::shared_ptr<char> data;
+    const HashMapSnapshotHeader* header;
+  };
+  std::vector<MappedPartition> mapped(num_partitions);
+
+  for (size_t part_index{0}; part_index != num_partitions; ++part_index) {
+    const std::string path{(dir / std::to_string(part_index)).string()};
+
+    const int fd{open(path.c_str(), O_RDONLY)};
+    if (fd < 0) {
+      throw DatabaseBackendError(get_name(), part_index, "Unable to open '" + path + "'.");
+    }
+    struct stat status;
+    const size_t size{fstat(fd, &status) == 0 ? static_cast<size_t>(status.st_size) : 0};
+    void* const p{size >= sizeof(HashMapSnapshotHeader)
+                      ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)
+                      : MAP_FAILED};
+    close(fd);
+    if (p == MAP_FAILED) {
+      throw DatabaseBackendError(get_name(), part_index, "Unable to map '" + path + "'.");
+    }
+
+    MappedPartition& m{mapped[part_index]};
+    m.data = std::shared_ptr<char>(static_cast<char*>(p), [size](char* const p) {
+      munmap(p, size);
+    });
+    m.header = reinterpret_cast<const HashMapSnapshotHeader*>(p);
+
+    const HashMapSnapshotHeader& h{*m.header};
+    if (h.magic != hash_map_snapshot_magic || h.key_size != sizeof(Key) ||
+        h.num_partitions != num_partitions || h.value_size != mapped.front().header->value_size ||
+        h.value_stride < h.value_size || h.value_stride % value_page_alignment ||
+        h.values_offset < sizeof(HashMapSnapshotHeader) +
+                              h.num_entries * (sizeof(uint64_t) + sizeof(Key)) ||
+        h.values_offset + h.num_entries * h.value_stride > size) {
+      throw DatabaseBackendError(get_name(), part_index, "Snapshot '" + path + "' is invalid.");
+    }
+  }
+
+  create_table_(table_name, mapped.front().header->value_size);
+
+  const std::shared_lock lock(read_write_guard_);
+  PartitionList& parts{tables_.find(table_name)->second};
+
+  // Rebuild the key -> payload maps. Values stay in the mappings and are paged in lazily.
+  std::atomic<size_t> num_entries{0};
+  std::vector<std::future<void>> tasks;
+  tasks.reserve(num_partitions);
+  for (size_t part_index{0}; part_index != num_partitions; ++part_index) {
+    tasks.emplace_back(ThreadPool::get().submit([&, part_index]() {
+      Partition& part{parts[part_index]};
+      const MappedPartition& m{mapped[part_index]};
+      const HashMapSnapshotHeader& h{*m.header};
+
+      const std::unique_lock part_lock(part.read_write_guard);
+      HCTR_CHECK(part.entries.empty());
+
+      const uint64_t* const meta{reinterpret_cast<const uint64_t*>(&m.header[1])};
+      const Key* const keys{reinterpret_cast<const Key*>(&meta[h.num_entries])};
+      char* const values{&m.data.get()[h.values_offset]};
+
+      // Start reading values in the background (does not block).
+      madvise(values, h.num_entries * h.value_stride, MADV_WILLNEED);
+
+      part.entries.reserve(h.num_entries);
+      for (size_t i{0}; i != h.num_entries; ++i) {
+        Payload payload;
+        payload.access_count = meta[i];
+        payload.value = &values[i * h.value_stride];
+        part.entries.emplace(keys[i], payload);
+      }
+      part.snapshot_pages.emplace_back(m.data);
+      num_entries += part.entries.size();
+    }));
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+
+  HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Table ", table_name, ": Restored ", num_entries,
+             " entries from snapshot.\n");
+  return num_entries;
+}
+
 template class HashMapBackend<unsigned int>;
 template class HashMapBackend<long long>;
 
@@ -15,19 +15,39 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <filesystem>
+#include <fstream>
+#include <hps/embedding_cache_sharded.hpp>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hier_parameter_server.hpp>
 #include <hps/kafka_message.hpp>
+#include <hps/lookup_metrics.hpp>
 #include <hps/modelloader.hpp>
 #include <hps/mp_hash_map_backend.hpp>
 #include <hps/redis_backend.hpp>
 #include <hps/rocksdb_backend.hpp>
+#include <hps/slab_hash_map_backend.hpp>
+#include <hps/tiered_hash_map_backend.hpp>
+#include <mutex>
+#include <random>
 #include <regex>
 
 namespace HugeCTR {
 
+namespace {
+
+// Awaits all tasks before rethrowing the first failure, since the tasks refer to the caller.
+void await_all_tasks(std::vector<std::future<void>>& tasks) {
+  for (auto& task : tasks) {
+    task.wait();
+  }
+  ThreadPool::await(tasks.begin(), tasks.end());
+}
+
+}  // namespace
+
 std::string HierParameterServerBase::make_tag_name(const std::string& model_name,
                                                    const std::string& embedding_table_name,
                                                    const bool check_arguments) {
@@ -76,6 +96,56 @@ std::shared_ptr<HierParameterServerBase> HierParameterServerBase::create(
   return HierParameterServerBase::create(ps_config);
 }
 
+std::shared_ptr<HierParameterServerBase> HierParameterServerBase::get_or_create(
+    const parameter_server_config& ps_config) {
+  // Process-wide registry of the parameter servers by the models they serve
+  static std::mutex registry_mutex;
+  static std::map<std::string, std::weak_ptr<HierParameterServerBase>> registry;
+  const std::lock_guard lock(registry_mutex);
+
+  std::shared_ptr<HierParameterServerBase> parameter_server;
+  for (const auto& inference_params : ps_config.inference_params_array) {
+    const auto it = registry.find(inference_params.model_name);
+    if (it == registry.end()) {
+      continue;
+    }
+    std::shared_ptr<HierParameterServerBase> registered = it->second.lock();
+    if (!registered) {
+      registry.erase(it);
+    } else if (!parameter_server) {
+      parameter_server = registered;
+    } else {
+      HCTR_CHECK_HINT(parameter_server == registered,
+                      "The models are served by different parameter servers of this process");
+    }
+  }
+
+  if (parameter_server) {
+    const auto model_map = parameter_server->get_hps_model_configuration_map();
+    for (const auto& inference_params : ps_config.inference_params_array) {
+      const auto it = model_map.find(inference_params.model_name);
+      HCTR_CHECK_HINT(it != model_map.end(), "Model ", inference_params.model_name,
+                      " is not served by the parameter server that is shared by other models");
+      const std::vector<int>& deployed_devices = it->second.deployed_devices;
+      for (const int device_id : inference_params.deployed_devices) {
+        HCTR_CHECK_HINT(std::find(deployed_devices.begin(), deployed_devices.end(), device_id) !=
+                            deployed_devices.end(),
+                        "Model ", inference_params.model_name, " is not deployed on device ",
+                        device_id, " by the parameter server of this process");
+      }
+    }
+    HCTR_LOG_S(INFO, ROOT) << "Sharing the parameter server of this process for "
+                           << ps_config.inference_params_array.size() << " model(s)." << std::endl;
+    return parameter_server;
+  }
+
+  parameter_server = HierParameterServerBase::create(ps_config);
+  for (const auto& inference_params : ps_config.inference_params_array) {
+    registry[inference_params.model_name] = parameter_server;
+  }
+  return parameter_server;
+}
+
 HierParameterServerBase::~HierParameterServerBase() = default;
 
 template <typename TypeHashKey>
@@ -104,6 +174,8 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
   // Connect to volatile database.
   {
     const auto& conf = inference_params_array[0].volatile_db;
+    const std::unordered_map<std::string, size_t> table_overflow_margins{
+        make_table_overflow_margins_(conf)};
     switch (conf.type) {
       case DatabaseType_t::Disabled:
         break;  // No volatile database.
@@ -117,7 +189,12 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
             conf.overflow_margin,
             conf.overflow_policy,
             conf.overflow_resolution_target,
+            table_overflow_margins,
             conf.allocation_rate,
+            conf.numa_aware,
+            conf.huge_page_size,
+            conf.snapshot_path,
+            std::chrono::milliseconds{conf.snapshot_interval_ms},
         };
         volatile_db_ = std::make_unique<HashMapBackend<TypeHashKey>>(params);
       } break;
@@ -131,15 +208,49 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
             conf.overflow_margin,
             conf.overflow_policy,
             conf.overflow_resolution_target,
+            table_overflow_margins,
             conf.allocation_rate,
             conf.shared_memory_size,
             conf.shared_memory_name,
             std::chrono::milliseconds{100},  // heart_beat_frequency
             conf.shared_memory_auto_remove,
+            conf.huge_page_size,
+            conf.short_read_locks,
         };
         volatile_db_ = std::make_unique<MultiProcessHashMapBackend<TypeHashKey>>(params);
       } break;
 
+      case DatabaseType_t::SlabHashMap: {
+        HCTR_LOG_S(INFO, WORLD) << "Creating SlabHashMap CPU database backend..." << std::endl;
+        SlabHashMapBackendParams params{
+            conf.max_batch_size,
+            conf.num_partitions,
+            conf.overflow_margin,
+            conf.overflow_policy,
+            conf.overflow_resolution_target,
+            table_overflow_margins,
+        };
+        volatile_db_ = std::make_unique<SlabHashMapBackend<TypeHashKey>>(params);
+      } break;
+
+      case DatabaseType_t::TieredHashMap: {
+        HCTR_LOG_S(INFO, WORLD) << "Creating TieredHashMap CPU database backend..." << std::endl;
+        TieredHashMapBackendParams params{
+            conf.max_batch_size,
+            conf.num_partitions,
+            conf.overflow_margin,
+            conf.overflow_policy,
+            conf.overflow_resolution_target,
+            table_overflow_margins,
+            conf.allocation_rate,
+            conf.spill_path,
+            conf.spill_queue_depth,
+            conf.spill_promotion_threshold,
+            conf.spill_compaction_ratio,
+        };
+        volatile_db_ = std::make_unique<TieredHashMapBackend<TypeHashKey>>(params);
+      } break;
+
       case DatabaseType_t::RedisCluster: {
         HCTR_LOG_S(INFO, WORLD) << "Creating RedisCluster backend..." << std::endl;
         RedisClusterBackendParams params{
@@ -148,15 +259,19 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
             conf.overflow_margin,
             conf.overflow_policy,
             conf.overflow_resolution_target,
+            table_overflow_margins,
             conf.address,
             conf.user_name,
             conf.password,
             conf.num_node_connections,
+            conf.num_pipelined_batches,
+            conf.value_encoding,
             conf.enable_tls,
             conf.tls_ca_certificate,
             conf.tls_client_certificate,
             conf.tls_client_key,
             conf.tls_server_name_identification,
+            conf.near_cache_size,
         };
         volatile_db_ = std::make_unique<RedisClusterBackend<TypeHashKey>>(params);
       } break;
@@ -167,11 +282,20 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
     }
     volatile_db_initialize_after_startup_ = conf.initialize_after_startup;
     volatile_db_cache_rate_ = conf.initial_cache_rate;
+    volatile_db_key_frequency_path_ = conf.key_frequency_path;
     volatile_db_cache_missed_embeddings_ = conf.cache_missed_embeddings;
+    volatile_db_cache_missed_embeddings_rate_ = conf.cache_missed_embeddings_rate;
+    volatile_db_cache_missed_embeddings_doorkeeper_ = conf.cache_missed_embeddings_doorkeeper;
     HCTR_LOG_S(INFO, WORLD) << "Volatile DB: initial cache rate = " << volatile_db_cache_rate_
                             << std::endl;
     HCTR_LOG_S(INFO, WORLD) << "Volatile DB: cache missed embeddings = "
                             << volatile_db_cache_missed_embeddings_ << std::endl;
+    if (volatile_db_cache_missed_embeddings_) {
+      HCTR_LOG_S(INFO, WORLD) << "Volatile DB: admit missed embeddings at rate "
+                              << volatile_db_cache_missed_embeddings_rate_ << " (doorkeeper = "
+                              << volatile_db_cache_missed_embeddings_doorkeeper_ << ")."
+                              << std::endl;
+    }
   }
 
   // Connect to persistent database.
@@ -188,8 +312,12 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
             conf.path,
             conf.num_threads,
             conf.read_only,
+            conf.block_cache_size,
         };
         persistent_db_ = std::make_unique<RocksDBBackend<TypeHashKey>>(params);
+        if (!conf.read_only) {
+          persistent_db_sst_staging_path_ = std::filesystem::path(conf.path) / "hps_ingest";
+        }
       } break;
 
       default:
@@ -197,22 +325,50 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
         break;
     }
     persistent_db_initialize_after_startup_ = conf.initialize_after_startup;
+    persistent_db_num_threads_ = conf.num_threads;
+    persistent_db_bloom_filter_bits_per_key_ = conf.bloom_filter_bits_per_key;
+  }
+
+  // Double-buffered updates require that this process owns and fully repopulates the tables.
+  double_buffered_update_ = inference_params_array[0].volatile_db.double_buffered_update;
+  if (double_buffered_update_) {
+    if (volatile_db_ && volatile_db_->is_shared()) {
+      HCTR_LOG_S(WARNING, WORLD) << "Double-buffered updates are not supported with shared "
+                                 << volatile_db_->get_name() << " backends. Updating in place."
+                                 << std::endl;
+      double_buffered_update_ = false;
+    } else if ((volatile_db_ && !volatile_db_initialize_after_startup_) ||
+               (persistent_db_ && !persistent_db_initialize_after_startup_)) {
+      HCTR_LOG_S(WARNING, WORLD) << "Double-buffered updates require initializing all databases "
+                                    "after startup. Updating in place."
+                                 << std::endl;
+      double_buffered_update_ = false;
+    }
   }
 
   // initialize the profiler
   hps_profiler = std::make_unique<profiler>(ProfilerTarget_t::HPSBACKEND);
 
   // Load embeddings for each embedding table from each model
+  HugeCTR::Timer timer_startup;
+  timer_startup.start();
   for (size_t i = 0; i < inference_params_array.size(); i++) {
     update_database_per_model(inference_params_array[i]);
   }
+  HCTR_LOG_S(INFO, WORLD) << "HPS startup: loaded the databases in " << std::fixed
+                          << std::setprecision(2) << timer_startup.elapsedSeconds() << " s."
+                          << std::endl;
 
   // Initialize embedding cache for each embedding table of each model
+  timer_startup.start();
   for (size_t i = 0; i < inference_params_array.size(); i++) {
     create_embedding_cache_per_model(inference_params_array[i]);
     inference_params_map_.emplace(inference_params_array[i].model_name, inference_params_array[i]);
   }
   buffer_pool_.reset(new ManagerPool(model_cache_map_, memory_pool_config_));
+  HCTR_LOG_S(INFO, WORLD) << "HPS startup: created the embedding caches in " << std::fixed
+                          << std::setprecision(2) << timer_startup.elapsedSeconds() << " s."
+                          << std::endl;
 
   // Insert embeddings to embedding cache for each embedding table of each mode
   for (size_t i = 0; i < inference_params_array.size(); i++) {
@@ -223,7 +379,12 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
       HCTR_LOG_S(INFO, ROOT) << "Initialize the embedding cache by by inserting the same size "
                                 "model file with embedding cache from beginning"
                              << std::endl;
+      timer_startup.start();
       init_ec(inference_params_array[i], model_cache_map_[inference_params_array[i].model_name]);
+      HCTR_LOG_S(INFO, WORLD) << "HPS startup: initialized the embedding caches of model "
+                              << inference_params_array[i].model_name << " in " << std::fixed
+                              << std::setprecision(2) << timer_startup.elapsedSeconds() << " s."
+                              << std::endl;
     }
   }
 }
@@ -243,118 +404,278 @@ HierParameterServer<TypeHashKey>::~HierParameterServer() {
 }
 
 template <typename TypeHashKey>
-void HierParameterServer<TypeHashKey>::update_database_per_model(
-    const InferenceParams& inference_params) {
+size_t HierParameterServer<TypeHashKey>::load_table_into_databases_(
+    const InferenceParams& inference_params, const size_t j, const size_t version) {
   IModelLoader* rawreader =
       ModelLoader<TypeHashKey, float>::CreateLoader(DatabaseTableDumpFormat_t::Raw);
-  size_t num_tables = inference_params.fuse_embedding_table
-                          ? inference_params.fused_sparse_model_files.size()
-                          : inference_params.sparse_model_files.size();
-  // Create input file stream to read the embedding file
-  for (size_t j = 0; j < num_tables; j++) {
-    if (ps_config_.embedding_vec_size_[inference_params.model_name].size() != num_tables) {
-      HCTR_OWN_THROW(Error_t::WrongInput,
-                     "Wrong input: The number of embedding tables in network json file for model " +
-                         inference_params.model_name +
-                         " doesn't match the number of model files in configuration.");
+  size_t num_key = 0;
+  if (inference_params.fuse_embedding_table) {
+    for (int table_id = 0; table_id < inference_params.fused_sparse_model_files[j].size();
+         table_id++) {
+      rawreader->load(inference_params.embedding_table_names[j],
+                      inference_params.fused_sparse_model_files[j][table_id]);
+      num_key += rawreader->getkeycount();
     }
-    // Get raw format model loader
-    size_t num_key = 0;
-    if (inference_params.fuse_embedding_table) {
+  } else {
+    rawreader->load(inference_params.embedding_table_names[j],
+                    inference_params.sparse_model_files[j]);
+    num_key = rawreader->getkeycount();
+  }
+  const std::string& table_name{ps_config_.emb_table_name_.at(inference_params.model_name)[j]};
+  const std::string tag_name =
+      make_versioned_tag_name_(make_tag_name(inference_params.model_name, table_name), version);
+  const size_t embedding_size = ps_config_.embedding_vec_size_.at(inference_params.model_name)[j];
+  const size_t value_size = embedding_size * sizeof(float);
+  const bool dynamic_cache =
+      inference_params.embedding_cache_type == HugeCTR::EmbeddingCacheType_t::Dynamic ||
+      inference_params.embedding_cache_type == HugeCTR::EmbeddingCacheType_t::Hybrid;
+  const bool populate_volatile_db =
+      volatile_db_ && volatile_db_initialize_after_startup_ && dynamic_cache;
+  // Persistent database - by definition - always gets all keys.
+  const bool populate_persistent_db =
+      persistent_db_ && persistent_db_initialize_after_startup_ && dynamic_cache;
+
+  // Invokes `fn()` once each file of this table has been loaded.
+  const auto for_each_file = [&](const auto& fn) {
+    if (!inference_params.fuse_embedding_table) {
+      fn();
+    } else {
       for (int table_id = 0; table_id < inference_params.fused_sparse_model_files[j].size();
            table_id++) {
         rawreader->load(inference_params.embedding_table_names[j],
                         inference_params.fused_sparse_model_files[j][table_id]);
-        num_key += rawreader->getkeycount();
+        fn();
       }
-    } else {
-      rawreader->load(inference_params.embedding_table_names[j],
-                      inference_params.sparse_model_files[j]);
-      num_key = rawreader->getkeycount();
     }
-    ps_config_.embedding_key_count_.at(inference_params.model_name).emplace_back(num_key);
-    const std::string tag_name = make_tag_name(
-        inference_params.model_name, ps_config_.emb_table_name_[inference_params.model_name][j]);
-    const size_t embedding_size = ps_config_.embedding_vec_size_[inference_params.model_name][j];
-    // Populate volatile database(s).
-    if (volatile_db_ && volatile_db_initialize_after_startup_ &&
-        inference_params.embedding_cache_type == HugeCTR::EmbeddingCacheType_t::Dynamic) {
-      const size_t volatile_capacity = volatile_db_->capacity(tag_name);
-      const size_t volatile_cache_amount =
-          (num_key <= volatile_capacity)
-              ? num_key
-              : static_cast<size_t>(
-                    volatile_db_cache_rate_ * static_cast<double>(volatile_capacity) + 0.5);
+  };
+  // Invokes `fn(num_pairs, keys, vectors)` for each batch in the files of this table.
+  const auto for_each_batch = [&](const auto& fn) {
+    for_each_file([&]() {
+      for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
+        std::pair<void*, size_t> key_result = rawreader->getkeys(i);
+        std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
+        fn(key_result.second, reinterpret_cast<const TypeHashKey*>(key_result.first),
+           reinterpret_cast<const float*>(vec_result.first));
+      }
+    });
+  };
 
-      volatile_db_async_inserter_.await_idle();
-      if (!inference_params.fuse_embedding_table) {
-        for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
-          std::pair<void*, size_t> key_result = rawreader->getkeys(i);
-          std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
-          volatile_db_->insert(tag_name, key_result.second,
-                               reinterpret_cast<const TypeHashKey*>(key_result.first),
-                               reinterpret_cast<const char*>(vec_result.first),
-                               embedding_size * sizeof(float), embedding_size * sizeof(float));
+  size_t volatile_capacity = 0;
+  size_t volatile_cache_amount = 0;
+  std::unordered_set<TypeHashKey> hot_keys;
+  if (populate_volatile_db) {
+    volatile_capacity = volatile_db_->capacity(tag_name);
+    volatile_cache_amount =
+        (num_key <= volatile_capacity)
+            ? num_key
+            : static_cast<size_t>(volatile_db_cache_rate_ * static_cast<double>(volatile_capacity) +
+                                  0.5);
+    // If the table does not fit, the most frequently accessed keys should be cached first.
+    if (num_key > volatile_cache_amount) {
+      hot_keys = load_hot_keys_(inference_params.model_name, table_name, volatile_cache_amount);
+    }
+  }
+
+  // The filter must reflect all keys in the table. Hence, if the table already has contents
+  // that we did not observe (e.g., from a previous run), it cannot have a filter.
+  std::shared_ptr<BloomFilter> filter;
+  if (populate_persistent_db) {
+    filter = get_persistent_db_filter_(tag_name);
+    if (!filter && persistent_db_bloom_filter_bits_per_key_ && !persistent_db_->size(tag_name)) {
+      filter = std::make_shared<BloomFilter>(num_key, persistent_db_bloom_filter_bits_per_key_);
+    }
+  }
+
+  // Databases that take the batches in file order share a single read of the files. Only the
+  // selection of hot keys and the ingestion of SST files read them once more.
+  const bool volatile_db_in_file_order = populate_volatile_db && hot_keys.empty();
+  const bool persistent_db_in_file_order =
+      populate_persistent_db && persistent_db_sst_staging_path_.empty();
+  if (volatile_db_in_file_order || persistent_db_in_file_order) {
+    for_each_batch(
+        [&](const size_t num_pairs, const TypeHashKey* const keys, const float* const vectors) {
+          if (volatile_db_in_file_order) {
+            volatile_db_->insert(tag_name, num_pairs, keys, reinterpret_cast<const char*>(vectors),
+                                 value_size, value_size);
+          }
+          if (persistent_db_in_file_order) {
+            if (filter) {
+              filter->insert(num_pairs, keys);
+            }
+            persistent_db_->insert(tag_name, num_pairs, keys,
+                                   reinterpret_cast<const char*>(vectors), value_size, value_size);
+          }
+        });
+  }
+
+  if (populate_volatile_db) {
+    if (!hot_keys.empty()) {
+      // Insert hot keys first. Then fill the remaining budget in file order.
+      size_t budget{volatile_cache_amount};
+      std::vector<TypeHashKey> batch_keys;
+      std::vector<float> batch_vectors;
+      for (const bool hot : {true, false}) {
+        for_each_batch(
+            [&](const size_t num_pairs, const TypeHashKey* const keys, const float* const vectors) {
+              batch_keys.clear();
+              batch_vectors.clear();
+              for (size_t k{0}; k != num_pairs && batch_keys.size() != budget; ++k) {
+                if ((hot_keys.find(keys[k]) != hot_keys.end()) == hot) {
+                  batch_keys.emplace_back(keys[k]);
+                  batch_vectors.insert(batch_vectors.end(), &vectors[k * embedding_size],
+                                       &vectors[(k + 1) * embedding_size]);
+                }
+              }
+              if (!batch_keys.empty()) {
+                volatile_db_->insert(tag_name, batch_keys.size(), batch_keys.data(),
+                                     reinterpret_cast<const char*>(batch_vectors.data()),
+                                     value_size, value_size);
+                budget -= batch_keys.size();
+              }
+            });
+        if (!budget) {
+          break;
         }
-      } else {
-        for (int table_id = 0; table_id < inference_params.fused_sparse_model_files[j].size();
-             table_id++) {
-          rawreader->load(inference_params.embedding_table_names[j],
-                          inference_params.fused_sparse_model_files[j][table_id]);
+      }
+    }
+
+    HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; cached " << volatile_cache_amount
+                            << " / " << num_key << " embeddings in volatile database ("
+                            << volatile_db_->get_name()
+                            << "); load: " << volatile_db_->size(tag_name) << " / "
+                            << volatile_capacity << " (" << std::fixed << std::setprecision(2)
+                            << (static_cast<double>(volatile_db_->size(tag_name)) * 100.0 /
+                                static_cast<double>(volatile_capacity))
+                            << "%)." << std::endl;
+  }
+
+  if (populate_persistent_db) {
+    if (!persistent_db_in_file_order) {
+      // Write key-sorted SST files and ingest them directly (bypasses memtable and WAL).
+      for_each_file([&]() {
+        if (filter) {
           for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
             std::pair<void*, size_t> key_result = rawreader->getkeys(i);
-            std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
-            volatile_db_->insert(tag_name, key_result.second,
-                                 reinterpret_cast<const TypeHashKey*>(key_result.first),
-                                 reinterpret_cast<const char*>(vec_result.first),
-                                 embedding_size * sizeof(float), embedding_size * sizeof(float));
+            filter->insert(key_result.second,
+                           reinterpret_cast<const TypeHashKey*>(key_result.first));
           }
         }
+        const std::string path = persistent_db_sst_staging_path_ + "/" + tag_name;
+        std::filesystem::remove_all(path);
+        persistent_db_->load_dump_sst(
+            tag_name, rawreader->dump_sst(path, embedding_size, persistent_db_num_threads_));
+        std::filesystem::remove_all(path);
+      });
+    }
+    HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; cached " << num_key
+                            << " embeddings in persistent database (" << persistent_db_->get_name()
+                            << ")." << std::endl;
+
+    if (filter) {
+      {
+        const std::unique_lock lock(persistent_db_filters_guard_);
+        persistent_db_filters_[tag_name] = filter;
       }
+      HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; Bloom filter for persistent database"
+                              << " uses " << filter->size_in_bytes() << " bytes." << std::endl;
+    } else if (persistent_db_bloom_filter_bits_per_key_) {
+      HCTR_LOG_S(WARNING, WORLD) << "Table: " << tag_name
+                                 << "; persistent database contained keys before the model was "
+                                    "loaded. Bloom filter disabled."
+                                 << std::endl;
+    }
+  }
+  rawreader->delete_table();
+  return num_key;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::update_database_per_model(
+    const InferenceParams& inference_params) {
+  // If double-buffering and the model is already deployed, the new version is loaded into shadow
+  // tables. Meanwhile, lookups continue to be served from the previous version.
+  std::shared_ptr<const ModelVersion> prev_model_version{
+      get_model_version_(inference_params.model_name)};
+  const size_t version{prev_model_version ? prev_model_version->version + 1 : 0};
+
+  const size_t num_tables = inference_params.fuse_embedding_table
+                                ? inference_params.fused_sparse_model_files.size()
+                                : inference_params.sparse_model_files.size();
+  if (ps_config_.embedding_vec_size_.at(inference_params.model_name).size() != num_tables) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "Wrong input: The number of embedding tables in network json file for model " +
+                       inference_params.model_name +
+                       " doesn't match the number of model files in configuration.");
+  }
+  volatile_db_async_inserter_.await_idle();
 
-      HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; cached " << volatile_cache_amount
-                              << " / " << num_key << " embeddings in volatile database ("
-                              << volatile_db_->get_name()
-                              << "); load: " << volatile_db_->size(tag_name) << " / "
-                              << volatile_capacity << " (" << std::fixed << std::setprecision(2)
-                              << (static_cast<double>(volatile_db_->size(tag_name)) * 100.0 /
-                                  static_cast<double>(volatile_capacity))
-                              << "%)." << std::endl;
+  // Tables are loaded by a bounded number of workers, each with a loader of its own, while the
+  // backends insert the partitions of each batch in parallel.
+  HugeCTR::Timer timer;
+  timer.start();
+  std::vector<size_t> num_keys(num_tables);
+  std::atomic<size_t> num_loaded_tables{0};
+  {
+    ThreadPool init_pool{
+        "hps init",
+        std::max(std::min(static_cast<size_t>(inference_params.init_thread_pool_size), num_tables),
+                 static_cast<size_t>(1))};
+    std::vector<std::future<void>> table_loads;
+    for (size_t j = 0; j < num_tables; j++) {
+      table_loads.emplace_back(init_pool.submit([&, j]() {
+        num_keys[j] = load_table_into_databases_(inference_params, j, version);
+        HCTR_LOG_S(INFO, WORLD) << "Model " << inference_params.model_name << ": loaded "
+                                << ++num_loaded_tables << " / " << num_tables
+                                << " tables into the databases after " << std::fixed
+                                << std::setprecision(2) << timer.elapsedSeconds() << " s."
+                                << std::endl;
+      }));
     }
+    await_all_tasks(table_loads);
+  }
+  for (const size_t num_key : num_keys) {
+    ps_config_.embedding_key_count_.at(inference_params.model_name).emplace_back(num_key);
+  }
 
-    // Persistent database - by definition - always gets all keys.
-    if (persistent_db_ && persistent_db_initialize_after_startup_ &&
-        inference_params.embedding_cache_type == HugeCTR::EmbeddingCacheType_t::Dynamic) {
-      if (!inference_params.fuse_embedding_table) {
-        for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
-          std::pair<void*, size_t> key_result = rawreader->getkeys(i);
-          std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
-          persistent_db_->insert(tag_name, key_result.second,
-                                 reinterpret_cast<const TypeHashKey*>(key_result.first),
-                                 reinterpret_cast<const char*>(vec_result.first),
-                                 embedding_size * sizeof(float), embedding_size * sizeof(float));
+  // Switch lookups over to the new version.
+  if (double_buffered_update_) {
+    {
+      const std::unique_lock lock(model_versions_guard_);
+      model_versions_[inference_params.model_name] = make_model_version_(version);
+    }
+
+    // Drop the tables of the previous version, once no in-flight lookup refers to them any longer.
+    if (prev_model_version) {
+      const size_t prev_version{prev_model_version->version};
+      const std::weak_ptr<const ModelVersion> prev_model_version_ref{prev_model_version};
+      prev_model_version.reset();
+      {
+        std::unique_lock lock(released_model_versions_guard_);
+        released_model_versions_cv_.wait(lock, [&]() { return prev_model_version_ref.expired(); });
+      }
+      for (const std::string& table_name :
+           ps_config_.emb_table_name_[inference_params.model_name]) {
+        const std::string tag_name = make_versioned_tag_name_(
+            make_tag_name(inference_params.model_name, table_name), prev_version);
+        if (volatile_db_) {
+          erase_doorkeepers_({tag_name});
+          volatile_db_->evict(tag_name);
         }
-      } else {
-        for (int table_id = 0; table_id < inference_params.fused_sparse_model_files[j].size();
-             table_id++) {
-          rawreader->load(inference_params.embedding_table_names[j],
-                          inference_params.fused_sparse_model_files[j][table_id]);
-          for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
-            std::pair<void*, size_t> key_result = rawreader->getkeys(i);
-            std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
-            persistent_db_->insert(tag_name, key_result.second,
-                                   reinterpret_cast<const TypeHashKey*>(key_result.first),
-                                   reinterpret_cast<const char*>(vec_result.first),
-                                   embedding_size * sizeof(float), embedding_size * sizeof(float));
-          }
+        if (persistent_db_) {
+          erase_persistent_db_filters_({tag_name});
+          persistent_db_->evict(tag_name);
         }
-        HCTR_LOG_S(INFO, WORLD) << "Table: " << tag_name << "; cached " << num_key
-                                << " embeddings in persistent database ("
-                                << persistent_db_->get_name() << ")." << std::endl;
       }
+      HCTR_LOG_S(INFO, WORLD) << "Model " << inference_params.model_name
+                              << ": switched from version " << prev_version
+                              << " to " << version << "." << std::endl;
     }
   }
-  rawreader->delete_table();
+
+  // Bring the tables up to date with the delta sparse models that followed the full one.
+  for (const auto& delta_model_files : inference_params.delta_sparse_model_files) {
+    apply_delta_(inference_params, delta_model_files);
+  }
 
   // Connect to online update service (if configured).
   // TODO: Maybe need to change the location where this is initialized.
@@ -369,6 +690,8 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
   char host_name[HOST_NAME_MAX + 1];
   HCTR_CHECK_HINT(!gethostname(host_name, sizeof(host_name)), "Unable to determine hostname.\n");
 
+  const std::lock_guard lock(update_source_guard_);
+
   switch (inference_params.update_source.type) {
     case UpdateSourceType_t::Null:
       break;  // Disabled
@@ -378,7 +701,11 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
       if (volatile_db_ && !inference_params.volatile_db.update_filters.empty()) {
         std::ostringstream consumer_group;
         consumer_group << kafka_group_prefix << "volatile";
-        if (!volatile_db_->is_shared()) {
+        // Near-caches are private, so each host must see all updates to invalidate its own.
+        const bool has_near_cache{inference_params.volatile_db.type ==
+                                      DatabaseType_t::RedisCluster &&
+                                  inference_params.volatile_db.near_cache_size > 0};
+        if (!volatile_db_->is_shared() || has_near_cache) {
           consumer_group << '.' << host_name;
         }
 
@@ -394,7 +721,8 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
             inference_params.update_source.poll_timeout_ms,
             inference_params.update_source.max_batch_size,
             inference_params.update_source.failure_backoff_ms,
-            inference_params.update_source.max_commit_interval);
+            inference_params.update_source.max_commit_interval,
+            inference_params.update_source.coalescing_window_ms);
       }
       // Persistent database updates.
       if (persistent_db_ && !inference_params.persistent_db.update_filters.empty()) {
@@ -416,7 +744,8 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
             inference_params.update_source.poll_timeout_ms,
             inference_params.update_source.max_batch_size,
             inference_params.update_source.failure_backoff_ms,
-            inference_params.update_source.max_commit_interval);
+            inference_params.update_source.max_commit_interval,
+            inference_params.update_source.coalescing_window_ms);
       }
       break;
 
@@ -427,30 +756,127 @@ void HierParameterServer<TypeHashKey>::update_database_per_model(
 
   HCTR_LOG(DEBUG, WORLD, "Real-time subscribers created!\n");
 
-  // TODO: Update embedding cache!
+  // Updates are forwarded to the GPU embedding caches by the topmost database layer.
+  const bool refresh_embedding_cache{inference_params.update_source.refresh_embedding_cache};
+  const bool incremental_cache_refresh{inference_params.update_source.incremental_cache_refresh};
 
   // Turn on background updates.
   if (volatile_db_source_) {
-    volatile_db_source_->engage([&](const std::string& tag, const size_t num_pairs,
+    volatile_db_source_->engage([this, refresh_embedding_cache, incremental_cache_refresh](
+                                    const std::string& tag, const size_t num_pairs,
                                     const TypeHashKey* keys, const char* values,
                                     const size_t value_size) {
       HCTR_LOG_C(TRACE, WORLD, "Volatile DB update for tag: '", tag, "', num_pairs: ", num_pairs,
                  ", value_size: ", value_size, " bytes\n");
-      volatile_db_->insert(tag, num_pairs, keys, values, value_size, value_size);
+      const auto resolved_tag{resolve_tag_name_(tag)};
+      volatile_db_->insert(resolved_tag.first, num_pairs, keys, values, value_size, value_size);
+      if (refresh_embedding_cache) {
+        refresh_embedding_cache_(tag, num_pairs, keys, values, value_size);
+      }
+      if (incremental_cache_refresh) {
+        mark_dirty_keys_(tag, num_pairs, keys);
+      }
     });
   }
 
   if (persistent_db_source_) {
-    persistent_db_source_->engage([&](const std::string& tag, const size_t num_pairs,
+    const bool refresh_from_persistent_db{refresh_embedding_cache && !volatile_db_source_};
+    const bool track_from_persistent_db{incremental_cache_refresh && !volatile_db_source_};
+    persistent_db_source_->engage([this, refresh_from_persistent_db, track_from_persistent_db](
+                                      const std::string& tag, const size_t num_pairs,
                                       const TypeHashKey* keys, const char* values,
                                       const size_t value_size) {
       HCTR_LOG_C(TRACE, WORLD, "Persistent DB update for tag: '", tag, "', num_pairs: ", num_pairs,
                  ", value_size: ", value_size, " bytes\n");
-      persistent_db_->insert(tag, num_pairs, keys, values, value_size, value_size);
+      const auto resolved_tag{resolve_tag_name_(tag)};
+      // Register keys with the filter first, so that lookups never skip inserted keys.
+      const std::shared_ptr<BloomFilter> filter{get_persistent_db_filter_(resolved_tag.first)};
+      if (filter) {
+        filter->insert(num_pairs, keys);
+      }
+      persistent_db_->insert(resolved_tag.first, num_pairs, keys, values, value_size, value_size);
+      if (refresh_from_persistent_db) {
+        refresh_embedding_cache_(tag, num_pairs, keys, values, value_size);
+      }
+      if (track_from_persistent_db) {
+        mark_dirty_keys_(tag, num_pairs, keys);
+      }
     });
   }
 }
 
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::apply_delta_per_model(
+    const std::string& model_name, const std::vector<std::string>& delta_model_files) {
+  const auto params_it = inference_params_map_.find(model_name);
+  HCTR_CHECK_HINT(params_it != inference_params_map_.end(), "Model ", model_name,
+                  " is not deployed.\n");
+  apply_delta_(params_it->second, delta_model_files);
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::apply_delta_(
+    const InferenceParams& inference_params, const std::vector<std::string>& delta_model_files) {
+  const std::string& model_name{inference_params.model_name};
+  const std::vector<std::string>& table_names{ps_config_.emb_table_name_.at(model_name)};
+  HCTR_CHECK_HINT(!inference_params.fuse_embedding_table, "Model ", model_name,
+                  ": delta sparse models cannot be applied to fused embedding tables.\n");
+  HCTR_CHECK_HINT(delta_model_files.size() == table_names.size(), "Model ", model_name, " has ",
+                  table_names.size(), " embedding tables, but ", delta_model_files.size(),
+                  " delta sparse model files were given.\n");
+  // Like the full model, the databases only hold the tables of dynamic and hybrid caches.
+  const bool update_databases{
+      inference_params.embedding_cache_type == HugeCTR::EmbeddingCacheType_t::Dynamic ||
+      inference_params.embedding_cache_type == HugeCTR::EmbeddingCacheType_t::Hybrid};
+
+  IModelLoader* rawreader =
+      ModelLoader<TypeHashKey, float>::CreateLoader(DatabaseTableDumpFormat_t::Raw);
+  for (size_t j = 0; j < table_names.size(); j++) {
+    if (delta_model_files[j].empty()) {
+      continue;
+    }
+    rawreader->load(inference_params.embedding_table_names[j], delta_model_files[j]);
+    const std::string tag_name{make_tag_name(model_name, table_names[j])};
+    const size_t embedding_size{ps_config_.embedding_vec_size_.at(model_name)[j]};
+    const size_t value_size{embedding_size * sizeof(float)};
+
+    // Holds the active version of the model while its tables are updated.
+    const auto resolved_tag{resolve_tag_name_(tag_name)};
+    const std::shared_ptr<BloomFilter> filter{
+        persistent_db_ ? get_persistent_db_filter_(resolved_tag.first) : nullptr};
+    if (volatile_db_) {
+      volatile_db_async_inserter_.await_idle();
+    }
+
+    for (size_t i = 0; i < rawreader->get_num_iterations(); i++) {
+      const std::pair<void*, size_t> key_result = rawreader->getkeys(i);
+      const std::pair<void*, size_t> vec_result = rawreader->getvectors(i, embedding_size);
+      const size_t num_pairs{key_result.second};
+      const TypeHashKey* const keys{reinterpret_cast<const TypeHashKey*>(key_result.first)};
+      const char* const values{reinterpret_cast<const char*>(vec_result.first)};
+
+      // The backends upsert the partitions of the keys in parallel.
+      if (volatile_db_ && update_databases) {
+        volatile_db_->insert(resolved_tag.first, num_pairs, keys, values, value_size, value_size);
+      }
+      if (persistent_db_ && update_databases) {
+        // Register keys with the filter first, so that lookups never skip inserted keys.
+        if (filter) {
+          filter->insert(num_pairs, keys);
+        }
+        persistent_db_->insert(resolved_tag.first, num_pairs, keys, values, value_size,
+                               value_size);
+      }
+      // Only the keys that are resident in the GPU embedding caches are overwritten.
+      refresh_embedding_cache_(tag_name, num_pairs, keys, values, value_size);
+    }
+    HCTR_LOG_S(INFO, WORLD) << "Table: " << resolved_tag.first << "; applied "
+                            << rawreader->getkeycount() << " embeddings of the delta sparse model "
+                            << delta_model_files[j] << "." << std::endl;
+  }
+  rawreader->delete_table();
+}
+
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::init_ec(
     InferenceParams& inference_params,
@@ -460,170 +886,245 @@ void HierParameterServer<TypeHashKey>::init_ec(
   size_t num_tables = inference_params.fuse_embedding_table
                           ? inference_params.fused_sparse_model_files.size()
                           : inference_params.sparse_model_files.size();
+  const std::vector<int>& devices{inference_params.deployed_devices};
+
+  // Each batch of the model files is read once, and inserted into the caches of all devices in
+  // parallel. The caches of all devices of a model have the same configuration.
+  HugeCTR::Timer timer;
+  timer.start();
+  ThreadPool init_pool{"hps init", devices.size()};
+  const auto for_each_device = [&](const auto& fn) {
+    std::vector<std::future<void>> device_inits;
+    for (size_t d = 0; d < devices.size(); d++) {
+      device_inits.emplace_back(init_pool.submit([&, d]() {
+        CudaDeviceContext dev_restorer{devices[d]};
+        fn(d);
+      }));
+    }
+    await_all_tasks(device_inits);
+  };
 
   for (size_t j = 0; j < num_tables; j++) {
     const std::string tag_name = make_tag_name(
         inference_params.model_name, ps_config_.emb_table_name_[inference_params.model_name][j]);
-    for (auto device_id : inference_params.deployed_devices) {
-      CudaDeviceContext dev_restorer{device_id};
-      HCTR_LOG_S(INFO, ROOT) << "EC initialization on device " << device_id << " for " << tag_name
-                             << std::endl;
-      cudaStream_t stream = embedding_cache_map[device_id]->get_refresh_streams()[j];
-      embedding_cache_config cache_config = embedding_cache_map[device_id]->get_cache_config();
+
+    // Select the keys that the hybrid embedding cache pins in its static tables.
+    std::vector<TypeHashKey> hot_keys;
+    std::vector<float> hot_vectors;
+    if (inference_params.embedding_cache_type == EmbeddingCacheType_t::Hybrid &&
+        inference_params.use_gpu_embedding_cache) {
+      if (inference_params.fuse_embedding_table) {
+        HCTR_LOG_S(WARNING, ROOT) << "Keys of the fused table " << tag_name
+                                  << " are not pinned by the hybrid embedding cache." << std::endl;
+      } else {
+        const size_t row_num = ps_config_.embedding_key_count_.at(inference_params.model_name)[j];
+        const size_t num_hot_keys = std::max(
+            static_cast<size_t>(static_cast<double>(inference_params.hot_key_percentage) *
+                                static_cast<double>(row_num)),
+            static_cast<size_t>(1));
+        const size_t embedding_size =
+            ps_config_.embedding_vec_size_[inference_params.model_name][j];
+        const std::unordered_set<TypeHashKey> hot_key_set{load_hot_keys_(
+            inference_params.model_name, ps_config_.emb_table_name_[inference_params.model_name][j],
+            num_hot_keys)};
+        if (!hot_key_set.empty()) {
+          hot_keys.assign(hot_key_set.begin(), hot_key_set.end());
+          hot_vectors.resize(hot_keys.size() * embedding_size);
+          this->lookup(hot_keys.data(), hot_keys.size(), hot_vectors.data(),
+                       inference_params.model_name, j);
+        } else {
+          // Without a key-frequency histogram, pin the first keys of the model file.
+          rawreader->load(inference_params.embedding_table_names[j],
+                          inference_params.sparse_model_files[j], num_hot_keys);
+          const std::pair<void*, size_t> key_result{rawreader->getkeys(0)};
+          const std::pair<void*, size_t> vec_result{rawreader->getvectors(0, embedding_size)};
+          const TypeHashKey* const keys = reinterpret_cast<const TypeHashKey*>(key_result.first);
+          const float* const vectors = reinterpret_cast<const float*>(vec_result.first);
+          hot_keys.assign(keys, &keys[key_result.second]);
+          hot_vectors.assign(vectors, &vectors[key_result.second * embedding_size]);
+        }
+      }
+    }
+
+    HCTR_LOG_S(INFO, ROOT) << "EC initialization on " << devices.size() << " devices for "
+                           << tag_name << std::endl;
+    std::vector<std::shared_ptr<EmbeddingCacheBase>> caches;
+    std::vector<cudaStream_t> streams;
+    std::vector<MemoryBlock*> memory_blocks;
+    for (const int device_id : devices) {
+      caches.emplace_back(embedding_cache_map[device_id]);
+      streams.emplace_back(caches.back()->get_refresh_streams()[j]);
       // apply the memory block for embedding cache refresh workspace
       MemoryBlock* memory_block = nullptr;
       while (memory_block == nullptr) {
         memory_block = reinterpret_cast<struct MemoryBlock*>(this->apply_buffer(
             inference_params.model_name, device_id, CACHE_SPACE_TYPE::REFRESHER));
       }
-      EmbeddingCacheRefreshspace refreshspace_handler = memory_block->refresh_buffer;
-
-      if (inference_params.embedding_cache_type == EmbeddingCacheType_t::Dynamic ||
-          (inference_params.embedding_cache_type == EmbeddingCacheType_t::Stochastic)) {
-        // initialize the embedding cache for each table
-        const size_t stride_set =
-            std::max(1.0f, floor(cache_config.num_set_in_cache_[j] *
-                                 cache_config.cache_refresh_percentage_per_iteration));
-        size_t length = SLAB_SIZE * SET_ASSOCIATIVITY * stride_set;
+      memory_blocks.emplace_back(memory_block);
+    }
+    const embedding_cache_config cache_config = caches.front()->get_cache_config();
+
+    // Copies a batch into the refresh space of each device, from which its cache is initialized.
+    const auto init_from_refreshspace = [&](const std::pair<void*, size_t>& key_result,
+                                            const std::pair<void*, size_t>& vec_result,
+                                            size_t& length) {
+      for_each_device([&](const size_t d) {
+        EmbeddingCacheRefreshspace refreshspace_handler = memory_blocks[d]->refresh_buffer;
         refreshspace_handler.h_length_ = &length;
-        size_t num_iteration = 0;
-        std::pair<void*, size_t> key_result;
-        std::pair<void*, size_t> vec_result;
-        for (size_t idx_set = 0; idx_set + stride_set < cache_config.num_set_in_cache_[j];
-             idx_set += stride_set) {
-          if (inference_params.fuse_embedding_table) {
-            size_t table_id = idx_set % inference_params.fused_sparse_model_files[j].size();
-            rawreader->load(inference_params.embedding_table_names[j],
-                            inference_params.fused_sparse_model_files[j][table_id], length);
-            size_t iter_id = (idx_set / inference_params.fused_sparse_model_files[j].size()) %
-                             rawreader->get_num_iterations();
-            key_result = rawreader->getkeys(iter_id);
-            vec_result = rawreader->getvectors(iter_id, cache_config.embedding_vec_size_[j]);
-          } else {
-            rawreader->load(inference_params.embedding_table_names[j],
-                            inference_params.sparse_model_files[j], length);
-            // copy the embedding keys from reader to refresh space
-            key_result = rawreader->getkeys(idx_set / stride_set);
-            vec_result =
-                rawreader->getvectors(idx_set / stride_set, cache_config.embedding_vec_size_[j]);
-          }
-          HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_embeddingcolumns_,
-                                         reinterpret_cast<const TypeHashKey*>(key_result.first),
-                                         *refreshspace_handler.h_length_ * sizeof(TypeHashKey),
-                                         cudaMemcpyHostToDevice, stream));
-          // copy the embedding vectors from reader to refresh space
-          HCTR_LIB_THROW(cudaMemcpyAsync(
-              refreshspace_handler.d_refresh_emb_vec_,
-              reinterpret_cast<const float*>(vec_result.first),
-              *refreshspace_handler.h_length_ * cache_config.embedding_vec_size_[j] * sizeof(float),
-              cudaMemcpyHostToDevice, stream));
-          HCTR_LOG_S(INFO, ROOT) << "Initialize the embedding table " << j << " for iteration "
-                                 << idx_set / stride_set << " with number of " << length << " keys."
-                                 << std::endl;
-          embedding_cache_map[device_id]->init(j, refreshspace_handler, stream);
-          HCTR_LIB_THROW(cudaStreamSynchronize(stream));
-          num_iteration++;
-        }
+        // copy the embedding keys from reader to refresh space
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_embeddingcolumns_,
+                                       reinterpret_cast<const TypeHashKey*>(key_result.first),
+                                       length * sizeof(TypeHashKey), cudaMemcpyHostToDevice,
+                                       streams[d]));
+        // copy the embedding vectors from reader to refresh space
+        HCTR_LIB_THROW(cudaMemcpyAsync(
+            refreshspace_handler.d_refresh_emb_vec_,
+            reinterpret_cast<const float*>(vec_result.first),
+            length * cache_config.embedding_vec_size_[j] * sizeof(float), cudaMemcpyHostToDevice,
+            streams[d]));
+        caches[d]->init(j, refreshspace_handler, streams[d]);
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[d]));
+      });
+    };
+
+    if (inference_params.embedding_cache_type == EmbeddingCacheType_t::Dynamic ||
+        (inference_params.embedding_cache_type == EmbeddingCacheType_t::Stochastic) ||
+        (inference_params.embedding_cache_type == EmbeddingCacheType_t::Hybrid)) {
+      // initialize the embedding cache for each table
+      const size_t stride_set =
+          std::max(1.0f, floor(cache_config.num_set_in_cache_[j] *
+                               cache_config.cache_refresh_percentage_per_iteration));
+      size_t length = SLAB_SIZE * SET_ASSOCIATIVITY * stride_set;
+      if (!inference_params.fuse_embedding_table) {
+        rawreader->load(inference_params.embedding_table_names[j],
+                        inference_params.sparse_model_files[j], length);
       }
-      // For UVM/Static solution
-      else if (inference_params.embedding_cache_type == EmbeddingCacheType_t::UVM ||
-               inference_params.embedding_cache_type == EmbeddingCacheType_t::Static) {
-        HCTR_LOG(INFO, WORLD,
-                 "To achieve the best performance, when using static table, the pointers of keys "
-                 "and vectors in HPS lookup should preferably be aligned to at least 16 Bytes.\n");
-        float ratio_per_ini_iteration = 0.1;
-        size_t length = cache_config.num_set_in_cache_[j] * ratio_per_ini_iteration;
-        size_t num_fused_tables = 1;
-        size_t total_emb_keys = cache_config.num_set_in_cache_[j];
-        std::vector<size_t> num_emb_keys_per_table;
-        std::pair<void*, size_t> key_result;
-        std::pair<void*, size_t> vec_result;
+      std::pair<void*, size_t> key_result;
+      std::pair<void*, size_t> vec_result;
+      for (size_t idx_set = 0; idx_set + stride_set < cache_config.num_set_in_cache_[j];
+           idx_set += stride_set) {
         if (inference_params.fuse_embedding_table) {
-          num_fused_tables = inference_params.fused_sparse_model_files[j].size();
-          total_emb_keys = 0;
-          for (int table_id = 0; table_id < inference_params.fused_sparse_model_files[j].size();
-               table_id++) {
-            rawreader->load(inference_params.embedding_table_names[j],
-                            inference_params.fused_sparse_model_files[j][table_id]);
-            // Get the number of keys in each table
-            num_emb_keys_per_table.emplace_back(rawreader->getkeycount());
-            // Get the total number of keys in fused table
-            total_emb_keys += rawreader->getkeycount();
-          }
+          size_t table_id = idx_set % inference_params.fused_sparse_model_files[j].size();
+          rawreader->load(inference_params.embedding_table_names[j],
+                          inference_params.fused_sparse_model_files[j][table_id], length);
+          size_t iter_id = (idx_set / inference_params.fused_sparse_model_files[j].size()) %
+                           rawreader->get_num_iterations();
+          key_result = rawreader->getkeys(iter_id);
+          vec_result = rawreader->getvectors(iter_id, cache_config.embedding_vec_size_[j]);
         } else {
-          // Get the total number of keys in non-fused table
-          num_emb_keys_per_table.emplace_back(cache_config.num_set_in_cache_[j]);
+          key_result = rawreader->getkeys(idx_set / stride_set);
+          vec_result =
+              rawreader->getvectors(idx_set / stride_set, cache_config.embedding_vec_size_[j]);
         }
-        // Calculate the number of iterations required to initialize ec
-        size_t num_iterations = 0;
-        // The number of keys that need to be inserted into the cache for each table
-        size_t numkeys_in_EC_pertable = 0;
-        for (size_t table_id = 0; table_id < num_fused_tables; table_id++) {
-          if (inference_params.fuse_embedding_table) {
-            // Get the number of keys in the cache for  the current table
-            numkeys_in_EC_pertable = ((float)num_emb_keys_per_table[table_id] / total_emb_keys) *
-                                     cache_config.num_set_in_cache_[j];
-            length = ratio_per_ini_iteration * numkeys_in_EC_pertable;
-            rawreader->load(inference_params.embedding_table_names[j],
-                            inference_params.fused_sparse_model_files[j][table_id], length);
-            num_iterations = (numkeys_in_EC_pertable - 1) / length + 1;
-          } else {
-            rawreader->load(inference_params.embedding_table_names[j],
-                            inference_params.sparse_model_files[j], length, 1,
-                            inference_params.fp8_quant);
-            num_iterations = (cache_config.num_set_in_cache_[j] - 1) / length + 1;
-            if (inference_params.fp8_quant) {
-              num_iterations = rawreader->get_num_iterations();
-            }
-          }
-          // initializing ec by iteratively inserting keys
-          for (size_t it = 0; it < num_iterations; it++) {
-            key_result = rawreader->getkeys(it);
-            vec_result = rawreader->getvectors(it, cache_config.embedding_vec_size_[j],
-                                               inference_params.fp8_quant);
-            HCTR_LOG_S(INFO, ROOT)
-                << "Initialize the embedding table " << j << " for iteration " << it
-                << " with number of " << key_result.second << " keys." << std::endl;
-            embedding_cache_map[device_id]->init(
-                j, key_result.first, reinterpret_cast<float*>(vec_result.first),
-                reinterpret_cast<float*>(rawreader->getmetas(inference_params.fp8_quant)),
-                key_result.second, stream);
-            HCTR_LIB_THROW(cudaStreamSynchronize(stream));
-          }
+        HCTR_LOG_S(INFO, ROOT) << "Initialize the embedding table " << j << " for iteration "
+                               << idx_set / stride_set << " with number of " << length << " keys."
+                               << std::endl;
+        init_from_refreshspace(key_result, vec_result, length);
+      }
+    }
+    // For UVM/Static solution
+    else if (inference_params.embedding_cache_type == EmbeddingCacheType_t::UVM ||
+             inference_params.embedding_cache_type == EmbeddingCacheType_t::Static) {
+      HCTR_LOG(INFO, WORLD,
+               "To achieve the best performance, when using static table, the pointers of keys "
+               "and vectors in HPS lookup should preferably be aligned to at least 16 Bytes.\n");
+      float ratio_per_ini_iteration = 0.1;
+      size_t length = cache_config.num_set_in_cache_[j] * ratio_per_ini_iteration;
+      size_t num_fused_tables = 1;
+      size_t total_emb_keys = cache_config.num_set_in_cache_[j];
+      std::vector<size_t> num_emb_keys_per_table;
+      std::pair<void*, size_t> key_result;
+      std::pair<void*, size_t> vec_result;
+      if (inference_params.fuse_embedding_table) {
+        num_fused_tables = inference_params.fused_sparse_model_files[j].size();
+        total_emb_keys = 0;
+        for (int table_id = 0; table_id < inference_params.fused_sparse_model_files[j].size();
+             table_id++) {
+          rawreader->load(inference_params.embedding_table_names[j],
+                          inference_params.fused_sparse_model_files[j][table_id]);
+          // Get the number of keys in each table
+          num_emb_keys_per_table.emplace_back(rawreader->getkeycount());
+          // Get the total number of keys in fused table
+          total_emb_keys += rawreader->getkeycount();
         }
-
       } else {
-        *refreshspace_handler.h_length_ = cache_config.num_set_in_cache_[j];
-        std::pair<void*, size_t> key_result;
-        std::pair<void*, size_t> vec_result;
+        // Get the total number of keys in non-fused table
+        num_emb_keys_per_table.emplace_back(cache_config.num_set_in_cache_[j]);
+      }
+      // Calculate the number of iterations required to initialize ec
+      size_t num_iterations = 0;
+      // The number of keys that need to be inserted into the cache for each table
+      size_t numkeys_in_EC_pertable = 0;
+      for (size_t table_id = 0; table_id < num_fused_tables; table_id++) {
         if (inference_params.fuse_embedding_table) {
-          rawreader->load_fused_emb(inference_params.embedding_table_names[j],
-                                    inference_params.fused_sparse_model_files[j]);
-          key_result = std::make_pair(rawreader->getkeys(), *refreshspace_handler.h_length_);
-          vec_result =
-              std::make_pair(rawreader->getvectors(),
-                             *refreshspace_handler.h_length_ * cache_config.embedding_vec_size_[j]);
+          // Get the number of keys in the cache for  the current table
+          numkeys_in_EC_pertable = ((float)num_emb_keys_per_table[table_id] / total_emb_keys) *
+                                   cache_config.num_set_in_cache_[j];
+          length = ratio_per_ini_iteration * numkeys_in_EC_pertable;
+          rawreader->load(inference_params.embedding_table_names[j],
+                          inference_params.fused_sparse_model_files[j][table_id], length);
+          num_iterations = (numkeys_in_EC_pertable - 1) / length + 1;
         } else {
           rawreader->load(inference_params.embedding_table_names[j],
-                          inference_params.sparse_model_files[j], *refreshspace_handler.h_length_);
-          key_result = rawreader->getkeys(0);
-          vec_result = rawreader->getvectors(0, cache_config.embedding_vec_size_[j]);
+                          inference_params.sparse_model_files[j], length, 1,
+                          inference_params.fp8_quant);
+          num_iterations = (cache_config.num_set_in_cache_[j] - 1) / length + 1;
+          if (inference_params.fp8_quant) {
+            num_iterations = rawreader->get_num_iterations();
+          }
+        }
+        // initializing ec by iteratively inserting keys
+        for (size_t it = 0; it < num_iterations; it++) {
+          key_result = rawreader->getkeys(it);
+          vec_result = rawreader->getvectors(it, cache_config.embedding_vec_size_[j],
+                                             inference_params.fp8_quant);
+          float* const metas =
+              reinterpret_cast<float*>(rawreader->getmetas(inference_params.fp8_quant));
+          HCTR_LOG_S(INFO, ROOT) << "Initialize the embedding table " << j << " for iteration "
+                                 << it << " with number of " << key_result.second << " keys."
+                                 << std::endl;
+          for_each_device([&](const size_t d) {
+            caches[d]->init(j, key_result.first, reinterpret_cast<float*>(vec_result.first), metas,
+                            key_result.second, streams[d]);
+            HCTR_LIB_THROW(cudaStreamSynchronize(streams[d]));
+          });
         }
+      }
 
-        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_embeddingcolumns_,
-                                       reinterpret_cast<const TypeHashKey*>(key_result.first),
-                                       *refreshspace_handler.h_length_ * sizeof(TypeHashKey),
-                                       cudaMemcpyHostToDevice, stream));
-        HCTR_LIB_THROW(cudaMemcpyAsync(
-            refreshspace_handler.d_refresh_emb_vec_,
-            reinterpret_cast<const TypeHashKey*>(vec_result.first),
-            *refreshspace_handler.h_length_ * cache_config.embedding_vec_size_[j] * sizeof(float),
-            cudaMemcpyHostToDevice, stream));
-        embedding_cache_map[device_id]->init(j, refreshspace_handler, stream);
-        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    } else {
+      size_t length = cache_config.num_set_in_cache_[j];
+      std::pair<void*, size_t> key_result;
+      std::pair<void*, size_t> vec_result;
+      if (inference_params.fuse_embedding_table) {
+        rawreader->load_fused_emb(inference_params.embedding_table_names[j],
+                                  inference_params.fused_sparse_model_files[j]);
+        key_result = std::make_pair(rawreader->getkeys(), length);
+        vec_result =
+            std::make_pair(rawreader->getvectors(), length * cache_config.embedding_vec_size_[j]);
+      } else {
+        rawreader->load(inference_params.embedding_table_names[j],
+                        inference_params.sparse_model_files[j], length);
+        key_result = rawreader->getkeys(0);
+        vec_result = rawreader->getvectors(0, cache_config.embedding_vec_size_[j]);
       }
+      init_from_refreshspace(key_result, vec_result, length);
+    }
+    if (!hot_keys.empty()) {
+      HCTR_LOG_S(INFO, ROOT) << "Pin " << hot_keys.size() << " keys of the embedding table " << j
+                             << " in the hybrid embedding cache." << std::endl;
+      for_each_device([&](const size_t d) {
+        caches[d]->init(j, hot_keys.data(), hot_vectors.data(), nullptr, hot_keys.size(),
+                        streams[d]);
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[d]));
+      });
+    }
+    for (MemoryBlock* const memory_block : memory_blocks) {
       this->free_buffer(memory_block);
     }
+    HCTR_LOG_S(INFO, WORLD) << "Model " << inference_params.model_name << ": initialized the "
+                            << "embedding caches of " << j + 1 << " / " << num_tables
+                            << " tables after " << std::fixed << std::setprecision(2)
+                            << timer.elapsedSeconds() << " s." << std::endl;
   }
   rawreader->delete_table();
 }
@@ -638,21 +1139,74 @@ void HierParameterServer<TypeHashKey>::create_embedding_cache_per_model(
                 inference_params.device_id) == inference_params.deployed_devices.end()) {
     HCTR_OWN_THROW(Error_t::WrongInput, "The device id is not in the list of deployed devices.");
   }
+  // The caches of the devices are created in parallel, each from parameters of its own.
+  std::vector<std::shared_ptr<EmbeddingCacheBase>> caches(inference_params.deployed_devices.size());
+  {
+    ThreadPool init_pool{"hps init", caches.size()};
+    std::vector<std::future<void>> cache_creations;
+    for (size_t i = 0; i < caches.size(); i++) {
+      cache_creations.emplace_back(init_pool.submit([&, i]() {
+        InferenceParams device_params{inference_params};
+        device_params.device_id = inference_params.deployed_devices[i];
+        HCTR_LOG(INFO, WORLD, "Creating embedding cache in device %d.\n", device_params.device_id);
+        caches[i] = EmbeddingCacheBase::create(device_params, ps_config_, this);
+      }));
+    }
+    await_all_tasks(cache_creations);
+  }
   std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>> embedding_cache_map;
-  for (auto device_id : inference_params.deployed_devices) {
-    HCTR_LOG(INFO, WORLD, "Creating embedding cache in device %d.\n", device_id);
-    inference_params.device_id = device_id;
-    embedding_cache_map[device_id] = EmbeddingCacheBase::create(inference_params, ps_config_, this);
+  for (size_t i = 0; i < caches.size(); i++) {
+    embedding_cache_map[inference_params.deployed_devices[i]] = caches[i];
+  }
+  inference_params.device_id = inference_params.deployed_devices.back();
+  if (inference_params.sharded_embedding_cache && inference_params.use_gpu_embedding_cache &&
+      inference_params.embedding_cache_type == EmbeddingCacheType_t::Dynamic &&
+      inference_params.deployed_devices.size() > 1) {
+    if (ShardedEmbeddingCache<TypeHashKey>::enable_peer_access(inference_params.deployed_devices)) {
+      std::vector<std::shared_ptr<EmbeddingCacheBase>> shards;
+      for (auto device_id : inference_params.deployed_devices) {
+        shards.emplace_back(embedding_cache_map[device_id]);
+      }
+      for (size_t i = 0; i < shards.size(); i++) {
+        const int device_id = inference_params.deployed_devices[i];
+        CudaDeviceContext context(device_id);
+        embedding_cache_map[device_id] =
+            std::make_shared<ShardedEmbeddingCache<TypeHashKey>>(shards, i);
+      }
+    } else {
+      HCTR_LOG(WARNING, ROOT,
+               "Peer access is not available among the deployed devices of model %s. The embedding "
+               "caches will not be sharded.\n",
+               inference_params.model_name.c_str());
+    }
   }
   model_cache_map_[inference_params.model_name] = embedding_cache_map;
+  if (inference_params.update_source.incremental_cache_refresh &&
+      inference_params.use_gpu_embedding_cache && !inference_params.fuse_embedding_table) {
+    const std::lock_guard<std::mutex> lock(dirty_keys_guard_);
+    for (const auto& cache_entry : embedding_cache_map) {
+      const embedding_cache_config& cache_config = cache_entry.second->get_cache_config();
+      for (size_t j = 0; j < cache_config.num_emb_table_; j++) {
+        const std::string tag_name =
+            make_tag_name(inference_params.model_name, cache_config.embedding_table_name_[j]);
+        DirtyKeys& dirty_keys = dirty_keys_[tag_name][static_cast<int>(cache_entry.first)];
+        dirty_keys.keys.clear();
+        dirty_keys.max_num_keys = cache_config.num_set_in_cache_[j] * SLAB_SIZE * SET_ASSOCIATIVITY;
+        dirty_keys.overflow = false;
+      }
+    }
+  }
   memory_pool_config_.num_woker_buffer_size_per_model[inference_params.model_name] =
       inference_params.number_of_worker_buffers_in_pool;
   memory_pool_config_.num_refresh_buffer_size_per_model[inference_params.model_name] =
       inference_params.number_of_refresh_buffers_in_pool;
+  memory_pool_config_.max_num_worker_buffer_size_per_model[inference_params.model_name] =
+      inference_params.max_number_of_worker_buffers_in_pool;
   if (buffer_pool_ != nullptr) {
-    buffer_pool_->_create_memory_pool_per_model(inference_params.model_name,
-                                                inference_params.number_of_worker_buffers_in_pool,
-                                                embedding_cache_map, CACHE_SPACE_TYPE::WORKER);
+    buffer_pool_->_create_memory_pool_per_model(
+        inference_params.model_name, inference_params.number_of_worker_buffers_in_pool,
+        embedding_cache_map, CACHE_SPACE_TYPE::WORKER,
+        inference_params.max_number_of_worker_buffers_in_pool);
     buffer_pool_->_create_memory_pool_per_model(inference_params.model_name,
                                                 inference_params.number_of_refresh_buffers_in_pool,
                                                 embedding_cache_map, CACHE_SPACE_TYPE::REFRESHER);
@@ -675,12 +1229,18 @@ template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::erase_model_from_hps(const std::string& model_name) {
   if (volatile_db_) {
     const std::vector<std::string>& table_names = volatile_db_->find_tables(model_name);
+    erase_doorkeepers_(table_names);
     volatile_db_->evict(table_names);
   }
   if (persistent_db_) {
     const std::vector<std::string>& table_names = persistent_db_->find_tables(model_name);
+    erase_persistent_db_filters_(table_names);
     persistent_db_->evict(table_names);
   }
+  if (double_buffered_update_) {
+    const std::unique_lock lock(model_versions_guard_);
+    model_versions_.erase(model_name);
+  }
 }
 
 template <typename TypeHashKey>
@@ -752,7 +1312,10 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
   const size_t embedding_size = ps_config_.embedding_vec_size_[model_name][table_id];
   const size_t expected_value_size = embedding_size * sizeof(float);
   const std::string& embedding_table_name = ps_config_.emb_table_name_[model_name][table_id];
-  const std::string& tag_name = make_tag_name(model_name, embedding_table_name);
+  // Pin the active model version, so that its tables are retained until this lookup completes.
+  const std::shared_ptr<const ModelVersion> model_version{get_model_version_(model_name)};
+  const std::string& tag_name = make_versioned_tag_name_(
+      make_tag_name(model_name, embedding_table_name), model_version ? model_version->version : 0);
   const float default_vec_value = ps_config_.default_emb_vec_value_[*model_id][table_id];
 
 #ifdef ENABLE_INFERENCE
@@ -760,6 +1323,7 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
                            << " values)..." << std::endl;
 #endif
   size_t hit_count = 0;
+  LookupMetrics& metrics{LookupMetrics::instance()};
 
   DatabaseMissCallback fill_default{[&](const size_t index) {
     std::fill_n(&h_vectors[index * embedding_size], embedding_size, default_vec_value);
@@ -772,9 +1336,13 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
     std::vector<size_t> indices(length, invalid_index);
 
     start = profiler::start();
-    hit_count += volatile_db_->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
-                                     reinterpret_cast<char*>(h_vectors), expected_value_size,
-                                     [&](const size_t index) { indices[index] = index; });
+    {
+      const ScopedLatency latency(metrics.histogram(model_name, table_id, LookupStage_t::VDBFetch));
+      hit_count +=
+          volatile_db_->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
+                              reinterpret_cast<char*>(h_vectors), expected_value_size,
+                              [&](const size_t index) { indices[index] = index; });
+    }
     hps_profiler->end(start, "Lookup the embedding key from VDB");
 
     HCTR_LOG_C(TRACE, WORLD, volatile_db_->get_name(), ": ", hit_count, " hits, ",
@@ -784,11 +1352,22 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
       // Compress indices (Erase-remove idiom).
       indices.erase(std::remove(indices.begin(), indices.end(), invalid_index), indices.end());
 
+      // Skip keys that are certainly absent from the persistent DB.
+      std::vector<size_t> pdb_indices_buffer;
+      const std::vector<size_t>& pdb_indices{
+          filter_persistent_db_misses_(tag_name, reinterpret_cast<const TypeHashKey*>(h_keys),
+                                       indices, fill_default, pdb_indices_buffer)};
+
       // Do a sparse lookup in the persisent DB, to fill gaps and set others to default.
       start = profiler::start();
-      hit_count += persistent_db_->fetch(
-          tag_name, indices.size(), indices.data(), reinterpret_cast<const TypeHashKey*>(h_keys),
-          reinterpret_cast<char*>(h_vectors), expected_value_size, fill_default);
+      {
+        const ScopedLatency latency(
+            metrics.histogram(model_name, table_id, LookupStage_t::PDBFetch));
+        hit_count += persistent_db_->fetch(tag_name, pdb_indices.size(), pdb_indices.data(),
+                                           reinterpret_cast<const TypeHashKey*>(h_keys),
+                                           reinterpret_cast<char*>(h_vectors),
+                                           expected_value_size, fill_default);
+      }
       hps_profiler->end(start, "Lookup the missing embedding key from the PDB");
 
       HCTR_LOG_C(TRACE, WORLD, persistent_db_->get_name(), ": ", hit_count, " hits, ",
@@ -796,34 +1375,9 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
 
       // Elevate KV pairs if desired and possible.
       if (volatile_db_cache_missed_embeddings_) {
-        // If the layer 0 cache should be optimized as we go, elevate missed keys.
-        auto keys_to_elevate{std::make_shared<std::vector<TypeHashKey>>(indices.size())};
-        auto values_to_elevate{
-            std::make_shared<std::vector<float>>(indices.size() * embedding_size)};
-
-        start = profiler::start();
-        for (size_t i{}; i != indices.size(); ++i) {
-          const size_t index{indices[i]};
-
-          (*keys_to_elevate)[i] = reinterpret_cast<const TypeHashKey*>(h_keys)[index];
-          std::copy_n(&h_vectors[index * embedding_size], embedding_size,
-                      &(*values_to_elevate)[i * embedding_size]);
-        }
-        hps_profiler->end(start, "Insert the missing embedding key into the VDB");
-
-        HCTR_LOG_C(DEBUG, WORLD, "Attempting to migrate ", keys_to_elevate->size(),
-                   " embeddings from ", persistent_db_->get_name(), " to ",
-                   volatile_db_->get_name(), ".\n");
-
-        start = profiler::start();
-        volatile_db_async_inserter_.submit([this, tag_name, keys_to_elevate, values_to_elevate,
-                                            expected_value_size, start]() {
-          volatile_db_->insert(tag_name, keys_to_elevate->size(), keys_to_elevate->data(),
-                               reinterpret_cast<char*>(values_to_elevate->data()),
-                               expected_value_size, expected_value_size);
-          hps_profiler->end(
-              start, "Insert the missing embedding key from the PDB into the VDB asynchronously");
-        });
+        elevate_missed_embeddings_(tag_name, model_version,
+                                   reinterpret_cast<const TypeHashKey*>(h_keys), h_vectors,
+                                   embedding_size, indices);
       }
     }
   } else {
@@ -834,8 +1388,14 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
     if (db) {
       start = profiler::start();
       // Do a sequential lookup in the volatile DB, but fill gaps with a default value.
-      hit_count += db->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
-                             reinterpret_cast<char*>(h_vectors), expected_value_size, fill_default);
+      {
+        const ScopedLatency latency(metrics.histogram(
+            model_name, table_id,
+            volatile_db_ ? LookupStage_t::VDBFetch : LookupStage_t::PDBFetch));
+        hit_count += db->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
+                               reinterpret_cast<char*>(h_vectors), expected_value_size,
+                               fill_default);
+      }
       hps_profiler->end(start, "Lookup the embedding key from default HPS database Backend");
       HCTR_LOG_C(TRACE, WORLD, db->get_name(), ": ", hit_count, " hits, ", length - hit_count,
                  " missing!\n");
@@ -855,6 +1415,596 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
 #endif
 }
 
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::lookup(const std::vector<const void*>& h_keys,
+                                              const std::vector<size_t>& lengths,
+                                              const std::vector<float*>& h_vectors,
+                                              const std::string& model_name) {
+  const size_t num_tables{h_keys.size()};
+  HCTR_CHECK(lengths.size() == num_tables && h_vectors.size() == num_tables);
+
+  // Without a database, there is nothing to overlap.
+  DatabaseBackendBase<TypeHashKey>* const db =
+      volatile_db_ ? static_cast<DatabaseBackendBase<TypeHashKey>*>(volatile_db_.get())
+                   : static_cast<DatabaseBackendBase<TypeHashKey>*>(persistent_db_.get());
+  if (!db || num_tables <= 1) {
+    for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+      lookup(h_keys[table_id], lengths[table_id], h_vectors[table_id], model_name, table_id);
+    }
+    return;
+  }
+
+  const auto start_time = std::chrono::high_resolution_clock::now();
+  BaseUnit* start = profiler::start();
+  const auto& model_id = ps_config_.find_model_id(model_name);
+  HCTR_CHECK_HINT(
+      static_cast<bool>(model_id),
+      "Error: parameter server unknown model name. Note that this error will also come out with "
+      "using Triton LOAD/UNLOAD APIs which haven't been supported in HPS backend.\n");
+
+  // Pin the active model version, so that its tables are retained until this lookup completes.
+  const std::shared_ptr<const ModelVersion> model_version{get_model_version_(model_name)};
+
+  // Pending lookup of a single table. Callbacks refer to their table, so the list must not grow.
+  constexpr size_t invalid_index{std::numeric_limits<size_t>::max()};
+  struct TableLookup final {
+    const TypeHashKey* keys;
+    size_t length;
+    float* vectors;
+    size_t embedding_size;
+    std::string tag_name;
+    DatabaseMissCallback fill_default;
+    DatabaseMissCallback record_miss;
+    std::vector<size_t> indices;  // Keys that were not found in the volatile database.
+    std::vector<size_t> pdb_indices_buffer;
+    std::future<size_t> hit_count;
+    LookupStage_t stage;  // Database layer of the pending lookup.
+    std::chrono::steady_clock::time_point dispatch_time;
+  };
+  std::vector<TableLookup> tables(num_tables);
+  LookupMetrics& metrics{LookupMetrics::instance()};
+
+  // Query the first database layer for all tables at once.
+  for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+    TableLookup& t{tables[table_id]};
+    t.keys = reinterpret_cast<const TypeHashKey*>(h_keys[table_id]);
+    t.length = lengths[table_id];
+    t.vectors = h_vectors[table_id];
+    t.embedding_size = ps_config_.embedding_vec_size_[model_name][table_id];
+    t.tag_name = make_versioned_tag_name_(
+        make_tag_name(model_name, ps_config_.emb_table_name_[model_name][table_id]),
+        model_version ? model_version->version : 0);
+
+    const float default_vec_value{ps_config_.default_emb_vec_value_[*model_id][table_id]};
+    t.fill_default = [&t, default_vec_value](const size_t index) {
+      std::fill_n(&t.vectors[index * t.embedding_size], t.embedding_size, default_vec_value);
+    };
+    t.record_miss = [&t](const size_t index) { t.indices[index] = index; };
+
+    if (!t.length) {
+      continue;
+    }
+    t.stage = volatile_db_ ? LookupStage_t::VDBFetch : LookupStage_t::PDBFetch;
+    t.dispatch_time = std::chrono::steady_clock::now();
+    if (volatile_db_ && persistent_db_) {
+      t.indices.resize(t.length, invalid_index);
+      t.hit_count = volatile_db_->fetch_async(t.tag_name, t.length, t.keys,
+                                              reinterpret_cast<char*>(t.vectors),
+                                              t.embedding_size * sizeof(float), t.record_miss);
+    } else {
+      t.hit_count =
+          db->fetch_async(t.tag_name, t.length, t.keys, reinterpret_cast<char*>(t.vectors),
+                          t.embedding_size * sizeof(float), t.fill_default);
+    }
+  }
+
+  size_t hit_count{0};
+  size_t length{0};
+  try {
+    // Forward the misses of each table to the persistent DB once its volatile DB lookup has
+    // completed. Meanwhile, the volatile DB lookups for the remaining tables proceed.
+    if (volatile_db_ && persistent_db_) {
+      for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+        TableLookup& t{tables[table_id]};
+        if (!t.hit_count.valid()) {
+          continue;
+        }
+        const size_t vdb_hit_count{t.hit_count.get()};
+        metrics.histogram(model_name, table_id, t.stage).observe_since(t.dispatch_time);
+        hit_count += vdb_hit_count;
+
+        // Compress indices (Erase-remove idiom).
+        t.indices.erase(std::remove(t.indices.begin(), t.indices.end(), invalid_index),
+                        t.indices.end());
+        if (vdb_hit_count != t.length) {
+          // Skip keys that are certainly absent from the persistent DB.
+          const std::vector<size_t>& pdb_indices{filter_persistent_db_misses_(
+              t.tag_name, t.keys, t.indices, t.fill_default, t.pdb_indices_buffer)};
+          if (!pdb_indices.empty()) {
+            t.stage = LookupStage_t::PDBFetch;
+            t.dispatch_time = std::chrono::steady_clock::now();
+            t.hit_count = persistent_db_->fetch_async(
+                t.tag_name, pdb_indices.size(), pdb_indices.data(), t.keys,
+                reinterpret_cast<char*>(t.vectors), t.embedding_size * sizeof(float),
+                t.fill_default);
+          }
+        }
+      }
+    }
+
+    // Await completion.
+    for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+      TableLookup& t{tables[table_id]};
+      if (t.hit_count.valid()) {
+        hit_count += t.hit_count.get();
+        metrics.histogram(model_name, table_id, t.stage).observe_since(t.dispatch_time);
+      }
+      length += t.length;
+    }
+  } catch (...) {
+    // Pending lookups refer to `tables`.
+    for (TableLookup& t : tables) {
+      if (t.hit_count.valid()) {
+        t.hit_count.wait();
+      }
+    }
+    throw;
+  }
+  hps_profiler->end(start, "Lookup the embedding keys of multiple tables from the HPS databases");
+
+  // Elevate KV pairs if desired and possible.
+  if (volatile_db_ && persistent_db_ && volatile_db_cache_missed_embeddings_) {
+    for (const TableLookup& t : tables) {
+      if (!t.indices.empty()) {
+        elevate_missed_embeddings_(t.tag_name, model_version, t.keys, t.vectors, t.embedding_size,
+                                   t.indices);
+      }
+    }
+  }
+
+  const auto end_time = std::chrono::high_resolution_clock::now();
+  const auto duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+#ifdef ENABLE_INFERENCE
+  HCTR_LOG_S(TRACE, WORLD) << "Parameter server lookup of " << hit_count << " / " << length
+                           << " embeddings in " << num_tables << " tables took "
+                           << duration.count() << " us." << std::endl;
+#endif
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::elevate_missed_embeddings_(
+    const std::string& tag_name, const std::shared_ptr<const ModelVersion>& model_version,
+    const TypeHashKey* const keys, const float* const vectors, const size_t embedding_size,
+    const std::vector<size_t>& indices) {
+  const size_t value_size{embedding_size * sizeof(float)};
+
+  // Admission control. Keys that are rarely accessed should not displace cached embeddings.
+  std::vector<size_t> admitted_buffer;
+  const std::vector<size_t>& admitted{
+      admit_missed_embeddings_(tag_name, keys, indices, admitted_buffer)};
+  if (admitted.empty()) {
+    return;
+  }
+
+  // If the layer 0 cache should be optimized as we go, elevate missed keys.
+  auto keys_to_elevate{std::make_shared<std::vector<TypeHashKey>>(admitted.size())};
+  auto values_to_elevate{std::make_shared<std::vector<float>>(admitted.size() * embedding_size)};
+
+  BaseUnit* start = profiler::start();
+  for (size_t i{}; i != admitted.size(); ++i) {
+    const size_t index{admitted[i]};
+
+    (*keys_to_elevate)[i] = keys[index];
+    std::copy_n(&vectors[index * embedding_size], embedding_size,
+                &(*values_to_elevate)[i * embedding_size]);
+  }
+  hps_profiler->end(start, "Insert the missing embedding key into the VDB");
+
+  HCTR_LOG_C(DEBUG, WORLD, "Attempting to migrate ", keys_to_elevate->size(), " embeddings from ",
+             persistent_db_->get_name(), " to ", volatile_db_->get_name(), ".\n");
+
+  start = profiler::start();
+  volatile_db_async_inserter_.submit(
+      [this, model_version, tag_name, keys_to_elevate, values_to_elevate, value_size, start]() {
+        volatile_db_->insert(tag_name, keys_to_elevate->size(), keys_to_elevate->data(),
+                             reinterpret_cast<char*>(values_to_elevate->data()), value_size,
+                             value_size);
+        hps_profiler->end(
+            start, "Insert the missing embedding key from the PDB into the VDB asynchronously");
+      },
+      ThreadPool::Priority::Background);
+}
+
+template <typename TypeHashKey>
+std::shared_ptr<const typename HierParameterServer<TypeHashKey>::ModelVersion>
+HierParameterServer<TypeHashKey>::make_model_version_(const size_t version) {
+  return {new ModelVersion{version}, [this](const ModelVersion* const model_version) {
+            delete model_version;
+            const std::lock_guard lock(released_model_versions_guard_);
+            released_model_versions_cv_.notify_all();
+          }};
+}
+
+template <typename TypeHashKey>
+std::shared_ptr<const typename HierParameterServer<TypeHashKey>::ModelVersion>
+HierParameterServer<TypeHashKey>::get_model_version_(const std::string& model_name) const {
+  if (!double_buffered_update_) {
+    return nullptr;
+  }
+  const std::shared_lock lock(model_versions_guard_);
+  const auto it = model_versions_.find(model_name);
+  return it != model_versions_.end() ? it->second : nullptr;
+}
+
+template <typename TypeHashKey>
+std::string HierParameterServer<TypeHashKey>::make_versioned_tag_name_(const std::string& tag_name,
+                                                                       const size_t version) {
+  if (!version) {
+    return tag_name;
+  }
+  std::ostringstream os;
+  os << tag_name << ".v" << version;
+  return os.str();
+}
+
+template <typename TypeHashKey>
+std::pair<std::string,
+          std::shared_ptr<const typename HierParameterServer<TypeHashKey>::ModelVersion>>
+HierParameterServer<TypeHashKey>::resolve_tag_name_(const std::string& tag_name) const {
+  // Tag names have the format "<prefix>.<model_name>.<table_name>" (see `make_tag_name`).
+  const size_t model_begin = tag_name.find('.') + 1;
+  const size_t model_end = tag_name.find('.', model_begin);
+  if (!model_begin || model_end == std::string::npos) {
+    return {tag_name, nullptr};
+  }
+
+  std::shared_ptr<const ModelVersion> model_version{
+      get_model_version_(tag_name.substr(model_begin, model_end - model_begin))};
+  if (!model_version) {
+    return {tag_name, nullptr};
+  }
+  return {make_versioned_tag_name_(tag_name, model_version->version), std::move(model_version)};
+}
+
+template <typename TypeHashKey>
+std::unordered_set<TypeHashKey> HierParameterServer<TypeHashKey>::load_hot_keys_(
+    const std::string& model_name, const std::string& table_name,
+    const size_t max_num_keys) const {
+  if (volatile_db_key_frequency_path_.empty() || !max_num_keys) {
+    return {};
+  }
+  const std::filesystem::path path{std::filesystem::path(volatile_db_key_frequency_path_) /
+                                   model_name / table_name};
+  if (!std::filesystem::exists(path)) {
+    HCTR_LOG_S(WARNING, WORLD) << "Table: " << table_name << "; no key-frequency histogram at "
+                               << path << ". Caching embeddings in file order." << std::endl;
+    return {};
+  }
+
+  // Histograms consist of (key, count) records.
+  struct Record final {
+    long long key;
+    uint64_t count;
+  };
+  const size_t file_size{std::filesystem::file_size(path)};
+  if (file_size % sizeof(Record) != 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "Error: key-frequency histogram " + path.string() + " size is not correct");
+  }
+  std::vector<Record> records(file_size / sizeof(Record));
+  std::ifstream file(path, std::ios::binary);
+  file.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(file_size));
+  if (!file) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen,
+                   "Error: unable to read key-frequency histogram " + path.string());
+  }
+
+  // Select most frequently accessed keys.
+  if (records.size() > max_num_keys) {
+    std::nth_element(records.begin(), records.begin() + max_num_keys, records.end(),
+                     [](const Record& a, const Record& b) { return a.count > b.count; });
+    records.resize(max_num_keys);
+  }
+
+  std::unordered_set<TypeHashKey> hot_keys;
+  hot_keys.reserve(records.size());
+  for (const Record& r : records) {
+    hot_keys.emplace(static_cast<TypeHashKey>(r.key));
+  }
+  HCTR_LOG_S(INFO, WORLD) << "Table: " << table_name << "; warming up with the " << hot_keys.size()
+                          << " most frequently accessed keys." << std::endl;
+  return hot_keys;
+}
+
+template <typename TypeHashKey>
+std::unordered_map<std::string, size_t>
+HierParameterServer<TypeHashKey>::make_table_overflow_margins_(
+    const VolatileDatabaseParams& conf) const {
+  std::unordered_map<std::string, size_t> margins;
+
+  // Explicit margins refer to "<model>" or "<model>.<table>".
+  for (const auto& margin : conf.table_overflow_margins) {
+    margins.emplace(std::string{PS_EMBEDDING_TABLE_TAG_PREFIX} + '.' + margin.first,
+                    margin.second);
+  }
+
+  // Split the shared budget among the remaining tables, proportional to their weights.
+  if (conf.shared_overflow_margin) {
+    const auto get_weight = [&](const std::string& model_name, const std::string& table_name) {
+      auto it = conf.table_overflow_weights.find(model_name + '.' + table_name);
+      if (it != conf.table_overflow_weights.end()) {
+        return it->second;
+      }
+      it = conf.table_overflow_weights.find(model_name);
+      return it != conf.table_overflow_weights.end() ? it->second : 1.0;
+    };
+    const auto has_margin = [&](const std::string& model_name, const std::string& table_name) {
+      return conf.table_overflow_margins.find(model_name) != conf.table_overflow_margins.end() ||
+             conf.table_overflow_margins.find(model_name + '.' + table_name) !=
+                 conf.table_overflow_margins.end();
+    };
+
+    double total_weight{0};
+    for (const auto& model : ps_config_.emb_table_name_) {
+      for (const std::string& table_name : model.second) {
+        if (!has_margin(model.first, table_name)) {
+          total_weight += get_weight(model.first, table_name);
+        }
+      }
+    }
+    HCTR_CHECK_HINT(total_weight > 0, "Overflow weights must be positive.");
+
+    for (const auto& model : ps_config_.emb_table_name_) {
+      for (const std::string& table_name : model.second) {
+        if (!has_margin(model.first, table_name)) {
+          const double share{get_weight(model.first, table_name) / total_weight};
+          const size_t margin{std::max(
+              static_cast<size_t>(static_cast<double>(conf.shared_overflow_margin) * share),
+              static_cast<size_t>(1))};
+          margins[make_tag_name(model.first, table_name)] = margin;
+          HCTR_LOG_S(INFO, WORLD) << "Volatile DB: table " << model.first << '.' << table_name
+                                  << " receives an overflow margin of " << margin << '.'
+                                  << std::endl;
+        }
+      }
+    }
+  }
+
+  return margins;
+}
+
+template <typename TypeHashKey>
+const std::vector<size_t>& HierParameterServer<TypeHashKey>::admit_missed_embeddings_(
+    const std::string& tag_name, const TypeHashKey* const keys, const std::vector<size_t>& indices,
+    std::vector<size_t>& buffer) {
+  const bool sample{volatile_db_cache_missed_embeddings_rate_ < 1};
+  if (!sample && !volatile_db_cache_missed_embeddings_doorkeeper_) {
+    return indices;
+  }
+
+  std::shared_ptr<Doorkeeper> doorkeeper;
+  if (volatile_db_cache_missed_embeddings_doorkeeper_) {
+    {
+      const std::shared_lock lock(doorkeepers_guard_);
+      const auto it = doorkeepers_.find(tag_name);
+      if (it != doorkeepers_.end()) {
+        doorkeeper = it->second;
+      }
+    }
+    if (!doorkeeper || doorkeeper->num_keys.load(std::memory_order_relaxed) >=
+                           Doorkeeper::capacity) {
+      const std::unique_lock lock(doorkeepers_guard_);
+      std::shared_ptr<Doorkeeper>& slot{doorkeepers_[tag_name]};
+      if (slot == doorkeeper) {
+        slot = std::make_shared<Doorkeeper>();
+      }
+      doorkeeper = slot;
+    }
+  }
+
+  thread_local std::minstd_rand rng{std::random_device{}()};
+  std::uniform_real_distribution<double> dist;
+
+  buffer.clear();
+  size_t num_new_keys{0};
+  for (const size_t index : indices) {
+    if (sample && dist(rng) >= volatile_db_cache_missed_embeddings_rate_) {
+      continue;
+    }
+    if (doorkeeper) {
+      const uint64_t key{static_cast<uint64_t>(keys[index])};
+      if (!doorkeeper->filter.may_contain(key)) {
+        doorkeeper->filter.insert(key);
+        ++num_new_keys;
+        continue;
+      }
+    }
+    buffer.emplace_back(index);
+  }
+  if (doorkeeper) {
+    doorkeeper->num_keys.fetch_add(num_new_keys, std::memory_order_relaxed);
+  }
+  return buffer;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::erase_doorkeepers_(
+    const std::vector<std::string>& tag_names) {
+  const std::unique_lock lock(doorkeepers_guard_);
+  for (const std::string& tag_name : tag_names) {
+    doorkeepers_.erase(tag_name);
+  }
+}
+
+template <typename TypeHashKey>
+std::shared_ptr<BloomFilter> HierParameterServer<TypeHashKey>::get_persistent_db_filter_(
+    const std::string& tag_name) const {
+  const std::shared_lock lock(persistent_db_filters_guard_);
+  const auto it = persistent_db_filters_.find(tag_name);
+  return it != persistent_db_filters_.end() ? it->second : nullptr;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::erase_persistent_db_filters_(
+    const std::vector<std::string>& tag_names) {
+  const std::unique_lock lock(persistent_db_filters_guard_);
+  for (const std::string& tag_name : tag_names) {
+    persistent_db_filters_.erase(tag_name);
+  }
+}
+
+template <typename TypeHashKey>
+const std::vector<size_t>& HierParameterServer<TypeHashKey>::filter_persistent_db_misses_(
+    const std::string& tag_name, const TypeHashKey* const keys, const std::vector<size_t>& indices,
+    const DatabaseMissCallback& fill_default, std::vector<size_t>& buffer) const {
+  const std::shared_ptr<BloomFilter> filter{get_persistent_db_filter_(tag_name)};
+  if (!filter) {
+    return indices;
+  }
+
+  buffer.clear();
+  for (const size_t index : indices) {
+    if (filter->may_contain(static_cast<uint64_t>(keys[index]))) {
+      buffer.emplace_back(index);
+    } else {
+      fill_default(index);
+    }
+  }
+  HCTR_LOG_C(TRACE, WORLD, "Bloom filter for table '", tag_name, "': ",
+             indices.size() - buffer.size(), " / ", indices.size(),
+             " keys are certainly absent from the persistent database.\n");
+  return buffer;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::mark_dirty_keys_(const std::string& tag_name,
+                                                        const size_t num_pairs,
+                                                        const TypeHashKey* const keys) {
+  const std::lock_guard<std::mutex> lock(dirty_keys_guard_);
+  const auto it = dirty_keys_.find(tag_name);
+  if (it == dirty_keys_.end()) {
+    return;
+  }
+  for (auto& device_entry : it->second) {
+    DirtyKeys& dirty_keys = device_entry.second;
+    if (dirty_keys.overflow) {
+      continue;
+    }
+    dirty_keys.keys.insert(keys, &keys[num_pairs]);
+    if (dirty_keys.keys.size() > dirty_keys.max_num_keys) {
+      // Sweeping the entire cache is cheaper now.
+      dirty_keys.keys.clear();
+      dirty_keys.overflow = true;
+    }
+  }
+}
+
+template <typename TypeHashKey>
+bool HierParameterServer<TypeHashKey>::take_dirty_keys_(const std::string& tag_name,
+                                                        const int device_id,
+                                                        std::vector<TypeHashKey>& keys) {
+  const std::lock_guard<std::mutex> lock(dirty_keys_guard_);
+  const auto it = dirty_keys_.find(tag_name);
+  if (it == dirty_keys_.end()) {
+    return false;
+  }
+  const auto device_it = it->second.find(device_id);
+  if (device_it == it->second.end()) {
+    return false;
+  }
+  DirtyKeys& dirty_keys = device_it->second;
+  if (dirty_keys.overflow) {
+    dirty_keys.overflow = false;
+    return false;
+  }
+  keys.assign(dirty_keys.keys.begin(), dirty_keys.keys.end());
+  dirty_keys.keys.clear();
+  return true;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::refresh_embedding_cache_(const std::string& tag_name,
+                                                                const size_t num_pairs,
+                                                                const TypeHashKey* const keys,
+                                                                const char* const values,
+                                                                const size_t value_size) {
+  // Tag names have the format "<prefix>.<model_name>.<table_name>" (see `make_tag_name`).
+  const size_t model_begin = tag_name.find('.') + 1;
+  const size_t model_end = tag_name.find('.', model_begin);
+  if (!model_begin || model_end == std::string::npos) {
+    return;
+  }
+  const std::string model_name{tag_name.substr(model_begin, model_end - model_begin)};
+  const std::string table_name{tag_name.substr(model_end + 1)};
+
+  const auto caches_it = model_cache_map_.find(model_name);
+  if (caches_it == model_cache_map_.end()) {
+    return;
+  }
+  const auto params_it = inference_params_map_.find(model_name);
+  if (params_it != inference_params_map_.end() && params_it->second.fuse_embedding_table) {
+    HCTR_LOG_C(TRACE, WORLD, "Fused embedding tables cannot be refreshed by realtime updates.\n");
+    return;
+  }
+
+  for (const auto& cache_entry : caches_it->second) {
+    const int device_id{static_cast<int>(cache_entry.first)};
+    const std::shared_ptr<EmbeddingCacheBase>& embedding_cache{cache_entry.second};
+    if (!embedding_cache->use_gpu_embedding_cache()) {
+      continue;
+    }
+
+    const embedding_cache_config& cache_config{embedding_cache->get_cache_config()};
+    const auto& table_names{cache_config.embedding_table_name_};
+    const size_t table_id = std::find(table_names.begin(), table_names.end(), table_name) -
+                            table_names.begin();
+    if (table_id == table_names.size()) {
+      continue;
+    }
+    if (value_size != cache_config.embedding_vec_size_[table_id] * sizeof(float)) {
+      HCTR_LOG_C(WARNING, WORLD, "Realtime update for '", tag_name, "' has value size ",
+                 value_size, ", which does not match the embedding cache. Skipped!\n");
+      continue;
+    }
+
+    CudaDeviceContext dev_restorer{device_id};
+    cudaStream_t stream = embedding_cache->get_refresh_streams()[table_id];
+
+    // apply the memory block for embedding cache refresh workspace
+    MemoryBlock* memory_block = nullptr;
+    while (memory_block == nullptr) {
+      memory_block = reinterpret_cast<struct MemoryBlock*>(
+          this->apply_buffer(model_name, device_id, CACHE_SPACE_TYPE::REFRESHER));
+    }
+    EmbeddingCacheRefreshspace refreshspace_handler = memory_block->refresh_buffer;
+
+    // Copy batches of updates to the device, and overwrite keys that are present in the cache.
+    const size_t stride = cache_config.max_num_keys_in_refresh_workspace_;
+    for (size_t i = 0; i < num_pairs; i += stride) {
+      const size_t length = std::min(stride, num_pairs - i);
+      std::copy_n(&keys[i], length,
+                  reinterpret_cast<TypeHashKey*>(refreshspace_handler.h_refresh_embeddingcolumns_));
+      std::copy_n(&values[i * value_size], length * value_size,
+                  reinterpret_cast<char*>(refreshspace_handler.h_refresh_emb_vec_));
+
+      HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_embeddingcolumns_,
+                                     refreshspace_handler.h_refresh_embeddingcolumns_,
+                                     length * sizeof(TypeHashKey), cudaMemcpyHostToDevice, stream));
+      HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_emb_vec_,
+                                     refreshspace_handler.h_refresh_emb_vec_, length * value_size,
+                                     cudaMemcpyHostToDevice, stream));
+      embedding_cache->refresh(table_id, refreshspace_handler.d_refresh_embeddingcolumns_,
+                               refreshspace_handler.d_refresh_emb_vec_, length, stream);
+      HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    }
+
+    this->free_buffer(memory_block);
+    HCTR_LOG_C(TRACE, WORLD, "Refreshed ", num_pairs, " keys of '", tag_name,
+               "' in embedding cache on device ", device_id, ".\n");
+  }
+}
+
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string& model_name,
                                                                const int device_id) {
@@ -867,6 +2017,10 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
     HCTR_LOG(WARNING, WORLD, "GPU embedding cache is not enabled and cannot be refreshed!\n");
     return;
   }
+  std::vector<cudaStream_t> streams = embedding_cache->get_refresh_streams();
+
+  // Redistribute the cache capacity before the refresh, which then covers the resized caches.
+  embedding_cache->rebalance_capacity(streams[0]);
 
   embedding_cache_config cache_config = embedding_cache->get_cache_config();
   if (cache_config.cache_refresh_percentage_per_iteration <= 0) {
@@ -876,7 +2030,6 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
     return;
   }
   timer_refresh.start();
-  std::vector<cudaStream_t> streams = embedding_cache->get_refresh_streams();
   // apply the memory block for embedding cache refresh workspace
   MemoryBlock* memory_block = nullptr;
   while (memory_block == nullptr) {
@@ -887,7 +2040,42 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
   // Refresh the embedding cache for each table
   const size_t stride_set = cache_config.num_set_in_refresh_workspace_;
   HugeCTR::Timer timer;
+  std::vector<TypeHashKey> dirty_keys;
   for (size_t i = 0; i < cache_config.num_emb_table_; i++) {
+    // If updates are tracked, only refresh the keys that were updated since the last refresh.
+    const std::string tag_name = make_tag_name(model_name, cache_config.embedding_table_name_[i]);
+    if (take_dirty_keys_(tag_name, device_id, dirty_keys)) {
+      timer.start();
+      const size_t stride = cache_config.max_num_keys_in_refresh_workspace_;
+      for (size_t idx = 0; idx < dirty_keys.size(); idx += stride) {
+        const size_t length = std::min(stride, dirty_keys.size() - idx);
+        std::copy_n(
+            &dirty_keys[idx], length,
+            reinterpret_cast<TypeHashKey*>(refreshspace_handler.h_refresh_embeddingcolumns_));
+        this->lookup(
+            reinterpret_cast<const TypeHashKey*>(refreshspace_handler.h_refresh_embeddingcolumns_),
+            length, refreshspace_handler.h_refresh_emb_vec_, model_name, i);
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_embeddingcolumns_,
+                                       refreshspace_handler.h_refresh_embeddingcolumns_,
+                                       length * sizeof(TypeHashKey), cudaMemcpyHostToDevice,
+                                       streams[i]));
+        HCTR_LIB_THROW(cudaMemcpyAsync(
+            refreshspace_handler.d_refresh_emb_vec_, refreshspace_handler.h_refresh_emb_vec_,
+            length * cache_config.embedding_vec_size_[i] * sizeof(float), cudaMemcpyHostToDevice,
+            streams[i]));
+        // Keys that do not reside in the cache are skipped by the refresh.
+        embedding_cache->refresh(static_cast<int>(i),
+                                 refreshspace_handler.d_refresh_embeddingcolumns_,
+                                 refreshspace_handler.d_refresh_emb_vec_, length, streams[i]);
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+      }
+      timer.stop();
+      HCTR_LOG_S(TRACE, ROOT) << "Embedding Cache refreshing the number of " << dirty_keys.size()
+                              << " updated keys takes: " << timer.elapsedSeconds() << "s"
+                              << std::endl;
+      continue;
+    }
+
     for (size_t idx_set = 0; idx_set < cache_config.num_set_in_cache_[i]; idx_set += stride_set) {
       const size_t end_idx = (idx_set + stride_set > cache_config.num_set_in_cache_[i])
                                  ? cache_config.num_set_in_cache_[i]
@@ -961,15 +2149,26 @@ void HierParameterServer<TypeHashKey>::insert_embedding_cache(
                workspace_handler.h_missing_length_[table_id],
                workspace_handler.h_missing_emb_vec_[table_id], cache_config.model_name_, table_id);
 
-  // Copy missing emb_vec to device
-
+  // Copy missing emb_vec to device. The copy is awaited, so that its latency is measurable. The
+  // insertion below would have to wait for it anyway.
+  LookupMetrics& metrics{LookupMetrics::instance()};
   const size_t missing_len_in_byte = workspace_handler.h_missing_length_[table_id] *
                                      cache_config.embedding_vec_size_[table_id] * sizeof(float);
-  HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.d_missing_emb_vec_[table_id],
-                                 workspace_handler.h_missing_emb_vec_[table_id],
-                                 missing_len_in_byte, cudaMemcpyHostToDevice, stream));
+  {
+    const ScopedLatency latency(
+        metrics.histogram(cache_config.model_name_, table_id, LookupStage_t::H2DCopy));
+    HCTR_LIB_THROW(cudaMemcpyAsync(workspace_handler.d_missing_emb_vec_[table_id],
+                                   workspace_handler.h_missing_emb_vec_[table_id],
+                                   missing_len_in_byte, cudaMemcpyHostToDevice, stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
   // Insert the vectors for missing keys into embedding cache
-  embedding_cache->insert(table_id, workspace_handler, stream);
+  {
+    const ScopedLatency latency(
+        metrics.histogram(cache_config.model_name_, table_id, LookupStage_t::Insert));
+    embedding_cache->insert(table_id, workspace_handler, stream);
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
 }
 
 template class HierParameterServer<long long>;
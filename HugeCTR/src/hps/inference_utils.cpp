@@ -36,19 +36,35 @@ bool VolatileDatabaseParams::operator==(const VolatileDatabaseParams& p) const {
          // Backend specific.
          address == p.address && user_name == p.user_name && password == p.password &&
          num_partitions == p.num_partitions && allocation_rate == p.allocation_rate &&
+         numa_aware == p.numa_aware && huge_page_size == p.huge_page_size &&
+         snapshot_path == p.snapshot_path && snapshot_interval_ms == p.snapshot_interval_ms &&
          shared_memory_size == p.shared_memory_size && shared_memory_name == p.shared_memory_name &&
          shared_memory_auto_remove == p.shared_memory_auto_remove &&
-         num_node_connections == p.num_node_connections && max_batch_size == p.max_batch_size &&
-         enable_tls == p.enable_tls && tls_ca_certificate == p.tls_ca_certificate &&
+         short_read_locks == p.short_read_locks && spill_path == p.spill_path &&
+         spill_queue_depth == p.spill_queue_depth &&
+         spill_promotion_threshold == p.spill_promotion_threshold &&
+         spill_compaction_ratio == p.spill_compaction_ratio &&
+         num_node_connections == p.num_node_connections &&
+         num_pipelined_batches == p.num_pipelined_batches &&
+         near_cache_size == p.near_cache_size && value_encoding == p.value_encoding &&
+         max_batch_size == p.max_batch_size && enable_tls == p.enable_tls &&
+         tls_ca_certificate == p.tls_ca_certificate &&
          tls_client_certificate == p.tls_client_certificate && tls_client_key == p.tls_client_key &&
          tls_server_name_identification == p.tls_server_name_identification &&
          // Overflow handling related.
          overflow_margin == p.overflow_margin && overflow_policy == p.overflow_policy &&
          overflow_resolution_target == p.overflow_resolution_target &&
+         table_overflow_margins == p.table_overflow_margins &&
+         shared_overflow_margin == p.shared_overflow_margin &&
+         table_overflow_weights == p.table_overflow_weights &&
          // Caching behavior related.
          initialize_after_startup == p.initialize_after_startup &&
          initial_cache_rate == p.initial_cache_rate &&
+         key_frequency_path == p.key_frequency_path &&
          cache_missed_embeddings == p.cache_missed_embeddings &&
+         cache_missed_embeddings_rate == p.cache_missed_embeddings_rate &&
+         cache_missed_embeddings_doorkeeper == p.cache_missed_embeddings_doorkeeper &&
+         double_buffered_update == p.double_buffered_update &&
          // Real-time update mechanism related.
          update_filters == p.update_filters;
 }
@@ -60,9 +76,10 @@ bool PersistentDatabaseParams::operator==(const PersistentDatabaseParams& p) con
   return type == p.type &&
          // Backend specific.
          path == p.path && num_threads == p.num_threads && read_only == p.read_only &&
-         max_batch_size == p.max_batch_size &&
+         max_batch_size == p.max_batch_size && block_cache_size == p.block_cache_size &&
          // Caching behavior related.
          initialize_after_startup == p.initialize_after_startup &&
+         bloom_filter_bits_per_key == p.bloom_filter_bits_per_key &&
          // Real-time update mechanism related.
          update_filters == p.update_filters;
 }
@@ -76,7 +93,11 @@ bool UpdateSourceParams::operator==(const UpdateSourceParams& p) const {
          brokers == p.brokers && metadata_refresh_interval_ms == p.metadata_refresh_interval_ms &&
          receive_buffer_size == p.receive_buffer_size && poll_timeout_ms == p.poll_timeout_ms &&
          max_batch_size == p.max_batch_size && failure_backoff_ms == p.failure_backoff_ms &&
-         max_commit_interval == p.max_commit_interval;
+         max_commit_interval == p.max_commit_interval &&
+         coalescing_window_ms == p.coalescing_window_ms &&
+         // Embedding cache related.
+         refresh_embedding_cache == p.refresh_embedding_cache &&
+         incremental_cache_refresh == p.incremental_cache_refresh;
 }
 bool UpdateSourceParams::operator!=(const UpdateSourceParams& p) const { return !operator==(p); }
 
@@ -89,17 +110,29 @@ VolatileDatabaseParams::VolatileDatabaseParams(
     const DatabaseType_t type,
     // Backend specific.
     const std::string& address, const std::string& user_name, const std::string& password,
-    const size_t num_partitions, const size_t allocation_rate, const size_t shared_memory_size,
+    const size_t num_partitions, const size_t allocation_rate, const bool numa_aware,
+    const size_t huge_page_size, const std::string& snapshot_path,
+    const size_t snapshot_interval_ms, const size_t shared_memory_size,
     const std::string& shared_memory_name, const bool shared_memory_auto_remove,
-    const size_t num_node_connections, const size_t max_batch_size, const bool enable_tls,
-    const std::string& tls_ca_certificate, const std::string& tls_client_certificate,
-    const std::string& tls_client_key, const std::string& tls_server_name_identification,
+    const bool short_read_locks, const std::string& spill_path, const size_t spill_queue_depth,
+    const size_t spill_promotion_threshold, const double spill_compaction_ratio,
+    const size_t num_node_connections,
+    const size_t num_pipelined_batches, const size_t near_cache_size,
+    const DatabaseValueEncoding_t value_encoding, const size_t max_batch_size,
+    const bool enable_tls, const std::string& tls_ca_certificate,
+    const std::string& tls_client_certificate, const std::string& tls_client_key,
+    const std::string& tls_server_name_identification,
     // Overflow handling related.
     const size_t overflow_margin, const DatabaseOverflowPolicy_t overflow_policy,
     const double overflow_resolution_target,
+    const std::map<std::string, size_t>& table_overflow_margins,
+    const size_t shared_overflow_margin,
+    const std::map<std::string, double>& table_overflow_weights,
     // Caching behavior related.
     const bool initialize_after_startup, const double initial_cache_rate,
-    const bool cache_missed_embeddings,
+    const std::string& key_frequency_path, const bool cache_missed_embeddings,
+    const double cache_missed_embeddings_rate, const bool cache_missed_embeddings_doorkeeper,
+    const bool double_buffered_update,
     // Real-time update mechanism related.
     const std::vector<std::string>& update_filters)
     : type{type},
@@ -109,10 +142,22 @@ VolatileDatabaseParams::VolatileDatabaseParams(
       password{password},
       num_partitions{num_partitions},
       allocation_rate{allocation_rate},
+      numa_aware{numa_aware},
+      huge_page_size{huge_page_size},
+      snapshot_path{snapshot_path},
+      snapshot_interval_ms{snapshot_interval_ms},
       shared_memory_size{shared_memory_size},
       shared_memory_name{shared_memory_name},
       shared_memory_auto_remove{shared_memory_auto_remove},
+      short_read_locks{short_read_locks},
+      spill_path{spill_path},
+      spill_queue_depth{spill_queue_depth},
+      spill_promotion_threshold{spill_promotion_threshold},
+      spill_compaction_ratio{spill_compaction_ratio},
       num_node_connections{num_node_connections},
+      num_pipelined_batches{num_pipelined_batches},
+      near_cache_size{near_cache_size},
+      value_encoding{value_encoding},
       max_batch_size{max_batch_size},
       enable_tls{enable_tls},
       tls_ca_certificate{tls_ca_certificate},
@@ -123,10 +168,17 @@ VolatileDatabaseParams::VolatileDatabaseParams(
       overflow_margin{overflow_margin},
       overflow_policy{overflow_policy},
       overflow_resolution_target{overflow_resolution_target},
+      table_overflow_margins{table_overflow_margins},
+      shared_overflow_margin{shared_overflow_margin},
+      table_overflow_weights{table_overflow_weights},
       // Caching behavior related.
       initialize_after_startup{initialize_after_startup},
       initial_cache_rate{initial_cache_rate},
+      key_frequency_path{key_frequency_path},
       cache_missed_embeddings{cache_missed_embeddings},
+      cache_missed_embeddings_rate{cache_missed_embeddings_rate},
+      cache_missed_embeddings_doorkeeper{cache_missed_embeddings_doorkeeper},
+      double_buffered_update{double_buffered_update},
       // Real-time update mechanism related.
       update_filters{update_filters} {}
 
@@ -138,8 +190,10 @@ PersistentDatabaseParams::PersistentDatabaseParams(const DatabaseType_t type,
                                                    const std::string& path,
                                                    const size_t num_threads, const bool read_only,
                                                    const size_t max_batch_size,
+                                                   const size_t block_cache_size,
                                                    // Caching behavior related.
                                                    const bool initialize_after_startup,
+                                                   const size_t bloom_filter_bits_per_key,
                                                    // Real-time update mechanism related.
                                                    const std::vector<std::string>& update_filters)
     : type(type),
@@ -148,8 +202,10 @@ PersistentDatabaseParams::PersistentDatabaseParams(const DatabaseType_t type,
       num_threads(num_threads),
       read_only(read_only),
       max_batch_size(max_batch_size),
+      block_cache_size(block_cache_size),
       // Caching behavior related.
       initialize_after_startup{initialize_after_startup},
+      bloom_filter_bits_per_key{bloom_filter_bits_per_key},
       // Real-time update mechanism related.
       update_filters(update_filters) {}
 
@@ -160,7 +216,11 @@ UpdateSourceParams::UpdateSourceParams(const UpdateSourceType_t type,
                                        const size_t receive_buffer_size,
                                        const size_t poll_timeout_ms, const size_t max_batch_size,
                                        const size_t failure_backoff_ms,
-                                       const size_t max_commit_interval)
+                                       const size_t max_commit_interval,
+                                       const size_t coalescing_window_ms,
+                                       // Embedding cache related.
+                                       const bool refresh_embedding_cache,
+                                       const bool incremental_cache_refresh)
     : type(type),
       // Backend specific.
       brokers(brokers),
@@ -169,7 +229,11 @@ UpdateSourceParams::UpdateSourceParams(const UpdateSourceType_t type,
       poll_timeout_ms(poll_timeout_ms),
       max_batch_size(max_batch_size),
       failure_backoff_ms(failure_backoff_ms),
-      max_commit_interval(max_commit_interval) {}
+      max_commit_interval(max_commit_interval),
+      coalescing_window_ms(coalescing_window_ms),
+      // Embedding cache related.
+      refresh_embedding_cache(refresh_embedding_cache),
+      incremental_cache_refresh(incremental_cache_refresh) {}
 
 InferenceParams::InferenceParams(
     const std::string& model_name, const size_t max_batchsize, const float hit_rate_threshold,
@@ -193,7 +257,17 @@ InferenceParams::InferenceParams(
     const size_t label_dim, const size_t slot_num, const std::string& non_trainable_params_file,
     bool use_static_table, EmbeddingCacheType_t embedding_cache_type, bool use_context_stream,
     bool fuse_embedding_table, bool use_hctr_cache_implementation, bool init_ec,
-    bool enable_pagelock, bool fp8_quant)
+    bool enable_pagelock, bool fp8_quant, DatabaseValueEncoding_t embedding_cache_value_encoding,
+    bool stream_ordered_lookup, bool use_cuda_graph_lookup, bool deduplicate_keys,
+    size_t embedding_cache_admission_threshold, bool adaptive_cache_sizing,
+    bool lock_free_cache_query, bool sharded_embedding_cache, float hot_key_percentage,
+    float uvm_promotion_percentage, size_t micro_batching_window_us,
+    const std::vector<size_t>& cuda_graph_batch_sizes, bool fp8_output,
+    const std::string& algorithm_cache_file, int max_number_of_worker_buffers_in_pool,
+    const std::string& tensorrt_onnx_file, const std::string& tensorrt_engine_file,
+    const std::string& shared_embedding_cache_dir, bool shared_embedding_cache_owner,
+    const std::vector<std::vector<std::string>>& delta_sparse_model_files,
+    int init_thread_pool_size)
     : model_name(model_name),
       max_batchsize(max_batchsize),
       hit_rate_threshold(hit_rate_threshold),
@@ -235,7 +309,28 @@ InferenceParams::InferenceParams(
       use_hctr_cache_implementation(use_hctr_cache_implementation),
       init_ec(init_ec),
       enable_pagelock(enable_pagelock),
-      fp8_quant(fp8_quant) {
+      fp8_quant(fp8_quant),
+      embedding_cache_value_encoding(embedding_cache_value_encoding),
+      stream_ordered_lookup(stream_ordered_lookup),
+      use_cuda_graph_lookup(use_cuda_graph_lookup),
+      deduplicate_keys(deduplicate_keys),
+      embedding_cache_admission_threshold(embedding_cache_admission_threshold),
+      adaptive_cache_sizing(adaptive_cache_sizing),
+      lock_free_cache_query(lock_free_cache_query),
+      sharded_embedding_cache(sharded_embedding_cache),
+      hot_key_percentage(hot_key_percentage),
+      uvm_promotion_percentage(uvm_promotion_percentage),
+      micro_batching_window_us(micro_batching_window_us),
+      cuda_graph_batch_sizes(cuda_graph_batch_sizes),
+      fp8_output(fp8_output),
+      algorithm_cache_file(algorithm_cache_file),
+      max_number_of_worker_buffers_in_pool(max_number_of_worker_buffers_in_pool),
+      tensorrt_onnx_file(tensorrt_onnx_file),
+      tensorrt_engine_file(tensorrt_engine_file),
+      shared_embedding_cache_dir(shared_embedding_cache_dir),
+      shared_embedding_cache_owner(shared_embedding_cache_owner),
+      delta_sparse_model_files(delta_sparse_model_files),
+      init_thread_pool_size(init_thread_pool_size) {
   // this code path is only used by hps python interface!
   if (this->default_value_for_each_table.size() != this->sparse_model_files.size()) {
     HCTR_LOG(
@@ -405,6 +500,14 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
         get_value_from_json_soft(update_source, "failure_backoff_ms", params.failure_backoff_ms);
     params.max_commit_interval =
         get_value_from_json_soft(update_source, "max_commit_interval", params.max_commit_interval);
+    params.coalescing_window_ms = get_value_from_json_soft(update_source, "coalescing_window_ms",
+                                                           params.coalescing_window_ms);
+
+    // Embedding cache related.
+    params.refresh_embedding_cache = get_value_from_json_soft(
+        update_source, "refresh_embedding_cache", params.refresh_embedding_cache);
+    params.incremental_cache_refresh = get_value_from_json_soft(
+        update_source, "incremental_cache_refresh", params.incremental_cache_refresh);
   }
 
   // Persistent database parameters.
@@ -421,6 +524,12 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
 
     params.max_batch_size =
         get_value_from_json_soft(persistent_db, "max_batch_size", params.max_batch_size);
+    params.block_cache_size =
+        get_value_from_json_soft(persistent_db, "block_cache_size", params.block_cache_size);
+
+    // Caching behavior related.
+    params.bloom_filter_bits_per_key = get_value_from_json_soft(
+        persistent_db, "bloom_filter_bits_per_key", params.bloom_filter_bits_per_key);
 
     if (persistent_db.find("update_filters") != persistent_db.end()) {
       params.update_filters.clear();
@@ -450,6 +559,13 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
 
     params.allocation_rate =
         get_value_from_json_soft(volatile_db, "allocation_rate", params.allocation_rate);
+    params.numa_aware = get_value_from_json_soft(volatile_db, "numa_aware", params.numa_aware);
+    params.huge_page_size =
+        get_value_from_json_soft(volatile_db, "huge_page_size", params.huge_page_size);
+    params.snapshot_path =
+        get_value_from_json_soft(volatile_db, "snapshot_path", params.snapshot_path);
+    params.snapshot_interval_ms =
+        get_value_from_json_soft(volatile_db, "snapshot_interval_ms", params.snapshot_interval_ms);
 
     params.shared_memory_size =
         get_value_from_json_soft(volatile_db, "shared_memory_size", params.shared_memory_size);
@@ -457,9 +573,25 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
         get_value_from_json_soft(volatile_db, "shared_memory_name", params.shared_memory_name);
     params.shared_memory_auto_remove = get_value_from_json_soft(
         volatile_db, "shared_memory_auto_remove", params.shared_memory_auto_remove);
+    params.short_read_locks =
+        get_value_from_json_soft(volatile_db, "short_read_locks", params.short_read_locks);
+
+    params.spill_path = get_value_from_json_soft(volatile_db, "spill_path", params.spill_path);
+    params.spill_queue_depth =
+        get_value_from_json_soft(volatile_db, "spill_queue_depth", params.spill_queue_depth);
+    params.spill_promotion_threshold = get_value_from_json_soft(
+        volatile_db, "spill_promotion_threshold", params.spill_promotion_threshold);
+    params.spill_compaction_ratio = get_value_from_json_soft(
+        volatile_db, "spill_compaction_ratio", params.spill_compaction_ratio);
 
     params.num_node_connections =
         get_value_from_json_soft(volatile_db, "num_node_connections", params.num_node_connections);
+    params.num_pipelined_batches = get_value_from_json_soft(volatile_db, "num_pipelined_batches",
+                                                            params.num_pipelined_batches);
+    params.near_cache_size =
+        get_value_from_json_soft(volatile_db, "near_cache_size", params.near_cache_size);
+    params.value_encoding =
+        get_hps_value_encoding(volatile_db, "value_encoding", params.value_encoding);
 
     params.max_batch_size =
         get_value_from_json_soft(volatile_db, "max_batch_size", params.max_batch_size);
@@ -481,13 +613,36 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
         get_hps_overflow_policy(volatile_db, "overflow_policy", params.overflow_policy);
     params.overflow_resolution_target = get_value_from_json_soft(
         volatile_db, "overflow_resolution_target", params.overflow_resolution_target);
+    if (volatile_db.find("table_overflow_margins") != volatile_db.end()) {
+      for (const auto& item : get_json(volatile_db, "table_overflow_margins").items()) {
+        params.table_overflow_margins[item.key()] = item.value().get<size_t>();
+      }
+    }
+    params.shared_overflow_margin = get_value_from_json_soft(
+        volatile_db, "shared_overflow_margin", params.shared_overflow_margin);
+    if (volatile_db.find("table_overflow_weights") != volatile_db.end()) {
+      for (const auto& item : get_json(volatile_db, "table_overflow_weights").items()) {
+        params.table_overflow_weights[item.key()] = item.value().get<double>();
+      }
+    }
 
     // Caching behavior related.
     params.initial_cache_rate =
         get_value_from_json_soft(volatile_db, "initial_cache_rate", params.initial_cache_rate);
 
+    params.key_frequency_path =
+        get_value_from_json_soft(volatile_db, "key_frequency_path", params.key_frequency_path);
+
     params.cache_missed_embeddings = get_value_from_json_soft(
         volatile_db, "cache_missed_embeddings", params.cache_missed_embeddings);
+    params.cache_missed_embeddings_rate = get_value_from_json_soft(
+        volatile_db, "cache_missed_embeddings_rate", params.cache_missed_embeddings_rate);
+    params.cache_missed_embeddings_doorkeeper =
+        get_value_from_json_soft(volatile_db, "cache_missed_embeddings_doorkeeper",
+                                 params.cache_missed_embeddings_doorkeeper);
+
+    params.double_buffered_update = get_value_from_json_soft(
+        volatile_db, "double_buffered_update", params.double_buffered_update);
 
     // Real-time update mechanism related.
     if (volatile_db.find("update_filters") != volatile_db.end()) {
@@ -672,6 +827,75 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
     params.enable_pagelock = get_value_from_json_soft<bool>(model, "enable_pagelock", false);
     // [27] fp8_quant -> bool
     params.fp8_quant = get_value_from_json_soft<bool>(model, "fp8_quant", false);
+    // [28] embedding_cache_value_encoding -> DatabaseValueEncoding_t
+    params.embedding_cache_value_encoding = get_hps_value_encoding(
+        model, "embedding_cache_value_encoding", DatabaseValueEncoding_t::Raw);
+    // [29] stream_ordered_lookup -> bool
+    params.stream_ordered_lookup =
+        get_value_from_json_soft<bool>(model, "stream_ordered_lookup", false);
+    // [30] use_cuda_graph_lookup -> bool
+    params.use_cuda_graph_lookup =
+        get_value_from_json_soft<bool>(model, "use_cuda_graph_lookup", false);
+    // [31] deduplicate_keys -> bool
+    params.deduplicate_keys = get_value_from_json_soft<bool>(model, "deduplicate_keys", true);
+    // [32] embedding_cache_admission_threshold -> size_t
+    params.embedding_cache_admission_threshold =
+        get_value_from_json_soft<size_t>(model, "embedding_cache_admission_threshold", 0);
+    // [33] adaptive_cache_sizing -> bool
+    params.adaptive_cache_sizing =
+        get_value_from_json_soft<bool>(model, "adaptive_cache_sizing", false);
+    // [34] lock_free_cache_query -> bool
+    params.lock_free_cache_query =
+        get_value_from_json_soft<bool>(model, "lock_free_cache_query", false);
+    // [35] sharded_embedding_cache -> bool
+    params.sharded_embedding_cache =
+        get_value_from_json_soft<bool>(model, "sharded_embedding_cache", false);
+    // [36] hot_key_percentage -> float
+    params.hot_key_percentage = get_value_from_json_soft<float>(model, "hot_key_percentage", 0.1);
+    // [37] uvm_promotion_percentage -> float
+    params.uvm_promotion_percentage =
+        get_value_from_json_soft<float>(model, "uvm_promotion_percentage", 0.0);
+    // [38] micro_batching_window_us -> size_t
+    params.micro_batching_window_us =
+        get_value_from_json_soft<size_t>(model, "micro_batching_window_us", 0);
+    // [39] cuda_graph_batch_sizes -> std::vector<size_t>
+    params.cuda_graph_batch_sizes.clear();
+    if (model.find("cuda_graph_batch_sizes") != model.end()) {
+      auto cuda_graph_batch_sizes = get_json(model, "cuda_graph_batch_sizes");
+      for (size_t i = 0; i < cuda_graph_batch_sizes.size(); ++i) {
+        params.cuda_graph_batch_sizes.emplace_back(cuda_graph_batch_sizes[i].get<size_t>());
+      }
+    }
+    // [40] fp8_output -> bool
+    params.fp8_output = get_value_from_json_soft<bool>(model, "fp8_output", false);
+    // [41] algorithm_cache_file -> std::string
+    params.algorithm_cache_file =
+        get_value_from_json_soft<std::string>(model, "algorithm_cache_file", "");
+    // [42] max_num_of_worker_buffer_in_pool -> int
+    params.max_number_of_worker_buffers_in_pool =
+        get_value_from_json_soft<int>(model, "max_num_of_worker_buffer_in_pool", 0);
+    // [43] tensorrt_onnx_file -> std::string
+    params.tensorrt_onnx_file =
+        get_value_from_json_soft<std::string>(model, "tensorrt_onnx_file", "");
+    // [44] tensorrt_engine_file -> std::string
+    params.tensorrt_engine_file =
+        get_value_from_json_soft<std::string>(model, "tensorrt_engine_file", "");
+    // [45] shared_embedding_cache_dir -> std::string
+    params.shared_embedding_cache_dir =
+        get_value_from_json_soft<std::string>(model, "shared_embedding_cache_dir", "");
+    // [46] shared_embedding_cache_owner -> bool
+    params.shared_embedding_cache_owner =
+        get_value_from_json_soft<bool>(model, "shared_embedding_cache_owner", true);
+    // [47] delta_sparse_model_files -> std::vector<std::vector<std::string>>
+    if (model.find("delta_sparse_files") != model.end()) {
+      const auto& delta_files_in_json = get_json(model, "delta_sparse_files");
+      for (size_t delta_id = 0; delta_id < delta_files_in_json.size(); ++delta_id) {
+        params.delta_sparse_model_files.emplace_back(
+            delta_files_in_json[delta_id].get<std::vector<std::string>>());
+      }
+    }
+    // [48] init_thread_pool_size -> int
+    params.init_thread_pool_size = get_value_from_json_soft<int>(model, "init_thread_pool_size", 8);
 
     params.volatile_db = volatile_db_params;
     params.persistent_db = persistent_db_params;
@@ -884,6 +1108,20 @@ DatabaseType_t get_hps_database_type(const nlohmann::json& json, const std::stri
       return enum_value;
     }
 
+  enum_value = DatabaseType_t::SlabHashMap;
+  names = {hctr_enum_to_c_str(enum_value), "slab_hashmap", "slab_hash", "slab_map", "slab"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = DatabaseType_t::TieredHashMap;
+  names = {hctr_enum_to_c_str(enum_value), "tiered_hashmap", "tiered_hash", "tiered_map", "tiered"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
   enum_value = DatabaseType_t::RedisCluster;
   names = {hctr_enum_to_c_str(enum_value), "redis"};
   for (const char* name : names)
@@ -956,6 +1194,11 @@ EmbeddingCacheType_t get_hps_embeddingcache_type(const nlohmann::json& json, con
     return enum_value;
   }
 
+  enum_value = EmbeddingCacheType_t::Hybrid;
+  if (hctr_enum_to_c_str(enum_value) == tmp) {
+    return enum_value;
+  }
+
   return default_value;
 }
 
@@ -989,6 +1232,53 @@ DatabaseOverflowPolicy_t get_hps_overflow_policy(const nlohmann::json& json, con
       return enum_value;
     }
 
+  enum_value = DatabaseOverflowPolicy_t::EvictClock;
+  names = {hctr_enum_to_c_str(enum_value), "clock"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  return default_value;
+}
+
+DatabaseValueEncoding_t get_hps_value_encoding(const nlohmann::json& json, const std::string& key,
+                                               const DatabaseValueEncoding_t default_value) {
+  if (json.find(key) == json.end()) {
+    return default_value;
+  }
+  std::string tmp = get_value_from_json<std::string>(json, key);
+  DatabaseValueEncoding_t enum_value;
+  std::unordered_set<const char*> names;
+
+  enum_value = DatabaseValueEncoding_t::Raw;
+  names = {hctr_enum_to_c_str(enum_value), "none", "float32", "fp32"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = DatabaseValueEncoding_t::Float16;
+  names = {hctr_enum_to_c_str(enum_value), "fp16", "half"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = DatabaseValueEncoding_t::BFloat16;
+  names = {hctr_enum_to_c_str(enum_value), "bf16"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
+  enum_value = DatabaseValueEncoding_t::Float8;
+  names = {hctr_enum_to_c_str(enum_value), "fp8", "float8_e4m3"};
+  for (const char* name : names)
+    if (tmp == name) {
+      return enum_value;
+    }
+
   return default_value;
 }
 
@@ -23,9 +23,9 @@ namespace HugeCTR {
 // Kernels to combine the value buffer
 __global__ void merge_emb_vec(float* d_output_emb_vec, const float* d_missing_emb_vec,
                               const uint64_t* d_missing_index, const size_t len,
-                              const size_t emb_vec_size) {
+                              const size_t* d_len, const size_t emb_vec_size) {
   const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
-  if (idx < (len * emb_vec_size)) {
+  if (idx < (len * emb_vec_size) && (d_len == nullptr || idx < (*d_len * emb_vec_size))) {
     size_t src_emb_vec = idx / emb_vec_size;
     size_t dst_emb_vec = d_missing_index[src_emb_vec];
     size_t dst_float = idx % emb_vec_size;
@@ -61,6 +61,93 @@ __global__ void decompress_emb_vec(const float* d_src_emb_vec, const uint64_t* d
   }
 }
 
+// Kernel to pool the value buffer, one thread per element of the output
+__global__ void pool_emb_vec(const float* d_src_emb_vec, const uint64_t* d_src_index,
+                             const int64_t* d_row_offsets, const size_t num_rows,
+                             const size_t emb_vec_size, const bool mean, float* d_dst_emb_vec) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < (num_rows * emb_vec_size)) {
+    size_t row = idx / emb_vec_size;
+    size_t dst_float = idx % emb_vec_size;
+    const int64_t begin = d_row_offsets[row];
+    const int64_t end = d_row_offsets[row + 1];
+    float sum = 0.f;
+    for (int64_t key = begin; key < end; ++key) {
+      size_t src_emb_vec = d_src_index ? d_src_index[key] : static_cast<size_t>(key);
+      sum += d_src_emb_vec[src_emb_vec * emb_vec_size + dst_float];
+    }
+    if (mean && end > begin) {
+      sum /= static_cast<float>(end - begin);
+    }
+    d_dst_emb_vec[row * emb_vec_size + dst_float] = sum;
+  }
+}
+
+// Maps a key to the device that caches it. The 64 bit finalizer is independent of the hash that
+// selects the slabset within a shard, so that every shard uses all of its slabsets.
+template <typename TypeHashKey>
+__device__ __forceinline__ size_t shard_of_key(const TypeHashKey key, const size_t num_shards) {
+  uint64_t h = static_cast<uint64_t>(key);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h % num_shards;
+}
+
+// Kernels to partition the keys by their shard
+template <typename TypeHashKey>
+__global__ void count_shard_keys(const TypeHashKey* d_keys, const size_t num_keys,
+                                 const size_t num_shards, size_t* d_shard_cursor) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < num_keys) {
+    const size_t shard = shard_of_key(d_keys[idx], num_shards);
+    atomicAdd(reinterpret_cast<unsigned long long*>(d_shard_cursor + shard), 1ull);
+  }
+}
+
+__global__ void scan_shard_offsets(size_t* d_shard_offset, size_t* d_shard_cursor,
+                                   const size_t num_shards) {
+  d_shard_offset[0] = 0;
+  for (size_t shard = 0; shard < num_shards; shard++) {
+    d_shard_offset[shard + 1] = d_shard_offset[shard] + d_shard_cursor[shard];
+    d_shard_cursor[shard] = d_shard_offset[shard];
+  }
+}
+
+template <typename TypeHashKey>
+__global__ void scatter_shard_keys(const TypeHashKey* d_keys, const size_t num_keys,
+                                   const size_t num_shards, TypeHashKey* d_shard_keys,
+                                   uint64_t* d_shard_index, size_t* d_shard_cursor) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < num_keys) {
+    const TypeHashKey key = d_keys[idx];
+    const size_t shard = shard_of_key(key, num_shards);
+    const size_t dst =
+        atomicAdd(reinterpret_cast<unsigned long long*>(d_shard_cursor + shard), 1ull);
+    d_shard_keys[dst] = key;
+    d_shard_index[dst] = idx;
+  }
+}
+
+// Kernel to compact the <k,v> pairs of a single shard, 1 thread per key
+template <typename TypeHashKey>
+__global__ void select_shard_emb_vec(const TypeHashKey* d_keys, const float* d_emb_vec,
+                                     const size_t len, const size_t emb_vec_size,
+                                     const size_t num_shards, const size_t shard_id,
+                                     TypeHashKey* d_shard_keys, float* d_shard_emb_vec,
+                                     size_t* d_shard_len) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx < len && shard_of_key(d_keys[idx], num_shards) == shard_id) {
+    const size_t dst = atomicAdd(reinterpret_cast<unsigned long long*>(d_shard_len), 1ull);
+    d_shard_keys[dst] = d_keys[idx];
+    for (size_t i = 0; i < emb_vec_size; i++) {
+      d_shard_emb_vec[dst * emb_vec_size + i] = d_emb_vec[idx * emb_vec_size + i];
+    }
+  }
+}
+
 void merge_emb_vec_async(float* d_vals_merge_dst_ptr, const float* d_vals_retrieved_ptr,
                          const uint64_t* d_missing_index_ptr, const size_t missing_len,
                          const size_t emb_vec_size, const size_t BLOCK_SIZE, cudaStream_t stream) {
@@ -69,7 +156,21 @@ void merge_emb_vec_async(float* d_vals_merge_dst_ptr, const float* d_vals_retrie
   }
   size_t missing_len_in_float = missing_len * emb_vec_size;
   merge_emb_vec<<<((missing_len_in_float - 1) / BLOCK_SIZE) + 1, BLOCK_SIZE, 0, stream>>>(
-      d_vals_merge_dst_ptr, d_vals_retrieved_ptr, d_missing_index_ptr, missing_len, emb_vec_size);
+      d_vals_merge_dst_ptr, d_vals_retrieved_ptr, d_missing_index_ptr, missing_len, nullptr,
+      emb_vec_size);
+}
+
+void merge_emb_vec_async(float* d_vals_merge_dst_ptr, const float* d_vals_retrieved_ptr,
+                         const uint64_t* d_missing_index_ptr, const size_t* d_missing_len_ptr,
+                         const size_t max_missing_len, const size_t emb_vec_size,
+                         const size_t BLOCK_SIZE, cudaStream_t stream) {
+  if (max_missing_len == 0) {
+    return;
+  }
+  size_t missing_len_in_float = max_missing_len * emb_vec_size;
+  merge_emb_vec<<<((missing_len_in_float - 1) / BLOCK_SIZE) + 1, BLOCK_SIZE, 0, stream>>>(
+      d_vals_merge_dst_ptr, d_vals_retrieved_ptr, d_missing_index_ptr, max_missing_len,
+      d_missing_len_ptr, emb_vec_size);
 }
 
 void fill_default_emb_vec_async(float* d_vals_merge_dst_ptr, const float default_emb_vec,
@@ -96,4 +197,64 @@ void decompress_emb_vec_async(const float* d_unique_src_ptr, const uint64_t* d_u
       d_unique_src_ptr, d_unique_index_ptr, d_decompress_dst_ptr, decompress_len, emb_vec_size);
 }
 
+void pool_emb_vec_async(const float* d_unique_src_ptr, const uint64_t* d_unique_index_ptr,
+                        const int64_t* d_row_offsets, const size_t num_rows,
+                        const size_t emb_vec_size, const bool mean, float* d_pooled_dst_ptr,
+                        const size_t BLOCK_SIZE, cudaStream_t stream) {
+  if (num_rows == 0) {
+    return;
+  }
+  size_t pooled_len_in_float = num_rows * emb_vec_size;
+  pool_emb_vec<<<((pooled_len_in_float - 1) / BLOCK_SIZE) + 1, BLOCK_SIZE, 0, stream>>>(
+      d_unique_src_ptr, d_unique_index_ptr, d_row_offsets, num_rows, emb_vec_size, mean,
+      d_pooled_dst_ptr);
+}
+
+template <typename TypeHashKey>
+void partition_keys_by_shard_async(const TypeHashKey* d_keys, const size_t num_keys,
+                                   const size_t num_shards, TypeHashKey* d_shard_keys,
+                                   uint64_t* d_shard_index, size_t* d_shard_offset,
+                                   size_t* d_shard_cursor, const size_t BLOCK_SIZE,
+                                   cudaStream_t stream) {
+  cudaMemsetAsync(d_shard_cursor, 0, num_shards * sizeof(size_t), stream);
+  if (num_keys > 0) {
+    count_shard_keys<<<((num_keys - 1) / BLOCK_SIZE) + 1, BLOCK_SIZE, 0, stream>>>(
+        d_keys, num_keys, num_shards, d_shard_cursor);
+  }
+  scan_shard_offsets<<<1, 1, 0, stream>>>(d_shard_offset, d_shard_cursor, num_shards);
+  if (num_keys > 0) {
+    scatter_shard_keys<<<((num_keys - 1) / BLOCK_SIZE) + 1, BLOCK_SIZE, 0, stream>>>(
+        d_keys, num_keys, num_shards, d_shard_keys, d_shard_index, d_shard_cursor);
+  }
+}
+
+template <typename TypeHashKey>
+void select_shard_emb_vec_async(const TypeHashKey* d_keys, const float* d_emb_vec,
+                                const size_t len, const size_t emb_vec_size,
+                                const size_t num_shards, const size_t shard_id,
+                                TypeHashKey* d_shard_keys, float* d_shard_emb_vec,
+                                size_t* d_shard_len, const size_t BLOCK_SIZE,
+                                cudaStream_t stream) {
+  cudaMemsetAsync(d_shard_len, 0, sizeof(size_t), stream);
+  if (len == 0) {
+    return;
+  }
+  select_shard_emb_vec<<<((len - 1) / BLOCK_SIZE) + 1, BLOCK_SIZE, 0, stream>>>(
+      d_keys, d_emb_vec, len, emb_vec_size, num_shards, shard_id, d_shard_keys, d_shard_emb_vec,
+      d_shard_len);
+}
+
+template void partition_keys_by_shard_async<long long>(const long long*, size_t, size_t,
+                                                       long long*, uint64_t*, size_t*, size_t*,
+                                                       size_t, cudaStream_t);
+template void partition_keys_by_shard_async<unsigned int>(const unsigned int*, size_t, size_t,
+                                                          unsigned int*, uint64_t*, size_t*,
+                                                          size_t*, size_t, cudaStream_t);
+template void select_shard_emb_vec_async<long long>(const long long*, const float*, size_t,
+                                                    size_t, size_t, size_t, long long*, float*,
+                                                    size_t*, size_t, cudaStream_t);
+template void select_shard_emb_vec_async<unsigned int>(const unsigned int*, const float*, size_t,
+                                                       size_t, size_t, size_t, unsigned int*,
+                                                       float*, size_t*, size_t, cudaStream_t);
+
 }  // namespace HugeCTR
@@ -16,10 +16,12 @@
 
 #include <parallel_hashmap/phmap.h>
 
+#include <algorithm>
 #include <cstring>
 #include <hps/database_backend.hpp>
 #include <hps/database_backend_detail.hpp>
 #include <hps/kafka_message.hpp>
+#include <type_traits>
 #include <vector>
 
 // TODO: Remove me!
@@ -68,6 +70,88 @@ const size_t HCTR_KAFKA_ERROR_STRING_LENGTH = 512;
 const uint32_t HCTR_KAFKA_VALUE_PREFIX =
     (uint32_t)('H') | ((uint32_t)('C') << 8) | ((uint32_t)('T') << 16) | ((uint32_t)('R') << 24);
 
+/**
+ * Messages in the columnar format are laid out as follows:
+ *
+ *   uint32_t prefix              = HCTR_KAFKA_COLUMNAR_PREFIX
+ *   uint32_t value_size          Size of each value after decoding.
+ *   uint8_t  version             = HCTR_KAFKA_COLUMNAR_VERSION
+ *   uint8_t  value_encoding      DatabaseValueEncoding_t
+ *   uint16_t reserved
+ *   uint32_t num_pairs
+ *   varint   keys[num_pairs]     Ascending. Each key is stored as difference to its predecessor.
+ *   char     values[num_pairs]   Encoded values in the same order as the keys.
+ */
+const uint32_t HCTR_KAFKA_COLUMNAR_PREFIX =
+    (uint32_t)('H') | ((uint32_t)('C') << 8) | ((uint32_t)('T') << 16) | ((uint32_t)('C') << 24);
+const uint8_t HCTR_KAFKA_COLUMNAR_VERSION = 1;
+const size_t HCTR_KAFKA_COLUMNAR_HEADER_SIZE = sizeof(uint32_t) * 4;
+const size_t HCTR_KAFKA_MAX_VARINT_SIZE = 10;
+
+void kafka_append_varint(std::vector<char>& dst, uint64_t value) {
+  while (value >= 0x80) {
+    dst.push_back(static_cast<char>(static_cast<uint8_t>(value) | 0x80));
+    value >>= 7;
+  }
+  dst.push_back(static_cast<char>(value));
+}
+
+bool kafka_read_varint(const char*& p, const char* const p_end, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; p != p_end && shift < 64; shift += 7) {
+    const uint8_t b = static_cast<uint8_t>(*p++);
+    value |= static_cast<uint64_t>(b & 0x7f) << shift;
+    if (!(b & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Parses the remainder of a columnar message header, and decodes its key column. Upon success,
+ * \p p points to the first value.
+ *
+ * @return \p false if the message is malformed or uses an unsupported version.
+ */
+template <typename Key>
+bool kafka_decode_key_column(const char*& p, const char* const p_end, const uint32_t value_size,
+                             DatabaseValueEncoding_t& value_encoding, size_t& encoded_value_size,
+                             std::vector<Key>& keys) {
+  using UKey = std::make_unsigned_t<Key>;
+
+  if (static_cast<size_t>(p_end - p) < sizeof(uint32_t) * 2) {
+    return false;
+  }
+  const uint8_t version = *reinterpret_cast<const uint8_t*>(p);
+  const uint8_t encoding = *reinterpret_cast<const uint8_t*>(&p[1]);
+  const uint32_t num_pairs = *reinterpret_cast<const uint32_t*>(&p[sizeof(uint32_t)]);
+  p += sizeof(uint32_t) * 2;
+
+  if (version != HCTR_KAFKA_COLUMNAR_VERSION ||
+      encoding > static_cast<uint8_t>(DatabaseValueEncoding_t::Float8)) {
+    return false;
+  }
+  value_encoding = static_cast<DatabaseValueEncoding_t>(encoding);
+  if (value_encoding != DatabaseValueEncoding_t::Raw && value_size % sizeof(float) != 0) {
+    return false;
+  }
+  encoded_value_size = db_encoded_value_size(value_encoding, value_size);
+
+  keys.clear();
+  UKey key = 0;
+  for (uint32_t i = 0; i < num_pairs; ++i) {
+    uint64_t delta;
+    if (!kafka_read_varint(p, p_end, delta)) {
+      return false;
+    }
+    key = static_cast<UKey>(key + delta);
+    keys.push_back(static_cast<Key>(key));
+  }
+
+  return static_cast<size_t>(p_end - p) == num_pairs * encoded_value_size;
+}
+
 void kafka_conf_set_and_check(rd_kafka_conf_t* const conf, const char* const key,
                               const char* const value) {
   char error[HCTR_KAFKA_ERROR_STRING_LENGTH];
@@ -123,7 +207,8 @@ KafkaMessageSink<Key>::KafkaMessageSink(const KafkaMessageSinkParams& params)
   for (auto it = send_buffer_memory_.begin(); it != send_buffer_memory_.end();
        it += params.send_buffer_size) {
     char* send_buffer = &(*it);
-    *reinterpret_cast<uint32_t*>(send_buffer) = HCTR_KAFKA_VALUE_PREFIX;
+    *reinterpret_cast<uint32_t*>(send_buffer) =
+        params.columnar_format ? HCTR_KAFKA_COLUMNAR_PREFIX : HCTR_KAFKA_VALUE_PREFIX;
     send_buffers_.push_back(send_buffer);
   }
   HCTR_CHECK(send_buffers_.size() == params.num_send_buffers);
@@ -154,7 +239,7 @@ KafkaMessageSink<Key>::KafkaMessageSink(const KafkaMessageSinkParams& params)
   kafka_conf_set_and_check(conf, "queue.buffering.max.kbytes",
                            1 * 1024 * 1024);                       // Default: 1'048'576
   kafka_conf_set_and_check(conf, "queue.buffering.max.ms", 100);   // Default: 5
-  kafka_conf_set_and_check(conf, "compression.codec", "none");     // Default: none
+  kafka_conf_set_and_check(conf, "compression.codec", params.compression_codec);  // Default: none
   kafka_conf_set_and_check(conf, "batch.num.messages", 8 * 1024);  // Default: 10'000
   kafka_conf_set_and_check(conf, "batch.size", 64 * 1024 * 1024);  // Default: 1'000'000
   rd_kafka_conf_set_dr_msg_cb(
@@ -218,7 +303,9 @@ void KafkaMessageSink<Key>::post(const std::string& tag, size_t num_pairs, const
   // Get topic, or create if it doesn't exist yet.
   rd_kafka_topic_t* const topic = resolve_topic(tag);
 
-  if (num_pairs == 0) {
+  if (num_pairs && this->params_.columnar_format) {
+    post_columnar(topic, num_pairs, keys, values, value_size);
+  } else if (num_pairs == 0) {
     // Request send buffer to hold the payload.
     char* const payload = acquire_send_buffer(value_size);
     const size_t p_length = sizeof(uint32_t) * 2;
@@ -292,6 +379,77 @@ void KafkaMessageSink<Key>::post(const std::string& tag, size_t num_pairs, const
   Base::post(tag, num_pairs, keys, values, value_size);
 }
 
+template <typename Key>
+void KafkaMessageSink<Key>::post_columnar(rd_kafka_topic_t* const topic, const size_t num_pairs,
+                                          const Key* const keys, const char* const values,
+                                          const uint32_t value_size) {
+  using UKey = std::make_unsigned_t<Key>;
+
+  const DatabaseValueEncoding_t value_encoding{this->params_.value_encoding};
+  const size_t encoded_value_size{db_encoded_value_size(value_encoding, value_size)};
+  const size_t max_columns_size{this->params_.send_buffer_size - HCTR_KAFKA_COLUMNAR_HEADER_SIZE};
+  HCTR_CHECK(HCTR_KAFKA_MAX_VARINT_SIZE + encoded_value_size <= max_columns_size);
+
+  std::vector<size_t> indices;
+  std::vector<char> key_column;
+  key_column.reserve(max_columns_size);
+
+  const size_t num_partitions{this->params_.num_partitions};
+  for (size_t part_index = 0; part_index < num_partitions; ++part_index) {
+    // Gather keys that belong to current group in ascending order (duplicates retain their order).
+    indices.clear();
+    for (size_t i = 0; i < num_pairs; ++i) {
+      if (HCTR_HPS_KEY_TO_PART_INDEX_(keys[i]) == part_index) {
+        indices.push_back(i);
+      }
+    }
+    std::stable_sort(indices.begin(), indices.end(), [keys](const size_t a, const size_t b) {
+      return static_cast<UKey>(keys[a]) < static_cast<UKey>(keys[b]);
+    });
+
+    for (auto it = indices.begin(); it != indices.end();) {
+      // Delta-encode keys until the message would overflow the send buffer.
+      const auto first = it;
+      key_column.clear();
+      UKey prev_key = 0;
+      for (; it != indices.end(); ++it) {
+        const UKey key{static_cast<UKey>(keys[*it])};
+        const size_t prev_size{key_column.size()};
+        kafka_append_varint(key_column, key - prev_key);
+
+        const size_t num_values{static_cast<size_t>(it - first) + 1};
+        if (key_column.size() + num_values * encoded_value_size > max_columns_size) {
+          key_column.resize(prev_size);
+          break;
+        }
+        prev_key = key;
+      }
+      const size_t batch_size{static_cast<size_t>(it - first)};
+
+      // Request send buffer and fill header.
+      char* const payload = acquire_send_buffer(value_size);
+      size_t p_length = sizeof(uint32_t) * 2;
+      payload[p_length] = static_cast<char>(HCTR_KAFKA_COLUMNAR_VERSION);
+      payload[p_length + 1] = static_cast<char>(value_encoding);
+      *reinterpret_cast<uint16_t*>(&payload[p_length + 2]) = 0;
+      p_length += sizeof(uint32_t);
+      *reinterpret_cast<uint32_t*>(&payload[p_length]) = static_cast<uint32_t>(batch_size);
+      p_length += sizeof(uint32_t);
+
+      // Append key column, followed by value column.
+      std::copy(key_column.begin(), key_column.end(), &payload[p_length]);
+      p_length += key_column.size();
+      for (auto jt = first; jt != it; ++jt) {
+        db_encode_value(value_encoding, &values[*jt * value_size], value_size, &payload[p_length]);
+        p_length += encoded_value_size;
+      }
+
+      // Produce Kafka message.
+      blocking_produce(topic, payload, p_length, part_index);
+    }
+  }
+}
+
 template <typename Key>
 void KafkaMessageSink<Key>::flush() {
   while (true) {
@@ -426,13 +584,15 @@ KafkaMessageSource<Key>::KafkaMessageSource(
     const std::string& brokers, const std::string& consumer_group_id,
     const std::vector<std::string>& tag_filters, const size_t metadata_refresh_interval_ms,
     const size_t receive_buffer_size, const size_t poll_timeout_ms, const size_t max_batch_size,
-    const size_t failure_backoff_ms, const size_t max_commit_interval)
+    const size_t failure_backoff_ms, const size_t max_commit_interval,
+    const size_t coalescing_window_ms)
     : Base(),
       tag_filters_(tag_filters),
       poll_timeout_ms_(poll_timeout_ms),
       max_batch_size_(max_batch_size),
       failure_backoff_ms_(failure_backoff_ms),
-      max_commit_interval_(max_commit_interval) {
+      max_commit_interval_(max_commit_interval),
+      coalescing_window_ms_(coalescing_window_ms) {
   // Make sure that there is at least one valid subscription pattern.
   HCTR_CHECK_HINT(!tag_filters_.empty(),
                   "Must provide at least subscription topic filter for Kafka.");
@@ -558,6 +718,10 @@ struct KafkaReceiveBuffer final {
   std::unique_ptr<rd_kafka_topic_partition_list_t, KafkaTopicPartitionListDeleter> next_offsets{
       rd_kafka_topic_partition_list_new(1)};
 
+  // Only used when coalescing.
+  std::chrono::steady_clock::time_point window_start;  // Arrival of the oldest buffered key.
+  phmap::flat_hash_map<Key, size_t> key_indices;       // Position of each key in the buffer.
+
   KafkaReceiveBuffer() = delete;
   KafkaReceiveBuffer(const uint32_t _value_size, const size_t max_batch_size)
       : value_size{_value_size} {
@@ -601,9 +765,50 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
     num_keys_delivered_ += buf.keys.size();
     buf.keys.clear();
     buf.values.clear();
+    buf.key_indices.clear();
+    return true;
+  };
+
+  // When coalescing, buffers are only handed over once their window has elapsed.
+  const bool coalesce{coalescing_window_ms_.count() > 0};
+  auto window_elapsed = [&](const KafkaReceiveBuffer<Key>& buf) -> bool {
+    return !coalesce ||
+           std::chrono::steady_clock::now() - buf.window_start >= coalescing_window_ms_;
+  };
+  const int poll_timeout_ms{static_cast<int>(
+      coalesce ? std::min<size_t>(poll_timeout_ms_, coalescing_window_ms_.count())
+               : poll_timeout_ms_)};
+
+  // Appends a key/value pair to the receive buffer. Delivers directly if the buffer is full.
+  auto append = [&](const std::string& topic, KafkaReceiveBuffer<Key>& buf, const Key key,
+                    const char* const value) -> bool {
+    if (coalesce) {
+      if (buf.keys.empty()) {
+        buf.window_start = std::chrono::steady_clock::now();
+      }
+
+      // Key already buffered? Overwrite its value (last writer wins).
+      const auto& res{buf.key_indices.try_emplace(key, buf.keys.size())};
+      if (!res.second) {
+        std::copy_n(value, buf.value_size, &buf.values[res.first->second * buf.value_size]);
+        return true;
+      }
+    }
+
+    buf.keys.push_back(key);
+    buf.values.insert(buf.values.end(), value, &value[buf.value_size]);
+
+    if (buf.keys.size() >= max_batch_size_) {
+      HCTR_LOG_C(TRACE, WORLD, "Kafka topic '", topic, "': Receive buffer is full.\n");
+      return deliver(topic, buf);
+    }
     return true;
   };
 
+  // Scratch space for decoding columnar messages.
+  std::vector<Key> columnar_keys;
+  std::vector<char> decoded_value;
+
   auto commit = [&](const std::string& topic, KafkaReceiveBuffer<Key>& buf) -> void {
     if (!buf.next_offsets->cnt) {
       return;
@@ -637,7 +842,7 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
 
   while (!terminate_) {
     std::unique_ptr<rd_kafka_message_t, KafkaMessageDeleter> msg{
-        rd_kafka_consumer_poll(rk_, static_cast<int>(poll_timeout_ms_))};
+        rd_kafka_consumer_poll(rk_, poll_timeout_ms)};
 
     // Timeout, or end of partition reached.
     if (!msg || msg->err == RD_KAFKA_RESP_ERR__TIMED_OUT ||
@@ -645,6 +850,9 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
       for (auto& recv_buffer_entry : recv_buffers) {
         const std::string& topic{recv_buffer_entry.first};
         KafkaReceiveBuffer<Key>& buf{recv_buffer_entry.second};
+        if (!window_elapsed(buf)) {
+          continue;
+        }
 
         // Hand over remaining data and commit.
         if (!deliver(topic, buf)) {
@@ -710,7 +918,8 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
     // Parse header.
     const char* p = static_cast<char*>(msg->payload);
     const char* const p_end = &p[msg->len];
-    if (*reinterpret_cast<const uint32_t*>(p) != HCTR_KAFKA_VALUE_PREFIX) {
+    const uint32_t prefix = *reinterpret_cast<const uint32_t*>(p);
+    if (prefix != HCTR_KAFKA_VALUE_PREFIX && prefix != HCTR_KAFKA_COLUMNAR_PREFIX) {
       HCTR_LOG(WARNING, WORLD,
                "Kafka message header contains unexpected values. Message discarded!\n");
       continue;
@@ -724,6 +933,18 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
       continue;
     }
 
+    // Columnar format: Decode the key column upfront. Values are decoded while copying.
+    DatabaseValueEncoding_t value_encoding{DatabaseValueEncoding_t::Raw};
+    size_t encoded_value_size{value_size};
+    if (prefix == HCTR_KAFKA_COLUMNAR_PREFIX &&
+        !kafka_decode_key_column(p, p_end, value_size, value_encoding, encoded_value_size,
+                                 columnar_keys)) {
+      HCTR_LOG(WARNING, WORLD,
+               "Kafka message is malformed, or uses an unsupported format version. Message "
+               "discarded!\n");
+      continue;
+    }
+
     // Select receive buffer.
     const char* const topic = rd_kafka_topic_name(msg->rkt);
     KafkaReceiveBuffer<Key>& buf =
@@ -744,18 +965,23 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
     }
 
     // Copy data to receive buffer.
-    while (p != p_end) {
-      buf.keys.push_back(*reinterpret_cast<const Key*>(p));
-      p += sizeof(Key);
-
-      const char* const p_next = &p[value_size];
-      buf.values.insert(buf.values.end(), p, p_next);
-      p = p_next;
+    if (prefix == HCTR_KAFKA_VALUE_PREFIX) {
+      for (; p != p_end; p += sizeof(Key) + value_size) {
+        if (!append(topic, buf, *reinterpret_cast<const Key*>(p), &p[sizeof(Key)])) {
+          break;
+        }
+      }
+    } else {
+      decoded_value.resize(value_size);
+      for (const Key key : columnar_keys) {
+        const char* value{p};
+        if (value_encoding != DatabaseValueEncoding_t::Raw) {
+          db_decode_value(value_encoding, p, encoded_value_size, decoded_value.data());
+          value = decoded_value.data();
+        }
+        p += encoded_value_size;
 
-      // Deliver directly if receive buffer is full.
-      if (buf.keys.size() >= max_batch_size_) {
-        HCTR_LOG_C(TRACE, WORLD, "Kafka topic '", topic, "': Receive buffer is full.\n");
-        if (!deliver(topic, buf)) {
+        if (!append(topic, buf, key, value)) {
           break;
         }
       }
@@ -774,8 +1000,9 @@ void KafkaMessageSource<Key>::run(std::function<Callback> callback) {
     }
     part->offset = msg->offset + 1;
 
-    // If reached maximum commit interval, deliver and commit now.
-    if (++buf.msg_count > max_commit_interval_) {
+    // If reached maximum commit interval (or coalescing window elapsed), deliver and commit now.
+    ++buf.msg_count;
+    if (coalesce ? window_elapsed(buf) : buf.msg_count > max_commit_interval_) {
       HCTR_LOG_C(TRACE, WORLD, " Kafka topic '", topic, "': Commit interval reached.\n");
       if (!deliver(topic, buf)) {
         break;
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <hps/lookup_metrics.hpp>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace HugeCTR {
+
+const char* lookup_stage_name(const LookupStage_t stage) {
+  switch (stage) {
+    case LookupStage_t::WorkspaceWait:
+      return "workspace_wait";
+    case LookupStage_t::CacheQuery:
+      return "cache_query";
+    case LookupStage_t::MissCompaction:
+      return "miss_compaction";
+    case LookupStage_t::VDBFetch:
+      return "vdb_fetch";
+    case LookupStage_t::PDBFetch:
+      return "pdb_fetch";
+    case LookupStage_t::H2DCopy:
+      return "h2d_copy";
+    case LookupStage_t::Insert:
+      return "insert";
+  }
+  return "unknown";
+}
+
+void LatencyHistogram::observe(const uint64_t latency_us) {
+  // Threads are assigned to the shards in a round robin manner upon their first observation.
+  static std::atomic<size_t> next_shard{0};
+  thread_local const size_t shard_id{next_shard.fetch_add(1, std::memory_order_relaxed) %
+                                     num_shards_};
+
+  // Smallest bucket whose bound is not exceeded.
+  size_t bucket{0};
+  if (latency_us > 1) {
+    bucket = std::min(static_cast<size_t>(64 - __builtin_clzll(latency_us - 1)), num_buckets - 1);
+  }
+
+  Shard& shard{shards_[shard_id]};
+  shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+  shard.sum_us.fetch_add(latency_us, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+  Snapshot snapshot;
+  for (const Shard& shard : shards_) {
+    for (size_t i{0}; i < num_buckets; ++i) {
+      const uint64_t count{shard.counts[i].load(std::memory_order_relaxed)};
+      snapshot.counts[i] += count;
+      snapshot.count += count;
+    }
+    snapshot.sum_us += shard.sum_us.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+LookupMetrics& LookupMetrics::instance() {
+  static LookupMetrics metrics;
+  return metrics;
+}
+
+LatencyHistogram& LookupMetrics::histogram(const std::string& model_name, const size_t table_id,
+                                           const LookupStage_t stage) {
+  const auto key{std::make_tuple(model_name, table_id, stage)};
+  {
+    const std::shared_lock lock(mutex_);
+    const auto it{histograms_.find(key)};
+    if (it != histograms_.end()) {
+      return *it->second;
+    }
+  }
+  const std::unique_lock lock(mutex_);
+  std::unique_ptr<LatencyHistogram>& histogram{histograms_[key]};
+  if (!histogram) {
+    histogram = std::make_unique<LatencyHistogram>();
+  }
+  return *histogram;
+}
+
+void LookupMetrics::visit(const Visitor& visitor) const {
+  const std::shared_lock lock(mutex_);
+  for (const auto& [key, histogram] : histograms_) {
+    visitor(std::get<0>(key), std::get<1>(key), std::get<2>(key), histogram->snapshot());
+  }
+}
+
+std::string LookupMetrics::to_openmetrics() const {
+  static const char* const name{"hps_lookup_stage_latency_seconds"};
+
+  std::ostringstream os;
+  os << std::setprecision(12);
+  os << "# TYPE " << name << " histogram\n";
+  os << "# UNIT " << name << " seconds\n";
+  os << "# HELP " << name << " Latency of each stage of the HPS embedding lookups.\n";
+  visit([&](const std::string& model_name, const size_t table_id, const LookupStage_t stage,
+            const LatencyHistogram::Snapshot& snapshot) {
+    std::ostringstream labels;
+    labels << "model=\"" << model_name << "\",table=\"" << table_id << "\",stage=\""
+           << lookup_stage_name(stage) << '"';
+
+    uint64_t cumulative_count{0};
+    for (size_t i{0}; i < LatencyHistogram::num_buckets; ++i) {
+      cumulative_count += snapshot.counts[i];
+      os << name << "_bucket{" << labels.str() << ",le=\"";
+      if (i + 1 < LatencyHistogram::num_buckets) {
+        os << static_cast<double>(LatencyHistogram::bucket_bound_us(i)) * 1e-6;
+      } else {
+        os << "+Inf";
+      }
+      os << "\"} " << cumulative_count << '\n';
+    }
+    os << name << "_sum{" << labels.str() << "} " << static_cast<double>(snapshot.sum_us) * 1e-6
+       << '\n';
+    os << name << "_count{" << labels.str() << "} " << snapshot.count << '\n';
+  });
+  os << "# EOF\n";
+  return os.str();
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <hps/lookup_server.hpp>
+#include <hps/remote_lookup.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+// Upper bound of the keys of one request, so that a corrupt header cannot exhaust the memory.
+constexpr uint64_t max_request_bytes{1ull << 30};
+
+}  // namespace
+
+BatchedLookupSession::BatchedLookupSession(
+    const std::shared_ptr<LookupSessionBase>& lookup_session,
+    const std::chrono::microseconds max_delay)
+    : lookup_session_(lookup_session), max_delay_(max_delay) {
+  const InferenceParams params{lookup_session_->get_inference_params()};
+  HCTR_THROW_IF(params.fuse_embedding_table, Error_t::WrongInput,
+                "Batched lookup sessions do not support table fusion");
+  device_id_ = params.device_id;
+  key_size_ = params.i64_input_key ? sizeof(long long) : sizeof(unsigned int);
+
+  CudaDeviceContext context(device_id_);
+  const size_t num_tables{params.sparse_model_files.size()};
+  for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+    auto table{std::make_unique<Table>()};
+    table->vector_size = params.embedding_vecsize_per_table[table_id];
+    table->max_num_keys =
+        params.max_batchsize * params.maxnum_catfeature_query_per_table_per_sample[table_id];
+    HCTR_LIB_THROW(cudaMallocHost(&table->h_keys, key_size_ * table->max_num_keys));
+    HCTR_LIB_THROW(cudaMallocHost(&table->h_vectors,
+                                  sizeof(float) * table->max_num_keys * table->vector_size));
+    HCTR_LIB_THROW(
+        cudaMalloc(&table->d_vectors, sizeof(float) * table->max_num_keys * table->vector_size));
+    tables_.emplace_back(std::move(table));
+  }
+  for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+    tables_[table_id]->worker = std::thread(&BatchedLookupSession::run, this, table_id);
+  }
+}
+
+BatchedLookupSession::~BatchedLookupSession() {
+  stop_ = true;
+  for (const auto& table : tables_) {
+    {
+      std::lock_guard<std::mutex> lock(table->mutex);
+    }
+    table->cv.notify_all();
+    table->worker.join();
+  }
+  CudaDeviceContext context(device_id_);
+  for (const auto& table : tables_) {
+    HCTR_LIB_CHECK_(cudaFreeHost(table->h_keys));
+    HCTR_LIB_CHECK_(cudaFreeHost(table->h_vectors));
+    HCTR_LIB_CHECK_(cudaFree(table->d_vectors));
+  }
+}
+
+void BatchedLookupSession::lookup(const void* const h_keys, float* const h_vectors,
+                                  const size_t num_keys, const size_t table_id) {
+  HCTR_THROW_IF(table_id >= tables_.size(), Error_t::WrongInput, "Table ", table_id,
+                " does not exist");
+  Table& table{*tables_[table_id]};
+
+  const size_t num_requests{(num_keys + table.max_num_keys - 1) / table.max_num_keys};
+  std::vector<Request> requests(num_requests);
+  {
+    std::lock_guard<std::mutex> lock(table.mutex);
+    HCTR_THROW_IF(stop_, Error_t::IllegalCall, "The batched lookup session is shutting down");
+    const auto now{std::chrono::steady_clock::now()};
+    for (size_t i{0}; i < num_requests; ++i) {
+      Request& request{requests[i]};
+      const size_t offset{i * table.max_num_keys};
+      request.h_keys = static_cast<const char*>(h_keys) + offset * key_size_;
+      request.h_vectors = h_vectors + offset * table.vector_size;
+      request.num_keys = std::min(table.max_num_keys, num_keys - offset);
+      request.arrival = now;
+      table.pending.emplace_back(&request);
+      table.num_pending_keys += request.num_keys;
+    }
+  }
+  table.cv.notify_one();
+
+  for (Request& request : requests) {
+    request.done.get_future().get();
+  }
+}
+
+void BatchedLookupSession::run(const size_t table_id) {
+  CudaDeviceContext context(device_id_);
+  Table& table{*tables_[table_id]};
+  std::vector<Request*> batch;
+  while (true) {
+    size_t num_keys{0};
+    {
+      std::unique_lock<std::mutex> lock(table.mutex);
+      table.cv.wait(lock, [&]() { return stop_ || !table.pending.empty(); });
+      if (table.pending.empty()) {
+        return;
+      }
+      // Give the other clients max_delay to join the batch, unless it is already full.
+      table.cv.wait_until(lock, table.pending.front()->arrival + max_delay_, [&]() {
+        return stop_ || table.num_pending_keys >= table.max_num_keys;
+      });
+      while (!table.pending.empty() &&
+             num_keys + table.pending.front()->num_keys <= table.max_num_keys) {
+        Request* const request{table.pending.front()};
+        table.pending.pop_front();
+        table.num_pending_keys -= request->num_keys;
+        num_keys += request->num_keys;
+        batch.emplace_back(request);
+      }
+    }
+
+    try {
+      char* h_keys{table.h_keys};
+      for (const Request* const request : batch) {
+        std::memcpy(h_keys, request->h_keys, key_size_ * request->num_keys);
+        h_keys += key_size_ * request->num_keys;
+      }
+      lookup_session_->lookup(table.h_keys, table.d_vectors, num_keys, table_id);
+      HCTR_LIB_THROW(cudaMemcpy(table.h_vectors, table.d_vectors,
+                                sizeof(float) * num_keys * table.vector_size,
+                                cudaMemcpyDeviceToHost));
+      const float* h_vectors{table.h_vectors};
+      for (Request* const request : batch) {
+        std::memcpy(request->h_vectors, h_vectors,
+                    sizeof(float) * request->num_keys * table.vector_size);
+        h_vectors += request->num_keys * table.vector_size;
+        request->done.set_value();
+      }
+    } catch (...) {
+      for (Request* const request : batch) {
+        request->done.set_exception(std::current_exception());
+      }
+    }
+    batch.clear();
+  }
+}
+
+LookupServer::LookupServer(const std::vector<std::shared_ptr<BatchedLookupSession>>& sessions,
+                           const uint16_t port)
+    : sessions_(sessions), port_(port) {
+  HCTR_THROW_IF(sessions_.empty(), Error_t::WrongInput,
+                "The lookup server needs at least one session");
+  listen_socket_ = ::socket(AF_INET6, SOCK_STREAM, 0);
+  HCTR_THROW_IF(listen_socket_ < 0, Error_t::UnspecificError, "Cannot create the socket: ",
+                std::strerror(errno));
+  const int one{1};
+  ::setsockopt(listen_socket_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  // Listens on all IPv4 and IPv6 addresses.
+  sockaddr_in6 address{};
+  address.sin6_family = AF_INET6;
+  address.sin6_addr = in6addr_any;
+  address.sin6_port = htons(port_);
+  if (::bind(listen_socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+      ::listen(listen_socket_, SOMAXCONN) != 0) {
+    const int error{errno};
+    ::close(listen_socket_);
+    HCTR_OWN_THROW(Error_t::WrongInput, "Cannot listen on port ", port_, ": ",
+                   std::strerror(error));
+  }
+  // With port 0, the system picks a free one.
+  socklen_t address_size{sizeof(address)};
+  ::getsockname(listen_socket_, reinterpret_cast<sockaddr*>(&address), &address_size);
+  port_ = ntohs(address.sin6_port);
+  HCTR_LOG_S(INFO, WORLD) << "HPS lookup server listening on port " << port_ << std::endl;
+}
+
+LookupServer::~LookupServer() {
+  shutdown();
+  for (std::thread& connection : connections_) {
+    connection.join();
+  }
+  ::close(listen_socket_);
+}
+
+void LookupServer::serve() {
+  for (size_t num_connections{0}; !stop_;) {
+    const int socket{::accept(listen_socket_, nullptr, nullptr)};
+    if (socket < 0) {
+      if (errno != EINTR && !stop_) {
+        HCTR_LOG_S(ERROR, WORLD) << "Cannot accept a connection: " << std::strerror(errno)
+                                 << std::endl;
+      }
+      continue;
+    }
+    const int one{1};
+    ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) {
+      ::close(socket);
+      break;
+    }
+    // Clients that reconnect would otherwise accumulate threads that have ended.
+    join_closed_connections();
+    BatchedLookupSession& session{*sessions_[num_connections++ % sessions_.size()]};
+    sockets_.emplace_back(socket);
+    connections_.emplace_back(&LookupServer::serve_connection, this, socket, std::ref(session));
+  }
+}
+
+void LookupServer::shutdown() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stop_.exchange(true)) {
+    return;
+  }
+  // Wakes up accept() and the recv() of the connections, which then return.
+  ::shutdown(listen_socket_, SHUT_RDWR);
+  for (const int socket : sockets_) {
+    ::shutdown(socket, SHUT_RDWR);
+  }
+}
+
+size_t LookupServer::num_connection_threads() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return connections_.size();
+}
+
+void LookupServer::serve_connection(const int socket, BatchedLookupSession& session) {
+  std::vector<char> keys;
+  std::vector<float> vectors;
+  remote_lookup::RequestHeader request;
+  while (remote_lookup::recv_all(socket, &request, sizeof(request))) {
+    if (request.magic != remote_lookup::request_magic || request.key_size > sizeof(uint64_t) ||
+        request.num_keys > max_request_bytes / sizeof(uint64_t)) {
+      HCTR_LOG_S(ERROR, WORLD) << "Closing a connection with a malformed request" << std::endl;
+      break;
+    }
+    keys.resize(request.key_size * request.num_keys);
+    if (!remote_lookup::recv_all(socket, keys.data(), keys.size())) {
+      break;
+    }
+
+    remote_lookup::ReplyHeader reply{remote_lookup::Status_t::Success, 0, 0};
+    std::string error;
+    try {
+      HCTR_THROW_IF(request.key_size != session.key_size(), Error_t::WrongInput, "The keys have ",
+                    request.key_size, " bytes, but the model has keys of ", session.key_size(),
+                    " bytes");
+      HCTR_THROW_IF(request.table_id >= session.num_tables(), Error_t::WrongInput, "Table ",
+                    request.table_id, " does not exist");
+      reply.vector_size = session.vector_size(request.table_id);
+      vectors.resize(request.num_keys * reply.vector_size);
+      session.lookup(keys.data(), vectors.data(), request.num_keys, request.table_id);
+      reply.payload_size = sizeof(float) * vectors.size();
+    } catch (const std::exception& e) {
+      error = e.what();
+      reply = {remote_lookup::Status_t::Error, 0, error.size()};
+    }
+
+    const void* const payload{reply.status == remote_lookup::Status_t::Success
+                                  ? static_cast<const void*>(vectors.data())
+                                  : static_cast<const void*>(error.data())};
+    if (!remote_lookup::send_all(socket, &reply, sizeof(reply)) ||
+        !remote_lookup::send_all(socket, payload, reply.payload_size)) {
+      break;
+    }
+  }
+
+  // Closes the socket while holding the lock, so that shutdown() cannot hit a reused descriptor.
+  std::lock_guard<std::mutex> lock(mutex_);
+  sockets_.erase(std::find(sockets_.begin(), sockets_.end(), socket));
+  ::close(socket);
+  closed_connections_.emplace_back(std::this_thread::get_id());
+}
+
+void LookupServer::join_closed_connections() {
+  // The threads only return after this, and do not need the lock anymore.
+  for (const std::thread::id id : closed_connections_) {
+    const auto it{std::find_if(connections_.begin(), connections_.end(),
+                               [id](const std::thread& connection) {
+                                 return connection.get_id() == id;
+                               })};
+    it->join();
+    connections_.erase(it);
+  }
+  closed_connections_.clear();
+}
+
+}  // namespace HugeCTR
@@ -358,8 +358,8 @@ void LookupSession::lookup_from_device(const std::vector<const void*>& d_keys_pe
   const auto begin = std::chrono::high_resolution_clock::now();
   BaseUnit* start = profiler::start();
 
-  for (size_t table_id{0}; table_id < original_num_tables; ++table_id) {
-    if (inference_params_.fuse_embedding_table) {
+  if (inference_params_.fuse_embedding_table) {
+    for (size_t table_id{0}; table_id < original_num_tables; ++table_id) {
       auto work_func = [this, d_keys_per_table, d_vectors_per_table, num_keys_per_table,
                         table_id]() {
         size_t fused_table_id = inference_params_.original_table_id_to_fused_table_id_map[table_id];
@@ -368,14 +368,16 @@ void LookupSession::lookup_from_device(const std::vector<const void*>& d_keys_pe
             table_id, true, lookup_streams_[fused_table_id]);
       };
       table_fusion_thread_pool_.submit(work_func);
-    } else {
-      this->lookup_from_device_impl(d_keys_per_table[table_id], d_vectors_per_table[table_id],
-                                    num_keys_per_table[table_id], table_id,
-                                    lookup_streams_[table_id]);
     }
-  }
-  if (inference_params_.fuse_embedding_table) {
     table_fusion_thread_pool_.await_idle();
+  } else {
+    // Query and replace all tables together, instead of one kernel launch per table.
+    CudaDeviceContext dev_restorer;
+    dev_restorer.set_device(inference_params_.device_id);
+    embedding_cache_->lookup_from_device_grouped(d_keys_per_table, d_vectors_per_table,
+                                                 num_keys_per_table,
+                                                 inference_params_.hit_rate_threshold,
+                                                 lookup_streams_[0]);
   }
   for (auto stream : lookup_streams_) {
     HCTR_LIB_THROW(cudaStreamSynchronize(stream));
@@ -387,4 +389,35 @@ void LookupSession::lookup_from_device(const std::vector<const void*>& d_keys_pe
                            << "lookup latency: " << latency.count() / 1000 << " us." << std::endl;
 }
 
-}  // namespace HugeCTR
\ No newline at end of file
+void LookupSession::lookup_from_device_pooled(const void* const d_keys, const size_t num_keys,
+                                              const PoolingRows& rows,
+                                              float* const d_pooled_vectors, const size_t table_id,
+                                              cudaStream_t stream) {
+  // The keys of a fused table are gathered from several lookups before the query.
+  HCTR_CHECK_HINT(!inference_params_.fuse_embedding_table,
+                  "Pooled lookups do not support fused embedding tables.");
+  CudaDeviceContext dev_restorer;
+  dev_restorer.set_device(inference_params_.device_id);
+  embedding_cache_->lookup_from_device_pooled(table_id, d_pooled_vectors, d_keys, num_keys, rows,
+                                              inference_params_.hit_rate_threshold, stream);
+}
+
+void LookupSession::lookup_from_device_pooled(const void* const d_keys, const size_t num_keys,
+                                              const PoolingRows& rows,
+                                              float* const d_pooled_vectors,
+                                              const size_t table_id) {
+  const auto begin = std::chrono::high_resolution_clock::now();
+  BaseUnit* start = profiler::start();
+
+  this->lookup_from_device_pooled(d_keys, num_keys, rows, d_pooled_vectors, table_id,
+                                  lookup_streams_[table_id]);
+  HCTR_LIB_THROW(cudaStreamSynchronize(lookup_streams_[table_id]));
+
+  ls_profiler_->end(start, "End-to-end pooled lookup embedding keys for Lookup session");
+  const auto latency = std::chrono::high_resolution_clock::now() - begin;
+  HCTR_LOG_S(TRACE, WORLD) << "Pooled lookup single table; number of keys " << num_keys
+                           << ", number of rows " << rows.num_rows << ", table id " << table_id
+                           << " lookup latency: " << latency.count() / 1000 << " us." << std::endl;
+}
+
+}  // namespace HugeCTR
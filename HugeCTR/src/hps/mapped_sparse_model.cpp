@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <fstream>
+#include <hps/mapped_sparse_model.hpp>
+#include <io/filesystem.hpp>
+#include <io/io_utils.hpp>
+#include <numeric>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr char mapped_sparse_model_magic[8] = {'H', 'C', 'T', 'R', 'S', 'P', 'M', '\0'};
+constexpr uint32_t mapped_sparse_model_version{1};
+constexpr size_t mapped_sparse_model_page_size{4096};
+
+size_t align_to_page(const size_t offset) {
+  return (offset + mapped_sparse_model_page_size - 1) / mapped_sparse_model_page_size *
+         mapped_sparse_model_page_size;
+}
+
+uint64_t get_index_slot(const long long key, const uint64_t num_slots) {
+  // Finalizer of splitmix64, so that the low bits depend on all bits of the key.
+  uint64_t hash = static_cast<uint64_t>(key);
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+  hash ^= hash >> 31;
+  return hash & (num_slots - 1);
+}
+
+}  // namespace
+
+void write_mapped_sparse_model(const std::string& path, const long long* const keys,
+                               const float* const vectors, const size_t num_keys,
+                               const size_t embedding_vec_size, const bool hash_index) {
+  if (!IOUtils::is_local_path(path)) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "Mapped sparse models can only be written to the local file system: " + path);
+  }
+
+  // Rows by key, keeping only the last row of each key.
+  std::vector<size_t> order(num_keys);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](const size_t a, const size_t b) { return keys[a] < keys[b]; });
+  size_t num_unique = 0;
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (i + 1 == order.size() || keys[order[i]] != keys[order[i + 1]]) {
+      order[num_unique++] = order[i];
+    }
+  }
+  order.resize(num_unique);
+
+  const size_t vector_size_in_byte = embedding_vec_size * sizeof(float);
+  MappedSparseModelHeader header{};
+  std::memcpy(header.magic, mapped_sparse_model_magic, sizeof(header.magic));
+  header.version = mapped_sparse_model_version;
+  header.key_size = sizeof(long long);
+  header.num_keys = num_unique;
+  header.embedding_vec_size = embedding_vec_size;
+  header.keys_offset = align_to_page(sizeof(MappedSparseModelHeader));
+  header.vectors_offset = align_to_page(header.keys_offset + num_unique * sizeof(long long));
+  header.index_offset = align_to_page(header.vectors_offset + num_unique * vector_size_in_byte);
+  header.index_num_slots = 0;
+  if (hash_index && num_unique > 0) {
+    // At most half of the slots are used, so that probe sequences stay short.
+    header.index_num_slots = 1;
+    while (header.index_num_slots < 2 * num_unique) {
+      header.index_num_slots <<= 1;
+    }
+  }
+
+  std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+  HCTR_CHECK_HINT(file.is_open(), "File not open for writing: ", path);
+  size_t position = 0;
+  const std::vector<char> padding(mapped_sparse_model_page_size, 0);
+  const auto pad_to = [&](const size_t offset) {
+    file.write(padding.data(), offset - position);
+    position = offset;
+  };
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  position += sizeof(header);
+  pad_to(header.keys_offset);
+
+  std::vector<long long> sorted_keys(num_unique);
+  for (size_t i = 0; i < num_unique; ++i) {
+    sorted_keys[i] = keys[order[i]];
+  }
+  file.write(reinterpret_cast<const char*>(sorted_keys.data()), num_unique * sizeof(long long));
+  position += num_unique * sizeof(long long);
+  pad_to(header.vectors_offset);
+
+  for (size_t i = 0; i < num_unique; ++i) {
+    file.write(reinterpret_cast<const char*>(vectors + order[i] * embedding_vec_size),
+               vector_size_in_byte);
+  }
+  position += num_unique * vector_size_in_byte;
+
+  if (header.index_num_slots > 0) {
+    pad_to(header.index_offset);
+    std::vector<uint64_t> slots(header.index_num_slots, 0);
+    for (size_t row = 0; row < num_unique; ++row) {
+      uint64_t slot = get_index_slot(sorted_keys[row], header.index_num_slots);
+      while (slots[slot] != 0) {
+        slot = (slot + 1) & (header.index_num_slots - 1);
+      }
+      slots[slot] = row + 1;
+    }
+    file.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(uint64_t));
+  }
+
+  file.close();
+  if (!file) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot write the mapped sparse model: " + path);
+  }
+}
+
+void convert_to_mapped_sparse_model(const std::string& sparse_model, const bool hash_index) {
+  const std::string key_file = sparse_model + "/key";
+  const std::string vec_file = sparse_model + "/emb_vector";
+
+  auto fs = FileSystemBuilder::build_unique_by_path(sparse_model);
+  const size_t key_file_size_in_byte = fs->get_file_size(key_file);
+  const size_t vec_file_size_in_byte = fs->get_file_size(vec_file);
+  const size_t num_keys = key_file_size_in_byte / sizeof(long long);
+  if (num_keys == 0 || key_file_size_in_byte % sizeof(long long) != 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings key file size is not correct");
+  }
+  if (vec_file_size_in_byte % (num_keys * sizeof(float)) != 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings vector file size is not correct");
+  }
+  const size_t embedding_vec_size = vec_file_size_in_byte / (num_keys * sizeof(float));
+
+  std::vector<long long> keys(num_keys);
+  std::vector<float> vectors(num_keys * embedding_vec_size);
+  fs->read(key_file, keys.data(), key_file_size_in_byte, 0);
+  fs->read(vec_file, vectors.data(), vec_file_size_in_byte, 0);
+  write_mapped_sparse_model(sparse_model + "/" + mapped_sparse_model_file_name, keys.data(),
+                            vectors.data(), num_keys, embedding_vec_size, hash_index);
+}
+
+MappedSparseModel::MappedSparseModel(const std::string& path) : path_(path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot open the mapped sparse model: " + path);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(MappedSparseModelHeader)) {
+    close(fd);
+    HCTR_OWN_THROW(Error_t::BrokenFile, "Mapped sparse model is too small: " + path);
+  }
+  size_ = file_stat.st_size;
+  data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data_ == MAP_FAILED) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "Cannot map the mapped sparse model: " + path);
+  }
+  header_ = static_cast<const MappedSparseModelHeader*>(data_);
+
+  const auto& h = *header_;
+  const bool valid =
+      std::memcmp(h.magic, mapped_sparse_model_magic, sizeof(h.magic)) == 0 &&
+      h.version == mapped_sparse_model_version && h.key_size == sizeof(long long) &&
+      h.keys_offset + h.num_keys * sizeof(long long) <= size_ &&
+      h.vectors_offset + h.num_keys * h.embedding_vec_size * sizeof(float) <= size_ &&
+      (h.index_num_slots & (h.index_num_slots - 1)) == 0 &&
+      h.index_offset + h.index_num_slots * sizeof(uint64_t) <= size_;
+  if (!valid) {
+    munmap(data_, size_);
+    HCTR_OWN_THROW(Error_t::BrokenFile, "Invalid mapped sparse model: " + path);
+  }
+}
+
+MappedSparseModel::~MappedSparseModel() { munmap(data_, size_); }
+
+const long long* MappedSparseModel::keys() const {
+  return reinterpret_cast<const long long*>(static_cast<const char*>(data_) +
+                                            header_->keys_offset);
+}
+
+const float* MappedSparseModel::vectors() const {
+  return reinterpret_cast<const float*>(static_cast<const char*>(data_) +
+                                        header_->vectors_offset);
+}
+
+const float* MappedSparseModel::find(const long long key) const {
+  const long long* const model_keys = keys();
+  size_t row = header_->num_keys;
+  if (header_->index_num_slots > 0) {
+    const uint64_t* const slots = reinterpret_cast<const uint64_t*>(
+        static_cast<const char*>(data_) + header_->index_offset);
+    for (uint64_t slot = get_index_slot(key, header_->index_num_slots); slots[slot] != 0;
+         slot = (slot + 1) & (header_->index_num_slots - 1)) {
+      if (model_keys[slots[slot] - 1] == key) {
+        row = slots[slot] - 1;
+        break;
+      }
+    }
+  } else {
+    const long long* const it = std::lower_bound(model_keys, model_keys + header_->num_keys, key);
+    if (it != model_keys + header_->num_keys && *it == key) {
+      row = it - model_keys;
+    }
+  }
+  return row < header_->num_keys ? vectors() + row * header_->embedding_vec_size : nullptr;
+}
+
+}  // namespace HugeCTR
@@ -16,9 +16,16 @@
 
 #include <algorithm>
 #include <common.hpp>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <hps/database_backend_detail.hpp>
 #include <hps/inference_utils.hpp>
 #include <hps/modelloader.hpp>
+#include <io/io_utils.hpp>
+#include <numeric>
 #include <parser.hpp>
+#include <thread_pool.hpp>
 #include <unordered_set>
 #include <utils.hpp>
 
@@ -78,8 +85,14 @@ void RawModelLoader<TKey, TValue>::load_emb(const std::string& table_name,
   const std::string vec_file = emb_file_prefix + "emb_vector";
 
   auto fs = FileSystemBuilder::build_unique_by_path(path);
+  std::unique_ptr<CompressedFileReader> compressed_vectors;
+  const std::string found_vec_file = find_maybe_compressed_file(*fs, vec_file);
+  if (get_file_compression_codec(found_vec_file) != CompressionCodec::None) {
+    compressed_vectors = std::make_unique<CompressedFileReader>(*fs, found_vec_file);
+  }
   const size_t key_file_size_in_byte = fs->get_file_size(key_file);
-  const size_t vec_file_size_in_byte = fs->get_file_size(vec_file);
+  const size_t vec_file_size_in_byte =
+      compressed_vectors ? compressed_vectors->size() : fs->get_file_size(vec_file);
 
   const size_t key_size_in_byte = sizeof(long long);
   const size_t vec_size_in_byte = sizeof(float);
@@ -119,8 +132,13 @@ void RawModelLoader<TKey, TValue>::load_emb(const std::string& table_name,
                    embedding_table_->keys.begin() + key_offset_in_elements,
                    [](long long key) { return static_cast<unsigned>(key); });
   }
-  fs->read(vec_file, embedding_table_->vectors.data() + vec_offset_in_elements,
-           vec_file_size_in_byte, 0);
+  if (compressed_vectors) {
+    compressed_vectors->read(*fs, embedding_table_->vectors.data() + vec_offset_in_elements,
+                             vec_file_size_in_byte, 0);
+  } else {
+    fs->read(vec_file, embedding_table_->vectors.data() + vec_offset_in_elements,
+             vec_file_size_in_byte, 0);
+  }
 }
 
 template <typename TKey, typename TValue>
@@ -134,48 +152,73 @@ void RawModelLoader<TKey, TValue>::load(const std::string& table_name, const std
   const std::string meta_file = emb_file_prefix + "meta";
 
   fs_ = FileSystemBuilder::build_unique_by_path(path);
-  const size_t key_file_size_in_byte = fs_->get_file_size(key_file);
-  const size_t vec_file_size_in_byte = fs_->get_file_size(vec_file);
-
-  const size_t key_size_in_byte = sizeof(long long);
-  const size_t vec_size_in_byte = sizeof(float);
-
-  if (key_file_size_in_byte == 0) {
-    HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings key file is empty");
-  }
-  if (vec_file_size_in_byte == 0) {
-    HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings vector file is empty");
-  }
-  if (key_file_size_in_byte % key_size_in_byte != 0) {
-    HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings key file size is not correct");
-  }
-  if (vec_file_size_in_byte % vec_size_in_byte != 0) {
-    HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings vector file size is not correct");
+  const std::string mapped_file = emb_file_prefix + mapped_sparse_model_file_name;
+  mapped_model_.reset();
+  compressed_vectors_.reset();
+  if (IOUtils::is_local_path(path) && std::filesystem::exists(mapped_file) &&
+      !std::filesystem::exists(meta_file)) {
+    mapped_model_ = std::make_unique<MappedSparseModel>(mapped_file);
+    HCTR_LOG_S(DEBUG, WORLD) << "Mapped the sparse model " << mapped_file << std::endl;
   }
 
-  const size_t num_key = key_file_size_in_byte / key_size_in_byte;
-  embedding_table_->total_key_count = num_key;
+  size_t num_key = 0;
+  if (mapped_model_) {
+    num_key = mapped_model_->num_keys();
+    if (num_key == 0) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Error: mapped sparse model is empty");
+    }
+  } else {
+    const std::string found_vec_file = find_maybe_compressed_file(*fs_, vec_file);
+    if (get_file_compression_codec(found_vec_file) != CompressionCodec::None) {
+      compressed_vectors_ = std::make_unique<CompressedFileReader>(*fs_, found_vec_file);
+      HCTR_LOG_S(DEBUG, WORLD) << "Reading the compressed sparse model " << found_vec_file
+                               << std::endl;
+    }
+    const size_t key_file_size_in_byte = fs_->get_file_size(key_file);
+    const size_t vec_file_size_in_byte =
+        compressed_vectors_ ? compressed_vectors_->size() : fs_->get_file_size(vec_file);
 
-  if (std::filesystem::exists(meta_file)) {
-    const size_t meta_file_size_in_byte = fs_->get_file_size(meta_file);
-    if (meta_file_size_in_byte == 0) {
-      HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings meta file is empty");
+    const size_t key_size_in_byte = sizeof(long long);
+    const size_t vec_size_in_byte = sizeof(float);
+
+    if (key_file_size_in_byte == 0) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings key file is empty");
     }
-    if (meta_file_size_in_byte != key_file_size_in_byte) {
-      HCTR_OWN_THROW(Error_t::WrongInput,
-                     "Error: embeddings meta file size does not match embedding key file size");
+    if (vec_file_size_in_byte == 0) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings vector file is empty");
     }
-    if (threshold > 0) {
-      embedding_table_->threshold = threshold;
-    } else {
-      embedding_table_->meta.resize(num_key);
-      fs_->read(meta_file, embedding_table_->meta.data(), meta_file_size_in_byte, 0);
-      sort(embedding_table_->meta.begin(), embedding_table_->meta.end());
-      embedding_table_->threshold = embedding_table_->meta[num_key - key_num_per_iteration];
-      embedding_table_->cache_capacity = key_num_per_iteration;
-      std::vector<TKey>().swap(embedding_table_->meta);
+    if (key_file_size_in_byte % key_size_in_byte != 0) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings key file size is not correct");
+    }
+    if (vec_file_size_in_byte % vec_size_in_byte != 0) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings vector file size is not correct");
+    }
+
+    num_key = key_file_size_in_byte / key_size_in_byte;
+
+    if (std::filesystem::exists(meta_file)) {
+      const size_t meta_file_size_in_byte = fs_->get_file_size(meta_file);
+      if (meta_file_size_in_byte == 0) {
+        HCTR_OWN_THROW(Error_t::WrongInput, "Error: embeddings meta file is empty");
+      }
+      if (meta_file_size_in_byte != key_file_size_in_byte) {
+        HCTR_OWN_THROW(Error_t::WrongInput,
+                       "Error: embeddings meta file size does not match embedding key file size");
+      }
+      if (threshold > 0) {
+        embedding_table_->threshold = threshold;
+      } else {
+        embedding_table_->meta.resize(num_key);
+        fs_->read(meta_file, embedding_table_->meta.data(), meta_file_size_in_byte, 0);
+        sort(embedding_table_->meta.begin(), embedding_table_->meta.end());
+        embedding_table_->threshold = embedding_table_->meta[num_key - key_num_per_iteration];
+        embedding_table_->cache_capacity = key_num_per_iteration;
+        std::vector<TKey>().swap(embedding_table_->meta);
+      }
     }
   }
+  embedding_table_->total_key_count = num_key;
+
   // The default value for the number of iterations
   num_iterations = 10;
   if (key_num_per_iteration == 0) {
@@ -207,6 +250,43 @@ void RawModelLoader<TKey, TValue>::delete_table() {
   delete embedding_table_;
 }
 
+template <typename TKey, typename TValue>
+void RawModelLoader<TKey, TValue>::read_keys(TKey* const keys, const size_t offset,
+                                             const size_t num_keys) {
+  if (mapped_model_) {
+    const long long* const model_keys = mapped_model_->keys() + offset;
+    std::transform(model_keys, model_keys + num_keys, keys,
+                   [](long long key) { return static_cast<TKey>(key); });
+    return;
+  }
+  const std::string key_file = embedding_folder_path + "/" + "key";
+  if (std::is_same<TKey, long long>::value) {
+    fs_->read(key_file, keys, num_keys * sizeof(TKey), offset * sizeof(TKey));
+  } else {
+    std::vector<long long> i64_key_vec(num_keys, 0);
+    fs_->read(key_file, i64_key_vec.data(), num_keys * sizeof(long long),
+              offset * sizeof(long long));
+    std::transform(i64_key_vec.begin(), i64_key_vec.end(), keys,
+                   [](long long key) { return static_cast<unsigned>(key); });
+  }
+}
+
+template <typename TKey, typename TValue>
+void RawModelLoader<TKey, TValue>::read_vectors(TValue* const vectors, const size_t offset,
+                                                const size_t num_elements) {
+  if (mapped_model_) {
+    std::memcpy(vectors, mapped_model_->vectors() + offset, num_elements * sizeof(TValue));
+    return;
+  }
+  if (compressed_vectors_) {
+    compressed_vectors_->read(*fs_, vectors, num_elements * sizeof(TValue),
+                              offset * sizeof(TValue));
+    return;
+  }
+  const std::string vec_file = embedding_folder_path + "/" + "emb_vector";
+  fs_->read(vec_file, vectors, num_elements * sizeof(TValue), offset * sizeof(TValue));
+}
+
 template <typename TKey, typename TValue>
 void* RawModelLoader<TKey, TValue>::getkeys() {
   return embedding_table_->keys.data();
@@ -216,9 +296,6 @@ template <typename TKey, typename TValue>
 void RawModelLoader<TKey, TValue>::get_cache_uvm(size_t iteration, size_t emb_size,
                                                  size_t cache_capacity) {
   embedding_table_->cache_capacity = cache_capacity;
-  const std::string key_file = embedding_folder_path + "/" + "key";
-  const std::string vec_file = embedding_folder_path + "/" + "emb_vector";
-  const std::string meta_file = embedding_folder_path + "meta";
   if (iteration <= cache_capacity / key_iteration) {
     embedding_table_->keys.resize(key_iteration);
     size_t iteration_key_reading_amount = key_iteration;
@@ -230,21 +307,11 @@ void RawModelLoader<TKey, TValue>::get_cache_uvm(size_t iteration, size_t emb_si
     }
     embedding_table_->key_count = iteration_key_reading_amount;
     embedding_table_->uvm_key_count = 0;
-    if (std::is_same<TKey, long long>::value) {
-      fs_->read(key_file, embedding_table_->keys.data(),
-                iteration_key_reading_amount * sizeof(TKey),
-                iteration * key_iteration * sizeof(TKey));
-    } else {
-      std::vector<long long> i64_key_vec(iteration_key_reading_amount, 0);
-      fs_->read(key_file, i64_key_vec.data(), iteration_key_reading_amount * sizeof(long long),
-                iteration * key_iteration * sizeof(long long));
-      std::transform(i64_key_vec.begin(), i64_key_vec.end(), embedding_table_->keys.begin(),
-                     [](long long key) { return static_cast<unsigned>(key); });
-    }
+    read_keys(embedding_table_->keys.data(), iteration * key_iteration,
+              iteration_key_reading_amount);
     embedding_table_->vectors.resize(key_iteration * emb_size);
-    fs_->read(vec_file, embedding_table_->vectors.data(),
-              iteration_vec_reading_amount * sizeof(TValue),
-              key_iteration * emb_size * iteration * sizeof(TValue));
+    read_vectors(embedding_table_->vectors.data(), key_iteration * emb_size * iteration,
+                 iteration_vec_reading_amount);
   }
   if (iteration >= cache_capacity / key_iteration) {
     embedding_table_->keys.resize(key_iteration);
@@ -267,41 +334,30 @@ void RawModelLoader<TKey, TValue>::get_cache_uvm(size_t iteration, size_t emb_si
           embedding_table_->total_key_count * emb_size - iteration * key_iteration * emb_size;
     }
     embedding_table_->uvm_key_count = iteration_key_reading_amount;
-    if (std::is_same<TKey, long long>::value) {
-      fs_->read(key_file, embedding_table_->uvm_keys.data(),
-                iteration_key_reading_amount * sizeof(TKey), offset * sizeof(TKey));
-    } else {
-      std::vector<long long> i64_key_vec(iteration_key_reading_amount, 0);
-      fs_->read(key_file, i64_key_vec.data(), iteration_key_reading_amount * sizeof(long long),
-                offset * sizeof(long long));
-      std::transform(i64_key_vec.begin(), i64_key_vec.end(), embedding_table_->uvm_keys.begin(),
-                     [](long long key) { return static_cast<unsigned>(key); });
-    }
+    read_keys(embedding_table_->uvm_keys.data(), offset, iteration_key_reading_amount);
     embedding_table_->vectors.resize(key_iteration * emb_size);
-    fs_->read(vec_file, embedding_table_->uvm_vectors.data(),
-              iteration_vec_reading_amount * sizeof(TValue), offset * emb_size * sizeof(TValue));
+    read_vectors(embedding_table_->uvm_vectors.data(), offset * emb_size,
+                 iteration_vec_reading_amount);
   }
 }
 
 template <typename TKey, typename TValue>
 std::pair<void*, size_t> RawModelLoader<TKey, TValue>::getkeys(size_t iteration) {
-  const std::string key_file = embedding_folder_path + "/" + "key";
-  embedding_table_->keys.resize(key_iteration);
   size_t iteration_reading_amount = key_iteration;
   if ((iteration + 1) * key_iteration > embedding_table_->total_key_count) {
     iteration_reading_amount = embedding_table_->total_key_count - iteration * key_iteration;
   }
 
-  if (std::is_same<TKey, long long>::value) {
-    fs_->read(key_file, embedding_table_->keys.data(), iteration_reading_amount * sizeof(TKey),
-              iteration * key_iteration * sizeof(TKey));
-  } else {
-    std::vector<long long> i64_key_vec(iteration_reading_amount, 0);
-    fs_->read(key_file, i64_key_vec.data(), iteration_reading_amount * sizeof(long long),
-              iteration * key_iteration * sizeof(long long));
-    std::transform(i64_key_vec.begin(), i64_key_vec.end(), embedding_table_->keys.begin(),
-                   [](long long key) { return static_cast<unsigned>(key); });
+  // Full iterations are handed out of the mapping, since callers may read key_iteration keys.
+  if constexpr (std::is_same<TKey, long long>::value) {
+    if (mapped_model_ && iteration_reading_amount == key_iteration) {
+      return std::make_pair(
+          const_cast<long long*>(mapped_model_->keys()) + iteration * key_iteration,
+          iteration_reading_amount);
+    }
   }
+  embedding_table_->keys.resize(key_iteration);
+  read_keys(embedding_table_->keys.data(), iteration * key_iteration, iteration_reading_amount);
   return std::make_pair(embedding_table_->keys.data(), iteration_reading_amount);
 }
 
@@ -317,23 +373,99 @@ std::pair<void*, size_t> RawModelLoader<TKey, TValue>::getvectors(size_t iterati
                   key_iteration * emb_size * sizeof(__nv_fp8_e4m3), cudaHostAllocPortable);
     cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking);
   }
-  const std::string vec_file = embedding_folder_path + "/" + "emb_vector";
-  embedding_table_->vectors.resize(key_iteration * emb_size);
   size_t iteration_reading_amount = key_iteration * emb_size;
   if ((iteration + 1) * key_iteration * emb_size > embedding_table_->total_key_count * emb_size) {
     iteration_reading_amount =
         embedding_table_->total_key_count * emb_size - iteration * key_iteration * emb_size;
   }
-  fs_->read(vec_file, embedding_table_->vectors.data(), iteration_reading_amount * sizeof(TValue),
-            key_iteration * emb_size * iteration * sizeof(TValue));
+  const TValue* vectors = nullptr;
+  if (mapped_model_) {
+    HCTR_CHECK_HINT(mapped_model_->embedding_vec_size() == emb_size,
+                    "The mapped sparse model has embedding vectors of size ",
+                    mapped_model_->embedding_vec_size(), ", not ", emb_size, ".");
+  }
+  if (mapped_model_ && iteration_reading_amount == key_iteration * emb_size) {
+    vectors = mapped_model_->vectors() + key_iteration * emb_size * iteration;
+  } else {
+    embedding_table_->vectors.resize(key_iteration * emb_size);
+    read_vectors(embedding_table_->vectors.data(), key_iteration * emb_size * iteration,
+                 iteration_reading_amount);
+    vectors = embedding_table_->vectors.data();
+  }
   if (fp8_quant) {
-    cudaMemcpy(embedding_table_->d_vec_, embedding_table_->vectors.data(),
+    cudaMemcpy(embedding_table_->d_vec_, vectors,
                iteration_reading_amount * sizeof(float), cudaMemcpyHostToDevice);
     quantizer_->quantize(embedding_table_->d_vec_, embedding_table_->d_vec_quant,
                          embedding_table_->quant_scales_, key_iteration, emb_size, stream);
     return std::make_pair(embedding_table_->d_vec_quant, iteration_reading_amount);
   }
-  return std::make_pair(embedding_table_->vectors.data(), iteration_reading_amount);
+  return std::make_pair(const_cast<TValue*>(vectors), iteration_reading_amount);
+}
+
+template <typename TKey, typename TValue>
+std::vector<std::string> RawModelLoader<TKey, TValue>::dump_sst(const std::string& path,
+                                                                const size_t emb_size,
+                                                                const size_t num_threads) {
+  HCTR_CHECK(num_threads > 0);
+  const size_t value_size = emb_size * sizeof(TValue);
+
+  std::filesystem::create_directories(path);
+  std::vector<std::string> files;
+
+  // Each worker reads, sorts and writes one contiguous slice of the model file.
+  const auto write_file = [&](const std::string& file_path, const size_t offset,
+                              const size_t num_keys) {
+    std::vector<TKey> keys(num_keys);
+    read_keys(keys.data(), offset, num_keys);
+    std::vector<TValue> vectors(num_keys * emb_size);
+    read_vectors(vectors.data(), offset * emb_size, num_keys * emb_size);
+
+    // RocksDB orders keys by their binary representation. For duplicates, the last entry wins.
+    std::vector<size_t> order(num_keys);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b) {
+      return std::memcmp(&keys[a], &keys[b], sizeof(TKey)) < 0;
+    });
+
+    rocksdb::Options options;
+    rocksdb::EnvOptions env_options;
+    rocksdb::SstFileWriter file{env_options, options};
+    HCTR_ROCKSDB_CHECK(file.Open(file_path));
+    for (auto it = order.begin(); it != order.end(); ++it) {
+      if (it + 1 != order.end() && keys[*it] == keys[*(it + 1)]) {
+        continue;
+      }
+      HCTR_ROCKSDB_CHECK(file.Put({reinterpret_cast<const char*>(&keys[*it]), sizeof(TKey)},
+                                  {reinterpret_cast<const char*>(&vectors[*it * emb_size]),
+                                   value_size}));
+    }
+    HCTR_ROCKSDB_CHECK(file.Finish());
+  };
+
+  // Iterations bound the memory footprint, similar to `getkeys` and `getvectors`.
+  ThreadPool workers{"sst writer", num_threads};
+  for (size_t iteration = 0; iteration < num_iterations; iteration++) {
+    const size_t iteration_offset = iteration * key_iteration;
+    const size_t iteration_key_count =
+        std::min(key_iteration, embedding_table_->total_key_count - iteration_offset);
+    const size_t slice_size = (iteration_key_count + num_threads - 1) / num_threads;
+
+    std::vector<std::future<void>> tasks;
+    for (size_t offset = 0; offset < iteration_key_count; offset += slice_size) {
+      const std::string file_path =
+          (std::filesystem::path(path) / (std::to_string(files.size()) + ".sst")).string();
+      files.emplace_back(file_path);
+      tasks.emplace_back(workers.submit(
+          [&write_file, file_path, file_offset = iteration_offset + offset,
+           num_keys = std::min(slice_size, iteration_key_count - offset)]() {
+            write_file(file_path, file_offset, num_keys);
+          }));
+    }
+    for (auto& task : tasks) {
+      task.get();
+    }
+  }
+  return files;
 }
 
 template <typename TKey, typename TValue>
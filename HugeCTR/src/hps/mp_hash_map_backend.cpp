@@ -14,13 +14,17 @@
  * limitations under the License.
  */
 
+#include <sys/mman.h>
+
 #include <boost/interprocess/sync/scoped_lock.hpp>
 #include <boost/interprocess/sync/sharable_lock.hpp>
 #include <boost/utility/string_view.hpp>
+#include <cerrno>
 #include <core23/logger.hpp>
 #include <hps/hash_map_backend_detail.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/mp_hash_map_backend.hpp>
+#include <hps/mp_hash_map_backend_detail.hpp>
 #include <random>
 
 // TODO: Remove me!
@@ -73,6 +77,20 @@ MultiProcessHashMapBackend<Key>::MultiProcessHashMapBackend(
         << std::endl;
   }
 
+  // Shared memory (tmpfs) can only be backed by transparent huge pages (= 2 MiB pages).
+  if (params.huge_page_size) {
+    if (params.huge_page_size != 2L * 1024 * 1024) {
+      HCTR_LOG_S(WARNING, WORLD) << "Shared memory cannot be backed by huge pages of "
+                                 << params.huge_page_size
+                                 << " bytes. Will use transparent huge pages instead." << std::endl;
+    }
+    if (madvise(sm_segment_.get_address(), sm_segment_.get_size(), MADV_HUGEPAGE) != 0) {
+      HCTR_LOG_S(WARNING, WORLD)
+          << "Unable to enable transparent huge pages for shared memory (errno = " << errno
+          << "). Check `/sys/kernel/mm/transparent_hugepage/shmem_enabled`." << std::endl;
+    }
+  }
+
   // Start heart.
   heart_ = std::thread([&] {
     while (!heart_stop_signal_) {
@@ -89,6 +107,19 @@ bool MultiProcessHashMapBackend<Key>::is_process_connected_() const {
   return sm_->heart_beat != old_heart_beat;
 }
 
+template <typename Key>
+auto MultiProcessHashMapBackend<Key>::find_table_(const std::string& table_name) const
+    -> SharedVector<Partition>* {
+  // Same hash as `boost::hash<SharedString>`, but avoids materializing the key in shared memory.
+  const boost::string_view name{table_name};
+  const auto& tables_it{sm_->tables.find(
+      name, [](const boost::string_view& s) { return boost::hash_range(s.begin(), s.end()); },
+      [](const boost::string_view& a, const SharedString& b) {
+        return a == boost::string_view{b.data(), b.size()};
+      })};
+  return tables_it == sm_->tables.end() ? nullptr : &tables_it->second;
+}
+
 template <typename Key>
 MultiProcessHashMapBackend<Key>::~MultiProcessHashMapBackend() {
   HCTR_LOG_S(INFO, WORLD) << "Disconnecting from shared memory '"
@@ -212,17 +243,25 @@ size_t MultiProcessHashMapBackend<Key>::insert(const std::string& table_name,
   const boost::interprocess::scoped_lock lock(sm_->read_write_guard);
 
   // Locate the partitions, or create them, if they do not exist yet.
-  const auto& tables_it{
-      sm_->tables.try_emplace({table_name.c_str(), char_allocator_}, partition_allocator_).first};
-  SharedVector<Partition>& parts{tables_it->second};
-  if (parts.empty()) {
-    HCTR_CHECK(value_size > 0 && value_size <= this->params_.allocation_rate);
-
-    parts.reserve(this->params_.num_partitions);
-    while (parts.size() < this->params_.num_partitions) {
-      parts.emplace_back(value_size, this->params_, sm_segment_);
+  SharedVector<Partition>* parts_ptr{find_table_(table_name)};
+  if (!parts_ptr || parts_ptr->empty()) {
+    // Inserting into the table directory may rehash it. Hence, readers must retry.
+    const SequenceWriteGuard seq_guard{sm_->tables_seq};
+
+    const auto& tables_it{
+        sm_->tables.try_emplace({table_name.c_str(), char_allocator_}, partition_allocator_).first};
+    parts_ptr = &tables_it->second;
+    if (parts_ptr->empty()) {
+      HCTR_CHECK(value_size > 0 && value_size <= this->params_.allocation_rate);
+
+      const size_t overflow_margin{this->params_.table_overflow_margin(table_name)};
+      parts_ptr->reserve(this->params_.num_partitions);
+      while (parts_ptr->size() < this->params_.num_partitions) {
+        parts_ptr->emplace_back(value_size, this->params_, overflow_margin, sm_segment_);
+      }
     }
   }
+  SharedVector<Partition>& parts{*parts_ptr};
 
   const Key* const keys_end{&keys[num_pairs]};
   const size_t num_partitions{parts.size()};
@@ -240,6 +279,8 @@ size_t MultiProcessHashMapBackend<Key>::insert(const std::string& table_name,
 
     // Step through batch-by-batch.
     for (const Key* k{keys}; k != keys_end;) {
+      const SequenceWriteGuard seq_guard{part.seq};
+
       // Check overflow condition.
       if (part.entries.size() >= part.overflow_margin) {
         resolve_overflow_(table_name, part_index, part);
@@ -268,6 +309,8 @@ size_t MultiProcessHashMapBackend<Key>::insert(const std::string& table_name,
       // Step through batch-by-batch.
       size_t num_batches{0};
       for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        const SequenceWriteGuard seq_guard{part.seq};
+
         // Check overflow condition.
         if (part.entries.size() >= part.overflow_margin) {
           resolve_overflow_(table_name, part_index, part);
@@ -302,6 +345,11 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name, con
                                               const size_t value_stride,
                                               const DatabaseMissCallback& on_miss,
                                               const std::chrono::nanoseconds& time_budget) {
+  if (this->params_.short_read_locks) {
+    return fetch_with_short_locks_(table_name, num_keys, keys, values, value_stride, on_miss,
+                                   time_budget);
+  }
+
   const auto begin{std::chrono::high_resolution_clock::now()};
   const boost::interprocess::sharable_lock lock(sm_->read_write_guard);
 
@@ -388,6 +436,11 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name,
                                               const size_t value_stride,
                                               const DatabaseMissCallback& on_miss,
                                               const std::chrono::nanoseconds& time_budget) {
+  if (this->params_.short_read_locks) {
+    return fetch_with_short_locks_(table_name, num_indices, indices, keys, values, value_stride,
+                                   on_miss, time_budget);
+  }
+
   const auto begin{std::chrono::high_resolution_clock::now()};
   const boost::interprocess::sharable_lock lock(sm_->read_write_guard);
 
@@ -468,6 +521,193 @@ size_t MultiProcessHashMapBackend<Key>::fetch(const std::string& table_name,
   return hit_count;
 }
 
+template <typename Key>
+size_t MultiProcessHashMapBackend<Key>::fetch_with_short_locks_(
+    const std::string& table_name, const size_t num_keys, const Key* const keys,
+    char* const values, const size_t value_stride, const DatabaseMissCallback& on_miss,
+    const std::chrono::nanoseconds& time_budget) {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+
+  // Locate the partitions. They stay in place until the table is dropped.
+  uint64_t tables_seq;
+  std::vector<const Partition*> parts;
+  const SharedVector<Partition>* parts_ptr;
+  {
+    const boost::interprocess::sharable_lock lock(sm_->read_write_guard);
+    tables_seq = sm_->tables_seq.begin_read();
+    parts_ptr = find_table_(table_name);
+    if (parts_ptr) {
+      for (const Partition& part : *parts_ptr) {
+        HCTR_CHECK(part.value_size <= value_stride);
+        parts.emplace_back(&part);
+      }
+    }
+  }
+  if (!parts_ptr) {
+    return Base::fetch(table_name, num_keys, keys, values, value_stride, on_miss, time_budget);
+  }
+
+  const Key* const keys_end{&keys[num_keys]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  size_t miss_count{0};
+  size_t skip_count{0};
+
+  if (num_keys == 0) {
+    // Do nothing ;-).
+  } else if (num_keys == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    const Partition& part{*parts[part_index]};
+
+    // Step through input batch-by-batch.
+    std::chrono::nanoseconds elapsed;
+    for (const Key* k{keys}; k != keys_end;) {
+      HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_DIRECT, on_miss);
+      HCTR_HPS_MP_HASH_MAP_CHECK_TABLES_(SEQUENTIAL_DIRECT, on_miss);
+
+      const size_t prev_miss_count{miss_count};
+      const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+      HCTR_HPS_MP_HASH_MAP_FETCH_(SEQUENTIAL_DIRECT, k);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (k - keys - 1) / max_batch_size, ": ",
+                 batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                 " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+    }
+  } else {
+    std::atomic<size_t> joint_miss_count{0};
+    std::atomic<size_t> joint_skip_count{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      const Partition& part{*parts[part_index]};
+
+      size_t miss_count{0};
+
+      // Step through input batch-by-batch.
+      std::chrono::nanoseconds elapsed;
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_DIRECT, on_miss);
+        HCTR_HPS_MP_HASH_MAP_CHECK_TABLES_(PARALLEL_DIRECT, on_miss);
+
+        const size_t prev_miss_count{miss_count};
+        size_t batch_size{0};
+        HCTR_HPS_MP_HASH_MAP_FETCH_(PARALLEL_DIRECT, k);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
+                   batch_size, " hits. Time: ", elapsed.count(), " / ", time_budget.count(),
+                   " ns.\n");
+      }
+
+      joint_miss_count += miss_count;
+    });
+
+    miss_count += joint_miss_count;
+    skip_count += joint_skip_count;
+  }
+
+  const size_t hit_count{num_keys - skip_count - miss_count};
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": ", hit_count, " / ",
+             num_keys - skip_count, " hits; skipped ", skip_count, " keys.\n");
+  return hit_count;
+}
+
+template <typename Key>
+size_t MultiProcessHashMapBackend<Key>::fetch_with_short_locks_(
+    const std::string& table_name, const size_t num_indices, const size_t* const indices,
+    const Key* const keys, char* const values, const size_t value_stride,
+    const DatabaseMissCallback& on_miss, const std::chrono::nanoseconds& time_budget) {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+
+  // Locate the partitions. They stay in place until the table is dropped.
+  uint64_t tables_seq;
+  std::vector<const Partition*> parts;
+  const SharedVector<Partition>* parts_ptr;
+  {
+    const boost::interprocess::sharable_lock lock(sm_->read_write_guard);
+    tables_seq = sm_->tables_seq.begin_read();
+    parts_ptr = find_table_(table_name);
+    if (parts_ptr) {
+      for (const Partition& part : *parts_ptr) {
+        HCTR_CHECK(part.value_size <= value_stride);
+        parts.emplace_back(&part);
+      }
+    }
+  }
+  if (!parts_ptr) {
+    return Base::fetch(table_name, num_indices, indices, keys, values, value_stride, on_miss,
+                       time_budget);
+  }
+
+  const size_t* const indices_end{&indices[num_indices]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  size_t miss_count{0};
+  size_t skip_count{0};
+
+  if (num_indices == 0) {
+    // Do nothing ;-).
+  } else if (num_indices == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    const Partition& part{*parts[part_index]};
+
+    // Step through input batch-by-batch.
+    std::chrono::nanoseconds elapsed;
+    for (const size_t* i{indices}; i != indices_end;) {
+      HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_INDIRECT, on_miss);
+      HCTR_HPS_MP_HASH_MAP_CHECK_TABLES_(SEQUENTIAL_INDIRECT, on_miss);
+
+      const size_t prev_miss_count{miss_count};
+      const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
+      HCTR_HPS_MP_HASH_MAP_FETCH_(SEQUENTIAL_INDIRECT, i);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (i - indices - 1) / max_batch_size, ": ",
+                 batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                 " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+    }
+  } else {
+    std::atomic<size_t> joint_miss_count{0};
+    std::atomic<size_t> joint_skip_count{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      const Partition& part{*parts[part_index]};
+
+      size_t miss_count{0};
+
+      // Step through input batch-by-batch.
+      std::chrono::nanoseconds elapsed;
+      size_t num_batches{0};
+      for (const size_t* i{indices}; i != indices_end; ++num_batches) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_INDIRECT, on_miss);
+        HCTR_HPS_MP_HASH_MAP_CHECK_TABLES_(PARALLEL_INDIRECT, on_miss);
+
+        const size_t prev_miss_count{miss_count};
+        size_t batch_size{0};
+        HCTR_HPS_MP_HASH_MAP_FETCH_(PARALLEL_INDIRECT, i);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
+                   batch_size, " hits. Time: ", elapsed.count(), " / ", time_budget.count(),
+                   " ns.\n");
+      }
+
+      joint_miss_count += miss_count;
+    });
+
+    miss_count += joint_miss_count;
+    skip_count += joint_skip_count;
+  }
+
+  const size_t hit_count{num_indices - skip_count - miss_count};
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": ", hit_count, " / ",
+             num_indices - skip_count, " hits; skipped ", skip_count, " keys.\n");
+  return hit_count;
+}
+
 template <typename Key>
 size_t MultiProcessHashMapBackend<Key>::evict(const std::string& table_name) {
   const boost::interprocess::scoped_lock lock(sm_->read_write_guard);
@@ -484,6 +724,7 @@ size_t MultiProcessHashMapBackend<Key>::evict(const std::string& table_name) {
   for (const Partition& part : parts) {
     num_deletions += part.entries.size();
   }
+  const SequenceWriteGuard seq_guard{sm_->tables_seq};
   sm_->tables.erase(tables_it);
 
   HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
@@ -517,6 +758,8 @@ size_t MultiProcessHashMapBackend<Key>::evict(const std::string& table_name, con
 
     // Step through input batch-by-batch.
     for (const Key* k{keys}; k != keys_end;) {
+      const SequenceWriteGuard seq_guard{part.seq};
+
       const size_t prev_num_deletions{num_deletions};
       const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
       HCTR_HPS_HASH_MAP_EVICT_(SEQUENTIAL_DIRECT);
@@ -536,6 +779,8 @@ size_t MultiProcessHashMapBackend<Key>::evict(const std::string& table_name, con
       // Step through input batch-by-batch.
       size_t num_batches{0};
       for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        const SequenceWriteGuard seq_guard{part.seq};
+
         const size_t prev_num_deletions{num_deletions};
         size_t batch_size{0};
         HCTR_HPS_HASH_MAP_EVICT_(PARALLEL_DIRECT);
@@ -642,6 +887,25 @@ size_t MultiProcessHashMapBackend<Key>::dump_sst(const std::string& table_name,
   return entries.size();
 }
 
+template <typename Key>
+void MultiProcessHashMapBackend<Key>::allocate_value_page_(Partition& part) {
+  const size_t stride{(part.value_size + value_page_alignment - 1) / value_page_alignment *
+                      value_page_alignment};
+  const size_t num_values{part.allocation_rate / stride};
+  HCTR_CHECK(num_values > 0);
+
+  // Get more memory.
+  part.value_pages.emplace_back(num_values * stride, char_allocator_);
+  ValuePage& value_page{part.value_pages.back()};
+
+  // Stock up slot references.
+  part.value_slots.reserve(part.value_slots.size() + num_values);
+  for (auto it{value_page.end()}; it != value_page.begin();) {
+    it -= stride;
+    part.value_slots.emplace_back(&*it);
+  }
+}
+
 template <typename Key>
 size_t MultiProcessHashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
                                                           const size_t part_index,
@@ -680,7 +944,7 @@ size_t MultiProcessHashMapBackend<Key>::resolve_overflow_(const std::string& tab
           const Key* const k{&*k_it};
           HCTR_HPS_HASH_MAP_EVICT_K_();
         }
-        if (part.entries.size() <= this->overflow_resolution_margin_) {
+        if (part.entries.size() <= part.overflow_resolution_margin) {
           break;
         }
       }
@@ -711,7 +975,7 @@ size_t MultiProcessHashMapBackend<Key>::resolve_overflow_(const std::string& tab
           const Key* const k{&km_it->first};
           HCTR_HPS_HASH_MAP_EVICT_K_();
         }
-        if (part.entries.size() <= this->overflow_resolution_margin_) {
+        if (part.entries.size() <= part.overflow_resolution_margin) {
           break;
         }
       }
@@ -760,11 +1024,37 @@ size_t MultiProcessHashMapBackend<Key>::resolve_overflow_(const std::string& tab
           const Key* const k{&km_it->first};
           HCTR_HPS_HASH_MAP_EVICT_K_();
         }
-        if (part.entries.size() <= this->overflow_resolution_margin_) {
+        if (part.entries.size() <= part.overflow_resolution_margin) {
           break;
         }
       }
     } break;
+
+    case DatabaseOverflowPolicy_t::EvictClock: {
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 " is overflowing (size = ", part.entries.size(), " > ", part.overflow_margin,
+                 "): Sweeping CLOCK to evict ",
+                 part.entries.size() - part.overflow_resolution_margin, " key/value pairs!\n");
+
+      // Entries are sorted. So, after an erasure, the hand already points to the next entry.
+      while (part.entries.size() > part.overflow_resolution_margin) {
+        if (part.clock_hand >= part.entries.size()) {
+          part.clock_hand = 0;
+        }
+
+        const auto& it{part.entries.nth(part.clock_hand)};
+        Payload& payload{it->second};
+        if (payload.access_count) {
+          // Referenced since last pass. Give the entry another chance.
+          --payload.access_count;
+          ++part.clock_hand;
+        } else {
+          part.value_slots.emplace_back(payload.value);
+          part.entries.erase(it);
+          ++num_deletions;
+        }
+      }
+    } break;
   }
 
   return num_deletions;
@@ -45,4 +45,15 @@ void Facade::forward(const char* model_name, int32_t table_id, int32_t global_re
                            emb_vec_size, d_keys, d_vectors, i64_input_tensor, context_stream);
 }
 
+void Facade::forward(const char* model_name, int32_t global_replica_id,
+                     const std::vector<size_t>& num_keys_per_table,
+                     const std::vector<size_t>& emb_vec_size_per_table,
+                     const std::vector<const void*>& d_keys_per_table,
+                     const std::vector<void*>& d_vectors_per_table, bool i64_input_tensor,
+                     cudaStream_t context_stream) {
+  lookup_manager_->forward(std::string(model_name), global_replica_id, num_keys_per_table,
+                           emb_vec_size_per_table, d_keys_per_table, d_vectors_per_table,
+                           i64_input_tensor, context_stream);
+}
+
 }  // namespace HierarchicalParameterServer
\ No newline at end of file
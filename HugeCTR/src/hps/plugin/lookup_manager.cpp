@@ -23,11 +23,12 @@ std::shared_ptr<LookupManager> LookupManager::Create() {
   return std::shared_ptr<LookupManager>(new LookupManager());
 }
 
-LookupManager::LookupManager() : initialized_{false} {}
+LookupManager::LookupManager() : initialized_{false}, plugin_type_{TENSORFLOW} {}
 
 void LookupManager::init(parameter_server_config& ps_config, pluginType_t plugin_type,
                          int32_t global_batch_size, int32_t num_replicas_in_sync) {
   initialized_ = true;
+  plugin_type_ = plugin_type;
   auto b2s = [](const char val) { return val ? "True" : "False"; };
   for (auto& inference_params : ps_config.inference_params_array) {
     HCTR_LOG_S(INFO, WORLD) << "HPS plugin uses context stream for model "
@@ -40,8 +41,9 @@ void LookupManager::init(parameter_server_config& ps_config, pluginType_t plugin
     return;
   }
 
-  // Create the HPS for all models on all the deployed devices
-  parameter_server_ = HierParameterServerBase::create(ps_config);
+  // Create the HPS for all models on all the deployed devices, or share the one of this process
+  // that already serves them, e.g., for another plugin type
+  parameter_server_ = HierParameterServerBase::get_or_create(ps_config);
 
   // Initialie the resources for each model
   for (auto& inference_params : ps_config.inference_params_array) {
@@ -69,6 +71,12 @@ void LookupManager::forward(const std::string& model_name, int32_t table_id,
   auto lookup_session =
       lookup_session_map_.find(model_name)->second.find(global_replica_id)->second;
   auto inference_params = lookup_session->get_inference_params();
+  if (plugin_type_ == TENSORRT && inference_params.fuse_embedding_table) {
+    // The fused tables are looked up together, which TensorRT only does for all tables at once.
+    HCTR_LOG_S(ERROR, WORLD) << "fuse_embedding_table requires the multi-table HPS TensorRT plugin."
+                             << std::endl;
+    return;
+  }
   if (inference_params.use_context_stream) {
     lookup_session->lookup_from_device(values_ptr, reinterpret_cast<float*>(emb_vector_ptr),
                                        num_keys, table_id, context_stream);
@@ -79,6 +87,37 @@ void LookupManager::forward(const std::string& model_name, int32_t table_id,
   }
 }
 
+void LookupManager::forward(const std::string& model_name, int32_t global_replica_id,
+                            const std::vector<size_t>& num_keys_per_table,
+                            const std::vector<size_t>& emb_vec_size_per_table,
+                            const std::vector<const void*>& values_ptr_per_table,
+                            const std::vector<void*>& emb_vector_ptr_per_table,
+                            bool i64_input_tensor, cudaStream_t context_stream) {
+  const size_t num_tables{num_keys_per_table.size()};
+  if (emb_vec_size_per_table.size() != num_tables || values_ptr_per_table.size() != num_tables ||
+      emb_vector_ptr_per_table.size() != num_tables) {
+    HCTR_LOG_S(ERROR, WORLD) << "The number of keys, embedding vector sizes, inputs and outputs "
+                                "should be given for every table"
+                             << std::endl;
+    return;
+  }
+  std::vector<float*> d_vectors_per_table(num_tables);
+  for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+    if (!forward_check(model_name, table_id, global_replica_id, num_keys_per_table[table_id],
+                       emb_vec_size_per_table[table_id], i64_input_tensor)) {
+      return;
+    }
+    d_vectors_per_table[table_id] = reinterpret_cast<float*>(emb_vector_ptr_per_table[table_id]);
+  }
+  auto lookup_session =
+      lookup_session_map_.find(model_name)->second.find(global_replica_id)->second;
+
+  // The multi-table lookup runs on the streams of the session, and waits for all of them.
+  HCTR_LIB_THROW(cudaStreamSynchronize(context_stream));
+  lookup_session->lookup_from_device(values_ptr_per_table, d_vectors_per_table,
+                                     num_keys_per_table);
+}
+
 bool LookupManager::init_check(parameter_server_config& ps_config, int32_t global_batch_size,
                                const int32_t num_replicas_in_sync, pluginType_t plugin_type) const {
   switch (plugin_type) {
@@ -135,11 +174,6 @@ bool LookupManager::init_check(parameter_server_config& ps_config, int32_t globa
               << "i64_input_key must be false for HPS TensorRT plugin." << std::endl;
           return false;
         }
-        if (inference_params.fuse_embedding_table) {
-          HCTR_LOG_S(ERROR, WORLD)
-              << "fuse_embedding_table must be false for HPS TensorRT plugin." << std::endl;
-          return false;
-        }
       }
       break;
     }
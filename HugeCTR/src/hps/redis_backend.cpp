@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <core23/logger.hpp>
 #include <hps/database_backend_detail.hpp>
@@ -74,6 +75,10 @@ RedisClusterBackend<Key>::RedisClusterBackend(const RedisClusterBackendParams& p
     : Base(params) {
   HCTR_CHECK(params.num_node_connections > 0);
   HCTR_CHECK(params.num_partitions >= params.num_node_connections);
+  HCTR_CHECK(params.num_pipelined_batches > 0);
+  HCTR_CHECK_HINT(params.overflow_policy != DatabaseOverflowPolicy_t::EvictClock,
+                  "The ", hctr_enum_to_c_str(params.overflow_policy),
+                  " overflow policy is not supported by the ", get_name(), ".");
 
   // Put together cluster configuration.
   sw::redis::ConnectionOptions options;
@@ -116,6 +121,21 @@ RedisClusterBackend<Key>::RedisClusterBackend(const RedisClusterBackendParams& p
   HCTR_LOG_C(INFO, WORLD, get_name(), ": Connecting via ", options.host, ':', options.port,
              "...\n");
   redis_ = std::make_unique<sw::redis::RedisCluster>(options, pool_options);
+
+  if (params.near_cache_size > 0) {
+    // A slab per partition and table, which evicts the least used keys once it is full.
+    const size_t part_size{(params.near_cache_size + params.num_partitions - 1) /
+                           params.num_partitions};
+    SlabHashMapBackendParams near_cache_params;
+    near_cache_params.max_batch_size = params.max_batch_size;
+    near_cache_params.num_partitions = params.num_partitions;
+    near_cache_params.overflow_margin = part_size;
+    near_cache_params.overflow_policy = DatabaseOverflowPolicy_t::EvictLeastUsed;
+    near_cache_params.overflow_resolution_target = params.overflow_resolution_target;
+    near_cache_ = std::make_unique<SlabHashMapBackend<Key>>(near_cache_params);
+    HCTR_LOG_C(INFO, WORLD, get_name(), ": Near-cache of up to ", part_size * params.num_partitions,
+               " entries per table enabled.\n");
+  }
 }
 
 template <typename Key>
@@ -233,6 +253,11 @@ size_t RedisClusterBackend<Key>::insert(const std::string& table_name, const siz
   const Key* const keys_end{&keys[num_pairs]};
   const size_t max_batch_size{this->params_.max_batch_size};
   const size_t num_partitions{this->params_.num_partitions};
+  const size_t overflow_margin{this->params_.table_overflow_margin(table_name)};
+  const size_t encoded_value_size{db_encoded_value_size(this->params_.value_encoding, value_size)};
+  const size_t v_buffer_size{this->params_.value_encoding == DatabaseValueEncoding_t::Raw
+                                 ? 0
+                                 : std::min(num_pairs, max_batch_size) * encoded_value_size};
 
   size_t num_inserts{0};
 
@@ -249,6 +274,7 @@ size_t RedisClusterBackend<Key>::insert(const std::string& table_name, const siz
       std::vector<std::pair<sw::redis::StringView, sw::redis::StringView>> km_views;
       kv_views.reserve(std::min(num_pairs, max_batch_size));
       km_views.reserve(std::min(num_pairs, max_batch_size));
+      std::vector<char> v_buffer(v_buffer_size);
 
       for (const Key* k{keys}; k != keys_end;) {
         const size_t prev_num_inserts{num_inserts};
@@ -264,7 +290,7 @@ size_t RedisClusterBackend<Key>::insert(const std::string& table_name, const siz
                    batch_size - num_inserts + prev_num_inserts, " = ", batch_size, " entries.\n");
 
         // Handle overflow situations.
-        if (part_size > this->params_.overflow_margin) {
+        if (part_size > overflow_margin) {
           resolve_overflow_(table_name, part_index, part_size);
         }
       }
@@ -283,6 +309,7 @@ size_t RedisClusterBackend<Key>::insert(const std::string& table_name, const siz
         std::vector<std::pair<sw::redis::StringView, sw::redis::StringView>> km_views;
         kv_views.reserve(std::min(num_pairs / num_partitions, max_batch_size));
         km_views.reserve(std::min(num_pairs / num_partitions, max_batch_size));
+        std::vector<char> v_buffer(v_buffer_size);
 
         size_t num_batches{0};
         for (const Key* k{keys}; k != keys_end; ++num_batches) {
@@ -299,7 +326,7 @@ size_t RedisClusterBackend<Key>::insert(const std::string& table_name, const siz
                      kv_views.size(), " entries.\n");
 
           // Handle overflow situations.
-          if (part_size > this->params_.overflow_margin) {
+          if (part_size > overflow_margin) {
             resolve_overflow_(table_name, part_index, part_size);
           }
         }
@@ -313,20 +340,27 @@ size_t RedisClusterBackend<Key>::insert(const std::string& table_name, const siz
 
   HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Inserted ", num_inserts,
              " + updated ", num_pairs - num_inserts, " = ", num_pairs, " entries.\n");
+
+  // The near-cache admits the new values on their next fetch.
+  if (near_cache_ && num_pairs > 0) {
+    near_cache_->evict(table_name, num_pairs, keys);
+  }
   return num_inserts;
 }
 
 template <typename Key>
-size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
-                                       const Key* const keys, char* const values,
-                                       const size_t value_stride,
-                                       const DatabaseMissCallback& on_miss,
-                                       const std::chrono::nanoseconds& time_budget) {
+size_t RedisClusterBackend<Key>::fetch_remote_(const std::string& table_name,
+                                               const size_t num_keys, const Key* const keys,
+                                               char* const values,
+                                               const size_t value_stride,
+                                               const DatabaseMissCallback& on_miss,
+                                               const std::chrono::nanoseconds& time_budget) {
   const auto begin{std::chrono::high_resolution_clock::now()};
 
   const Key* const keys_end{&keys[num_keys]};
   const size_t max_batch_size{this->params_.max_batch_size};
   const size_t num_partitions{this->params_.num_partitions};
+  const size_t num_pipelined_batches{this->params_.num_pipelined_batches};
 
   size_t miss_count{0};
   size_t skip_count{0};
@@ -340,25 +374,32 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
       HCTR_DEFINE_REDIS_VALUE_HKEY_();
 
       std::shared_ptr<std::vector<Key>> touched_keys;
-      HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS();
       std::vector<sw::redis::StringView> k_views;
-      k_views.reserve(std::min(num_keys, max_batch_size));
+      k_views.reserve(std::min(num_keys, max_batch_size * num_pipelined_batches));
+      std::vector<size_t> k_views_offsets;
+      k_views_offsets.reserve(num_pipelined_batches);
 
-      // Step through input batch-by-batch.
+      // Step through input batch-by-batch, and pipeline multiple batches per round trip.
       std::chrono::nanoseconds elapsed;
+      size_t num_batches{0};
       for (const Key* k{keys}; k != keys_end;) {
         HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_DIRECT, on_miss);
 
         const size_t prev_miss_count{miss_count};
-        const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
-        if (!HCTR_HPS_REDIS_FETCH_(SEQUENTIAL_DIRECT)) {
-          break;
-        }
+        sw::redis::Pipeline pipe{redis_->pipeline(hkey_v, false)};
+        k_views.clear();
+        k_views_offsets.clear();
+        do {
+          const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+          HCTR_HPS_REDIS_FETCH_QUEUE_(SEQUENTIAL_DIRECT);
+        } while (k != keys_end && k_views_offsets.size() < num_pipelined_batches);
+        HCTR_HPS_REDIS_FETCH_EXEC_();
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                   ", batch ", (k - keys - 1) / max_batch_size, ": ",
-                   batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                   ", batches ", num_batches, '-', num_batches + k_views_offsets.size() - 1, ": ",
+                   k_views.size() - miss_count + prev_miss_count, " / ", k_views.size(),
                    " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+        num_batches += k_views_offsets.size();
 
         // Refresh metadata if required.
         if (touched_keys && !touched_keys->empty()) {
@@ -377,26 +418,38 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
         HCTR_DEFINE_REDIS_VALUE_HKEY_();
 
         std::shared_ptr<std::vector<Key>> touched_keys;
-        HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS();
         std::vector<sw::redis::StringView> k_views;
-        k_views.reserve(std::min(num_keys / num_partitions, max_batch_size));
+        k_views.reserve(
+            std::min(num_keys / num_partitions, max_batch_size * num_pipelined_batches));
+        std::vector<size_t> k_views_offsets;
+        k_views_offsets.reserve(num_pipelined_batches);
 
-        // Step through input batch-by-batch.
+        // Step through input batch-by-batch, and pipeline multiple batches per round trip.
         std::chrono::nanoseconds elapsed;
         size_t num_batches{0};
-        for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        for (const Key* k{keys}; k != keys_end;) {
           HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_DIRECT, on_miss);
 
           const size_t prev_miss_count{miss_count};
-          size_t batch_size{0};
-          if (!HCTR_HPS_REDIS_FETCH_(PARALLEL_DIRECT)) {
+          sw::redis::Pipeline pipe{redis_->pipeline(hkey_v, false)};
+          k_views.clear();
+          k_views_offsets.clear();
+          while (k != keys_end && k_views_offsets.size() < num_pipelined_batches) {
+            size_t batch_size{0};
+            if (!HCTR_HPS_REDIS_FETCH_QUEUE_(PARALLEL_DIRECT)) {
+              break;
+            }
+          }
+          if (k_views_offsets.empty()) {
             break;
           }
+          HCTR_HPS_REDIS_FETCH_EXEC_();
 
           HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                     ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count,
-                     " / ", batch_size, " hits. Time: ", elapsed.count(), " / ",
-                     time_budget.count(), " ns.\n");
+                     ", batches ", num_batches, '-', num_batches + k_views_offsets.size() - 1,
+                     ": ", k_views.size() - miss_count + prev_miss_count, " / ", k_views.size(),
+                     " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+          num_batches += k_views_offsets.size();
         }
 
         // Refresh metadata if required.
@@ -419,16 +472,18 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
 }
 
 template <typename Key>
-size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
-                                       const size_t* const indices, const Key* const keys,
-                                       char* const values, const size_t value_stride,
-                                       const DatabaseMissCallback& on_miss,
-                                       const std::chrono::nanoseconds& time_budget) {
+size_t RedisClusterBackend<Key>::fetch_remote_(const std::string& table_name,
+                                               const size_t num_indices,
+                                               const size_t* const indices, const Key* const keys,
+                                               char* const values, const size_t value_stride,
+                                               const DatabaseMissCallback& on_miss,
+                                               const std::chrono::nanoseconds& time_budget) {
   const auto begin{std::chrono::high_resolution_clock::now()};
 
   const size_t* const indices_end{&indices[num_indices]};
   const size_t max_batch_size{this->params_.max_batch_size};
   const size_t num_partitions{this->params_.num_partitions};
+  const size_t num_pipelined_batches{this->params_.num_pipelined_batches};
 
   size_t miss_count{0};
   size_t skip_count{0};
@@ -442,25 +497,32 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
       HCTR_DEFINE_REDIS_VALUE_HKEY_();
 
       std::shared_ptr<std::vector<Key>> touched_keys;
-      HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS();
       std::vector<sw::redis::StringView> k_views;
-      k_views.reserve(std::min(num_indices, max_batch_size));
+      k_views.reserve(std::min(num_indices, max_batch_size * num_pipelined_batches));
+      std::vector<size_t> k_views_offsets;
+      k_views_offsets.reserve(num_pipelined_batches);
 
-      // Step through input batch-by-batch.
+      // Step through input batch-by-batch, and pipeline multiple batches per round trip.
       std::chrono::nanoseconds elapsed;
+      size_t num_batches{0};
       for (const size_t* i{indices}; i != indices_end;) {
         HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_INDIRECT, on_miss);
 
         const size_t prev_miss_count{miss_count};
-        const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
-        if (!HCTR_HPS_REDIS_FETCH_(SEQUENTIAL_INDIRECT)) {
-          break;
-        }
+        sw::redis::Pipeline pipe{redis_->pipeline(hkey_v, false)};
+        k_views.clear();
+        k_views_offsets.clear();
+        do {
+          const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
+          HCTR_HPS_REDIS_FETCH_QUEUE_(SEQUENTIAL_INDIRECT);
+        } while (i != indices_end && k_views_offsets.size() < num_pipelined_batches);
+        HCTR_HPS_REDIS_FETCH_EXEC_();
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                   ", batch ", (i - indices - 1) / max_batch_size, ": ",
-                   batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                   ", batches ", num_batches, '-', num_batches + k_views_offsets.size() - 1, ": ",
+                   k_views.size() - miss_count + prev_miss_count, " / ", k_views.size(),
                    " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+        num_batches += k_views_offsets.size();
       }
 
       // Refresh metadata if required.
@@ -479,27 +541,39 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
         HCTR_DEFINE_REDIS_VALUE_HKEY_();
 
         std::shared_ptr<std::vector<Key>> touched_keys;
-        HCTR_HPS_REDIS_FETCH_DEFINE_V_VIEWS();
         std::vector<sw::redis::StringView> k_views;
-        k_views.reserve(std::min(num_indices / num_partitions, max_batch_size));
+        k_views.reserve(
+            std::min(num_indices / num_partitions, max_batch_size * num_pipelined_batches));
+        std::vector<size_t> k_views_offsets;
+        k_views_offsets.reserve(num_pipelined_batches);
 
-        // Step through input batch-by-batch.
+        // Step through input batch-by-batch, and pipeline multiple batches per round trip.
         std::chrono::nanoseconds elapsed;
         size_t num_batches{0};
-        for (const size_t* i{indices}; i != indices_end; ++num_batches) {
+        for (const size_t* i{indices}; i != indices_end;) {
           HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_INDIRECT, on_miss);
 
           // Assemble query.
           const size_t prev_miss_count{miss_count};
-          size_t batch_size{0};
-          if (!HCTR_HPS_REDIS_FETCH_(PARALLEL_INDIRECT)) {
+          sw::redis::Pipeline pipe{redis_->pipeline(hkey_v, false)};
+          k_views.clear();
+          k_views_offsets.clear();
+          while (i != indices_end && k_views_offsets.size() < num_pipelined_batches) {
+            size_t batch_size{0};
+            if (!HCTR_HPS_REDIS_FETCH_QUEUE_(PARALLEL_INDIRECT)) {
+              break;
+            }
+          }
+          if (k_views_offsets.empty()) {
             break;
           }
+          HCTR_HPS_REDIS_FETCH_EXEC_();
 
           HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                     ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count,
-                     " / ", batch_size, " hits. Time: ", elapsed.count(), " / ",
-                     time_budget.count(), " ns.\n");
+                     ", batches ", num_batches, '-', num_batches + k_views_offsets.size() - 1,
+                     ": ", k_views.size() - miss_count + prev_miss_count, " / ", k_views.size(),
+                     " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+          num_batches += k_views_offsets.size();
         }
 
         // Refresh metadata if required.
@@ -521,6 +595,110 @@ size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size
   return hit_count;
 }
 
+template <typename Key>
+size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                       const Key* const keys, char* const values,
+                                       const size_t value_stride,
+                                       const DatabaseMissCallback& on_miss,
+                                       const std::chrono::nanoseconds& time_budget) {
+  if (!near_cache_) {
+    return fetch_remote_(table_name, num_keys, keys, values, value_stride, on_miss, time_budget);
+  }
+  return fetch_through_near_cache_(table_name, num_keys, nullptr, keys, values, value_stride,
+                                   on_miss, time_budget);
+}
+
+template <typename Key>
+size_t RedisClusterBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                       const size_t* const indices, const Key* const keys,
+                                       char* const values, const size_t value_stride,
+                                       const DatabaseMissCallback& on_miss,
+                                       const std::chrono::nanoseconds& time_budget) {
+  if (!near_cache_) {
+    return fetch_remote_(table_name, num_indices, indices, keys, values, value_stride, on_miss,
+                         time_budget);
+  }
+  return fetch_through_near_cache_(table_name, num_indices, indices, keys, values, value_stride,
+                                   on_miss, time_budget);
+}
+
+template <typename Key>
+size_t RedisClusterBackend<Key>::fetch_through_near_cache_(
+    const std::string& table_name, const size_t num_indices, const size_t* const indices,
+    const Key* const keys, char* const values, const size_t value_stride,
+    const DatabaseMissCallback& on_miss, const std::chrono::nanoseconds& time_budget) {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  if (num_indices == 0) {
+    return 0;
+  }
+
+  // State of each key: 0 = near-cache hit, 1 = near-cache miss, 2 = Redis miss. Each key is only
+  // reported once, so that the miss callbacks of parallel partitions can write without locking.
+  const size_t num_keys{indices ? *std::max_element(indices, &indices[num_indices]) + 1
+                                : num_indices};
+  std::vector<char> states(num_keys, 0);
+  const auto index_at = [&](const size_t i) -> size_t { return indices ? indices[i] : i; };
+
+  size_t hit_count;
+  {
+    const auto on_near_miss = [&](const size_t index) { states[index] = 1; };
+    if (indices) {
+      hit_count = near_cache_->fetch(table_name, num_indices, indices, keys, values, value_stride,
+                                     on_near_miss, std::chrono::nanoseconds::zero());
+    } else {
+      hit_count = near_cache_->fetch(table_name, num_indices, keys, values, value_stride,
+                                     on_near_miss, std::chrono::nanoseconds::zero());
+    }
+  }
+  if (hit_count == num_indices) {
+    return hit_count;
+  }
+
+  std::vector<size_t> missed_indices;
+  missed_indices.reserve(num_indices - hit_count);
+  for (size_t i{0}; i < num_indices; ++i) {
+    if (states[index_at(i)] == 1) {
+      missed_indices.emplace_back(index_at(i));
+    }
+  }
+
+  std::chrono::nanoseconds remaining_budget{std::chrono::nanoseconds::zero()};
+  if (time_budget != std::chrono::nanoseconds::zero()) {
+    const std::chrono::nanoseconds elapsed{std::chrono::high_resolution_clock::now() - begin};
+    remaining_budget = std::max(time_budget - elapsed, std::chrono::nanoseconds{1});
+  }
+  const size_t remote_hit_count{fetch_remote_(
+      table_name, missed_indices.size(), missed_indices.data(), keys, values, value_stride,
+      [&](const size_t index) {
+        states[index] = 2;
+        on_miss(index);
+      },
+      remaining_budget)};
+  hit_count += remote_hit_count;
+
+  // Admit the values that were fetched from Redis.
+  if (remote_hit_count > 0) {
+    std::vector<Key> fetched_keys;
+    std::vector<char> fetched_values;
+    fetched_keys.reserve(remote_hit_count);
+    fetched_values.reserve(remote_hit_count * value_stride);
+    for (const size_t index : missed_indices) {
+      if (states[index] == 1) {
+        fetched_keys.emplace_back(keys[index]);
+        const char* const value{&values[index * value_stride]};
+        fetched_values.insert(fetched_values.end(), value, value + value_stride);
+      }
+    }
+    near_cache_->insert(table_name, fetched_keys.size(), fetched_keys.data(),
+                        fetched_values.data(), static_cast<uint32_t>(value_stride), value_stride);
+  }
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": ",
+             num_indices - missed_indices.size(), " / ", num_indices, " near-cache hits, ",
+             remote_hit_count, " / ", missed_indices.size(), " Redis hits.\n");
+  return hit_count;
+}
+
 template <typename Key>
 size_t RedisClusterBackend<Key>::evict(const std::string& table_name) {
   const auto evict_part = [&](const size_t part_index) -> size_t {
@@ -560,6 +738,10 @@ size_t RedisClusterBackend<Key>::evict(const std::string& table_name) {
 
   HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
              " entries.\n");
+
+  if (near_cache_) {
+    near_cache_->evict(table_name);
+  }
   return num_deletions;
 }
 
@@ -631,6 +813,10 @@ size_t RedisClusterBackend<Key>::evict(const std::string& table_name, const size
 
   HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
              " / ", num_keys, " entries.\n");
+
+  if (near_cache_ && num_keys > 0) {
+    near_cache_->evict(table_name, num_keys, keys);
+  }
   return num_deletions;
 }
 
@@ -695,8 +881,10 @@ uint32_t RedisClusterBackend<Key>::value_size_for(const std::string& table_name)
       const sw::redis::Optional<std::string> v_view{
           redis_->hget(hkey_v, {reinterpret_cast<const char*>(&key), sizeof(Key)})};
       if (v_view) {
-        const uint32_t size{static_cast<uint32_t>(v_view->size())};
-        HCTR_CHECK(size == v_view->size());
+        const size_t decoded_size{
+            db_decoded_value_size(this->params_.value_encoding, v_view->size())};
+        const uint32_t size{static_cast<uint32_t>(decoded_size)};
+        HCTR_CHECK(size == decoded_size);
         return size;
       }
     }
@@ -736,7 +924,8 @@ size_t RedisClusterBackend<Key>::dump_bin(const std::string& table_name, std::of
 
         const std::lock_guard lock(mutex);
         redis_->hmget(hkey_v, k_views.begin(), k_views.end(),
-                      RedisBinFileInserter<Key>(k_views, value_size, file, num_entries));
+                      RedisBinFileInserter<Key>(k_views, this->params_.value_encoding, value_size,
+                                                file, num_entries));
       }
     });
   };
@@ -786,8 +975,11 @@ size_t RedisClusterBackend<Key>::dump_sst(const std::string& table_name,
 template <typename Key>
 void RedisClusterBackend<Key>::resolve_overflow_(const std::string& table_name,
                                                  const size_t part_index, size_t part_size) {
+  const size_t overflow_margin{this->params_.table_overflow_margin(table_name)};
+  const size_t overflow_resolution_margin{
+      this->params_.overflow_resolution_margin(overflow_margin)};
   HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-             " is overflowing (size = ", part_size, " > ", this->params_.overflow_margin,
+             " is overflowing (size = ", part_size, " > ", overflow_margin,
              "). Attempting to resolve...\n");
 
   const size_t max_batch_size{this->params_.max_batch_size};
@@ -813,7 +1005,7 @@ void RedisClusterBackend<Key>::resolve_overflow_(const std::string& table_name,
       redis_->hkeys(hkey_m, RedisKeyVectorInserter(keys));
 
       part_size = keys.size();
-      if (part_size <= this->overflow_resolution_margin_) {
+      if (part_size <= overflow_resolution_margin) {
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                    ": Overflow was already resolved by another process.\n");
         return;
@@ -843,7 +1035,7 @@ void RedisClusterBackend<Key>::resolve_overflow_(const std::string& table_name,
           k_views.emplace_back(reinterpret_cast<const char*>(&*k_it), sizeof(Key));
         }
         delete_batch(k_views);
-        if (part_size <= this->overflow_resolution_margin_) {
+        if (part_size <= overflow_resolution_margin) {
           break;
         }
       }
@@ -856,7 +1048,7 @@ void RedisClusterBackend<Key>::resolve_overflow_(const std::string& table_name,
       redis_->hgetall(hkey_m, RedisKeyAccumulatorVectorInserter<Key>(keys_metas));
 
       part_size = keys_metas.size();
-      if (part_size <= this->overflow_resolution_margin_) {
+      if (part_size <= overflow_resolution_margin) {
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                    ": Overflow was already resolved by another process.\n");
         return;
@@ -887,7 +1079,7 @@ void RedisClusterBackend<Key>::resolve_overflow_(const std::string& table_name,
             k_views.emplace_back(reinterpret_cast<const char*>(&km_it->first), sizeof(Key));
           }
           delete_batch(k_views);
-          if (part_size <= this->overflow_resolution_margin_) {
+          if (part_size <= overflow_resolution_margin) {
             break;
           }
         }
@@ -903,9 +1095,11 @@ void RedisClusterBackend<Key>::resolve_overflow_(const std::string& table_name,
           touched_keys->emplace_back(km_it->first);
         }
 
-        background_worker_.submit([this, table_name, part_index, touched_keys, new_count]() {
-          refresh_metadata_lfu_set_(table_name, part_index, *touched_keys, new_count);
-        });
+        background_worker_.submit(
+            [this, table_name, part_index, touched_keys, new_count]() {
+              refresh_metadata_lfu_set_(table_name, part_index, *touched_keys, new_count);
+            },
+            ThreadPool::Priority::Background);
       }
     } break;
 
@@ -916,7 +1110,7 @@ void RedisClusterBackend<Key>::resolve_overflow_(const std::string& table_name,
       redis_->hgetall(hkey_m, RedisKeyTimeVectorInserter<Key>(keys_metas));
 
       part_size = keys_metas.size();
-      if (part_size <= this->overflow_resolution_margin_) {
+      if (part_size <= overflow_resolution_margin) {
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                    ": Overflow was already resolved by another process.\n");
         return;
@@ -945,11 +1139,14 @@ void RedisClusterBackend<Key>::resolve_overflow_(const std::string& table_name,
           k_views.emplace_back(reinterpret_cast<const char*>(&km_it->first), sizeof(Key));
         }
         delete_batch(k_views);
-        if (part_size <= this->overflow_resolution_margin_) {
+        if (part_size <= overflow_resolution_margin) {
           break;
         }
       }
     } break;
+
+    default:
+      HCTR_DIE("Unsupported overflow policy!");
   }
 
   HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
@@ -1053,17 +1250,24 @@ void RedisClusterBackend<Key>::queue_metadata_refresh_(const std::string& table_
     } break;
 
     case DatabaseOverflowPolicy_t::EvictLeastUsed: {
-      background_worker_.submit([this, table_name, part_index, keys]() {
-        refresh_metadata_lfu_inc_(table_name, part_index, *keys, 1);
-      });
+      background_worker_.submit(
+          [this, table_name, part_index, keys]() {
+            refresh_metadata_lfu_inc_(table_name, part_index, *keys, 1);
+          },
+          ThreadPool::Priority::Background);
     } break;
 
     case DatabaseOverflowPolicy_t::EvictOldest: {
       const time_t now{std::time(nullptr)};
-      background_worker_.submit([this, table_name, part_index, keys, now]() {
-        refresh_metadata_lru_(table_name, part_index, *keys, now);
-      });
+      background_worker_.submit(
+          [this, table_name, part_index, keys, now]() {
+            refresh_metadata_lru_(table_name, part_index, *keys, now);
+          },
+          ThreadPool::Priority::Background);
     } break;
+
+    default:
+      HCTR_DIE("Unsupported overflow policy!");
   }
 }
 
@@ -14,6 +14,10 @@
  * limitations under the License.
  */
 
+#include <rocksdb/cache.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/table.h>
+
 #include <core23/logger.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/rocksdb_backend.hpp>
@@ -41,6 +45,23 @@ RocksDBBackend<Key>::RocksDBBackend(const RocksDBBackendParams& params)
   // Configure various behaviors and options used in later operations.
   column_family_options_.OptimizeForPointLookup(8);
   column_family_options_.OptimizeLevelStyleCompaction();
+
+  // All tables (column families) share a single block cache. Index and filter blocks are cached in
+  // the high-priority pool, so that they are not flushed out by a large scan over data blocks.
+  block_cache_ = rocksdb::NewLRUCache(this->params_.block_cache_size, -1, false, 0.5);
+  {
+    rocksdb::BlockBasedTableOptions table_options;
+    table_options.data_block_index_type = rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+    table_options.data_block_hash_table_util_ratio = 0.75;
+    table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10));
+    table_options.block_cache = block_cache_;
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.cache_index_and_filter_blocks_with_high_priority = true;
+    table_options.pin_l0_filter_and_index_blocks_in_cache = true;
+    column_family_options_.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+  }
+  options.table_factory = column_family_options_.table_factory;
+
   // Need to tune: read_options_.readahead_size
   // Need to tune: read_options_.verify_checksums
   write_options_.sync = false;
@@ -110,7 +131,7 @@ RocksDBBackend<Key>::~RocksDBBackend() {
 template <typename Key>
 size_t RocksDBBackend<Key>::size(const std::string& table_name) const {
   rocksdb::ColumnFamilyHandle* const col_handle{get_column_handle_(table_name)};
-  if (col_handle) {
+  if (!col_handle) {
     return 0;
   }
 
@@ -138,10 +159,10 @@ size_t RocksDBBackend<Key>::contains(const std::string& table_name, const size_t
   size_t hit_count{0};
   size_t skip_count{0};
 
-  std::vector<rocksdb::ColumnFamilyHandle*> col_handles;
-  std::vector<std::string> v_views;
   std::vector<rocksdb::Slice> k_views;
   k_views.reserve(std::min(num_keys, this->params_.max_batch_size));
+  std::vector<rocksdb::PinnableSlice> v_views(k_views.capacity());
+  std::vector<rocksdb::Status> statuses(k_views.capacity());
 
   // Step through keys batch-by-batch.
   std::chrono::nanoseconds elapsed;
@@ -156,17 +177,14 @@ size_t RocksDBBackend<Key>::contains(const std::string& table_name, const size_t
           k_views.clear();
           HCTR_HPS_DB_APPLY_(SEQUENTIAL_DIRECT,
                              k_views.emplace_back(reinterpret_cast<const char*>(k), sizeof(Key)));
-          col_handles.resize(k_views.size(), ch);
+          db_->MultiGet(read_options_, ch, k_views.size(), k_views.data(), v_views.data(),
+                        statuses.data());
 
-          v_views.clear();
-          v_views.reserve(col_handles.size());
-          const std::vector<rocksdb::Status>& statuses{
-              db_->MultiGet(read_options_, col_handles, k_views, &v_views)};
-
-          for (size_t idx{0}; idx < batch_size; ++idx) {
+          for (size_t idx{0}; idx < k_views.size(); ++idx) {
             const rocksdb::Status& s{statuses[idx]};
             if (s.ok()) {
               ++hit_count;
+              v_views[idx].Reset();
             } else if (!s.IsNotFound()) {
               HCTR_ROCKSDB_CHECK(s);
             }
@@ -246,10 +264,10 @@ size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t nu
   size_t miss_count{0};
   size_t skip_count{0};
 
-  std::vector<rocksdb::ColumnFamilyHandle*> col_handles;
-  std::vector<std::string> v_views;
   std::vector<rocksdb::Slice> k_views;
   k_views.reserve(std::min(num_keys, this->params_.max_batch_size));
+  std::vector<rocksdb::PinnableSlice> v_views(k_views.capacity());
+  std::vector<rocksdb::Status> statuses(k_views.capacity());
 
   // Step through input batch-by-batch.
   std::chrono::nanoseconds elapsed;
@@ -293,10 +311,10 @@ size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t nu
   size_t miss_count{0};
   size_t skip_count{0};
 
-  std::vector<rocksdb::ColumnFamilyHandle*> col_handles;
-  std::vector<std::string> v_views;
   std::vector<rocksdb::Slice> k_views;
   k_views.reserve(std::min(num_indices, this->params_.max_batch_size));
+  std::vector<rocksdb::PinnableSlice> v_views(k_views.capacity());
+  std::vector<rocksdb::Status> statuses(k_views.capacity());
 
   std::chrono::nanoseconds elapsed;
   const size_t* const indices_end{&indices[num_indices]};
@@ -312,7 +330,7 @@ size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t nu
 
     HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, ", batch ",
                (i - indices - 1) / this->params_.max_batch_size, ": ",
-               v_views.size() - miss_count + prev_miss_count, " / ", v_views.size(),
+               k_views.size() - miss_count + prev_miss_count, " / ", k_views.size(),
                " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
   }
 
@@ -322,6 +340,48 @@ size_t RocksDBBackend<Key>::fetch(const std::string& table_name, const size_t nu
   return hit_count;
 }
 
+template <typename Key>
+std::future<size_t> RocksDBBackend<Key>::fetch_async(
+    const std::string& table_name, const size_t num_keys, const Key* const keys,
+    char* const values, const size_t value_stride, const DatabaseMissCallback& on_miss,
+    const std::chrono::nanoseconds& time_budget) {
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  // Issue the `MultiGet`s for all batches concurrently, so that the storage device sees a deeper
+  // queue than with a sequential `fetch`.
+  std::vector<std::future<size_t>> batches;
+  batches.reserve((num_keys + max_batch_size - 1) / max_batch_size);
+  for (size_t offset{0}; offset < num_keys; offset += max_batch_size) {
+    const size_t batch_size{std::min(num_keys - offset, max_batch_size)};
+    batches.emplace_back(this->submit_fetch_([=, &on_miss]() {
+      return fetch(
+          table_name, batch_size, &keys[offset], &values[offset * value_stride], value_stride,
+          [&](const size_t index) { on_miss(offset + index); }, time_budget);
+    }));
+  }
+  return this->join_fetches_(std::move(batches));
+}
+
+template <typename Key>
+std::future<size_t> RocksDBBackend<Key>::fetch_async(
+    const std::string& table_name, const size_t num_indices, const size_t* const indices,
+    const Key* const keys, char* const values, const size_t value_stride,
+    const DatabaseMissCallback& on_miss, const std::chrono::nanoseconds& time_budget) {
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  // Issue the `MultiGet`s for all batches concurrently (see above).
+  std::vector<std::future<size_t>> batches;
+  batches.reserve((num_indices + max_batch_size - 1) / max_batch_size);
+  for (size_t offset{0}; offset < num_indices; offset += max_batch_size) {
+    const size_t batch_size{std::min(num_indices - offset, max_batch_size)};
+    batches.emplace_back(this->submit_fetch_([=, &on_miss]() {
+      return fetch(table_name, batch_size, &indices[offset], keys, values, value_stride, on_miss,
+                   time_budget);
+    }));
+  }
+  return this->join_fetches_(std::move(batches));
+}
+
 template <typename Key>
 size_t RocksDBBackend<Key>::evict(const std::string& table_name) {
   rocksdb::ColumnFamilyHandle* const ch{get_column_handle_(table_name)};
@@ -457,6 +517,19 @@ size_t RocksDBBackend<Key>::load_dump_sst(const std::string& table_name, const s
   return 0;
 }
 
+template <typename Key>
+size_t RocksDBBackend<Key>::load_dump_sst(const std::string& table_name,
+                                          const std::vector<std::string>& paths) {
+  rocksdb::ColumnFamilyHandle* const ch{get_or_create_column_handle_(table_name)};
+
+  // Ingest all files in one go. Overlapping files end up in level 0 and are merged by compaction.
+  // Files are hard-linked if possible (falls back to copying across file systems).
+  rocksdb::IngestExternalFileOptions ingest_file_options{ingest_file_options_};
+  ingest_file_options.move_files = true;
+  HCTR_ROCKSDB_CHECK(db_->IngestExternalFile(ch, paths, ingest_file_options));
+  return 0;
+}
+
 template class RocksDBBackend<unsigned int>;
 template class RocksDBBackend<long long>;
 
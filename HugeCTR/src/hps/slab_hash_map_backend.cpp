@@ -0,0 +1,781 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/slab_hash_map_backend.hpp>
+#include <hps/slab_hash_map_backend_detail.hpp>
+#include <numeric>
+#include <random>
+#include <thread_pool.hpp>
+
+// TODO: Remove me!
+#pragma GCC diagnostic error "-Wconversion"
+
+namespace HugeCTR {
+
+// Number of slots to start with, once the first entry is inserted into a partition.
+static constexpr size_t slab_hash_map_min_capacity{64};
+
+template <typename Key>
+std::pair<size_t, bool> SlabHashMapBackend<Key>::Partition::try_emplace(const Key& key) {
+  size_t index{find(key)};
+  if (index != capacity) {
+    return {index, false};
+  }
+
+  // Grow slab, if adding another entry would exceed the load limit.
+  if (static_cast<double>(size + 1) > static_cast<double>(capacity) * max_load_factor) {
+    rehash(std::max(capacity * 2, slab_hash_map_min_capacity));
+  }
+
+  // Claim the first free slot along the probe sequence.
+  for (index = home(key); is_occupied(index);) {
+    index = next(index);
+  }
+  SlotHeader& h{header(index)};
+  h.key = key;
+  h.meta = occupied_flag;
+  ++size;
+
+  return {index, true};
+}
+
+template <typename Key>
+void SlabHashMapBackend<Key>::Partition::erase(size_t index) {
+  // Cyclic distance from slot `a` to slot `b`.
+  const auto distance{
+      [&](const size_t a, const size_t b) { return b >= a ? b - a : b + capacity - a; }};
+
+  // Backward shift. An entry may fill the hole, if its home slot does not lie in (hole, i].
+  for (size_t i{next(index)}; is_occupied(i); i = next(i)) {
+    if (distance(home(header(i).key), i) >= distance(index, i)) {
+      std::memcpy(slot(index), slot(i), slot_size);
+      index = i;
+    }
+  }
+
+  header(index).meta = 0;
+  --size;
+}
+
+template <typename Key>
+void SlabHashMapBackend<Key>::Partition::rehash(const size_t new_capacity) {
+  HCTR_CHECK(new_capacity > size);
+
+  // Zero-initialized, hence all slots are free.
+  Slab old_slots(new_capacity * slot_size);
+  slots.swap(old_slots);
+  const size_t old_capacity{capacity};
+  capacity = new_capacity;
+
+  for (size_t i{0}; i < old_capacity; ++i) {
+    const char* const src{&old_slots[i * slot_size]};
+    const SlotHeader& src_header{*reinterpret_cast<const SlotHeader*>(src)};
+    if (src_header.meta & occupied_flag) {
+      size_t index{home(src_header.key)};
+      while (is_occupied(index)) {
+        index = next(index);
+      }
+      std::memcpy(slot(index), src, slot_size);
+    }
+  }
+}
+
+template <typename Key>
+SlabHashMapBackend<Key>::SlabHashMapBackend(const SlabHashMapBackendParams& params) : Base(params) {
+  HCTR_CHECK_HINT(params.max_load_factor > 0 && params.max_load_factor < 1,
+                  "Maximum load factor (", params.max_load_factor, ") must be in (0, 1).");
+
+  HCTR_LOG_C(DEBUG, WORLD, "Created blank database backend in local memory!\n");
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::size(const std::string& table_name) const {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  const PartitionList& parts{tables_it->second};
+
+  return std::accumulate(parts.begin(), parts.end(), UINT64_C(0),
+                         [](const size_t a, const Partition& b) {
+                           const std::shared_lock part_lock(b.read_write_guard);
+                           return a + b.size;
+                         });
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::contains(const std::string& table_name, const size_t num_keys,
+                                         const Key* const keys,
+                                         const std::chrono::nanoseconds& time_budget) const {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return Base::contains(table_name, num_keys, keys, time_budget);
+  }
+  const PartitionList& parts{tables_it->second};
+
+  const Key* const keys_end{&keys[num_keys]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  size_t hit_count{0};
+  size_t skip_count{0};
+
+  if (num_keys == 0) {
+    // Do nothing ;-).
+  } else if (num_keys == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    const Partition& part{parts[part_index]};
+    const std::shared_lock part_lock(part.read_write_guard);
+
+    // Step through keys batch-by-batch.
+    std::chrono::nanoseconds elapsed;
+    for (const Key* k{keys}; k != keys_end;) {
+      HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_DIRECT, nullptr);
+
+      const size_t prev_hit_count{hit_count};
+      const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+      HCTR_HPS_SLAB_HASH_MAP_CONTAINS_(SEQUENTIAL_DIRECT);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (k - keys - 1) / max_batch_size, ": ", hit_count - prev_hit_count,
+                 " / ", batch_size, " hits. Time: ", elapsed.count(), " / ", time_budget.count(),
+                 " ns.\n");
+    }
+  } else {
+    std::atomic<size_t> joint_hit_count{0};
+    std::atomic<size_t> joint_skip_count{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      const Partition& part{parts[part_index]};
+      const std::shared_lock part_lock(part.read_write_guard);
+
+      size_t hit_count{0};
+
+      // Step through keys batch-by-batch.
+      std::chrono::nanoseconds elapsed;
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_DIRECT, nullptr);
+
+        const size_t prev_hit_count{hit_count};
+        size_t batch_size{0};
+        HCTR_HPS_SLAB_HASH_MAP_CONTAINS_(PARALLEL_DIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": ", hit_count - prev_hit_count, " / ", batch_size,
+                   " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+      }
+
+      joint_hit_count += hit_count;
+    });
+
+    hit_count += joint_hit_count;
+    skip_count += joint_skip_count;
+  }
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": ", hit_count, " / ",
+             num_keys - skip_count, " hits, ", skip_count, " skipped.\n");
+  return hit_count;
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::insert(const std::string& table_name, const size_t num_pairs,
+                                       const Key* const keys, const char* const values,
+                                       const uint32_t value_size, const size_t value_stride) {
+  HCTR_CHECK(value_size <= value_stride);
+
+  std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions, or create them, if they do not exist yet.
+  auto tables_it{tables_.find(table_name)};
+  while (tables_it == tables_.end()) {
+    lock.unlock();
+    create_table_(table_name, value_size);
+    lock.lock();
+    tables_it = tables_.find(table_name);
+  }
+  PartitionList& parts{tables_it->second};
+
+  const Key* const keys_end{&keys[num_pairs]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+  const DatabaseOverflowPolicy_t overflow_policy{this->params_.overflow_policy};
+
+  size_t num_inserts{0};
+
+  if (num_pairs == 0) {
+    // Do nothing ;-).
+  } else if (num_pairs == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    Partition& part{parts[part_index]};
+    HCTR_CHECK(part.value_size == value_size);
+    const std::unique_lock part_lock(part.read_write_guard);
+
+    // Step through batch-by-batch.
+    for (const Key* k{keys}; k != keys_end;) {
+      // Check overflow condition.
+      if (part.size >= part.overflow_margin) {
+        resolve_overflow_(table_name, part_index, part);
+      }
+
+      // Perform insertion.
+      const size_t prev_num_inserts{num_inserts};
+      const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+      HCTR_HPS_SLAB_HASH_MAP_INSERT_(SEQUENTIAL_DIRECT);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (k - keys - 1) / max_batch_size, ": Inserted ",
+                 num_inserts - prev_num_inserts, " + updated ",
+                 batch_size - num_inserts + prev_num_inserts, " = ", batch_size, " entries.\n");
+    }
+  } else {
+    std::atomic<size_t> joint_num_inserts{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      Partition& part{parts[part_index]};
+      HCTR_CHECK(part.value_size == value_size);
+      const std::unique_lock part_lock(part.read_write_guard);
+
+      size_t num_inserts{0};
+
+      // Step through batch-by-batch.
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        // Check overflow condition.
+        if (part.size >= part.overflow_margin) {
+          resolve_overflow_(table_name, part_index, part);
+        }
+
+        // Perform insertion.
+        const size_t prev_num_inserts{num_inserts};
+        size_t batch_size{0};
+        HCTR_HPS_SLAB_HASH_MAP_INSERT_(PARALLEL_DIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": Inserted ", num_inserts - prev_num_inserts,
+                   " + updated ", batch_size - num_inserts + prev_num_inserts, " = ", batch_size,
+                   " entries.\n");
+      }
+
+      joint_num_inserts += num_inserts;
+    });
+
+    num_inserts += joint_num_inserts;
+  }
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Inserted ", num_inserts,
+             " + updated ", num_pairs - num_inserts, " = ", num_pairs, " entries.\n");
+  return num_inserts;
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                      const Key* const keys, char* const values,
+                                      const size_t value_stride,
+                                      const DatabaseMissCallback& on_miss,
+                                      const std::chrono::nanoseconds& time_budget) {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return Base::fetch(table_name, num_keys, keys, values, value_stride, on_miss, time_budget);
+  }
+  PartitionList& parts{tables_it->second};
+
+  const Key* const keys_end{&keys[num_keys]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+  const DatabaseOverflowPolicy_t overflow_policy{this->params_.overflow_policy};
+
+  size_t miss_count{0};
+  size_t skip_count{0};
+
+  if (num_keys == 0) {
+    // Do nothing ;-).
+  } else if (num_keys == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    Partition& part{parts[part_index]};
+    HCTR_CHECK(part.value_size <= value_stride);
+    const std::shared_lock part_lock(part.read_write_guard);
+
+    // Step through input batch-by-batch.
+    std::chrono::nanoseconds elapsed;
+    for (const Key* k{keys}; k != keys_end;) {
+      HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_DIRECT, on_miss);
+
+      const size_t prev_miss_count{miss_count};
+      const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+      HCTR_HPS_SLAB_HASH_MAP_FETCH_(SEQUENTIAL_DIRECT);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (k - keys - 1) / max_batch_size, ": ",
+                 batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                 " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+    }
+  } else {
+    std::atomic<size_t> joint_miss_count{0};
+    std::atomic<size_t> joint_skip_count{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      Partition& part{parts[part_index]};
+      HCTR_CHECK(part.value_size <= value_stride);
+      const std::shared_lock part_lock(part.read_write_guard);
+
+      size_t miss_count{0};
+
+      // Step through input batch-by-batch.
+      std::chrono::nanoseconds elapsed;
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_DIRECT, on_miss);
+
+        const size_t prev_miss_count{miss_count};
+        size_t batch_size{0};
+        HCTR_HPS_SLAB_HASH_MAP_FETCH_(PARALLEL_DIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
+                   batch_size, " hits. Time: ", elapsed.count(), " / ", time_budget.count(),
+                   " ns.\n");
+      }
+
+      joint_miss_count += miss_count;
+    });
+
+    miss_count += joint_miss_count;
+    skip_count += joint_skip_count;
+  }
+
+  const size_t hit_count{num_keys - skip_count - miss_count};
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": ", hit_count, " / ",
+             num_keys - skip_count, " hits; skipped ", skip_count, " keys.\n");
+  return hit_count;
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                      const size_t* const indices, const Key* const keys,
+                                      char* const values, const size_t value_stride,
+                                      const DatabaseMissCallback& on_miss,
+                                      const std::chrono::nanoseconds& time_budget) {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return Base::fetch(table_name, num_indices, indices, keys, values, value_stride, on_miss,
+                       time_budget);
+  }
+  PartitionList& parts{tables_it->second};
+
+  const size_t* const indices_end{&indices[num_indices]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+  const DatabaseOverflowPolicy_t overflow_policy{this->params_.overflow_policy};
+
+  size_t miss_count{0};
+  size_t skip_count{0};
+
+  if (num_indices == 0) {
+    // Do nothing ;-).
+  } else if (num_indices == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    Partition& part{parts[part_index]};
+    HCTR_CHECK(part.value_size <= value_stride);
+    const std::shared_lock part_lock(part.read_write_guard);
+
+    // Step through input batch-by-batch.
+    std::chrono::nanoseconds elapsed;
+    for (const size_t* i{indices}; i != indices_end;) {
+      HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_INDIRECT, on_miss);
+
+      const size_t prev_miss_count{miss_count};
+      const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
+      HCTR_HPS_SLAB_HASH_MAP_FETCH_(SEQUENTIAL_INDIRECT);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (i - indices - 1) / max_batch_size, ": ",
+                 batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                 " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+    }
+  } else {
+    std::atomic<size_t> joint_miss_count{0};
+    std::atomic<size_t> joint_skip_count{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      Partition& part{parts[part_index]};
+      HCTR_CHECK(part.value_size <= value_stride);
+      const std::shared_lock part_lock(part.read_write_guard);
+
+      size_t miss_count{0};
+
+      // Step through input batch-by-batch.
+      std::chrono::nanoseconds elapsed;
+      size_t num_batches{0};
+      for (const size_t* i{indices}; i != indices_end; ++num_batches) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_INDIRECT, on_miss);
+
+        const size_t prev_miss_count{miss_count};
+        size_t batch_size{0};
+        HCTR_HPS_SLAB_HASH_MAP_FETCH_(PARALLEL_INDIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
+                   batch_size, " hits. Time: ", elapsed.count(), " / ", time_budget.count(),
+                   " ns.\n");
+      }
+
+      joint_miss_count += miss_count;
+    });
+
+    miss_count += joint_miss_count;
+    skip_count += joint_skip_count;
+  }
+
+  const size_t hit_count{num_indices - skip_count - miss_count};
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": ", hit_count, " / ",
+             num_indices - skip_count, " hits; skipped ", skip_count, " keys.\n");
+  return hit_count;
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::evict(const std::string& table_name) {
+  const std::unique_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  const PartitionList& parts{tables_it->second};
+
+  // Count items and erase.
+  size_t num_deletions{0};
+  for (const Partition& part : parts) {
+    num_deletions += part.size;
+  }
+  tables_.erase(tables_it);
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
+             " entries.\n");
+  return num_deletions;
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::evict(const std::string& table_name, const size_t num_keys,
+                                      const Key* const keys) {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  PartitionList& parts{tables_it->second};
+
+  const Key* const keys_end{&keys[num_keys]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  size_t num_deletions{0};
+
+  if (num_keys == 0) {
+    // Do nothing ;-).
+  } else if (num_keys == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    Partition& part{parts[part_index]};
+    const std::unique_lock part_lock(part.read_write_guard);
+
+    // Step through input batch-by-batch.
+    for (const Key* k{keys}; k != keys_end;) {
+      const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+      const size_t prev_num_deletions{num_deletions};
+      HCTR_HPS_SLAB_HASH_MAP_EVICT_(SEQUENTIAL_DIRECT);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (k - keys - 1) / max_batch_size, ": Erased ",
+                 num_deletions - prev_num_deletions, " entries.\n");
+    }
+  } else {
+    std::atomic<size_t> joint_num_deletions{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      Partition& part{parts[part_index]};
+      const std::unique_lock part_lock(part.read_write_guard);
+
+      size_t num_deletions{0};
+
+      // Step through input batch-by-batch.
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        const size_t prev_num_deletions{num_deletions};
+        size_t batch_size{0};
+        HCTR_HPS_SLAB_HASH_MAP_EVICT_(PARALLEL_DIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": Erased ", num_deletions - prev_num_deletions, " / ",
+                   batch_size, " entries.\n");
+      }
+
+      joint_num_deletions += num_deletions;
+    });
+
+    num_deletions += joint_num_deletions;
+  }
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
+             " / ", num_keys, " entries.\n");
+  return num_deletions;
+}
+
+template <typename Key>
+std::vector<std::string> SlabHashMapBackend<Key>::find_tables(const std::string& model_name) {
+  const std::string& tag_prefix{HierParameterServerBase::make_tag_name(model_name, "", false)};
+
+  const std::shared_lock lock(read_write_guard_);
+
+  std::vector<std::string> matches;
+  for (const auto& pair : tables_) {
+    if (pair.first.find(tag_prefix) == 0) {
+      matches.push_back(pair.first);
+    }
+  }
+  return matches;
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::dump_bin(const std::string& table_name, std::ofstream& file) {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  const PartitionList& parts{tables_it->second};
+
+  // Store value size.
+  const uint32_t value_size{parts.empty() ? 0 : parts.front().value_size};
+  file.write(reinterpret_cast<const char*>(&value_size), sizeof(uint32_t));
+
+  // Store values.
+  size_t num_entries{0};
+
+  for (const Partition& part : parts) {
+    const std::shared_lock part_lock(part.read_write_guard);
+    for (size_t i{0}; i < part.capacity; ++i) {
+      if (part.is_occupied(i)) {
+        file.write(reinterpret_cast<const char*>(&part.header(i).key), sizeof(Key));
+        file.write(part.value(i), value_size);
+      }
+    }
+    num_entries += part.size;
+  }
+
+  return num_entries;
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::dump_sst(const std::string& table_name,
+                                         rocksdb::SstFileWriter& file) {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  const PartitionList& parts{tables_it->second};
+
+  // Slots are referenced until written. So we must hold all partition locks until the end.
+  std::vector<std::shared_lock<std::shared_mutex>> part_locks;
+  part_locks.reserve(parts.size());
+  for (const Partition& part : parts) {
+    part_locks.emplace_back(part.read_write_guard);
+  }
+
+  // Sort slots by key.
+  std::vector<const char*> slots;
+  slots.reserve(std::accumulate(parts.begin(), parts.end(), UINT64_C(0),
+                                [](const size_t a, const Partition& b) { return a + b.size; }));
+  for (const Partition& part : parts) {
+    for (size_t i{0}; i < part.capacity; ++i) {
+      if (part.is_occupied(i)) {
+        slots.emplace_back(part.slot(i));
+      }
+    }
+  }
+  std::sort(slots.begin(), slots.end(), [](const char* const a, const char* const b) {
+    return reinterpret_cast<const SlotHeader*>(a)->key <
+           reinterpret_cast<const SlotHeader*>(b)->key;
+  });
+
+  // Iterate over pairs and insert.
+  rocksdb::Slice k_view{nullptr, sizeof(Key)};
+  rocksdb::Slice v_view{nullptr, parts.empty() ? 0 : parts.front().value_size};
+
+  for (const char* const slot : slots) {
+    k_view.data_ = slot;
+    v_view.data_ = &slot[sizeof(SlotHeader)];
+    HCTR_ROCKSDB_CHECK(file.Put(k_view, v_view));
+  }
+
+  return slots.size();
+}
+
+template <typename Key>
+void SlabHashMapBackend<Key>::create_table_(const std::string& table_name,
+                                            const uint32_t value_size) {
+  const std::unique_lock lock(read_write_guard_);
+
+  PartitionList& parts{tables_.try_emplace(table_name).first->second};
+  if (parts.empty()) {
+    HCTR_CHECK(value_size > 0);
+
+    const size_t overflow_margin{this->params_.table_overflow_margin(table_name)};
+    while (parts.size() < this->params_.num_partitions) {
+      parts.emplace_back(value_size, this->params_, overflow_margin);
+    }
+  }
+}
+
+template <typename Key>
+size_t SlabHashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
+                                                  const size_t part_index, Partition& part) {
+  const size_t max_batch_size{this->params_.max_batch_size};
+  const DatabaseOverflowPolicy_t overflow_policy{this->params_.overflow_policy};
+
+  size_t num_deletions{0};
+
+  // The clock sweeps the slab in place. Hence, it neither needs to collect nor sort the keys.
+  if (overflow_policy == DatabaseOverflowPolicy_t::EvictClock) {
+    HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+               " is overflowing (size = ", part.size, " > ", part.overflow_margin,
+               "): Sweeping CLOCK to evict ", part.size - part.overflow_resolution_margin,
+               " key/value pairs!\n");
+
+    while (part.size > part.overflow_resolution_margin) {
+      if (part.clock_hand >= part.capacity) {
+        part.clock_hand = 0;
+      }
+
+      if (part.is_occupied(part.clock_hand)) {
+        SlotHeader& header{part.header(part.clock_hand)};
+        if (header.meta & ~occupied_flag) {
+          // Referenced since last pass. Give the entry another chance.
+          --header.meta;
+        } else {
+          // Erasing shifts the next entry of the cluster into this slot. So, we stay.
+          part.erase(part.clock_hand);
+          ++num_deletions;
+          continue;
+        }
+      }
+      ++part.clock_hand;
+    }
+    return num_deletions;
+  }
+
+  // Fetch keys and metadata.
+  std::vector<std::pair<Key, uint64_t>> keys_metas;
+  keys_metas.reserve(part.size);
+  for (size_t i{0}; i < part.capacity; ++i) {
+    if (part.is_occupied(i)) {
+      const SlotHeader& header{part.header(i)};
+      keys_metas.emplace_back(header.key, header.meta & ~occupied_flag);
+    }
+  }
+
+  // Order by eviction priority.
+  const char* policy_name{nullptr};
+  switch (overflow_policy) {
+    case DatabaseOverflowPolicy_t::EvictRandom: {
+      policy_name = "RANDOM";
+
+      // TODO: This randomizer should fetch its seed from a central source.
+      std::random_device rd;
+      std::default_random_engine gen(rd());
+      std::shuffle(keys_metas.begin(), keys_metas.end(), gen);
+    } break;
+
+    case DatabaseOverflowPolicy_t::EvictLeastUsed:
+    case DatabaseOverflowPolicy_t::EvictOldest: {
+      policy_name = overflow_policy == DatabaseOverflowPolicy_t::EvictLeastUsed ? "LEAST USED"
+                                                                                : "OLDEST";
+
+      // Sort ascending by number of accesses / time.
+      std::sort(keys_metas.begin(), keys_metas.end(),
+                [](const auto& km0, const auto& km1) { return km0.second < km1.second; });
+    } break;
+
+    default:
+      HCTR_DIE("Unsupported overflow policy!");
+  }
+
+  // Call erase, until we reached the target amount.
+  auto km_it{keys_metas.begin()};
+  while (km_it != keys_metas.end()) {
+    const size_t batch_size{std::min<size_t>(keys_metas.end() - km_it, max_batch_size)};
+
+    HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+               " is overflowing (size = ", part.size, " > ", part.overflow_margin,
+               "): Attempting to evict ", batch_size, " ", policy_name, " key/value pairs!\n");
+
+    for (const auto& batch_end{km_it + batch_size}; km_it != batch_end; ++km_it) {
+      const Key* const k{&km_it->first};
+      HCTR_HPS_SLAB_HASH_MAP_EVICT_K_();
+    }
+    if (part.size <= part.overflow_resolution_margin) {
+      break;
+    }
+  }
+
+  // Normalize access counts to avoid that once popular entries can never be evicted (see
+  // `HashMapBackend::resolve_overflow_`).
+  if (overflow_policy == DatabaseOverflowPolicy_t::EvictLeastUsed && km_it != keys_metas.end()) {
+    const uint64_t min_access_count{km_it->second};
+    for (size_t i{0}; i < part.capacity; ++i) {
+      if (part.is_occupied(i)) {
+        SlotHeader& header{part.header(i)};
+        const uint64_t access_count{header.meta & ~occupied_flag};
+        header.meta = occupied_flag |
+                      (access_count > min_access_count ? (access_count - min_access_count) / 2 : 0);
+      }
+    }
+  }
+
+  return num_deletions;
+}
+
+template class SlabHashMapBackend<unsigned int>;
+template class SlabHashMapBackend<long long>;
+
+}  // namespace HugeCTR
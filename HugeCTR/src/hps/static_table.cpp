@@ -29,7 +29,9 @@ template <typename TypeHashKey, typename TypeEmbVec>
 StaticTable<TypeHashKey, TypeEmbVec>::StaticTable(const InferenceParams& inference_params,
                                                   const parameter_server_config& ps_config,
                                                   HierParameterServerBase* const parameter_server)
-    : EmbeddingCacheBase(), parameter_server_(parameter_server) {
+    : EmbeddingCacheBase(),
+      parameter_server_(parameter_server),
+      fp8_output_(inference_params.fp8_output) {
   // Store the configuration
   cache_config_.num_emb_table_ = inference_params.fuse_embedding_table
                                      ? inference_params.fused_sparse_model_files.size()
@@ -81,6 +83,16 @@ StaticTable<TypeHashKey, TypeEmbVec>::StaticTable(const InferenceParams& inferen
     }
   }
 
+  if (fp8_output_) {
+    HCTR_CHECK_HINT(inference_params.fp8_quant, "fp8_output requires fp8_quant to be enabled");
+    for (const size_t embedding_vec_size : cache_config_.embedding_vec_size_) {
+      HCTR_CHECK_HINT(embedding_vec_size >= 2,
+                      "fp8_output requires an embedding vector size of at least 2 to fit the "
+                      "scales into the output buffer");
+    }
+  }
+  HCTR_LOG(INFO, ROOT, "Return FP8 embeddings: %s\n", b2s(fp8_output_));
+
   // This is the only two places to set the cuda context in static table
   CudaDeviceContext dev_restorer;
   dev_restorer.set_device(cache_config_.cuda_dev_id_);
@@ -171,9 +183,19 @@ void StaticTable<TypeHashKey, TypeEmbVec>::lookup_from_device(size_t table_id, f
   CudaDeviceContext dev_restorer;
   dev_restorer.check_device(cache_config_.cuda_dev_id_);
 
-  static_tables_[table_id]->Query(
-      static_cast<TypeHashKey*>(workspace_handler.d_embeddingcolumns_[table_id]), num_keys,
-      d_vectors, stream);
+  const TypeHashKey* d_keys =
+      static_cast<TypeHashKey*>(workspace_handler.d_embeddingcolumns_[table_id]);
+  if (fp8_output_) {
+    // The quantized embeddings are followed by the scale of each key, aligned to 4 bytes.
+    const size_t values_size = num_keys * cache_config_.embedding_vec_size_[table_id];
+    const size_t scales_offset =
+        (values_size * sizeof(TypeEmbVec) + sizeof(float) - 1) / sizeof(float);
+    static_tables_[table_id]->QueryQuantized(d_keys, num_keys,
+                                             reinterpret_cast<TypeEmbVec*>(d_vectors),
+                                             d_vectors + scales_offset, stream);
+  } else {
+    static_tables_[table_id]->Query(d_keys, num_keys, d_vectors, stream);
+  }
 }
 
 template <typename TypeHashKey, typename TypeEmbVec>
@@ -0,0 +1,1124 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <filesystem>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/tiered_hash_map_backend.hpp>
+#include <hps/tiered_hash_map_backend_detail.hpp>
+#include <numeric>
+#include <thread_pool.hpp>
+
+// TODO: Remove me!
+#pragma GCC diagnostic error "-Wconversion"
+
+namespace HugeCTR {
+
+// Spill logs smaller than this are never compacted.
+static constexpr uint64_t tiered_hash_map_min_compaction_size{64L * 1024 * 1024};
+
+namespace {
+
+/**
+ * Creates an anonymous spill log in the directory \p path .
+ */
+int create_spill_log(const std::string& path) {
+  // Unnamed files vanish once closed. Not all file systems support them.
+  int fd{open(path.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR)};
+  if (fd < 0 && (errno == EOPNOTSUPP || errno == EISDIR)) {
+    std::string name{(std::filesystem::path{path} / "hctr_spill_XXXXXX").string()};
+    fd = mkostemp(name.data(), O_CLOEXEC);
+    if (fd >= 0) {
+      unlink(name.c_str());
+    }
+  }
+  HCTR_CHECK_HINT(fd >= 0, "Unable to create spill log in '", path, "' (errno = ", errno, ").");
+  return fd;
+}
+
+void read_fully(const int fd, char* value, size_t num_bytes, uint64_t offset) {
+  while (num_bytes) {
+    const ssize_t n{pread(fd, value, num_bytes, static_cast<off_t>(offset))};
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    HCTR_CHECK_HINT(n > 0, "Spill log read failed (errno = ", errno, ").");
+    value += n;
+    num_bytes -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+}
+
+/**
+ * Minimal io_uring instance that only issues reads. Set up through the raw system calls, to avoid
+ * depending on liburing. Not thread-safe. Hence, each thread owns its own instance.
+ */
+class SpillReader final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(SpillReader);
+
+  explicit SpillReader(const unsigned int queue_depth) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    fd_ = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+    if (fd_ < 0) {
+      HCTR_LOG_C(WARNING, WORLD, "io_uring is not available (errno = ", errno,
+                 "). Spill logs will be read using pread.\n");
+      return;
+    }
+    num_entries_ = params.sq_entries;
+
+    // Map submission and completion queues.
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd_, IORING_OFF_SQ_RING);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+      cq_ring_ = sq_ring_;
+    } else if (sq_ring_ != MAP_FAILED) {
+      cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd_, IORING_OFF_CQ_RING);
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    if (sq_ring_ != MAP_FAILED && cq_ring_ != MAP_FAILED) {
+      sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                   IORING_OFF_SQES);
+    }
+    if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+      HCTR_LOG_C(WARNING, WORLD, "Unable to map io_uring queues (errno = ", errno,
+                 "). Spill logs will be read using pread.\n");
+      release_();
+      return;
+    }
+
+    char* const sq{static_cast<char*>(sq_ring_)};
+    sq_tail_ = reinterpret_cast<unsigned int*>(&sq[params.sq_off.tail]);
+    sq_mask_ = *reinterpret_cast<unsigned int*>(&sq[params.sq_off.ring_mask]);
+    sq_array_ = reinterpret_cast<unsigned int*>(&sq[params.sq_off.array]);
+
+    char* const cq{static_cast<char*>(cq_ring_)};
+    cq_head_ = reinterpret_cast<unsigned int*>(&cq[params.cq_off.head]);
+    cq_tail_ = reinterpret_cast<unsigned int*>(&cq[params.cq_off.tail]);
+    cq_mask_ = *reinterpret_cast<unsigned int*>(&cq[params.cq_off.ring_mask]);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(&cq[params.cq_off.cqes]);
+  }
+
+  ~SpillReader() { release_(); }
+
+  inline bool is_available() const { return fd_ >= 0; }
+
+  void read(const int fd, const uint32_t value_size,
+            const std::vector<TieredHashMapSpillRead>& reads) {
+    for (size_t i{0}; i < reads.size();) {
+      const unsigned int n{
+          static_cast<unsigned int>(std::min<size_t>(reads.size() - i, num_entries_))};
+
+      // Fill submission queue (we are the only producer).
+      const unsigned int tail{*sq_tail_};
+      for (unsigned int j{0}; j < n; ++j) {
+        const unsigned int index{(tail + j) & sq_mask_};
+        io_uring_sqe& sqe{static_cast<io_uring_sqe*>(sqes_)[index]};
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.off = reads[i + j].offset;
+        sqe.addr = reinterpret_cast<uint64_t>(reads[i + j].value);
+        sqe.len = value_size;
+        sqe.user_data = i + j;
+        sq_array_[index] = index;
+      }
+      __atomic_store_n(sq_tail_, tail + n, __ATOMIC_RELEASE);
+
+      // Submit, and wait until all requests have completed.
+      unsigned int num_unsubmitted{n};
+      unsigned int num_incomplete{n};
+      while (num_incomplete) {
+        const long ret{syscall(__NR_io_uring_enter, fd_, num_unsubmitted,
+                               num_unsubmitted ? 0U : 1U, IORING_ENTER_GETEVENTS, nullptr, 0)};
+        if (ret < 0) {
+          HCTR_CHECK_HINT(errno == EINTR || errno == EAGAIN, "io_uring_enter failed (errno = ",
+                          errno, ").");
+        } else {
+          num_unsubmitted -= static_cast<unsigned int>(ret);
+        }
+
+        // Reap completions (we are the only consumer).
+        unsigned int head{*cq_head_};
+        for (; head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE); ++head, --num_incomplete) {
+          const io_uring_cqe& cqe{cqes_[head & cq_mask_]};
+          const TieredHashMapSpillRead& r{reads[cqe.user_data]};
+          if (cqe.res < 0) {
+            // Kernels before 5.6 do not support `IORING_OP_READ`.
+            HCTR_CHECK_HINT(cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP,
+                            "Spill log read failed (errno = ", -cqe.res, ").");
+            read_fully(fd, r.value, value_size, r.offset);
+          } else if (static_cast<uint32_t>(cqe.res) < value_size) {
+            const uint32_t n{static_cast<uint32_t>(cqe.res)};
+            read_fully(fd, &r.value[n], value_size - n, r.offset + n);
+          }
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      }
+
+      i += n;
+    }
+  }
+
+ private:
+  int fd_{-1};
+  unsigned int num_entries_{0};
+
+  size_t sq_ring_size_{0};
+  size_t cq_ring_size_{0};
+  size_t sqes_size_{0};
+  void* sq_ring_{MAP_FAILED};
+  void* cq_ring_{MAP_FAILED};
+  void* sqes_{MAP_FAILED};
+
+  unsigned int* sq_tail_{nullptr};
+  unsigned int sq_mask_{0};
+  unsigned int* sq_array_{nullptr};
+  unsigned int* cq_head_{nullptr};
+  unsigned int* cq_tail_{nullptr};
+  unsigned int cq_mask_{0};
+  io_uring_cqe* cqes_{nullptr};
+
+  void release_() {
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    sqes_ = cq_ring_ = sq_ring_ = MAP_FAILED;
+    if (fd_ >= 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+};
+
+}  // namespace
+
+void tiered_hash_map_read_spilled(const int fd, const uint32_t value_size,
+                                  const std::vector<TieredHashMapSpillRead>& reads,
+                                  const size_t queue_depth) {
+  thread_local SpillReader reader{static_cast<unsigned int>(queue_depth)};
+  if (reader.is_available()) {
+    reader.read(fd, value_size, reads);
+  } else {
+    for (const TieredHashMapSpillRead& r : reads) {
+      read_fully(fd, r.value, value_size, r.offset);
+    }
+  }
+}
+
+void tiered_hash_map_write_spilled(const int fd, uint64_t offset, const char* data,
+                                   size_t num_bytes) {
+  while (num_bytes) {
+    const ssize_t n{pwrite(fd, data, num_bytes, static_cast<off_t>(offset))};
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    HCTR_CHECK_HINT(n > 0, "Spill log write failed (errno = ", errno, ").");
+    data += n;
+    num_bytes -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+}
+
+template <typename Key>
+TieredHashMapBackend<Key>::Partition::Partition(const uint32_t value_size,
+                                                const TieredHashMapBackendParams& params,
+                                                const size_t overflow_margin)
+    : value_size{value_size},
+      allocation_rate{params.allocation_rate},
+      overflow_margin{overflow_margin},
+      overflow_resolution_margin{params.overflow_resolution_margin(overflow_margin)},
+      spill_fd{create_spill_log(params.spill_path)} {}
+
+template <typename Key>
+TieredHashMapBackend<Key>::Partition::~Partition() {
+  if (spill_fd >= 0) {
+    close(spill_fd);
+  }
+}
+
+template <typename Key>
+TieredHashMapBackend<Key>::TieredHashMapBackend(const TieredHashMapBackendParams& params)
+    : Base(params) {
+  HCTR_CHECK_HINT(std::filesystem::is_directory(params.spill_path), "Spill path '",
+                  params.spill_path, "' is not a directory.");
+  HCTR_CHECK(params.spill_queue_depth > 0 && params.spill_promotion_threshold > 0);
+  HCTR_CHECK(params.spill_compaction_ratio > 0 && params.spill_compaction_ratio <= 1);
+
+  HCTR_LOG_C(DEBUG, WORLD, "Created blank database backend in local memory, spilling to '",
+             params.spill_path, "'!\n");
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::size(const std::string& table_name) const {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  const PartitionList& parts{tables_it->second};
+
+  return std::accumulate(parts.begin(), parts.end(), UINT64_C(0),
+                         [](const size_t a, const Partition& b) {
+                           const std::shared_lock part_lock(b.read_write_guard);
+                           return a + b.entries.size() + b.spilled.size();
+                         });
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::contains(const std::string& table_name, const size_t num_keys,
+                                           const Key* const keys,
+                                           const std::chrono::nanoseconds& time_budget) const {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return Base::contains(table_name, num_keys, keys, time_budget);
+  }
+  const PartitionList& parts{tables_it->second};
+
+  const Key* const keys_end{&keys[num_keys]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  size_t hit_count{0};
+  size_t skip_count{0};
+
+  if (num_keys == 0) {
+    // Do nothing ;-).
+  } else if (num_keys == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    const Partition& part{parts[part_index]};
+    const std::shared_lock part_lock(part.read_write_guard);
+
+    // Step through keys batch-by-batch.
+    std::chrono::nanoseconds elapsed;
+    for (const Key* k{keys}; k != keys_end;) {
+      HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_DIRECT, nullptr);
+
+      const size_t prev_hit_count{hit_count};
+      const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+      HCTR_HPS_TIERED_HASH_MAP_CONTAINS_(SEQUENTIAL_DIRECT);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (k - keys - 1) / max_batch_size, ": ", hit_count - prev_hit_count,
+                 " / ", batch_size, " hits. Time: ", elapsed.count(), " / ", time_budget.count(),
+                 " ns.\n");
+    }
+  } else {
+    std::atomic<size_t> joint_hit_count{0};
+    std::atomic<size_t> joint_skip_count{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      const Partition& part{parts[part_index]};
+      const std::shared_lock part_lock(part.read_write_guard);
+
+      size_t hit_count{0};
+
+      // Step through keys batch-by-batch.
+      std::chrono::nanoseconds elapsed;
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_DIRECT, nullptr);
+
+        const size_t prev_hit_count{hit_count};
+        size_t batch_size{0};
+        HCTR_HPS_TIERED_HASH_MAP_CONTAINS_(PARALLEL_DIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": ", hit_count - prev_hit_count, " / ", batch_size,
+                   " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+      }
+
+      joint_hit_count += hit_count;
+    });
+
+    hit_count += joint_hit_count;
+    skip_count += joint_skip_count;
+  }
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": ", hit_count, " / ",
+             num_keys - skip_count, " hits, ", skip_count, " skipped.\n");
+  return hit_count;
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::insert(const std::string& table_name, const size_t num_pairs,
+                                         const Key* const keys, const char* const values,
+                                         const uint32_t value_size, const size_t value_stride) {
+  HCTR_CHECK(value_size <= value_stride);
+
+  std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions, or create them, if they do not exist yet.
+  auto tables_it{tables_.find(table_name)};
+  while (tables_it == tables_.end()) {
+    lock.unlock();
+    create_table_(table_name, value_size);
+    lock.lock();
+    tables_it = tables_.find(table_name);
+  }
+  PartitionList& parts{tables_it->second};
+
+  const Key* const keys_end{&keys[num_pairs]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  size_t num_inserts{0};
+
+  if (num_pairs == 0) {
+    // Do nothing ;-).
+  } else if (num_pairs == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    Partition& part{parts[part_index]};
+    HCTR_CHECK(part.value_size == value_size);
+    const std::unique_lock part_lock(part.read_write_guard);
+
+    // Step through batch-by-batch.
+    for (const Key* k{keys}; k != keys_end;) {
+      // Check overflow condition.
+      if (part.entries.size() >= part.overflow_margin) {
+        resolve_overflow_(table_name, part_index, part);
+      }
+
+      // Perform insertion.
+      const size_t prev_num_inserts{num_inserts};
+      const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+      HCTR_HPS_TIERED_HASH_MAP_INSERT_(SEQUENTIAL_DIRECT);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (k - keys - 1) / max_batch_size, ": Inserted ",
+                 num_inserts - prev_num_inserts, " + updated ",
+                 batch_size - num_inserts + prev_num_inserts, " = ", batch_size, " entries.\n");
+    }
+    compact_spill_(table_name, part_index, part);
+  } else {
+    std::atomic<size_t> joint_num_inserts{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      Partition& part{parts[part_index]};
+      HCTR_CHECK(part.value_size == value_size);
+      const std::unique_lock part_lock(part.read_write_guard);
+
+      size_t num_inserts{0};
+
+      // Step through batch-by-batch.
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        // Check overflow condition.
+        if (part.entries.size() >= part.overflow_margin) {
+          resolve_overflow_(table_name, part_index, part);
+        }
+
+        // Perform insertion.
+        const size_t prev_num_inserts{num_inserts};
+        size_t batch_size{0};
+        HCTR_HPS_TIERED_HASH_MAP_INSERT_(PARALLEL_DIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": Inserted ", num_inserts - prev_num_inserts,
+                   " + updated ", batch_size - num_inserts + prev_num_inserts, " = ", batch_size,
+                   " entries.\n");
+      }
+      compact_spill_(table_name, part_index, part);
+
+      joint_num_inserts += num_inserts;
+    });
+
+    num_inserts += joint_num_inserts;
+  }
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Inserted ", num_inserts,
+             " + updated ", num_pairs - num_inserts, " = ", num_pairs, " entries.\n");
+  return num_inserts;
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_keys,
+                                        const Key* const keys, char* const values,
+                                        const size_t value_stride,
+                                        const DatabaseMissCallback& on_miss,
+                                        const std::chrono::nanoseconds& time_budget) {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return Base::fetch(table_name, num_keys, keys, values, value_stride, on_miss, time_budget);
+  }
+  PartitionList& parts{tables_it->second};
+
+  const Key* const keys_end{&keys[num_keys]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  size_t miss_count{0};
+  size_t skip_count{0};
+
+  if (num_keys == 0) {
+    // Do nothing ;-).
+  } else if (num_keys == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    Partition& part{parts[part_index]};
+    HCTR_CHECK(part.value_size <= value_stride);
+
+    std::vector<TieredHashMapSpillRead> spill_reads;
+    std::vector<Promotion> promotions;
+    {
+      const std::shared_lock part_lock(part.read_write_guard);
+
+      // Step through input batch-by-batch.
+      std::chrono::nanoseconds elapsed;
+      for (const Key* k{keys}; k != keys_end;) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_DIRECT, on_miss);
+
+        const size_t prev_miss_count{miss_count};
+        const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+        HCTR_HPS_TIERED_HASH_MAP_FETCH_(SEQUENTIAL_DIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", (k - keys - 1) / max_batch_size, ": ",
+                   batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                   " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+      }
+    }
+    promote_(table_name, part_index, part, promotions);
+  } else {
+    std::atomic<size_t> joint_miss_count{0};
+    std::atomic<size_t> joint_skip_count{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      Partition& part{parts[part_index]};
+      HCTR_CHECK(part.value_size <= value_stride);
+
+      size_t miss_count{0};
+      std::vector<TieredHashMapSpillRead> spill_reads;
+      std::vector<Promotion> promotions;
+      {
+        const std::shared_lock part_lock(part.read_write_guard);
+
+        // Step through input batch-by-batch.
+        std::chrono::nanoseconds elapsed;
+        size_t num_batches{0};
+        for (const Key* k{keys}; k != keys_end; ++num_batches) {
+          HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_DIRECT, on_miss);
+
+          const size_t prev_miss_count{miss_count};
+          size_t batch_size{0};
+          HCTR_HPS_TIERED_HASH_MAP_FETCH_(PARALLEL_DIRECT);
+
+          HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/',
+                     part_index, ", batch ", num_batches, ": ",
+                     batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                     " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+        }
+      }
+      promote_(table_name, part_index, part, promotions);
+
+      joint_miss_count += miss_count;
+    });
+
+    miss_count += joint_miss_count;
+    skip_count += joint_skip_count;
+  }
+
+  const size_t hit_count{num_keys - skip_count - miss_count};
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": ", hit_count, " / ",
+             num_keys - skip_count, " hits; skipped ", skip_count, " keys.\n");
+  return hit_count;
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                        const size_t* const indices, const Key* const keys,
+                                        char* const values, const size_t value_stride,
+                                        const DatabaseMissCallback& on_miss,
+                                        const std::chrono::nanoseconds& time_budget) {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return Base::fetch(table_name, num_indices, indices, keys, values, value_stride, on_miss,
+                       time_budget);
+  }
+  PartitionList& parts{tables_it->second};
+
+  const size_t* const indices_end{&indices[num_indices]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  size_t miss_count{0};
+  size_t skip_count{0};
+
+  if (num_indices == 0) {
+    // Do nothing ;-).
+  } else if (num_indices == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    Partition& part{parts[part_index]};
+    HCTR_CHECK(part.value_size <= value_stride);
+
+    std::vector<TieredHashMapSpillRead> spill_reads;
+    std::vector<Promotion> promotions;
+    {
+      const std::shared_lock part_lock(part.read_write_guard);
+
+      // Step through input batch-by-batch.
+      std::chrono::nanoseconds elapsed;
+      for (const size_t* i{indices}; i != indices_end;) {
+        HCTR_HPS_DB_CHECK_TIME_BUDGET_(SEQUENTIAL_INDIRECT, on_miss);
+
+        const size_t prev_miss_count{miss_count};
+        const size_t batch_size{std::min<size_t>(indices_end - i, max_batch_size)};
+        HCTR_HPS_TIERED_HASH_MAP_FETCH_(SEQUENTIAL_INDIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", (i - indices - 1) / max_batch_size, ": ",
+                   batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                   " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+      }
+    }
+    promote_(table_name, part_index, part, promotions);
+  } else {
+    std::atomic<size_t> joint_miss_count{0};
+    std::atomic<size_t> joint_skip_count{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      Partition& part{parts[part_index]};
+      HCTR_CHECK(part.value_size <= value_stride);
+
+      size_t miss_count{0};
+      std::vector<TieredHashMapSpillRead> spill_reads;
+      std::vector<Promotion> promotions;
+      {
+        const std::shared_lock part_lock(part.read_write_guard);
+
+        // Step through input batch-by-batch.
+        std::chrono::nanoseconds elapsed;
+        size_t num_batches{0};
+        for (const size_t* i{indices}; i != indices_end; ++num_batches) {
+          HCTR_HPS_DB_CHECK_TIME_BUDGET_(PARALLEL_INDIRECT, on_miss);
+
+          const size_t prev_miss_count{miss_count};
+          size_t batch_size{0};
+          HCTR_HPS_TIERED_HASH_MAP_FETCH_(PARALLEL_INDIRECT);
+
+          HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/',
+                     part_index, ", batch ", num_batches, ": ",
+                     batch_size - miss_count + prev_miss_count, " / ", batch_size,
+                     " hits. Time: ", elapsed.count(), " / ", time_budget.count(), " ns.\n");
+        }
+      }
+      promote_(table_name, part_index, part, promotions);
+
+      joint_miss_count += miss_count;
+    });
+
+    miss_count += joint_miss_count;
+    skip_count += joint_skip_count;
+  }
+
+  const size_t hit_count{num_indices - skip_count - miss_count};
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": ", hit_count, " / ",
+             num_indices - skip_count, " hits; skipped ", skip_count, " keys.\n");
+  return hit_count;
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::evict(const std::string& table_name) {
+  const std::unique_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  const PartitionList& parts{tables_it->second};
+
+  // Count items and erase (also releases the spill logs).
+  size_t num_deletions{0};
+  for (const Partition& part : parts) {
+    num_deletions += part.entries.size() + part.spilled.size();
+  }
+  tables_.erase(tables_it);
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
+             " entries.\n");
+  return num_deletions;
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::evict(const std::string& table_name, const size_t num_keys,
+                                        const Key* const keys) {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  PartitionList& parts{tables_it->second};
+
+  const Key* const keys_end{&keys[num_keys]};
+  const size_t num_partitions{parts.size()};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  size_t num_deletions{0};
+
+  if (num_keys == 0) {
+    // Do nothing ;-).
+  } else if (num_keys == 1 || num_partitions == 1) {
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    Partition& part{parts[part_index]};
+    const std::unique_lock part_lock(part.read_write_guard);
+
+    // Step through input batch-by-batch.
+    for (const Key* k{keys}; k != keys_end;) {
+      const size_t prev_num_deletions{num_deletions};
+      const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+      HCTR_HPS_TIERED_HASH_MAP_EVICT_(SEQUENTIAL_DIRECT);
+
+      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                 ", batch ", (k - keys - 1) / max_batch_size, ": Erased ",
+                 num_deletions - prev_num_deletions, " entries.\n");
+    }
+    compact_spill_(table_name, part_index, part);
+  } else {
+    std::atomic<size_t> joint_num_deletions{0};
+
+    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+      Partition& part{parts[part_index]};
+      const std::unique_lock part_lock(part.read_write_guard);
+
+      size_t num_deletions{0};
+
+      // Step through input batch-by-batch.
+      size_t num_batches{0};
+      for (const Key* k{keys}; k != keys_end; ++num_batches) {
+        const size_t prev_num_deletions{num_deletions};
+        size_t batch_size{0};
+        HCTR_HPS_TIERED_HASH_MAP_EVICT_(PARALLEL_DIRECT);
+
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", num_batches, ": Erased ", num_deletions - prev_num_deletions, " / ",
+                   batch_size, " entries.\n");
+      }
+      compact_spill_(table_name, part_index, part);
+
+      joint_num_deletions += num_deletions;
+    });
+
+    num_deletions += joint_num_deletions;
+  }
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
+             " / ", num_keys, " entries.\n");
+  return num_deletions;
+}
+
+template <typename Key>
+std::vector<std::string> TieredHashMapBackend<Key>::find_tables(const std::string& model_name) {
+  const std::string& tag_prefix{HierParameterServerBase::make_tag_name(model_name, "", false)};
+
+  const std::shared_lock lock(read_write_guard_);
+
+  std::vector<std::string> matches;
+  for (const auto& pair : tables_) {
+    if (pair.first.find(tag_prefix) == 0) {
+      matches.push_back(pair.first);
+    }
+  }
+  return matches;
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::dump_bin(const std::string& table_name, std::ofstream& file) {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  const PartitionList& parts{tables_it->second};
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  // Store value size.
+  const uint32_t value_size{parts.empty() ? 0 : parts.front().value_size};
+  file.write(reinterpret_cast<const char*>(&value_size), sizeof(uint32_t));
+
+  // Store values.
+  size_t num_entries{0};
+
+  std::vector<Key> keys;
+  std::vector<char> values;
+  std::vector<TieredHashMapSpillRead> reads;
+
+  for (const Partition& part : parts) {
+    const std::shared_lock part_lock(part.read_write_guard);
+
+    // Memory tier.
+    for (const Entry& entry : part.entries) {
+      file.write(reinterpret_cast<const char*>(&entry.first), sizeof(Key));
+      file.write(entry.second.value, value_size);
+    }
+
+    // Spill tier (batch-by-batch).
+    for (auto it{part.spilled.begin()}; it != part.spilled.end();) {
+      keys.clear();
+      reads.clear();
+      values.resize(max_batch_size * value_size);
+      for (; it != part.spilled.end() && keys.size() < max_batch_size; ++it) {
+        reads.push_back({it->second.offset, &values[keys.size() * value_size]});
+        keys.emplace_back(it->first);
+      }
+      tiered_hash_map_read_spilled(part.spill_fd, value_size, reads,
+                                   this->params_.spill_queue_depth);
+
+      for (size_t j{0}; j < keys.size(); ++j) {
+        file.write(reinterpret_cast<const char*>(&keys[j]), sizeof(Key));
+        file.write(&values[j * value_size], value_size);
+      }
+    }
+
+    num_entries += part.entries.size() + part.spilled.size();
+  }
+
+  return num_entries;
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::dump_sst(const std::string& table_name,
+                                           rocksdb::SstFileWriter& file) {
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  const PartitionList& parts{tables_it->second};
+  const size_t max_batch_size{this->params_.max_batch_size};
+  const uint32_t value_size{parts.empty() ? 0 : parts.front().value_size};
+
+  // Entries are referenced until written. So we must hold all partition locks until the end.
+  std::vector<std::shared_lock<std::shared_mutex>> part_locks;
+  part_locks.reserve(parts.size());
+  for (const Partition& part : parts) {
+    part_locks.emplace_back(part.read_write_guard);
+  }
+
+  // Sort keys (values are either in memory, or in the spill log of the partition).
+  struct DumpEntry final {
+    Key key;
+    const char* value;
+    size_t part_index;
+    uint64_t offset;
+  };
+  std::vector<DumpEntry> entries;
+  for (size_t part_index{0}; part_index < parts.size(); ++part_index) {
+    const Partition& part{parts[part_index]};
+    for (const Entry& entry : part.entries) {
+      entries.push_back({entry.first, entry.second.value, part_index, 0});
+    }
+    for (const auto& pair : part.spilled) {
+      entries.push_back({pair.first, nullptr, part_index, pair.second.offset});
+    }
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& a, const auto& b) { return a.key < b.key; });
+
+  // Iterate over pairs and insert (batch-by-batch, to overlap reading spilled values).
+  rocksdb::Slice k_view{nullptr, sizeof(Key)};
+  rocksdb::Slice v_view{nullptr, value_size};
+
+  std::vector<char> values(max_batch_size * value_size);
+  std::vector<std::vector<TieredHashMapSpillRead>> reads(parts.size());
+
+  for (auto it{entries.begin()}; it != entries.end();) {
+    const auto batch_end{it + std::min<ptrdiff_t>(entries.end() - it, max_batch_size)};
+
+    for (auto e_it{it}; e_it != batch_end; ++e_it) {
+      if (!e_it->value) {
+        char* const value{&values[static_cast<size_t>(e_it - it) * value_size]};
+        reads[e_it->part_index].push_back({e_it->offset, value});
+        e_it->value = value;
+      }
+    }
+    for (size_t part_index{0}; part_index < parts.size(); ++part_index) {
+      if (!reads[part_index].empty()) {
+        tiered_hash_map_read_spilled(parts[part_index].spill_fd, value_size, reads[part_index],
+                                     this->params_.spill_queue_depth);
+        reads[part_index].clear();
+      }
+    }
+
+    for (; it != batch_end; ++it) {
+      k_view.data_ = reinterpret_cast<const char*>(&it->key);
+      v_view.data_ = it->value;
+      HCTR_ROCKSDB_CHECK(file.Put(k_view, v_view));
+    }
+  }
+
+  return entries.size();
+}
+
+template <typename Key>
+void TieredHashMapBackend<Key>::create_table_(const std::string& table_name,
+                                              const uint32_t value_size) {
+  const std::unique_lock lock(read_write_guard_);
+
+  PartitionList& parts{tables_.try_emplace(table_name).first->second};
+  if (parts.empty()) {
+    HCTR_CHECK(value_size > 0 && value_size <= this->params_.allocation_rate);
+
+    const size_t overflow_margin{this->params_.table_overflow_margin(table_name)};
+    while (parts.size() < this->params_.num_partitions) {
+      parts.emplace_back(value_size, this->params_, overflow_margin);
+    }
+  }
+}
+
+template <typename Key>
+void TieredHashMapBackend<Key>::allocate_value_page_(Partition& part) {
+  const size_t stride{(part.value_size + value_page_alignment - 1) / value_page_alignment *
+                      value_page_alignment};
+  const size_t num_values{part.allocation_rate / stride};
+  HCTR_CHECK(num_values > 0);
+
+  // Get more memory.
+  ValuePage& value_page{part.value_pages.emplace_back(num_values * stride)};
+
+  // Stock up slot references.
+  part.value_slots.reserve(part.value_slots.size() + num_values);
+  for (auto it{value_page.end()}; it != value_page.begin();) {
+    it -= stride;
+    part.value_slots.emplace_back(&*it);
+  }
+}
+
+template <typename Key>
+bool TieredHashMapBackend<Key>::insert_(Partition& part, const Key& key, const char* const value) {
+  const auto& res{part.entries.try_emplace(key)};
+  Payload& payload{res.first->second};
+
+  bool is_new{res.second};
+  if (res.second) {
+    // If spilled, the entry retains its access count. The log storage is reclaimed during the next
+    // compaction.
+    const auto& s_it{part.spilled.find(key)};
+    if (s_it != part.spilled.end()) {
+      payload.access_count = s_it->second.access_count;
+      part.spilled.erase(s_it);
+      part.spill_garbage += part.value_size;
+      is_new = false;
+    } else {
+      payload.access_count = 0;
+    }
+
+    // If no free space, allocate another buffer, and fill pointer queue.
+    if (part.value_slots.empty()) {
+      allocate_value_page_(part);
+    }
+
+    // Fetch storage slot.
+    payload.value = part.value_slots.back();
+    part.value_slots.pop_back();
+  }
+
+  std::copy_n(value, part.value_size, payload.value);
+  return is_new;
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::promote_(const std::string& table_name, const size_t part_index,
+                                           Partition& part,
+                                           const std::vector<Promotion>& promotions) {
+  if (promotions.empty()) {
+    return 0;
+  }
+
+  const std::unique_lock part_lock(part.read_write_guard);
+
+  size_t num_promotions{0};
+  for (const Promotion& promotion : promotions) {
+    // Make room first. Demotion invalidates iterators.
+    if (part.entries.size() >= part.overflow_margin) {
+      resolve_overflow_(table_name, part_index, part);
+    }
+
+    // Skip entries that were updated, evicted or already promoted meanwhile.
+    const auto& s_it{part.spilled.find(promotion.key)};
+    if (s_it == part.spilled.end() || s_it->second.offset != promotion.offset) {
+      continue;
+    }
+
+    insert_(part, promotion.key, promotion.value);
+    ++num_promotions;
+  }
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+             ": Promoted ", num_promotions, " / ", promotions.size(), " spilled entries.\n");
+
+  compact_spill_(table_name, part_index, part);
+  return num_promotions;
+}
+
+template <typename Key>
+size_t TieredHashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
+                                                    const size_t part_index, Partition& part) {
+  const size_t max_batch_size{this->params_.max_batch_size};
+
+  // Fetch keys and access counts.
+  std::vector<std::pair<Key, uint64_t>> keys_metas;
+  keys_metas.reserve(part.entries.size());
+  for (const auto& entry : part.entries) {
+    keys_metas.emplace_back(entry.first, entry.second.access_count);
+  }
+
+  // Find the least used entries.
+  const size_t num_demotions{part.entries.size() -
+                             std::min(part.entries.size(), part.overflow_resolution_margin)};
+  const auto& km_end{keys_metas.begin() + static_cast<ptrdiff_t>(num_demotions)};
+  std::nth_element(keys_metas.begin(), km_end, keys_metas.end(),
+                   [](const auto& km0, const auto& km1) { return km0.second < km1.second; });
+
+  HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+             " is overflowing (size = ", part.entries.size(), " > ", part.overflow_margin,
+             "): Demoting ", num_demotions, " LEAST USED key/value pairs to the spill log!\n");
+
+  // Append their values to the spill log batch-by-batch.
+  std::vector<char> values;
+  for (auto km_it{keys_metas.begin()}; km_it != km_end;) {
+    const auto& batch_end{km_it + std::min<ptrdiff_t>(km_end - km_it, max_batch_size)};
+
+    values.resize(static_cast<size_t>(batch_end - km_it) * part.value_size);
+    char* value{values.data()};
+    for (auto it{km_it}; it != batch_end; ++it, value += part.value_size) {
+      std::copy_n(part.entries.find(it->first)->second.value, part.value_size, value);
+    }
+    tiered_hash_map_write_spilled(part.spill_fd, part.spill_size, values.data(), values.size());
+
+    for (; km_it != batch_end; ++km_it) {
+      const auto& it{part.entries.find(km_it->first)};
+      part.value_slots.emplace_back(it->second.value);
+      part.entries.erase(it);
+
+      // Spilled entries have to earn their way back into memory.
+      part.spilled.emplace(km_it->first, SpillEntry{0, part.spill_size});
+      part.spill_size += part.value_size;
+    }
+  }
+
+  // Normalize the access counts of the remaining entries (same as the `EvictLeastUsed` policy of
+  // the `HashMapBackend`), so that entries that were once popular cannot stay in memory forever.
+  if (km_end != keys_metas.end()) {
+    const uint64_t min_access_count{km_end->second};
+    for (auto& entry : part.entries) {
+      uint64_t& access_count{entry.second.access_count};
+      access_count = (access_count - std::min(access_count, min_access_count)) / 2;
+    }
+  }
+
+  return num_demotions;
+}
+
+template <typename Key>
+void TieredHashMapBackend<Key>::compact_spill_(const std::string& table_name,
+                                               const size_t part_index, Partition& part) {
+  if (part.spill_size < tiered_hash_map_min_compaction_size ||
+      static_cast<double>(part.spill_garbage) <
+          static_cast<double>(part.spill_size) * this->params_.spill_compaction_ratio) {
+    return;
+  }
+
+  HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+             ": Compacting spill log (size = ", part.spill_size,
+             " bytes, outdated = ", part.spill_garbage, " bytes).\n");
+
+  // Visit remaining entries in log order.
+  std::vector<SpillEntry*> entries;
+  entries.reserve(part.spilled.size());
+  for (auto& pair : part.spilled) {
+    entries.emplace_back(&pair.second);
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& a, const auto& b) { return a->offset < b->offset; });
+
+  // Copy them batch-by-batch to a new log.
+  const int fd{create_spill_log(this->params_.spill_path)};
+  const size_t max_batch_size{this->params_.max_batch_size};
+  uint64_t spill_size{0};
+
+  std::vector<char> values;
+  std::vector<TieredHashMapSpillRead> reads;
+  for (auto it{entries.begin()}; it != entries.end();) {
+    const auto& batch_end{it + std::min<ptrdiff_t>(entries.end() - it, max_batch_size)};
+
+    values.resize(static_cast<size_t>(batch_end - it) * part.value_size);
+    reads.clear();
+    for (auto e_it{it}; e_it != batch_end; ++e_it) {
+      reads.push_back({(*e_it)->offset, &values[reads.size() * part.value_size]});
+    }
+    tiered_hash_map_read_spilled(part.spill_fd, part.value_size, reads,
+                                 this->params_.spill_queue_depth);
+    tiered_hash_map_write_spilled(fd, spill_size, values.data(), values.size());
+
+    for (; it != batch_end; ++it) {
+      (*it)->offset = spill_size;
+      spill_size += part.value_size;
+    }
+  }
+
+  close(part.spill_fd);
+  part.spill_fd = fd;
+  part.spill_size = spill_size;
+  part.spill_garbage = 0;
+}
+
+template class TieredHashMapBackend<unsigned int>;
+template class TieredHashMapBackend<long long>;
+
+}  // namespace HugeCTR
@@ -138,8 +138,8 @@ void unique_op<KeyType, CounterType, empty_key, empty_val, hasher>::unique(
                                                                 keys_, vals_, capacity_, counter_,
                                                                 d_unique_key, empty_key, empty_val);
 
-  HCTR_LIB_THROW(
-      cudaMemcpyAsync(d_output_counter, counter_, sizeof(size_t), cudaMemcpyHostToHost, stream));
+  HCTR_LIB_THROW(cudaMemcpyAsync(d_output_counter, counter_, sizeof(size_t),
+                                 cudaMemcpyDeviceToDevice, stream));
 
   HCTR_LIB_THROW(cudaGetLastError());
 }
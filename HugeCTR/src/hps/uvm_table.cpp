@@ -51,6 +51,8 @@ UvmTable<TypeHashKey>::UvmTable(const InferenceParams &inference_params,
            inference_params.number_of_refresh_buffers_in_pool);
   HCTR_LOG(INFO, ROOT, "Embedding cache type: %s\n",
            hctr_enum_to_c_str(inference_params.embedding_cache_type));
+  HCTR_LOG(INFO, ROOT, "UVM promotion percentage: %f\n",
+           inference_params.uvm_promotion_percentage);
 
   // initialize the profiler
   ec_profiler_ = std::make_unique<profiler>(ProfilerTarget_t::EC);
@@ -82,12 +84,13 @@ UvmTable<TypeHashKey>::UvmTable(const InferenceParams &inference_params,
   // Allocate resources.
   for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
     const size_t num_row = ps_config.embedding_key_count_.at(inference_params.model_name)[i];
+    const size_t num_host_row = num_row - num_row * cache_config_.cache_size_percentage_;
     uvm_tables_.emplace_back(std::make_unique<Cache>(
-        num_row * cache_config_.cache_size_percentage_,
-        num_row - num_row * cache_config_.cache_size_percentage_,
+        num_row * cache_config_.cache_size_percentage_, num_host_row,
         inference_params.max_batchsize *
             inference_params.maxnum_catfeature_query_per_table_per_sample[i],
-        cache_config_.embedding_vec_size_[i]));
+        cache_config_.embedding_vec_size_[i], 0.0f,
+        static_cast<size_t>(num_host_row * inference_params.uvm_promotion_percentage)));
     cache_config_.num_set_in_cache_.push_back(num_row);
   }
 
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <gemm_algorithm_cache.hpp>
 #include <inference/inference_session.hpp>
 #include <iostream>
 #include <resource_managers/resource_manager_core.hpp>
@@ -70,23 +72,17 @@ InferenceSession::InferenceSession(const std::string& model_config_path,
                                       embedding_features_tensors_, embedding_table_slot_size_,
                                       &embedding_feature_combiners_, &network_ptr,
                                       inference_tensor_entries_, resource_manager_);
-    auto dense_network_feedforward =
-        std::make_shared<StreamContextScheduleable>([=] { network_->predict(); });
-    predict_network_pipeline_ = Pipeline(
-        "default", resource_manager_->get_local_gpu_from_device_id(inference_params.device_id),
-        {dense_network_feedforward});
+    // Only the networks of cuda_graph_batch_sizes are captured in graphs of their own.
+    predict_network_pipeline_ = create_predict_pipeline_(
+        network_ptr,
+        inference_params.use_cuda_graph && !inference_params.cuda_graph_batch_sizes.empty());
 
     network_ = std::move(std::unique_ptr<Network>(network_ptr));
-    network_->initialize(false);
-    if (inference_params.use_algorithm_search) {
-      network_->search_algorithm();
-    }
-    if (inference_params_.dense_model_file.size() > 0) {
-      network_->upload_params_to_device_inference(inference_params_.dense_model_file);
-    }
-    if (inference_params_.non_trainable_params_file.size() > 0) {
-      network_->upload_non_trainable_params_to_device_inference(
-          inference_params_.non_trainable_params_file);
+    if (inference_params_.tensorrt_onnx_file.empty()) {
+      initialize_network_(*network_);
+      create_batch_size_buckets_();
+    } else {
+      create_tensorrt_network_();
     }
     CudaDeviceContext context(inference_params_.device_id);
     for (size_t idx = 0; idx < inference_params_.sparse_model_files.size(); ++idx) {
@@ -108,6 +104,33 @@ InferenceSession::InferenceSession(const std::string& model_config_path,
                               inference_params_.max_batchsize *
                                   inference_parser_.max_embedding_vector_size_per_sample *
                                   sizeof(float)));
+    if (!batch_size_buckets_.empty()) {
+      HCTR_LIB_THROW(
+          cudaMalloc((void**)&d_padded_row_ptrs_,
+                     (inference_params_.max_batchsize * inference_parser_.slot_num +
+                      inference_parser_.num_embedding_tables) *
+                         sizeof(int)));
+    }
+    if (inference_params_.micro_batching_window_us > 0) {
+      HCTR_LOG(INFO, ROOT, "Micro-batching window: %zu us\n",
+               inference_params_.micro_batching_window_us);
+      HCTR_LIB_THROW(cudaMalloc((void**)&d_batch_dense_, inference_params_.max_batchsize *
+                                                              inference_parser_.dense_dim *
+                                                              sizeof(float)));
+      HCTR_LIB_THROW(
+          cudaMalloc((void**)&d_batch_row_ptrs_,
+                     (inference_params_.max_batchsize * inference_parser_.slot_num +
+                      inference_parser_.num_embedding_tables) *
+                         sizeof(int)));
+      HCTR_LIB_THROW(cudaMalloc((void**)&d_batch_output_, inference_params_.max_batchsize *
+                                                               inference_parser_.label_dim *
+                                                               sizeof(float)));
+      h_batch_keys_ = malloc(inference_params_.max_batchsize *
+                             inference_parser_.max_feature_num_per_sample * sizeof(long long));
+      HCTR_LIB_THROW(cudaMalloc(&d_batch_keys_, inference_params_.max_batchsize *
+                                                    inference_parser_.max_feature_num_per_sample *
+                                                    sizeof(long long)));
+    }
   } catch (const std::runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     throw;
@@ -121,9 +144,102 @@ InferenceSession::~InferenceSession() {
   free(h_keys_);
   free(h_row_ptrs_);
   cudaFree(d_keys_);
+  cudaFree(d_batch_dense_);
+  cudaFree(d_batch_row_ptrs_);
+  cudaFree(d_batch_output_);
+  free(h_batch_keys_);
+  cudaFree(d_batch_keys_);
+  cudaFree(d_padded_row_ptrs_);
   for (auto stream : streams_) cudaStreamDestroy(stream);
 }
 
+void InferenceSession::initialize_network_(Network& network) {
+  network.initialize(false);
+  if (inference_params_.use_algorithm_search) {
+    if (!inference_params_.algorithm_cache_file.empty()) {
+      GemmAlgorithmCache::get().set_file(inference_params_.algorithm_cache_file);
+    }
+    network.search_algorithm();
+    GemmAlgorithmCache::get().save();
+  }
+  if (inference_params_.dense_model_file.size() > 0) {
+    network.upload_params_to_device_inference(inference_params_.dense_model_file);
+  }
+  if (inference_params_.non_trainable_params_file.size() > 0) {
+    network.upload_non_trainable_params_to_device_inference(
+        inference_params_.non_trainable_params_file);
+  }
+}
+
+Pipeline InferenceSession::create_predict_pipeline_(Network* network, bool capture_graph) {
+  auto dense_network_feedforward =
+      std::make_shared<StreamContextScheduleable>([network] { network->predict(); });
+  std::vector<std::shared_ptr<Scheduleable>> scheduleable_list{dense_network_feedforward};
+  if (capture_graph) {
+    scheduleable_list = {std::make_shared<GraphScheduleable>(dense_network_feedforward)};
+  }
+  return Pipeline("default",
+                  resource_manager_->get_local_gpu_from_device_id(inference_params_.device_id),
+                  scheduleable_list);
+}
+
+void InferenceSession::create_batch_size_buckets_() {
+  std::vector<size_t> batch_sizes;
+  for (const size_t batch_size : inference_params_.cuda_graph_batch_sizes) {
+    if (batch_size == 0 || batch_size >= inference_params_.max_batchsize) {
+      HCTR_LOG(WARNING, ROOT, "Ignore CUDA graph batch size %zu, which is not in (0, %zu).\n",
+               batch_size, inference_params_.max_batchsize);
+      continue;
+    }
+    batch_sizes.push_back(batch_size);
+  }
+  std::sort(batch_sizes.begin(), batch_sizes.end());
+  batch_sizes.erase(std::unique(batch_sizes.begin(), batch_sizes.end()), batch_sizes.end());
+
+  for (const size_t batch_size : batch_sizes) {
+    HCTR_LOG(INFO, ROOT, "Create dense network for batch size: %zu\n", batch_size);
+    auto bucket = std::make_unique<BatchSizeBucket>(config_);
+    bucket->batch_size = batch_size;
+
+    InferenceParams bucket_params = inference_params_;
+    bucket_params.max_batchsize = batch_size;
+    Network* network_ptr;
+    bucket->parser.create_pipeline(bucket_params, bucket->dense_input_tensorbag,
+                                   bucket->row_ptrs_tensors, bucket->embedding_features_tensors,
+                                   bucket->embedding_table_slot_size,
+                                   &bucket->embedding_feature_combiners, &network_ptr,
+                                   bucket->tensor_entries, resource_manager_);
+    bucket->network = std::unique_ptr<Network>(network_ptr);
+    initialize_network_(*bucket->network);
+    bucket->predict_network_pipeline =
+        create_predict_pipeline_(network_ptr, inference_params_.use_cuda_graph);
+    batch_size_buckets_.push_back(std::move(bucket));
+  }
+}
+
+void InferenceSession::create_tensorrt_network_() {
+  HCTR_LOG(INFO, ROOT, "Run the dense network with TensorRT: %s\n",
+           inference_params_.tensorrt_onnx_file.c_str());
+  if (!inference_params_.cuda_graph_batch_sizes.empty()) {
+    HCTR_LOG(WARNING, ROOT,
+             "Ignore the CUDA graph batch sizes, since the TensorRT engine runs any batch size.\n");
+  }
+  tensorrt_network_ = std::make_unique<TensorRTDenseNetwork>(
+      inference_params_.tensorrt_onnx_file, inference_params_.tensorrt_engine_file,
+      inference_params_.max_batchsize, inference_params_.use_mixed_precision,
+      inference_params_.device_id);
+
+  // The inputs of the engine are the dense input and the outputs of the embedding combiners.
+  for (const std::string& name : tensorrt_network_->input_names()) {
+    const auto entry =
+        std::find_if(inference_tensor_entries_.begin(), inference_tensor_entries_.end(),
+                     [&name](const TensorEntry& entry) { return entry.name == name; });
+    HCTR_THROW_IF(entry == inference_tensor_entries_.end(), Error_t::WrongInput, "Input ", name,
+                  " of the TensorRT engine is not a tensor of the model graph");
+    tensorrt_inputs_.push_back(entry->bag.get_ptr());
+  }
+}
+
 void InferenceSession::predict_impl(float* d_dense, void* keys, bool key_on_device, int* d_row_ptrs,
                                     float* d_output, int num_samples, int num_embedding_tables,
                                     bool table_major_key_layout) {
@@ -170,20 +286,64 @@ void InferenceSession::predict_impl(float* d_dense, void* keys, bool key_on_devi
     HCTR_LIB_THROW(cudaStreamSynchronize(streams_[i]));
   }
 
+  // Run the network of the smallest batch size that fits the samples.
+  BatchSizeBucket* bucket = nullptr;
+  for (const auto& batch_size_bucket : batch_size_buckets_) {
+    if (static_cast<size_t>(num_samples) <= batch_size_bucket->batch_size) {
+      bucket = batch_size_bucket.get();
+      break;
+    }
+  }
+  core23::Tensor& dense_input_tensorbag =
+      bucket ? bucket->dense_input_tensorbag : dense_input_tensorbag_;
+  auto& row_ptrs_tensors = bucket ? bucket->row_ptrs_tensors : row_ptrs_tensors_;
+  auto& embedding_features_tensors =
+      bucket ? bucket->embedding_features_tensors : embedding_features_tensors_;
+  auto& embedding_feature_combiners =
+      bucket ? bucket->embedding_feature_combiners : embedding_feature_combiners_;
+  Network& network = bucket ? *bucket->network : *network_;
+  Pipeline& predict_network_pipeline =
+      bucket ? bucket->predict_network_pipeline : predict_network_pipeline_;
+
+  // Pad the rows of each table with empty samples up to the batch size of the bucket.
+  size_t row_ptrs_batch_size = num_samples;
+  if (bucket && static_cast<size_t>(num_samples) < bucket->batch_size) {
+    std::vector<int> padded_row_ptrs;
+    padded_row_ptrs.reserve(bucket->batch_size * inference_parser_.slot_num +
+                            num_embedding_tables);
+    const int* table_row_ptrs = h_row_ptrs_;
+    for (size_t i = 0; i < num_embedding_tables; ++i) {
+      const size_t num_rows = num_samples * inference_parser_.slot_num_for_tables[i];
+      padded_row_ptrs.insert(padded_row_ptrs.end(), table_row_ptrs, table_row_ptrs + num_rows + 1);
+      padded_row_ptrs.insert(
+          padded_row_ptrs.end(),
+          (bucket->batch_size - num_samples) * inference_parser_.slot_num_for_tables[i],
+          table_row_ptrs[num_rows]);
+      table_row_ptrs += num_rows + 1;
+    }
+    cudaStream_t stream =
+        resource_manager_->get_local_gpu_from_device_id(inference_params_.device_id)->get_stream();
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_padded_row_ptrs_, padded_row_ptrs.data(),
+                                   padded_row_ptrs.size() * sizeof(int), cudaMemcpyHostToDevice,
+                                   stream));
+    d_row_ptrs = d_padded_row_ptrs_;
+    row_ptrs_batch_size = bucket->batch_size;
+  }
+
   // convert dense input to dense tensor
   // auto dense_dims = dense_input_tensorbag_.get_dimensions();
   // for (auto dim : dense_dims) {
   //   dense_size *= dim;
   // }
-  size_t dense_size = dense_input_tensorbag_.num_elements();
+  size_t dense_size = dense_input_tensorbag.num_elements();
   if (inference_params_.use_mixed_precision) {
     convert_array_on_device(
-        dense_input_tensorbag_.data<__half>(), d_dense, dense_size,
+        dense_input_tensorbag.data<__half>(), d_dense, dense_size,
         resource_manager_->get_local_gpu_from_device_id(inference_params_.device_id)->get_stream());
 
   } else {
     convert_array_on_device(
-        dense_input_tensorbag_.data<float>(), d_dense, dense_size,
+        dense_input_tensorbag.data<float>(), d_dense, dense_size,
         resource_manager_->get_local_gpu_from_device_id(inference_params_.device_id)->get_stream());
   }
 
@@ -191,40 +351,48 @@ void InferenceSession::predict_impl(float* d_dense, void* keys, bool key_on_devi
   acc_row_ptrs_offset = 0;
   for (size_t i = 0; i < num_embedding_tables; ++i) {
     // bind row ptrs input to row ptrs tensor
-    (*row_ptrs_tensors_[i]) =
-        core23::Tensor::bind(d_row_ptrs + acc_row_ptrs_offset, row_ptrs_tensors_[i]->shape(),
-                             row_ptrs_tensors_[i]->data_type(), row_ptrs_tensors_[i]->device());
-    acc_row_ptrs_offset += num_samples * inference_parser_.slot_num_for_tables[i] + 1;
+    (*row_ptrs_tensors[i]) =
+        core23::Tensor::bind(d_row_ptrs + acc_row_ptrs_offset, row_ptrs_tensors[i]->shape(),
+                             row_ptrs_tensors[i]->data_type(), row_ptrs_tensors[i]->device());
+    acc_row_ptrs_offset += row_ptrs_batch_size * inference_parser_.slot_num_for_tables[i] + 1;
 
     // bind embedding vectors from looking up to embedding features tensor
-    (*embedding_features_tensors_[i]) = core23::Tensor::bind(
-        d_embedding_vectors_ + acc_vectors_offset, embedding_features_tensors_[i]->shape(),
-        embedding_features_tensors_[i]->data_type(), embedding_features_tensors_[i]->device());
+    (*embedding_features_tensors[i]) = core23::Tensor::bind(
+        d_embedding_vectors_ + acc_vectors_offset, embedding_features_tensors[i]->shape(),
+        embedding_features_tensors[i]->data_type(), embedding_features_tensors[i]->device());
     acc_vectors_offset += inference_params_.max_batchsize *
                           inference_parser_.max_feature_num_for_tables[i] *
                           inference_parser_.embed_vec_size_for_tables[i];
     // feature combiner feedforward
-    embedding_feature_combiners_[i]->fprop(false);
+    embedding_feature_combiners[i]->fprop(false);
+  }
+
+  if (tensorrt_network_) {
+    cudaStream_t stream =
+        resource_manager_->get_local_gpu_from_device_id(inference_params_.device_id)->get_stream();
+    tensorrt_network_->predict(tensorrt_inputs_, d_output, num_samples, stream);
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    return;
   }
 
   // dense network feedforward
 
   if (inference_params_.use_cuda_graph) {
-    predict_network_pipeline_.run_graph();
+    predict_network_pipeline.run_graph();
   } else {
-    predict_network_pipeline_.run();
+    predict_network_pipeline.run();
   }
 
   // convert the prediction result to output
   if (inference_params_.use_mixed_precision) {
     convert_array_on_device(
-        d_output, network_->get_pred_tensor_half().get_ptr(),
-        network_->get_pred_tensor_half().get_num_elements(),
+        d_output, network.get_pred_tensor_half().get_ptr(),
+        network.get_pred_tensor_half().get_num_elements(),
         resource_manager_->get_local_gpu_from_device_id(inference_params_.device_id)->get_stream());
   } else {
     convert_array_on_device(
-        d_output, network_->get_pred_tensor().get_ptr(),
-        network_->get_pred_tensor().get_num_elements(),
+        d_output, network.get_pred_tensor().get_ptr(),
+        network.get_pred_tensor().get_num_elements(),
         resource_manager_->get_local_gpu_from_device_id(inference_params_.device_id)->get_stream());
   }
   HCTR_LIB_THROW(cudaStreamSynchronize(
@@ -233,6 +401,32 @@ void InferenceSession::predict_impl(float* d_dense, void* keys, bool key_on_devi
 
 void InferenceSession::predict(float* d_dense, void* h_embeddingcolumns, int* d_row_ptrs,
                                float* d_output, int num_samples, bool table_major_key_layout) {
+  if (inference_params_.micro_batching_window_us == 0) {
+    predict_from_host_(d_dense, h_embeddingcolumns, d_row_ptrs, d_output, num_samples,
+                       table_major_key_layout);
+    return;
+  }
+  PendingRequest request{d_dense, h_embeddingcolumns, false, d_row_ptrs, d_output, num_samples,
+                         table_major_key_layout, std::chrono::steady_clock::now()};
+  predict_batched_(request);
+}
+
+void InferenceSession::predict_from_device(float* d_dense, void* d_embeddingcolumns,
+                                           int* d_row_ptrs, float* d_output, int num_samples,
+                                           bool table_major_key_layout) {
+  if (inference_params_.micro_batching_window_us == 0) {
+    predict_from_device_(d_dense, d_embeddingcolumns, d_row_ptrs, d_output, num_samples,
+                         table_major_key_layout);
+    return;
+  }
+  PendingRequest request{d_dense, d_embeddingcolumns, true, d_row_ptrs, d_output, num_samples,
+                         table_major_key_layout, std::chrono::steady_clock::now()};
+  predict_batched_(request);
+}
+
+void InferenceSession::predict_from_host_(float* d_dense, void* h_embeddingcolumns,
+                                          int* d_row_ptrs, float* d_output, int num_samples,
+                                          bool table_major_key_layout) {
   size_t num_embedding_tables = inference_parser_.num_embedding_tables;
   if (num_embedding_tables != row_ptrs_tensors_.size() ||
       num_embedding_tables != embedding_features_tensors_.size() ||
@@ -264,9 +458,9 @@ void InferenceSession::predict(float* d_dense, void* h_embeddingcolumns, int* d_
                num_embedding_tables, table_major_key_layout);
 }
 
-void InferenceSession::predict_from_device(float* d_dense, void* d_embeddingcolumns,
-                                           int* d_row_ptrs, float* d_output, int num_samples,
-                                           bool table_major_key_layout) {
+void InferenceSession::predict_from_device_(float* d_dense, void* d_embeddingcolumns,
+                                            int* d_row_ptrs, float* d_output, int num_samples,
+                                            bool table_major_key_layout) {
   size_t num_embedding_tables = inference_parser_.num_embedding_tables;
   if (num_embedding_tables != row_ptrs_tensors_.size() ||
       num_embedding_tables != embedding_features_tensors_.size() ||
@@ -307,4 +501,196 @@ void InferenceSession::predict_from_device(float* d_dense, void* d_embeddingcolu
                num_embedding_tables, table_major_key_layout);
 }
 
+void InferenceSession::predict_batched_(PendingRequest& request) {
+  if (request.num_samples > static_cast<int>(inference_params_.max_batchsize)) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "The number of samples exceeds max_batchsize.");
+  }
+  const size_t max_batchsize = inference_params_.max_batchsize;
+  const auto window = std::chrono::microseconds(inference_params_.micro_batching_window_us);
+
+  std::unique_lock<std::mutex> lock(batch_mutex_);
+  pending_requests_.push_back(&request);
+  batch_cv_.notify_all();
+  while (!request.done) {
+    if (batch_in_flight_) {
+      batch_cv_.wait(lock);
+      continue;
+    }
+    batch_in_flight_ = true;
+
+    // Wait for more requests until the window of the oldest request closes or a batch is full.
+    batch_cv_.wait_until(lock, pending_requests_.front()->arrival_time + window, [&] {
+      size_t num_samples = 0;
+      for (const PendingRequest* const pending : pending_requests_) {
+        num_samples += pending->num_samples;
+      }
+      return num_samples >= max_batchsize;
+    });
+
+    // Take the oldest requests that fit into one batch, and share the key location and layout.
+    const bool key_on_device = pending_requests_.front()->key_on_device;
+    const bool table_major_key_layout = pending_requests_.front()->table_major_key_layout;
+    std::vector<PendingRequest*> batch;
+    size_t num_samples = 0;
+    for (auto it = pending_requests_.begin(); it != pending_requests_.end();) {
+      PendingRequest* const pending = *it;
+      if (pending->key_on_device == key_on_device &&
+          pending->table_major_key_layout == table_major_key_layout &&
+          num_samples + pending->num_samples <= max_batchsize) {
+        num_samples += pending->num_samples;
+        batch.push_back(pending);
+        it = pending_requests_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      run_micro_batch_(batch);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+
+    for (PendingRequest* const pending : batch) {
+      pending->error = error;
+      pending->done = true;
+    }
+    batch_in_flight_ = false;
+    batch_cv_.notify_all();
+  }
+  lock.unlock();
+
+  if (request.error) {
+    std::rethrow_exception(request.error);
+  }
+}
+
+void InferenceSession::run_micro_batch_(const std::vector<PendingRequest*>& requests) {
+  const PendingRequest& first = *requests.front();
+  if (requests.size() == 1) {
+    if (first.key_on_device) {
+      predict_from_device_(first.d_dense, first.keys, first.d_row_ptrs, first.d_output,
+                           first.num_samples, first.table_major_key_layout);
+    } else {
+      predict_from_host_(first.d_dense, first.keys, first.d_row_ptrs, first.d_output,
+                         first.num_samples, first.table_major_key_layout);
+    }
+    return;
+  }
+
+  CudaDeviceContext context(
+      resource_manager_->get_local_gpu_from_device_id(inference_params_.device_id)
+          ->get_device_id());
+  cudaStream_t stream =
+      resource_manager_->get_local_gpu_from_device_id(inference_params_.device_id)->get_stream();
+  const size_t num_tables = inference_parser_.num_embedding_tables;
+  const auto& slot_num_for_tables = inference_parser_.slot_num_for_tables;
+  const size_t key_size =
+      inference_params_.i64_input_key ? sizeof(long long) : sizeof(unsigned int);
+
+  // Copy the row pointers of all requests to host.
+  std::vector<std::vector<int>> row_ptrs(requests.size());
+  for (size_t r = 0; r < requests.size(); ++r) {
+    row_ptrs[r].resize(requests[r]->num_samples * inference_parser_.slot_num + num_tables);
+    HCTR_LIB_THROW(cudaMemcpyAsync(row_ptrs[r].data(), requests[r]->d_row_ptrs,
+                                   row_ptrs[r].size() * sizeof(int), cudaMemcpyDeviceToHost,
+                                   stream));
+  }
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  // Locate the row pointers and keys of each table in each request.
+  std::vector<std::vector<size_t>> row_ptrs_offset(requests.size());
+  std::vector<std::vector<size_t>> keys_offset(requests.size());
+  int num_samples = 0;
+  for (size_t r = 0; r < requests.size(); ++r) {
+    row_ptrs_offset[r].resize(num_tables + 1, 0);
+    keys_offset[r].resize(num_tables + 1, 0);
+    for (size_t t = 0; t < num_tables; ++t) {
+      const size_t num_rows = requests[r]->num_samples * slot_num_for_tables[t];
+      row_ptrs_offset[r][t + 1] = row_ptrs_offset[r][t] + num_rows + 1;
+      keys_offset[r][t + 1] = keys_offset[r][t] + row_ptrs[r][row_ptrs_offset[r][t] + num_rows];
+    }
+    num_samples += requests[r]->num_samples;
+  }
+
+  // Concatenate the rows of each table.
+  std::vector<int> batch_row_ptrs;
+  batch_row_ptrs.reserve(num_samples * inference_parser_.slot_num + num_tables);
+  for (size_t t = 0; t < num_tables; ++t) {
+    int num_keys = 0;
+    for (size_t r = 0; r < requests.size(); ++r) {
+      const size_t num_rows = requests[r]->num_samples * slot_num_for_tables[t];
+      const int* const table_row_ptrs = row_ptrs[r].data() + row_ptrs_offset[r][t];
+      for (size_t i = 0; i < num_rows; ++i) {
+        batch_row_ptrs.push_back(num_keys + table_row_ptrs[i]);
+      }
+      num_keys += table_row_ptrs[num_rows];
+    }
+    batch_row_ptrs.push_back(num_keys);
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(d_batch_row_ptrs_, batch_row_ptrs.data(),
+                                 batch_row_ptrs.size() * sizeof(int), cudaMemcpyHostToDevice,
+                                 stream));
+
+  // Concatenate the keys. The keys of sample-major requests follow each other, while those of
+  // table-major requests are concatenated per table.
+  void* const batch_keys = first.key_on_device ? d_batch_keys_ : h_batch_keys_;
+  size_t num_batch_keys = 0;
+  const auto append_keys = [&](const PendingRequest& request, size_t begin, size_t end) {
+    char* const dst = static_cast<char*>(batch_keys) + num_batch_keys * key_size;
+    const char* const src = static_cast<const char*>(request.keys) + begin * key_size;
+    if (request.key_on_device) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(dst, src, (end - begin) * key_size,
+                                     cudaMemcpyDeviceToDevice, stream));
+    } else {
+      memcpy(dst, src, (end - begin) * key_size);
+    }
+    num_batch_keys += end - begin;
+  };
+  if (first.table_major_key_layout) {
+    for (size_t t = 0; t < num_tables; ++t) {
+      for (size_t r = 0; r < requests.size(); ++r) {
+        append_keys(*requests[r], keys_offset[r][t], keys_offset[r][t + 1]);
+      }
+    }
+  } else {
+    for (size_t r = 0; r < requests.size(); ++r) {
+      append_keys(*requests[r], 0, keys_offset[r][num_tables]);
+    }
+  }
+
+  // Concatenate the dense features.
+  const size_t dense_dim = inference_parser_.dense_dim;
+  size_t sample_offset = 0;
+  for (const PendingRequest* const request : requests) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_batch_dense_ + sample_offset * dense_dim, request->d_dense,
+                                   request->num_samples * dense_dim * sizeof(float),
+                                   cudaMemcpyDeviceToDevice, stream));
+    sample_offset += request->num_samples;
+  }
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  if (first.key_on_device) {
+    predict_from_device_(d_batch_dense_, batch_keys, d_batch_row_ptrs_, d_batch_output_,
+                         num_samples, first.table_major_key_layout);
+  } else {
+    predict_from_host_(d_batch_dense_, batch_keys, d_batch_row_ptrs_, d_batch_output_, num_samples,
+                       first.table_major_key_layout);
+  }
+
+  // Scatter the predictions to the callers.
+  const size_t label_dim = inference_parser_.label_dim;
+  sample_offset = 0;
+  for (const PendingRequest* const request : requests) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(request->d_output, d_batch_output_ + sample_offset * label_dim,
+                                   request->num_samples * label_dim * sizeof(float),
+                                   cudaMemcpyDeviceToDevice, stream));
+    sample_offset += request->num_samples;
+  }
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
 }  // namespace HugeCTR
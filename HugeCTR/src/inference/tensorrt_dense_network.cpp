@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core23/logger.hpp>
+#include <inference/tensorrt_dense_network.hpp>
+#include <utils.hpp>
+
+#ifdef ENABLE_TENSORRT
+#include <NvInfer.h>
+#include <NvOnnxParser.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace HugeCTR {
+
+#ifdef ENABLE_TENSORRT
+
+namespace {
+
+class Logger : public nvinfer1::ILogger {
+ public:
+  void log(const Severity severity, const char* const msg) noexcept override {
+    switch (severity) {
+      case Severity::kINTERNAL_ERROR:
+      case Severity::kERROR:
+        HCTR_LOG_S(ERROR, WORLD) << "TensorRT: " << msg << std::endl;
+        break;
+      case Severity::kWARNING:
+        HCTR_LOG_S(WARNING, WORLD) << "TensorRT: " << msg << std::endl;
+        break;
+      default:
+        break;
+    }
+  }
+};
+
+Logger& logger() {
+  static Logger logger;
+  return logger;
+}
+
+// Returns the engine file, or nothing if it doesn't exist or is older than the ONNX model.
+std::vector<char> read_engine_file(const std::string& engine_file, const std::string& onnx_file) {
+  std::error_code ec;
+  if (engine_file.empty() || !std::filesystem::exists(engine_file, ec)) {
+    return {};
+  }
+  // Without the ONNX model, its time is the minimum, and the engine is used as it is.
+  if (std::filesystem::last_write_time(engine_file, ec) <
+      std::filesystem::last_write_time(onnx_file, ec)) {
+    return {};
+  }
+  std::ifstream in(engine_file, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void write_engine_file(const std::string& engine_file, const nvinfer1::IHostMemory& engine) {
+  // Concurrent sessions can write the same file, so it is replaced atomically.
+  const std::string tmp_file = engine_file + ".tmp";
+  std::ofstream out(tmp_file, std::ios::binary | std::ios::trunc);
+  out.write(static_cast<const char*>(engine.data()), static_cast<std::streamsize>(engine.size()));
+  out.close();
+  if (!out || std::rename(tmp_file.c_str(), engine_file.c_str()) != 0) {
+    HCTR_LOG_S(WARNING, ROOT) << "Cannot write the TensorRT engine " << engine_file << std::endl;
+  }
+}
+
+std::unique_ptr<nvinfer1::IHostMemory> build_engine(const std::string& onnx_file,
+                                                   const size_t max_batchsize,
+                                                   const bool half_inputs) {
+  std::unique_ptr<nvinfer1::IBuilder> builder{nvinfer1::createInferBuilder(logger())};
+  HCTR_THROW_IF(!builder, Error_t::UnspecificError, "Cannot create the TensorRT builder");
+  const uint32_t flags{
+      1U << static_cast<uint32_t>(nvinfer1::NetworkDefinitionCreationFlag::kEXPLICIT_BATCH)};
+  std::unique_ptr<nvinfer1::INetworkDefinition> network{builder->createNetworkV2(flags)};
+  std::unique_ptr<nvonnxparser::IParser> parser{nvonnxparser::createParser(*network, logger())};
+  if (!parser->parseFromFile(onnx_file.c_str(),
+                             static_cast<int32_t>(nvinfer1::ILogger::Severity::kWARNING))) {
+    std::string errors;
+    for (int32_t i = 0; i < parser->getNbErrors(); ++i) {
+      errors += std::string("\n") + parser->getError(i)->desc();
+    }
+    HCTR_OWN_THROW(Error_t::WrongInput, "Cannot parse the ONNX model ", onnx_file, ":", errors);
+  }
+
+  std::unique_ptr<nvinfer1::IBuilderConfig> config{builder->createBuilderConfig()};
+  nvinfer1::IOptimizationProfile* const profile{builder->createOptimizationProfile()};
+  for (int32_t i = 0; i < network->getNbInputs(); ++i) {
+    nvinfer1::ITensor* const input{network->getInput(i)};
+    nvinfer1::Dims dims{input->getDimensions()};
+    HCTR_THROW_IF(dims.nbDims < 1, Error_t::WrongInput, "Input ", input->getName(),
+                  " of the ONNX model has no batch dimension");
+    for (int32_t d = 1; d < dims.nbDims; ++d) {
+      HCTR_THROW_IF(dims.d[d] < 0, Error_t::WrongInput, "Only the batch dimension of input ",
+                    input->getName(), " of the ONNX model may be dynamic");
+    }
+    dims.d[0] = 1;
+    profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims);
+    dims.d[0] = static_cast<int32_t>(max_batchsize);
+    profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims);
+    profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims);
+    if (half_inputs) {
+      input->setType(nvinfer1::DataType::kHALF);
+    }
+  }
+  config->addOptimizationProfile(profile);
+  if (half_inputs) {
+    config->setFlag(nvinfer1::BuilderFlag::kFP16);
+  }
+
+  std::unique_ptr<nvinfer1::IHostMemory> engine{builder->buildSerializedNetwork(*network, *config)};
+  HCTR_THROW_IF(!engine, Error_t::UnspecificError, "Cannot build the TensorRT engine of ",
+                onnx_file);
+  return engine;
+}
+
+}  // namespace
+
+struct TensorRTDenseNetwork::Impl {
+  struct Output {
+    std::string name;
+    size_t dim;
+    float* d_buffer{nullptr};  // Only with several outputs, which are interleaved into d_output.
+  };
+
+  int device_id;
+  size_t max_batchsize;
+  std::unique_ptr<nvinfer1::IRuntime> runtime;
+  std::unique_ptr<nvinfer1::ICudaEngine> engine;
+  std::unique_ptr<nvinfer1::IExecutionContext> context;
+  std::vector<std::string> input_names;
+  std::vector<Output> outputs;
+  size_t output_dim{0};
+
+  // Whether an engine can run the batches and inputs of this session.
+  bool is_compatible(const bool half_inputs) const {
+    const nvinfer1::DataType input_type{half_inputs ? nvinfer1::DataType::kHALF
+                                                     : nvinfer1::DataType::kFLOAT};
+    for (int32_t i = 0; i < engine->getNbIOTensors(); ++i) {
+      const char* const name{engine->getIOTensorName(i)};
+      if (engine->getTensorIOMode(name) != nvinfer1::TensorIOMode::kINPUT) {
+        continue;
+      }
+      if (engine->getTensorDataType(name) != input_type ||
+          engine->getProfileShape(name, 0, nvinfer1::OptProfileSelector::kMAX).d[0] <
+              static_cast<int32_t>(max_batchsize)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+TensorRTDenseNetwork::TensorRTDenseNetwork(const std::string& onnx_file,
+                                           const std::string& engine_file,
+                                           const size_t max_batchsize, const bool half_inputs,
+                                           const int device_id)
+    : impl_(std::make_unique<Impl>()) {
+  CudaDeviceContext context(device_id);
+  impl_->device_id = device_id;
+  impl_->max_batchsize = max_batchsize;
+  impl_->runtime.reset(nvinfer1::createInferRuntime(logger()));
+  HCTR_THROW_IF(!impl_->runtime, Error_t::UnspecificError, "Cannot create the TensorRT runtime");
+
+  const std::vector<char> cached_engine{read_engine_file(engine_file, onnx_file)};
+  if (!cached_engine.empty()) {
+    impl_->engine.reset(
+        impl_->runtime->deserializeCudaEngine(cached_engine.data(), cached_engine.size()));
+    if (impl_->engine && !impl_->is_compatible(half_inputs)) {
+      impl_->engine.reset();
+    }
+    if (impl_->engine) {
+      HCTR_LOG_S(INFO, ROOT) << "Loaded the TensorRT engine " << engine_file << std::endl;
+    } else {
+      HCTR_LOG_S(WARNING, ROOT) << "The TensorRT engine " << engine_file
+                                << " does not fit this TensorRT version, GPU or session, and is "
+                                   "built again"
+                                << std::endl;
+    }
+  }
+  if (!impl_->engine) {
+    HCTR_LOG_S(INFO, ROOT) << "Build the TensorRT engine of " << onnx_file << std::endl;
+    const std::unique_ptr<nvinfer1::IHostMemory> serialized_engine{
+        build_engine(onnx_file, max_batchsize, half_inputs)};
+    impl_->engine.reset(
+        impl_->runtime->deserializeCudaEngine(serialized_engine->data(), serialized_engine->size()));
+    HCTR_THROW_IF(!impl_->engine, Error_t::UnspecificError, "Cannot load the TensorRT engine of ",
+                  onnx_file);
+    if (!engine_file.empty()) {
+      write_engine_file(engine_file, *serialized_engine);
+    }
+  }
+
+  for (int32_t i = 0; i < impl_->engine->getNbIOTensors(); ++i) {
+    const char* const name{impl_->engine->getIOTensorName(i)};
+    if (impl_->engine->getTensorIOMode(name) == nvinfer1::TensorIOMode::kINPUT) {
+      impl_->input_names.emplace_back(name);
+      continue;
+    }
+    const nvinfer1::Dims dims{impl_->engine->getTensorShape(name)};
+    HCTR_THROW_IF(impl_->engine->getTensorDataType(name) != nvinfer1::DataType::kFLOAT ||
+                      dims.nbDims != 2 || dims.d[1] < 0,
+                  Error_t::WrongInput, "Output ", name,
+                  " of the TensorRT engine must be float predictions of shape [batch, labels]");
+    impl_->outputs.push_back({name, static_cast<size_t>(dims.d[1])});
+    impl_->output_dim += static_cast<size_t>(dims.d[1]);
+  }
+  HCTR_THROW_IF(impl_->outputs.empty(), Error_t::WrongInput,
+                "The TensorRT engine has no outputs");
+  if (impl_->outputs.size() > 1) {
+    for (Impl::Output& output : impl_->outputs) {
+      HCTR_LIB_THROW(cudaMalloc(&output.d_buffer, sizeof(float) * max_batchsize * output.dim));
+    }
+  }
+  impl_->context.reset(impl_->engine->createExecutionContext());
+  HCTR_THROW_IF(!impl_->context, Error_t::UnspecificError,
+                "Cannot create the TensorRT execution context");
+}
+
+TensorRTDenseNetwork::~TensorRTDenseNetwork() {
+  CudaDeviceContext context(impl_->device_id);
+  for (const Impl::Output& output : impl_->outputs) {
+    HCTR_LIB_CHECK_(cudaFree(output.d_buffer));
+  }
+}
+
+const std::vector<std::string>& TensorRTDenseNetwork::input_names() const {
+  return impl_->input_names;
+}
+
+void TensorRTDenseNetwork::predict(const std::vector<const void*>& inputs, float* const d_output,
+                                   const size_t num_samples, cudaStream_t stream) {
+  HCTR_THROW_IF(inputs.size() != impl_->input_names.size(), Error_t::WrongInput,
+                "The TensorRT engine has ", impl_->input_names.size(), " inputs, but got ",
+                inputs.size());
+  HCTR_THROW_IF(num_samples > impl_->max_batchsize, Error_t::WrongInput, "Cannot predict ",
+                num_samples, " samples, which is more than the max_batchsize ",
+                impl_->max_batchsize);
+  nvinfer1::IExecutionContext& context{*impl_->context};
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const char* const name{impl_->input_names[i].c_str()};
+    nvinfer1::Dims dims{impl_->engine->getTensorShape(name)};
+    dims.d[0] = static_cast<int32_t>(num_samples);
+    HCTR_THROW_IF(!context.setInputShape(name, dims) ||
+                      !context.setTensorAddress(name, const_cast<void*>(inputs[i])),
+                  Error_t::WrongInput, "Cannot bind input ", name, " of the TensorRT engine");
+  }
+  for (const Impl::Output& output : impl_->outputs) {
+    float* const d_buffer{output.d_buffer ? output.d_buffer : d_output};
+    HCTR_THROW_IF(!context.setTensorAddress(output.name.c_str(), d_buffer), Error_t::WrongInput,
+                  "Cannot bind output ", output.name, " of the TensorRT engine");
+  }
+  HCTR_THROW_IF(!context.enqueueV3(stream), Error_t::UnspecificError,
+                "Cannot run the TensorRT engine");
+
+  // The predictions of a sample are next to each other, as those of the HugeCTR network.
+  size_t offset{0};
+  for (const Impl::Output& output : impl_->outputs) {
+    if (output.d_buffer) {
+      HCTR_LIB_THROW(cudaMemcpy2DAsync(d_output + offset, sizeof(float) * impl_->output_dim,
+                                       output.d_buffer, sizeof(float) * output.dim,
+                                       sizeof(float) * output.dim, num_samples,
+                                       cudaMemcpyDeviceToDevice, stream));
+    }
+    offset += output.dim;
+  }
+}
+
+#else
+
+struct TensorRTDenseNetwork::Impl {};
+
+TensorRTDenseNetwork::TensorRTDenseNetwork(const std::string&, const std::string&, size_t, bool,
+                                           int) {
+  HCTR_OWN_THROW(Error_t::WrongInput,
+                 "Please install TensorRT and compile HugeCTR with ENABLE_TENSORRT to run the "
+                 "dense network with TensorRT.");
+}
+
+TensorRTDenseNetwork::~TensorRTDenseNetwork() = default;
+
+const std::vector<std::string>& TensorRTDenseNetwork::input_names() const {
+  static const std::vector<std::string> input_names;
+  return input_names;
+}
+
+void TensorRTDenseNetwork::predict(const std::vector<const void*>&, float*, size_t,
+                                   cudaStream_t) {}
+
+#endif
+
+}  // namespace HugeCTR
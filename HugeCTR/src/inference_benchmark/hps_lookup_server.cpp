@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <signal.h>
+
+#include <argparse/argparse.hpp>
+#include <hps/hier_parameter_server.hpp>
+#include <hps/inference_utils.hpp>
+#include <hps/lookup_server.hpp>
+#include <hps/lookup_session.hpp>
+#include <iostream>
+#include <thread>
+
+using namespace HugeCTR;
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args("HPS_Lookup_Server");
+
+  args.add_argument("--config")
+      .help("The path of the HPS json configuration file")
+      .required()
+      .action([](const std::string& value) { return value; });
+
+  args.add_argument("--model")
+      .help("The name of the model to serve. Defaults to the first model of the configuration")
+      .default_value(std::string())
+      .action([](const std::string& value) { return value; });
+
+  args.add_argument("--port")
+      .help("The TCP port to listen on")
+      .default_value(9500)
+      .action([](const std::string& value) { return std::stoi(value); });
+
+  args.add_argument("--max_batch_delay_us")
+      .help("How long a lookup waits for the lookups of other clients to join its batch")
+      .default_value(100)
+      .action([](const std::string& value) { return std::stoi(value); });
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cout << err.what() << std::endl;
+    std::cout << args;
+    exit(1);
+  }
+
+  // Handle SIGINT and SIGTERM in a dedicated thread, which can then shut the server down safely.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  parameter_server_config ps_config{args.get<std::string>("--config")};
+  const auto parameter_server = HierParameterServerBase::create(ps_config);
+
+  std::string model_name = args.get<std::string>("--model");
+  if (model_name.empty()) {
+    model_name = ps_config.inference_params_array.at(0).model_name;
+  }
+  std::vector<std::shared_ptr<BatchedLookupSession>> sessions;
+  for (auto inference_params : ps_config.inference_params_array) {
+    if (inference_params.model_name != model_name) {
+      continue;
+    }
+    for (const auto& device_id : inference_params.deployed_devices) {
+      inference_params.device_id = device_id;
+      auto embedding_cache = parameter_server->get_embedding_cache(model_name, device_id);
+      sessions.emplace_back(std::make_shared<BatchedLookupSession>(
+          LookupSessionBase::create(inference_params, embedding_cache),
+          std::chrono::microseconds(args.get<int>("--max_batch_delay_us"))));
+    }
+  }
+  if (sessions.empty()) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "The model ", model_name, " does not exist in HPS.");
+  }
+
+  LookupServer server(sessions, static_cast<uint16_t>(args.get<int>("--port")));
+  std::thread signal_thread([&server, signals]() {
+    int signal;
+    sigwait(&signals, &signal);
+    server.shutdown();
+  });
+  server.serve();
+  signal_thread.join();
+  return 0;
+}
@@ -187,7 +187,8 @@ void HPS_Metrics::initialize() {
 }
 
 void HPS_Metrics::refresh_async(int iteration) {
-  refresh_thread_->submit([this, iteration]() { refresh_embeddingcache(iteration); });
+  refresh_thread_->submit([this, iteration]() { refresh_embeddingcache(iteration); },
+                          ThreadPool::Priority::Background);
 }
 
 void HPS_Metrics::refresh_embeddingcache(int iteration) {
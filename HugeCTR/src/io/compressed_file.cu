@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_runtime_api.h>
+
+#include <algorithm>
+#include <common.hpp>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <exception>
+#include <io/compressed_file.hpp>
+#ifdef ENABLE_NVCOMP
+#include <nvcomp/bitcomp.h>
+#include <nvcomp/lz4.h>
+#include <nvcomp/zstd.h>
+#endif
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr uint64_t compressed_file_magic = 0x4547415052544348ull;  // "HCTRPAGE"
+constexpr size_t page_alignment = 8;
+// Pages compressed or decompressed at the same time, which bounds the gpu memory of a call.
+constexpr size_t max_pages_per_batch = 1024;
+
+struct CompressedFileHead {
+  uint64_t magic;
+  uint32_t codec;
+  uint32_t max_page_bytes;
+  uint64_t num_pages;
+};
+
+size_t align_page(size_t bytes) {
+  return (bytes + page_alignment - 1) / page_alignment * page_alignment;
+}
+
+#ifdef ENABLE_NVCOMP
+
+void check_nvcomp(nvcompStatus_t status, const char* what) {
+  if (status != nvcompSuccess) {
+    HCTR_OWN_THROW(Error_t::UnspecificError,
+                   std::string(what) + " failed with nvCOMP status " + std::to_string(status));
+  }
+}
+
+// Device memory of one call, released when it returns or throws.
+class DeviceBuffer {
+ public:
+  explicit DeviceBuffer(size_t bytes) {
+    if (bytes > 0) {
+      HCTR_LIB_THROW(cudaMalloc(&ptr_, bytes));
+    }
+  }
+  DeviceBuffer(const DeviceBuffer&) = delete;
+  DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+  ~DeviceBuffer() { cudaFree(ptr_); }
+
+  template <typename T>
+  T* get() const {
+    return static_cast<T*>(ptr_);
+  }
+
+ private:
+  void* ptr_ = nullptr;
+};
+
+// A stream of one call, so that calls of several threads run at the same time.
+class Stream {
+ public:
+  Stream() { HCTR_LIB_THROW(cudaStreamCreateWithFlags(&stream_, cudaStreamNonBlocking)); }
+  Stream(const Stream&) = delete;
+  Stream& operator=(const Stream&) = delete;
+  ~Stream() { cudaStreamDestroy(stream_); }
+
+  operator cudaStream_t() const { return stream_; }
+
+ private:
+  cudaStream_t stream_;
+};
+
+// Bitcomp compresses the floats of the weights best as 32 bit words.
+nvcompBatchedBitcompFormatOpts get_bitcomp_opts() { return {0, NVCOMP_TYPE_UINT}; }
+
+size_t get_compress_temp_bytes(CompressionCodec codec, size_t num_pages, size_t max_page_bytes) {
+  size_t temp_bytes = 0;
+  switch (codec) {
+    case CompressionCodec::LZ4:
+      check_nvcomp(nvcompBatchedLZ4CompressGetTempSize(num_pages, max_page_bytes,
+                                                       nvcompBatchedLZ4DefaultOpts, &temp_bytes),
+                   "nvcompBatchedLZ4CompressGetTempSize");
+      break;
+    case CompressionCodec::Zstd:
+      check_nvcomp(nvcompBatchedZstdCompressGetTempSize(num_pages, max_page_bytes,
+                                                        nvcompBatchedZstdDefaultOpts, &temp_bytes),
+                   "nvcompBatchedZstdCompressGetTempSize");
+      break;
+    case CompressionCodec::Bitcomp:
+      check_nvcomp(nvcompBatchedBitcompCompressGetTempSize(num_pages, max_page_bytes,
+                                                           get_bitcomp_opts(), &temp_bytes),
+                   "nvcompBatchedBitcompCompressGetTempSize");
+      break;
+    default:
+      HCTR_OWN_THROW(Error_t::WrongInput, "Unknown compression codec");
+  }
+  return temp_bytes;
+}
+
+size_t get_max_compressed_page_bytes(CompressionCodec codec, size_t max_page_bytes) {
+  size_t max_bytes = 0;
+  switch (codec) {
+    case CompressionCodec::LZ4:
+      check_nvcomp(nvcompBatchedLZ4CompressGetMaxOutputChunkSize(
+                       max_page_bytes, nvcompBatchedLZ4DefaultOpts, &max_bytes),
+                   "nvcompBatchedLZ4CompressGetMaxOutputChunkSize");
+      break;
+    case CompressionCodec::Zstd:
+      check_nvcomp(nvcompBatchedZstdCompressGetMaxOutputChunkSize(
+                       max_page_bytes, nvcompBatchedZstdDefaultOpts, &max_bytes),
+                   "nvcompBatchedZstdCompressGetMaxOutputChunkSize");
+      break;
+    case CompressionCodec::Bitcomp:
+      check_nvcomp(nvcompBatchedBitcompCompressGetMaxOutputChunkSize(
+                       max_page_bytes, get_bitcomp_opts(), &max_bytes),
+                   "nvcompBatchedBitcompCompressGetMaxOutputChunkSize");
+      break;
+    default:
+      HCTR_OWN_THROW(Error_t::WrongInput, "Unknown compression codec");
+  }
+  return max_bytes;
+}
+
+void compress_async(CompressionCodec codec, const void* const* uncompressed_ptrs,
+                    const size_t* uncompressed_bytes, size_t max_page_bytes, size_t num_pages,
+                    void* temp, size_t temp_bytes, void* const* compressed_ptrs,
+                    size_t* compressed_bytes, cudaStream_t stream) {
+  switch (codec) {
+    case CompressionCodec::LZ4:
+      check_nvcomp(nvcompBatchedLZ4CompressAsync(uncompressed_ptrs, uncompressed_bytes,
+                                                 max_page_bytes, num_pages, temp, temp_bytes,
+                                                 compressed_ptrs, compressed_bytes,
+                                                 nvcompBatchedLZ4DefaultOpts, stream),
+                   "nvcompBatchedLZ4CompressAsync");
+      break;
+    case CompressionCodec::Zstd:
+      check_nvcomp(nvcompBatchedZstdCompressAsync(uncompressed_ptrs, uncompressed_bytes,
+                                                  max_page_bytes, num_pages, temp, temp_bytes,
+                                                  compressed_ptrs, compressed_bytes,
+                                                  nvcompBatchedZstdDefaultOpts, stream),
+                   "nvcompBatchedZstdCompressAsync");
+      break;
+    case CompressionCodec::Bitcomp:
+      check_nvcomp(nvcompBatchedBitcompCompressAsync(uncompressed_ptrs, uncompressed_bytes,
+                                                     max_page_bytes, num_pages, temp, temp_bytes,
+                                                     compressed_ptrs, compressed_bytes,
+                                                     get_bitcomp_opts(), stream),
+                   "nvcompBatchedBitcompCompressAsync");
+      break;
+    default:
+      HCTR_OWN_THROW(Error_t::WrongInput, "Unknown compression codec");
+  }
+}
+
+size_t get_decompress_temp_bytes(CompressionCodec codec, size_t num_pages, size_t max_page_bytes) {
+  size_t temp_bytes = 0;
+  switch (codec) {
+    case CompressionCodec::LZ4:
+      check_nvcomp(nvcompBatchedLZ4DecompressGetTempSize(num_pages, max_page_bytes, &temp_bytes),
+                   "nvcompBatchedLZ4DecompressGetTempSize");
+      break;
+    case CompressionCodec::Zstd:
+      check_nvcomp(nvcompBatchedZstdDecompressGetTempSize(num_pages, max_page_bytes, &temp_bytes),
+                   "nvcompBatchedZstdDecompressGetTempSize");
+      break;
+    case CompressionCodec::Bitcomp:
+      check_nvcomp(
+          nvcompBatchedBitcompDecompressGetTempSize(num_pages, max_page_bytes, &temp_bytes),
+          "nvcompBatchedBitcompDecompressGetTempSize");
+      break;
+    default:
+      HCTR_OWN_THROW(Error_t::WrongInput, "Unknown compression codec");
+  }
+  return temp_bytes;
+}
+
+void decompress_async(CompressionCodec codec, const void* const* compressed_ptrs,
+                      const size_t* compressed_bytes, const size_t* uncompressed_bytes,
+                      size_t* actual_uncompressed_bytes, size_t num_pages, void* temp,
+                      size_t temp_bytes, void* const* uncompressed_ptrs, nvcompStatus_t* statuses,
+                      cudaStream_t stream) {
+  switch (codec) {
+    case CompressionCodec::LZ4:
+      check_nvcomp(nvcompBatchedLZ4DecompressAsync(compressed_ptrs, compressed_bytes,
+                                                   uncompressed_bytes, actual_uncompressed_bytes,
+                                                   num_pages, temp, temp_bytes, uncompressed_ptrs,
+                                                   statuses, stream),
+                   "nvcompBatchedLZ4DecompressAsync");
+      break;
+    case CompressionCodec::Zstd:
+      check_nvcomp(nvcompBatchedZstdDecompressAsync(compressed_ptrs, compressed_bytes,
+                                                    uncompressed_bytes, actual_uncompressed_bytes,
+                                                    num_pages, temp, temp_bytes, uncompressed_ptrs,
+                                                    statuses, stream),
+                   "nvcompBatchedZstdDecompressAsync");
+      break;
+    case CompressionCodec::Bitcomp:
+      check_nvcomp(nvcompBatchedBitcompDecompressAsync(
+                       compressed_ptrs, compressed_bytes, uncompressed_bytes,
+                       actual_uncompressed_bytes, num_pages, temp, temp_bytes, uncompressed_ptrs,
+                       statuses, stream),
+                   "nvcompBatchedBitcompDecompressAsync");
+      break;
+    default:
+      HCTR_OWN_THROW(Error_t::WrongInput, "Unknown compression codec");
+  }
+}
+
+#endif
+
+}  // namespace
+
+CompressionCodec get_compression_codec(const std::string& name) {
+  if (name.empty() || name == "none") {
+    return CompressionCodec::None;
+  } else if (name == "lz4") {
+    return CompressionCodec::LZ4;
+  } else if (name == "zstd") {
+    return CompressionCodec::Zstd;
+  } else if (name == "bitcomp") {
+    return CompressionCodec::Bitcomp;
+  }
+  HCTR_OWN_THROW(Error_t::WrongInput, "Unknown compression codec: " + name);
+  return CompressionCodec::None;
+}
+
+std::string get_compressed_file_suffix(CompressionCodec codec) {
+  switch (codec) {
+    case CompressionCodec::LZ4:
+      return ".lz4";
+    case CompressionCodec::Zstd:
+      return ".zstd";
+    case CompressionCodec::Bitcomp:
+      return ".bitcomp";
+    default:
+      return "";
+  }
+}
+
+CompressionCodec get_file_compression_codec(const std::string& path) {
+  for (auto codec : {CompressionCodec::LZ4, CompressionCodec::Zstd, CompressionCodec::Bitcomp}) {
+    const std::string suffix = get_compressed_file_suffix(codec);
+    if (path.size() > suffix.size() &&
+        path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0) {
+      return codec;
+    }
+  }
+  return CompressionCodec::None;
+}
+
+std::string find_maybe_compressed_file(FileSystem& file_system, const std::string& path) {
+  for (auto codec : {CompressionCodec::None, CompressionCodec::LZ4, CompressionCodec::Zstd,
+                     CompressionCodec::Bitcomp}) {
+    const std::string codec_path = path + get_compressed_file_suffix(codec);
+    // The file systems have no other way to tell whether a file exists. HDFS returns 0 bytes for
+    // files that do not exist, and empty files are not valid ones either.
+    try {
+      if (file_system.get_file_size(codec_path) > 0) {
+        return codec_path;
+      }
+    } catch (const std::exception&) {
+    }
+  }
+  return "";
+}
+
+CompressedPages compress_pages(const void* data, size_t size, CompressionCodec codec,
+                               size_t page_bytes) {
+  HCTR_CHECK_HINT(codec != CompressionCodec::None, "Pages need a compression codec");
+  HCTR_CHECK_HINT(page_bytes > 0 && page_bytes % page_alignment == 0,
+                  "Pages must be a multiple of ", page_alignment, " bytes");
+  CompressedPages pages;
+  pages.codec = codec;
+  const size_t num_pages = (size + page_bytes - 1) / page_bytes;
+  for (size_t p = 0; p < num_pages; ++p) {
+    pages.uncompressed_bytes.push_back(std::min(page_bytes, size - p * page_bytes));
+  }
+  pages.compressed_bytes.resize(num_pages);
+  if (num_pages == 0) {
+    return pages;
+  }
+#ifdef ENABLE_NVCOMP
+  const size_t batch_size = std::min(max_pages_per_batch, num_pages);
+  const size_t temp_bytes = get_compress_temp_bytes(codec, batch_size, page_bytes);
+  const size_t max_compressed_bytes =
+      align_page(get_max_compressed_page_bytes(codec, page_bytes));
+  DeviceBuffer d_uncompressed(batch_size * page_bytes);
+  DeviceBuffer d_compressed(batch_size * max_compressed_bytes);
+  DeviceBuffer d_temp(temp_bytes);
+  // The uncompressed and then the compressed pointers and bytes of the pages of a batch.
+  DeviceBuffer d_ptrs(2 * batch_size * sizeof(void*));
+  DeviceBuffer d_bytes(2 * batch_size * sizeof(size_t));
+  std::vector<void*> h_ptrs(2 * batch_size);
+  std::vector<size_t> h_bytes(2 * batch_size);
+  Stream stream;
+
+  const char* host_data = static_cast<const char*>(data);
+  for (size_t first = 0; first < num_pages; first += batch_size) {
+    const size_t num_batch_pages = std::min(batch_size, num_pages - first);
+    const size_t batch_bytes = std::min(num_batch_pages * page_bytes, size - first * page_bytes);
+    for (size_t i = 0; i < num_batch_pages; ++i) {
+      h_ptrs[i] = d_uncompressed.get<char>() + i * page_bytes;
+      h_ptrs[batch_size + i] = d_compressed.get<char>() + i * max_compressed_bytes;
+      h_bytes[i] = pages.uncompressed_bytes[first + i];
+    }
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_uncompressed.get<char>(), host_data + first * page_bytes,
+                                   batch_bytes, cudaMemcpyHostToDevice, stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_ptrs.get<void*>(), h_ptrs.data(),
+                                   h_ptrs.size() * sizeof(void*), cudaMemcpyHostToDevice, stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_bytes.get<size_t>(), h_bytes.data(),
+                                   batch_size * sizeof(size_t), cudaMemcpyHostToDevice, stream));
+    compress_async(codec, d_ptrs.get<void*>(), d_bytes.get<size_t>(), page_bytes,
+                   num_batch_pages, d_temp.get<void>(), temp_bytes,
+                   d_ptrs.get<void*>() + batch_size, d_bytes.get<size_t>() + batch_size, stream);
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_bytes.data() + batch_size,
+                                   d_bytes.get<size_t>() + batch_size,
+                                   num_batch_pages * sizeof(size_t), cudaMemcpyDeviceToHost,
+                                   stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+    // The buffer is only grown before the copies into it are issued.
+    size_t offset = pages.data.size();
+    size_t num_batch_bytes = 0;
+    for (size_t i = 0; i < num_batch_pages; ++i) {
+      pages.compressed_bytes[first + i] = h_bytes[batch_size + i];
+      num_batch_bytes += align_page(h_bytes[batch_size + i]);
+    }
+    pages.data.resize(offset + num_batch_bytes);
+    for (size_t i = 0; i < num_batch_pages; ++i) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(pages.data.data() + offset, h_ptrs[batch_size + i],
+                                     h_bytes[batch_size + i], cudaMemcpyDeviceToHost, stream));
+      offset += align_page(h_bytes[batch_size + i]);
+    }
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+#else
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Compressed files need HugeCTR built with ENABLE_NVCOMP");
+#endif
+  return pages;
+}
+
+std::vector<char> get_compressed_file_head(const std::vector<CompressedPages>& parts) {
+  HCTR_CHECK_HINT(!parts.empty(), "A compressed file needs at least one part");
+  CompressedFileHead head{compressed_file_magic, static_cast<uint32_t>(parts[0].codec), 0, 0};
+  std::vector<uint64_t> uncompressed_bytes, compressed_bytes;
+  for (const auto& part : parts) {
+    HCTR_CHECK_HINT(part.codec == parts[0].codec,
+                    "The parts of a compressed file must have the same codec");
+    for (uint64_t bytes : part.uncompressed_bytes) {
+      head.max_page_bytes = std::max<uint32_t>(head.max_page_bytes, bytes);
+    }
+    uncompressed_bytes.insert(uncompressed_bytes.end(), part.uncompressed_bytes.begin(),
+                              part.uncompressed_bytes.end());
+    compressed_bytes.insert(compressed_bytes.end(), part.compressed_bytes.begin(),
+                            part.compressed_bytes.end());
+  }
+  head.num_pages = uncompressed_bytes.size();
+
+  const size_t index_bytes = head.num_pages * sizeof(uint64_t);
+  std::vector<char> bytes(sizeof(head) + 2 * index_bytes);
+  memcpy(bytes.data(), &head, sizeof(head));
+  memcpy(bytes.data() + sizeof(head), uncompressed_bytes.data(), index_bytes);
+  memcpy(bytes.data() + sizeof(head) + index_bytes, compressed_bytes.data(), index_bytes);
+  return bytes;
+}
+
+size_t get_compressed_file_bytes(const CompressedPages& part) {
+  size_t bytes = 0;
+  for (uint64_t compressed_bytes : part.compressed_bytes) {
+    bytes += align_page(compressed_bytes);
+  }
+  return bytes;
+}
+
+void write_compressed_file(FileSystem& file_system, const std::string& path, const void* data,
+                           size_t size, CompressionCodec codec) {
+  std::vector<CompressedPages> parts;
+  parts.push_back(compress_pages(data, size, codec));
+  std::vector<char> bytes = get_compressed_file_head(parts);
+  bytes.insert(bytes.end(), parts[0].data.begin(), parts[0].data.end());
+  // Object stores cannot append, so the file is written at once.
+  file_system.write(path, bytes.data(), bytes.size(), true);
+}
+
+CompressedFileReader::CompressedFileReader(FileSystem& file_system, const std::string& path)
+    : path_(path) {
+  CompressedFileHead head;
+  file_system.read(path, &head, sizeof(head), 0);
+  HCTR_CHECK_HINT(head.magic == compressed_file_magic, "Not a compressed file: ", path);
+  HCTR_CHECK_HINT(head.codec > static_cast<uint32_t>(CompressionCodec::None) &&
+                      head.codec <= static_cast<uint32_t>(CompressionCodec::Bitcomp),
+                  "Unknown compression codec of ", path);
+  codec_ = static_cast<CompressionCodec>(head.codec);
+  max_page_bytes_ = head.max_page_bytes;
+
+  std::vector<uint64_t> index(2 * head.num_pages);
+  if (!index.empty()) {
+    file_system.read(path, index.data(), index.size() * sizeof(uint64_t), sizeof(head));
+  }
+  page_offsets_.assign(1, 0);
+  file_offsets_.assign(1, sizeof(head) + index.size() * sizeof(uint64_t));
+  for (size_t p = 0; p < head.num_pages; ++p) {
+    page_offsets_.push_back(page_offsets_.back() + index[p]);
+    file_offsets_.push_back(file_offsets_.back() + align_page(index[head.num_pages + p]));
+    compressed_bytes_.push_back(index[head.num_pages + p]);
+  }
+}
+
+void CompressedFileReader::read(FileSystem& file_system, void* buffer, size_t size,
+                                size_t offset) const {
+  if (size == 0) {
+    return;
+  }
+  HCTR_CHECK_HINT(offset + size <= this->size(), "Read past the end of ", path_);
+  // The pages [first_page, last_page) overlap the bytes to read.
+  const size_t first_page =
+      std::upper_bound(page_offsets_.begin(), page_offsets_.end(), offset) -
+      page_offsets_.begin() - 1;
+  const size_t last_page =
+      std::lower_bound(page_offsets_.begin(), page_offsets_.end(), offset + size) -
+      page_offsets_.begin();
+#ifdef ENABLE_NVCOMP
+  const size_t batch_size = std::min(max_pages_per_batch, last_page - first_page);
+  size_t max_batch_file_bytes = 0;
+  for (size_t first = first_page; first < last_page; first += batch_size) {
+    const size_t last = std::min(first + batch_size, last_page);
+    max_batch_file_bytes =
+        std::max<size_t>(max_batch_file_bytes, file_offsets_[last] - file_offsets_[first]);
+  }
+  const size_t temp_bytes = get_decompress_temp_bytes(codec_, batch_size, max_page_bytes_);
+  std::vector<char> compressed(max_batch_file_bytes);
+  DeviceBuffer d_compressed(max_batch_file_bytes);
+  DeviceBuffer d_uncompressed(batch_size * max_page_bytes_);
+  DeviceBuffer d_temp(temp_bytes);
+  // The compressed and then the uncompressed pointers, and the compressed, uncompressed and
+  // decompressed bytes of the pages of a batch.
+  DeviceBuffer d_ptrs(2 * batch_size * sizeof(void*));
+  DeviceBuffer d_bytes(3 * batch_size * sizeof(size_t));
+  DeviceBuffer d_statuses(batch_size * sizeof(nvcompStatus_t));
+  std::vector<void*> h_ptrs(2 * batch_size);
+  std::vector<size_t> h_bytes(2 * batch_size);
+  std::vector<nvcompStatus_t> h_statuses(batch_size);
+  Stream stream;
+
+  char* host_buffer = static_cast<char*>(buffer);
+  for (size_t first = first_page; first < last_page; first += batch_size) {
+    const size_t num_batch_pages = std::min(batch_size, last_page - first);
+    const size_t file_bytes = file_offsets_[first + num_batch_pages] - file_offsets_[first];
+    file_system.read(path_, compressed.data(), file_bytes, file_offsets_[first]);
+    for (size_t i = 0; i < num_batch_pages; ++i) {
+      h_ptrs[i] = d_compressed.get<char>() + file_offsets_[first + i] - file_offsets_[first];
+      h_ptrs[batch_size + i] = d_uncompressed.get<char>() + i * max_page_bytes_;
+      h_bytes[i] = compressed_bytes_[first + i];
+      h_bytes[batch_size + i] = page_offsets_[first + i + 1] - page_offsets_[first + i];
+    }
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_compressed.get<char>(), compressed.data(), file_bytes,
+                                   cudaMemcpyHostToDevice, stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_ptrs.get<void*>(), h_ptrs.data(),
+                                   h_ptrs.size() * sizeof(void*), cudaMemcpyHostToDevice, stream));
+    HCTR_LIB_THROW(cudaMemcpyAsync(d_bytes.get<size_t>(), h_bytes.data(),
+                                   h_bytes.size() * sizeof(size_t), cudaMemcpyHostToDevice,
+                                   stream));
+    decompress_async(codec_, d_ptrs.get<void*>(), d_bytes.get<size_t>(),
+                     d_bytes.get<size_t>() + batch_size, d_bytes.get<size_t>() + 2 * batch_size,
+                     num_batch_pages, d_temp.get<void>(), temp_bytes,
+                     d_ptrs.get<void*>() + batch_size, d_statuses.get<nvcompStatus_t>(), stream);
+    HCTR_LIB_THROW(cudaMemcpyAsync(h_statuses.data(), d_statuses.get<nvcompStatus_t>(),
+                                   num_batch_pages * sizeof(nvcompStatus_t),
+                                   cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    for (size_t i = 0; i < num_batch_pages; ++i) {
+      check_nvcomp(h_statuses[i], ("Decompressing " + path_).c_str());
+    }
+
+    // Copies the bytes of each page that overlap the bytes to read.
+    for (size_t i = 0; i < num_batch_pages; ++i) {
+      const size_t page_begin = page_offsets_[first + i];
+      const size_t begin = std::max(offset, page_begin);
+      const size_t end = std::min(offset + size, page_offsets_[first + i + 1]);
+      HCTR_LIB_THROW(cudaMemcpyAsync(host_buffer + begin - offset,
+                                     static_cast<char*>(h_ptrs[batch_size + i]) + begin -
+                                         page_begin,
+                                     end - begin, cudaMemcpyDeviceToHost, stream));
+    }
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+#else
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Compressed files need HugeCTR built with ENABLE_NVCOMP");
+#endif
+}
+
+}  // namespace HugeCTR
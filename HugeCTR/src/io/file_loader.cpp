@@ -18,6 +18,10 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <future>
 #include <io/file_loader.hpp>
 
 namespace HugeCTR {
@@ -49,59 +53,204 @@ Error_t FileLoader::set_file(const std::string& file_name) noexcept {
   }
 }
 
+Error_t FileLoader::map_file(const std::string& path) noexcept {
+  fd_ = open(path.c_str(), O_RDONLY, 0);
+  if (fd_ == -1) {
+    HCTR_LOG_S(ERROR, WORLD) << "Error open file for read " << HCTR_LOCATION() << std::endl;
+    return Error_t::BrokenFile;
+  }
+  data_ = (char*)mmap(0, cur_file_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (data_ == MAP_FAILED) {
+    close(fd_);
+    fd_ = -1;
+    data_ = nullptr;
+    HCTR_LOG_S(ERROR, WORLD) << "Error mmapping the file " << HCTR_LOCATION() << std::endl;
+    return Error_t::BrokenFile;
+  }
+  // Start the readahead of the whole file, instead of faulting it in page by page on decode.
+  madvise(data_, cur_file_size_, MADV_WILLNEED);
+  return Error_t::Success;
+}
+
+std::string FileLoader::get_cache_path(const std::string& file_name) const {
+  if (data_source_params_.cache_dir.empty()) {
+    return std::string();
+  }
+  // Flatten the remote path, so that all files share the cache directory.
+  std::string cache_name{file_name};
+  std::replace_if(
+      cache_name.begin(), cache_name.end(), [](char c) { return c == '/' || c == ':'; }, '_');
+  return data_source_params_.cache_dir + "/" + cache_name;
+}
+
+Error_t FileLoader::fetch(const std::string& file_name, char*& data, size_t& file_size) noexcept {
+  try {
+    file_size = file_system_->get_file_size(file_name);
+  } catch (const std::exception& e) {
+    HCTR_LOG_S(ERROR, WORLD) << e.what() << ' ' << HCTR_LOCATION() << std::endl;
+    file_size = 0;
+  }
+  if (file_size == 0) {
+    HCTR_LOG_S(ERROR, WORLD) << "data_source_backend failed to open: " << file_name << ' '
+                             << HCTR_LOCATION() << std::endl;
+    return Error_t::FileCannotOpen;
+  }
+  data = new char[file_size];
+
+  // Ranged reads of a single stream are bound by its latency, so several are kept in flight.
+  const size_t chunk_size{
+      static_cast<size_t>(std::max(data_source_params_.read_chunk_size_mb, 1)) << 20};
+  const size_t num_chunks{(file_size + chunk_size - 1) / chunk_size};
+  const size_t max_in_flight{
+      static_cast<size_t>(std::max(data_source_params_.num_read_threads, 1))};
+  std::deque<std::pair<std::future<int>, size_t>> reads;
+  bool failed{false};
+  const auto await_read = [&]() {
+    try {
+      if (reads.front().first.get() != static_cast<int>(reads.front().second)) {
+        failed = true;
+      }
+    } catch (const std::exception& e) {
+      HCTR_LOG_S(ERROR, WORLD) << e.what() << ' ' << HCTR_LOCATION() << std::endl;
+      failed = true;
+    }
+    reads.pop_front();
+  };
+  for (size_t chunk = 0; chunk < num_chunks && !failed; ++chunk) {
+    if (reads.size() == max_in_flight) {
+      await_read();
+    }
+    const size_t offset{chunk * chunk_size};
+    const size_t size{std::min(chunk_size, file_size - offset)};
+    reads.emplace_back(file_system_->read_async(file_name, data + offset, size, offset), size);
+  }
+  while (!reads.empty()) {
+    await_read();
+  }
+  if (failed) {
+    delete[] data;
+    data = nullptr;
+    HCTR_LOG_S(ERROR, WORLD) << "Error reading the file from dfs " << HCTR_LOCATION() << std::endl;
+    return Error_t::BrokenFile;
+  }
+
+  // Write to a temporary file first, so that other loaders never map a partial file.
+  const std::string cache_path{get_cache_path(file_name)};
+  if (!cache_path.empty()) {
+    const std::string tmp_path{cache_path + ".tmp" + std::to_string(getpid()) + "_" +
+                               std::to_string(reinterpret_cast<uintptr_t>(this))};
+    std::ofstream cache_stream(tmp_path, std::ofstream::binary);
+    cache_stream.write(data, file_size);
+    cache_stream.close();
+    std::error_code ec;
+    if (cache_stream.good()) {
+      std::filesystem::rename(tmp_path, cache_path, ec);
+    }
+    if (!cache_stream.good() || ec) {
+      std::filesystem::remove(tmp_path, ec);
+      HCTR_LOG_S(WARNING, WORLD) << "Failed to write " << file_name << " into the cache directory "
+                                 << data_source_params_.cache_dir << std::endl;
+    }
+  }
+  return Error_t::Success;
+}
+
+void FileLoader::discard_prefetch() noexcept {
+  if (prefetch_.valid()) {
+    prefetch_.wait();
+    delete[] prefetch_data_;
+    prefetch_data_ = nullptr;
+    prefetch_ = std::future<Error_t>();
+  }
+}
+
 FileLoader::FileLoader(const DataSourceParams& data_source_params)
-    : cur_file_size_(0), data_source_params_(data_source_params), fd_(-1), data_(nullptr) {
+    : cur_file_size_(0),
+      data_source_params_(data_source_params),
+      fd_(-1),
+      data_(nullptr),
+      prefetch_data_(nullptr),
+      prefetch_file_size_(0) {
   use_mmap_ = data_source_params_.type == FileSystemType_t::Local;
   if (!use_mmap_) {
     file_system_ = FileSystemBuilder::build_unique_by_data_source_params(data_source_params);
+    if (!data_source_params_.cache_dir.empty()) {
+      std::error_code ec;
+      std::filesystem::create_directories(data_source_params_.cache_dir, ec);
+    }
   }
 }
 
-FileLoader::~FileLoader() { clean(); }
+FileLoader::~FileLoader() {
+  discard_prefetch();
+  clean();
+}
 
 Error_t FileLoader::load(const std::string& file_name) noexcept {
-  Error_t err = set_file(file_name);
-  if (err != Error_t::Success) {
-    HCTR_LOG_S(ERROR, WORLD) << "Error open file for read " << HCTR_LOCATION() << std::endl;
-    return err;
-  }
   if (use_mmap_) {
-    fd_ = open(cur_file_name_.c_str(), O_RDONLY, 0);
-    if (fd_ == -1) {
+    Error_t err = set_file(file_name);
+    if (err != Error_t::Success) {
       HCTR_LOG_S(ERROR, WORLD) << "Error open file for read " << HCTR_LOCATION() << std::endl;
-      return Error_t::BrokenFile;
+      return err;
     }
-    data_ = (char*)mmap(0, cur_file_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
-    if (data_ == MAP_FAILED) {
-      close(fd_);
-      fd_ = -1;
-      HCTR_LOG_S(ERROR, WORLD) << "Error mmapping the file " << HCTR_LOCATION() << std::endl;
-      return Error_t::BrokenFile;
+    return map_file(cur_file_name_);
+  }
+
+  cur_file_name_ = file_name;
+  const std::string cache_path{get_cache_path(file_name)};
+  std::error_code ec;
+  if (!cache_path.empty() && std::filesystem::exists(cache_path, ec)) {
+    cur_file_size_ = std::filesystem::file_size(cache_path, ec);
+    if (!ec && map_file(cache_path) == Error_t::Success) {
+      return Error_t::Success;
     }
-    return Error_t::Success;
-  } else {
-    data_ = new char[cur_file_size_ / sizeof(char)];
-    int bytes_read = file_system_->read(cur_file_name_, data_, cur_file_size_, 0);
-    if (bytes_read < 0) {
-      delete[] data_;
-      data_ = nullptr;
-      HCTR_LOG_S(ERROR, WORLD) << "Error reading the file from dfs " << HCTR_LOCATION()
-                               << std::endl;
-      return Error_t::BrokenFile;
+  }
+
+  if (prefetch_.valid() && prefetch_file_name_ == file_name) {
+    Error_t err = prefetch_.get();
+    data_ = prefetch_data_;
+    cur_file_size_ = prefetch_file_size_;
+    prefetch_data_ = nullptr;
+    return err;
+  }
+  discard_prefetch();
+  return fetch(file_name, data_, cur_file_size_);
+}
+
+void FileLoader::prefetch(const std::string& file_name) noexcept {
+  if (use_mmap_) {
+    // The kernel reads the file into the page cache in the background.
+    int fd = open(file_name.c_str(), O_RDONLY, 0);
+    if (fd != -1) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+      close(fd);
     }
-    return Error_t::Success;
+    return;
   }
+  if (prefetch_.valid() && prefetch_file_name_ == file_name) {
+    return;
+  }
+  discard_prefetch();
+  const std::string cache_path{get_cache_path(file_name)};
+  std::error_code ec;
+  if (!cache_path.empty() && std::filesystem::exists(cache_path, ec)) {
+    return;
+  }
+  prefetch_file_name_ = file_name;
+  prefetch_ = std::async(std::launch::async, [this]() {
+    return fetch(prefetch_file_name_, prefetch_data_, prefetch_file_size_);
+  });
 }
 
 void FileLoader::clean() {
-  if (use_mmap_ && fd_ != -1) {
+  if (fd_ != -1) {
     munmap(data_, cur_file_size_);
     close(fd_);
     fd_ = -1;
-  } else if (!use_mmap_ && data_ != nullptr) {
+  } else if (data_ != nullptr) {
     delete[] data_;
-    data_ = nullptr;
   }
+  data_ = nullptr;
 }
 
-}  // namespace HugeCTR
\ No newline at end of file
+}  // namespace HugeCTR
@@ -15,15 +15,100 @@
  */
 
 #include <core23/logger.hpp>
+#include <exception>
 #include <io/filesystem.hpp>
 #include <io/gcs_filesystem.hpp>
 #include <io/hadoop_filesystem.hpp>
 #include <io/io_utils.hpp>
 #include <io/local_filesystem.hpp>
 #include <io/s3_filesystem.hpp>
+#include <map>
+#include <thread_pool.hpp>
 
 namespace HugeCTR {
 
+namespace {
+
+// Workers mostly wait for the storage, so that there are more of them than CPUs.
+ThreadPool& get_io_thread_pool() {
+  static ThreadPool pool{"file system io",
+                         std::max<size_t>(std::thread::hardware_concurrency(), 32)};
+  return pool;
+}
+
+template <typename Task>
+std::future<int> submit_io_task(Task&& task) {
+  auto packaged_task = std::make_shared<std::packaged_task<int()>>(std::forward<Task>(task));
+  std::future<int> result = packaged_task->get_future();
+  get_io_thread_pool().submit([packaged_task]() { (*packaged_task)(); });
+  return result;
+}
+
+// Waits for all futures, and rethrows the first exception once all of them are ready.
+std::vector<int> await_io_tasks(std::vector<std::future<int>>& futures) {
+  std::vector<int> results(futures.size());
+  std::exception_ptr error;
+  for (size_t i = 0; i < futures.size(); ++i) {
+    try {
+      results[i] = futures[i].get();
+    } catch (...) {
+      if (!error) error = std::current_exception();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return results;
+}
+
+}  // namespace
+
+std::future<int> FileSystem::read_async(const std::string& path, void* const buffer,
+                                        const size_t buffer_size, const size_t offset) {
+  return submit_io_task([this, path, buffer, buffer_size, offset]() {
+    return read(path, buffer, buffer_size, offset);
+  });
+}
+
+std::future<int> FileSystem::write_async(const std::string& path, const void* const data,
+                                         const size_t data_size, const bool overwrite) {
+  return submit_io_task([this, path, data, data_size, overwrite]() {
+    return write(path, data, data_size, overwrite);
+  });
+}
+
+std::vector<int> FileSystem::batch_read(const std::vector<FileReadRequest>& requests) {
+  std::vector<std::future<int>> futures;
+  futures.reserve(requests.size());
+  for (const auto& request : requests) {
+    futures.emplace_back(
+        read_async(request.path, request.buffer, request.buffer_size, request.offset));
+  }
+  return await_io_tasks(futures);
+}
+
+std::vector<int> FileSystem::batch_write(const std::vector<FileWriteRequest>& requests) {
+  std::map<std::string, std::vector<size_t>> requests_by_path;
+  for (size_t i = 0; i < requests.size(); ++i) {
+    requests_by_path[requests[i].path].push_back(i);
+  }
+
+  // One task per file, which keeps the number of bytes written by each request.
+  std::vector<int> results(requests.size());
+  std::vector<std::future<int>> futures;
+  for (const auto& [path, indices] : requests_by_path) {
+    futures.emplace_back(submit_io_task([this, &requests, &results, &indices]() {
+      for (const size_t i : indices) {
+        const auto& request = requests[i];
+        results[i] = write(request.path, request.data, request.data_size, request.overwrite);
+      }
+      return static_cast<int>(indices.size());
+    }));
+  }
+  await_io_tasks(futures);
+  return results;
+}
+
 FileSystem* FileSystemBuilder::build_by_path(const std::string& file_path) {
   std::string scheme = IOUtils::get_path_scheme(file_path);
   FileSystemType_t fs_type;
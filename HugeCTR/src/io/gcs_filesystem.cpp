@@ -16,18 +16,23 @@
 
 #ifdef ENABLE_GCS
 #include <google/cloud/status_or.h>
+#include <fcntl.h>
 #include <google/cloud/storage/client.h>
 #endif
 
 #include <core23/logger.hpp>
 #include <fstream>
 #include <io/gcs_filesystem.hpp>
+#include <io/io_utils.hpp>
+#include <nlohmann/json.hpp>
 #include <string_view>
 
 namespace HugeCTR {
 
 #ifdef ENABLE_GCS
 auto constexpr kUploadBufferSize = 256 * 1024;
+// Maximum number of source objects of a compose request.
+auto constexpr kMaxComposeSources = 32;
 
 namespace gcs = google::cloud::storage;
 
@@ -96,11 +101,29 @@ GCSConfigs GCSConfigs::FromUrl(const std::string& url) {
 GCSConfigs GCSConfigs::FromDataSourceParams(const DataSourceParams& data_source_params) {
   GCSConfigs configs;
   configs.set_endpoint_override(data_source_params.server);
+  configs.part_size = static_cast<size_t>(std::max(data_source_params.read_chunk_size_mb, 1)) << 20;
+  configs.max_concurrency = data_source_params.num_read_threads;
   return configs;
 }
 
 GCSConfigs GCSConfigs::FromJSON(const std::string& path) {
   GCSConfigs configs;
+  nlohmann::json config;
+  std::ifstream file_stream(path);
+  if (!file_stream.is_open()) {
+    HCTR_OWN_THROW(Error_t::FileCannotOpen, "file_stream.is_open() failed: " + path);
+  }
+  try {
+    file_stream >> config;
+  } catch (const std::runtime_error& rt_err) {
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+  }
+  if (config.contains("part_size_mb")) {
+    configs.part_size = config.find("part_size_mb").value().get<size_t>() << 20;
+  }
+  if (config.contains("max_concurrency")) {
+    configs.max_concurrency = config.find("max_concurrency").value().get<int>();
+  }
   return configs;
 }
 
@@ -134,7 +157,9 @@ google::cloud::Options ToGoogleCloudOptions(const GCSConfigs& configs) {
   return options;
 }
 
-GCSFileSystem::GCSFileSystem(const GCSConfigs& configs) {
+GCSFileSystem::GCSFileSystem(const GCSConfigs& configs)
+    : part_size_(std::max<size_t>(configs.part_size, 1)),
+      max_concurrency_(std::max(configs.max_concurrency, 1)) {
   client_ = std::make_unique<gcs::Client>(ToGoogleCloudOptions(configs));
 }
 
@@ -167,19 +192,126 @@ void GCSFileSystem::fetch(const std::string& source_path, const std::string& tar
   GCSPath source_gcs_path = GCSPath::FromString(source_path);
   HCTR_CHECK_HINT(source_gcs_path.has_bucket_and_object(),
                   "The source GCS path does not contain bucket or key information.");
-  google::cloud::Status status =
-      client_->DownloadToFile(source_gcs_path.bucket, source_gcs_path.object, target_path);
-  HCTR_CHECK_HINT(status.ok(), "Failed to download the file from GCS.");
+  const size_t size = get_file_size(source_path);
+  if (size <= part_size_) {
+    google::cloud::Status status =
+        client_->DownloadToFile(source_gcs_path.bucket, source_gcs_path.object, target_path);
+    HCTR_CHECK_HINT(status.ok(), "Failed to download the file from GCS.");
+    return;
+  }
+
+  const int fd = open(target_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  HCTR_CHECK_HINT(fd != -1, "Failed to open the local file ", target_path);
+  const auto fetch_part = [&](const size_t part, const size_t offset, const size_t nbytes) {
+    std::vector<char> buffer(nbytes);
+    if (read_range_(source_gcs_path, buffer.data(), nbytes, offset) != nbytes) {
+      HCTR_OWN_THROW(Error_t::BrokenFile, "Failed to download the file from GCS.");
+    }
+    IOUtils::pwrite_fully(fd, buffer.data(), nbytes, offset);
+  };
+  try {
+    IOUtils::for_each_part(size, part_size_, max_concurrency_, fetch_part);
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
 }
 
 void GCSFileSystem::upload(const std::string& source_path, const std::string& target_path) {
   GCSPath target_gcs_path = GCSPath::FromString(target_path);
   HCTR_CHECK_HINT(target_gcs_path.has_bucket_and_object(),
                   "This destination GCS path does not contain bucket or key information.");
-  google::cloud::StatusOr<gcs::ObjectMetadata> object_metadata =
-      client_->UploadFile(source_path, target_gcs_path.bucket, target_gcs_path.object,
-                          gcs::IfGenerationMatch(0), gcs::NewResumableUploadSession());
-  HCTR_CHECK_HINT(object_metadata.ok(), "Failed to upload the file to GCS.");
+  const int fd = open(source_path.c_str(), O_RDONLY);
+  HCTR_CHECK_HINT(fd != -1, "Failed to open the local file ", source_path);
+  const size_t size = lseek(fd, 0, SEEK_END);
+  if (size <= part_size_) {
+    close(fd);
+    google::cloud::StatusOr<gcs::ObjectMetadata> object_metadata =
+        client_->UploadFile(source_path, target_gcs_path.bucket, target_gcs_path.object,
+                            gcs::IfGenerationMatch(0), gcs::NewResumableUploadSession());
+    HCTR_CHECK_HINT(object_metadata.ok(), "Failed to upload the file to GCS.");
+    return;
+  }
+
+  const auto get_part = [fd](const size_t offset, const size_t nbytes, std::vector<char>& buffer) {
+    buffer.resize(nbytes);
+    IOUtils::pread_fully(fd, buffer.data(), nbytes, offset);
+    return static_cast<const char*>(buffer.data());
+  };
+  try {
+    composite_upload_(target_gcs_path, size, get_part);
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
+}
+
+void GCSFileSystem::composite_upload_(
+    const GCSPath& gcs_path, const size_t size,
+    const std::function<const char*(size_t, size_t, std::vector<char>&)>& get_part) {
+  const size_t num_parts = (size + part_size_ - 1) / part_size_;
+  std::vector<std::string> temporary_objects;
+  for (size_t part = 0; part < num_parts; ++part) {
+    temporary_objects.emplace_back(gcs_path.object + ".hctr_part" + std::to_string(part));
+  }
+  const auto delete_temporary_objects = [&]() {
+    for (const auto& object : temporary_objects) {
+      if (!client_->DeleteObject(gcs_path.bucket, object).ok()) {
+        HCTR_LOG_S(WARNING, WORLD) << "Cannot delete the temporary GCS object " << object
+                                   << std::endl;
+      }
+    }
+  };
+
+  try {
+    const auto upload_part = [&](const size_t part, const size_t offset, const size_t nbytes) {
+      std::vector<char> buffer;
+      const char* const data = get_part(offset, nbytes, buffer);
+      gcs::ObjectWriteStream stream =
+          client_->WriteObject(gcs_path.bucket, temporary_objects[part]);
+      stream.write(data, nbytes);
+      stream.Close();
+      if (!stream.metadata().ok() || stream.metadata().value().size() != nbytes) {
+        HCTR_OWN_THROW(Error_t::FileCannotOpen, "Failed to upload a part to GCS.");
+      }
+    };
+    IOUtils::for_each_part(size, part_size_, max_concurrency_, upload_part);
+
+    // A compose request takes at most kMaxComposeSources objects, so that many parts are composed
+    // in rounds, the last of which writes the object.
+    std::vector<std::string> sources(temporary_objects);
+    for (size_t round = 0;; ++round) {
+      std::vector<std::string> composed;
+      for (size_t i = 0; i < sources.size(); i += kMaxComposeSources) {
+        std::vector<gcs::ComposeSourceObject> compose_sources;
+        for (size_t j = i; j < std::min<size_t>(i + kMaxComposeSources, sources.size()); ++j) {
+          compose_sources.push_back(gcs::ComposeSourceObject{sources[j], {}, {}});
+        }
+        const std::string destination =
+            sources.size() <= kMaxComposeSources
+                ? gcs_path.object
+                : gcs_path.object + ".hctr_compose" + std::to_string(round) + "_" +
+                      std::to_string(composed.size());
+        google::cloud::StatusOr<gcs::ObjectMetadata> compose_meta =
+            client_->ComposeObject(gcs_path.bucket, compose_sources, destination);
+        if (!compose_meta.ok()) {
+          HCTR_OWN_THROW(Error_t::FileCannotOpen, "Failed to compose the parts in GCS.");
+        }
+        composed.push_back(destination);
+      }
+      if (sources.size() <= kMaxComposeSources) {
+        break;
+      }
+      temporary_objects.insert(temporary_objects.end(), composed.begin(), composed.end());
+      sources.swap(composed);
+    }
+  } catch (...) {
+    delete_temporary_objects();
+    throw;
+  }
+  delete_temporary_objects();
 }
 
 int GCSFileSystem::write(const std::string& path, const void* const data, const size_t data_size,
@@ -187,6 +319,15 @@ int GCSFileSystem::write(const std::string& path, const void* const data, const
   GCSPath gcs_path = GCSPath::FromString(path);
   HCTR_CHECK_HINT(gcs_path.has_bucket_and_object(),
                   "This GCS path does not contain bucket or key information.");
+  if (data_size > part_size_) {
+    const char* const bytes = static_cast<const char*>(data);
+    composite_upload_(gcs_path, data_size,
+                      [bytes](const size_t offset, size_t, std::vector<char>&) {
+                        return bytes + offset;
+                      });
+    HCTR_LOG_S(DEBUG, WORLD) << "Successfully write to GCS location:  " << path << std::endl;
+    return data_size;
+  }
   gcs::ObjectWriteStream stream =
       client_->WriteObject(gcs_path.bucket, gcs_path.object, gcs::NewResumableUploadSession(),
                            gcs::AutoFinalizeEnabled());
@@ -200,17 +341,36 @@ int GCSFileSystem::write(const std::string& path, const void* const data, const
   return data_size;
 }
 
+size_t GCSFileSystem::read_range_(const GCSPath& gcs_path, void* const buffer, const size_t nbytes,
+                                  const size_t offset) {
+  gcs::ObjectReadStream stream = client_->ReadObject(gcs_path.bucket, gcs_path.object,
+                                                     gcs::ReadRange(offset, offset + nbytes));
+  stream.read(reinterpret_cast<char*>(buffer), nbytes);
+  stream.Close();
+  if (stream.IsOpen()) {
+    HCTR_OWN_THROW(Error_t::BrokenFile, "Failed to read from GCS.");
+  }
+  return stream.gcount();
+}
+
 int GCSFileSystem::read(const std::string& path, void* const buffer, const size_t buffer_size,
                         const size_t offset) {
   GCSPath gcs_path = GCSPath::FromString(path);
   HCTR_CHECK_HINT(gcs_path.has_bucket_and_object(),
                   "This GCS path does not contain bucket or key information.");
-  gcs::ObjectReadStream stream = client_->ReadObject(gcs_path.bucket, gcs_path.object,
-                                                     gcs::ReadRange(offset, offset + buffer_size));
-  stream.read(reinterpret_cast<char*>(buffer), buffer_size);
-  stream.Close();
-  HCTR_CHECK_HINT(!stream.IsOpen(), "Failed to read from GCS.");
-  return stream.gcount();
+  if (buffer_size <= part_size_) {
+    return read_range_(gcs_path, buffer, buffer_size, offset);
+  }
+  // Large reads are split into ranged requests, which are sent at the same time.
+  const size_t nbytes = std::min(buffer_size, get_file_size(path) - offset);
+  const auto read_part = [&](const size_t part, const size_t part_offset, const size_t part_bytes) {
+    char* const part_buffer = static_cast<char*>(buffer) + part_offset;
+    if (read_range_(gcs_path, part_buffer, part_bytes, offset + part_offset) != part_bytes) {
+      HCTR_OWN_THROW(Error_t::BrokenFile, "Failed to read from GCS.");
+    }
+  };
+  IOUtils::for_each_part(nbytes, part_size_, max_concurrency_, read_part);
+  return nbytes;
 }
 
 void GCSFileSystem::copy(const std::string& source_path, const std::string& target_path) {
@@ -227,13 +387,11 @@ void GCSFileSystem::copy(const std::string& source_path, const std::string& targ
 }
 
 void GCSFileSystem::batch_fetch(const std::string& source_path, const std::string& target_path) {
-  // TODO
-  HCTR_DIE("Not implemented yet!");
+  fetch(source_path, target_path);
 }
 
 void GCSFileSystem::batch_upload(const std::string& source_path, const std::string& target_path) {
-  // TODO
-  HCTR_DIE("Not implemented yet!");
+  upload(source_path, target_path);
 }
 
 #endif
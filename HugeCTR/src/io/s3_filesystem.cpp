@@ -19,7 +19,12 @@
 #include <aws/core/auth/AWSCredentialsProviderChain.h>
 #include <aws/core/utils/logging/ConsoleLogSystem.h>
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CompletedMultipartUpload.h>
+#include <aws/s3/model/CompletedPart.h>
 #include <aws/s3/model/CopyObjectRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/CreateBucketRequest.h>
 #include <aws/s3/model/DeleteBucketRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
@@ -27,10 +32,13 @@
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
 #include <aws/s3/model/PutObjectRequest.h>
+#include <aws/s3/model/UploadPartRequest.h>
+#include <fcntl.h>
 #endif
 
 #include <core23/logger.hpp>
 #include <fstream>
+#include <io/io_utils.hpp>
 #include <io/s3_filesystem.hpp>
 #include <io/s3_utils.hpp>
 #include <nlohmann/json.hpp>
@@ -76,6 +84,12 @@ void S3Configs::set_all_from_json(const std::string& path) {
   }
   std::string fs_type = (std::string)config.find("fs_type").value();
   HCTR_CHECK_HINT(fs_type == "S3", "Not a valid S3 configuration file.");
+  if (config.contains("part_size_mb")) {
+    this->part_size = config.find("part_size_mb").value().get<size_t>() << 20;
+  }
+  if (config.contains("max_concurrency")) {
+    this->max_concurrency = config.find("max_concurrency").value().get<int>();
+  }
   // TODO: parse more configs
   file_stream.close();
   return;
@@ -96,6 +110,8 @@ S3Configs S3Configs::FromUrl(const std::string& url) {
 S3Configs S3Configs::FromDataSourceParams(const DataSourceParams& data_source_params) {
   S3Configs configs;
   configs.configure_default(data_source_params.server);
+  configs.part_size = static_cast<size_t>(std::max(data_source_params.read_chunk_size_mb, 1)) << 20;
+  configs.max_concurrency = data_source_params.num_read_threads;
   return configs;
 }
 
@@ -150,7 +166,9 @@ Aws::IOStreamFactory AwsWriteableStreamFactory(void* data, size_t nbytes) {
   return [=]() { return Aws::New<StringViewStream>("", data, nbytes); };
 }
 
-S3FileSystem::S3FileSystem(const S3Configs& configs) {
+S3FileSystem::S3FileSystem(const S3Configs& configs)
+    : part_size_(std::max<size_t>(configs.part_size, 5 << 20)),
+      max_concurrency_(std::max(configs.max_concurrency, 1)) {
   try {
     std::call_once(sdk_is_running, start_aws_sdk);
   } catch (const std::runtime_error& rt_err) {
@@ -200,13 +218,107 @@ void S3FileSystem::delete_file(const std::string& path) {
 }
 
 void S3FileSystem::fetch(const std::string& source_path, const std::string& target_path) {
-  // TODO
-  HCTR_DIE("Not implemented yet!");
+  S3Path s3_path = S3Path::FromString(source_path);
+  HCTR_CHECK_HINT(s3_path.has_bucket_and_key(),
+                  "The source S3 path does not contain bucket or key information.");
+  const size_t size = get_file_size(source_path);
+  const int fd = open(target_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  HCTR_CHECK_HINT(fd != -1, "Failed to open the local file ", target_path);
+  const auto fetch_part = [&](const size_t part, const size_t offset, const size_t nbytes) {
+    std::vector<char> buffer(nbytes);
+    if (read_range_(s3_path, buffer.data(), nbytes, offset) != nbytes) {
+      HCTR_OWN_THROW(Error_t::BrokenFile, "Failed to read from S3.");
+    }
+    IOUtils::pwrite_fully(fd, buffer.data(), nbytes, offset);
+  };
+  try {
+    if (size > 0) {
+      IOUtils::for_each_part(size, part_size_, max_concurrency_, fetch_part);
+    }
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
 }
 
 void S3FileSystem::upload(const std::string& source_path, const std::string& target_path) {
-  // TODO
-  HCTR_DIE("Not implemented yet!");
+  S3Path s3_path = S3Path::FromString(target_path);
+  HCTR_CHECK_HINT(s3_path.has_bucket_and_key(),
+                  "This destination S3 path does not contain bucket or key information.");
+  const int fd = open(source_path.c_str(), O_RDONLY);
+  HCTR_CHECK_HINT(fd != -1, "Failed to open the local file ", source_path);
+  const off_t size = lseek(fd, 0, SEEK_END);
+  const auto get_part = [fd](const size_t offset, const size_t nbytes, std::vector<char>& buffer) {
+    buffer.resize(nbytes);
+    IOUtils::pread_fully(fd, buffer.data(), nbytes, offset);
+    return static_cast<const char*>(buffer.data());
+  };
+  try {
+    if (static_cast<size_t>(size) > part_size_) {
+      multipart_upload_(s3_path, size, get_part);
+    } else {
+      std::vector<char> buffer;
+      write(target_path, get_part(0, size, buffer), size, true);
+    }
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
+}
+
+void S3FileSystem::multipart_upload_(
+    const S3Path& s3_path, const size_t size,
+    const std::function<const char*(size_t, size_t, std::vector<char>&)>& get_part) {
+  const Aws::String bucket = S3Utils::to_aws_string(s3_path.bucket);
+  const Aws::String key = S3Utils::to_aws_string(s3_path.key);
+  Aws::S3::Model::CreateMultipartUploadRequest create_request;
+  create_request.SetBucket(bucket);
+  create_request.SetKey(key);
+  auto create_outcome = client_->CreateMultipartUpload(create_request);
+  HCTR_CHECK_HINT(create_outcome.IsSuccess(), "Failed to start the multipart upload to S3.");
+  const Aws::String upload_id = create_outcome.GetResult().GetUploadId();
+
+  Aws::Vector<Aws::S3::Model::CompletedPart> parts((size + part_size_ - 1) / part_size_);
+  try {
+    IOUtils::for_each_part(
+        size, part_size_, max_concurrency_,
+        [&](const size_t part, const size_t offset, const size_t nbytes) {
+          std::vector<char> buffer;
+          const char* const data = get_part(offset, nbytes, buffer);
+          Aws::S3::Model::UploadPartRequest request;
+          request.SetBucket(bucket);
+          request.SetKey(key);
+          request.SetUploadId(upload_id);
+          request.SetPartNumber(static_cast<int>(part + 1));
+          request.SetContentLength(static_cast<long long>(nbytes));
+          request.SetBody(Aws::MakeShared<StringViewStream>("UploadPartInputStream", data, nbytes));
+          auto outcome = client_->UploadPart(request);
+          if (!outcome.IsSuccess()) {
+            HCTR_OWN_THROW(Error_t::FileCannotOpen, "Failed to upload a part to S3.");
+          }
+          parts[part].SetPartNumber(static_cast<int>(part + 1));
+          parts[part].SetETag(outcome.GetResult().GetETag());
+        });
+  } catch (...) {
+    Aws::S3::Model::AbortMultipartUploadRequest abort_request;
+    abort_request.SetBucket(bucket);
+    abort_request.SetKey(key);
+    abort_request.SetUploadId(upload_id);
+    client_->AbortMultipartUpload(abort_request);
+    throw;
+  }
+
+  Aws::S3::Model::CompletedMultipartUpload completed_upload;
+  completed_upload.SetParts(std::move(parts));
+  Aws::S3::Model::CompleteMultipartUploadRequest complete_request;
+  complete_request.SetBucket(bucket);
+  complete_request.SetKey(key);
+  complete_request.SetUploadId(upload_id);
+  complete_request.SetMultipartUpload(std::move(completed_upload));
+  auto complete_outcome = client_->CompleteMultipartUpload(complete_request);
+  HCTR_CHECK_HINT(complete_outcome.IsSuccess(), "Failed to complete the multipart upload to S3.");
 }
 
 int S3FileSystem::write(const std::string& path, const void* const data, const size_t data_size,
@@ -214,27 +326,27 @@ int S3FileSystem::write(const std::string& path, const void* const data, const s
   S3Path s3_path = S3Path::FromString(path);
   HCTR_CHECK_HINT(s3_path.has_bucket_and_key(),
                   "This S3 path does not contain bucket or key information.");
-  Aws::S3::Model::PutObjectRequest request;
-  request.SetBucket(S3Utils::to_aws_string(s3_path.bucket));
-  request.SetKey(S3Utils::to_aws_string(s3_path.key));
-
-  auto aws_stream = Aws::MakeShared<Aws::StringStream>(
-      "WriteObjectInputStream",
-      std::stringstream::in | std::stringstream::out | std::stringstream::binary);
-  aws_stream->write(reinterpret_cast<char*>(const_cast<void*>(data)), data_size);
-  request.SetBody(aws_stream);
-
-  Aws::S3::Model::PutObjectOutcome outcome = client_->PutObject(request);
-  HCTR_CHECK_HINT(outcome.IsSuccess(), "Failed to write to S3.");
+  const char* const bytes = static_cast<const char*>(data);
+  if (data_size > part_size_) {
+    multipart_upload_(s3_path, data_size, [bytes](const size_t offset, size_t, std::vector<char>&) {
+      return bytes + offset;
+    });
+  } else {
+    Aws::S3::Model::PutObjectRequest request;
+    request.SetBucket(S3Utils::to_aws_string(s3_path.bucket));
+    request.SetKey(S3Utils::to_aws_string(s3_path.key));
+    request.SetContentLength(static_cast<long long>(data_size));
+    request.SetBody(Aws::MakeShared<StringViewStream>("WriteObjectInputStream", data, data_size));
+
+    Aws::S3::Model::PutObjectOutcome outcome = client_->PutObject(request);
+    HCTR_CHECK_HINT(outcome.IsSuccess(), "Failed to write to S3.");
+  }
   HCTR_LOG_S(DEBUG, WORLD) << "Successfully write to AWS S3 location:  " << path << std::endl;
   return data_size;
 }
 
-int S3FileSystem::read(const std::string& path, void* const buffer, const size_t buffer_size,
-                       const size_t offset) {
-  size_t content_length = get_file_size(path);
-  size_t nbytes = std::min(buffer_size, content_length - offset);
-  S3Path s3_path = S3Path::FromString(path);
+size_t S3FileSystem::read_range_(const S3Path& s3_path, void* const buffer, const size_t nbytes,
+                                 const size_t offset) {
   Aws::S3::Model::GetObjectRequest get_request;
   get_request.SetBucket(S3Utils::to_aws_string(s3_path.bucket));
   get_request.SetKey(S3Utils::to_aws_string(s3_path.key));
@@ -243,10 +355,29 @@ int S3FileSystem::read(const std::string& path, void* const buffer, const size_t
   get_request.SetRange(S3Utils::to_aws_string(ss.str()));
   get_request.SetResponseStreamFactory(AwsWriteableStreamFactory(buffer, nbytes));
   Aws::S3::Model::GetObjectOutcome outcome = client_->GetObject(get_request);
-  HCTR_CHECK_HINT(outcome.IsSuccess(), "Failed to read the file.");
-  Aws::S3::Model::GetObjectResult result = std::move(outcome).GetResultWithOwnership();
-  auto& stream = result.GetBody();
-  return stream.gcount();
+  if (!outcome.IsSuccess()) {
+    HCTR_OWN_THROW(Error_t::BrokenFile, "Failed to read the file.");
+  }
+  return outcome.GetResult().GetContentLength();
+}
+
+int S3FileSystem::read(const std::string& path, void* const buffer, const size_t buffer_size,
+                       const size_t offset) {
+  size_t content_length = get_file_size(path);
+  size_t nbytes = std::min(buffer_size, content_length - offset);
+  S3Path s3_path = S3Path::FromString(path);
+  if (nbytes <= part_size_) {
+    return read_range_(s3_path, buffer, nbytes, offset);
+  }
+  // Large reads are split into ranged requests, which are sent at the same time.
+  const auto read_part = [&](const size_t part, const size_t part_offset, const size_t part_bytes) {
+    char* const part_buffer = static_cast<char*>(buffer) + part_offset;
+    if (read_range_(s3_path, part_buffer, part_bytes, offset + part_offset) != part_bytes) {
+      HCTR_OWN_THROW(Error_t::BrokenFile, "Failed to read the file.");
+    }
+  };
+  IOUtils::for_each_part(nbytes, part_size_, max_concurrency_, read_part);
+  return nbytes;
 }
 
 void S3FileSystem::copy(const std::string& source_path, const std::string& target_path) {
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <gemm_algorithm_cache.hpp>
 #include <layers/fully_connected_layer.hpp>
 #include <linalg/matrix_vector_op.cuh>
 #include <linalg/reduce.cuh>
@@ -206,6 +207,13 @@ void FullyConnectedLayer<float>::search_algorithm() {
     out_batch_size = out_batch_size * out_tensor_dim[idx];
   }
 
+  const std::string cache_key = GemmAlgorithmCache::make_key(
+      "FullyConnectedLayer<float>", in_batch_size, input_size, output_size,
+      use_mixed_precision_, enable_tf32_compute_);
+  if (GemmAlgorithmCache::get().find(cache_key, falgo_, balgo_W_, balgo_Xn_)) {
+    return;
+  }
+
   // Record time for each algorithm
   float shortestTime = 100000000.0;
   float time;
@@ -335,6 +343,7 @@ void FullyConnectedLayer<float>::search_algorithm() {
   // Gemm.\n"); Clean-up
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
+  GemmAlgorithmCache::get().insert(cache_key, falgo_, balgo_W_, balgo_Xn_);
 }
 
 std::unique_ptr<DataSimulator> FullyConnectedLayer<float>::get_uniform_initializer(
@@ -543,6 +552,13 @@ void Core23TempFullyConnectedLayer<float>::search_algorithm() {
     out_batch_size = out_batch_size * out_tensor_dim.size(idx);
   }
 
+  const std::string cache_key = GemmAlgorithmCache::make_key(
+      "FullyConnectedLayer<float>", in_batch_size, input_size, output_size,
+      use_mixed_precision_, enable_tf32_compute_);
+  if (GemmAlgorithmCache::get().find(cache_key, falgo_, balgo_W_, balgo_Xn_)) {
+    return;
+  }
+
   // Record time for each algorithm
   float shortestTime = 100000000.0;
   float time;
@@ -672,6 +688,7 @@ void Core23TempFullyConnectedLayer<float>::search_algorithm() {
   // Gemm.\n"); Clean-up
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
+  GemmAlgorithmCache::get().insert(cache_key, falgo_, balgo_W_, balgo_Xn_);
 }
 
 std::unique_ptr<DataSimulator> Core23TempFullyConnectedLayer<float>::get_uniform_initializer(
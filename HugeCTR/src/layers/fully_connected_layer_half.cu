@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <gemm_algorithm_cache.hpp>
 #include <layers/fully_connected_layer_half.hpp>
 #include <utils.cuh>
 #include <utils.hpp>
@@ -187,6 +188,12 @@ void FullyConnectedLayer<__half>::search_algorithm() {
     in_batch_size = in_batch_size * bottom_tensor_dim[idx];
   }
 
+  const std::string cache_key = GemmAlgorithmCache::make_key(
+      "FullyConnectedLayer<__half>", in_batch_size, input_size, output_size);
+  if (GemmAlgorithmCache::get().find(cache_key, falgo_b_, falgo_k_, balgo_b_, balgo_k_, balgo_x_)) {
+    return;
+  }
+
   // Record time for each algorithm
   float shortestTime = std::numeric_limits<float>::max();
   float time;
@@ -390,6 +397,7 @@ void FullyConnectedLayer<__half>::search_algorithm() {
   // Gemm.\n"); Clean-up
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
+  GemmAlgorithmCache::get().insert(cache_key, falgo_b_, falgo_k_, balgo_b_, balgo_k_, balgo_x_);
 }  // namespace HugeCTR
 
 std::unique_ptr<DataSimulator> FullyConnectedLayer<__half>::get_uniform_initializer(
@@ -616,6 +624,12 @@ void Core23TempFullyConnectedLayer<__half>::search_algorithm() {
     in_batch_size = in_batch_size * bottom_tensor_dim.size(idx);
   }
 
+  const std::string cache_key = GemmAlgorithmCache::make_key(
+      "FullyConnectedLayer<__half>", in_batch_size, input_size, output_size);
+  if (GemmAlgorithmCache::get().find(cache_key, falgo_b_, falgo_k_, balgo_b_, balgo_k_, balgo_x_)) {
+    return;
+  }
+
   // Record time for each algorithm
   float shortestTime = std::numeric_limits<float>::max();
   float time;
@@ -819,6 +833,7 @@ void Core23TempFullyConnectedLayer<__half>::search_algorithm() {
   // Gemm.\n"); Clean-up
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
+  GemmAlgorithmCache::get().insert(cache_key, falgo_b_, falgo_k_, balgo_b_, balgo_k_, balgo_x_);
 }  // namespace HugeCTR
 
 std::unique_ptr<DataSimulator> Core23TempFullyConnectedLayer<__half>::get_uniform_initializer(
@@ -0,0 +1,207 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+#include <layers/functors/fp8_gemm_functors.hpp>
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int fp8_tile_dim = 32;
+constexpr int fp8_tile_rows_per_iter = 8;
+
+__global__ void update_fp8_scaling_states_kernel(Fp8ScalingState* states, int num_states) {
+  const int i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i >= num_states) {
+    return;
+  }
+  Fp8ScalingState& state = states[i];
+  state.amax_history[state.step % FP8_AMAX_HISTORY_LEN] = state.amax;
+  state.step++;
+  state.amax = 0.f;
+
+  float amax = 0.f;
+  for (int h = 0; h < FP8_AMAX_HISTORY_LEN; h++) {
+    amax = fmaxf(amax, state.amax_history[h]);
+  }
+  // Keep the previous scale until the tensor has been seen with finite, non-zero values.
+  if (amax > 0.f && isfinite(amax)) {
+    state.scale = state.fp8_max / amax;
+    state.scale_inv = 1.f / state.scale;
+  }
+}
+
+// Each block quantizes a 32 x 32 tile, which is staged in shared memory for the transpose.
+template <typename Fp8T>
+__global__ void quantize_fp8_kernel(const __half* __restrict__ in,
+                                    const __half* __restrict__ relu_mask, Fp8T* out, Fp8T* out_t,
+                                    int64_t rows, int64_t cols, Fp8ScalingState* state,
+                                    bool update_amax, float* col_sum) {
+  __shared__ float tile[fp8_tile_dim][fp8_tile_dim + 1];
+  const float scale = state->scale;
+  const int64_t row0 = static_cast<int64_t>(blockIdx.y) * fp8_tile_dim;
+  const int64_t col0 = static_cast<int64_t>(blockIdx.x) * fp8_tile_dim;
+  const int64_t col = col0 + threadIdx.x;
+
+  float amax = 0.f;
+  float sum = 0.f;
+  for (int r = threadIdx.y; r < fp8_tile_dim; r += blockDim.y) {
+    const int64_t row = row0 + r;
+    float value = 0.f;
+    if (row < rows && col < cols) {
+      const int64_t idx = row * cols + col;
+      value = __half2float(in[idx]);
+      if (relu_mask != nullptr && !(__half2float(relu_mask[idx]) > 0.f)) {
+        value = 0.f;
+      }
+      out[idx] = Fp8T(value * scale);
+      amax = fmaxf(amax, fabsf(value));
+      sum += value;
+    }
+    tile[r][threadIdx.x] = value;
+  }
+  if (col_sum != nullptr && col < cols) {
+    atomicAdd(col_sum + col, sum);
+  }
+
+  if (out_t != nullptr) {
+    __syncthreads();
+    for (int c = threadIdx.y; c < fp8_tile_dim; c += blockDim.y) {
+      const int64_t t_row = col0 + c;
+      const int64_t t_col = row0 + threadIdx.x;
+      if (t_row < cols && t_col < rows) {
+        out_t[t_row * rows + t_col] = Fp8T(tile[threadIdx.x][c] * scale);
+      }
+    }
+  }
+
+  if (update_amax) {
+    // Each row of the block is a warp. The amaxes are non-negative, so that their order is the
+    // order of their bits as integers.
+    amax = warpReduceMax(amax);
+    if (threadIdx.x == 0) {
+      atomicMax(reinterpret_cast<int*>(&state->amax), __float_as_int(amax));
+    }
+  }
+}
+
+}  // namespace
+
+Fp8ScalingState make_fp8_scaling_state(const float fp8_max) {
+  Fp8ScalingState state{};
+  state.scale = 1.f;
+  state.scale_inv = 1.f;
+  state.fp8_max = fp8_max;
+  return state;
+}
+
+void update_fp8_scaling_states(Fp8ScalingState* states, const int num_states,
+                               cudaStream_t stream) {
+  constexpr int block_size = 128;
+  update_fp8_scaling_states_kernel<<<(num_states - 1) / block_size + 1, block_size, 0, stream>>>(
+      states, num_states);
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+template <typename Fp8T>
+void quantize_fp8(const __half* in, const __half* relu_mask, Fp8T* out, Fp8T* out_t,
+                  const int64_t rows, const int64_t cols, Fp8ScalingState* state,
+                  const bool update_amax, float* col_sum, cudaStream_t stream) {
+  const dim3 grid(ceildiv<int64_t>(cols, fp8_tile_dim), ceildiv<int64_t>(rows, fp8_tile_dim));
+  const dim3 block(fp8_tile_dim, fp8_tile_rows_per_iter);
+  quantize_fp8_kernel<<<grid, block, 0, stream>>>(in, relu_mask, out, out_t, rows, cols, state,
+                                                  update_amax, col_sum);
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
+template void quantize_fp8(const __half*, const __half*, __nv_fp8_e4m3*, __nv_fp8_e4m3*, int64_t,
+                           int64_t, Fp8ScalingState*, bool, float*, cudaStream_t);
+template void quantize_fp8(const __half*, const __half*, __nv_fp8_e5m2*, __nv_fp8_e5m2*, int64_t,
+                           int64_t, Fp8ScalingState*, bool, float*, cudaStream_t);
+
+void CublasFp8Gemm::init(const int64_t m, const int64_t n, const int64_t k,
+                         const cudaDataType a_type, const cudaDataType b_type,
+                         const float* a_scale_inv, const float* b_scale_inv,
+                         const __half* bias_ptr, const Activation_t act, const bool fast_accum,
+                         cublasLtHandle_t cublaslt_handle) {
+  HCTR_LIB_THROW(cublasLtMatmulDescCreate(&cublas_op_desc, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+
+  const cublasOperation_t op_a = CUBLAS_OP_T;
+  const cublasOperation_t op_b = CUBLAS_OP_N;
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_TRANSA, &op_a,
+                                                sizeof(op_a)));
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_TRANSB, &op_b,
+                                                sizeof(op_b)));
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(
+      cublas_op_desc, CUBLASLT_MATMUL_DESC_A_SCALE_POINTER, &a_scale_inv, sizeof(a_scale_inv)));
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(
+      cublas_op_desc, CUBLASLT_MATMUL_DESC_B_SCALE_POINTER, &b_scale_inv, sizeof(b_scale_inv)));
+  const int8_t fast_accum_mode = fast_accum;
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_FAST_ACCUM,
+                                                &fast_accum_mode, sizeof(fast_accum_mode)));
+
+  cublasLtEpilogue_t epilogue =
+      act == Activation_t::Relu ? CUBLASLT_EPILOGUE_RELU : CUBLASLT_EPILOGUE_DEFAULT;
+  if (bias_ptr != nullptr) {
+    epilogue = act == Activation_t::Relu ? CUBLASLT_EPILOGUE_RELU_BIAS : CUBLASLT_EPILOGUE_BIAS;
+    HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+                                                  &bias_ptr, sizeof(bias_ptr)));
+  }
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                                &epilogue, sizeof(epilogue)));
+
+  HCTR_LIB_THROW(cublasLtMatrixLayoutCreate(&cublas_mat_a_desc, a_type, k, m, k));
+  HCTR_LIB_THROW(cublasLtMatrixLayoutCreate(&cublas_mat_b_desc, b_type, k, n, k));
+  HCTR_LIB_THROW(cublasLtMatrixLayoutCreate(&cublas_mat_c_desc, CUDA_R_16F, m, n, m));
+
+  HCTR_LIB_THROW(cublasLtMatmulPreferenceCreate(&cublas_preference));
+  HCTR_LIB_THROW(cudaMalloc(&cublaslt_workspace, cublaslt_workspace_size));
+  HCTR_LIB_THROW(cublasLtMatmulPreferenceSetAttribute(
+      cublas_preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &cublaslt_workspace_size,
+      sizeof(cublaslt_workspace_size)));
+
+  cublasLtMatmulHeuristicResult_t heuristic_result;
+  int returned_res = 0;
+  HCTR_LIB_THROW(cublasLtMatmulAlgoGetHeuristic(
+      cublaslt_handle, cublas_op_desc, cublas_mat_a_desc, cublas_mat_b_desc, cublas_mat_c_desc,
+      cublas_mat_c_desc, cublas_preference, 1, &heuristic_result, &returned_res));
+  if (returned_res == 0) {
+    HCTR_LIB_THROW(CUBLAS_STATUS_NOT_SUPPORTED);
+  }
+  algo = heuristic_result.algo;
+}
+
+void CublasFp8Gemm::operator()(const void* mat_a, const void* mat_b, const float beta,
+                               __half* mat_d, cublasLtHandle_t cublaslt_handle,
+                               cudaStream_t stream) const {
+  const float alpha = 1.0f;
+  HCTR_LIB_THROW(cublasLtMatmul(cublaslt_handle, cublas_op_desc, &alpha, mat_a, cublas_mat_a_desc,
+                                mat_b, cublas_mat_b_desc, &beta, mat_d, cublas_mat_c_desc, mat_d,
+                                cublas_mat_c_desc, &algo, cublaslt_workspace,
+                                cublaslt_workspace_size, stream));
+}
+
+CublasFp8Gemm::~CublasFp8Gemm() {
+  cudaFree(cublaslt_workspace);
+  cublasLtMatmulPreferenceDestroy(cublas_preference);
+  cublasLtMatmulDescDestroy(cublas_op_desc);
+  cublasLtMatrixLayoutDestroy(cublas_mat_a_desc);
+  cublasLtMatrixLayoutDestroy(cublas_mat_b_desc);
+  cublasLtMatrixLayoutDestroy(cublas_mat_c_desc);
+}
+
+}  // namespace HugeCTR
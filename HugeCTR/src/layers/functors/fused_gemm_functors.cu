@@ -14,10 +14,41 @@
  * limitations under the License.
  */
 
+#include <gemm_algorithm_cache.hpp>
 #include <layers/functors/fused_gemm_functors.hpp>
 
 namespace HugeCTR {
 
+namespace {
+
+// Key of the GEMM of cublas_desc in the GEMM algorithm cache, made of its compute type,
+// operations, epilogue and matrix layouts.
+template <typename T>
+std::string get_algorithm_cache_key(const CublasDesc<T>& cublas_desc) {
+  std::vector<int64_t> params{static_cast<int64_t>(sizeof(T))};
+  size_t size_written = 0;
+  for (const auto attr : {CUBLASLT_MATMUL_DESC_COMPUTE_TYPE, CUBLASLT_MATMUL_DESC_TRANSA,
+                          CUBLASLT_MATMUL_DESC_TRANSB, CUBLASLT_MATMUL_DESC_EPILOGUE}) {
+    int32_t value = 0;
+    HCTR_LIB_THROW(cublasLtMatmulDescGetAttribute(cublas_desc.cublas_op_desc, attr, &value,
+                                                  sizeof(value), &size_written));
+    params.push_back(value);
+  }
+  for (const auto layout : {cublas_desc.cublas_mat_a_desc, cublas_desc.cublas_mat_b_desc,
+                            cublas_desc.cublas_mat_c_desc}) {
+    for (const auto attr : {CUBLASLT_MATRIX_LAYOUT_ROWS, CUBLASLT_MATRIX_LAYOUT_COLS,
+                            CUBLASLT_MATRIX_LAYOUT_LD}) {
+      int64_t value = 0;
+      HCTR_LIB_THROW(
+          cublasLtMatrixLayoutGetAttribute(layout, attr, &value, sizeof(value), &size_written));
+      params.push_back(value);
+    }
+  }
+  return GemmAlgorithmCache::make_key("cublasLt", params);
+}
+
+}  // namespace
+
 template <typename T>
 void CublasDesc<T>::set_fprop_attr(std::vector<size_t> dims_a, std::vector<size_t> dims_b,
                                    cublasOperation_t op_a, cublasOperation_t op_b,
@@ -217,6 +248,10 @@ void CublasAlgo<T>::search_algorithm(const float alpha, const T* mat_a, const T*
   if (!initialized) {
     init_algorithm(cublas_desc, cublaslt_handle);
   }
+  const std::string cache_key = get_algorithm_cache_key(cublas_desc);
+  if (GemmAlgorithmCache::get().find(cache_key, algo)) {
+    return;
+  }
   const size_t repeat_num = 100;
   const int max_algo_count = 16;
 
@@ -263,6 +298,7 @@ void CublasAlgo<T>::search_algorithm(const float alpha, const T* mat_a, const T*
 
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
+  GemmAlgorithmCache::get().insert(cache_key, algo);
 }
 
 template <typename T>
@@ -0,0 +1,109 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+#include <layers/functors/grouped_gemm_functors.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+void create_layout(cublasLtMatrixLayout_t* desc, cudaDataType data_type,
+                   const GroupedGemmOperand& operand, int num_groups) {
+  HCTR_LIB_THROW(
+      cublasLtMatrixLayoutCreate(desc, data_type, operand.rows, operand.cols, operand.ld));
+  if (num_groups > 1) {
+    HCTR_LIB_THROW(cublasLtMatrixLayoutSetAttribute(*desc, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT,
+                                                    &num_groups, sizeof(num_groups)));
+    HCTR_LIB_THROW(cublasLtMatrixLayoutSetAttribute(
+        *desc, CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET, &operand.stride,
+        sizeof(operand.stride)));
+  }
+}
+
+}  // namespace
+
+void CublasGroupedGemm::init(const cublasOperation_t op_a, const cublasOperation_t op_b,
+                             const GroupedGemmOperand& a, const GroupedGemmOperand& b,
+                             const GroupedGemmOperand& d, const int num_groups,
+                             const cudaDataType data_type, const bool enable_tf32_compute,
+                             const void* bias_ptr, const int64_t bias_stride,
+                             const Activation_t act, cublasLtHandle_t cublaslt_handle) {
+  const cublasComputeType_t compute_type = data_type == CUDA_R_32F && enable_tf32_compute
+                                               ? CUBLAS_COMPUTE_32F_FAST_TF32
+                                               : CUBLAS_COMPUTE_32F;
+  HCTR_LIB_THROW(cublasLtMatmulDescCreate(&cublas_op_desc, compute_type, CUDA_R_32F));
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_TRANSA, &op_a,
+                                                sizeof(op_a)));
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_TRANSB, &op_b,
+                                                sizeof(op_b)));
+
+  cublasLtEpilogue_t epilogue =
+      act == Activation_t::Relu ? CUBLASLT_EPILOGUE_RELU : CUBLASLT_EPILOGUE_DEFAULT;
+  if (bias_ptr != nullptr) {
+    epilogue = act == Activation_t::Relu ? CUBLASLT_EPILOGUE_RELU_BIAS : CUBLASLT_EPILOGUE_BIAS;
+    HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+                                                  &bias_ptr, sizeof(bias_ptr)));
+    if (num_groups > 1) {
+      HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc,
+                                                    CUBLASLT_MATMUL_DESC_BIAS_BATCH_STRIDE,
+                                                    &bias_stride, sizeof(bias_stride)));
+    }
+  }
+  HCTR_LIB_THROW(cublasLtMatmulDescSetAttribute(cublas_op_desc, CUBLASLT_MATMUL_DESC_EPILOGUE,
+                                                &epilogue, sizeof(epilogue)));
+
+  create_layout(&cublas_mat_a_desc, data_type, a, num_groups);
+  create_layout(&cublas_mat_b_desc, data_type, b, num_groups);
+  create_layout(&cublas_mat_d_desc, data_type, d, num_groups);
+
+  HCTR_LIB_THROW(cublasLtMatmulPreferenceCreate(&cublas_preference));
+  HCTR_LIB_THROW(cudaMalloc(&cublaslt_workspace, cublaslt_workspace_size));
+  HCTR_LIB_THROW(cublasLtMatmulPreferenceSetAttribute(
+      cublas_preference, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &cublaslt_workspace_size,
+      sizeof(cublaslt_workspace_size)));
+
+  cublasLtMatmulHeuristicResult_t heuristic_result;
+  int returned_res = 0;
+  HCTR_LIB_THROW(cublasLtMatmulAlgoGetHeuristic(
+      cublaslt_handle, cublas_op_desc, cublas_mat_a_desc, cublas_mat_b_desc, cublas_mat_d_desc,
+      cublas_mat_d_desc, cublas_preference, 1, &heuristic_result, &returned_res));
+  if (returned_res == 0) {
+    HCTR_LIB_THROW(CUBLAS_STATUS_NOT_SUPPORTED);
+  }
+  algo = heuristic_result.algo;
+}
+
+void CublasGroupedGemm::operator()(const void* mat_a, const void* mat_b, const float beta,
+                                   void* mat_d, cublasLtHandle_t cublaslt_handle,
+                                   cudaStream_t stream) const {
+  const float alpha = 1.0f;
+  HCTR_LIB_THROW(cublasLtMatmul(cublaslt_handle, cublas_op_desc, &alpha, mat_a, cublas_mat_a_desc,
+                                mat_b, cublas_mat_b_desc, &beta, mat_d, cublas_mat_d_desc, mat_d,
+                                cublas_mat_d_desc, &algo, cublaslt_workspace,
+                                cublaslt_workspace_size, stream));
+}
+
+CublasGroupedGemm::~CublasGroupedGemm() {
+  cudaFree(cublaslt_workspace);
+  cublasLtMatmulPreferenceDestroy(cublas_preference);
+  cublasLtMatmulDescDestroy(cublas_op_desc);
+  cublasLtMatrixLayoutDestroy(cublas_mat_a_desc);
+  cublasLtMatrixLayoutDestroy(cublas_mat_b_desc);
+  cublasLtMatrixLayoutDestroy(cublas_mat_d_desc);
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,470 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+#include <curand_kernel.h>
+
+#include <algorithm>
+#include <layers/fused_add_layer_norm_layer.hpp>
+#include <network_buffer_channels.hpp>
+#include <type_traits>
+#include <utils.cuh>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int WARPS_PER_BLOCK = 4;
+
+int64_t get_elements_per_lane(int64_t hidden_dim) { return (hidden_dim - 1) / WARP_SIZE + 1; }
+
+// 32 bit words of mask per lane and row, with a bit per element of the lane
+int64_t get_mask_words(int64_t hidden_dim) {
+  return (get_elements_per_lane(hidden_dim) - 1) / 32 + 1;
+}
+
+// Calls launch with the number of elements per lane in the registers, which is 0 for the rows
+// longer than 1024 that are read again from the global memory.
+template <typename Launch>
+void dispatch_elements_per_lane(int64_t hidden_dim, Launch launch) {
+  const int64_t n = get_elements_per_lane(hidden_dim);
+  if (n <= 1) {
+    launch(std::integral_constant<int, 1>());
+  } else if (n <= 2) {
+    launch(std::integral_constant<int, 2>());
+  } else if (n <= 4) {
+    launch(std::integral_constant<int, 4>());
+  } else if (n <= 8) {
+    launch(std::integral_constant<int, 8>());
+  } else if (n <= 16) {
+    launch(std::integral_constant<int, 16>());
+  } else if (n <= 32) {
+    launch(std::integral_constant<int, 32>());
+  } else {
+    launch(std::integral_constant<int, 0>());
+  }
+}
+
+template <typename T>
+struct FpropParams {
+  const T* x;
+  const T* residual;
+  const T* gamma;
+  const T* beta;
+  T* out;
+  uint32_t* mask;
+  float* mean;
+  float* rstd;
+  int64_t rows;
+  int hidden_dim;
+  int mask_words;
+  float eps;
+  float dropout_rate;
+  bool dropout;
+  uint64_t seed;
+  const uint64_t* iteration;
+};
+
+template <typename T>
+struct BpropParams {
+  const T* top_grad;
+  T* x;
+  T* residual;
+  const T* gamma;
+  const uint32_t* mask;
+  const float* mean;
+  const float* rstd;
+  float* partial_gamma_grad;
+  float* partial_beta_grad;
+  int64_t rows;
+  int hidden_dim;
+  int mask_words;
+  float dropout_rate;
+  bool dropout;
+};
+
+template <typename T>
+__device__ __forceinline__ float load_sum(const T* x, const T* residual, int64_t idx, bool keep,
+                                          float scale) {
+  const float x_value = TypeConvertFunc<float, T>::convert(x[idx]);
+  return (keep ? x_value * scale : 0.f) + TypeConvertFunc<float, T>::convert(residual[idx]);
+}
+
+// Whether the dropout keeps element i of the lane, loading the next word of its mask into bits.
+__device__ __forceinline__ bool get_keep(const uint32_t* mask, bool dropout, int i,
+                                         uint32_t& bits) {
+  if (!dropout) {
+    return true;
+  }
+  if (i % 32 == 0) {
+    bits = mask[i / 32 * WARP_SIZE];
+  }
+  return (bits >> (i % 32)) & 1u;
+}
+
+template <typename T, int VPT>
+__global__ void fused_add_layer_norm_fprop_kernel(const FpropParams<T> p) {
+  const int lane = threadIdx.x;
+  const int64_t num_warps = static_cast<int64_t>(gridDim.x) * blockDim.y;
+  const int num_per_lane = VPT > 0 ? VPT : (p.hidden_dim - 1) / WARP_SIZE + 1;
+  const float scale = p.dropout ? 1.f / (1.f - p.dropout_rate) : 1.f;
+  for (int64_t row = blockIdx.x * blockDim.y + threadIdx.y; row < p.rows; row += num_warps) {
+    const int64_t offset = row * p.hidden_dim;
+    uint32_t* mask = p.mask + row * p.mask_words * WARP_SIZE + lane;
+    curandStatePhilox4_32_10_t rng;
+    if (p.dropout) {
+      curand_init(p.seed, row * WARP_SIZE + lane, *p.iteration * num_per_lane, &rng);
+    }
+
+    // residual + dropout(x), the rows longer than 1024 are recomputed from the saved mask
+    float values[VPT > 0 ? VPT : 1];
+    float sum = 0.f;
+    uint32_t bits = 0;
+#pragma unroll
+    for (int i = 0; i < num_per_lane; i++) {
+      const int col = lane + i * WARP_SIZE;
+      float value = 0.f;
+      if (col < p.hidden_dim) {
+        bool keep = true;
+        if (p.dropout) {
+          keep = curand_uniform(&rng) > p.dropout_rate;
+          bits |= static_cast<uint32_t>(keep) << (i % 32);
+        }
+        value = load_sum(p.x, p.residual, offset + col, keep, scale);
+      }
+      if constexpr (VPT > 0) {
+        values[i] = value;
+      }
+      sum += value;
+      if (p.dropout && (i % 32 == 31 || i == num_per_lane - 1)) {
+        mask[i / 32 * WARP_SIZE] = bits;
+        bits = 0;
+      }
+    }
+    const float mean = warpReduceSum(sum) / p.hidden_dim;
+
+    float variance = 0.f;
+#pragma unroll
+    for (int i = 0; i < num_per_lane; i++) {
+      const int col = lane + i * WARP_SIZE;
+      if (col < p.hidden_dim) {
+        float value;
+        if constexpr (VPT > 0) {
+          value = values[i];
+        } else {
+          const bool keep = get_keep(mask, p.dropout, i, bits);
+          value = load_sum(p.x, p.residual, offset + col, keep, scale);
+        }
+        variance += (value - mean) * (value - mean);
+      }
+    }
+    const float rstd = rsqrtf(warpReduceSum(variance) / p.hidden_dim + p.eps);
+    if (lane == 0) {
+      p.mean[row] = mean;
+      p.rstd[row] = rstd;
+    }
+
+#pragma unroll
+    for (int i = 0; i < num_per_lane; i++) {
+      const int col = lane + i * WARP_SIZE;
+      if (col < p.hidden_dim) {
+        float value;
+        if constexpr (VPT > 0) {
+          value = values[i];
+        } else {
+          const bool keep = get_keep(mask, p.dropout, i, bits);
+          value = load_sum(p.x, p.residual, offset + col, keep, scale);
+        }
+        const float gamma = TypeConvertFunc<float, T>::convert(__ldg(p.gamma + col));
+        const float beta = TypeConvertFunc<float, T>::convert(__ldg(p.beta + col));
+        const float out = (value - mean) * rstd * gamma + beta;
+        p.out[offset + col] = TypeConvertFunc<T, float>::convert(out);
+      }
+    }
+  }
+}
+
+template <typename T, int VPT>
+__global__ void fused_add_layer_norm_bprop_kernel(const BpropParams<T> p) {
+  const int lane = threadIdx.x;
+  const int64_t warp = blockIdx.x * blockDim.y + threadIdx.y;
+  const int64_t num_warps = static_cast<int64_t>(gridDim.x) * blockDim.y;
+  const int num_per_lane = VPT > 0 ? VPT : (p.hidden_dim - 1) / WARP_SIZE + 1;
+  const float scale = p.dropout ? 1.f / (1.f - p.dropout_rate) : 1.f;
+
+  // The gradients of gamma and beta of the rows of this warp, in the registers or directly in
+  // the partial sums otherwise.
+  float* partial_gamma_grad = p.partial_gamma_grad + warp * p.hidden_dim;
+  float* partial_beta_grad = p.partial_beta_grad + warp * p.hidden_dim;
+  float gamma_grads[VPT > 0 ? VPT : 1];
+  float beta_grads[VPT > 0 ? VPT : 1];
+#pragma unroll
+  for (int i = 0; i < num_per_lane; i++) {
+    if constexpr (VPT > 0) {
+      gamma_grads[i] = 0.f;
+      beta_grads[i] = 0.f;
+    } else {
+      const int col = lane + i * WARP_SIZE;
+      if (col < p.hidden_dim) {
+        partial_gamma_grad[col] = 0.f;
+        partial_beta_grad[col] = 0.f;
+      }
+    }
+  }
+
+  for (int64_t row = warp; row < p.rows; row += num_warps) {
+    const int64_t offset = row * p.hidden_dim;
+    const uint32_t* mask = p.mask + row * p.mask_words * WARP_SIZE + lane;
+    const float mean = p.mean[row];
+    const float rstd = p.rstd[row];
+
+    // normalized values and gradients of them
+    float xhats[VPT > 0 ? VPT : 1];
+    float grads[VPT > 0 ? VPT : 1];
+    float grad_sum = 0.f;
+    float grad_xhat_sum = 0.f;
+    uint32_t bits = 0;
+#pragma unroll
+    for (int i = 0; i < num_per_lane; i++) {
+      const int col = lane + i * WARP_SIZE;
+      const bool keep = get_keep(mask, p.dropout, i, bits);
+      if (col < p.hidden_dim) {
+        const float xhat = (load_sum(p.x, p.residual, offset + col, keep, scale) - mean) * rstd;
+        const float top_grad = TypeConvertFunc<float, T>::convert(p.top_grad[offset + col]);
+        const float grad = top_grad * TypeConvertFunc<float, T>::convert(__ldg(p.gamma + col));
+        if constexpr (VPT > 0) {
+          xhats[i] = xhat;
+          grads[i] = grad;
+          gamma_grads[i] += top_grad * xhat;
+          beta_grads[i] += top_grad;
+        } else {
+          partial_gamma_grad[col] += top_grad * xhat;
+          partial_beta_grad[col] += top_grad;
+        }
+        grad_sum += grad;
+        grad_xhat_sum += grad * xhat;
+      }
+    }
+    const float grad_mean = warpReduceSum(grad_sum) / p.hidden_dim;
+    const float grad_xhat_mean = warpReduceSum(grad_xhat_sum) / p.hidden_dim;
+
+#pragma unroll
+    for (int i = 0; i < num_per_lane; i++) {
+      const int col = lane + i * WARP_SIZE;
+      const bool keep = get_keep(mask, p.dropout, i, bits);
+      if (col < p.hidden_dim) {
+        float xhat, grad;
+        if constexpr (VPT > 0) {
+          xhat = xhats[i];
+          grad = grads[i];
+        } else {
+          xhat = (load_sum(p.x, p.residual, offset + col, keep, scale) - mean) * rstd;
+          grad = TypeConvertFunc<float, T>::convert(p.top_grad[offset + col]) *
+                 TypeConvertFunc<float, T>::convert(__ldg(p.gamma + col));
+        }
+        const float sum_grad = rstd * (grad - grad_mean - xhat * grad_xhat_mean);
+        p.residual[offset + col] = TypeConvertFunc<T, float>::convert(sum_grad);
+        p.x[offset + col] = TypeConvertFunc<T, float>::convert(keep ? sum_grad * scale : 0.f);
+      }
+    }
+  }
+
+  if constexpr (VPT > 0) {
+#pragma unroll
+    for (int i = 0; i < VPT; i++) {
+      const int col = lane + i * WARP_SIZE;
+      if (col < p.hidden_dim) {
+        partial_gamma_grad[col] = gamma_grads[i];
+        partial_beta_grad[col] = beta_grads[i];
+      }
+    }
+  }
+}
+
+template <typename T>
+__global__ void fused_add_layer_norm_wgrad_kernel(const float* partial_gamma_grad,
+                                                  const float* partial_beta_grad, int num_warps,
+                                                  int hidden_dim, T* gamma_grad, T* beta_grad) {
+  for (int col = blockIdx.x * blockDim.x + threadIdx.x; col < hidden_dim;
+       col += blockDim.x * gridDim.x) {
+    float gamma_sum = 0.f;
+    float beta_sum = 0.f;
+    for (int warp = 0; warp < num_warps; warp++) {
+      gamma_sum += partial_gamma_grad[static_cast<int64_t>(warp) * hidden_dim + col];
+      beta_sum += partial_beta_grad[static_cast<int64_t>(warp) * hidden_dim + col];
+    }
+    gamma_grad[col] = TypeConvertFunc<T, float>::convert(gamma_sum);
+    beta_grad[col] = TypeConvertFunc<T, float>::convert(beta_sum);
+  }
+}
+
+__global__ void advance_iteration_kernel(uint64_t* iteration) { ++*iteration; }
+
+}  // namespace
+
+template <typename T>
+Core23TempFusedAddLayerNormLayer<T>::Core23TempFusedAddLayerNormLayer(
+    const core23::Tensor& x_tensor, const core23::Tensor& residual_tensor,
+    const core23::Tensor& out_tensor, const Params& params, uint64_t seed,
+    const std::shared_ptr<GPUResource>& gpu_resource, std::vector<Initializer_t> initializer_types)
+    : Base({x_tensor, residual_tensor}, {out_tensor}, gpu_resource, initializer_types),
+      params_(params),
+      seed_(seed),
+      is_train_(true) {
+  CudaDeviceContext context(this->get_device_id());
+  const auto& shape = x_tensor.shape();
+  if (residual_tensor.shape() != shape || out_tensor.shape() != shape) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "x, residual and out must have the same shape");
+  }
+  if (shape.dims() > 4 || shape.dims() < 2) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Only 2D 3D 4D tensors can be layer-normed");
+  }
+  if (params_.dropout_rate < 0.f || params_.dropout_rate >= 1.f) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "The dropout rate must be in [0, 1)");
+  }
+  hidden_dim_ = shape.size(shape.dims() - 1);
+  rows_ = shape.size() / hidden_dim_;
+  if (hidden_dim_ > 65535) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "Unsupported hidden_dim, the last dim should not be longer than 65535");
+  }
+  const int64_t max_blocks = this->get_gpu().get_sm_count() * 2;
+  num_warps_ = std::min((rows_ - 1) / WARPS_PER_BLOCK + 1, max_blocks) * WARPS_PER_BLOCK;
+
+  core23::Shape gamma_dim = {hidden_dim_, 1};
+  this->set_weight(0, gamma_dim);
+  this->set_weight(1, gamma_dim);
+  gamma_ = this->get_weight(0);
+  beta_ = this->get_weight(1);
+  this->set_wgrad(0, gamma_dim);
+  this->set_wgrad(1, gamma_dim);
+  gamma_grad_ = this->get_wgrad(0);
+  beta_grad_ = this->get_wgrad(1);
+
+  core23::BufferParams blobs_buffer_params = {};
+  blobs_buffer_params.channel = GetBlobsBufferChannel();
+  core23::TensorParams tensor_params =
+      core23::TensorParams()
+          .device(core23::Device(core23::DeviceType::GPU, gpu_resource->get_device_id()))
+          .buffer_params(blobs_buffer_params);
+  mean_ = core23::Tensor(tensor_params.data_type(core23::ScalarType::Float).shape({rows_}));
+  rstd_ = core23::Tensor(tensor_params.data_type(core23::ScalarType::Float).shape({rows_}));
+  partial_gamma_grad_ = core23::Tensor(
+      tensor_params.data_type(core23::ScalarType::Float).shape({num_warps_, hidden_dim_}));
+  partial_beta_grad_ = core23::Tensor(
+      tensor_params.data_type(core23::ScalarType::Float).shape({num_warps_, hidden_dim_}));
+  if (params_.dropout_rate > 0.f) {
+    mask_ = core23::Tensor(tensor_params.data_type(core23::ScalarType::UInt32)
+                               .shape({rows_, get_mask_words(hidden_dim_) * WARP_SIZE}));
+    iteration_ = core23::Tensor(tensor_params.data_type(core23::ScalarType::UInt64).shape({1}));
+  }
+}
+
+template <typename T>
+void Core23TempFusedAddLayerNormLayer<T>::initialize() {
+  if (!iteration_.empty()) {
+    CudaDeviceContext context(this->get_device_id());
+    HCTR_LIB_THROW(cudaMemsetAsync(iteration_.data(), 0, iteration_.num_bytes(),
+                                   this->get_gpu().get_stream()));
+  }
+}
+
+template <typename T>
+void Core23TempFusedAddLayerNormLayer<T>::fprop(bool is_train) {
+  CudaDeviceContext context(this->get_device_id());
+  is_train_ = is_train;
+  const bool dropout = is_train && params_.dropout_rate > 0.f;
+  auto stream = this->get_gpu().get_stream();
+  if (dropout) {
+    advance_iteration_kernel<<<1, 1, 0, stream>>>(iteration_.data<uint64_t>());
+  }
+
+  FpropParams<T> params{this->input_tensors_[0].template data<T>(),
+                        this->input_tensors_[1].template data<T>(),
+                        gamma_.data<T>(),
+                        beta_.data<T>(),
+                        this->output_tensors_[0].template data<T>(),
+                        dropout ? mask_.data<uint32_t>() : nullptr,
+                        mean_.data<float>(),
+                        rstd_.data<float>(),
+                        rows_,
+                        static_cast<int>(hidden_dim_),
+                        static_cast<int>(get_mask_words(hidden_dim_)),
+                        static_cast<float>(params_.eps),
+                        params_.dropout_rate,
+                        dropout,
+                        seed_,
+                        dropout ? iteration_.data<uint64_t>() : nullptr};
+  const dim3 block_size(WARP_SIZE, WARPS_PER_BLOCK);
+  const int grid_size = num_warps_ / WARPS_PER_BLOCK;
+  dispatch_elements_per_lane(hidden_dim_, [&](auto vpt) {
+    fused_add_layer_norm_fprop_kernel<T, decltype(vpt)::value>
+        <<<grid_size, block_size, 0, stream>>>(params);
+  });
+}
+
+template <typename T>
+void Core23TempFusedAddLayerNormLayer<T>::bprop() {
+  CudaDeviceContext context(this->get_device_id());
+  const bool dropout = is_train_ && params_.dropout_rate > 0.f;
+  auto stream = this->get_gpu().get_stream();
+
+  BpropParams<T> params{this->output_tensors_[0].template data<T>(),
+                        this->input_tensors_[0].template data<T>(),
+                        this->input_tensors_[1].template data<T>(),
+                        gamma_.data<T>(),
+                        dropout ? mask_.data<uint32_t>() : nullptr,
+                        mean_.data<float>(),
+                        rstd_.data<float>(),
+                        partial_gamma_grad_.data<float>(),
+                        partial_beta_grad_.data<float>(),
+                        rows_,
+                        static_cast<int>(hidden_dim_),
+                        static_cast<int>(get_mask_words(hidden_dim_)),
+                        params_.dropout_rate,
+                        dropout};
+  const dim3 block_size(WARP_SIZE, WARPS_PER_BLOCK);
+  const int grid_size = num_warps_ / WARPS_PER_BLOCK;
+  dispatch_elements_per_lane(hidden_dim_, [&](auto vpt) {
+    fused_add_layer_norm_bprop_kernel<T, decltype(vpt)::value>
+        <<<grid_size, block_size, 0, stream>>>(params);
+  });
+
+  const int wgrad_block_size = 256;
+  const int wgrad_grid_size = (hidden_dim_ - 1) / wgrad_block_size + 1;
+  fused_add_layer_norm_wgrad_kernel<<<wgrad_grid_size, wgrad_block_size, 0, stream>>>(
+      partial_gamma_grad_.data<float>(), partial_beta_grad_.data<float>(), num_warps_,
+      hidden_dim_, gamma_grad_.data<T>(), beta_grad_.data<T>());
+}
+
+template <typename T>
+std::unique_ptr<DataSimulator> Core23TempFusedAddLayerNormLayer<T>::get_default_initializer(
+    const int index) {
+  std::unique_ptr<DataSimulator> simu;
+  if (0 == index) {
+    simu.reset(new ConstantDataSimulator(1.0f));
+  } else if (1 == index) {
+    simu.reset(new ConstantDataSimulator(0.0f));
+  } else {
+    HCTR_OWN_THROW(Error_t::OutOfBound, "index != {0, 1}.");
+  }
+  return simu;
+}
+
+template class Core23TempFusedAddLayerNormLayer<float>;
+template class Core23TempFusedAddLayerNormLayer<__half>;
+
+}  // namespace HugeCTR
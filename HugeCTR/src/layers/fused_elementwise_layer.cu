@@ -0,0 +1,313 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+#include <curand_kernel.h>
+
+#include <algorithm>
+#include <layers/fused_elementwise_layer.hpp>
+#include <network_buffer_channels.hpp>
+#include <utils.cuh>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+template <typename T>
+struct FusedElementwiseParams {
+  T* inputs[FUSED_ELEMENTWISE_MAX_INPUTS];
+  FusedElementwiseOp ops[FUSED_ELEMENTWISE_MAX_OPS];
+  int num_ops;
+  int64_t num_elements;
+  bool has_dropout;
+  bool is_train;
+  uint64_t seed;
+  const uint64_t* iteration;
+};
+
+__device__ __forceinline__ int get_num_operands(const FusedElementwiseOp& op) {
+  return op.num_inputs + (op.chain_pos >= 0 ? 1 : 0);
+}
+
+// The input tensor of operand j of op, which must not be the result of the previous op.
+template <typename T>
+__device__ __forceinline__ T* get_operand_input(const FusedElementwiseParams<T>& p,
+                                                const FusedElementwiseOp& op, int j) {
+  return p.inputs[op.first_input + (op.chain_pos >= 0 && j > op.chain_pos ? j - 1 : j)];
+}
+
+template <typename T>
+__device__ __forceinline__ void load_operands(const FusedElementwiseParams<T>& p,
+                                              const FusedElementwiseOp& op, float chain,
+                                              int64_t idx, float* operands) {
+  for (int j = 0; j < get_num_operands(op); j++) {
+    operands[j] = j == op.chain_pos
+                      ? chain
+                      : TypeConvertFunc<float, T>::convert(get_operand_input(p, op, j)[idx]);
+  }
+}
+
+// Each element draws at most one number per op, so that the iterations don't overlap.
+template <typename T>
+__device__ __forceinline__ void init_rng(const FusedElementwiseParams<T>& p, int64_t idx,
+                                         curandStatePhilox4_32_10_t& rng) {
+  if (p.has_dropout && p.is_train) {
+    curand_init(p.seed, idx, *p.iteration * FUSED_ELEMENTWISE_MAX_OPS, &rng);
+  }
+}
+
+__global__ void advance_iteration_kernel(uint64_t* iteration) { ++*iteration; }
+
+// Applies op k, recording in keep_mask whether a dropout keeps the element.
+template <typename T>
+__device__ float fprop_op(const FusedElementwiseParams<T>& p, int k, float chain, int64_t idx,
+                          curandStatePhilox4_32_10_t& rng, uint32_t& keep_mask) {
+  const FusedElementwiseOp& op = p.ops[k];
+  float operands[FUSED_ELEMENTWISE_MAX_INPUTS + 1];
+  load_operands(p, op, chain, idx, operands);
+  const int num_operands = get_num_operands(op);
+  switch (op.type) {
+    case FusedElementwiseOp_t::Add: {
+      float sum = 0.f;
+      for (int j = 0; j < num_operands; j++) {
+        sum += operands[j];
+      }
+      return sum;
+    }
+    case FusedElementwiseOp_t::Sub:
+      return operands[0] - operands[1];
+    case FusedElementwiseOp_t::Multiply: {
+      float product = 1.f;
+      for (int j = 0; j < num_operands; j++) {
+        product *= operands[j];
+      }
+      return product;
+    }
+    case FusedElementwiseOp_t::Relu:
+      return operands[0] > 0.f ? operands[0] : 0.f;
+    case FusedElementwiseOp_t::Sigmoid:
+      return 1.f / (1.f + __expf(-operands[0]));
+    case FusedElementwiseOp_t::Dropout: {
+      if (!p.is_train) {
+        return operands[0];
+      }
+      if (curand_uniform(&rng) > op.dropout_rate) {
+        keep_mask |= 1u << k;
+        return operands[0] / (1.f - op.dropout_rate);
+      }
+      return 0.f;
+    }
+  }
+  return 0.f;
+}
+
+// Writes the gradients of the input operands of op k and returns the gradient of the previous op.
+template <typename T>
+__device__ float bprop_op(const FusedElementwiseParams<T>& p, int k, float chain, float top,
+                          bool keep, float grad, int64_t idx) {
+  const FusedElementwiseOp& op = p.ops[k];
+  float operands[FUSED_ELEMENTWISE_MAX_INPUTS + 1];
+  load_operands(p, op, chain, idx, operands);
+  const int num_operands = get_num_operands(op);
+
+  float chain_grad = 0.f;
+  auto set_grad = [&](int j, float operand_grad) {
+    if (j == op.chain_pos) {
+      chain_grad = operand_grad;
+    } else {
+      get_operand_input(p, op, j)[idx] = TypeConvertFunc<T, float>::convert(operand_grad);
+    }
+  };
+  switch (op.type) {
+    case FusedElementwiseOp_t::Add:
+      for (int j = 0; j < num_operands; j++) {
+        set_grad(j, grad);
+      }
+      break;
+    case FusedElementwiseOp_t::Sub:
+      set_grad(0, grad);
+      set_grad(1, -grad);
+      break;
+    case FusedElementwiseOp_t::Multiply:
+      for (int j = 0; j < num_operands; j++) {
+        float product = grad;
+        for (int l = 0; l < num_operands; l++) {
+          product *= l == j ? 1.f : operands[l];
+        }
+        set_grad(j, product);
+      }
+      break;
+    case FusedElementwiseOp_t::Relu:
+      set_grad(0, operands[0] > 0.f ? grad : 0.f);
+      break;
+    case FusedElementwiseOp_t::Sigmoid:
+      set_grad(0, grad * top * (1.f - top));
+      break;
+    case FusedElementwiseOp_t::Dropout:
+      set_grad(0, keep ? grad / (1.f - op.dropout_rate) : 0.f);
+      break;
+  }
+  return chain_grad;
+}
+
+template <typename T>
+__global__ void fused_elementwise_fprop_kernel(const FusedElementwiseParams<T> p, T* out) {
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < p.num_elements;
+       idx += blockDim.x * gridDim.x) {
+    curandStatePhilox4_32_10_t rng;
+    init_rng(p, idx, rng);
+    uint32_t keep_mask = 0;
+    float value = 0.f;
+    for (int k = 0; k < p.num_ops; k++) {
+      value = fprop_op(p, k, value, idx, rng, keep_mask);
+    }
+    out[idx] = TypeConvertFunc<T, float>::convert(value);
+  }
+}
+
+template <typename T>
+__global__ void fused_elementwise_bprop_kernel(const FusedElementwiseParams<T> p, const T* top) {
+  for (int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < p.num_elements;
+       idx += blockDim.x * gridDim.x) {
+    curandStatePhilox4_32_10_t rng;
+    init_rng(p, idx, rng);
+    uint32_t keep_mask = 0;
+    float values[FUSED_ELEMENTWISE_MAX_OPS];
+    float value = 0.f;
+    for (int k = 0; k < p.num_ops; k++) {
+      value = fprop_op(p, k, value, idx, rng, keep_mask);
+      values[k] = value;
+    }
+    float grad = TypeConvertFunc<float, T>::convert(top[idx]);
+    for (int k = p.num_ops - 1; k >= 0; k--) {
+      grad = bprop_op(p, k, k > 0 ? values[k - 1] : 0.f, values[k], (keep_mask >> k) & 1u, grad,
+                      idx);
+    }
+  }
+}
+
+template <typename T>
+FusedElementwiseParams<T> make_params(const std::vector<core23::Tensor>& input_tensors,
+                                      const core23::Tensor& output_tensor,
+                                      const std::vector<FusedElementwiseOp>& ops, bool is_train,
+                                      uint64_t seed, const core23::Tensor& iteration) {
+  FusedElementwiseParams<T> params{};
+  for (size_t i = 0; i < input_tensors.size(); i++) {
+    params.inputs[i] = input_tensors[i].data<T>();
+  }
+  params.num_ops = ops.size();
+  params.has_dropout = false;
+  for (size_t k = 0; k < ops.size(); k++) {
+    params.ops[k] = ops[k];
+    params.has_dropout |= ops[k].type == FusedElementwiseOp_t::Dropout;
+  }
+  params.num_elements = output_tensor.num_elements();
+  params.is_train = is_train;
+  params.seed = seed;
+  params.iteration = params.has_dropout ? iteration.data<uint64_t>() : nullptr;
+  return params;
+}
+
+}  // namespace
+
+template <typename T>
+FusedElementwiseLayer<T>::FusedElementwiseLayer(const std::vector<core23::Tensor>& input_tensors,
+                                                const core23::Tensor& output_tensor,
+                                                const std::vector<FusedElementwiseOp>& ops,
+                                                uint64_t seed,
+                                                const std::shared_ptr<GPUResource>& gpu_resource)
+    : Layer(input_tensors, {output_tensor}, gpu_resource),
+      ops_(ops),
+      seed_(seed),
+      is_train_(true) {
+  if (ops_.empty() || ops_.size() > FUSED_ELEMENTWISE_MAX_OPS) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "FusedElementwiseLayer needs 1 to " +
+                                            std::to_string(FUSED_ELEMENTWISE_MAX_OPS) + " ops");
+  }
+  if (input_tensors_.size() > FUSED_ELEMENTWISE_MAX_INPUTS) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "FusedElementwiseLayer can have at most " +
+                                            std::to_string(FUSED_ELEMENTWISE_MAX_INPUTS) +
+                                            " input tensors");
+  }
+  for (const auto& input_tensor : input_tensors_) {
+    if (input_tensor.shape() != output_tensors_[0].shape()) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "All the tensors must have the same shape");
+    }
+  }
+  for (size_t k = 0; k < ops_.size(); k++) {
+    const auto& op = ops_[k];
+    if ((k == 0) != (op.chain_pos < 0) || op.first_input < 0 ||
+        op.first_input + op.num_inputs > static_cast<int>(input_tensors_.size())) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Invalid operands of the op " + std::to_string(k));
+    }
+  }
+  if (std::any_of(ops_.begin(), ops_.end(),
+                  [](const auto& op) { return op.type == FusedElementwiseOp_t::Dropout; })) {
+    core23::BufferParams buf_p{.channel = GetBlobsBufferChannel()};
+    iteration_ = core23::Tensor(output_tensors_[0]
+                                    .my_params()
+                                    .data_type(core23::ScalarType::UInt64)
+                                    .shape({1})
+                                    .buffer_params(buf_p));
+  }
+}
+
+template <typename T>
+void FusedElementwiseLayer<T>::initialize() {
+  if (!iteration_.empty()) {
+    CudaDeviceContext context(get_device_id());
+    HCTR_LIB_THROW(cudaMemsetAsync(iteration_.data(), 0, iteration_.num_bytes(),
+                                   get_gpu().get_stream()));
+  }
+}
+
+template <typename T>
+void FusedElementwiseLayer<T>::fprop(bool is_train) {
+  CudaDeviceContext context(get_device_id());
+  is_train_ = is_train;
+  if (is_train && !iteration_.empty()) {
+    advance_iteration_kernel<<<1, 1, 0, get_gpu().get_stream()>>>(iteration_.data<uint64_t>());
+  }
+
+  const auto params = make_params<T>(input_tensors_, output_tensors_[0], ops_, is_train_, seed_,
+                                     iteration_);
+
+  const int block_size = 256;
+  const int64_t grid_size =
+      std::min<int64_t>((params.num_elements - 1) / block_size + 1, get_gpu().get_sm_count() * 8);
+  fused_elementwise_fprop_kernel<<<grid_size, block_size, 0, get_gpu().get_stream()>>>(
+      params, output_tensors_[0].data<T>());
+}
+
+template <typename T>
+void FusedElementwiseLayer<T>::bprop() {
+  CudaDeviceContext context(get_device_id());
+
+  // The same seed and offset as the fprop give the same dropout masks.
+  const auto params = make_params<T>(input_tensors_, output_tensors_[0], ops_, is_train_, seed_,
+                                     iteration_);
+
+  const int block_size = 256;
+  const int64_t grid_size =
+      std::min<int64_t>((params.num_elements - 1) / block_size + 1, get_gpu().get_sm_count() * 8);
+  fused_elementwise_bprop_kernel<<<grid_size, block_size, 0, get_gpu().get_stream()>>>(
+      params, output_tensors_[0].data<T>());
+}
+
+template class FusedElementwiseLayer<float>;
+template class FusedElementwiseLayer<__half>;
+
+}  // namespace HugeCTR
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <gemm_algorithm_cache.hpp>
 #include <layers/fused_fully_connected_layer.hpp>
 #include <network_buffer_channels.hpp>
 #include <utils.cuh>
@@ -231,6 +232,12 @@ void FusedFullyConnectedLayer::search_algorithm() {
   size_t output_size = top_tensor_dim[1];
   size_t input_size = bottom_tensor_dim[1];
 
+  const std::string cache_key = GemmAlgorithmCache::make_key(
+      "FusedFullyConnectedLayer", batch_size, input_size, output_size);
+  if (GemmAlgorithmCache::get().find(cache_key, falgo_k_, balgo_k_, balgo_x_)) {
+    return;
+  }
+
   // Record time for each algorithm
   float shortestTime = std::numeric_limits<float>::max();
   float time;
@@ -360,6 +367,7 @@ void FusedFullyConnectedLayer::search_algorithm() {
   // Gemm.\n"); Clean-up
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
+  GemmAlgorithmCache::get().insert(cache_key, falgo_k_, balgo_k_, balgo_x_);
 }  // namespace HugeCTR
 
 std::unique_ptr<DataSimulator> FusedFullyConnectedLayer::get_uniform_initializer(const int index) {
@@ -556,6 +564,12 @@ void Core23TempFusedFullyConnectedLayer::search_algorithm() {
   int64_t output_size = top_tensor_dim.size(1);
   int64_t input_size = bottom_tensor_dim.size(1);
 
+  const std::string cache_key = GemmAlgorithmCache::make_key(
+      "FusedFullyConnectedLayer", batch_size, input_size, output_size);
+  if (GemmAlgorithmCache::get().find(cache_key, falgo_k_, balgo_k_, balgo_x_)) {
+    return;
+  }
+
   // Record time for each algorithm
   float shortestTime = std::numeric_limits<float>::max();
   float time;
@@ -685,6 +699,7 @@ void Core23TempFusedFullyConnectedLayer::search_algorithm() {
   // Gemm.\n"); Clean-up
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
+  GemmAlgorithmCache::get().insert(cache_key, falgo_k_, balgo_k_, balgo_x_);
 }  // namespace HugeCTR
 
 std::unique_ptr<DataSimulator> Core23TempFusedFullyConnectedLayer::get_uniform_initializer(
@@ -16,6 +16,7 @@
 
 #include <common.hpp>
 #include <cstdio>
+#include <gemm_algorithm_cache.hpp>
 #include <layers/fused_relu_bias_fully_connected_layer.hpp>
 #include <linalg/reduce.cuh>
 #include <utils.cuh>
@@ -492,6 +493,14 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
   int output_size = top_tensor_dim[1];
   int input_size = bottom_tensor_dim[1];
 
+  const std::string cache_key = GemmAlgorithmCache::make_key(
+      "FusedReluBiasFullyConnectedLayer", batch_size, input_size, output_size, pos_, act_,
+      skip_dgrad_, fuse_wb_);
+  if (GemmAlgorithmCache::get().find(cache_key, falgo_k_, balgo_dRelu_, balgo_wgrad_, balgo_k_,
+                                     balgo_b_, balgo_x_)) {
+    return;
+  }
+
   // Record time for each algorithm
   float shortestTime = std::numeric_limits<float>::max();
   float time;
@@ -769,6 +778,8 @@ void FusedReluBiasFullyConnectedLayer::search_algorithm() {
   // Gemm.\n"); Clean-up
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
+  GemmAlgorithmCache::get().insert(cache_key, falgo_k_, balgo_dRelu_, balgo_wgrad_, balgo_k_,
+                                   balgo_b_, balgo_x_);
 }  // namespace HugeCTR
 
 std::unique_ptr<DataSimulator> FusedReluBiasFullyConnectedLayer::get_uniform_initializer(
@@ -1258,6 +1269,14 @@ void Core23TempFusedReluBiasFullyConnectedLayer::search_algorithm() {
   int output_size = top_tensor_dim.size(1);
   int input_size = bottom_tensor_dim.size(1);
 
+  const std::string cache_key = GemmAlgorithmCache::make_key(
+      "FusedReluBiasFullyConnectedLayer", batch_size, input_size, output_size, pos_, act_,
+      skip_dgrad_, fuse_wb_);
+  if (GemmAlgorithmCache::get().find(cache_key, falgo_k_, balgo_dRelu_, balgo_wgrad_, balgo_k_,
+                                     balgo_b_, balgo_x_)) {
+    return;
+  }
+
   // Record time for each algorithm
   float shortestTime = std::numeric_limits<float>::max();
   float time;
@@ -1535,6 +1554,8 @@ void Core23TempFusedReluBiasFullyConnectedLayer::search_algorithm() {
   // Gemm.\n"); Clean-up
   HCTR_LIB_THROW(cudaEventDestroy(start));
   HCTR_LIB_THROW(cudaEventDestroy(stop));
+  GemmAlgorithmCache::get().insert(cache_key, falgo_k_, balgo_dRelu_, balgo_wgrad_, balgo_k_,
+                                   balgo_b_, balgo_x_);
 }  // namespace HugeCTR
 
 std::unique_ptr<DataSimulator> Core23TempFusedReluBiasFullyConnectedLayer::get_uniform_initializer(
@@ -0,0 +1,239 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+#include <algorithm>
+#include <layers/grouped_mlp_layer.hpp>
+#include <network_buffer_channels.hpp>
+#include <type_traits>
+#include <utils.cuh>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+// grad = grad * (out > 0), reading grad from in, which may be grad itself
+template <typename T>
+__global__ void drelu_kernel(T* grad, const T* in, const T* out, size_t num_elements) {
+  const size_t tid_base = blockIdx.x * blockDim.x + threadIdx.x;
+  const size_t num_threads = blockDim.x * gridDim.x;
+  for (size_t tid = tid_base; tid < num_elements; tid += num_threads) {
+    grad[tid] = TypeConvertFunc<float, T>::convert(out[tid]) > 0.f ? in[tid] : T(0.f);
+  }
+}
+
+template <typename T>
+void drelu(T* grad, const T* in, const T* out, size_t num_elements, cudaStream_t stream) {
+  constexpr int block_size = 512;
+  const int grid_size = std::min<size_t>((num_elements - 1) / block_size + 1, 4096);
+  drelu_kernel<<<grid_size, block_size, 0, stream>>>(grad, in, out, num_elements);
+}
+
+}  // namespace
+
+template <typename T>
+Core23TempGroupedMLPLayer<T>::Core23TempGroupedMLPLayer(
+    const core23::Tensor& bottom_tensor, const core23::Tensor& top_tensor, int64_t num_experts,
+    const std::vector<int64_t>& num_outputs, Activation_t act,
+    const std::shared_ptr<GPUResource>& gpu_resource, std::vector<Initializer_t> initializer_types,
+    bool skip_dgrad, bool enable_tf32_compute)
+    : Core23TempTrainableLayer<T>({bottom_tensor}, {top_tensor}, gpu_resource, initializer_types),
+      num_experts_(num_experts),
+      num_outputs_(num_outputs),
+      num_layers_(num_outputs.size()),
+      act_(act),
+      skip_dgrad_(skip_dgrad),
+      enable_tf32_compute_(enable_tf32_compute) {
+  if (num_experts_ < 1 || num_layers_ < 1) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "GroupedMLP requires at least one expert and one layer");
+  }
+  if (act_ != Activation_t::Relu && act_ != Activation_t::None) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "GroupedMLP only supports Relu or None as activation");
+  }
+  const auto& bottom_shape = bottom_tensor.shape();
+  const auto& top_shape = top_tensor.shape();
+  if (bottom_shape.dims() != 2) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "GroupedMLP input must be 2D");
+  }
+  batch_size_ = bottom_shape.size(0);
+  if (top_shape.dims() != 3 || top_shape.size(0) != batch_size_ ||
+      top_shape.size(1) != num_experts_ || top_shape.size(2) != num_outputs_.back()) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "GroupedMLP output must be [batch_size, num_experts, num_outputs.back()]");
+  }
+
+  for (int i = 0; i < num_layers_; i++) {
+    core23::Shape kernel_dim = {get_input_size(i), num_experts_ * num_outputs_[i]};
+    core23::Shape bias_dim = {1, num_experts_ * num_outputs_[i]};
+    this->set_weight(i * 2, kernel_dim);
+    kernels_.push_back(this->get_weight(i * 2));
+    this->set_weight(i * 2 + 1, bias_dim);
+    biases_.push_back(this->get_weight(i * 2 + 1));
+    this->set_wgrad(i * 2, kernel_dim);
+    kernels_grad_.push_back(this->get_wgrad(i * 2));
+    this->set_wgrad(i * 2 + 1, bias_dim);
+    biases_grad_.push_back(this->get_wgrad(i * 2 + 1));
+  }
+
+  core23::BufferParams buffer_params = {};
+  buffer_params.channel = GetBlobsBufferChannel();
+  auto tensor_params = core23::TensorParams()
+                           .data_type(core23::ToScalarType<T>::value)
+                           .device({core23::DeviceType::GPU, gpu_resource->get_device_id()})
+                           .buffer_params(buffer_params);
+  int64_t max_hidden_size = 0;
+  for (int i = 0; i < num_layers_ - 1; i++) {
+    hiddens_.emplace_back(tensor_params.shape({batch_size_, num_experts_, num_outputs_[i]}));
+    max_hidden_size = std::max(max_hidden_size, num_outputs_[i]);
+  }
+  if (max_hidden_size > 0) {
+    dgrad_scratch_ =
+        core23::Tensor(tensor_params.shape({batch_size_ * num_experts_ * max_hidden_size}));
+  }
+  if (act_ == Activation_t::Relu) {
+    last_out_ = core23::Tensor(tensor_params.shape(top_shape));
+  }
+  ones_ = core23::Tensor(tensor_params.shape({batch_size_}));
+
+  fprop_gemms_.resize(num_layers_);
+  dgrad_gemms_.resize(num_layers_);
+  wgrad_gemms_.resize(num_layers_);
+  bgrad_gemms_.resize(num_layers_);
+}
+
+template <typename T>
+void Core23TempGroupedMLPLayer<T>::initialize() {
+  CudaDeviceContext context(this->get_device_id());
+  const cudaDataType data_type = std::is_same<T, __half>::value ? CUDA_R_16F : CUDA_R_32F;
+  auto handle = this->get_gpu().get_cublaslt_handle();
+  for (int i = 0; i < num_layers_; i++) {
+    // The experts share the input of the first layer, which is then one GEMM of all the experts,
+    // and its dgrad sums up the gradients of the experts.
+    const int num_groups = i == 0 ? 1 : num_experts_;
+    const int64_t k = get_input_size(i);
+    const int64_t n = num_outputs_[i];
+    const int64_t m = i == 0 ? num_experts_ * n : n;
+    const int64_t input_ld = i == 0 ? k : num_experts_ * k;
+    const int64_t input_stride = i == 0 ? 0 : k;
+    const int64_t output_stride = i == 0 ? 0 : n;
+    // Column-major views of the row-major tensors, a column per sample or input
+    const GroupedGemmOperand kernel{m, k, num_experts_ * n, output_stride};
+    const GroupedGemmOperand input{k, batch_size_, input_ld, input_stride};
+    const GroupedGemmOperand output{m, batch_size_, num_experts_ * n, output_stride};
+    const Activation_t act = i == num_layers_ - 1 ? act_ : Activation_t::Relu;
+
+    fprop_gemms_[i].init(CUBLAS_OP_N, CUBLAS_OP_N, kernel, input, output, num_groups, data_type,
+                         enable_tf32_compute_, biases_[i].data(), n, act, handle);
+    if (i != 0 || !skip_dgrad_) {
+      dgrad_gemms_[i].init(CUBLAS_OP_T, CUBLAS_OP_N, kernel, output, input, num_groups, data_type,
+                           enable_tf32_compute_, nullptr, 0, Activation_t::None, handle);
+    }
+    wgrad_gemms_[i].init(CUBLAS_OP_N, CUBLAS_OP_T, output, input, kernel, num_groups, data_type,
+                         enable_tf32_compute_, nullptr, 0, Activation_t::None, handle);
+    // The bias gradients of all the experts are the gradient of the output times 1s.
+    const GroupedGemmOperand all_outputs{num_experts_ * n, batch_size_, num_experts_ * n, 0};
+    const GroupedGemmOperand ones{batch_size_, 1, batch_size_, 0};
+    const GroupedGemmOperand bias{num_experts_ * n, 1, num_experts_ * n, 0};
+    bgrad_gemms_[i].init(CUBLAS_OP_N, CUBLAS_OP_N, all_outputs, ones, bias, 1, data_type,
+                         enable_tf32_compute_, nullptr, 0, Activation_t::None, handle);
+  }
+
+  auto stream = this->get_gpu().get_stream();
+  initialize_array<<<(batch_size_ - 1) / 1024 + 1, 1024, 0, stream>>>(
+      ones_.data<T>(), batch_size_, T(1.f));
+}
+
+template <typename T>
+void Core23TempGroupedMLPLayer<T>::fprop(bool is_train) {
+  CudaDeviceContext context(this->get_device_id());
+  auto handle = this->get_gpu().get_cublaslt_handle();
+  auto stream = this->get_gpu().get_stream();
+  for (int i = 0; i < num_layers_; i++) {
+    fprop_gemms_[i](kernels_[i].data(), get_layer_input(i).data(), 0.f,
+                    get_layer_output(i).data(), handle, stream);
+  }
+  // The top holds its gradient in the bprop, so the ReLU is applied with a copy of it.
+  if (is_train && act_ == Activation_t::Relu) {
+    HCTR_LIB_THROW(cudaMemcpyAsync(last_out_.data(), this->output_tensors_[0].data(),
+                                   last_out_.num_bytes(), cudaMemcpyDeviceToDevice, stream));
+  }
+}
+
+template <typename T>
+void Core23TempGroupedMLPLayer<T>::bprop() {
+  CudaDeviceContext context(this->get_device_id());
+  auto handle = this->get_gpu().get_cublaslt_handle();
+  auto stream = this->get_gpu().get_stream();
+  if (act_ == Activation_t::Relu) {
+    auto& top = this->output_tensors_[0];
+    drelu(top.data<T>(), top.data<T>(), last_out_.data<T>(), top.num_elements(), stream);
+  }
+  for (int i = num_layers_ - 1; i >= 0; i--) {
+    const auto& grad = get_layer_output(i);
+    const auto& input = get_layer_input(i);
+    bgrad_gemms_[i](grad.data(), ones_.data(), 1.f, biases_grad_[i].data(), handle, stream);
+    wgrad_gemms_[i](grad.data(), input.data(), 1.f, kernels_grad_[i].data(), handle, stream);
+    if (i > 0) {
+      // The input of the layer is the output of a hidden ReLU layer, which its gradient replaces.
+      const auto& hidden = hiddens_[i - 1];
+      dgrad_gemms_[i](kernels_[i].data(), grad.data(), 0.f, dgrad_scratch_.data(), handle, stream);
+      drelu(hidden.data<T>(), dgrad_scratch_.data<T>(), hidden.data<T>(), hidden.num_elements(),
+            stream);
+    } else if (!skip_dgrad_) {
+      dgrad_gemms_[i](kernels_[i].data(), grad.data(), 0.f, input.data(), handle, stream);
+    }
+  }
+}
+
+template <typename T>
+std::unique_ptr<DataSimulator> Core23TempGroupedMLPLayer<T>::get_uniform_initializer(
+    const int index) {
+  float limit = sqrt(1.0f / get_input_size(index / 2));
+  return std::make_unique<UniformDataSimulator>(-1 * limit, limit);
+}
+
+template <typename T>
+std::unique_ptr<DataSimulator> Core23TempGroupedMLPLayer<T>::get_xavier_uniform_initializer(
+    const int index) {
+  int i = index / 2;
+  // fan_avg for weight
+  // fan_out for bias
+  auto fan_mode = index % 2 ? data_simu::Mode_t::Fan_out : data_simu::Mode_t::Fan_avg;
+  return std::make_unique<VarianceScalingSimulator>(
+      1.f, fan_mode, data_simu::Distribution_t::Uniform, get_input_size(i), num_outputs_[i]);
+}
+
+template <typename T>
+std::unique_ptr<DataSimulator> Core23TempGroupedMLPLayer<T>::get_xavier_norm_initializer(
+    const int index) {
+  int i = index / 2;
+  // fan_avg for weight
+  // fan_out for bias
+  auto fan_mode = index % 2 ? data_simu::Mode_t::Fan_out : data_simu::Mode_t::Fan_avg;
+  return std::make_unique<VarianceScalingSimulator>(1.f, fan_mode, data_simu::Distribution_t::Norm,
+                                                    get_input_size(i), num_outputs_[i]);
+}
+
+template <typename T>
+std::unique_ptr<DataSimulator> Core23TempGroupedMLPLayer<T>::get_default_initializer(
+    const int index) {
+  return this->get_uniform_initializer(index);
+}
+
+template class Core23TempGroupedMLPLayer<float>;
+template class Core23TempGroupedMLPLayer<__half>;
+
+}  // namespace HugeCTR
@@ -30,6 +30,24 @@
 
 namespace HugeCTR {
 
+namespace {
+
+// The largest hidden size that is tried with the persistent algorithm.
+constexpr int max_persistent_hidden_size = 1024;
+
+template <typename TIn>
+__global__ void clamp_seq_lengths_kernel(const TIn* lengths, int* seq_lengths, int batch_size,
+                                         int max_seq_length) {
+  const int i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < batch_size) {
+    // cuDNN rejects empty sequences, so they run a single step.
+    const int length = static_cast<int>(lengths[i]);
+    seq_lengths[i] = max(1, min(length, max_seq_length));
+  }
+}
+
+}  // namespace
+
 template <typename T>
 GRULayer<T>::GRULayer(const std::shared_ptr<BufferBlock2<T>>& weight_buff,
                       const std::shared_ptr<BufferBlock2<T>>& wgrad_buff,
@@ -409,13 +427,36 @@ Core23TempGRULayer<T>::Core23TempGRULayer(const core23::Tensor& in_tensor,
                                           int64_t batch_size, int64_t SeqLength,
                                           int64_t embedding_vec_size,
                                           const std::shared_ptr<GPUResource>& gpu_resource,
-                                          std::vector<Initializer_t> initializer_types)
-    : Core23TempTrainableLayer<T>({in_tensor}, {out_tensor}, gpu_resource, initializer_types) {
+                                          std::vector<Initializer_t> initializer_types,
+                                          bool allow_mixed_precision_math)
+    : Core23TempGRULayer(std::vector<core23::Tensor>{in_tensor}, out_tensor, hiddenSize,
+                         batch_size, SeqLength, embedding_vec_size, gpu_resource,
+                         initializer_types, allow_mixed_precision_math) {}
+
+template <typename T>
+Core23TempGRULayer<T>::Core23TempGRULayer(const std::vector<core23::Tensor>& in_tensors,
+                                          const core23::Tensor& out_tensor, int64_t hiddenSize,
+                                          int64_t batch_size, int64_t SeqLength,
+                                          int64_t embedding_vec_size,
+                                          const std::shared_ptr<GPUResource>& gpu_resource,
+                                          std::vector<Initializer_t> initializer_types,
+                                          bool allow_mixed_precision_math)
+    : Core23TempTrainableLayer<T>(in_tensors, {out_tensor}, gpu_resource, initializer_types) {
   try {
     CudaDeviceContext context(this->get_device_id());
-    // check the in_tensor and out_tensor
-    const auto& in_tensor_dim = in_tensor.shape();
-    const auto& out_tensor_dim = out_tensor.shape();
+    if (in_tensors.empty() || in_tensors.size() > 2) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "GRU takes an input and optional sequence lengths");
+    }
+    variable_length_ = in_tensors.size() == 2;
+    if (variable_length_) {
+      const auto& length_tensor = in_tensors[1];
+      if (length_tensor.num_elements() != batch_size) {
+        HCTR_OWN_THROW(Error_t::WrongInput, "GRU needs one sequence length per sample");
+      }
+      if (!length_tensor.data_type().match<float>() && !length_tensor.data_type().match<int>()) {
+        HCTR_OWN_THROW(Error_t::WrongInput, "GRU sequence lengths must be float or int32");
+      }
+    }
 
     // 2. dim match?
     // seqLength = in_tensor_dim[1];
@@ -438,15 +479,19 @@ Core23TempGRULayer<T>::Core23TempGRULayer(const core23::Tensor& in_tensor,
 
     // HCTR_LIB_THROW(cudnnSetTensor4dDescriptorEx(cDesc, data_type, 1, n, m, n,
     //  n, 1, 1, 1));
-    seqLengthArray = new int[miniBatch];
+    // Pinned, because the lengths of variable length batches are read back before each fprop.
+    HCTR_LIB_THROW(cudaMallocHost((void**)&seqLengthArray, miniBatch * sizeof(int)));
 
     for (size_t i = 0; i < miniBatch; i++) {
       seqLengthArray[i] = seqLength_;
     }
 
-    // cudnnHandle= get_gpu().get_cudnn_handle();
-    HCTR_LIB_THROW(cudnnCreate(&cudnnHandle));
+    // The handle of the GPU runs on the computation stream of the other layers.
+    cudnnHandle = this->get_gpu().get_cudnn_handle();
     data_type = CudnnDataType<T>::getType();
+    // With conversion, cuDNN may round float operands to half for the tensor cores.
+    math_type_ =
+        allow_mixed_precision_math ? CUDNN_TENSOR_OP_MATH_ALLOW_CONVERSION : CUDNN_TENSOR_OP_MATH;
     HCTR_LIB_THROW(cudnnCreateRNNDescriptor(&rnnDesc));
     HCTR_LIB_THROW(cudnnCreateRNNDataDescriptor(&in_Desc));
     HCTR_LIB_THROW(cudnnCreateRNNDataDescriptor(&out_Desc));
@@ -454,29 +499,7 @@ Core23TempGRULayer<T>::Core23TempGRULayer(const core23::Tensor& in_tensor,
     HCTR_LIB_THROW(cudnnCreateTensorDescriptor(&hDesc));
     HCTR_LIB_THROW(cudnnCreateDropoutDescriptor(&dropoutDesc));
 
-    HCTR_LIB_THROW(cudnnSetRNNDataDescriptor(
-        in_Desc,                                   // cudnnRNNDataDescriptor_t RNNDataDesc,
-        data_type,                                 // cudnnDataType_t dataType,
-        CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED,  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_PACKED,
-                                                   // //cudnnRNNDataLayout_t layout,
-        seqLength_,                                // int maxSeqLength,
-        miniBatch,                                 // int batchSize,
-        embedding_vec_size_,                       // int vectorSize,
-        seqLengthArray,                            // const int seqLengthArray[],
-        NULL                                       // void *paddingFill
-        ));
-
-    HCTR_LIB_THROW(cudnnSetRNNDataDescriptor(
-        out_Desc,                                  // cudnnRNNDataDescriptor_t RNNDataDesc,
-        data_type,                                 // cudnnDataType_t dataType,
-        CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED,  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_PACKED,
-                                                   // //cudnnRNNDataLayout_t layout,
-        seqLength_,                                // int maxSeqLength,
-        miniBatch,                                 // int batchSize,
-        hiddenSize_,                               // int vectorSize,
-        seqLengthArray,                            // const int seqLengthArray[],
-        NULL                                       // void *paddingFill
-        ));
+    set_data_descriptors();
     dimHidden[0] = 1 * 1;
     dimHidden[1] = miniBatch;
     dimHidden[2] = hiddenSize_;
@@ -492,26 +515,24 @@ Core23TempGRULayer<T>::Core23TempGRULayer(const core23::Tensor& in_tensor,
     HCTR_LIB_THROW(
         cudnnSetDropoutDescriptor(dropoutDesc, cudnnHandle, dropout, states, stateSize, seed));
 
-    HCTR_LIB_THROW(cudnnSetRNNDescriptor_v8(
-        rnnDesc,
-        CUDNN_RNN_ALGO_STANDARD,    // cudnnRNNAlgo_t algo,
-        CUDNN_GRU,                  // cudnnRNNMode_t cellMode,
-        CUDNN_RNN_SINGLE_INP_BIAS,  // cudnnRNNBiasMode_t biasMode,
-        CUDNN_UNIDIRECTIONAL,       // cudnnDirectionMode_t dirMode,
-        CUDNN_LINEAR_INPUT,         // CUDNN_SKIP_INPUT, //CUDNN_LINEAR_INPUT, //cudnnRNNInputMode_t
-                             // inputMode, CUDNN_SKIP_INPUT :without multiplying input by the weight
-                             // matrix
-        data_type,             // cudnnDataType_t dataType,
-        data_type,             // cudnnDataType_t mathPrec,
-        CUDNN_TENSOR_OP_MATH,  // CUDNN_DEFAULT_MATH , //cudnnMathType_t mathType,
-        embedding_vec_size_,   // int32_t embedding_vec_size, When the inputMode=CUDNN_SKIP_INPUT,
-                               // the embedding_vec_size should match the hiddenSize value
-        hiddenSize_,           // int32_t hiddenSize,
-        hiddenSize_,           // int32_t projSize,
-        1,                     // int32_t numLayers, BIDIRECTIONAL=2
-        dropoutDesc,           // cudnnDropoutDescriptor_t dropoutDesc,
-        CUDNN_RNN_PADDED_IO_DISABLED  // uint32_t auxFlags
-        ));
+    // The persistent kernel keeps the recurrent weights on chip for all the steps, which saves
+    // most of the time of the small hidden sizes and batches of interest evolution. cuDNN reports
+    // the configurations it cannot run persistently, and those use the standard algorithm.
+    bool persistent = this->get_gpu().get_cc_major() >= 7 &&
+                      hiddenSize_ <= max_persistent_hidden_size &&
+                      set_rnn_descriptor(CUDNN_RNN_ALGO_PERSIST_STATIC) == CUDNN_STATUS_SUCCESS;
+    if (persistent) {
+      persistent = cudnnGetRNNTempSpaceSizes(cudnnHandle, rnnDesc, CUDNN_FWD_MODE_TRAINING,
+                                             in_Desc, &workSpaceSize,
+                                             &reserveSpaceSize) == CUDNN_STATUS_SUCCESS;
+    }
+    if (persistent) {
+      algo_ = CUDNN_RNN_ALGO_PERSIST_STATIC;
+    } else {
+      HCTR_LIB_THROW(set_rnn_descriptor(CUDNN_RNN_ALGO_STANDARD));
+    }
+    HCTR_LOG(DEBUG, ROOT, "GRU hidden size %d uses the %s algorithm\n", hiddenSize_,
+             persistent ? "persistent" : "standard");
 
     // const int seqLengthArray[in_tensor_dim[0]] = { [0...10] = int(in_tensor_dim[1]) };
     // const int seqLengthArray[m] ={n,n....n};
@@ -560,6 +581,62 @@ Core23TempGRULayer<T>::Core23TempGRULayer(const core23::Tensor& in_tensor,
   }
 }
 
+template <typename T>
+Core23TempGRULayer<T>::~Core23TempGRULayer() {
+  try {
+    CudaDeviceContext context(this->get_device_id());
+    HCTR_LIB_THROW(cudaFree(workSpace));
+    HCTR_LIB_THROW(cudaFree(reserveSpace));
+    HCTR_LIB_THROW(cudaFree(weightSpace));
+    HCTR_LIB_THROW(cudaFree(states));
+    HCTR_LIB_THROW(cudaFree(devSeqLengthArray));
+    HCTR_LIB_THROW(cudaFreeHost(seqLengthArray));
+    HCTR_LIB_THROW(cudnnDestroyRNNDataDescriptor(in_Desc));
+    HCTR_LIB_THROW(cudnnDestroyRNNDataDescriptor(out_Desc));
+    HCTR_LIB_THROW(cudnnDestroyTensorDescriptor(hDesc));
+    HCTR_LIB_THROW(cudnnDestroyTensorDescriptor(cDesc));
+    HCTR_LIB_THROW(cudnnDestroyDropoutDescriptor(dropoutDesc));
+    HCTR_LIB_THROW(cudnnDestroyRNNDescriptor(rnnDesc));
+  } catch (const std::runtime_error& rt_err) {
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+  }
+}
+
+template <typename T>
+cudnnStatus_t Core23TempGRULayer<T>::set_rnn_descriptor(cudnnRNNAlgo_t algo) {
+  return cudnnSetRNNDescriptor_v8(
+      rnnDesc,
+      algo,                       // cudnnRNNAlgo_t algo,
+      CUDNN_GRU,                  // cudnnRNNMode_t cellMode,
+      CUDNN_RNN_SINGLE_INP_BIAS,  // cudnnRNNBiasMode_t biasMode,
+      CUDNN_UNIDIRECTIONAL,       // cudnnDirectionMode_t dirMode,
+      CUDNN_LINEAR_INPUT,         // cudnnRNNInputMode_t inputMode,
+      data_type,                  // cudnnDataType_t dataType,
+      data_type,                  // cudnnDataType_t mathPrec,
+      math_type_,                 // cudnnMathType_t mathType,
+      embedding_vec_size_,        // int32_t inputSize,
+      hiddenSize_,                // int32_t hiddenSize,
+      hiddenSize_,                // int32_t projSize,
+      1,                          // int32_t numLayers,
+      dropoutDesc,                // cudnnDropoutDescriptor_t dropoutDesc,
+      // The padded steps of shorter sequences are skipped, so they must be declared.
+      variable_length_ ? CUDNN_RNN_PADDED_IO_ENABLED : CUDNN_RNN_PADDED_IO_DISABLED);
+}
+
+template <typename T>
+void Core23TempGRULayer<T>::set_data_descriptors() {
+  // Both keep the padded (seqLength_, miniBatch, vectorSize) layout of the tensors, and the
+  // outputs of the steps after the length of a sample are filled with 0.
+  HCTR_LIB_THROW(cudnnSetRNNDataDescriptor(in_Desc, data_type,
+                                           CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED, seqLength_,
+                                           miniBatch, embedding_vec_size_, seqLengthArray,
+                                           &padding_fill_));
+  HCTR_LIB_THROW(cudnnSetRNNDataDescriptor(out_Desc, data_type,
+                                           CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED, seqLength_,
+                                           miniBatch, hiddenSize_, seqLengthArray,
+                                           &padding_fill_));
+}
+
 //#define KERAS_CHECK
 template <typename T>
 void Core23TempGRULayer<T>::fprop(bool is_train) {
@@ -574,6 +651,24 @@ void Core23TempGRULayer<T>::fprop(bool is_train) {
   T* in = in_tensor.data<T>();
   T* out = out_tensor.data<T>();
 
+  if (variable_length_) {
+    // cuDNN plans the steps on the host, so the lengths of the batch have to be read back.
+    const auto& length_tensor = get_in_tensors(is_train)[1];
+    const auto stream = this->get_gpu().get_stream();
+    const int grid = (miniBatch + 255) / 256;
+    if (length_tensor.data_type().template match<int>()) {
+      clamp_seq_lengths_kernel<<<grid, 256, 0, stream>>>(
+          length_tensor.template data<int>(), devSeqLengthArray, miniBatch, seqLength_);
+    } else {
+      clamp_seq_lengths_kernel<<<grid, 256, 0, stream>>>(
+          length_tensor.template data<float>(), devSeqLengthArray, miniBatch, seqLength_);
+    }
+    HCTR_LIB_THROW(cudaMemcpyAsync(seqLengthArray, devSeqLengthArray, miniBatch * sizeof(int),
+                                   cudaMemcpyDeviceToHost, stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    set_data_descriptors();
+  }
+
 #ifdef KERAS_CHECK
   cudnnTensorDescriptor_t wDesc;
   cudnnTensorDescriptor_t bDesc;
@@ -638,8 +733,10 @@ void Core23TempGRULayer<T>::fprop(bool is_train) {
   // hiddenTensorSize, cudaMemcpyDeviceToHost)); for(size_t i=0;i<hiddenTensorSize;i++)
   //  if(tmp[i] != 0.0)
   //    HCTR_LOG(INFO, WORLD, "tmp[i] %f\n", tmp[i]);
+  // The inference mode doesn't save the intermediate results for bprop to the reserve space.
   HCTR_LIB_THROW(cudnnRNNForward(
-      cudnnHandle, rnnDesc, CUDNN_FWD_MODE_TRAINING, devSeqLengthArray,
+      cudnnHandle, rnnDesc, is_train ? CUDNN_FWD_MODE_TRAINING : CUDNN_FWD_MODE_INFERENCE,
+      devSeqLengthArray,
       in_Desc,   // xDesc,
       in,        // x, input data pointer
       out_Desc,  // yDesc,
@@ -715,20 +812,6 @@ void Core23TempGRULayer<T>::bprop() {
       weightSpaceSize,
       dweightSpace,  // output
       workSpaceSize, workSpace, reserveSpaceSize, reserveSpace));
-  HCTR_LIB_THROW(cudaFree(workSpace));
-  HCTR_LIB_THROW(cudaFree(reserveSpace));
-  HCTR_LIB_THROW(cudaFree(weightSpace));  // cudaFree(dweightSpace);
-  // cudaFree(x); cudaFree(y); cudaFree(hx);
-  HCTR_LIB_THROW(cudaFree(states));
-  HCTR_LIB_THROW(cudnnDestroyRNNDataDescriptor(in_Desc));
-  HCTR_LIB_THROW(cudnnDestroyRNNDataDescriptor(out_Desc));
-  delete[] seqLengthArray;
-
-  HCTR_LIB_THROW(cudnnDestroyTensorDescriptor(hDesc));
-  HCTR_LIB_THROW(cudnnDestroyTensorDescriptor(cDesc));
-
-  HCTR_LIB_THROW(cudnnDestroyDropoutDescriptor(dropoutDesc));
-  HCTR_LIB_THROW(cudnnDestroyRNNDescriptor(rnnDesc));
 }
 
 template class Core23TempGRULayer<float>;
@@ -24,6 +24,7 @@
 #include <layers/interaction_layer.hpp>
 #include <network_buffer_channels.hpp>
 #include <type_traits>
+#include <utils.cuh>
 #include <utils.hpp>
 
 namespace HugeCTR {
@@ -31,6 +32,8 @@ namespace HugeCTR {
 namespace {
 
 static constexpr int n_ins_knob = 32;
+// Shared memory that the fused FP32 kernels can use without opting into more.
+static constexpr size_t fused_fp32_max_smem_bytes = 48 * 1024;
 
 template <uint x>
 struct Log2 {
@@ -896,6 +899,112 @@ __global__ void gather_concat_bprop_kernel(const T *out, T *in0, T *mat, const i
   }
 }
 
+// Shared memory of the fused kernels: the rows of a sample and the gradients of its pairs.
+size_t fused_interaction_smem_bytes(const size_t n_ins, const size_t w, const bool bprop) {
+  return sizeof(float) * (n_ins * (w + 1) + (bprop ? n_ins * (n_ins - 1) / 2 : 0));
+}
+
+// The pairs (row, col) with row < col are numbered by col * (col - 1) / 2 + row, which is the
+// order of the interactions in the output.
+__device__ __forceinline__ int interaction_pair_col(const int pair) {
+  int col = static_cast<int>((1.0f + sqrtf(8.0f * pair + 1.0f)) * 0.5f);
+  while (col * (col - 1) / 2 > pair) {
+    --col;
+  }
+  while ((col + 1) * col / 2 <= pair) {
+    ++col;
+  }
+  return col;
+}
+
+// Loads the n_ins rows of a sample into shared memory with a stride of w + 1, so that the rows of
+// the threads of a warp fall into different banks.
+template <typename T>
+__device__ __forceinline__ void load_interaction_rows(float *s_in, const T *in_mlp,
+                                                     const T *in_emb, const int bid,
+                                                     const int n_ins, const int w) {
+  for (int idx = threadIdx.x; idx < n_ins * w; idx += blockDim.x) {
+    const int row = idx / w;
+    const int col = idx - row * w;
+    const T val =
+        (row == 0) ? in_mlp[bid * w + col] : in_emb[(bid * (n_ins - 1) + row - 1) * w + col];
+    s_in[row * (w + 1) + col] = TypeConvertFunc<float, T>::convert(val);
+  }
+}
+
+// Computes only the strictly lower triangle of the interactions of a sample and writes it right
+// after the passed through bottom MLP output, in the layout that the top MLP reads. It replaces the
+// concat, the batched GEMM of the full matrix and the gather.
+template <typename T>
+__global__ void fused_interaction_fprop_kernel(const T *__restrict in_mlp,
+                                               const T *__restrict in_emb, T *__restrict out,
+                                               const int h, const int n_ins, const int w) {
+  extern __shared__ char s_buf_char[];
+  float *s_in = reinterpret_cast<float *>(s_buf_char);
+  const int n_pairs = n_ins * (n_ins - 1) / 2;
+  const int out_len = w + n_pairs + 1;
+  for (int bid = blockIdx.x; bid < h; bid += gridDim.x) {
+    load_interaction_rows(s_in, in_mlp, in_emb, bid, n_ins, w);
+    for (int col = threadIdx.x; col < w; col += blockDim.x) {
+      out[bid * out_len + col] = in_mlp[bid * w + col];
+    }
+    if (threadIdx.x == 0) {
+      out[bid * out_len + out_len - 1] = TypeConvertFunc<T, float>::convert(0.0f);
+    }
+    __syncthreads();
+    for (int pair = threadIdx.x; pair < n_pairs; pair += blockDim.x) {
+      const int col = interaction_pair_col(pair);
+      const float *a = s_in + (pair - col * (col - 1) / 2) * (w + 1);
+      const float *b = s_in + col * (w + 1);
+      float accum = 0.0f;
+      for (int k = 0; k < w; ++k) {
+        accum += a[k] * b[k];
+      }
+      out[bid * out_len + w + pair] = TypeConvertFunc<T, float>::convert(accum);
+    }
+    __syncthreads();
+  }
+}
+
+// The gradient of a row is the sum of the other rows weighted by the gradients of their pairs, as
+// the interaction matrix is symmetric. The bottom MLP also gets its passed through gradient. The
+// gradients overwrite the inputs, which are staged in shared memory first.
+template <typename T>
+__global__ void fused_interaction_bprop_kernel(const T *__restrict up_grad, T *__restrict in_mlp,
+                                               T *__restrict in_emb, const int h, const int n_ins,
+                                               const int w) {
+  extern __shared__ char s_buf_char[];
+  float *s_in = reinterpret_cast<float *>(s_buf_char);
+  float *s_grad = s_in + n_ins * (w + 1);
+  const int n_pairs = n_ins * (n_ins - 1) / 2;
+  const int out_len = w + n_pairs + 1;
+  for (int bid = blockIdx.x; bid < h; bid += gridDim.x) {
+    load_interaction_rows(s_in, in_mlp, in_emb, bid, n_ins, w);
+    for (int pair = threadIdx.x; pair < n_pairs; pair += blockDim.x) {
+      s_grad[pair] = TypeConvertFunc<float, T>::convert(up_grad[bid * out_len + w + pair]);
+    }
+    __syncthreads();
+    for (int idx = threadIdx.x; idx < n_ins * w; idx += blockDim.x) {
+      const int row = idx / w;
+      const int col = idx - row * w;
+      float accum = 0.0f;
+      for (int k = 0; k < n_ins; ++k) {
+        if (k != row) {
+          const int pair = (k > row) ? k * (k - 1) / 2 + row : row * (row - 1) / 2 + k;
+          accum += s_grad[pair] * s_in[k * (w + 1) + col];
+        }
+      }
+      if (row == 0) {
+        accum += TypeConvertFunc<float, T>::convert(up_grad[bid * out_len + col]);
+        in_mlp[bid * w + col] = TypeConvertFunc<T, float>::convert(accum);
+      } else {
+        in_emb[(bid * (n_ins - 1) + row - 1) * w + col] = TypeConvertFunc<T, float>::convert(accum);
+      }
+    }
+    __syncthreads();
+  }
+}
+
 }  // anonymous namespace
 
 template <typename T>
@@ -927,8 +1036,11 @@ void InteractionLayer<T>::init(const core23::Tensor &input_bottom_mlp_tensor,
     auto tensor_params = input_bottom_mlp_tensor.my_params().buffer_params(buf_p);
 
     auto n_ins = 1 + second_input_shape.size(1);
-    if (std::is_same<T, __half>::value == false ||
-        ((n_ins > 31) && (std::is_same<T, __half>::value))) {
+    use_fused_fp32_ = std::is_same<T, float>::value && n_ins < n_ins_knob &&
+                      fused_interaction_smem_bytes(n_ins, first_input_shape.size(1), true) <=
+                          fused_fp32_max_smem_bytes;
+    if (!use_fused_fp32_ && (std::is_same<T, __half>::value == false ||
+                             ((n_ins > 31) && (std::is_same<T, __half>::value)))) {
       auto concat_shape_width =
           first_input_shape.size(1) + second_input_shape.size(1) * second_input_shape.size(2);
       core23::Shape concat_shape = {first_input_shape.size(0), concat_shape_width};
@@ -985,8 +1097,11 @@ void InteractionLayer<T>::init(const Tensor2<T> &in_bottom_mlp_tensor,
     }
 
     size_t n_ins = 1 + second_in_dims[1];
-    if (std::is_same<T, __half>::value == false ||
-        ((n_ins > 31) && (std::is_same<T, __half>::value))) {
+    use_fused_fp32_ = std::is_same<T, float>::value && n_ins < n_ins_knob &&
+                      fused_interaction_smem_bytes(n_ins, first_in_dims[1], true) <=
+                          fused_fp32_max_smem_bytes;
+    if (!use_fused_fp32_ && (std::is_same<T, __half>::value == false ||
+                             ((n_ins > 31) && (std::is_same<T, __half>::value)))) {
       size_t concat_dims_width = first_in_dims[1] + second_in_dims[1] * second_in_dims[2];
       std::vector<size_t> concat_dims = {first_in_dims[0], concat_dims_width};
 
@@ -1205,8 +1320,41 @@ void InteractionLayer<T>::fprop_generic(bool is_train) {
   }
   HCTR_LIB_THROW(cudaGetLastError());
 }
+
+template <typename T>
+void InteractionLayer<T>::fprop_fused(bool is_train) {
+  CudaDeviceContext context(get_device_id());
+  const T *in_mlp, *in_emb;
+  T *out;
+  int h, n_ins, in_w;
+  // TODO: this block will be removed later
+  if (input_tensors_.empty()) {
+    in_mlp = get_in_tensors(is_train)[0].get_ptr();
+    in_emb = get_in_tensors(is_train)[1].get_ptr();
+    out = out_tensors_[0].get_ptr();
+    h = get_in_tensors(is_train)[0].get_dimensions()[0];
+    in_w = get_in_tensors(is_train)[0].get_dimensions()[1];
+    n_ins = 1 + get_in_tensors(is_train)[1].get_dimensions()[1];
+  } else {
+    in_mlp = input_tensors_[0].data<T>();
+    in_emb = input_tensors_[1].data<T>();
+    out = output_tensors_[0].data<T>();
+    h = input_tensors_[0].size(0);
+    in_w = input_tensors_[0].size(1);
+    n_ins = 1 + input_tensors_[1].size(1);
+  }
+  const size_t smem_size = fused_interaction_smem_bytes(n_ins, in_w, false);
+  fused_interaction_fprop_kernel<<<get_gpu().get_sm_count() * 8, 256, smem_size,
+                                   get_gpu().get_stream()>>>(in_mlp, in_emb, out, h, n_ins, in_w);
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
 template <>
 void InteractionLayer<float>::fprop(bool is_train) {
+  if (use_fused_fp32_) {
+    this->fprop_fused(is_train);
+    return;
+  }
   this->fprop_generic(is_train);
 }
 template <>
@@ -1399,8 +1547,42 @@ void InteractionLayer<T>::bprop_generic() {
                                                                 h, out_w, in_w, n_emb);
   }
 }
+
+template <typename T>
+void InteractionLayer<T>::bprop_fused() {
+  CudaDeviceContext context(get_device_id());
+  const T *up_grad;
+  T *mlp_grad, *emb_grad;
+  int h, n_ins, in_w;
+  // TODO: this block will be removed later
+  if (input_tensors_.empty()) {
+    up_grad = out_tensors_[separate_Y_and_dY_ ? 1 : 0].get_ptr();
+    mlp_grad = get_in_tensors(true)[0].get_ptr();
+    emb_grad = get_in_tensors(true)[1].get_ptr();
+    h = get_in_tensors(true)[0].get_dimensions()[0];
+    in_w = get_in_tensors(true)[0].get_dimensions()[1];
+    n_ins = 1 + get_in_tensors(true)[1].get_dimensions()[1];
+  } else {
+    up_grad = output_tensors_[separate_Y_and_dY_ ? 1 : 0].data<T>();
+    mlp_grad = input_tensors_[0].data<T>();
+    emb_grad = input_tensors_[1].data<T>();
+    h = input_tensors_[0].size(0);
+    in_w = input_tensors_[0].size(1);
+    n_ins = 1 + input_tensors_[1].size(1);
+  }
+  const size_t smem_size = fused_interaction_smem_bytes(n_ins, in_w, true);
+  fused_interaction_bprop_kernel<<<get_gpu().get_sm_count() * 8, 256, smem_size,
+                                   get_gpu().get_stream()>>>(up_grad, mlp_grad, emb_grad, h, n_ins,
+                                                             in_w);
+  HCTR_LIB_THROW(cudaGetLastError());
+}
+
 template <>
 void InteractionLayer<float>::bprop() {
+  if (use_fused_fp32_) {
+    this->bprop_fused();
+    return;
+  }
   this->bprop_generic();
 }
 template <>
@@ -16,9 +16,19 @@
 
 #include <layers/mlp_layer.hpp>
 #include <type_traits>
+#include <utils.cuh>
 
 namespace HugeCTR {
 
+namespace {
+
+// Operands of the FP8 scaling states of each layer.
+constexpr int fp8_bottom = 0;
+constexpr int fp8_kernel = 1;
+constexpr int fp8_grad_top = 2;
+
+}  // namespace
+
 template class MLPLayer<float>;
 template class MLPLayer<__half>;
 
@@ -289,7 +299,8 @@ Core23TempMLPLayer<T>::Core23TempMLPLayer(
     const std::vector<core23::Tensor>& top_tensors, const std::vector<int64_t>& num_outputs,
     const std::shared_ptr<GPUResource>& gpu_resource, const std::vector<Activation_t>& acts,
     const std::vector<bool>& use_bias, std::vector<Initializer_t> initializer_types,
-    bool skip_head_dgrad, bool async_wgrad, bool fuse_wb, bool enable_tf32_compute)
+    bool skip_head_dgrad, bool async_wgrad, bool fuse_wb, bool enable_tf32_compute,
+    bool use_fp8)
     : Core23TempTrainableLayer<T>(bottom_tensors, top_tensors, gpu_resource, initializer_types),
       num_outputs_(num_outputs),
       acts_(acts),
@@ -298,8 +309,18 @@ Core23TempMLPLayer<T>::Core23TempMLPLayer(
       async_wgrad_(async_wgrad),
       fuse_wb_(fuse_wb),
       enable_tf32_compute_(enable_tf32_compute),
+      use_fp8_(use_fp8),
       event_overlap_created_(false) {
   int num_layers = num_outputs.size();
+  if (use_fp8_) {
+    if (!std::is_same<T, __half>::value) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "FP8 MLP requires mixed precision training");
+    }
+    const int compute_capability = gpu_resource->get_cc_major() * 10 + gpu_resource->get_cc_minor();
+    if (compute_capability < 89) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "FP8 MLP requires a GPU of compute capability 8.9 or up");
+    }
+  }
   train_tensors_.resize(num_layers);
   mask_tensors_.resize(num_layers);
   output_mask_.resize(num_layers);
@@ -340,9 +361,12 @@ Core23TempMLPLayer<T>::Core23TempMLPLayer(
           core23::TensorParams().data_type(data_type).shape(shape).device(device).buffer_params(
               buffer_params));
       if (acts_[i] == Activation_t::Relu) {
-        mask_tensors_[i] = core23::Tensor(
-            core23::TensorParams().data_type(data_type).shape(shape).device(device).buffer_params(
-                buffer_params));
+        // The FP8 bprop masks the top gradient with the top itself.
+        if (!use_fp8_) {
+          mask_tensors_[i] = core23::Tensor(
+              core23::TensorParams().data_type(data_type).shape(shape).device(device).buffer_params(
+                  buffer_params));
+        }
         dact_tensors_[i] = core23::Tensor(
             core23::TensorParams().data_type(data_type).shape(shape).device(device).buffer_params(
                 buffer_params));
@@ -364,13 +388,51 @@ Core23TempMLPLayer<T>::Core23TempMLPLayer(
       }
     }
 
-    output_mask_[i] = (acts_[i] == Activation_t::Relu) && (i != num_layers - 1);
+    output_mask_[i] = (acts_[i] == Activation_t::Relu) && (i != num_layers - 1) && !use_fp8_;
+
+    if (use_fp8_) {
+      if (batch_size % 16 != 0 || input_size % 16 != 0 || output_size % 16 != 0) {
+        HCTR_OWN_THROW(Error_t::WrongInput,
+                       "FP8 MLP requires the batch size and all layer sizes to be multiples of 16");
+      }
+      auto fp8_params = core23::TensorParams()
+                            .data_type(core23::ScalarType::UInt8)
+                            .device(device)
+                            .buffer_params(buffer_params);
+      fp8_bottoms_.emplace_back(fp8_params.shape({batch_size, input_size}));
+      fp8_bottoms_t_.emplace_back(fp8_params.shape({input_size, batch_size}));
+      fp8_kernels_.emplace_back(fp8_params.shape({input_size, output_size}));
+      fp8_kernels_t_.emplace_back(fp8_params.shape({output_size, input_size}));
+      fp8_grad_tops_.emplace_back(fp8_params.shape({batch_size, output_size}));
+      fp8_grad_tops_t_.emplace_back(fp8_params.shape({output_size, batch_size}));
+      fp8_db_sums_.emplace_back(
+          fp8_params.data_type(core23::ScalarType::Float).shape({output_size}));
+    }
+  }
+
+  if (use_fp8_) {
+    core23::BufferParams buffer_params = {};
+    buffer_params.channel = GetBlobsBufferChannel();
+    core23::Device device(core23::DeviceType::GPU, gpu_resource->get_device_id());
+    fp8_states_ = core23::Tensor(
+        core23::TensorParams()
+            .data_type(core23::ScalarType::UInt8)
+            .shape({num_layers * 3, static_cast<int64_t>(sizeof(Fp8ScalingState))})
+            .device(device)
+            .buffer_params(buffer_params));
+    fp8_fprop_gemms_.resize(num_layers);
+    fp8_wgrad_gemms_.resize(num_layers);
+    fp8_dgrad_gemms_.resize(num_layers);
   }
 }
 
 template <typename T>
 void Core23TempMLPLayer<T>::fprop(bool is_train) {
   CudaDeviceContext context(this->get_device_id());
+  if (use_fp8_) {
+    fprop_fp8(is_train);
+    return;
+  }
   int num_layers = num_outputs_.size();
   for (int i = 0; i < num_layers; i++) {
     const T* kernel = kernels_[i].data<T>();
@@ -391,6 +453,10 @@ void Core23TempMLPLayer<T>::fprop(bool is_train) {
 template <typename T>
 void Core23TempMLPLayer<T>::bprop() {
   CudaDeviceContext context(this->get_device_id());
+  if (use_fp8_) {
+    bprop_fp8();
+    return;
+  }
 
   int num_layers = num_outputs_.size();
   for (int i = num_layers - 1; i >= 0; i--) {
@@ -445,6 +511,10 @@ void Core23TempMLPLayer<T>::initialize() {
 
   HCTR_LIB_THROW(cudaEventCreate(&event_overlap_));
   event_overlap_created_ = true;
+  if (use_fp8_) {
+    initialize_fp8();
+    return;
+  }
 
   int num_layers = num_outputs_.size();
   for (int i = 0; i < num_layers; i++) {
@@ -497,6 +567,10 @@ void Core23TempMLPLayer<T>::initialize() {
 template <typename T>
 void Core23TempMLPLayer<T>::search_algorithm() {
   CudaDeviceContext context(this->get_device_id());
+  // The FP8 GEMMs keep the heuristic algorithms of initialize().
+  if (use_fp8_) {
+    return;
+  }
   int num_layers = num_outputs_.size();
   for (int i = 0; i < num_layers; i++) {
     T* kernel = kernels_[i].data<T>();
@@ -516,6 +590,153 @@ void Core23TempMLPLayer<T>::search_algorithm() {
   }
 }
 
+template <typename T>
+void Core23TempMLPLayer<T>::initialize_fp8() {
+  if constexpr (std::is_same<T, __half>::value) {
+    int num_layers = num_outputs_.size();
+    std::vector<Fp8ScalingState> states;
+    for (int i = 0; i < num_layers; i++) {
+      states.push_back(make_fp8_scaling_state(FP8_E4M3_MAX_NORM));
+      states.push_back(make_fp8_scaling_state(FP8_E4M3_MAX_NORM));
+      states.push_back(make_fp8_scaling_state(FP8_E5M2_MAX_NORM));
+    }
+    HCTR_LIB_THROW(cudaMemcpyAsync(get_fp8_state(0, 0), states.data(),
+                                   states.size() * sizeof(Fp8ScalingState), cudaMemcpyHostToDevice,
+                                   this->get_gpu().get_stream()));
+
+    const auto cublaslt_handle = this->get_gpu().get_cublaslt_handle();
+    for (int i = 0; i < num_layers; i++) {
+      const auto& bottom_tensor_dim =
+          i == 0 ? this->input_tensors_[0].shape() : train_tensors_[i - 1].shape();
+      int64_t batch_size = bottom_tensor_dim.size(0);
+      int64_t input_size = bottom_tensor_dim.size(1);
+      int64_t output_size = num_outputs_[i];
+      const __half* bias_ptr = use_bias_[i] ? biases_[i].data<__half>() : nullptr;
+      const float* bottom_scale_inv = &get_fp8_state(i, fp8_bottom)->scale_inv;
+      const float* kernel_scale_inv = &get_fp8_state(i, fp8_kernel)->scale_inv;
+      const float* grad_top_scale_inv = &get_fp8_state(i, fp8_grad_top)->scale_inv;
+
+      // top^T = kernel^T * bottom^T
+      fp8_fprop_gemms_[i].init(output_size, batch_size, input_size, CUDA_R_8F_E4M3,
+                               CUDA_R_8F_E4M3, kernel_scale_inv, bottom_scale_inv, bias_ptr,
+                               acts_[i], true, cublaslt_handle);
+      // bottom_grad^T = kernel * top_grad^T
+      fp8_dgrad_gemms_[i].init(input_size, batch_size, output_size, CUDA_R_8F_E4M3,
+                               CUDA_R_8F_E5M2, kernel_scale_inv, grad_top_scale_inv, nullptr,
+                               Activation_t::None, false, cublaslt_handle);
+      // kernel_grad^T = top_grad^T * bottom
+      fp8_wgrad_gemms_[i].init(output_size, input_size, batch_size, CUDA_R_8F_E5M2,
+                               CUDA_R_8F_E4M3, grad_top_scale_inv, bottom_scale_inv, nullptr,
+                               Activation_t::None, false, cublaslt_handle);
+    }
+  }
+}
+
+template <typename T>
+void Core23TempMLPLayer<T>::fprop_fp8(bool is_train) {
+  if constexpr (std::is_same<T, __half>::value) {
+    const auto stream = this->get_gpu().get_stream();
+    int num_layers = num_outputs_.size();
+    for (int i = 0; i < num_layers; i++) {
+      const auto& bottom_tensor_dim =
+          i == 0 ? this->input_tensors_[0].shape() : train_tensors_[i - 1].shape();
+      int64_t batch_size = bottom_tensor_dim.size(0);
+      int64_t input_size = bottom_tensor_dim.size(1);
+      int64_t output_size = num_outputs_[i];
+      const __half* bottom = i == 0 ? this->input_tensors_[0].template data<__half>()
+                                    : train_tensors_[i - 1].data<__half>();
+      __half* top_fprop = train_tensors_[i].data<__half>();
+
+      // Only training collects amaxes, and needs the transposed bottom for the wgrad.
+      auto fp8_bottom_t = is_train ? fp8_bottoms_t_[i].data<__nv_fp8_e4m3>() : nullptr;
+      quantize_fp8(bottom, nullptr, fp8_bottoms_[i].data<__nv_fp8_e4m3>(), fp8_bottom_t,
+                   batch_size, input_size, get_fp8_state(i, fp8_bottom), is_train, nullptr, stream);
+      quantize_fp8(kernels_[i].data<__half>(), nullptr, fp8_kernels_[i].data<__nv_fp8_e4m3>(),
+                   fp8_kernels_t_[i].data<__nv_fp8_e4m3>(), input_size, output_size,
+                   get_fp8_state(i, fp8_kernel), is_train, nullptr, stream);
+      fp8_fprop_gemms_[i](fp8_kernels_t_[i].data(), fp8_bottoms_[i].data(), 0.0f, top_fprop,
+                          this->get_gpu().get_cublaslt_handle(), stream);
+
+      if (i == num_layers - 1 && acts_[i] == Activation_t::Relu) {
+        __half* mask_out = mask_tensors_[i].data<__half>();
+        int64_t len = train_tensors_[i].num_elements();
+        HCTR_LIB_THROW(cudaMemcpyAsync(mask_out, top_fprop, len * sizeof(__half),
+                                       cudaMemcpyDeviceToDevice, stream));
+      }
+    }
+  }
+}
+
+template <typename T>
+void Core23TempMLPLayer<T>::bprop_fp8() {
+  if constexpr (std::is_same<T, __half>::value) {
+    const auto stream = this->get_gpu().get_stream();
+    const auto overlap_stream = this->get_gpu().get_comp_overlap_stream();
+    const auto cublaslt_handle = this->get_gpu().get_cublaslt_handle();
+    int num_layers = num_outputs_.size();
+    for (int i = num_layers - 1; i >= 0; i--) {
+      const auto& bottom_tensor_dim =
+          i == 0 ? this->input_tensors_[0].shape() : train_tensors_[i - 1].shape();
+      int64_t batch_size = bottom_tensor_dim.size(0);
+      int64_t top_size = num_outputs_[i];
+      const bool is_relu = acts_[i] == Activation_t::Relu;
+
+      // The next layer writes the gradient of a hidden ReLU layer to its dact tensor, so that its
+      // top stays intact as the mask. The last layer gets its gradient in the top, which its fprop
+      // has copied to the mask tensor.
+      const __half* top = train_tensors_[i].data<__half>();
+      const __half* grad_top =
+          is_relu && i != num_layers - 1 ? dact_tensors_[i].data<__half>() : top;
+      const __half* mask_top = nullptr;
+      if (is_relu) {
+        mask_top = i == num_layers - 1 ? mask_tensors_[i].data<__half>() : top;
+      }
+      float* db_sum = use_bias_[i] ? fp8_db_sums_[i].data<float>() : nullptr;
+      if (db_sum != nullptr) {
+        HCTR_LIB_THROW(cudaMemsetAsync(db_sum, 0, top_size * sizeof(float), stream));
+      }
+      quantize_fp8(grad_top, mask_top, fp8_grad_tops_[i].data<__nv_fp8_e5m2>(),
+                   fp8_grad_tops_t_[i].data<__nv_fp8_e5m2>(), batch_size, top_size,
+                   get_fp8_state(i, fp8_grad_top), true, db_sum, stream);
+      if (db_sum != nullptr) {
+        convert_array<<<(top_size - 1) / 1024 + 1, 1024, 0, stream>>>(db_tensors_[i].data<__half>(),
+                                                                       db_sum, top_size);
+      }
+
+      __half* bottom_bprop = nullptr;
+      if (i != 0) {
+        bottom_bprop = acts_[i - 1] == Activation_t::None ? train_tensors_[i - 1].data<__half>()
+                                                          : dact_tensors_[i - 1].data<__half>();
+      } else {
+        bottom_bprop = this->input_tensors_.size() == 1
+                           ? this->input_tensors_[0].template data<__half>()
+                           : this->input_tensors_[1].template data<__half>();
+      }
+
+      // The wgrad reads the FP8 copy of the bottom, so it can overlap with the dgrad even when
+      // the dgrad overwrites the bottom.
+      if (async_wgrad_) {
+        HCTR_LIB_THROW(cudaEventRecord(event_overlap_, stream));
+        HCTR_LIB_THROW(cudaStreamWaitEvent(overlap_stream, event_overlap_));
+      }
+      fp8_wgrad_gemms_[i](fp8_grad_tops_t_[i].data(), fp8_bottoms_t_[i].data(), 1.0f,
+                          kernels_grad_[i].data<__half>(), cublaslt_handle,
+                          async_wgrad_ ? overlap_stream : stream);
+      if (i != 0 || !skip_head_dgrad_) {
+        fp8_dgrad_gemms_[i](fp8_kernels_[i].data(), fp8_grad_tops_[i].data(), 0.0f, bottom_bprop,
+                            cublaslt_handle, stream);
+      }
+    }
+
+    if (async_wgrad_) {
+      HCTR_LIB_THROW(cudaEventRecord(event_overlap_, overlap_stream));
+      HCTR_LIB_THROW(cudaStreamWaitEvent(stream, event_overlap_));
+    }
+    // The scales of this iteration are read until the last wgrad, so they are updated only now.
+    update_fp8_scaling_states(get_fp8_state(0, 0), num_layers * 3, stream);
+  }
+}
+
 template <typename T>
 std::unique_ptr<DataSimulator> Core23TempMLPLayer<T>::get_uniform_initializer(const int index) {
   int i = index / 2;
@@ -192,11 +192,12 @@ __global__ void vector_fma3_align8(T* __restrict__ pout, const T* __restrict__ p
   if (gtid < len) pout[gtid] += pvec_a[gtid] * pvec_b[gtid];
 }
 // out0 = a * b
-// out1 += a * c
+// out1 += a * c, and also += a with add_a
 template <typename T, int VecLen = 1, int SHT = 0>
 __global__ void vector_mul_fma3_align(T* __restrict__ pout0, T* __restrict__ pout1,
                                       const T* __restrict__ pvec_a, const T* __restrict__ pvec_b,
-                                      const T* __restrict__ pvec_c, const int len) {
+                                      const T* __restrict__ pvec_c, const int len,
+                                      const bool add_a = false) {
   const int gtid = (blockDim.x * blockIdx.x + threadIdx.x) << SHT;
   if (gtid >= len) {
     return;
@@ -223,6 +224,9 @@ __global__ void vector_mul_fma3_align(T* __restrict__ pout0, T* __restrict__ pou
   for (int i = 0; i < VecLen; i++) {
     mul[i] = regA[i] * regB[i];
     acc[i] += regA[i] * regC[i];
+    if (add_a) {
+      acc[i] += regA[i];
+    }
   }
 // store
 #pragma unroll
@@ -232,11 +236,12 @@ __global__ void vector_mul_fma3_align(T* __restrict__ pout0, T* __restrict__ pou
   }
 }
 // out0 = a * b
-// out1 += a * c
+// out1 += a * c, and also += a with add_a
 template <>
 __global__ void vector_mul_fma3_align<__half, 8, 3>(
     __half* __restrict__ pout0, __half* __restrict__ pout1, const __half* __restrict__ pvec_a,
-    const __half* __restrict__ pvec_b, const __half* __restrict__ pvec_c, const int len) {
+    const __half* __restrict__ pvec_b, const __half* __restrict__ pvec_c, const int len,
+    const bool add_a) {
   const int start = (blockDim.x * blockIdx.x + threadIdx.x) << 3;
   if (start >= len) {
     return;
@@ -267,6 +272,12 @@ __global__ void vector_mul_fma3_align<__half, 8, 3>(
                       *reinterpret_cast<half2*>(&acc_8.z));
     out1[3] = __hfma2(*reinterpret_cast<half2*>(&a_8.w), *reinterpret_cast<half2*>(&c_8.w),
                       *reinterpret_cast<half2*>(&acc_8.w));
+    if (add_a) {
+      out1[0] = __hadd2(out1[0], *reinterpret_cast<half2*>(&a_8.x));
+      out1[1] = __hadd2(out1[1], *reinterpret_cast<half2*>(&a_8.y));
+      out1[2] = __hadd2(out1[2], *reinterpret_cast<half2*>(&a_8.z));
+      out1[3] = __hadd2(out1[3], *reinterpret_cast<half2*>(&a_8.w));
+    }
     // store
     *out1_ptr = out1;
   }
@@ -1522,9 +1533,12 @@ void matrix_add(core23::Tensor& out_mat, const core23::Tensor& mat_a, const core
       pout, pmat_a, pmat_b, h * w, [] __device__(T a, T b) { return a + b; }, stream);
 }
 
+// Y0 = A .* B
+// Y1 += A .* C, plus A with add_a
 template <typename T>
 void fused_mul_fma3(core23::Tensor& Y0, core23::Tensor& Y1, const core23::Tensor& A,
-                    const core23::Tensor& B, const core23::Tensor& C, cudaStream_t stream) {
+                    const core23::Tensor& B, const core23::Tensor& C, cudaStream_t stream,
+                    bool add_a = false) {
   const T* pmat_a = A.data<T>();
   const T* pmat_b = B.data<T>();
   const T* pmat_c = C.data<T>();
@@ -1549,11 +1563,11 @@ void fused_mul_fma3(core23::Tensor& Y0, core23::Tensor& Y1, const core23::Tensor
   int GRID_DIM = (len + BLOCK_DIM - 1) / BLOCK_DIM;
   if (len % 8 == 0 && std::is_same<T, __half>::value) {
     GRID_DIM = (len / 8 + BLOCK_DIM - 1) / BLOCK_DIM;
-    vector_mul_fma3_align<T, 8, 3>
-        <<<GRID_DIM, BLOCK_DIM, 0, stream>>>(pmat_o0, pmat_o1, pmat_a, pmat_b, pmat_c, len);
+    vector_mul_fma3_align<T, 8, 3><<<GRID_DIM, BLOCK_DIM, 0, stream>>>(
+        pmat_o0, pmat_o1, pmat_a, pmat_b, pmat_c, len, add_a);
   } else {
-    vector_mul_fma3_align<T>
-        <<<GRID_DIM, BLOCK_DIM, 0, stream>>>(pmat_o0, pmat_o1, pmat_a, pmat_b, pmat_c, len);
+    vector_mul_fma3_align<T><<<GRID_DIM, BLOCK_DIM, 0, stream>>>(pmat_o0, pmat_o1, pmat_a, pmat_b,
+                                                                 pmat_c, len, add_a);
   }
 }
 // perform out_mat = mat_a * mat_b + mat_c
@@ -1890,8 +1904,10 @@ void Core23TempMultiCrossBackwardFunctorv2<T>::operator()(
   for (int i = num_layers - 1; i >= 0; i--) {
     // S0 = dY_i .* X , shape: (batchsize, w)
     // dX += dY_i .* H , shape: (batchsize, w)
+    // The first cell also adds its dY to dX, which is then the residual of its last gemm, so that
+    // no separate pass adds dX to dY_{-1}.
     fused_mul_fma3<T>(bprop_bottoms[2 * i], accum_dx_tensor_, grad_tensors[i + 1], input_tensor,
-                      layer_hidden_tensors[i], dgrad_stream);
+                      layer_hidden_tensors[i], dgrad_stream, i == 0);
 
     {
       if (async_wgrad) {
@@ -1927,17 +1943,16 @@ void Core23TempMultiCrossBackwardFunctorv2<T>::operator()(
         HCTR_LIB_THROW(cudaStreamWaitEvent(dgrad_stream, event_overlap));
       }
 
-      // 4 dY_{i-1} = S1 * U^T + dY_{i} shape: (batchsize, w)
+      // 4 dY_{i-1} = S1 * U^T + dY_{i} shape: (batchsize, w), and + dX for the first cell
       mat_a = bprop_bottoms[1 + 2 * i].data<T>();
       mat_b = kernel_tensors[i * 2].data<T>();
-      mat_c = grad_tensors[i + 1].data<T>();
+      mat_c = i == 0 ? accum_dx_tensor_.data<T>() : grad_tensors[i + 1].data<T>();
       T* mat_d = grad_tensors[i].data<T>();
       // gemm: mat_d = mat_a * mat_b + mat_c
       this->gemm_functor_(1.0f, mat_a, mat_b, 1.0f, mat_c, mat_d, dhidden_descrs_bprop_[i],
                           dhidden_bprop_algos_[i], cublaslt_handle, dgrad_stream);
     }
   }
-  matrix_add<T>(grad_tensors[0], accum_dx_tensor_, grad_tensors[0], dgrad_stream);
   if (async_wgrad) {
     HCTR_LIB_THROW(cudaEventRecord(event_overlap, wgrad_stream));
     HCTR_LIB_THROW(cudaStreamWaitEvent(dgrad_stream, event_overlap));
@@ -2175,6 +2190,7 @@ void Core23TempMultiCrossLayer<T>::fprop(bool is_train) {
     output_tensors.push_back(activation_tensors_[i + 1]);
     hidden_tensors.push_back(hidden_tensors_[i]);
   }
+  set_x0_window_(this->get_gpu().get_stream(), true);
   if (this->projection_dim_ == 0) {
     // dcn v1
     Core23TempMultiCrossForwardFunctor<T>()(
@@ -2188,6 +2204,7 @@ void Core23TempMultiCrossLayer<T>::fprop(bool is_train) {
                                  xu_fprop_algos_, xuvb_fprop_algos_,
                                  this->get_gpu().get_cublaslt_handle());
   }
+  set_x0_window_(this->get_gpu().get_stream(), false);
 }
 
 template <typename T>
@@ -2226,6 +2243,7 @@ void Core23TempMultiCrossLayer<T>::bprop() {
   for (int i = 0; i < num_layers_ - 1; i++) {
     forward_output_tensors.push_back(activation_tensors_[i + 1]);
   }
+  set_x0_window_(this->get_gpu().get_stream(), true);
   if (this->projection_dim_ == 0) {
     // dcn v1
     Core23TempMultiCrossBackwardFunctor<T>()(
@@ -2243,6 +2261,20 @@ void Core23TempMultiCrossLayer<T>::bprop() {
         du_descrs_bprop_, dhidden_descrs_bprop_, xu_bprop_algos_, xuvb_bprop_algos_,
         du_bprop_algos_, dhidden_bprop_algos_, this->get_gpu().get_cublaslt_handle());
   }
+  set_x0_window_(this->get_gpu().get_stream(), false);
+}
+
+template <typename T>
+void Core23TempMultiCrossLayer<T>::set_x0_window_(cudaStream_t stream, bool persisting) {
+  if (x0_window_.num_bytes == 0) {
+    return;
+  }
+  cudaStreamAttrValue attr = {};
+  attr.accessPolicyWindow = x0_window_;
+  if (!persisting) {
+    attr.accessPolicyWindow.num_bytes = 0;
+  }
+  HCTR_LIB_THROW(cudaStreamSetAttribute(stream, cudaStreamAttributeAccessPolicyWindow, &attr));
 }
 template <typename T>
 void Core23TempMultiCrossLayer<T>::search_algorithm() {
@@ -2375,6 +2407,29 @@ void Core23TempMultiCrossLayer<T>::initialize() {
       }
     }
   }
+
+  // The persisting L2 is shared by the device, so it's only ever grown to fit x0.
+  int max_persisting_bytes = 0;
+  int max_window_bytes = 0;
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&max_persisting_bytes, cudaDevAttrMaxPersistingL2CacheSize,
+                                        this->get_device_id()));
+  HCTR_LIB_THROW(cudaDeviceGetAttribute(&max_window_bytes, cudaDevAttrMaxAccessPolicyWindowSize,
+                                        this->get_device_id()));
+  if (max_persisting_bytes > 0 && max_window_bytes > 0) {
+    const size_t x0_bytes = activation_tensors_[0].num_bytes();
+    size_t persisting_bytes = 0;
+    HCTR_LIB_THROW(cudaDeviceGetLimit(&persisting_bytes, cudaLimitPersistingL2CacheSize));
+    persisting_bytes =
+        std::max(persisting_bytes, std::min(x0_bytes, static_cast<size_t>(max_persisting_bytes)));
+    HCTR_LIB_THROW(cudaDeviceSetLimit(cudaLimitPersistingL2CacheSize, persisting_bytes));
+
+    x0_window_.base_ptr = activation_tensors_[0].data();
+    x0_window_.num_bytes = std::min(x0_bytes, static_cast<size_t>(max_window_bytes));
+    x0_window_.hitRatio = std::min(1.0f, static_cast<float>(persisting_bytes) /
+                                             static_cast<float>(x0_window_.num_bytes));
+    x0_window_.hitProp = cudaAccessPropertyPersisting;
+    x0_window_.missProp = cudaAccessPropertyStreaming;
+  }
   HCTR_LIB_THROW(cudaDeviceSynchronize());
 }
 template <typename T>
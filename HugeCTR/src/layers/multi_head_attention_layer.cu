@@ -20,6 +20,7 @@
 #include <layers/multi_head_attention_layer.hpp>
 #include <memory>
 #include <network_buffer_channels.hpp>
+#include <recompute_workspace.hpp>
 #include <utils.cuh>
 #include <utils.hpp>
 namespace HugeCTR {
@@ -154,17 +155,320 @@ __global__ void transpose_V(T* v_buf, const T* V, const int batch_size, const in
   float input_V = V[d0 * d0_stride + d1 * d1_stride + d2 * d2_stride + d3];
   v_buf[d0 * d0_out_stride + d1 * d1_out_stride + d2 * d2_out_stride + d3] = input_V;
 }
+// The fused attention goes over the keys, or the queries in bprop, in tiles of shared memory, with
+// one warp per row of one head. Each lane keeps up to 4 of the dims of the row it accumulates.
+constexpr int kFusedAttentionMaxHeadSize = 128;
+constexpr int kFusedAttentionTile = 32;
+constexpr int kFusedAttentionWarps = 4;
+constexpr int kFusedAttentionDimsPerLane = kFusedAttentionMaxHeadSize / 32;
+
+// Offset of a row of one head in a [batch_size, seq_len, head_num * size_per_head] tensor
+__device__ __forceinline__ int64_t attention_row_offset(int batch, int pos, int head, int seq_len,
+                                                        int head_num, int size_per_head) {
+  return ((static_cast<int64_t>(batch) * seq_len + pos) * head_num + head) * size_per_head;
+}
+
+// Loads the rows [first, first + kFusedAttentionTile) of one head into a tile of size_per_head + 1
+// floats per row, so that the lanes reading a column of it don't conflict.
+template <typename T>
+__device__ void load_attention_tile(float* tile, const T* rows, int batch, int first, int head,
+                                    int seq_len, int head_num, int size_per_head) {
+  const int tile_len = min(kFusedAttentionTile, seq_len - first);
+  for (int idx = threadIdx.x; idx < tile_len * size_per_head; idx += blockDim.x) {
+    const int r = idx / size_per_head;
+    const int x = idx % size_per_head;
+    tile[r * (size_per_head + 1) + x] = static_cast<float>(
+        rows[attention_row_offset(batch, first + r, head, seq_len, head_num, size_per_head) + x]);
+  }
+}
+
+template <typename T>
+__device__ void load_attention_row(float* row, const T* rows, int batch, int pos, int head,
+                                   int seq_len, int head_num, int size_per_head) {
+  const int64_t offset = attention_row_offset(batch, pos, head, seq_len, head_num, size_per_head);
+  for (int x = threadIdx.x % 32; x < size_per_head; x += 32) {
+    row[x] = static_cast<float>(rows[offset + x]);
+  }
+}
+
+// The scaled and masked score of a query and a key, as in MaskedSoftmaxLayer
+template <typename T>
+__device__ __forceinline__ float attention_score(const float* q, const float* k, const T* mask,
+                                                 int batch, int i, int j, int seq_from, int seq_to,
+                                                 int size_per_head, float scale) {
+  float s = 0.0f;
+  for (int x = 0; x < size_per_head; x++) {
+    s += q[x] * k[x];
+  }
+  s *= scale;
+  if (mask) {
+    const int64_t mask_offset = (static_cast<int64_t>(batch) * seq_from + i) * seq_to + j;
+    s -= (1.0f - static_cast<float>(mask[mask_offset])) * 10000.0f;
+  }
+  return s;
+}
+
+// out = softmax(scale * Q * K^T - mask) * V with an online softmax, which also keeps the log sum
+// exp of the scores of each query for bprop.
+// grid = ((seq_from - 1) / kFusedAttentionWarps + 1, batch_size * head_num)
+// block = 32 * kFusedAttentionWarps
+template <typename T>
+__global__ void fused_attention_fprop_kernel(T* out, float* lse, const T* query, const T* key,
+                                             const T* value, const T* mask, int head_num,
+                                             int seq_from, int seq_to, int size_per_head,
+                                             float scale) {
+  extern __shared__ float smem[];
+  const int tile_stride = size_per_head + 1;
+  float* k_tile = smem;
+  float* v_tile = k_tile + kFusedAttentionTile * tile_stride;
+  const int warp = threadIdx.x / 32;
+  const int lane = threadIdx.x % 32;
+  float* q = v_tile + kFusedAttentionTile * tile_stride + warp * size_per_head;
+
+  const int batch = blockIdx.y / head_num;
+  const int head = blockIdx.y % head_num;
+  const int i = blockIdx.x * kFusedAttentionWarps + warp;
+  const bool active = i < seq_from;
+  if (active) {
+    load_attention_row(q, query, batch, i, head, seq_from, head_num, size_per_head);
+  }
+
+  float acc[kFusedAttentionDimsPerLane] = {};
+  float row_max = -INFINITY;
+  float row_sum = 0.0f;
+  for (int first = 0; first < seq_to; first += kFusedAttentionTile) {
+    __syncthreads();
+    load_attention_tile(k_tile, key, batch, first, head, seq_to, head_num, size_per_head);
+    load_attention_tile(v_tile, value, batch, first, head, seq_to, head_num, size_per_head);
+    __syncthreads();
+    if (!active) {
+      continue;
+    }
+    const int tile_len = min(kFusedAttentionTile, seq_to - first);
+    const float s = lane < tile_len
+                        ? attention_score(q, k_tile + lane * tile_stride, mask, batch, i,
+                                          first + lane, seq_from, seq_to, size_per_head, scale)
+                        : -INFINITY;
+    const float new_max = fmaxf(row_max, warpReduceMax(s));
+    const float p = lane < tile_len ? __expf(s - new_max) : 0.0f;
+    const float correction = __expf(row_max - new_max);
+    row_sum = row_sum * correction + warpReduceSum(p);
+    row_max = new_max;
+#pragma unroll
+    for (int t = 0; t < kFusedAttentionDimsPerLane; t++) {
+      acc[t] *= correction;
+    }
+    for (int jj = 0; jj < tile_len; jj++) {
+      const float p_jj = __shfl_sync(0xffffffff, p, jj);
+#pragma unroll
+      for (int t = 0; t < kFusedAttentionDimsPerLane; t++) {
+        const int x = lane + 32 * t;
+        if (x < size_per_head) {
+          acc[t] += p_jj * v_tile[jj * tile_stride + x];
+        }
+      }
+    }
+  }
+
+  if (active) {
+    const int64_t offset = attention_row_offset(batch, i, head, seq_from, head_num, size_per_head);
+#pragma unroll
+    for (int t = 0; t < kFusedAttentionDimsPerLane; t++) {
+      const int x = lane + 32 * t;
+      if (x < size_per_head) {
+        out[offset + x] = static_cast<T>(acc[t] / row_sum);
+      }
+    }
+    if (lane == 0) {
+      lse[static_cast<int64_t>(blockIdx.y) * seq_from + i] = row_max + __logf(row_sum);
+    }
+  }
+}
+
+// dQ = scale * dS * K, with dS = P * (dP - delta), dP = dO * V^T and delta = rowsum(P * dP). The
+// softmax P is recomputed from the log sum exp of fprop, in one pass for delta and one for dQ.
+// grid and block as in fused_attention_fprop_kernel
+template <typename T>
+__global__ void fused_attention_bprop_dq_kernel(T* d_query, float* delta, const T* d_out,
+                                                const float* lse, const T* query, const T* key,
+                                                const T* value, const T* mask, int head_num,
+                                                int seq_from, int seq_to, int size_per_head,
+                                                float scale) {
+  extern __shared__ float smem[];
+  const int tile_stride = size_per_head + 1;
+  float* k_tile = smem;
+  float* v_tile = k_tile + kFusedAttentionTile * tile_stride;
+  const int warp = threadIdx.x / 32;
+  const int lane = threadIdx.x % 32;
+  float* q = v_tile + kFusedAttentionTile * tile_stride + warp * 2 * size_per_head;
+  float* d_o = q + size_per_head;
+
+  const int batch = blockIdx.y / head_num;
+  const int head = blockIdx.y % head_num;
+  const int i = blockIdx.x * kFusedAttentionWarps + warp;
+  const bool active = i < seq_from;
+  const int64_t row = static_cast<int64_t>(blockIdx.y) * seq_from + i;
+  float row_lse = 0.0f;
+  if (active) {
+    load_attention_row(q, query, batch, i, head, seq_from, head_num, size_per_head);
+    load_attention_row(d_o, d_out, batch, i, head, seq_from, head_num, size_per_head);
+    row_lse = lse[row];
+  }
+
+  float acc[kFusedAttentionDimsPerLane] = {};
+  float row_delta = 0.0f;
+  for (int pass = 0; pass < 2; pass++) {
+    for (int first = 0; first < seq_to; first += kFusedAttentionTile) {
+      __syncthreads();
+      load_attention_tile(k_tile, key, batch, first, head, seq_to, head_num, size_per_head);
+      load_attention_tile(v_tile, value, batch, first, head, seq_to, head_num, size_per_head);
+      __syncthreads();
+      if (!active) {
+        continue;
+      }
+      const int tile_len = min(kFusedAttentionTile, seq_to - first);
+      float p = 0.0f;
+      float dp = 0.0f;
+      if (lane < tile_len) {
+        p = __expf(attention_score(q, k_tile + lane * tile_stride, mask, batch, i, first + lane,
+                                   seq_from, seq_to, size_per_head, scale) -
+                   row_lse);
+        for (int x = 0; x < size_per_head; x++) {
+          dp += d_o[x] * v_tile[lane * tile_stride + x];
+        }
+      }
+      if (pass == 0) {
+        row_delta += p * dp;
+        continue;
+      }
+      const float ds = p * (dp - row_delta);
+      for (int jj = 0; jj < tile_len; jj++) {
+        const float ds_jj = __shfl_sync(0xffffffff, ds, jj);
+#pragma unroll
+        for (int t = 0; t < kFusedAttentionDimsPerLane; t++) {
+          const int x = lane + 32 * t;
+          if (x < size_per_head) {
+            acc[t] += ds_jj * k_tile[jj * tile_stride + x];
+          }
+        }
+      }
+    }
+    if (pass == 0 && active) {
+      row_delta = warpReduceSum(row_delta);
+    }
+  }
+
+  if (active) {
+    const int64_t offset = attention_row_offset(batch, i, head, seq_from, head_num, size_per_head);
+#pragma unroll
+    for (int t = 0; t < kFusedAttentionDimsPerLane; t++) {
+      const int x = lane + 32 * t;
+      if (x < size_per_head) {
+        d_query[offset + x] = static_cast<T>(scale * acc[t]);
+      }
+    }
+    if (lane == 0) {
+      delta[row] = row_delta;
+    }
+  }
+}
+
+// dK = scale * dS^T * Q and dV = P^T * dO, with one warp per key and the queries in tiles.
+// grid = ((seq_to - 1) / kFusedAttentionWarps + 1, batch_size * head_num)
+// block = 32 * kFusedAttentionWarps
+template <typename T>
+__global__ void fused_attention_bprop_dkv_kernel(T* d_key, T* d_value, const T* d_out,
+                                                 const float* lse, const float* delta,
+                                                 const T* query, const T* key, const T* value,
+                                                 const T* mask, int head_num, int seq_from,
+                                                 int seq_to, int size_per_head, float scale) {
+  extern __shared__ float smem[];
+  const int tile_stride = size_per_head + 1;
+  float* q_tile = smem;
+  float* do_tile = q_tile + kFusedAttentionTile * tile_stride;
+  float* lse_tile = do_tile + kFusedAttentionTile * tile_stride;
+  float* delta_tile = lse_tile + kFusedAttentionTile;
+  const int warp = threadIdx.x / 32;
+  const int lane = threadIdx.x % 32;
+  float* k = delta_tile + kFusedAttentionTile + warp * 2 * size_per_head;
+  float* v = k + size_per_head;
+
+  const int batch = blockIdx.y / head_num;
+  const int head = blockIdx.y % head_num;
+  const int j = blockIdx.x * kFusedAttentionWarps + warp;
+  const bool active = j < seq_to;
+  if (active) {
+    load_attention_row(k, key, batch, j, head, seq_to, head_num, size_per_head);
+    load_attention_row(v, value, batch, j, head, seq_to, head_num, size_per_head);
+  }
+
+  float dk[kFusedAttentionDimsPerLane] = {};
+  float dv[kFusedAttentionDimsPerLane] = {};
+  for (int first = 0; first < seq_from; first += kFusedAttentionTile) {
+    const int tile_len = min(kFusedAttentionTile, seq_from - first);
+    __syncthreads();
+    load_attention_tile(q_tile, query, batch, first, head, seq_from, head_num, size_per_head);
+    load_attention_tile(do_tile, d_out, batch, first, head, seq_from, head_num, size_per_head);
+    if (threadIdx.x < tile_len) {
+      const int64_t row = static_cast<int64_t>(blockIdx.y) * seq_from + first + threadIdx.x;
+      lse_tile[threadIdx.x] = lse[row];
+      delta_tile[threadIdx.x] = delta[row];
+    }
+    __syncthreads();
+    if (!active) {
+      continue;
+    }
+    float p = 0.0f;
+    float ds = 0.0f;
+    if (lane < tile_len) {
+      p = __expf(attention_score(q_tile + lane * tile_stride, k, mask, batch, first + lane, j,
+                                 seq_from, seq_to, size_per_head, scale) -
+                 lse_tile[lane]);
+      float dp = 0.0f;
+      for (int x = 0; x < size_per_head; x++) {
+        dp += do_tile[lane * tile_stride + x] * v[x];
+      }
+      ds = p * (dp - delta_tile[lane]);
+    }
+    for (int ii = 0; ii < tile_len; ii++) {
+      const float p_ii = __shfl_sync(0xffffffff, p, ii);
+      const float ds_ii = __shfl_sync(0xffffffff, ds, ii);
+#pragma unroll
+      for (int t = 0; t < kFusedAttentionDimsPerLane; t++) {
+        const int x = lane + 32 * t;
+        if (x < size_per_head) {
+          dv[t] += p_ii * do_tile[ii * tile_stride + x];
+          dk[t] += ds_ii * q_tile[ii * tile_stride + x];
+        }
+      }
+    }
+  }
+
+  if (active) {
+    const int64_t offset = attention_row_offset(batch, j, head, seq_to, head_num, size_per_head);
+#pragma unroll
+    for (int t = 0; t < kFusedAttentionDimsPerLane; t++) {
+      const int x = lane + 32 * t;
+      if (x < size_per_head) {
+        d_key[offset + x] = static_cast<T>(scale * dk[t]);
+        d_value[offset + x] = static_cast<T>(dv[t]);
+      }
+    }
+  }
+}
+
 // input is q, k, v, mask
 template <typename T>
 MultiHeadAttentionLayer<T>::MultiHeadAttentionLayer(
     const std::vector<core23::Tensor>& input_tensors, std::vector<core23::Tensor>& output_tensors,
     int num_attention_heads, bool transpose_b, const std::shared_ptr<GPUResource>& gpu_resource,
-    bool use_mixed_precision, bool enable_tf32_compute)
+    bool use_mixed_precision, bool enable_tf32_compute, bool recompute_activations)
     : Layer(input_tensors, {}, gpu_resource),
       use_mixed_precision_(use_mixed_precision),
       enable_tf32_compute_(enable_tf32_compute),
       num_(input_tensors_.size()),
-      dims_(input_tensors_[0].dims()) {
+      dims_(input_tensors_[0].dims()),
+      recompute_activations_(recompute_activations) {
   try {
     // k always is the gemm K
     int64_t m = 0, k = 0, h = 0, b = 0, size_per_head = 0;
@@ -213,19 +517,45 @@ MultiHeadAttentionLayer<T>::MultiHeadAttentionLayer(
     core23::Shape score_shape = {b, h, m, k};
     core23::Shape from_shape = {b, h, m, size_per_head};
     core23::Shape to_shape = {b, h, k, size_per_head};
-    attention_score_4d_ = core23::Tensor(common_tensor_params.shape(score_shape));
-    attention_softmax_4d_ = core23::Tensor(common_tensor_params.shape(score_shape));
-    attention_out_4d_ = core23::Tensor(common_tensor_params.shape(from_shape));
+    // per query of each head
+    core23::Shape row_shape = {b, h, m};
     output_tensors.emplace_back(common_tensor_params.shape({b, m, size_per_head * h}));
+    output_tensors_ = output_tensors;
 
-    fprop_query_tensor_ = core23::Tensor(common_tensor_params);
-    fprop_softmax_tensor_ = core23::Tensor(common_tensor_params.shape(score_shape));
+    // The fused kernels don't materialize the scores, and work on the layout of the inputs.
+    use_fused_ = size_per_head <= kFusedAttentionMaxHeadSize;
+    const int64_t type_size = sizeof(T);
+    const int64_t score_bytes = score_shape.size() * type_size;
+    const int64_t from_bytes = from_shape.size() * type_size;
+    const int64_t to_bytes = to_shape.size() * type_size;
+    const int64_t row_bytes = row_shape.size() * sizeof(float);
+    auto intermediate_params = common_tensor_params;
+    if (recompute_activations_) {
+      intermediate_params = GetRecomputeWorkspaceTensorParams(
+          common_tensor_params,
+          use_fused_ ? std::vector<int64_t>{from_bytes, to_bytes, to_bytes, row_bytes}
+                     : std::vector<int64_t>{score_bytes, score_bytes, score_bytes, from_bytes,
+                                            from_bytes, from_bytes, to_bytes, to_bytes});
+    }
+    query_buf_tensor_ = core23::Tensor(intermediate_params.shape(from_shape));
+    key_buf_tensor_ = core23::Tensor(intermediate_params.shape(to_shape));
+    attention_value_4d_ = core23::Tensor(intermediate_params.shape(to_shape));
+    if (use_fused_) {
+      // The log sum exp of the scores from fprop, and the row sums of P * dP in bprop
+      softmax_lse_tensor_ = core23::Tensor(
+          common_tensor_params.data_type(core23::ScalarType::Float).shape(row_shape));
+      softmax_delta_tensor_ = core23::Tensor(
+          intermediate_params.data_type(core23::ScalarType::Float).shape(row_shape));
+      return;
+    }
 
-    query_buf_tensor_ = core23::Tensor(common_tensor_params.shape(from_shape));
-    key_buf_tensor_ = core23::Tensor(common_tensor_params.shape(to_shape));
-    attention_value_4d_ = core23::Tensor(common_tensor_params.shape(to_shape));
+    attention_score_4d_ = core23::Tensor(intermediate_params.shape(score_shape));
+    attention_softmax_4d_ = core23::Tensor(intermediate_params.shape(score_shape));
+    attention_out_4d_ = core23::Tensor(intermediate_params.shape(from_shape));
+
+    fprop_query_tensor_ = core23::Tensor(intermediate_params);
+    fprop_softmax_tensor_ = core23::Tensor(intermediate_params.shape(score_shape));
 
-    output_tensors_ = output_tensors;
     // with masked
     if (input_tensors.size() == 4) {
       std::vector<core23::Tensor> bottoms{attention_score_4d_, input_tensors[3]};
@@ -256,8 +586,7 @@ MultiHeadAttentionLayer<T>::MultiHeadAttentionLayer(
 }
 
 template <typename T>
-void MultiHeadAttentionLayer<T>::fprop(bool is_train) {
-  CudaDeviceContext context(get_device_id());
+void MultiHeadAttentionLayer<T>::fprop_scores_() {
   T* query = input_tensors_[0].data<T>();
   T* key = input_tensors_[1].data<T>();
   T* value = input_tensors_[2].data<T>();
@@ -267,12 +596,8 @@ void MultiHeadAttentionLayer<T>::fprop(bool is_train) {
 
   T* score = attention_score_4d_.data<T>();
   T* value_4d = attention_value_4d_.data<T>();
-  // attention_out = transpose(attention_out_tmp)
-  T* attention_out = output_tensors_[0].data<T>();
-  T* attention_out_tmp = attention_out_4d_.data<T>();
 
   const auto& in_tensor_shape = input_tensors_[0].shape();
-  const auto& out_tensor_shape = output_tensors_[0].shape();
 
   size_t head_num = 0, batch_size = 0, from_seq_len = 0, to_seq_len = 0, size_per_head = 0;
   /* 1. transpose
@@ -348,7 +673,53 @@ void MultiHeadAttentionLayer<T>::fprop(bool is_train) {
   } else {
     softmax_layer_->fprop(true);
   }
-  score = attention_softmax_4d_.data<T>();
+}
+
+template <typename T>
+std::vector<core23::Tensor> MultiHeadAttentionLayer<T>::get_core23_workspace_tensors() const {
+  if (!recompute_activations_) {
+    return {};
+  }
+  if (use_fused_) {
+    return {query_buf_tensor_, key_buf_tensor_, attention_value_4d_, softmax_delta_tensor_};
+  }
+  return {attention_score_4d_,   attention_softmax_4d_, attention_out_4d_, fprop_query_tensor_,
+          fprop_softmax_tensor_, query_buf_tensor_,     key_buf_tensor_,   attention_value_4d_};
+}
+
+template <typename T>
+void MultiHeadAttentionLayer<T>::fprop(bool is_train) {
+  CudaDeviceContext context(get_device_id());
+  if (use_fused_) {
+    fused_fprop_();
+    return;
+  }
+  fprop_scores_();
+
+  T* value_4d = attention_value_4d_.data<T>();
+  // attention_out = transpose(attention_out_tmp)
+  T* attention_out = output_tensors_[0].data<T>();
+  T* attention_out_tmp = attention_out_4d_.data<T>();
+
+  const auto& in_tensor_shape = input_tensors_[0].shape();
+  const size_t head_num = num_head_;
+  const size_t batch_size = in_tensor_shape[0];
+  const size_t from_seq_len = in_tensor_shape[dims_ - 2];
+  const size_t to_seq_len = input_tensors_[1].size(dims_ - 2);
+  const size_t size_per_head = in_tensor_shape[dims_ - 1] / head_num;
+
+  const int batch_count = head_num * batch_size;
+  cudaDataType_t a_type = use_mixed_precision_ ? CUDA_R_16F : CUDA_R_32F;
+  cudaDataType_t b_type = use_mixed_precision_ ? CUDA_R_16F : CUDA_R_32F;
+  cudaDataType_t c_type = use_mixed_precision_ ? CUDA_R_16F : CUDA_R_32F;
+
+  cublasComputeType_t compute_type =
+      enable_tf32_compute_ ? CUBLAS_COMPUTE_32F_FAST_TF32 : CUBLAS_COMPUTE_32F;
+
+  cublasGemmAlgo_t algo =
+      use_mixed_precision_ ? CUBLAS_GEMM_DEFAULT_TENSOR_OP : CUBLAS_GEMM_DEFAULT;
+
+  T* score = attention_softmax_4d_.data<T>();
   /* 4. bgemm
      input : attention_softmax_4d_(score), attention_value_4d_
      output: attention_out_tmp -> attention_out
@@ -375,7 +746,15 @@ void MultiHeadAttentionLayer<T>::fprop(bool is_train) {
           attention_out, attention_out_tmp, batch_size, head_num, from_seq_len, size_per_head);
     }
   }
-  HCTR_LIB_THROW(cudaMemcpyAsync(fprop_query_tensor_.data(), (void*)query_buf,
+  // The copies of the query and softmax that bprop uses, which it then makes itself.
+  if (!recompute_activations_) {
+    copy_fprop_activations_();
+  }
+}
+
+template <typename T>
+void MultiHeadAttentionLayer<T>::copy_fprop_activations_() {
+  HCTR_LIB_THROW(cudaMemcpyAsync(fprop_query_tensor_.data(), query_buf_tensor_.data(),
                                  input_tensors_[0].num_bytes(), cudaMemcpyDeviceToDevice,
                                  get_gpu().get_stream()));
   HCTR_LIB_THROW(cudaMemcpyAsync(fprop_softmax_tensor_.data(), attention_softmax_4d_.data(),
@@ -386,6 +765,15 @@ void MultiHeadAttentionLayer<T>::fprop(bool is_train) {
 template <typename T>
 void MultiHeadAttentionLayer<T>::bprop() {
   CudaDeviceContext context(get_device_id());
+  if (use_fused_) {
+    fused_bprop_();
+    return;
+  }
+  // The inputs are only overwritten by their gradients at the end of bprop.
+  if (recompute_activations_) {
+    fprop_scores_();
+    copy_fprop_activations_();
+  }
   T* query = input_tensors_[0].data<T>();
   T* key = input_tensors_[1].data<T>();
   T* value = input_tensors_[2].data<T>();
@@ -525,6 +913,76 @@ void MultiHeadAttentionLayer<T>::bprop() {
   }
 }
 
+template <typename T>
+void MultiHeadAttentionLayer<T>::fused_fprop_() {
+  const auto& in_tensor_shape = input_tensors_[0].shape();
+  const int head_num = num_head_;
+  const int batch_size = in_tensor_shape[0];
+  const int from_seq_len = in_tensor_shape[dims_ - 2];
+  const int to_seq_len = input_tensors_[1].size(dims_ - 2);
+  const int size_per_head = in_tensor_shape[dims_ - 1] / head_num;
+  const float scale = 1.0f / sqrtf(size_per_head);
+  const T* mask = input_tensors_.size() == 4 ? input_tensors_[3].data<T>() : nullptr;
+
+  const dim3 grid_dim((from_seq_len - 1) / kFusedAttentionWarps + 1, batch_size * head_num);
+  const dim3 block_dim(32 * kFusedAttentionWarps);
+  const size_t smem_bytes =
+      (2 * kFusedAttentionTile * (size_per_head + 1) + kFusedAttentionWarps * size_per_head) *
+      sizeof(float);
+  fused_attention_fprop_kernel<<<grid_dim, block_dim, smem_bytes, get_gpu().get_stream()>>>(
+      output_tensors_[0].data<T>(), softmax_lse_tensor_.data<float>(),
+      input_tensors_[0].data<T>(), input_tensors_[1].data<T>(), input_tensors_[2].data<T>(), mask,
+      head_num, from_seq_len, to_seq_len, size_per_head, scale);
+}
+
+template <typename T>
+void MultiHeadAttentionLayer<T>::fused_bprop_() {
+  T* query = input_tensors_[0].data<T>();
+  T* key = input_tensors_[1].data<T>();
+  T* value = input_tensors_[2].data<T>();
+  const T* mask = input_tensors_.size() == 4 ? input_tensors_[3].data<T>() : nullptr;
+  const T* d_out = output_tensors_[0].data<T>();
+  T* d_query = query_buf_tensor_.data<T>();
+  T* d_key = key_buf_tensor_.data<T>();
+  T* d_value = attention_value_4d_.data<T>();
+  const float* lse = softmax_lse_tensor_.data<float>();
+  float* delta = softmax_delta_tensor_.data<float>();
+
+  const auto& in_tensor_shape = input_tensors_[0].shape();
+  const int head_num = num_head_;
+  const int batch_size = in_tensor_shape[0];
+  const int from_seq_len = in_tensor_shape[dims_ - 2];
+  const int to_seq_len = input_tensors_[1].size(dims_ - 2);
+  const int size_per_head = in_tensor_shape[dims_ - 1] / head_num;
+  const float scale = 1.0f / sqrtf(size_per_head);
+
+  const dim3 block_dim(32 * kFusedAttentionWarps);
+  const size_t tiles_bytes = 2 * kFusedAttentionTile * (size_per_head + 1) * sizeof(float);
+  const size_t rows_bytes = 2 * kFusedAttentionWarps * size_per_head * sizeof(float);
+  {
+    const dim3 grid_dim((from_seq_len - 1) / kFusedAttentionWarps + 1, batch_size * head_num);
+    fused_attention_bprop_dq_kernel<<<grid_dim, block_dim, tiles_bytes + rows_bytes,
+                                      get_gpu().get_stream()>>>(
+        d_query, delta, d_out, lse, query, key, value, mask, head_num, from_seq_len, to_seq_len,
+        size_per_head, scale);
+  }
+  {
+    const dim3 grid_dim((to_seq_len - 1) / kFusedAttentionWarps + 1, batch_size * head_num);
+    const size_t smem_bytes = tiles_bytes + rows_bytes + 2 * kFusedAttentionTile * sizeof(float);
+    fused_attention_bprop_dkv_kernel<<<grid_dim, block_dim, smem_bytes,
+                                       get_gpu().get_stream()>>>(
+        d_key, d_value, d_out, lse, delta, query, key, value, mask, head_num, from_seq_len,
+        to_seq_len, size_per_head, scale);
+  }
+  // The gradients replace the inputs once both kernels have read them.
+  HCTR_LIB_THROW(cudaMemcpyAsync(query, d_query, input_tensors_[0].num_bytes(),
+                                 cudaMemcpyDeviceToDevice, get_gpu().get_stream()));
+  HCTR_LIB_THROW(cudaMemcpyAsync(key, d_key, input_tensors_[1].num_bytes(),
+                                 cudaMemcpyDeviceToDevice, get_gpu().get_stream()));
+  HCTR_LIB_THROW(cudaMemcpyAsync(value, d_value, input_tensors_[2].num_bytes(),
+                                 cudaMemcpyDeviceToDevice, get_gpu().get_stream()));
+}
+
 template class MultiHeadAttentionLayer<float>;
 template class MultiHeadAttentionLayer<__half>;
 
@@ -194,6 +194,17 @@ void Loss<T>::regularizer_initialize_wgrad(bool is_train) {
   }
 }
 
+template <typename T>
+std::pair<Regularizer_t, float> Loss<T>::fuse_regularizer_wgrad(bool fused) {
+  if (regularizer_ == nullptr) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "Null regularizer is not allowed in calling Loss::fuse_regularizer_wgrad().");
+  }
+  regularizer_->fuse_wgrad_into_optimizer(fused);
+  // The wgrad term is summed over all GPUs with the rest of the wgrad before the update.
+  return {regularizer_->get_type(), regularizer_->get_wgrad_coefficient() * total_gpu_count_};
+}
+
 template <typename T>
 CrossEntropyLoss<T>::CrossEntropyLoss(const Tensor2<float> &label_tensor,
                                       const Tensor2<T> &input_tensor,
@@ -242,8 +253,12 @@ CrossEntropyLoss<T>::CrossEntropyLoss(const core23::Tensor &label_tensor,
 // Suppose we use one thread to calculate one sample
 template <typename T>
 __global__ void CrossEntropy_Kernel(T *input, const float *label, float *cel_loss, int batch_size,
-                                    int total_gpu_count, int feature_dim, float scaler, float rterm,
-                                    float label_weight, bool is_train) {
+                                    int total_gpu_count, int feature_dim, float scaler,
+                                    const float *loss_scale, float rterm, float label_weight,
+                                    bool is_train) {
+  if (loss_scale) {
+    scaler = *loss_scale;
+  }
   int tid = threadIdx.x;
   extern __shared__ float loss_s[];
 
@@ -292,8 +307,8 @@ void CrossEntropyLoss<T>::do_compute(T *input, const float *label, float *loss,
   size_t smem_size = block_size * sizeof(float);
   if (block_size > 0) {
     CrossEntropy_Kernel<<<1, block_size, smem_size, stream>>>(
-        input, label, loss, batch_size, Loss<T>::get_total_gpu_count(), feature_dim, scaler, rterm,
-        label_weight, is_train);
+        input, label, loss, batch_size, Loss<T>::get_total_gpu_count(), feature_dim, scaler,
+        Loss<T>::get_loss_scale(), rterm, label_weight, is_train);
   }
 }
 
@@ -331,9 +346,13 @@ BinaryCrossEntropyLoss<T>::BinaryCrossEntropyLoss(
 // Suppose we use one thread to calculate one sample
 template <typename T>
 __global__ void BinaryCrossEntropy_Kernel(T *input, const float *label, float *bce_loss,
-                                          float scaler, int batch_size, int total_gpu_count,
-                                          float rterm, float label_weight, bool is_train,
+                                          float scaler, const float *loss_scale,
+                                          int batch_size, int total_gpu_count, float rterm,
+                                          float label_weight, bool is_train,
                                           bool gen_loss_summary) {
+  if (loss_scale) {
+    scaler = *loss_scale;
+  }
   int tid = blockIdx.x * blockDim.x + threadIdx.x;
   float val = 0.0f;
   if (tid < batch_size) {
@@ -375,8 +394,8 @@ void BinaryCrossEntropyLoss<T>::do_compute(T *input, const float *label, float *
       HCTR_LIB_THROW(cudaMemsetAsync(loss, 0, sizeof(float), stream));
     }
     BinaryCrossEntropy_Kernel<<<grid_size, block_size, 0, stream>>>(
-        input, label, loss, scaler, batch_size, Loss<T>::get_total_gpu_count(), rterm, label_weight,
-        is_train, Loss<T>::gen_loss_summary_);
+        input, label, loss, scaler, Loss<T>::get_loss_scale(), batch_size,
+        Loss<T>::get_total_gpu_count(), rterm, label_weight, is_train, Loss<T>::gen_loss_summary_);
   }
 }
 
@@ -407,8 +426,11 @@ __forceinline__ __device__ __host__ float cross_entropy_loss_backward(float x, f
 template <typename T>
 __global__ void MultiCrossEntropy_Kernel(T *input, const float *label, const float *target_weight,
                                          float *bce_loss, int batchsize, int total_gpu_count,
-                                         int labels_per_sample, float scaler, float rterm,
-                                         bool is_train) {
+                                         int labels_per_sample, float scaler,
+                                         const float *loss_scale, float rterm, bool is_train) {
+  if (loss_scale) {
+    scaler = *loss_scale;
+  }
   int tid = threadIdx.x + blockDim.x * blockIdx.x;
   int num_threads = blockDim.x * gridDim.x;
   float loss_s = 0.f;
@@ -462,7 +484,7 @@ void MultiCrossEntropyLoss<T>::do_compute(T *input, const float *label, float *l
   }
   MultiCrossEntropy_Kernel<<<GRID_SIZE, BLOCK_SIZE, 0, stream>>>(
       input, label, target_weight, loss, batch_size, Loss<T>::get_total_gpu_count(),
-      labels_per_sample, scaler, rterm, is_train);
+      labels_per_sample, scaler, Loss<T>::get_loss_scale(), rterm, is_train);
 }
 
 template <typename T>
@@ -533,6 +555,281 @@ MultiCrossEntropyLoss<T>::MultiCrossEntropyLoss(
                             cudaMemcpyHostToDevice));
 }
 
+constexpr int in_batch_tile = 32;
+constexpr int in_batch_rows_per_thread = 4;
+// The gradients of a tile of embeddings are accumulated in shared memory.
+constexpr int in_batch_softmax_max_dim = 256;
+
+template <typename T>
+InBatchSoftmaxLoss<T>::InBatchSoftmaxLoss(const core23::Tensor &label_tensor,
+                                          const core23::Tensor &input_tensor,
+                                          const core23::Tensor &loss_tensor,
+                                          const std::shared_ptr<Regularizer<T>> &regularizer,
+                                          const std::shared_ptr<GPUResource> &gpu_resource,
+                                          int total_gpu_count, float scaler, bool gen_loss_summary)
+    : Loss<T>(label_tensor, input_tensor, loss_tensor, regularizer, gpu_resource, total_gpu_count,
+              scaler, gen_loss_summary) {
+  if (label_tensor.dims() != 2 || input_tensor.dims() != 2 ||
+      label_tensor.size(0) != input_tensor.size(0)) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Format of input tensor and label tensor don't match");
+  }
+  const int64_t feature_dim = input_tensor.size(1);
+  if (feature_dim % 2 != 0 || feature_dim / 2 > in_batch_softmax_max_dim) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "The input of InBatchSoftmaxLoss must be a query and an item embedding of the "
+                   "same size, which is at most " +
+                       std::to_string(in_batch_softmax_max_dim));
+  }
+  label_dim_ = label_tensor.size(1);
+
+  core23::BufferParams blobs_buffer_params = {};
+  blobs_buffer_params.channel = core23::GetRandomBufferChannel();
+  core23::Device device(core23::DeviceType::GPU, gpu_resource->get_device_id());
+  auto tensor_params = core23::TensorParams()
+                           .data_type(core23::ToScalarType<float>::value)
+                           .device(device)
+                           .buffer_params(blobs_buffer_params);
+  lse_ = core23::Tensor(tensor_params.shape({input_tensor.size(0)}));
+  grad_ = core23::Tensor(tensor_params.shape(input_tensor.shape()));
+}
+
+// The log of the sampling probability of item, or 0 without one.
+__forceinline__ __device__ float in_batch_logq(const float *label, int label_dim, int item) {
+  if (label_dim < 2) {
+    return 0.f;
+  }
+  const float probability = label[static_cast<size_t>(item) * label_dim + 1];
+  return probability > 0.f ? logf(probability) : 0.f;
+}
+
+// Computes the dot products of the queries [query_begin, query_begin + in_batch_tile) and the
+// items [item_begin, item_begin + in_batch_tile). Thread (x, y) gets the products of item x and
+// the queries y + r * blockDim.y, which are 0 beyond the batch.
+template <typename T>
+__forceinline__ __device__ void in_batch_logit_tile(
+    const T *input, int batch_size, int dim, int query_begin, int item_begin,
+    float (*queries)[in_batch_tile + 1], float (*items)[in_batch_tile + 1],
+    float (&logits)[in_batch_rows_per_thread]) {
+  const size_t stride = 2 * dim;
+  for (int r = 0; r < in_batch_rows_per_thread; r++) {
+    logits[r] = 0.f;
+  }
+  for (int k_begin = 0; k_begin < dim; k_begin += in_batch_tile) {
+    const int k = k_begin + threadIdx.x;
+    for (int r = 0; r < in_batch_rows_per_thread; r++) {
+      const int row = threadIdx.y + r * blockDim.y;
+      const int query = query_begin + row;
+      const int item = item_begin + row;
+      queries[row][threadIdx.x] =
+          query < batch_size && k < dim ? static_cast<float>(input[query * stride + k]) : 0.f;
+      items[row][threadIdx.x] =
+          item < batch_size && k < dim ? static_cast<float>(input[item * stride + dim + k]) : 0.f;
+    }
+    __syncthreads();
+    for (int kk = 0; kk < in_batch_tile; kk++) {
+      const float item_k = items[threadIdx.x][kk];
+      for (int r = 0; r < in_batch_rows_per_thread; r++) {
+        logits[r] += queries[threadIdx.y + r * blockDim.y][kk] * item_k;
+      }
+    }
+    __syncthreads();
+  }
+}
+
+// Merges the softmax denominator sum_exp relative to max_logit with another one.
+__forceinline__ __device__ void in_batch_merge_softmax(float &max_logit, float &sum_exp,
+                                                       float other_max_logit,
+                                                       float other_sum_exp) {
+  const float new_max_logit = fmaxf(max_logit, other_max_logit);
+  if (new_max_logit == -INFINITY) {
+    return;
+  }
+  sum_exp = sum_exp * expf(max_logit - new_max_logit) +
+            other_sum_exp * expf(other_max_logit - new_max_logit);
+  max_logit = new_max_logit;
+}
+
+// Each block computes the log of the softmax denominator of a tile of queries, with one online
+// softmax over the tiles of items.
+template <typename T>
+__global__ void InBatchSoftmax_Forward_Kernel(const T *input, const float *label, int label_dim,
+                                              int batch_size, int dim, float *lse, float *loss,
+                                              float rterm, float label_weight,
+                                              bool gen_loss_summary) {
+  __shared__ float queries[in_batch_tile][in_batch_tile + 1];
+  __shared__ float items[in_batch_tile][in_batch_tile + 1];
+  const int query_begin = blockIdx.x * in_batch_tile;
+
+  float max_logit[in_batch_rows_per_thread];
+  float sum_exp[in_batch_rows_per_thread];
+  float pos_logit[in_batch_rows_per_thread];
+  for (int r = 0; r < in_batch_rows_per_thread; r++) {
+    max_logit[r] = -INFINITY;
+    sum_exp[r] = 0.f;
+    pos_logit[r] = 0.f;
+  }
+  for (int item_begin = 0; item_begin < batch_size; item_begin += in_batch_tile) {
+    float logits[in_batch_rows_per_thread];
+    in_batch_logit_tile(input, batch_size, dim, query_begin, item_begin, queries, items, logits);
+    const int item = item_begin + threadIdx.x;
+    if (item < batch_size) {
+      const float logq = in_batch_logq(label, label_dim, item);
+      for (int r = 0; r < in_batch_rows_per_thread; r++) {
+        const float logit = logits[r] - logq;
+        in_batch_merge_softmax(max_logit[r], sum_exp[r], logit, 1.f);
+        if (item == query_begin + threadIdx.y + r * blockDim.y) {
+          pos_logit[r] = logit;
+        }
+      }
+    }
+  }
+
+  // The threads of a warp hold the same queries
+  float warp_loss = 0.f;
+  for (int r = 0; r < in_batch_rows_per_thread; r++) {
+    for (int offset = warpSize / 2; offset > 0; offset /= 2) {
+      const float other_max_logit = __shfl_xor_sync(0xffffffff, max_logit[r], offset);
+      const float other_sum_exp = __shfl_xor_sync(0xffffffff, sum_exp[r], offset);
+      in_batch_merge_softmax(max_logit[r], sum_exp[r], other_max_logit, other_sum_exp);
+    }
+    pos_logit[r] = warpReduceSum(pos_logit[r]);
+    const int query = query_begin + threadIdx.y + r * blockDim.y;
+    if (threadIdx.x == 0 && query < batch_size) {
+      lse[query] = max_logit[r] + logf(sum_exp[r]);
+      if (label[static_cast<size_t>(query) * label_dim] > 0.5f) {
+        warp_loss += lse[query] - pos_logit[r];
+      }
+    }
+  }
+  if (gen_loss_summary && threadIdx.x == 0) {
+    const bool first = blockIdx.x == 0 && threadIdx.y == 0;
+    atomicAdd(loss, (warp_loss / batch_size + (first ? rterm : 0.f)) * label_weight);
+  }
+}
+
+// Each block computes the gradients of a tile of query embeddings, or of item embeddings if
+// item_grads, by going over the tiles of the other side. The gradient of logit (i, j) is
+// softmax_i(j) - (i == j), which the block recomputes from the log of the denominator.
+template <typename T, bool item_grads>
+__global__ void InBatchSoftmax_Backward_Kernel(const T *input, const float *label, int label_dim,
+                                               int batch_size, int dim, const float *lse,
+                                               int total_gpu_count, float scaler,
+                                               const float *loss_scale, float *grad) {
+  if (loss_scale) {
+    scaler = *loss_scale;
+  }
+  const float scale = scaler / batch_size / total_gpu_count;
+  __shared__ float queries[in_batch_tile][in_batch_tile + 1];
+  __shared__ float items[in_batch_tile][in_batch_tile + 1];
+  __shared__ float probs[in_batch_tile][in_batch_tile + 1];
+  extern __shared__ float acc[];
+  const size_t stride = 2 * dim;
+  const int own_begin = blockIdx.x * in_batch_tile;
+  const int own_offset = item_grads ? dim : 0;
+  const int other_offset = item_grads ? 0 : dim;
+
+  for (int i = threadIdx.y * blockDim.x + threadIdx.x; i < in_batch_tile * dim;
+       i += blockDim.x * blockDim.y) {
+    acc[i] = 0.f;
+  }
+  __syncthreads();
+
+  for (int other_begin = 0; other_begin < batch_size; other_begin += in_batch_tile) {
+    const int query_begin = item_grads ? other_begin : own_begin;
+    const int item_begin = item_grads ? own_begin : other_begin;
+    float logits[in_batch_rows_per_thread];
+    in_batch_logit_tile(input, batch_size, dim, query_begin, item_begin, queries, items, logits);
+    const int item = item_begin + threadIdx.x;
+    for (int r = 0; r < in_batch_rows_per_thread; r++) {
+      const int row = threadIdx.y + r * blockDim.y;
+      const int query = query_begin + row;
+      float g = 0.f;
+      if (query < batch_size && item < batch_size &&
+          label[static_cast<size_t>(query) * label_dim] > 0.5f) {
+        g = expf(logits[r] - in_batch_logq(label, label_dim, item) - lse[query]) -
+            (query == item ? 1.f : 0.f);
+      }
+      probs[row][threadIdx.x] = g * scale;
+    }
+
+    // in_batch_logit_tile is done with items, which now holds the other embeddings
+    for (int k_begin = 0; k_begin < dim; k_begin += in_batch_tile) {
+      const int k = k_begin + threadIdx.x;
+      for (int r = 0; r < in_batch_rows_per_thread; r++) {
+        const int row = threadIdx.y + r * blockDim.y;
+        const int other = other_begin + row;
+        items[row][threadIdx.x] = other < batch_size && k < dim
+                                      ? static_cast<float>(input[other * stride + other_offset + k])
+                                      : 0.f;
+      }
+      __syncthreads();
+      if (k < dim) {
+        for (int r = 0; r < in_batch_rows_per_thread; r++) {
+          const int row = threadIdx.y + r * blockDim.y;
+          float sum = 0.f;
+          for (int x = 0; x < in_batch_tile; x++) {
+            sum += (item_grads ? probs[x][row] : probs[row][x]) * items[x][threadIdx.x];
+          }
+          acc[row * dim + k] += sum;
+        }
+      }
+      __syncthreads();
+    }
+  }
+
+  for (int r = 0; r < in_batch_rows_per_thread; r++) {
+    const int row = threadIdx.y + r * blockDim.y;
+    const int own = own_begin + row;
+    if (own < batch_size) {
+      for (int k = threadIdx.x; k < dim; k += blockDim.x) {
+        grad[own * stride + own_offset + k] = acc[row * dim + k];
+      }
+    }
+  }
+}
+
+template <typename T>
+__global__ void InBatchSoftmax_Grad_Copy_Kernel(const float *grad, T *input, size_t size) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < size; i += blockDim.x * gridDim.x) {
+    input[i] = static_cast<T>(grad[i]);
+  }
+}
+
+template <typename T>
+void InBatchSoftmaxLoss<T>::do_compute(T *input, const float *label, float *loss, int batch_size,
+                                       int feature_dim, float scaler, float rterm,
+                                       float label_weight, bool is_train, cudaStream_t stream) {
+  if (batch_size <= 0) {
+    return;
+  }
+  const int dim = feature_dim / 2;
+  const int num_tiles = ceildiv(batch_size, in_batch_tile);
+  dim3 block(in_batch_tile, in_batch_tile / in_batch_rows_per_thread, 1);
+  float *lse = lse_.data<float>();
+  if (Loss<T>::gen_loss_summary_) {
+    HCTR_LIB_THROW(cudaMemsetAsync(loss, 0, sizeof(float), stream));
+  }
+  InBatchSoftmax_Forward_Kernel<<<num_tiles, block, 0, stream>>>(
+      input, label, label_dim_, batch_size, dim, lse, loss, rterm, label_weight,
+      Loss<T>::gen_loss_summary_);
+  if (!is_train) {
+    return;
+  }
+
+  // Both passes read the input, so the gradients are only copied into it at the end
+  float *grad = grad_.data<float>();
+  const size_t smem_size = in_batch_tile * dim * sizeof(float);
+  InBatchSoftmax_Backward_Kernel<T, false><<<num_tiles, block, smem_size, stream>>>(
+      input, label, label_dim_, batch_size, dim, lse, Loss<T>::get_total_gpu_count(), scaler,
+      Loss<T>::get_loss_scale(), grad);
+  InBatchSoftmax_Backward_Kernel<T, true><<<num_tiles, block, smem_size, stream>>>(
+      input, label, label_dim_, batch_size, dim, lse, Loss<T>::get_total_gpu_count(), scaler,
+      Loss<T>::get_loss_scale(), grad);
+  const size_t size = static_cast<size_t>(batch_size) * feature_dim;
+  InBatchSoftmax_Grad_Copy_Kernel<<<Loss<T>::get_gpu().get_sm_count() * 4, 512, 0, stream>>>(
+      grad, input, size);
+}
+
 template class Loss<__half>;
 template class Loss<float>;
 template class MultiCrossEntropyLoss<__half>;
@@ -541,5 +838,7 @@ template class CrossEntropyLoss<__half>;
 template class CrossEntropyLoss<float>;
 template class BinaryCrossEntropyLoss<__half>;
 template class BinaryCrossEntropyLoss<float>;
+template class InBatchSoftmaxLoss<__half>;
+template class InBatchSoftmaxLoss<float>;
 
 }  // namespace HugeCTR
@@ -23,7 +23,6 @@
 #include <metrics.hpp>
 #include <network_buffer_channels.hpp>
 #include <utils.cuh>
-#define MMAP_DEBUG(...)  // HCTR_LOG(INFO, ROOT, __VA_ARGS__)
 
 namespace HugeCTR {
 
@@ -459,7 +458,7 @@ void get_raw_metric_as_host_float_tensor(RawMetricMap metric_map, RawType raw_ty
 std::unique_ptr<Metric> Metric::Create(const Type type, bool use_mixed_precision,
                                        int batch_size_eval, int n_batches, int label_dim,
                                        const std::shared_ptr<ResourceManager>& resource_manager,
-                                       bool use_old_tensor) {
+                                       bool use_old_tensor, int top_k) {
   std::unique_ptr<Metric> ret;
   switch (type) {
     case Type::AUC:
@@ -487,6 +486,23 @@ std::unique_ptr<Metric> Metric::Create(const Type type, bool use_mixed_precision
     case Type::SMAPE:
       ret.reset(new SMAPE<float>(batch_size_eval, resource_manager));
       break;
+    case Type::ApproxAUC:
+      if (use_mixed_precision) {
+        ret.reset(new ApproxAUC<__half>(batch_size_eval, label_dim, resource_manager));
+      } else {
+        ret.reset(new ApproxAUC<float>(batch_size_eval, label_dim, resource_manager));
+      }
+      break;
+    case Type::RecallAtK:
+    case Type::NDCGAtK:
+      if (use_mixed_precision) {
+        ret.reset(new InBatchRanking<__half>(type, top_k, batch_size_eval, label_dim,
+                                             resource_manager));
+      } else {
+        ret.reset(
+            new InBatchRanking<float>(type, top_k, batch_size_eval, label_dim, resource_manager));
+      }
+      break;
   }
   return ret;
 }
@@ -537,6 +553,20 @@ void AverageLoss<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metri
                             cudaMemcpyDeviceToHost));
 }
 
+template <typename T>
+bool AverageLoss<T>::add_fused_terms(int local_gpu_id, FusedMetricTerms& terms) {
+  if (terms.loss) {
+    return false;
+  }
+  terms.loss = true;
+  return true;
+}
+
+template <typename T>
+void AverageLoss<T>::take_fused_sums(int local_gpu_id, const FusedMetricSums& sums) {
+  *loss_local_[local_gpu_id] = sums.loss;
+}
+
 template <typename T>
 void AverageLoss<T>::global_reduce(int n_nets) {
   float loss_inter = 0.0f;
@@ -1817,6 +1847,373 @@ void AUC<T>::run_finalize_step(float* d_preds, float* d_labels, int local_id,
   }
 }
 
+template <typename T>
+ApproxAUC<T>::ApproxAUC(int batch_size_per_gpu, int label_dim,
+                        const std::shared_ptr<ResourceManager>& resource_manager)
+    : Metric(),
+      resource_manager_(resource_manager),
+      batch_size_per_gpu_(batch_size_per_gpu),
+      num_classes_(label_dim),
+      num_local_gpus_(resource_manager_->get_local_gpu_count()),
+      histograms_(num_local_gpus_, nullptr),
+      h_histograms_(2 * num_classes_ * num_bins_),
+      per_class_aucs_(num_classes_, 0.0f) {
+  const size_t histogram_bytes = h_histograms_.size() * sizeof(CountType);
+  for (int i = 0; i < num_local_gpus_; i++) {
+    int device_id = resource_manager_->get_local_gpu(i)->get_device_id();
+    CudaDeviceContext context(device_id);
+    HCTR_LIB_THROW(cudaMalloc((void**)&histograms_[i], histogram_bytes));
+    HCTR_LIB_THROW(cudaMemset(histograms_[i], 0, histogram_bytes));
+  }
+}
+
+template <typename T>
+ApproxAUC<T>::~ApproxAUC() {
+  for (int i = 0; i < num_local_gpus_; i++) {
+    int device_id = resource_manager_->get_local_gpu(i)->get_device_id();
+    CudaDeviceContext context(device_id);
+    HCTR_LIB_CHECK_(cudaFree(histograms_[i]));
+  }
+}
+
+template <typename PredType>
+__global__ void approx_auc_histogram_kernel(const PredType* preds, const float* labels,
+                                            int num_elems, int num_classes, int num_bins,
+                                            float pred_min, float pred_max,
+                                            CountType* pos_histograms, CountType* neg_histograms) {
+  const float scale = num_bins / (pred_max - pred_min);
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < num_elems;
+       i += blockDim.x * gridDim.x) {
+    const int class_id = i % num_classes;
+    const float pred = static_cast<float>(preds[i]);
+    const int bin = min(max(static_cast<int>((pred - pred_min) * scale), 0), num_bins - 1);
+    CountType* histogram = labels[i] > 0.5f ? pos_histograms : neg_histograms;
+    atomicAdd(histogram + class_id * num_bins + bin, CountType(1));
+  }
+}
+
+template <typename T>
+void ApproxAUC<T>::update_histograms(int local_gpu_id, const PredType* preds,
+                                     const LabelType* labels) {
+  const auto& local_gpu = resource_manager_->get_local_gpu(local_gpu_id);
+  CudaDeviceContext context(local_gpu->get_device_id());
+  int num_valid_samples =
+      get_num_valid_samples(local_gpu->get_global_id(), current_batch_size_, batch_size_per_gpu_);
+  if (num_valid_samples == 0) {
+    return;
+  }
+
+  // The samples only increment the counts of their bins, so nothing is kept across batches.
+  CountType* pos_histograms = histograms_[local_gpu_id];
+  CountType* neg_histograms = pos_histograms + num_classes_ * num_bins_;
+  dim3 grid(local_gpu->get_sm_count() * 2, 1, 1);
+  dim3 block(1024, 1, 1);
+  approx_auc_histogram_kernel<<<grid, block, 0, local_gpu->get_stream()>>>(
+      preds, labels, num_valid_samples * num_classes_, num_classes_, num_bins_, pred_min_,
+      pred_max_, pos_histograms, neg_histograms);
+}
+
+template <typename T>
+void ApproxAUC<T>::local_reduce(int local_gpu_id, RawMetricMap raw_metrics) {
+  Tensor2<PredType> pred_tensor = Tensor2<PredType>::stretch_from(raw_metrics[RawType::Pred]);
+  Tensor2<LabelType> label_tensor = Tensor2<LabelType>::stretch_from(raw_metrics[RawType::Label]);
+  update_histograms(local_gpu_id, pred_tensor.get_ptr(), label_tensor.get_ptr());
+}
+
+template <typename T>
+void ApproxAUC<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) {
+  core23::Tensor pred_tensor = raw_metrics[RawType::Pred];
+  core23::Tensor label_tensor = raw_metrics[RawType::Label];
+  update_histograms(local_gpu_id, pred_tensor.data<PredType>(), label_tensor.data<LabelType>());
+}
+
+template <typename T>
+bool ApproxAUC<T>::add_fused_terms(int local_gpu_id, FusedMetricTerms& terms) {
+  if (terms.histograms) {
+    return false;
+  }
+  const auto& local_gpu = resource_manager_->get_local_gpu(local_gpu_id);
+  int num_valid_samples =
+      get_num_valid_samples(local_gpu->get_global_id(), current_batch_size_, batch_size_per_gpu_);
+  terms.histograms = true;
+  terms.num_histogram_elems = num_valid_samples * num_classes_;
+  terms.num_classes = num_classes_;
+  terms.num_bins = num_bins_;
+  terms.pred_min = pred_min_;
+  terms.pred_max = pred_max_;
+  terms.pos_histograms = histograms_[local_gpu_id];
+  terms.neg_histograms = histograms_[local_gpu_id] + num_classes_ * num_bins_;
+  return true;
+}
+
+template <typename T>
+void ApproxAUC<T>::global_reduce(int n_nets) {
+  // The histograms are reduced once in finalize_metric
+}
+
+template <typename T>
+float ApproxAUC<T>::finalize_metric() {
+  const size_t num_counts = h_histograms_.size();
+#pragma omp parallel num_threads(num_local_gpus_)
+  {
+    const int local_id = omp_get_thread_num();
+    auto gpu_resource = resource_manager_->get_local_gpu(local_id).get();
+    CudaDeviceContext context(gpu_resource->get_device_id());
+    auto& stream = gpu_resource->get_stream();
+
+    if (resource_manager_->get_global_gpu_count() > 1) {
+      metric_comm::allreduce(histograms_[local_id], histograms_[local_id], num_counts,
+                             gpu_resource, stream);
+    }
+    if (local_id == 0) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(h_histograms_.data(), histograms_[local_id],
+                                     num_counts * sizeof(CountType), cudaMemcpyDeviceToHost,
+                                     stream));
+    }
+    // Start the next evaluation from empty histograms
+    HCTR_LIB_THROW(
+        cudaMemsetAsync(histograms_[local_id], 0, num_counts * sizeof(CountType), stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+  }
+
+  float result = 0.0f;
+  for (size_t class_id = 0; class_id < num_classes_; class_id++) {
+    const CountType* pos = h_histograms_.data() + class_id * num_bins_;
+    const CountType* neg = h_histograms_.data() + (num_classes_ + class_id) * num_bins_;
+    // Each positive sample ranks above the negative samples of the lower bins, and ties with the
+    // ones of its own bin.
+    double num_pos = 0.0;
+    double num_neg = 0.0;
+    double num_ranked_pairs = 0.0;
+    for (int bin = 0; bin < num_bins_; bin++) {
+      num_ranked_pairs += pos[bin] * (num_neg + 0.5 * neg[bin]);
+      num_pos += pos[bin];
+      num_neg += neg[bin];
+    }
+    float class_auc = (num_pos > 0 && num_neg > 0) ? num_ranked_pairs / (num_pos * num_neg) : 0.0f;
+    per_class_aucs_[class_id] = class_auc;
+    result += class_auc;
+  }
+  return result / num_classes_;
+}
+
+template <typename T>
+InBatchRanking<T>::InBatchRanking(Type type, int top_k, int batch_size_per_gpu, int label_dim,
+                                  const std::shared_ptr<ResourceManager>& resource_manager)
+    : Metric(),
+      type_(type),
+      top_k_(top_k),
+      resource_manager_(resource_manager),
+      batch_size_per_gpu_(batch_size_per_gpu),
+      label_dim_(label_dim),
+      num_local_gpus_(resource_manager_->get_local_gpu_count()),
+      pos_scores_(num_local_gpus_, nullptr),
+      ranks_(num_local_gpus_, nullptr),
+      sums_(num_local_gpus_, nullptr) {
+  if (label_dim_ <= 0 || label_dim_ % 2 != 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "In-batch ranking metrics need the query and the item embedding of each "
+                   "sample, so the label dimension must be even.");
+  }
+  if (top_k_ <= 0) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "The K of in-batch ranking metrics must be positive.");
+  }
+  for (int i = 0; i < num_local_gpus_; i++) {
+    int device_id = resource_manager_->get_local_gpu(i)->get_device_id();
+    CudaDeviceContext context(device_id);
+    HCTR_LIB_THROW(cudaMalloc((void**)&pos_scores_[i], batch_size_per_gpu_ * sizeof(float)));
+    HCTR_LIB_THROW(cudaMalloc((void**)&ranks_[i], batch_size_per_gpu_ * sizeof(int)));
+    HCTR_LIB_THROW(cudaMalloc((void**)&sums_[i], 2 * sizeof(double)));
+    HCTR_LIB_THROW(cudaMemset(sums_[i], 0, 2 * sizeof(double)));
+  }
+}
+
+template <typename T>
+InBatchRanking<T>::~InBatchRanking() {
+  for (int i = 0; i < num_local_gpus_; i++) {
+    int device_id = resource_manager_->get_local_gpu(i)->get_device_id();
+    CudaDeviceContext context(device_id);
+    HCTR_LIB_CHECK_(cudaFree(pos_scores_[i]));
+    HCTR_LIB_CHECK_(cudaFree(ranks_[i]));
+    HCTR_LIB_CHECK_(cudaFree(sums_[i]));
+  }
+}
+
+template <typename T>
+std::string InBatchRanking<T>::name() const {
+  return (type_ == Type::RecallAtK ? "Recall@" : "NDCG@") + std::to_string(top_k_);
+}
+
+constexpr int in_batch_tile = 32;
+constexpr int in_batch_rows_per_thread = 4;
+
+// One warp computes the score of the relevant item of each query.
+template <typename PredType>
+__global__ void in_batch_pos_scores_kernel(const PredType* preds, int num_samples, int dim,
+                                           float* pos_scores) {
+  const int lane_id = threadIdx.x % warpSize;
+  const int num_warps = blockDim.x * gridDim.x / warpSize;
+  for (int i = (blockIdx.x * blockDim.x + threadIdx.x) / warpSize; i < num_samples;
+       i += num_warps) {
+    const PredType* query = preds + static_cast<size_t>(i) * 2 * dim;
+    const PredType* item = query + dim;
+    float score = 0.0f;
+    for (int k = lane_id; k < dim; k += warpSize) {
+      score += static_cast<float>(query[k]) * static_cast<float>(item[k]);
+    }
+    score = warpReduceSum(score);
+    if (lane_id == 0) {
+      pos_scores[i] = score;
+    }
+  }
+}
+
+// Each block scores a tile of queries against a tile of items, and counts the items that rank
+// above the relevant item of each query. Ties rank by sample index. The block is
+// in_batch_tile x (in_batch_tile / in_batch_rows_per_thread) threads, and the threads of a warp
+// share their queries.
+template <typename PredType>
+__global__ void in_batch_rank_kernel(const PredType* preds, int num_samples, int dim,
+                                     const float* pos_scores, int* ranks) {
+  __shared__ float queries[in_batch_tile][in_batch_tile + 1];
+  __shared__ float items[in_batch_tile][in_batch_tile + 1];
+  const int query_begin = blockIdx.y * in_batch_tile;
+  const int item_begin = blockIdx.x * in_batch_tile;
+  const size_t stride = 2 * dim;
+
+  float scores[in_batch_rows_per_thread] = {};
+  for (int k_begin = 0; k_begin < dim; k_begin += in_batch_tile) {
+    const int k = k_begin + threadIdx.x;
+    for (int r = 0; r < in_batch_rows_per_thread; r++) {
+      const int row = threadIdx.y + r * blockDim.y;
+      const int query = query_begin + row;
+      const int item = item_begin + row;
+      queries[row][threadIdx.x] =
+          query < num_samples && k < dim ? static_cast<float>(preds[query * stride + k]) : 0.0f;
+      items[row][threadIdx.x] =
+          item < num_samples && k < dim ? static_cast<float>(preds[item * stride + dim + k]) : 0.0f;
+    }
+    __syncthreads();
+    for (int kk = 0; kk < in_batch_tile; kk++) {
+      const float item_k = items[threadIdx.x][kk];
+      for (int r = 0; r < in_batch_rows_per_thread; r++) {
+        scores[r] += queries[threadIdx.y + r * blockDim.y][kk] * item_k;
+      }
+    }
+    __syncthreads();
+  }
+
+  const int item = item_begin + threadIdx.x;
+  for (int r = 0; r < in_batch_rows_per_thread; r++) {
+    const int query = query_begin + threadIdx.y + r * blockDim.y;
+    bool ahead = false;
+    if (query < num_samples && item < num_samples && item != query) {
+      const float pos_score = pos_scores[query];
+      ahead = scores[r] > pos_score || (scores[r] == pos_score && item < query);
+    }
+    const int count = __popc(__ballot_sync(0xffffffff, ahead));
+    if (threadIdx.x == 0 && count > 0) {
+      atomicAdd(ranks + query, count);
+    }
+  }
+}
+
+__global__ void in_batch_ranking_sum_kernel(const int* ranks, const float* labels,
+                                            int num_samples, int label_dim, int top_k, bool ndcg,
+                                            double* sums) {
+  float sum = 0.0f;
+  float num_queries = 0.0f;
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < num_samples;
+       i += blockDim.x * gridDim.x) {
+    if (labels[static_cast<size_t>(i) * label_dim] > 0.5f) {
+      num_queries += 1.0f;
+      const int rank = ranks[i];
+      if (rank < top_k) {
+        // The DCG of the only relevant item, whose ideal DCG is 1.
+        sum += ndcg ? 1.0f / log2f(rank + 2.0f) : 1.0f;
+      }
+    }
+  }
+  sum = blockReduceSum(sum);
+  __syncthreads();
+  num_queries = blockReduceSum(num_queries);
+  if (threadIdx.x == 0) {
+    atomicAdd(sums, static_cast<double>(sum));
+    atomicAdd(sums + 1, static_cast<double>(num_queries));
+  }
+}
+
+template <typename T>
+void InBatchRanking<T>::update_ranks(int local_gpu_id, const PredType* preds,
+                                     const LabelType* labels) {
+  const auto& local_gpu = resource_manager_->get_local_gpu(local_gpu_id);
+  CudaDeviceContext context(local_gpu->get_device_id());
+  int num_valid_samples =
+      get_num_valid_samples(local_gpu->get_global_id(), current_batch_size_, batch_size_per_gpu_);
+  if (num_valid_samples == 0) {
+    return;
+  }
+
+  auto stream = local_gpu->get_stream();
+  const int dim = label_dim_ / 2;
+  HCTR_LIB_THROW(
+      cudaMemsetAsync(ranks_[local_gpu_id], 0, num_valid_samples * sizeof(int), stream));
+  constexpr int block_size = 256;
+  in_batch_pos_scores_kernel<<<ceildiv(num_valid_samples * 32, block_size), block_size, 0,
+                               stream>>>(preds, num_valid_samples, dim, pos_scores_[local_gpu_id]);
+  const int num_tiles = ceildiv(num_valid_samples, in_batch_tile);
+  dim3 rank_grid(num_tiles, num_tiles, 1);
+  dim3 rank_block(in_batch_tile, in_batch_tile / in_batch_rows_per_thread, 1);
+  in_batch_rank_kernel<<<rank_grid, rank_block, 0, stream>>>(
+      preds, num_valid_samples, dim, pos_scores_[local_gpu_id], ranks_[local_gpu_id]);
+  in_batch_ranking_sum_kernel<<<local_gpu->get_sm_count(), 1024, 0, stream>>>(
+      ranks_[local_gpu_id], labels, num_valid_samples, label_dim_, top_k_,
+      type_ == Type::NDCGAtK, sums_[local_gpu_id]);
+}
+
+template <typename T>
+void InBatchRanking<T>::local_reduce(int local_gpu_id, RawMetricMap raw_metrics) {
+  Tensor2<PredType> pred_tensor = Tensor2<PredType>::stretch_from(raw_metrics[RawType::Pred]);
+  Tensor2<LabelType> label_tensor = Tensor2<LabelType>::stretch_from(raw_metrics[RawType::Label]);
+  update_ranks(local_gpu_id, pred_tensor.get_ptr(), label_tensor.get_ptr());
+}
+
+template <typename T>
+void InBatchRanking<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) {
+  core23::Tensor pred_tensor = raw_metrics[RawType::Pred];
+  core23::Tensor label_tensor = raw_metrics[RawType::Label];
+  update_ranks(local_gpu_id, pred_tensor.data<PredType>(), label_tensor.data<LabelType>());
+}
+
+template <typename T>
+void InBatchRanking<T>::global_reduce(int n_nets) {
+  // The sums stay on the GPUs until finalize_metric
+}
+
+template <typename T>
+float InBatchRanking<T>::finalize_metric() {
+  double sums[2] = {0.0, 0.0};
+  for (int i = 0; i < num_local_gpus_; i++) {
+    const auto& local_gpu = resource_manager_->get_local_gpu(i);
+    CudaDeviceContext context(local_gpu->get_device_id());
+    auto stream = local_gpu->get_stream();
+    double local_sums[2];
+    HCTR_LIB_THROW(cudaMemcpyAsync(local_sums, sums_[i], sizeof(local_sums),
+                                   cudaMemcpyDeviceToHost, stream));
+    // Start the next evaluation from 0
+    HCTR_LIB_THROW(cudaMemsetAsync(sums_[i], 0, sizeof(local_sums), stream));
+    HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+    sums[0] += local_sums[0];
+    sums[1] += local_sums[1];
+  }
+#ifdef ENABLE_MPI
+  if (resource_manager_->get_num_process() > 1) {
+    HCTR_MPI_THROW(MPI_Allreduce(MPI_IN_PLACE, sums, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD));
+  }
+#endif
+  return sums[1] > 0.0 ? sums[0] / sums[1] : 0.0f;
+}
+
 template <typename CUB_Func>
 void CUB_allocate_and_launch(NDCGStorageOld& st, CUB_Func func) {
   size_t requested_size = 0;
@@ -2701,6 +3098,24 @@ void HitRate<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics)
   hits_local_[local_gpu_id] = hits_host;
 }
 
+template <typename T>
+bool HitRate<T>::add_fused_terms(int local_gpu_id, FusedMetricTerms& terms) {
+  if (terms.hit_rate) {
+    return false;
+  }
+  int global_device_id = resource_manager_->get_local_gpu(local_gpu_id)->get_global_id();
+  terms.hit_rate = true;
+  terms.num_hit_rate_samples =
+      get_num_valid_samples(global_device_id, current_batch_size_, batch_size_per_gpu_);
+  return true;
+}
+
+template <typename T>
+void HitRate<T>::take_fused_sums(int local_gpu_id, const FusedMetricSums& sums) {
+  checked_local_[local_gpu_id] = sums.hit_rate_checked;
+  hits_local_[local_gpu_id] = sums.hit_rate_hits;
+}
+
 template <typename T>
 void HitRate<T>::global_reduce(int n_nets) {
   int checked_inter = 0;
@@ -2847,6 +3262,25 @@ void SMAPE<T>::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) {
                                  cudaMemcpyDeviceToHost, local_gpu->get_stream()));
 }
 
+template <typename T>
+bool SMAPE<T>::add_fused_terms(int local_gpu_id, FusedMetricTerms& terms) {
+  if (terms.smape) {
+    return false;
+  }
+  int global_device_id = resource_manager_->get_local_gpu(local_gpu_id)->get_global_id();
+  int num_valid_samples =
+      get_num_valid_samples(global_device_id, current_batch_size_, batch_size_per_gpu_);
+  terms.smape = true;
+  terms.num_smape_samples = num_valid_samples;
+  checked_local_[local_gpu_id] = num_valid_samples;
+  return true;
+}
+
+template <typename T>
+void SMAPE<T>::take_fused_sums(int local_gpu_id, const FusedMetricSums& sums) {
+  error_local_[local_gpu_id] = sums.smape_error;
+}
+
 template <typename T>
 void SMAPE<T>::global_reduce(int n_nets) {
   int checked_inter = 0;
@@ -2902,19 +3336,121 @@ float SMAPE<T>::finalize_metric() {
   return ret;
 }
 
-template <typename T, ReallocType_t U>
-ReallocBuffer<T, U>::ReallocBuffer() : num_elements_(0), ptr_(nullptr) {
-  CUdevice device;
-  HCTR_LIB_THROW(cudaGetDevice(&device));
+FusedLocalReduce::FusedLocalReduce(const std::vector<Metric*>& metrics,
+                                   const std::shared_ptr<ResourceManager>& resource_manager)
+    : metrics_(metrics),
+      resource_manager_(resource_manager),
+      d_sums_(resource_manager->get_local_gpu_count(), nullptr),
+      h_sums_(resource_manager->get_local_gpu_count(), nullptr) {
+  for (size_t i = 0; i < d_sums_.size(); i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    HCTR_LIB_THROW(cudaMalloc((void**)&d_sums_[i], sizeof(FusedMetricSums)));
+    HCTR_LIB_THROW(cudaMallocHost((void**)&h_sums_[i], sizeof(FusedMetricSums)));
+  }
+}
 
-  prop_.type = CU_MEM_ALLOCATION_TYPE_PINNED;
-  prop_.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
-  prop_.location.id = device;
-  HCTR_LIB_THROW(
-      cuMemGetAllocationGranularity(&chunk_size_, &prop_, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
-  access_desc_ = nullptr;
+FusedLocalReduce::~FusedLocalReduce() {
+  for (size_t i = 0; i < d_sums_.size(); i++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(i)->get_device_id());
+    HCTR_LIB_CHECK_(cudaFree(d_sums_[i]));
+    HCTR_LIB_CHECK_(cudaFreeHost(h_sums_[i]));
+  }
+}
+
+template <typename PredType>
+__global__ void fused_local_reduce_kernel(const PredType* preds, const float* labels,
+                                          const float* loss, const FusedMetricTerms terms,
+                                          FusedMetricSums* sums) {
+  if (terms.loss && blockIdx.x == 0 && threadIdx.x == 0) {
+    sums->loss = *loss;
+  }
+
+  const int num_elems = max(terms.num_histogram_elems,
+                            max(terms.num_hit_rate_samples, terms.num_smape_samples));
+  const float scale = terms.num_bins / (terms.pred_max - terms.pred_min);
+  int checked = 0;
+  int hits = 0;
+  float error = 0.0f;
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < num_elems;
+       i += blockDim.x * gridDim.x) {
+    const float pred = static_cast<float>(preds[i]);
+    const float label = labels[i];
+    if (i < terms.num_histogram_elems) {
+      const int class_id = i % terms.num_classes;
+      const int bin =
+          min(max(static_cast<int>((pred - terms.pred_min) * scale), 0), terms.num_bins - 1);
+      CountType* histogram = label > 0.5f ? terms.pos_histograms : terms.neg_histograms;
+      atomicAdd(histogram + class_id * terms.num_bins + bin, CountType(1));
+    }
+    if (i < terms.num_hit_rate_samples && pred > 0.8f) {
+      checked++;
+      hits += label == 1.0f;
+    }
+    if (i < terms.num_smape_samples) {
+      error += fabsf(pred - label) / ((pred + label) / 2);
+    }
+  }
+
+  // Each block adds its partial sums once.
+  checked = blockReduceSum(checked);
+  __syncthreads();
+  hits = blockReduceSum(hits);
+  __syncthreads();
+  error = blockReduceSum(error);
+  if (threadIdx.x == 0) {
+    if (terms.hit_rate) {
+      atomicAdd(&sums->hit_rate_checked, checked);
+      atomicAdd(&sums->hit_rate_hits, hits);
+    }
+    if (terms.smape) {
+      atomicAdd(&sums->smape_error, error);
+    }
+  }
+}
+
+void FusedLocalReduce::local_reduce(int local_gpu_id, Core23RawMetricMap raw_metrics) {
+  FusedMetricTerms terms;
+  std::vector<Metric*> fused_metrics;
+  for (Metric* metric : metrics_) {
+    if (metric->add_fused_terms(local_gpu_id, terms)) {
+      fused_metrics.push_back(metric);
+    } else {
+      metric->local_reduce(local_gpu_id, raw_metrics);
+    }
+  }
+  if (fused_metrics.empty()) {
+    return;
+  }
+
+  const auto& local_gpu = resource_manager_->get_local_gpu(local_gpu_id);
+  CudaDeviceContext context(local_gpu->get_device_id());
+  auto stream = local_gpu->get_stream();
+  const float* loss = terms.loss ? raw_metrics[RawType::Loss].data<float>() : nullptr;
+  const core23::Tensor& pred_tensor = raw_metrics[RawType::Pred];
+  const float* labels = raw_metrics[RawType::Label].data<float>();
+
+  HCTR_LIB_THROW(cudaMemsetAsync(d_sums_[local_gpu_id], 0, sizeof(FusedMetricSums), stream));
+  dim3 grid(local_gpu->get_sm_count() * 2, 1, 1);
+  dim3 block(1024, 1, 1);
+  if (pred_tensor.data_type() == core23::ScalarType::Half) {
+    fused_local_reduce_kernel<<<grid, block, 0, stream>>>(
+        pred_tensor.data<__half>(), labels, loss, terms, d_sums_[local_gpu_id]);
+  } else {
+    fused_local_reduce_kernel<<<grid, block, 0, stream>>>(
+        pred_tensor.data<float>(), labels, loss, terms, d_sums_[local_gpu_id]);
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(h_sums_[local_gpu_id], d_sums_[local_gpu_id],
+                                 sizeof(FusedMetricSums), cudaMemcpyDeviceToHost, stream));
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+
+  for (Metric* metric : fused_metrics) {
+    metric->take_fused_sums(local_gpu_id, *h_sums_[local_gpu_id]);
+  }
 }
 
+template <typename T, ReallocType_t U>
+ReallocBuffer<T, U>::ReallocBuffer() : num_elements_(0), ptr_(nullptr), access_desc_(nullptr) {}
+
 template <typename T, ReallocType_t U>
 void ReallocBuffer<T, U>::init_access_desc(const std::vector<CUmemAccessDesc>* access_desc) {
   access_desc_ = access_desc;
@@ -2925,8 +3461,8 @@ ReallocBuffer<T, U>::~ReallocBuffer() {
   if (num_elements_ > 0 and U != ReallocType_t::MMAP) {
     HCTR_LIB_CHECK_(cudaFree(ptr_));
   }
-  if (U == ReallocType_t::MMAP) {
-    release_mmap_memory();
+  if (U == ReallocType_t::MMAP && ptr_) {
+    vm_allocator_->deallocate(ptr_);
   }
 }
 
@@ -2950,139 +3486,36 @@ void ReallocBuffer<T, U>::realloc(size_t new_num_elements, cudaStream_t stream)
     }
     ptr_ = (T*)tmp;
   } else {  // MMAP
-    get_aligned_size(old_size);
-    get_aligned_size(new_size);
-
-    if (new_size > old_size) {
-      CUdevice device;
+    // The buffer keeps its address, so that neither a copy nor a remap of the old memory is
+    // needed.
+    if (!vm_allocator_) {
+      HCTR_CHECK(access_desc_->size());
+      int device;
       HCTR_LIB_THROW(cudaGetDevice(&device));
-      prop_.location.id = device;
-      realloc_ptr_mmap((void**)&ptr_, old_size, new_size);
-    }
-  }
-
-  num_elements_ = new_num_elements;
-}
-
-template <typename T, ReallocType_t U>
-void ReallocBuffer<T, U>::realloc_ptr_mmap(void** ptr, size_t old_size, size_t new_size) {
-  // Implementation based on
-  // https://developer.nvidia.com/blog/introducing-low-level-gpu-virtual-memory-management/
-
-  HCTR_CHECK(access_desc_->size());
-  size_t reserve_size = new_size - old_size;
-  MMAP_DEBUG("Old %lu New %lu Reserve %lu bytes\n", old_size, new_size, reserve_size);
-
-  // First step: create the necessary virtual memory range
-  // Second step: create physical memory rchunk and perform VM -> PM mapping
-  // Most of the complexity is in first step when old_size != 0
-  // Second step is common across different scenarios in first step
-
-  // Physical memory handle
-  CUmemGenericAllocationHandle allocHandle;
-  CUdeviceptr new_ptr = 0;
-  if (old_size == 0) {
-    // Reserve a virtual address range
-    HCTR_LIB_THROW(cuMemAddressReserve(&new_ptr, reserve_size, 0, 0, 0));
-    vm_ranges_.push_back({new_ptr, reserve_size});
-    *ptr = (void*)new_ptr;
-  } else {
-    // Try to reserve virtual memory at the end of old ptr
-    const CUresult status =
-        cuMemAddressReserve(&new_ptr, reserve_size, 0, (CUdeviceptr)((uint64_t)*ptr + old_size), 0);
-
-    if ((status != CUDA_SUCCESS) || ((void*)new_ptr != (void*)((uint64_t)*ptr + old_size))) {
-      // We couldn't get the address we wanted, so fall back to the slow path
-      MMAP_DEBUG("Failed to extend VM range\n");
-
-      // Don’t leak new_ptr if you got one
-      if (new_ptr) {
-        HCTR_LIB_THROW(cuMemAddressFree(new_ptr, reserve_size));
-      }
-
-      // Now reserve the new, bigger VA range
-      HCTR_LIB_THROW(cuMemAddressReserve(&new_ptr, new_size, 0, 0, 0));
-
-      // Map first part of new VA range to existing physical memory chunks, enabling their access
-      std::vector<std::pair<CUdeviceptr, size_t>> new_mmap_ranges;
-      CUdeviceptr tmp = new_ptr;
-      MMAP_DEBUG("Remapping VM -> PM\n");
-      for (auto handle : pm_handles_) {
-        auto size = handle.second;
-        HCTR_LIB_THROW(cuMemMap(tmp, size, 0, handle.first, 0));
-        new_mmap_ranges.push_back({tmp, size});
-        tmp += size;
-      }
-
-      // Set access permissions
-      HCTR_LIB_THROW(
-          cuMemSetAccess(new_ptr, old_size, &(access_desc_->at(0)), access_desc_->size()));
-
-      // Unmap old mappings
-      for (auto range : mmap_ranges_) {
-        HCTR_LIB_THROW(cuMemUnmap(range.first, range.second));
-      }
-      // Clear old mappings, save new mappings
-      mmap_ranges_ = new_mmap_ranges;
-
-      // Free up previous VA allocations
-      MMAP_DEBUG("Freeing %lu old VM allocations\n", vm_ranges_.size());
-      for (auto range : vm_ranges_) {
-        HCTR_LIB_THROW(cuMemAddressFree(range.first, range.second));
+      std::vector<int> peers;
+      for (const auto& desc : *access_desc_) {
+        peers.push_back(desc.location.id);
       }
-
-      // Save new VA allocation information
-      vm_ranges_.clear();
-      vm_ranges_.push_back({new_ptr, new_size});
-
-      *ptr = (void*)new_ptr;
-      new_ptr = (CUdeviceptr)(((uint64_t)new_ptr) + old_size);
+      vm_allocator_ = std::make_shared<core23::VirtualCUDAAllocator>(
+          core23::Device(core23::DeviceType::GPU, device), 0, peers);
+    }
+    if (ptr_) {
+      vm_allocator_->grow(ptr_, new_size);
     } else {
-      vm_ranges_.push_back({new_ptr, reserve_size});
+      ptr_ = static_cast<T*>(vm_allocator_->allocate(new_size));
     }
   }
 
-  // Finally, create new physical memory chunk
-  HCTR_LIB_THROW(cuMemCreate(&allocHandle, reserve_size, &prop_, 0));
-  pm_handles_.push_back({allocHandle, reserve_size});
-
-  // Map new_ptr to physical memory
-  HCTR_LIB_THROW(cuMemMap(new_ptr, reserve_size, 0, allocHandle, 0));
-  mmap_ranges_.push_back({new_ptr, reserve_size});
-
-  // Set access permissions
-  HCTR_LIB_THROW(
-      cuMemSetAccess(new_ptr, reserve_size, &(access_desc_->at(0)), access_desc_->size()));
-}
-
-template <typename T, ReallocType_t U>
-void ReallocBuffer<T, U>::release_mmap_memory() {
-  MMAP_DEBUG("Release mmap metadata sizes: pm %lu vm %lu mmap %lu\n", pm_handles_.size(),
-             vm_ranges_.size(), mmap_ranges_.size());
-
-  CUresult status;
-  // Unmap virtual memory
-  for (auto range : mmap_ranges_) {
-    HCTR_LIB_THROW(cuMemUnmap(range.first, range.second));
-  }
-  mmap_ranges_.clear();
-
-  // Release virtual memory
-  for (auto range : vm_ranges_) {
-    HCTR_LIB_THROW(cuMemAddressFree(range.first, range.second));
-  }
-  vm_ranges_.clear();
-
-  // Release physical memory
-  for (auto handle : pm_handles_) {
-    HCTR_LIB_THROW(cuMemRelease(handle.first));
-  }
-  pm_handles_.clear();
+  num_elements_ = new_num_elements;
 }
 
 template class AverageLoss<float>;
 template class AUC<float>;
 template class AUC<__half>;
+template class ApproxAUC<float>;
+template class ApproxAUC<__half>;
+template class InBatchRanking<float>;
+template class InBatchRanking<__half>;
 template class HitRate<float>;
 
 }  // namespace metrics
@@ -22,6 +22,7 @@
 #include <network.hpp>
 #include <parser.hpp>
 #include <regularizers/no_regularizer.hpp>
+#include <timeline.hpp>
 
 namespace HugeCTR {
 
@@ -35,6 +36,7 @@ Network::Network(const std::shared_ptr<CPUResource>& cpu_resource,
       use_mixed_precision_(use_mixed_precision) {}
 
 void Network::update_params() {
+  TraceRange range(TraceCategory::Optimizer, "optimizer_update");
   optimizer_->update();
   return;
 }
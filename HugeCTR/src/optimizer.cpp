@@ -18,6 +18,8 @@
 #include <optimizers/adagrad_optimizer.hpp>
 #include <optimizers/adam_optimizer.hpp>
 #include <optimizers/ftrl_optimizer.hpp>
+#include <optimizers/lamb_optimizer.hpp>
+#include <optimizers/lars_optimizer.hpp>
 #include <optimizers/momentum_sgd_optimizer.hpp>
 #include <optimizers/nesterov_optimizer.hpp>
 #include <optimizers/sgd_optimizer.hpp>
@@ -91,6 +93,10 @@ std::unique_ptr<Optimizer> Optimizer::Create(const OptParams& params,
                                               learning_rate, scaler, use_mixed_precision);
     } break;
 
+    case Optimizer_t::LAMB:
+    case Optimizer_t::LARS:
+      HCTR_OWN_THROW(Error_t::WrongInput, "LAMB and LARS need the weight tensors of the layers");
+
     default:
       HCTR_OWN_THROW(Error_t::WrongInput, "No such optimizer && should never get here!");
   }
@@ -161,9 +167,29 @@ std::unique_ptr<Optimizer> Optimizer::Create(
                                     use_mixed_precision));
     } break;
 
+    case Optimizer_t::LAMB: {
+      const auto& hyperparams = params.hyperparams.lamb;
+      ret = std::make_unique<LAMBOptimizer<T>>(
+          weight_tensor_container, wgrad_tensor_container, gpu_resource, params.lr,
+          hyperparams.beta1, hyperparams.beta2, hyperparams.epsilon, hyperparams.weight_decay,
+          scaler);
+    } break;
+
+    case Optimizer_t::LARS: {
+      const auto& hyperparams = params.hyperparams.lars;
+      ret = std::make_unique<LARSOptimizer<T>>(
+          weight_tensor_container, wgrad_tensor_container, gpu_resource, params.lr,
+          hyperparams.momentum, hyperparams.trust_coefficient, hyperparams.epsilon,
+          hyperparams.weight_decay, scaler);
+    } break;
+
     default:
       HCTR_OWN_THROW(Error_t::WrongInput, "No such optimizer && should never get here!");
   }
+  if (use_mixed_precision && params.optimizer != Optimizer_t::SGD) {
+    ret->set_weight_half_tensors(WeightHalfTensors(
+        weight_half_tensors, {static_cast<int64_t>(weight_half_tensors.size())}));
+  }
   return ret;
 }
 template std::unique_ptr<Optimizer> Optimizer::Create<float>(
@@ -16,6 +16,7 @@
 
 #include <general_buffer2.hpp>
 #include <optimizers/adagrad_optimizer.hpp>
+#include <optimizers/fused_update.cuh>
 #include <utils.cuh>
 #include <utils.hpp>
 
@@ -24,7 +25,13 @@ namespace {
 
 template <typename T>
 __global__ void ada_grad_update4_kernel(size_t len, float* weight, const T* wgrad, float* sum,
-                                        float lr, const float epsilon, float scaler) {
+                                        float lr, const float* lr_ptr, const float epsilon,
+                                        float scaler, const int* skip_update,
+                                        FusedUpdateParams fused) {
+  if (skip_update && *skip_update) {
+    return;
+  }
+  lr = scale_by_device_lr(lr, lr_ptr);
   size_t num_threads_in_grid = static_cast<size_t>(gridDim.x) * blockDim.x;
   constexpr int group_size = 4;
   using T4 = typename std::conditional<(sizeof(T) == 4), float4, float2>::type;
@@ -33,10 +40,15 @@ __global__ void ada_grad_update4_kernel(size_t len, float* weight, const T* wgra
   for (size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < new_len;
        i += num_threads_in_grid) {
     T4 gi_group = *reinterpret_cast<const T4*>(wgrad + i * group_size);
+    float4 weight_group = *reinterpret_cast<float4*>(weight + i * group_size);
+    float* weight_ = reinterpret_cast<float*>(&weight_group);
     float gi[group_size];
 #pragma unroll group_size
     for (int j = 0; j < group_size; j++) {
-      gi[j] = TypeConvertFunc<float, T>::convert(reinterpret_cast<T*>(&gi_group)[j]) / scaler;
+      gi[j] = add_fused_regularizer(
+                  fused, TypeConvertFunc<float, T>::convert(reinterpret_cast<T*>(&gi_group)[j]),
+                  weight_[j]) /
+              scaler;
     }
 
     float4 accum_group = *reinterpret_cast<float4*>(sum + i * group_size);
@@ -52,38 +64,50 @@ __global__ void ada_grad_update4_kernel(size_t len, float* weight, const T* wgra
       std_[j] = epsilon + sqrtf(accum_[j]);
     }
 
-    float4 weight_group = *reinterpret_cast<float4*>(weight + i * group_size);
-    float* weight_ = reinterpret_cast<float*>(&weight_group);
 #pragma unroll group_size
     for (int j = 0; j < group_size; j++) {
       weight_[j] -= lr * gi[j] / std_[j];
     }
 
     *reinterpret_cast<float4*>(weight + i * group_size) = weight_group;
+    if (fused.weight_half) {
+      __half2* weight_half2 = reinterpret_cast<__half2*>(fused.weight_half + i * group_size);
+      weight_half2[0] = __floats2half2_rn(weight_[0], weight_[1]);
+      weight_half2[1] = __floats2half2_rn(weight_[2], weight_[3]);
+    }
     *reinterpret_cast<float4*>(sum + i * group_size) = accum_group;
   }
 
   size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x + new_len * group_size;
   if (i < len) {
-    float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float wi = weight[i];
+    float gi =
+        add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[i]), wi) / scaler;
     float accum_ = sum[i];
     accum_ += gi * gi;
     float std_ = epsilon + sqrtf(accum_);
-    weight[i] -= lr * gi / std_;
+    store_fused_weight(fused, weight, i, wi - lr * gi / std_);
     sum[i] = accum_;
   }
 }
 
 template <typename T>
 __global__ void ada_grad_update_kernel(int len, float* weight, const T* wgrad, float* sum, float lr,
-                                       const float epsilon, float scaler) {
+                                       const float* lr_ptr, const float epsilon, float scaler,
+                                       const int* skip_update, FusedUpdateParams fused) {
+  if (skip_update && *skip_update) {
+    return;
+  }
+  lr = scale_by_device_lr(lr, lr_ptr);
   const int i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
-    float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float wi = weight[i];
+    float gi =
+        add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[i]), wi) / scaler;
     float accum_ = sum[i];
     accum_ += gi * gi;
     float std_ = epsilon + sqrtf(accum_);
-    weight[i] -= lr * gi / std_;
+    store_fused_weight(fused, weight, i, wi - lr * gi / std_);
     sum[i] = accum_;
   }
 }
@@ -154,11 +178,13 @@ void AdaGradOptimizer<T>::update() {
       auto max_thread_per_sm = gpu_resource_->get_max_thread_per_sm();
       size_t grid_dim = num_sms * max_thread_per_sm / block_dim;
       ada_grad_update4_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-          len, weight, wgrad, accum, lr_, epsilon_, scaler_);
+          len, weight, wgrad, accum, get_host_learning_rate(), get_device_learning_rate(), epsilon_,
+          scaler_, skip_update_, get_fused_update_params());
     } else {
       size_t grid_dim = (len - 1) / block_dim + 1;
       ada_grad_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-          len, weight, wgrad, accum, lr_, epsilon_, scaler_);
+          len, weight, wgrad, accum, get_host_learning_rate(), get_device_learning_rate(), epsilon_,
+          scaler_, skip_update_, get_fused_update_params());
     }
   } else {
     auto flat_weight_tensor = weight_tensors_->flatten();
@@ -172,11 +198,13 @@ void AdaGradOptimizer<T>::update() {
       auto max_thread_per_sm = gpu_resource_->get_max_thread_per_sm();
       size_t grid_dim = num_sms * max_thread_per_sm / block_dim;
       ada_grad_update4_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-          len, weight, wgrad, accum, lr_, epsilon_, scaler_);
+          len, weight, wgrad, accum, get_host_learning_rate(), get_device_learning_rate(), epsilon_,
+          scaler_, skip_update_, get_fused_update_params());
     } else {
       size_t grid_dim = (len - 1) / block_dim + 1;
       ada_grad_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-          len, weight, wgrad, accum, lr_, epsilon_, scaler_);
+          len, weight, wgrad, accum, get_host_learning_rate(), get_device_learning_rate(), epsilon_,
+          scaler_, skip_update_, get_fused_update_params());
     }
   }
 }
@@ -17,6 +17,7 @@
 #include <core23/data_type.hpp>
 #include <general_buffer2.hpp>
 #include <optimizers/adam_optimizer.hpp>
+#include <optimizers/fused_update.cuh>
 #include <utils.cuh>
 #include <utils.hpp>
 
@@ -26,16 +27,23 @@ namespace {
 
 template <typename T>
 __global__ void adam_update_kernel(int len, float* weight, float* m, float* v, const T* wgrad,
-                                   float alpha_t, float beta1, float beta2, float epsilon,
-                                   float scaler) {
+                                   float alpha_t, const float* lr_ptr, float beta1, float beta2,
+                                   float epsilon, float scaler, const int* skip_update,
+                                   FusedUpdateParams fused) {
+  if (skip_update && *skip_update) {
+    return;
+  }
+  alpha_t = scale_by_device_lr(alpha_t, lr_ptr);
   const int i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
-    float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float wi = weight[i];
+    float gi =
+        add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[i]), wi) / scaler;
     float mi = beta1 * m[i] + (1.f - beta1) * gi;
     float vi = beta2 * v[i] + (1.f - beta2) * gi * gi;
     m[i] = mi;
     v[i] = vi;
-    weight[i] -= alpha_t * mi / (sqrt(vi) + epsilon);
+    store_fused_weight(fused, weight, i, wi - alpha_t * mi / (sqrt(vi) + epsilon));
   }
 }
 
@@ -105,7 +113,8 @@ void AdamOptimizer<T>::update() {
   constexpr size_t block_dim = 256;
 
   ++t_;
-  const float alpha_t = lr_ * std::sqrt(1 - std::pow(beta2_, t_)) / (1 - std::pow(beta1_, t_));
+  const float alpha_t = get_host_learning_rate() * std::sqrt(1 - std::pow(beta2_, t_)) /
+                        (1 - std::pow(beta1_, t_));
   if (!wgrad_tensors_) {
     const size_t len = weight_main_.get_num_elements();
     const size_t grid_dim = (len - 1) / block_dim + 1;
@@ -115,7 +124,8 @@ void AdamOptimizer<T>::update() {
     float* v = v_.get_ptr();
     const T* wgrad = wgrad_.get_ptr();
     adam_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, m, v, wgrad, alpha_t, beta1_, beta2_, epsilon_, scaler_);
+        len, weight, m, v, wgrad, alpha_t, get_device_learning_rate(), beta1_, beta2_, epsilon_,
+        scaler_, skip_update_, get_fused_update_params());
   } else {
     auto flat_weight_tensor = weight_tensors_->flatten();
     auto flat_wgrad_tensor = wgrad_tensors_->flatten();
@@ -129,7 +139,8 @@ void AdamOptimizer<T>::update() {
     float* v = v_tensor_.data<float>();
 
     adam_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, m, v, wgrad, alpha_t, beta1_, beta2_, epsilon_, scaler_);
+        len, weight, m, v, wgrad, alpha_t, get_device_learning_rate(), beta1_, beta2_, epsilon_,
+        scaler_, skip_update_, get_fused_update_params());
   }
 }
 
@@ -16,6 +16,7 @@
 #include <float.h>
 
 #include <general_buffer2.hpp>
+#include <optimizers/fused_update.cuh>
 #include <optimizers/ftrl_optimizer.hpp>
 #include <utils.cuh>
 #include <utils.hpp>
@@ -26,19 +27,26 @@ namespace {
 
 template <typename T>
 __global__ void ftrl_update_kernel(int len, float* weight, float* z, float* n, const T* wgrad,
-                                   float alpha, float beta, float lambda1, float lambda2,
-                                   float scaler) {
+                                   float alpha, const float* lr_ptr, float beta, float lambda1,
+                                   float lambda2, float scaler, const int* skip_update,
+                                   FusedUpdateParams fused) {
+  if (skip_update && *skip_update) {
+    return;
+  }
+  alpha = scale_by_device_lr(alpha, lr_ptr);
+  lambda2 += beta / alpha;
   const int i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
-    float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float wi = weight[i];
+    float gi =
+        add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[i]), wi) / scaler;
     float ni_new = n[i] + gi * gi;
-    float zi =
-        z[i] + gi + (sqrtf(n[i] + FLT_EPSILON) - sqrtf(ni_new + FLT_EPSILON)) * weight[i] / alpha;
+    float zi = z[i] + gi + (sqrtf(n[i] + FLT_EPSILON) - sqrtf(ni_new + FLT_EPSILON)) * wi / alpha;
     float x = lambda1 * (1.0f - 2.0f * signbit(zi)) - zi;
     float y = sqrtf(ni_new + FLT_EPSILON) / alpha + lambda2;
     n[i] = ni_new;
     z[i] = zi;
-    weight[i] = x / y * signbit(lambda1 - abs(zi));
+    store_fused_weight(fused, weight, i, x / y * signbit(lambda1 - abs(zi)));
   }
 }
 
@@ -113,7 +121,8 @@ void FtrlOptimizer<T>::update() {
     float* n = n_.get_ptr();
     const T* wgrad = wgrad_.get_ptr();
     ftrl_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, z, n, wgrad, lr_, beta_, lambda1_, lambda2_ + beta_ / lr_, scaler_);
+        len, weight, z, n, wgrad, get_host_learning_rate(), get_device_learning_rate(), beta_,
+        lambda1_, lambda2_, scaler_, skip_update_, get_fused_update_params());
   } else {
     auto flat_weight_tensor = weight_tensors_->flatten();
     auto flat_wgrad_tensor = wgrad_tensors_->flatten();
@@ -126,7 +135,8 @@ void FtrlOptimizer<T>::update() {
     float* z = z_tensor_.data<float>();
     float* n = n_tensor_.data<float>();
     ftrl_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, z, n, wgrad, lr_, beta_, lambda1_, lambda2_ + beta_ / lr_, scaler_);
+        len, weight, z, n, wgrad, get_host_learning_rate(), get_device_learning_rate(), beta_,
+        lambda1_, lambda2_, scaler_, skip_update_, get_fused_update_params());
   }
 }
 
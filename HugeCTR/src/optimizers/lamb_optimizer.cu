@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <optimizers/fused_update.cuh>
+#include <optimizers/lamb_optimizer.hpp>
+#include <optimizers/layer_wise_update.cuh>
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+namespace {
+
+// Update direction of LAMB with the bias corrected moments, before the trust ratio.
+struct LAMBDirection {
+  float m_correction;
+  float v_correction;
+  float epsilon;
+  float weight_decay;
+
+  __device__ float operator()(float mi, float vi, float wi) const {
+    return mi * m_correction / (sqrtf(vi * v_correction) + epsilon) + weight_decay * wi;
+  }
+};
+
+// Updates the moments, and returns the weight and its update direction for their norms.
+template <typename T>
+struct LAMBMomentsOp {
+  const float* weight;
+  float* m;
+  float* v;
+  const T* wgrad;
+  float beta1;
+  float beta2;
+  float scaler;
+  LAMBDirection direction;
+  FusedUpdateParams fused;
+
+  __device__ float2 operator()(int64_t i) const {
+    const float wi = weight[i];
+    const float gi =
+        add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[i]), wi) / scaler;
+    const float mi = beta1 * m[i] + (1.f - beta1) * gi;
+    const float vi = beta2 * v[i] + (1.f - beta2) * gi * gi;
+    m[i] = mi;
+    v[i] = vi;
+    return make_float2(wi, direction(mi, vi, wi));
+  }
+};
+
+struct LAMBUpdateOp {
+  float* weight;
+  const float* m;
+  const float* v;
+  LAMBDirection direction;
+  float lr;
+  const float* lr_ptr;
+  FusedUpdateParams fused;
+
+  __device__ void operator()(int64_t i, float weight_norm, float direction_norm) const {
+    const float wi = weight[i];
+    // Layers whose weights are still 0, e.g. biases, are updated as with Adam.
+    const float trust_ratio =
+        weight_norm > 0.f && direction_norm > 0.f ? weight_norm / direction_norm : 1.f;
+    const float update = scale_by_device_lr(lr, lr_ptr) * trust_ratio * direction(m[i], v[i], wi);
+    store_fused_weight(fused, weight, i, wi - update);
+  }
+};
+
+}  // namespace
+
+template <typename T>
+LAMBOptimizer<T>::LAMBOptimizer(std::optional<WeightTensors> weight_tensors,
+                                std::optional<WgradTensors<T>> wgrad_tensors,
+                                const std::shared_ptr<GPUResource>& gpu_resource,
+                                float learning_rate, float beta1, float beta2, float epsilon,
+                                float weight_decay, float scaler)
+    : LayerWiseOptimizer(weight_tensors, gpu_resource, learning_rate, scaler),
+      wgrad_tensors_(wgrad_tensors),
+      t_(0),
+      beta1_(beta1),
+      beta2_(beta2),
+      epsilon_(epsilon),
+      weight_decay_(weight_decay) {
+  core23::TensorParams tensor_params =
+      core23::TensorParams()
+          .device(core23::Device(core23::DeviceType::GPU, gpu_resource->get_device_id()))
+          .data_type(core23::ScalarType::Float)
+          .shape(core23::Shape({weight_tensors_->flatten().size(0)}))
+          .buffer_channel(GetOptStateBufferChannnel());
+
+  m_tensor_ = core23::Tensor(tensor_params);
+  v_tensor_ = core23::Tensor(tensor_params);
+}
+
+template <typename T>
+void LAMBOptimizer<T>::initialize() {
+  LayerWiseOptimizer::initialize();
+  HCTR_LIB_THROW(
+      cudaMemsetAsync(m_tensor_.data(), 0, m_tensor_.num_bytes(), gpu_resource_->get_stream()));
+  HCTR_LIB_THROW(
+      cudaMemsetAsync(v_tensor_.data(), 0, v_tensor_.num_bytes(), gpu_resource_->get_stream()));
+}
+
+template <typename T>
+void LAMBOptimizer<T>::update() {
+  CudaDeviceContext context(get_device_id());
+
+  constexpr size_t block_dim = 256;
+
+  ++t_;
+  const LAMBDirection direction{1.f / (1.f - std::pow(beta1_, t_)),
+                                1.f / (1.f - std::pow(beta2_, t_)), epsilon_, weight_decay_};
+  float* weight = weight_tensors_->flatten().data();
+  const T* wgrad = wgrad_tensors_->flatten().data();
+  float* m = m_tensor_.data<float>();
+  float* v = v_tensor_.data<float>();
+  const FusedUpdateParams fused = get_fused_update_params();
+
+  const dim3 grid_dim = get_layer_wise_grid_dim(block_dim);
+  float* square_sums = reset_square_sums();
+  layer_wise_square_sum_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
+      get_layer_ranges(),
+      LAMBMomentsOp<T>{weight, m, v, wgrad, beta1_, beta2_, scaler_, direction, fused},
+      square_sums, skip_update_);
+  layer_wise_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
+      get_layer_ranges(),
+      LAMBUpdateOp{weight, m, v, direction, get_host_learning_rate(), get_device_learning_rate(),
+                   fused},
+      square_sums, skip_update_);
+}
+
+template class LAMBOptimizer<float>;
+template class LAMBOptimizer<__half>;
+
+}  // namespace HugeCTR
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <optimizers/fused_update.cuh>
+#include <optimizers/lars_optimizer.hpp>
+#include <optimizers/layer_wise_update.cuh>
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+namespace {
+
+template <typename T>
+struct LARSGradient {
+  const float* weight;
+  const T* wgrad;
+  float scaler;
+  FusedUpdateParams fused;
+
+  __device__ float operator()(int64_t i) const {
+    return add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[i]), weight[i]) /
+           scaler;
+  }
+};
+
+// Returns the weight and its gradient for their norms.
+template <typename T>
+struct LARSNormsOp {
+  LARSGradient<T> gradient;
+
+  __device__ float2 operator()(int64_t i) const {
+    return make_float2(gradient.weight[i], gradient(i));
+  }
+};
+
+template <typename T>
+struct LARSUpdateOp {
+  float* weight;
+  float* momentum_state;
+  LARSGradient<T> gradient;
+  float momentum;
+  float trust_coefficient;
+  float epsilon;
+  float weight_decay;
+  float lr;
+  const float* lr_ptr;
+
+  __device__ void operator()(int64_t i, float weight_norm, float gradient_norm) const {
+    const float wi = weight[i];
+    // Layers whose weights or gradients are still 0, e.g. biases, are updated as with momentum.
+    const float local_lr =
+        weight_norm > 0.f && gradient_norm > 0.f
+            ? trust_coefficient * weight_norm /
+                  (gradient_norm + weight_decay * weight_norm + epsilon)
+            : 1.f;
+    const float vi = momentum * momentum_state[i] + scale_by_device_lr(lr, lr_ptr) * local_lr *
+                                                        (gradient(i) + weight_decay * wi);
+    momentum_state[i] = vi;
+    store_fused_weight(gradient.fused, weight, i, wi - vi);
+  }
+};
+
+}  // namespace
+
+template <typename T>
+LARSOptimizer<T>::LARSOptimizer(std::optional<WeightTensors> weight_tensors,
+                                std::optional<WgradTensors<T>> wgrad_tensors,
+                                const std::shared_ptr<GPUResource>& gpu_resource,
+                                float learning_rate, float momentum, float trust_coefficient,
+                                float epsilon, float weight_decay, float scaler)
+    : LayerWiseOptimizer(weight_tensors, gpu_resource, learning_rate, scaler),
+      wgrad_tensors_(wgrad_tensors),
+      momentum_(momentum),
+      trust_coefficient_(trust_coefficient),
+      epsilon_(epsilon),
+      weight_decay_(weight_decay) {
+  core23::TensorParams tensor_params =
+      core23::TensorParams()
+          .device(core23::Device(core23::DeviceType::GPU, gpu_resource->get_device_id()))
+          .data_type(core23::ScalarType::Float)
+          .shape(core23::Shape({weight_tensors_->flatten().size(0)}))
+          .buffer_channel(GetOptStateBufferChannnel());
+
+  momentum_tensor_ = core23::Tensor(tensor_params);
+}
+
+template <typename T>
+void LARSOptimizer<T>::initialize() {
+  LayerWiseOptimizer::initialize();
+  HCTR_LIB_THROW(cudaMemsetAsync(momentum_tensor_.data(), 0, momentum_tensor_.num_bytes(),
+                                 gpu_resource_->get_stream()));
+}
+
+template <typename T>
+void LARSOptimizer<T>::update() {
+  CudaDeviceContext context(get_device_id());
+
+  constexpr size_t block_dim = 256;
+
+  float* weight = weight_tensors_->flatten().data();
+  const LARSGradient<T> gradient{weight, wgrad_tensors_->flatten().data(), scaler_,
+                                 get_fused_update_params()};
+
+  const dim3 grid_dim = get_layer_wise_grid_dim(block_dim);
+  float* square_sums = reset_square_sums();
+  layer_wise_square_sum_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
+      get_layer_ranges(), LARSNormsOp<T>{gradient}, square_sums, skip_update_);
+  layer_wise_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
+      get_layer_ranges(),
+      LARSUpdateOp<T>{weight, momentum_tensor_.data<float>(), gradient, momentum_,
+                      trust_coefficient_, epsilon_, weight_decay_, get_host_learning_rate(),
+                      get_device_learning_rate()},
+      square_sums, skip_update_);
+}
+
+template class LARSOptimizer<float>;
+template class LARSOptimizer<__half>;
+
+}  // namespace HugeCTR
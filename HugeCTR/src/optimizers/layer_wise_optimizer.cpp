@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <optimizers/layer_wise_optimizer.hpp>
+
+namespace HugeCTR {
+
+LayerWiseOptimizer::LayerWiseOptimizer(std::optional<WeightTensors> weight_tensors,
+                                       const std::shared_ptr<GPUResource>& gpu_resource,
+                                       float learning_rate, float scaler)
+    : Optimizer(weight_tensors, gpu_resource, learning_rate, scaler), max_layer_size_(1) {
+  const int64_t num_layers = weight_tensors_->size(0);
+  core23::TensorParams tensor_params = core23::TensorParams().device(
+      core23::Device(core23::DeviceType::GPU, gpu_resource->get_device_id()));
+  layer_ranges_ = core23::Tensor(
+      tensor_params.data_type(core23::ScalarType::Int64).shape({2 * num_layers}));
+  square_sums_ =
+      core23::Tensor(tensor_params.data_type(core23::ScalarType::Float).shape({2 * num_layers}));
+}
+
+void LayerWiseOptimizer::initialize() {
+  auto flat_weight_tensor = weight_tensors_->flatten();
+  const float* weight = flat_weight_tensor.data();
+  const int64_t num_layers = weight_tensors_->size(0);
+  h_layer_ranges_.resize(2 * num_layers);
+  for (int64_t l = 0; l < num_layers; ++l) {
+    auto layer_weight = weight_tensors_->at(l);
+    h_layer_ranges_[2 * l] = layer_weight.data<float>() - weight;
+    h_layer_ranges_[2 * l + 1] = h_layer_ranges_[2 * l] + layer_weight.num_elements();
+    max_layer_size_ = std::max(max_layer_size_, layer_weight.num_elements());
+  }
+  HCTR_LIB_THROW(cudaMemcpyAsync(layer_ranges_.data(), h_layer_ranges_.data(),
+                                 layer_ranges_.num_bytes(), cudaMemcpyHostToDevice,
+                                 gpu_resource_->get_stream()));
+}
+
+dim3 LayerWiseOptimizer::get_layer_wise_grid_dim(size_t block_dim) const {
+  // Enough blocks for the largest layer, but not more than fill the GPU with that layer alone.
+  const size_t blocks_per_layer = std::min<size_t>((max_layer_size_ - 1) / block_dim + 1,
+                                                   gpu_resource_->get_sm_count());
+  return dim3(blocks_per_layer, weight_tensors_->size(0));
+}
+
+float* LayerWiseOptimizer::reset_square_sums() {
+  HCTR_LIB_THROW(cudaMemsetAsync(square_sums_.data(), 0, square_sums_.num_bytes(),
+                                 gpu_resource_->get_stream()));
+  return square_sums_.data<float>();
+}
+
+}  // namespace HugeCTR
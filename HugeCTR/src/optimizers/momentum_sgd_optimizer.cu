@@ -15,6 +15,7 @@
  */
 
 #include <general_buffer2.hpp>
+#include <optimizers/fused_update.cuh>
 #include <optimizers/momentum_sgd_optimizer.hpp>
 #include <utils.cuh>
 #include <utils.hpp>
@@ -25,13 +26,20 @@ namespace {
 
 template <typename T>
 __global__ void momentum_sgd_update_kernel(int len, float* weight, float* momentum, const T* wgrad,
-                                           float lr, float momentum_factor, float scaler) {
+                                           float lr, const float* lr_ptr, float momentum_factor,
+                                           float scaler, const int* skip_update,
+                                           FusedUpdateParams fused) {
+  if (skip_update && *skip_update) {
+    return;
+  }
+  lr = scale_by_device_lr(lr, lr_ptr);
   int idx = blockDim.x * blockIdx.x + threadIdx.x;
   if (idx < len) {
-    float mv = momentum_factor * momentum[idx] -
-               lr * TypeConvertFunc<float, T>::convert(wgrad[idx]) / scaler;
+    float wi = weight[idx];
+    float gi = add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[idx]), wi);
+    float mv = momentum_factor * momentum[idx] - lr * gi / scaler;
     momentum[idx] = mv;
-    weight[idx] += mv;
+    store_fused_weight(fused, weight, idx, wi + mv);
   }
   return;
 }
@@ -97,7 +105,8 @@ void MomentumSGDOptimizer<T>::update() {
     float* momentum = momentum_.get_ptr();
     T* wgrad = wgrad_.get_ptr();
     momentum_sgd_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, momentum, wgrad, lr_, momentum_factor_, scaler_);
+        len, weight, momentum, wgrad, get_host_learning_rate(), get_device_learning_rate(),
+        momentum_factor_, scaler_, skip_update_, get_fused_update_params());
   } else {
     auto flat_weight_tensor = weight_tensors_->flatten();
     auto flat_wgrad_tensor = wgrad_tensors_->flatten();
@@ -108,7 +117,8 @@ void MomentumSGDOptimizer<T>::update() {
 
     float* momentum = momentum_tensor_.data<float>();
     momentum_sgd_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, momentum, wgrad, lr_, momentum_factor_, scaler_);
+        len, weight, momentum, wgrad, get_host_learning_rate(), get_device_learning_rate(),
+        momentum_factor_, scaler_, skip_update_, get_fused_update_params());
   }
 }
 
@@ -15,6 +15,7 @@
  */
 
 #include <general_buffer2.hpp>
+#include <optimizers/fused_update.cuh>
 #include <optimizers/nesterov_optimizer.hpp>
 #include <utils.cuh>
 #include <utils.hpp>
@@ -25,13 +26,20 @@ namespace {
 
 template <typename T>
 __global__ void nesterov_update_kernel(int len, float* weight, float* accum, const T* wgrad,
-                                       float lr, float mu, float scaler) {
+                                       float lr, const float* lr_ptr, float mu, float scaler,
+                                       const int* skip_update, FusedUpdateParams fused) {
+  if (skip_update && *skip_update) {
+    return;
+  }
+  lr = scale_by_device_lr(lr, lr_ptr);
   const int i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
+    float wi = weight[i];
+    float gi = add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[i]), wi);
     float accum_old = accum[i];
-    float accum_new = mu * accum_old - lr * TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+    float accum_new = mu * accum_old - lr * gi / scaler;
     accum[i] = accum_new;
-    weight[i] += (-mu * accum_old + (1.f + mu) * accum_new);
+    store_fused_weight(fused, weight, i, wi + (-mu * accum_old + (1.f + mu) * accum_new));
   }
 }
 
@@ -93,7 +101,8 @@ void NesterovOptimizer<T>::update() {
     float* accum = accum_.get_ptr();
     T* wgrad = wgrad_.get_ptr();
     nesterov_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, accum, wgrad, lr_, mu_, scaler_);
+        len, weight, accum, wgrad, get_host_learning_rate(), get_device_learning_rate(), mu_,
+        scaler_, skip_update_, get_fused_update_params());
   } else {
     auto flat_weight_tensor = weight_tensors_->flatten();
     auto flat_wgrad_tensor = wgrad_tensors_->flatten();
@@ -103,7 +112,8 @@ void NesterovOptimizer<T>::update() {
     float* accum = accum_tensor_.data<float>();
     const size_t grid_dim = (len - 1) / block_dim + 1;
     nesterov_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-        len, weight, accum, wgrad, lr_, mu_, scaler_);
+        len, weight, accum, wgrad, get_host_learning_rate(), get_device_learning_rate(), mu_,
+        scaler_, skip_update_, get_fused_update_params());
   }
 }
 
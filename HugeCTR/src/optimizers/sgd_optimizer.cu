@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <optimizers/fused_update.cuh>
 #include <optimizers/sgd_optimizer.hpp>
 #include <utils.cuh>
 #include <utils.hpp>
@@ -24,7 +25,7 @@ namespace {
 
 template <typename T>
 __device__ inline void sgd_update_device(int len, float* weight, const T* wgrad, float lr,
-                                         float scaler) {
+                                         float scaler, const FusedUpdateParams& fused) {
   constexpr int vec_width = sizeof(float4) / sizeof(float);
   using T4 = typename std::conditional<(sizeof(T) == 4), float4, float2>::type;
 
@@ -40,7 +41,9 @@ __device__ inline void sgd_update_device(int len, float* weight, const T* wgrad,
 
 #pragma unroll vec_width
     for (int i = 0; i < vec_width; i++) {
-      float gi = TypeConvertFunc<float, T>::convert(wgrad_vec[i]) / scaler;
+      float gi = add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad_vec[i]),
+                                       weight_vec[i]) /
+                 scaler;
       weight_vec[i] -= lr * gi;
     }
 
@@ -49,7 +52,9 @@ __device__ inline void sgd_update_device(int len, float* weight, const T* wgrad,
   } else {
 #pragma unroll vec_width
     for (int i = vec_width * gid; i < min(len, vec_width * (gid + 1)); i++) {
-      float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+      float gi =
+          add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[i]), weight[i]) /
+          scaler;
       weight[i] -= lr * gi;
     }
   }
@@ -57,7 +62,8 @@ __device__ inline void sgd_update_device(int len, float* weight, const T* wgrad,
 
 template <typename T>
 __device__ inline void sgd_update_device(int len, float* weight, __half* weight_half,
-                                         const T* wgrad, float lr, float scaler) {
+                                         const T* wgrad, float lr, float scaler,
+                                         const FusedUpdateParams& fused) {
   constexpr int vec_width = sizeof(float4) / sizeof(float);
   using T4 = typename std::conditional<(sizeof(T) == 4), float4, float2>::type;
 
@@ -75,7 +81,9 @@ __device__ inline void sgd_update_device(int len, float* weight, __half* weight_
 
 #pragma unroll vec_width
     for (int i = 0; i < vec_width; i++) {
-      float gi = TypeConvertFunc<float, T>::convert(wgrad_vec[i]) / scaler;
+      float gi = add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad_vec[i]),
+                                       weight_vec[i]) /
+                 scaler;
       weight_vec[i] -= lr * gi;
       weight_half_vec[i] = (__half)weight_vec[i];
     }
@@ -86,7 +94,9 @@ __device__ inline void sgd_update_device(int len, float* weight, __half* weight_
   } else {
 #pragma unroll vec_width
     for (int i = vec_width * gid; i < min(len, vec_width * (gid + 1)); i++) {
-      float gi = TypeConvertFunc<float, T>::convert(wgrad[i]) / scaler;
+      float gi =
+          add_fused_regularizer(fused, TypeConvertFunc<float, T>::convert(wgrad[i]), weight[i]) /
+          scaler;
       weight[i] -= lr * gi;
       weight_half[i] = (__half)weight[i];
     }
@@ -95,21 +105,29 @@ __device__ inline void sgd_update_device(int len, float* weight, __half* weight_
 
 template <typename T>
 __global__ void sgd_update_kernel(int len, float* weight, __half* weight_half, const T* wgrad,
-                                  float lr, float scaler, bool use_mixed_precision) {
+                                  float lr, float scaler, bool use_mixed_precision,
+                                  const int* skip_update, FusedUpdateParams fused) {
+  if (skip_update && *skip_update) {
+    return;
+  }
   if (true == use_mixed_precision) {
-    sgd_update_device(len, weight, weight_half, wgrad, lr, scaler);
+    sgd_update_device(len, weight, weight_half, wgrad, lr, scaler, fused);
   } else {
-    sgd_update_device(len, weight, wgrad, lr, scaler);
+    sgd_update_device(len, weight, wgrad, lr, scaler, fused);
   }
 }
 
 template <typename T>
 __global__ void sgd_update_kernel(int len, float* weight, __half* weight_half, const T* wgrad,
-                                  const float* lr_ptr, float scaler, bool use_mixed_precision) {
+                                  const float* lr_ptr, float scaler, bool use_mixed_precision,
+                                  const int* skip_update, FusedUpdateParams fused) {
+  if (skip_update && *skip_update) {
+    return;
+  }
   if (true == use_mixed_precision) {
-    sgd_update_device(len, weight, weight_half, wgrad, *lr_ptr, scaler);
+    sgd_update_device(len, weight, weight_half, wgrad, *lr_ptr, scaler, fused);
   } else {
-    sgd_update_device(len, weight, wgrad, *lr_ptr, scaler);
+    sgd_update_device(len, weight, wgrad, *lr_ptr, scaler, fused);
   }
 }
 
@@ -157,11 +175,13 @@ void SGDOptimizer<T>::update() {
 
     if (gpu_learning_rate_scheduler_ == nullptr) {
       sgd_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-          len, weight, weight_half, wgrad, lr_, scaler_, use_mixed_precision_);
+          len, weight, weight_half, wgrad, lr_, scaler_, use_mixed_precision_, skip_update_,
+          get_fused_update_params());
     } else {
       float* lr_ptr = gpu_learning_rate_scheduler_->get_learning_rate();
       sgd_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-          len, weight, weight_half, wgrad, lr_ptr, scaler_, use_mixed_precision_);
+          len, weight, weight_half, wgrad, lr_ptr, scaler_, use_mixed_precision_, skip_update_,
+          get_fused_update_params());
     }
   } else {
     auto flat_weight_tensor = weight_tensors_->flatten();
@@ -177,11 +197,13 @@ void SGDOptimizer<T>::update() {
     const size_t grid_dim = (len + block_dim * vec_width - 1) / (block_dim * vec_width);
     if (gpu_learning_rate_scheduler_ == nullptr) {
       sgd_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-          len, weight, weight_half, wgrad, lr_, scaler_, use_mixed_precision_);
+          len, weight, weight_half, wgrad, lr_, scaler_, use_mixed_precision_, skip_update_,
+          get_fused_update_params());
     } else {
       float* lr_ptr = gpu_learning_rate_scheduler_->get_learning_rate();
       sgd_update_kernel<<<grid_dim, block_dim, 0, gpu_resource_->get_stream()>>>(
-          len, weight, weight_half, wgrad, lr_ptr, scaler_, use_mixed_precision_);
+          len, weight, weight_half, wgrad, lr_ptr, scaler_, use_mixed_precision_, skip_update_,
+          get_fused_update_params());
     }
   }
 }
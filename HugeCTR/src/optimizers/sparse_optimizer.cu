@@ -273,7 +273,8 @@ __global__ void adam_update_kernel_global(int embedding_vec_size,
                                           size_t table_size,  // vocabulary size / factor
                                           const AdamOptHyperParams adam, TypeEmbeddingComp *m_ptr,
                                           TypeEmbeddingComp *v_ptr, float alpha_t,
-                                          float *hash_table_value) {
+                                          const float *lr_ptr, float *hash_table_value) {
+  alpha_t = scale_by_device_lr(alpha_t, lr_ptr);
   const int TILE_SIZE = blockDim.x * gridDim.x;
   for (size_t feature_index = blockIdx.x * blockDim.x + threadIdx.x;
        feature_index < table_size * embedding_vec_size; feature_index += TILE_SIZE) {
@@ -294,10 +295,11 @@ __global__ void adam_update_kernel_global(int embedding_vec_size,
 // term to the momentum
 template <typename TypeKey, typename TypeEmbeddingComp>
 __global__ void opt_momentum_sgd_kernel_global(
-    uint32_t hash_value_index_count_num, int embedding_vec_size, float lr,
+    uint32_t hash_value_index_count_num, int embedding_vec_size, float lr, const float *lr_ptr,
     const MomentumSGDOptHyperParams momentum, TypeEmbeddingComp *momentum_ptr,
     const TypeKey *sample_id, const size_t *hash_value_index_sort,
     const uint32_t *hash_value_index_count_offset, const TypeEmbeddingComp *wgrad, float scaler) {
+  lr = scale_by_device_lr(lr, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -353,10 +355,11 @@ __global__ void nesterov_global_update_kernel_global(int embedding_vec_size,
 // to the momentum and update the weights
 template <typename TypeKey, typename TypeEmbeddingComp>
 __global__ void nesterov_local_update_kernel_global(
-    uint32_t hash_value_index_count_num, int embedding_vec_size, float lr,
+    uint32_t hash_value_index_count_num, int embedding_vec_size, float lr, const float *lr_ptr,
     const NesterovOptHyperParams nesterov, TypeEmbeddingComp *accm_ptr, const TypeKey *sample_id,
     const size_t *hash_value_index_sort, const uint32_t *hash_value_index_count_offset,
     const TypeEmbeddingComp *wgrad, float *hash_table_value, float scaler) {
+  lr = scale_by_device_lr(lr, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -379,11 +382,12 @@ __global__ void nesterov_local_update_kernel_global(
 template <typename TypeKey, typename TypeEmbeddingComp>
 __global__ void opt_adam_kernel(uint32_t hash_value_index_count_num, int embedding_vec_size,
                                 const AdamOptHyperParams adam, TypeEmbeddingComp *m_ptr,
-                                TypeEmbeddingComp *v_ptr, float alpha_t, const TypeKey *sample_id,
-                                const size_t *hash_value_index_sort,
+                                TypeEmbeddingComp *v_ptr, float alpha_t, const float *lr_ptr,
+                                const TypeKey *sample_id, const size_t *hash_value_index_sort,
                                 const uint32_t *hash_value_index_count_offset,
                                 const TypeEmbeddingComp *wgrad, float *hash_table_value,
                                 float scaler) {
+  alpha_t = scale_by_device_lr(alpha_t, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -412,12 +416,14 @@ __global__ void opt_adam_kernel(uint32_t hash_value_index_count_num, int embeddi
 // weights
 template <typename TypeKey, typename TypeEmbeddingComp>
 __global__ void opt_adagrad_kernel(uint32_t hash_value_index_count_num, int embedding_vec_size,
-                                   float lr, const AdaGradOptHyperParams adagrad,
+                                   float lr, const float *lr_ptr,
+                                   const AdaGradOptHyperParams adagrad,
                                    TypeEmbeddingComp *accum_ptr, const TypeKey *sample_id,
                                    const size_t *hash_value_index_sort,
                                    const uint32_t *hash_value_index_count_offset,
                                    const TypeEmbeddingComp *wgrad, float *hash_table_value,
                                    float scaler) {
+  lr = scale_by_device_lr(lr, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -442,12 +448,14 @@ __global__ void opt_adagrad_kernel(uint32_t hash_value_index_count_num, int embe
 // Local update for Momentum SGD: compute the gradients and update the momentum and the weights
 template <typename TypeKey, typename TypeEmbeddingComp>
 __global__ void opt_momentum_sgd_kernel(uint32_t hash_value_index_count_num, int embedding_vec_size,
-                                        float lr, const MomentumSGDOptHyperParams momentum,
+                                        float lr, const float *lr_ptr,
+                                        const MomentumSGDOptHyperParams momentum,
                                         TypeEmbeddingComp *momentum_ptr, const TypeKey *sample_id,
                                         const size_t *hash_value_index_sort,
                                         const uint32_t *hash_value_index_count_offset,
                                         const TypeEmbeddingComp *wgrad, float *hash_table_value,
                                         float scaler) {
+  lr = scale_by_device_lr(lr, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -470,12 +478,14 @@ __global__ void opt_momentum_sgd_kernel(uint32_t hash_value_index_count_num, int
 // Local update for Nesterov: compute the gradients and update the accumulators and the weights
 template <typename TypeKey, typename TypeEmbeddingComp>
 __global__ void opt_nesterov_kernel(uint32_t hash_value_index_count_num, int embedding_vec_size,
-                                    float lr, const NesterovOptHyperParams nesterov,
+                                    float lr, const float *lr_ptr,
+                                    const NesterovOptHyperParams nesterov,
                                     TypeEmbeddingComp *accm_ptr, const TypeKey *sample_id,
                                     const size_t *hash_value_index_sort,
                                     const uint32_t *hash_value_index_count_offset,
                                     const TypeEmbeddingComp *wgrad, float *hash_table_value,
                                     float scaler) {
+  lr = scale_by_device_lr(lr, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -498,11 +508,12 @@ __global__ void opt_nesterov_kernel(uint32_t hash_value_index_count_num, int emb
 // Local update for SGD: compute the gradients and update the weights
 template <typename TypeKey, typename TypeEmbeddingComp>
 __global__ void opt_sgd_kernel(uint32_t hash_value_index_count_num, int embedding_vec_size,
-                               float lr, const TypeKey *sample_id,
+                               float lr, const float *lr_ptr, const TypeKey *sample_id,
                                const size_t *hash_value_index_sort,
                                const uint32_t *hash_value_index_count_offset,
                                const TypeEmbeddingComp *wgrad, float *hash_table_value,
                                float scaler) {
+  lr = scale_by_device_lr(lr, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -525,11 +536,12 @@ template <typename TypeKey, typename TypeEmbeddingComp>
 __global__ void opt_adam_kernel_lazy(uint32_t hash_value_index_count_num, int embedding_vec_size,
                                      const AdamOptHyperParams adam, uint64_t *prev_time_ptr,
                                      TypeEmbeddingComp *m_ptr, TypeEmbeddingComp *v_ptr,
-                                     float alpha_t_common, uint64_t times, const TypeKey *sample_id,
-                                     const size_t *hash_value_index_sort,
+                                     float alpha_t_common, const float *lr_ptr, uint64_t times,
+                                     const TypeKey *sample_id, const size_t *hash_value_index_sort,
                                      const uint32_t *hash_value_index_count_offset,
                                      const TypeEmbeddingComp *wgrad, float *hash_table_value,
                                      float scaler) {
+  alpha_t_common = scale_by_device_lr(alpha_t_common, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -563,8 +575,10 @@ __global__ void opt_adam_kernel_lazy(uint32_t hash_value_index_count_num, int em
 
 template <typename TypeKey, typename TypeEmbeddingComp>
 __global__ void opt_sgd_atomic_kernel(int nnz, int embedding_vec_size, float lr_scale,
-                                      const size_t *hash_value_index, const TypeKey *sample_ids,
-                                      const TypeEmbeddingComp *wgrad, float *hash_table_value) {
+                                      const float *lr_ptr, const size_t *hash_value_index,
+                                      const TypeKey *sample_ids, const TypeEmbeddingComp *wgrad,
+                                      float *hash_table_value) {
+  lr_scale = scale_by_device_lr(lr_scale, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -585,8 +599,9 @@ __global__ void opt_sgd_atomic_kernel(int nnz, int embedding_vec_size, float lr_
 // only support LocalizedSlotSparseEmbeddingOneHot
 template <typename TypeEmbeddingComp>
 __global__ void opt_sgd_atomic_kernel(int nnz, int embedding_vec_size, float lr_scale,
-                                      const size_t *hash_value_index,
+                                      const float *lr_ptr, const size_t *hash_value_index,
                                       const TypeEmbeddingComp *wgrad, float *hash_table_value) {
+  lr_scale = scale_by_device_lr(lr_scale, lr_ptr);
   int bid = blockIdx.x;
   int tid = threadIdx.x;
 
@@ -640,6 +655,9 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
   if (slot_num == 0) {
     return;
   }
+  // With a GPU scheduler, the kernels scale the host part of the learning rate by its one.
+  const float *lr_ptr = lr_sched_ ? lr_sched_->get_learning_rate() : nullptr;
+  const float lr = lr_ptr ? 1.f : opt_params.lr;
 
   size_t block_size, grid_size;
 
@@ -655,10 +673,10 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
       const size_t block_size = embedding_vec_size;
       const size_t grid_size = min(max(1ul, nnz), sm_count * 32);
 
-      float lr_scale = opt_params.lr / opt_params.scaler;
+      float lr_scale = lr / opt_params.scaler;
       opt_sgd_atomic_kernel<<<grid_size, block_size, 0, stream>>>(
-          nnz, embedding_vec_size, lr_scale, hash_value_index.get_ptr(), sample_id.get_ptr(),
-          wgrad.get_ptr(), hash_table_value.get_ptr());
+          nnz, embedding_vec_size, lr_scale, lr_ptr, hash_value_index.get_ptr(),
+          sample_id.get_ptr(), wgrad.get_ptr(), hash_table_value.get_ptr());
     } else {
       // step3: sort by hash_value_index
       int end_bit = static_cast<int>(log2(static_cast<float>(max_vocabulary_size_per_gpu))) + 1;
@@ -704,7 +722,7 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
         case Update_t::Global: {
           switch (opt_params.optimizer) {
             case Optimizer_t::Adam: {
-              const float alpha_t = opt_params.lr * opt_params.hyperparams.adam.bias();
+              const float alpha_t = lr * opt_params.hyperparams.adam.bias();
 
               // update target mi and vi
               opt_adam_kernel_global<<<grid_size, block_size, 0, stream>>>(
@@ -716,12 +734,12 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
               adam_update_kernel_global<<<1024, 256, 0, stream>>>(
                   embedding_vec_size, max_vocabulary_size_per_gpu, opt_params.hyperparams.adam,
                   opt_tensor.opt_m_tensors_.get_ptr(), opt_tensor.opt_v_tensors_.get_ptr(), alpha_t,
-                  hash_table_value.get_ptr());
+                  lr_ptr, hash_table_value.get_ptr());
             } break;
 
             case Optimizer_t::AdaGrad:
               opt_adagrad_kernel<<<grid_size, block_size, 0, stream>>>(
-                  hash_hash_value_index_count_num, embedding_vec_size, opt_params.lr,
+                  hash_hash_value_index_count_num, embedding_vec_size, lr, lr_ptr,
                   opt_params.hyperparams.adagrad, opt_tensor.opt_accm_tensors_.get_ptr(),
                   sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
                   hash_value_index_count_offset.get_ptr(), wgrad.get_ptr(),
@@ -730,7 +748,7 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
 
             case Optimizer_t::MomentumSGD:
               opt_momentum_sgd_kernel_global<<<grid_size, block_size, 0, stream>>>(
-                  hash_hash_value_index_count_num, embedding_vec_size, opt_params.lr,
+                  hash_hash_value_index_count_num, embedding_vec_size, lr, lr_ptr,
                   opt_params.hyperparams.momentum, opt_tensor.opt_momentum_tensors_.get_ptr(),
                   sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
                   hash_value_index_count_offset.get_ptr(), wgrad.get_ptr(), opt_params.scaler);
@@ -744,7 +762,7 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
                   embedding_vec_size, max_vocabulary_size_per_gpu, opt_params.hyperparams.nesterov,
                   opt_tensor.opt_accm_tensors_.get_ptr(), hash_table_value.get_ptr());
               nesterov_local_update_kernel_global<<<grid_size, block_size, 0, stream>>>(
-                  hash_hash_value_index_count_num, embedding_vec_size, opt_params.lr,
+                  hash_hash_value_index_count_num, embedding_vec_size, lr, lr_ptr,
                   opt_params.hyperparams.nesterov, opt_tensor.opt_accm_tensors_.get_ptr(),
                   sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
                   hash_value_index_count_offset.get_ptr(), wgrad.get_ptr(),
@@ -755,7 +773,7 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
               // Note: this is in fact a local update
               /// TODO: remove duplicate?
               opt_sgd_kernel<<<grid_size, block_size, 0, stream>>>(
-                  hash_hash_value_index_count_num, embedding_vec_size, opt_params.lr,
+                  hash_hash_value_index_count_num, embedding_vec_size, lr, lr_ptr,
                   sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
                   hash_value_index_count_offset.get_ptr(), wgrad.get_ptr(),
                   hash_table_value.get_ptr(), opt_params.scaler);
@@ -769,19 +787,19 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
         case Update_t::Local: {
           switch (opt_params.optimizer) {
             case Optimizer_t::Adam: {
-              const float alpha_t = opt_params.lr * opt_params.hyperparams.adam.bias();
+              const float alpha_t = lr * opt_params.hyperparams.adam.bias();
 
               opt_adam_kernel<<<grid_size, block_size, 0, stream>>>(
                   hash_hash_value_index_count_num, embedding_vec_size, opt_params.hyperparams.adam,
                   opt_tensor.opt_m_tensors_.get_ptr(), opt_tensor.opt_v_tensors_.get_ptr(), alpha_t,
-                  sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
+                  lr_ptr, sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
                   hash_value_index_count_offset.get_ptr(), wgrad.get_ptr(),
                   hash_table_value.get_ptr(), opt_params.scaler);
             } break;
 
             case Optimizer_t::AdaGrad:
               opt_adagrad_kernel<<<grid_size, block_size, 0, stream>>>(
-                  hash_hash_value_index_count_num, embedding_vec_size, opt_params.lr,
+                  hash_hash_value_index_count_num, embedding_vec_size, lr, lr_ptr,
                   opt_params.hyperparams.adagrad, opt_tensor.opt_accm_tensors_.get_ptr(),
                   sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
                   hash_value_index_count_offset.get_ptr(), wgrad.get_ptr(),
@@ -790,7 +808,7 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
 
             case Optimizer_t::MomentumSGD:
               opt_momentum_sgd_kernel<<<grid_size, block_size, 0, stream>>>(
-                  hash_hash_value_index_count_num, embedding_vec_size, opt_params.lr,
+                  hash_hash_value_index_count_num, embedding_vec_size, lr, lr_ptr,
                   opt_params.hyperparams.momentum, opt_tensor.opt_momentum_tensors_.get_ptr(),
                   sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
                   hash_value_index_count_offset.get_ptr(), wgrad.get_ptr(),
@@ -799,7 +817,7 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
 
             case Optimizer_t::Nesterov:
               opt_nesterov_kernel<<<grid_size, block_size, 0, stream>>>(
-                  hash_hash_value_index_count_num, embedding_vec_size, opt_params.lr,
+                  hash_hash_value_index_count_num, embedding_vec_size, lr, lr_ptr,
                   opt_params.hyperparams.nesterov, opt_tensor.opt_accm_tensors_.get_ptr(),
                   sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
                   hash_value_index_count_offset.get_ptr(), wgrad.get_ptr(),
@@ -808,7 +826,7 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
 
             case Optimizer_t::SGD:
               opt_sgd_kernel<<<grid_size, block_size, 0, stream>>>(
-                  hash_hash_value_index_count_num, embedding_vec_size, opt_params.lr,
+                  hash_hash_value_index_count_num, embedding_vec_size, lr, lr_ptr,
                   sample_id_sort.get_ptr(), hash_value_index_sort.get_ptr(),
                   hash_value_index_count_offset.get_ptr(), wgrad.get_ptr(),
                   hash_table_value.get_ptr(), opt_params.scaler);
@@ -826,13 +844,12 @@ void EmbeddingOptimizer<TypeHashKey, TypeEmbeddingComp>::update(
               HCTR_OWN_THROW(Error_t::WrongInput,
                              "Error: lazy global update is only implemented for Adam");
             case Optimizer_t::Adam: {
-              const float alpha_t_common =
-                  opt_params.lr / (1.0f - opt_params.hyperparams.adam.beta1);
+              const float alpha_t_common = lr / (1.0f - opt_params.hyperparams.adam.beta1);
 
               opt_adam_kernel_lazy<<<grid_size, block_size, 0, stream>>>(
                   hash_hash_value_index_count_num, embedding_vec_size, opt_params.hyperparams.adam,
                   opt_tensor.opt_prev_time_tensors_.get_ptr(), opt_tensor.opt_m_tensors_.get_ptr(),
-                  opt_tensor.opt_v_tensors_.get_ptr(), alpha_t_common,
+                  opt_tensor.opt_v_tensors_.get_ptr(), alpha_t_common, lr_ptr,
                   opt_params.hyperparams.adam.times, sample_id_sort.get_ptr(),
                   hash_value_index_sort.get_ptr(), hash_value_index_count_offset.get_ptr(),
                   wgrad.get_ptr(), hash_table_value.get_ptr(), opt_params.scaler);
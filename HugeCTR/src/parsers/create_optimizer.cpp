@@ -112,6 +112,27 @@ OptParams get_optimizer_param(const nlohmann::json& j_optimizer) {
       opt_params = {Optimizer_t::SGD, learning_rate, opt_hyper_params, update_type};
     } break;
 
+    case Optimizer_t::LAMB: {
+      auto j_hparam = get_json(j_optimizer, "lamb_hparam");
+      float learning_rate = get_value_from_json<float>(j_hparam, "learning_rate");
+      opt_hyper_params.lamb.beta1 = get_value_from_json<float>(j_hparam, "beta1");
+      opt_hyper_params.lamb.beta2 = get_value_from_json<float>(j_hparam, "beta2");
+      opt_hyper_params.lamb.epsilon = get_value_from_json<float>(j_hparam, "epsilon");
+      opt_hyper_params.lamb.weight_decay = get_value_from_json<float>(j_hparam, "weight_decay");
+      opt_params = {Optimizer_t::LAMB, learning_rate, opt_hyper_params, update_type};
+    } break;
+
+    case Optimizer_t::LARS: {
+      auto j_hparam = get_json(j_optimizer, "lars_hparam");
+      float learning_rate = get_value_from_json<float>(j_hparam, "learning_rate");
+      opt_hyper_params.lars.momentum = get_value_from_json<float>(j_hparam, "momentum_factor");
+      opt_hyper_params.lars.trust_coefficient =
+          get_value_from_json<float>(j_hparam, "trust_coefficient");
+      opt_hyper_params.lars.epsilon = get_value_from_json<float>(j_hparam, "epsilon");
+      opt_hyper_params.lars.weight_decay = get_value_from_json<float>(j_hparam, "weight_decay");
+      opt_params = {Optimizer_t::LARS, learning_rate, opt_hyper_params, update_type};
+    } break;
+
     default:
       assert(!"Error: no such optimizer && should never get here!");
   }
@@ -88,6 +88,16 @@ std::unique_ptr<LearningRateScheduler> get_learning_rate_scheduler(
       lr = get_value_from_json<float>(j_hparam, "learning_rate");
       break;
 
+    case Optimizer_t::LAMB:
+      j_hparam = get_json(j_optimizer, "lamb_hparam");
+      lr = get_value_from_json<float>(j_hparam, "learning_rate");
+      break;
+
+    case Optimizer_t::LARS:
+      j_hparam = get_json(j_optimizer, "lars_hparam");
+      lr = get_value_from_json<float>(j_hparam, "learning_rate");
+      break;
+
     default:
       assert(!"Error: no such optimizer && should never get here!");
   }
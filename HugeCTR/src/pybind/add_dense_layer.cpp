@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <core23/memory_usage.hpp>
 #include <core23_network.hpp>
 #include <layer.hpp>
 #include <layers/add_layer.hpp>
@@ -23,9 +24,11 @@
 #include <layers/dropout_layer.hpp>
 #include <layers/elementwise_multiply_layer.hpp>
 #include <layers/elu_layer.hpp>
+#include <layers/fused_add_layer_norm_layer.hpp>
 #include <layers/fm_order2_layer.hpp>
 #include <layers/fully_connected_layer.hpp>
 #include <layers/fully_connected_layer_half.hpp>
+#include <layers/fused_elementwise_layer.hpp>
 #include <layers/fused_fully_connected_layer.hpp>
 #include <layers/fused_relu_bias_fully_connected_layer.hpp>
 #include <layers/fused_reshape_concat_general_layer.hpp>
@@ -59,6 +62,7 @@
 #include <regularizers/l1_regularizer.hpp>
 #include <regularizers/l2_regularizer.hpp>
 #include <regularizers/no_regularizer.hpp>
+#include <set>
 #include <unordered_map>
 #ifdef ENABLE_MPI
 #include <mpi.h>
@@ -152,6 +156,10 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
       sparse_hparam_config["hybrid_embedding_type"] =
           HE_TYPE_TO_STRING[sparse_embedding_params[i]
                                 .hybrid_embedding_param.hybrid_embedding_type];
+      sparse_hparam_config["statistics_file"] =
+          sparse_embedding_params[i].hybrid_embedding_param.statistics_file;
+      sparse_hparam_config["recalibration_interval"] =
+          sparse_embedding_params[i].hybrid_embedding_param.recalibration_interval;
     }
     sparse_config["sparse_embedding_hparam"] = sparse_hparam_config;
     nlohmann::json optimizer_config;
@@ -283,6 +291,7 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
       case Layer_t::MultiHeadAttention: {
         layer_config["num_attention_heads"] = dense_layer_params[i].num_attention_heads;
         layer_config["transpose_b"] = dense_layer_params[i].transpose_b;
+        layer_config["recompute_activations"] = dense_layer_params[i].recompute_activations;
         break;
       }
       case Layer_t::FusedInnerProduct: {
@@ -330,6 +339,15 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
         layer_config["mlp_param"] = mlp_param_config;
         break;
       }
+      case Layer_t::GroupedMLP: {
+        nlohmann::json grouped_mlp_param_config;
+        grouped_mlp_param_config["num_outputs"] = dense_layer_params[i].num_outputs;
+        grouped_mlp_param_config["num_experts"] = dense_layer_params[i].num_experts;
+        grouped_mlp_param_config["activation"] =
+            FC_ACTIVATION_TO_STRING[dense_layer_params[i].act_type];
+        layer_config["grouped_mlp_param"] = grouped_mlp_param_config;
+        break;
+      }
       case Layer_t::InnerProduct: {
         nlohmann::json fc_param_config;
         fc_param_config["num_output"] = dense_layer_params[i].num_output;
@@ -445,7 +463,8 @@ void save_graph_to_json(nlohmann::json& layer_config_array,
         }
         break;
       }
-      case Layer_t::BinaryCrossEntropyLoss: {
+      case Layer_t::BinaryCrossEntropyLoss:
+      case Layer_t::InBatchSoftmaxLoss: {
         if (dense_layer_params[i].use_regularizer) {
           layer_config["regularizer"] =
               dense_layer_params[i].regularizer_type == Regularizer_t::L1 ? "L1" : "L2";
@@ -666,6 +685,25 @@ DenseLayer get_dense_layer_from_json(const nlohmann::json& j_dense_layer) {
       dense_layer.num_output = output;
       break;
     }
+    case Layer_t::GroupedMLP: {
+      auto j_grouped_mlp_param = get_json(j_dense_layer, "grouped_mlp_param");
+      std::vector<size_t> num_outputs;
+      auto nums = get_json(j_grouped_mlp_param, "num_outputs");
+      assert(nums.is_array());
+      for (auto num : nums) {
+        num_outputs.emplace_back(num.get<size_t>());
+      }
+      dense_layer.num_outputs = num_outputs;
+      dense_layer.num_experts = get_value_from_json<size_t>(j_grouped_mlp_param, "num_experts");
+      const auto act_name = get_value_from_json<std::string>(j_grouped_mlp_param, "activation");
+      Activation_t act_type;
+      if (find_item_in_map(act_type, act_name, ACTIVATION_TYPE_MAP)) {
+        dense_layer.act_type = act_type;
+      } else {
+        HCTR_OWN_THROW(Error_t::WrongInput, "No such activation: " + act_name);
+      }
+      break;
+    }
     case Layer_t::InnerProduct: {
       auto j_fc_param = get_json(j_dense_layer, "fc_param");
       if (has_key_(j_fc_param, "weight_init")) {
@@ -713,6 +751,9 @@ DenseLayer get_dense_layer_from_json(const nlohmann::json& j_dense_layer) {
       } else {
         dense_layer.transpose_b = false;
       }
+      auto recompute_activations_it = j_dense_layer.find("recompute_activations");
+      dense_layer.recompute_activations = recompute_activations_it != j_dense_layer.end() &&
+                                          recompute_activations_it->get<bool>();
       break;
     }
     case Layer_t::MultiCross: {
@@ -906,7 +947,8 @@ DenseLayer get_dense_layer_from_json(const nlohmann::json& j_dense_layer) {
       }
       break;
     }
-    case Layer_t::BinaryCrossEntropyLoss: {
+    case Layer_t::BinaryCrossEntropyLoss:
+    case Layer_t::InBatchSoftmaxLoss: {
       auto reg_it = j_dense_layer.find("regularizer");
       if (reg_it != j_dense_layer.end()) {
         Regularizer_t reg_type;
@@ -1009,11 +1051,222 @@ static std::shared_ptr<Regularizer<T>> create_regularizer(
   return reg;
 }
 
-void Model::add_dense_layers(std::vector<DenseLayer>& dense_layers) {
+std::vector<DenseLayer> fuse_add_layer_norm_layers(const std::vector<DenseLayer>& dense_layers) {
+  std::map<std::string, int> tensor_usage;
+  std::map<std::string, size_t> producers;
+  for (size_t i = 0; i < dense_layers.size(); i++) {
+    for (auto& bottom_name : dense_layers[i].bottom_names) {
+      tensor_usage[bottom_name]++;
+    }
+    for (auto& top_name : dense_layers[i].top_names) {
+      producers[top_name] = i;
+    }
+  }
+  // The layer of type which computes the tensor if no other layer reads it.
+  auto get_single_use_producer = [&](const std::string& name, Layer_t type) -> const DenseLayer* {
+    auto it = producers.find(name);
+    if (it == producers.end() || tensor_usage[name] != 1 ||
+        dense_layers[it->second].layer_type != type ||
+        dense_layers[it->second].top_names.size() != 1) {
+      return nullptr;
+    }
+    return &dense_layers[it->second];
+  };
+
+  std::set<const DenseLayer*> fused;
+  std::vector<DenseLayer> fused_dense_layers;
+  for (auto& dense_layer : dense_layers) {
+    const DenseLayer* add = nullptr;
+    if (dense_layer.layer_type == Layer_t::LayerNorm) {
+      add = get_single_use_producer(dense_layer.bottom_names[0], Layer_t::Add);
+    }
+    if (!add || add->bottom_names.size() != 2) {
+      fused_dense_layers.push_back(dense_layer);
+      continue;
+    }
+    std::vector<std::string> bottom_names = add->bottom_names;
+    float dropout_rate = 0.f;
+    for (size_t j = 0; j < 2; j++) {
+      if (auto dropout = get_single_use_producer(add->bottom_names[j], Layer_t::Dropout)) {
+        bottom_names = {dropout->bottom_names[0], add->bottom_names[1 - j]};
+        dropout_rate = dropout->dropout_rate;
+        fused.insert(dropout);
+        break;
+      }
+    }
+    fused.insert(add);
+    DenseLayer fused_layer = dense_layer;
+    fused_layer.layer_type = Layer_t::FusedAddLayerNorm;
+    fused_layer.bottom_names = bottom_names;
+    fused_layer.dropout_rate = dropout_rate;
+    HCTR_LOG(INFO, ROOT, "Fuse the residual add%s into the LayerNorm with the output %s\n",
+             dropout_rate > 0.f ? " and dropout" : "", dense_layer.top_names[0].c_str());
+    fused_dense_layers.push_back(fused_layer);
+  }
+  // The Add and Dropout layers come before their LayerNorm, so they are only dropped now.
+  std::vector<DenseLayer> result;
+  for (size_t i = 0; i < dense_layers.size(); i++) {
+    if (!fused.count(&dense_layers[i])) {
+      result.push_back(fused_dense_layers[i]);
+    }
+  }
+  return result;
+}
+
+std::vector<DenseLayer> fuse_elementwise_layers(const std::vector<DenseLayer>& dense_layers,
+                                                bool use_mixed_precision) {
+  const std::set<Layer_t> fusable_layer_types = {Layer_t::Add,     Layer_t::Sub,
+                                                 Layer_t::ElementwiseMultiply, Layer_t::ReLU,
+                                                 Layer_t::Sigmoid, Layer_t::Dropout};
+  const auto& layer_type_to_string =
+      use_mixed_precision ? LAYER_TYPE_TO_STRING_MP : LAYER_TYPE_TO_STRING;
+  auto is_fusable = [&](const DenseLayer& dense_layer) {
+    return fusable_layer_types.count(dense_layer.layer_type) &&
+           layer_type_to_string.count(dense_layer.layer_type) &&
+           dense_layer.top_names.size() == 1;
+  };
+  std::map<std::string, int> tensor_usage;
+  for (auto& dense_layer : dense_layers) {
+    for (auto& bottom_name : dense_layer.bottom_names) {
+      tensor_usage[bottom_name]++;
+    }
+  }
+
+  // Each chain is the list of its layers, and ends up at the position of its last layer.
+  std::vector<std::vector<const DenseLayer*>> chains;
+  std::vector<int> num_chain_inputs;
+  std::map<std::string, size_t> open_chains;
+  for (auto& dense_layer : dense_layers) {
+    if (!is_fusable(dense_layer)) {
+      chains.push_back({&dense_layer});
+      num_chain_inputs.push_back(0);
+      continue;
+    }
+    const int num_inputs = dense_layer.bottom_names.size();
+    auto chain = open_chains.end();
+    for (auto& bottom_name : dense_layer.bottom_names) {
+      auto it = open_chains.find(bottom_name);
+      if (it != open_chains.end() && tensor_usage[bottom_name] == 1 &&
+          chains[it->second].size() < FUSED_ELEMENTWISE_MAX_OPS &&
+          num_chain_inputs[it->second] + num_inputs - 1 <= FUSED_ELEMENTWISE_MAX_INPUTS) {
+        chain = it;
+        break;
+      }
+    }
+    size_t index;
+    if (chain != open_chains.end()) {
+      index = chain->second;
+      open_chains.erase(chain);
+      num_chain_inputs[index] += num_inputs - 1;
+      // The chain moves to the position of its new last layer.
+      chains.push_back(std::move(chains[index]));
+      num_chain_inputs.push_back(num_chain_inputs[index]);
+      chains[index].clear();
+      index = chains.size() - 1;
+      chains[index].push_back(&dense_layer);
+    } else {
+      chains.push_back({&dense_layer});
+      num_chain_inputs.push_back(num_inputs);
+      index = chains.size() - 1;
+    }
+    open_chains[dense_layer.top_names[0]] = index;
+  }
+
+  std::vector<DenseLayer> fused_dense_layers;
+  for (auto& chain : chains) {
+    if (chain.size() == 1) {
+      fused_dense_layers.push_back(*chain[0]);
+    } else if (chain.size() > 1) {
+      std::vector<std::string> bottom_names;
+      for (size_t k = 0; k < chain.size(); k++) {
+        for (auto& bottom_name : chain[k]->bottom_names) {
+          if (k == 0 || bottom_name != chain[k - 1]->top_names[0]) {
+            bottom_names.push_back(bottom_name);
+          }
+        }
+      }
+      std::vector<std::string> top_names = chain.back()->top_names;
+      DenseLayer fused_layer(Layer_t::FusedElementwise, bottom_names, top_names);
+      for (auto dense_layer : chain) {
+        fused_layer.fused_layers.push_back(*dense_layer);
+      }
+      HCTR_LOG(INFO, ROOT, "Fuse %zu elementwise layers into one, with the output %s\n",
+               chain.size(), top_names[0].c_str());
+      fused_dense_layers.push_back(fused_layer);
+    }
+  }
+  return fused_dense_layers;
+}
+
+void plan_activation_lifetimes(const std::vector<DenseLayer>& dense_layers,
+                               const std::vector<TensorEntity>& tensor_entities, bool is_train) {
+  const int64_t num_layers = dense_layers.size();
+  const int64_t last_step = is_train ? 2 * num_layers - 1 : num_layers - 1;
+  std::map<std::string, std::pair<int64_t, int64_t>> lifetimes;
+  std::set<std::string> produced, consumed, pinned;
+  auto use = [&](const std::string& name, int64_t step) {
+    const int64_t bprop_step = is_train ? last_step - step : step;
+    auto it = lifetimes.find(name);
+    if (it == lifetimes.end()) {
+      lifetimes.emplace(name, std::make_pair(step, bprop_step));
+    } else {
+      it->second.first = std::min(it->second.first, step);
+      it->second.second = std::max(it->second.second, bprop_step);
+    }
+  };
+  for (int64_t i = 0; i < num_layers; i++) {
+    const auto& dense_layer = dense_layers[i];
+    const auto layer_type = dense_layer.layer_type;
+    if (layer_type == Layer_t::CrossEntropyLoss || layer_type == Layer_t::BinaryCrossEntropyLoss ||
+        layer_type == Layer_t::MultiCrossEntropyLoss || layer_type == Layer_t::InBatchSoftmaxLoss) {
+      pinned.insert(dense_layer.bottom_names.begin(), dense_layer.bottom_names.end());
+      continue;
+    }
+    for (const auto& bottom_name : dense_layer.bottom_names) {
+      consumed.insert(bottom_name);
+      use(bottom_name, i);
+    }
+    for (const auto& top_name : dense_layer.top_names) {
+      produced.insert(top_name);
+      use(top_name, i);
+    }
+  }
+
+  const auto channel = GetBlobsBufferChannel();
+  size_t num_planned = 0;
+  for (const auto& tensor_entity : tensor_entities) {
+    const auto& name = tensor_entity.name;
+    const auto& tensor = tensor_entity.tensor;
+    auto it = lifetimes.find(name);
+    if (it == lifetimes.end() || tensor.empty() ||
+        tensor.my_params().buffer_params().channel != channel) {
+      continue;
+    }
+    // The inputs of the dense network and its outputs are used outside the layers.
+    if (!produced.count(name) || !consumed.count(name) || pinned.count(name)) {
+      tensor.set_lifetime(0, last_step);
+    } else {
+      tensor.set_lifetime(it->second.first, it->second.second);
+      num_planned++;
+    }
+  }
+  HCTR_LOG(DEBUG, ROOT, "Planned the lifetimes of %zu %s activations\n", num_planned,
+           is_train ? "train" : "evaluate");
+}
+
+void Model::add_dense_layers(std::vector<DenseLayer>& raw_dense_layers) {
+  std::vector<DenseLayer> dense_layers = raw_dense_layers;
+  if (solver_.fuse_add_layer_norm_layers) {
+    dense_layers = fuse_add_layer_norm_layers(dense_layers);
+  }
+  if (solver_.fuse_elementwise_layers) {
+    dense_layers = fuse_elementwise_layers(dense_layers, solver_.use_mixed_precision);
+  }
   for (auto& dense_layer : dense_layers) {
     pre_add_dense_layer(dense_layer);
   }
   auto add_dense_layers_op = [&dense_layers, this](bool is_train) {
+    core23::MemoryTagScope memory_tag_scope(is_train ? "dense" : "dense_eval");
     for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
       std::vector<std::unique_ptr<Layer>> layers;
       std::map<std::string, std::unique_ptr<ILoss>> losses;
@@ -1021,6 +1274,8 @@ void Model::add_dense_layers(std::vector<DenseLayer>& dense_layers) {
       std::vector<Layer*> top_layers;
       std::vector<Layer*> bottom_layers;
       for (auto& dense_layer : dense_layers) {
+        core23::MemoryTagScope layer_memory_tag_scope(
+            dense_layer.top_names.empty() ? "loss" : dense_layer.top_names[0]);
         add_dense_layer_impl(
             dense_layer,
             is_train ? train_tensor_entities_list_[i] : evaluate_tensor_entities_list_[i], layers,
@@ -1030,6 +1285,12 @@ void Model::add_dense_layers(std::vector<DenseLayer>& dense_layers) {
             is_train ? &top_layers : nullptr, is_train ? &bottom_layers : nullptr,
             is_train ? embedding_dependent_ : false, solver_);
       }
+      if (solver_.plan_activation_memory) {
+        plan_activation_lifetimes(
+            dense_layers,
+            is_train ? train_tensor_entities_list_[i] : evaluate_tensor_entities_list_[i],
+            is_train);
+      }
       if (is_train) {
         core23_networks_[i]->set_train_layers(std::move(layers));
         core23_networks_[i]->set_train_losses(std::move(losses), label_weights_);
@@ -1089,7 +1350,8 @@ void calculate_tensor_dimensions(std::map<std::string, std::vector<int>>& tensor
           std::vector<int>{batch_size, 1, max_sequence_len_from, max_sequence_len_to}));
       break;
     }
-    case Layer_t::BinaryCrossEntropyLoss: {
+    case Layer_t::BinaryCrossEntropyLoss:
+    case Layer_t::InBatchSoftmaxLoss: {
       tensor_shape_info_raw.insert(std::make_pair(
           dense_layer.top_names[0], tensor_shape_info_raw[dense_layer.bottom_names[0]]));
       break;
@@ -1148,6 +1410,14 @@ void calculate_tensor_dimensions(std::map<std::string, std::vector<int>>& tensor
       }
       break;
     }
+    case Layer_t::GroupedMLP: {
+      int batch_size = tensor_shape_info_raw[dense_layer.bottom_names[0]][0];
+      int num_experts = dense_layer.num_experts;
+      int num_output = dense_layer.num_outputs.back();
+      tensor_shape_info_raw.insert(std::make_pair(
+          dense_layer.top_names[0], std::vector<int>{batch_size, num_experts, num_output}));
+      break;
+    }
     case Layer_t::FusedInnerProduct: {
       int batch_size = tensor_shape_info_raw[dense_layer.bottom_names[0]][0];
       int num_output = dense_layer.num_output;
@@ -26,13 +26,16 @@
 #include <layers/dropout_layer.hpp>
 #include <layers/elementwise_multiply_layer.hpp>
 #include <layers/elu_layer.hpp>
+#include <layers/fused_add_layer_norm_layer.hpp>
 #include <layers/fm_order2_layer.hpp>
 #include <layers/fully_connected_layer.hpp>
 #include <layers/fully_connected_layer_half.hpp>
+#include <layers/fused_elementwise_layer.hpp>
 #include <layers/fused_fully_connected_layer.hpp>
 #include <layers/fused_relu_bias_fully_connected_layer.hpp>
 #include <layers/fused_reshape_concat_general_layer.hpp>
 #include <layers/fused_reshape_concat_layer.hpp>
+#include <layers/grouped_mlp_layer.hpp>
 #include <layers/gru_layer.hpp>
 #include <layers/interaction_layer.hpp>
 #include <layers/layer_norm_layer.hpp>
@@ -188,6 +191,31 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       }
       break;
     }
+    case Layer_t::FusedAddLayerNorm: {
+      auto& x_tensor = input_output_info.input_tensors[0];
+      auto& residual_tensor = input_output_info.input_tensors[1];
+      core23::Tensor ln_out_tensor(tensor_params.shape(x_tensor.shape()));
+      output_tensor_entities.push_back({input_output_info.output_names[0], ln_out_tensor});
+      std::vector<Initializer_t> initializer_types{dense_layer.gamma_init_type,
+                                                   dense_layer.beta_init_type};
+      // A different dropout seed for each layer and GPU.
+      const uint64_t seed =
+          solver.seed + layers.size() * gpu_count_in_total + gpu_resource->get_global_id();
+      if (use_mixed_precision) {
+        Core23TempFusedAddLayerNormLayer<__half>::Params params = {dense_layer.eps,
+                                                                   dense_layer.dropout_rate};
+        layers.emplace_back(new Core23TempFusedAddLayerNormLayer<__half>(
+            x_tensor, residual_tensor, ln_out_tensor, params, seed, gpu_resource,
+            initializer_types));
+      } else {
+        Core23TempFusedAddLayerNormLayer<float>::Params params = {dense_layer.eps,
+                                                                  dense_layer.dropout_rate};
+        layers.emplace_back(new Core23TempFusedAddLayerNormLayer<float>(
+            x_tensor, residual_tensor, ln_out_tensor, params, seed, gpu_resource,
+            initializer_types));
+      }
+      break;
+    }
     case Layer_t::BinaryCrossEntropyLoss: {
       if (input_output_info.input_tensors.size() != 2) {
         HCTR_OWN_THROW(Error_t::WrongInput, "BinaryCrossEntropyLoss must have two inputs");
@@ -376,12 +404,14 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
         layers.emplace_back(new Core23TempMLPLayer<__half>(
             in_tensors, train_out_tensors, num_outputs, gpu_resource, acts, biases,
             initializer_types, skip_dgrad, dense_layer.compute_config.async_wgrad,
-            dense_layer.compute_config.fuse_wb, enable_tf32_compute));
+            dense_layer.compute_config.fuse_wb, enable_tf32_compute,
+            dense_layer.compute_config.use_fp8));
       } else {
         layers.emplace_back(new Core23TempMLPLayer<float>(
             in_tensors, train_out_tensors, num_outputs, gpu_resource, acts, biases,
             initializer_types, skip_dgrad, dense_layer.compute_config.async_wgrad,
-            dense_layer.compute_config.fuse_wb, enable_tf32_compute));
+            dense_layer.compute_config.fuse_wb, enable_tf32_compute,
+            dense_layer.compute_config.use_fp8));
       }
 
       if (output_size == 1) {
@@ -389,6 +419,27 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       }
       break;
     }
+    case Layer_t::GroupedMLP: {
+      std::vector<Initializer_t> initializer_types{dense_layer.weight_init_type,
+                                                   dense_layer.bias_init_type};
+      auto& in_tensor = input_output_info.input_tensors[0];
+      std::vector<int64_t> num_outputs(dense_layer.num_outputs.begin(),
+                                       dense_layer.num_outputs.end());
+      const int64_t num_experts = dense_layer.num_experts;
+      core23::Tensor out_tensor(
+          tensor_params.shape({in_tensor.shape().size(0), num_experts, num_outputs.back()}));
+      if (use_mixed_precision) {
+        layers.emplace_back(new Core23TempGroupedMLPLayer<__half>(
+            in_tensor, out_tensor, num_experts, num_outputs, dense_layer.act_type, gpu_resource,
+            initializer_types, skip_dgrad, enable_tf32_compute));
+      } else {
+        layers.emplace_back(new Core23TempGroupedMLPLayer<float>(
+            in_tensor, out_tensor, num_experts, num_outputs, dense_layer.act_type, gpu_resource,
+            initializer_types, skip_dgrad, enable_tf32_compute));
+      }
+      output_tensor_entities.push_back({input_output_info.output_names[0], out_tensor});
+      break;
+    }
     case Layer_t::FusedInnerProduct: {
       std::vector<Initializer_t> initializer_types{dense_layer.weight_init_type,
                                                    dense_layer.bias_init_type};
@@ -526,11 +577,11 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       if (use_mixed_precision) {
         layers.emplace_back(new MultiHeadAttentionLayer<__half>(
             in_tensors, out_tensors, num_attention_heads, transpose_b, gpu_resource,
-            use_mixed_precision, enable_tf32_compute));
+            use_mixed_precision, enable_tf32_compute, dense_layer.recompute_activations));
       } else {
         layers.emplace_back(new MultiHeadAttentionLayer<float>(
             in_tensors, out_tensors, num_attention_heads, transpose_b, gpu_resource,
-            use_mixed_precision, enable_tf32_compute));
+            use_mixed_precision, enable_tf32_compute, dense_layer.recompute_activations));
       }
 
       for (size_t i = 0; i < out_tensors.size(); i++) {
@@ -609,6 +660,30 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       }
       break;
     }
+    case Layer_t::InBatchSoftmaxLoss: {
+      if (input_output_info.input_tensors.size() != 2) {
+        HCTR_OWN_THROW(Error_t::WrongInput, "InBatchSoftmaxLoss must have two inputs");
+      }
+
+      auto& input_tensor = input_output_info.input_tensors[0];
+      auto& label_tensor = input_output_info.input_tensors[1];
+      core23::Tensor loss_tensor(tensor_params.shape({1, 1}).data_type(core23::ScalarType::Float));
+
+      std::unique_ptr<ILoss> new_loss;
+      if (use_mixed_precision) {
+        new_loss = create_loss<__half, InBatchSoftmaxLoss>(
+            label_tensor, input_tensor, loss_tensor, dense_layer, layers, gpu_count_in_total,
+            gpu_resource, scaler, solver.gen_loss_summary);
+      } else {
+        new_loss = create_loss<float, InBatchSoftmaxLoss>(
+            label_tensor, input_tensor, loss_tensor, dense_layer, layers, gpu_count_in_total,
+            gpu_resource, scaler, solver.gen_loss_summary);
+      }
+
+      std::string name = dense_layer.bottom_names[1];
+      losses.insert(std::make_pair(name, std::move(new_loss)));
+      break;
+    }
     case Layer_t::MultiCrossEntropyLoss: {
       if (input_output_info.input_tensors.size() != 2) {
         HCTR_OWN_THROW(Error_t::WrongInput, "MultiCrossEntropyLoss must have two inputs");
@@ -838,9 +913,11 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       auto& in_tensor = input_output_info.input_tensors[0];
       int64_t num_output = dense_layer.num_output;
       core23::Tensor gru_out_tensor(tensor_params.shape({in_tensor.shape().size(0), num_output}));
+      // The optional second bottom holds the sequence length of each sample.
       layers.emplace_back(new Core23TempGRULayer<float>(
-          in_tensor, gru_out_tensor, dense_layer.num_output, dense_layer.batchsize,
-          dense_layer.SeqLength, dense_layer.vector_size, gpu_resource, initializer_types));
+          input_output_info.input_tensors, gru_out_tensor, dense_layer.num_output,
+          dense_layer.batchsize, dense_layer.SeqLength, dense_layer.vector_size, gpu_resource,
+          initializer_types, enable_tf32_compute));
       output_tensor_entities.push_back({input_output_info.output_names[0], gru_out_tensor});
       break;
     }
@@ -927,12 +1004,53 @@ void add_dense_layer_impl(DenseLayer& dense_layer, std::vector<TensorEntity>& te
       output_tensor_entities.push_back({input_output_info.output_names[0], out_tensor});
       break;
     }
+    case Layer_t::FusedElementwise: {
+      const std::map<Layer_t, FusedElementwiseOp_t> op_types = {
+          {Layer_t::Add, FusedElementwiseOp_t::Add},
+          {Layer_t::Sub, FusedElementwiseOp_t::Sub},
+          {Layer_t::ElementwiseMultiply, FusedElementwiseOp_t::Multiply},
+          {Layer_t::ReLU, FusedElementwiseOp_t::Relu},
+          {Layer_t::Sigmoid, FusedElementwiseOp_t::Sigmoid},
+          {Layer_t::Dropout, FusedElementwiseOp_t::Dropout}};
+      std::vector<FusedElementwiseOp> ops;
+      int first_input = 0;
+      for (size_t k = 0; k < dense_layer.fused_layers.size(); k++) {
+        const auto& fused_layer = dense_layer.fused_layers[k];
+        FusedElementwiseOp op{op_types.at(fused_layer.layer_type), first_input, 0, -1,
+                              fused_layer.dropout_rate};
+        for (size_t j = 0; j < fused_layer.bottom_names.size(); j++) {
+          if (k > 0 && op.chain_pos < 0 &&
+              fused_layer.bottom_names[j] == dense_layer.fused_layers[k - 1].top_names[0]) {
+            op.chain_pos = j;
+          } else {
+            op.num_inputs++;
+          }
+        }
+        first_input += op.num_inputs;
+        ops.push_back(op);
+      }
+      auto& in_tensors = input_output_info.input_tensors;
+      core23::Tensor out_tensor(tensor_params.shape(in_tensors[0].shape()));
+      // A different dropout seed for each layer and GPU.
+      const uint64_t seed =
+          solver.seed + layers.size() * gpu_count_in_total + gpu_resource->get_global_id();
+      if (use_mixed_precision) {
+        layers.emplace_back(
+            new FusedElementwiseLayer<__half>(in_tensors, out_tensor, ops, seed, gpu_resource));
+      } else {
+        layers.emplace_back(
+            new FusedElementwiseLayer<float>(in_tensors, out_tensor, ops, seed, gpu_resource));
+      }
+      output_tensor_entities.push_back({input_output_info.output_names[0], out_tensor});
+      break;
+    }
     default: {
       assert(!"Error: no such layer && should never get here!");
     }
   }  // end of switch
   if (!(layer_type == Layer_t::CrossEntropyLoss || layer_type == Layer_t::BinaryCrossEntropyLoss ||
-        layer_type == Layer_t::MultiCrossEntropyLoss)) {
+        layer_type == Layer_t::MultiCrossEntropyLoss ||
+        layer_type == Layer_t::InBatchSoftmaxLoss)) {
     for (auto& output_tensor_entity : output_tensor_entities) {
       tensor_entities.push_back(output_tensor_entity);
     }
@@ -22,6 +22,7 @@
 
 #include <data_readers/async_reader/async_reader_adapter.hpp>
 #include <data_readers/data_reader.hpp>
+#include <data_readers/in_memory_data_reader.hpp>
 #include <data_readers/multi_hot/async_data_reader.hpp>
 #include <pybind/model.hpp>
 
@@ -110,7 +111,8 @@ void add_input(Input& input, DataReaderParams& reader_params,
                std::shared_ptr<IDataReader>& evaluate_data_reader,
                std::shared_ptr<IDataReader>& init_data_reader, size_t batch_size,
                size_t batch_size_eval, bool use_mixed_precision, bool repeat_dataset,
-               bool train_intra_iteration_overlap, size_t num_iterations_statistics,
+               bool train_intra_iteration_overlap, bool use_cuda_graph,
+               size_t num_iterations_statistics,
                const std::shared_ptr<ResourceManager> resource_manager) {
   DataReaderType_t format = reader_params.data_reader_type;
   Check_t check_type = reader_params.check_type;
@@ -143,8 +145,22 @@ void add_input(Input& input, DataReaderParams& reader_params,
     sparse_input_map.emplace(sparse_name, sparse_input);
   }
 
-  if ((format == DataReaderType_t::RawAsync)) {
-    if (reader_params.async_param.multi_hot_reader) {
+  if (format == DataReaderType_t::RawAsync || format == DataReaderType_t::InMemory) {
+    if (format == DataReaderType_t::InMemory) {
+      // The queue of each reader holds num_batches_per_thread batches. The sparse values are
+      // staged in fixed buffers for cuda graphs, which capture their addresses.
+      const size_t queue_capacity = reader_params.async_param.num_batches_per_thread;
+      HCTR_LOG_S(INFO, ROOT) << "InMemory data reader: queue_capacity = " << queue_capacity
+                             << ", in-place device values = " << (use_cuda_graph ? "OFF" : "ON")
+                             << std::endl;
+      train_data_reader.reset(new InMemoryDataReader<TypeKey>(
+          resource_manager, batch_size, input.data_reader_sparse_param_array, total_label_dim,
+          dense_dim, use_mixed_precision, queue_capacity, use_cuda_graph));
+      evaluate_data_reader.reset(new InMemoryDataReader<TypeKey>(
+          resource_manager, batch_size_eval, input.data_reader_sparse_param_array,
+          total_label_dim, dense_dim, use_mixed_precision, queue_capacity, use_cuda_graph));
+
+    } else if (reader_params.async_param.multi_hot_reader) {
       bool is_float_dense = reader_params.async_param.is_dense_float;
       int num_threads = reader_params.async_param.num_threads;
       int num_batches_per_thread = reader_params.async_param.num_batches_per_thread;
@@ -169,6 +185,47 @@ void add_input(Input& input, DataReaderParams& reader_params,
                              << std::endl;
       HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: schedule_h2d = "
                              << (schedule_h2d ? "ON" : "OFF") << std::endl;
+      IOBackend_t io_backend = reader_params.async_param.io_backend;
+      HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: io_backend = "
+                             << (io_backend == IOBackend_t::AIO             ? "AIO"
+                                 : io_backend == IOBackend_t::IOUring       ? "IOUring"
+                                 : io_backend == IOBackend_t::IOUringSQPoll ? "IOUringSQPoll"
+                                                                            : "GDS")
+                             << std::endl;
+      int shuffle_window = shuffle ? reader_params.async_param.shuffle_window : 1;
+      HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: shuffle_window = " << shuffle_window
+                             << std::endl;
+
+      MultiHot::ReaderPosition start_position;
+      const std::string& resume_state = reader_params.async_param.resume_state;
+      if (!resume_state.empty()) {
+        const MultiHot::ReaderState state = MultiHot::load_reader_state(resume_state);
+        start_position = MultiHot::resume_position(state, batch_size, shuffle);
+        HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: resuming epoch "
+                               << start_position.epoch << " at batch " << start_position.batch
+                               << " of " << resume_state << std::endl;
+      }
+
+      // The eval reader generates other samples than the train reader.
+      MultiHot::SyntheticSource synthetic_source;
+      synthetic_source.vocabulary_sizes = reader_params.async_param.synthetic_vocabulary_sizes;
+      synthetic_source.alphas = reader_params.async_param.synthetic_alphas;
+      if (synthetic_source.enabled()) {
+        HCTR_CHECK_HINT(resume_state.empty(), "Synthetic data readers cannot resume");
+        HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: generating synthetic data instead "
+                               << "of reading " << source_data << std::endl;
+      }
+
+      // Only the train batches have a token budget, so that evaluations are comparable.
+      MultiHot::TokenBudget token_budget;
+      if (reader_params.async_param.token_budget > 0) {
+        token_budget.max_tokens = reader_params.async_param.token_budget;
+      }
+      token_budget.slots = reader_params.async_param.token_budget_slots;
+      if (token_budget.enabled()) {
+        HCTR_LOG_S(INFO, ROOT) << "Multi-Hot AsyncDataReader: token_budget = "
+                               << token_budget.max_tokens << std::endl;
+      }
 
       MultiHot::FileSource file_source;
       file_source.name = source_data;
@@ -177,13 +234,16 @@ void add_input(Input& input, DataReaderParams& reader_params,
       train_data_reader.reset(new MultiHot::core23_reader::AsyncDataReader<TypeKey>(
           {file_source}, resource_manager, batch_size, num_threads, num_batches_per_thread,
           input.data_reader_sparse_param_array, total_label_dim, dense_dim, use_mixed_precision,
-          shuffle, schedule_h2d, is_float_dense));
+          shuffle, schedule_h2d, is_float_dense, io_backend, shuffle_window, start_position,
+          synthetic_source, token_budget));
 
       file_source.name = eval_source;
+      synthetic_source.seed = 1;
       evaluate_data_reader.reset(new MultiHot::core23_reader::AsyncDataReader<TypeKey>(
           {file_source}, resource_manager, batch_size_eval, num_threads,
           eval_num_batches_per_thread, input.data_reader_sparse_param_array, total_label_dim,
-          dense_dim, use_mixed_precision, false, schedule_h2d, is_float_dense));
+          dense_dim, use_mixed_precision, false, schedule_h2d, is_float_dense, io_backend, 1, {},
+          synthetic_source));
 
     } else {  // use original one-hot async reader
       bool is_float_dense = reader_params.async_param.is_dense_float;
@@ -511,10 +571,10 @@ template void add_input<long long>(Input&, DataReaderParams&,
                                    std::vector<std::vector<TensorEntity>>&,
                                    std::shared_ptr<IDataReader>&, std::shared_ptr<IDataReader>&,
                                    std::shared_ptr<IDataReader>&, size_t, size_t, bool, bool, bool,
-                                   size_t, const std::shared_ptr<ResourceManager>);
+                                   bool, size_t, const std::shared_ptr<ResourceManager>);
 template void add_input<unsigned int>(
     Input&, DataReaderParams&, std::map<std::string, core23_reader::SparseInput<unsigned int>>&,
     std::vector<std::vector<TensorEntity>>&, std::vector<std::vector<TensorEntity>>&,
     std::shared_ptr<IDataReader>&, std::shared_ptr<IDataReader>&, std::shared_ptr<IDataReader>&,
-    size_t, size_t, bool, bool, bool, size_t, const std::shared_ptr<ResourceManager>);
+    size_t, size_t, bool, bool, bool, bool, size_t, const std::shared_ptr<ResourceManager>);
 }  // namespace HugeCTR
@@ -155,6 +155,10 @@ SparseEmbedding get_sparse_embedding_from_json(const nlohmann::json& j_sparse_em
       get_value_from_json_soft<double>(j_hparam, "max_all_to_all_bandwidth", 1.9e11);
   hybrid_embedding_param.efficiency_bandwidth_ratio =
       get_value_from_json_soft<double>(j_hparam, "efficiency_bandwidth_ratio", 1.0);
+  hybrid_embedding_param.statistics_file =
+      get_value_from_json_soft<std::string>(j_hparam, "statistics_file", "");
+  hybrid_embedding_param.recalibration_interval =
+      get_value_from_json_soft<size_t>(j_hparam, "recalibration_interval", 0);
   std::string communication_type_string =
       get_value_from_json_soft<std::string>(j_hparam, "communication_type", "IB_NVLink");
   std::string hybrid_embedding_type_string =
@@ -276,7 +280,9 @@ void add_sparse_embedding(
           sparse_embedding.hybrid_embedding_param.max_all_to_all_bandwidth,  // TBD
           sparse_embedding.hybrid_embedding_param.efficiency_bandwidth_ratio,
           sparse_embedding.hybrid_embedding_param.hybrid_embedding_type,
-          embedding_opt_params};
+          embedding_opt_params,
+          sparse_embedding.hybrid_embedding_param.statistics_file,
+          sparse_embedding.hybrid_embedding_param.recalibration_interval};
       embeddings.emplace_back(new HybridSparseEmbedding<TypeKey, TypeFP>(
           core_helper::convert_sparse_tensors23_to_sparse_tensors<TypeKey>(
               sparse_input.train_sparse_tensors),
@@ -19,23 +19,46 @@
 #include <algorithm>
 #include <core/hctr_impl/hctr_backend.hpp>
 #include <core23/logger.hpp>
+#include <core23/memory_usage.hpp>
 #include <core23/mpi_init_service.hpp>
+#include <core23/scratch_arena.hpp>
 #include <core23_helper.hpp>
 #include <core23_network.hpp>
 #include <data_readers/async_reader/async_reader_adapter.hpp>
+#include <data_readers/in_memory_data_reader.hpp>
 #include <data_readers/multi_hot/async_data_reader.hpp>
 #include <embeddings/hybrid_sparse_embedding.hpp>
 #include <fstream>
+#include <gemm_algorithm_cache.hpp>
+#include <hps/mapped_sparse_model.hpp>
 #include <iomanip>
+#include <io/compressed_file.hpp>
+#include <io/io_utils.hpp>
 #include <iterator>
+#include <limits>
 #include <network_buffer_channels.hpp>
+#include <optional>
 #include <pybind/model.hpp>
 #include <resource_managers/resource_manager_ext.hpp>
+#include <set>
 #include <sstream>
+#include <timeline.hpp>
+#include <unordered_set>
 using namespace HugeCTR::MultiHot;
 
 namespace HugeCTR {
 
+void accumulate_wgrad_gpu(size_t grid, size_t block, float* accumulator, const void* wgrad,
+                          size_t count, bool first, bool half, cudaStream_t stream);
+void average_accumulated_wgrad_gpu(size_t grid, size_t block, void* wgrad,
+                                   const float* accumulator, size_t count, float scale, bool half,
+                                   cudaStream_t stream);
+void unscale_and_check_gpu(size_t grid, size_t block, void* grad, size_t count,
+                           const float* loss_scale, float scaler, int* overflow,
+                           bool zero_non_finite, bool half, cudaStream_t stream);
+void update_loss_scale_gpu(float* loss_scale, int* state, int growth_interval,
+                           cudaStream_t stream);
+
 namespace {
 
 /**
@@ -115,6 +138,15 @@ static void check_device(int device_id, int min_major, int min_minor) {
   return;
 }
 
+// The layer-wise optimizers need the weights of a whole layer, while embeddings update rows.
+static void check_embedding_optimizer(Optimizer_t optimizer) {
+  if (optimizer == Optimizer_t::LAMB || optimizer == Optimizer_t::LARS) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "LAMB and LARS are only available to the dense layers, please specify another "
+                   "optimizer for the embedding");
+  }
+}
+
 template <typename TypeKey>
 auto load_key_files(std::vector<std::string> const& key_files) {
   std::vector<TypeKey> keys_vec;
@@ -134,24 +166,48 @@ auto load_key_files(std::vector<std::string> const& key_files) {
   return keys_vec;
 }
 
+// Reads the keys of a static vocabulary in the order of the file, without duplicates.
+template <typename TypeKey>
+std::vector<int64_t> load_vocabulary_file(std::string const& keyset_file) {
+  std::ifstream key_fs(keyset_file, std::ifstream::binary);
+  if (!key_fs.is_open()) {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Cannot open the file: " + keyset_file);
+  }
+  std::vector<TypeKey> file_keys(std::filesystem::file_size(keyset_file) / sizeof(TypeKey));
+  key_fs.read(reinterpret_cast<char*>(file_keys.data()), file_keys.size() * sizeof(TypeKey));
+  HCTR_CHECK_HINT(!file_keys.empty(), "static_vocabulary error, ", keyset_file, " is empty.\n");
+
+  std::vector<int64_t> keys;
+  keys.reserve(file_keys.size());
+  std::unordered_set<TypeKey> seen_keys(file_keys.size());
+  for (TypeKey key : file_keys) {
+    if (seen_keys.insert(key).second) keys.push_back(key);
+  }
+  return keys;
+}
+
 }  // end namespace
 
 EmbeddingTrainingCacheParams::EmbeddingTrainingCacheParams(
     std::vector<TrainPSType_t>& _ps_types, std::vector<std::string>& _sparse_models,
-    std::vector<std::string>& _local_paths, std::vector<HMemCacheConfig>& _hmem_cache_configs)
+    std::vector<std::string>& _local_paths, std::vector<HMemCacheConfig>& _hmem_cache_configs,
+    bool _prefetch_next_pass, const WritebackConfig& _writeback_config)
     : use_embedding_training_cache(true),
       ps_types(_ps_types),
       sparse_models(_sparse_models),
       local_paths(_local_paths),
-      hmem_cache_configs(_hmem_cache_configs) {}
+      hmem_cache_configs(_hmem_cache_configs),
+      prefetch_next_pass(_prefetch_next_pass),
+      writeback_config(_writeback_config) {}
 
 EmbeddingTrainingCacheParams::EmbeddingTrainingCacheParams()
-    : use_embedding_training_cache(false) {}
+    : use_embedding_training_cache(false), prefetch_next_pass(false) {}
 
-DenseLayerComputeConfig::DenseLayerComputeConfig() : async_wgrad(false), fuse_wb(false){};
+DenseLayerComputeConfig::DenseLayerComputeConfig()
+    : async_wgrad(false), fuse_wb(false), use_fp8(false){};
 
-DenseLayerComputeConfig::DenseLayerComputeConfig(bool async_wgrad, bool fuse_wb)
-    : async_wgrad(async_wgrad), fuse_wb(fuse_wb){};
+DenseLayerComputeConfig::DenseLayerComputeConfig(bool async_wgrad, bool fuse_wb, bool use_fp8)
+    : async_wgrad(async_wgrad), fuse_wb(fuse_wb), use_fp8(use_fp8){};
 
 DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type,
                                    std::vector<std::string> source, std::vector<std::string> keyset,
@@ -296,7 +352,7 @@ DenseLayer::DenseLayer(
     Activation_t act_type, std::vector<size_t> num_outputs, bool use_bias,
     std::vector<Activation_t> acts, std::vector<bool> biases,
     DenseLayerComputeConfig compute_config, const std::vector<int64_t>& reshape_out_dimension,
-    int dim, const std::vector<int64_t>& index)
+    int dim, const std::vector<int64_t>& index, bool recompute_activations)
     : layer_type(layer_type),
       bottom_names(bottom_names),
       top_names(top_names),
@@ -327,6 +383,7 @@ DenseLayer::DenseLayer(
       max_sequence_len_to(max_sequence_len_to),
       num_attention_heads(num_attention_heads),
       transpose_b(transpose_b),
+      recompute_activations(recompute_activations),
       target_weight_vec(target_weight_vec),
       use_regularizer(use_regularizer),
       regularizer_type(regularizer_type),
@@ -345,13 +402,25 @@ DenseLayer::DenseLayer(
 GroupDenseLayer::GroupDenseLayer(GroupLayer_t group_layer_type,
                                  std::vector<std::string>& bottom_name_list,
                                  std::vector<std::string>& top_name_list,
-                                 std::vector<size_t>& num_outputs, Activation_t last_act_type)
+                                 std::vector<size_t>& num_outputs, Activation_t last_act_type,
+                                 size_t num_experts)
     : group_layer_type(group_layer_type),
       bottom_name_list(bottom_name_list),
       top_name_list(top_name_list),
       num_outputs(num_outputs),
-      last_act_type(last_act_type) {
+      last_act_type(last_act_type),
+      num_experts(num_experts) {
   size_t num_layers = num_outputs.size();
+  if (group_layer_type == GroupLayer_t::GroupExpertMLP) {
+    if (num_layers < 1 || num_experts < 1) {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "There should be at least one layer and one expert for GroupExpertMLP");
+    }
+    if (bottom_name_list.size() != 1 || top_name_list.size() != 1) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "GroupExpertMLP has exactly one bottom and one top");
+    }
+    return;
+  }
   if (num_layers < 2) {
     HCTR_OWN_THROW(Error_t::WrongInput, "There should be at least two layers for GroupDenseLayer");
   }
@@ -373,12 +442,16 @@ void init_optimizer_params(OptParams& opt_params, const Solver& solver,
   opt_params.hyperparams.adam.beta1 = opt_params_py->hyperparams.adam.beta1;
   opt_params.hyperparams.adam.beta2 = opt_params_py->hyperparams.adam.beta2;
   opt_params.hyperparams.adam.epsilon = opt_params_py->hyperparams.adam.epsilon;
+  opt_params.hyperparams.adam.half_state = opt_params_py->hyperparams.adam.half_state;
   opt_params.hyperparams.adagrad.initial_accu_value =
       opt_params_py->hyperparams.adagrad.initial_accu_value;
   opt_params.hyperparams.adagrad.epsilon = opt_params_py->hyperparams.adagrad.epsilon;
+  opt_params.hyperparams.adagrad.row_wise = opt_params_py->hyperparams.adagrad.row_wise;
   opt_params.hyperparams.momentum.factor = opt_params_py->hyperparams.momentum.factor;
   opt_params.hyperparams.nesterov.mu = opt_params_py->hyperparams.nesterov.mu;
   opt_params.hyperparams.sgd.atomic_update = opt_params_py->hyperparams.sgd.atomic_update;
+  opt_params.hyperparams.lamb = opt_params_py->hyperparams.lamb;
+  opt_params.hyperparams.lars = opt_params_py->hyperparams.lars;
 }
 
 void init_learning_rate_scheduler(std::shared_ptr<LearningRateScheduler>& lr_sch,
@@ -399,7 +472,17 @@ void init_exchange_wgrad(const std::shared_ptr<ResourceManager>& resource_manage
   HCTR_LOG(INFO, ROOT, "Using All-reduce algorithm: %s\n",
            ALLREDUCE_ALGO_TO_STRING[solver.all_reduce_algo].c_str());
   resource_manager->set_ar_comm(solver.all_reduce_algo, solver.use_mixed_precision);
+  const bool compressed = solver.dense_wgrad_compression != WgradCompression_t::Disabled;
+  if (solver.shard_dense_optimizer && (solver.grouped_all_reduce || compressed)) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "shard_dense_optimizer requires grouped_all_reduce to be False and "
+                   "dense_wgrad_compression to be Disabled");
+  }
   if (solver.grouped_all_reduce) {
+    if (solver.dense_wgrad_compression != WgradCompression_t::Disabled) {
+      HCTR_LOG_S(WARNING, ROOT) << "The wgrad isn't compressed with grouped_all_reduce"
+                                << std::endl;
+    }
     if (solver.use_mixed_precision) {
       exchange_wgrad = std::make_shared<GroupedExchangeWgrad<__half>>(resource_manager);
     } else {
@@ -407,9 +490,11 @@ void init_exchange_wgrad(const std::shared_ptr<ResourceManager>& resource_manage
     }
   } else {
     if (solver.use_mixed_precision) {
-      exchange_wgrad = std::make_shared<NetworkExchangeWgrad<__half>>(resource_manager);
+      exchange_wgrad = std::make_shared<NetworkExchangeWgrad<__half>>(
+          resource_manager, solver.dense_wgrad_compression);
     } else {
-      exchange_wgrad = std::make_shared<NetworkExchangeWgrad<float>>(resource_manager);
+      exchange_wgrad = std::make_shared<NetworkExchangeWgrad<float>>(
+          resource_manager, solver.dense_wgrad_compression);
     }
   }
 }
@@ -443,6 +528,9 @@ Model::Model(const Solver& solver, const DataReaderParams& reader_params,
     HCTR_LOG(INFO, ROOT, "Initialize model: %s\n", solver_.model_name.c_str());
   }
   resource_manager_ = ResourceManagerExt::create(solver.vvgpu, solver.seed, solver.device_layout);
+  Timeline::get().set_rank(resource_manager_->get_process_id());
+  step_timer_ = std::make_unique<StepTimer>(resource_manager_, solver_.step_time_report_interval,
+                                            solver_.straggler_threshold);
 
   embedding_para_io_ = std::shared_ptr<embedding::EmbeddingParameterIO>(
       new embedding::EmbeddingParameterIO(resource_manager_));
@@ -464,6 +552,9 @@ Model::Model(const Solver& solver, const DataReaderParams& reader_params,
   if (etc_params_->use_embedding_training_cache && solver_.kafka_brokers.length()) {
     KafkaMessageSinkParams params;
     params.brokers = solver_.kafka_brokers;
+    params.columnar_format = solver_.kafka_columnar_format;
+    params.value_encoding = solver_.kafka_value_encoding;
+    params.compression_codec = solver_.kafka_compression_codec;
     message_sink_ = std::make_shared<KafkaMessageSink<long long>>(params);
   }
   if (etc_params_->use_embedding_training_cache && solver_.repeat_dataset) {
@@ -494,6 +585,10 @@ Model::Model(const Solver& solver, const DataReaderParams& reader_params,
 }
 
 Model::~Model() {
+  wait_for_snapshot_();
+  if (snapshot_staging_) {
+    HCTR_LIB_CHECK_(cudaFreeHost(snapshot_staging_));
+  }
   for (auto device : resource_manager_->get_local_gpu_device_id_list()) {
     CudaDeviceContext context(device);
     HCTR_LIB_CHECK_(cudaDeviceSynchronize());
@@ -600,6 +695,12 @@ void Model::add(Input& input) {
                                 });
   }
 
+  if (reader_params_.data_reader_type == DataReaderType_t::InMemory &&
+      !solver_.use_embedding_collection) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "The InMemory data reader requires the embedding collection");
+  }
+
   input_params_.push_back(input);
   activate_tensor(tensor_active_, label_name);
   activate_tensor(tensor_active_, input.dense_name);
@@ -645,20 +746,22 @@ void Model::add(Input& input) {
   for (unsigned int i = 0; i < input.data_reader_sparse_param_array.size(); i++) {
     activate_tensor(tensor_active_, input.data_reader_sparse_param_array[i].top_name);
   }
+  core23::MemoryTagScope memory_tag_scope("data_reader");
   if (solver_.i64_input_key) {
     add_input<long long>(input, reader_params_, sparse_input_map_64_, train_tensor_entities_list_,
                          evaluate_tensor_entities_list_, train_data_reader_, evaluate_data_reader_,
                          init_data_reader_, solver_.batchsize, solver_.batchsize_eval,
                          solver_.use_mixed_precision, solver_.repeat_dataset,
-                         solver_.train_intra_iteration_overlap, solver_.num_iterations_statistics,
-                         resource_manager_);
+                         solver_.train_intra_iteration_overlap, solver_.use_cuda_graph,
+                         solver_.num_iterations_statistics, resource_manager_);
   } else {
     add_input<unsigned int>(input, reader_params_, sparse_input_map_32_,
                             train_tensor_entities_list_, evaluate_tensor_entities_list_,
                             train_data_reader_, evaluate_data_reader_, init_data_reader_,
                             solver_.batchsize, solver_.batchsize_eval, solver_.use_mixed_precision,
                             solver_.repeat_dataset, solver_.train_intra_iteration_overlap,
-                            solver_.num_iterations_statistics, resource_manager_);
+                            solver_.use_cuda_graph, solver_.num_iterations_statistics,
+                            resource_manager_);
   }
 
   if (solver_.use_embedding_collection and solver_.train_inter_iteration_overlap) {
@@ -729,6 +832,8 @@ void Model::add(SparseEmbedding& sparse_embedding) {
 
   embedding_opt_params_list_.push_back(sparse_embedding.embedding_opt_params);
   init_optimizer_params(embedding_opt_params, solver_, sparse_embedding.embedding_opt_params);
+  check_embedding_optimizer(embedding_opt_params.optimizer);
+  core23::MemoryTagScope memory_tag_scope("embedding/" + sparse_embedding.sparse_embedding_name);
   if (solver_.i64_input_key && !solver_.use_mixed_precision) {
     add_sparse_embedding<long long, float>(
         sparse_embedding, sparse_input_map_64_, train_tensor_entities_list_,
@@ -897,16 +1002,25 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
       solver_.use_mixed_precision ? core23::ScalarType::Half : core23::ScalarType::Float;
   core23::DataType wgrad_type =
       solver_.use_mixed_precision ? core23::ScalarType::Half : core23::ScalarType::Float;
-  embedding::EmbeddingLayout input_layout_ =
-      reader_params_.data_reader_type == DataReaderType_t::RawAsync
-          ? embedding::EmbeddingLayout::FeatureMajor
-          : embedding::EmbeddingLayout::BatchMajor;
+  embedding::EmbeddingLayout input_layout_ = is_scheduled_datareader()
+                                                 ? embedding::EmbeddingLayout::FeatureMajor
+                                                 : embedding::EmbeddingLayout::BatchMajor;
 
   std::vector<std::string> bottom_name_list;
   for (int lookup_id = 0; lookup_id < num_lookup; ++lookup_id) {
     auto bottom_name = ebc_config.bottom_names_[lookup_id];
     bottom_name_list.push_back(bottom_name);
   }
+  // The lookups of virtual features read the input features by name, so the collection takes all
+  // input features of the data reader.
+  std::vector<std::string> input_feature_names;
+  if (!ebc_config.virtual_features_.empty()) {
+    HCTR_CHECK_HINT(!input_params_.empty(), "Virtual features require an Input.\n");
+    for (const auto &p : input_params_.back().data_reader_sparse_param_array) {
+      input_feature_names.push_back(p.top_name);
+    }
+    bottom_name_list = input_feature_names;
+  }
 
   std::string bottom_name = join(bottom_name_list, ",");
   deactivate_tensor(tensor_active_, bottom_name);
@@ -918,11 +1032,76 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
     auto b_name = ebc_config.bottom_names_[lookup_id];
     lookup_params[lookup_id].max_hotness = hotness_map_[b_name];
   }
-
-  auto shard_matrix = create_shard_matrix_from_ebc_config(table_name_to_id_dict, ebc_config);
-
-  auto grouped_emb_params =
-      create_grouped_embedding_param_from_ebc_config(table_name_to_id_dict, ebc_config);
+  std::vector<int> lookup_input_feature_ids;
+  std::vector<embedding::VirtualFeatureParam> virtual_features;
+  auto find_input_feature = [&](const std::string &name) {
+    auto it = std::find(input_feature_names.begin(), input_feature_names.end(), name);
+    HCTR_CHECK_HINT(it != input_feature_names.end(), "No such input feature: ", name, "\n");
+    return static_cast<int>(it - input_feature_names.begin());
+  };
+  for (int lookup_id = 0; lookup_id < num_lookup && !input_feature_names.empty(); ++lookup_id) {
+    const auto &b_name = ebc_config.bottom_names_[lookup_id];
+    auto it = ebc_config.virtual_features_.find(b_name);
+    if (it == ebc_config.virtual_features_.end()) {
+      lookup_input_feature_ids.push_back(find_input_feature(b_name));
+      continue;
+    }
+    const auto &feature_config = it->second;
+    embedding::VirtualFeatureParam feature{lookup_id,
+                                           {},
+                                           {},
+                                           feature_config.hash_function,
+                                           static_cast<uint64_t>(feature_config.num_buckets),
+                                           static_cast<uint64_t>(feature_config.seed)};
+    int hotness = 1;
+    for (const auto &name : feature_config.bottom_names) {
+      feature.input_feature_ids.push_back(find_input_feature(name));
+      feature.input_hotness.push_back(hotness_map_.at(name));
+      hotness *= hotness_map_.at(name);
+    }
+    lookup_params[lookup_id].max_hotness = hotness;
+    lookup_input_feature_ids.push_back(-1);
+    virtual_features.push_back(feature);
+
+    // The keys of static tables are rows, unless they are remapped by a static vocabulary.
+    const auto &table_name = ebc_config.lookup_configs_[lookup_id].first;
+    const int64_t max_vocabulary_size =
+        ebc_config.emb_table_config_list_[table_name_to_id_dict.at(table_name)]
+            .table_param.max_vocabulary_size;
+    HCTR_CHECK_HINT(
+        max_vocabulary_size < 0 || ebc_config.static_vocabulary_files_.count(table_name) ||
+            (feature_config.num_buckets > 0 && feature_config.num_buckets <= max_vocabulary_size),
+        "The num_buckets of ", b_name, " must be in [1, ", max_vocabulary_size,
+        "], the max_vocabulary_size of ", table_name, ".\n");
+  }
+
+  // The keys of static tables are rows, so that 64-bit input keys of small tables fit in 32 bits.
+  const bool narrow_input_keys = ebc_config.use_32bit_keys_ && solver_.i64_input_key;
+  if (narrow_input_keys) {
+    HCTR_CHECK_HINT(input_layout_ == embedding::EmbeddingLayout::FeatureMajor,
+                    "use_32bit_keys error, requires the RawAsync or InMemory data reader.\n");
+    HCTR_CHECK_HINT(
+        ebc_config.keys_preprocess_strategy_ == embedding::KeysPreprocessStrategy::AddOffset,
+        "use_32bit_keys error, all tables must have a max_vocabulary_size.\n");
+    HCTR_CHECK_HINT(ebc_config.static_vocabulary_files_.empty(),
+                    "use_32bit_keys error, can't be combined with static_vocabulary.\n");
+    int64_t total_vocabulary_size = 0;
+    for (const auto &table_config : ebc_config.emb_table_config_list_) {
+      total_vocabulary_size += table_config.table_param.max_vocabulary_size;
+    }
+    int64_t total_hotness = 0;
+    for (const auto &lookup_param : lookup_params) {
+      total_hotness += lookup_param.max_hotness;
+    }
+    const int64_t max_batch_size = std::max(solver_.batchsize, solver_.batchsize_eval);
+    HCTR_CHECK_HINT(total_vocabulary_size <= std::numeric_limits<uint32_t>::max() &&
+                        max_batch_size * total_hotness <= std::numeric_limits<uint32_t>::max(),
+                    "use_32bit_keys error, the ", total_vocabulary_size, " rows or the ",
+                    max_batch_size * total_hotness, " keys of a batch exceed 32 bits.\n");
+    key_type = core23::ScalarType::UInt32;
+    index_type = core23::ScalarType::UInt32;
+    offset_type = core23::ScalarType::UInt32;
+  }
 
   int num_table = ebc_config.emb_table_config_list_.size();
   auto emb_table_list = create_table_params_from_ebc_config(table_name_to_id_dict, ebc_config);
@@ -930,6 +1109,7 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
     if (p.opt_param.optimizer == Optimizer_t::NOT_INITIALIZED) {
       p.opt_param = opt_params_;
     }
+    check_embedding_optimizer(p.opt_param.optimizer);
   }
 
   embedding::AllreduceStrategy allreduce_strategy = ebc_config.allreduce_strategy_;
@@ -942,6 +1122,27 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
     }
   }
 
+  std::vector<std::vector<int>> shard_matrix;
+  std::vector<embedding::GroupedTableParam> grouped_emb_params;
+  if (ebc_config.shard_planner_params_) {
+    HCTR_CHECK_HINT(num_total_gpus % resource_manager_->get_num_process() == 0,
+                    "Automatic sharding requires the same number of GPUs in each process.\n");
+    auto plan = plan_shards(*ebc_config.shard_planner_params_, table_name_to_id_dict,
+                            emb_table_list, lookup_params, solver_.batchsize,
+                            resource_manager_->get_num_process(),
+                            num_total_gpus / resource_manager_->get_num_process(),
+                            emb_type.size(), allreduce_strategy,
+                            ebc_config.table_storage_type_ == embedding::TableStorageType::FP16
+                                ? sizeof(__half)
+                                : sizeof(float));
+    shard_matrix = std::move(plan.shard_matrix);
+    grouped_emb_params = std::move(plan.grouped_table_params);
+  } else {
+    shard_matrix = create_shard_matrix_from_ebc_config(table_name_to_id_dict, ebc_config);
+    grouped_emb_params =
+        create_grouped_embedding_param_from_ebc_config(table_name_to_id_dict, ebc_config);
+  }
+
   embedding::EmbeddingCollectionParam ebc_param{num_table,
                                                 num_lookup,
                                                 lookup_params,
@@ -977,6 +1178,93 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
                                                      ebc_config.keys_preprocess_strategy_,
                                                      ebc_config.allreduce_strategy_,
                                                      ebc_config.comm_strategy_};
+  ebc_param.comm_quantization_strategy_ = ebc_config.comm_quantization_strategy_;
+  eval_ebc_param.comm_quantization_strategy_ = ebc_config.comm_quantization_strategy_;
+  ebc_param.table_storage_type_ = ebc_config.table_storage_type_;
+  eval_ebc_param.table_storage_type_ = ebc_config.table_storage_type_;
+  ebc_param.use_p2p_all2all_ = ebc_config.use_p2p_all2all_;
+  eval_ebc_param.use_p2p_all2all_ = ebc_config.use_p2p_all2all_;
+  if (!ebc_config.frequent_keys_.empty()) {
+    embedding::SparseFrequentKeysData frequent_keys_data;
+    for (const auto &[name, keys] : ebc_config.frequent_keys_) {
+      HCTR_CHECK_HINT(table_name_to_id_dict.find(name) != table_name_to_id_dict.end(),
+                      "replicate_frequent_keys error, no such table: ", name, "\n");
+      frequent_keys_data.table_ids.push_back(table_name_to_id_dict.at(name));
+    }
+    std::sort(frequent_keys_data.table_ids.begin(), frequent_keys_data.table_ids.end());
+    for (int table_id : frequent_keys_data.table_ids) {
+      const auto it = std::find_if(
+          table_name_to_id_dict.begin(), table_name_to_id_dict.end(),
+          [table_id](const auto &name_and_id) { return name_and_id.second == table_id; });
+      std::vector<int64_t> keys = ebc_config.frequent_keys_.at(it->first);
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+      frequent_keys_data.h_frequent_keys.push_back(std::move(keys));
+    }
+    ebc_param.init_sparse_frequent_keys(frequent_keys_data);
+    eval_ebc_param.init_sparse_frequent_keys(frequent_keys_data);
+  }
+  if (!ebc_config.unique_key_tables_.empty()) {
+    std::vector<int> unique_table_ids;
+    for (const auto &name : ebc_config.unique_key_tables_) {
+      HCTR_CHECK_HINT(table_name_to_id_dict.find(name) != table_name_to_id_dict.end(),
+                      "deduplicate_keys error, no such table: ", name, "\n");
+      unique_table_ids.push_back(table_name_to_id_dict.at(name));
+    }
+    ebc_param.init_unique_pooled_keys(unique_table_ids);
+    eval_ebc_param.init_unique_pooled_keys(unique_table_ids);
+  }
+  if (!ebc_config.deterministic_tables_.empty()) {
+    std::vector<int> deterministic_table_ids;
+    for (const auto &name : ebc_config.deterministic_tables_) {
+      HCTR_CHECK_HINT(table_name_to_id_dict.find(name) != table_name_to_id_dict.end(),
+                      "deterministic_reduction error, no such table: ", name, "\n");
+      deterministic_table_ids.push_back(table_name_to_id_dict.at(name));
+    }
+    ebc_param.init_deterministic_tables(deterministic_table_ids);
+    eval_ebc_param.init_deterministic_tables(deterministic_table_ids);
+  }
+  if (ebc_config.num_lookup_streams_ > 1) {
+    std::map<int, int> table_id_to_stream_priority;
+    for (const auto &[name, priority] : ebc_config.stream_priorities_) {
+      HCTR_CHECK_HINT(table_name_to_id_dict.find(name) != table_name_to_id_dict.end(),
+                      "lookup_streams error, no such table: ", name, "\n");
+      table_id_to_stream_priority[table_name_to_id_dict.at(name)] = priority;
+    }
+    ebc_param.init_lookup_streams(ebc_config.num_lookup_streams_, table_id_to_stream_priority);
+    eval_ebc_param.init_lookup_streams(ebc_config.num_lookup_streams_,
+                                       table_id_to_stream_priority);
+  }
+  for (const auto &[name, keyset_file] : ebc_config.static_vocabulary_files_) {
+    HCTR_CHECK_HINT(table_name_to_id_dict.find(name) != table_name_to_id_dict.end(),
+                    "static_vocabulary error, no such table: ", name, "\n");
+    HCTR_CHECK_HINT(input_layout_ == embedding::EmbeddingLayout::FeatureMajor,
+                    "static_vocabulary error, requires the RawAsync or InMemory data reader.\n");
+    int table_id = table_name_to_id_dict.at(name);
+    HCTR_CHECK_HINT(ebc_param.get_frequent_table_index(table_id) < 0, "static_vocabulary error, ",
+                    name, " can't have frequent keys.\n");
+    auto keys = std::make_shared<const std::vector<int64_t>>(
+        solver_.i64_input_key ? load_vocabulary_file<long long>(keyset_file)
+                              : load_vocabulary_file<unsigned int>(keyset_file));
+    // The last row holds all keys outside of the vocabulary.
+    const int64_t max_vocabulary_size = emb_table_list[table_id].max_vocabulary_size;
+    HCTR_CHECK_HINT(max_vocabulary_size > static_cast<int64_t>(keys->size()),
+                    "static_vocabulary error, the max_vocabulary_size of ", name,
+                    " must exceed the ", keys->size(), " keys of its vocabulary.\n");
+    ebc_param.static_vocabularies_[table_id] = keys;
+    eval_ebc_param.static_vocabularies_[table_id] = keys;
+  }
+  if (!virtual_features.empty()) {
+    HCTR_CHECK_HINT(input_layout_ == embedding::EmbeddingLayout::FeatureMajor,
+                    "Virtual features require the RawAsync or InMemory data reader.\n");
+    for (auto *param : {&ebc_param, &eval_ebc_param}) {
+      param->num_input_features_ = static_cast<int>(input_feature_names.size());
+      param->lookup_input_feature_ids_ = lookup_input_feature_ids;
+      param->virtual_features_ = virtual_features;
+    }
+  }
+  ebc_param.narrow_input_keys_ = narrow_input_keys;
+  eval_ebc_param.narrow_input_keys_ = narrow_input_keys;
 
   std::vector<std::shared_ptr<core::CoreResourceManager>> core_list;
 
@@ -985,8 +1273,12 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
         std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager_, local_gpu_id);
     core_list.push_back(core_resource_manager);
   }
-  ebc_list_.push_back(std::make_unique<embedding::EmbeddingCollection>(
-      resource_manager_, core_list, ebc_param, eval_ebc_param, emb_table_list, exchange_wgrad_));
+  {
+    core23::MemoryTagScope memory_tag_scope("embedding_collection/" +
+                                            std::to_string(global_ebc_id));
+    ebc_list_.push_back(std::make_unique<embedding::EmbeddingCollection>(
+        resource_manager_, core_list, ebc_param, eval_ebc_param, emb_table_list, exchange_wgrad_));
+  }
   embedding_para_io_->add_embedding_collection((ebc_list_[ebc_list_.size() - 1]).get());
 
   auto prepare_ebc_input = [&](auto& sparse_input_map, bool is_longlong) {
@@ -1029,7 +1321,7 @@ void Model::add(const EmbeddingCollectionConfig& ebc_config) {
     }
   };
 
-  if (reader_params_.data_reader_type != DataReaderType_t::RawAsync) {
+  if (!is_scheduled_datareader()) {
     if (solver_.i64_input_key) {
       prepare_ebc_input(sparse_input_map_64_, true);
     } else {
@@ -1204,6 +1496,15 @@ void Model::add(GroupDenseLayer& group_dense_layer) {
       }
       break;
     }
+    case GroupLayer_t::GroupExpertMLP: {
+      DenseLayer grouped_mlp_layer = DenseLayer(
+          Layer_t::GroupedMLP, group_dense_layer.bottom_name_list, group_dense_layer.top_name_list);
+      grouped_mlp_layer.num_outputs = group_dense_layer.num_outputs;
+      grouped_mlp_layer.act_type = group_dense_layer.last_act_type;
+      grouped_mlp_layer.num_experts = group_dense_layer.num_experts;
+      add(grouped_mlp_layer);
+      break;
+    }
     default: {
       assert(!"Error: no such group layer && should never get here!");
     }
@@ -1426,7 +1727,8 @@ void Model::load_sparse_weights(
   }
 }
 
-void Model::embedding_load(const std::string& path, const std::vector<std::string>& table_names) {
+void Model::embedding_load(const std::string& path, const std::vector<std::string>& table_names,
+                           int num_threads) {
   TableNameToGlobalIDDict table_id_map;
   if (!table_names.empty()) {
     check_table_name_correct(ebc_name_to_global_id_dict_, table_names);
@@ -1439,98 +1741,21 @@ void Model::embedding_load(const std::string& path, const std::vector<std::strin
     }
   }
 
-  int num_total_gpus = resource_manager_->get_global_gpu_count();
-  int num_local_gpus = resource_manager_->get_local_gpu_count();
-  std::vector<std::shared_ptr<core::CoreResourceManager>> core_list;
-
-  for (int local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
-    auto core_resource_manager =
-        std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager_, local_gpu_id);
-    core_list.push_back(core_resource_manager);
-  }
-
   for (auto& [name, ids] : table_id_map) {
     int embedding_collection_id = ids.first;
     int file_table_id = ids.second;
     int model_table_id = ids.second;
-    auto& tmp_embedding_collection = ebc_list_[embedding_collection_id];
-    auto& tmp_ebc_param = tmp_embedding_collection->ebc_param_;
-    auto& tmp_shard_matrix = tmp_ebc_param.shard_matrix;
 
     struct embedding::EmbeddingParameterInfo tmp_epi = embedding::EmbeddingParameterInfo();
     embedding_para_io_->load_metadata(path, embedding_collection_id, tmp_epi);
-
-    int target_grouped_id = -1;
-    embedding::TablePlacementStrategy target_placement;
-    for (int grouped_id = 0; grouped_id < tmp_ebc_param.grouped_table_params.size(); ++grouped_id) {
-      auto& tmp_table_ids = tmp_ebc_param.grouped_table_params[grouped_id].table_ids;
-
-      auto tmp_it = std::find(tmp_table_ids.begin(), tmp_table_ids.end(), model_table_id);
-      if (tmp_it != tmp_table_ids.end()) {
-        target_grouped_id = grouped_id;
-        target_placement = tmp_ebc_param.grouped_table_params[grouped_id].table_placement_strategy;
-        break;
-      }
-    }
-    if (target_grouped_id == -1) {
-      HCTR_OWN_THROW(Error_t::WrongInput,
-                     "can not find table_id in model table_ids,please check your input");
-    }
-
-    if (target_placement == embedding::TablePlacementStrategy::DataParallel) {
-      auto tmp_filter = [=](size_t key) { return true; };
-      core23::Tensor keys;
-      core23::Tensor embedding_weights;
-      auto& target_key_type = tmp_ebc_param.key_type;
-      auto& target_value_type = tmp_ebc_param.emb_type;
-      embedding_para_io_->load_embedding_weight(tmp_epi, file_table_id, keys, embedding_weights,
-                                                tmp_filter, core_list[0], target_key_type,
-                                                target_value_type);
-      for (size_t local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
-        HugeCTR::CudaDeviceContext context(core_list[local_gpu_id]->get_device_id());
-        auto& grouped_table =
-            tmp_embedding_collection->embedding_tables_[local_gpu_id][target_grouped_id];
-        grouped_table->load_by_id(&keys, &embedding_weights, model_table_id);
-      }
-    } else if (target_placement == embedding::TablePlacementStrategy::ModelParallel) {
-      for (size_t local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
-        HugeCTR::CudaDeviceContext context(core_list[local_gpu_id]->get_device_id());
-        size_t global_id = resource_manager_->get_gpu_global_id_from_local_id(local_gpu_id);
-        auto& target_key_type = tmp_ebc_param.key_type;
-        auto& target_value_type = tmp_ebc_param.emb_type;
-        std::vector<int> shard_gpu_list;
-        for (int gpu_id = 0; gpu_id < num_total_gpus; ++gpu_id) {
-          HCTR_CHECK_HINT(model_table_id < static_cast<int>(tmp_shard_matrix[gpu_id].size()),
-                          "table_id is out of range");
-          if (tmp_ebc_param.shard_matrix[gpu_id][model_table_id] == 1) {
-            shard_gpu_list.push_back(gpu_id);
-          }
-        }
-        int num_shards = static_cast<int>(shard_gpu_list.size());
-        auto find_shard_id_iter =
-            std::find(shard_gpu_list.begin(), shard_gpu_list.end(), global_id);
-        if (find_shard_id_iter == shard_gpu_list.end()) {
-          continue;
-        }
-        int shard_id = static_cast<int>(std::distance(shard_gpu_list.begin(), find_shard_id_iter));
-
-        auto tmp_filter = [=](size_t key) { return key % num_shards == shard_id; };
-        core23::Tensor keys;
-        core23::Tensor embedding_weights;
-        embedding_para_io_->load_embedding_weight(tmp_epi, file_table_id, keys, embedding_weights,
-                                                  tmp_filter, core_list[0], target_key_type,
-                                                  target_value_type);
-        auto& grouped_table =
-            tmp_embedding_collection->embedding_tables_[local_gpu_id][target_grouped_id];
-        grouped_table->load_by_id(&keys, &embedding_weights, model_table_id);
-      }
-    } else {
-      HCTR_OWN_THROW(Error_t::UnspecificError, "unsupported parallel mode");
-    }
+    embedding_para_io_->load_embedding_table(tmp_epi, file_table_id, embedding_collection_id,
+                                             model_table_id, num_threads);
   }
 }
 
-void Model::embedding_dump(const std::string& path, const std::vector<std::string>& table_names) {
+void Model::embedding_dump(const std::string& path, const std::vector<std::string>& table_names,
+                           int num_threads, bool incremental, const std::string& compression) {
+  const CompressionCodec codec = get_compression_codec(compression);
   std::vector<struct embedding::EmbeddingParameterInfo> epis;
 
   embedding_para_io_->get_parameter_info_from_model(path, epis);
@@ -1562,13 +1787,57 @@ void Model::embedding_dump(const std::string& path, const std::vector<std::strin
     }
   }
 
+  const bool sharded = num_threads > 1 || incremental || codec != CompressionCodec::None;
+  if (sharded) {
+    embedding_para_io_->begin_sharded_dump(path, incremental, codec);
+  }
   for (auto collection_id_iter = table_ids.begin(); collection_id_iter != table_ids.end();
        ++collection_id_iter) {
     auto& cid = collection_id_iter->first;
     auto& tmp_table_ids = collection_id_iter->second;
     std::sort(tmp_table_ids.begin(), tmp_table_ids.end());
-    embedding_para_io_->dump_metadata(path, epis[cid], tmp_table_ids);
-    embedding_para_io_->dump_embedding_weight(path, epis[cid], tmp_table_ids);
+    ebc_list_[cid]->flush_frequent_rows();
+    if (sharded) {
+      embedding_para_io_->dump_metadata(path, epis[cid], tmp_table_ids,
+                                        resource_manager_->get_num_process());
+      embedding_para_io_->dump_embedding_weight_sharded(path, epis[cid], tmp_table_ids,
+                                                        num_threads);
+    } else {
+      embedding_para_io_->dump_metadata(path, epis[cid], tmp_table_ids);
+      embedding_para_io_->dump_embedding_weight(path, epis[cid], tmp_table_ids);
+    }
+  }
+}
+
+void Model::embedding_export(const std::string& path, const std::vector<std::string>& table_names,
+                             uint32_t min_lookup_count, uint32_t max_idle_iterations,
+                             const std::string& compression) {
+  const CompressionCodec codec = get_compression_codec(compression);
+  std::vector<std::string> export_table_names = table_names;
+  if (!export_table_names.empty()) {
+    check_table_name_correct(ebc_name_to_global_id_dict_, export_table_names);
+  } else {
+    for (auto& [name, id_pair] : ebc_name_to_global_id_dict_) {
+      export_table_names.push_back(name);
+    }
+    // All ranks must export the tables in the same order.
+    std::sort(export_table_names.begin(), export_table_names.end());
+  }
+
+  std::vector<struct embedding::EmbeddingParameterInfo> epis;
+  embedding_para_io_->get_parameter_info_from_model(path, epis);
+  std::set<int> flushed_collection_ids;
+  for (const auto& name : export_table_names) {
+    const auto& [embedding_collection_id, table_id] = ebc_name_to_global_id_dict_.at(name);
+    if (flushed_collection_ids.insert(embedding_collection_id).second) {
+      ebc_list_[embedding_collection_id]->flush_frequent_rows();
+    }
+    const auto& epi = epis[embedding_collection_id];
+    const size_t num_rows = embedding_para_io_->export_sparse_model(
+        path + "/" + name, epi, table_id, min_lookup_count, max_idle_iterations, codec);
+    HCTR_LOG_S(INFO, ROOT) << "Exported " << num_rows << " of the "
+                           << epi.table_key_nums.at(table_id) << " rows of table " << name
+                           << " to " << path << "/" << name << std::endl;
   }
 }
 
@@ -1640,6 +1909,16 @@ void Model::summary() {
            "---------------------------------"
         << std::endl;
   }
+  log << "Memory usage of the tensors of this process" << std::endl
+      << core23::GetMemoryUsageReport();
+}
+
+std::vector<std::tuple<std::string, std::string, int64_t, int64_t>> Model::get_memory_usage() {
+  std::vector<std::tuple<std::string, std::string, int64_t, int64_t>> usage;
+  for (const auto& u : core23::GetMemoryUsage()) {
+    usage.emplace_back(u.device.name(), u.tag, u.current_bytes, u.peak_bytes);
+  }
+  return usage;
 }
 
 void Model::set_source(std::vector<std::string> source, std::vector<std::string> keyset,
@@ -1679,6 +1958,17 @@ void Model::set_source(std::string source, std::string eval_source) {
   reader_params_.eval_source.assign(eval_source);
 }
 
+// Returns the metric type of the AUC named name, or nothing for the other metrics.
+std::optional<metrics::Type> get_auc_type(const std::string& name) {
+  if (name == "AUC") {
+    return metrics::Type::AUC;
+  }
+  if (name == "ApproxAUC") {
+    return metrics::Type::ApproxAUC;
+  }
+  return std::nullopt;
+}
+
 void print_class_aucs(std::vector<float> class_aucs) {
   if (class_aucs.size() > 1) {
     HCTR_LOG_S(INFO, ROOT) << "Evaluation, AUC: {";
@@ -1693,7 +1983,7 @@ void print_class_aucs(std::vector<float> class_aucs) {
 }
 
 void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, int snapshot,
-                std::string snapshot_prefix) {
+                std::string snapshot_prefix, bool snapshot_async) {
   if (!buff_allocated_) {
     HCTR_OWN_THROW(Error_t::IllegalCall,
                    "Cannot start the training process "
@@ -1844,9 +2134,9 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
             metric_id++;
             HCTR_LOG_S(INFO, ROOT)
                 << "Evaluation, " << eval_metric.first << ": " << eval_metric.second << std::endl;
-            if (!eval_metric.first.compare("AUC")) {
+            if (const auto auc_type = get_auc_type(eval_metric.first)) {
               print_class_aucs(metrics_[metric_id - 1]->get_per_class_metric());
-              const auto auc_threshold = solver_.metrics_spec[HugeCTR::metrics::Type::AUC];
+              const auto auc_threshold = solver_.metrics_spec[*auc_type];
               if (eval_metric.second > auc_threshold) {
                 timer.stop();
                 HCTR_LOG(INFO, ROOT,
@@ -1866,7 +2156,11 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
                                  << " iters: " << timer_eval.elapsedSeconds() << "s" << std::endl;
         }
         if (snapshot > 0 && iter % snapshot == 0 && iter != 0) {
-          this->download_params_to_files(snapshot_prefix, iter);
+          if (snapshot_async) {
+            this->download_params_to_files_async_(snapshot_prefix, iter);
+          } else {
+            this->download_params_to_files(snapshot_prefix, iter);
+          }
         }
         iter++;
       } while (data_reader_train_status_);
@@ -1901,6 +2195,11 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         data_reader_train->set_source(reader_params_.source[f]);
         data_reader_train_status_ = true;
         embedding_training_cache->update(reader_params_.keyset[f]);
+        const bool is_last_pass = e == etc_epochs - 1 && f == reader_params_.source.size() - 1;
+        if (etc_params_->prefetch_next_pass && !is_last_pass) {
+          embedding_training_cache->prefetch(
+              reader_params_.keyset[(f + 1) % reader_params_.source.size()]);
+        }
         do {
           float lr = 0;
           if (!this->use_gpu_learning_rate_scheduling()) {
@@ -1955,7 +2254,7 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
               metric_id++;
               HCTR_LOG_S(INFO, ROOT)
                   << "Evaluation, " << eval_metric.first << ": " << eval_metric.second << std::endl;
-              if (!eval_metric.first.compare("AUC")) {
+              if (get_auc_type(eval_metric.first)) {
                 print_class_aucs(metrics_[metric_id - 1]->get_per_class_metric());
               }
             }
@@ -1980,15 +2279,47 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
     this->start_data_reading();
     this->init_data_reader_.reset();
 
+    // With overlap_eval, the batches of an evaluation are spread over the training iterations until
+    // the next one. The dense network of a batch runs on its own stream, concurrent with the
+    // training iteration that is launched after its embedding lookup.
+    const bool overlap_eval = solver_.overlap_eval && eval_interval > 0 &&
+                              !solver_.use_embedding_collection &&
+                              !(is_scheduled_datareader() && is_scheduled_embedding());
+    const int eval_batches_per_iter =
+        overlap_eval ? (solver_.max_eval_batches + eval_interval - 1) / eval_interval : 0;
+    int eval_batches_left = 0;
+    int eval_iter = 0;
+
     for (int iter = 0; iter < max_iter; iter++) {
       float lr = 0;
       if (!this->use_gpu_learning_rate_scheduling()) {
         lr = lr_sch_->get_next();
         this->set_learning_rate(lr);
       }
+      long long eval_batchsize = 0;
+      if (eval_batches_left > 0) {
+        eval_batchsize = read_eval_batch_();
+        if (eval_batchsize) {
+          lookup_eval_embeddings_();
+        }
+      }
       graph_.is_first_train_batch_ = (iter == 0);
       graph_.is_last_train_batch_ = (iter == max_iter - 1);
       this->train();
+      bool eval_done = false;
+      if (eval_batches_left > 0) {
+        if (eval_batchsize) {
+          run_eval_network_();
+        }
+        eval_batches_left--;
+        int batches = 1;
+        while (eval_batches_left > 0 && (batches < eval_batches_per_iter || iter == max_iter - 1)) {
+          this->eval();
+          eval_batches_left--;
+          batches++;
+        }
+        eval_done = eval_batches_left == 0;
+      }
       if (display > 0 && (iter + 1) % display == 0) {
         timer_train.stop();
         float loss = 0.0f;
@@ -2012,7 +2343,8 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         timer_train.start();
       }
       if (eval_interval > 0 && (iter + 1) % eval_interval == 0) {
-        if (solver_.all_reduce_algo == AllReduceAlgo::NCCL) {
+        if (solver_.all_reduce_algo == AllReduceAlgo::NCCL ||
+            solver_.all_reduce_algo == AllReduceAlgo::HIERARCHICAL) {
 #pragma omp parallel num_threads(number_of_networks())
           {
             size_t id = omp_get_thread_num();
@@ -2029,11 +2361,20 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         for (auto tc : training_callbacks_) {
           tc->on_eval_start(iter);
         }
-        for (int batches = 0; batches < solver_.max_eval_batches; batches++) {
-          graph_.is_first_eval_batch_ = (batches == 0);
-          graph_.is_last_eval_batch_ = (batches == solver_.max_eval_batches - 1);
-          this->eval();
+        eval_iter = iter;
+        if (overlap_eval && iter < max_iter - 1) {
+          eval_batches_left = solver_.max_eval_batches;
+          eval_done = eval_batches_left == 0;
+        } else {
+          for (int batches = 0; batches < solver_.max_eval_batches; batches++) {
+            graph_.is_first_eval_batch_ = (batches == 0);
+            graph_.is_last_eval_batch_ = (batches == solver_.max_eval_batches - 1);
+            this->eval();
+          }
+          eval_done = true;
         }
+      }
+      if (eval_done) {
         auto eval_metrics = this->get_eval_metrics();
         std::map<std::string, float> eval_results;
         for (auto& eval_metric : eval_metrics) {
@@ -2041,11 +2382,11 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         }
         bool early_stop = false;
         for (auto tc : training_callbacks_) {
-          early_stop = tc->on_eval_end(iter, eval_results) || early_stop;
+          early_stop = tc->on_eval_end(eval_iter, eval_results) || early_stop;
         }
         if (early_stop) {
           for (auto tc : training_callbacks_) {
-            tc->on_training_end(iter);
+            tc->on_training_end(eval_iter);
           }
           return;
         }
@@ -2056,18 +2397,19 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
                                  << eval_metric.second << std::endl;
           if (solver_.perf_logging) {
             HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "eval_accuracy", eval_metric.second,
-                          float(iter) / max_iter, iter);
+                          float(eval_iter) / max_iter, eval_iter);
           }
-          if (!eval_metric.first.compare("AUC")) {
+          if (const auto auc_type = get_auc_type(eval_metric.first)) {
             print_class_aucs(metrics_[metric_id - 1]->get_per_class_metric());
-            const auto auc_threshold = solver_.metrics_spec[HugeCTR::metrics::Type::AUC];
+            const auto auc_threshold = solver_.metrics_spec[*auc_type];
             if (eval_metric.second > auc_threshold) {
               timer.stop();
               if (solver_.perf_logging) {
                 size_t train_samples =
-                    static_cast<size_t>(iter + 1) * static_cast<size_t>(solver_.batchsize);
+                    static_cast<size_t>(eval_iter + 1) * static_cast<size_t>(solver_.batchsize);
 
-                HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "eval_stop", float(iter) / max_iter);
+                HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "eval_stop",
+                              float(eval_iter) / max_iter);
                 HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "epoch_stop", 0);
                 HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "run_stop", "success");
                 HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "train_samples", train_samples);
@@ -2078,8 +2420,9 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
                        "%d / %d iterations with batchsize %d "
                        "in %.2fs. Average speed %f "
                        "records/s.\n",
-                       auc_threshold, iter, max_iter, solver_.batchsize, timer.elapsedSeconds(),
-                       float(iter) * solver_.batchsize / timer.elapsedSeconds());
+                       auc_threshold, eval_iter, max_iter, solver_.batchsize,
+                       timer.elapsedSeconds(),
+                       float(eval_iter) * solver_.batchsize / timer.elapsedSeconds());
               return;
             }
           }
@@ -2088,12 +2431,16 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         HCTR_LOG_S(INFO, ROOT) << "Eval Time for " << solver_.max_eval_batches
                                << " iters: " << timer_eval.elapsedSeconds() << "s" << std::endl;
         if (solver_.perf_logging) {
-          HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "eval_stop",
-                        float(iter) / max_iter);  // use iteration to calculate it's in which epoch
+          // use iteration to calculate it's in which epoch
+          HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "eval_stop", float(eval_iter) / max_iter);
         }
       }
       if (snapshot > 0 && iter % snapshot == 0 && iter != 0) {
-        this->download_params_to_files(snapshot_prefix, iter);
+        if (snapshot_async) {
+          this->download_params_to_files_async_(snapshot_prefix, iter);
+        } else {
+          this->download_params_to_files(snapshot_prefix, iter);
+        }
       }
     }  // end for iter
     for (auto tc : training_callbacks_) {
@@ -2114,12 +2461,192 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
              max_iter, solver_.batchsize, timer.elapsedSeconds());
 
   }  // end if else
+  wait_for_snapshot_();
   high_level_eval_ = false;
 }
+void Model::init_wgrad_buckets_(const std::vector<void*>& wgrad_buffer_ptrs,
+                                size_t wgrad_buffer_size) {
+  if (resource_manager_->get_global_gpu_count() == 1) {
+    return;
+  }
+  if (solver_.gradient_accumulation_steps > 1) {
+    HCTR_LOG_S(WARNING, ROOT) << "The dense wgrad is accumulated over micro-batches and reduced "
+                                 "after the backward of the last one, not in buckets."
+                              << std::endl;
+    return;
+  }
+  if (solver_.shard_dense_optimizer) {
+    HCTR_LOG_S(WARNING, ROOT) << "The dense wgrad is reduce-scattered for the sharded optimizer "
+                                 "after backward, not in buckets."
+                              << std::endl;
+    return;
+  }
+  if (solver_.all_reduce_algo == AllReduceAlgo::ONESHOT || solver_.grouped_all_reduce) {
+    HCTR_LOG_S(WARNING, ROOT) << "dense_wgrad_bucket_size_mb requires an NCCL based all-reduce "
+                                 "without grouped_all_reduce. The dense wgrad is reduced after "
+                                 "backward."
+                              << std::endl;
+    return;
+  }
+  const size_t bucket_size = solver_.dense_wgrad_bucket_size_mb << 20;
+  const size_t alignment = 256;
+  std::vector<std::pair<size_t, size_t>> buckets;
+  for (size_t g = 0; g < core23_networks_.size(); g++) {
+    auto network_buckets = core23_networks_[g]->make_wgrad_buckets(
+        wgrad_buffer_ptrs[g], wgrad_buffer_size, bucket_size, alignment);
+    // The all-reduces of a bucket are matched across the GPUs, which must all bucket alike.
+    if (network_buckets.empty() || (g > 0 && network_buckets != buckets)) {
+      HCTR_LOG_S(WARNING, ROOT)
+          << "The dense wgrad can't be bucketed. It is reduced after backward." << std::endl;
+      return;
+    }
+    buckets = std::move(network_buckets);
+  }
+  if (!exchange_wgrad_->init_buckets(buckets)) {
+    HCTR_LOG_S(WARNING, ROOT) << "The wgrad exchange can't be bucketed. The dense wgrad is reduced "
+                                 "after backward."
+                              << std::endl;
+    return;
+  }
+  for (size_t g = 0; g < core23_networks_.size(); g++) {
+    core23_networks_[g]->enable_wgrad_buckets([this, g](size_t bucket, cudaStream_t stream) {
+      exchange_wgrad_->allreduce_bucket(bucket, g, stream);
+    });
+  }
+  HCTR_LOG_S(INFO, ROOT) << "The dense wgrad is all reduced in " << buckets.size()
+                         << " buckets during backward" << std::endl;
+}
+
+void Model::init_wgrad_accumulation_(const std::vector<void*>& wgrad_buffer_ptrs,
+                                     size_t wgrad_buffer_size) {
+  if (solver_.use_embedding_collection || is_scheduled_datareader() || is_scheduled_embedding()) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "gradient_accumulation_steps > 1 is not supported with use_embedding_collection "
+                   "or the scheduled training pipeline");
+  }
+  const size_t wgrad_type_size = solver_.use_mixed_precision ? sizeof(__half) : sizeof(float);
+  accumulated_wgrad_ptrs_ = wgrad_buffer_ptrs;
+  wgrad_accumulator_bufs_.resize(wgrad_buffer_ptrs.size());
+  wgrad_accumulators_.resize(wgrad_buffer_ptrs.size());
+  for (size_t g = 0; g < wgrad_buffer_ptrs.size(); g++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(g)->get_device_id());
+    wgrad_accumulator_bufs_[g] = GeneralBuffer2<CudaAllocator>::create();
+    wgrad_accumulator_bufs_[g]->reserve({wgrad_buffer_size / wgrad_type_size},
+                                        &wgrad_accumulators_[g]);
+    wgrad_accumulator_bufs_[g]->allocate();
+  }
+  HCTR_LOG_S(INFO, ROOT) << "The dense wgrad is accumulated over "
+                         << solver_.gradient_accumulation_steps << " micro-batches" << std::endl;
+}
+
+bool Model::accumulate_wgrad_() {
+  const size_t num_steps = solver_.gradient_accumulation_steps;
+  if (num_steps <= 1) {
+    return true;
+  }
+  const bool first = accumulation_step_ == 0;
+  const bool last = accumulation_step_ + 1 == num_steps;
+#pragma omp parallel num_threads(number_of_networks())
+  {
+    size_t id = omp_get_thread_num();
+    const auto& gpu_resource = resource_manager_->get_local_gpu(id);
+    CudaCPUDeviceContext ctx(gpu_resource->get_device_id());
+    float* accumulator = wgrad_accumulators_[id].get_ptr();
+    void* wgrad = accumulated_wgrad_ptrs_[id];
+    const size_t count = wgrad_accumulators_[id].get_num_elements();
+    constexpr size_t block = 256;
+    const size_t grid = std::min((count + block - 1) / block, gpu_resource->get_sm_count() * 8);
+    if (last) {
+      average_accumulated_wgrad_gpu(grid, block, wgrad, accumulator, count, 1.f / num_steps,
+                                    solver_.use_mixed_precision, gpu_resource->get_stream());
+    } else {
+      accumulate_wgrad_gpu(grid, block, accumulator, wgrad, count, first,
+                           solver_.use_mixed_precision, gpu_resource->get_stream());
+    }
+  }
+  accumulation_step_ = last ? 0 : accumulation_step_ + 1;
+  return last;
+}
+
+void Model::init_dynamic_loss_scaling_(const std::vector<void*>& wgrad_buffer_ptrs,
+                                       size_t wgrad_buffer_size) {
+  if (solver_.use_embedding_collection || is_scheduled_datareader() || is_scheduled_embedding()) {
+    HCTR_OWN_THROW(Error_t::WrongInput,
+                   "dynamic_loss_scaling is not supported with use_embedding_collection or the "
+                   "scheduled training pipeline");
+  }
+  const size_t wgrad_type_size = solver_.use_mixed_precision ? sizeof(__half) : sizeof(float);
+  loss_scaled_wgrad_ptrs_ = wgrad_buffer_ptrs;
+  loss_scaled_wgrad_count_ = wgrad_buffer_size / wgrad_type_size;
+  loss_scale_bufs_.resize(wgrad_buffer_ptrs.size());
+  loss_scales_.resize(wgrad_buffer_ptrs.size());
+  loss_scale_states_.resize(wgrad_buffer_ptrs.size());
+  for (size_t g = 0; g < wgrad_buffer_ptrs.size(); g++) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(g)->get_device_id());
+    loss_scale_bufs_[g] = GeneralBuffer2<CudaAllocator>::create();
+    loss_scale_bufs_[g]->reserve({1}, &loss_scales_[g]);
+    loss_scale_bufs_[g]->reserve({2}, &loss_scale_states_[g]);
+    loss_scale_bufs_[g]->allocate();
+    HCTR_LIB_THROW(cudaMemcpy(loss_scales_[g].get_ptr(), &solver_.scaler, sizeof(float),
+                              cudaMemcpyHostToDevice));
+    HCTR_LIB_THROW(
+        cudaMemset(loss_scale_states_[g].get_ptr(), 0, loss_scale_states_[g].get_size_in_bytes()));
+    core23_networks_[g]->set_dynamic_loss_scale(loss_scales_[g].get_ptr(),
+                                                loss_scale_states_[g].get_ptr());
+  }
+  HCTR_LOG_S(INFO, ROOT) << "The loss scale starts at " << solver_.scaler
+                         << " and is adjusted on the GPUs" << std::endl;
+}
+
+void Model::unscale_embedding_grads_() {
+#pragma omp parallel num_threads(number_of_networks())
+  {
+    size_t id = omp_get_thread_num();
+    const auto& gpu_resource = resource_manager_->get_local_gpu(id);
+    CudaCPUDeviceContext ctx(gpu_resource->get_device_id());
+    const size_t type_size = solver_.use_mixed_precision ? sizeof(__half) : sizeof(float);
+    for (const auto& one_embedding : embeddings_) {
+      auto grads = one_embedding->get_train_output_tensors();
+      const size_t count = grads[id].get_size_in_bytes() / type_size;
+      constexpr size_t block = 256;
+      const size_t grid = std::min((count + block - 1) / block, gpu_resource->get_sm_count() * 8);
+      unscale_and_check_gpu(grid, block, grads[id].get_ptr(), count, loss_scales_[id].get_ptr(),
+                            solver_.scaler, loss_scale_states_[id].get_ptr(), true,
+                            solver_.use_mixed_precision, gpu_resource->get_stream());
+    }
+  }
+}
+
+void Model::unscale_dense_wgrad_(size_t device_id) {
+  const auto& gpu_resource = resource_manager_->get_local_gpu(device_id);
+  const size_t count = loss_scaled_wgrad_count_;
+  constexpr size_t block = 256;
+  const size_t grid = std::min((count + block - 1) / block, gpu_resource->get_sm_count() * 8);
+  int* overflow = loss_scale_states_[device_id].get_ptr();
+  unscale_and_check_gpu(grid, block, loss_scaled_wgrad_ptrs_[device_id], count,
+                        loss_scales_[device_id].get_ptr(), solver_.scaler, overflow, false,
+                        solver_.use_mixed_precision, gpu_resource->get_stream());
+  // The all-reduced wgrad is alike on all GPUs, but the flags of the embedding gradients are not.
+  if (resource_manager_->get_global_gpu_count() > 1) {
+    HCTR_LIB_THROW(ncclAllReduce(overflow, overflow, 1, ncclInt32, ncclMax,
+                                 gpu_resource->get_nccl(), gpu_resource->get_stream()));
+  }
+}
+
+void Model::update_loss_scale_(size_t device_id) {
+  const auto& gpu_resource = resource_manager_->get_local_gpu(device_id);
+  CudaCPUDeviceContext ctx(gpu_resource->get_device_id());
+  update_loss_scale_gpu(loss_scales_[device_id].get_ptr(),
+                        loss_scale_states_[device_id].get_ptr(),
+                        static_cast<int>(solver_.loss_scale_growth_interval),
+                        gpu_resource->get_stream());
+}
+
 void Model::exchange_wgrad(size_t device_id) {
   auto& gpu_resource = resource_manager_->get_local_gpu(device_id);
   CudaCPUDeviceContext context(gpu_resource->get_device_id());
   if (resource_manager_->get_global_gpu_count() > 1) {
+    StepTimer::Scope phase(step_timer_.get(), device_id, StepPhase::AllReduce);
     exchange_wgrad_->allreduce(device_id, gpu_resource->get_stream());
   }
 }
@@ -2141,6 +2668,11 @@ long long Model::read_a_batch(bool is_train) {
   if (skip_prefetch_data_reading) {
     return data_reader->get_current_batchsize();
   }
+  TraceRange range(TraceCategory::DataReader, "read_a_batch");
+  std::optional<StepTimer::HostScope> reader_wait;
+  if (is_train) {
+    reader_wait.emplace(step_timer_.get(), StepPhase::ReaderWait);
+  }
 
   long long current_batchsize = 0;
 
@@ -2165,6 +2697,14 @@ bool Model::train() {
                      "Start the data reader first before "
                      "calling Model::train()");
     }
+    TraceIteration trace_iteration;
+    if (const auto report = step_timer_->begin_iteration()) {
+      for (const auto& tc : training_callbacks_) {
+        tc->on_step_time_report(report->iteration, *report);
+      }
+    }
+    // The scratch memory of the previous iteration is released, and grows to its peak.
+    core23::ScratchArena::reset_all();
 
 #ifndef DATA_READING_TEST
     // TODO: assuming the there are enough training
@@ -2186,7 +2726,8 @@ bool Model::train() {
       return false;
     }
 
-    if (solver_.all_reduce_algo == AllReduceAlgo::NCCL and
+    if ((solver_.all_reduce_algo == AllReduceAlgo::NCCL or
+         solver_.all_reduce_algo == AllReduceAlgo::HIERARCHICAL) and
         train_data_reader_->current_batch_incomplete()) {
 #pragma omp parallel num_threads(number_of_networks())
       {
@@ -2207,7 +2748,10 @@ bool Model::train() {
       return true;
     }
 
-    auto network_update = [&](int id) { core23_networks_[id]->update_params(); };
+    auto network_update = [&](int id) {
+      StepTimer::Scope phase(step_timer_.get(), id, StepPhase::Update);
+      core23_networks_[id]->update_params();
+    };
 
     for (auto& one_embedding : embeddings_) {
       one_embedding->forward(true);
@@ -2224,23 +2768,44 @@ bool Model::train() {
       }
     }
 
+    if (!loss_scales_.empty()) {
+      unscale_embedding_grads_();
+    }
+
     // Embedding backward
     for (auto& one_embedding : embeddings_) {
       one_embedding->backward();
     }
 
+    // The embeddings are updated with every micro-batch, the dense network once per update.
+    if (!accumulate_wgrad_()) {
+      for (const auto& one_embedding : embeddings_) {
+        one_embedding->update_params();
+      }
+      return true;
+    }
+
     // Exchange wgrad and update params
 #pragma omp parallel num_threads(number_of_networks())
     {
       size_t id = omp_get_thread_num();
       CudaCPUDeviceContext ctx(resource_manager_->get_local_gpu(id)->get_device_id());
       exchange_wgrad(id);
+      if (!loss_scales_.empty()) {
+        unscale_dense_wgrad_(id);
+      }
       network_update(id);
     }
 
     for (const auto& one_embedding : embeddings_) {
       one_embedding->update_params();
     }
+    if (!loss_scales_.empty()) {
+#pragma omp parallel num_threads(number_of_networks())
+      {
+        update_loss_scale_(omp_get_thread_num());
+      }
+    }
     return true;
 #else
     train_data_reader_->read_a_batch_to_device();
@@ -2259,16 +2824,12 @@ bool Model::eval() {
       HCTR_OWN_THROW(Error_t::IllegalCall,
                      "Start the data reader first before calling Model::eval()");
     }
+    core23::ScratchArena::reset_all();
     if (!high_level_eval_) {
       this->check_overflow();
       this->copy_weights_for_evaluation();
     }
-    bool is_train = false;
-    long long current_batchsize = read_a_batch(is_train);
-
-    for (auto& metric : metrics_) {
-      metric->set_current_batch_size(current_batchsize);
-    }
+    long long current_batchsize = read_eval_batch_();
     if (!current_batchsize) {
       return false;
     }
@@ -2286,23 +2847,8 @@ bool Model::eval() {
     if (is_scheduled_datareader() && is_scheduled_embedding()) {
       evaluate_pipeline(current_batchsize);
     } else {
-      for (size_t i = 0; i < embeddings_.size(); ++i) {
-        auto& one_embedding = embeddings_.at(i);
-        one_embedding->forward(false);
-      }
-
-#pragma omp parallel num_threads(number_of_networks())
-      {
-        size_t id = omp_get_thread_num();
-        auto gpu = resource_manager_->get_local_gpu(id);
-
-        // doesn't do anything if eval_overlap disabled
-        graph_.evaluate_pipeline_[id].run();
-      }
-
-      for (auto& metric : metrics_) {
-        metric->global_reduce(number_of_networks());
-      }
+      lookup_eval_embeddings_();
+      run_eval_network_();
     }
 #endif
 
@@ -2313,6 +2859,68 @@ bool Model::eval() {
   }
 }  // namespace HugeCTR
 
+long long Model::read_eval_batch_() {
+  // The overlapped evaluation of the previous batch may still read the evaluation buffers.
+  wait_for_overlapped_eval_();
+  bool is_train = false;
+  long long current_batchsize = read_a_batch(is_train);
+
+  for (auto& metric : metrics_) {
+    metric->set_current_batch_size(current_batchsize);
+  }
+  return current_batchsize;
+}
+
+void Model::lookup_eval_embeddings_() {
+  // The embedding lookup stays on the training stream, as the embeddings share their tables and
+  // buffers between training and evaluation.
+  for (auto& one_embedding : embeddings_) {
+    one_embedding->forward(false);
+  }
+  if (solver_.overlap_eval) {
+    for (size_t id = 0; id < resource_manager_->get_local_gpu_count(); id++) {
+      auto gpu = resource_manager_->get_local_gpu(id);
+      CudaCPUDeviceContext ctx(gpu->get_device_id());
+      HCTR_LIB_THROW(cudaEventRecord(gpu->get_event("overlapped_eval_ready"), gpu->get_stream()));
+    }
+  }
+}
+
+void Model::run_eval_network_() {
+#pragma omp parallel num_threads(number_of_networks())
+  {
+    size_t id = omp_get_thread_num();
+    auto gpu = resource_manager_->get_local_gpu(id);
+    CudaCPUDeviceContext ctx(gpu->get_device_id());
+
+    if (solver_.overlap_eval) {
+      HCTR_LIB_THROW(cudaStreamWaitEvent(gpu->get_stream(overlapped_eval_stream_name),
+                                         gpu->get_event("overlapped_eval_ready")));
+    }
+    // doesn't do anything if eval_overlap disabled
+    graph_.evaluate_pipeline_[id].run();
+    if (solver_.overlap_eval) {
+      HCTR_LIB_THROW(cudaEventRecord(gpu->get_event("overlapped_eval_done"),
+                                     gpu->get_stream(overlapped_eval_stream_name)));
+    }
+  }
+
+  for (auto& metric : metrics_) {
+    metric->global_reduce(number_of_networks());
+  }
+}
+
+void Model::wait_for_overlapped_eval_() {
+  if (!solver_.overlap_eval) {
+    return;
+  }
+  for (size_t id = 0; id < resource_manager_->get_local_gpu_count(); id++) {
+    auto gpu = resource_manager_->get_local_gpu(id);
+    CudaCPUDeviceContext ctx(gpu->get_device_id());
+    HCTR_LIB_THROW(cudaEventSynchronize(gpu->get_event("overlapped_eval_done")));
+  }
+}
+
 Error_t Model::export_predictions(const std::string& output_prediction_file_name,
                                   const std::string& output_label_file_name) {
   try {
@@ -2409,6 +3017,7 @@ Error_t Model::export_predictions(const std::string& output_prediction_file_name
 }
 
 std::vector<std::pair<std::string, float>> Model::get_eval_metrics() {
+  wait_for_overlapped_eval_();
   std::vector<std::pair<std::string, float>> metrics;
   for (auto& metric : metrics_) {
     metrics.push_back(std::make_pair(metric->name(), metric->finalize_metric()));
@@ -2449,6 +3058,7 @@ Error_t Model::get_current_loss(float* loss) {
 }
 
 Error_t Model::download_params_to_files(std::string prefix, int iter) {
+  wait_for_snapshot_();
   std::string snapshot_dense_name = prefix + "_dense_" + std::to_string(iter) + ".model";
   std::string snapshot_dense_opt_name = prefix + "_opt_dense_" + std::to_string(iter) + ".model";
   std::vector<std::string> snapshot_sparse_names;
@@ -2468,6 +3078,91 @@ Error_t Model::download_params_to_files(std::string prefix, int iter) {
   return download_dense_params_to_files_(snapshot_dense_name, snapshot_dense_opt_name);
 }
 
+Error_t Model::download_params_to_files_async_(std::string prefix, int iter) {
+  // The staging buffers are reused, so the last snapshot must be written first.
+  wait_for_snapshot_();
+  std::string snapshot_dense_name = prefix + "_dense_" + std::to_string(iter) + ".model";
+  std::string snapshot_dense_opt_name = prefix + "_opt_dense_" + std::to_string(iter) + ".model";
+  std::vector<std::string> snapshot_sparse_names;
+  std::vector<std::string> snapshot_sparse_opt_names;
+  for (unsigned int i = 0; i < embeddings_.size(); i++) {
+    snapshot_sparse_names.push_back(prefix + std::to_string(i) + "_sparse_" + std::to_string(iter) +
+                                    ".model");
+    snapshot_sparse_opt_names.push_back(prefix + std::to_string(i) + "_opt_sparse_" +
+                                        std::to_string(iter) + ".model");
+  }
+  if (etc_params_->use_embedding_training_cache) {
+    embedding_training_cache_->dump();
+    embedding_training_cache_->update_sparse_model_file();
+  } else {
+    download_sparse_params_to_files_(snapshot_sparse_names, snapshot_sparse_opt_names);
+  }
+  if (!resource_manager_->is_master_process()) {
+    return Error_t::Success;
+  }
+
+  try {
+    auto& network = core23_networks_[0];
+    const size_t weights_size = network->get_params_num() * sizeof(float);
+    const size_t opt_states_size = network->get_opt_states_size_in_byte();
+    if (snapshot_staging_size_ < weights_size + opt_states_size) {
+      CudaCPUDeviceContext context(network->get_device_id());
+      if (snapshot_staging_) {
+        HCTR_LIB_THROW(cudaFreeHost(snapshot_staging_));
+        snapshot_staging_ = nullptr;
+      }
+      HCTR_LIB_THROW(cudaMallocHost(&snapshot_staging_, weights_size + opt_states_size));
+      snapshot_staging_size_ = weights_size + opt_states_size;
+    }
+    char* weights = snapshot_staging_;
+    char* opt_states = snapshot_staging_ + weights_size;
+    network->download_params_to_host(reinterpret_cast<float*>(weights));
+    network->download_opt_states_to_host(opt_states);
+    std::string no_trained_params = network->get_no_trained_params_in_string();
+
+    // Training goes on while the staged state is written.
+    snapshot_writer_ = std::async(std::launch::async, [=]() {
+      try {
+        auto fs = FileSystemBuilder::build_unique_by_path(snapshot_dense_name);
+        fs->write(snapshot_dense_name, weights, weights_size, true);
+        HCTR_LOG(INFO, ROOT, "Dumping dense weights to file, successful\n");
+        fs->write(snapshot_dense_opt_name, opt_states, opt_states_size, true);
+        HCTR_LOG(INFO, ROOT, "Dumping dense optimizer states to file, successful\n");
+        if (no_trained_params.length() != 0) {
+          std::string ntp_file = snapshot_dense_name + ".ntp.json";
+          fs->write(ntp_file, no_trained_params.c_str(), no_trained_params.length(), true);
+          HCTR_LOG(INFO, ROOT, "Dumping untrainable weights to file, successful\n");
+        }
+      } catch (const core23::RuntimeError& rt_err) {
+        Logger::get().print(rt_err);
+        return rt_err.error;
+      } catch (const std::exception& err) {
+        Logger::get().print(err);
+        return Error_t::UnspecificError;
+      }
+      return Error_t::Success;
+    });
+  } catch (const core23::RuntimeError& rt_err) {
+    Logger::get().print(rt_err);
+    return rt_err.error;
+  } catch (const std::exception& err) {
+    Logger::get().print(err);
+    return Error_t::UnspecificError;
+  }
+  return Error_t::Success;
+}
+
+Error_t Model::wait_for_snapshot_() {
+  if (!snapshot_writer_.valid()) {
+    return Error_t::Success;
+  }
+  Error_t error = snapshot_writer_.get();
+  if (error != Error_t::Success) {
+    HCTR_LOG(ERROR, WORLD, "Writing the asynchronous snapshot failed\n");
+  }
+  return error;
+}
+
 void Model::check_overflow() const {
   if (!overflow_check_) {
     return;
@@ -2478,6 +3173,8 @@ void Model::check_overflow() const {
 }
 
 void Model::copy_weights_for_evaluation() {
+  // The weights of the evaluation layers are in use until the overlapped evaluation has finished.
+  wait_for_overlapped_eval_();
   auto op = [](auto& networks) {
     for (auto& network : networks) {
       network->copy_weights_from_train_layers_to_evaluate_layers();
@@ -2525,6 +3222,14 @@ Error_t Model::download_sparse_params_to_files_(
       int i = 0;
       for (auto& embedding_file : embedding_files) {
         embeddings_[i]->dump_parameters(embedding_file);
+        if (solver_.export_mapped_sparse_model && resource_manager_->is_master_process()) {
+          if (IOUtils::is_local_path(embedding_file)) {
+            convert_to_mapped_sparse_model(embedding_file);
+          } else {
+            HCTR_LOG_S(WARNING, ROOT) << "Mapped sparse models are only exported to the local "
+                                      << "file system, skipped " << embedding_file << std::endl;
+          }
+        }
         i++;
       }
     }
@@ -2556,7 +3261,8 @@ std::shared_ptr<EmbeddingTrainingCache> Model::create_embedding_training_cache_(
   try {
     return std::shared_ptr<EmbeddingTrainingCache>(new EmbeddingTrainingCache(
         ps_types, embeddings_, sparse_embedding_files, resource_manager_,
-        solver_.use_mixed_precision, solver_.i64_input_key, local_paths, hmem_cache_configs));
+        solver_.use_mixed_precision, solver_.i64_input_key, local_paths, hmem_cache_configs,
+        etc_params_->writeback_config));
   } catch (const std::exception& err) {
     Logger::get().print(err);
     throw;
@@ -2711,6 +3417,55 @@ std::vector<std::pair<std::vector<long long>, std::vector<float>>>& Model::get_i
   return inc_sparse_model_;
 }
 
+void Model::save_data_reader_state(const std::string& file_name) {
+  // The prefetch overlaps the next batch with the current iteration.
+  const size_t num_prefetched = solver_.use_embedding_collection &&
+                                        solver_.train_inter_iteration_overlap &&
+                                        !graph_.is_first_train_batch_
+                                    ? 1
+                                    : 0;
+  MultiHot::ReaderState state;
+  if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<uint32_t>*>(
+          train_data_reader_.get())) {
+    state = reader->get_state(num_prefetched);
+  } else if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<long long>*>(
+                 train_data_reader_.get())) {
+    state = reader->get_state(num_prefetched);
+  } else {
+    HCTR_OWN_THROW(Error_t::IllegalCall,
+                   "Reader states can only be saved for the multi-hot RawAsync reader");
+  }
+  // The position is the same on all ranks.
+  if (resource_manager_->is_master_process()) {
+    MultiHot::save_reader_state(file_name, state);
+    HCTR_LOG_S(INFO, ROOT) << "Saved epoch " << state.position.epoch << ", batch "
+                           << state.position.batch << " of the train data reader to " << file_name
+                           << std::endl;
+  }
+}
+
+void Model::push_batch(InMemoryBatch batch, bool is_train) {
+  auto& data_reader = is_train ? train_data_reader_ : evaluate_data_reader_;
+  if (auto reader = dynamic_cast<InMemoryDataReader<uint32_t>*>(data_reader.get())) {
+    reader->push(std::move(batch));
+  } else if (auto reader = dynamic_cast<InMemoryDataReader<long long>*>(data_reader.get())) {
+    reader->push(std::move(batch));
+  } else {
+    HCTR_OWN_THROW(Error_t::IllegalCall, "Batches can only be pushed to the InMemory reader");
+  }
+}
+
+void Model::finish_batches(bool is_train) {
+  auto& data_reader = is_train ? train_data_reader_ : evaluate_data_reader_;
+  if (auto reader = dynamic_cast<InMemoryDataReader<uint32_t>*>(data_reader.get())) {
+    reader->finish();
+  } else if (auto reader = dynamic_cast<InMemoryDataReader<long long>*>(data_reader.get())) {
+    reader->finish();
+  } else {
+    HCTR_OWN_THROW(Error_t::IllegalCall, "Batches can only be pushed to the InMemory reader");
+  }
+}
+
 void Model::dump_incremental_model_2kafka() {
   if (!etc_params_->use_embedding_training_cache) {
     HCTR_OWN_THROW(Error_t::IllegalCall, "Get incremental is only supported in ETC");
@@ -2836,9 +3591,7 @@ void Model::create_networks() {
 }
 
 void Model::build_networks() {
-  for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
-    core23_networks_[i]->create_and_set_optimizer(opt_params_);
-  }
+  core23::MemoryTagScope memory_tag_scope("dense/optimizer");
   auto aligned_size = 16 * resource_manager_->get_local_gpu_count();
   core23::BufferParams bp{.channel = solver_.use_mixed_precision ? GetWgradHalfBufferChannel()
                                                                  : GetWgradBufferChannel()};
@@ -2856,16 +3609,40 @@ void Model::build_networks() {
                                              .data_type(core23::ScalarType::Char)
                                              .buffer_params(bp));
   }
+  // After the wgrad is padded, since a sharded optimizer binds to the allocated wgrad.
+  const size_t num_shards = get_num_dense_optimizer_shards_();
+  for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
+    core23_networks_[i]->create_and_set_optimizer(opt_params_, num_shards);
+  }
+  if (num_shards > 1) {
+    HCTR_LOG_S(INFO, ROOT) << "The dense optimizer states are sharded across " << num_shards
+                           << " GPUs. They are not dumped with the dense model." << std::endl;
+  }
   buff_allocated_ = true;
 }
 
+size_t Model::get_num_dense_optimizer_shards_() const {
+  return solver_.shard_dense_optimizer ? resource_manager_->get_global_gpu_count() : 1;
+}
+
 void Model::initialize() {
 #ifndef DATA_READING_TEST
+  if (solver_.use_algorithm_search && !solver_.algorithm_cache_file.empty()) {
+    GemmAlgorithmCache::get().set_file(solver_.algorithm_cache_file);
+  }
   auto op = [this](auto& networks, const size_t id) {
     networks[id]->initialize();
     if (solver_.use_algorithm_search) {
       networks[id]->search_algorithm();
     }
+    if (solver_.dense_branch_streams > 1) {
+      const size_t num_streams =
+          networks[id]->enable_concurrent_branches(solver_.dense_branch_streams);
+      if (id == 0) {
+        HCTR_LOG_S(INFO, ROOT) << "The independent branches of the dense network run on "
+                               << num_streams << " streams" << std::endl;
+      }
+    }
     HCTR_LIB_THROW(cudaStreamSynchronize(resource_manager_->get_local_gpu(id)->get_stream()));
   };
 #pragma omp parallel num_threads(number_of_networks())
@@ -2873,6 +3650,9 @@ void Model::initialize() {
     size_t id = omp_get_thread_num();
     op(core23_networks_, id);
   }
+  if (solver_.use_algorithm_search) {
+    GemmAlgorithmCache::get().save();
+  }
 
   int num_gpus = resource_manager_->get_local_gpu_count();
   std::vector<void*> wgrad_buffer_ptrs;
@@ -2889,6 +3669,27 @@ void Model::initialize() {
     wgrad_buffer_ptrs.push_back(ptr_);
   }
   exchange_wgrad_->init_ar_comm(wgrad_buffer_ptrs, wgrad_buffer_size);
+  if (get_num_dense_optimizer_shards_() > 1) {
+    for (int g = 0; g < num_gpus; g++) {
+      const auto& network = core23_networks_[g];
+      const void* wgrad = solver_.use_mixed_precision
+                              ? static_cast<void*>(network->wgrad_tensor_half_->data())
+                              : static_cast<void*>(network->wgrad_tensor_->data());
+      HCTR_CHECK_HINT(wgrad == wgrad_buffer_ptrs[g], "The wgrad must start the wgrad buffer");
+    }
+    if (!exchange_wgrad_->init_shards(core23_networks_[0]->get_params_num())) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "The wgrad exchange can't be sharded");
+    }
+  }
+  if (solver_.gradient_accumulation_steps > 1) {
+    init_wgrad_accumulation_(wgrad_buffer_ptrs, wgrad_buffer_size);
+  }
+  if (solver_.dense_wgrad_bucket_size_mb > 0) {
+    init_wgrad_buckets_(wgrad_buffer_ptrs, wgrad_buffer_size);
+  }
+  if (solver_.dynamic_loss_scaling) {
+    init_dynamic_loss_scaling_(wgrad_buffer_ptrs, wgrad_buffer_size);
+  }
 #endif
   init_params_for_dense_();
   if (solver_.perf_logging) {
@@ -2921,24 +3722,45 @@ void Model::create_metrics() {
   auto num_metrics = [&]() { return core23_networks_[0]->get_raw_metrics_all().size(); };
   for (const auto& metric : solver_.metrics_spec) {
     // Only AUC is currently supported for models with more than one loss layer
-    if ((metric.first != metrics::Type::AUC) && num_metrics() > 1) {
+    if (metric.first != metrics::Type::AUC && metric.first != metrics::Type::ApproxAUC &&
+        num_metrics() > 1) {
       HCTR_OWN_THROW(Error_t::WrongInput,
                      "Metrics besides AUC are not supported for multi-task models.");
     }
 
+    // The value of the in-batch ranking metrics is their K
     metrics_.emplace_back(std::move(metrics::Metric::Create(
         metric.first, solver_.use_mixed_precision, solver_.batchsize_eval / num_total_gpus,
-        solver_.max_eval_batches, label_dim, resource_manager_)));
+        solver_.max_eval_batches, label_dim, resource_manager_, false,
+        static_cast<int>(metric.second))));
   }
+
+  std::vector<metrics::Metric*> metrics;
+  for (auto& metric : metrics_) {
+    metrics.push_back(metric.get());
+  }
+  fused_local_reduce_ = std::make_unique<metrics::FusedLocalReduce>(metrics, resource_manager_);
 }
 
 void Model::create_pipelines() {
   // TODO: currently it is only for HE
-  if (embeddings_.size() == 1) {
+  if (embeddings_.size() == 1 && !embeddings_[0]->get_learning_rate_schedulers().empty()) {
     auto lr_scheds = embeddings_[0]->get_learning_rate_schedulers();
     for (size_t i = 0; i < lr_scheds.size(); i++) {
       core23_networks_[i]->set_learning_rate_scheduler(lr_scheds[i]);
     }
+  } else if (solver_.gpu_learning_rate_scheduling) {
+    // The train pipelines update the schedulers of the networks once per iteration, and the
+    // embeddings read the learning rate of the same step.
+    for (size_t i = 0; i < core23_networks_.size(); i++) {
+      core23_networks_[i]->set_learning_rate_scheduler(gpu_lr_sches_[i]);
+    }
+    for (auto& one_embedding : embeddings_) {
+      one_embedding->set_learning_rate_schedulers(gpu_lr_sches_);
+    }
+    for (auto& ebc : ebc_list_) {
+      ebc->set_learning_rate_schedulers(gpu_lr_sches_);
+    }
   }
 
   if (is_scheduled_datareader() && is_scheduled_embedding()) {
@@ -3026,35 +3848,47 @@ void Model::create_pipelines() {
       HCTR_LOG_ARGS(timer_log.elapsedMilliseconds(), "run_start");
     }
 
-    if (init_data_reader_ar_i32) {
-      init_data_reader_ar_i32->start();
-      init_data_reader_ar_i32->read_a_batch_to_device();
-    }
-    if (init_data_reader_ar_i64) {
-      init_data_reader_ar_i64->start();
-      init_data_reader_ar_i64->read_a_batch_to_device();
-    }
+    // The init data is only read if a hybrid embedding doesn't load its statistics from file.
+    bool init_data_read = false;
+    const auto read_init_data = [&](const bool needed) {
+      if (!needed || init_data_read) {
+        return;
+      }
+      if (init_data_reader_ar_i32) {
+        init_data_reader_ar_i32->start();
+        init_data_reader_ar_i32->read_a_batch_to_device();
+      }
+      if (init_data_reader_ar_i64) {
+        init_data_reader_ar_i64->start();
+        init_data_reader_ar_i64->read_a_batch_to_device();
+      }
+      init_data_read = true;
+    };
 
     for (size_t i = 0; i < sparse_embedding_params_.size(); i++) {
       if (sparse_embedding_params_[i].embedding_type == Embedding_t::HybridSparseEmbedding) {
         if (solver_.use_mixed_precision && solver_.i64_input_key) {
           auto hybrid_embedding =
               dynamic_cast<HybridSparseEmbedding<long long, __half>*>(embeddings_[i].get());
+          read_init_data(hybrid_embedding->needs_init_data());
           hybrid_embedding->init_model(init_data_reader_ar_i64->get_value_tensors(),
                                        embed_wgrad_size);
         } else if (solver_.use_mixed_precision && !solver_.i64_input_key) {
           auto hybrid_embedding =
               dynamic_cast<HybridSparseEmbedding<unsigned int, __half>*>(embeddings_[i].get());
+          read_init_data(hybrid_embedding->needs_init_data());
           hybrid_embedding->init_model(init_data_reader_ar_i32->get_value_tensors(),
                                        embed_wgrad_size);
         } else if (!solver_.use_mixed_precision && solver_.i64_input_key) {
           auto hybrid_embedding =
               dynamic_cast<HybridSparseEmbedding<long long, float>*>(embeddings_[i].get());
+          read_init_data(hybrid_embedding->needs_init_data());
           hybrid_embedding->init_model(init_data_reader_ar_i64->get_value_tensors(),
                                        embed_wgrad_size);
         } else {
           auto hybrid_embedding =
               dynamic_cast<HybridSparseEmbedding<unsigned int, float>*>(embeddings_[i].get());
+          read_init_data(hybrid_embedding->needs_init_data());
           hybrid_embedding->init_model(init_data_reader_ar_i32->get_value_tensors(),
                                        embed_wgrad_size);
         }
@@ -26,6 +26,7 @@
 #include <pybind/model.hpp>
 #include <resource_managers/resource_manager_ext.hpp>
 #include <sstream>
+#include <timeline.hpp>
 
 namespace HugeCTR {
 
@@ -58,6 +59,12 @@ void Model::create_train_network_pipeline(std::vector<std::shared_ptr<Network>>&
     } else {
       scheduleable_list = {network_forward_and_backward};
     }
+    // The learning rate of the step is computed on the gpu, so that it is captured with the rest.
+    if (networks[local_id]->lr_sched_) {
+      auto lr_sched_update = std::make_shared<StreamContextScheduleable>(
+          [=]() { networks[local_id]->lr_sched_->update(); });
+      scheduleable_list.insert(scheduleable_list.begin(), lr_sched_update);
+    }
 
     auto graph = std::make_shared<GraphScheduleable>(scheduleable_list);
     graph_.train_pipeline_[local_id] = Pipeline{"default", gpu_resource, {graph}};
@@ -80,16 +87,22 @@ void Model::create_eval_network_pipeline(std::vector<std::shared_ptr<Network>>&
     });
 
     auto cal_metrics = std::make_shared<StreamContextScheduleable>([=] {
-      for (auto& metric : metrics_) {
-        auto metric_map = networks[local_id]->get_raw_metrics_all().begin()->second;
-        metric->local_reduce(local_id, metric_map);
-      }
+      auto metric_map = networks[local_id]->get_raw_metrics_all().begin()->second;
+      fused_local_reduce_->local_reduce(local_id, metric_map);
     });
 
     std::vector<std::shared_ptr<Scheduleable>> scheduleable_list = {network_eval, cal_metrics};
 
     auto graph = std::make_shared<GraphScheduleable>(scheduleable_list);
-    graph_.evaluate_pipeline_[local_id] = Pipeline{"default", gpu_resource, {graph}};
+    if (solver_.overlap_eval) {
+      // The stream is created here so that it gets the least priority, with which the scheduler
+      // prefers the training kernels.
+      int least_priority, greatest_priority;
+      HCTR_LIB_THROW(cudaDeviceGetStreamPriorityRange(&least_priority, &greatest_priority));
+      gpu_resource->get_stream(overlapped_eval_stream_name, least_priority);
+    }
+    graph_.evaluate_pipeline_[local_id] = Pipeline{
+        solver_.overlap_eval ? overlapped_eval_stream_name : "default", gpu_resource, {graph}};
   }
 }
 
@@ -177,7 +190,7 @@ void Model::create_train_pipeline(std::vector<std::shared_ptr<Network>>& network
 
     auto network_init = std::make_shared<StreamContextScheduleable>([=] {
       if (networks[local_id]->use_mixed_precision_ &&
-          networks[local_id]->optimizer_->get_optimizer_type() != Optimizer_t::SGD) {
+          !networks[local_id]->optimizer_->updates_weight_half()) {
         networks[local_id]->conv_weight_(networks[local_id]->train_weight_tensor_half_,
                                          networks[local_id]->train_weight_tensor_);
       }
@@ -433,7 +446,7 @@ void Model::create_evaluate_pipeline(std::vector<std::shared_ptr<Network>>& netw
 
     auto network_init = std::make_shared<StreamContextScheduleable>([=] {
       if (networks[local_id]->use_mixed_precision_ &&
-          networks[local_id]->optimizer_->get_optimizer_type() != Optimizer_t::SGD) {
+          !networks[local_id]->optimizer_->updates_weight_half()) {
         networks[local_id]->conv_weight_(networks[local_id]->train_weight_tensor_half_,
                                          networks[local_id]->train_weight_tensor_);
       }
@@ -447,10 +460,8 @@ void Model::create_evaluate_pipeline(std::vector<std::shared_ptr<Network>>& netw
     });
 
     auto cal_metrics = std::make_shared<StreamContextScheduleable>([=] {
-      for (auto& metric : metrics_) {
-        auto metric_map = networks[local_id]->get_raw_metrics_all().begin()->second;
-        metric->local_reduce(local_id, metric_map);
-      }
+      auto metric_map = networks[local_id]->get_raw_metrics_all().begin()->second;
+      fused_local_reduce_->local_reduce(local_id, metric_map);
     });
 
     std::vector<std::shared_ptr<Scheduleable>> scheduleable_list = {
@@ -565,19 +576,16 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
 
     // create scheduleable
     auto distribute_data = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Embedding, "distribute_data");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Forward);
       if (skip_prefetch_in_last_batch(is_train)) return;
 
       if (is_scheduled_datareader()) {
-        if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<uint32_t>*>(
-                train_data_reader_.get())) {
+        if (auto reader = dynamic_cast<SparseValueReader*>(train_data_reader_.get())) {
           train_data_distributor_->distribute(
-              local_id, reader->get_current_sparse_values()[local_id], {},
-              train_ddl_output_[local_id], train_data_reader_->get_current_batchsize());
-        } else if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<long long>*>(
-                       train_data_reader_.get())) {
-          train_data_distributor_->distribute(
-              local_id, reader->get_current_sparse_values()[local_id], {},
-              train_ddl_output_[local_id], train_data_reader_->get_current_batchsize());
+              local_id, reader->get_current_sparse_values()[local_id],
+              reader->get_current_dp_bucket_ranges()[local_id], train_ddl_output_[local_id],
+              train_data_reader_->get_current_batchsize());
         }
 
       } else {
@@ -606,54 +614,81 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
     };
 
     auto ebc_mp_model_forward = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Embedding, "ebc_mp_model_forward");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Forward);
       ebc_forward(embedding::Stage::MPModelForward);
       ebc_forward(embedding::Stage::HierMPModelForward);
       ebc_forward(embedding::Stage::DenseMPModelForward);
     });
 
     auto ebc_mp_network_forward = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Communication, "ebc_mp_network_forward");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::AllToAll);
       ebc_forward(embedding::Stage::MPNetworkdForward);
       ebc_forward(embedding::Stage::HierMPNetworkForward);
       ebc_forward(embedding::Stage::DenseMPNetworkForward);
+      ebc_forward(embedding::Stage::DPFrequentForward);
     });
 
     auto ebc_mp_network_backward = std::make_shared<StreamContextScheduleable>([=]() {
+      TraceRange range(TraceCategory::Communication, "ebc_mp_network_backward");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::AllToAll);
       ebc_backward(embedding::Stage::MPNetworkBackward);
       ebc_backward(embedding::Stage::HierMPNetworkBackward);
       ebc_backward(embedding::Stage::DenseMPNetworkBackward);
     });
 
     auto ebc_mp_backward_index_calculation = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Embedding, "ebc_mp_backward_index_calculation");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Backward);
       ebc_backward(embedding::Stage::MPBackwardIndexCalculation);
       ebc_backward(embedding::Stage::HierMPBackwardIndexCalculation);
       ebc_backward(embedding::Stage::DenseMPBackwardIndexCalculation);
     });
 
     auto ebc_mp_local_reduce = std::make_shared<StreamContextScheduleable>([=]() {
+      TraceRange range(TraceCategory::Embedding, "ebc_mp_local_reduce");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Backward);
       ebc_backward(embedding::Stage::HierMPLocalReduce);
       ebc_backward(embedding::Stage::MPLocalReduce);
       ebc_backward(embedding::Stage::DenseMPLocalReduce);
     });
 
     auto ebc_mp_update = std::make_shared<StreamContextScheduleable>([=]() {
+      TraceRange range(TraceCategory::Optimizer, "ebc_mp_update");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Update);
       for (auto& ebc : ebc_list_) {
         ebc->update_per_gpu(local_id, embedding::TablePlacementStrategy::ModelParallel);
       }
     });
 
-    auto ebc_dp_forward = std::make_shared<StreamContextScheduleable>(
-        [=] { ebc_forward(embedding::Stage::DPForward); });
+    auto ebc_dp_forward = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Embedding, "ebc_dp_forward");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Forward);
+      ebc_forward(embedding::Stage::DPForward);
+    });
 
-    auto ebc_dp_backward_index_calculation = std::make_shared<StreamContextScheduleable>(
-        [=] { ebc_backward(embedding::Stage::DPBackwardIndexCalculation); });
+    auto ebc_dp_backward_index_calculation = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Embedding, "ebc_dp_backward_index_calculation");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Backward);
+      ebc_backward(embedding::Stage::DPBackwardIndexCalculation);
+    });
 
-    auto ebc_dp_local_reduce = std::make_shared<StreamContextScheduleable>(
-        [=]() { ebc_backward(embedding::Stage::DPLocalReduce); });
+    auto ebc_dp_local_reduce = std::make_shared<StreamContextScheduleable>([=]() {
+      TraceRange range(TraceCategory::Embedding, "ebc_dp_local_reduce");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Backward);
+      ebc_backward(embedding::Stage::DPLocalReduce);
+    });
 
-    auto ebc_dp_allreduce = std::make_shared<StreamContextScheduleable>(
-        [=]() { ebc_backward(embedding::Stage::DPAllreduce); });
+    auto ebc_dp_allreduce = std::make_shared<StreamContextScheduleable>([=]() {
+      TraceRange range(TraceCategory::Communication, "ebc_dp_allreduce");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::AllReduce);
+      ebc_backward(embedding::Stage::DPAllreduce);
+    });
 
     auto ebc_dp_update = std::make_shared<StreamContextScheduleable>([=]() {
+      TraceRange range(TraceCategory::Optimizer, "ebc_dp_update");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Update);
       for (auto& ebc : ebc_list_) {
         ebc->update_per_gpu(local_id, embedding::TablePlacementStrategy::DataParallel);
       }
@@ -661,24 +696,31 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
 
     auto network_init = std::make_shared<StreamContextScheduleable>([=] {
       if (networks[local_id]->use_mixed_precision_ &&
-          networks[local_id]->optimizer_->get_optimizer_type() != Optimizer_t::SGD) {
+          !networks[local_id]->optimizer_->updates_weight_half()) {
         networks[local_id]->conv_weight_(networks[local_id]->train_weight_tensor_half_,
                                          networks[local_id]->train_weight_tensor_);
       }
     });
 
     auto bottom_network_fprop = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Network, "bottom_network_fprop");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Forward);
       networks[local_id]->prop_layers(networks[local_id]->bottom_layers_, true, is_train);
     });
 
-    auto top_network_fprop = std::make_shared<StreamContextScheduleable>(
-        [=] { networks[local_id]->prop_layers(networks[local_id]->top_layers_, true, is_train); });
+    auto top_network_fprop = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Network, "top_network_fprop");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Forward);
+      networks[local_id]->prop_layers(networks[local_id]->top_layers_, true, is_train);
+    });
 
     auto init_wgrad = std::make_shared<StreamContextScheduleable>([=] {
       networks[local_id]->train_losses_.begin()->second->regularizer_initialize_wgrad(is_train);
     });
 
     auto cal_loss = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Network, "cal_loss");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Forward);
       float rterm = networks[local_id]->train_losses_.begin()->second->regularizer_compute_rterm();
       long long current_batchsize_per_device =
           graph_.is_last_train_batch_
@@ -690,25 +732,59 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
           is_train, current_batchsize_per_device, rterm);
     });
 
-    auto top_network_bprop = std::make_shared<StreamContextScheduleable>(
-        [=] { networks[local_id]->prop_layers(networks[local_id]->top_layers_, false, is_train); });
+    auto top_network_bprop = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Network, "top_network_bprop");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Backward);
+      networks[local_id]->prop_layers(networks[local_id]->top_layers_, false, is_train);
+    });
 
     auto bottom_network_bprop = std::make_shared<StreamContextScheduleable>([=] {
+      TraceRange range(TraceCategory::Network, "bottom_network_bprop");
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Backward);
       networks[local_id]->prop_layers(networks[local_id]->bottom_layers_, false, is_train);
     });
 
-    auto network_graph = std::make_shared<GraphScheduleable>(
+    std::vector<std::shared_ptr<Scheduleable>> network_scheduleables = {
         network_init, bottom_network_fprop, top_network_fprop, init_wgrad, cal_loss,
-        top_network_bprop, bottom_network_bprop);
+        top_network_bprop, bottom_network_bprop};
+    // With gpu_learning_rate_scheduling, the learning rate of the step is computed on the gpu
+    // before the network, and the dense and embedding updates read it there.
+    if (networks[local_id]->lr_sched_) {
+      auto lr_sched_update = std::make_shared<StreamContextScheduleable>(
+          [=]() { networks[local_id]->lr_sched_->update(); });
+      network_scheduleables.insert(network_scheduleables.begin(), lr_sched_update);
+    }
+    auto network_graph = std::make_shared<GraphScheduleable>(network_scheduleables);
 
     auto network_exchange_wgrad =
         std::make_shared<StreamContextScheduleable>([=] { this->exchange_wgrad(local_id); });
 
-    auto update_params =
-        std::make_shared<StreamContextScheduleable>([=] { networks[local_id]->update_params(); });
+    auto update_params = std::make_shared<StreamContextScheduleable>([=] {
+      StepTimer::Scope phase(step_timer_.get(), local_id, StepPhase::Update);
+      networks[local_id]->update_params();
+    });
 
     auto sync_back = std::make_shared<StreamContextScheduleable>([] {});
 
+    // The network sides of the model parallel all-to-alls are captured as well, unless some
+    // embedding of their stages reads counts back to the host.
+    const bool capture_mp_network =
+        use_graph && std::all_of(ebc_list_.begin(), ebc_list_.end(), [](const auto& ebc) {
+          return ebc->is_graph_capturable(
+                     {embedding::Stage::MPNetworkdForward, embedding::Stage::HierMPNetworkForward,
+                      embedding::Stage::DenseMPNetworkForward,
+                      embedding::Stage::DPFrequentForward}) &&
+                 ebc->is_graph_capturable({embedding::Stage::MPNetworkBackward,
+                                           embedding::Stage::HierMPNetworkBackward,
+                                           embedding::Stage::DenseMPNetworkBackward});
+        });
+    std::shared_ptr<Scheduleable> mp_network_forward = ebc_mp_network_forward;
+    std::shared_ptr<Scheduleable> mp_network_backward = ebc_mp_network_backward;
+    if (capture_mp_network) {
+      mp_network_forward = std::make_shared<GraphScheduleable>(ebc_mp_network_forward);
+      mp_network_backward = std::make_shared<GraphScheduleable>(ebc_mp_network_backward);
+    }
+
     if (solver_.train_intra_iteration_overlap) {
       std::string dp_stream = "dp";
       ebc_dp_forward->set_stream(dp_stream);
@@ -717,26 +793,30 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
       ebc_dp_local_reduce->set_stream(dp_stream);
       ebc_dp_update->set_stream(dp_stream);
 
+      // The mp stream has the highest priority, so that the lookups and all-to-alls are not
+      // starved by the bottom mlp running alongside them.
       std::string mp_stream = "mp";
-      ebc_mp_model_forward->set_stream(mp_stream);
-      ebc_mp_network_forward->set_stream(mp_stream);
-      ebc_mp_network_backward->set_stream(mp_stream);
-      ebc_mp_local_reduce->set_stream(mp_stream);
-      ebc_mp_update->set_stream(mp_stream);
-
-      // dp_emb_forward, bmlp_fprop wait for mp_emb_model_forward
+      const int mp_priority = -100;
+      ebc_mp_model_forward->set_stream(mp_stream, mp_priority);
+      ebc_mp_network_forward->set_stream(mp_stream, mp_priority);
+      ebc_mp_network_backward->set_stream(mp_stream, mp_priority);
+      ebc_mp_local_reduce->set_stream(mp_stream, mp_priority);
+      ebc_mp_update->set_stream(mp_stream, mp_priority);
+
+      // dp_emb_forward waits for mp_emb_model_forward. bmlp_fprop does not depend on the
+      // embedding, and overlaps with both the mp lookup and its all-to-all.
       auto done_mp_model_forward = ebc_mp_model_forward->record_done();
       ebc_dp_forward->wait_event({done_mp_model_forward});
-      bottom_network_fprop->wait_event({done_mp_model_forward}, use_graph);
 
       // tmlp_fprop wait for embedding
-      auto done_mp_network_forward = ebc_mp_network_forward->record_done();
+      auto done_mp_network_forward = ebc_mp_network_forward->record_done(capture_mp_network);
       auto done_dp_forward = ebc_dp_forward->record_done();
       top_network_fprop->wait_event({done_dp_forward, done_mp_network_forward}, use_graph);
 
-      // mp_emb_bck, dp_emb_bck wait for tmlp bprop
+      // mp_emb_bck, dp_emb_bck wait for tmlp bprop, which computes the embedding gradients. The
+      // backward all-to-all then overlaps with bmlp_bprop and the dense wgrad all-reduce.
       auto done_top_network_bprop = top_network_bprop->record_done(use_graph);
-      ebc_mp_network_backward->wait_event({done_top_network_bprop});
+      ebc_mp_network_backward->wait_event({done_top_network_bprop}, capture_mp_network);
       ebc_dp_local_reduce->wait_event({done_top_network_bprop});
 
       // mp_local_reduce wait mp_backward_index_calculation
@@ -762,12 +842,12 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
       std::vector<std::shared_ptr<Scheduleable>> scheduleable_list = {
           distribute_data,
           ebc_mp_model_forward,
-          ebc_mp_network_forward,
+          mp_network_forward,
           ebc_dp_forward,
           network_graph,
           ebc_mp_backward_index_calculation,
           ebc_dp_backward_index_calculation,
-          ebc_mp_network_backward,
+          mp_network_backward,
           ebc_dp_local_reduce,
           network_exchange_wgrad,
           ebc_dp_allreduce,
@@ -784,6 +864,7 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
     } else {
       auto ebc_cache_train_ddl_output =
           std::make_shared<StreamContextScheduleable>([=, &ddl_output] {
+            TraceRange range(TraceCategory::Embedding, "ebc_cache_train_ddl_output");
             for (auto& ebc : ebc_list_) {
               ebc->cache_ddl_output(local_id, train_ddl_output_[local_id], ddl_output,
                                     train_data_reader_->get_full_batchsize());
@@ -791,22 +872,36 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
           });
 
       auto copy_next_iter_network_input = std::make_shared<StreamContextScheduleable>([=]() {
+        TraceRange range(TraceCategory::DataReader, "copy_next_iter_network_input");
         if (skip_prefetch_in_last_batch(is_train)) return;
 
         graph_.train_copy_ops_[local_id]->run();
         graph_.train_copy_ops_[local_id + resource_manager_->get_local_gpu_count()]->run();
       });
 
+      // Prepares the rows of the keys of the next batch in the tables, e.g. in the gpu caches of
+      // the tables in host memory, while the current batch runs on the other streams.
+      auto ebc_prefetch = std::make_shared<StreamContextScheduleable>([=] {
+        TraceRange range(TraceCategory::Embedding, "ebc_prefetch");
+        if (skip_prefetch_in_last_batch(is_train)) return;
+
+        for (auto& ebc : ebc_list_) {
+          ebc->prefetch_per_gpu(local_id, train_ddl_output_[local_id],
+                                train_data_reader_->get_full_batchsize());
+        }
+      });
+
       std::vector<std::shared_ptr<Scheduleable>> scheduleable_list = {
           ebc_cache_train_ddl_output,
           ebc_mp_model_forward,
-          ebc_mp_network_forward,
+          mp_network_forward,
           ebc_dp_forward,
           network_graph,
           ebc_mp_backward_index_calculation,
           ebc_dp_backward_index_calculation,
           distribute_data,
-          ebc_mp_network_backward,
+          ebc_prefetch,
+          mp_network_backward,
           ebc_dp_local_reduce,
           network_exchange_wgrad,
           ebc_dp_allreduce,
@@ -824,6 +919,7 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
 
       distribute_data->set_absolute_stream(prefetch_stream);
       distribute_data->wait_event({done_ebc_cache_train_ddl_output});
+      ebc_prefetch->set_absolute_stream(prefetch_stream);
 
       auto done_distribute_data = distribute_data->record_done();
       ebc_cache_train_ddl_output->wait_event({done_distribute_data});
@@ -840,14 +936,9 @@ void Model::train_pipeline_with_ebc() {
       CudaCPUDeviceContext ctx(resource_manager_->get_local_gpu(id)->get_device_id());
       HCTR_CHECK(solver_.use_embedding_collection);
       if (is_scheduled_datareader()) {
-        if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<uint32_t>*>(
-                train_data_reader_.get())) {
-          train_data_distributor_->distribute(id, reader->get_current_sparse_values()[id], {},
-                                              train_ddl_output_[id],
-                                              train_data_reader_->get_full_batchsize());
-        } else if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<long long>*>(
-                       train_data_reader_.get())) {
-          train_data_distributor_->distribute(id, reader->get_current_sparse_values()[id], {},
+        if (auto reader = dynamic_cast<SparseValueReader*>(train_data_reader_.get())) {
+          train_data_distributor_->distribute(id, reader->get_current_sparse_values()[id],
+                                              reader->get_current_dp_bucket_ranges()[id],
                                               train_ddl_output_[id],
                                               train_data_reader_->get_full_batchsize());
         }
@@ -878,6 +969,8 @@ void Model::train_pipeline_with_ebc() {
     auto device_id = resource_manager_->get_local_gpu(id)->get_device_id();
     CudaCPUDeviceContext context(device_id);
 
+    TraceRange range(TraceCategory::Iteration,
+                     use_graph ? "train_pipeline_graph" : "train_pipeline");
     if (use_graph) {
       graph_.train_pipeline_[id].run_graph();
     } else {
@@ -901,16 +994,11 @@ void Model::create_evaluate_pipeline_with_ebc(std::vector<std::shared_ptr<Networ
     auto eval_data_distribute = std::make_shared<StreamContextScheduleable>([=] {
       if (skip_prefetch_in_last_batch(is_train)) return;
       if (is_scheduled_datareader()) {
-        if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<uint32_t>*>(
-                evaluate_data_reader_.get())) {
+        if (auto reader = dynamic_cast<SparseValueReader*>(evaluate_data_reader_.get())) {
           eval_data_distributor_->distribute(
-              local_id, reader->get_current_sparse_values()[local_id], {},
-              evaluate_ddl_output_[local_id], evaluate_data_reader_->get_current_batchsize());
-        } else if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<long long>*>(
-                       evaluate_data_reader_.get())) {
-          eval_data_distributor_->distribute(
-              local_id, reader->get_current_sparse_values()[local_id], {},
-              evaluate_ddl_output_[local_id], evaluate_data_reader_->get_current_batchsize());
+              local_id, reader->get_current_sparse_values()[local_id],
+              reader->get_current_dp_bucket_ranges()[local_id], evaluate_ddl_output_[local_id],
+              evaluate_data_reader_->get_current_batchsize());
         }
       } else {
         eval_data_distributor_->distribute(
@@ -940,6 +1028,7 @@ void Model::create_evaluate_pipeline_with_ebc(std::vector<std::shared_ptr<Networ
       ebc_forward(embedding::Stage::MPNetworkdForward);
       ebc_forward(embedding::Stage::HierMPNetworkForward);
       ebc_forward(embedding::Stage::DenseMPNetworkForward);
+      ebc_forward(embedding::Stage::DPFrequentForward);
     });
 
     auto ebc_dp_forward = std::make_shared<StreamContextScheduleable>(
@@ -956,10 +1045,8 @@ void Model::create_evaluate_pipeline_with_ebc(std::vector<std::shared_ptr<Networ
     auto network_graph = std::make_shared<GraphScheduleable>(network_eval);
 
     auto cal_metrics = std::make_shared<StreamContextScheduleable>([=] {
-      for (auto& metric : metrics_) {
-        auto metric_map = networks[local_id]->get_raw_metrics_all().begin()->second;
-        metric->local_reduce(local_id, metric_map);
-      }
+      auto metric_map = networks[local_id]->get_raw_metrics_all().begin()->second;
+      fused_local_reduce_->local_reduce(local_id, metric_map);
     });
 
     if (!solver_.eval_inter_iteration_overlap) {
@@ -1025,14 +1112,9 @@ void Model::evaluate_pipeline_with_ebc() {
       size_t id = omp_get_thread_num();
       CudaCPUDeviceContext ctx(resource_manager_->get_local_gpu(id)->get_device_id());
       if (is_scheduled_datareader()) {
-        if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<uint32_t>*>(
-                evaluate_data_reader_.get())) {
-          eval_data_distributor_->distribute(id, reader->get_current_sparse_values()[id], {},
-                                             evaluate_ddl_output_[id],
-                                             evaluate_data_reader_->get_current_batchsize());
-        } else if (auto reader = dynamic_cast<MultiHot::core23_reader::AsyncDataReader<long long>*>(
-                       evaluate_data_reader_.get())) {
-          eval_data_distributor_->distribute(id, reader->get_current_sparse_values()[id], {},
+        if (auto reader = dynamic_cast<SparseValueReader*>(evaluate_data_reader_.get())) {
+          eval_data_distributor_->distribute(id, reader->get_current_sparse_values()[id],
+                                             reader->get_current_dp_bucket_ranges()[id],
                                              evaluate_ddl_output_[id],
                                              evaluate_data_reader_->get_current_batchsize());
         }
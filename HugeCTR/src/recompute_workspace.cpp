@@ -0,0 +1,120 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <core23/allocator.hpp>
+#include <core23/buffer_channel_helpers.hpp>
+#include <core23/device_guard.hpp>
+#include <core23/logger.hpp>
+#include <core23/macros.hpp>
+#include <memory>
+#include <mutex>
+#include <recompute_workspace.hpp>
+#include <unordered_map>
+
+namespace HugeCTR {
+
+namespace {
+
+class RecomputeWorkspace {
+ public:
+  explicit RecomputeWorkspace(const core23::Device& device) : device_(device) {}
+  ~RecomputeWorkspace() {
+    if (ptr_) {
+      core23::DeviceGuard device_guard(device_);
+      cudaFree(ptr_);
+    }
+  }
+
+  void reserve(int64_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HCTR_THROW_IF(ptr_ != nullptr, Error_t::IllegalCall,
+                  "The recompute workspace has already been allocated");
+    size_ = std::max(size_, size);
+  }
+
+  void* get(int64_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HCTR_THROW_IF(size > size_, Error_t::IllegalCall,
+                  "The buffer is larger than the reserved recompute workspace");
+    if (ptr_ == nullptr) {
+      core23::DeviceGuard device_guard(device_);
+      HCTR_LIB_THROW(cudaMalloc(&ptr_, size_));
+    }
+    return ptr_;
+  }
+
+ private:
+  core23::Device device_;
+  std::mutex mutex_;
+  int64_t size_{0};
+  void* ptr_{nullptr};
+};
+
+// The buffers of all the layers start at the workspace, and don't own it.
+class RecomputeWorkspaceAllocator : public core23::Allocator {
+ public:
+  explicit RecomputeWorkspaceAllocator(const std::shared_ptr<RecomputeWorkspace>& workspace)
+      : workspace_(workspace) {}
+  ~RecomputeWorkspaceAllocator() override {}
+
+  void* allocate(int64_t size, core23::CUDAStream) override { return workspace_->get(size); }
+
+  void deallocate(void*, core23::CUDAStream) override {}
+
+  int64_t default_alignment() const override { return core23::kcudaAllocationAlignment; }
+
+ private:
+  std::shared_ptr<RecomputeWorkspace> workspace_;
+};
+
+// The workspace is freed with the last buffer in it, e.g. when the model is destroyed.
+std::mutex g_workspaces_mutex;
+std::unordered_map<core23::Device, std::weak_ptr<RecomputeWorkspace>> g_workspaces;
+
+std::shared_ptr<RecomputeWorkspace> get_workspace(const core23::Device& device) {
+  std::lock_guard<std::mutex> lock(g_workspaces_mutex);
+  auto workspace = g_workspaces[device].lock();
+  if (!workspace) {
+    workspace = std::make_shared<RecomputeWorkspace>(device);
+    g_workspaces[device] = workspace;
+  }
+  return workspace;
+}
+
+}  // namespace
+
+core23::TensorParams GetRecomputeWorkspaceTensorParams(const core23::TensorParams& params,
+                                                       const std::vector<int64_t>& num_bytes) {
+  auto workspace = get_workspace(params.device());
+  // The buffer aligns each of the tensors to the alignment of the allocator.
+  int64_t size = 0;
+  for (auto bytes : num_bytes) {
+    size += (bytes + core23::kcudaAllocationAlignment - 1) / core23::kcudaAllocationAlignment *
+            core23::kcudaAllocationAlignment;
+  }
+  workspace->reserve(size);
+
+  core23::BufferParams buffer_params = {};
+  buffer_params.channel = core23::GetRandomBufferChannel();
+  core23::AllocatorParams allocator_params = {};
+  allocator_params.custom_factory = [workspace](const auto&, const auto&) {
+    return std::make_unique<RecomputeWorkspaceAllocator>(workspace);
+  };
+  return params.buffer_params(buffer_params).allocator_params(allocator_params);
+}
+
+}  // namespace HugeCTR
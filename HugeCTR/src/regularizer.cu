@@ -78,6 +78,10 @@ void Regularizer<T>::initialize_wgrad() {
     const float* weight = flat_weight_tensor.data();
     T* wgrad = flat_wgrad_tensor.data();
     auto num_elements = flat_weight_tensor.size(0);
+    if (wgrad_fused_) {
+      HCTR_LIB_THROW(cudaMemsetAsync(wgrad, 0, num_elements * sizeof(T), get_gpu().get_stream()));
+      return;
+    }
     do_initialize_wgrad(weight, wgrad, num_elements, get_gpu().get_stream());
   }
 }
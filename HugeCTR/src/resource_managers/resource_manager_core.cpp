@@ -240,6 +240,12 @@ bool ResourceManagerCore::all_p2p_enabled() const {
   return true;
 }
 
+int ResourceManagerCore::get_local_gpu_numa_node(size_t local_gpu_id) const {
+  const auto& numa_nodes = CudaCPUDeviceContext::device_id_to_numa_node_;
+  const auto it = numa_nodes.find(get_local_gpu_device_id_list().at(local_gpu_id));
+  return it != numa_nodes.end() ? it->second : -1;
+}
+
 const std::shared_ptr<rmm::mr::device_memory_resource>&
 ResourceManagerCore::get_device_rmm_device_memory_resource(int local_gpu_id) const {
   auto dev_list = get_local_gpu_device_id_list();
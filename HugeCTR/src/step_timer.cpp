@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <common.hpp>
+#include <core23/logger.hpp>
+#include <step_timer.hpp>
+#include <utils.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+float get_median(std::vector<float> values) {
+  const size_t middle = values.size() / 2;
+  std::nth_element(values.begin(), values.begin() + middle, values.end());
+  return values[middle];
+}
+
+}  // namespace
+
+const char* get_step_phase_name(const StepPhase phase) {
+  switch (phase) {
+    case StepPhase::ReaderWait:
+      return "reader_wait";
+    case StepPhase::Forward:
+      return "forward";
+    case StepPhase::AllToAll:
+      return "all_to_all";
+    case StepPhase::Backward:
+      return "backward";
+    case StepPhase::AllReduce:
+      return "all_reduce";
+    case StepPhase::Update:
+      return "update";
+  }
+  return "unknown";
+}
+
+StepTimer::StepTimer(const std::shared_ptr<ResourceManager>& resource_manager,
+                     const size_t report_interval, const float threshold)
+    : resource_manager_(resource_manager),
+      report_interval_(report_interval),
+      sample_interval_(std::max<size_t>(report_interval / 10, 1)),
+      threshold_(threshold) {
+  HCTR_CHECK_HINT(threshold >= 0.f, "The straggler threshold must not be negative: ", threshold);
+  const size_t num_local_gpus = resource_manager_->get_local_gpu_count();
+  records_.resize(num_local_gpus);
+  captured_records_.resize(num_local_gpus);
+  num_records_.resize(num_local_gpus, 0);
+  gpu_ms_.resize(num_local_gpus, std::array<double, num_step_phases>{});
+}
+
+StepTimer::~StepTimer() {
+  for (size_t id = 0; id < records_.size(); ++id) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(id)->get_device_id());
+    for (const auto* records : {&records_[id], &captured_records_[id]}) {
+      for (const Record& record : *records) {
+        cudaEventDestroy(record.begin);
+        cudaEventDestroy(record.end);
+      }
+    }
+  }
+}
+
+StepTimer::Record& StepTimer::acquire_record(const size_t local_gpu_id, const StepPhase phase,
+                                             const bool captured) {
+  auto& records = captured ? captured_records_[local_gpu_id] : records_[local_gpu_id];
+  if (captured || num_records_[local_gpu_id] == records.size()) {
+    Record record{phase};
+    HCTR_LIB_THROW(cudaEventCreate(&record.begin));
+    HCTR_LIB_THROW(cudaEventCreate(&record.end));
+    records.push_back(record);
+  }
+  Record& record = captured ? records.back() : records[num_records_[local_gpu_id]++];
+  record.phase = phase;
+  return record;
+}
+
+std::optional<StepTimeReport> StepTimer::begin_iteration() {
+  if (!is_enabled()) {
+    return std::nullopt;
+  }
+  if (sampling_) {
+    collect();
+  }
+  ++iteration_;
+  sampling_ = iteration_ % sample_interval_ == 0;
+  if (sampling_) {
+    std::fill(num_records_.begin(), num_records_.end(), 0);
+  }
+  if (iteration_ > window_begin_ && iteration_ % report_interval_ == 0) {
+    return report();
+  }
+  return std::nullopt;
+}
+
+void StepTimer::collect() {
+  for (size_t id = 0; id < records_.size(); ++id) {
+    CudaDeviceContext context(resource_manager_->get_local_gpu(id)->get_device_id());
+    const auto add = [&](const Record& record) {
+      float ms = 0.f;
+      HCTR_LIB_THROW(cudaEventSynchronize(record.end));
+      HCTR_LIB_THROW(cudaEventElapsedTime(&ms, record.begin, record.end));
+      gpu_ms_[id][static_cast<size_t>(record.phase)] += ms;
+    };
+    std::for_each(records_[id].begin(), records_[id].begin() + num_records_[id], add);
+    std::for_each(captured_records_[id].begin(), captured_records_[id].end(), add);
+  }
+  ++num_samples_;
+}
+
+std::optional<StepTimeReport> StepTimer::report() {
+  const size_t num_gpus = resource_manager_->get_global_gpu_count();
+  std::vector<double> times(num_gpus * num_step_phases, 0.);
+  for (size_t id = 0; id < gpu_ms_.size(); ++id) {
+    const size_t global_id = resource_manager_->get_gpu_global_id_from_local_id(id);
+    for (size_t phase = 0; phase < num_step_phases; ++phase) {
+      times[global_id * num_step_phases + phase] =
+          num_samples_ ? (gpu_ms_[id][phase] + host_ms_[phase]) / num_samples_ : 0.;
+    }
+  }
+#ifdef ENABLE_MPI
+  if (resource_manager_->get_num_process() > 1) {
+    HCTR_MPI_THROW(MPI_Reduce(resource_manager_->is_master_process() ? MPI_IN_PLACE : times.data(),
+                              times.data(), static_cast<int>(times.size()), MPI_DOUBLE, MPI_SUM, 0,
+                              MPI_COMM_WORLD));
+  }
+#endif
+  const int64_t window_begin = window_begin_;
+  window_begin_ = iteration_;
+  num_samples_ = 0;
+  for (auto& ms : gpu_ms_) {
+    ms.fill(0.);
+  }
+  host_ms_.fill(0.);
+  if (!resource_manager_->is_master_process()) {
+    return std::nullopt;
+  }
+
+  StepTimeReport report;
+  report.iteration = static_cast<int>(iteration_);
+  for (size_t phase = 0; phase < num_step_phases; ++phase) {
+    report.phases.emplace_back(get_step_phase_name(static_cast<StepPhase>(phase)));
+  }
+  report.gpu_phase_ms.resize(num_gpus, std::vector<float>(num_step_phases));
+  report.gpu_step_ms.resize(num_gpus, 0.f);
+  for (size_t gpu = 0; gpu < num_gpus; ++gpu) {
+    for (size_t phase = 0; phase < num_step_phases; ++phase) {
+      report.gpu_phase_ms[gpu][phase] = static_cast<float>(times[gpu * num_step_phases + phase]);
+      report.gpu_step_ms[gpu] += report.gpu_phase_ms[gpu][phase];
+    }
+  }
+  report.median_step_ms = get_median(report.gpu_step_ms);
+
+  std::array<float, num_step_phases> median_phase_ms;
+  for (size_t phase = 0; phase < num_step_phases; ++phase) {
+    std::vector<float> phase_ms(num_gpus);
+    for (size_t gpu = 0; gpu < num_gpus; ++gpu) {
+      phase_ms[gpu] = report.gpu_phase_ms[gpu][phase];
+    }
+    median_phase_ms[phase] = get_median(phase_ms);
+  }
+  for (size_t gpu = 0; gpu < num_gpus; ++gpu) {
+    size_t straggling_phase = 0;
+    float max_excess_ms = 0.f;
+    for (size_t phase = 0; phase < num_step_phases; ++phase) {
+      const float excess_ms = report.gpu_phase_ms[gpu][phase] - median_phase_ms[phase];
+      if (excess_ms > max_excess_ms) {
+        straggling_phase = phase;
+        max_excess_ms = excess_ms;
+      }
+    }
+    if (max_excess_ms > threshold_ * report.median_step_ms) {
+      report.stragglers.push_back(static_cast<int>(gpu));
+      report.straggling_phases.push_back(report.phases[straggling_phase]);
+      HCTR_LOG_S(WARNING, ROOT) << "Straggler in iterations " << window_begin << "-" << iteration_
+                                << ": GPU " << gpu << " of process "
+                                << resource_manager_->get_process_id_from_gpu_global_id(gpu)
+                                << " takes " << report.gpu_phase_ms[gpu][straggling_phase]
+                                << " ms in " << report.phases[straggling_phase]
+                                << ", the median is " << median_phase_ms[straggling_phase]
+                                << " ms" << std::endl;
+    }
+  }
+
+  const auto slowest = std::max_element(report.gpu_step_ms.begin(), report.gpu_step_ms.end());
+  auto log = HCTR_LOG_S(INFO, ROOT);
+  log << "Step time in iterations " << window_begin << "-" << iteration_ << ": median "
+      << report.median_step_ms << " ms, slowest GPU " << slowest - report.gpu_step_ms.begin()
+      << " " << *slowest << " ms, median phases";
+  for (size_t phase = 0; phase < num_step_phases; ++phase) {
+    log << " " << report.phases[phase] << " " << median_phase_ms[phase] << " ms";
+  }
+  log << std::endl;
+  return report;
+}
+
+StepTimer::Scope::Scope(StepTimer* const timer, const size_t local_gpu_id, const StepPhase phase)
+    : local_gpu_id_(local_gpu_id) {
+  if (!timer || !timer->is_enabled()) {
+    return;
+  }
+  stream_ = timer->resource_manager_->get_local_gpu(local_gpu_id)->get_stream();
+  cudaStreamCaptureStatus status;
+  HCTR_LIB_THROW(cudaStreamIsCapturing(stream_, &status));
+  captured_ = status == cudaStreamCaptureStatusActive;
+  if (!captured_ && !timer->sampling_) {
+    return;
+  }
+  timer_ = timer;
+  const Record& record = timer_->acquire_record(local_gpu_id, phase, captured_);
+  end_ = record.end;
+  HCTR_LIB_THROW(cudaEventRecordWithFlags(
+      record.begin, stream_, captured_ ? cudaEventRecordExternal : cudaEventRecordDefault));
+}
+
+StepTimer::Scope::~Scope() {
+  if (timer_) {
+    cudaEventRecordWithFlags(end_, stream_,
+                             captured_ ? cudaEventRecordExternal : cudaEventRecordDefault);
+  }
+}
+
+StepTimer::HostScope::HostScope(StepTimer* const timer, const StepPhase phase) : phase_(phase) {
+  if (timer && timer->is_enabled() && timer->sampling_) {
+    timer_ = timer;
+    begin_ = std::chrono::steady_clock::now();
+  }
+}
+
+StepTimer::HostScope::~HostScope() {
+  if (timer_) {
+    const std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - begin_;
+    timer_->host_ms_[static_cast<size_t>(phase_)] += ms.count();
+  }
+}
+
+}  // namespace HugeCTR
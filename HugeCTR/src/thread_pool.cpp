@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <numa.h>
+
 #include <core23/logger.hpp>
 #include <cstdlib>
 #include <iostream>
@@ -21,10 +23,35 @@
 
 namespace HugeCTR {
 
+namespace {
+
+// Pool and queue of the worker that is the current thread, if it is one.
+thread_local const ThreadPool* g_worker_pool = nullptr;
+thread_local size_t g_worker_index = 0;
+
+// Priority of the task that the current thread runs.
+thread_local ThreadPool::Priority g_task_priority = ThreadPool::Priority::Foreground;
+
+}  // namespace
+
 ThreadPool::ThreadPool(const std::string& name) : ThreadPool(name, 0) {}
 
-ThreadPool::ThreadPool(const std::string& name, size_t num_workers) : name_(name) {
+ThreadPool::ThreadPool(const std::string& name, size_t num_workers)
+    : ThreadPool(name, num_workers, -1) {}
+
+ThreadPool::ThreadPool(const std::string& name, size_t num_workers, const int numa_node)
+    : name_(name), numa_node_(numa_node) {
+  HCTR_CHECK_HINT(numa_node < 0 || (numa_available() >= 0 && numa_node <= numa_max_node()),
+                  "NUMA node ", numa_node, " is not available!");
+
   // Determine eventual number of threads.
+  if (num_workers == 0 && numa_node >= 0) {
+    bitmask* const cpu_mask{numa_allocate_cpumask()};
+    if (numa_node_to_cpus(numa_node, cpu_mask) == 0) {
+      num_workers = numa_bitmask_weight(cpu_mask);
+    }
+    numa_free_cpumask(cpu_mask);
+  }
   if (num_workers == 0) {
     const char* num_workers_str = getenv("HCTR_DEFAULT_CONCURRENCY");
     if (num_workers_str) {
@@ -34,13 +61,13 @@ ThreadPool::ThreadPool(const std::string& name, size_t num_workers) : name_(name
     }
   }
 
-  // Create worker threads.
+  // Create worker queues and threads.
+  for (size_t i = 0; i < num_workers; i++) {
+    queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
   for (size_t i = 0; i < num_workers; i++) {
     workers_.emplace_back(&ThreadPool::run_, this, i);
   }
-
-  // Block until all workers entered the idle state.
-  await_idle();
 }
 
 ThreadPool::~ThreadPool() {
@@ -49,6 +76,7 @@ ThreadPool::~ThreadPool() {
     std::lock_guard<std::mutex> lock(barrier_);
     terminate_ = true;
     submit_sempahore_.notify_all();
+    idle_semaphore_.notify_all();
   }
 
   // Wait for the worker threads to exit.
@@ -57,18 +85,14 @@ ThreadPool::~ThreadPool() {
   }
 }
 
-bool ThreadPool::idle() const {
-  // Momentarily request exclusive access, and read out the idle status.
-  std::lock_guard<std::mutex> lock(barrier_);
-  return num_idle_workers_ == workers_.size() && packages_.empty();
-}
+bool ThreadPool::idle() const { return num_pending_packages_ == 0; }
 
 void ThreadPool::await_idle() const {
   // Momentarily request exclusive access.
   std::unique_lock<std::mutex> lock(barrier_);
 
-  // Are we idle already? If not wait for a worker to exit.
-  while (num_idle_workers_ != workers_.size() || !packages_.empty()) {
+  // Are we idle already? If not wait for the last task to finish.
+  while (num_pending_packages_ != 0) {
     if (terminate_) {
       HCTR_OWN_THROW(Error_t::IllegalCall, "Attempted to await an already terminated ThreadPool!");
     }
@@ -77,21 +101,35 @@ void ThreadPool::await_idle() const {
 }
 
 std::future<void> ThreadPool::submit(std::function<void()> task) {
+  return submit(std::move(task), g_task_priority);
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task, const Priority priority) {
+  if (terminate_) {
+    HCTR_OWN_THROW(Error_t::IllegalCall,
+                   "Attempted to submit work to an already terminated ThreadPool!");
+  }
   std::packaged_task<void()> package(std::move(task));
   std::future<void> result = package.get_future();
 
-  // Momentarily request exclusive access, to submit the task.
+  // Workers keep their own work, so that it stays in their cache.
+  const size_t queue_index =
+      g_worker_pool == this ? g_worker_index : next_queue_.fetch_add(1) % queues_.size();
+  WorkerQueue& queue = *queues_[queue_index];
+  const size_t p = static_cast<size_t>(priority);
+  num_pending_packages_ += 1;
   {
-    std::lock_guard<std::mutex> lock(barrier_);
-    if (terminate_) {
-      HCTR_OWN_THROW(Error_t::IllegalCall,
-                     "Attempted to submit work to an already terminated ThreadPool!");
-    }
-    packages_.emplace_back(std::move(package));
+    std::lock_guard<std::mutex> lock(queue.barrier);
+    queue.packages[p].emplace_back(std::move(package));
+    queue.num_packages[p] += 1;
   }
 
-  // Wake up a worker.
-  submit_sempahore_.notify_one();
+  // Wake up a worker. A worker counts itself as sleeping before it looks for work the last time,
+  // so that either it finds this task, or it is counted here.
+  if (num_sleeping_workers_ > 0) {
+    std::lock_guard<std::mutex> lock(barrier_);
+    submit_sempahore_.notify_one();
+  }
 
   return result;
 }
@@ -104,44 +142,80 @@ ThreadPool& ThreadPool::get() {
   return *default_pool.get();
 }
 
+bool ThreadPool::take_(const size_t thread_index, std::packaged_task<void()>& package,
+                       Priority& priority) {
+  const size_t num_queues = queues_.size();
+  for (size_t p = 0; p < num_priorities_; ++p) {
+    for (size_t i = 0; i < num_queues; ++i) {
+      WorkerQueue& queue = *queues_[(thread_index + i) % num_queues];
+      if (queue.num_packages[p] == 0) {
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(queue.barrier);
+      auto& packages = queue.packages[p];
+      if (packages.empty()) {
+        continue;
+      }
+      // The owner takes the oldest task, and a thief the newest one, which the owner would take
+      // last.
+      if (i == 0) {
+        package = std::move(packages.front());
+        packages.pop_front();
+      } else {
+        package = std::move(packages.back());
+        packages.pop_back();
+      }
+      queue.num_packages[p] -= 1;
+      priority = static_cast<Priority>(p);
+      return true;
+    }
+  }
+  return false;
+}
+
 void ThreadPool::run_(const size_t thread_index) {
   if (name_ != "") {
     Logger::set_thread_name(name_ + " #" + std::to_string(thread_index));
   }
+  if (numa_node_ >= 0) {
+    numa_run_on_node(numa_node_);
+    numa_set_preferred(numa_node_);
+  }
+  g_worker_pool = this;
+  g_worker_index = thread_index;
+
+  std::packaged_task<void()> package;
+  Priority priority{Priority::Foreground};
   while (true) {
-    thread_local std::packaged_task<void()> package;
+    // If termination request occurred.
+    if (terminate_) {
+      return;
+    }
 
-    // Acquire exclusive access.
-    {
+    if (!take_(thread_index, package, priority)) {
+      // Enter the sleep state, and look for work once more before waiting for a task.
       std::unique_lock barrier_lock(barrier_);
-
-      // If termination request occurred.
-      if (terminate_) {
-        return;
-      }
-
-      // If no work package queued.
-      while (packages_.empty()) {
-        // Enter idle state (notify threads that wait for the threadpool to go idle).
-        num_idle_workers_ += 1;
-        idle_semaphore_.notify_all();
-
-        // Wait for a task.
+      num_sleeping_workers_ += 1;
+      while (!terminate_ && !take_(thread_index, package, priority)) {
         submit_sempahore_.wait(barrier_lock);
-        num_idle_workers_ -= 1;
-
-        // If woken up by terminate request.
-        if (terminate_) {
-          return;
-        }
       }
-
-      package = std::move(packages_.front());
-      packages_.pop_front();
+      num_sleeping_workers_ -= 1;
+      if (!package.valid()) {
+        return;
+      }
     }
 
     // Execute work package.
+    g_task_priority = priority;
     package();
+    package = {};
+    g_task_priority = Priority::Foreground;
+
+    // Notify the threads that wait for the threadpool to go idle.
+    if (num_pending_packages_.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> lock(barrier_);
+      idle_semaphore_.notify_all();
+    }
   }
 }
 
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nvToolsExt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <core23/logger.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <timeline.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+struct CategoryInfo {
+  const char* name;
+  uint32_t color;
+};
+
+// Indexed by TraceCategory.
+constexpr CategoryInfo category_infos[] = {{"", 0},
+                                           {"iteration", 0xff76b900},
+                                           {"data_reader", 0xff1f77b4},
+                                           {"embedding", 0xffff7f0e},
+                                           {"network", 0xff2ca02c},
+                                           {"communication", 0xffd62728},
+                                           {"optimizer", 0xff9467bd}};
+
+const auto g_time_origin = std::chrono::steady_clock::now();
+
+int get_thread_id() {
+  static std::atomic<int> next_thread_id{0};
+  thread_local const int thread_id = next_thread_id++;
+  return thread_id;
+}
+
+int64_t get_env(const char* name, const int64_t default_value) {
+  const char* const value = std::getenv(name);
+  return value ? std::atoll(value) : default_value;
+}
+
+}  // namespace
+
+Timeline& Timeline::get() {
+  static Timeline* timeline = new Timeline;
+  return *timeline;
+}
+
+Timeline::Timeline() {
+  for (uint32_t category = 1; category < std::size(category_infos); ++category) {
+    nvtxNameCategoryA(category, category_infos[category].name);
+  }
+  const char* const path = std::getenv("HUGECTR_TRACE_FILE");
+  configure(path ? path : "", get_env("HUGECTR_TRACE_INTERVAL", interval_),
+            get_env("HUGECTR_TRACE_ITERATIONS", num_iterations_));
+}
+
+void Timeline::configure(const std::string& path, const int64_t interval,
+                         const int64_t num_iterations) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  path_ = path;
+  interval_ = std::max<int64_t>(interval, 1);
+  num_iterations_ = num_iterations;
+  num_recorded_iterations_ = 0;
+  events_.clear();
+  if (!path_.empty()) {
+    HCTR_LOG_S(INFO, ROOT) << "Tracing " << num_iterations_ << " iterations, one every "
+                           << interval_ << ", to " << path_ << std::endl;
+  }
+}
+
+void Timeline::set_rank(const int rank) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  rank_ = rank;
+}
+
+void Timeline::begin_iteration() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++iteration_;
+  if (!path_.empty() && num_recorded_iterations_ < num_iterations_ &&
+      (iteration_ + 1) % interval_ == 0) {
+    iteration_begin_us_ = now_us();
+    recording_.store(true, std::memory_order_relaxed);
+  }
+}
+
+void Timeline::end_iteration() {
+  if (!is_recording()) {
+    return;
+  }
+  record(TraceCategory::Iteration, "iteration", iteration_begin_us_, now_us());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  recording_.store(false, std::memory_order_relaxed);
+  ++num_recorded_iterations_;
+  write_trace();
+}
+
+int64_t Timeline::now_us() const {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                               g_time_origin)
+      .count();
+}
+
+void Timeline::record(const TraceCategory category, const char* const name,
+                      const int64_t begin_us, const int64_t end_us) {
+  const int thread_id = get_thread_id();
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.push_back({category, name, begin_us, end_us, thread_id, iteration_});
+}
+
+void Timeline::write_trace() {
+  nlohmann::json trace_events = nlohmann::json::array();
+  for (const Event& event : events_) {
+    trace_events.push_back({{"name", event.name},
+                            {"cat", category_infos[static_cast<uint32_t>(event.category)].name},
+                            {"ph", "X"},
+                            {"ts", event.begin_us},
+                            {"dur", event.end_us - event.begin_us},
+                            {"pid", rank_},
+                            {"tid", event.thread_id},
+                            {"args", {{"iteration", event.iteration}}}});
+  }
+  const nlohmann::json trace{{"traceEvents", trace_events}, {"displayTimeUnit", "ms"}};
+
+  std::string path = path_;
+  for (size_t pos; (pos = path.find("%r")) != std::string::npos;) {
+    path.replace(pos, 2, std::to_string(rank_));
+  }
+  // A trace that can't be written must not stop the training.
+  std::ofstream file(path, std::ofstream::trunc);
+  file << trace.dump() << std::endl;
+  if (!file) {
+    HCTR_LOG_S(WARNING, WORLD) << "Cannot write the trace to " << path << std::endl;
+  }
+}
+
+TraceRange::TraceRange(const TraceCategory category, const char* const name)
+    : category_(category), name_(name), begin_us_(-1) {
+  Timeline& timeline = Timeline::get();
+  nvtxEventAttributes_t attributes = {};
+  attributes.version = NVTX_VERSION;
+  attributes.size = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+  attributes.category = static_cast<uint32_t>(category);
+  attributes.colorType = NVTX_COLOR_ARGB;
+  attributes.color = category_infos[static_cast<uint32_t>(category)].color;
+  attributes.messageType = NVTX_MESSAGE_TYPE_ASCII;
+  attributes.message.ascii = name;
+  nvtxRangePushEx(&attributes);
+  if (timeline.is_recording()) {
+    begin_us_ = timeline.now_us();
+  }
+}
+
+TraceRange::~TraceRange() {
+  nvtxRangePop();
+  if (begin_us_ >= 0) {
+    Timeline& timeline = Timeline::get();
+    timeline.record(category_, name_, begin_us_, timeline.now_us());
+  }
+}
+
+}  // namespace HugeCTR
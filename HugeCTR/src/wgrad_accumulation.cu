@@ -0,0 +1,67 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <utils.cuh>
+
+namespace HugeCTR {
+
+namespace {
+
+template <typename T>
+__global__ void accumulate_wgrad_kernel(float* accumulator, const T* wgrad, size_t count,
+                                        bool first) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < count; i += blockDim.x * gridDim.x) {
+    const float value = TypeConvertFunc<float, T>::convert(wgrad[i]);
+    accumulator[i] = first ? value : accumulator[i] + value;
+  }
+}
+
+template <typename T>
+__global__ void average_accumulated_wgrad_kernel(T* wgrad, const float* accumulator, size_t count,
+                                                 float scale) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < count; i += blockDim.x * gridDim.x) {
+    const float sum = accumulator[i] + TypeConvertFunc<float, T>::convert(wgrad[i]);
+    wgrad[i] = TypeConvertFunc<T, float>::convert(sum * scale);
+  }
+}
+
+}  // namespace
+
+void accumulate_wgrad_gpu(size_t grid, size_t block, float* accumulator, const void* wgrad,
+                          size_t count, bool first, bool half, cudaStream_t stream) {
+  if (half) {
+    accumulate_wgrad_kernel<<<grid, block, 0, stream>>>(
+        accumulator, static_cast<const __half*>(wgrad), count, first);
+  } else {
+    accumulate_wgrad_kernel<<<grid, block, 0, stream>>>(
+        accumulator, static_cast<const float*>(wgrad), count, first);
+  }
+}
+
+void average_accumulated_wgrad_gpu(size_t grid, size_t block, void* wgrad,
+                                   const float* accumulator, size_t count, float scale, bool half,
+                                   cudaStream_t stream) {
+  if (half) {
+    average_accumulated_wgrad_kernel<<<grid, block, 0, stream>>>(static_cast<__half*>(wgrad),
+                                                                 accumulator, count, scale);
+  } else {
+    average_accumulated_wgrad_kernel<<<grid, block, 0, stream>>>(static_cast<float*>(wgrad),
+                                                                 accumulator, count, scale);
+  }
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,88 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+
+#include <type_traits>
+
+namespace HugeCTR {
+
+namespace {
+
+template <typename T>
+__device__ __forceinline__ T round_wgrad(float value) {
+  if constexpr (std::is_same_v<T, __nv_bfloat16>) {
+    return __float2bfloat16(value);
+  } else {
+    return __float2half(value);
+  }
+}
+
+template <typename T>
+__device__ __forceinline__ float widen_wgrad(T value) {
+  if constexpr (std::is_same_v<T, __nv_bfloat16>) {
+    return __bfloat162float(value);
+  } else {
+    return __half2float(value);
+  }
+}
+
+// The wgrad plus the residual of the last iteration is rounded, and the rounding error becomes the
+// residual of the next iteration.
+template <typename T>
+__global__ void compress_wgrad_kernel(T* dst, float* residual, const float* wgrad, size_t count) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < count; i += blockDim.x * gridDim.x) {
+    const float value = wgrad[i] + residual[i];
+    const T rounded = round_wgrad<T>(value);
+    residual[i] = value - widen_wgrad(rounded);
+    dst[i] = rounded;
+  }
+}
+
+template <typename T>
+__global__ void decompress_wgrad_kernel(float* wgrad, const T* src, size_t count) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < count; i += blockDim.x * gridDim.x) {
+    wgrad[i] = widen_wgrad(src[i]);
+  }
+}
+
+}  // namespace
+
+void compress_wgrad_gpu(size_t grid, size_t block, void* dst, float* residual, const float* wgrad,
+                        size_t count, bool bf16, cudaStream_t stream) {
+  if (bf16) {
+    compress_wgrad_kernel<<<grid, block, 0, stream>>>(static_cast<__nv_bfloat16*>(dst), residual,
+                                                      wgrad, count);
+  } else {
+    compress_wgrad_kernel<<<grid, block, 0, stream>>>(static_cast<__half*>(dst), residual, wgrad,
+                                                      count);
+  }
+}
+
+void decompress_wgrad_gpu(size_t grid, size_t block, float* wgrad, const void* src, size_t count,
+                          bool bf16, cudaStream_t stream) {
+  if (bf16) {
+    decompress_wgrad_kernel<<<grid, block, 0, stream>>>(
+        wgrad, static_cast<const __nv_bfloat16*>(src), count);
+  } else {
+    decompress_wgrad_kernel<<<grid, block, 0, stream>>>(wgrad, static_cast<const __half*>(src),
+                                                        count);
+  }
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,551 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <core/hctr_impl/hctr_backend.hpp>
+#include <core23/buffer_factory.hpp>
+#include <core23/logger.hpp>
+#include <core23/tensor_operations.hpp>
+#include <ctime>
+#include <embedding/common.hpp>
+#include <embedding/data_distributor/data_distributor.hpp>
+#include <embedding_storage/dynamic_embedding.hpp>
+#include <embeddings/embedding_collection.hpp>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <random>
+#include <resource_managers/resource_manager_ext.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Micro-benchmarks of the operators of a training step of the embedding collection. Each operator
+ * is timed on its own, for every combination of the values of the shape flags, which take comma
+ * separated lists:
+ *
+ *   embedding_operators_bench --tables=26 --hotness=1,20 --ev_size=16,128 --batch_size=8192 \
+ *       --gpus=1,2 --benchmark_filter=Forward --benchmark_out=result.json
+ *
+ * All tables are model parallel and placed round-robin. The batch size is per GPU. The results
+ * are written in the JSON format of Google Benchmark, so that two runs can be diffed with its
+ * compare.py.
+ */
+
+using namespace embedding;
+
+namespace {
+
+using Key = uint32_t;
+using Offset = uint32_t;
+using Index = uint32_t;
+using Emb = float;
+
+struct Shape {
+  int num_tables;
+  int hotness;
+  int ev_size;
+  int batch_size_per_gpu;
+  int num_gpus;
+  int vocabulary_size;
+};
+
+std::string to_string(const Shape& shape) {
+  std::ostringstream os;
+  os << "tables:" << shape.num_tables << "/hotness:" << shape.hotness
+     << "/ev_size:" << shape.ev_size << "/batch_size:" << shape.batch_size_per_gpu
+     << "/gpus:" << shape.num_gpus;
+  return os.str();
+}
+
+struct Flags {
+  std::vector<int> tables{26};
+  std::vector<int> hotness{1, 20};
+  std::vector<int> ev_size{16, 128};
+  std::vector<int> batch_size{8192};
+  std::vector<int> gpus{1};
+  int vocabulary_size{1000000};
+  int warmup{10};
+  int iterations{100};
+  uint64_t seed{4711};
+  std::string filter;
+  std::string out;
+};
+
+std::vector<int> parse_list(const std::string& value) {
+  std::vector<int> list;
+  std::istringstream is(value);
+  for (std::string item; std::getline(is, item, ',');) {
+    list.push_back(std::stoi(item));
+    HCTR_CHECK_HINT(list.back() > 0, "Shape values must be positive: ", value);
+  }
+  HCTR_CHECK_HINT(!list.empty(), "Empty list of shape values.");
+  return list;
+}
+
+Flags parse_flags(const int argc, char** const argv) {
+  Flags flags;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const size_t eq = arg.find('=');
+    HCTR_CHECK_HINT(arg.rfind("--", 0) == 0 && eq != std::string::npos,
+                    "Expected --flag=value, got ", arg);
+    const std::string name = arg.substr(2, eq - 2);
+    const std::string value = arg.substr(eq + 1);
+    if (name == "tables") {
+      flags.tables = parse_list(value);
+    } else if (name == "hotness") {
+      flags.hotness = parse_list(value);
+    } else if (name == "ev_size") {
+      flags.ev_size = parse_list(value);
+    } else if (name == "batch_size") {
+      flags.batch_size = parse_list(value);
+    } else if (name == "gpus") {
+      flags.gpus = parse_list(value);
+    } else if (name == "vocabulary_size") {
+      flags.vocabulary_size = std::stoi(value);
+    } else if (name == "warmup") {
+      flags.warmup = std::stoi(value);
+    } else if (name == "iterations") {
+      flags.iterations = std::stoi(value);
+    } else if (name == "seed") {
+      flags.seed = std::stoull(value);
+    } else if (name == "benchmark_filter") {
+      flags.filter = value;
+    } else if (name == "benchmark_out") {
+      flags.out = value;
+    } else {
+      HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput, "Unknown flag: " + arg);
+    }
+  }
+  HCTR_CHECK_HINT(flags.iterations > 0, "At least one iteration is required.");
+  return flags;
+}
+
+EmbeddingCollectionParam make_ebc_param(const Shape& shape) {
+  std::vector<LookupParam> lookup_params;
+  std::vector<std::vector<int>> shard_matrix(shape.num_gpus,
+                                             std::vector<int>(shape.num_tables, 0));
+  std::vector<int> table_ids(shape.num_tables);
+  for (int table_id = 0; table_id < shape.num_tables; ++table_id) {
+    lookup_params.emplace_back(table_id, table_id, Combiner::Sum, shape.hotness, shape.ev_size);
+    shard_matrix[table_id % shape.num_gpus][table_id] = 1;
+    table_ids[table_id] = table_id;
+  }
+  const std::vector<GroupedTableParam> grouped_table_params{
+      {TablePlacementStrategy::ModelParallel, table_ids}};
+
+  return EmbeddingCollectionParam(shape.num_tables, shape.num_tables, lookup_params, shard_matrix,
+                                  grouped_table_params, shape.batch_size_per_gpu * shape.num_gpus,
+                                  HugeCTR::core23::ToScalarType<Key>::value,
+                                  HugeCTR::core23::ToScalarType<Index>::value,
+                                  HugeCTR::core23::ToScalarType<Offset>::value,
+                                  HugeCTR::core23::ToScalarType<Emb>::value,
+                                  HugeCTR::core23::ToScalarType<Emb>::value,
+                                  EmbeddingLayout::FeatureMajor, EmbeddingLayout::FeatureMajor,
+                                  SortStrategy::Radix, KeysPreprocessStrategy::None,
+                                  AllreduceStrategy::Dense, CommunicationStrategy::Uniform);
+}
+
+std::vector<EmbeddingTableParam> make_table_params(const Shape& shape,
+                                                   const int max_vocabulary_size) {
+  const HugeCTR::OptParams sgd{.optimizer = HugeCTR::Optimizer_t::SGD, .lr = 1e-3, .scaler = 1};
+  std::vector<EmbeddingTableParam> table_params;
+  for (int table_id = 0; table_id < shape.num_tables; ++table_id) {
+    table_params.emplace_back(table_id, max_vocabulary_size, shape.ev_size, sgd);
+  }
+  return table_params;
+}
+
+/**
+ * Embedding collection of a shape, together with the data distributor that feeds it, the
+ * dynamic embedding tables of the same tables, and one batch of random input.
+ */
+class EmbeddingCollectionBench {
+ public:
+  EmbeddingCollectionBench(const Shape& shape, const uint64_t seed)
+      : shape_(shape),
+        ebc_param_(make_ebc_param(shape)),
+        table_params_(make_table_params(shape, shape.vocabulary_size)) {
+    HCTR_CHECK_HINT(shape.num_tables >= shape.num_gpus, "Every GPU needs a table, but there are ",
+                    shape.num_tables, " tables for ", shape.num_gpus, " GPUs.");
+    std::vector<int> device_list(shape.num_gpus);
+    std::iota(device_list.begin(), device_list.end(), 0);
+    resource_manager_ = HugeCTR::ResourceManagerExt::create({device_list}, 0);
+    for (int gpu_id = 0; gpu_id < shape.num_gpus; ++gpu_id) {
+      cores_.push_back(
+          std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager_, gpu_id));
+    }
+
+    const int64_t num_ev =
+        static_cast<int64_t>(shape.num_tables) * shape.ev_size * shape.batch_size_per_gpu;
+    const std::vector<EmbeddingTableParam> dynamic_table_params = make_table_params(shape, -1);
+    for (int gpu_id = 0; gpu_id < shape.num_gpus; ++gpu_id) {
+      HugeCTR::CudaDeviceContext context(cores_[gpu_id]->get_device_id());
+      const core23::TensorParams params = core23::TensorParams().device(
+          core23::Device(core23::DeviceType::GPU, cores_[gpu_id]->get_device_id()));
+
+      std::vector<core23::Tensor> keys, bucket_range;
+      for (int table_id = 0; table_id < shape.num_tables; ++table_id) {
+        keys.emplace_back(params.shape({shape.batch_size_per_gpu, shape.hotness})
+                              .data_type(ebc_param_.key_type));
+        bucket_range.emplace_back(
+            params.shape({shape.batch_size_per_gpu + 1}).data_type(ebc_param_.offset_type));
+      }
+      dp_keys_.push_back(std::move(keys));
+      dp_bucket_range_.push_back(std::move(bucket_range));
+      top_grads_.emplace_back(params.shape({num_ev}).data_type(ebc_param_.emb_type));
+      outputs_.emplace_back(params.shape({num_ev}).data_type(ebc_param_.emb_type));
+
+      dynamic_tables_.push_back(std::make_unique<DynamicEmbeddingTable>(
+          *resource_manager_->get_local_gpu(gpu_id), cores_[gpu_id], dynamic_table_params,
+          ebc_param_, 0, dynamic_table_params[0].opt_param));
+    }
+
+    data_distributor_ =
+        std::make_unique<HugeCTR::DataDistributor>(cores_, ebc_param_, table_params_);
+    for (int gpu_id = 0; gpu_id < shape.num_gpus; ++gpu_id) {
+      HugeCTR::CudaDeviceContext context(cores_[gpu_id]->get_device_id());
+      data_distributor_outputs_.push_back(
+          HugeCTR::allocate_output_for_data_distributor(cores_[gpu_id], ebc_param_));
+    }
+    ebc_ = std::make_unique<EmbeddingCollection>(resource_manager_, cores_, ebc_param_, ebc_param_,
+                                                 table_params_);
+
+    for (int gpu_id = 0; gpu_id < shape.num_gpus; ++gpu_id) {
+      core23::AllocateBuffers(
+          core23::Device(core23::DeviceType::GPU, cores_[gpu_id]->get_device_id()));
+    }
+    core23::AllocateBuffers(core23::Device(core23::DeviceType::CPU));
+
+    generate_input(seed);
+    sync();
+  }
+
+  const Shape& shape() const { return shape_; }
+
+  int global_batch_size() const { return shape_.batch_size_per_gpu * shape_.num_gpus; }
+
+  // Number of keys of the batch of all GPUs.
+  int64_t num_keys() const {
+    return static_cast<int64_t>(global_batch_size()) * shape_.num_tables * shape_.hotness;
+  }
+
+  // Runs op for each GPU on a thread of its own, and waits for all of their streams.
+  void run_on_all_gpus(const std::function<void(int)>& op) {
+#pragma omp parallel for num_threads(shape_.num_gpus)
+    for (int gpu_id = 0; gpu_id < shape_.num_gpus; ++gpu_id) {
+      HugeCTR::CudaDeviceContext context(cores_[gpu_id]->get_device_id());
+      op(gpu_id);
+    }
+    sync();
+  }
+
+  void distribute(const int gpu_id) {
+    data_distributor_->distribute(gpu_id, dp_keys_[gpu_id], dp_bucket_range_[gpu_id],
+                                  data_distributor_outputs_[gpu_id], global_batch_size());
+  }
+
+  void forward(const Stage stage, const int gpu_id) {
+    ebc_->forward_per_gpu(stage, true, gpu_id, data_distributor_outputs_[gpu_id], outputs_[gpu_id],
+                          global_batch_size());
+  }
+
+  void backward(const Stage stage, const int gpu_id) {
+    ebc_->backward_per_gpu(stage, gpu_id, data_distributor_outputs_[gpu_id], top_grads_[gpu_id],
+                           global_batch_size());
+  }
+
+  // Runs one training step, so that each stage finds the results of the ones before it.
+  void train_step(const int gpu_id) {
+    distribute(gpu_id);
+    ebc_->forward_per_gpu(true, gpu_id, data_distributor_outputs_[gpu_id], outputs_[gpu_id],
+                          global_batch_size());
+    ebc_->backward_per_gpu(gpu_id, data_distributor_outputs_[gpu_id], top_grads_[gpu_id],
+                           global_batch_size());
+  }
+
+  void update(const int gpu_id) {
+    ebc_->update_per_gpu(gpu_id, TablePlacementStrategy::ModelParallel);
+  }
+
+  void dynamic_lookup(const int gpu_id) {
+    auto& input = dynamic_lookup_inputs_[gpu_id];
+    dynamic_tables_[gpu_id]->lookup(input.keys, input.num_keys, input.id_space_offset,
+                                    input.id_space_offset.num_elements(), input.id_space_list,
+                                    input.emb_vec);
+  }
+
+ private:
+  // Unique keys of the batch of a GPU for the dynamic tables, grouped by table.
+  struct DynamicLookupInput {
+    core23::Tensor keys;
+    size_t num_keys;
+    core23::Tensor id_space_offset;
+    core23::Tensor id_space_list;
+    core23::Tensor emb_vec;
+  };
+
+  void sync() {
+    for (auto& core : cores_) {
+      HugeCTR::CudaDeviceContext context(core->get_device_id());
+      HCTR_LIB_THROW(cudaStreamSynchronize(core->get_local_gpu()->get_stream()));
+    }
+  }
+
+  void generate_input(const uint64_t seed) {
+    const int num_keys_per_table = shape_.batch_size_per_gpu * shape_.hotness;
+    std::vector<Offset> bucket_range(shape_.batch_size_per_gpu + 1);
+    for (size_t i = 0; i < bucket_range.size(); ++i) {
+      bucket_range[i] = static_cast<Offset>(i * shape_.hotness);
+    }
+
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<Key> key_dist(0, shape_.vocabulary_size - 1);
+    std::uniform_real_distribution<Emb> grad_dist(-1.f, 1.f);
+    for (int gpu_id = 0; gpu_id < shape_.num_gpus; ++gpu_id) {
+      HugeCTR::CudaDeviceContext context(cores_[gpu_id]->get_device_id());
+      const int device_id = cores_[gpu_id]->get_device_id();
+      const core23::TensorParams params =
+          core23::TensorParams().device(core23::Device(core23::DeviceType::GPU, device_id));
+
+      std::vector<Key> unique_keys;
+      std::vector<Index> id_space_offset{0};
+      std::vector<int> id_space_list;
+      for (int table_id = 0; table_id < shape_.num_tables; ++table_id) {
+        std::vector<Key> keys(num_keys_per_table);
+        std::generate(keys.begin(), keys.end(), [&]() { return key_dist(gen); });
+        core23::copy_sync(dp_keys_[gpu_id][table_id], keys);
+        core23::copy_sync(dp_bucket_range_[gpu_id][table_id], bucket_range);
+
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        unique_keys.insert(unique_keys.end(), keys.begin(), keys.end());
+        id_space_offset.push_back(static_cast<Index>(unique_keys.size()));
+        id_space_list.push_back(table_id);
+      }
+
+      std::vector<Emb> top_grad(top_grads_[gpu_id].num_elements());
+      std::generate(top_grad.begin(), top_grad.end(), [&]() { return grad_dist(gen); });
+      core23::copy_sync(top_grads_[gpu_id], top_grad);
+
+      DynamicLookupInput input{
+          core23::Tensor(params.shape({static_cast<int64_t>(unique_keys.size())})
+                             .data_type(ebc_param_.key_type)),
+          unique_keys.size(),
+          core23::Tensor(params.shape({static_cast<int64_t>(id_space_offset.size())})
+                             .data_type(core23::ScalarType::UInt32)),
+          core23::Tensor(params.shape({static_cast<int64_t>(id_space_list.size())})
+                             .data_type(core23::ScalarType::Int32)),
+          core23::init_tensor_list<float>(static_cast<int64_t>(unique_keys.size()), device_id)};
+      core23::copy_sync(input.keys, unique_keys);
+      core23::copy_sync(input.id_space_offset, id_space_offset);
+      core23::copy_sync(input.id_space_list, id_space_list);
+      dynamic_lookup_inputs_.push_back(std::move(input));
+    }
+  }
+
+  Shape shape_;
+  EmbeddingCollectionParam ebc_param_;
+  std::vector<EmbeddingTableParam> table_params_;
+  std::shared_ptr<HugeCTR::ResourceManager> resource_manager_;
+  std::vector<std::shared_ptr<CoreResourceManager>> cores_;
+
+  std::vector<std::vector<core23::Tensor>> dp_keys_;
+  std::vector<std::vector<core23::Tensor>> dp_bucket_range_;
+  std::vector<core23::Tensor> top_grads_;
+  std::vector<core23::Tensor> outputs_;
+
+  std::unique_ptr<HugeCTR::DataDistributor> data_distributor_;
+  std::vector<HugeCTR::DataDistributor::Result> data_distributor_outputs_;
+  std::unique_ptr<EmbeddingCollection> ebc_;
+  std::vector<std::unique_ptr<DynamicEmbeddingTable>> dynamic_tables_;
+  std::vector<DynamicLookupInput> dynamic_lookup_inputs_;
+};
+
+// Timing of one benchmark, in microseconds per iteration.
+struct BenchmarkRun {
+  std::string name;
+  int64_t iterations;
+  double real_time;
+  double cpu_time;
+  double items_per_second;
+};
+
+double process_cpu_time_us() {
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) * 1e6 + static_cast<double>(ts.tv_nsec) * 1e-3;
+}
+
+class BenchmarkRunner {
+ public:
+  explicit BenchmarkRunner(const Flags& flags) : flags_(flags) {}
+
+  // Whether a benchmark of an operator and shape passes the filter.
+  bool selected(const std::string& op_name, const Shape& shape) const {
+    return (op_name + "/" + to_string(shape)).find(flags_.filter) != std::string::npos;
+  }
+
+  // Times op on all GPUs of bench, where each iteration processes num_items items.
+  void run(const std::string& op_name, EmbeddingCollectionBench& bench, const int64_t num_items,
+           const std::function<void(int)>& op) {
+    if (!selected(op_name, bench.shape())) {
+      return;
+    }
+    for (int i = 0; i < flags_.warmup; ++i) {
+      bench.run_on_all_gpus(op);
+    }
+
+    const double cpu_begin = process_cpu_time_us();
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < flags_.iterations; ++i) {
+      bench.run_on_all_gpus(op);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double cpu_end = process_cpu_time_us();
+
+    BenchmarkRun run;
+    run.name = op_name + "/" + to_string(bench.shape());
+    run.iterations = flags_.iterations;
+    run.real_time = std::chrono::duration<double, std::micro>(end - begin).count() / run.iterations;
+    run.cpu_time = (cpu_end - cpu_begin) / run.iterations;
+    run.items_per_second = static_cast<double>(num_items) / (run.real_time * 1e-6);
+    HCTR_LOG_S(INFO, ROOT) << std::left << std::setw(88) << run.name << std::right << std::fixed
+                           << std::setprecision(1) << std::setw(12) << run.real_time << " us"
+                           << std::setw(12) << run.cpu_time << " us" << std::setprecision(3)
+                           << std::setw(12) << run.items_per_second * 1e-6 << " M/s"
+                           << std::endl;
+    runs_.push_back(std::move(run));
+  }
+
+  // Writes the runs in the JSON format of Google Benchmark.
+  void write_json(const std::string& path, const std::string& executable) const {
+    const std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%FT%T%z", std::localtime(&now));
+    char host_name[256] = {};
+    gethostname(host_name, sizeof(host_name) - 1);
+
+    nlohmann::json json;
+    json["context"] = {{"date", date},
+                       {"host_name", host_name},
+                       {"executable", executable},
+                       {"num_cpus", std::thread::hardware_concurrency()},
+#ifdef NDEBUG
+                       {"library_build_type", "release"}};
+#else
+                       {"library_build_type", "debug"}};
+#endif
+    json["benchmarks"] = nlohmann::json::array();
+    for (const auto& run : runs_) {
+      json["benchmarks"].push_back({{"name", run.name},
+                                    {"run_name", run.name},
+                                    {"run_type", "iteration"},
+                                    {"repetitions", 1},
+                                    {"repetition_index", 0},
+                                    {"threads", 1},
+                                    {"iterations", run.iterations},
+                                    {"real_time", run.real_time},
+                                    {"cpu_time", run.cpu_time},
+                                    {"time_unit", "us"},
+                                    {"items_per_second", run.items_per_second}});
+    }
+
+    std::ofstream file(path, std::ofstream::trunc);
+    HCTR_CHECK_HINT(file.is_open(), "File not open for writing: ", path);
+    file << json.dump(2) << std::endl;
+  }
+
+ private:
+  const Flags& flags_;
+  std::vector<BenchmarkRun> runs_;
+};
+
+const std::vector<std::string> op_names{"DataDistributor::distribute",
+                                        "ModelForward",
+                                        "NetworkForward",
+                                        "MPLocalReduceIndexCalculation",
+                                        "RaggedStaticEmbeddingTable::update",
+                                        "DynamicEmbeddingTable::lookup"};
+
+void bench_shape(BenchmarkRunner& runner, const Shape& shape, const uint64_t seed) {
+  if (std::none_of(op_names.begin(), op_names.end(),
+                   [&](const std::string& name) { return runner.selected(name, shape); })) {
+    return;
+  }
+  EmbeddingCollectionBench bench(shape, seed);
+  const int64_t num_keys = bench.num_keys();
+  const int64_t num_evs = static_cast<int64_t>(bench.global_batch_size()) * shape.num_tables;
+
+  runner.run("DataDistributor::distribute", bench, num_keys,
+             [&](int gpu_id) { bench.distribute(gpu_id); });
+  bench.run_on_all_gpus([&](int gpu_id) { bench.train_step(gpu_id); });
+
+  runner.run("ModelForward", bench, num_keys,
+             [&](int gpu_id) { bench.forward(Stage::MPModelForward, gpu_id); });
+  runner.run("NetworkForward", bench, num_evs,
+             [&](int gpu_id) { bench.forward(Stage::MPNetworkdForward, gpu_id); });
+  runner.run("MPLocalReduceIndexCalculation", bench, num_keys,
+             [&](int gpu_id) { bench.backward(Stage::MPBackwardIndexCalculation, gpu_id); });
+
+  // The update applies the same wgrad in each iteration, which is as much work as a new one.
+  bench.run_on_all_gpus([&](int gpu_id) { bench.train_step(gpu_id); });
+  runner.run("RaggedStaticEmbeddingTable::update", bench, num_keys,
+             [&](int gpu_id) { bench.update(gpu_id); });
+
+  // The warm-up inserts the keys, so that the iterations time lookups of existing keys.
+  runner.run("DynamicEmbeddingTable::lookup", bench, num_keys,
+             [&](int gpu_id) { bench.dynamic_lookup(gpu_id); });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    const Flags flags = parse_flags(argc, argv);
+    BenchmarkRunner runner(flags);
+    for (const int num_gpus : flags.gpus) {
+      for (const int num_tables : flags.tables) {
+        for (const int hotness : flags.hotness) {
+          for (const int ev_size : flags.ev_size) {
+            for (const int batch_size : flags.batch_size) {
+              const Shape shape{num_tables, hotness,  ev_size,
+                                batch_size, num_gpus, flags.vocabulary_size};
+              bench_shape(runner, shape, flags.seed);
+            }
+          }
+        }
+      }
+    }
+    if (!flags.out.empty()) {
+      runner.write_json(flags.out, argv[0]);
+    }
+  } catch (const std::exception& e) {
+    HCTR_LOG_S(ERROR, WORLD) << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
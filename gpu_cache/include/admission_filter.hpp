@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <nv_util.h>
+
+#include <cstdint>
+#include <hash_functions.cuh>
+
+// Number of hash rows of the count-min sketch
+#define ADMISSION_SKETCH_DEPTH 4
+// The sketch is aged after (window factor * capacity) recorded misses
+#define ADMISSION_WINDOW_FACTOR 10
+
+namespace gpu_cache {
+
+// Device-side view of an admission_filter, passed to kernels by value. A null counters pointer
+// admits every key.
+template <typename key_type>
+struct admission_sketch {
+  uint32_t* counters;  // ADMISSION_SKETCH_DEPTH rows of (width_mask + 1) counters
+  size_t width_mask;
+  uint32_t threshold;
+};
+
+#ifdef __CUDACC__
+// Records a miss of key and returns whether it has missed at least threshold times. Uses
+// conservative update, i.e. only the smallest counters are incremented, which limits the
+// overestimation caused by colliding keys.
+template <typename key_type>
+__device__ __forceinline__ bool admission_sketch_admit(const admission_sketch<key_type>& sketch,
+                                                       const key_type& key) {
+  const uint32_t h1 = MurmurHash3_32<key_type, 0>::hash(key);
+  const uint32_t h2 = MurmurHash3_32<key_type, 0x9e3779b9>::hash(key) | 1;
+  const size_t width = sketch.width_mask + 1;
+
+  size_t counter_idx[ADMISSION_SKETCH_DEPTH];
+  uint32_t count = 0xffffffff;
+  for (int row = 0; row < ADMISSION_SKETCH_DEPTH; row++) {
+    counter_idx[row] = row * width + ((h1 + row * h2) & sketch.width_mask);
+    count = min(count, sketch.counters[counter_idx[row]]);
+  }
+  count++;
+  for (int row = 0; row < ADMISSION_SKETCH_DEPTH; row++) {
+    atomicMax(&sketch.counters[counter_idx[row]], count);
+  }
+  return count >= sketch.threshold;
+}
+#endif
+
+// Miss accounting of an admission_filter in device memory, because the number of misses of a
+// replacement may only be known on the device.
+struct admission_aging {
+  unsigned long long num_recorded;
+  uint32_t age;  // Whether the last accounted misses completed another window
+};
+
+// Admission policy for embedding caches. Keys are only admitted into the cache after they missed
+// threshold times, which prevents scans over cold keys from evicting the hot working set. The
+// miss counts are estimated by a count-min sketch in device memory, and halved periodically so
+// that keys that were hot a long time ago lose their head start (TinyLFU aging). A threshold of 1
+// or less admits every key, so caches only create a filter for larger thresholds.
+template <typename key_type>
+class admission_filter {
+ public:
+  // Ctor, the sketch is sized for capacity distinct keys
+  admission_filter(const size_t capacity, const uint32_t threshold);
+
+  // Dtor
+  ~admission_filter() noexcept(false);
+
+  admission_sketch<key_type> sketch() const { return {counters_, width_ - 1, threshold_}; }
+
+  // Accounts for the misses recorded by other kernels through sketch(), i.e. num_keys, or
+  // *d_num_keys if given. Ages the sketch whenever another window of misses is complete.
+  void Age(const size_t num_keys, const size_t* d_num_keys, cudaStream_t stream);
+
+  // Records the misses of d_keys and compacts the admitted <k,v> pairs into d_admitted_keys and
+  // d_admitted_values. The order of the admitted pairs is not preserved.
+  void Filter(const key_type* d_keys, const size_t len, const float* d_values,
+              const size_t embedding_vec_size, key_type* d_admitted_keys,
+              float* d_admitted_values, size_t* d_admitted_len, cudaStream_t stream);
+
+ private:
+  static const size_t BLOCK_SIZE_ = 64;
+  // Most sketches are not aged by a call, so aging is done by a small grid that exits early
+  static const size_t AGE_GRID_SIZE_ = 128;
+
+  // CUDA device
+  int dev_;
+
+  // Sketch data
+  uint32_t* counters_;
+  size_t width_;
+  uint32_t threshold_;
+
+  // Aging
+  size_t window_;
+  admission_aging* aging_;
+};
+
+}  // namespace gpu_cache
@@ -17,10 +17,38 @@
 #pragma once
 #include <nv_util.h>
 
+#include <algorithm>
+
 #define TASK_PER_WARP_TILE_MACRO 1
 
 namespace gpu_cache {
 
+template <typename key_type>
+class gpu_cache_api;
+
+// Arguments of a single Query within QueryGrouped. d_len may be nullptr (see QueryWithDeviceLen).
+template <typename key_type>
+struct gpu_cache_query_task {
+  gpu_cache_api<key_type>* cache;
+  const key_type* d_keys;
+  const size_t* d_len;
+  size_t len;
+  float* d_values;
+  uint64_t* d_missing_index;
+  key_type* d_missing_keys;
+  size_t* d_missing_len;
+};
+
+// Arguments of a single Replace within ReplaceGrouped. d_len may be nullptr.
+template <typename key_type>
+struct gpu_cache_replace_task {
+  gpu_cache_api<key_type>* cache;
+  const key_type* d_keys;
+  const size_t* d_len;
+  size_t len;
+  const float* d_values;
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 // GPU Cache API
@@ -39,6 +67,70 @@ class gpu_cache_api {
                        cudaStream_t stream,
                        const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) = 0;
 
+  // Query API that processes the first *d_len (<= len) keys, where d_len resides in device memory.
+  // Allows enqueuing the query before the number of keys is known on the host. Implementations
+  // that do not support this fall back to reading d_len on the host, which synchronizes stream.
+  virtual void QueryWithDeviceLen(const key_type* d_keys, const size_t* d_len, const size_t len,
+                                  float* d_values, uint64_t* d_missing_index,
+                                  key_type* d_missing_keys, size_t* d_missing_len,
+                                  cudaStream_t stream,
+                                  const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) {
+    size_t h_len;
+    CUDA_CHECK(cudaMemcpyAsync(&h_len, d_len, sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+    CUDA_CHECK(cudaStreamSynchronize(stream));
+    Query(d_keys, std::min(h_len, len), d_values, d_missing_index, d_missing_keys, d_missing_len,
+          stream, task_per_warp_tile);
+  }
+
+  // Replace API counterpart of QueryWithDeviceLen
+  virtual void ReplaceWithDeviceLen(const key_type* d_keys, const size_t* d_len, const size_t len,
+                                    const float* d_values, cudaStream_t stream,
+                                    const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) {
+    size_t h_len;
+    CUDA_CHECK(cudaMemcpyAsync(&h_len, d_len, sizeof(size_t), cudaMemcpyDeviceToHost, stream));
+    CUDA_CHECK(cudaStreamSynchronize(stream));
+    Replace(d_keys, std::min(h_len, len), d_values, stream, task_per_warp_tile);
+  }
+
+  // Grouped Query API, i.e. perform the Query of each task on its cache, which need not be this
+  // cache. Implementations may fuse the tasks for caches of their own type into fewer kernels.
+  virtual void QueryGrouped(const gpu_cache_query_task<key_type>* tasks, const size_t num_tasks,
+                            cudaStream_t stream,
+                            const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) {
+    for (const gpu_cache_query_task<key_type>* t = tasks; t != &tasks[num_tasks]; ++t) {
+      if (t->d_len) {
+        t->cache->QueryWithDeviceLen(t->d_keys, t->d_len, t->len, t->d_values, t->d_missing_index,
+                                     t->d_missing_keys, t->d_missing_len, stream,
+                                     task_per_warp_tile);
+      } else {
+        t->cache->Query(t->d_keys, t->len, t->d_values, t->d_missing_index, t->d_missing_keys,
+                        t->d_missing_len, stream, task_per_warp_tile);
+      }
+    }
+  }
+
+  // Grouped Replace API, the Replace counterpart of QueryGrouped
+  virtual void ReplaceGrouped(const gpu_cache_replace_task<key_type>* tasks,
+                              const size_t num_tasks, cudaStream_t stream,
+                              const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) {
+    for (const gpu_cache_replace_task<key_type>* t = tasks; t != &tasks[num_tasks]; ++t) {
+      if (t->d_len) {
+        t->cache->ReplaceWithDeviceLen(t->d_keys, t->d_len, t->len, t->d_values, stream,
+                                       task_per_warp_tile);
+      } else {
+        t->cache->Replace(t->d_keys, t->len, t->d_values, stream, task_per_warp_tile);
+      }
+    }
+  }
+
+  // Preload API, i.e. insert <k,v> pairs regardless of the admission policy of the cache (if any),
+  // e.g. to warm up the cache from the parameter server
+  virtual void Preload(const key_type* d_keys, const size_t len, const float* d_values,
+                       cudaStream_t stream,
+                       const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) {
+    Replace(d_keys, len, d_values, stream, task_per_warp_tile);
+  }
+
   // Update API, i.e. update the embeddings which exist in the cache
   virtual void Update(const key_type* d_keys, const size_t len, const float* d_values,
                       cudaStream_t stream,
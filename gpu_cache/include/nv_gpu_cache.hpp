@@ -15,9 +15,13 @@
  */
 #pragma once
 
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+#include <cuda_fp8.h>
 #include <nv_util.h>
 
 #include <cstdio>
+#include <admission_filter.hpp>
 #include <hash_functions.cuh>
 #include <limits>
 
@@ -30,6 +34,8 @@
 #define SET_ASSOCIATIVITY 2
 #define SLAB_SIZE 32
 #define TASK_PER_WARP_TILE_MACRO 1
+// Number of tasks that fit into the parameters (max. 4 KiB) of a single grouped kernel launch
+#define GROUPED_TASKS_PER_LAUNCH 16
 
 namespace gpu_cache {
 
@@ -48,13 +54,35 @@ struct slab_set {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 // GPU Cache
+// Embedding vectors are stored as value_type (float, __half, __nv_bfloat16 or __nv_fp8_e4m3). The
+// API always exchanges float values: Replace/Update down-convert on insertion, Query up-converts.
+// FP8 values are not scaled, so embeddings must lie within the E4M3 range (+/-448).
+// If admission_threshold > 1, Replace only inserts keys that were replaced (i.e., missed) at least
+// admission_threshold times, see admission_filter. Preload always inserts.
+// If lock_free_query is set, Query reads the slabsets without acquiring their mutex and refreshes
+// the recency of hit slots only if they are outdated. Writers still lock the slabsets, but publish
+// keys after their values, so that Query reports a slot overwritten during its read as missing.
+// While Replace writes a slot, the slot holds empty_key. Query stops probing a set at the first
+// slab with an empty slot, so keys in the later slabs of that set are briefly reported as missing.
+// Update overwrites values in place, so a concurrent Query may return a mix of old and new value.
+// All device memory of a cache is a single allocation, which GetIpcHandle exports to other
+// processes on the same device. A cache opened from such a handle shares the slabsets and values
+// of its owner; it can Query and Dump, but Replace, Preload and Update are rejected, since the
+// owner is the only writer. The owner must outlive the caches opened from its handle.
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
           int warp_size, typename set_hasher = MurmurHash3_32<key_type>,
-          typename slab_hasher = Mod_Hash<key_type, size_t>>
+          typename slab_hasher = Mod_Hash<key_type, size_t>, typename value_type = float>
 class gpu_cache : public gpu_cache_api<key_type> {
  public:
   // Ctor
-  gpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size);
+  gpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size,
+            const uint32_t admission_threshold = 0, const bool lock_free_query = false);
+
+  // Ctor of a read-only cache sharing the memory of the cache that exported ipc_handle. The owner
+  // must run in another process on the current device, with the same capacity_in_set,
+  // embedding_vec_size and template arguments.
+  gpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size,
+            const cudaIpcMemHandle_t& ipc_handle, const bool lock_free_query = false);
 
   // Dtor
   ~gpu_cache();
@@ -68,6 +96,31 @@ class gpu_cache : public gpu_cache_api<key_type> {
   void Replace(const key_type* d_keys, const size_t len, const float* d_values, cudaStream_t stream,
                const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
 
+  // Query/Replace API with the number of keys taken from device memory, without host sync
+  void QueryWithDeviceLen(const key_type* d_keys, const size_t* d_len, const size_t len,
+                          float* d_values, uint64_t* d_missing_index, key_type* d_missing_keys,
+                          size_t* d_missing_len, cudaStream_t stream,
+                          const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
+
+  void ReplaceWithDeviceLen(const key_type* d_keys, const size_t* d_len, const size_t len,
+                            const float* d_values, cudaStream_t stream,
+                            const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
+
+  // Grouped Query/Replace API. Tasks for caches of this type on the same device are processed by
+  // a single kernel launch per GROUPED_TASKS_PER_LAUNCH tasks.
+  void QueryGrouped(const gpu_cache_query_task<key_type>* tasks, const size_t num_tasks,
+                    cudaStream_t stream,
+                    const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
+
+  void ReplaceGrouped(const gpu_cache_replace_task<key_type>* tasks, const size_t num_tasks,
+                      cudaStream_t stream,
+                      const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
+
+  // Preload API, i.e. Replace bypassing the admission filter
+  void Preload(const key_type* d_keys, const size_t len, const float* d_values,
+               cudaStream_t stream,
+               const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
+
   // Update API, i.e. update the embeddings which exist in the cache
   void Update(const key_type* d_keys, const size_t len, const float* d_values, cudaStream_t stream,
               const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
@@ -76,6 +129,9 @@ class gpu_cache : public gpu_cache_api<key_type> {
   void Dump(key_type* d_keys, size_t* d_dump_counter, const size_t start_set_index,
             const size_t end_set_index, cudaStream_t stream) override;
 
+  // Handle for other processes to open this cache read-only
+  cudaIpcMemHandle_t GetIpcHandle() const;
+
  public:
   using slabset = slab_set<set_associativity, key_type, warp_size>;
 #ifdef LIBCUDACXX_VERSION
@@ -86,9 +142,21 @@ class gpu_cache : public gpu_cache_api<key_type> {
  private:
   static const size_t BLOCK_SIZE_ = 64;
 
+  void replace_grouped_(const gpu_cache_replace_task<key_type>* tasks, const size_t num_tasks,
+                        cudaStream_t stream, const size_t task_per_warp_tile,
+                        const bool use_admission_filter);
+
+  // Size of the single allocation holding all cache data, and the assignment of its parts
+  size_t memory_size_() const;
+  void assign_memory_(char* memory);
+
+  // The single allocation, cudaMalloc'ed or opened from the handle of another process
+  char* memory_;
+  bool ipc_opened_;
+
   // Cache data
   slabset* keys_;
-  float* vals_;
+  value_type* vals_;
   ref_counter_type* slot_counter_;
 
   // Global counter
@@ -107,6 +175,9 @@ class gpu_cache : public gpu_cache_api<key_type> {
   // Embedding vector size
   size_t embedding_vec_size_;
 
+  // Whether Query skips the set mutex
+  bool lock_free_query_;
+
 #ifdef LIBCUDACXX_VERSION
   // Array of mutex to protect (sub-)warp-level data structure, each mutex protect 1 slab set
   mutex* set_mutex_;
@@ -115,6 +186,9 @@ class gpu_cache : public gpu_cache_api<key_type> {
   // 1 slab set 1 for unlock, 0 for lock
   int* set_mutex_;
 #endif
+
+  // Admission policy for Replace, nullptr if every key is admitted
+  admission_filter<key_type>* admission_filter_;
 };
 
 }  // namespace gpu_cache
@@ -61,8 +61,22 @@ class StaticHashTable {
   void insert(const key_type *keys, const value_type *values, size_type num_keys,
               cudaStream_t stream = 0, const float *quant_scales = nullptr);
 
+  // If missing_len is not null, the embeddings of absent keys are not written. Instead, the
+  // absent keys and their positions are compacted into missing_keys and missing_index.
   void lookup(const key_type *keys, out_value_type *values, int num_keys,
-              out_value_type default_value = 0, cudaStream_t stream = 0);
+              out_value_type default_value = 0, cudaStream_t stream = 0,
+              key_type *missing_keys = nullptr, uint64_t *missing_index = nullptr,
+              size_t *missing_len = nullptr);
+
+  // Returns the values as they are stored, together with the quantization scale of each row.
+  // The scale of non-quantized values and of absent keys is 1.
+  void lookup_quantized(const key_type *keys, value_type *values, float *scales, int num_keys,
+                        value_type default_value = value_type(0), cudaStream_t stream = 0);
+
+  // Overwrites the values of keys that exist in the table. Absent keys are skipped. Tables with
+  // quantized values cannot be updated.
+  void update(const key_type *keys, const value_type *values, size_type num_keys,
+              cudaStream_t stream = 0);
 
  private:
   key_type *table_keys_;
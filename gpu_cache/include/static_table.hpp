@@ -41,6 +41,21 @@ class static_table {
   void Query(const key_type* d_keys, const size_t len, out_value_type* d_values,
              cudaStream_t stream);
 
+  // Query API that reports the keys which are absent from the table, instead of filling their
+  // embeddings with the default value
+  void Query(const key_type* d_keys, const size_t len, out_value_type* d_values,
+             key_type* d_missing_keys, uint64_t* d_missing_index, size_t* d_missing_len,
+             cudaStream_t stream);
+
+  // Query API that returns the quantized embeddings as they are stored, and the scale of each
+  // row in d_scales, instead of dequantizing them
+  void QueryQuantized(const key_type* d_keys, const size_t len, value_type* d_values,
+                      float* d_scales, cudaStream_t stream);
+
+  // Update API, i.e. overwrite the embeddings of keys which exist in the table
+  void Update(const key_type* d_keys, const size_t len, const value_type* d_values,
+              cudaStream_t stream);
+
   // Replace API, i.e. Follow the Query API to update the content of the cache to Most Recent
   void Init(const key_type* d_keys, const size_t len, const value_type* d_values,
             cudaStream_t stream);
@@ -16,6 +16,7 @@
 #pragma once
 #include <nv_util.h>
 
+#include <memory>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -124,12 +125,21 @@ class H2HCopy {
   std::atomic<int> num_finished_workers_{0};
 };
 
+/**
+ * Two-tier table that keeps the vectors of the first keys in device memory and the remaining keys
+ * in host memory. If \p promotion_capacity is non-zero, the host hits of each key are counted on
+ * the device. Every \p promotion_interval queries, the host keys that were hit at least
+ * \p promotion_threshold times since the previous interval are copied to a device-resident
+ * region of up to \p promotion_capacity keys, from which later queries read them without a
+ * host round trip. The promoted keys are dropped by \p clear and \p add.
+ */
 template <typename key_type, typename index_type, typename vec_type = float>
 class UvmTable {
  public:
   UvmTable(const size_t device_table_capacity, const size_t host_table_capacity,
            const int max_batch_size, const int vec_size,
-           const vec_type default_value = (vec_type)0);
+           const vec_type default_value = (vec_type)0, const size_t promotion_capacity = 0,
+           const uint32_t promotion_threshold = 8, const int promotion_interval = 100);
   ~UvmTable();
   void query(const key_type* d_keys, const int len, vec_type* d_vectors, cudaStream_t stream = 0);
   void add(const key_type* h_keys, const vec_type* h_vectors, const size_t len);
@@ -137,6 +147,12 @@ class UvmTable {
 
  private:
   static constexpr int num_buffers_ = 2;
+  static constexpr size_t max_num_access_counters_ = 1 << 22;
+
+  // Copies the vectors of the hot host keys to the device-resident region.
+  void promote_hot_keys_();
+  void clear_promoted_keys_(cudaStream_t stream);
+
   key_type* d_keys_buffer_;
   vec_type* d_vectors_buffer_;
   vec_type* d_vectors_;
@@ -171,5 +187,24 @@ class UvmTable {
 
   HashBlock<key_type, index_type> device_table_;
   HashBlock<key_type, index_type> host_table_;
+
+  // Host keys that were promoted to device memory, nullptr if promotion is disabled
+  std::unique_ptr<HashBlock<key_type, index_type>> promoted_table_;
+  vec_type* d_promoted_vectors_{nullptr};
+  index_type* d_output_promoted_indices_{nullptr};
+  size_t num_promoted_keys_{0};
+
+  // Host hits per slot of the host table, folded into max_num_access_counters_ counters
+  uint32_t* d_access_counts_{nullptr};
+  size_t num_access_counters_{0};
+  uint32_t promotion_threshold_;
+  int promotion_interval_;
+  size_t num_queries_{0};
+
+  // Host keys whose access count reached the promotion threshold
+  key_type* d_candidate_keys_{nullptr};
+  index_type* d_candidate_indices_{nullptr};
+  int* d_candidate_count_{nullptr};
+  int max_num_candidates_{0};
 };
-}  // namespace gpu_cache
\ No newline at end of file
+}  // namespace gpu_cache
\ No newline at end of file
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <admission_filter.hpp>
+#include <algorithm>
+
+namespace gpu_cache {
+
+// Kernel to account for the misses of a replacement, and to flag the sketch for aging whenever
+// another window of misses is complete, 1 thread
+__global__ void record_misses_kernel(admission_aging* aging, const size_t num_keys,
+                                     const size_t* d_num_keys, const size_t window) {
+  const unsigned long long num_misses =
+      (d_num_keys && *d_num_keys < num_keys) ? *d_num_keys : num_keys;
+  const unsigned long long num_recorded = atomicAdd(&aging->num_recorded, num_misses);
+  aging->age = (num_recorded + num_misses) / window != num_recorded / window;
+}
+
+// Kernel to halve all counters of the sketch if it is flagged for aging. Races with concurrent
+// increments only lose counts, and races with the replacements of other streams may skip or repeat
+// an aging step, which the sketch tolerates.
+__global__ void age_sketch_kernel(uint32_t* counters, const size_t num_counters,
+                                  const admission_aging* aging) {
+  if (!aging->age) {
+    return;
+  }
+  for (size_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < num_counters;
+       idx += gridDim.x * blockDim.x) {
+    counters[idx] >>= 1;
+  }
+}
+
+// Kernel to record the misses of the keys and compact the admitted <k,v> pairs, 1 thread per key
+template <typename key_type>
+__global__ void filter_kernel(const admission_sketch<key_type> sketch, const key_type* d_keys,
+                              const size_t len, const float* d_values,
+                              const size_t embedding_vec_size, key_type* d_admitted_keys,
+                              float* d_admitted_values, size_t* d_admitted_len) {
+  const size_t idx = blockIdx.x * blockDim.x + threadIdx.x;
+  if (idx >= len) {
+    return;
+  }
+  const key_type key = d_keys[idx];
+  if (!admission_sketch_admit(sketch, key)) {
+    return;
+  }
+
+  const size_t dst_idx = atomicAdd(reinterpret_cast<unsigned long long*>(d_admitted_len), 1);
+  d_admitted_keys[dst_idx] = key;
+  for (size_t i = 0; i < embedding_vec_size; i++) {
+    d_admitted_values[dst_idx * embedding_vec_size + i] = d_values[idx * embedding_vec_size + i];
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename key_type>
+admission_filter<key_type>::admission_filter(const size_t capacity, const uint32_t threshold)
+    : threshold_(threshold) {
+  // Get the current CUDA dev
+  CUDA_CHECK(cudaGetDevice(&dev_));
+
+  // Round the width up to a power of 2, so that rows can be indexed by masking
+  width_ = 1;
+  while (width_ < capacity) {
+    width_ <<= 1;
+  }
+  window_ = std::max(capacity, static_cast<size_t>(1)) * ADMISSION_WINDOW_FACTOR;
+
+  // Allocate and clear GPU memory for the sketch
+  const size_t sketch_size = sizeof(uint32_t) * ADMISSION_SKETCH_DEPTH * width_;
+  CUDA_CHECK(cudaMalloc((void**)&counters_, sketch_size));
+  CUDA_CHECK(cudaMemset(counters_, 0, sketch_size));
+  CUDA_CHECK(cudaMalloc((void**)&aging_, sizeof(admission_aging)));
+  CUDA_CHECK(cudaMemset(aging_, 0, sizeof(admission_aging)));
+}
+
+template <typename key_type>
+admission_filter<key_type>::~admission_filter() noexcept(false) {
+  // Device Restorer
+  nv::CudaDeviceRestorer dev_restorer;
+  // Check device
+  dev_restorer.check_device(dev_);
+
+  CUDA_CHECK(cudaFree(counters_));
+  CUDA_CHECK(cudaFree(aging_));
+}
+
+template <typename key_type>
+void admission_filter<key_type>::Age(const size_t num_keys, const size_t* d_num_keys,
+                                     cudaStream_t stream) {
+  // Device Restorer
+  nv::CudaDeviceRestorer dev_restorer;
+  // Check device
+  dev_restorer.check_device(dev_);
+
+  record_misses_kernel<<<1, 1, 0, stream>>>(aging_, num_keys, d_num_keys, window_);
+  const size_t num_counters = ADMISSION_SKETCH_DEPTH * width_;
+  const size_t num_blocks = ((num_counters - 1) / BLOCK_SIZE_) + 1;
+  const size_t grid_size = num_blocks < AGE_GRID_SIZE_ ? num_blocks : AGE_GRID_SIZE_;
+  age_sketch_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(counters_, num_counters, aging_);
+
+  // Check for GPU error before return
+  CUDA_CHECK(cudaGetLastError());
+}
+
+template <typename key_type>
+void admission_filter<key_type>::Filter(const key_type* d_keys, const size_t len,
+                                        const float* d_values, const size_t embedding_vec_size,
+                                        key_type* d_admitted_keys, float* d_admitted_values,
+                                        size_t* d_admitted_len, cudaStream_t stream) {
+  // Device Restorer
+  nv::CudaDeviceRestorer dev_restorer;
+  // Check device
+  dev_restorer.check_device(dev_);
+
+  CUDA_CHECK(cudaMemsetAsync(d_admitted_len, 0, sizeof(size_t), stream));
+  if (len == 0) {
+    return;
+  }
+
+  Age(len, nullptr, stream);
+  filter_kernel<key_type><<<((len - 1) / BLOCK_SIZE_) + 1, BLOCK_SIZE_, 0, stream>>>(
+      sketch(), d_keys, len, d_values, embedding_vec_size, d_admitted_keys, d_admitted_values,
+      d_admitted_len);
+
+  // Check for GPU error before return
+  CUDA_CHECK(cudaGetLastError());
+}
+
+template class admission_filter<unsigned int>;
+template class admission_filter<long long>;
+
+}  // namespace gpu_cache
@@ -16,6 +16,8 @@
 
 #include <cooperative_groups.h>
 
+#include <cstring>
+
 #include <nv_gpu_cache.hpp>
 
 namespace cg = cooperative_groups;
@@ -35,25 +37,62 @@ __forceinline__ __device__ unsigned long atomicAdd(unsigned long* address, unsig
 
 namespace gpu_cache {
 
+// Copy an embedding vector, converting between the float values seen by the user and the
+// value_type that is stored in the cache
 #ifdef LIBCUDACXX_VERSION
-template <int warp_size>
-__forceinline__ __device__ void warp_tile_copy(const size_t lane_idx,
-                                               const size_t emb_vec_size_in_float, float* d_dst,
-                                               const float* d_src) {
+template <int warp_size, typename dst_type, typename src_type>
+__forceinline__ __device__ void warp_tile_copy(const size_t lane_idx, const size_t emb_vec_size,
+                                               dst_type* d_dst, const src_type* d_src) {
 #pragma unroll
-  for (size_t i = lane_idx; i < emb_vec_size_in_float; i += warp_size) {
-    d_dst[i] = d_src[i];
+  for (size_t i = lane_idx; i < emb_vec_size; i += warp_size) {
+    d_dst[i] = static_cast<dst_type>(d_src[i]);
   }
 }
 #else
-template <int warp_size>
-__forceinline__ __device__ void warp_tile_copy(const size_t lane_idx,
-                                               const size_t emb_vec_size_in_float,
-                                               volatile float* d_dst, volatile float* d_src) {
+// Volatile access to the half-precision and FP8 class types is not permitted, so elements are
+// moved through an unsigned integer of the same width
+template <size_t size>
+struct volatile_bits;
+
+template <>
+struct volatile_bits<1> {
+  using type = uint8_t;
+};
+
+template <>
+struct volatile_bits<2> {
+  using type = uint16_t;
+};
+
+template <>
+struct volatile_bits<4> {
+  using type = uint32_t;
+};
+
+template <typename value_type>
+__forceinline__ __device__ value_type volatile_load(volatile value_type* ptr) {
+  using bits_type = typename volatile_bits<sizeof(value_type)>::type;
+  const bits_type bits = *reinterpret_cast<volatile bits_type*>(ptr);
+  value_type value;
+  memcpy(&value, &bits, sizeof(value_type));
+  return value;
+}
 
+template <typename value_type>
+__forceinline__ __device__ void volatile_store(volatile value_type* ptr, const value_type value) {
+  using bits_type = typename volatile_bits<sizeof(value_type)>::type;
+  bits_type bits;
+  memcpy(&bits, &value, sizeof(value_type));
+  *reinterpret_cast<volatile bits_type*>(ptr) = bits;
+}
+
+template <int warp_size, typename dst_type, typename src_type>
+__forceinline__ __device__ void warp_tile_copy(const size_t lane_idx, const size_t emb_vec_size,
+                                               volatile dst_type* d_dst,
+                                               volatile src_type* d_src) {
 #pragma unroll
-  for (size_t i = lane_idx; i < emb_vec_size_in_float; i += warp_size) {
-    d_dst[i] = d_src[i];
+  for (size_t i = lane_idx; i < emb_vec_size; i += warp_size) {
+    volatile_store(d_dst + i, static_cast<dst_type>(volatile_load(d_src + i)));
   }
 }
 #endif
@@ -218,23 +257,74 @@ __global__ void init_cache(slabset* keys, ref_counter_type* slot_counter,
 }
 #endif
 
-// Kernel to update global counter
+// Arguments of the query of a single cache within a grouped get_kernel launch
+template <typename key_type, typename global_counter_type, typename slot_counter_type,
+          typename slabset_type, typename vals_type, typename mutex_type>
+struct get_task {
+  const key_type* d_keys;
+  size_t len;
+  const size_t* d_len;
+  float* d_values;
+  size_t embedding_vec_size;
+  uint64_t* d_missing_index;
+  key_type* d_missing_keys;
+  size_t* d_missing_len;
+  global_counter_type* global_counter;
+  slot_counter_type* slot_counter;
+  size_t capacity_in_set;
+  slabset_type* keys;
+  vals_type* vals;
+  mutex_type* set_mutex;
+  bool lock_free;
+};
+
+// Arguments of the replacement of a single cache within a grouped insert_replace_kernel launch
+template <typename key_type, typename global_counter_type, typename slot_counter_type,
+          typename slabset_type, typename vals_type, typename mutex_type>
+struct replace_task {
+  const key_type* d_keys;
+  const float* d_values;
+  size_t embedding_vec_size;
+  size_t len;
+  const size_t* d_len;
+  slabset_type* keys;
+  vals_type* vals;
+  slot_counter_type* slot_counter;
+  mutex_type* set_mutex;
+  global_counter_type* global_counter;
+  size_t capacity_in_set;
+  admission_sketch<key_type> admission;
+  bool lock_free_query;
+};
+
+// Tasks of a grouped kernel launch, passed by value. Block (x, y) works on tasks[y].
+template <typename task_type>
+struct task_group {
+  task_type tasks[GROUPED_TASKS_PER_LAUNCH];
+  size_t num_tasks;
+};
+
+// Kernel to update global counter, one thread per task
 // Resolve distance overflow issue as well
 #ifdef LIBCUDACXX_VERSION
-template <typename atomic_ref_counter_type>
-__global__ void update_kernel_overflow_ignore(atomic_ref_counter_type* global_counter,
-                                              size_t* d_missing_len) {
-  // Update global counter
-  global_counter->fetch_add(1, cuda::std::memory_order_relaxed);
-  *d_missing_len = 0;
+template <typename task_type>
+__global__ void update_kernel_overflow_ignore(const task_group<task_type> group) {
+  if (threadIdx.x < group.num_tasks) {
+    const task_type& task = group.tasks[threadIdx.x];
+    // Update global counter
+    task.global_counter->fetch_add(1, cuda::std::memory_order_relaxed);
+    *task.d_missing_len = 0;
+  }
 }
 #else
-template <typename ref_counter_type>
-__global__ void update_kernel_overflow_ignore(ref_counter_type* global_counter,
-                                              size_t* d_missing_len) {
-  // Update global counter
-  atomicAdd(global_counter, 1);
-  *d_missing_len = 0;
+template <typename task_type>
+__global__ void update_kernel_overflow_ignore(const task_group<task_type> group) {
+  if (threadIdx.x < group.num_tasks) {
+    const task_type& task = group.tasks[threadIdx.x];
+    // Update global counter
+    atomicAdd(task.global_counter, 1);
+    *task.d_missing_len = 0;
+  }
 }
 #endif
 
@@ -242,22 +332,22 @@ __global__ void update_kernel_overflow_ignore(ref_counter_type* global_counter,
 // Kernel to read from cache
 // Also update locality information for touched slot
 template <typename key_type, typename ref_counter_type, typename atomic_ref_counter_type,
-          typename slabset, typename set_hasher, typename slab_hasher, typename mutex,
-          key_type empty_key, int set_associativity, int warp_size>
-__global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_values,
-                           const size_t embedding_vec_size, uint64_t* d_missing_index,
-                           key_type* d_missing_keys, size_t* d_missing_len,
-                           const atomic_ref_counter_type* global_counter,
-                           ref_counter_type* slot_counter, const size_t capacity_in_set,
-                           const slabset* keys, const float* vals, mutex* set_mutex,
-                           const size_t task_per_warp_tile) {
+          typename slabset, typename set_hasher, typename slab_hasher, typename value_type,
+          typename mutex, key_type empty_key, int set_associativity, int warp_size>
+__device__ __forceinline__ void get_kernel_impl(
+    const key_type* d_keys, const size_t len, const size_t* d_len, float* d_values,
+    const size_t embedding_vec_size, uint64_t* d_missing_index, key_type* d_missing_keys,
+    size_t* d_missing_len, const atomic_ref_counter_type* global_counter,
+    ref_counter_type* slot_counter, const size_t capacity_in_set, const slabset* keys,
+    const value_type* vals, mutex* set_mutex, const bool lock_free,
+    const size_t task_per_warp_tile, const size_t block_idx) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
       cg::tiled_partition<warp_size>(cg::this_thread_block());
   const size_t lane_idx = warp_tile.thread_rank();
   // Warp tile global ID
   const size_t warp_tile_global_idx =
-      (blockIdx.x * (blockDim.x / warp_size)) + warp_tile.meta_group_rank();
+      (block_idx * (blockDim.x / warp_size)) + warp_tile.meta_group_rank();
   // The index of key for this thread
   const size_t key_idx = (warp_tile_global_idx * task_per_warp_tile) + lane_idx;
   // The assigned key for this lane(thread)
@@ -274,7 +364,7 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
   // Active flag: whether current lane(thread) has unfinished task
   bool active = false;
   if (lane_idx < task_per_warp_tile) {
-    if (key_idx < len) {
+    if (key_idx < len && (d_len == nullptr || key_idx < *d_len)) {
       active = true;
       key = d_keys[key_idx];
       src_set = set_hasher::hash(key) % capacity_in_set;
@@ -302,7 +392,9 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
     const unsigned old_active_mask = active_mask;
 
     // Lock the slabset before operating the slabset
-    warp_lock_mutex<mutex, warp_size>(warp_tile, set_mutex[next_set]);
+    if (!lock_free) {
+      warp_lock_mutex<mutex, warp_size>(warp_tile, set_mutex[next_set]);
+    }
 
     // The warp-level inner loop: finish a single task in the work queue
     while (active_mask == old_active_mask) {
@@ -332,15 +424,37 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
       // If found, mark hit task, copy the founded data, the task is completed
       if (found_lane >= 0) {
         size_t found_offset = (next_set * set_associativity + next_slab) * warp_size + found_lane;
-        if (lane_idx == (size_t)next_lane) {
-          slot_counter[found_offset] = global_counter->load(cuda::std::memory_order_relaxed);
-          active = false;
-        }
-
         warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
                                   d_values + next_idx * embedding_vec_size,
                                   vals + found_offset * embedding_vec_size);
 
+        // Without the lock, a concurrent replace may have taken over the slot during the copy.
+        // Replace clears the key before it overwrites the value, so a torn copy is detected by
+        // reading the key again, and reported as missing.
+        bool hit = true;
+        if (lock_free) {
+          __threadfence();
+          warp_tile.sync();
+          hit = warp_tile.all(keys[next_set].set_[next_slab].slab_[found_lane] == next_key);
+        }
+
+        if (lane_idx == (size_t)next_lane) {
+          const ref_counter_type now = global_counter->load(cuda::std::memory_order_relaxed);
+          // Lock-free queries only refresh outdated slots, which spares the writes once a hot
+          // slot has been touched in the current query.
+          if (hit && (!lock_free || slot_counter[found_offset] != now)) {
+            slot_counter[found_offset] = now;
+          }
+          active = false;
+        }
+        if (!hit) {
+          if (lane_idx == warp_missing_counter) {
+            missing_key = next_key;
+            missing_index = next_idx;
+          }
+          warp_missing_counter++;
+        }
+
         active_mask = warp_tile.ballot(active);
         break;
       }
@@ -368,7 +482,9 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
     }
 
     // Unlock the slabset after operating the slabset
-    warp_unlock_mutex<mutex, warp_size>(warp_tile, set_mutex[next_set]);
+    if (!lock_free) {
+      warp_unlock_mutex<mutex, warp_size>(warp_tile, set_mutex[next_set]);
+    }
   }
 
   // After warp_tile complete the working queue, save the result for output
@@ -384,25 +500,43 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
     d_missing_index[warp_position + lane_idx] = missing_index;
   }
 }
+
+template <typename key_type, typename ref_counter_type, typename atomic_ref_counter_type,
+          typename slabset, typename set_hasher, typename slab_hasher, typename value_type,
+          typename mutex, key_type empty_key, int set_associativity, int warp_size,
+          typename task_type>
+__global__ void get_kernel(const task_group<task_type> group, const size_t task_per_warp_tile) {
+  const task_type& task = group.tasks[blockIdx.y];
+  if (blockIdx.x * (blockDim.x / warp_size) * task_per_warp_tile >= task.len) {
+    return;
+  }
+  get_kernel_impl<key_type, ref_counter_type, atomic_ref_counter_type, slabset, set_hasher,
+                  slab_hasher, value_type, mutex, empty_key, set_associativity, warp_size>(
+      task.d_keys, task.len, task.d_len, task.d_values, task.embedding_vec_size,
+      task.d_missing_index, task.d_missing_keys, task.d_missing_len, task.global_counter,
+      task.slot_counter, task.capacity_in_set, task.keys, task.vals, task.set_mutex,
+      task.lock_free, task_per_warp_tile, blockIdx.x);
+}
 #else
 // Kernel to read from cache
 // Also update locality information for touched slot
 template <typename key_type, typename ref_counter_type, typename slabset, typename set_hasher,
-          typename slab_hasher, key_type empty_key, int set_associativity, int warp_size>
-__global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_values,
-                           const size_t embedding_vec_size, uint64_t* d_missing_index,
-                           key_type* d_missing_keys, size_t* d_missing_len,
-                           ref_counter_type* global_counter,
-                           volatile ref_counter_type* slot_counter, const size_t capacity_in_set,
-                           volatile slabset* keys, volatile float* vals, volatile int* set_mutex,
-                           const size_t task_per_warp_tile) {
+          typename slab_hasher, typename value_type, key_type empty_key, int set_associativity,
+          int warp_size>
+__device__ __forceinline__ void get_kernel_impl(
+    const key_type* d_keys, const size_t len, const size_t* d_len, float* d_values,
+    const size_t embedding_vec_size, uint64_t* d_missing_index, key_type* d_missing_keys,
+    size_t* d_missing_len, ref_counter_type* global_counter,
+    volatile ref_counter_type* slot_counter, const size_t capacity_in_set, volatile slabset* keys,
+    volatile value_type* vals, volatile int* set_mutex, const bool lock_free,
+    const size_t task_per_warp_tile, const size_t block_idx) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
       cg::tiled_partition<warp_size>(cg::this_thread_block());
   const size_t lane_idx = warp_tile.thread_rank();
   // Warp tile global ID
   const size_t warp_tile_global_idx =
-      (blockIdx.x * (blockDim.x / warp_size)) + warp_tile.meta_group_rank();
+      (block_idx * (blockDim.x / warp_size)) + warp_tile.meta_group_rank();
   // The index of key for this thread
   const size_t key_idx = (warp_tile_global_idx * task_per_warp_tile) + lane_idx;
   // The assigned key for this lane(thread)
@@ -419,7 +553,7 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
   // Active flag: whether current lane(thread) has unfinished task
   bool active = false;
   if (lane_idx < task_per_warp_tile) {
-    if (key_idx < len) {
+    if (key_idx < len && (d_len == nullptr || key_idx < *d_len)) {
       active = true;
       key = d_keys[key_idx];
       src_set = set_hasher::hash(key) % capacity_in_set;
@@ -447,7 +581,9 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
     const unsigned old_active_mask = active_mask;
 
     // Lock the slabset before operating the slabset
-    warp_lock_mutex<warp_size>(warp_tile, set_mutex[next_set]);
+    if (!lock_free) {
+      warp_lock_mutex<warp_size>(warp_tile, set_mutex[next_set]);
+    }
 
     // The warp-level inner loop: finish a single task in the work queue
     while (active_mask == old_active_mask) {
@@ -477,14 +613,37 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
       // If found, mark hit task, copy the founded data, the task is completed
       if (found_lane >= 0) {
         size_t found_offset = (next_set * set_associativity + next_slab) * warp_size + found_lane;
+        warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
+                                  (volatile float*)(d_values + next_idx * embedding_vec_size),
+                                  (volatile value_type*)(vals + found_offset * embedding_vec_size));
+
+        // Without the lock, a concurrent replace may have taken over the slot during the copy.
+        // Replace clears the key before it overwrites the value, so a torn copy is detected by
+        // reading the key again, and reported as missing.
+        bool hit = true;
+        if (lock_free) {
+          __threadfence();
+          warp_tile.sync();
+          hit = warp_tile.all(
+              ((volatile key_type*)(keys[next_set].set_[next_slab].slab_))[found_lane] == next_key);
+        }
+
         if (lane_idx == (size_t)next_lane) {
-          slot_counter[found_offset] = atomicAdd(global_counter, 0);
+          const ref_counter_type now = atomicAdd(global_counter, 0);
+          // Lock-free queries only refresh outdated slots, which spares the writes once a hot
+          // slot has been touched in the current query.
+          if (hit && (!lock_free || slot_counter[found_offset] != now)) {
+            slot_counter[found_offset] = now;
+          }
           active = false;
         }
-
-        warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
-                                  (volatile float*)(d_values + next_idx * embedding_vec_size),
-                                  (volatile float*)(vals + found_offset * embedding_vec_size));
+        if (!hit) {
+          if (lane_idx == warp_missing_counter) {
+            missing_key = next_key;
+            missing_index = next_idx;
+          }
+          warp_missing_counter++;
+        }
 
         active_mask = warp_tile.ballot(active);
         break;
@@ -513,7 +672,9 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
     }
 
     // Unlock the slabset after operating the slabset
-    warp_unlock_mutex<warp_size>(warp_tile, set_mutex[next_set]);
+    if (!lock_free) {
+      warp_unlock_mutex<warp_size>(warp_tile, set_mutex[next_set]);
+    }
   }
 
   // After warp_tile complete the working queue, save the result for output
@@ -529,29 +690,44 @@ __global__ void get_kernel(const key_type* d_keys, const size_t len, float* d_va
     d_missing_index[warp_position + lane_idx] = missing_index;
   }
 }
+
+template <typename key_type, typename ref_counter_type, typename slabset, typename set_hasher,
+          typename slab_hasher, typename value_type, key_type empty_key, int set_associativity,
+          int warp_size, typename task_type>
+__global__ void get_kernel(const task_group<task_type> group, const size_t task_per_warp_tile) {
+  const task_type& task = group.tasks[blockIdx.y];
+  if (blockIdx.x * (blockDim.x / warp_size) * task_per_warp_tile >= task.len) {
+    return;
+  }
+  get_kernel_impl<key_type, ref_counter_type, slabset, set_hasher, slab_hasher, value_type,
+                  empty_key, set_associativity, warp_size>(
+      task.d_keys, task.len, task.d_len, task.d_values, task.embedding_vec_size,
+      task.d_missing_index, task.d_missing_keys, task.d_missing_len, task.global_counter,
+      task.slot_counter, task.capacity_in_set, task.keys, task.vals, task.set_mutex,
+      task.lock_free, task_per_warp_tile, blockIdx.x);
+}
 #endif
 
 #ifdef LIBCUDACXX_VERSION
 // Kernel to insert or replace the <k,v> pairs into the cache
 template <typename key_type, typename slabset, typename ref_counter_type, typename mutex,
           typename atomic_ref_counter_type, typename set_hasher, typename slab_hasher,
-          key_type empty_key, int set_associativity, int warp_size,
+          typename value_type, key_type empty_key, int set_associativity, int warp_size,
           ref_counter_type max_ref_counter_type = std::numeric_limits<ref_counter_type>::max(),
           size_t max_slab_distance = std::numeric_limits<size_t>::max()>
-__global__ void insert_replace_kernel(const key_type* d_keys, const float* d_values,
-                                      const size_t embedding_vec_size, const size_t len,
-                                      slabset* keys, float* vals, ref_counter_type* slot_counter,
-                                      mutex* set_mutex,
-                                      const atomic_ref_counter_type* global_counter,
-                                      const size_t capacity_in_set,
-                                      const size_t task_per_warp_tile) {
+__device__ __forceinline__ void insert_replace_kernel_impl(
+    const key_type* d_keys, const float* d_values, const size_t embedding_vec_size,
+    const size_t len, const size_t* d_len, slabset* keys, value_type* vals,
+    ref_counter_type* slot_counter, mutex* set_mutex, const atomic_ref_counter_type* global_counter,
+    const size_t capacity_in_set, const admission_sketch<key_type>& admission,
+    const bool lock_free_query, const size_t task_per_warp_tile, const size_t block_idx) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
       cg::tiled_partition<warp_size>(cg::this_thread_block());
   const size_t lane_idx = warp_tile.thread_rank();
   // Warp tile global ID
   const size_t warp_tile_global_idx =
-      (blockIdx.x * (blockDim.x / warp_size)) + warp_tile.meta_group_rank();
+      (block_idx * (blockDim.x / warp_size)) + warp_tile.meta_group_rank();
   // The index of key for this thread
   const size_t key_idx = (warp_tile_global_idx * task_per_warp_tile) + lane_idx;
   // The assigned key for this lane(thread)
@@ -562,9 +738,10 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
   // Active flag: whether current lane(thread) has unfinished task
   bool active = false;
   if (lane_idx < task_per_warp_tile) {
-    if (key_idx < len) {
-      active = true;
+    if (key_idx < len && (d_len == nullptr || key_idx < *d_len)) {
       key = d_keys[key_idx];
+      // Keys rejected by the admission policy are not inserted
+      active = admission.counters == nullptr || admission_sketch_admit(admission, key);
       src_set = set_hasher::hash(key) % capacity_in_set;
       src_slab = slab_hasher::hash(key) % set_associativity;
     }
@@ -613,16 +790,30 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
         size_t slot_index =
             (next_set * set_associativity + target_slab) * warp_size + slot_distance;
 
-        // Replace the LR slot
+        // Replace the LR slot. Lock-free queries must never see the key next to a partially
+        // written value. Hence, clear the slot, write the value, and only then publish the key.
+        // Until then, queries for keys in later slabs of this set stop at the cleared slot.
         if (lane_idx == (size_t)next_lane) {
-          keys[next_set].set_[target_slab].slab_[slot_distance] = key;
+          keys[next_set].set_[target_slab].slab_[slot_distance] = lock_free_query ? empty_key : key;
           slot_counter[slot_index] = global_counter->load(cuda::std::memory_order_relaxed);
         }
+        if (lock_free_query) {
+          __threadfence();
+          warp_tile.sync();
+        }
 
         warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
                                   vals + slot_index * embedding_vec_size,
                                   d_values + next_idx * embedding_vec_size);
 
+        if (lock_free_query) {
+          __threadfence();
+          warp_tile.sync();
+          if (lane_idx == (size_t)next_lane) {
+            keys[next_set].set_[target_slab].slab_[slot_distance] = key;
+          }
+        }
+
         // Replace complete, mark this task completed
         if (lane_idx == (size_t)next_lane) {
           active = false;
@@ -657,15 +848,28 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
       if (found_lane >= 0) {
         size_t found_offset = (next_set * set_associativity + next_slab) * warp_size + found_lane;
 
+        // Publish the key only after the value, see the LR replacement above.
         if (lane_idx == (size_t)next_lane) {
-          keys[next_set].set_[next_slab].slab_[found_lane] = key;
+          keys[next_set].set_[next_slab].slab_[found_lane] = lock_free_query ? empty_key : key;
           slot_counter[found_offset] = global_counter->load(cuda::std::memory_order_relaxed);
         }
+        if (lock_free_query) {
+          __threadfence();
+          warp_tile.sync();
+        }
 
         warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
                                   vals + found_offset * embedding_vec_size,
                                   d_values + next_idx * embedding_vec_size);
 
+        if (lock_free_query) {
+          __threadfence();
+          warp_tile.sync();
+          if (lane_idx == (size_t)next_lane) {
+            keys[next_set].set_[next_slab].slab_[found_lane] = key;
+          }
+        }
+
         if (lane_idx == (size_t)next_lane) {
           active = false;
         }
@@ -691,26 +895,45 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
     warp_unlock_mutex<mutex, warp_size>(warp_tile, set_mutex[next_set]);
   }
 }
+
+template <typename key_type, typename slabset, typename ref_counter_type, typename mutex,
+          typename atomic_ref_counter_type, typename set_hasher, typename slab_hasher,
+          typename value_type, key_type empty_key, int set_associativity, int warp_size,
+          typename task_type>
+__global__ void insert_replace_kernel(const task_group<task_type> group,
+                                      const size_t task_per_warp_tile) {
+  const task_type& task = group.tasks[blockIdx.y];
+  if (blockIdx.x * (blockDim.x / warp_size) * task_per_warp_tile >= task.len) {
+    return;
+  }
+  insert_replace_kernel_impl<key_type, slabset, ref_counter_type, mutex, atomic_ref_counter_type,
+                             set_hasher, slab_hasher, value_type, empty_key, set_associativity,
+                             warp_size>(
+      task.d_keys, task.d_values, task.embedding_vec_size, task.len, task.d_len, task.keys,
+      task.vals, task.slot_counter, task.set_mutex, task.global_counter, task.capacity_in_set,
+      task.admission, task.lock_free_query, task_per_warp_tile, blockIdx.x);
+}
 #else
 // Kernel to insert or replace the <k,v> pairs into the cache
 template <typename key_type, typename slabset, typename ref_counter_type, typename set_hasher,
-          typename slab_hasher, key_type empty_key, int set_associativity, int warp_size,
+          typename slab_hasher, typename value_type, key_type empty_key, int set_associativity,
+          int warp_size,
           ref_counter_type max_ref_counter_type = std::numeric_limits<ref_counter_type>::max(),
           size_t max_slab_distance = std::numeric_limits<size_t>::max()>
-__global__ void insert_replace_kernel(const key_type* d_keys, const float* d_values,
-                                      const size_t embedding_vec_size, const size_t len,
-                                      volatile slabset* keys, volatile float* vals,
-                                      volatile ref_counter_type* slot_counter,
-                                      volatile int* set_mutex, ref_counter_type* global_counter,
-                                      const size_t capacity_in_set,
-                                      const size_t task_per_warp_tile) {
+__device__ __forceinline__ void insert_replace_kernel_impl(
+    const key_type* d_keys, const float* d_values, const size_t embedding_vec_size,
+    const size_t len, const size_t* d_len, volatile slabset* keys, volatile value_type* vals,
+    volatile ref_counter_type* slot_counter, volatile int* set_mutex,
+    ref_counter_type* global_counter, const size_t capacity_in_set,
+    const admission_sketch<key_type>& admission, const bool lock_free_query,
+    const size_t task_per_warp_tile, const size_t block_idx) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
       cg::tiled_partition<warp_size>(cg::this_thread_block());
   const size_t lane_idx = warp_tile.thread_rank();
   // Warp tile global ID
   const size_t warp_tile_global_idx =
-      (blockIdx.x * (blockDim.x / warp_size)) + warp_tile.meta_group_rank();
+      (block_idx * (blockDim.x / warp_size)) + warp_tile.meta_group_rank();
   // The index of key for this thread
   const size_t key_idx = (warp_tile_global_idx * task_per_warp_tile) + lane_idx;
   // The assigned key for this lane(thread)
@@ -721,9 +944,10 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
   // Active flag: whether current lane(thread) has unfinished task
   bool active = false;
   if (lane_idx < task_per_warp_tile) {
-    if (key_idx < len) {
-      active = true;
+    if (key_idx < len && (d_len == nullptr || key_idx < *d_len)) {
       key = d_keys[key_idx];
+      // Keys rejected by the admission policy are not inserted
+      active = admission.counters == nullptr || admission_sketch_admit(admission, key);
       src_set = set_hasher::hash(key) % capacity_in_set;
       src_slab = slab_hasher::hash(key) % set_associativity;
     }
@@ -772,16 +996,31 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
         size_t slot_index =
             (next_set * set_associativity + target_slab) * warp_size + slot_distance;
 
-        // Replace the LR slot
+        // Replace the LR slot. Lock-free queries must never see the key next to a partially
+        // written value. Hence, clear the slot, write the value, and only then publish the key.
+        // Until then, queries for keys in later slabs of this set stop at the cleared slot.
         if (lane_idx == (size_t)next_lane) {
-          ((volatile key_type*)(keys[next_set].set_[target_slab].slab_))[slot_distance] = key;
+          ((volatile key_type*)(keys[next_set].set_[target_slab].slab_))[slot_distance] =
+              lock_free_query ? empty_key : key;
           slot_counter[slot_index] = atomicAdd(global_counter, 0);
         }
+        if (lock_free_query) {
+          __threadfence();
+          warp_tile.sync();
+        }
 
         warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
-                                  (volatile float*)(vals + slot_index * embedding_vec_size),
+                                  (volatile value_type*)(vals + slot_index * embedding_vec_size),
                                   (volatile float*)(d_values + next_idx * embedding_vec_size));
 
+        if (lock_free_query) {
+          __threadfence();
+          warp_tile.sync();
+          if (lane_idx == (size_t)next_lane) {
+            ((volatile key_type*)(keys[next_set].set_[target_slab].slab_))[slot_distance] = key;
+          }
+        }
+
         // Replace complete, mark this task completed
         if (lane_idx == (size_t)next_lane) {
           active = false;
@@ -816,15 +1055,29 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
       if (found_lane >= 0) {
         size_t found_offset = (next_set * set_associativity + next_slab) * warp_size + found_lane;
 
+        // Publish the key only after the value, see the LR replacement above.
         if (lane_idx == (size_t)next_lane) {
-          ((volatile key_type*)(keys[next_set].set_[next_slab].slab_))[found_lane] = key;
+          ((volatile key_type*)(keys[next_set].set_[next_slab].slab_))[found_lane] =
+              lock_free_query ? empty_key : key;
           slot_counter[found_offset] = atomicAdd(global_counter, 0);
         }
+        if (lock_free_query) {
+          __threadfence();
+          warp_tile.sync();
+        }
 
         warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
-                                  (volatile float*)(vals + found_offset * embedding_vec_size),
+                                  (volatile value_type*)(vals + found_offset * embedding_vec_size),
                                   (volatile float*)(d_values + next_idx * embedding_vec_size));
 
+        if (lock_free_query) {
+          __threadfence();
+          warp_tile.sync();
+          if (lane_idx == (size_t)next_lane) {
+            ((volatile key_type*)(keys[next_set].set_[next_slab].slab_))[found_lane] = key;
+          }
+        }
+
         if (lane_idx == (size_t)next_lane) {
           active = false;
         }
@@ -850,16 +1103,33 @@ __global__ void insert_replace_kernel(const key_type* d_keys, const float* d_val
     warp_unlock_mutex<warp_size>(warp_tile, set_mutex[next_set]);
   }
 }
+
+template <typename key_type, typename slabset, typename ref_counter_type, typename set_hasher,
+          typename slab_hasher, typename value_type, key_type empty_key, int set_associativity,
+          int warp_size, typename task_type>
+__global__ void insert_replace_kernel(const task_group<task_type> group,
+                                      const size_t task_per_warp_tile) {
+  const task_type& task = group.tasks[blockIdx.y];
+  if (blockIdx.x * (blockDim.x / warp_size) * task_per_warp_tile >= task.len) {
+    return;
+  }
+  insert_replace_kernel_impl<key_type, slabset, ref_counter_type, set_hasher, slab_hasher,
+                             value_type, empty_key, set_associativity, warp_size>(
+      task.d_keys, task.d_values, task.embedding_vec_size, task.len, task.d_len, task.keys,
+      task.vals, task.slot_counter, task.set_mutex, task.global_counter, task.capacity_in_set,
+      task.admission, task.lock_free_query, task_per_warp_tile, blockIdx.x);
+}
 #endif
 
 #ifdef LIBCUDACXX_VERSION
 // Kernel to update the existing keys in the cache
 // Will not change the locality information
 template <typename key_type, typename slabset, typename set_hasher, typename slab_hasher,
-          typename mutex, key_type empty_key, int set_associativity, int warp_size>
+          typename value_type, typename mutex, key_type empty_key, int set_associativity,
+          int warp_size>
 __global__ void update_kernel(const key_type* d_keys, const size_t len, const float* d_values,
                               const size_t embedding_vec_size, const size_t capacity_in_set,
-                              const slabset* keys, float* vals, mutex* set_mutex,
+                              const slabset* keys, value_type* vals, mutex* set_mutex,
                               const size_t task_per_warp_tile) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
@@ -966,11 +1236,11 @@ __global__ void update_kernel(const key_type* d_keys, const size_t len, const fl
 // Kernel to update the existing keys in the cache
 // Will not change the locality information
 template <typename key_type, typename slabset, typename set_hasher, typename slab_hasher,
-          key_type empty_key, int set_associativity, int warp_size>
+          typename value_type, key_type empty_key, int set_associativity, int warp_size>
 __global__ void update_kernel(const key_type* d_keys, const size_t len, const float* d_values,
                               const size_t embedding_vec_size, const size_t capacity_in_set,
-                              volatile slabset* keys, volatile float* vals, volatile int* set_mutex,
-                              const size_t task_per_warp_tile) {
+                              volatile slabset* keys, volatile value_type* vals,
+                              volatile int* set_mutex, const size_t task_per_warp_tile) {
   // Lane(thread) ID within a warp_tile
   cg::thread_block_tile<warp_size> warp_tile =
       cg::tiled_partition<warp_size>(cg::this_thread_block());
@@ -1045,7 +1315,7 @@ __global__ void update_kernel(const key_type* d_keys, const size_t len, const fl
         }
 
         warp_tile_copy<warp_size>(lane_idx, embedding_vec_size,
-                                  (volatile float*)(vals + found_offset * embedding_vec_size),
+                                  (volatile value_type*)(vals + found_offset * embedding_vec_size),
                                   (volatile float*)(d_values + next_idx * embedding_vec_size));
 
         active_mask = warp_tile.ballot(active);
@@ -1229,10 +1499,18 @@ __global__ void dump_kernel(key_type* d_keys, size_t* d_dump_counter, volatile s
 
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-          slab_hasher>::gpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size)
-    : capacity_in_set_(capacity_in_set), embedding_vec_size_(embedding_vec_size) {
+          slab_hasher, value_type>::gpu_cache(const size_t capacity_in_set,
+                                              const size_t embedding_vec_size,
+                                              const uint32_t admission_threshold,
+                                              const bool lock_free_query)
+    : memory_(nullptr),
+      ipc_opened_(false),
+      capacity_in_set_(capacity_in_set),
+      embedding_vec_size_(embedding_vec_size),
+      lock_free_query_(lock_free_query),
+      admission_filter_(nullptr) {
   // Check parameter
   if (capacity_in_set_ == 0) {
     printf("Error: Invalid value for capacity_in_set.\n");
@@ -1258,14 +1536,9 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
   // Calculate # of slot
   num_slot_ = capacity_in_set_ * set_associativity * warp_size;
 
-  // Allocate GPU memory for cache
-  CUDA_CHECK(cudaMalloc((void**)&keys_, sizeof(slabset) * capacity_in_set_));
-  CUDA_CHECK(cudaMalloc((void**)&vals_, sizeof(float) * embedding_vec_size_ * num_slot_));
-  CUDA_CHECK(cudaMalloc((void**)&slot_counter_, sizeof(ref_counter_type) * num_slot_));
-  CUDA_CHECK(cudaMalloc((void**)&global_counter_, sizeof(atomic_ref_counter_type)));
-
-  // Allocate GPU memory for set mutex
-  CUDA_CHECK(cudaMalloc((void**)&set_mutex_, sizeof(mutex) * capacity_in_set_));
+  // Allocate GPU memory for cache and set mutex
+  CUDA_CHECK(cudaMalloc((void**)&memory_, memory_size_()));
+  assign_memory_(memory_);
 
   // Initialize the cache, set all entry to unused <K,V>
   init_cache<<<((num_slot_ - 1) / BLOCK_SIZE_) + 1, BLOCK_SIZE_>>>(
@@ -1274,13 +1547,25 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
   // Wait for initialization to finish
   CUDA_CHECK(cudaStreamSynchronize(0));
   CUDA_CHECK(cudaGetLastError());
+
+  if (admission_threshold > 1) {
+    admission_filter_ = new admission_filter<key_type>(num_slot_, admission_threshold);
+  }
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-          slab_hasher>::gpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size)
-    : capacity_in_set_(capacity_in_set), embedding_vec_size_(embedding_vec_size) {
+          slab_hasher, value_type>::gpu_cache(const size_t capacity_in_set,
+                                              const size_t embedding_vec_size,
+                                              const uint32_t admission_threshold,
+                                              const bool lock_free_query)
+    : memory_(nullptr),
+      ipc_opened_(false),
+      capacity_in_set_(capacity_in_set),
+      embedding_vec_size_(embedding_vec_size),
+      lock_free_query_(lock_free_query),
+      admission_filter_(nullptr) {
   // Check parameter
   if (capacity_in_set_ == 0) {
     printf("Error: Invalid value for capacity_in_set.\n");
@@ -1306,14 +1591,9 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
   // Calculate # of slot
   num_slot_ = capacity_in_set_ * set_associativity * warp_size;
 
-  // Allocate GPU memory for cache
-  CUDA_CHECK(cudaMalloc((void**)&keys_, sizeof(slabset) * capacity_in_set_));
-  CUDA_CHECK(cudaMalloc((void**)&vals_, sizeof(float) * embedding_vec_size_ * num_slot_));
-  CUDA_CHECK(cudaMalloc((void**)&slot_counter_, sizeof(ref_counter_type) * num_slot_));
-  CUDA_CHECK(cudaMalloc((void**)&global_counter_, sizeof(ref_counter_type)));
-
-  // Allocate GPU memory for set mutex
-  CUDA_CHECK(cudaMalloc((void**)&set_mutex_, sizeof(int) * capacity_in_set_));
+  // Allocate GPU memory for cache and set mutex
+  CUDA_CHECK(cudaMalloc((void**)&memory_, memory_size_()));
+  assign_memory_(memory_);
 
   // Initialize the cache, set all entry to unused <K,V>
   init_cache<<<((num_slot_ - 1) / BLOCK_SIZE_) + 1, BLOCK_SIZE_>>>(
@@ -1322,204 +1602,395 @@ gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, s
   // Wait for initialization to finish
   CUDA_CHECK(cudaStreamSynchronize(0));
   CUDA_CHECK(cudaGetLastError());
+
+  if (admission_threshold > 1) {
+    admission_filter_ = new admission_filter<key_type>(num_slot_, admission_threshold);
+  }
 }
 #endif
 
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+          slab_hasher, value_type>::gpu_cache(const size_t capacity_in_set,
+                                              const size_t embedding_vec_size,
+                                              const cudaIpcMemHandle_t& ipc_handle,
+                                              const bool lock_free_query)
+    : memory_(nullptr),
+      ipc_opened_(false),
+      capacity_in_set_(capacity_in_set),
+      embedding_vec_size_(embedding_vec_size),
+      lock_free_query_(lock_free_query),
+      admission_filter_(nullptr) {
+  // Check parameter
+  if (capacity_in_set_ == 0) {
+    printf("Error: Invalid value for capacity_in_set.\n");
+    return;
+  }
+  if (embedding_vec_size_ == 0) {
+    printf("Error: Invalid value for embedding_vec_size.\n");
+    return;
+  }
+
+  // Get the current CUDA dev
+  CUDA_CHECK(cudaGetDevice(&dev_));
+
+  // Calculate # of slot
+  num_slot_ = capacity_in_set_ * set_associativity * warp_size;
+
+  // Map the memory of the owner, which already initialized the cache
+  CUDA_CHECK(cudaIpcOpenMemHandle((void**)&memory_, ipc_handle, cudaIpcMemLazyEnablePeerAccess));
+  ipc_opened_ = true;
+  assign_memory_(memory_);
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+size_t gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+                 slab_hasher, value_type>::memory_size_() const {
+  // Every part starts at a multiple of 256 bytes, like separate cudaMalloc allocations
+  const auto align = [](const size_t size) { return (size + 255) / 256 * 256; };
+  return align(sizeof(slabset) * capacity_in_set_) +
+         align(sizeof(value_type) * embedding_vec_size_ * num_slot_) +
+         align(sizeof(ref_counter_type) * num_slot_) + align(sizeof(*global_counter_)) +
+         align(sizeof(*set_mutex_) * capacity_in_set_);
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+               slab_hasher, value_type>::assign_memory_(char* memory) {
+  const auto align = [](const size_t size) { return (size + 255) / 256 * 256; };
+  keys_ = reinterpret_cast<slabset*>(memory);
+  memory += align(sizeof(slabset) * capacity_in_set_);
+  vals_ = reinterpret_cast<value_type*>(memory);
+  memory += align(sizeof(value_type) * embedding_vec_size_ * num_slot_);
+  slot_counter_ = reinterpret_cast<ref_counter_type*>(memory);
+  memory += align(sizeof(ref_counter_type) * num_slot_);
+  global_counter_ = reinterpret_cast<decltype(global_counter_)>(memory);
+  memory += align(sizeof(*global_counter_));
+  set_mutex_ = reinterpret_cast<decltype(set_mutex_)>(memory);
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+cudaIpcMemHandle_t gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size,
+                             set_hasher, slab_hasher, value_type>::GetIpcHandle() const {
+  cudaIpcMemHandle_t handle;
+  if (ipc_opened_) {
+    printf("Error: Only the owner of a cache can export it.\n");
+    memset(&handle, 0, sizeof(handle));
+    return handle;
+  }
+  CUDA_CHECK(cudaIpcGetMemHandle(&handle, memory_));
+  return handle;
+}
+
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-          slab_hasher>::~gpu_cache() {
+          slab_hasher, value_type>::~gpu_cache() {
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
 
   // Check device
   dev_restorer.check_device(dev_);
 
+  // The objects of an opened cache are destructed by the owner
+  if (ipc_opened_) {
+    CUDA_CHECK(cudaIpcCloseMemHandle(memory_));
+    return;
+  }
+
   // Destruct CUDA std object
   destruct_kernel<<<((capacity_in_set_ - 1) / BLOCK_SIZE_) + 1, BLOCK_SIZE_>>>(
       global_counter_, set_mutex_, capacity_in_set_);
   // Wait for destruction to finish
   CUDA_CHECK(cudaStreamSynchronize(0));
 
-  // Free GPU memory for cache
-  CUDA_CHECK(cudaFree(keys_));
-  CUDA_CHECK(cudaFree(vals_));
-  CUDA_CHECK(cudaFree(slot_counter_));
-  CUDA_CHECK(cudaFree(global_counter_));
-  // Free GPU memory for set mutex
-  CUDA_CHECK(cudaFree(set_mutex_));
+  // Free GPU memory for cache and set mutex
+  CUDA_CHECK(cudaFree(memory_));
+
+  delete admission_filter_;
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-          slab_hasher>::~gpu_cache() noexcept(false) {
+          slab_hasher, value_type>::~gpu_cache() noexcept(false) {
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
 
   // Check device
   dev_restorer.check_device(dev_);
 
-  // Free GPU memory for cache
-  CUDA_CHECK(cudaFree(keys_));
-  CUDA_CHECK(cudaFree(vals_));
-  CUDA_CHECK(cudaFree(slot_counter_));
-  CUDA_CHECK(cudaFree(global_counter_));
-  // Free GPU memory for set mutex
-  CUDA_CHECK(cudaFree(set_mutex_));
+  if (ipc_opened_) {
+    CUDA_CHECK(cudaIpcCloseMemHandle(memory_));
+    return;
+  }
+
+  // Free GPU memory for cache and set mutex
+  CUDA_CHECK(cudaFree(memory_));
+
+  delete admission_filter_;
 }
 #endif
 
-#ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Query(const key_type* d_keys, const size_t len, float* d_values,
-                                   uint64_t* d_missing_index, key_type* d_missing_keys,
-                                   size_t* d_missing_len, cudaStream_t stream,
-                                   const size_t task_per_warp_tile) {
-  // Device Restorer
-  nv::CudaDeviceRestorer dev_restorer;
-  // Check device
-  dev_restorer.check_device(dev_);
-
-  // Check if it is a valid query
-  if (len == 0) {
-    // Set the d_missing_len to 0 before return
-    CUDA_CHECK(cudaMemsetAsync(d_missing_len, 0, sizeof(size_t), stream));
-    return;
-  }
+               slab_hasher, value_type>::Query(const key_type* d_keys, const size_t len,
+                                               float* d_values, uint64_t* d_missing_index,
+                                               key_type* d_missing_keys, size_t* d_missing_len,
+                                               cudaStream_t stream,
+                                               const size_t task_per_warp_tile) {
+  QueryWithDeviceLen(d_keys, nullptr, len, d_values, d_missing_index, d_missing_keys,
+                     d_missing_len, stream, task_per_warp_tile);
+}
 
-  // Update the global counter as user perform a new(most recent) read operation to the cache
-  // Resolve distance overflow issue as well.
-  update_kernel_overflow_ignore<atomic_ref_counter_type>
-      <<<1, 1, 0, stream>>>(global_counter_, d_missing_len);
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+               slab_hasher, value_type>::Replace(const key_type* d_keys, const size_t len,
+                                                 const float* d_values, cudaStream_t stream,
+                                                 const size_t task_per_warp_tile) {
+  ReplaceWithDeviceLen(d_keys, nullptr, len, d_values, stream, task_per_warp_tile);
+}
 
-  // Read from the cache
-  // Touch and refresh the hitting slot
-  const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
-  const size_t grid_size = ((len - 1) / keys_per_block) + 1;
-  get_kernel<key_type, ref_counter_type, atomic_ref_counter_type, slabset, set_hasher, slab_hasher,
-             mutex, empty_key, set_associativity, warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      d_keys, len, d_values, embedding_vec_size_, d_missing_index, d_missing_keys, d_missing_len,
-      global_counter_, slot_counter_, capacity_in_set_, keys_, vals_, set_mutex_,
-      task_per_warp_tile);
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+               slab_hasher, value_type>::QueryWithDeviceLen(const key_type* d_keys,
+                                                            const size_t* d_len, const size_t len,
+                                                            float* d_values,
+                                                            uint64_t* d_missing_index,
+                                                            key_type* d_missing_keys,
+                                                            size_t* d_missing_len,
+                                                            cudaStream_t stream,
+                                                            const size_t task_per_warp_tile) {
+  const gpu_cache_query_task<key_type> task{
+      this, d_keys, d_len, len, d_values, d_missing_index, d_missing_keys, d_missing_len};
+  QueryGrouped(&task, 1, stream, task_per_warp_tile);
+}
 
-  // Check for GPU error before return
-  CUDA_CHECK(cudaGetLastError());
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+               slab_hasher, value_type>::ReplaceWithDeviceLen(const key_type* d_keys,
+                                                              const size_t* d_len,
+                                                              const size_t len,
+                                                              const float* d_values,
+                                                              cudaStream_t stream,
+                                                              const size_t task_per_warp_tile) {
+  const gpu_cache_replace_task<key_type> task{this, d_keys, d_len, len, d_values};
+  ReplaceGrouped(&task, 1, stream, task_per_warp_tile);
 }
-#else
+
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Query(const key_type* d_keys, const size_t len, float* d_values,
-                                   uint64_t* d_missing_index, key_type* d_missing_keys,
-                                   size_t* d_missing_len, cudaStream_t stream,
-                                   const size_t task_per_warp_tile) {
+               slab_hasher, value_type>::QueryGrouped(const gpu_cache_query_task<key_type>* tasks,
+                                                      const size_t num_tasks, cudaStream_t stream,
+                                                      const size_t task_per_warp_tile) {
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
   // Check device
   dev_restorer.check_device(dev_);
 
-  // Check if it is a valid query
-  if (len == 0) {
-    // Set the d_missing_len to 0 before return
-    CUDA_CHECK(cudaMemsetAsync(d_missing_len, 0, sizeof(size_t), stream));
-    return;
-  }
+#ifdef LIBCUDACXX_VERSION
+  using task_type = get_task<key_type, atomic_ref_counter_type, ref_counter_type, const slabset,
+                             const value_type, mutex>;
+#else
+  using task_type = get_task<key_type, ref_counter_type, volatile ref_counter_type,
+                             volatile slabset, volatile value_type, volatile int>;
+#endif
+  task_group<task_type> group;
+  group.num_tasks = 0;
+  size_t max_len = 0;
 
-  // Update the global counter as user perform a new(most recent) read operation to the cache
-  // Resolve distance overflow issue as well.
-  update_kernel_overflow_ignore<ref_counter_type>
-      <<<1, 1, 0, stream>>>(global_counter_, d_missing_len);
+  const auto launch = [&]() {
+    if (group.num_tasks == 0) {
+      return;
+    }
 
-  // Read from the cache
-  // Touch and refresh the hitting slot
-  const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
-  const size_t grid_size = ((len - 1) / keys_per_block) + 1;
-  get_kernel<key_type, ref_counter_type, slabset, set_hasher, slab_hasher, empty_key,
-             set_associativity, warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      d_keys, len, d_values, embedding_vec_size_, d_missing_index, d_missing_keys, d_missing_len,
-      global_counter_, slot_counter_, capacity_in_set_, keys_, vals_, set_mutex_,
-      task_per_warp_tile);
+    // Update the global counter as user perform a new(most recent) read operation to the cache
+    // Resolve distance overflow issue as well.
+    update_kernel_overflow_ignore<task_type><<<1, group.num_tasks, 0, stream>>>(group);
 
-  // Check for GPU error before return
-  CUDA_CHECK(cudaGetLastError());
-}
+    // Read from the cache
+    // Touch and refresh the hitting slot
+    const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
+    const dim3 grid_size(((max_len - 1) / keys_per_block) + 1, group.num_tasks);
+#ifdef LIBCUDACXX_VERSION
+    get_kernel<key_type, ref_counter_type, atomic_ref_counter_type, slabset, set_hasher,
+               slab_hasher, value_type, mutex, empty_key, set_associativity, warp_size>
+        <<<grid_size, BLOCK_SIZE_, 0, stream>>>(group, task_per_warp_tile);
+#else
+    get_kernel<key_type, ref_counter_type, slabset, set_hasher, slab_hasher, value_type, empty_key,
+               set_associativity, warp_size>
+        <<<grid_size, BLOCK_SIZE_, 0, stream>>>(group, task_per_warp_tile);
 #endif
 
-#ifdef LIBCUDACXX_VERSION
-template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
-void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Replace(const key_type* d_keys, const size_t len,
-                                     const float* d_values, cudaStream_t stream,
-                                     const size_t task_per_warp_tile) {
-  // Check if it is a valid replacement
-  if (len == 0) {
-    return;
-  }
+    // Check for GPU error before return
+    CUDA_CHECK(cudaGetLastError());
+    group.num_tasks = 0;
+    max_len = 0;
+  };
+
+  for (const gpu_cache_query_task<key_type>* t = tasks; t != &tasks[num_tasks]; ++t) {
+    const auto cache = dynamic_cast<gpu_cache*>(t->cache);
+    if (!cache || cache->dev_ != dev_) {
+      // Cannot fuse the queries of other cache types or devices.
+      gpu_cache_api<key_type>::QueryGrouped(t, 1, stream, task_per_warp_tile);
+      continue;
+    }
 
-  // Device Restorer
-  nv::CudaDeviceRestorer dev_restorer;
-  // Check device
-  dev_restorer.check_device(dev_);
+    // Check if it is a valid query
+    if (t->len == 0) {
+      // Set the d_missing_len to 0 before return
+      CUDA_CHECK(cudaMemsetAsync(t->d_missing_len, 0, sizeof(size_t), stream));
+      continue;
+    }
 
-  // Try to insert the <k,v> paris into the cache as long as there are unused slot
-  // Then replace the <k,v> pairs into the cache
-  const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
-  const size_t grid_size = ((len - 1) / keys_per_block) + 1;
-  insert_replace_kernel<key_type, slabset, ref_counter_type, mutex, atomic_ref_counter_type,
-                        set_hasher, slab_hasher, empty_key, set_associativity, warp_size>
-      <<<grid_size, BLOCK_SIZE_, 0, stream>>>(d_keys, d_values, embedding_vec_size_, len, keys_,
-                                              vals_, slot_counter_, set_mutex_, global_counter_,
-                                              capacity_in_set_, task_per_warp_tile);
+    group.tasks[group.num_tasks++] = {t->d_keys, t->len, t->d_len, t->d_values,
+                                      cache->embedding_vec_size_, t->d_missing_index,
+                                      t->d_missing_keys, t->d_missing_len, cache->global_counter_,
+                                      cache->slot_counter_, cache->capacity_in_set_, cache->keys_,
+                                      cache->vals_, cache->set_mutex_, cache->lock_free_query_};
+    max_len = std::max(max_len, t->len);
+    if (group.num_tasks == GROUPED_TASKS_PER_LAUNCH) {
+      launch();
+    }
+  }
+  launch();
+}
 
-  // Check for GPU error before return
-  CUDA_CHECK(cudaGetLastError());
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+               slab_hasher, value_type>::ReplaceGrouped(const gpu_cache_replace_task<key_type>*
+                                                            tasks,
+                                                        const size_t num_tasks, cudaStream_t stream,
+                                                        const size_t task_per_warp_tile) {
+  replace_grouped_(tasks, num_tasks, stream, task_per_warp_tile, true);
 }
-#else
+
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Replace(const key_type* d_keys, const size_t len,
-                                     const float* d_values, cudaStream_t stream,
-                                     const size_t task_per_warp_tile) {
-  // Check if it is a valid replacement
-  if (len == 0) {
-    return;
-  }
+               slab_hasher, value_type>::Preload(const key_type* d_keys, const size_t len,
+                                                 const float* d_values, cudaStream_t stream,
+                                                 const size_t task_per_warp_tile) {
+  const gpu_cache_replace_task<key_type> task{this, d_keys, nullptr, len, d_values};
+  replace_grouped_(&task, 1, stream, task_per_warp_tile, false);
+}
 
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
+void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
+               slab_hasher, value_type>::replace_grouped_(const gpu_cache_replace_task<key_type>*
+                                                              tasks,
+                                                          const size_t num_tasks,
+                                                          cudaStream_t stream,
+                                                          const size_t task_per_warp_tile,
+                                                          const bool use_admission_filter) {
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
   // Check device
   dev_restorer.check_device(dev_);
 
-  // Try to insert the <k,v> paris into the cache as long as there are unused slot
-  // Then replace the <k,v> pairs into the cache
-  const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
-  const size_t grid_size = ((len - 1) / keys_per_block) + 1;
-  insert_replace_kernel<key_type, slabset, ref_counter_type, set_hasher, slab_hasher, empty_key,
-                        set_associativity, warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-      d_keys, d_values, embedding_vec_size_, len, keys_, vals_, slot_counter_, set_mutex_,
-      global_counter_, capacity_in_set_, task_per_warp_tile);
+#ifdef LIBCUDACXX_VERSION
+  using task_type = replace_task<key_type, const atomic_ref_counter_type, ref_counter_type,
+                                 slabset, value_type, mutex>;
+#else
+  using task_type = replace_task<key_type, ref_counter_type, volatile ref_counter_type,
+                                 volatile slabset, volatile value_type, volatile int>;
+#endif
+  task_group<task_type> group;
+  group.num_tasks = 0;
+  size_t max_len = 0;
 
-  // Check for GPU error before return
-  CUDA_CHECK(cudaGetLastError());
-}
+  const auto launch = [&]() {
+    if (group.num_tasks == 0) {
+      return;
+    }
+
+    // Try to insert the <k,v> paris into the cache as long as there are unused slot
+    // Then replace the <k,v> pairs into the cache
+    const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
+    const dim3 grid_size(((max_len - 1) / keys_per_block) + 1, group.num_tasks);
+#ifdef LIBCUDACXX_VERSION
+    insert_replace_kernel<key_type, slabset, ref_counter_type, mutex, atomic_ref_counter_type,
+                          set_hasher, slab_hasher, value_type, empty_key, set_associativity,
+                          warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(group,
+                                                                           task_per_warp_tile);
+#else
+    insert_replace_kernel<key_type, slabset, ref_counter_type, set_hasher, slab_hasher,
+                          value_type, empty_key, set_associativity, warp_size>
+        <<<grid_size, BLOCK_SIZE_, 0, stream>>>(group, task_per_warp_tile);
 #endif
 
+    // Check for GPU error before return
+    CUDA_CHECK(cudaGetLastError());
+    group.num_tasks = 0;
+    max_len = 0;
+  };
+
+  for (const gpu_cache_replace_task<key_type>* t = tasks; t != &tasks[num_tasks]; ++t) {
+    const auto cache = dynamic_cast<gpu_cache*>(t->cache);
+    if (!cache || cache->dev_ != dev_) {
+      // Cannot fuse the replacements of other cache types or devices.
+      if (use_admission_filter) {
+        gpu_cache_api<key_type>::ReplaceGrouped(t, 1, stream, task_per_warp_tile);
+      } else {
+        t->cache->Preload(t->d_keys, t->len, t->d_values, stream, task_per_warp_tile);
+      }
+      continue;
+    }
+
+    // Check if it is a valid replacement
+    if (t->len == 0) {
+      continue;
+    }
+    if (cache->ipc_opened_) {
+      printf("Error: Cannot insert into a cache opened from the handle of another process.\n");
+      continue;
+    }
+
+    admission_sketch<key_type> admission{nullptr, 0, 0};
+    if (use_admission_filter && cache->admission_filter_) {
+      admission = cache->admission_filter_->sketch();
+      cache->admission_filter_->Age(t->len, t->d_len, stream);
+    }
+    group.tasks[group.num_tasks++] = {t->d_keys, t->d_values, cache->embedding_vec_size_, t->len,
+                                      t->d_len, cache->keys_, cache->vals_, cache->slot_counter_,
+                                      cache->set_mutex_, cache->global_counter_,
+                                      cache->capacity_in_set_, admission,
+                                      cache->lock_free_query_};
+    max_len = std::max(max_len, t->len);
+    if (group.num_tasks == GROUPED_TASKS_PER_LAUNCH) {
+      launch();
+    }
+  }
+  launch();
+}
+
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Update(const key_type* d_keys, const size_t len, const float* d_values,
-                                    cudaStream_t stream, const size_t task_per_warp_tile) {
+               slab_hasher, value_type>::Update(const key_type* d_keys, const size_t len,
+                                                const float* d_values, cudaStream_t stream,
+                                                const size_t task_per_warp_tile) {
   // Check if it is a valid update request
   if (len == 0) {
     return;
   }
+  if (ipc_opened_) {
+    printf("Error: Cannot update a cache opened from the handle of another process.\n");
+    return;
+  }
 
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
@@ -1529,8 +2000,8 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
   // Update the value of input keys that are existed in the cache
   const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
   const size_t grid_size = ((len - 1) / keys_per_block) + 1;
-  update_kernel<key_type, slabset, set_hasher, slab_hasher, mutex, empty_key, set_associativity,
-                warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+  update_kernel<key_type, slabset, set_hasher, slab_hasher, value_type, mutex, empty_key,
+                set_associativity, warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
       d_keys, len, d_values, embedding_vec_size_, capacity_in_set_, keys_, vals_, set_mutex_,
       task_per_warp_tile);
 
@@ -1539,14 +2010,19 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Update(const key_type* d_keys, const size_t len, const float* d_values,
-                                    cudaStream_t stream, const size_t task_per_warp_tile) {
+               slab_hasher, value_type>::Update(const key_type* d_keys, const size_t len,
+                                                const float* d_values, cudaStream_t stream,
+                                                const size_t task_per_warp_tile) {
   // Check if it is a valid update request
   if (len == 0) {
     return;
   }
+  if (ipc_opened_) {
+    printf("Error: Cannot update a cache opened from the handle of another process.\n");
+    return;
+  }
 
   // Device Restorer
   nv::CudaDeviceRestorer dev_restorer;
@@ -1556,10 +2032,10 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
   // Update the value of input keys that are existed in the cache
   const size_t keys_per_block = (BLOCK_SIZE_ / warp_size) * task_per_warp_tile;
   const size_t grid_size = ((len - 1) / keys_per_block) + 1;
-  update_kernel<key_type, slabset, set_hasher, slab_hasher, empty_key, set_associativity, warp_size>
-      <<<grid_size, BLOCK_SIZE_, 0, stream>>>(d_keys, len, d_values, embedding_vec_size_,
-                                              capacity_in_set_, keys_, vals_, set_mutex_,
-                                              task_per_warp_tile);
+  update_kernel<key_type, slabset, set_hasher, slab_hasher, value_type, empty_key,
+                set_associativity, warp_size><<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+      d_keys, len, d_values, embedding_vec_size_, capacity_in_set_, keys_, vals_, set_mutex_,
+      task_per_warp_tile);
 
   // Check for GPU error before return
   CUDA_CHECK(cudaGetLastError());
@@ -1568,11 +2044,11 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 
 #ifdef LIBCUDACXX_VERSION
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Dump(key_type* d_keys, size_t* d_dump_counter,
-                                  const size_t start_set_index, const size_t end_set_index,
-                                  cudaStream_t stream) {
+               slab_hasher, value_type>::Dump(key_type* d_keys, size_t* d_dump_counter,
+                                              const size_t start_set_index,
+                                              const size_t end_set_index, cudaStream_t stream) {
   // Check if it is a valid dump request
   if (start_set_index >= capacity_in_set_) {
     printf("Error: Invalid value for start_set_index. Nothing dumped.\n");
@@ -1603,11 +2079,11 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 }
 #else
 template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
-          int warp_size, typename set_hasher, typename slab_hasher>
+          int warp_size, typename set_hasher, typename slab_hasher, typename value_type>
 void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_size, set_hasher,
-               slab_hasher>::Dump(key_type* d_keys, size_t* d_dump_counter,
-                                  const size_t start_set_index, const size_t end_set_index,
-                                  cudaStream_t stream) {
+               slab_hasher, value_type>::Dump(key_type* d_keys, size_t* d_dump_counter,
+                                              const size_t start_set_index,
+                                              const size_t end_set_index, cudaStream_t stream) {
   // Check if it is a valid dump request
   if (start_set_index >= capacity_in_set_) {
     printf("Error: Invalid value for start_set_index. Nothing dumped.\n");
@@ -1638,8 +2114,20 @@ void gpu_cache<key_type, ref_counter_type, empty_key, set_associativity, warp_si
 }
 #endif
 
-template class gpu_cache<unsigned int, uint64_t, std::numeric_limits<unsigned int>::max(),
-                         SET_ASSOCIATIVITY, SLAB_SIZE>;
-template class gpu_cache<long long, uint64_t, std::numeric_limits<long long>::max(),
-                         SET_ASSOCIATIVITY, SLAB_SIZE>;
+#define GPU_CACHE_INSTANTIATE(key_type, value_type)                                  \
+  template class gpu_cache<key_type, uint64_t, std::numeric_limits<key_type>::max(), \
+                           SET_ASSOCIATIVITY, SLAB_SIZE, MurmurHash3_32<key_type>,   \
+                           Mod_Hash<key_type, size_t>, value_type>
+
+GPU_CACHE_INSTANTIATE(unsigned int, float);
+GPU_CACHE_INSTANTIATE(unsigned int, __half);
+GPU_CACHE_INSTANTIATE(unsigned int, __nv_bfloat16);
+GPU_CACHE_INSTANTIATE(unsigned int, __nv_fp8_e4m3);
+GPU_CACHE_INSTANTIATE(long long, float);
+GPU_CACHE_INSTANTIATE(long long, __half);
+GPU_CACHE_INSTANTIATE(long long, __nv_bfloat16);
+GPU_CACHE_INSTANTIATE(long long, __nv_fp8_e4m3);
+
+#undef GPU_CACHE_INSTANTIATE
+
 }  // namespace gpu_cache
@@ -256,7 +256,8 @@ __global__ void LookupKernel(key_type *table_keys, size_type *table_indices, flo
                              int64_t capacity, const key_type *keys, int num_keys,
                              const value_type *values, int value_dim, out_value_type *output,
                              hasher hash, const key_type empty_key, out_value_type default_value,
-                             const size_type invalid_slot) {
+                             const size_type invalid_slot, key_type *missing_keys,
+                             uint64_t *missing_index, size_t *missing_len) {
   static_assert(tile_size <= group_size, "tile_size cannot be larger than group_size");
   constexpr int WARP_SIZE = 32;
   static_assert(WARP_SIZE % tile_size == 0, "tile_size must be divisible by warp_size");
@@ -286,6 +287,15 @@ __global__ void LookupKernel(key_type *table_keys, size_type *table_indices, flo
       auto slot_to_read = warp_tile.shfl(slot, i * tile_size);
       int idx_to_write = warp_tile.shfl(key_num, 0) + i;
       if (idx_to_write >= num_keys) break;
+      if (slot_to_read == invalid_slot && missing_len) {
+        if (warp_tile.thread_rank() == 0) {
+          const size_t missing_idx =
+              atomicAdd(reinterpret_cast<unsigned long long *>(missing_len), 1);
+          missing_keys[missing_idx] = keys[idx_to_write];
+          missing_index[missing_idx] = idx_to_write;
+        }
+        continue;
+      }
       if (slot_to_read == invalid_slot) {
         warp_tile_copy<WARP_SIZE, value_type>(warp_tile.thread_rank(), value_dim,
                                               output + (size_t)value_dim * idx_to_write,
@@ -309,6 +319,104 @@ __global__ void LookupKernel(key_type *table_keys, size_type *table_indices, flo
   }
 }
 
+template <unsigned int tile_size, unsigned int group_size, typename key_type, typename value_type,
+          typename size_type, typename hasher>
+__global__ void LookupQuantizedKernel(key_type *table_keys, size_type *table_indices,
+                                      float *quant_scales_, int64_t capacity, const key_type *keys,
+                                      int num_keys, const value_type *values, int value_dim,
+                                      value_type *output, float *output_scales, hasher hash,
+                                      const key_type empty_key, const value_type default_value,
+                                      const size_type invalid_slot) {
+  static_assert(tile_size <= group_size, "tile_size cannot be larger than group_size");
+  constexpr int WARP_SIZE = 32;
+  static_assert(WARP_SIZE % tile_size == 0, "tile_size must be divisible by warp_size");
+
+  auto block = cooperative_groups::this_thread_block();
+  auto tile = cooperative_groups::tiled_partition<tile_size>(block);
+  auto warp_tile = cooperative_groups::tiled_partition<WARP_SIZE>(block);
+
+  int tile_idx = tile.meta_group_size() * block.group_index().x + tile.meta_group_rank();
+  int tile_cnt = tile.meta_group_size() * gridDim.x;
+
+  for (int it = 0; it < (num_keys - 1) / tile_cnt + 1; it++) {
+    size_type slot = invalid_slot;
+    int key_num = it * tile_cnt + tile_idx;
+    if (key_num < num_keys) {
+      key_type key = keys[key_num];
+      if (key == empty_key) {
+        if (tile.thread_rank() == 0 && table_keys[capacity] == key) {
+          slot = capacity;
+        }
+      } else {
+        slot = lookup<group_size>(table_keys, capacity, key, hash, tile, empty_key, invalid_slot);
+      }
+    }
+    for (int i = 0; i < WARP_SIZE / tile_size; i++) {
+      auto slot_to_read = warp_tile.shfl(slot, i * tile_size);
+      int idx_to_write = warp_tile.shfl(key_num, 0) + i;
+      if (idx_to_write >= num_keys) break;
+      value_type *dst = output + (size_t)value_dim * idx_to_write;
+      if (slot_to_read == invalid_slot) {
+        for (int j = warp_tile.thread_rank(); j < value_dim; j += WARP_SIZE) {
+          dst[j] = default_value;
+        }
+        if (warp_tile.thread_rank() == 0) {
+          output_scales[idx_to_write] = 1.0f;
+        }
+        continue;
+      }
+      auto index = table_indices[slot_to_read];
+
+      // The stored values are copied without rescaling, so each row keeps its own scale.
+      const value_type *src = values + (size_t)value_dim * index;
+      for (int j = warp_tile.thread_rank(); j < value_dim; j += WARP_SIZE) {
+        dst[j] = src[j];
+      }
+      if (warp_tile.thread_rank() == 0) {
+        if constexpr (nv::is_fp8<value_type>::value) {
+          output_scales[idx_to_write] = quant_scales_[index];
+        } else {
+          output_scales[idx_to_write] = 1.0f;
+        }
+      }
+    }
+  }
+}
+
+template <unsigned int tile_size, unsigned int group_size, typename key_type, typename value_type,
+          typename size_type, typename hasher>
+__global__ void UpdateKernel(key_type *table_keys, const size_type *table_indices,
+                             int64_t capacity, const key_type *keys, size_type num_keys,
+                             const value_type *new_values, value_type *values, int value_dim,
+                             hasher hash, const key_type empty_key, const size_type invalid_slot) {
+  static_assert(tile_size <= group_size, "tile_size cannot be larger than group_size");
+
+  auto block = cooperative_groups::this_thread_block();
+  auto tile = cooperative_groups::tiled_partition<tile_size>(block);
+
+  int tile_idx = tile.meta_group_size() * block.group_index().x + tile.meta_group_rank();
+  int tile_cnt = tile.meta_group_size() * gridDim.x;
+
+  for (size_t i = tile_idx; i < static_cast<size_t>(num_keys); i += tile_cnt) {
+    key_type key = keys[i];
+    size_type slot = invalid_slot;
+    if (key == empty_key) {
+      if (table_keys[capacity] == key) {
+        slot = capacity;
+      }
+    } else {
+      slot = lookup<group_size>(table_keys, capacity, key, hash, tile, empty_key, invalid_slot);
+    }
+    if (slot == invalid_slot) {
+      continue;
+    }
+    const size_t index = table_indices[slot];
+    for (size_t j = tile.thread_rank(); j < static_cast<size_t>(value_dim); j += tile_size) {
+      values[index * value_dim + j] = new_values[i * value_dim + j];
+    }
+  }
+}
+
 template <typename key_type, typename value_type, typename out_value_type, unsigned int tile_size,
           unsigned int group_size, typename hasher>
 StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size,
@@ -425,6 +533,26 @@ void StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size
   size_ += num_keys;
 }
 
+template <typename key_type, typename value_type, typename out_value_type, unsigned int tile_size,
+          unsigned int group_size, typename hasher>
+void StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size, hasher>::update(
+    const key_type *keys, const value_type *values, size_type num_keys, cudaStream_t stream) {
+  if (num_keys == 0) {
+    return;
+  }
+  if constexpr (nv::is_fp8<value_type>::value) {
+    printf("Error: Quantized tables cannot be updated\n");
+    return;
+  }
+
+  constexpr int block = 256;
+  const int grid = (num_keys - 1) / block + 1;
+  UpdateKernel<tile_size, group_size><<<grid, block, 0, stream>>>(
+      table_keys_, table_indices_, key_capacity_, keys, num_keys, values, table_values_,
+      value_dim_, hash_, empty_key, invalid_slot);
+  CUDA_CHECK(cudaGetLastError());
+}
+
 template <typename key_type, typename value_type, typename out_value_type, unsigned int tile_size,
           unsigned int group_size, typename hasher>
 void StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size, hasher>::clear(
@@ -470,7 +598,10 @@ template <typename key_type, typename value_type, typename out_value_type, unsig
           unsigned int group_size, typename hasher>
 void StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size, hasher>::lookup(
     const key_type *keys, out_value_type *values, int num_keys, out_value_type default_value,
-    cudaStream_t stream) {
+    cudaStream_t stream, key_type *missing_keys, uint64_t *missing_index, size_t *missing_len) {
+  if (missing_len) {
+    CUDA_CHECK(cudaMemsetAsync(missing_len, 0, sizeof(size_t), stream));
+  }
   if (num_keys == 0) {
     return;
   }
@@ -480,7 +611,26 @@ void StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size
   // Lookup keys
   LookupKernel<tile_size, group_size><<<grid, block, 0, stream>>>(
       table_keys_, table_indices_, quant_scales_, key_capacity_, keys, num_keys, table_values_,
-      value_dim_, values, hash_, empty_key, default_value, invalid_slot);
+      value_dim_, values, hash_, empty_key, default_value, invalid_slot, missing_keys,
+      missing_index, missing_len);
+  cudaStreamSynchronize(stream);
+}
+
+template <typename key_type, typename value_type, typename out_value_type, unsigned int tile_size,
+          unsigned int group_size, typename hasher>
+void StaticHashTable<key_type, value_type, out_value_type, tile_size, group_size,
+                     hasher>::lookup_quantized(const key_type *keys, value_type *values,
+                                               float *scales, int num_keys,
+                                               value_type default_value, cudaStream_t stream) {
+  if (num_keys == 0) {
+    return;
+  }
+
+  constexpr int block = 256;
+  const int grid = (num_keys - 1) / block + 1;
+  LookupQuantizedKernel<tile_size, group_size><<<grid, block, 0, stream>>>(
+      table_keys_, table_indices_, quant_scales_, key_capacity_, keys, num_keys, table_values_,
+      value_dim_, values, scales, hash_, empty_key, default_value, invalid_slot);
   cudaStreamSynchronize(stream);
 }
 
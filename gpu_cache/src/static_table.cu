@@ -46,6 +46,32 @@ void static_table<key_type, value_type, out_value_type>::Query(const key_type* d
   static_hash_table_.lookup(d_keys, d_values, len, default_value_, stream);
 }
 
+template <typename key_type, typename value_type, typename out_value_type>
+void static_table<key_type, value_type, out_value_type>::Query(
+    const key_type* d_keys, const size_t len, out_value_type* d_values, key_type* d_missing_keys,
+    uint64_t* d_missing_index, size_t* d_missing_len, cudaStream_t stream) {
+  static_hash_table_.lookup(d_keys, d_values, len, default_value_, stream, d_missing_keys,
+                            d_missing_index, d_missing_len);
+}
+
+template <typename key_type, typename value_type, typename out_value_type>
+void static_table<key_type, value_type, out_value_type>::QueryQuantized(const key_type* d_keys,
+                                                                        const size_t len,
+                                                                        value_type* d_values,
+                                                                        float* d_scales,
+                                                                        cudaStream_t stream) {
+  static_hash_table_.lookup_quantized(d_keys, d_values, d_scales, len,
+                                      value_type(float(default_value_)), stream);
+}
+
+template <typename key_type, typename value_type, typename out_value_type>
+void static_table<key_type, value_type, out_value_type>::Update(const key_type* d_keys,
+                                                                const size_t len,
+                                                                const value_type* d_values,
+                                                                cudaStream_t stream) {
+  static_hash_table_.update(d_keys, d_values, len, stream);
+}
+
 template <typename key_type, typename value_type, typename out_value_type>
 void static_table<key_type, value_type, out_value_type>::Init(const key_type* d_keys,
                                                               const size_t len,
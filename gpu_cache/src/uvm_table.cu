@@ -273,6 +273,60 @@ __global__ void distribute_vectors_kernel(const index_type* positions, const siz
   }
 }
 
+// Host index of the keys that were served from the promoted region
+template <typename index_type>
+__host__ __device__ constexpr index_type promoted_host_index() {
+  return std::numeric_limits<index_type>::max() - 1;
+}
+
+template <typename key_type, typename index_type, typename vec_type>
+__global__ void read_promoted_vectors_kernel(
+    const key_type* missing_keys, const int num_keys, const index_type* promoted_indices,
+    const vec_type* promoted_vectors, const int vec_size, int* missing_positions,
+    index_type* host_indices, vec_type* output_vectors, uint32_t* access_counts,
+    const size_t num_access_counters, const uint32_t promotion_threshold,
+    key_type* candidate_keys, index_type* candidate_indices, int* candidate_count,
+    const int max_num_candidates) {
+  constexpr int warp_size = 32;
+
+  auto grid = cg::this_grid();
+  auto block = cg::this_thread_block();
+  auto tile = cg::tiled_partition<warp_size>(block);
+
+#if (CUDA_VERSION < 11060)
+  size_t num_warps_per_grid = grid.size() / warp_size;
+#else
+  size_t num_warps_per_grid = grid.num_threads() / warp_size;
+#endif
+
+  for (size_t i = grid.thread_rank() / warp_size; i < num_keys; i += num_warps_per_grid) {
+    const index_type promoted_idx = promoted_indices[i];
+    if (promoted_idx != std::numeric_limits<index_type>::max()) {
+      const size_t idx_write = missing_positions[i];
+      warp_tile_copy<warp_size>(tile.thread_rank(), vec_size,
+                                output_vectors + idx_write * vec_size,
+                                promoted_vectors + (size_t)promoted_idx * vec_size);
+      tile.sync();
+      // Neither copy these keys from the host nor distribute them again.
+      if (tile.thread_rank() == 0) {
+        missing_positions[i] = std::numeric_limits<int>::max();
+        host_indices[i] = promoted_host_index<index_type>();
+      }
+    } else if (tile.thread_rank() == 0) {
+      const index_type host_idx = host_indices[i];
+      if (host_idx == std::numeric_limits<index_type>::max()) continue;
+      const uint32_t count = atomicAdd(&access_counts[host_idx % num_access_counters], 1) + 1;
+      if (count == promotion_threshold) {
+        const int idx_candidate = atomicAdd(candidate_count, 1);
+        if (idx_candidate < max_num_candidates) {
+          candidate_keys[idx_candidate] = missing_keys[i];
+          candidate_indices[idx_candidate] = host_idx;
+        }
+      }
+    }
+  }
+}
+
 }  // namespace
 
 namespace gpu_cache {
@@ -280,7 +334,10 @@ template <typename key_type, typename index_type, typename vec_type>
 UvmTable<key_type, index_type, vec_type>::UvmTable(const size_t device_table_capacity,
                                                    const size_t host_table_capacity,
                                                    const int max_batch_size, const int vec_size,
-                                                   const vec_type default_value)
+                                                   const vec_type default_value,
+                                                   const size_t promotion_capacity,
+                                                   const uint32_t promotion_threshold,
+                                                   const int promotion_interval)
     : max_batch_size_(std::max(100000, max_batch_size)),
       vec_size_(vec_size),
       num_set_((device_table_capacity - 1) / set_size + 1),
@@ -288,7 +345,9 @@ UvmTable<key_type, index_type, vec_type>::UvmTable(const size_t device_table_cap
       table_capacity_(num_set_ * set_size),
       default_vector_(vec_size, default_value),
       device_table_(device_table_capacity, set_size, max_batch_size_),
-      host_table_(host_table_capacity * 1.1, set_size, max_batch_size_) {
+      host_table_(host_table_capacity * 1.1, set_size, max_batch_size_),
+      promotion_threshold_(std::max(1u, promotion_threshold)),
+      promotion_interval_(std::max(1, promotion_interval)) {
   CUDA_CHECK(cudaMalloc(&d_keys_buffer_, sizeof(key_type) * max_batch_size_));
   CUDA_CHECK(cudaMalloc(&d_vectors_buffer_, sizeof(vec_type) * max_batch_size_ * vec_size_));
   CUDA_CHECK(cudaMalloc(&d_vectors_, sizeof(vec_type) * device_table_.capacity * vec_size_));
@@ -312,12 +371,35 @@ UvmTable<key_type, index_type, vec_type>::UvmTable(const size_t device_table_cap
   CUDA_CHECK(cudaMallocHost(&h_missing_keys_, sizeof(key_type) * max_batch_size_));
   CUDA_CHECK(cudaEventCreate(&query_event_));
   h_vectors_.resize(host_table_.capacity * vec_size_);
+
+  if (promotion_capacity) {
+    promoted_table_ = std::make_unique<HashBlock<key_type, index_type>>(
+        promotion_capacity, set_size, max_batch_size_);
+    CUDA_CHECK(cudaMalloc(&d_promoted_vectors_,
+                          sizeof(vec_type) * promoted_table_->capacity * vec_size_));
+    CUDA_CHECK(cudaMalloc(&d_output_promoted_indices_, sizeof(index_type) * max_batch_size_));
+
+    num_access_counters_ = std::min(host_table_.capacity, max_num_access_counters_);
+    CUDA_CHECK(cudaMalloc(&d_access_counts_, sizeof(uint32_t) * num_access_counters_));
+    CUDA_CHECK(cudaMemset(d_access_counts_, 0, sizeof(uint32_t) * num_access_counters_));
+
+    // The candidates are staged in the copy buffers when they are promoted.
+    max_num_candidates_ = ceil(1.0 * max_batch_size_ / num_buffers_);
+    CUDA_CHECK(cudaMalloc(&d_candidate_keys_, sizeof(key_type) * max_num_candidates_));
+    CUDA_CHECK(cudaMalloc(&d_candidate_indices_, sizeof(index_type) * max_num_candidates_));
+    CUDA_CHECK(cudaMalloc(&d_candidate_count_, sizeof(int)));
+    CUDA_CHECK(cudaMemset(d_candidate_count_, 0, sizeof(int)));
+  }
 }
 
 template <typename key_type, typename index_type, typename vec_type>
 void UvmTable<key_type, index_type, vec_type>::add(const key_type* h_keys,
                                                    const vec_type* h_vectors,
                                                    const size_t num_keys) {
+  // The promoted copies of the updated keys would become stale.
+  clear_promoted_keys_(0);
+  CUDA_CHECK(cudaStreamSynchronize(0));
+
   std::vector<key_type> h_missing_keys;
   size_t num_batches = (num_keys - 1) / max_batch_size_ + 1;
   for (size_t i = 0; i < num_batches; i++) {
@@ -421,6 +503,9 @@ template <typename key_type, typename index_type, typename vec_type>
 void UvmTable<key_type, index_type, vec_type>::query(const key_type* d_keys, const int num_keys,
                                                      vec_type* d_vectors, cudaStream_t stream) {
   if (!num_keys) return;
+  if (promoted_table_ && ++num_queries_ % promotion_interval_ == 0) {
+    promote_hot_keys_();
+  }
   CUDA_CHECK(cudaEventRecord(query_event_, stream));
   CUDA_CHECK(cudaStreamWaitEvent(query_stream_, query_event_));
 
@@ -438,6 +523,18 @@ void UvmTable<key_type, index_type, vec_type>::query(const key_type* d_keys, con
   host_table_.query(d_missing_keys_, d_missing_count_, d_output_host_indices_, query_stream_);
   CUDA_CHECK(cudaStreamSynchronize(cpy_streams_[0]));
 
+  if (promoted_table_ && num_missing_keys) {
+    promoted_table_->query(d_missing_keys_, num_missing_keys, d_output_promoted_indices_, nullptr,
+                           nullptr, nullptr, query_stream_);
+    constexpr int num_warps_per_block = block_size / 32;
+    read_promoted_vectors_kernel<<<(num_missing_keys - 1) / num_warps_per_block + 1, block_size, 0,
+                                   query_stream_>>>(
+        d_missing_keys_, num_missing_keys, d_output_promoted_indices_, d_promoted_vectors_,
+        vec_size_, d_missing_positions_, d_output_host_indices_, d_vectors, d_access_counts_,
+        num_access_counters_, promotion_threshold_, d_candidate_keys_, d_candidate_indices_,
+        d_candidate_count_, max_num_candidates_);
+  }
+
   CUDA_CHECK(cudaMemsetAsync(d_missing_count_, 0, sizeof(*d_missing_count_), query_stream_));
 
   CUDA_CHECK(cudaMemcpyAsync(h_output_host_indices_, d_output_host_indices_,
@@ -464,6 +561,7 @@ void UvmTable<key_type, index_type, vec_type>::query(const key_type* d_keys, con
     for (size_t i = 0; i < static_cast<size_t>(num_keys_this_buffer); i++) {
       size_t idx_key = buffer_num * num_keys_per_buffer + i;
       index_type index = h_output_host_indices_[idx_key];
+      if (index == promoted_host_index<index_type>()) continue;
       if (index == std::numeric_limits<index_type>::max()) {
         key_type key = h_missing_keys_[idx_key];
         auto iterator = h_final_missing_items_.find(key);
@@ -499,6 +597,67 @@ template <typename key_type, typename index_type, typename vec_type>
 void UvmTable<key_type, index_type, vec_type>::clear(cudaStream_t stream) {
   device_table_.clear(stream);
   host_table_.clear(stream);
+  clear_promoted_keys_(stream);
+}
+
+template <typename key_type, typename index_type, typename vec_type>
+void UvmTable<key_type, index_type, vec_type>::clear_promoted_keys_(cudaStream_t stream) {
+  if (!promoted_table_) return;
+  promoted_table_->clear(stream);
+  num_promoted_keys_ = 0;
+  CUDA_CHECK(cudaMemsetAsync(d_access_counts_, 0, sizeof(uint32_t) * num_access_counters_, stream));
+  CUDA_CHECK(cudaMemsetAsync(d_candidate_count_, 0, sizeof(int), stream));
+}
+
+template <typename key_type, typename index_type, typename vec_type>
+void UvmTable<key_type, index_type, vec_type>::promote_hot_keys_() {
+  int num_candidates;
+  CUDA_CHECK(cudaMemcpyAsync(&num_candidates, d_candidate_count_, sizeof(num_candidates),
+                             cudaMemcpyDeviceToHost, query_stream_));
+  CUDA_CHECK(cudaStreamSynchronize(query_stream_));
+  num_candidates = std::min(num_candidates, max_num_candidates_);
+  if (num_promoted_keys_ >= promoted_table_->capacity) {
+    num_candidates = 0;
+  }
+
+  if (num_candidates) {
+    // Gather the vectors of the candidates from the host table.
+    CUDA_CHECK(cudaMemcpyAsync(h_output_host_indices_, d_candidate_indices_,
+                               sizeof(index_type) * num_candidates, cudaMemcpyDeviceToHost,
+                               query_stream_));
+    CUDA_CHECK(cudaStreamSynchronize(query_stream_));
+#pragma omp parallel for num_threads(8)
+    for (size_t i = 0; i < static_cast<size_t>(num_candidates); i++) {
+      memcpy(h_cpy_buffers_[0] + i * vec_size_,
+             h_vectors_.data() + h_output_host_indices_[i] * vec_size_,
+             sizeof(vec_type) * vec_size_);
+    }
+    CUDA_CHECK(cudaMemcpyAsync(d_cpy_buffers_[0], h_cpy_buffers_[0],
+                               sizeof(vec_type) * num_candidates * vec_size_,
+                               cudaMemcpyHostToDevice, query_stream_));
+
+    // Candidates that fall into full sets of the promoted table remain on the host.
+    promoted_table_->add(d_candidate_keys_, num_candidates, d_missing_keys_, d_missing_count_,
+                         query_stream_);
+    promoted_table_->query(d_candidate_keys_, num_candidates, d_output_promoted_indices_, nullptr,
+                           nullptr, nullptr, query_stream_);
+    distribute_vectors_kernel<<<(num_candidates - 1) / block_size + 1, block_size, 0,
+                                query_stream_>>>(d_output_promoted_indices_, num_candidates,
+                                                 d_cpy_buffers_[0], vec_size_,
+                                                 d_promoted_vectors_);
+
+    int num_rejected_keys;
+    CUDA_CHECK(cudaMemcpyAsync(&num_rejected_keys, d_missing_count_, sizeof(num_rejected_keys),
+                               cudaMemcpyDeviceToHost, query_stream_));
+    CUDA_CHECK(cudaMemsetAsync(d_missing_count_, 0, sizeof(*d_missing_count_), query_stream_));
+    CUDA_CHECK(cudaStreamSynchronize(query_stream_));
+    num_promoted_keys_ += num_candidates - num_rejected_keys;
+  }
+
+  // Start counting the next interval.
+  CUDA_CHECK(cudaMemsetAsync(d_access_counts_, 0, sizeof(uint32_t) * num_access_counters_,
+                             query_stream_));
+  CUDA_CHECK(cudaMemsetAsync(d_candidate_count_, 0, sizeof(int), query_stream_));
 }
 
 template <typename key_type, typename index_type, typename vec_type>
@@ -525,6 +684,15 @@ UvmTable<key_type, index_type, vec_type>::~UvmTable() {
     CUDA_CHECK(cudaStreamDestroy(cpy_streams_[i]));
     CUDA_CHECK(cudaEventDestroy(cpy_events_[i]));
   }
+
+  if (promoted_table_) {
+    CUDA_CHECK(cudaFree(d_promoted_vectors_));
+    CUDA_CHECK(cudaFree(d_output_promoted_indices_));
+    CUDA_CHECK(cudaFree(d_access_counts_));
+    CUDA_CHECK(cudaFree(d_candidate_keys_));
+    CUDA_CHECK(cudaFree(d_candidate_indices_));
+    CUDA_CHECK(cudaFree(d_candidate_count_));
+  }
 }
 
 template <typename key_type, typename index_type>
@@ -20,5 +20,6 @@ from hierarchical_parameter_server.core._version import __version__
 from hierarchical_parameter_server.core.initialize import Init
 from hierarchical_parameter_server.core.lookup_layer import LookupLayer
 from hierarchical_parameter_server.core.sparse_lookup_layer import SparseLookupLayer
+from hierarchical_parameter_server.core.ragged_lookup_layer import RaggedLookupLayer
 
 __all__ = [item for item in dir() if not item.startswith("__")]
@@ -157,3 +157,35 @@ def lookup(
     )
     ret = clip(embeddings, ids, max_norm)
     return array_ops.identity(ret)
+
+
+def ragged_lookup(
+    values,
+    row_splits,
+    model_name,
+    table_id,
+    emb_vec_size,
+    emb_vec_dtype,
+    ps_config_file,
+    global_batch_size,
+    combiner,
+):
+    """
+    This function is a wrapper of HPS's lookup forward propagation for ragged keys,
+    which pools the embeddings of each row on the GPU.
+    """
+    # Lazy initialization of hps
+    status = Init(ps_config_file=ps_config_file, global_batch_size=global_batch_size)
+    global_replica_id = get_global_replica_id(_get_comm_tool())
+    embeddings = hps_lib.ragged_lookup(
+        values=values,
+        row_splits=row_splits,
+        global_replica_id=global_replica_id,
+        model_name=model_name,
+        table_id=table_id,
+        emb_vec_size=emb_vec_size,
+        combiner=combiner,
+        dtype=emb_vec_dtype,
+        init_status=status,
+    )
+    return array_ops.identity(embeddings)
@@ -0,0 +1,150 @@
+"""
+ Copyright (c) 2023, NVIDIA CORPORATION.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+         http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+import tensorflow as tf
+from tensorflow.python.framework import sparse_tensor
+
+from hierarchical_parameter_server.core import lookup_ops
+
+
+class RaggedLookupLayer(tf.keras.layers.Layer):
+    """
+    Abbreviated as ``hps.RaggedLookupLayer(*args, **kwargs)``.
+
+    This is a wrapper class for HPS ragged lookup layer, which basically performs
+    the same function as ``tf.nn.embedding_lookup_sparse`` without weights, for
+    variable-length keys. The keys are passed to HPS as the values and row splits
+    of a ``tf.RaggedTensor``, without being padded. Each distinct key is queried once,
+    and the embeddings of each row are pooled by a single GPU kernel. Note that
+    ``ps_config_file`` and ``global_batch_size`` should be specified in the constructor
+    if you want to use implicit HPS initialization.
+
+    Parameters
+    ----------
+    model_name: str
+            The name of the model that has embedding tables.
+    table_id: int
+            The index of the embedding table for the model specified by
+            model_name.
+    emb_vec_size: int
+            The embedding vector size for the embedding table specified
+            by model_name and table_id.
+    emb_vec_dtype:
+            The data type of embedding vectors which must be ``tf.float32``.
+    ps_config_file: str
+            The JSON configuration file for HPS initialization.
+    global_batch_size: int
+            The global batch size for HPS that is deployed on multiple GPUs.
+
+    Examples
+    --------
+    .. code-block:: python
+
+        import hierarchical_parameter_server as hps
+
+        ragged_lookup_layer = hps.RaggedLookupLayer(model_name = args.model_name,
+                                                   table_id = args.table_id,
+                                                   emb_vec_size = args.embed_vec_size,
+                                                   emb_vec_dtype = tf.float32,
+                                                   ps_config_file = args.ps_config_file,
+                                                   global_batch_size = args.global_batch_size)
+
+        @tf.function
+        def _infer_step(inputs):
+            embedding_vector = ragged_lookup_layer(ids=inputs, combiner="mean")
+            ...
+
+        for i, (inputs, labels) in enumerate(dataset):
+            _infer_step(inputs)
+    """
+
+    def __init__(
+        self,
+        model_name,
+        table_id,
+        emb_vec_size,
+        emb_vec_dtype,
+        ps_config_file="",
+        global_batch_size=1,
+        **kwargs,
+    ):
+        super(RaggedLookupLayer, self).__init__(**kwargs)
+        self.model_name = model_name
+        self.table_id = table_id
+        self.emb_vec_size = emb_vec_size
+        self.emb_vec_dtype = emb_vec_dtype
+        self.ps_config_file = ps_config_file
+        self.global_batch_size = global_batch_size
+
+    def call(self, ids, combiner=None):
+        """
+        Looks up and pools the embeddings of each row of variable-length keys.
+        If an ID value cannot be found in the HPS, the default embeddings are retrieved,
+        which can be specified in the HPS configuration JSON file.
+
+        Parameters
+        ----------
+        ids:
+            N x None ``tf.RaggedTensor`` of ``int32`` or ``int64`` IDs, or N x M
+            ``SparseTensor`` of such IDs, whose indices are in canonical row-major order,
+            where N is typically batch size.
+        combiner:
+            A string that specifies the reduction op:
+
+            ``"sum"``
+              Computes the sum of the embedding results for each row.
+            ``"mean"``
+              Computes the mean of the embedding results for each row.
+
+            The default value is ``"mean"``.
+
+        Returns
+        -------
+        emb_vector: ``tf.Tensor`` of float32
+            A dense tensor of shape *[N, emb_vec_size]* with the combined embeddings of
+            each row. Rows without keys are combined to zeros.
+
+        Raises
+        ------
+            TypeError: If ``ids`` is neither a ``tf.RaggedTensor`` nor a ``SparseTensor``.
+            ValueError: If ``ids`` is not 2-D, or if ``combiner`` is not one of
+                {``"mean"``, ``"sum"``}.
+        """
+        if combiner is None:
+            combiner = "mean"
+        if combiner not in ("mean", "sum"):
+            raise ValueError(f"combiner must be one of 'mean' or 'sum', got {combiner}")
+
+        if isinstance(ids, sparse_tensor.SparseTensor):
+            ids = tf.RaggedTensor.from_sparse(ids)
+        if not isinstance(ids, tf.RaggedTensor):
+            raise TypeError(f"ids must be RaggedTensor or SparseTensor, got {type(ids)}")
+        if ids.ragged_rank != 1 or ids.shape.rank != 2:
+            raise ValueError(f"ids must be a 2-D RaggedTensor, got shape {ids.shape}")
+
+        embeddings = lookup_ops.ragged_lookup(
+            values=ids.values,
+            row_splits=ids.row_splits,
+            model_name=self.model_name,
+            table_id=self.table_id,
+            emb_vec_size=self.emb_vec_size,
+            emb_vec_dtype=self.emb_vec_dtype,
+            ps_config_file=self.ps_config_file,
+            global_batch_size=self.global_batch_size,
+            combiner=combiner,
+        )
+        embeddings.set_shape([ids.shape[0], self.emb_vec_size])
+        return embeddings
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <tensorflow/core/common_runtime/gpu/gpu_event_mgr.h>
 #include <tensorflow/core/framework/op_kernel.h>
 #ifndef TF_GE_211
 #include <tensorflow/stream_executor/cuda/cuda_activation.h>
@@ -48,31 +49,37 @@ class Lookup : public AsyncOpKernel {
   }
 
   void ComputeAsync(OpKernelContext *ctx, DoneCallback done) override {
-    auto work_func = [this, ctx, done]() {
-      auto stream = ctx->op_device_context()->stream();
-      ScopedActivateExecutorContext scoped_activation{stream->parent()};
-      cudaStream_t gpu_stream = AsGpuStreamValue(stream);
+    auto stream = ctx->op_device_context()->stream();
 
-      Tensor const *status_tensor = nullptr;
-      OP_REQUIRES_OK_ASYNC(ctx, ctx->input("init_status", &status_tensor), done);
-      std::string init_status = status_tensor->flat<tstring>()(0);
-      OP_REQUIRES_ASYNC(ctx, init_status == "OK",
-                        errors::Aborted("hierarchical parameter server is not initialized."), done);
+    Tensor const *status_tensor = nullptr;
+    OP_REQUIRES_OK_ASYNC(ctx, ctx->input("init_status", &status_tensor), done);
+    std::string init_status = status_tensor->flat<tstring>()(0);
+    OP_REQUIRES_ASYNC(ctx, init_status == "OK",
+                      errors::Aborted("hierarchical parameter server is not initialized."), done);
 
-      Tensor const *values_tensor = nullptr;
-      OP_REQUIRES_OK_ASYNC(ctx, ctx->input("values", &values_tensor), done);
+    Tensor const *values_tensor = nullptr;
+    OP_REQUIRES_OK_ASYNC(ctx, ctx->input("values", &values_tensor), done);
 
-      Tensor const *global_replica_id_tensor = nullptr;
-      OP_REQUIRES_OK_ASYNC(ctx, ctx->input("global_replica_id", &global_replica_id_tensor), done);
-      const int32_t global_replica_id_value = global_replica_id_tensor->scalar<int32_t>()();
+    Tensor const *global_replica_id_tensor = nullptr;
+    OP_REQUIRES_OK_ASYNC(ctx, ctx->input("global_replica_id", &global_replica_id_tensor), done);
+    const int32_t global_replica_id_value = global_replica_id_tensor->scalar<int32_t>()();
+
+    // allocate output
+    Tensor *emb_vector_tensor = nullptr;
+    TensorShape emb_vector_tensor_shape = values_tensor->shape();
+    emb_vector_tensor_shape.AppendShape({emb_vec_size_});
 
-      // allocate output
-      Tensor *emb_vector_tensor = nullptr;
-      TensorShape emb_vector_tensor_shape = values_tensor->shape();
-      emb_vector_tensor_shape.AppendShape({emb_vec_size_});
+    OP_REQUIRES_OK_ASYNC(ctx, ctx->allocate_output(0, emb_vector_tensor_shape, &emb_vector_tensor),
+                         done);
 
-      OP_REQUIRES_OK_ASYNC(
-          ctx, ctx->allocate_output(0, emb_vector_tensor_shape, &emb_vector_tensor), done);
+    // The lookup blocks on the HPS embedding cache, so it runs on the worker thread. It is only
+    // dispatched once the values are ready on the compute stream, and done is called once the
+    // lookup has completed on the compute stream, both from CUDA event callbacks.
+    auto event_mgr = event_mgr_(ctx);
+    auto work_func = [this, ctx, done, stream, event_mgr, values_tensor, emb_vector_tensor,
+                      global_replica_id_value]() {
+      ScopedActivateExecutorContext scoped_activation{stream->parent()};
+      cudaStream_t gpu_stream = AsGpuStreamValue(stream);
 
       // do forward propagation
       try {
@@ -89,12 +96,20 @@ class Lookup : public AsyncOpKernel {
         done();
         return;
       }
-      done();
+      event_mgr->ThenExecute(stream, done);
     };
-    thread_pool_.submit(work_func);
+    event_mgr->ThenExecute(stream, [this, work_func]() { thread_pool_.submit(work_func); });
   }
 
  private:
+  static EventMgr *event_mgr_(OpKernelContext *ctx) {
+#ifdef TF_GE_210
+    return ctx->device()->tensorflow_accelerator_device_info()->event_mgr;
+#else
+    return ctx->device()->tensorflow_gpu_device_info()->event_mgr;
+#endif
+  }
+
   std::string model_name_;
   tensorflow::int32 table_id_;
   tensorflow::int32 emb_vec_size_;
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tensorflow/core/common_runtime/gpu/gpu_event_mgr.h>
+#include <tensorflow/core/framework/op_kernel.h>
+#ifndef TF_GE_211
+#include <tensorflow/stream_executor/cuda/cuda_activation.h>
+#include <tensorflow/stream_executor/gpu/gpu_stream.h>
+#include <tensorflow/stream_executor/stream.h>
+#include <tensorflow/stream_executor/stream_executor.h>
+#else
+#include <tensorflow/compiler/xla/stream_executor/cuda/cuda_activation.h>
+#include <tensorflow/compiler/xla/stream_executor/gpu/gpu_stream.h>
+#include <tensorflow/compiler/xla/stream_executor/stream.h>
+#include <tensorflow/compiler/xla/stream_executor/stream_executor.h>
+#endif
+
+#include <hps/plugin/facade.hpp>
+#include <hps_cc/kernels/ragged_pooling.hpp>
+
+namespace tensorflow {
+
+using GPUDevice = Eigen::GpuDevice;
+using CPUDevice = Eigen::ThreadPoolDevice;
+using namespace HierarchicalParameterServer;
+using namespace stream_executor::gpu;
+using namespace stream_executor::cuda;
+
+namespace {
+
+/**
+ * Looks up the embedding vectors of the keys of a ragged batch, whose rows are given by
+ * row_splits, and pools the vectors of each row on the GPU. HPS deduplicates the keys, so that
+ * each distinct key is queried once. The vectors of the keys are written to emb_vectors, and the
+ * pooled ones to pooled_vectors.
+ */
+void ragged_lookup(const std::string &model_name, const int32_t table_id,
+                   const int32_t global_replica_id, const bool mean, const Tensor &values,
+                   const Tensor &row_splits, Tensor &emb_vectors, Tensor &pooled_vectors,
+                   cudaStream_t stream) {
+  const size_t num_keys = static_cast<size_t>(values.NumElements());
+  const size_t num_rows = static_cast<size_t>(row_splits.NumElements() - 1);
+  const size_t emb_vec_size = static_cast<size_t>(pooled_vectors.shape().dim_sizes().back());
+  if (num_keys > 0) {
+    Facade::instance()->forward(model_name.c_str(), table_id, global_replica_id, num_keys,
+                                emb_vec_size, values.data(), emb_vectors.data(),
+                                DT_INT64 == values.dtype(), stream);
+  }
+  const float *const d_emb_vectors = reinterpret_cast<const float *>(emb_vectors.data());
+  float *const d_pooled_vectors = reinterpret_cast<float *>(pooled_vectors.data());
+  if (DT_INT64 == row_splits.dtype()) {
+    HCTR_LIB_THROW(ragged_pooling(d_emb_vectors,
+                                  reinterpret_cast<const int64_t *>(row_splits.data()), num_rows,
+                                  emb_vec_size, mean, d_pooled_vectors, stream));
+  } else {
+    HCTR_LIB_THROW(ragged_pooling(d_emb_vectors,
+                                  reinterpret_cast<const int32_t *>(row_splits.data()), num_rows,
+                                  emb_vec_size, mean, d_pooled_vectors, stream));
+  }
+}
+
+}  // namespace
+
+#ifdef HPS_ASYNC_OP
+template <typename Device>
+class RaggedLookup : public AsyncOpKernel {
+ public:
+  explicit RaggedLookup(OpKernelConstruction *ctx) : AsyncOpKernel(ctx), thread_pool_("", 1) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("model_name", &model_name_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("table_id", &table_id_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("emb_vec_size", &emb_vec_size_));
+    std::string combiner;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("combiner", &combiner));
+    mean_ = combiner == "mean";
+  }
+
+  void ComputeAsync(OpKernelContext *ctx, DoneCallback done) override {
+    auto stream = ctx->op_device_context()->stream();
+
+    Tensor const *status_tensor = nullptr;
+    OP_REQUIRES_OK_ASYNC(ctx, ctx->input("init_status", &status_tensor), done);
+    std::string init_status = status_tensor->flat<tstring>()(0);
+    OP_REQUIRES_ASYNC(ctx, init_status == "OK",
+                      errors::Aborted("hierarchical parameter server is not initialized."), done);
+
+    Tensor const *values_tensor = nullptr;
+    OP_REQUIRES_OK_ASYNC(ctx, ctx->input("values", &values_tensor), done);
+    Tensor const *row_splits_tensor = nullptr;
+    OP_REQUIRES_OK_ASYNC(ctx, ctx->input("row_splits", &row_splits_tensor), done);
+    OP_REQUIRES_ASYNC(ctx, row_splits_tensor->NumElements() > 0,
+                      errors::InvalidArgument("row_splits must not be empty."), done);
+
+    Tensor const *global_replica_id_tensor = nullptr;
+    OP_REQUIRES_OK_ASYNC(ctx, ctx->input("global_replica_id", &global_replica_id_tensor), done);
+    const int32_t global_replica_id_value = global_replica_id_tensor->scalar<int32_t>()();
+
+    // allocate output, and the embedding vectors of the keys before they are pooled
+    Tensor *emb_vector_tensor = nullptr;
+    OP_REQUIRES_OK_ASYNC(ctx,
+                         ctx->allocate_output(
+                             0, TensorShape({row_splits_tensor->NumElements() - 1, emb_vec_size_}),
+                             &emb_vector_tensor),
+                         done);
+    Tensor key_emb_vector_tensor;
+    OP_REQUIRES_OK_ASYNC(
+        ctx,
+        ctx->allocate_temp(DT_FLOAT, TensorShape({values_tensor->NumElements(), emb_vec_size_}),
+                           &key_emb_vector_tensor),
+        done);
+
+    // Like the Lookup kernel, the lookup and the pooling run on the worker thread, once the inputs
+    // are ready on the compute stream.
+    auto event_mgr = event_mgr_(ctx);
+    auto work_func = [this, ctx, done, stream, event_mgr, values_tensor, row_splits_tensor,
+                      emb_vector_tensor, key_emb_vector_tensor, global_replica_id_value]() mutable {
+      ScopedActivateExecutorContext scoped_activation{stream->parent()};
+      cudaStream_t gpu_stream = AsGpuStreamValue(stream);
+      try {
+        ragged_lookup(model_name_, table_id_, global_replica_id_value, mean_, *values_tensor,
+                      *row_splits_tensor, key_emb_vector_tensor, *emb_vector_tensor, gpu_stream);
+      } catch (std::exception const &error) {
+        ctx->SetStatus(errors::Aborted(error.what()));
+        done();
+        return;
+      }
+      event_mgr->ThenExecute(stream, done);
+    };
+    event_mgr->ThenExecute(stream, [this, work_func]() { thread_pool_.submit(work_func); });
+  }
+
+ private:
+  static EventMgr *event_mgr_(OpKernelContext *ctx) {
+#ifdef TF_GE_210
+    return ctx->device()->tensorflow_accelerator_device_info()->event_mgr;
+#else
+    return ctx->device()->tensorflow_gpu_device_info()->event_mgr;
+#endif
+  }
+
+  std::string model_name_;
+  tensorflow::int32 table_id_;
+  tensorflow::int32 emb_vec_size_;
+  bool mean_;
+  HugeCTR::ThreadPool thread_pool_;
+};
+
+#else
+template <typename Device>
+class RaggedLookup : public OpKernel {
+ public:
+  explicit RaggedLookup(OpKernelConstruction *ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("model_name", &model_name_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("table_id", &table_id_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("emb_vec_size", &emb_vec_size_));
+    std::string combiner;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("combiner", &combiner));
+    mean_ = combiner == "mean";
+  }
+
+  void Compute(OpKernelContext *ctx) override {
+    cudaStream_t gpu_stream = AsGpuStreamValue(ctx->op_device_context()->stream());
+
+    Tensor const *status_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("init_status", &status_tensor));
+    std::string init_status = status_tensor->flat<tstring>()(0);
+    OP_REQUIRES(ctx, init_status == "OK",
+                errors::Aborted("hierarchical parameter server is not initialized."));
+
+    Tensor const *values_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("values", &values_tensor));
+    Tensor const *row_splits_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("row_splits", &row_splits_tensor));
+    OP_REQUIRES(ctx, row_splits_tensor->NumElements() > 0,
+                errors::InvalidArgument("row_splits must not be empty."));
+
+    Tensor const *global_replica_id_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("global_replica_id", &global_replica_id_tensor));
+    const int32_t global_replica_id_value = global_replica_id_tensor->scalar<int32_t>()();
+
+    // allocate output, and the embedding vectors of the keys before they are pooled
+    Tensor *emb_vector_tensor = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(
+                            0, TensorShape({row_splits_tensor->NumElements() - 1, emb_vec_size_}),
+                            &emb_vector_tensor));
+    Tensor key_emb_vector_tensor;
+    OP_REQUIRES_OK(ctx, ctx->allocate_temp(
+                            DT_FLOAT, TensorShape({values_tensor->NumElements(), emb_vec_size_}),
+                            &key_emb_vector_tensor));
+
+    try {
+      ragged_lookup(model_name_, table_id_, global_replica_id_value, mean_, *values_tensor,
+                    *row_splits_tensor, key_emb_vector_tensor, *emb_vector_tensor, gpu_stream);
+    } catch (std::exception const &error) {
+      ctx->SetStatus(errors::Aborted(error.what()));
+      return;
+    }
+  }
+
+  bool IsExpensive() override { return true; }
+
+ private:
+  std::string model_name_;
+  tensorflow::int32 table_id_;
+  tensorflow::int32 emb_vec_size_;
+  bool mean_;
+};
+#endif
+
+REGISTER_KERNEL_BUILDER(Name("RaggedLookup").Device(DEVICE_GPU).HostMemory("global_replica_id"),
+                        RaggedLookup<GPUDevice>);
+
+}  // namespace tensorflow
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <hps_cc/kernels/ragged_pooling.hpp>
+
+namespace HierarchicalParameterServer {
+
+namespace {
+
+// Each block pools rows, and its threads the elements of their embedding vectors.
+template <typename OffsetType>
+__global__ void ragged_pooling_kernel(const float* const emb_vectors,
+                                      const OffsetType* const row_splits, const size_t num_rows,
+                                      const size_t emb_vec_size, const bool mean,
+                                      float* const pooled_vectors) {
+  for (size_t row = blockIdx.x; row < num_rows; row += gridDim.x) {
+    const OffsetType begin = row_splits[row];
+    const OffsetType end = row_splits[row + 1];
+    for (size_t i = threadIdx.x; i < emb_vec_size; i += blockDim.x) {
+      float sum = 0.f;
+      for (OffsetType key = begin; key < end; ++key) {
+        sum += emb_vectors[static_cast<size_t>(key) * emb_vec_size + i];
+      }
+      if (mean && end > begin) {
+        sum /= static_cast<float>(end - begin);
+      }
+      pooled_vectors[row * emb_vec_size + i] = sum;
+    }
+  }
+}
+
+}  // namespace
+
+template <typename OffsetType>
+cudaError_t ragged_pooling(const float* const d_emb_vectors, const OffsetType* const d_row_splits,
+                           const size_t num_rows, const size_t emb_vec_size, const bool mean,
+                           float* const d_pooled_vectors, cudaStream_t stream) {
+  if (num_rows == 0 || emb_vec_size == 0) {
+    return cudaSuccess;
+  }
+  constexpr size_t max_grid_size = 65536;
+  const size_t block_size = std::min<size_t>(((emb_vec_size + 31) / 32) * 32, 1024);
+  const size_t grid_size = std::min(num_rows, max_grid_size);
+  ragged_pooling_kernel<<<grid_size, block_size, 0, stream>>>(
+      d_emb_vectors, d_row_splits, num_rows, emb_vec_size, mean, d_pooled_vectors);
+  return cudaGetLastError();
+}
+
+template cudaError_t ragged_pooling<int32_t>(const float*, const int32_t*, size_t, size_t, bool,
+                                             float*, cudaStream_t);
+template cudaError_t ragged_pooling<int64_t>(const float*, const int64_t*, size_t, size_t, bool,
+                                             float*, cudaStream_t);
+
+}  // namespace HierarchicalParameterServer
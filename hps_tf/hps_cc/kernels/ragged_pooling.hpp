@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cuda_runtime_api.h>
+
+#include <cstddef>
+
+namespace HierarchicalParameterServer {
+
+/**
+ * Pools the embedding vectors of the keys of each row of a ragged batch, whose rows are given by
+ * row_splits, the offsets of their first keys followed by the number of keys. The vectors of a
+ * row are summed, and divided by its number of keys if mean is set. Empty rows are pooled to
+ * zeros. Returns the error of the kernel launch.
+ */
+template <typename OffsetType>
+cudaError_t ragged_pooling(const float* d_emb_vectors, const OffsetType* d_row_splits,
+                           size_t num_rows, size_t emb_vec_size, bool mean,
+                           float* d_pooled_vectors, cudaStream_t stream);
+
+}  // namespace HierarchicalParameterServer
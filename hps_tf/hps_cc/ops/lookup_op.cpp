@@ -50,3 +50,42 @@ REGISTER_OP("Lookup")
       return OkStatus();
 #endif
     });
+
+REGISTER_OP("RaggedLookup")
+    .Input("values: value_dtype")
+    .Input("row_splits: row_splits_dtype")
+    .Input("global_replica_id: int32")
+    .Output("emb_vector: dtype")
+    .Attr("value_dtype: {int32, int64}")
+    .Attr("row_splits_dtype: {int32, int64}")
+    .Attr("model_name: string")
+    .Attr("table_id: int")
+    .Attr("emb_vec_size: int")
+    .Attr("combiner: {'sum', 'mean'}")
+    .Attr("dtype: {float32}")
+    .Input("init_status: status_dtype")
+    .Attr("status_dtype: {string}")
+    .SetShapeFn([](InferenceContext* ctx) {
+      ShapeHandle values_shape;
+      TF_RETURN_IF_ERROR(ctx->WithRank(ctx->input(0), 1, &values_shape));
+      ShapeHandle row_splits_shape;
+      TF_RETURN_IF_ERROR(ctx->WithRank(ctx->input(1), 1, &row_splits_shape));
+
+      ShapeHandle input_shape_2 = ctx->input(2);
+      DimensionHandle input_num_elem_2 = ctx->NumElements(input_shape_2);
+      if (1 != ctx->Value(input_num_elem_2)) {
+        return errors::InvalidArgument("global_replica_id must be a scalar.");
+      }
+
+      // One pooled embedding vector per row.
+      DimensionHandle num_rows;
+      TF_RETURN_IF_ERROR(ctx->Subtract(ctx->Dim(row_splits_shape, 0), 1, &num_rows));
+      int emb_vec_size;
+      TF_RETURN_IF_ERROR(ctx->GetAttr("emb_vec_size", &emb_vec_size));
+      ctx->set_output(0, ctx->Matrix(num_rows, emb_vec_size));
+#ifndef TF_GE_211
+      return Status::OK();
+#else
+      return OkStatus();
+#endif
+    });
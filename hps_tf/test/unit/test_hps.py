@@ -212,3 +212,36 @@ class TestHPS:
                             )
                             flag = tf.reduce_all(tf.equal(embeddings, embeddings_gt))
                             assert True == flag
+
+    def test_ragged_lookup_layer(cls):
+        for model in hps_config["models"]:
+            model_name = model["model"]
+            embedding_vecsize_per_table = model["embedding_vecsize_per_table"]
+            max_vocabulary_size_per_table = args["max_vocabulary_size_per_table_per_model"][
+                model_name
+            ]
+            max_nnz_per_sample_per_table = model["maxnum_catfeature_query_per_table_per_sample"]
+            for table_id in range(len(embedding_vecsize_per_table)):
+                for combiner in ["sum", "mean"]:
+                    ragged_lookup_layer = hps.RaggedLookupLayer(
+                        model_name=model_name,
+                        table_id=table_id,
+                        emb_vec_size=embedding_vecsize_per_table[table_id],
+                        emb_vec_dtype=tf.float32,
+                    )
+                    for i in range(args["num_iters"]):
+                        sparse_keys = _generate_sparse_keys(
+                            args["global_batch_size"],
+                            [0, max_vocabulary_size_per_table[table_id]],
+                            max_nnz_per_sample_per_table[table_id],
+                        )
+                        embeddings_gt = tf.nn.embedding_lookup_sparse(
+                            params=cls.embedding_tables[model_name][table_id],
+                            sp_ids=sparse_keys,
+                            sp_weights=None,
+                            combiner=combiner,
+                        )
+                        # Both sparse and ragged keys are pooled without padding.
+                        for keys in [sparse_keys, tf.RaggedTensor.from_sparse(sparse_keys)]:
+                            embeddings = ragged_lookup_layer(ids=keys, combiner=combiner)
+                            assert np.allclose(embeddings.numpy(), embeddings_gt.numpy(), atol=1e-5)
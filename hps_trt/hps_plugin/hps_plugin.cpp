@@ -21,6 +21,8 @@
 #include <utility>
 
 using namespace nvinfer1;
+using nvinfer1::plugin::HpsMultiTablePlugin;
+using nvinfer1::plugin::HpsMultiTablePluginCreator;
 using nvinfer1::plugin::HpsPlugin;
 using nvinfer1::plugin::HpsPluginCreator;
 
@@ -31,6 +33,13 @@ std::vector<PluginField> HpsPluginCreator::mPluginAttributes;
 
 REGISTER_TENSORRT_PLUGIN(HpsPluginCreator);
 
+static const char* HPS_MULTI_TABLE_PLUGIN_VERSION{"1"};
+static const char* HPS_MULTI_TABLE_PLUGIN_NAME{"HPS_TRT_MULTI_TABLE"};
+PluginFieldCollection HpsMultiTablePluginCreator::mFC{};
+std::vector<PluginField> HpsMultiTablePluginCreator::mPluginAttributes;
+
+REGISTER_TENSORRT_PLUGIN(HpsMultiTablePluginCreator);
+
 HpsPlugin::HpsPlugin(std::string name, std::string ps_config_file, std::string model_name,
                      int32_t table_id, int32_t emb_vec_size)
     : mLayerName(std::move(name)),
@@ -243,3 +252,237 @@ IPluginV2DynamicExt* HpsPluginCreator::deserializePlugin(const char* name, const
   }
   return nullptr;
 }
+
+HpsMultiTablePlugin::HpsMultiTablePlugin(std::string name, std::string ps_config_file,
+                                         std::string model_name,
+                                         std::vector<int32_t> emb_vec_sizes)
+    : mLayerName(std::move(name)),
+      ps_config_file(std::move(ps_config_file)),
+      model_name(std::move(model_name)),
+      emb_vec_sizes(std::move(emb_vec_sizes)) {}
+
+HpsMultiTablePlugin::HpsMultiTablePlugin(std::string name, const void* data, size_t length)
+    : mLayerName(std::move(name)) {
+  // Deserialize in the same order as serialization
+  const char *d = static_cast<const char*>(data), *a = d;
+
+  int32_t ps_config_file_str_size;
+  int32_t model_name_str_size;
+  int32_t num_tables;
+  ps_config_file_str_size = read<int32_t>(d);
+  ps_config_file = read_string(d, ps_config_file_str_size);
+  model_name_str_size = read<int32_t>(d);
+  model_name = read_string(d, model_name_str_size);
+  num_tables = read<int32_t>(d);
+  emb_vec_sizes.resize(num_tables);
+  for (auto& emb_vec_size : emb_vec_sizes) {
+    emb_vec_size = read<int32_t>(d);
+  }
+  mKeyType = read<DataType>(d);
+  mVecType = read<DataType>(d);
+  HCTR_CHECK_HINT(d == (a + length), "The size for reading serialized data is not correct");
+}
+
+int HpsMultiTablePlugin::initialize() noexcept { return 0; }
+
+void HpsMultiTablePlugin::terminate() noexcept {}
+
+void HpsMultiTablePlugin::destroy() noexcept { delete this; }
+
+int HpsMultiTablePlugin::getNbOutputs() const noexcept { return emb_vec_sizes.size(); }
+
+DimsExprs HpsMultiTablePlugin::getOutputDimensions(int32_t outputIndex, DimsExprs const* inputs,
+                                                   int32_t nbInputs,
+                                                   IExprBuilder& exprBuilder) noexcept {
+  try {
+    HCTR_CHECK_HINT(nbInputs == emb_vec_sizes.size(),
+                    "The number of inputs should be equal to the number of embedding tables");
+    HCTR_CHECK_HINT(inputs[outputIndex].nbDims == 2, "The dimensions of inputs should be 2");
+    DimsExprs ret;
+    ret.nbDims = 3;
+    ret.d[0] = inputs[outputIndex].d[0];
+    ret.d[1] = inputs[outputIndex].d[1];
+    ret.d[2] = exprBuilder.constant(emb_vec_sizes[outputIndex]);
+    return ret;
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+  }
+  return DimsExprs{};
+}
+
+DataType HpsMultiTablePlugin::getOutputDataType(int32_t index, nvinfer1::DataType const* inputTypes,
+                                                int32_t nbInputs) const noexcept {
+  return DataType::kFLOAT;
+}
+
+size_t HpsMultiTablePlugin::getWorkspaceSize(PluginTensorDesc const* inputs, int32_t nbInputs,
+                                             PluginTensorDesc const* outputs,
+                                             int32_t nbOutputs) const noexcept {
+  return 0;
+}
+
+size_t HpsMultiTablePlugin::getSerializationSize() const noexcept {
+  return (3 + emb_vec_sizes.size()) * sizeof(int32_t) + 2 * sizeof(DataType) +
+         ps_config_file.size() + model_name.size();
+}
+
+const char* HpsMultiTablePlugin::getPluginType() const noexcept {
+  return HPS_MULTI_TABLE_PLUGIN_NAME;
+}
+
+const char* HpsMultiTablePlugin::getPluginVersion() const noexcept {
+  return HPS_MULTI_TABLE_PLUGIN_VERSION;
+}
+
+bool HpsMultiTablePlugin::supportsFormatCombination(int32_t pos, const PluginTensorDesc* inOut,
+                                                    int32_t nbInputs, int32_t nbOutputs) noexcept {
+  if (pos < nbInputs) {
+    PluginTensorDesc const& input = inOut[pos];
+    return (input.type == mKeyType) && (input.format == TensorFormat::kLINEAR);
+  }
+  if (pos < nbInputs + nbOutputs) {
+    const PluginTensorDesc& output = inOut[pos];
+    return (output.type == mVecType) && (output.format == TensorFormat::kLINEAR);
+  }
+  return false;
+}
+
+void HpsMultiTablePlugin::configurePlugin(const DynamicPluginTensorDesc* in, int32_t nbInput,
+                                          const DynamicPluginTensorDesc* out,
+                                          int32_t nbOutput) noexcept {}
+
+int32_t HpsMultiTablePlugin::enqueue(PluginTensorDesc const* inputDesc,
+                                     PluginTensorDesc const* outputDesc, void const* const* inputs,
+                                     void* const* outputs, void* workspace,
+                                     cudaStream_t stream) noexcept {
+  try {
+    const size_t num_tables{emb_vec_sizes.size()};
+    std::vector<size_t> num_keys_per_table(num_tables);
+    std::vector<size_t> emb_vec_size_per_table(num_tables);
+    std::vector<const void*> d_keys_per_table(inputs, inputs + num_tables);
+    std::vector<void*> d_vectors_per_table(outputs, outputs + num_tables);
+    for (size_t t{0}; t < num_tables; ++t) {
+      size_t num_elements = inputDesc[t].dims.d[0];
+      for (size_t i{1}; i < inputDesc[t].dims.nbDims; i++) {
+        num_elements *= inputDesc[t].dims.d[i];
+      }
+      num_keys_per_table[t] = num_elements;
+      emb_vec_size_per_table[t] = emb_vec_sizes[t];
+    }
+    int32_t device_id;
+    HCTR_LIB_THROW(cudaGetDevice(&device_id));
+    bool i64_input_key = !(inputDesc->type == DataType::kINT32);
+    Facade::instance()->forward(model_name.c_str(), device_id, num_keys_per_table,
+                                emb_vec_size_per_table, d_keys_per_table, d_vectors_per_table,
+                                i64_input_key, stream);
+    return 0;
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+  }
+  return -1;
+}
+
+void HpsMultiTablePlugin::serialize(void* buffer) const noexcept {
+  int32_t ps_config_file_str_size = ps_config_file.size();
+  int32_t model_name_str_size = model_name.size();
+  int32_t num_tables = emb_vec_sizes.size();
+
+  char *d = static_cast<char*>(buffer), *a = d;
+
+  // Serialize plugin data
+  write(d, ps_config_file_str_size);
+  write_string(d, ps_config_file);
+  write(d, model_name_str_size);
+  write_string(d, model_name);
+  write(d, num_tables);
+  for (const auto emb_vec_size : emb_vec_sizes) {
+    write(d, emb_vec_size);
+  }
+  write(d, mKeyType);
+  write(d, mVecType);
+
+  HCTR_CHECK_HINT(d == a + getSerializationSize(), "The serialization size does not match");
+}
+
+IPluginV2DynamicExt* HpsMultiTablePlugin::clone() const noexcept {
+  try {
+    HpsMultiTablePlugin* ret =
+        new HpsMultiTablePlugin(mLayerName, ps_config_file, model_name, emb_vec_sizes);
+    ret->setPluginNamespace(mNamespace.c_str());
+    return ret;
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+  }
+  return nullptr;
+}
+
+HpsMultiTablePluginCreator::HpsMultiTablePluginCreator() {
+  mPluginAttributes.clear();
+  mPluginAttributes.emplace_back(PluginField("ps_config_file", nullptr, PluginFieldType::kCHAR, 1));
+  mPluginAttributes.emplace_back(PluginField("model_name", nullptr, PluginFieldType::kCHAR, 1));
+  mPluginAttributes.emplace_back(PluginField("emb_vec_sizes", nullptr, PluginFieldType::kINT32, 1));
+
+  mFC.nbFields = mPluginAttributes.size();
+  mFC.fields = mPluginAttributes.data();
+}
+
+const char* HpsMultiTablePluginCreator::getPluginName() const noexcept {
+  return HPS_MULTI_TABLE_PLUGIN_NAME;
+}
+
+const char* HpsMultiTablePluginCreator::getPluginVersion() const noexcept {
+  return HPS_MULTI_TABLE_PLUGIN_VERSION;
+}
+
+const PluginFieldCollection* HpsMultiTablePluginCreator::getFieldNames() noexcept { return &mFC; }
+
+IPluginV2DynamicExt* HpsMultiTablePluginCreator::createPlugin(
+    const char* name, const PluginFieldCollection* fc) noexcept {
+  try {
+    std::vector<int32_t> emb_vec_sizes;
+    std::string model_name, ps_config_file;
+    const PluginField* fields = fc->fields;
+
+    validateRequiredAttributesExist({"ps_config_file", "model_name", "emb_vec_sizes"}, fc);
+    HCTR_CHECK_HINT(fc->nbFields == 3, "The number of fields for HPS multi-table plugin should be 3");
+
+    for (int32_t i = 0; i < fc->nbFields; i++) {
+      if (strcmp(fields[i].name, "ps_config_file") == 0) {
+        HCTR_CHECK_HINT(fields[i].type == PluginFieldType::kCHAR, "ps_config_file should be CHAR");
+        ps_config_file = static_cast<const char*>(fields[i].data);
+      } else if (strcmp(fields[i].name, "model_name") == 0) {
+        HCTR_CHECK_HINT(fields[i].type == PluginFieldType::kCHAR, "model_name should be CHAR");
+        model_name = static_cast<const char*>(fields[i].data);
+      } else if (strcmp(fields[i].name, "emb_vec_sizes") == 0) {
+        HCTR_CHECK_HINT(fields[i].type == PluginFieldType::kINT32, "emb_vec_sizes should be INT32");
+        const int32_t* data = static_cast<const int32_t*>(fields[i].data);
+        emb_vec_sizes.assign(data, data + fields[i].length);
+      }
+    }
+    HCTR_CHECK_HINT(!emb_vec_sizes.empty(), "emb_vec_sizes should not be empty");
+    Facade::instance()->init(ps_config_file.c_str(), pluginType_t::TENSORRT);
+    return new HpsMultiTablePlugin(name, ps_config_file, model_name, emb_vec_sizes);
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+  }
+  return nullptr;
+}
+
+IPluginV2DynamicExt* HpsMultiTablePluginCreator::deserializePlugin(const char* name,
+                                                                   const void* serialData,
+                                                                   size_t serialLength) noexcept {
+  try {
+    // This object will be deleted when the network is destroyed, which will
+    // call HpsMultiTablePlugin::destroy()
+    const char* d = static_cast<const char*>(serialData);
+    int32_t ps_config_file_str_size;
+    std::string ps_config_file;
+    ps_config_file_str_size = read<int32_t>(d);
+    ps_config_file = read_string(d, ps_config_file_str_size);
+    Facade::instance()->init(ps_config_file.c_str(), pluginType_t::TENSORRT);
+    return new HpsMultiTablePlugin(name, serialData, serialLength);
+  } catch (const std::exception& err) {
+    HCTR_LOG_S(ERROR, WORLD) << err.what() << std::endl;
+  }
+  return nullptr;
+}
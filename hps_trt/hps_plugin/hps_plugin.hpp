@@ -131,6 +131,105 @@ class HpsPluginCreator : public IPluginCreator {
   static std::vector<PluginField> mPluginAttributes;
 };
 
+/**
+ * Looks up all embedding tables of a model in a single enqueue. Input \p t holds the keys of table
+ * \p t , and output \p t receives their embedding vectors of size \p emb_vec_sizes[t] .
+ */
+class HpsMultiTablePlugin : public IPluginV2DynamicExt {
+ public:
+  HpsMultiTablePlugin(std::string plugin_layer_name, std::string ps_config_file,
+                      std::string model_name, std::vector<int32_t> emb_vec_sizes);
+
+  HpsMultiTablePlugin(std::string plugin_layer_name, const void* data, size_t length);
+
+  ~HpsMultiTablePlugin() override = default;
+
+  HpsMultiTablePlugin() = delete;
+
+  int initialize() noexcept override;
+
+  void terminate() noexcept override;
+
+  void destroy() noexcept override;
+
+  int getNbOutputs() const noexcept override;
+
+  DimsExprs getOutputDimensions(int32_t outputIndex, DimsExprs const* inputs, int32_t nbInputs,
+                                IExprBuilder& exprBuilder) noexcept override;
+
+  DataType getOutputDataType(int32_t index, nvinfer1::DataType const* inputTypes,
+                             int32_t nbInputs) const noexcept override;
+
+  size_t getWorkspaceSize(PluginTensorDesc const* inputs, int32_t nbInputs,
+                          PluginTensorDesc const* outputs,
+                          int32_t nbOutputs) const noexcept override;
+
+  size_t getSerializationSize() const noexcept override;
+
+  const char* getPluginType() const noexcept override;
+
+  const char* getPluginVersion() const noexcept override;
+
+  bool supportsFormatCombination(int32_t pos, const PluginTensorDesc* inOut, int32_t nbInputs,
+                                 int32_t nbOutputs) noexcept override;
+
+  void configurePlugin(const DynamicPluginTensorDesc* in, int32_t nbInput,
+                       const DynamicPluginTensorDesc* out, int32_t nbOutput) noexcept override;
+
+  int32_t enqueue(PluginTensorDesc const* inputDesc, PluginTensorDesc const* outputDesc,
+                  void const* const* inputs, void* const* outputs, void* workspace,
+                  cudaStream_t stream) noexcept override;
+
+  void serialize(void* buffer) const noexcept override;
+
+  IPluginV2DynamicExt* clone() const noexcept override;
+
+ protected:
+  void setPluginNamespace(const char* libNamespace) noexcept override { mNamespace = libNamespace; }
+
+  const char* getPluginNamespace() const noexcept override { return mNamespace.c_str(); }
+
+  std::string mNamespace;
+
+ private:
+  std::string mLayerName;
+  std::string ps_config_file;
+  std::string model_name;
+  std::vector<int32_t> emb_vec_sizes;
+  DataType mKeyType{DataType::kINT32};
+  DataType mVecType{DataType::kFLOAT};
+};
+
+class HpsMultiTablePluginCreator : public IPluginCreator {
+ public:
+  HpsMultiTablePluginCreator();
+
+  ~HpsMultiTablePluginCreator() override = default;
+
+  const char* getPluginName() const noexcept override;
+
+  const char* getPluginVersion() const noexcept override;
+
+  const PluginFieldCollection* getFieldNames() noexcept override;
+
+  IPluginV2DynamicExt* createPlugin(const char* name,
+                                    const PluginFieldCollection* fc) noexcept override;
+
+  IPluginV2DynamicExt* deserializePlugin(const char* name, const void* serialData,
+                                         size_t serialLength) noexcept override;
+
+  void setPluginNamespace(const char* libNamespace) noexcept override { mNamespace = libNamespace; }
+
+  const char* getPluginNamespace() const noexcept override { return mNamespace.c_str(); }
+
+ protected:
+  std::string mNamespace;
+
+ private:
+  static PluginFieldCollection mFC;
+  static std::vector<PluginField> mPluginAttributes;
+};
+
 }  // namespace plugin
 
 }  // namespace nvinfer1
@@ -129,6 +129,14 @@ def create_hps_plugin_creator():
     return hps_plugin_creator
 
 
+def create_hps_multi_table_plugin_creator():
+    plg_registry = trt.get_plugin_registry()
+    hps_multi_table_plugin_creator = plg_registry.get_plugin_creator(
+        "HPS_TRT_MULTI_TABLE", "1", ""
+    )
+    return hps_multi_table_plugin_creator
+
+
 def create_hps_plugin(hps_plugin_creator, model_name, table_id, embedding_vec_size):
     ps_config_file = trt.PluginField(
         "ps_config_file",
@@ -149,6 +157,25 @@ def create_hps_plugin(hps_plugin_creator, model_name, table_id, embedding_vec_si
     return hps_plugin
 
 
+def create_hps_multi_table_plugin(hps_multi_table_plugin_creator, model_name, embedding_vec_sizes):
+    ps_config_file = trt.PluginField(
+        "ps_config_file",
+        np.array([args["ps_config_file"] + "\0"], dtype=np.string_),
+        trt.PluginFieldType.CHAR,
+    )
+    model_name = trt.PluginField(
+        "model_name", np.array([model_name + "\0"], dtype=np.string_), trt.PluginFieldType.CHAR
+    )
+    emb_vec_sizes = trt.PluginField(
+        "emb_vec_sizes", np.array(embedding_vec_sizes, dtype=np.int32), trt.PluginFieldType.INT32
+    )
+    params = trt.PluginFieldCollection([ps_config_file, model_name, emb_vec_sizes])
+    hps_plugin = hps_multi_table_plugin_creator.create_plugin(
+        name="hps_multi_table", field_collection=params
+    )
+    return hps_plugin
+
+
 def load_engine(engine_path):
     TRT_LOGGER = trt.Logger(trt.Logger.WARNING)
     trt_runtime = trt.Runtime(TRT_LOGGER)
@@ -164,6 +191,9 @@ class TestHPS:
     hps_plugin_creator = create_hps_plugin_creator()
     assert hps_plugin_creator
 
+    hps_multi_table_plugin_creator = create_hps_multi_table_plugin_creator()
+    assert hps_multi_table_plugin_creator
+
     def test_build_engine1(self):
         plugin1 = create_hps_plugin(self.hps_plugin_creator, "foo", 0, 16)
         with trt.Builder(TRT_LOGGER) as builder, builder.create_network(
@@ -225,6 +255,40 @@ class TestHPS:
             with open("bar.trt", "wb") as fout:
                 fout.write(engine)
 
+    def test_build_engine3(self):
+        plugin4 = create_hps_multi_table_plugin(
+            self.hps_multi_table_plugin_creator, "bar", [64, 32]
+        )
+        with trt.Builder(TRT_LOGGER) as builder, builder.create_network(
+            EXPLICIT_BATCH
+        ) as network, builder.create_builder_config() as builder_config:
+            input_tensor1 = network.add_input(name="input1", dtype=trt.int32, shape=(-1, 3))
+            input_tensor2 = network.add_input(name="input2", dtype=trt.int32, shape=(-1, 5))
+            bazquz_hps_layer = network.add_plugin_v2(
+                inputs=[input_tensor1, input_tensor2], plugin=plugin4
+            )
+            bazquz_hps_layer.name = "bazquz_hps_multi_table_layer"
+            for i in range(2):
+                bazquz_hps_layer.set_output_type(i, trt.float32)
+                bazquz_hps_layer.get_output(i).name = "output_{}".format(i + 1)
+                network.mark_output(bazquz_hps_layer.get_output(i))
+
+            profile = builder.create_optimization_profile()
+            profile.set_shape("input1", (1, 3), (1024, 3), (1024, 3))
+            profile.set_shape("input2", (1, 5), (1024, 5), (1024, 5))
+            builder_config.add_optimization_profile(profile)
+
+            build_start_time = time.time()
+            engine = builder.build_serialized_network(network, builder_config)
+            build_time_elapsed = time.time() - build_start_time
+            TRT_LOGGER.log(
+                TRT_LOGGER.INFO,
+                "build bar multi-table engine in {:.3f} Sec".format(build_time_elapsed),
+            )
+            assert engine
+            with open("bar_multi_table.trt", "wb") as fout:
+                fout.write(engine)
+
     def test_execute_engine1(self):
         engine = load_engine("foo.trt")
 
@@ -254,7 +318,13 @@ class TestHPS:
             assert mse <= 1e-6
 
     def test_execute_engine2(self):
-        engine = load_engine("bar.trt")
+        self._execute_bar_engine("bar.trt")
+
+    def test_execute_engine3(self):
+        self._execute_bar_engine("bar_multi_table.trt")
+
+    def _execute_bar_engine(self, engine_path):
+        engine = load_engine(engine_path)
 
         BZ = 1
         KEY_DTYPE = np.int32
@@ -274,7 +344,13 @@ class TestHPS:
         d_input2 = cuda.mem_alloc(1 * h_input2.nbytes)
         d_output2 = cuda.mem_alloc(1 * h_output2.nbytes)
 
-        bindings = [int(d_input1), int(d_output1), int(d_input2), int(d_output2)]
+        addresses = {
+            "input1": int(d_input1),
+            "output_1": int(d_output1),
+            "input2": int(d_input2),
+            "output_2": int(d_output2),
+        }
+        bindings = [addresses[engine.get_tensor_name(i)] for i in range(engine.num_io_tensors)]
         stream = cuda.Stream()
 
         for _ in range(5):
@@ -19,6 +19,12 @@
 // clang-format off
 #include <cuda_runtime.h>
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "tensorflow/core/common_runtime/gpu/gpu_id_manager.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -167,6 +173,145 @@ class TFAllocatorImpl  : public core23::Allocator{
   GPUOptions gpu_option_;
 };
 
+// Caches the GPU buffers of the core23 tensors that an op allocates in each step, so that they
+// are taken from TF's allocator once instead of every step. The cache is sized by the high-water
+// mark of the bytes in use per step. The mark grows immediately, but only shrinks after
+// `shrink_steps` consecutive steps below half of it, so that varying hotness does not make the
+// cache release and reallocate its buffers back and forth.
+class TFWorkspace : public std::enable_shared_from_this<TFWorkspace> {
+ public:
+  // Makes `workspace` serve the core23 allocations of the calling thread until it is destroyed.
+  class Scope {
+   public:
+    explicit Scope(TFWorkspace* workspace) : workspace_(workspace), previous_(current()) {
+      current() = workspace_;
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() {
+      current() = previous_;
+      workspace_->end_step();
+    }
+
+   private:
+    TFWorkspace* workspace_;
+    TFWorkspace* previous_;
+  };
+
+  explicit TFWorkspace(int shrink_steps = 100) : shrink_steps_(shrink_steps) {}
+
+  ~TFWorkspace() {
+    for (auto& block : free_blocks_) {
+      allocator_->deallocate(block.second, core23::CUDAStream());
+    }
+  }
+
+  static TFWorkspace*& current() {
+    static thread_local TFWorkspace* workspace = nullptr;
+    return workspace;
+  }
+
+  void* allocate(const core23::Device& device, int64_t size) {
+    // The granularity of TF's BFC allocator
+    size = (std::max<int64_t>(size, 1) + 255) / 256 * 256;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!allocator_) {
+      allocator_.reset(new TFAllocatorImpl(device));
+    }
+
+    // Take the smallest cached block that fits, unless it would waste more than half of itself
+    void* ptr = nullptr;
+    auto it = free_blocks_.lower_bound(size);
+    if (it != free_blocks_.end() && it->first <= 2 * size) {
+      size = it->first;
+      ptr = it->second;
+      free_blocks_.erase(it);
+      cached_bytes_ -= size;
+    } else {
+      ptr = allocator_->allocate(size, core23::CUDAStream());
+      block_sizes_[ptr] = size;
+    }
+    bytes_in_use_ += size;
+    step_peak_ = std::max(step_peak_, bytes_in_use_);
+    return ptr;
+  }
+
+  void deallocate(void* ptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t size = block_sizes_.at(ptr);
+    bytes_in_use_ -= size;
+    free_blocks_.emplace(size, ptr);
+    cached_bytes_ += size;
+  }
+
+  void end_step() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (step_peak_ >= high_water_) {
+      high_water_ = step_peak_;
+      num_shrink_steps_ = 0;
+    } else if (2 * step_peak_ < high_water_) {
+      if (++num_shrink_steps_ >= shrink_steps_) {
+        high_water_ = step_peak_;
+        num_shrink_steps_ = 0;
+      }
+    } else {
+      num_shrink_steps_ = 0;
+    }
+
+    // Keep at most twice the high-water mark, releasing the largest cached blocks first
+    while (!free_blocks_.empty() && bytes_in_use_ + cached_bytes_ > 2 * high_water_) {
+      auto it = std::prev(free_blocks_.end());
+      allocator_->deallocate(it->second, core23::CUDAStream());
+      block_sizes_.erase(it->second);
+      cached_bytes_ -= it->first;
+      free_blocks_.erase(it);
+    }
+    step_peak_ = bytes_in_use_;
+  }
+
+ private:
+  int shrink_steps_;
+  int num_shrink_steps_ = 0;
+  int64_t bytes_in_use_ = 0;
+  int64_t cached_bytes_ = 0;
+  int64_t step_peak_ = 0;
+  int64_t high_water_ = 0;
+
+  std::mutex mutex_;
+  std::unique_ptr<TFAllocatorImpl> allocator_;
+  std::multimap<int64_t, void*> free_blocks_;
+  std::unordered_map<void*, int64_t> block_sizes_;
+};
+
+// The allocator of a core23 buffer that is allocated from a TFWorkspace. It keeps the workspace
+// alive, because the buffer may outlive the op that allocated it.
+class TFWorkspaceAllocator : public core23::Allocator {
+ public:
+  TFWorkspaceAllocator(std::shared_ptr<TFWorkspace> workspace, const core23::Device& device)
+      : workspace_(std::move(workspace)), device_(device) {}
+
+  void* allocate(int64_t size, core23::CUDAStream) override {
+    return workspace_->allocate(device_, size);
+  }
+
+  void deallocate(void* ptr, core23::CUDAStream) override { workspace_->deallocate(ptr); }
+
+  int64_t default_alignment() const override { return alignof(std::max_align_t); }
+
+ private:
+  std::shared_ptr<TFWorkspace> workspace_;
+  core23::Device device_;
+};
+
+std::unique_ptr<core23::Allocator> TFGetAllocator(const core23::Device& device) {
+  TFWorkspace* workspace = TFWorkspace::current();
+  if (workspace != nullptr && device.type() == core23::DeviceType::GPU) {
+    return std::unique_ptr<core23::Allocator>(
+        new TFWorkspaceAllocator(workspace->shared_from_this(), device));
+  }
+  return std::unique_ptr<core23::Allocator>(new TFAllocatorImpl(device));
+}
+
 std::shared_ptr<core23::Buffer> TFGetBuffer(const core23::BufferParams& buffer_params, const core23::Device& device,
                                   std::unique_ptr<core23::Allocator> allocator) {
   return std::make_shared<core23::ConfederalBuffer>(device, std::move(allocator));
@@ -50,6 +50,12 @@ core23::Tensor convert_tensor_core23(const tensorflow::Tensor* tensor,int device
   return core23::Tensor::bind(tensor->data(),{tensor->NumElements()},core23::ToScalarType<T>::value,{core23::DeviceType::GPU,device_id});
 }
 
+// Binds the first `num_elements` elements of a buffer that may be larger, e.g. a persistent one.
+template <typename T>
+core23::Tensor convert_tensor_core23(const tensorflow::Tensor* tensor,int64_t num_elements,int device_id) {
+  return core23::Tensor::bind(tensor->data(),{num_elements},core23::ToScalarType<T>::value,{core23::DeviceType::GPU,device_id});
+}
+
 template <typename KeyType, typename OffsetType, typename DType>
 std::unique_ptr<::embedding::EmbeddingCollectionParam> make_embedding_collection_param(
                                       const std::vector<std::vector<int>> &shard_matrix,
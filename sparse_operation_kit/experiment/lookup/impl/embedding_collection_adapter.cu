@@ -266,6 +266,7 @@ void DummyVarAdapter<KeyType, OffsetType, DType>::set(
     vars_[i] = var;
     // id_space_to_local_index_[i] = i;
   }
+  stream_ = stream;
 }
 
 template <typename KeyType, typename OffsetType, typename DType>
@@ -289,13 +290,22 @@ void DummyVarAdapter<KeyType, OffsetType, DType>::lookup(
 
   DType** output = static_cast<DType**>(embedding_vec.data());
   const KeyType* input = keys.data<KeyType>();
+  tasks_.clear();
   for (int i = 0; i < num_id_space_offset - 1; ++i) {
     size_t num = id_space_offset_[i + 1] - id_space_offset_[i];
-    auto var = vars_[id_space_[i]];
-    var->lookup(input, output, num, stream_);
+    auto var = vars_[id_space_[i]].get();
+    // Consecutive id spaces of the same variable are looked up together.
+    if (!tasks_.empty() && tasks_.back().var == var) {
+      tasks_.back().num_keys += num;
+    } else {
+      tasks_.push_back({var, input, output, num});
+    }
     input += num;
     output += num;
   }
+  if (!tasks_.empty()) {
+    tasks_[0].var->group_lookup(tasks_, stream_);
+  }
 }
 
 template class DummyVarAdapter<int32_t, int32_t, float>;
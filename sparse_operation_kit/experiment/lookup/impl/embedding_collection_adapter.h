@@ -89,6 +89,7 @@ class DummyVarAdapter : public ::embedding::ILookup {
   std::vector<OffsetType> id_space_offset_;
   std::vector<int> id_space_;
   std::vector<std::shared_ptr<VariableBase<KeyType, DType>>> vars_;
+  std::vector<GroupLookupTask<KeyType, DType>> tasks_;
   cudaStream_t stream_;
 };
 
@@ -14,104 +14,148 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include "common/check.h"
 #include "lookup/impl/select_kernel.h"
 
 namespace sok {
 
+// The keys are split into one contiguous segment per block, so that the blocks can write the
+// keys of each split in the order of the blocks, keeping the order of the input in every split.
+
+template <typename KeyType>
+__device__ __forceinline__ int get_split(KeyType key, int num_splits) {
+  return static_cast<int>(key % num_splits);
+}
+
+// block_counts[split * gridDim.x + block] = the number of keys of `split` in the segment of
+// `block`.
 template <typename KeyType>
-__global__ void selectKernel(const KeyType *input_keys, size_t num_keys, KeyType *output_keys,
-                             int32_t *output_indices, size_t chunks, size_t max_chunk_size,
-                             int32_t *chunk_sizes, const size_t ITEMS_PER_GPU_PER_WARP,
-                             const size_t KEY_WARPS_PER_BLOCK) {
-  // set indices
-  const size_t thread_cnt = blockDim.x * blockDim.y;
-  const size_t stride_size = thread_cnt * gridDim.x;
-  const size_t items_per_warp = chunks * ITEMS_PER_GPU_PER_WARP;
-  const size_t items_per_block = KEY_WARPS_PER_BLOCK * items_per_warp;
-  const size_t gpu_cnt_by_warps_cnt = chunks * KEY_WARPS_PER_BLOCK;
-  const size_t thread_idx = threadIdx.x + blockDim.x * threadIdx.y;
-  // set ptrs in smem
-  extern __shared__ char smem[];
-  KeyType *key_smem = (KeyType *)smem;
-  uint32_t *idx_smem = (uint32_t *)(key_smem + items_per_block);
-  uint32_t *cnt_smem = idx_smem + items_per_block;
-  if (thread_idx < gpu_cnt_by_warps_cnt) {
-    cnt_smem[thread_idx] = 0;
+__global__ void selectCountKernel(const KeyType *input_keys, size_t num_keys,
+                                  size_t keys_per_block, int num_splits, int32_t *block_counts) {
+  extern __shared__ int32_t counts[];
+  for (int i = threadIdx.x; i < num_splits; i += blockDim.x) {
+    counts[i] = 0;
+  }
+  __syncthreads();
+
+  size_t begin = blockIdx.x * keys_per_block;
+  size_t end = min(begin + keys_per_block, num_keys);
+  for (size_t idx = begin + threadIdx.x; idx < end; idx += blockDim.x) {
+    atomicAdd(counts + get_split(input_keys[idx], num_splits), 1);
   }
-  // if (thread_idx + blockIdx.x * thread_cnt < chunks) {
-  //   chunk_sizes[thread_idx] = 0;
-  // }
   __syncthreads();
-  // do offset
-  KeyType *curr_warp_key_smem = key_smem + threadIdx.y * items_per_warp;
-  uint32_t *curr_warp_idx_smem = idx_smem + threadIdx.y * items_per_warp;
-  uint32_t *curr_warp_cnt_smem = cnt_smem + threadIdx.y * chunks;
-  uint32_t padded_input_size = (num_keys + warpSize - 1) / warpSize * warpSize;
-  // loop on input_keys
-  for (size_t idx = thread_idx + blockIdx.x * thread_cnt; idx < padded_input_size;
-       idx += stride_size) {
+
+  for (int i = threadIdx.x; i < num_splits; i += blockDim.x) {
+    block_counts[i * gridDim.x + blockIdx.x] = counts[i];
+  }
+}
+
+// Exclusive scan of the n block counts in one block, which also gets the size of every split.
+__global__ void selectScanKernel(int32_t *block_counts, int n, int num_blocks,
+                                 int32_t *chunk_sizes) {
+  extern __shared__ int32_t partials[];
+  int items_per_thread = (n + blockDim.x - 1) / blockDim.x;
+  int begin = min(static_cast<int>(threadIdx.x) * items_per_thread, n);
+  int end = min(begin + items_per_thread, n);
+
+  int32_t sum = 0;
+  for (int i = begin; i < end; ++i) {
+    sum += block_counts[i];
+  }
+  partials[threadIdx.x] = sum;
+  __syncthreads();
+  for (int stride = 1; stride < blockDim.x; stride *= 2) {
+    int32_t value = threadIdx.x >= stride ? partials[threadIdx.x - stride] : 0;
+    __syncthreads();
+    partials[threadIdx.x] += value;
+    __syncthreads();
+  }
+
+  int32_t offset = partials[threadIdx.x] - sum;
+  for (int i = begin; i < end; ++i) {
+    int32_t count = block_counts[i];
+    block_counts[i] = offset;
+    offset += count;
+  }
+  __syncthreads();
+
+  // A split ends where the next one starts.
+  int num_splits = n / num_blocks;
+  int32_t total = partials[blockDim.x - 1];
+  for (int i = threadIdx.x; i < num_splits; i += blockDim.x) {
+    int32_t split_end = i + 1 < num_splits ? block_counts[(i + 1) * num_blocks] : total;
+    chunk_sizes[i] = split_end - block_counts[i * num_blocks];
+  }
+}
+
+// Writes the keys of the segment of each block, a tile of blockDim.x keys at a time, to the
+// offsets given by selectScanKernel.
+template <typename KeyType>
+__global__ void selectScatterKernel(const KeyType *input_keys, size_t num_keys,
+                                    size_t keys_per_block, int num_splits,
+                                    const int32_t *block_offsets, KeyType *output_keys,
+                                    int32_t *output_indices) {
+  extern __shared__ int32_t smem[];
+  const int num_warps = blockDim.x / warpSize;
+  const int warp_id = threadIdx.x / warpSize;
+  const int lane_id = threadIdx.x % warpSize;
+  // cursors[split], then warp_offsets[warp][split]
+  int32_t *cursors = smem;
+  int32_t *warp_offsets = smem + num_splits;
+
+  for (int i = threadIdx.x; i < num_splits; i += blockDim.x) {
+    cursors[i] = block_offsets[i * gridDim.x + blockIdx.x];
+  }
+
+  size_t begin = blockIdx.x * keys_per_block;
+  size_t end = min(begin + keys_per_block, num_keys);
+  for (size_t base = begin; base < end; base += blockDim.x) {
+    for (int i = threadIdx.x; i < num_warps * num_splits; i += blockDim.x) {
+      warp_offsets[i] = 0;
+    }
+    __syncthreads();
+
+    size_t idx = base + threadIdx.x;
     KeyType key = 0;
-    size_t chunk_id = 0;
-    uint32_t curr_local_idx = 0;
-    uint32_t offset = 0;
-    uint32_t is_full = 0;
-    if (idx < num_keys) {
+    int split = -1;
+    if (idx < end) {
       key = input_keys[idx];
-      chunk_id = key % chunks;
-      curr_local_idx = atomicAdd(curr_warp_cnt_smem + chunk_id, 1);
-      offset = chunk_id * ITEMS_PER_GPU_PER_WARP + curr_local_idx;
-      curr_warp_key_smem[offset] = key;
-      curr_warp_idx_smem[offset] = idx;
+      split = get_split(key, num_splits);
     }
-    is_full = (curr_local_idx == ITEMS_PER_GPU_PER_WARP - warpSize);
-    uint32_t ballot_val = __ballot_sync(0xffffffff, is_full);
-    // __syncwarp();
-    int leading_zeros = __clz(ballot_val);
-    while (leading_zeros < warpSize) {
-      uint32_t full_gpu_idx = __shfl_sync(0xffffffff, chunk_id, warpSize - leading_zeros - 1);
-      ballot_val &= (((uint32_t)0xffffffff) >> (leading_zeros + 1));
-      leading_zeros = __clz(ballot_val);
-      uint32_t curr_global_idx = 0;
-      if (threadIdx.x == 0) {
-        curr_global_idx = atomicAdd(chunk_sizes + full_gpu_idx, curr_warp_cnt_smem[full_gpu_idx]);
-      }
-      curr_global_idx = __shfl_sync(0xffffffff, curr_global_idx, 0);
-      // __syncwarp();
-      for (size_t output_idx = threadIdx.x; output_idx < curr_warp_cnt_smem[full_gpu_idx];
-           output_idx += warpSize) {
-        output_keys[full_gpu_idx * max_chunk_size + curr_global_idx + output_idx] =
-            curr_warp_key_smem[full_gpu_idx * ITEMS_PER_GPU_PER_WARP + output_idx];
-        output_indices[full_gpu_idx * max_chunk_size + curr_global_idx + output_idx] =
-            curr_warp_idx_smem[full_gpu_idx * ITEMS_PER_GPU_PER_WARP + output_idx];
+    // The rank of the key among the keys of the same split in this warp.
+    unsigned int peers = __match_any_sync(0xffffffff, split);
+    int rank = __popc(peers & ((1u << lane_id) - 1));
+    if (split >= 0 && rank == 0) {
+      warp_offsets[warp_id * num_splits + split] = __popc(peers);
+    }
+    __syncthreads();
+
+    for (int i = threadIdx.x; i < num_splits; i += blockDim.x) {
+      int32_t offset = cursors[i];
+      for (int w = 0; w < num_warps; ++w) {
+        int32_t count = warp_offsets[w * num_splits + i];
+        warp_offsets[w * num_splits + i] = offset;
+        offset += count;
       }
-      // __syncwarp();
+      cursors[i] = offset;
     }
-    __syncwarp();
-    if (is_full) {
-      curr_warp_cnt_smem[chunk_id] = 0;
+    __syncthreads();
+
+    if (split >= 0) {
+      int32_t offset = warp_offsets[warp_id * num_splits + split] + rank;
+      output_keys[offset] = key;
+      output_indices[offset] = static_cast<int32_t>(idx);
     }
-    __syncwarp();
+    __syncthreads();
   }
-  // tail
-  for (size_t has_gpu_idx = 0; has_gpu_idx < chunks; ++has_gpu_idx) {
-    uint32_t curr_gpu_items = curr_warp_cnt_smem[has_gpu_idx];
-    if (curr_gpu_items == 0) {
-      continue;
-    }
-    uint32_t curr_global_idx = 0;
-    if (threadIdx.x == 0) {
-      curr_global_idx = atomicAdd(chunk_sizes + has_gpu_idx, curr_warp_cnt_smem[has_gpu_idx]);
-    }
-    curr_global_idx = __shfl_sync(0xffffffff, curr_global_idx, 0);
-    for (size_t output_idx = threadIdx.x; output_idx < curr_warp_cnt_smem[has_gpu_idx];
-         output_idx += warpSize) {
-      output_keys[has_gpu_idx * max_chunk_size + curr_global_idx + output_idx] =
-          curr_warp_key_smem[has_gpu_idx * ITEMS_PER_GPU_PER_WARP + output_idx];
-      output_indices[has_gpu_idx * max_chunk_size + curr_global_idx + output_idx] =
-          curr_warp_idx_smem[has_gpu_idx * ITEMS_PER_GPU_PER_WARP + output_idx];
-    }
-    __syncwarp();
+}
+
+template <typename KeyType>
+SelectLauncher<KeyType>::~SelectLauncher() {
+  if (block_counts_) {
+    CUDACHECK(cudaFree(block_counts_));
   }
 }
 
@@ -121,52 +165,45 @@ void SelectLauncher<KeyType>::initialize(size_t num_splits) {
   CUDACHECK(cudaGetDevice(&device));
   CUDACHECK(cudaDeviceGetAttribute(&sm_count_, cudaDevAttrMultiProcessorCount, device));
   CUDACHECK(cudaDeviceGetAttribute(&warp_size_, cudaDevAttrWarpSize, device));
-  CUDACHECK(cudaDeviceGetAttribute(&max_shared_memory_per_sm_,
-                                   cudaDevAttrMaxSharedMemoryPerMultiprocessor, device));
-  max_shared_memory_per_sm_ -= (4 * 1024);
-  CUDACHECK(cudaFuncSetAttribute(selectKernel<KeyType>, cudaFuncAttributeMaxDynamicSharedMemorySize,
-                                 max_shared_memory_per_sm_));
-  key_warps_per_block_ = 8;
-  items_per_gpu_per_warp_ =
-      max_shared_memory_per_sm_ - (sizeof(uint32_t) * key_warps_per_block_ * num_splits);
-  items_per_gpu_per_warp_ /=
-      (num_splits * key_warps_per_block_ * (sizeof(KeyType) + sizeof(uint32_t)));
-  items_per_gpu_per_warp_ = (items_per_gpu_per_warp_ / 16) * 16;
-  host_splits_.resize(num_splits);
+  max_num_blocks_ = 2 * sm_count_;
+  CUDACHECK(cudaMalloc(&block_counts_, sizeof(int32_t) * num_splits * max_num_blocks_));
 }
 
 template <typename KeyType>
 void SelectLauncher<KeyType>::operator()(const void *indices, size_t num_keys, void *output,
-                                         void *output_buffer, void *order, void *order_buffer,
-                                         void *splits, size_t num_splits, cudaStream_t stream) {
+                                         void *order, void *splits, size_t num_splits,
+                                         cudaStream_t stream) {
   const KeyType *t_indices = reinterpret_cast<const KeyType *>(indices);
   KeyType *t_output = reinterpret_cast<KeyType *>(output);
-  KeyType *t_output_buffer = reinterpret_cast<KeyType *>(output_buffer);
   int32_t *t_order = reinterpret_cast<int32_t *>(order);
-  int32_t *t_order_buffer = reinterpret_cast<int32_t *>(order_buffer);
   int32_t *t_splits = reinterpret_cast<int32_t *>(splits);
 
-  // Launch kernel
-  CUDACHECK(cudaMemsetAsync(t_splits, 0, sizeof(int32_t) * num_splits, stream));
-  size_t grid_dim = sm_count_;
-  dim3 block_dim(warp_size_, key_warps_per_block_);
-  selectKernel<KeyType><<<grid_dim, block_dim, max_shared_memory_per_sm_, stream>>>(
-      t_indices, num_keys, t_output_buffer, t_order_buffer, num_splits, num_keys, t_splits,
-      items_per_gpu_per_warp_, key_warps_per_block_);
+  if (num_keys == 0) {
+    CUDACHECK(cudaMemsetAsync(t_splits, 0, sizeof(int32_t) * num_splits, stream));
+    return;
+  }
+
+  // Each block takes a segment of whole tiles.
+  const int block_size = 256;
+  size_t num_tiles = (num_keys + block_size - 1) / block_size;
+  int num_blocks = static_cast<int>(std::min(num_tiles, static_cast<size_t>(max_num_blocks_)));
+  size_t keys_per_block = (num_tiles + num_blocks - 1) / num_blocks * block_size;
+  num_blocks = static_cast<int>((num_keys + keys_per_block - 1) / keys_per_block);
+
+  int num_splits_i = static_cast<int>(num_splits);
+  selectCountKernel<KeyType><<<num_blocks, block_size, sizeof(int32_t) * num_splits, stream>>>(
+      t_indices, num_keys, keys_per_block, num_splits_i, block_counts_);
   CUDACHECK(cudaGetLastError());
 
-  // Copy data from output_buffer & order_buffer to output & order.
-  CUDACHECK(cudaMemcpyAsync(host_splits_.data(), t_splits, sizeof(int32_t) * num_splits,
-                            cudaMemcpyDeviceToHost, stream));
-  CUDACHECK(cudaStreamSynchronize(stream));
-  size_t offset = 0;
-  for (int i = 0; i < num_splits; ++i) {
-    CUDACHECK(cudaMemcpyAsync(t_output + offset, t_output_buffer + i * num_keys,
-                              sizeof(KeyType) * host_splits_[i], cudaMemcpyDeviceToDevice, stream));
-    CUDACHECK(cudaMemcpyAsync(t_order + offset, t_order_buffer + i * num_keys,
-                              sizeof(int32_t) * host_splits_[i], cudaMemcpyDeviceToDevice, stream));
-    offset += host_splits_[i];
-  }
+  const int scan_block_size = 1024;
+  selectScanKernel<<<1, scan_block_size, sizeof(int32_t) * scan_block_size, stream>>>(
+      block_counts_, num_splits_i * num_blocks, num_blocks, t_splits);
+  CUDACHECK(cudaGetLastError());
+
+  size_t scatter_smem = sizeof(int32_t) * num_splits * (1 + block_size / warp_size_);
+  selectScatterKernel<KeyType><<<num_blocks, block_size, scatter_smem, stream>>>(
+      t_indices, num_keys, keys_per_block, num_splits_i, block_counts_, t_output, t_order);
+  CUDACHECK(cudaGetLastError());
 }
 
 template class SelectLauncher<int64_t>;
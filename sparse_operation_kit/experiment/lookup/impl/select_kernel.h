@@ -27,18 +27,20 @@ namespace sok {
 template <typename KeyType>
 class SelectLauncher {
  public:
+  ~SelectLauncher();
+
   void initialize(size_t num_splits);
-  void operator()(const void* indices, size_t num_keys, void* output, void* output_buffer,
-                  void* order, void* order_buffer, void* splits, size_t num_splits,
-                  cudaStream_t stream = 0);
+  // Writes the keys of each split to output, in the order of the input, without any
+  // synchronization of the stream.
+  void operator()(const void* indices, size_t num_keys, void* output, void* order, void* splits,
+                  size_t num_splits, cudaStream_t stream = 0);
 
  private:
   int sm_count_;
   int warp_size_;
-  int max_shared_memory_per_sm_;
-  size_t key_warps_per_block_;
-  size_t items_per_gpu_per_warp_;
-  std::vector<int32_t> host_splits_;
+  int max_num_blocks_;
+  // The number of keys of each split in the segment of each block, then their offsets.
+  int32_t* block_counts_ = nullptr;
 };
 
 }  // namespace sok
@@ -42,7 +42,7 @@ namespace tf_internal {
 
 int set_default_alloctor() {
   core23::AllocatorParams::default_allocator_factory = [](const auto& params, const auto& device) {
-    return std::unique_ptr<core23::Allocator>(new TFAllocatorImpl(device));
+    return TFGetAllocator(device);
   };
   core23::BufferParams::custom_factory = TFGetBuffer;
   return 0;
@@ -56,6 +56,10 @@ namespace tensorflow {
 template <typename KeyType, typename OffsetType, typename DType>
 class EmbeddingCollectionBase : public OpKernel {
  protected:
+  // Caches the core23 tensors allocated by each step of this op, it serves the allocations made
+  // within a tf_internal::TFWorkspace::Scope of it.
+  std::shared_ptr<tf_internal::TFWorkspace> workspace_;
+
   int num_lookups_;
   std::vector<std::string> combiners_;
   // std::vector<int> hotness_;
@@ -123,7 +127,10 @@ class EmbeddingCollectionBase : public OpKernel {
 
  public:
   explicit EmbeddingCollectionBase(OpKernelConstruction* ctx)
-      : OpKernel(ctx), ebc_param_(nullptr), meta_(nullptr) {
+      : OpKernel(ctx),
+        workspace_(std::make_shared<tf_internal::TFWorkspace>()),
+        ebc_param_(nullptr),
+        meta_(nullptr) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("num_lookups", &num_lookups_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("combiners", &combiners_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("shard", &shard_));
@@ -418,6 +425,7 @@ class LookupFowardBase : public EmbeddingCollectionBase<KeyType, OffsetType, DTy
 
   void forward(OpKernelContext* ctx, std::shared_ptr<sok::CoreResourceManager>& tf_backend,
                cudaStream_t stream) {
+    tf_internal::TFWorkspace::Scope workspace_scope(this->workspace_.get());
     /*
        There are some steps in this op:
        1.reorder key to feature major
@@ -518,11 +526,11 @@ class LookupFowardBase : public EmbeddingCollectionBase<KeyType, OffsetType, DTy
   }
 };
 
-template <typename KeyType, typename OffsetType, typename DType, typename VarType, typename Adapter>
-class LookupForwardOp : public LookupFowardBase<KeyType, OffsetType, DType, Adapter> {
+// `Base` provides forward(), so that the variable handling is shared with the fused lookup.
+template <typename KeyType, typename OffsetType, typename DType, typename VarType, typename Adapter,
+          typename Base = LookupFowardBase<KeyType, OffsetType, DType, Adapter>>
+class LookupForwardOp : public Base {
  public:
-  using Base = LookupFowardBase<KeyType, OffsetType, DType, Adapter>;
-
   explicit LookupForwardOp(OpKernelConstruction* ctx) : Base(ctx) {}
 
   void Compute(OpKernelContext* ctx) override {
@@ -562,13 +570,11 @@ class LookupForwardOp : public LookupFowardBase<KeyType, OffsetType, DType, Adap
   }
 };
 
-template <typename KeyType, typename OffsetType, typename DType>
-class LookupForwardVarOp : public LookupFowardBase<KeyType, OffsetType, DType,
-                                                   sok::TFAdapter<KeyType, OffsetType, DType>> {
+template <typename KeyType, typename OffsetType, typename DType,
+          typename Base = LookupFowardBase<KeyType, OffsetType, DType,
+                                           sok::TFAdapter<KeyType, OffsetType, DType>>>
+class LookupForwardVarOp : public Base {
  public:
-  using Base =
-      LookupFowardBase<KeyType, OffsetType, DType, sok::TFAdapter<KeyType, OffsetType, DType>>;
-
   explicit LookupForwardVarOp(OpKernelConstruction* ctx) : Base(ctx) {}
 
   void Compute(OpKernelContext* ctx) override {
@@ -661,6 +667,7 @@ class LookupBackwardOp : public EmbeddingCollectionBase<KeyType, OffsetType, DTy
       : EmbeddingCollectionBase<KeyType, OffsetType, DType>(ctx) {}
 
   void Compute(OpKernelContext* ctx) override {
+    tf_internal::TFWorkspace::Scope workspace_scope(this->workspace_.get());
     /*
        There some steps in this OP:
        1. backward index calculation:
@@ -803,6 +810,7 @@ class PostprocessingForwardOp : public EmbeddingCollectionBase<KeyType, OffsetTy
       : EmbeddingCollectionBase<KeyType, OffsetType, DType>(ctx) {}
 
   void Compute(OpKernelContext* ctx) override {
+    tf_internal::TFWorkspace::Scope workspace_scope(this->workspace_.get());
     // Prepare emb_vec_buffer_shape, this will be used in backward
     /*
        after all2all done , every gpu get partial results from every other gpu,
@@ -924,6 +932,7 @@ class PostprocessingBackwardOp : public EmbeddingCollectionBase<KeyType, OffsetT
       : EmbeddingCollectionBase<KeyType, OffsetType, DType>(ctx) {}
 
   void Compute(OpKernelContext* ctx) override {
+    tf_internal::TFWorkspace::Scope workspace_scope(this->workspace_.get());
     /*
        input is dense layer wgrad , we can assume every gpu maybe need this wgrad ,
        so we need copy the grad to all2all buffer , the all2all buffer then can send the wgrad to
@@ -1035,6 +1044,336 @@ REGISTER_GPU_KERNELS(int32_t, int32_t, int32_t, int32_t, Eigen::half, __half);
 
 #undef REGISTER_GPU_KERNELS
 
+// -----------------------------------------------------------------------------------------------
+// LookupFused
+// -----------------------------------------------------------------------------------------------
+/*
+   Runs PreprocessingForward, HotnessCalculate, LookupForward and PostprocessingForward in one op,
+   so that a lookup costs a single op dispatch. There is no communication between the stages on a
+   single GPU, which is why this op requires num_gpus == 1. The intermediate buffers persist
+   across steps and are only reallocated when they have to grow.
+*/
+template <typename KeyType, typename OffsetType, typename DType, typename Adapter>
+class LookupFusedBase : public EmbeddingCollectionBase<KeyType, OffsetType, DType> {
+ protected:
+  Adapter adapter_;
+
+ private:
+  sok::HotnessCalLauncher<OffsetType> launcher_;
+
+  // Persistent buffers, they only grow
+  Tensor key_buffer_;
+  Tensor row_length_buffer_;
+  Tensor hotness_buffer_;
+  Tensor emb_vec_buffer_;
+
+ public:
+  explicit LookupFusedBase(OpKernelConstruction* ctx)
+      : EmbeddingCollectionBase<KeyType, OffsetType, DType>(ctx) {
+    launcher_.initialize();
+    OP_REQUIRES(ctx, this->num_gpus_ == 1,
+                errors::InvalidArgument("The fused lookup only supports num_gpus == 1."));
+    OP_REQUIRES(ctx, !this->use_sp_weight_,
+                errors::InvalidArgument("The fused lookup does not support sp_weights."));
+  }
+
+  void forward(OpKernelContext* ctx, std::shared_ptr<sok::CoreResourceManager>& tf_backend,
+               cudaStream_t stream) {
+    tf_internal::TFWorkspace::Scope workspace_scope(this->workspace_.get());
+    int tensor_device_id = tf_backend->get_device_id();
+    // Prepare inputs (except handles)
+    int64_t num_keys = 0;
+    int batch_size = -1;
+    std::vector<sok::Tensor23> keys;
+    std::vector<sok::Tensor23> row_lengths;
+    for (int i = 0; i < this->num_lookups_; ++i) {
+      const Tensor& key_tf = ctx->input(this->num_lookups_ + i);
+      keys.push_back(sok::convert_tensor_core23<KeyType>(&key_tf, tensor_device_id));
+      num_keys += key_tf.NumElements();
+
+      const Tensor& row_length_tf = ctx->input(this->num_lookups_ * 2 + i);
+      row_lengths.push_back(
+          sok::convert_tensor_core23<OffsetType>(&row_length_tf, tensor_device_id));
+      if (batch_size == -1) {
+        batch_size = row_length_tf.NumElements();
+      } else if (batch_size != row_length_tf.NumElements()) {
+        OP_REQUIRES(
+            ctx, false,
+            errors::InvalidArgument("shape[0] of each tensor in row_lengths are different."));
+      }
+    }
+    const int64_t num_row_lengths = static_cast<int64_t>(batch_size) * this->num_lookups_;
+
+    // Copy all the keys and row lengths in one buffer, which is what the lookup reads
+    if (key_buffer_.NumElements() < num_keys) {
+      OP_REQUIRES_OK(ctx, ctx->allocate_temp(ctx->input(this->num_lookups_).dtype(), {num_keys},
+                                             &key_buffer_));
+    }
+    if (row_length_buffer_.NumElements() < num_row_lengths) {
+      OP_REQUIRES_OK(ctx, ctx->allocate_temp(ctx->input(this->num_lookups_ * 2).dtype(),
+                                             {num_row_lengths}, &row_length_buffer_));
+    }
+    sok::Tensor23 key_buffer(
+        sok::convert_tensor_core23<KeyType>(&key_buffer_, num_keys, tensor_device_id));
+    sok::Tensor23 row_length_buffer(sok::convert_tensor_core23<OffsetType>(
+        &row_length_buffer_, num_row_lengths, tensor_device_id));
+    ::embedding::tf::swizzle_key::sparse_forward_per_gpu(tf_backend, keys, row_lengths, key_buffer,
+                                                         row_length_buffer);
+
+    // Get hotness dynamic
+    Tensor* hotness = nullptr;
+    OP_REQUIRES_OK(ctx,
+                   ctx->allocate_output(this->num_lookups_ + 2, {this->num_lookups_}, &hotness));
+    if (!hotness_buffer_.IsInitialized()) {
+      OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_INT32, {this->num_lookups_}, &hotness_buffer_));
+    }
+    launcher_(row_length_buffer_.data(), batch_size, this->num_lookups_, this->num_gpus_,
+              hotness_buffer_.data(), hotness->data(), stream);
+    int* t_hotness = (int*)hotness->data();
+    std::vector<int> hotness_vector(t_hotness, t_hotness + this->num_lookups_);
+
+    // Instance 3g embedding
+    this->update_meta(tf_backend, batch_size, hotness_vector);
+
+    // Lookup into the persistent emb_vec_buffer
+    auto buffer_size_list = ::embedding::tf::model_forward::get_model_comm_buffer_size(
+        *this->meta_, this->num_gpus_, batch_size);
+    const int64_t emb_vec_buffer_size = static_cast<int64_t>(buffer_size_list[0]);
+    if (emb_vec_buffer_.NumElements() < emb_vec_buffer_size) {
+      OP_REQUIRES_OK(ctx, ctx->allocate_temp(ctx->expected_output_dtype(0), {emb_vec_buffer_size},
+                                             &emb_vec_buffer_));
+    }
+    std::vector<sok::Tensor23> emb_vec_buffer{
+        sok::convert_tensor_core23<DType>(&emb_vec_buffer_, emb_vec_buffer_size, tensor_device_id)};
+
+    int64_t num_model_key, num_model_offsets;
+    sok::Tensor23 ret_model_key, ret_model_offset;
+    ::embedding::tf::model_forward::sparse_forward_per_gpu(
+        tf_backend, *this->ebc_param_, *this->meta_, key_buffer, row_length_buffer, &adapter_,
+        emb_vec_buffer, &num_model_key, &num_model_offsets, &ret_model_key, &ret_model_offset);
+
+    // Prepare model_key & model_offsets, which will be used in backward
+    Tensor* model_key = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(this->num_lookups_, {num_model_key}, &model_key));
+    sok::Tensor23 model_key_tensor(
+        sok::convert_tensor_core23<KeyType>(model_key, tensor_device_id));
+    Tensor* model_offsets = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(this->num_lookups_ + 1, {num_model_offsets},
+                                             &model_offsets));
+    sok::Tensor23 model_offsets_tensor(
+        sok::convert_tensor_core23<OffsetType>(model_offsets, tensor_device_id));
+    ::embedding::tf::model_forward::copy_model_keys_and_offsets(
+        tf_backend, ret_model_key, ret_model_offset, model_key_tensor, model_offsets_tensor);
+
+    // Combine the embedding vectors of each sample
+    std::vector<sok::Tensor23> emb_vec;
+    for (int i = 0; i < this->num_lookups_; ++i) {
+      Tensor* emb = nullptr;
+      OP_REQUIRES_OK(ctx, ctx->allocate_output(i, {batch_size, this->dimensions_[i]}, &emb));
+      emb_vec.push_back(sok::convert_tensor_core23<DType>(emb, tensor_device_id));
+    }
+    ::embedding::tf::network_forward::sparse_forward_per_gpu(tf_backend, *this->meta_,
+                                                             emb_vec_buffer, row_lengths, emb_vec);
+
+    Tensor* emb_vec_buffer_shape = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->allocate_output(this->num_lookups_ + 3, {this->num_gpus_},
+                                             &emb_vec_buffer_shape));
+#if TF_VERSION_MAJOR == 1
+    emb_vec_buffer_shape->flat<int64>().data()[0] = emb_vec_buffer_size;
+#else
+    emb_vec_buffer_shape->flat<int64_t>().data()[0] = emb_vec_buffer_size;
+#endif
+  }
+};
+
+// clang-format off
+#define REGISTER_GPU_KERNELS(key_type_tf, key_type, offset_type_tf, offset_type, dtype_tf, dtype)  \
+  REGISTER_KERNEL_BUILDER(Name("LookupFused")                                                      \
+                              .Device(DEVICE_GPU)                                                  \
+                              .HostMemory("handles")                                               \
+                              .HostMemory("hotness")                                               \
+                              .HostMemory("emb_vec_buffer_shape")                                  \
+                              .TypeConstraint<key_type_tf>("Tindices")                             \
+                              .TypeConstraint<offset_type_tf>("Toffsets")                          \
+                              .TypeConstraint<dtype_tf>("dtype"),                                  \
+                          LookupForwardOp<key_type, offset_type, dtype, Var,                       \
+                                          sok::TFAdapter<key_type, offset_type, dtype>,            \
+                                          LookupFusedBase<key_type, offset_type, dtype,            \
+                                              sok::TFAdapter<key_type, offset_type, dtype>>>)      \
+  REGISTER_KERNEL_BUILDER(Name("LookupFusedDynamic")                                               \
+                              .Device(DEVICE_GPU)                                                  \
+                              .HostMemory("handles")                                               \
+                              .HostMemory("hotness")                                               \
+                              .HostMemory("emb_vec_buffer_shape")                                  \
+                              .TypeConstraint<key_type_tf>("Tindices")                             \
+                              .TypeConstraint<offset_type_tf>("Toffsets")                          \
+                              .TypeConstraint<dtype_tf>("dtype"),                                  \
+                          LookupForwardOp<key_type, offset_type, dtype, DummyVar<key_type, dtype>, \
+                                          sok::DummyVarAdapter<key_type, offset_type, dtype>,      \
+                                          LookupFusedBase<key_type, offset_type, dtype,            \
+                                              sok::DummyVarAdapter<key_type, offset_type, dtype>>>) \
+  REGISTER_KERNEL_BUILDER(Name("LookupFusedVariable")                                              \
+                              .Device(DEVICE_GPU)                                                  \
+                              .HostMemory("hotness")                                               \
+                              .HostMemory("emb_vec_buffer_shape")                                  \
+                              .TypeConstraint<key_type_tf>("Tindices")                             \
+                              .TypeConstraint<offset_type_tf>("Toffsets")                          \
+                              .TypeConstraint<dtype_tf>("dtype"),                                  \
+                          LookupForwardVarOp<key_type, offset_type, dtype,                         \
+                                             LookupFusedBase<key_type, offset_type, dtype,         \
+                                                 sok::TFAdapter<key_type, offset_type, dtype>>>)
+// clang-format on
+
+#if TF_VERSION_MAJOR == 1
+REGISTER_GPU_KERNELS(int64, int64_t, int64, int64_t, float, float);
+REGISTER_GPU_KERNELS(int32, int32_t, int64, int64_t, float, float);
+REGISTER_GPU_KERNELS(int64, int64_t, int32, int32_t, float, float);
+REGISTER_GPU_KERNELS(int32, int32_t, int32, int32_t, float, float);
+#else
+REGISTER_GPU_KERNELS(int64_t, int64_t, int64_t, int64_t, float, float);
+REGISTER_GPU_KERNELS(int32_t, int32_t, int64_t, int64_t, float, float);
+REGISTER_GPU_KERNELS(int64_t, int64_t, int32_t, int32_t, float, float);
+REGISTER_GPU_KERNELS(int32_t, int32_t, int32_t, int32_t, float, float);
+#endif
+
+#undef REGISTER_GPU_KERNELS
+
+// -----------------------------------------------------------------------------------------------
+// LookupFusedBackward
+// -----------------------------------------------------------------------------------------------
+template <typename KeyType, typename OffsetType, typename DType>
+class LookupFusedBackwardOp : public EmbeddingCollectionBase<KeyType, OffsetType, DType> {
+ private:
+  // Persistent buffer, it only grows
+  Tensor emb_vec_buffer_grad_;
+
+ public:
+  explicit LookupFusedBackwardOp(OpKernelConstruction* ctx)
+      : EmbeddingCollectionBase<KeyType, OffsetType, DType>(ctx) {
+    OP_REQUIRES(ctx, this->num_gpus_ == 1,
+                errors::InvalidArgument("The fused lookup only supports num_gpus == 1."));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    tf_internal::TFWorkspace::Scope workspace_scope(this->workspace_.get());
+    /*
+       PostprocessingBackward followed by LookupBackward, the wgrad of the combined embedding
+       vectors is scattered into the persistent emb_vec_buffer_grad, then reduced by unique key.
+    */
+    int tensor_device_id = this->make_core_resource(ctx)->get_device_id();
+    // Prepare input
+    int batch_size = -1;
+    std::vector<sok::Tensor23> emb_vec_grad;
+    std::vector<sok::Tensor23> row_lengths;
+    for (int i = 0; i < this->num_lookups_; ++i) {
+      const Tensor& emb_vec_grad_tf = ctx->input(i);
+      emb_vec_grad.push_back(
+          sok::convert_tensor_core23<DType>(&emb_vec_grad_tf, tensor_device_id));
+      OP_REQUIRES(ctx, this->dimensions_[i] == emb_vec_grad_tf.dim_size(1),
+                  errors::InvalidArgument("Invalid dimension"));
+      if (batch_size == -1) {
+        batch_size = emb_vec_grad_tf.dim_size(0);
+      } else if (batch_size != emb_vec_grad_tf.dim_size(0)) {
+        OP_REQUIRES(
+            ctx, false,
+            errors::InvalidArgument("shape[0] of each tensor in emb_vec_grad are different."));
+      }
+
+      const Tensor& row_length = ctx->input(this->num_lookups_ + 2 + i);
+      row_lengths.push_back(sok::convert_tensor_core23<OffsetType>(&row_length, tensor_device_id));
+    }
+
+    const Tensor* model_key = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("model_key", &model_key));
+    sok::Tensor23 model_key_tensor(
+        sok::convert_tensor_core23<KeyType>(model_key, tensor_device_id));
+    const Tensor* model_offsets = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("model_offsets", &model_offsets));
+    sok::Tensor23 model_offsets_tensor(
+        sok::convert_tensor_core23<OffsetType>(model_offsets, tensor_device_id));
+
+    const Tensor* hotness = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("hotness", &hotness));
+    int* t_hotness = (int*)hotness->data();
+    std::vector<int> hotness_vector(t_hotness, t_hotness + hotness->NumElements());
+
+    // Instance 3g embedding
+    auto tf_backend = this->make_core_resource(ctx);
+    this->update_meta(tf_backend, batch_size, hotness_vector);
+
+    // Scatter the wgrad into the persistent emb_vec_buffer_grad
+    const Tensor* emb_vec_buffer_shape = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->input("emb_vec_buffer_shape", &emb_vec_buffer_shape));
+#if TF_VERSION_MAJOR == 1
+    const int64_t emb_vec_buffer_size = emb_vec_buffer_shape->flat<int64>().data()[0];
+#else
+    const int64_t emb_vec_buffer_size = emb_vec_buffer_shape->flat<int64_t>().data()[0];
+#endif
+    if (emb_vec_buffer_grad_.NumElements() < emb_vec_buffer_size) {
+      OP_REQUIRES_OK(ctx, ctx->allocate_temp(ctx->input(0).dtype(), {emb_vec_buffer_size},
+                                             &emb_vec_buffer_grad_));
+    }
+    std::vector<sok::Tensor23> emb_vec_buffer_grad{sok::convert_tensor_core23<DType>(
+        &emb_vec_buffer_grad_, emb_vec_buffer_size, tensor_device_id)};
+    ::embedding::tf::network_backward::backward_per_gpu(tf_backend, *this->meta_, emb_vec_grad,
+                                                        row_lengths, emb_vec_buffer_grad);
+
+    // Reduce the wgrad by unique key
+    std::vector<int> num_unique_key_per_table, unique_id_space_list;
+    sok::Tensor23 ret_continous_unique_key, ret_continous_emb_vec;
+    ::embedding::tf::model_backward::sparse_backward_per_gpu(
+        tf_backend, *this->ebc_param_, *this->meta_, emb_vec_buffer_grad, model_key_tensor,
+        model_offsets_tensor, &num_unique_key_per_table, &unique_id_space_list,
+        &ret_continous_unique_key, &ret_continous_emb_vec);
+
+    // Prepare output, all the lookups are local on a single GPU
+    std::vector<sok::Tensor23> unique_key, grad;
+    std::vector<size_t> num_unique_keys;
+    std::vector<size_t> num_grad_length;
+    for (int i = 0; i < this->num_lookups_; ++i) {
+      int num_unique_key = num_unique_key_per_table[i];
+      Tensor* unique_key_tf = nullptr;
+      OP_REQUIRES_OK(ctx, ctx->allocate_output(i, {num_unique_key}, &unique_key_tf));
+      Tensor* grad_tf = nullptr;
+      OP_REQUIRES_OK(ctx, ctx->allocate_output(i + this->num_lookups_,
+                                               {num_unique_key, this->dimensions_[i]}, &grad_tf));
+      num_unique_keys.push_back(num_unique_key);
+      num_grad_length.push_back(grad_tf->NumElements());
+      unique_key.push_back(sok::convert_tensor_core23<KeyType>(unique_key_tf, tensor_device_id));
+      grad.push_back(sok::convert_tensor_core23<DType>(grad_tf, tensor_device_id));
+    }
+
+    // Copy output
+    ::embedding::tf::model_backward::copy_backward_key_and_emb_vec(
+        tf_backend, num_unique_keys, num_grad_length, ret_continous_unique_key,
+        ret_continous_emb_vec, unique_key, grad);
+  }
+};
+
+#define REGISTER_GPU_KERNELS(key_type_tf, key_type, offset_type_tf, offset_type, dtype_tf, dtype) \
+  REGISTER_KERNEL_BUILDER(Name("LookupFusedBackward")                                             \
+                              .Device(DEVICE_GPU)                                                 \
+                              .HostMemory("hotness")                                              \
+                              .HostMemory("emb_vec_buffer_shape")                                 \
+                              .TypeConstraint<key_type_tf>("Tindices")                            \
+                              .TypeConstraint<offset_type_tf>("Toffsets")                         \
+                              .TypeConstraint<dtype_tf>("dtype"),                                 \
+                          LookupFusedBackwardOp<key_type, offset_type, dtype>)
+
+#if TF_VERSION_MAJOR == 1
+REGISTER_GPU_KERNELS(int64, int64_t, int64, int64_t, float, float);
+REGISTER_GPU_KERNELS(int32, int32_t, int64, int64_t, float, float);
+REGISTER_GPU_KERNELS(int64, int64_t, int32, int32_t, float, float);
+REGISTER_GPU_KERNELS(int32, int32_t, int32, int32_t, float, float);
+#else
+REGISTER_GPU_KERNELS(int64_t, int64_t, int64_t, int64_t, float, float);
+REGISTER_GPU_KERNELS(int32_t, int32_t, int64_t, int64_t, float, float);
+REGISTER_GPU_KERNELS(int64_t, int64_t, int32_t, int32_t, float, float);
+REGISTER_GPU_KERNELS(int32_t, int32_t, int32_t, int32_t, float, float);
+#endif
+
+#undef REGISTER_GPU_KERNELS
+
 }  // namespace tensorflow
 
 #ifdef GOOGLE_CUDA
@@ -52,21 +52,14 @@ class DistSelectOp : public OpKernel {
     OP_REQUIRES_OK(ctx, ctx->allocate_output(1, {num_keys}, &order));
     OP_REQUIRES_OK(ctx, ctx->allocate_output(2, {num_splits_}, &splits));
 
-    // temp buffer
-    Tensor output_buffer;
-    Tensor order_buffer;
-    OP_REQUIRES_OK(ctx,
-                   ctx->allocate_temp(indices->dtype(), {num_keys * num_splits_}, &output_buffer));
-    OP_REQUIRES_OK(ctx, ctx->allocate_temp(DT_INT32, {num_keys * num_splits_}, &order_buffer));
-
     // stream
     auto device_ctx = ctx->op_device_context();
     OP_REQUIRES(ctx, device_ctx != nullptr, errors::Aborted("No valid device context."));
     cudaStream_t stream = stream_executor::gpu::AsGpuStreamValue(device_ctx->stream());
 
     // cuda kernel
-    launcher_(indices->data(), num_keys, output->data(), output_buffer.data(), order->data(),
-              order_buffer.data(), splits->data(), num_splits_, stream);
+    launcher_(indices->data(), num_keys, output->data(), order->data(), splits->data(),
+              num_splits_, stream);
   }
 
  private:
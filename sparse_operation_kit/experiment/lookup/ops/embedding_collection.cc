@@ -417,4 +417,99 @@ REGISTER_OP("PostprocessingBackward")
         return sok_tsl_status(); 
     });
 
+// Fuses PreprocessingForward, HotnessCalculate, LookupForward and PostprocessingForward,
+// only for num_gpus == 1. There may be duplicates in the `handles`
+#define REGISTER_LOOKUP_FUSED_OP(name, params)                                             \
+  REGISTER_OP(name)                                                                        \
+      .Input(params)                                                                       \
+      .Input("keys: num_lookups * Tindices")                                               \
+      .Input("row_lengths: num_lookups * Toffsets")                                        \
+      .Output("emb_vec: num_lookups * dtype")                                              \
+      .Output("model_key: Tindices")                                                       \
+      .Output("model_offsets: Toffsets")                                                   \
+      .Output("hotness: int32")                                                            \
+      .Output("emb_vec_buffer_shape: int64")                                               \
+      .Attr("num_lookups: int")                                                            \
+      .Attr("combiners: list(string)")                                                     \
+      .Attr("shard: list(int)")                                                            \
+      .Attr("dimensions: list(int)")                                                       \
+      .Attr("rank: int")                                                                   \
+      .Attr("num_ranks: int")                                                              \
+      .Attr("id_in_local_rank: int")                                                       \
+      .Attr("num_gpus: int")                                                               \
+      .Attr("use_sp_weight: bool")                                                         \
+      .Attr("Tindices: {int32, int64} = DT_INT64")                                         \
+      .Attr("Toffsets: {int32, int64} = DT_INT64")                                         \
+      .Attr("dtype: {float32, float16} = DT_FLOAT")                                        \
+      .SetShapeFn([](InferenceContext* c) {                                                \
+        int num_lookups;                                                                   \
+        TF_RETURN_IF_ERROR(c->GetAttr("num_lookups", &num_lookups));                       \
+                                                                                           \
+        int num_gpus;                                                                      \
+        TF_RETURN_IF_ERROR(c->GetAttr("num_gpus", &num_gpus));                             \
+                                                                                           \
+        std::vector<int> dimensions;                                                       \
+        TF_RETURN_IF_ERROR(c->GetAttr("dimensions", &dimensions));                         \
+                                                                                           \
+        ShapeHandle row_lengths = c->input(2 * num_lookups);                               \
+        shape_inference::DimensionHandle batch_size = c->NumElements(row_lengths);         \
+                                                                                           \
+        for (int i = 0; i < num_lookups; ++i) {                                            \
+          c->set_output(i, c->MakeShape({batch_size, dimensions[i]}));                     \
+        }                                                                                  \
+        ShapeHandle unknown_1d_shape = c->UnknownShapeOfRank(1);                           \
+        c->set_output(num_lookups, unknown_1d_shape);                                      \
+        c->set_output(num_lookups + 1, unknown_1d_shape);                                  \
+        c->set_output(num_lookups + 2, c->MakeShape({num_lookups}));                       \
+        c->set_output(num_lookups + 3, c->MakeShape({num_gpus}));                          \
+                                                                                           \
+        return sok_tsl_status();                                                           \
+      });
+
+REGISTER_LOOKUP_FUSED_OP("LookupFused", "handles: num_lookups * resource")
+REGISTER_LOOKUP_FUSED_OP("LookupFusedVariable", "embeddings: num_lookups * dtype")
+REGISTER_LOOKUP_FUSED_OP("LookupFusedDynamic", "handles: num_lookups * resource")
+
+#undef REGISTER_LOOKUP_FUSED_OP
+
+REGISTER_OP("LookupFusedBackward")
+    .Input("emb_vec_grad: num_lookups * dtype")
+    .Input("model_key: Tindices")
+    .Input("model_offsets: Toffsets")
+    .Input("row_lengths: num_lookups * Toffsets")
+    .Input("hotness: int32")
+    .Input("emb_vec_buffer_shape: int64")
+    .Output("unique_key: num_lookups * Tindices")
+    .Output("grad: num_lookups * dtype")
+    .Attr("num_lookups: int")
+    .Attr("combiners: list(string)")
+    .Attr("shard: list(int)")
+    .Attr("dimensions: list(int)")
+    .Attr("rank: int")
+    .Attr("num_ranks: int")
+    .Attr("id_in_local_rank: int")
+    .Attr("num_gpus: int")
+    .Attr("use_sp_weight: bool")
+    .Attr("Tindices: {int32, int64} = DT_INT64")
+    .Attr("Toffsets: {int32, int64} = DT_INT64")
+    .Attr("dtype: {float32, float16} = DT_FLOAT")
+    .SetShapeFn([](InferenceContext* c) {
+        int num_lookups;
+        TF_RETURN_IF_ERROR(c->GetAttr("num_lookups", &num_lookups));
+
+        std::vector<int> dimensions;
+        TF_RETURN_IF_ERROR(c->GetAttr("dimensions", &dimensions));
+
+        for  (int i = 0; i < num_lookups; ++i) {
+            shape_inference::DimensionHandle num_unique_key = c->UnknownDim();
+
+            ShapeHandle unique_key_shape = c->MakeShape({num_unique_key});
+            c->set_output(i, unique_key_shape);
+            ShapeHandle wgrad_shape = c->MakeShape({num_unique_key, dimensions[i]});
+            c->set_output(num_lookups + i, wgrad_shape);
+        }
+
+        return sok_tsl_status(); 
+    });
+
 }  // namespace tensorflow
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CHUNKED_TRANSFER_H
+#define CHUNKED_TRANSFER_H
+
+#include <cuda_runtime_api.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/check.h"
+
+namespace sok {
+
+// Moves the keys and values of a variable between the host and the device in chunks, so that
+// the device never holds a second copy of the whole table. There are two device and two pinned
+// host buffers, so that the copy of one chunk overlaps with the work on the other one.
+template <typename KeyType, typename ValueType>
+class ChunkedTransfer {
+ public:
+  // The size of a chunk when the caller does not need a particular one.
+  static constexpr size_t default_chunk_bytes = 64 * 1024 * 1024;
+
+  ChunkedTransfer(size_t dimension, size_t chunk_size = 0)
+      : dimension_(dimension),
+        chunk_size_(chunk_size > 0 ? chunk_size
+                                   : std::max(default_chunk_bytes /
+                                                  (sizeof(KeyType) + sizeof(ValueType) * dimension),
+                                              static_cast<size_t>(1))) {
+    for (int i = 0; i < 2; ++i) {
+      CUDACHECK(cudaMalloc(&d_keys_[i], sizeof(KeyType) * chunk_size_));
+      CUDACHECK(cudaMalloc(&d_values_[i], sizeof(ValueType) * chunk_size_ * dimension_));
+      CUDACHECK(cudaMallocHost(&h_keys_[i], sizeof(KeyType) * chunk_size_));
+      CUDACHECK(cudaMallocHost(&h_values_[i], sizeof(ValueType) * chunk_size_ * dimension_));
+      CUDACHECK(cudaEventCreateWithFlags(&events_[i], cudaEventDisableTiming));
+    }
+  }
+
+  ~ChunkedTransfer() {
+    for (int i = 0; i < 2; ++i) {
+      CUDACHECK(cudaFree(d_keys_[i]));
+      CUDACHECK(cudaFree(d_values_[i]));
+      CUDACHECK(cudaFreeHost(h_keys_[i]));
+      CUDACHECK(cudaFreeHost(h_values_[i]));
+      CUDACHECK(cudaEventDestroy(events_[i]));
+    }
+  }
+
+  ChunkedTransfer(const ChunkedTransfer &) = delete;
+  ChunkedTransfer &operator=(const ChunkedTransfer &) = delete;
+
+  size_t chunk_size() const { return chunk_size_; }
+
+  // Copies up to max_rows rows of the table to the host keys and values, and returns the number
+  // of rows copied. export_chunk(i, d_keys, d_values, stream) fills the device buffers with the
+  // rows of chunk i (at most chunk_size() of them) and returns their number after synchronizing
+  // the stream.
+  template <typename ExportChunk>
+  size_t eXport(size_t num_chunks, ExportChunk export_chunk, KeyType *keys, ValueType *values,
+                size_t max_rows, cudaStream_t stream) {
+    size_t offset = 0;
+    size_t pending_rows = 0;
+    for (size_t i = 0; i < num_chunks; ++i) {
+      int b = i % 2;
+      // The synchronization of export_chunk also finishes the D2H copy of the last chunk.
+      size_t num_rows = export_chunk(i, d_keys_[b], d_values_[b], stream);
+      num_rows = std::min(num_rows, max_rows - offset - pending_rows);
+      copy_to_host(b, num_rows, stream);
+      if (pending_rows > 0) {
+        write(1 - b, pending_rows, keys + offset, values + offset * dimension_);
+        offset += pending_rows;
+      }
+      pending_rows = num_rows;
+    }
+    CUDACHECK(cudaStreamSynchronize(stream));
+    if (pending_rows > 0) {
+      write((num_chunks - 1) % 2, pending_rows, keys + offset, values + offset * dimension_);
+      offset += pending_rows;
+    }
+    return offset;
+  }
+
+  // Copies the num_keys host keys and values to the device chunk by chunk, and calls
+  // assign_chunk(d_keys, d_values, num_rows, stream) on each chunk without synchronizing.
+  template <typename AssignChunk>
+  void assign(const KeyType *keys, const ValueType *values, size_t num_keys,
+              AssignChunk assign_chunk, cudaStream_t stream) {
+    for (size_t i = 0, offset = 0; offset < num_keys; ++i, offset += chunk_size_) {
+      int b = i % 2;
+      size_t num_rows = std::min(chunk_size_, num_keys - offset);
+      if (i >= 2) {
+        // Wait until the chunk before the last one is done with the buffers.
+        CUDACHECK(cudaEventSynchronize(events_[b]));
+      }
+      std::memcpy(h_keys_[b], keys + offset, sizeof(KeyType) * num_rows);
+      std::memcpy(h_values_[b], values + offset * dimension_,
+                  sizeof(ValueType) * num_rows * dimension_);
+      CUDACHECK(cudaMemcpyAsync(d_keys_[b], h_keys_[b], sizeof(KeyType) * num_rows,
+                                cudaMemcpyHostToDevice, stream));
+      CUDACHECK(cudaMemcpyAsync(d_values_[b], h_values_[b],
+                                sizeof(ValueType) * num_rows * dimension_, cudaMemcpyHostToDevice,
+                                stream));
+      assign_chunk(d_keys_[b], d_values_[b], num_rows, stream);
+      CUDACHECK(cudaEventRecord(events_[b], stream));
+    }
+    CUDACHECK(cudaStreamSynchronize(stream));
+  }
+
+ private:
+  void copy_to_host(int b, size_t num_rows, cudaStream_t stream) {
+    CUDACHECK(cudaMemcpyAsync(h_keys_[b], d_keys_[b], sizeof(KeyType) * num_rows,
+                              cudaMemcpyDeviceToHost, stream));
+    CUDACHECK(cudaMemcpyAsync(h_values_[b], d_values_[b], sizeof(ValueType) * num_rows * dimension_,
+                              cudaMemcpyDeviceToHost, stream));
+  }
+
+  void write(int b, size_t num_rows, KeyType *keys, ValueType *values) {
+    std::memcpy(keys, h_keys_[b], sizeof(KeyType) * num_rows);
+    std::memcpy(values, h_values_[b], sizeof(ValueType) * num_rows * dimension_);
+  }
+
+  size_t dimension_;
+  size_t chunk_size_;
+  KeyType *d_keys_[2];
+  ValueType *d_values_[2];
+  KeyType *h_keys_[2];
+  ValueType *h_values_[2];
+  cudaEvent_t events_[2];
+};
+
+}  // namespace sok
+
+#endif  // CHUNKED_TRANSFER_H
@@ -17,6 +17,7 @@
 #include <random>
 
 #include "common/check.h"
+#include "variable/impl/chunked_transfer.h"
 #include "variable/impl/det_variable.h"
 
 namespace sok {
@@ -110,6 +111,9 @@ DETVariable<KeyType, ValueType>::~DETVariable() {
   if (curand_states_) {
     CUDACHECK(cudaFree(curand_states_));
   }
+  if (d_group_tasks_) {
+    CUDACHECK(cudaFree(d_group_tasks_));
+  }
 }
 
 template <typename KeyType, typename ValueType>
@@ -126,25 +130,18 @@ template <typename KeyType, typename ValueType>
 void DETVariable<KeyType, ValueType>::eXport(KeyType* keys, ValueType* values,
                                              cudaStream_t stream) {
   size_t num_keys = rows();
-  size_t dim = cols();
-
-  // `keys` and `values` are pointers of host memory
-  KeyType* d_keys;
-  CUDACHECK(cudaMalloc(&d_keys, sizeof(KeyType) * num_keys));
-  ValueType* d_values;
-  CUDACHECK(cudaMalloc(&d_values, sizeof(ValueType) * num_keys * dim));
-
-  map_->eXport(d_keys, d_values, num_keys, stream);
 
-  // clang-format off
-  CUDACHECK(cudaMemcpyAsync(keys, d_keys, sizeof(KeyType) * num_keys,
-                            cudaMemcpyDeviceToHost, stream));
-  CUDACHECK(cudaMemcpyAsync(values, d_values, sizeof(ValueType) * num_keys * dim,
-                            cudaMemcpyDeviceToHost, stream));
-  // clang-format on
-  CUDACHECK(cudaStreamSynchronize(stream));
-  CUDACHECK(cudaFree(d_keys));
-  CUDACHECK(cudaFree(d_values));
+  // `keys` and `values` are pointers of host memory, which are filled chunk by chunk of slots
+  ChunkedTransfer<KeyType, ValueType> transfer(cols());
+  size_t chunk_size = transfer.chunk_size();
+  size_t num_slots = map_->get_num_slots();
+  transfer.eXport(
+      (num_slots + chunk_size - 1) / chunk_size,
+      [&](size_t i, KeyType* d_keys, ValueType* d_values, cudaStream_t stream) {
+        return map_->export_slots(i * chunk_size, std::min(chunk_size, num_slots - i * chunk_size),
+                                  d_keys, d_values, stream);
+      },
+      keys, values, num_keys, stream);
 }
 
 template <typename KeyType, typename ValueType>
@@ -152,24 +149,19 @@ void DETVariable<KeyType, ValueType>::assign(const KeyType* keys, const ValueTyp
                                              size_t num_keys, cudaStream_t stream) {
   size_t dim = cols();
 
-  // `keys` and `values` are pointers of host memory
-  KeyType* d_keys;
-  CUDACHECK(cudaMalloc(&d_keys, sizeof(KeyType) * num_keys));
-  ValueType* d_values;
-  CUDACHECK(cudaMalloc(&d_values, sizeof(ValueType) * num_keys * dim));
-
-  // clang-format off
-  CUDACHECK(cudaMemcpyAsync(d_keys, keys, sizeof(KeyType) * num_keys,
-                            cudaMemcpyHostToDevice, stream));
-  // clang-format on
-  map_->lookup(d_keys, d_values, num_keys, stream);
-
-  CUDACHECK(cudaMemcpyAsync(d_values, values, sizeof(ValueType) * num_keys * dim,
-                            cudaMemcpyHostToDevice, stream));
-  map_->scatter_update(d_keys, d_values, num_keys, stream);
-  CUDACHECK(cudaStreamSynchronize(stream));
-  CUDACHECK(cudaFree(d_keys));
-  CUDACHECK(cudaFree(d_values));
+  // `keys` and `values` are pointers of host memory, which are copied chunk by chunk
+  ChunkedTransfer<KeyType, ValueType> transfer(dim);
+  // The lookup inserts the missing keys, its values are overwritten by scatter_update.
+  ValueType* d_inserted_values;
+  CUDACHECK(cudaMalloc(&d_inserted_values, sizeof(ValueType) * transfer.chunk_size() * dim));
+  transfer.assign(
+      keys, values, num_keys,
+      [&](const KeyType* d_keys, const ValueType* d_values, size_t n, cudaStream_t stream) {
+        map_->lookup(d_keys, d_inserted_values, n, stream);
+        map_->scatter_update(d_keys, d_values, n, stream);
+      },
+      stream);
+  CUDACHECK(cudaFree(d_inserted_values));
 }
 
 template <typename KeyType, typename ValueType>
@@ -196,6 +188,83 @@ void DETVariable<KeyType, ValueType>::scatter_update(const KeyType* keys, const
   map_->scatter_update(keys, values, num_keys, stream);
 }
 
+template <typename KeyType, typename ValueType>
+void DETVariable<KeyType, ValueType>::group_lookup(
+    const std::vector<GroupLookupTask<KeyType, ValueType>>& tasks, cudaStream_t stream) {
+  std::vector<DETVariable*> vars(tasks.size());
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    vars[i] = dynamic_cast<DETVariable*>(tasks[i].var);
+    if (vars[i] == nullptr) {
+      VariableBase<KeyType, ValueType>::group_lookup(tasks, stream);
+      return;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(group_mu_);
+  h_group_tasks_.clear();
+  // The index in h_group_tasks_ of the first task of each variable, -1 for the others.
+  std::vector<int> first_task(tasks.size(), -1);
+  uint32_t num_blocks = 0;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (tasks[i].num_keys == 0) {
+      continue;
+    }
+    int first = -1;
+    for (size_t j = 0; j < i && first < 0; ++j) {
+      if (vars[j] == vars[i]) {
+        first = first_task[j];
+      }
+    }
+
+    typename Map::lookup_task task;
+    if (first < 0) {
+      // Make room for the keys of all the tasks of this variable at once.
+      size_t num_keys = 0;
+      for (size_t j = i; j < tasks.size(); ++j) {
+        num_keys += vars[j] == vars[i] ? tasks[j].num_keys : 0;
+      }
+      if (!vars[i]->map_->get_lookup_task(tasks[i].keys, tasks[i].values, num_keys, &task,
+                                          stream)) {
+        VariableBase<KeyType, ValueType>::group_lookup(tasks, stream);
+        return;
+      }
+      first_task[i] = h_group_tasks_.size();
+    } else {
+      task = h_group_tasks_[first];
+      task.keys = tasks[i].keys;
+      task.values = tasks[i].values;
+    }
+    task.num_keys = tasks[i].num_keys;
+    task.block_offset = num_blocks;
+    num_blocks += Map::get_lookup_num_blocks(tasks[i].num_keys);
+    h_group_tasks_.push_back(task);
+  }
+  if (h_group_tasks_.empty()) {
+    return;
+  }
+
+  if (h_group_tasks_.size() > group_tasks_capacity_) {
+    if (d_group_tasks_) {
+      CUDACHECK(cudaFree(d_group_tasks_));
+    }
+    group_tasks_capacity_ = h_group_tasks_.size();
+    CUDACHECK(
+        cudaMalloc(&d_group_tasks_, sizeof(typename Map::lookup_task) * group_tasks_capacity_));
+  }
+  CUDACHECK(cudaMemcpyAsync(d_group_tasks_, h_group_tasks_.data(),
+                            sizeof(typename Map::lookup_task) * h_group_tasks_.size(),
+                            cudaMemcpyHostToDevice, stream));
+  Map::group_lookup(d_group_tasks_, h_group_tasks_.size(), num_blocks, stream);
+
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (first_task[i] >= 0) {
+      vars[i]->map_->copy_size_async(stream);
+    }
+  }
+  // Make the sizes of all the maps valid, like dynamic_map::lookup does for one map.
+  CUDACHECK(cudaStreamSynchronize(stream));
+}
+
 template class DETVariable<int32_t, float>;
 template class DETVariable<int64_t, float>;
 
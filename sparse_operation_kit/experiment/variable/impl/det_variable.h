@@ -17,7 +17,9 @@
 #ifndef DET_VARIABLE_H
 #define DET_VARIABLE_H
 
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "variable/impl/dynamic_embedding_table/cuCollections/include/cuco/dynamic_map.cuh"
 #include "variable/impl/dynamic_embedding_table/cuCollections/include/cuco/initializer.cuh"
@@ -48,8 +50,19 @@ class DETVariable : public VariableBase<KeyType, ValueType> {
   void scatter_update(const KeyType *keys, const ValueType *values, size_t num_keys,
                       cudaStream_t stream = 0) override;
 
+  // Looks up all the DETVariables of tasks in one kernel and one synchronization.
+  void group_lookup(const std::vector<GroupLookupTask<KeyType, ValueType>> &tasks,
+                    cudaStream_t stream = 0) override;
+
  private:
-  std::unique_ptr<cuco::dynamic_map<KeyType, ValueType, cuco::initializer>> map_;
+  using Map = cuco::dynamic_map<KeyType, ValueType, cuco::initializer>;
+  std::unique_ptr<Map> map_;
+
+  // The descriptors of group_lookup, reused across the calls.
+  std::mutex group_mu_;
+  std::vector<typename Map::lookup_task> h_group_tasks_;
+  typename Map::lookup_task *d_group_tasks_ = nullptr;
+  size_t group_tasks_capacity_ = 0;
 
   size_t dimension_;
   size_t initial_capacity_;
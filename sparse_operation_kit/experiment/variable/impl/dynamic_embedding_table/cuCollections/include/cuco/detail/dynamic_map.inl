@@ -170,6 +170,52 @@ void dynamic_map<Key, Element, Initializer>::lookup(key_type const *keys, elemen
   CUCO_CUDA_TRY(cudaStreamSynchronize(stream));
 }
 
+template <typename Key, typename Element, typename Initializer>
+bool dynamic_map<Key, Element, Initializer>::get_lookup_task(key_type const *keys,
+                                                             element_type **values,
+                                                             size_t num_keys, lookup_task *task,
+                                                             cudaStream_t stream) {
+  reserve(get_size() + num_keys, stream);
+
+  for (uint32_t submap_idx = 0; submap_idx < submaps_.size(); ++submap_idx) {
+    double capacity_remaining =
+        static_cast<double>(max_load_factor_) * submaps_[submap_idx]->get_capacity() -
+        static_cast<double>(submaps_[submap_idx]->get_size());
+    if (capacity_remaining >= min_insert_size_ && capacity_remaining >= num_keys) {
+      task->keys = keys;
+      task->values = values;
+      task->num_keys = num_keys;
+      task->submap_views = submap_views_.data().get();
+      task->submap_mutable_views = submap_mutable_views_.data().get();
+      task->occupied_size = submaps_[submap_idx]->occupied_size_;
+      task->reclaimed_size = submaps_[submap_idx]->reclaimed_size_;
+      task->insert_idx = submap_idx;
+      task->num_submaps = submaps_.size();
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename Key, typename Element, typename Initializer>
+void dynamic_map<Key, Element, Initializer>::copy_size_async(cudaStream_t stream) {
+  CUCO_CUDA_TRY(cudaMemcpyAsync(h_occupied_size_per_submap_, occupied_size_per_submap_,
+                                sizeof(atomic_ctr_type) * max_num_submaps * 2,
+                                cudaMemcpyDeviceToHost, stream));
+}
+
+template <typename Key, typename Element, typename Initializer>
+template <typename Hash>
+void dynamic_map<Key, Element, Initializer>::group_lookup(lookup_task const *tasks,
+                                                          size_t num_tasks, uint32_t num_blocks,
+                                                          cudaStream_t stream, Hash hash) {
+  if (num_blocks == 0) {
+    return;
+  }
+  detail::group_lookup<lookup_block_size, lookup_tile_size, pointer_pair_type>
+      <<<num_blocks, lookup_block_size, 0, stream>>>(tasks, num_tasks, hash);
+}
+
 template <typename Key, typename Element, typename Initializer>
 template <typename Hash>
 void dynamic_map<Key, Element, Initializer>::scatter_add(key_type const *keys,
@@ -246,4 +292,33 @@ void dynamic_map<Key, Element, Initializer>::eXport(key_type *keys, element_type
   // CUCO_CUDA_TRY(cudaStreamSynchronize(stream));
 }
 
+template <typename Key, typename Element, typename Initializer>
+size_t dynamic_map<Key, Element, Initializer>::export_slots(size_t slot_begin, size_t num_slots,
+                                                            key_type *keys, element_type *values,
+                                                            cudaStream_t stream) {
+  auto const block_size = 128;
+
+  h_num_successes_[0] = 0;
+  CUCO_CUDA_TRY(cudaMemcpyAsync(num_successes_, h_num_successes_, sizeof(atomic_ctr_type),
+                                cudaMemcpyHostToDevice, stream));
+  size_t slot_end = slot_begin + num_slots;
+  size_t submap_begin = 0;
+  for (uint32_t i = 0; i < submaps_.size() && submap_begin < slot_end; ++i) {
+    size_t submap_end = submap_begin + submaps_[i]->get_capacity();
+    size_t begin = std::max(slot_begin, submap_begin);
+    size_t end = std::min(slot_end, submap_end);
+    if (begin < end) {
+      auto const grid_size = (end - begin + block_size - 1) / block_size;
+      detail::export_slots<block_size><<<grid_size, block_size, 0, stream>>>(
+          keys, values, num_successes_, submaps_[i]->get_device_view(), begin - submap_begin,
+          end - submap_begin);
+    }
+    submap_begin = submap_end;
+  }
+  CUCO_CUDA_TRY(cudaMemcpyAsync(h_num_successes_, num_successes_, sizeof(atomic_ctr_type),
+                                cudaMemcpyDeviceToHost, stream));
+  CUCO_CUDA_TRY(cudaStreamSynchronize(stream));
+  return h_num_successes_[0];
+}
+
 }  // namespace cuco
@@ -139,6 +139,73 @@ __global__ void lookup(key_type const *keys, element_type **values, uint32_t dim
   }
 }
 
+template <uint32_t block_size, uint32_t tile_size, typename pair_type, typename taskT,
+          typename Hash>
+__global__ void group_lookup(taskT const *tasks, size_t num_tasks, Hash hash) {
+  __shared__ cuda::atomic<size_t, cuda::thread_scope_block> block_num_occupied_empty;
+  __shared__ cuda::atomic<size_t, cuda::thread_scope_block> block_num_occupied_reclaimed;
+
+  auto grid = cooperative_groups::this_grid();
+  auto block = cooperative_groups::this_thread_block();
+  auto tile = cooperative_groups::tiled_partition<tile_size>(block);
+
+  // The task of this block is the last one starting at or before it.
+  size_t lo = 0;
+  size_t hi = num_tasks;
+  while (hi - lo > 1) {
+    size_t mid = (lo + hi) / 2;
+    if (tasks[mid].block_offset <= block.group_index().x) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+  taskT const &task = tasks[lo];
+  uint32_t task_block = block.group_index().x - task.block_offset;
+  uint32_t task_num_blocks =
+      (lo + 1 < num_tasks ? tasks[lo + 1].block_offset : grid.group_dim().x) - task.block_offset;
+
+  if (block.thread_rank() == 0) {
+    block_num_occupied_empty = 0;
+    block_num_occupied_reclaimed = 0;
+  }
+
+  block.sync();
+
+  for (size_t key_idx = tile.meta_group_size() * task_block + tile.meta_group_rank();
+       key_idx < task.num_keys; key_idx += tile.meta_group_size() * task_num_blocks) {
+    pair_type lookup_pair = {task.keys[key_idx], task.values + key_idx};
+    auto exists = false;
+
+    for (auto i = 0; i < task.num_submaps; ++i) {
+      auto submap_view = task.submap_views[i];
+      if (submap_view.lookup(tile, lookup_pair, hash)) {
+        exists = true;
+        break;
+      }
+    }
+
+    if (!exists) {
+      auto const status =
+          task.submap_mutable_views[task.insert_idx].lookup_or_insert(tile, lookup_pair, hash);
+      if (tile.thread_rank() == 0) {
+        if (status == insert_result::OCCUPIED_EMPTY) {
+          block_num_occupied_empty++;
+        } else if (status == insert_result::OCCUPIED_RECLAIMED) {
+          block_num_occupied_reclaimed++;
+        }
+      }
+    }
+  }
+
+  block.sync();
+
+  if (block.thread_rank() == 0) {
+    *task.occupied_size += block_num_occupied_empty;
+    *task.reclaimed_size -= block_num_occupied_reclaimed;
+  }
+}
+
 template <uint32_t tile_size, typename pair_type, typename key_type, typename element_type,
           typename mutableViewT, typename Hash>
 __global__ void scatter_add(key_type const *keys, element_type const *updates, uint32_t dimension,
@@ -271,5 +338,53 @@ __global__ void eXport(key_type *keys, value_type *values, size_t num_keys, atom
   }
 }
 
+// Exports the entries of the slots [begin, end) of one submap. Unlike eXport, every thread of
+// a block runs the same number of iterations, so that the block synchronizations match.
+template <uint32_t block_size, typename key_type, typename value_type, typename viewT,
+          typename atomicT>
+__global__ void export_slots(key_type *keys, value_type *values, atomicT *counter,
+                             viewT submap_view, size_t begin, size_t end) {
+  __shared__ cuda::atomic<size_t, cuda::thread_scope_block> block_counter;
+  __shared__ size_t global_offset;
+
+  auto block = cooperative_groups::this_thread_block();
+
+  for (size_t base = begin + static_cast<size_t>(blockIdx.x) * block_size; base < end;
+       base += static_cast<size_t>(gridDim.x) * block_size) {
+    size_t j = base + block.thread_rank();
+    if (block.thread_rank() == 0) {
+      block_counter = 0;
+    }
+
+    block.sync();
+
+    int block_offset = -1;
+    if (j < end) {
+      auto it = submap_view.at(j);
+      if (it.key() != submap_view.get_empty_key_sentinel() &&
+          it.key() != submap_view.get_reclaimed_key_sentinel()) {
+        block_offset = block_counter.fetch_add(1, cuda::std::memory_order_relaxed);
+      }
+    }
+
+    block.sync();
+
+    if (block.thread_rank() == 0) {
+      auto block_num_entries = block_counter.load(cuda::std::memory_order_relaxed);
+      global_offset = counter[0].fetch_add(block_num_entries, cuda::std::memory_order_relaxed);
+    }
+
+    block.sync();
+
+    if (block_offset != -1) {
+      auto it = submap_view.at(j);
+      auto offset = global_offset + block_offset;
+      keys[offset] = it.key();
+      detail::copy_array(cooperative_groups::this_thread(), submap_view.get_dimension(),
+                         values + submap_view.get_dimension() * offset, it.value());
+    }
+  }
+}
+
 }  // namespace detail
 }  // namespace cuco
\ No newline at end of file
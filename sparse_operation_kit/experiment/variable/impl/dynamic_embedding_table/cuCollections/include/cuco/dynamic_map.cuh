@@ -128,6 +128,78 @@ class dynamic_map {
 
   void eXport(key_type *keys, element_type *values, size_t num_keys, cudaStream_t stream = 0);
 
+  /**
+   * @brief Exports the entries in the slots [`slot_begin`, `slot_begin + num_slots`) of the map,
+   * numbering the slots of all the submaps one after another.
+   *
+   * @param keys The keys of at most `num_slots` entries
+   * @param values The values of at most `num_slots` entries
+   * @return The number of entries exported, after synchronizing the stream
+   */
+  size_t export_slots(size_t slot_begin, size_t num_slots, key_type *keys, element_type *values,
+                      cudaStream_t stream = 0);
+
+  /**
+   * @brief Gets the total number of slots of all the submaps.
+   */
+  size_t get_num_slots() const noexcept {
+    size_t num_slots = 0;
+    for (auto &submap : submaps_) {
+      num_slots += submap->get_capacity();
+    }
+    return num_slots;
+  }
+
+  /**
+   * @brief The lookup of `num_keys` keys in one map, as one of the tasks of `group_lookup`.
+   */
+  struct lookup_task {
+    key_type const *keys;
+    element_type **values;
+    size_t num_keys;
+    view_type *submap_views;
+    mutable_view_type *submap_mutable_views;
+    atomic_ctr_type *occupied_size;
+    atomic_ctr_type *reclaimed_size;
+    uint32_t insert_idx;
+    uint32_t num_submaps;
+    uint32_t block_offset;  ///< The first block of the `group_lookup` kernel for this task
+  };
+
+  /**
+   * @brief Grows the map for `num_keys` more keys and gets the task looking them up.
+   *
+   * Unlike `lookup`, all the missing keys are inserted into one submap.
+   *
+   * @return false if no submap can hold all the keys, then `lookup` should be used
+   */
+  bool get_lookup_task(key_type const *keys, element_type **values, size_t num_keys,
+                       lookup_task *task, cudaStream_t stream = 0);
+
+  /**
+   * @brief Copies the sizes updated by `group_lookup` to the host. The stream must be
+   * synchronized before calling `get_size`.
+   */
+  void copy_size_async(cudaStream_t stream = 0);
+
+  /**
+   * @brief Looks up the tasks of several maps in one kernel, the `block_offset` of the
+   * tasks must be set in the order of the tasks before copying them to the device.
+   *
+   * @param tasks The tasks in device memory
+   * @param num_blocks The total number of blocks of all the tasks
+   */
+  template <typename Hash = cuco::detail::MurmurHash3_32<key_type>>
+  static void group_lookup(lookup_task const *tasks, size_t num_tasks, uint32_t num_blocks,
+                           cudaStream_t stream = 0, Hash hash = Hash{});
+
+  /**
+   * @brief Gets the number of blocks `group_lookup` needs for `num_keys` keys.
+   */
+  static uint32_t get_lookup_num_blocks(size_t num_keys) {
+    return (lookup_tile_size * num_keys + lookup_block_size - 1) / lookup_block_size;
+  }
+
   /**
    * @brief Gets the current number of elements in the map
    *
@@ -158,6 +230,8 @@ class dynamic_map {
 
  private:
   static constexpr size_t max_num_submaps = 128;
+  static constexpr uint32_t lookup_block_size = 128;
+  static constexpr uint32_t lookup_tile_size = 4;
   const float max_load_factor_{};   ///< Max load factor before capacity growth
   const size_t min_insert_size_{};  ///< min remaining capacity of submap for insert
   const uint32_t dimension_{};
@@ -14,9 +14,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <random>
 
 #include "common/check.h"
+#include "variable/impl/chunked_transfer.h"
 #include "variable/impl/hkv_variable.h"
 
 namespace sok {
@@ -117,6 +119,21 @@ __global__ void generate_normal_kernel(curandState* state, T** result, bool* d_f
   state[GlobalThreadId()] = localState;
 }
 
+__global__ static void count_found_kernel(const bool* found, size_t n, bool expected,
+                                          unsigned long long* counter) {
+  size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  int count = __syncthreads_count(i < n && found[i] == expected);
+  if (threadIdx.x == 0 && count > 0) {
+    atomicAdd(counter, static_cast<unsigned long long>(count));
+  }
+}
+
+__global__ static void fill_scores_kernel(uint64_t* scores, uint64_t score, size_t n) {
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x) {
+    scores[i] = score;
+  }
+}
+
 static void set_curand_states(curandState** states, cudaStream_t stream = 0) {
   int device;
   CUDACHECK(cudaGetDevice(&device));
@@ -137,13 +154,13 @@ static void set_curand_states(curandState** states, cudaStream_t stream = 0) {
 
 static void parse_evict_strategy(const std::string& evict_strategy,
                                  nv::merlin::EvictStrategy& strategy) {
-  if (evict_strategy == "kLru") {
+  if (evict_strategy == "kLru" || evict_strategy == "lru") {
     strategy = nv::merlin::EvictStrategy::kLru;
-    return;
-  } else if (evict_strategy == "kCustomized") {
+  } else if (evict_strategy == "kCustomized" || evict_strategy == "customized") {
     strategy = nv::merlin::EvictStrategy::kCustomized;
   } else {
-    throw std::runtime_error("Unrecognized evict_strategy {" + evict_strategy + "}");
+    throw std::runtime_error("Unrecognized evict_strategy {" + evict_strategy +
+                             "}, it should be one of {kLru, kCustomized}");
   }
 }
 template <typename KeyType, typename ValueType>
@@ -179,6 +196,9 @@ HKVVariable<KeyType, ValueType>::HKVVariable(int64_t dimension, int64_t initial_
   hkv_table_option_.evict_strategy = hkv_evict_strategy;
 
   hkv_table_->init(hkv_table_option_);
+
+  CUDACHECK(cudaMalloc(&d_counters_, 2 * sizeof(unsigned long long)));
+  CUDACHECK(cudaMemsetAsync(d_counters_, 0, 2 * sizeof(unsigned long long), stream));
 }
 
 template <typename KeyType, typename ValueType>
@@ -186,6 +206,58 @@ HKVVariable<KeyType, ValueType>::~HKVVariable() {
   if (curand_states_) {
     CUDACHECK(cudaFree(curand_states_));
   }
+  CUDACHECK(cudaFree(d_found_));
+  CUDACHECK(cudaFree(d_scores_));
+  CUDACHECK(cudaFree(d_counters_));
+}
+
+template <typename KeyType, typename ValueType>
+void HKVVariable<KeyType, ValueType>::reserve(size_t num_keys) {
+  if (num_keys <= buffer_size_) {
+    return;
+  }
+  // cudaFree synchronizes the device, so grow geometrically to make it rare.
+  buffer_size_ = std::max(num_keys, 2 * buffer_size_);
+  CUDACHECK(cudaFree(d_found_));
+  CUDACHECK(cudaMalloc(&d_found_, buffer_size_ * sizeof(bool)));
+  if (hkv_table_option_.evict_strategy == nv::merlin::EvictStrategy::kCustomized) {
+    CUDACHECK(cudaFree(d_scores_));
+    CUDACHECK(cudaMalloc(&d_scores_, buffer_size_ * sizeof(uint64_t)));
+  }
+}
+
+template <typename KeyType, typename ValueType>
+uint64_t* HKVVariable<KeyType, ValueType>::scores(size_t num_keys, cudaStream_t stream) {
+  if (hkv_table_option_.evict_strategy != nv::merlin::EvictStrategy::kCustomized ||
+      num_keys == 0) {
+    return nullptr;
+  }
+  fill_scores_kernel<<<(num_keys - 1) / 1024 + 1, 1024, 0, stream>>>(d_scores_, score_, num_keys);
+  return d_scores_;
+}
+
+template <typename KeyType, typename ValueType>
+void HKVVariable<KeyType, ValueType>::set_score(uint64_t score) {
+  std::lock_guard<std::mutex> lock(mu_);
+  score_ = score;
+}
+
+template <typename KeyType, typename ValueType>
+void HKVVariable<KeyType, ValueType>::statistics(int64_t* num_lookups, int64_t* num_hits,
+                                                 int64_t* num_evicted, cudaStream_t stream) {
+  std::lock_guard<std::mutex> lock(mu_);
+  unsigned long long h_counters[2] = {0, 0};
+  CUDACHECK(cudaMemcpyAsync(h_counters, d_counters_, 2 * sizeof(unsigned long long),
+                            cudaMemcpyDeviceToHost, stream));
+  int64_t size = static_cast<int64_t>(hkv_table_->size(stream));
+  CUDACHECK(cudaStreamSynchronize(stream));
+
+  *num_lookups = num_lookups_;
+  *num_hits = static_cast<int64_t>(h_counters[0]);
+  // Each missed key was inserted, so the ones not in the table anymore have been evicted.
+  // The keys inserted by the dense lookup are not counted, which may make this an underestimate.
+  int64_t num_inserted = num_lookups_ - *num_hits + static_cast<int64_t>(h_counters[1]);
+  *num_evicted = std::max(num_inserted - size, static_cast<int64_t>(0));
 }
 
 template <typename KeyType, typename ValueType>
@@ -202,25 +274,20 @@ template <typename KeyType, typename ValueType>
 void HKVVariable<KeyType, ValueType>::eXport(KeyType* keys, ValueType* values,
                                              cudaStream_t stream) {
   int64_t num_keys = rows();
-  int64_t dim = cols();
-
-  // `keys` and `values` are pointers of host memory
-  KeyType* d_keys;
-  CUDACHECK(cudaMalloc(&d_keys, sizeof(KeyType) * num_keys));
-  ValueType* d_values;
-  CUDACHECK(cudaMalloc(&d_values, sizeof(ValueType) * num_keys * dim));
-
-  hkv_table_->export_batch(num_keys, 0, d_keys, d_values, nullptr, stream);  // Meta missing
 
-  // clang-format off
-  CUDACHECK(cudaMemcpyAsync(keys, d_keys, sizeof(KeyType) * num_keys,
-                            cudaMemcpyDeviceToHost, stream));
-  CUDACHECK(cudaMemcpyAsync(values, d_values, sizeof(ValueType) * num_keys * dim,
-                            cudaMemcpyDeviceToHost, stream));
-  // clang-format on
-  CUDACHECK(cudaStreamSynchronize(stream));
-  CUDACHECK(cudaFree(d_keys));
-  CUDACHECK(cudaFree(d_values));
+  // `keys` and `values` are pointers of host memory, which are filled chunk by chunk of slots.
+  // Note that export_batch walks the slots of the table, so its range is the capacity.
+  ChunkedTransfer<KeyType, ValueType> transfer(cols());
+  size_t chunk_size = transfer.chunk_size();
+  size_t capacity = hkv_table_->capacity();
+  transfer.eXport(
+      (capacity + chunk_size - 1) / chunk_size,
+      [&](size_t i, KeyType* d_keys, ValueType* d_values, cudaStream_t stream) {
+        size_t n = std::min(chunk_size, capacity - i * chunk_size);
+        return static_cast<size_t>(hkv_table_->export_batch(n, i * chunk_size, d_keys, d_values,
+                                                            nullptr, stream));  // Meta missing
+      },
+      keys, values, num_keys, stream);
 }
 
 template <typename KeyType, typename ValueType>
@@ -228,31 +295,29 @@ void HKVVariable<KeyType, ValueType>::assign(const KeyType* keys, const ValueTyp
                                              size_t num_keys, cudaStream_t stream) {
   int64_t dim = cols();
 
-  // `keys` and `values` are pointers of host memory
-  KeyType* d_keys;
-  CUDACHECK(cudaMalloc(&d_keys, sizeof(KeyType) * num_keys));
-  ValueType* d_values;
-  CUDACHECK(cudaMalloc(&d_values, sizeof(ValueType) * num_keys * dim));
-
-  // clang-format off
-  CUDACHECK(cudaMemcpyAsync(d_keys, keys, sizeof(KeyType) * num_keys,
-                            cudaMemcpyHostToDevice, stream));
-
-  CUDACHECK(cudaMemcpyAsync(d_values, values, sizeof(ValueType) * num_keys * dim,
-                            cudaMemcpyHostToDevice, stream));
-
-  hkv_table_->insert_or_assign(num_keys, d_keys, d_values, nullptr, stream);
-
-  CUDACHECK(cudaStreamSynchronize(stream));
+  // `keys` and `values` are pointers of host memory, which are copied chunk by chunk
+  ChunkedTransfer<KeyType, ValueType> transfer(dim);
+  std::lock_guard<std::mutex> lock(mu_);
+  reserve(transfer.chunk_size());
+  // Count the keys that are new to the table, `d_old_values` is just a scratch buffer.
+  ValueType* d_old_values;
+  CUDACHECK(cudaMalloc(&d_old_values, sizeof(ValueType) * transfer.chunk_size() * dim));
+  transfer.assign(
+      keys, values, num_keys,
+      [&](const KeyType* d_keys, const ValueType* d_values, size_t n, cudaStream_t stream) {
+        CUDACHECK(cudaMemsetAsync(d_found_, 0, n * sizeof(bool), stream));
+        hkv_table_->find(n, d_keys, d_old_values, d_found_, nullptr, stream);
+        count_found_kernel<<<(n - 1) / 1024 + 1, 1024, 0, stream>>>(d_found_, n, false,
+                                                                     d_counters_ + 1);
+        hkv_table_->insert_or_assign(n, d_keys, d_values, scores(n, stream), stream);
+      },
+      stream);
+  CUDACHECK(cudaFree(d_old_values));
 }
 
 template <typename KeyType, typename ValueType>
 void HKVVariable<KeyType, ValueType>::lookup(const KeyType* keys, ValueType* values,
                                              size_t num_keys, cudaStream_t stream) {
-  bool* d_found;
-  CUDACHECK(cudaMalloc(&d_found, num_keys * sizeof(bool)));
-  CUDACHECK(cudaMemset(d_found, 0, num_keys * sizeof(bool)));
-
   int64_t dim = cols();
 
   if (initializer_ == "normal" || initializer_ == "random") {
@@ -271,17 +336,24 @@ void HKVVariable<KeyType, ValueType>::lookup(const KeyType* keys, ValueType* val
     }
   }
 
-  hkv_table_->find_or_insert(num_keys, keys, values, nullptr, stream);
-  CUDACHECK(cudaFree(d_found));
+  std::lock_guard<std::mutex> lock(mu_);
+  reserve(num_keys);
+  hkv_table_->find_or_insert(num_keys, keys, values, scores(num_keys, stream), stream);
 }
 
 template <typename KeyType, typename ValueType>
 void HKVVariable<KeyType, ValueType>::lookup(const KeyType* keys, ValueType** values,
                                              size_t num_keys, cudaStream_t stream) {
-  bool* d_found;
-  CUDACHECK(cudaMalloc(&d_found, num_keys * sizeof(bool)));
-  CUDACHECK(cudaMemset(d_found, 0, num_keys * sizeof(bool)));
-  hkv_table_->find_or_insert(num_keys, keys, values, d_found, nullptr, stream);
+  std::lock_guard<std::mutex> lock(mu_);
+  reserve(num_keys);
+  bool* d_found = d_found_;
+  CUDACHECK(cudaMemsetAsync(d_found, 0, num_keys * sizeof(bool), stream));
+  hkv_table_->find_or_insert(num_keys, keys, values, d_found, scores(num_keys, stream), stream);
+  if (num_keys > 0) {
+    count_found_kernel<<<(num_keys - 1) / 1024 + 1, 1024, 0, stream>>>(d_found, num_keys, true,
+                                                                        d_counters_);
+  }
+  num_lookups_ += num_keys;
   //CUDACHECK(cudaStreamSynchronize(stream));
 
   int64_t dim = cols();
@@ -302,24 +374,23 @@ void HKVVariable<KeyType, ValueType>::lookup(const KeyType* keys, ValueType** va
   }
 
   //CUDACHECK(cudaStreamSynchronize(stream));
-  CUDACHECK(cudaFree(d_found));
 }
 
 template <typename KeyType, typename ValueType>
 void HKVVariable<KeyType, ValueType>::scatter_add(const KeyType* keys, const ValueType* values,
                                                   size_t num_keys, cudaStream_t stream) {
   int64_t dim = cols();
-  bool* d_found;
-  CUDACHECK(cudaMalloc(&d_found, num_keys * sizeof(bool)));
-  CUDACHECK(cudaMemset(d_found, 0, num_keys * sizeof(bool)));
-  
+  std::lock_guard<std::mutex> lock(mu_);
+  reserve(num_keys);
+  bool* d_found = d_found_;
+  CUDACHECK(cudaMemsetAsync(d_found, 0, num_keys * sizeof(bool), stream));
+
   ValueType* d_values;
   CUDACHECK(cudaMalloc(&d_values, sizeof(ValueType) * num_keys * dim));
 
   hkv_table_->find(num_keys, keys, d_values, d_found, nullptr, stream);
-  hkv_table_->accum_or_assign(num_keys, keys, values, d_found, nullptr, stream);
+  hkv_table_->accum_or_assign(num_keys, keys, values, d_found, scores(num_keys, stream), stream);
 
-  CUDACHECK(cudaFree(d_found));
   CUDACHECK(cudaFree(d_values));
 }
 
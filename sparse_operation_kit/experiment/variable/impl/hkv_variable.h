@@ -19,6 +19,7 @@
 
 #include <curand_kernel.h>
 
+#include <mutex>
 #include <string>
 
 #include "merlin_hashtable.cuh"
@@ -52,7 +53,16 @@ class HKVVariable : public VariableBase<KeyType, ValueType> {
   void scatter_update(const KeyType *keys, const ValueType *values, size_t num_keys,
                       cudaStream_t stream = 0) override;
 
+  void set_score(uint64_t score) override;
+  void statistics(int64_t *num_lookups, int64_t *num_hits, int64_t *num_evicted,
+                  cudaStream_t stream = 0) override;
+
  private:
+  // Grows the per-key buffers to hold at least num_keys keys.
+  void reserve(size_t num_keys);
+  // Returns the scores of num_keys keys for the customized eviction, nullptr otherwise.
+  uint64_t *scores(size_t num_keys, cudaStream_t stream);
+
   using HKVTable = nv::merlin::HashTable<KeyType, ValueType, uint64_t>;
   std::unique_ptr<HKVTable> hkv_table_ = std::make_unique<HKVTable>();
   nv::merlin::HashTableOptions hkv_table_option_;
@@ -62,6 +72,17 @@ class HKVVariable : public VariableBase<KeyType, ValueType> {
   std::string initializer_;
   curandState *curand_states_;
   cudaStream_t stream_;
+
+  // Per-key buffers reused across the calls, guarded by mu_ together with the counters.
+  std::mutex mu_;
+  size_t buffer_size_ = 0;
+  bool *d_found_ = nullptr;
+  uint64_t *d_scores_ = nullptr;
+  uint64_t score_ = 0;
+
+  int64_t num_lookups_ = 0;
+  // The keys found by lookups, and the keys inserted by assign().
+  unsigned long long *d_counters_ = nullptr;
 };
 
 }  // namespace sok
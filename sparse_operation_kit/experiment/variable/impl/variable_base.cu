@@ -55,7 +55,7 @@ std::shared_ptr<VariableBase<KeyType, ValueType>> VariableFactory::create(
     size_t max_bucket_size = 128;  ///< The length of each bucket.
     auto max_bucket_size_it = config_json.find("max_bucket_size");
     if (max_bucket_size_it != config_json.end()) {
-      max_bucket_size = max_bucket_size_it->get<float>();
+      max_bucket_size = max_bucket_size_it->get<size_t>();
     }
     int block_size = 1024;  ///< The default block size for CUDA kernels.
     auto block_size_it = config_json.find("block_size");
@@ -65,7 +65,7 @@ std::shared_ptr<VariableBase<KeyType, ValueType>> VariableFactory::create(
     int device_id = -1;  ///< The ID of device.
     auto device_id_it = config_json.find("device_id");
     if (device_id_it != config_json.end()) {
-      device_id = block_size_it->get<int>();
+      device_id = device_id_it->get<int>();
     }
     bool io_by_cpu = false;  ///< The flag indicating if the CPU handles IO.
     auto io_by_cpu_it = config_json.find("io_by_cpu");
@@ -75,7 +75,7 @@ std::shared_ptr<VariableBase<KeyType, ValueType>> VariableFactory::create(
     std::string evict_strategy = "kLru";
     auto evict_strategy_it = config_json.find("evict_strategy");
     if (evict_strategy_it != config_json.end()) {
-      evict_strategy = io_by_cpu_it->get<std::string>();
+      evict_strategy = evict_strategy_it->get<std::string>();
     }
     return std::make_shared<HKVVariable<KeyType, ValueType>>(
         cols, init_capacity, initializer, max_capacity, max_hbm_for_vectors, max_bucket_size,
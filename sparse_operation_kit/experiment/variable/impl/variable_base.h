@@ -21,9 +21,22 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace sok {
 
+template <typename KeyType, typename ValueType>
+class VariableBase;
+
+// The lookup of num_keys keys in var, as one of the tasks of VariableBase::group_lookup.
+template <typename KeyType, typename ValueType>
+struct GroupLookupTask {
+  VariableBase<KeyType, ValueType> *var;
+  const KeyType *keys;
+  ValueType **values;
+  size_t num_keys;
+};
+
 template <typename KeyType, typename ValueType>
 class VariableBase {
  public:
@@ -43,6 +56,29 @@ class VariableBase {
                            cudaStream_t stream = 0) = 0;
   virtual void scatter_update(const KeyType *keys, const ValueType *values, size_t num_keys,
                               cudaStream_t stream = 0) = 0;
+
+  // Does the lookups of several variables, which can be batched into one kernel by the
+  // variables of the same type. By default each variable looks up its keys separately.
+  virtual void group_lookup(const std::vector<GroupLookupTask<KeyType, ValueType>> &tasks,
+                            cudaStream_t stream = 0) {
+    for (auto &task : tasks) {
+      task.var->lookup(task.keys, task.values, task.num_keys, stream);
+    }
+  }
+
+  // The methods below only make sense for the variables that can evict keys, the
+  // others keep the defaults.
+
+  // Sets the score given to the keys touched from now on, used by the customized eviction.
+  virtual void set_score(uint64_t score) {}
+  // Gets the number of keys looked up, the number of them found in the table, and the
+  // number of keys inserted so far that have been evicted since.
+  virtual void statistics(int64_t *num_lookups, int64_t *num_hits, int64_t *num_evicted,
+                          cudaStream_t stream = 0) {
+    *num_lookups = 0;
+    *num_hits = 0;
+    *num_evicted = 0;
+  }
 };
 
 class VariableFactory {
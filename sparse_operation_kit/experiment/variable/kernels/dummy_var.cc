@@ -95,6 +95,18 @@ void DummyVar<KeyType, ValueType>::ScatterUpdate(const void* keys, const void* v
                        num_keys, stream);
 }
 
+template <typename KeyType, typename ValueType>
+void DummyVar<KeyType, ValueType>::SetScore(uint64_t score) {
+  check_var();
+  var_->set_score(score);
+}
+
+template <typename KeyType, typename ValueType>
+void DummyVar<KeyType, ValueType>::Statistics(int64_t* statistics, cudaStream_t stream) {
+  check_var();
+  var_->statistics(&statistics[0], &statistics[1], &statistics[2], stream);
+}
+
 // explicit instance the template
 template class DummyVar<int32_t, float>;
 template class DummyVar<int64_t, float>;
@@ -59,6 +59,10 @@ class DummyVar : public ResourceBase {
   void ScatterAdd(const void *keys, const void *values, size_t num_keys, cudaStream_t stream);
   void ScatterUpdate(const void *keys, const void *values, size_t num_keys, cudaStream_t stream);
 
+  void SetScore(uint64_t score);
+  // Writes {num_lookups, num_hits, num_evicted} to statistics, see VariableBase::statistics.
+  void Statistics(int64_t *statistics, cudaStream_t stream);
+
   inline std::shared_ptr<sok::VariableBase<KeyType, ValueType>> get_var() { return var_; }
 
  private:
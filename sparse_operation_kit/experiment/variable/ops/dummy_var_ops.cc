@@ -113,4 +113,25 @@ REGISTER_OP("DummyVarScatterUpdate")
     .Attr("dtype: {float32}")
     .SetShapeFn(DummyVarScatterShapeFn);
 
+REGISTER_OP("DummyVarSetScore")
+    .Input("resource: resource")
+    .Input("score: int64")
+    .Attr("key_type: {int32, int64}")
+    .Attr("dtype: {float32}")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 0, &unused));
+      return sok_tsl_status();
+    });
+
+REGISTER_OP("DummyVarStatistics")
+    .Input("resource: resource")
+    .Output("statistics: int64")
+    .Attr("key_type: {int32, int64}")
+    .Attr("dtype: {float32}")
+    .SetShapeFn([](InferenceContext* c) {
+      c->set_output(0, c->Vector(3));
+      return sok_tsl_status();
+    });
+
 }  // namespace tensorflow
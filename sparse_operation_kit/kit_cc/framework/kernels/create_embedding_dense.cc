@@ -43,6 +43,12 @@ class CreateEmbeddingDenseOp : public OpKernel {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("compute_dtype", &compute_dtype_));
     OP_REQUIRES(ctx, compute_dtype_ == DT_FLOAT || compute_dtype_ == DT_HALF,
                 errors::Aborted("compute dtype can only be either float32 or float16."));
+    std::vector<int64> key_range_bounds;
+    std::vector<int32> key_range_gpus;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("key_range_bounds", &key_range_bounds));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("key_range_gpus", &key_range_gpus));
+    key_range_bounds_.assign(key_range_bounds.begin(), key_range_bounds.end());
+    key_range_gpus_.assign(key_range_gpus.begin(), key_range_gpus.end());
   }
 
   void Compute(OpKernelContext* ctx) override {
@@ -62,7 +68,8 @@ class CreateEmbeddingDenseOp : public OpKernel {
           SparseOperationKit::Facade::instance()->create_embedding_dense(
               embedding_variable, input_dispatcher_, input_dispatcher_subsequent_ops_,
               embedding_lookuper_, output_dispatcher_, output_dispatcher_subsequent_ops_, slot_num_,
-              nnz_per_slot_, compute_dtype_, &emb_layer_handle_);
+              nnz_per_slot_, compute_dtype_, key_range_bounds_, key_range_gpus_,
+              &emb_layer_handle_);
         } catch (const std::exception& error) {
           ctx->SetStatus(errors::Aborted(error.what()));
           return;
@@ -85,6 +92,8 @@ class CreateEmbeddingDenseOp : public OpKernel {
   std::string layer_handle_name_;
   Tensor emb_layer_handle_;
   DataType compute_dtype_;
+  std::vector<int64_t> key_range_bounds_;
+  std::vector<int32_t> key_range_gpus_;
   std::atomic<bool> created_{false};
   mutex mutex_;
 };
@@ -34,6 +34,8 @@ REGISTER_OP("CreateEmbeddingDense")
     .Attr("nnz_per_slot: int >= 1 = 1")
     .Attr("layer_handle_name: string")
     .Attr("compute_dtype: {float32, float16}")
+    .Attr("key_range_bounds: list(int) = []")
+    .Attr("key_range_gpus: list(int) = []")
     .SetShapeFn([](InferenceContext* ctx) {
       ShapeHandle output_shape = ctx->Scalar();
       ctx->set_output(0, output_shape);
@@ -43,4 +45,7 @@ REGISTER_OP("CreateEmbeddingDense")
         This operation is used to create embedding layer that will not 
         do reduction intra slots, which means embedding vectors will
         be concatenated.
+        If key_range_bounds is not empty, keys in [key_range_bounds[i],
+        key_range_bounds[i + 1]) are dispatched to the GPU key_range_gpus[i],
+        while the other keys are dispatched to the GPU key % gpu_num.
     )doc");
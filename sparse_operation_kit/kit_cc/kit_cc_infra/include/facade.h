@@ -101,6 +101,7 @@ class Facade final {
       const std::string embedding_executor, const std::string output_dispatcher,
       const std::vector<std::string>& output_dispatcher_subsequent_ops, const size_t slot_num,
       const size_t nnz_per_slot, const tensorflow::DataType compute_dtype,
+      const std::vector<int64_t>& key_range_bounds, const std::vector<int32_t>& key_range_gpus,
       tensorflow::Tensor* emb_handle);
 
   void create_optimizer(const std::string optimizer_type, tensorflow::Tensor* optimizer_handle,
@@ -57,6 +57,12 @@ class ParamInterface : public States {
   virtual std::string get_var_name() const;
   virtual DataType dtype() const;
   virtual DataType key_dtype() const;
+  // Keys in [key_range_bounds[i], key_range_bounds[i + 1]) are placed on the global GPU
+  // key_range_gpus[i], and the other keys are placed on key % global_gpu_count.
+  virtual void set_key_ranges(const std::vector<int64_t>& key_range_bounds,
+                              const std::vector<int32_t>& key_range_gpus);
+  virtual const std::vector<int64_t>& get_key_range_bounds() const;
+  virtual const std::vector<int32_t>& get_key_range_gpus() const;
 
   virtual void set_user(std::shared_ptr<EmbeddingLayer>& embedding);
   virtual void let_user_dump_to_file(const std::string filepath);
@@ -71,6 +77,8 @@ class ParamInterface : public States {
   const std::string var_name_;
   DataType dtype_;
   DataType key_dtype_;
+  std::vector<int64_t> key_range_bounds_;
+  std::vector<int32_t> key_range_gpus_;
 };
 
 struct TypeIdentity {
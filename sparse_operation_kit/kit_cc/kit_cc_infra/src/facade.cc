@@ -191,14 +191,23 @@ void Facade::create_embedding_dense(
     const std::string embedding_executor, const std::string output_dispatcher,
     const std::vector<std::string>& output_dispatcher_subsequent_ops, const size_t slot_num,
     const size_t nnz_per_slot, const tensorflow::DataType compute_dtype,
+    const std::vector<int64_t>& key_range_bounds, const std::vector<int32_t>& key_range_gpus,
     tensorflow::Tensor* emb_handle) {
   // check input validness
   if (slot_num <= 0) throw std::runtime_error(ErrorBase + "slot_num must be >= 1.");
   if (nnz_per_slot <= 0) throw std::runtime_error(ErrorBase + "nnz_per_slot must be >= 1.");
+  const size_t global_gpu_count = resources_mgr_->get_global_gpu_count();
+  for (const int32_t gpu : key_range_gpus) {
+    if (gpu < 0 || static_cast<size_t>(gpu) >= global_gpu_count)
+      throw std::runtime_error(ErrorBase + "key_range_gpus must be in the range of [0, " +
+                               std::to_string(global_gpu_count) + ").");
+  }
 
   // create embedding layer
   std::shared_ptr<ParamInterface> param;
   variable->get_param(param);
+  // the dispatcher and the lookuper read the key ranges from param when they are created
+  param->set_key_ranges(key_range_bounds, key_range_gpus);
 
   std::shared_ptr<EmbeddingLayer> embedding;
   embedding_mgr_->create_embedding(param, input_dispatcher, input_dispatcher_subsequent_ops,
@@ -67,6 +67,31 @@ DataType ParamInterface::dtype() const { return dtype_; }
 
 DataType ParamInterface::key_dtype() const { return key_dtype_; }
 
+void ParamInterface::set_key_ranges(const std::vector<int64_t>& key_range_bounds,
+                                    const std::vector<int32_t>& key_range_gpus) {
+  if (key_range_bounds.empty() && key_range_gpus.empty()) return;
+  if (key_range_bounds.size() != key_range_gpus.size() + 1)
+    throw std::runtime_error(ErrorBase +
+                             "key_range_bounds must have one more item than key_range_gpus.");
+  for (size_t i = 1; i < key_range_bounds.size(); i++) {
+    if (key_range_bounds[i - 1] >= key_range_bounds[i])
+      throw std::runtime_error(ErrorBase + "key_range_bounds must be strictly increasing.");
+  }
+  // the keys must be placed in the same way by all the embedding layers using this param
+  if (!key_range_bounds_.empty() &&
+      (key_range_bounds_ != key_range_bounds || key_range_gpus_ != key_range_gpus))
+    throw std::runtime_error(ErrorBase + get_var_name() +
+                             " has already been given different key ranges.");
+  key_range_bounds_ = key_range_bounds;
+  key_range_gpus_ = key_range_gpus;
+}
+
+const std::vector<int64_t>& ParamInterface::get_key_range_bounds() const {
+  return key_range_bounds_;
+}
+
+const std::vector<int32_t>& ParamInterface::get_key_range_gpus() const { return key_range_gpus_; }
+
 void ParamInterface::set_user(std::shared_ptr<EmbeddingLayer>& embedding) {
   // It is not compulsory for the subclass to override this function.
   throw std::runtime_error(ErrorBase + "Not implemented.");
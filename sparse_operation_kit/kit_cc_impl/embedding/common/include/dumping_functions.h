@@ -27,7 +27,7 @@ namespace SparseOperationKit {
 void get_hash_value(size_t count, size_t embedding_vec_size, const size_t *value_index,
                     const float *embedding_table, float *value_retrieved, cudaStream_t stream);
 
-// distribute keys to GPU based on key % GPU_NUM
+// distribute keys to GPU based on key % GPU_NUM or the key ranges of param
 template <typename KeyType>
 void save_params_helper(const std::shared_ptr<ParamInterface> &param,
                         const std::shared_ptr<ResourcesManager> &resource_mgr,
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef KEY_RANGES_H
+#define KEY_RANGES_H
+
+#include <cuda_runtime_api.h>
+
+#include <cstdint>
+
+namespace SparseOperationKit {
+
+// Returns the index i of the range [bounds[i], bounds[i + 1]) containing key, or num_ranges if
+// key is not in any range. bounds must be strictly increasing and have num_ranges + 1 items.
+template <typename KeyType>
+__host__ __device__ inline uint32_t find_key_range(const KeyType key, const int64_t *bounds,
+                                                   const uint32_t num_ranges) {
+  const int64_t value = static_cast<int64_t>(key);
+  if (num_ranges == 0 || value < bounds[0] || value >= bounds[num_ranges]) return num_ranges;
+  uint32_t lower = 0;
+  uint32_t upper = num_ranges;
+  while (upper - lower > 1) {
+    const uint32_t middle = (lower + upper) / 2;
+    if (bounds[middle] <= value) {
+      lower = middle;
+    } else {
+      upper = middle;
+    }
+  }
+  return lower;
+}
+
+}  // namespace SparseOperationKit
+
+#endif  // KEY_RANGES_H
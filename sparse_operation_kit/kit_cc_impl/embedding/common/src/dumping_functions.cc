@@ -20,6 +20,7 @@
 
 #include "common.h"
 #include "common/include/forward_functions.h"
+#include "common/include/key_ranges.h"
 
 namespace SparseOperationKit {
 
@@ -303,6 +304,14 @@ void restore_params_helper(std::shared_ptr<ParamInterface> &param,
 
   const KeyType *key_ptr = keys->GetPtrWithType<KeyType>();
   const float *embedding_ptr = embedding_values->GetPtrWithType<float>();
+  const int64_t *key_range_bounds = param->get_key_range_bounds().data();
+  const int32_t *key_range_gpus = param->get_key_range_gpus().data();
+  const uint32_t num_key_ranges = param->get_key_range_gpus().size();
+  auto get_global_gpu_id = [&](const KeyType key) -> size_t {
+    const uint32_t range_id = find_key_range(key, key_range_bounds, num_key_ranges);
+    return range_id < num_key_ranges ? key_range_gpus[range_id]
+                                     : key % resource_mgr->get_global_gpu_count();
+  };
 
   // step 1: allocate temporary spaces
   const size_t worker_id = resource_mgr->get_worker_id();
@@ -356,7 +365,7 @@ void restore_params_helper(std::shared_ptr<ParamInterface> &param,
     float *value_dst_buf;
     for (size_t k = 0; k < chunk_size; k++) {
       const KeyType key = key_ptr[i * chunk_size + k];
-      const size_t global_gpu_id = key % resource_mgr->get_global_gpu_count();
+      const size_t global_gpu_id = get_global_gpu_id(key);
       const size_t local_gpu_id = resource_mgr->cal_local_id_from_global_id(global_gpu_id);
       const size_t dst_worker = resource_mgr->cal_worker_id_from_global_id(global_gpu_id);
       if (dst_worker == worker_id) {  // it belongs to this worker
@@ -430,7 +439,7 @@ void restore_params_helper(std::shared_ptr<ParamInterface> &param,
   float *value_dst_buf;
   for (size_t i = 0; i < remain_loop_num; i++) {
     const KeyType key = key_ptr[loop_num * chunk_size + i];
-    const size_t global_gpu_id = key % resource_mgr->get_global_gpu_count();
+    const size_t global_gpu_id = get_global_gpu_id(key);
     const size_t local_gpu_id = resource_mgr->cal_local_id_from_global_id(global_gpu_id);
     const size_t dst_worker = resource_mgr->cal_worker_id_from_global_id(global_gpu_id);
 
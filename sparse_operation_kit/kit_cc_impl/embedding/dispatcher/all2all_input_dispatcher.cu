@@ -15,6 +15,7 @@
  */
 
 #include "common/include/forward_functions.h"
+#include "common/include/key_ranges.h"
 #include "operation/operation_interface.h"
 
 namespace SparseOperationKit {
@@ -30,11 +31,14 @@ struct IdenticalHash {
   }
 };
 
-/*It will dispatcher keys based on key % GPU_NUM */
+/*It will dispatcher keys based on key % GPU_NUM, unless the key is in one of the key ranges,
+ * which are placed on range_gpus. */
 template <typename KeyType, typename Hasher>
 __global__ void selectKernel(KeyType const *input_keys, size_t num_keys, KeyType *output_keys,
                              uint32_t *output_indices, size_t chunks, size_t max_chunk_size,
-                             uint32_t *chunk_sizes, const size_t ITEMS_PER_GPU_PER_WARP) {
+                             uint32_t *chunk_sizes, const size_t ITEMS_PER_GPU_PER_WARP,
+                             const int64_t *range_bounds, const int32_t *range_gpus,
+                             const uint32_t num_ranges) {
   // set indices
   const size_t thread_cnt = blockDim.x * blockDim.y;
   const size_t stride_size = thread_cnt * gridDim.x;
@@ -69,7 +73,8 @@ __global__ void selectKernel(KeyType const *input_keys, size_t num_keys, KeyType
     uint32_t is_full = 0;
     if (idx < num_keys) {
       key = input_keys[idx];
-      chunk_id = Hasher::compute(key) % chunks;
+      const uint32_t range_id = find_key_range(key, range_bounds, num_ranges);
+      chunk_id = range_id < num_ranges ? range_gpus[range_id] : Hasher::compute(key) % chunks;
       curr_local_idx = atomicAdd(curr_warp_cnt_smem + chunk_id, 1);
       offset = chunk_id * ITEMS_PER_GPU_PER_WARP + curr_local_idx;
       curr_warp_key_smem[offset] = key;
@@ -134,7 +139,8 @@ class All2AllInputDispatcher : public Dispatcher {
         resource_mgr_(base_context()->get_resource_mgr()),
         num_keys_per_rank_(base_context()->get_replica_batch_size() *
                            base_context()->get_slot_num() * base_context()->get_nnz_per_slot()),
-        ITEMS_PER_GPU_PER_WARP_(0) {
+        ITEMS_PER_GPU_PER_WARP_(0),
+        num_key_ranges_(base_context()->get_param()->get_key_range_gpus().size()) {
     const size_t local_gpu_count = resource_mgr_->get_local_gpu_count();
     selected_keys_buf_.reserve(local_gpu_count);
     selected_indices_buf_.reserve(local_gpu_count);
@@ -144,6 +150,9 @@ class All2AllInputDispatcher : public Dispatcher {
     h_num_exchanged_keys_.reserve(local_gpu_count);
     exchanged_keys_buf_.reserve(local_gpu_count);
     h_recv_chunk_offsets_.reserve(local_gpu_count);
+    key_range_bounds_.reserve(local_gpu_count);
+    key_range_gpus_.reserve(local_gpu_count);
+    key_ranges_uploaded_.reset(new bool[local_gpu_count]());
 
     const size_t max_smem_size = resource_mgr_->get_local_gpu(0)->get_max_smem_size_per_sm();
     const size_t global_gpu_count = resource_mgr_->get_global_gpu_count();
@@ -205,6 +214,14 @@ class All2AllInputDispatcher : public Dispatcher {
         host_buffer->reserve({global_gpu_count + 1}, &tensor);
         h_recv_chunk_offsets_.push_back(tensor);
       }
+      if (num_key_ranges_ > 0) {
+        Tensor2<int64_t> bounds_tensor;
+        buffer->reserve({num_key_ranges_ + 1}, &bounds_tensor);
+        key_range_bounds_.push_back(bounds_tensor);
+        Tensor2<int32_t> gpus_tensor;
+        buffer->reserve({num_key_ranges_}, &gpus_tensor);
+        key_range_gpus_.push_back(gpus_tensor);
+      }
     }  // for dev_id in local_gpu_count
   }
 
@@ -222,6 +239,19 @@ class All2AllInputDispatcher : public Dispatcher {
                             local_gpu->get_stream()));
     std::memset(h_recv_chunk_offsets_[local_replica_id].get_ptr(), 0,
                 h_recv_chunk_offsets_[local_replica_id].get_size_in_bytes());
+    // the key ranges can only be copied to GPU after the buffers are allocated.
+    if (num_key_ranges_ > 0 && !key_ranges_uploaded_[local_replica_id]) {
+      const auto &param = base_context()->get_param();
+      CK_CUDA(cudaMemcpyAsync(key_range_bounds_[local_replica_id].get_ptr(),
+                              param->get_key_range_bounds().data(),
+                              key_range_bounds_[local_replica_id].get_size_in_bytes(),
+                              cudaMemcpyHostToDevice, local_gpu->get_stream()));
+      CK_CUDA(cudaMemcpyAsync(key_range_gpus_[local_replica_id].get_ptr(),
+                              param->get_key_range_gpus().data(),
+                              key_range_gpus_[local_replica_id].get_size_in_bytes(),
+                              cudaMemcpyHostToDevice, local_gpu->get_stream()));
+      key_ranges_uploaded_[local_replica_id] = true;
+    }
 
     // step 2: select keys for each GPU (rank)
     const auto &input_keys = replica_context->input("replica_values");
@@ -239,7 +269,12 @@ class All2AllInputDispatcher : public Dispatcher {
               /*output_indices=*/selected_indices_buf_[local_replica_id].get_ptr(),
               /*chunks=*/global_gpu_count, /*max_chunk_size=*/num_keys_per_rank_,
               /*chunk_sizes=*/num_selected_keys_[local_replica_id].get_ptr(),
-              /*ITEMS_PER_GPU_PER_WARP=*/ITEMS_PER_GPU_PER_WARP_);
+              /*ITEMS_PER_GPU_PER_WARP=*/ITEMS_PER_GPU_PER_WARP_,
+              /*range_bounds=*/num_key_ranges_ > 0 ? key_range_bounds_[local_replica_id].get_ptr()
+                                                   : nullptr,
+              /*range_gpus=*/num_key_ranges_ > 0 ? key_range_gpus_[local_replica_id].get_ptr()
+                                                 : nullptr,
+              /*num_ranges=*/static_cast<uint32_t>(num_key_ranges_));
       CK_CUDA(cudaGetLastError());
     }
 
@@ -304,6 +339,7 @@ class All2AllInputDispatcher : public Dispatcher {
   const std::shared_ptr<ResourcesManager> resource_mgr_;
   const size_t num_keys_per_rank_;
   size_t ITEMS_PER_GPU_PER_WARP_;
+  const size_t num_key_ranges_;
 
   // forward spaces
   Tensors2<KeyType> selected_keys_buf_;
@@ -314,6 +350,9 @@ class All2AllInputDispatcher : public Dispatcher {
   Tensors2<uint32_t> h_num_exchanged_keys_;
   Tensors2<KeyType> exchanged_keys_buf_;
   Tensors2<uint32_t> h_recv_chunk_offsets_;
+  Tensors2<int64_t> key_range_bounds_;
+  Tensors2<int32_t> key_range_gpus_;
+  std::unique_ptr<bool[]> key_ranges_uploaded_;
 };
 
 REGISTER_INPUT_DISPATCHER_BUILDER("All2AllInput", DataType::Int64, DataType::Float32,
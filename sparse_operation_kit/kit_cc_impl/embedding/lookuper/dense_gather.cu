@@ -55,6 +55,9 @@ class DenseGather : public EmbeddingLookuper {
           "size_t pointer to int64_t pointer.");
 
     if (param->get_hashtable(0)->identical_mapping()) {
+      if (!param->get_key_range_gpus().empty())
+        throw std::runtime_error(ErrorBase +
+                                 "key ranges can only be used when use_hashtable is True.");
       // identical_mapping waste memory spaces, so that lookuper
       // will set its wanted hashtable for param
       const size_t global_gpu_count = resource_mgr_->get_global_gpu_count();
@@ -158,7 +161,7 @@ class DenseGather : public EmbeddingLookuper {
   void restore_params(const std::shared_ptr<Tensor> &keys,
                       const std::shared_ptr<Tensor> &embedding_values,
                       const size_t num_total_keys) override {
-    // this lookuper distribute keys to each GPU based on key % GPU_NUM
+    // this lookuper distribute keys to each GPU based on key % GPU_NUM, or the key ranges of param
     restore_params_helper<KeyType>(param_, resource_mgr_, keys, embedding_values, num_total_keys);
   }
 
@@ -36,6 +36,7 @@ from sparse_operation_kit.core.initialize import Init
 from sparse_operation_kit.core.context_scope import OptimizerScope
 from sparse_operation_kit.embeddings.distributed_embedding import DistributedEmbedding
 from sparse_operation_kit.embeddings.all2all_dense_embedding import All2AllDenseEmbedding
+from sparse_operation_kit.embeddings.all2all_dense_embedding import key_ranges_from_samples
 from sparse_operation_kit.embeddings.get_embedding_op import get_embedding
 from sparse_operation_kit.saver.Saver import Saver
 from sparse_operation_kit.optimizers.utils import split_embedding_variable_from_others
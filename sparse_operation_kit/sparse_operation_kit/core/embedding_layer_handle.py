@@ -78,6 +78,8 @@ class DenseEmbeddingLayerHandle(EmbeddingLayerHandle):
         slot_num=1,
         nnz_per_slot=1,
         compute_dtype=None,
+        key_range_bounds=[],
+        key_range_gpus=[],
         **unused,
     ):
         super(DenseEmbeddingLayerHandle, self).__init__(embedding_variable, compute_dtype)
@@ -90,6 +92,8 @@ class DenseEmbeddingLayerHandle(EmbeddingLayerHandle):
         self._output_dispatcher_subsequent_ops = output_dispatcher_subsequent_ops
         self._slot_num = slot_num
         self._nnz_per_slot = nnz_per_slot
+        self._key_range_bounds = [int(bound) for bound in key_range_bounds]
+        self._key_range_gpus = [int(gpu) for gpu in key_range_gpus]
 
         with ops.init_scope():
             if hasattr(self._embedding_variable, "values"):
@@ -110,6 +114,8 @@ class DenseEmbeddingLayerHandle(EmbeddingLayerHandle):
                 nnz_per_slot=self._nnz_per_slot,
                 layer_handle_name=emb_var_name,
                 compute_dtype=self.compute_dtype,
+                key_range_bounds=self._key_range_bounds,
+                key_range_gpus=self._key_range_gpus,
             )
 
             self._initializer_op = control_flow_ops.group((self._handle))
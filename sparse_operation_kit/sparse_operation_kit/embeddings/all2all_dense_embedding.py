@@ -21,16 +21,66 @@ from __future__ import print_function
 from sparse_operation_kit.core import EmbeddingVariable
 from sparse_operation_kit.core import DenseEmbeddingLayerHandle
 from sparse_operation_kit.embeddings import embedding_ops
+import numpy as np
 import tensorflow as tf
 
 
+def key_ranges_from_samples(sampled_keys, num_ranges=1024):
+    """
+    Abbreviated as ``sok.key_ranges_from_samples(*args, **kwargs)``.
+
+    Derives the key ranges of ``sok.All2AllDenseEmbedding`` from the keys sampled
+    on each GPU, so that each key range is placed on the GPU looking it up most often.
+
+    Parameters
+    ----------
+    sampled_keys: list of array-like
+            `sampled_keys[i]` are the keys looked up by the GPU whose global id is `i`.
+    num_ranges: integer = 1024
+            the number of ranges the sampled keys are split into, each of which
+            contains about the same number of distinct keys. Neighbouring ranges
+            placed on the same GPU are merged.
+
+    Returns
+    -------
+    key_range_bounds: list of integer
+            the bounds of the key ranges.
+    key_range_gpus: list of integer
+            the GPU of each key range.
+    """
+    num_gpus = len(sampled_keys)
+    keys = [np.asarray(k, dtype=np.int64).reshape(-1) for k in sampled_keys]
+    unique_keys = np.unique(np.concatenate(keys))
+    if unique_keys.size == 0:
+        return [], []
+    num_ranges = max(1, min(num_ranges, unique_keys.size))
+    starts = np.linspace(0, unique_keys.size, num_ranges, endpoint=False).astype(np.int64)
+    bounds = np.append(np.unique(unique_keys[starts]), unique_keys[-1] + 1)
+
+    counts = np.zeros((bounds.size - 1, num_gpus), dtype=np.int64)
+    for gpu, k in enumerate(keys):
+        range_ids = np.searchsorted(bounds, k, side="right") - 1
+        counts[:, gpu] = np.bincount(range_ids, minlength=bounds.size - 1)
+    gpus = np.argmax(counts, axis=1)
+
+    key_range_bounds, key_range_gpus = [int(bounds[0])], []
+    for i, gpu in enumerate(gpus):
+        if key_range_gpus and key_range_gpus[-1] == gpu:
+            key_range_bounds[-1] = int(bounds[i + 1])
+        else:
+            key_range_gpus.append(int(gpu))
+            key_range_bounds.append(int(bounds[i + 1]))
+    return key_range_bounds, key_range_gpus
+
+
 class All2AllDenseEmbedding(tf.keras.layers.Layer):
     """
     Abbreviated as ``sok.All2AllDenseEmbedding(*args, **kwargs)``.
 
     This is a wrapper class for all2all dense embedding layer.
     It can be used to create a dense embedding layer which will distribute
-    keys based on `gpu_id = key % gpu_num` to each GPU.
+    keys based on `gpu_id = key % gpu_num` to each GPU, unless the key is in
+    one of the key ranges.
 
     Parameters
     ----------
@@ -62,6 +112,16 @@ class All2AllDenseEmbedding(tf.keras.layers.Layer):
     embedding_initializer: string or an instance of `tf.keras.initializers.Initializer`
             the initializer used to generate initial value for embedding variable.
             By default, it will use `random_uniform` where ``minval=-0.05, maxval=0.05``.
+    key_range_bounds: list of integer = None
+            the strictly increasing bounds of the key ranges. The keys in
+            ``[key_range_bounds[i], key_range_bounds[i + 1])`` are distributed to
+            the GPU ``key_range_gpus[i]``, so that the keys mostly looked up by one GPU
+            can stay on it. The ranges can be derived from sampled keys with
+            ``sok.key_ranges_from_samples``. The keys in a range count toward the
+            `max_vocabulary_size_per_gpu` of its GPU, and `use_hashtable` must be `True`.
+    key_range_gpus: list of integer = None
+            the global GPU id of each key range, which has one item less than
+            `key_range_bounds`.
 
     Examples
     --------
@@ -93,6 +153,8 @@ class All2AllDenseEmbedding(tf.keras.layers.Layer):
         use_hashtable=True,
         key_dtype=None,
         embedding_initializer=None,
+        key_range_bounds=None,
+        key_range_gpus=None,
         **kwargs
     ):
         super(All2AllDenseEmbedding, self).__init__(**kwargs)
@@ -128,6 +190,8 @@ class All2AllDenseEmbedding(tf.keras.layers.Layer):
             slot_num=self.slot_num,
             nnz_per_slot=self.nnz_per_slot,
             compute_dtype=self._dtype_policy.compute_dtype,
+            key_range_bounds=key_range_bounds or [],
+            key_range_gpus=key_range_gpus or [],
         )
 
     @property
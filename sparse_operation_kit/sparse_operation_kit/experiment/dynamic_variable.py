@@ -59,6 +59,25 @@ class DynamicVariable(ResourceVariable):
     dtype: dtype
         specify the data type of values. Default value is tf.float32.
 
+    **kwargs:
+        the configuration of the HKV backend, only used when var_type is "hybrid".
+
+        * init_capacity: the initial number of keys of the hash table.
+        * max_capacity: the maximum number of keys of the hash table, the
+          keys beyond it evict the existing ones.
+        * max_hbm_for_vectors: the HBM used for the embedding vectors, in GB.
+          The vectors that do not fit are kept in the host memory, so a table
+          can be much larger than the HBM. Default value is 16.
+        * max_load_factor: the load factor at which the table grows until
+          max_capacity. Default value is 0.5.
+        * max_bucket_size: the number of keys of each bucket. Default value is 128.
+        * evict_strategy: "kLru" evicts the least recently used keys,
+          "kCustomized" evicts the keys with the lowest score, see ``set_score``.
+          Default value is "kLru".
+
+        The number of lookups, hits and evicted keys can be checked with
+        ``statistics``.
+
     Example
     -------
     .. code-block:: python
@@ -78,6 +97,17 @@ class DynamicVariable(ResourceVariable):
         print("embedding:", embedding)
         print("v.shape:", v.shape)
         print("v.size:", v.size)
+
+        # A table of 2**30 keys with 128 GB of vectors, 16 GB of which are in HBM.
+        v = sok.DynamicVariable(
+            dimension=32,
+            var_type="hybrid",
+            initializer="uniform",
+            init_capacity=2**26,
+            max_capacity=2**30,
+            max_hbm_for_vectors=16,
+            evict_strategy="kLru",
+        )
     """
 
     def __init__(
@@ -217,6 +247,30 @@ class DynamicVariable(ResourceVariable):
             self._dummy_handle, key_type=self._key_type, dtype=self._handle_dtype
         )
 
+    @property
+    def statistics(self):
+        """
+        A tf.int64 tensor of [num_lookups, num_hits, num_evicted] since the
+        creation of the variable, which is all zeros if the backend does not
+        evict keys.
+        """
+        return dynamic_variable_ops.dummy_var_statistics(
+            self._dummy_handle, key_type=self._key_type, dtype=self._handle_dtype
+        )
+
+    def set_score(self, score):
+        """
+        Sets the score(e.g. the global step) of the keys looked up or updated from
+        now on. Only used by the "kCustomized" evict_strategy of HKV, which
+        evicts the keys with the lowest score.
+        """
+        return dynamic_variable_ops.dummy_var_set_score(
+            self._dummy_handle,
+            ops.convert_to_tensor(score, tf.int64),
+            key_type=self._key_type,
+            dtype=self._handle_dtype,
+        )
+
     @property
     def indices(self):
         return self._indices
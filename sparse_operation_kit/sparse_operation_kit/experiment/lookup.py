@@ -124,6 +124,47 @@ def _preprocessing_forward(keys, row_lengths, sp_weight_value, *args, **kwargs):
             )
 
 
+def _allgather_keys_and_sp_weights(key_send_buffer, sp_weight_send_buffer, row_length_recv_buffer):
+    """
+    This function should not be used by user directly.
+    Gathers the keys and the sparse weights of all ranks with a single allgather. The bytes of the
+    weights of each rank are appended to the bytes of its keys, and are split again by the number
+    of keys of each rank.
+    """
+    key_size = key_send_buffer.dtype.size
+    sp_weight_size = sp_weight_send_buffer.dtype.size
+    packed_send_buffer = tf.concat(
+        [
+            tf.reshape(tf.bitcast(key_send_buffer, tf.uint8), [-1]),
+            tf.reshape(tf.bitcast(sp_weight_send_buffer, tf.uint8), [-1]),
+        ],
+        0,
+    )
+    packed_recv_buffer = allgather(packed_send_buffer)
+
+    num_keys = tf.reduce_sum(tf.reshape(row_length_recv_buffer, [num_gpus(), -1]), 1)
+    num_keys = tf.cast(num_keys, tf.int64)
+    packed_chunks = tf.split(
+        packed_recv_buffer, num_keys * (key_size + sp_weight_size), num=num_gpus()
+    )
+    key_chunks, sp_weight_chunks = [], []
+    for i, packed_chunk in enumerate(packed_chunks):
+        key_chunk, sp_weight_chunk = tf.split(
+            packed_chunk, tf.stack([num_keys[i] * key_size, num_keys[i] * sp_weight_size]), num=2
+        )
+        key_chunks.append(key_chunk)
+        sp_weight_chunks.append(sp_weight_chunk)
+
+    key_recv_buffer = tf.bitcast(
+        tf.reshape(tf.concat(key_chunks, 0), [-1, key_size]), key_send_buffer.dtype
+    )
+    sp_weight_recv_buffer = tf.bitcast(
+        tf.reshape(tf.concat(sp_weight_chunks, 0), [-1, sp_weight_size]),
+        sp_weight_send_buffer.dtype,
+    )
+    return key_recv_buffer, sp_weight_recv_buffer
+
+
 def _hotness_calculate(*args, **kwargs):
     """
     This function should not be used by user directly.
@@ -379,6 +420,99 @@ def _PostprocessingBackward(op, *top_grads):
     return grads + [None] * (len(op.inputs) - len(grads))
 
 
+def _lookup_fused(params, *args, **kwargs):
+    """
+    This function should not be used by user directly.
+    Does the whole lookup of a single GPU in one op, see lookup_sparse_impl.
+    """
+    name = kwargs.pop("name") if "name" in kwargs else "LookupFused"
+    with ops.name_scope(name) as name:
+        for param in params:
+            # For tf.GradientTape
+            variable_accessed(param)
+        if isDynamicVariable(params[0]):
+            handles = [param.handle for param in params]
+            return raw_ops.lookup_fused_dynamic(handles, *args, **kwargs)
+        elif isResourceVariable(params[0]):
+            handles = [param.handle for param in params]
+            return raw_ops.lookup_fused(handles, *args, **kwargs)
+        elif isVariable(params[0]):
+            return raw_ops.lookup_fused_variable(params, *args, **kwargs)
+        else:
+            raise NotImplementedError(str(type(params[0])) + " is not supported in fused lookup")
+
+
+def _lookup_fused_backward(op, top_grads):
+    """
+    This function should not be used by user directly.
+    """
+    attr_list = [
+        "combiners",
+        "shard",
+        "dimensions",
+        "rank",
+        "num_ranks",
+        "id_in_local_rank",
+        "num_gpus",
+        "use_sp_weight",
+    ]
+    kwargs = {}
+    for attr in attr_list:
+        kwargs[attr] = op.get_attr(attr)
+
+    num_lookups = op.get_attr("num_lookups")
+    top_grads = top_grads[:num_lookups]
+    model_key, model_offsets, hotness, emb_vec_buffer_shape = op.outputs[
+        num_lookups : num_lookups + 4
+    ]
+    row_lengths = op.inputs[2 * num_lookups : 3 * num_lookups]
+    return raw_ops.lookup_fused_backward(
+        top_grads, model_key, model_offsets, row_lengths, hotness, emb_vec_buffer_shape, **kwargs
+    )
+
+
+@tf.RegisterGradient("LookupFused")
+def _LookupFusedBackward(op, *top_grads):
+    indices, values = _lookup_fused_backward(op, top_grads)
+    grads = []
+    for i in range(len(indices)):
+        handle = op.inputs[i]
+        params_shape = variable_shape(handle)
+        size = array_ops.expand_dims(array_ops.size(indices[i]), 0)
+        values_shape = array_ops.concat([size, params_shape[1:]], 0)
+        values[i] = tf.reshape(values[i], values_shape)
+        grads.append(tf.IndexedSlices(values[i], indices[i], params_shape))
+    return grads + [None] * (len(op.inputs) - len(grads))
+
+
+@tf.RegisterGradient("LookupFusedVariable")
+def _LookupFusedBackward(op, *top_grads):
+    indices, values = _lookup_fused_backward(op, top_grads)
+    grads = []
+    for i in range(len(indices)):
+        handle = op.inputs[i]
+        params_shape = handle.shape
+        size = array_ops.expand_dims(array_ops.size(indices[i]), 0)
+        values_shape = array_ops.concat([size, params_shape[1:]], 0)
+        values[i] = tf.reshape(values[i], values_shape)
+        grads.append(tf.IndexedSlices(values[i], indices[i], params_shape))
+    return grads + [None] * (len(op.inputs) - len(grads))
+
+
+@tf.RegisterGradient("LookupFusedDynamic")
+def _LookupFusedDynamicBackward(op, *top_grads):
+    indices, values = _lookup_fused_backward(op, top_grads)
+    grads = []
+    for i in range(len(indices)):
+        handle = op.inputs[i]
+        params_shape = raw_ops.dummy_var_shape(handle)
+        size = array_ops.expand_dims(array_ops.size(indices[i]), 0)
+        values_shape = array_ops.concat([size, params_shape[1:]], 0)
+        values[i] = tf.reshape(values[i], values_shape)
+        grads.append(tf.IndexedSlices(values[i], indices[i], params_shape))
+    return grads + [None] * (len(op.inputs) - len(grads))
+
+
 def to_list(any_obj):
     if not (isinstance(any_obj, list) or isinstance(any_obj, tuple)):
         return [any_obj]
@@ -443,6 +577,14 @@ def lookup_sparse_impl(params, sp_ids, sp_weights=None, combiners=None):
         "use_sp_weight": use_sp_weight,
     }
 
+    # On a single GPU there is no communication between the steps below, so that all of them run
+    # in one op, which saves the op dispatch and the buffer allocations of each step.
+    if num_gpus() == 1 and not use_sp_weight and not isEmbeddingVariable(params[0]):
+        if isDynamicVariable(params[0]):
+            keys = [tf.cast(key, params[0].key_type) for key in keys]
+        emb_vec, _, _, _, _ = _lookup_fused(params, keys, row_lengths, num_gpus=1, **kwargs)
+        return emb_vec
+
     # Step1
     # copy all the key and row length in one buffer
     key_send_buffer, row_length_send_buffer, sp_weight_send_buffer = _preprocessing_forward(
@@ -451,11 +593,14 @@ def lookup_sparse_impl(params, sp_ids, sp_weights=None, combiners=None):
 
     # Step2
     if num_gpus() > 1:
-        key_recv_buffer = allgather(key_send_buffer)
         row_length_recv_buffer = allgather(row_length_send_buffer)
         if use_sp_weight:
-            sp_weight_recv_buffer = allgather(sp_weight_send_buffer)
+            # The sparse weights travel with the keys, so that both need one allgather.
+            key_recv_buffer, sp_weight_recv_buffer = _allgather_keys_and_sp_weights(
+                key_send_buffer, sp_weight_send_buffer, row_length_recv_buffer
+            )
         else:
+            key_recv_buffer = allgather(key_send_buffer)
             sp_weight_recv_buffer = sp_weight_send_buffer
     else:
         key_recv_buffer = key_send_buffer
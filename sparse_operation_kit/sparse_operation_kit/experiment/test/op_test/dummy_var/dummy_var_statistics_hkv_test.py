@@ -0,0 +1,68 @@
+"""
+ Copyright (c) 2022, NVIDIA CORPORATION.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+import numpy as np
+import tensorflow as tf
+from sparse_operation_kit import experiment as sok
+
+
+def test():
+    capacity = 128
+    handle = sok.raw_ops.dummy_var_handle(
+        shared_name="Var_0", shape=[None, 16], key_type=tf.int64, dtype=tf.float32
+    )
+    sok.raw_ops.dummy_var_initialize(
+        handle,
+        initializer=[2.71828],
+        var_type="hybrid",
+        unique_name="",
+        key_type=tf.int64,
+        dtype=tf.float32,
+        config='{"init_capacity":%d,"max_capacity":%d,"max_bucket_size":%d,'
+        '"evict_strategy":"kCustomized"}' % (capacity, capacity, capacity),
+    )
+    statistics = sok.raw_ops.dummy_var_statistics(handle, key_type=tf.int64, dtype=tf.float32)
+    assert np.all(statistics.numpy() == 0)
+
+    # Keys with a higher score stay in the table
+    num_keys = capacity * 4
+    for step in range(4):
+        sok.raw_ops.dummy_var_set_score(
+            handle, tf.constant(step, dtype=tf.int64), key_type=tf.int64, dtype=tf.float32
+        )
+        indices = tf.range(step * capacity, (step + 1) * capacity, dtype=tf.int64)
+        values = tf.ones([capacity, 16], dtype=tf.float32) * step
+        sok.raw_ops.dummy_var_assign(handle, indices, values)
+
+    shape = sok.raw_ops.dummy_var_shape(handle, key_type=tf.int64, dtype=tf.float32)
+    assert shape[0] <= capacity
+    statistics = sok.raw_ops.dummy_var_statistics(handle, key_type=tf.int64, dtype=tf.float32)
+    assert statistics[0] == 0
+    assert statistics[2] == num_keys - shape[0]
+
+    indices, values = sok.raw_ops.dummy_var_export(handle, key_type=tf.int64, dtype=tf.float32)
+    assert np.all(indices.numpy() >= 3 * capacity)
+    assert np.all(values.numpy() == 3)
+
+
+if __name__ == "__main__":
+    op_name = "dummy_var_statistics"
+    if not hasattr(sok.raw_ops, op_name):
+        raise RuntimeError("There is no op called " + op_name)
+
+    test()
+
+    print("[SOK INFO] Test of %s passed." % (op_name))
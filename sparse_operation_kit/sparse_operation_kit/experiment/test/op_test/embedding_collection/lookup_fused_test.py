@@ -0,0 +1,78 @@
+"""
+ Copyright (c) 2022, NVIDIA CORPORATION.
+
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+import numpy as np
+import tensorflow as tf
+from sparse_operation_kit import experiment as sok
+
+
+def test():
+    v1 = tf.Variable(np.arange(12).reshape(4, 3) + 1, dtype=tf.float32)
+    v2 = tf.Variable(np.arange(25).reshape(5, 5) + 1, dtype=tf.float32)
+    key1 = tf.convert_to_tensor([0, 1, 1, 3], dtype=tf.int64)
+    row_length1 = tf.convert_to_tensor([1, 3], dtype=tf.int64)
+    key2 = tf.convert_to_tensor([2, 4, 0], dtype=tf.int64)
+    row_length2 = tf.convert_to_tensor([2, 1], dtype=tf.int64)
+    kwargs = {
+        "combiners": ["sum", "mean"],
+        "shard": [-1, -1],
+        "dimensions": [3, 5],
+        "rank": 0,
+        "num_ranks": 1,
+        "id_in_local_rank": 0,
+        "num_gpus": 1,
+        "use_sp_weight": False,
+    }
+
+    emb_vec, model_key, model_offsets, hotness, emb_vec_buffer_shape = sok.raw_ops.lookup_fused(
+        [v1.handle, v2.handle], [key1, key2], [row_length1, row_length2], **kwargs
+    )
+
+    w1, w2 = v1.numpy(), v2.numpy()
+    assert len(emb_vec) == 2
+    assert np.allclose(emb_vec[0].numpy(), [w1[0], w1[1] + w1[1] + w1[3]])
+    assert np.allclose(emb_vec[1].numpy(), [(w2[2] + w2[4]) / 2, w2[0]])
+    for i, item in enumerate([3, 2]):
+        assert hotness[i] == item
+    assert emb_vec_buffer_shape[0] == 2 * (3 + 5)
+
+    # The wgrad of reduce_sum(emb_vec)
+    emb_vec_grad = [tf.ones_like(emb) for emb in emb_vec]
+    indices, grads = sok.raw_ops.lookup_fused_backward(
+        emb_vec_grad,
+        model_key,
+        model_offsets,
+        [row_length1, row_length2],
+        hotness,
+        emb_vec_buffer_shape,
+        **kwargs
+    )
+    # The sum of the wgrad of every key
+    expected = [{0: 1.0, 1: 2.0, 3: 1.0}, {0: 1.0, 2: 0.5, 4: 0.5}]
+    for i in range(2):
+        assert len(indices[i]) == len(expected[i])
+        for key, grad in zip(indices[i].numpy(), grads[i].numpy()):
+            assert np.allclose(grad, expected[i][key])
+
+
+if __name__ == "__main__":
+    op_name = "lookup_fused"
+    if not hasattr(sok.raw_ops, op_name):
+        raise RuntimeError("There is no op called " + op_name)
+
+    test()
+
+    print("[SOK INFO] Test of %s passed." % (op_name))
@@ -16,6 +16,7 @@ python dummy_var_scatter_add_test.py
 python dummy_var_scatter_add_hkv_test.py
 python dummy_var_scatter_update_test.py
 python dummy_var_scatter_update_hkv_test.py
+python dummy_var_statistics_hkv_test.py
 cd ..
 
 # -------- embedding collection -------------- #
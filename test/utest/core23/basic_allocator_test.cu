@@ -17,14 +17,17 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <common.hpp>
 #include <core23/allocator_factory.hpp>
 #include <core23/allocator_params.hpp>
 #include <core23/details/pool_cuda_allocator.hpp>
+#include <core23/details/virtual_cuda_allocator.hpp>
 #include <core23/logger.hpp>
 #include <cstdint>
 #include <random>
 #include <utils.cuh>
+#include <vector>
 
 namespace {
 
@@ -125,3 +128,31 @@ TEST(test_core23, allocator_managed_cuda) {
   Device device(DeviceType::UNIFIED, 0);
   test_impl(my_allocator_params, device);
 }
+
+TEST(test_core23, allocator_growable_cuda) {
+  AllocatorParams my_allocator_params = g_allocator_params;
+  Device device(DeviceType::GPU, 0);
+  my_allocator_params.growable = true;
+  test_impl(my_allocator_params, device);
+}
+
+TEST(test_core23, allocator_virtual_cuda_grow_in_place) {
+  Device device(DeviceType::GPU, 0);
+  VirtualCUDAAllocator allocator(device, 64 * 1024 * 1024);
+  const int64_t num_bytes = 3 * 1024 * 1024;
+  auto ptr = allocator.allocate(num_bytes);
+  EXPECT_GE(allocator.mapped_size(ptr), num_bytes);
+  HCTR_LIB_THROW(cudaMemset(ptr, 1, num_bytes));
+
+  // The memory is extended behind the old bytes, which are kept.
+  allocator.grow(ptr, 5 * num_bytes);
+  EXPECT_GE(allocator.mapped_size(ptr), 5 * num_bytes);
+  launch_init_kernel<int8_t>(static_cast<int8_t*>(ptr) + num_bytes, 4 * num_bytes,
+                             DeviceType::GPU);
+  std::vector<int8_t> head(num_bytes);
+  HCTR_LIB_THROW(cudaMemcpy(head.data(), ptr, num_bytes, cudaMemcpyDeviceToHost));
+  EXPECT_EQ(std::count(head.begin(), head.end(), 1), num_bytes);
+
+  EXPECT_THROW(allocator.grow(ptr, allocator.reserve_size() + 1), std::exception);
+  allocator.deallocate(ptr);
+}
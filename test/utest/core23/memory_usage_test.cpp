@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <core23/buffer_params.hpp>
+#include <core23/memory_usage.hpp>
+#include <core23/tensor.hpp>
+#include <optional>
+#include <string>
+
+namespace {
+
+using namespace HugeCTR::core23;
+
+std::optional<MemoryUsage> find_usage(const Device& device, const std::string& tag) {
+  for (const auto& u : GetMemoryUsage()) {
+    if (u.device == device && u.tag == tag) {
+      return u;
+    }
+  }
+  return std::nullopt;
+}
+
+TEST(test_core23, memory_usage_test) {
+  constexpr int64_t float_size = sizeof(float);
+  const Device device(DeviceType::GPU, 0);
+  const auto params = TensorParams().device(device).data_type(ScalarType::Float);
+
+  EXPECT_EQ(GetMemoryTag(), "untagged");
+  {
+    MemoryTagScope subsystem_scope("memory_usage_test");
+    EXPECT_EQ(GetMemoryTag(), "memory_usage_test");
+    std::optional<Tensor> layer_tensor;
+    {
+      MemoryTagScope layer_scope("layer");
+      EXPECT_EQ(GetMemoryTag(), "memory_usage_test/layer");
+      layer_tensor.emplace(params.shape({256}));
+    }
+    EXPECT_EQ(GetMemoryTag(), "memory_usage_test");
+    // A tag of the BufferParams wins over that of the scope.
+    BufferParams buffer_params;
+    buffer_params.tag = "memory_usage_test/explicit";
+    Tensor explicit_tensor(params.shape({64}).buffer_params(buffer_params));
+
+    // The usage is recorded when the memory is allocated, rather than when the Tensor is created.
+    EXPECT_FALSE(find_usage(device, "memory_usage_test/layer").has_value());
+    EXPECT_NE(layer_tensor->data(), nullptr);
+    EXPECT_NE(explicit_tensor.data(), nullptr);
+    auto layer_usage = find_usage(device, "memory_usage_test/layer");
+    ASSERT_TRUE(layer_usage.has_value());
+    EXPECT_EQ(layer_usage->current_bytes, 256 * float_size);
+    EXPECT_EQ(layer_usage->peak_bytes, 256 * float_size);
+    auto explicit_usage = find_usage(device, "memory_usage_test/explicit");
+    ASSERT_TRUE(explicit_usage.has_value());
+    EXPECT_EQ(explicit_usage->current_bytes, 64 * float_size);
+    EXPECT_FALSE(find_usage(device, "memory_usage_test").has_value());
+
+    layer_tensor.reset();
+    layer_usage = find_usage(device, "memory_usage_test/layer");
+    ASSERT_TRUE(layer_usage.has_value());
+    EXPECT_EQ(layer_usage->current_bytes, 0);
+    EXPECT_EQ(layer_usage->peak_bytes, 256 * float_size);
+    EXPECT_NE(GetMemoryUsageReport().find("memory_usage_test/explicit"), std::string::npos);
+  }
+  EXPECT_EQ(GetMemoryTag(), "untagged");
+  EXPECT_EQ(find_usage(device, "memory_usage_test/explicit")->current_bytes, 0);
+
+  ResetPeakMemoryUsage();
+  EXPECT_EQ(find_usage(device, "memory_usage_test/layer")->peak_bytes, 0);
+}
+
+}  // namespace
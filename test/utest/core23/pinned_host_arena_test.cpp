@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_runtime.h>
+#include <gtest/gtest.h>
+
+#include <core23/pinned_host_arena.hpp>
+
+namespace {
+
+using namespace HugeCTR::core23;
+
+TEST(test_core23, pinned_host_arena_test) {
+  PinnedHostArena& arena = PinnedHostArena::instance();
+  const std::string consumer = "pinned_host_arena_test";
+  const int64_t size = 3 << 20;
+
+  void* data = nullptr;
+  int64_t pinned_bytes = 0;
+  int numa_node = 0;
+  {
+    PinnedHostBuffer buffer = arena.acquire(consumer, size);
+    data = buffer.data();
+    numa_node = buffer.numa_node();
+    EXPECT_EQ(buffer.size(), size);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % 4096, 0);
+    EXPECT_EQ(arena.stats().lent_bytes.at(consumer), size);
+
+    cudaPointerAttributes attributes;
+    ASSERT_EQ(cudaPointerGetAttributes(&attributes, data), cudaSuccess);
+    EXPECT_EQ(attributes.type, cudaMemoryTypeHost);
+    pinned_bytes = arena.stats().pinned_bytes;
+  }
+  EXPECT_EQ(arena.stats().lent_bytes.at(consumer), 0);
+
+  // A returned buffer is lent out again to another consumer, without pinning new memory.
+  {
+    PinnedHostBuffer buffer = arena.acquire(consumer + "_other", size - 4096, numa_node);
+    EXPECT_EQ(buffer.data(), data);
+    EXPECT_EQ(arena.stats().pinned_bytes, pinned_bytes);
+  }
+
+  arena.set_quota(consumer, size);
+  PinnedHostBuffer buffer = arena.acquire(consumer, size);
+  EXPECT_THROW(arena.acquire(consumer, 1), std::exception);
+  buffer.reset();
+  EXPECT_NO_THROW(arena.acquire(consumer, 1));
+  arena.set_quota(consumer, -1);
+
+  arena.trim();
+  EXPECT_EQ(arena.stats().pinned_bytes, 0);
+}
+
+}  // namespace
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cuda_runtime.h>
+#include <gtest/gtest.h>
+
+#include <core23/scratch_arena.hpp>
+
+namespace {
+
+using namespace HugeCTR::core23;
+
+TEST(test_core23, scratch_arena_test) {
+  ASSERT_EQ(cudaSetDevice(0), cudaSuccess);
+  cudaStream_t stream;
+  ASSERT_EQ(cudaStreamCreate(&stream), cudaSuccess);
+  ScratchArena& arena = ScratchArena::get(0, stream);
+  EXPECT_EQ(&ScratchArena::get(0, stream), &arena);
+  EXPECT_EQ(arena.capacity(), 0);
+
+  // Requests overflow into stream-ordered allocations until the arena is reset.
+  {
+    ScratchArena::Scope scope(arena);
+    void* first = scope.allocate(1000);
+    void* second = scope.allocate(3000);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 256, 0);
+    EXPECT_EQ(arena.high_water_mark(), 1024 + 3072);
+    EXPECT_THROW(arena.reset(), std::exception);
+  }
+  {
+    ScratchArena::Scope scope(arena);
+    scope.allocate(2048);
+  }
+  EXPECT_EQ(arena.high_water_mark(), 1024 + 3072);
+  arena.reset();
+  EXPECT_EQ(arena.capacity(), 1024 + 3072);
+  EXPECT_EQ(arena.high_water_mark(), 0);
+
+  // Scopes that follow each other reuse the memory, nested scopes don't overlap.
+  void* outer = nullptr;
+  {
+    ScratchArena::Scope scope(arena);
+    outer = scope.allocate(1024);
+    {
+      ScratchArena::Scope inner(arena);
+      void* ptr = inner.allocate(3072);
+      EXPECT_EQ(static_cast<char*>(ptr), static_cast<char*>(outer) + 1024);
+      ASSERT_EQ(cudaMemsetAsync(ptr, 0, 3072, stream), cudaSuccess);
+    }
+    ScratchArena::Scope inner(arena);
+    EXPECT_EQ(static_cast<char*>(inner.allocate(256)), static_cast<char*>(outer) + 1024);
+  }
+  {
+    ScratchArena::Scope scope(arena);
+    EXPECT_EQ(scope.allocate(4096), outer);
+  }
+  EXPECT_EQ(arena.high_water_mark(), 4096);
+
+  ScratchArena::reset_all();
+  EXPECT_EQ(arena.capacity(), 4096);
+  ASSERT_EQ(cudaStreamSynchronize(stream), cudaSuccess);
+}
+
+}  // namespace
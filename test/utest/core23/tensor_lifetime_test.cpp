@@ -0,0 +1,100 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <core23/buffer_params.hpp>
+#include <core23/tensor.hpp>
+#include <core23/tensor_params.hpp>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace HugeCTR::core23;
+
+using Lifetime = std::optional<std::pair<int64_t, int64_t>>;
+
+Lifetime steps(int64_t first_step, int64_t last_step) {
+  return std::make_pair(first_step, last_step);
+}
+
+void tensor_lifetime_test(const std::vector<int64_t>& sizes,
+                          const std::vector<Lifetime>& lifetimes) {
+  BufferParams buffer_params;
+  buffer_params.channel = "TENSOR_LIFETIME_TEST";
+  TensorParams tensor_params = TensorParams()
+                                   .data_type(ScalarType::Float)
+                                   .device(Device(DeviceType::GPU, 0))
+                                   .buffer_params(buffer_params);
+
+  std::vector<Tensor> tensors;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    tensors.emplace_back(tensor_params.shape({sizes[i]}));
+    if (lifetimes[i]) {
+      tensors[i].set_lifetime(lifetimes[i]->first, lifetimes[i]->second);
+    }
+  }
+
+  // The tensors whose lifetimes overlap, or which have no lifetime, must not share memory.
+  for (size_t i = 0; i < tensors.size(); i++) {
+    for (size_t j = i + 1; j < tensors.size(); j++) {
+      const bool overlap = !lifetimes[i] || !lifetimes[j] ||
+                           (lifetimes[i]->first <= lifetimes[j]->second &&
+                            lifetimes[j]->first <= lifetimes[i]->second);
+      if (overlap) {
+        const char* begin_i = tensors[i].data<char>();
+        const char* begin_j = tensors[j].data<char>();
+        EXPECT_TRUE(begin_i + tensors[i].num_bytes() <= begin_j ||
+                    begin_j + tensors[j].num_bytes() <= begin_i);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(test_core23, tensor_lifetime_chain_test) {
+  std::vector<int64_t> sizes = {1024, 1024, 1024, 1024};
+  std::vector<Lifetime> lifetimes = {steps(0, 1), steps(1, 2), steps(2, 3), steps(3, 4)};
+  tensor_lifetime_test(sizes, lifetimes);
+}
+
+TEST(test_core23, tensor_lifetime_mixed_test) {
+  std::vector<int64_t> sizes = {4096, 100, 2048, 333, 4096, 64, 1000};
+  std::vector<Lifetime> lifetimes = {steps(0, 3), std::nullopt, steps(2, 2), steps(4, 6),
+                                     steps(5, 9), steps(0, 9),  std::nullopt};
+  tensor_lifetime_test(sizes, lifetimes);
+}
+
+TEST(test_core23, tensor_lifetime_reuse_test) {
+  BufferParams buffer_params;
+  buffer_params.channel = "TENSOR_LIFETIME_REUSE_TEST";
+  TensorParams tensor_params = TensorParams()
+                                   .data_type(ScalarType::Float)
+                                   .device(Device(DeviceType::GPU, 0))
+                                   .buffer_params(buffer_params)
+                                   .shape({1024});
+  Tensor a(tensor_params), b(tensor_params), c(tensor_params);
+  a.set_lifetime(0, 1);
+  b.set_lifetime(1, 2);
+  c.set_lifetime(2, 3);
+  // c is placed where a was, as their lifetimes are disjoint.
+  EXPECT_EQ(a.data(), c.data());
+  EXPECT_NE(a.data(), b.data());
+}
@@ -0,0 +1,208 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <core23/low_level_primitives.hpp>
+#include <core23/shape.hpp>
+#include <core23/tensor.hpp>
+#include <layers/fused_add_layer_norm_layer.hpp>
+#include <utest/test_utils.hpp>
+#include <utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+constexpr float eps = 1e-4;
+
+template <typename T>
+struct Eps {
+  static T value();
+};
+
+template <>
+struct Eps<float> {
+  static constexpr float value() { return 1e-3f; }
+};
+
+template <>
+struct Eps<__half> {
+  static __half value() { return __float2half(3e-2f); }
+};
+
+template <typename T>
+void upload(const core23::Tensor& tensor, const std::vector<T>& h_tensor) {
+  core23::copy_sync(tensor.data(), h_tensor.data(), tensor.num_bytes(), tensor.device(),
+                    core23::DeviceType::CPU);
+}
+
+template <typename T>
+std::vector<T> download(const core23::Tensor& tensor) {
+  std::vector<T> h_tensor(tensor.num_elements());
+  core23::copy_sync(h_tensor.data(), tensor.data(), tensor.num_bytes(), core23::DeviceType::CPU,
+                    tensor.device());
+  return h_tensor;
+}
+
+// LayerNorm of residual + dropout(x) and its gradients, with the dropout masks in keep
+template <typename T>
+void fused_add_layer_norm_cpu(const std::vector<T>& x, const std::vector<T>& residual,
+                              const std::vector<bool>& keep, float scale,
+                              const std::vector<T>& gamma, const std::vector<T>& beta,
+                              const std::vector<T>& top_grad, int64_t rows, int64_t hidden_dim,
+                              std::vector<T>& out, std::vector<T>& x_grad,
+                              std::vector<T>& residual_grad, std::vector<T>& gamma_grad,
+                              std::vector<T>& beta_grad) {
+  std::vector<float> gamma_sum(hidden_dim, 0.f), beta_sum(hidden_dim, 0.f);
+  std::vector<float> xhat(hidden_dim), grad(hidden_dim);
+  for (int64_t i = 0; i < rows; i++) {
+    const int64_t offset = i * hidden_dim;
+    float mean = 0.f;
+    for (int64_t j = 0; j < hidden_dim; j++) {
+      xhat[j] = (keep[offset + j] ? static_cast<float>(x[offset + j]) * scale : 0.f) +
+                static_cast<float>(residual[offset + j]);
+      mean += xhat[j];
+    }
+    mean /= hidden_dim;
+    float var = 0.f;
+    for (int64_t j = 0; j < hidden_dim; j++) {
+      var += (xhat[j] - mean) * (xhat[j] - mean);
+    }
+    const float rstd = 1.f / std::sqrt(var / hidden_dim + eps);
+
+    float grad_mean = 0.f, grad_xhat_mean = 0.f;
+    for (int64_t j = 0; j < hidden_dim; j++) {
+      xhat[j] = (xhat[j] - mean) * rstd;
+      out[offset + j] = xhat[j] * static_cast<float>(gamma[j]) + static_cast<float>(beta[j]);
+      const float dy = top_grad[offset + j];
+      grad[j] = dy * static_cast<float>(gamma[j]);
+      gamma_sum[j] += dy * xhat[j];
+      beta_sum[j] += dy;
+      grad_mean += grad[j] / hidden_dim;
+      grad_xhat_mean += grad[j] * xhat[j] / hidden_dim;
+    }
+    for (int64_t j = 0; j < hidden_dim; j++) {
+      const float sum_grad = rstd * (grad[j] - grad_mean - xhat[j] * grad_xhat_mean);
+      residual_grad[offset + j] = sum_grad;
+      x_grad[offset + j] = keep[offset + j] ? sum_grad * scale : 0.f;
+    }
+  }
+  for (int64_t j = 0; j < hidden_dim; j++) {
+    gamma_grad[j] = gamma_sum[j];
+    beta_grad[j] = beta_sum[j];
+  }
+}
+
+template <typename T>
+void fused_add_layer_norm_test(int64_t rows, int64_t hidden_dim, float dropout_rate) {
+  constexpr bool use_mixed_precision = std::is_same_v<T, __half>;
+  const int64_t size = rows * hidden_dim;
+  core23::CURANDGenerator generator(core23::DeviceType::CPU);
+  core23::TensorParams tensor_params =
+      core23::TensorParams()
+          .device(core23::Device::current())
+          .data_type(use_mixed_precision ? core23::ScalarType::Half : core23::ScalarType::Float)
+          .buffer_channel(core23::GetRandomBufferChannel())
+          .shape({rows, hidden_dim});
+  core23::Tensor x_tensor(tensor_params), residual_tensor(tensor_params), out_tensor(tensor_params);
+
+  typename Core23TempFusedAddLayerNormLayer<T>::Params params = {eps, dropout_rate};
+  Core23TempFusedAddLayerNormLayer<T> layer(x_tensor, residual_tensor, out_tensor, params, 2023,
+                                            test::get_default_gpu());
+  layer.initialize();
+
+  std::vector<T> h_x(size), h_residual(size), h_top_grad(size), h_gamma(hidden_dim),
+      h_beta(hidden_dim);
+  test::normal_sync_cpu(h_x.data(), size, 0.f, 1.f, generator);
+  test::normal_sync_cpu(h_residual.data(), size, 0.f, 1.f, generator);
+  test::normal_sync_cpu(h_top_grad.data(), size, 0.f, 1.f, generator);
+  test::normal_sync_cpu(h_gamma.data(), hidden_dim, 1.f, 0.1f, generator);
+  test::normal_sync_cpu(h_beta.data(), hidden_dim, 0.f, 0.1f, generator);
+  auto weights = layer.get_weights();
+  auto wgrads = layer.get_wgrads();
+  upload(weights[0], h_gamma);
+  upload(weights[1], h_beta);
+  upload(x_tensor, h_x);
+  upload(residual_tensor, h_residual);
+
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  layer.fprop(true);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  auto h_out = download<T>(out_tensor);
+
+  upload(out_tensor, h_top_grad);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  layer.bprop();
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  auto h_x_grad = download<T>(x_tensor);
+  auto h_residual_grad = download<T>(residual_tensor);
+  auto h_gamma_grad = download<T>(wgrads[0]);
+  auto h_beta_grad = download<T>(wgrads[1]);
+
+  // The mask is what the gradient of x drops, which must be close to the dropout rate.
+  std::vector<bool> keep(size, true);
+  if (dropout_rate > 0.f) {
+    int64_t num_dropped = 0;
+    for (int64_t i = 0; i < size; i++) {
+      keep[i] = static_cast<float>(h_x_grad[i]) != 0.f;
+      num_dropped += !keep[i];
+    }
+    ASSERT_NEAR(static_cast<float>(num_dropped) / size, dropout_rate, 0.02f);
+  }
+
+  std::vector<T> h_expected_out(size), h_expected_x_grad(size), h_expected_residual_grad(size),
+      h_expected_gamma_grad(hidden_dim), h_expected_beta_grad(hidden_dim);
+  fused_add_layer_norm_cpu(h_x, h_residual, keep, 1.f / (1.f - dropout_rate), h_gamma, h_beta,
+                           h_top_grad, rows, hidden_dim, h_expected_out, h_expected_x_grad,
+                           h_expected_residual_grad, h_expected_gamma_grad, h_expected_beta_grad);
+  ASSERT_TRUE(
+      test::compare_array_approx<T>(h_out.data(), h_expected_out.data(), size, Eps<T>::value()));
+  ASSERT_TRUE(test::compare_array_approx<T>(h_x_grad.data(), h_expected_x_grad.data(), size,
+                                            Eps<T>::value()));
+  ASSERT_TRUE(test::compare_array_approx<T>(h_residual_grad.data(),
+                                            h_expected_residual_grad.data(), size,
+                                            Eps<T>::value()));
+  // The gradients of gamma and beta are sums over the rows.
+  const T wgrad_eps = static_cast<float>(Eps<T>::value()) * std::sqrt(static_cast<float>(rows));
+  ASSERT_TRUE(test::compare_array_approx<T>(h_gamma_grad.data(), h_expected_gamma_grad.data(),
+                                            hidden_dim, wgrad_eps));
+  ASSERT_TRUE(test::compare_array_approx<T>(h_beta_grad.data(), h_expected_beta_grad.data(),
+                                            hidden_dim, wgrad_eps));
+}
+
+}  // namespace
+
+TEST(fused_add_layer_norm_layer, fp32_1024x256) {
+  fused_add_layer_norm_test<float>(1024, 256, 0.f);
+}
+TEST(fused_add_layer_norm_layer, fp16_1024x256) {
+  fused_add_layer_norm_test<__half>(1024, 256, 0.f);
+}
+TEST(fused_add_layer_norm_layer, fp32_1024x1000_dropout) {
+  fused_add_layer_norm_test<float>(1024, 1000, 0.1f);
+}
+TEST(fused_add_layer_norm_layer, fp16_1024x1000_dropout) {
+  fused_add_layer_norm_test<__half>(1024, 1000, 0.1f);
+}
+TEST(fused_add_layer_norm_layer, fp32_256x1536_dropout) {
+  fused_add_layer_norm_test<float>(256, 1536, 0.1f);
+}
+TEST(fused_add_layer_norm_layer, fp16_256x1536_dropout) {
+  fused_add_layer_norm_test<__half>(256, 1536, 0.1f);
+}
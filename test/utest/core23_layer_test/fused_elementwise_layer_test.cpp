@@ -0,0 +1,201 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <core23/data_type_helpers.cuh>
+#include <core23/low_level_primitives.hpp>
+#include <core23/shape.hpp>
+#include <core23/tensor.hpp>
+#include <layers/fused_elementwise_layer.hpp>
+#include <utest/test_utils.hpp>
+#include <utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+template <typename T>
+struct Eps {
+  static T value();
+};
+
+template <>
+struct Eps<float> {
+  static constexpr float value() { return 1e-5f; }
+};
+
+template <>
+struct Eps<__half> {
+  static __half value() { return __float2half(2e-2f); }
+};
+
+template <typename T>
+std::vector<core23::Tensor> make_tensors(const core23::Shape& shape, size_t num) {
+  constexpr bool use_mixed_precision = std::is_same_v<T, __half>;
+  core23::TensorParams tensor_params =
+      core23::TensorParams()
+          .device(core23::Device::current())
+          .data_type(use_mixed_precision ? core23::ScalarType::Half : core23::ScalarType::Float)
+          .buffer_channel(core23::GetRandomBufferChannel());
+  std::vector<core23::Tensor> tensors;
+  for (size_t i = 0; i < num; i++) {
+    tensors.emplace_back(tensor_params.shape(shape));
+  }
+  return tensors;
+}
+
+template <typename T>
+void upload(core23::Tensor& tensor, const std::vector<T>& h_tensor) {
+  core23::copy_sync(tensor.data(), h_tensor.data(), tensor.num_bytes(), tensor.device(),
+                    core23::DeviceType::CPU);
+}
+
+template <typename T>
+std::vector<T> download(const core23::Tensor& tensor) {
+  std::vector<T> h_tensor(tensor.num_elements());
+  core23::copy_sync(h_tensor.data(), tensor.data(), tensor.num_bytes(), core23::DeviceType::CPU,
+                    tensor.device());
+  return h_tensor;
+}
+
+// sigmoid(c * relu(a + b)), where c is the first operand of the multiply
+template <typename T>
+void fused_elementwise_chain_test(int64_t batch_size, int64_t width) {
+  core23::Shape shape = {batch_size, width};
+  const size_t size = batch_size * width;
+  core23::CURANDGenerator generator(core23::DeviceType::CPU);
+
+  auto bottom_tensors = make_tensors<T>(shape, 3);
+  core23::Tensor top_tensor = make_tensors<T>(shape, 1)[0];
+  std::vector<FusedElementwiseOp> ops = {{FusedElementwiseOp_t::Add, 0, 2, -1, 0.f},
+                                         {FusedElementwiseOp_t::Relu, 2, 0, 0, 0.f},
+                                         {FusedElementwiseOp_t::Multiply, 2, 1, 1, 0.f},
+                                         {FusedElementwiseOp_t::Sigmoid, 3, 0, 0, 0.f}};
+  FusedElementwiseLayer<T> fused_layer(bottom_tensors, top_tensor, ops, 0,
+                                       test::get_default_gpu());
+  fused_layer.initialize();
+
+  std::vector<std::vector<T>> h_bottoms(3, std::vector<T>(size));
+  for (size_t i = 0; i < 3; i++) {
+    test::normal_sync_cpu(h_bottoms[i].data(), size, 0.f, 1.f, generator);
+    upload(bottom_tensors[i], h_bottoms[i]);
+  }
+  std::vector<T> h_top_grad(size);
+  test::normal_sync_cpu(h_top_grad.data(), size, 0.f, 1.f, generator);
+
+  std::vector<T> h_cpu_top(size);
+  std::vector<std::vector<T>> h_cpu_dgrads(3, std::vector<T>(size));
+  for (size_t i = 0; i < size; i++) {
+    const float a = h_bottoms[0][i], b = h_bottoms[1][i], c = h_bottoms[2][i];
+    const float relu = std::max(a + b, 0.f);
+    const float top = 1.f / (1.f + std::exp(-c * relu));
+    h_cpu_top[i] = top;
+    const float grad = static_cast<float>(h_top_grad[i]) * top * (1.f - top);
+    h_cpu_dgrads[0][i] = h_cpu_dgrads[1][i] = a + b > 0.f ? grad * c : 0.f;
+    h_cpu_dgrads[2][i] = grad * relu;
+  }
+
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  fused_layer.fprop(true);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  auto h_top = download<T>(top_tensor);
+  ASSERT_TRUE(test::compare_array_approx<T>(h_top.data(), h_cpu_top.data(), size, Eps<T>::value()));
+
+  upload(top_tensor, h_top_grad);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  fused_layer.bprop();
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  for (size_t i = 0; i < 3; i++) {
+    auto h_dgrad = download<T>(bottom_tensors[i]);
+    ASSERT_TRUE(test::compare_array_approx<T>(h_dgrad.data(), h_cpu_dgrads[i].data(), size,
+                                              Eps<T>::value()));
+  }
+}
+
+// dropout(a + b): the bprop must drop the same elements as the fprop
+template <typename T>
+void fused_elementwise_dropout_test(int64_t batch_size, int64_t width, float rate) {
+  core23::Shape shape = {batch_size, width};
+  const size_t size = batch_size * width;
+  core23::CURANDGenerator generator(core23::DeviceType::CPU);
+
+  auto bottom_tensors = make_tensors<T>(shape, 2);
+  core23::Tensor top_tensor = make_tensors<T>(shape, 1)[0];
+  std::vector<FusedElementwiseOp> ops = {{FusedElementwiseOp_t::Add, 0, 2, -1, 0.f},
+                                         {FusedElementwiseOp_t::Dropout, 2, 0, 0, rate}};
+  FusedElementwiseLayer<T> fused_layer(bottom_tensors, top_tensor, ops, 2023,
+                                       test::get_default_gpu());
+  fused_layer.initialize();
+
+  std::vector<T> h_previous_top;
+  for (int iter = 0; iter < 2; iter++) {
+    std::vector<std::vector<T>> h_bottoms(2, std::vector<T>(size));
+    for (size_t i = 0; i < 2; i++) {
+      test::normal_sync_cpu(h_bottoms[i].data(), size, 0.f, 1.f, generator);
+      upload(bottom_tensors[i], h_bottoms[i]);
+    }
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+    fused_layer.fprop(true);
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+    auto h_top = download<T>(top_tensor);
+
+    std::vector<T> h_cpu_dgrad(size);
+    size_t num_dropped = 0;
+    for (size_t i = 0; i < size; i++) {
+      const float kept =
+          (static_cast<float>(h_bottoms[0][i]) + static_cast<float>(h_bottoms[1][i])) /
+          (1.f - rate);
+      const bool dropped = static_cast<float>(h_top[i]) == 0.f;
+      if (!dropped) {
+        ASSERT_NEAR(static_cast<float>(h_top[i]), kept,
+                    static_cast<float>(Eps<T>::value()) * std::max(1.f, std::abs(kept)));
+      }
+      num_dropped += dropped;
+      h_cpu_dgrad[i] = dropped ? 0.f : 1.f / (1.f - rate);
+    }
+    ASSERT_NEAR(static_cast<float>(num_dropped) / size, rate, 0.02f);
+    // Each iteration draws new masks.
+    if (iter > 0) {
+      ASSERT_FALSE(std::equal(h_top.begin(), h_top.end(), h_previous_top.begin(),
+                              [](T x, T y) { return (float(x) == 0.f) == (float(y) == 0.f); }));
+    }
+    h_previous_top = h_top;
+
+    upload(top_tensor, std::vector<T>(size, T(1.f)));
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+    fused_layer.bprop();
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+    for (size_t i = 0; i < 2; i++) {
+      auto h_dgrad = download<T>(bottom_tensors[i]);
+      ASSERT_TRUE(test::compare_array_approx<T>(h_dgrad.data(), h_cpu_dgrad.data(), size,
+                                                Eps<T>::value()));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(fused_elementwise_layer, fp32_4096x64) { fused_elementwise_chain_test<float>(4096, 64); }
+TEST(fused_elementwise_layer, fp16_4096x64) { fused_elementwise_chain_test<__half>(4096, 64); }
+TEST(fused_elementwise_layer, fp32_dropout_4096x64) {
+  fused_elementwise_dropout_test<float>(4096, 64, 0.5f);
+}
+TEST(fused_elementwise_layer, fp16_dropout_4096x64) {
+  fused_elementwise_dropout_test<__half>(4096, 64, 0.5f);
+}
@@ -0,0 +1,221 @@
+
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <core23/low_level_primitives.hpp>
+#include <core23/shape.hpp>
+#include <core23/tensor.hpp>
+#include <layers/grouped_mlp_layer.hpp>
+#include <utest/test_utils.hpp>
+#include <utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+template <typename T>
+struct Eps {
+  static T value();
+};
+
+template <>
+struct Eps<float> {
+  static constexpr float value() { return 1e-3f; }
+};
+
+template <>
+struct Eps<__half> {
+  static __half value() { return __float2half(5e-2f); }
+};
+
+template <typename T>
+void upload(const core23::Tensor& tensor, const std::vector<T>& h_tensor) {
+  core23::copy_sync(tensor.data(), h_tensor.data(), tensor.num_bytes(), tensor.device(),
+                    core23::DeviceType::CPU);
+}
+
+template <typename T>
+std::vector<T> download(const core23::Tensor& tensor) {
+  std::vector<T> h_tensor(tensor.num_elements());
+  core23::copy_sync(h_tensor.data(), tensor.data(), tensor.num_bytes(), core23::DeviceType::CPU,
+                    tensor.device());
+  return h_tensor;
+}
+
+// One layer of all the experts, with in [batch_size, num_groups, input_size] and out
+// [batch_size, num_experts, output_size]. The experts share the input if num_groups is 1.
+template <typename T>
+void grouped_layer_fprop_cpu(const std::vector<float>& in, const std::vector<T>& kernel,
+                             const std::vector<T>& bias, int64_t batch_size, int64_t num_groups,
+                             int64_t num_experts, int64_t input_size, int64_t output_size,
+                             bool relu, std::vector<float>& out) {
+  out.assign(batch_size * num_experts * output_size, 0.f);
+  for (int64_t b = 0; b < batch_size; b++) {
+    for (int64_t e = 0; e < num_experts; e++) {
+      const int64_t g = num_groups == 1 ? 0 : e;
+      for (int64_t n = 0; n < output_size; n++) {
+        const int64_t col = e * output_size + n;
+        float sum = static_cast<float>(bias[col]);
+        for (int64_t k = 0; k < input_size; k++) {
+          sum += in[(b * num_groups + g) * input_size + k] *
+                 static_cast<float>(kernel[k * num_experts * output_size + col]);
+        }
+        out[(b * num_experts + e) * output_size + n] = relu && sum < 0.f ? 0.f : sum;
+      }
+    }
+  }
+}
+
+// The gradients of a layer of grouped_layer_fprop_cpu, for the gradient of out in grad
+template <typename T>
+void grouped_layer_bprop_cpu(const std::vector<float>& in, const std::vector<T>& kernel,
+                             const std::vector<float>& grad, int64_t batch_size,
+                             int64_t num_groups, int64_t num_experts, int64_t input_size,
+                             int64_t output_size, std::vector<float>& in_grad,
+                             std::vector<float>& kernel_grad, std::vector<float>& bias_grad) {
+  in_grad.assign(batch_size * num_groups * input_size, 0.f);
+  kernel_grad.assign(input_size * num_experts * output_size, 0.f);
+  bias_grad.assign(num_experts * output_size, 0.f);
+  for (int64_t b = 0; b < batch_size; b++) {
+    for (int64_t e = 0; e < num_experts; e++) {
+      const int64_t g = num_groups == 1 ? 0 : e;
+      for (int64_t n = 0; n < output_size; n++) {
+        const int64_t col = e * output_size + n;
+        const float dy = grad[(b * num_experts + e) * output_size + n];
+        bias_grad[col] += dy;
+        for (int64_t k = 0; k < input_size; k++) {
+          const int64_t in_index = (b * num_groups + g) * input_size + k;
+          kernel_grad[k * num_experts * output_size + col] += in[in_index] * dy;
+          in_grad[in_index] +=
+              static_cast<float>(kernel[k * num_experts * output_size + col]) * dy;
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void grouped_mlp_test(int64_t batch_size, int64_t input_size, int64_t num_experts,
+                      const std::vector<int64_t>& num_outputs, Activation_t act) {
+  constexpr bool use_mixed_precision = std::is_same_v<T, __half>;
+  const int num_layers = num_outputs.size();
+  core23::CURANDGenerator generator(core23::DeviceType::CPU);
+  core23::TensorParams tensor_params =
+      core23::TensorParams()
+          .device(core23::Device::current())
+          .data_type(use_mixed_precision ? core23::ScalarType::Half : core23::ScalarType::Float)
+          .buffer_channel(core23::GetRandomBufferChannel());
+  core23::Tensor bottom_tensor(tensor_params.shape({batch_size, input_size}));
+  core23::Tensor top_tensor(tensor_params.shape({batch_size, num_experts, num_outputs.back()}));
+
+  Core23TempGroupedMLPLayer<T> layer(bottom_tensor, top_tensor, num_experts, num_outputs, act,
+                                     test::get_default_gpu());
+  layer.initialize();
+
+  std::vector<T> h_bottom(batch_size * input_size);
+  test::normal_sync_cpu(h_bottom.data(), h_bottom.size(), 0.f, 1.f, generator);
+  upload(bottom_tensor, h_bottom);
+  std::vector<std::vector<T>> h_kernels(num_layers), h_biases(num_layers);
+  for (int i = 0; i < num_layers; i++) {
+    const int64_t layer_input_size = i == 0 ? input_size : num_outputs[i - 1];
+    h_kernels[i].resize(layer_input_size * num_experts * num_outputs[i]);
+    h_biases[i].resize(num_experts * num_outputs[i]);
+    test::normal_sync_cpu(h_kernels[i].data(), h_kernels[i].size(), 0.f,
+                          1.f / std::sqrt(static_cast<float>(layer_input_size)), generator);
+    test::normal_sync_cpu(h_biases[i].data(), h_biases[i].size(), 0.f, 0.1f, generator);
+    upload(layer.get_kernel(i), h_kernels[i]);
+    upload(layer.get_bias(i), h_biases[i]);
+    upload(layer.get_kernel_grad(i), std::vector<T>(h_kernels[i].size(), T(0.f)));
+    upload(layer.get_bias_grad(i), std::vector<T>(h_biases[i].size(), T(0.f)));
+  }
+
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  layer.fprop(true);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  auto h_top = download<T>(top_tensor);
+
+  std::vector<T> h_top_grad(h_top.size());
+  test::normal_sync_cpu(h_top_grad.data(), h_top_grad.size(), 0.f, 1.f, generator);
+  upload(top_tensor, h_top_grad);
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  layer.bprop();
+  HCTR_LIB_THROW(cudaDeviceSynchronize());
+  auto h_bottom_grad = download<T>(bottom_tensor);
+
+  // The reference keeps the activations in FP32.
+  std::vector<std::vector<float>> outs(num_layers + 1);
+  outs[0].assign(h_bottom.begin(), h_bottom.end());
+  for (int i = 0; i < num_layers; i++) {
+    const bool relu = i != num_layers - 1 || act == Activation_t::Relu;
+    grouped_layer_fprop_cpu(outs[i], h_kernels[i], h_biases[i], batch_size,
+                            i == 0 ? 1 : num_experts, num_experts,
+                            i == 0 ? input_size : num_outputs[i - 1], num_outputs[i], relu,
+                            outs[i + 1]);
+  }
+  std::vector<T> h_expected_top(outs[num_layers].begin(), outs[num_layers].end());
+  ASSERT_TRUE(test::compare_array_approx<T>(h_top.data(), h_expected_top.data(), h_top.size(),
+                                            Eps<T>::value()));
+
+  std::vector<float> grad(h_top_grad.begin(), h_top_grad.end());
+  for (int i = num_layers - 1; i >= 0; i--) {
+    const bool relu = i != num_layers - 1 || act == Activation_t::Relu;
+    if (relu) {
+      for (size_t j = 0; j < grad.size(); j++) {
+        grad[j] = outs[i + 1][j] > 0.f ? grad[j] : 0.f;
+      }
+    }
+    std::vector<float> in_grad, kernel_grad, bias_grad;
+    grouped_layer_bprop_cpu(outs[i], h_kernels[i], grad, batch_size, i == 0 ? 1 : num_experts,
+                            num_experts, i == 0 ? input_size : num_outputs[i - 1], num_outputs[i],
+                            in_grad, kernel_grad, bias_grad);
+    // The weight gradients are sums over the batch.
+    const T wgrad_eps =
+        static_cast<float>(Eps<T>::value()) * std::sqrt(static_cast<float>(batch_size));
+    auto h_kernel_grad = download<T>(layer.get_kernel_grad(i));
+    auto h_bias_grad = download<T>(layer.get_bias_grad(i));
+    std::vector<T> h_expected_kernel_grad(kernel_grad.begin(), kernel_grad.end());
+    std::vector<T> h_expected_bias_grad(bias_grad.begin(), bias_grad.end());
+    ASSERT_TRUE(test::compare_array_approx<T>(h_kernel_grad.data(), h_expected_kernel_grad.data(),
+                                              h_kernel_grad.size(), wgrad_eps));
+    ASSERT_TRUE(test::compare_array_approx<T>(h_bias_grad.data(), h_expected_bias_grad.data(),
+                                              h_bias_grad.size(), wgrad_eps));
+    grad = in_grad;
+  }
+  std::vector<T> h_expected_bottom_grad(grad.begin(), grad.end());
+  ASSERT_TRUE(test::compare_array_approx<T>(h_bottom_grad.data(), h_expected_bottom_grad.data(),
+                                            h_bottom_grad.size(), Eps<T>::value()));
+}
+
+}  // namespace
+
+TEST(grouped_mlp_layer, fp32_256x64_1expert) {
+  grouped_mlp_test<float>(256, 64, 1, {128, 32}, Activation_t::Relu);
+}
+TEST(grouped_mlp_layer, fp32_256x64_8experts) {
+  grouped_mlp_test<float>(256, 64, 8, {128, 64, 32}, Activation_t::Relu);
+}
+TEST(grouped_mlp_layer, fp32_128x100_4experts_single_layer) {
+  grouped_mlp_test<float>(128, 100, 4, {16}, Activation_t::None);
+}
+TEST(grouped_mlp_layer, fp16_256x64_8experts) {
+  grouped_mlp_test<__half>(256, 64, 8, {128, 64, 32}, Activation_t::Relu);
+}
+TEST(grouped_mlp_layer, fp16_512x128_3experts) {
+  grouped_mlp_test<__half>(512, 128, 3, {64, 8}, Activation_t::None);
+}
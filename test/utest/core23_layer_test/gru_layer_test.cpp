@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <core23/tensor_container.hpp>
 #include <cstdlib>
@@ -563,6 +564,75 @@ static void gru_layer_test(int64_t batch_size, int64_t hiddenSize, int64_t embed
   // embedding_vec_size,  h_dweight.get(), h_out.get());
 }
 
+template <typename T>
+static void gru_layer_variable_length_test(int64_t batch_size, int64_t hiddenSize,
+                                           int64_t embedding_vec_size, int64_t SeqLength) {
+  core23::BufferParams blobs_buffer_params = {};
+  blobs_buffer_params.channel = GetBlobsBufferChannel();
+  auto tensor_params = core23::TensorParams()
+                           .data_type(core23::ToScalarType<T>::value)
+                           .buffer_params(blobs_buffer_params);
+
+  int64_t inputTensorSize = batch_size * SeqLength * embedding_vec_size;
+  int64_t outputTensorSize = batch_size * SeqLength * hiddenSize;
+  int64_t hiddenTensorSize = batch_size * hiddenSize;
+  int64_t weightSpaceSize =
+      3 * hiddenSize * embedding_vec_size + 3 * hiddenSize * hiddenSize + 3 * hiddenSize;
+
+  core23::Tensor in_tensor(tensor_params.shape({1, inputTensorSize}));
+  core23::Tensor length_tensor(
+      tensor_params.data_type(core23::ScalarType::Float).shape({batch_size, 1}));
+  core23::Tensor out_tensor(tensor_params.shape({1, outputTensorSize}));
+
+  Core23TempGRULayer<T> gru_layer({in_tensor, length_tensor}, out_tensor, hiddenSize, batch_size,
+                                  SeqLength, embedding_vec_size, test::get_default_gpu());
+  gru_layer.initialize();
+
+  std::vector<T> h_weight(test::align_to_even(weightSpaceSize));
+  std::vector<T> h_in(test::align_to_even(inputTensorSize));
+  std::vector<T> h_hx(hiddenTensorSize, 0);
+  std::vector<T> h_out(outputTensorSize);
+  std::vector<T> cpu_y(outputTensorSize);
+  std::vector<float> h_lengths(batch_size);
+  test::UniformDataSimulator simulator;
+  simulator.fill(h_weight.data(), h_weight.size(), -1, 1);
+  simulator.fill(h_in.data(), h_in.size(), -1, 1);
+  for (int64_t j = 0; j < batch_size; j++) {
+    h_lengths[j] = static_cast<float>((j * 7) % SeqLength + 1);
+  }
+
+  HCTR_LIB_THROW(cudaMemcpy(gru_layer.get_weight(0).template data<T>(), h_weight.data(),
+                            sizeof(T) * weightSpaceSize, cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(gru_layer.get_weight(1).template data<T>(), h_hx.data(),
+                            sizeof(T) * hiddenTensorSize, cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(in_tensor.data(), h_in.data(), sizeof(T) * inputTensorSize,
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(length_tensor.data(), h_lengths.data(), sizeof(float) * batch_size,
+                            cudaMemcpyHostToDevice));
+
+  // The GRU is causal, so a shorter sequence has the leading steps of the full one, and its
+  // remaining steps are filled with 0.
+  cpu_gru<T>(h_weight.data(), h_in.data(), h_hx.data(), cpu_y.data(), hiddenSize,
+             embedding_vec_size, batch_size, SeqLength);
+  for (int64_t i = 0; i < SeqLength; i++) {
+    for (int64_t j = 0; j < batch_size; j++) {
+      if (i >= h_lengths[j]) {
+        std::fill_n(cpu_y.data() + (i * batch_size + j) * hiddenSize, hiddenSize, T(0));
+      }
+    }
+  }
+
+  for (bool is_train : {true, false}) {
+    HCTR_LIB_THROW(cudaMemset(out_tensor.data(), 0xff, sizeof(T) * outputTensorSize));
+    gru_layer.fprop(is_train);
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+    HCTR_LIB_THROW(cudaMemcpy(h_out.data(), out_tensor.data(), sizeof(T) * outputTensorSize,
+                              cudaMemcpyDeviceToHost));
+    ASSERT_TRUE(check_correctness(h_out.data(), cpu_y.data(), outputTensorSize, 1e-3))
+        << "fprop of variable lengths failed, is_train " << is_train;
+  }
+}
+
 }  // namespace
 
 // batch_size, int64_t hiddenSize, int64_t embedding_vec_size, int64_t SeqLength
@@ -581,3 +651,9 @@ TEST(gru_layer, fp32_256x128x256x256) { gru_layer_test<float>(256, 128, 256, 256
 TEST(gru_layer, fp32_128x256x256x64) { gru_layer_test<float>(128, 256, 256, 64); }
 TEST(gru_layer, fp32_128x256x256x128) { gru_layer_test<float>(128, 256, 256, 128); }
 // TEST(gru_layer, fp32_1024x512x1024x128) { gru_layer_test<float>(1024, 512, 1024, 128); }
+TEST(gru_layer, fp32_variable_length_32x64x32x20) {
+  gru_layer_variable_length_test<float>(32, 64, 32, 20);
+}
+TEST(gru_layer, fp32_variable_length_8x256x64x50) {
+  gru_layer_variable_length_test<float>(8, 256, 64, 50);
+}
@@ -285,6 +285,8 @@ void interaction_layer_test(int64_t height, int64_t n_emb, int64_t in_width,
 }  // namespace
 
 TEST(interaction_layer, fp32_512x479) { interaction_layer_test<float>(512, 26, 128); }
+TEST(interaction_layer, fp32_512x451) { interaction_layer_test<float>(512, 26, 100); }
+TEST(interaction_layer, fp32_512x863) { interaction_layer_test<float>(512, 26, 512); }
 
 TEST(interaction_layer, fp32_512x1340) { interaction_layer_test<float>(512, 33, 128); }
 TEST(interaction_layer, tf32_512x479) { interaction_layer_test<float>(512, 26, 128, true); }
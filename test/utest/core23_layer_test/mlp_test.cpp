@@ -608,6 +608,95 @@ static void mlp_test(std::vector<Layer_t> network,
   layers.clear();
 }
 
+static void fill_same_data(const core23::Tensor& lhs, const core23::Tensor& rhs, float range) {
+  std::vector<__half> h_data(lhs.num_elements());
+  for (auto& value : h_data) {
+    value = __float2half(range * (2.0f * rand() / RAND_MAX - 1.0f));
+  }
+  HCTR_LIB_THROW(cudaMemcpy(lhs.data(), h_data.data(), lhs.num_bytes(), cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(rhs.data(), h_data.data(), rhs.num_bytes(), cudaMemcpyHostToDevice));
+}
+
+static double relative_l1_error(const core23::Tensor& expected, const core23::Tensor& actual) {
+  std::vector<__half> h_expected(expected.num_elements());
+  std::vector<__half> h_actual(actual.num_elements());
+  HCTR_LIB_THROW(cudaMemcpy(h_expected.data(), expected.data(), expected.num_bytes(),
+                            cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(
+      cudaMemcpy(h_actual.data(), actual.data(), actual.num_bytes(), cudaMemcpyDeviceToHost));
+  double diff = 0.0;
+  double norm = 0.0;
+  for (size_t i = 0; i < h_expected.size(); i++) {
+    diff += std::abs(__half2float(h_expected[i]) - __half2float(h_actual[i]));
+    norm += std::abs(__half2float(h_expected[i]));
+  }
+  return diff / std::max(norm, 1e-12);
+}
+
+// Runs the same MLP in FP16 and in FP8, and checks that the tops and the gradients agree up to the
+// precision of FP8. The first iteration finds the amaxes, which the second one uses as scales.
+static void mlp_fp8_test(const std::vector<int64_t>& num_outputs, int64_t input_dim,
+                         int64_t batch_size) {
+  std::shared_ptr<GPUResource> gpu_resource = test::get_default_gpu();
+  if (gpu_resource->get_cc_major() * 10 + gpu_resource->get_cc_minor() < 89) {
+    GTEST_SKIP() << "FP8 requires a GPU of compute capability 8.9 or up";
+  }
+
+  core23::BufferParams buffer_params = {};
+  buffer_params.channel = GetBlobsBufferChannel();
+  auto tensor_params = core23::TensorParams()
+                           .data_type(core23::ToScalarType<__half>::value)
+                           .buffer_params(buffer_params);
+  std::vector<Activation_t> acts(num_outputs.size(), Activation_t::Relu);
+  acts.back() = Activation_t::None;
+  std::vector<bool> use_bias(num_outputs.size(), true);
+
+  std::vector<core23::Tensor> bottoms, tops;
+  std::vector<std::unique_ptr<Core23TempMLPLayer<__half>>> mlps;
+  for (bool use_fp8 : {false, true}) {
+    bottoms.emplace_back(tensor_params.shape({batch_size, input_dim}));
+    tops.emplace_back(tensor_params.shape({batch_size, num_outputs.back()}));
+    mlps.emplace_back(new Core23TempMLPLayer<__half>(
+        {bottoms.back()}, {tops.back()}, num_outputs, gpu_resource, acts, use_bias,
+        std::vector<Initializer_t>(), false, false, false, false, use_fp8));
+    mlps.back()->initialize();
+  }
+  for (size_t i = 0; i < num_outputs.size(); i++) {
+    const int64_t fan_in = mlps[0]->get_kernel(i).shape().size(0);
+    fill_same_data(mlps[0]->get_kernel(i), mlps[1]->get_kernel(i), 1.0f / std::sqrt(fan_in));
+    fill_same_data(mlps[0]->get_bias(i), mlps[1]->get_bias(i), 0.1f);
+  }
+
+  for (int iter = 0; iter < 2; iter++) {
+    fill_same_data(bottoms[0], bottoms[1], 1.0f);
+    for (auto& mlp : mlps) {
+      mlp->fprop(true);
+    }
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+    if (iter == 1) {
+      ASSERT_LT(relative_l1_error(tops[0], tops[1]), 0.05) << "fprop cross_check result fail";
+    }
+
+    fill_same_data(tops[0], tops[1], 1.0f);
+    for (auto& mlp : mlps) {
+      for (size_t i = 0; i < num_outputs.size(); i++) {
+        auto& kernel_grad = mlp->get_kernel_grad(i);
+        HCTR_LIB_THROW(cudaMemset(kernel_grad.data(), 0, kernel_grad.num_bytes()));
+      }
+      mlp->bprop();
+    }
+    HCTR_LIB_THROW(cudaDeviceSynchronize());
+  }
+
+  for (size_t i = 0; i < num_outputs.size(); i++) {
+    ASSERT_LT(relative_l1_error(mlps[0]->get_kernel_grad(i), mlps[1]->get_kernel_grad(i)), 0.05)
+        << "kernel_grad cross_check result fail";
+    ASSERT_LT(relative_l1_error(mlps[0]->get_bias_grad(i), mlps[1]->get_bias_grad(i)), 0.05)
+        << "bias_grad cross_check result fail";
+  }
+  ASSERT_LT(relative_l1_error(bottoms[0], bottoms[1]), 0.05) << "dgrad cross_check result fail";
+}
+
 ConfigSet function_config_set = {false, false, true, 10, 1};
 ConfigSet perf_config_set = {true, true, true, 10, 1};
 
@@ -635,6 +724,8 @@ TEST(mlp_test_tf32, all) {
                   batch_size, function_config_set);
 };
 
+TEST(mlp_test_fp8, all) { mlp_fp8_test({256, 128, 64}, 64, 256); };
+
 TEST(mlp_test_fp16_perf, all) {
   mlp_test<__half>(network, mlp_num_outputs, use_relu, use_bias, use_fuse_wb, false, input_dim,
                    batch_size, perf_config_set);
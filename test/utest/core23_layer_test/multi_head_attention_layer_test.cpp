@@ -455,7 +455,8 @@ void multi_head_attention_dgrad_3d_cpu_fused(T *in_dgrad, T **h_ins, T *softmax,
 template <typename T>
 void multi_head_attention_layer_test_fused(int64_t batch_size, int64_t seq_from, int64_t seq_to,
                                            int64_t hidden_dim, int head_num,
-                                           bool enable_tf32_compute = false) {
+                                           bool enable_tf32_compute = false,
+                                           bool recompute_activations = false) {
   constexpr bool use_mixed_precision = std::is_same_v<T, __half>;
   auto device = core23::Device::current();
   core23::CURANDGenerator generator(core23::DeviceType::CPU);
@@ -479,7 +480,7 @@ void multi_head_attention_layer_test_fused(int64_t batch_size, int64_t seq_from,
   std::vector<core23::Tensor> output_3d_tensors;
   MultiHeadAttentionLayer<T> multi_head_attention_3d_layer(
       input_3d_tensors, output_3d_tensors, head_num, true, test::get_default_gpu(),
-      use_mixed_precision, enable_tf32_compute);
+      use_mixed_precision, enable_tf32_compute, recompute_activations);
 
   std::unique_ptr<T *[]> h_cpu_ins(new T *[num]);
   std::unique_ptr<T[]> h_d_out(new T[q_size]);
@@ -553,3 +554,13 @@ TEST(mha_layer, fp16_debug) {
 }
 
 TEST(mha_layer, fp32_debug) { multi_head_attention_layer_test_fused<float>(2, 4, 4, 16, 1); }
+
+// heads of more than 128 dims don't use the fused kernels
+TEST(mha_layer, fp32_unfused_64x20x1024) {
+  multi_head_attention_layer_test_fused<float>(64, 20, 30, 1024, 4);
+}
+
+TEST(mha_layer, fp32_recompute) {
+  multi_head_attention_layer_test_fused<float>(512, 30, 60, 128, 4, false, true);
+  multi_head_attention_layer_test_fused<float>(64, 20, 30, 1024, 4, false, true);
+}
@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include <data_readers/multi_hot/detail/batch_locations.hpp>
+#include <data_readers/multi_hot/variable_format.hpp>
 
 using namespace HugeCTR;
 
@@ -74,6 +75,34 @@ TEST(static_batch_locations, multiple_threads) {
   }
 }
 
+TEST(static_batch_locations, multiple_threads_begin_at) {
+  size_t num_batches = 51;
+  size_t batch_size_bytes = 4;
+  size_t start_offset = 0;
+  size_t end_offset = 51 * batch_size_bytes;
+  size_t num_threads = 4;
+  size_t first_batch = 22;
+
+  BatchLocations locations(batch_size_bytes, start_offset, end_offset);
+  auto thread_locations = locations.distribute(num_threads);
+
+  // Every thread resumes at its first batch from first_batch, and later wraps to its first one.
+  size_t num_remaining = 0;
+  for (auto& local_thread_locations : thread_locations) {
+    auto it = local_thread_locations->begin_at(first_batch);
+    num_remaining += local_thread_locations->end() - it;
+    size_t expected = (*local_thread_locations->begin()).i;
+    while (expected < first_batch) {
+      expected += num_threads;
+    }
+    for (; it != local_thread_locations->end(); it++, expected += num_threads) {
+      ASSERT_EQ((*it).i, expected);
+    }
+    ASSERT_EQ((*it).i, (*local_thread_locations->begin()).i);
+  }
+  ASSERT_EQ(num_remaining, num_batches - first_batch);
+}
+
 TEST(static_batch_locations, single_thread_sharded) {
   size_t num_batches = 51;
   size_t batch_size_bytes = 5000;
@@ -190,4 +219,68 @@ TEST(static_batch_locations, multiple_threads_sharded) {
       }
     }
   }
-}
\ No newline at end of file
+}
+TEST(indexed_batch_locations, single_thread_sharded) {
+  // 10 samples of 4 + i bytes after a header of 16 bytes, in batches of 4 samples.
+  auto offsets = std::make_shared<std::vector<uint64_t>>(1, 16);
+  for (size_t i = 0; i < 10; ++i) {
+    offsets->push_back(offsets->back() + 4 + i);
+  }
+  const size_t batch_size = 4;
+  const size_t num_shards = 2;
+
+  IndexedBatchLocations locations(offsets, batch_size);
+  ASSERT_EQ(locations.count(), 3);
+
+  auto sharded_locations = locations.shard(num_shards, 0);
+  ASSERT_EQ(sharded_locations.size(), num_shards);
+  // The largest shard holds samples 6 and 7.
+  ASSERT_EQ(sharded_locations[1]->get_max_shard_size_bytes(), 10 + 11);
+
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    auto it = sharded_locations[shard]->begin();
+    for (size_t batch = 0; batch < 3; ++batch, ++it) {
+      auto location = *it;
+      const size_t first = std::min<size_t>(10, batch * batch_size + shard * 2);
+      const size_t last = std::min<size_t>(10, first + 2);
+      ASSERT_EQ(location.id, batch);
+      ASSERT_EQ(location.first_sample, first);
+      ASSERT_EQ(location.shard_samples, last - first);
+      ASSERT_EQ(location.batch_samples, batch < 2 ? 4 : 2);
+      ASSERT_EQ(location.shard_size_bytes, (*offsets)[last] - (*offsets)[first]);
+      ASSERT_EQ(location.offset, first < last ? (*offsets)[first] : SIZE_MAX);
+    }
+  }
+}
+
+TEST(indexed_batch_locations, token_budget) {
+  // 10 samples of 1 to 10 keys, in batches of at most 4 samples and 12 keys. Sample 9 exceeds
+  // the budget on its own.
+  auto offsets = std::make_shared<std::vector<uint64_t>>(1, 16);
+  std::vector<uint32_t> num_keys;
+  for (size_t i = 0; i < 10; ++i) {
+    num_keys.push_back(i == 9 ? 13 : i + 1);
+    offsets->push_back(offsets->back() + 4 * (num_keys.back() + 1));
+  }
+  auto first_samples = MultiHot::get_token_budget_batches(num_keys, 4, 12);
+  ASSERT_EQ(*first_samples, std::vector<size_t>({0, 4, 6, 7, 8, 9, 10}));
+
+  const size_t num_shards = 2;
+  IndexedBatchLocations locations(offsets, 4, false, 0, first_samples);
+  ASSERT_EQ(locations.count(), 6);
+  auto sharded_locations = locations.shard(num_shards, 0);
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    auto it = sharded_locations[shard]->begin();
+    for (size_t batch = 0; batch < 6; ++batch, ++it) {
+      auto location = *it;
+      const size_t batch_end = (*first_samples)[batch + 1];
+      const size_t first = std::min(batch_end, (*first_samples)[batch] + shard * 2);
+      const size_t last = std::min(batch_end, first + 2);
+      ASSERT_EQ(location.id, batch);
+      ASSERT_EQ(location.first_sample, first);
+      ASSERT_EQ(location.shard_samples, last - first);
+      ASSERT_EQ(location.batch_samples, batch_end - (*first_samples)[batch]);
+      ASSERT_EQ(location.shard_size_bytes, (*offsets)[last] - (*offsets)[first]);
+    }
+  }
+}
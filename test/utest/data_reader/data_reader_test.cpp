@@ -44,7 +44,7 @@ const std::string file_list_name("data_reader_file_list.txt");
 const std::string prefix("./data_reader_test_data/temp_dataset_");
 const Check_t CHK = Check_t::Sum;
 
-void data_reader_worker_norm_test_impl(bool repeat) {
+void data_reader_worker_norm_test_impl(bool repeat, Check_t read_check = CHK) {
   std::vector<T> generated_sparse_value;
   std::vector<T> generated_sparse_rowoffset;
   std::vector<float> generated_label_data;
@@ -97,8 +97,8 @@ void data_reader_worker_norm_test_impl(bool repeat) {
   // setup a data reader
   std::shared_ptr<std::atomic<bool>> loop_flag = std::make_shared<std::atomic<bool>>(1);
   core23_reader::DataReaderWorker<T> data_reader(0, 1, local_gpu, loop_flag, thread_buffer,
-                                                 file_list_name, buffer_length, repeat, CHK,
-                                                 params);
+                                                 file_list_name, buffer_length, repeat,
+                                                 read_check, params);
   // call read a batch
   size_t value_offset = 0;
   int round = (num_samples - 1) / batchsize + 1;
@@ -232,6 +232,10 @@ TEST(data_reader_worker, data_reader_worker_test_1) { data_reader_worker_norm_te
 
 TEST(data_reader_worker, data_reader_worker_test_2) { data_reader_worker_norm_test_impl(false); }
 
+TEST(data_reader_worker, data_reader_worker_test_deferred_checksum) {
+  data_reader_worker_norm_test_impl(false, Check_t::SumDeferred);
+}
+
 TEST(data_reader_test, data_reader_test_repeat_1) {
   data_reader_norm_test_impl({0}, 1, true, false);
 }
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <common.hpp>
+#include <core23/tensor_operations.hpp>
+#include <data_readers/in_memory_data_reader.hpp>
+#include <memory>
+#include <numeric>
+#include <resource_managers/resource_manager_ext.hpp>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const size_t batch_size = 64;
+const size_t label_dim = 1;
+const size_t dense_dim = 3;
+const std::vector<int> hotness = {1, 3};
+
+struct HostBatch {
+  std::vector<float> labels;
+  std::vector<float> dense;
+  std::vector<std::vector<long long>> keys;
+};
+
+HostBatch get_host_batch(size_t batch_id) {
+  HostBatch batch;
+  batch.labels.resize(batch_size * label_dim);
+  batch.dense.resize(batch_size * dense_dim);
+  std::iota(batch.labels.begin(), batch.labels.end(), batch_id * 1000.f);
+  std::iota(batch.dense.begin(), batch.dense.end(), batch_id * 2000.f);
+  for (const int h : hotness) {
+    std::vector<long long> keys(batch_size * h);
+    std::iota(keys.begin(), keys.end(), batch_id * 3000);
+    batch.keys.push_back(keys);
+  }
+  return batch;
+}
+
+// Binds the host batch, or uploads it to gpu 0 when on_device is set.
+InMemoryBatch get_batch(const HostBatch& host_batch, bool on_device) {
+  InMemoryBatch batch;
+  const core23::Device host(core23::DeviceType::CPU);
+  auto bind = [&](const auto& data, core23::DataType data_type, int64_t dim) {
+    core23::Tensor tensor = core23::Tensor::bind(const_cast<void*>(static_cast<const void*>(
+                                                     data.data())),
+                                                 {static_cast<int64_t>(batch_size), dim},
+                                                 data_type, host);
+    if (!on_device) {
+      return tensor;
+    }
+    core23::Tensor device_tensor(core23::TensorParams()
+                                     .shape(tensor.shape())
+                                     .data_type(data_type)
+                                     .device({core23::DeviceType::GPU, 0}));
+    core23::copy_sync(device_tensor, tensor);
+    return device_tensor;
+  };
+  batch.labels.push_back(bind(host_batch.labels, core23::ScalarType::Float, label_dim));
+  batch.dense.push_back(bind(host_batch.dense, core23::ScalarType::Float, dense_dim));
+  batch.sparse.emplace_back();
+  for (size_t fea_id = 0; fea_id < hotness.size(); ++fea_id) {
+    batch.sparse[0].push_back(
+        bind(host_batch.keys[fea_id], core23::ScalarType::LongLong, hotness[fea_id]));
+  }
+  return batch;
+}
+
+template <typename T>
+std::vector<T> download(const core23::Tensor& tensor) {
+  std::vector<T> data(tensor.num_elements());
+  HCTR_LIB_THROW(cudaMemcpy(data.data(), tensor.data(), tensor.num_bytes(), cudaMemcpyDefault));
+  return data;
+}
+
+void in_memory_data_reader_test(bool on_device, bool fixed_buffers) {
+  const auto resource_manager = ResourceManagerExt::create({{0}}, 424242);
+  std::vector<DataReaderSparseParam> params = {
+      DataReaderSparseParam("data", hotness, true, static_cast<int>(hotness.size()))};
+  InMemoryDataReader<long long> reader(resource_manager, batch_size, params, label_dim, dense_dim,
+                                       false, 2, fixed_buffers);
+
+  // The batches are pushed while they are read, through a queue of 2 batches.
+  const size_t num_batches = 7;
+  std::vector<HostBatch> host_batches;
+  for (size_t batch_id = 0; batch_id < num_batches; ++batch_id) {
+    host_batches.push_back(get_host_batch(batch_id));
+  }
+  std::thread producer([&] {
+    for (const auto& host_batch : host_batches) {
+      reader.push(get_batch(host_batch, on_device));
+    }
+    reader.finish();
+  });
+
+  for (size_t batch_id = 0; batch_id < num_batches; ++batch_id) {
+    ASSERT_EQ(reader.read_a_batch_to_device(), batch_size);
+    EXPECT_FALSE(reader.current_batch_incomplete());
+    HCTR_LIB_THROW(cudaStreamSynchronize(resource_manager->get_local_gpu(0)->get_stream()));
+    EXPECT_EQ(download<float>(reader.get_label_tensor23s()[0]), host_batches[batch_id].labels);
+    EXPECT_EQ(download<float>(reader.get_dense_tensor23s()[0]), host_batches[batch_id].dense);
+    for (size_t fea_id = 0; fea_id < hotness.size(); ++fea_id) {
+      EXPECT_EQ(download<long long>(reader.get_current_sparse_values()[0][fea_id]),
+                host_batches[batch_id].keys[fea_id]);
+    }
+  }
+  EXPECT_EQ(reader.read_a_batch_to_device(), 0);
+  producer.join();
+}
+
+}  // namespace
+
+TEST(in_memory_data_reader_test, host) { in_memory_data_reader_test(false, false); }
+TEST(in_memory_data_reader_test, device) { in_memory_data_reader_test(true, false); }
+TEST(in_memory_data_reader_test, device_fixed_buffers) { in_memory_data_reader_test(true, true); }
+
+TEST(in_memory_data_reader_test, wrong_batch) {
+  const auto resource_manager = ResourceManagerExt::create({{0}}, 424242);
+  std::vector<DataReaderSparseParam> params = {
+      DataReaderSparseParam("data", hotness, true, static_cast<int>(hotness.size()))};
+  InMemoryDataReader<long long> reader(resource_manager, batch_size, params, label_dim, dense_dim,
+                                       false, 2, false);
+  HostBatch host_batch = get_host_batch(0);
+  host_batch.keys[1].resize(batch_size);
+  EXPECT_THROW(reader.push(get_batch(host_batch, false)), core23::RuntimeError);
+}
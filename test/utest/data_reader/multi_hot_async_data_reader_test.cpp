@@ -210,6 +210,69 @@ void async_data_reader_test(std::vector<int> device_list, size_t batch_size,
   }
 }
 
+template <typename dtype>
+void synthetic_data_reader_test(size_t batch_size, int label_dim, int dense_dim,
+                                const std::vector<int>& multi_hot_sizes,
+                                const std::vector<long long>& vocabulary_sizes,
+                                const std::vector<float>& alphas) {
+  HCTR_LIB_THROW(nvmlInit_v2());
+  std::vector<std::vector<int>> vvgpu{{0}};
+  const auto resource_manager = ResourceManagerExt::create(vvgpu, 424242);
+  const int sparse_dim = static_cast<int>(multi_hot_sizes.size());
+  std::vector<DataReaderSparseParam> params{
+      DataReaderSparseParam("dummy", multi_hot_sizes, true, sparse_dim)};
+
+  SyntheticSource synthetic_source{vocabulary_sizes, alphas, 7};
+  FileSource source;
+  source.name = "__tmp_synthetic.dat";  // never read
+  source.slot_id = 0;
+
+  // Two readers of the same seed generate the same batches.
+  using DataReaderType = HugeCTR::MultiHot::core23_reader::AsyncDataReader<dtype>;
+  DataReaderType data_reader({source}, resource_manager, batch_size, 1, 1, params, label_dim,
+                             dense_dim, false, false, false, true, IOBackend_t::AIO, 1, {},
+                             synthetic_source);
+  DataReaderType ref_reader({source}, resource_manager, batch_size, 1, 1, params, label_dim,
+                            dense_dim, false, false, false, true, IOBackend_t::AIO, 1, {},
+                            synthetic_source);
+  data_reader.start();
+  ref_reader.start();
+
+  for (int batch = 0; batch < 3; ++batch) {
+    ASSERT_EQ(data_reader.read_a_batch_to_device(), static_cast<long long>(batch_size));
+    ASSERT_EQ(ref_reader.read_a_batch_to_device(), static_cast<long long>(batch_size));
+    ASSERT_FALSE(data_reader.current_batch_incomplete());
+
+    std::vector<float> labels, denses;
+    core23::copy_sync(labels, data_reader.get_label_tensor23s()[0]);
+    core23::copy_sync(denses, data_reader.get_dense_tensor23s()[0]);
+    for (float label : labels) {
+      ASSERT_TRUE(label == 0.f || label == 1.f);
+    }
+    for (float dense : denses) {
+      ASSERT_GE(dense, 0.f);
+      ASSERT_LT(dense, 1.f);
+    }
+
+    for (int feat_id = 0; feat_id < sparse_dim; ++feat_id) {
+      std::vector<dtype> keys, ref_keys;
+      core23::copy_sync(keys, data_reader.get_current_sparse_values()[0][feat_id]);
+      core23::copy_sync(ref_keys, ref_reader.get_current_sparse_values()[0][feat_id]);
+      ASSERT_EQ(keys, ref_keys);
+
+      size_t num_lower_keys = 0;
+      for (dtype key : keys) {
+        ASSERT_LT(static_cast<long long>(key), vocabulary_sizes[feat_id]);
+        num_lower_keys += static_cast<long long>(key) < vocabulary_sizes[feat_id] / 2;
+      }
+      // With a power law, most keys are in the lower half of the vocabulary.
+      if (alphas[feat_id] > 0.f) {
+        ASSERT_GT(num_lower_keys, keys.size() * 3 / 5);
+      }
+    }
+  }
+}
+
 // class MPIEnvironment : public ::testing::Environment {
 // protected:
 //  virtual void SetUp() { test::mpi_init(); }
@@ -236,4 +299,11 @@ TEST(async_data_reader_test, gpu_1x_multiple_batches_per_thread) {
 TEST(async_data_reader_test, gpu_8x_incomplete_batch) {
   async_data_reader_test<uint32_t>({0, 1, 2, 3, 4, 5, 6, 7}, 128, 1, 1, 2, 3, 5, 1,
                                    global_seed += 128, true);
-}
\ No newline at end of file
+}
+TEST(async_data_reader_test, gpu_1x_synthetic) {
+  synthetic_data_reader_test<uint32_t>(4096, 1, 13, {1, 3, 2}, {1000, 50, 1000},
+                                       {1.1f, 0.f, 0.5f});
+}
+TEST(async_data_reader_test, gpu_1x_synthetic_long_long) {
+  synthetic_data_reader_test<long long>(4096, 2, 3, {2, 4}, {1ll << 40, 10}, {1.f, 2.f});
+}
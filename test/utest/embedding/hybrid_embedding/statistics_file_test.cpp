@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <embeddings/dataset_stats.hpp>
+#include <embeddings/hybrid_embedding/statistics_file.hpp>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+using namespace HugeCTR::hybrid_embedding;
+
+namespace {
+
+template <typename dtype>
+void statistics_file_round_trip_test() {
+  const std::string file_name = "hybrid_embedding_statistics_test.json";
+  const std::vector<size_t> table_sizes{10, 5, 20};
+
+  // Categories 3 and 7 are in table 0, 12 in table 1 and 15, 30 in table 2.
+  CategoryCounts<dtype> counts{{12, 40}, {3, 100}, {30, 10}, {7, 100}, {15, 20}};
+  save_category_counts<dtype>(file_name, counts, table_sizes, 100, 4);
+
+  const DatasetStats stats{load_dataset_stats(file_name)};
+  EXPECT_EQ(stats.num_samples, 100);
+  ASSERT_EQ(stats.tables.size(), table_sizes.size());
+  const TableKeyStats& table_0{stats.tables.at("table_0")};
+  EXPECT_EQ(table_0.num_keys, 100);
+  EXPECT_EQ(table_0.num_unique_keys, 2);
+  EXPECT_EQ(table_0.pooling_factor_histogram.at(1), 100);
+  ASSERT_EQ(table_0.top_keys.size(), 2);
+  EXPECT_EQ(table_0.top_keys[0], std::pair<int64_t, int64_t>(3, 100));
+  EXPECT_EQ(table_0.top_keys[1], std::pair<int64_t, int64_t>(7, 100));
+  const TableKeyStats& table_1{stats.tables.at("table_1")};
+  ASSERT_EQ(table_1.top_keys.size(), 1);
+  EXPECT_EQ(table_1.top_keys[0], std::pair<int64_t, int64_t>(2, 40));
+  // Only the 4 most frequent are top keys, so category 30 is unique but not listed.
+  const TableKeyStats& table_2{stats.tables.at("table_2")};
+  EXPECT_EQ(table_2.num_unique_keys, 2);
+  ASSERT_EQ(table_2.top_keys.size(), 1);
+  EXPECT_EQ(table_2.top_keys[0], std::pair<int64_t, int64_t>(0, 20));
+
+  // The counts are scaled to the samples, and keys outside of their table are dropped.
+  const CategoryCounts<dtype> loaded{
+      load_category_counts<dtype>(file_name, std::vector<size_t>{10, 2, 20}, 50)};
+  const CategoryCounts<dtype> expected{{3, 50}, {7, 50}, {12, 10}};
+  EXPECT_EQ(loaded, expected);
+
+  std::remove(file_name.c_str());
+}
+
+}  // namespace
+
+TEST(statistics_file_test, round_trip_uint32) { statistics_file_round_trip_test<uint32_t>(); }
+
+TEST(statistics_file_test, round_trip_long_long) { statistics_file_round_trip_test<long long>(); }
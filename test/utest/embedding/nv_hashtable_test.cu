@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <hashtable/nv_hashtable.hpp>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+template <typename T>
+T* to_device(const std::vector<T>& h) {
+  T* d;
+  HCTR_LIB_THROW(cudaMalloc(&d, std::max<size_t>(h.size(), 1) * sizeof(T)));
+  HCTR_LIB_THROW(cudaMemcpy(d, h.data(), h.size() * sizeof(T), cudaMemcpyHostToDevice));
+  return d;
+}
+
+template <typename T>
+std::vector<T> to_host(const T* d, const size_t size) {
+  std::vector<T> h(size);
+  HCTR_LIB_THROW(cudaMemcpy(h.data(), d, size * sizeof(T), cudaMemcpyDeviceToHost));
+  return h;
+}
+
+template <typename KeyType>
+void nv_hashtable_test(const HashTableBackend backend, const size_t capacity,
+                       const size_t num_keys) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<KeyType> dist(0, static_cast<KeyType>(capacity * 2 / 3));
+  std::vector<KeyType> h_keys(num_keys);
+  std::generate(h_keys.begin(), h_keys.end(), [&] { return dist(gen); });
+
+  HashTable<KeyType, size_t> table(capacity, 0, backend);
+  cudaStream_t stream = 0;
+  KeyType* d_keys = to_device(h_keys);
+  size_t* d_vals = to_device(std::vector<size_t>(num_keys));
+
+  // get_insert gives each unique key the next value of the counter.
+  table.get_insert(d_keys, d_vals, num_keys, stream);
+  const std::vector<size_t> h_vals = to_host(d_vals, num_keys);
+  std::map<KeyType, size_t> expected;
+  for (size_t i = 0; i < num_keys; ++i) {
+    const auto it = expected.emplace(h_keys[i], h_vals[i]).first;
+    ASSERT_EQ(it->second, h_vals[i]) << "key " << h_keys[i];
+  }
+  const size_t num_unique = expected.size();
+  std::vector<bool> seen(num_unique, false);
+  for (const auto& kv : expected) {
+    ASSERT_LT(kv.second, num_unique);
+    ASSERT_FALSE(seen[kv.second]);
+    seen[kv.second] = true;
+  }
+  ASSERT_EQ(table.get_value_head(stream), num_unique);
+  ASSERT_EQ(table.get_size(stream), num_unique);
+
+  // get finds the same values, and get_mark marks the missing keys.
+  size_t* d_found = to_device(std::vector<size_t>(num_keys));
+  table.get(d_keys, d_found, num_keys, stream);
+  ASSERT_EQ(to_host(d_found, num_keys), h_vals);
+  const std::vector<KeyType> h_missing = {static_cast<KeyType>(capacity),
+                                          static_cast<KeyType>(capacity + 1)};
+  KeyType* d_missing = to_device(h_missing);
+  table.get_mark(d_missing, d_found, h_missing.size(), stream);
+  for (const size_t val : to_host(d_found, h_missing.size())) {
+    ASSERT_EQ(val, std::numeric_limits<size_t>::max());
+  }
+
+  // set overwrites the values, and dump returns all pairs.
+  std::vector<KeyType> h_unique_keys;
+  std::vector<size_t> h_new_vals;
+  for (const auto& kv : expected) {
+    h_unique_keys.push_back(kv.first);
+    h_new_vals.push_back(kv.second + 1000);
+  }
+  KeyType* d_unique_keys = to_device(h_unique_keys);
+  size_t* d_new_vals = to_device(h_new_vals);
+  table.set(d_unique_keys, d_new_vals, num_unique, stream);
+
+  KeyType* d_dump_keys = to_device(std::vector<KeyType>(num_unique));
+  size_t* d_dump_vals = to_device(std::vector<size_t>(num_unique));
+  size_t* d_dump_counter = to_device(std::vector<size_t>(1));
+  table.dump(d_dump_keys, d_dump_vals, d_dump_counter, stream);
+  ASSERT_EQ(to_host(d_dump_counter, 1)[0], num_unique);
+  const std::vector<KeyType> h_dump_keys = to_host(d_dump_keys, num_unique);
+  const std::vector<size_t> h_dump_vals = to_host(d_dump_vals, num_unique);
+  for (size_t i = 0; i < num_unique; ++i) {
+    ASSERT_EQ(h_dump_vals[i], expected.at(h_dump_keys[i]) + 1000);
+  }
+
+  table.clear(stream);
+  ASSERT_EQ(table.get_size(stream), 0);
+  ASSERT_EQ(table.get_value_head(stream), 0);
+
+  for (void* ptr : std::vector<void*>{d_keys, d_vals, d_found, d_missing, d_unique_keys,
+                                      d_new_vals, d_dump_keys, d_dump_vals, d_dump_counter}) {
+    HCTR_LIB_THROW(cudaFree(ptr));
+  }
+}
+
+}  // namespace
+
+TEST(nv_hashtable_test, static_map_uint32) {
+  nv_hashtable_test<unsigned int>(HashTableBackend::StaticMap, 100000, 200000);
+}
+TEST(nv_hashtable_test, static_map_int64) {
+  nv_hashtable_test<long long>(HashTableBackend::StaticMap, 100000, 200000);
+}
+TEST(nv_hashtable_test, static_map_high_load) {
+  nv_hashtable_test<long long>(HashTableBackend::StaticMap, 1024, 100000);
+}
+TEST(nv_hashtable_test, concurrent_unordered_map_uint32) {
+  nv_hashtable_test<unsigned int>(HashTableBackend::ConcurrentUnorderedMap, 100000, 200000);
+}
+TEST(nv_hashtable_test, concurrent_unordered_map_int64) {
+  nv_hashtable_test<long long>(HashTableBackend::ConcurrentUnorderedMap, 100000, 200000);
+}
@@ -245,6 +245,30 @@ ShardConfiguration row_wise_sharding(const RuntimeConfiguration &runtime_config,
   return {shard_matrix, {{TablePlacementStrategy::ModelParallel, table_ids}}};
 }
 
+ShardConfiguration column_wise_sharding(
+    const RuntimeConfiguration &runtime_config,
+    const std::vector<EmbeddingConfiguration> &embedding_config, int num_column_shards) {
+  int num_global_gpus = runtime_config.num_node * runtime_config.num_gpus_per_node;
+  int num_table = get_num_table(embedding_config);
+
+  // Each table is split into num_column_shards slices of its embedding vectors, on consecutive
+  // GPUs. The c-th column group holds the c-th slice of every table.
+  std::vector<std::vector<int>> shard_matrix(num_global_gpus, std::vector<int>(num_table, 0));
+  for (int table_id = 0; table_id < num_table; ++table_id) {
+    for (int c = 0; c < num_column_shards; ++c) {
+      shard_matrix[(table_id + c) % num_global_gpus][table_id] = 1;
+    }
+  }
+  std::vector<int> table_ids(num_table);
+  std::iota(table_ids.begin(), table_ids.end(), 0);
+
+  std::vector<embedding::GroupedTableParam> grouped_table_params;
+  for (int c = 0; c < num_column_shards; ++c) {
+    grouped_table_params.push_back({TablePlacementStrategy::ModelParallel, table_ids, c});
+  }
+  return {shard_matrix, grouped_table_params};
+}
+
 ShardConfiguration hybrid_sharding(const RuntimeConfiguration &runtime_config,
                                    const std::vector<EmbeddingConfiguration> &embedding_config) {
   int num_local_gpus = runtime_config.num_gpus_per_node;
@@ -332,12 +356,15 @@ struct EmbeddingCollectionOption {
   embedding::SortStrategy sort_strategy;
   embedding::AllreduceStrategy allreduce_strategy;
   embedding::CommunicationStrategy comm_strategy;
+  bool deterministic = false;  // Reduces the gradients of all tables in a fixed order
+  int num_lookup_streams = 1;
 };
 std::ostream &operator<<(std::ostream &os, const EmbeddingCollectionOption &p) {
   os << "\n\tinput_layout:" << p.input_layout << "\n\toutput_layout:" << p.output_layout
      << "\n\tkeys_preprocess_strategy:" << p.keys_preprocess_strategy
      << "\n\tsort_strategy:" << p.sort_strategy << "\n\tallreduce_strategy:" << p.allreduce_strategy
-     << "\n\tcomm_strategy:" << p.comm_strategy << std::endl;
+     << "\n\tcomm_strategy:" << p.comm_strategy << "\n\tdeterministic:" << p.deterministic
+     << "\n\tnum_lookup_streams:" << p.num_lookup_streams << std::endl;
   return os;
 }
 
@@ -408,6 +435,19 @@ std::vector<Configuration> get_ebc_single_node_utest_configuration() {
           embedding::EmbeddingLayout::FeatureMajor, embedding::EmbeddingLayout::FeatureMajor,
           embedding::KeysPreprocessStrategy::AddOffset, embedding::SortStrategy::Segmented,
           embedding::AllreduceStrategy::Sparse, embedding::CommunicationStrategy::Uniform},
+      EmbeddingCollectionOption{
+          embedding::EmbeddingLayout::FeatureMajor, embedding::EmbeddingLayout::FeatureMajor,
+          embedding::KeysPreprocessStrategy::AddOffset, embedding::SortStrategy::Hash,
+          embedding::AllreduceStrategy::Dense, embedding::CommunicationStrategy::Uniform},
+      EmbeddingCollectionOption{
+          embedding::EmbeddingLayout::FeatureMajor, embedding::EmbeddingLayout::FeatureMajor,
+          embedding::KeysPreprocessStrategy::AddOffset, embedding::SortStrategy::Segmented,
+          embedding::AllreduceStrategy::Sparse, embedding::CommunicationStrategy::Uniform, true},
+      EmbeddingCollectionOption{
+          embedding::EmbeddingLayout::FeatureMajor, embedding::EmbeddingLayout::FeatureMajor,
+          embedding::KeysPreprocessStrategy::AddOffset, embedding::SortStrategy::Radix,
+          embedding::AllreduceStrategy::Dense, embedding::CommunicationStrategy::Uniform, false,
+          4},
   };
 
   std::vector<Configuration> configurations{
@@ -429,6 +469,15 @@ std::vector<Configuration> get_ebc_single_node_utest_configuration() {
           .options = options,
           .reference_check = true,
       },
+      Configuration{
+          .embedding_config = tiny_embedding,
+          .opt = sgd_opt,
+          .shard_configuration = sharding::column_wise_sharding(single_node, tiny_embedding, 2),
+          .runtime_configuration = single_node,
+          .input_data_configuration = synthetic_uniform_dataset,
+          .options = options,
+          .reference_check = true,
+      },
       Configuration{
           .embedding_config = criteo_multi_hot_embedding,
           .opt = adagrad_opt,
@@ -115,3 +115,83 @@ inline float kahanSum(const std::vector<float> &fa) {
   }
   return sum;
 }
+
+// A single embedding table on one GPU, looked up as the only lookup of a model parallel embedding
+// collection.
+template <typename Table, typename key_t>
+class SingleEmbeddingTable {
+ public:
+  SingleEmbeddingTable(int device_id, const EmbeddingTableParam &table_param)
+      : context_(device_id),
+        resource_manager_(HugeCTR::ResourceManagerExt::create({{device_id}}, 0)),
+        core_(std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager_, 0)),
+        table_params_{table_param},
+        lookup_params_{{0, 0, Combiner::Sum, 8, table_param.ev_size}},
+        ebc_param_{1,
+                   1,
+                   lookup_params_,
+                   {{1}},
+                   {{TablePlacementStrategy::ModelParallel, {0}}},
+                   1024,
+                   HugeCTR::core23::ToScalarType<key_t>::value,
+                   HugeCTR::core23::ToScalarType<uint32_t>::value,
+                   HugeCTR::core23::ToScalarType<uint32_t>::value,
+                   HugeCTR::core23::ToScalarType<float>::value,
+                   HugeCTR::core23::ToScalarType<float>::value,
+                   EmbeddingLayout::BatchMajor,
+                   EmbeddingLayout::FeatureMajor,
+                   embedding::SortStrategy::Radix,
+                   embedding::KeysPreprocessStrategy::None,
+                   embedding::AllreduceStrategy::Dense,
+                   CommunicationStrategy::Uniform},
+        table_(*resource_manager_->get_local_gpu(0), core_, table_params_, ebc_param_, 0,
+               table_params_[0].opt_param) {
+    core23::Device device(core23::DeviceType::GPU, core_->get_device_id());
+    core23::BufferParams buffer_params;
+    buffer_params.unitary = false;
+    params_ = core23::TensorParams().device(device).buffer_params(buffer_params);
+  }
+
+  Table &table() { return table_; }
+
+  // Parameters of device tensors, e.g., to pass keys and gradients to the table.
+  const core23::TensorParams &params() const { return params_; }
+
+  // Looks up the keys, and returns their embedding vectors.
+  std::vector<std::vector<float>> lookup(const std::vector<key_t> &cpu_keys) {
+    auto keys = core23::Tensor(params_.shape({static_cast<int64_t>(cpu_keys.size())})
+                                   .data_type(core23::ToScalarType<key_t>::value));
+    auto id_space_offset = core23::Tensor(params_.shape({2}).data_type(core23::ScalarType::UInt32));
+    auto id_space_list = core23::Tensor(params_.shape({1}).data_type(core23::ScalarType::Int32));
+    core23::copy_sync(keys, cpu_keys);
+    core23::copy_sync(id_space_offset,
+                      std::vector<uint32_t>{0, static_cast<uint32_t>(cpu_keys.size())});
+    core23::copy_sync(id_space_list, std::vector<int>{0});
+
+    core23::Tensor emb_vec =
+        core23::init_tensor_list<float>(cpu_keys.size(), core_->get_device_id());
+    table_.lookup(keys, cpu_keys.size(), id_space_offset, 2, id_space_list, emb_vec);
+    HCTR_LIB_THROW(cudaStreamSynchronize(core_->get_local_gpu()->get_stream()));
+
+    std::vector<float *> cpu_emb_vec(cpu_keys.size());
+    HCTR_LIB_THROW(cudaMemcpy(cpu_emb_vec.data(), emb_vec.data(),
+                              cpu_keys.size() * sizeof(float *), cudaMemcpyDeviceToHost));
+    const int ev_size = table_params_[0].ev_size;
+    std::vector<std::vector<float>> evs(cpu_keys.size(), std::vector<float>(ev_size));
+    for (size_t i = 0; i < cpu_keys.size(); ++i) {
+      HCTR_LIB_THROW(cudaMemcpy(evs[i].data(), cpu_emb_vec[i], ev_size * sizeof(float),
+                                cudaMemcpyDeviceToHost));
+    }
+    return evs;
+  }
+
+ private:
+  HugeCTR::CudaDeviceContext context_;
+  std::shared_ptr<HugeCTR::ResourceManager> resource_manager_;
+  std::shared_ptr<hctr_internal::HCTRCoreResourceManager> core_;
+  const std::vector<EmbeddingTableParam> table_params_;
+  const std::vector<LookupParam> lookup_params_;
+  EmbeddingCollectionParam ebc_param_;
+  Table table_;
+  core23::TensorParams params_;
+};
@@ -69,7 +69,10 @@ class EmbeddingTableCPU {
           int ev_size = cpu_emb_table_ev_size[i];
           HCTR_CHECK_HINT(table_id < static_cast<int>(table_param_list_.size()),
                           "table id out of range in EmbeddingTableCPU");
-          HCTR_CHECK_HINT(table_param_list_[table_id].ev_size == ev_size,
+          // Column shards hold a slice of each embedding vector. Their GPUs are visited in the
+          // order of the slices, so that appending the slices restores the embedding vectors.
+          bool is_column_shard = ev_size < table_param_list_[table_id].ev_size;
+          HCTR_CHECK_HINT(is_column_shard || table_param_list_[table_id].ev_size == ev_size,
                           "ev size not match in EmbeddingTableCPU");
           index_t start = cpu_num_key_per_table_offset[i];
           index_t end = cpu_num_key_per_table_offset[i + 1];
@@ -83,7 +86,13 @@ class EmbeddingTableCPU {
                               "(ev_start + e) out of range in EmbeddingTableCPU");
               ev.push_back(cpu_emb_table[ev_start + e]);
             }
-            if (emb_table_list_[table_id].find(k) != emb_table_list_[table_id].end()) {
+            if (is_column_shard) {
+              auto &full_ev = emb_table_list_[table_id][k];
+              HCTR_CHECK_HINT(
+                  static_cast<int>(full_ev.size()) + ev_size <= table_param_list_[table_id].ev_size,
+                  "column shards not match in EmbeddingTableCPU");
+              full_ev.insert(full_ev.end(), ev.begin(), ev.end());
+            } else if (emb_table_list_[table_id].find(k) != emb_table_list_[table_id].end()) {
               HCTR_CHECK_HINT(ev.size() == emb_table_list_[table_id][k].size(),
                               "ev not match in EmbeddingTableCPU");
               for (int e = 0; e < ev_size; ++e) {
@@ -49,7 +49,8 @@ class EmbeddingIO {
   }
   // same with model.embedding_load function
   void embedding_load(const std::string& path, const std::map<int, int>& table_id_map_raw,
-                      int embedding_collection_id) {
+                      int embedding_collection_id, int num_threads = 1,
+                      size_t chunk_bytes = 256 << 20) {
     int embedding_collection_nums = ebc_list_.size();
     if (embedding_collection_id < 0 || embedding_collection_id >= embedding_collection_nums) {
       HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput, "embedding_collection_id is out of range");
@@ -57,16 +58,6 @@ class EmbeddingIO {
     std::map<int, int> table_id_map;
     auto& tmp_embedding_collection = ebc_list_[embedding_collection_id];
     auto& tmp_ebc_param = tmp_embedding_collection->ebc_param_;
-    auto& tmp_shard_matrix = tmp_ebc_param.shard_matrix;
-    int num_total_gpus = resource_manager_->get_global_gpu_count();
-    int num_local_gpus = resource_manager_->get_local_gpu_count();
-    std::vector<std::shared_ptr<core::CoreResourceManager>> core_list;
-
-    for (int local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
-      auto core_resource_manager =
-          std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager_, local_gpu_id);
-      core_list.push_back(core_resource_manager);
-    }
 
     struct embedding::EmbeddingParameterInfo tmp_epi = embedding::EmbeddingParameterInfo();
     embedding_para_io_->load_metadata(path, embedding_collection_id, tmp_epi);
@@ -85,88 +76,35 @@ class EmbeddingIO {
          ++table_id_iter) {
       int file_table_id = table_id_iter->first;
       int model_table_id = table_id_iter->second;
-      int target_grouped_id = -1;
-      embedding::TablePlacementStrategy target_placement;
-      for (int grouped_id = 0; grouped_id < tmp_ebc_param.grouped_table_params.size();
-           ++grouped_id) {
-        auto& tmp_table_ids = tmp_ebc_param.grouped_table_params[grouped_id].table_ids;
-
-        auto tmp_it = std::find(tmp_table_ids.begin(), tmp_table_ids.end(), model_table_id);
-        if (tmp_it != tmp_table_ids.end()) {
-          target_grouped_id = grouped_id;
-          target_placement =
-              tmp_ebc_param.grouped_table_params[grouped_id].table_placement_strategy;
-          break;
-        }
-      }
-      if (target_grouped_id == -1) {
-        HCTR_OWN_THROW(HugeCTR::Error_t::WrongInput,
-                       "can not find table_id in model table_ids,please check your input");
-      }
-
-      if (target_placement == embedding::TablePlacementStrategy::DataParallel) {
-        auto tmp_filter = [=](size_t key) { return true; };
-        core23::Tensor keys;
-        core23::Tensor embedding_weights;
-        auto& target_key_type = tmp_ebc_param.key_type;
-        auto& target_value_type = tmp_ebc_param.emb_type;
-        embedding_para_io_->load_embedding_weight(tmp_epi, file_table_id, keys, embedding_weights,
-                                                  tmp_filter, core_list[0], target_key_type,
-                                                  target_value_type);
-        for (size_t local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
-          HugeCTR::CudaDeviceContext context(core_list[local_gpu_id]->get_device_id());
-          auto& grouped_table =
-              tmp_embedding_collection->embedding_tables_[local_gpu_id][target_grouped_id];
-          grouped_table->load_by_id(&keys, &embedding_weights, model_table_id);
-        }
-      } else if (target_placement == embedding::TablePlacementStrategy::ModelParallel) {
-        for (size_t local_gpu_id = 0; local_gpu_id < num_local_gpus; ++local_gpu_id) {
-          HugeCTR::CudaDeviceContext context(core_list[local_gpu_id]->get_device_id());
-          size_t global_id = resource_manager_->get_gpu_global_id_from_local_id(local_gpu_id);
-          auto& target_key_type = tmp_ebc_param.key_type;
-          auto& target_value_type = tmp_ebc_param.emb_type;
-          std::vector<int> shard_gpu_list;
-          for (int gpu_id = 0; gpu_id < num_total_gpus; ++gpu_id) {
-            HCTR_CHECK_HINT(model_table_id < static_cast<int>(tmp_shard_matrix[gpu_id].size()),
-                            "table_id is out of range");
-            if (tmp_ebc_param.shard_matrix[gpu_id][model_table_id] == 1) {
-              shard_gpu_list.push_back(gpu_id);
-            }
-          }
-          int num_shards = static_cast<int>(shard_gpu_list.size());
-          auto find_shard_id_iter =
-              std::find(shard_gpu_list.begin(), shard_gpu_list.end(), global_id);
-          if (find_shard_id_iter == shard_gpu_list.end()) {
-            continue;
-          }
-          int shard_id =
-              static_cast<int>(std::distance(shard_gpu_list.begin(), find_shard_id_iter));
-
-          auto tmp_filter = [=](size_t key) { return key % num_shards == shard_id; };
-          core23::Tensor keys;
-          core23::Tensor embedding_weights;
-          embedding_para_io_->load_embedding_weight(tmp_epi, file_table_id, keys, embedding_weights,
-                                                    tmp_filter, core_list[0], target_key_type,
-                                                    target_value_type);
-
-          auto& grouped_table =
-              tmp_embedding_collection->embedding_tables_[local_gpu_id][target_grouped_id];
-          grouped_table->load_by_id(&keys, &embedding_weights, model_table_id);
-        }
-      } else {
-        HCTR_OWN_THROW(HugeCTR::Error_t::UnspecificError, "unsupported parallel mode");
-      }
+      embedding_para_io_->load_embedding_table(tmp_epi, file_table_id, embedding_collection_id,
+                                               model_table_id, num_threads, chunk_bytes);
     }
   }
 
   // same with model.embedding_dump function
-  void embedding_dump(const std::string& path, const std::map<int, std::vector<int>>& table_ids) {
+  void embedding_dump(const std::string& path, const std::map<int, std::vector<int>>& table_ids,
+                      int num_threads = 1, bool incremental = false) {
     std::vector<struct embedding::EmbeddingParameterInfo> epis;
 
     embedding_para_io_->get_parameter_info_from_model(path, epis);
     for (int i = 0; i < epis.size(); ++i) {
       epis[i].gemb_distribution->print_info();
     }
+    const bool sharded = num_threads > 1 || incremental;
+    if (sharded) {
+      embedding_para_io_->begin_sharded_dump(path, incremental);
+    }
+    auto dump_collection = [&](int cid, const std::vector<int>& tmp_table_ids) {
+      if (sharded) {
+        embedding_para_io_->dump_metadata(path, epis[cid], tmp_table_ids,
+                                          resource_manager_->get_num_process());
+        embedding_para_io_->dump_embedding_weight_sharded(path, epis[cid], tmp_table_ids,
+                                                          num_threads);
+      } else {
+        embedding_para_io_->dump_metadata(path, epis[cid], tmp_table_ids);
+        embedding_para_io_->dump_embedding_weight(path, epis[cid], tmp_table_ids);
+      }
+    };
 
     if (table_ids.empty()) {
       int collection_num = ebc_list_.size();
@@ -178,8 +116,7 @@ class EmbeddingIO {
         for (int i = 0; i < tmp_table_num; ++i) {
           tmp_table_ids.push_back(i);
         }
-        embedding_para_io_->dump_metadata(path, epis[cid], tmp_table_ids);
-        embedding_para_io_->dump_embedding_weight(path, epis[cid], tmp_table_ids);
+        dump_collection(cid, tmp_table_ids);
       }
     } else {
       for (auto collection_id_iter = table_ids.begin(); collection_id_iter != table_ids.end();
@@ -199,8 +136,7 @@ class EmbeddingIO {
             tmp_table_ids.push_back(raw_table_ids[i]);
           }
         }
-        embedding_para_io_->dump_metadata(path, epis[cid], tmp_table_ids);
-        embedding_para_io_->dump_embedding_weight(path, epis[cid], tmp_table_ids);
+        dump_collection(cid, tmp_table_ids);
       }
     }
   }
@@ -260,7 +196,9 @@ std::vector<EmbeddingTableParam> get_table_param_list_io(core23::DataType emb_ty
 template <typename key_t, typename offset_t, typename index_t, typename emb_t>
 void embedding_collection_e2e_io(const std::vector<LookupParam>& lookup_params,
                                  const std::vector<std::vector<int>>& shard_matrix,
-                                 const std::vector<GroupedTableParam>& grouped_emb_params) {
+                                 const std::vector<GroupedTableParam>& grouped_emb_params,
+                                 int dump_threads = 1, bool incremental_dump = false,
+                                 int load_threads = 1, size_t load_chunk_bytes = 256 << 20) {
   ASSERT_EQ(table_max_vocabulary_list.size(), num_table);
   ASSERT_EQ(table_ev_size_list.size(), num_table);
   EmbeddingCollectionParam ebc_param{num_table,
@@ -493,10 +431,12 @@ void embedding_collection_e2e_io(const std::vector<LookupParam>& lookup_params,
     // try to dump data to file system , and load it from file systems
     // if value don't change , it load dump can be work , and result is correct
     std::map<int, std::vector<int>> dump_table_ids_map;
-    emb_io.embedding_dump("./embedding_io_test", dump_table_ids_map);
+    emb_io.embedding_dump("./embedding_io_test", dump_table_ids_map, dump_threads,
+                          incremental_dump);
 
     std::map<int, int> load_table_id_map;
-    emb_io.embedding_load("./embedding_io_test", load_table_id_map, 0);
+    emb_io.embedding_load("./embedding_io_test", load_table_id_map, 0, load_threads,
+                          load_chunk_bytes);
     sync_gpus();
 
     check_forward_result();
@@ -550,6 +490,12 @@ TEST(test_embedding_collection_load_dump, mp_plan0) {
                                                                    grouped_emb_params);
 }
 
+// The dumps after the first one of the iterations only write the updated rows.
+TEST(test_embedding_collection_load_dump, mp_plan0_incremental) {
+  embedding_collection_e2e_io<uint32_t, uint32_t, uint32_t, float>(lookup_params, shard_matrix,
+                                                                   grouped_emb_params, 4, true);
+}
+
 TEST(test_embedding_collection_load_dump, mp_plan1) {
   embedding_collection_e2e_io<uint32_t, uint32_t, uint32_t, float>(
       lookup_params_with_shared_table, shard_matrix, grouped_emb_params);
@@ -571,6 +517,27 @@ TEST(test_embedding_collection_load_dump, dp_and_mp_plan0) {
                                                                    grouped_emb_params);
 }
 
+TEST(test_embedding_collection_load_dump, dp_and_mp_plan0_sharded) {
+  embedding_collection_e2e_io<uint32_t, uint32_t, uint32_t, float>(lookup_params, shard_matrix,
+                                                                   grouped_emb_params, 4);
+}
+
+TEST(test_embedding_collection_load_dump, dp_and_mp_plan0_incremental) {
+  embedding_collection_e2e_io<uint32_t, uint32_t, uint32_t, float>(lookup_params, shard_matrix,
+                                                                   grouped_emb_params, 4, true);
+}
+
+// The tables are loaded in chunks of a few rows, several of them read at the same time.
+TEST(test_embedding_collection_load_dump, dp_and_mp_plan0_streaming) {
+  embedding_collection_e2e_io<uint32_t, uint32_t, uint32_t, float>(
+      lookup_params, shard_matrix, grouped_emb_params, 1, false, 4, 1024);
+}
+
+TEST(test_embedding_collection_load_dump, dp_and_mp_plan0_incremental_streaming) {
+  embedding_collection_e2e_io<uint32_t, uint32_t, uint32_t, float>(
+      lookup_params, shard_matrix, grouped_emb_params, 4, true, 4, 1024);
+}
+
 TEST(test_embedding_collection_load_dump, dp_and_mp_plan1) {
   embedding_collection_e2e_io<uint32_t, uint32_t, uint32_t, float>(
       lookup_params_with_shared_table, shard_matrix, grouped_emb_params);
@@ -320,6 +320,14 @@ void embedding_collection_e2e(const Configuration &config) {
                             batch_size, key_type, index_type, offset_type, emb_type, wgrad_type,
                             input_layout, output_layout, sort_strategy, keys_preprocess_strategy,
                             allreduce_strategy, comm_strategy);
+    if (option.deterministic) {
+      std::vector<int> table_ids(num_table);
+      std::iota(table_ids.begin(), table_ids.end(), 0);
+      ebc_params.back().init_deterministic_tables(table_ids);
+    }
+    if (option.num_lookup_streams > 1) {
+      ebc_params.back().init_lookup_streams(option.num_lookup_streams, {{0, -1}});
+    }
   }
 
   HCTR_LOG(INFO, ROOT, "start preparing host data\n");
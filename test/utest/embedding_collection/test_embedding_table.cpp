@@ -21,7 +21,9 @@
 #include <embedding/operators/keys_to_indices.hpp>
 #include <embedding_storage/dynamic_embedding.hpp>
 #include <embedding_storage/ragged_static_embedding.hpp>
+#include <map>
 #include <resource_managers/resource_manager_ext.hpp>
+#include <utest/embedding_collection/embedding_collection_utils.hpp>
 
 using namespace embedding;
 int num_embedding_table = 3;
@@ -152,3 +154,85 @@ TEST(dynamic_embedding_table, dynamic_embedding_table) {
   test_embedding_table<int32_t, int32_t>(0, 1);
   test_embedding_table<int64_t, int32_t>(0, 1);
 }
+
+template <typename key_t>
+void test_dynamic_embedding_table_eviction(int device_id) {
+  const int ev_size = 8;
+  SingleEmbeddingTable<DynamicEmbeddingTable, key_t> test(
+      device_id,
+      {0, -1, ev_size, {}, InitParams(ev_size), {EvictionPolicy::LFU, 4, 0, 1.0, 1, true}});
+  DynamicEmbeddingTable& embedding_table = test.table();
+
+  // Keys 0 to 3 are looked up more often, so LFU evicts keys 4 to 7.
+  const std::vector<key_t> hot_keys{0, 1, 2, 3};
+  const std::vector<key_t> cold_keys{4, 5, 6, 7};
+  test.lookup(hot_keys);
+  const auto cold_evs = test.lookup(cold_keys);
+  test.lookup(hot_keys);
+  ASSERT_EQ(embedding_table.key_num(), 8ul);
+
+  embedding_table.evict_by_policy();
+  ASSERT_EQ(embedding_table.key_num(), 4ul);
+  auto stats = embedding_table.eviction_stats_per_table()[0];
+  EXPECT_EQ(stats.num_evicted, 4ul);
+  EXPECT_EQ(stats.num_spilled, 4ul);
+
+  // Spilled keys are restored with their embedding vectors.
+  const auto restored_evs = test.lookup(cold_keys);
+  ASSERT_EQ(embedding_table.key_num(), 8ul);
+  EXPECT_EQ(restored_evs, cold_evs);
+  stats = embedding_table.eviction_stats_per_table()[0];
+  EXPECT_EQ(stats.num_restored, 4ul);
+  EXPECT_EQ(stats.num_spilled, 0ul);
+}
+
+TEST(dynamic_embedding_table, dynamic_embedding_table_eviction) {
+  test_dynamic_embedding_table_eviction<int64_t>(0);
+}
+
+template <typename key_t>
+void test_dynamic_embedding_table_pruned_dump(int device_id) {
+  auto key_type = HugeCTR::core23::ToScalarType<key_t>::value;
+  const int ev_size = 8;
+  // An unbounded LFU table only counts the lookups of its keys.
+  SingleEmbeddingTable<DynamicEmbeddingTable, key_t> test(
+      device_id, {0, -1, ev_size, {}, InitParams(ev_size), {EvictionPolicy::LFU}});
+  DynamicEmbeddingTable& embedding_table = test.table();
+
+  // Keys 0 to 3 are looked up twice, and keys 4 to 7 once.
+  test.lookup({0, 1, 2, 3});
+  test.lookup({4, 5, 6, 7});
+  test.lookup({0, 1, 2, 3});
+  ASSERT_EQ(embedding_table.key_num(), 8ul);
+
+  core23::TensorParams cpu_params =
+      core23::TensorParams().device(core23::Device(core23::DeviceType::CPU));
+  auto keys = core23::Tensor(cpu_params.shape({8}).data_type(key_type));
+  auto values =
+      core23::Tensor(cpu_params.shape({8 * ev_size}).data_type(core23::ScalarType::Float));
+  embedding_table.dump_by_id(&keys, &values, 0);
+  std::map<key_t, std::vector<float>> rows;
+  for (int i = 0; i < 8; ++i) {
+    const float* row = values.data<float>() + i * ev_size;
+    rows[keys.data<key_t>()[i]].assign(row, row + ev_size);
+  }
+
+  // Without pruning, all rows are dumped.
+  ASSERT_EQ(embedding_table.dump_pruned_by_id(&keys, &values, 0, 0, 0), 8ul);
+
+  const size_t num_dumped = embedding_table.dump_pruned_by_id(&keys, &values, 0, 2, 0);
+  ASSERT_EQ(num_dumped, 4ul);
+  std::vector<key_t> dumped_keys(keys.data<key_t>(), keys.data<key_t>() + num_dumped);
+  std::sort(dumped_keys.begin(), dumped_keys.end());
+  EXPECT_EQ(dumped_keys, (std::vector<key_t>{0, 1, 2, 3}));
+  for (size_t i = 0; i < num_dumped; ++i) {
+    const float* row = values.data<float>() + i * ev_size;
+    EXPECT_EQ(std::vector<float>(row, row + ev_size), rows[keys.data<key_t>()[i]]);
+  }
+  // Pruning does not remove the rows from the table.
+  EXPECT_EQ(embedding_table.key_num(), 8ul);
+}
+
+TEST(dynamic_embedding_table, dynamic_embedding_table_pruned_dump) {
+  test_dynamic_embedding_table_pruned_dump<int64_t>(0);
+}
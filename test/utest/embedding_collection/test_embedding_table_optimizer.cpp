@@ -19,11 +19,14 @@
 
 #include <core/hctr_impl/hctr_backend.hpp>
 #include <embedding/operators/keys_to_indices.hpp>
+#include <embedding_storage/compositional_embedding.hpp>
 #include <embedding_storage/dynamic_embedding.hpp>
 #include <embedding_storage/dynamic_embedding_cpu.hpp>
+#include <embedding_storage/host_cached_embedding.hpp>
 #include <embedding_storage/ragged_static_embedding.hpp>
 #include <random>
 #include <resource_managers/resource_manager_ext.hpp>
+#include <utest/embedding_collection/embedding_collection_utils.hpp>
 
 using namespace embedding;
 
@@ -37,7 +40,10 @@ const size_t universal_batch_size = 1024;
 template <class Key, typename Index>
 void test_embedding_table_optimizer(int device_id, const char table_type[],
                                     const HugeCTR::Optimizer_t& opt_type,
-                                    const size_t num_iterations) {
+                                    const size_t num_iterations,
+                                    const HugeCTR::OptHyperParams& hyperparams = {},
+                                    TableStorageType table_storage_type = TableStorageType::FP32,
+                                    HugeCTR::Update_t update_type = HugeCTR::Update_t::Local) {
   std::vector<int> device_list{device_id};
   HugeCTR::CudaDeviceContext context(device_id);
 
@@ -47,7 +53,7 @@ void test_embedding_table_optimizer(int device_id, const char table_type[],
   const auto key_type = core23::ToScalarType<Key>::value;
   const auto index_type = core23::ToScalarType<Index>::value;
 
-  const HugeCTR::OptParams opt_params{opt_type, 0.1f, {}, HugeCTR::Update_t::Local, 1.f};
+  const HugeCTR::OptParams opt_params{opt_type, 0.1f, hyperparams, update_type, 1.f};
   const std::vector<EmbeddingTableParam> table_params{
       {0, 10000, 8, {opt_params}, {}},
       {0, 20000, 10, {opt_params}, {}},
@@ -81,6 +87,7 @@ void test_embedding_table_optimizer(int device_id, const char table_type[],
                                      KeysPreprocessStrategy::None,
                                      AllreduceStrategy::Dense,
                                      CommunicationStrategy::Uniform};
+  ebc_param.table_storage_type_ = table_storage_type;
 
   // Implementation to test.
   std::unique_ptr<IGroupedEmbeddingTable> test_table;
@@ -89,6 +96,16 @@ void test_embedding_table_optimizer(int device_id, const char table_type[],
     test_table = std::make_unique<RaggedStaticEmbeddingTable>(*resource_manager->get_local_gpu(0),
                                                               core, table_params, ebc_param, 0,
                                                               table_params[0].opt_param);
+  } else if (!strcmp(table_type, "HostCached")) {
+    HCTR_LOG_S(INFO, WORLD) << "Creating `HostCachedEmbeddingTable`..." << std::endl;
+    // Caches fewer rows than are checked, so that lookups both hit and miss.
+    std::vector<EmbeddingTableParam> host_cached_table_params = table_params;
+    for (auto& table_param : host_cached_table_params) {
+      table_param.num_gpu_cached_rows = 8;
+    }
+    test_table = std::make_unique<HostCachedEmbeddingTable>(
+        *resource_manager->get_local_gpu(0), core, host_cached_table_params, ebc_param, 0,
+        table_params[0].opt_param);
   } else if (!strcmp(table_type, "Dynamic")) {
     HCTR_LOG_S(INFO, WORLD) << "Creating `DynamicEmbeddingTable`..." << std::endl;
     test_table = std::make_unique<DynamicEmbeddingTable>(*resource_manager->get_local_gpu(0), core,
@@ -400,7 +417,8 @@ void test_embedding_table_optimizer(int device_id, const char table_type[],
       ASSERT_EQ(v0.size(), v1.size());
 
       for (size_t j = 0; j < v0.size(); ++j) {
-        EXPECT_NEAR(v0[j], v1[j], 1e-6);
+        // FP16 weights are rounded after each update.
+        EXPECT_NEAR(v0[j], v1[j], table_storage_type == TableStorageType::FP16 ? 1e-3 : 1e-6);
       }
     }
   };
@@ -452,6 +470,16 @@ TEST(dynamic_embedding_table, optimizer) {
                                                     10);
   test_embedding_table_optimizer<int64_t, uint32_t>(0, "Dynamic", HugeCTR::Optimizer_t::Adam, 10);
   test_embedding_table_optimizer<int64_t, uint32_t>(0, "Dynamic", HugeCTR::Optimizer_t::Ftrl, 10);
+
+  HugeCTR::OptHyperParams row_wise;
+  row_wise.adagrad.row_wise = true;
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "Dynamic", HugeCTR::Optimizer_t::AdaGrad,
+                                                    10, row_wise);
+
+  // Lazy Adam.
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "Dynamic", HugeCTR::Optimizer_t::Adam, 10,
+                                                    {}, TableStorageType::FP32,
+                                                    HugeCTR::Update_t::LazyGlobal);
 }
 
 TEST(static_embedding_table, optimizer) {
@@ -461,4 +489,93 @@ TEST(static_embedding_table, optimizer) {
                                                     HugeCTR::Optimizer_t::AdaGrad, 10);
   test_embedding_table_optimizer<int64_t, uint32_t>(0, "RaggedStatic", HugeCTR::Optimizer_t::Ftrl,
                                                     10);
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "RaggedStatic", HugeCTR::Optimizer_t::Adam,
+                                                    10);
+
+  HugeCTR::OptHyperParams row_wise;
+  row_wise.adagrad.row_wise = true;
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "RaggedStatic",
+                                                    HugeCTR::Optimizer_t::AdaGrad, 10, row_wise);
+
+  // Lazy Adam.
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "RaggedStatic", HugeCTR::Optimizer_t::Adam,
+                                                    10, {}, TableStorageType::FP32,
+                                                    HugeCTR::Update_t::LazyGlobal);
+
+  // FP16 weights with stochastic rounding.
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "RaggedStatic", HugeCTR::Optimizer_t::SGD,
+                                                    10, {}, TableStorageType::FP16);
+  test_embedding_table_optimizer<int64_t, uint32_t>(
+      0, "RaggedStatic", HugeCTR::Optimizer_t::AdaGrad, 10, {}, TableStorageType::FP16);
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "RaggedStatic", HugeCTR::Optimizer_t::Adam,
+                                                    10, {}, TableStorageType::FP16);
+}
+
+TEST(host_cached_embedding_table, optimizer) {
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "HostCached", HugeCTR::Optimizer_t::SGD, 10);
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "HostCached", HugeCTR::Optimizer_t::AdaGrad,
+                                                    10);
+  test_embedding_table_optimizer<int64_t, uint32_t>(0, "HostCached", HugeCTR::Optimizer_t::Adam,
+                                                    10);
+}
+
+TEST(compositional_embedding_table, sum_combiner) {
+  const int ev_size = 8;
+  const float lr = 0.1f;
+  const HugeCTR::OptParams opt_params{HugeCTR::Optimizer_t::SGD, lr, {}, HugeCTR::Update_t::Local,
+                                      1.f};
+  SingleEmbeddingTable<CompositionalEmbeddingTable, int64_t> test(
+      0, {0, 1000, ev_size, {opt_params}, {}, {}, 0, {CompositionalCombiner::Sum, 100}});
+  CompositionalEmbeddingTable &table = test.table();
+  // 10 quotient rows and 100 remainder rows instead of 1000 rows.
+  EXPECT_EQ(table.key_num(), 1000);
+  EXPECT_EQ(table.size(), (10 + 100) * ev_size);
+
+  // With a single shard, the keys are the rows of the table.
+  const std::vector<int64_t> keys_vec{0, 1, 100, 101};
+
+  // Rows 0 and 1 share their quotient row, and so do rows 100 and 101, while rows 0 and 100 share
+  // their remainder row.
+  const auto evs0 = test.lookup(keys_vec);
+  for (int i = 0; i < ev_size; ++i) {
+    EXPECT_NEAR(evs0[0][i] - evs0[1][i], evs0[2][i] - evs0[3][i], 1e-6);
+  }
+
+  // Updates row 0, which updates both its quotient and its remainder row.
+  const std::vector<float> grad_vec(ev_size, 1.f);
+  const core23::TensorParams &params = test.params();
+  auto keys = core23::Tensor(params.shape({1}).data_type(core23::ScalarType::Int64));
+  auto num_keys = core23::Tensor(params.shape({1}).data_type(core23::ScalarType::UInt64));
+  auto table_ids = core23::Tensor(params.shape({1}).data_type(core23::ScalarType::Int32));
+  auto grad = core23::Tensor(params.shape({ev_size}).data_type(core23::ScalarType::Float));
+  auto grad_idx = core23::Tensor(params.shape({2}).data_type(core23::ScalarType::UInt32));
+  core23::copy_sync(keys, std::vector<int64_t>{0});
+  core23::copy_sync(num_keys, std::vector<uint64_t>{1});
+  core23::copy_sync(table_ids, std::vector<int32_t>{0});
+  core23::copy_sync(grad, grad_vec);
+  core23::copy_sync(grad_idx, std::vector<uint32_t>{0, ev_size});
+  table.update(keys, num_keys, table_ids, grad_idx, grad);
+
+  const auto evs1 = test.lookup(keys_vec);
+  for (int i = 0; i < ev_size; ++i) {
+    EXPECT_NEAR(evs1[0][i], evs0[0][i] - 2 * lr, 1e-6);
+    EXPECT_NEAR(evs1[1][i], evs0[1][i] - lr, 1e-6);
+    EXPECT_NEAR(evs1[2][i], evs0[2][i] - lr, 1e-6);
+    EXPECT_NEAR(evs1[3][i], evs0[3][i], 1e-6);
+  }
+
+  // The table is dumped as its combined rows.
+  core23::TensorParams cpu_params =
+      core23::TensorParams().device(core23::Device(core23::DeviceType::CPU));
+  auto h_keys = core23::Tensor(cpu_params.shape({1000}).data_type(core23::ScalarType::Int64));
+  auto h_embedding_table =
+      core23::Tensor(cpu_params.shape({1000 * ev_size}).data_type(core23::ScalarType::Float));
+  table.dump_by_id(&h_keys, &h_embedding_table, 0);
+  for (size_t k = 0; k < keys_vec.size(); ++k) {
+    const int64_t key = keys_vec[k];
+    EXPECT_EQ(h_keys.data<int64_t>()[key], key);
+    for (int i = 0; i < ev_size; ++i) {
+      EXPECT_NEAR(h_embedding_table.data<float>()[key * ev_size + i], evs1[k][i], 1e-6);
+    }
+  }
 }
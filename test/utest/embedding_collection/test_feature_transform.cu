@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <core/hctr_impl/hctr_backend.hpp>
+#include <core23/tensor.hpp>
+#include <core23/tensor_operations.hpp>
+#include <embedding/data_distributor/key_filtering_operators.hpp>
+#include <embedding/operators/feature_hash.cuh>
+#include <numeric>
+#include <resource_managers/resource_manager_ext.hpp>
+#include <utils.hpp>
+
+using namespace embedding;
+
+namespace {
+
+// Lookup 0 reads input feature 1, lookup 1 hashes input feature 0, and lookup 2 crosses them.
+void test_feature_transform(FeatureHashFunction hash_function, uint64_t num_buckets) {
+  auto resource_manager = HugeCTR::ResourceManagerExt::create({{0}}, 0);
+  auto core = std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager, 0);
+  HugeCTR::CudaDeviceContext context(core->get_device_id());
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+
+  const int batch_size = 37;
+  const std::vector<int> input_hotness = {1, 3};
+  std::vector<LookupParam> lookup_params = {{0, 0, Combiner::Sum, 3, 8},
+                                            {1, 0, Combiner::Sum, 1, 8},
+                                            {2, 0, Combiner::Sum, 3, 8}};
+  EmbeddingCollectionParam ebc_param{1,
+                                     3,
+                                     lookup_params,
+                                     {{1}},
+                                     {},
+                                     batch_size,
+                                     core23::ScalarType::Int64,
+                                     core23::ScalarType::UInt64,
+                                     core23::ScalarType::Int64,
+                                     core23::ScalarType::Float,
+                                     core23::ScalarType::Float,
+                                     EmbeddingLayout::FeatureMajor,
+                                     EmbeddingLayout::FeatureMajor,
+                                     SortStrategy::Segmented,
+                                     KeysPreprocessStrategy::None,
+                                     AllreduceStrategy::Sparse,
+                                     CommunicationStrategy::Uniform};
+  ebc_param.num_input_features_ = 2;
+  ebc_param.lookup_input_feature_ids_ = {1, -1, -1};
+  ebc_param.virtual_features_ = {{1, {0}, {1}, hash_function, num_buckets, 7},
+                                 {2, {0, 1}, {1, 3}, hash_function, num_buckets, 11}};
+
+  std::vector<std::vector<int64_t>> h_input_keys(2);
+  std::vector<core23::Tensor> input_keys;
+  for (int input_id = 0; input_id < 2; ++input_id) {
+    h_input_keys[input_id].resize(batch_size * input_hotness[input_id]);
+    std::iota(h_input_keys[input_id].begin(), h_input_keys[input_id].end(), 1000 * input_id);
+    input_keys.emplace_back(params.shape({static_cast<int64_t>(h_input_keys[input_id].size())})
+                                .data_type(core23::ScalarType::Int64));
+    core23::copy_sync(input_keys.back(), h_input_keys[input_id]);
+  }
+
+  HugeCTR::FeatureTransformOperator feature_transform{core, ebc_param};
+  const auto& keys = feature_transform(input_keys, core->get_local_gpu()->get_stream());
+  HCTR_LIB_THROW(cudaStreamSynchronize(core->get_local_gpu()->get_stream()));
+  ASSERT_EQ(keys.size(), 3u);
+  EXPECT_EQ(keys[0].data(), input_keys[1].data());
+
+  std::vector<int64_t> hashed_keys(batch_size), crossed_keys(batch_size * 3);
+  core23::copy_sync(hashed_keys, keys[1]);
+  core23::copy_sync(crossed_keys, keys[2]);
+  for (int sample = 0; sample < batch_size; ++sample) {
+    const uint64_t key = h_input_keys[0][sample];
+    EXPECT_EQ(hashed_keys[sample],
+              static_cast<int64_t>(hash_feature_key(key, 7, num_buckets, hash_function)));
+    for (int j = 0; j < 3; ++j) {
+      const uint64_t cross_key = h_input_keys[1][sample * 3 + j];
+      const int64_t crossed_key = crossed_keys[sample * 3 + j];
+      EXPECT_EQ(crossed_key, static_cast<int64_t>(cross_feature_keys(key, cross_key, 11,
+                                                                     num_buckets, hash_function)));
+      if (num_buckets > 0) {
+        EXPECT_LT(static_cast<uint64_t>(crossed_key), num_buckets);
+      }
+    }
+  }
+  // Crosses depend on the order of their inputs.
+  EXPECT_NE(cross_feature_keys(1, 2, 0, 0, hash_function),
+            cross_feature_keys(2, 1, 0, 0, hash_function));
+}
+
+}  // namespace
+
+TEST(test_feature_transform, murmur) { test_feature_transform(FeatureHashFunction::Murmur, 0); }
+
+TEST(test_feature_transform, xxhash) { test_feature_transform(FeatureHashFunction::XXHash, 0); }
+
+TEST(test_feature_transform, buckets) {
+  test_feature_transform(FeatureHashFunction::Murmur, 1000);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <core/hctr_impl/hctr_backend.hpp>
+#include <core23/tensor.hpp>
+#include <core23/tensor_operations.hpp>
+#include <embedding/data_distributor/key_filtering_operators.hpp>
+#include <numeric>
+#include <resource_managers/resource_manager_ext.hpp>
+#include <utils.hpp>
+
+using namespace embedding;
+
+namespace {
+
+// The 64-bit keys and bucket ranges of 2 lookups are converted to 32-bit ones.
+void test_narrow_keys(bool has_bucket_ranges) {
+  auto resource_manager = HugeCTR::ResourceManagerExt::create({{0}}, 0);
+  auto core = std::make_shared<hctr_internal::HCTRCoreResourceManager>(resource_manager, 0);
+  HugeCTR::CudaDeviceContext context(core->get_device_id());
+  core23::Device device(core23::DeviceType::GPU, core->get_device_id());
+  core23::TensorParams params = core23::TensorParams().device(device);
+
+  const int batch_size = 1537;
+  const std::vector<int> hotness = {1, 3};
+  std::vector<LookupParam> lookup_params = {{0, 0, Combiner::Sum, 1, 8},
+                                            {1, 1, Combiner::Sum, 3, 8}};
+  EmbeddingCollectionParam ebc_param{2,
+                                     2,
+                                     lookup_params,
+                                     {{1, 1}},
+                                     {},
+                                     batch_size,
+                                     core23::ScalarType::UInt32,
+                                     core23::ScalarType::UInt32,
+                                     core23::ScalarType::UInt32,
+                                     core23::ScalarType::Float,
+                                     core23::ScalarType::Float,
+                                     EmbeddingLayout::FeatureMajor,
+                                     EmbeddingLayout::FeatureMajor,
+                                     SortStrategy::Segmented,
+                                     KeysPreprocessStrategy::AddOffset,
+                                     AllreduceStrategy::Dense,
+                                     CommunicationStrategy::Uniform};
+  ebc_param.narrow_input_keys_ = true;
+
+  std::vector<std::vector<int64_t>> h_keys(2), h_bucket_ranges(2);
+  std::vector<core23::Tensor> keys, bucket_ranges;
+  for (int lookup_id = 0; lookup_id < 2; ++lookup_id) {
+    h_keys[lookup_id].resize(batch_size * hotness[lookup_id]);
+    std::iota(h_keys[lookup_id].begin(), h_keys[lookup_id].end(), 100000 * lookup_id);
+    keys.emplace_back(params.shape({static_cast<int64_t>(h_keys[lookup_id].size())})
+                          .data_type(core23::ScalarType::Int64));
+    core23::copy_sync(keys.back(), h_keys[lookup_id]);
+
+    h_bucket_ranges[lookup_id].resize(batch_size + 1);
+    for (int sample = 0; sample <= batch_size; ++sample) {
+      h_bucket_ranges[lookup_id][sample] = static_cast<int64_t>(sample) * hotness[lookup_id];
+    }
+    if (has_bucket_ranges) {
+      bucket_ranges.emplace_back(
+          params.shape({batch_size + 1}).data_type(core23::ScalarType::Int64));
+      core23::copy_sync(bucket_ranges.back(), h_bucket_ranges[lookup_id]);
+    }
+  }
+
+  HugeCTR::NarrowKeysOperator narrow_keys{core, ebc_param};
+  narrow_keys(keys, bucket_ranges, core->get_local_gpu()->get_stream());
+  HCTR_LIB_THROW(cudaStreamSynchronize(core->get_local_gpu()->get_stream()));
+  ASSERT_EQ(narrow_keys.keys().size(), 2u);
+  ASSERT_EQ(narrow_keys.bucket_ranges().size(), has_bucket_ranges ? 2u : 0u);
+  for (int lookup_id = 0; lookup_id < 2; ++lookup_id) {
+    ASSERT_EQ(narrow_keys.keys()[lookup_id].data_type(), core23::ScalarType::UInt32);
+    std::vector<uint32_t> result_keys(h_keys[lookup_id].size());
+    core23::copy_sync(result_keys, narrow_keys.keys()[lookup_id]);
+    EXPECT_EQ(std::vector<int64_t>(result_keys.begin(), result_keys.end()), h_keys[lookup_id]);
+    if (has_bucket_ranges) {
+      std::vector<uint32_t> result_bucket_range(batch_size + 1);
+      core23::copy_sync(result_bucket_range, narrow_keys.bucket_ranges()[lookup_id]);
+      EXPECT_EQ(std::vector<int64_t>(result_bucket_range.begin(), result_bucket_range.end()),
+                h_bucket_ranges[lookup_id]);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(test_narrow_keys, keys) { test_narrow_keys(false); }
+
+TEST(test_narrow_keys, bucket_ranges) { test_narrow_keys(true); }
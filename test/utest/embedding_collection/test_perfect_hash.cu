@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <gtest/gtest.h>
+
+#include <embedding/operators/perfect_hash.cuh>
+#include <random>
+#include <unordered_set>
+
+using namespace embedding;
+
+namespace {
+
+uint64_t find_slot(const PerfectHash& ph, int64_t key) {
+  uint64_t hash = perfect_hash_key(static_cast<uint64_t>(key), ph.seed);
+  uint32_t pilot = ph.pilots[perfect_hash_bucket(hash, ph.num_buckets)];
+  return perfect_hash_slot(hash, pilot, ph.num_keys);
+}
+
+void test_perfect_hash(size_t num_keys) {
+  std::mt19937_64 gen{42};
+  std::unordered_set<int64_t> key_set;
+  std::vector<int64_t> keys;
+  while (keys.size() < num_keys) {
+    int64_t key = static_cast<int64_t>(gen());
+    if (key_set.insert(key).second) keys.push_back(key);
+  }
+
+  PerfectHash ph = build_perfect_hash(keys);
+  ASSERT_EQ(ph.num_keys, num_keys);
+  ASSERT_EQ(ph.slot_keys.size(), num_keys);
+  ASSERT_EQ(ph.slot_rows.size(), num_keys);
+
+  // Every key has its own slot, which records its row.
+  std::vector<bool> used(num_keys, false);
+  for (size_t row = 0; row < num_keys; ++row) {
+    uint64_t slot = find_slot(ph, keys[row]);
+    ASSERT_LT(slot, num_keys);
+    ASSERT_FALSE(used[slot]);
+    used[slot] = true;
+    ASSERT_EQ(ph.slot_keys[slot], static_cast<uint64_t>(keys[row]));
+    ASSERT_EQ(ph.slot_rows[slot], row);
+  }
+
+  // Other keys are detected by the verification.
+  for (int i = 0; i < 1000; ++i) {
+    int64_t key = static_cast<int64_t>(gen());
+    if (key_set.count(key)) continue;
+    uint64_t slot = find_slot(ph, key);
+    ASSERT_LT(slot, num_keys);
+    ASSERT_NE(ph.slot_keys[slot], static_cast<uint64_t>(key));
+  }
+}
+
+}  // namespace
+
+TEST(test_perfect_hash, single_key) { test_perfect_hash(1); }
+
+TEST(test_perfect_hash, small_vocabulary) { test_perfect_hash(1000); }
+
+TEST(test_perfect_hash, large_vocabulary) { test_perfect_hash(1000000); }
+
+TEST(test_perfect_hash, duplicate_keys) {
+  EXPECT_ANY_THROW(build_perfect_hash({1, 2, 3, 2}));
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <embeddings/dataset_stats.hpp>
+#include <embeddings/shard_planner.hpp>
+#include <fstream>
+#include <optimizer.hpp>
+#include <random>
+
+using namespace HugeCTR;
+
+namespace {
+
+struct TestCollection {
+  std::unordered_map<std::string, int> table_name_to_id_dict;
+  std::vector<embedding::EmbeddingTableParam> table_params;
+  std::vector<embedding::LookupParam> lookup_params;
+
+  void add_table(int max_vocabulary_size, int ev_size, int hotness) {
+    const int table_id{static_cast<int>(table_params.size())};
+    OptParams opt_param;
+    opt_param.optimizer = Optimizer_t::Adam;
+    table_name_to_id_dict[std::to_string(table_id)] = table_id;
+    table_params.emplace_back(table_id, max_vocabulary_size, ev_size, opt_param);
+    lookup_params.emplace_back(table_id, table_id, embedding::Combiner::Sum, hotness, ev_size);
+  }
+
+  ShardPlan plan(const ShardPlannerParams& params, int num_nodes, int num_gpus_per_node) const {
+    return plan_shards(params, table_name_to_id_dict, table_params, lookup_params, 65536,
+                       num_nodes, num_gpus_per_node, sizeof(float),
+                       embedding::AllreduceStrategy::Dense);
+  }
+};
+
+int num_shards(const ShardPlan& plan, int table_id) {
+  int count = 0;
+  for (const auto& row : plan.shard_matrix) {
+    count += row[table_id];
+  }
+  return count;
+}
+
+TEST(test_shard_planner, balance_and_placement) {
+  TestCollection collection;
+  std::mt19937 gen{42};
+  // 1 huge table, and many tables from 100 to 10M rows.
+  collection.add_table(400000000, 128, 1);
+  for (int i = 0; i < 200; ++i) {
+    collection.add_table(static_cast<int>(std::pow(10., 2 + (gen() % 50) / 10.)), 128,
+                         1 + gen() % 20);
+  }
+  const int num_gpus = 16;
+  const ShardPlan plan{collection.plan(ShardPlannerParams(80), 2, 8)};
+
+  ASSERT_EQ(plan.shard_matrix.size(), num_gpus);
+  // The huge table (about 600 GB with Adam states) requires row-wise sharding.
+  EXPECT_GE(num_shards(plan, 0), 8);
+
+  std::vector<int> placement(collection.table_params.size(), -1);
+  for (const auto& group : plan.grouped_table_params) {
+    for (int table_id : group.table_ids) {
+      EXPECT_EQ(placement[table_id], -1);
+      placement[table_id] = static_cast<int>(group.table_placement_strategy);
+      if (group.table_placement_strategy == embedding::TablePlacementStrategy::DataParallel) {
+        EXPECT_EQ(num_shards(plan, table_id), num_gpus);
+      } else {
+        EXPECT_GE(num_shards(plan, table_id), 1);
+      }
+    }
+  }
+  for (int p : placement) {
+    EXPECT_NE(p, -1);
+  }
+
+  const double max_cost{*std::max_element(plan.gpu_cost.begin(), plan.gpu_cost.end())};
+  const double min_cost{*std::min_element(plan.gpu_cost.begin(), plan.gpu_cost.end())};
+  EXPECT_LT(max_cost / min_cost, 1.2);
+}
+
+TEST(test_shard_planner, hbm_budget) {
+  TestCollection collection;
+  for (int i = 0; i < 4; ++i) {
+    collection.add_table(10000000, 128, 1);
+  }
+  // Each table takes about 15 GB with Adam states, which does not fit into a single GPU.
+  EXPECT_THROW(collection.plan(ShardPlannerParams(10), 1, 1), std::exception);
+  const ShardPlan plan{collection.plan(ShardPlannerParams(10), 1, 8)};
+  for (int table_id = 0; table_id < 4; ++table_id) {
+    EXPECT_GE(num_shards(plan, table_id), 2);
+  }
+}
+
+TEST(test_shard_planner, data_parallel_small_tables) {
+  TestCollection collection;
+  collection.add_table(100, 16, 10);
+  collection.add_table(100000000, 16, 1);
+  const ShardPlan plan{collection.plan(ShardPlannerParams(), 1, 8)};
+  ASSERT_EQ(plan.grouped_table_params.size(), 2);
+  EXPECT_EQ(num_shards(plan, 0), 8);
+  EXPECT_EQ(plan.grouped_table_params[1].table_placement_strategy,
+            embedding::TablePlacementStrategy::DataParallel);
+
+  ShardPlannerParams mp_only;
+  mp_only.allow_data_parallel = false;
+  const ShardPlan mp_plan{collection.plan(mp_only, 1, 8)};
+  ASSERT_EQ(mp_plan.grouped_table_params.size(), 1);
+  EXPECT_EQ(mp_plan.grouped_table_params[0].table_placement_strategy,
+            embedding::TablePlacementStrategy::ModelParallel);
+}
+
+TEST(test_shard_planner, dataset_stats) {
+  const std::string stats_file{"test_shard_planner_dataset_stats.json"};
+  {
+    std::ofstream file(stats_file);
+    file << R"({"version": 1, "num_samples": 1000, "tables": [{"name": "0", "num_keys": 2000,
+        "num_unique_keys": 100000000.0, "hll_precision": 14,
+        "pooling_factor_histogram": {"1": 500, "3": 500}, "top_keys": [[7, 900], [3, 100]]}]})";
+  }
+  const DatasetStats stats{load_dataset_stats(stats_file)};
+  ASSERT_EQ(stats.tables.size(), 1);
+  const TableKeyStats& table{stats.tables.at("0")};
+  EXPECT_EQ(stats.num_samples, 1000);
+  EXPECT_DOUBLE_EQ(table.mean_pooling_factor(stats.num_samples), 2.);
+  EXPECT_EQ(table.pooling_factor_histogram.at(3), 500);
+  ASSERT_EQ(table.top_keys.size(), 2);
+  EXPECT_EQ(table.top_keys[0], std::make_pair(int64_t{7}, int64_t{900}));
+
+  // The dynamic table only has rows, and must be split, with the unique keys of the stats.
+  TestCollection collection;
+  collection.add_table(-1, 128, 4);
+  EXPECT_EQ(num_shards(collection.plan(ShardPlannerParams(80), 1, 8), 0), 1);
+  ShardPlannerParams params(80);
+  params.dataset_stats = stats_file;
+  EXPECT_GE(num_shards(collection.plan(params, 1, 8), 0), 2);
+
+  {
+    std::ofstream file(stats_file);
+    file << R"({"version": 2, "num_samples": 0, "tables": []})";
+  }
+  EXPECT_THROW(load_dataset_stats(stats_file), std::exception);
+  std::remove(stats_file.c_str());
+}
+
+}  // namespace
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <embedding_training_cache/sparse_model_writeback.hpp>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const char *file_name = "./sparse_model_writeback_test.bin";
+
+// Rows of 13 floats straddle the blocks and the extents, and the file ends in a partial block.
+void sparse_model_writeback_test(IOBackend_t io_backend, size_t dirty_budget_bytes) {
+  const size_t row_size = 13;
+  const size_t num_rows = 10007;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+
+  std::vector<float> expected(num_rows * row_size);
+  for (auto &value : expected) value = dist(gen);
+  {
+    std::ofstream file(file_name, std::ofstream::binary | std::ofstream::trunc);
+    file.write(reinterpret_cast<char *>(expected.data()), expected.size() * sizeof(float));
+  }
+
+  {
+    WritebackConfig config;
+    config.dirty_budget_bytes = dirty_budget_bytes;
+    config.io_backend = io_backend;
+    SparseModelWriteback writeback(file_name, row_size * sizeof(float), config, 4, 8192);
+
+    std::uniform_int_distribution<size_t> row_dist(0, num_rows - 1);
+    for (int round = 0; round < 4; ++round) {
+      // Duplicate rows, and the last row of the file, are written too.
+      const size_t num_src_rows = 3000;
+      std::vector<float> src(num_src_rows * row_size);
+      for (auto &value : src) value = dist(gen);
+      std::vector<size_t> rows(num_src_rows), src_rows(num_src_rows);
+      for (size_t i = 0; i < num_src_rows; ++i) {
+        rows[i] = i == 0 ? num_rows - 1 : row_dist(gen);
+        src_rows[i] = num_src_rows - 1 - i;
+      }
+      writeback.write(rows, src_rows, src.data());
+      for (size_t i = 0; i < num_src_rows; ++i) {
+        std::copy_n(src.begin() + src_rows[i] * row_size, row_size,
+                    expected.begin() + rows[i] * row_size);
+      }
+    }
+    writeback.wait();
+  }
+
+  ASSERT_EQ(std::filesystem::file_size(file_name), num_rows * row_size * sizeof(float));
+  std::vector<float> actual(num_rows * row_size);
+  std::ifstream file(file_name, std::ifstream::binary);
+  file.read(reinterpret_cast<char *>(actual.data()), actual.size() * sizeof(float));
+  for (size_t i = 0; i < actual.size(); ++i) {
+    ASSERT_EQ(actual[i], expected[i]) << "row " << i / row_size;
+  }
+  std::filesystem::remove(file_name);
+}
+
+}  // namespace
+
+TEST(sparse_model_writeback_test, aio) {
+  sparse_model_writeback_test(IOBackend_t::AIO, 1 << 20);
+}
+TEST(sparse_model_writeback_test, aio_small_budget) {
+  sparse_model_writeback_test(IOBackend_t::AIO, 4096);
+}
+#ifdef ENABLE_IO_URING
+TEST(sparse_model_writeback_test, io_uring) {
+  sparse_model_writeback_test(IOBackend_t::IOUring, 1 << 20);
+}
+#endif
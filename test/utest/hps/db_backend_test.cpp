@@ -18,16 +18,21 @@
 #include <gtest/gtest.h>
 
 #include <cassert>
+#include <cmath>
 #include <core23/logger.hpp>
 #include <filesystem>
 #include <fstream>
+#include <hps/bloom_filter.hpp>
 #include <hps/database_backend.hpp>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/mp_hash_map_backend.hpp>
 #include <hps/redis_backend.hpp>
 #include <hps/rocksdb_backend.hpp>
+#include <hps/slab_hash_map_backend.hpp>
+#include <hps/tiered_hash_map_backend.hpp>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 using namespace HugeCTR;
@@ -43,6 +48,21 @@ std::unique_ptr<DatabaseBackendBase<T>> make_db(const DatabaseType_t database_ty
       return std::make_unique<HashMapBackend<T>>(params);
     } break;
 
+    case DatabaseType_t::SlabHashMap: {
+      SlabHashMapBackendParams params;
+      params.num_partitions = 16;
+      return std::make_unique<SlabHashMapBackend<T>>(params);
+    } break;
+
+    case DatabaseType_t::TieredHashMap: {
+      // Keep the memory tier tiny, so that most entries are spilled.
+      TieredHashMapBackendParams params;
+      params.num_partitions = 2;
+      params.overflow_margin = 8;
+      params.overflow_resolution_target = 0.5;
+      return std::make_unique<TieredHashMapBackend<T>>(params);
+    } break;
+
     case DatabaseType_t::RedisCluster: {
       RedisClusterBackendParams params;
       params.address = "127.0.0.1:7000,127.0.0.1:7001,127.0.0.1:7002";
@@ -112,6 +132,15 @@ void db_backend_insert_fetch_test(const DatabaseType_t database_type) {
     for (size_t i{0}; i < values.size(); ++i) {
       EXPECT_DOUBLE_EQ(values[i], expected_values[i]);
     }
+
+    // Asynchronous variant.
+    std::fill(values.begin(), values.end(), 0);
+    db->fetch_async(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()),
+                    sizeof(double), [&](size_t index) { FAIL(); })
+        .wait();
+    for (size_t i{0}; i < values.size(); ++i) {
+      EXPECT_DOUBLE_EQ(values[i], expected_values[i]);
+    }
   }
 }
 
@@ -245,11 +274,338 @@ void db_backend_dump_test(DatabaseType_t database_type) {
   }
 }
 
+template <typename Key>
+void db_backend_multi_sst_ingest_test(DatabaseType_t database_type) {
+  std::unique_ptr<DatabaseBackendBase<Key>> db{make_db<Key>(database_type)};
+
+  // Write two SST files with overlapping key ranges (even and odd keys).
+  std::vector<std::string> paths;
+  for (Key offset{0}; offset < 2; ++offset) {
+    paths.emplace_back("tbl_part" + std::to_string(offset) + ".sst");
+    std::filesystem::remove(paths.back());  // Might be hard-linked by a previous ingestion.
+
+    rocksdb::Options options;
+    rocksdb::EnvOptions env_options;
+    rocksdb::SstFileWriter file(env_options, options);
+    HCTR_ROCKSDB_CHECK(file.Open(paths.back()));
+    for (Key k{offset}; k < 20; k += 2) {
+      const double v{std::cos(static_cast<double>(k))};
+      HCTR_ROCKSDB_CHECK(file.Put({reinterpret_cast<const char*>(&k), sizeof(Key)},
+                                  {reinterpret_cast<const char*>(&v), sizeof(double)}));
+    }
+    HCTR_ROCKSDB_CHECK(file.Finish());
+  }
+
+  // Ingest both files at once.
+  const std::string tag0{HierParameterServerBase::make_tag_name("mdl", "tbl0")};
+  db->load_dump_sst(tag0, paths);
+  std::cout << "tbl0 size " << db->size(tag0) << std::endl;
+
+  for (Key k{0}; k < 20; ++k) {
+    double v;
+    db->fetch(tag0, 1, &k, reinterpret_cast<char*>(&v), sizeof(double),
+              [&](size_t index) { FAIL(); });
+
+    EXPECT_EQ(v, std::cos(static_cast<double>(k)));
+  }
+  db->evict(tag0);
+}
+
+template <typename Backend, typename Params>
+void db_backend_clock_overflow_test() {
+  using Key = long long;
+
+  Params params;
+  params.num_partitions = 1;
+  params.overflow_margin = 100;
+  params.overflow_policy = DatabaseOverflowPolicy_t::EvictClock;
+  std::unique_ptr<DatabaseBackendBase<Key>> db{std::make_unique<Backend>(params)};
+
+  const std::string tag{HierParameterServerBase::make_tag_name("mdl", "tbl")};
+
+  // Fill up the partition.
+  {
+    std::vector<Key> keys(params.overflow_margin);
+    std::iota(keys.begin(), keys.end(), 0);
+    const std::vector<double> values(keys.size(), 1.0);
+    db->insert(tag, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+               sizeof(double), sizeof(double));
+    EXPECT_EQ(db->size(tag), params.overflow_margin);
+  }
+
+  // Make the first 10 keys hot.
+  std::vector<Key> hot_keys(10);
+  std::iota(hot_keys.begin(), hot_keys.end(), 0);
+  {
+    std::vector<double> values(hot_keys.size());
+    db->fetch(tag, hot_keys.size(), hot_keys.data(), reinterpret_cast<char*>(values.data()),
+              sizeof(double), [&](size_t index) { FAIL(); });
+  }
+
+  // Overflow. Only entries that were not accessed should be evicted.
+  {
+    const Key k{static_cast<Key>(params.overflow_margin)};
+    const double v{2.0};
+    db->insert(tag, 1, &k, reinterpret_cast<const char*>(&v), sizeof(double), sizeof(double));
+  }
+  EXPECT_EQ(db->size(tag), params.overflow_margin * 8 / 10 + 1);
+  EXPECT_EQ(
+      db->contains(tag, hot_keys.size(), hot_keys.data(), std::chrono::nanoseconds::zero()),
+      hot_keys.size());
+}
+
+template <typename Backend, typename Params>
+void db_backend_table_overflow_margin_test() {
+  using Key = long long;
+
+  Params params;
+  params.max_batch_size = 1;  // Overflow conditions are checked per batch.
+  params.num_partitions = 1;
+  params.overflow_margin = 100;
+  params.table_overflow_margins = {
+      {HierParameterServerBase::make_tag_name("mdl", "tbl0"), 200},
+      {std::string{HierParameterServerBase::PS_EMBEDDING_TABLE_TAG_PREFIX} + ".mdl", 50},
+  };
+  std::unique_ptr<DatabaseBackendBase<Key>> db{std::make_unique<Backend>(params)};
+
+  std::vector<Key> keys(1000);
+  std::iota(keys.begin(), keys.end(), 0);
+  const std::vector<double> values(keys.size(), 1.0);
+
+  for (const auto& [tag, margin] : std::vector<std::pair<std::string, size_t>>{
+           {HierParameterServerBase::make_tag_name("mdl", "tbl0"), 200},
+           {HierParameterServerBase::make_tag_name("mdl", "tbl1"), 50},
+           {HierParameterServerBase::make_tag_name("other", "tbl0"), 100},
+       }) {
+    db->insert(tag, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+               sizeof(double), sizeof(double));
+    EXPECT_LE(db->size(tag), margin);
+    EXPECT_GE(db->size(tag), margin * 8 / 10);
+  }
+}
+
+template <typename Key>
+void db_backend_hash_map_snapshot_test() {
+  HashMapBackendParams params;
+  params.num_partitions = 4;
+  params.snapshot_path = "hash_map_snapshots";
+  std::filesystem::remove_all(params.snapshot_path);
+
+  const std::string tag0{HierParameterServerBase::make_tag_name("mdl", "tbl0")};
+  const std::string tag1{HierParameterServerBase::make_tag_name("mdl", "tbl1")};
+  const Key num_keys{10'000};
+
+  const auto check = [&](DatabaseBackendBase<Key>& db, const std::string& tag) {
+    EXPECT_EQ(db.size(tag), static_cast<size_t>(num_keys));
+    for (Key k{0}; k < num_keys; ++k) {
+      double v;
+      db.fetch(tag, 1, &k, reinterpret_cast<char*>(&v), sizeof(double),
+               [&](size_t index) { FAIL(); });
+      EXPECT_EQ(v, std::cos(static_cast<double>(k)));
+    }
+  };
+
+  // Populate tables and write snapshots on destruction.
+  {
+    HashMapBackend<Key> db{params};
+    std::vector<Key> keys(num_keys);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::vector<double> values;
+    for (const Key k : keys) {
+      values.push_back(std::cos(static_cast<double>(k)));
+    }
+    db.insert(tag0, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+              sizeof(double), sizeof(double));
+    db.insert(tag1, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+              sizeof(double), sizeof(double));
+  }
+
+  // Restore, then modify the restored tables. Values reside in the mapped snapshot files.
+  {
+    HashMapBackend<Key> db{params};
+    check(db, tag0);
+    check(db, tag1);
+
+    std::vector<Key> keys(static_cast<size_t>(num_keys) / 2);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::vector<double> values;
+    for (const Key k : keys) {
+      values.push_back(std::cos(static_cast<double>(k)) + 1);
+    }
+    db.insert(tag0, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+              sizeof(double), sizeof(double));
+    db.evict(tag0, keys.size() / 2, keys.data());
+    db.evict(tag1);
+    EXPECT_EQ(db.snapshot(), static_cast<size_t>(num_keys) - keys.size() / 2);
+  }
+
+  // Evicted tables must not reappear.
+  {
+    std::unique_ptr<DatabaseBackendBase<Key>> db{std::make_unique<HashMapBackend<Key>>(params)};
+    EXPECT_EQ(db->size(tag1), 0);
+    EXPECT_EQ(db->size(tag0), static_cast<size_t>(num_keys) - static_cast<size_t>(num_keys) / 4);
+    for (Key k{num_keys / 4}; k < num_keys; ++k) {
+      double v;
+      db->fetch(tag0, 1, &k, reinterpret_cast<char*>(&v), sizeof(double),
+                [&](size_t index) { FAIL(); });
+      EXPECT_EQ(v, std::cos(static_cast<double>(k)) + (k < num_keys / 2 ? 1 : 0));
+    }
+    db->evict(tag0);
+  }
+  std::filesystem::remove_all(params.snapshot_path);
+}
+
+void db_backend_redis_value_encoding_test(const DatabaseValueEncoding_t value_encoding) {
+  using Key = long long;
+
+  RedisClusterBackendParams params;
+  params.address = "127.0.0.1:7000,127.0.0.1:7001,127.0.0.1:7002";
+  params.value_encoding = value_encoding;
+  std::unique_ptr<DatabaseBackendBase<Key>> db{std::make_unique<RedisClusterBackend<Key>>(params)};
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("value_encoding", "test")};
+  constexpr size_t emb_vec_size{16};
+
+  std::vector<Key> keys(100);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<float> values(keys.size() * emb_vec_size);
+  for (size_t i{0}; i < values.size(); ++i) {
+    values[i] = static_cast<float>(i) / 64.f - 10.f;
+  }
+  db->insert(tag, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+             emb_vec_size * sizeof(float), emb_vec_size * sizeof(float));
+
+  std::vector<float> fetched(values.size());
+  db->fetch(tag, keys.size(), keys.data(), reinterpret_cast<char*>(fetched.data()),
+            emb_vec_size * sizeof(float), [&](size_t index) { FAIL(); });
+
+  // 16 bit floats retain at least 7 bits of mantissa.
+  for (size_t i{0}; i < values.size(); ++i) {
+    EXPECT_NEAR(fetched[i], values[i], std::abs(values[i]) / 128.f);
+  }
+
+  db->evict(tag);
+}
+
+void db_backend_redis_near_cache_test() {
+  using Key = long long;
+
+  RedisClusterBackendParams params;
+  params.address = "127.0.0.1:7000,127.0.0.1:7001,127.0.0.1:7002";
+  params.near_cache_size = 64;
+  std::unique_ptr<DatabaseBackendBase<Key>> db{std::make_unique<RedisClusterBackend<Key>>(params)};
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("near_cache", "test")};
+  std::vector<Key> keys(100);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<double> values(keys.size());
+  const auto insert = [&](const double offset) {
+    for (size_t i{0}; i < keys.size(); ++i) {
+      values[i] = static_cast<double>(keys[i]) + offset;
+    }
+    db->insert(tag, keys.size(), keys.data(), reinterpret_cast<const char*>(values.data()),
+               sizeof(double), sizeof(double));
+  };
+  const auto check = [&](const double offset) {
+    std::vector<double> fetched(keys.size());
+    EXPECT_EQ(db->fetch(tag, keys.size(), keys.data(), reinterpret_cast<char*>(fetched.data()),
+                        sizeof(double), [&](size_t index) { FAIL(); }),
+              keys.size());
+    for (size_t i{0}; i < keys.size(); ++i) {
+      EXPECT_DOUBLE_EQ(fetched[i], static_cast<double>(keys[i]) + offset);
+    }
+  };
+
+  // The first fetch fills the near-cache, the second one hits it. There are more keys than fit.
+  insert(0);
+  check(0);
+  check(0);
+
+  // Inserts invalidate the cached values.
+  insert(1000);
+  check(1000);
+
+  // Indirect fetches only return the requested keys.
+  {
+    const std::vector<size_t> indices{5, 97, 42};
+    std::vector<double> fetched(keys.size(), -1);
+    EXPECT_EQ(db->fetch(tag, indices.size(), indices.data(), keys.data(),
+                        reinterpret_cast<char*>(fetched.data()), sizeof(double),
+                        [&](size_t index) { FAIL(); }),
+              indices.size());
+    for (size_t i{0}; i < keys.size(); ++i) {
+      const bool requested{std::find(indices.begin(), indices.end(), i) != indices.end()};
+      EXPECT_DOUBLE_EQ(fetched[i], requested ? static_cast<double>(keys[i]) + 1000 : -1);
+    }
+  }
+
+  // Evicted keys are no longer fetched from the near-cache.
+  db->evict(tag, 10, keys.data());
+  {
+    std::vector<double> fetched(keys.size());
+    size_t num_misses{0};
+    EXPECT_EQ(db->fetch(tag, keys.size(), keys.data(), reinterpret_cast<char*>(fetched.data()),
+                        sizeof(double),
+                        [&](size_t index) {
+                          EXPECT_LT(index, 10);
+                          ++num_misses;
+                        }),
+              keys.size() - 10);
+    EXPECT_EQ(num_misses, 10);
+  }
+
+  db->evict(tag);
+}
+
+template <typename Key>
+void bloom_filter_test(const size_t bits_per_key, const double max_false_positive_rate) {
+  const size_t num_keys{1'000'000};
+  BloomFilter filter(num_keys, bits_per_key);
+
+  std::vector<Key> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0);
+  filter.insert(keys.size(), keys.data());
+
+  // Never yields false negatives.
+  for (const Key& k : keys) {
+    ASSERT_TRUE(filter.may_contain(static_cast<uint64_t>(k)));
+  }
+
+  size_t num_false_positives{0};
+  for (Key k{static_cast<Key>(num_keys)}; k != static_cast<Key>(2 * num_keys); ++k) {
+    num_false_positives += filter.may_contain(static_cast<uint64_t>(k));
+  }
+  const double false_positive_rate{static_cast<double>(num_false_positives) / num_keys};
+  std::cout << "Bloom filter (" << bits_per_key << " bits / key): false positive rate "
+            << false_positive_rate << std::endl;
+  EXPECT_LT(false_positive_rate, max_false_positive_rate);
+}
+
 }  // namespace
 
+TEST(db_backend_clock_overflow_test, HashMap) {
+  db_backend_clock_overflow_test<HashMapBackend<long long>, HashMapBackendParams>();
+}
+TEST(db_backend_clock_overflow_test, SlabHashMap) {
+  db_backend_clock_overflow_test<SlabHashMapBackend<long long>, SlabHashMapBackendParams>();
+}
+
+TEST(db_backend_table_overflow_margin_test, HashMap) {
+  db_backend_table_overflow_margin_test<HashMapBackend<long long>, HashMapBackendParams>();
+}
+TEST(db_backend_table_overflow_margin_test, SlabHashMap) {
+  db_backend_table_overflow_margin_test<SlabHashMapBackend<long long>, SlabHashMapBackendParams>();
+}
+
 TEST(db_backend_insert_fetch_test, HashMap) {
   db_backend_insert_fetch_test<long long>(DatabaseType_t::HashMap);
 }
+TEST(db_backend_insert_fetch_test, SlabHashMap) {
+  db_backend_insert_fetch_test<long long>(DatabaseType_t::SlabHashMap);
+}
+TEST(db_backend_insert_fetch_test, TieredHashMap) {
+  db_backend_insert_fetch_test<long long>(DatabaseType_t::TieredHashMap);
+}
 TEST(db_backend_insert_fetch_test, Redis) {
   db_backend_insert_fetch_test<long long>(DatabaseType_t::RedisCluster);
 }
@@ -260,6 +616,12 @@ TEST(db_backend_insert_fetch_test, Rocksdb) {
 TEST(db_backend_multi_evict, HashMap) {
   db_backend_multi_evict_test<long long>(DatabaseType_t::HashMap);
 }
+TEST(db_backend_multi_evict, SlabHashMap) {
+  db_backend_multi_evict_test<long long>(DatabaseType_t::SlabHashMap);
+}
+TEST(db_backend_multi_evict, TieredHashMap) {
+  db_backend_multi_evict_test<long long>(DatabaseType_t::TieredHashMap);
+}
 TEST(db_backend_multi_evict, Redis) {
   db_backend_multi_evict_test<long long>(DatabaseType_t::RedisCluster);
 }
@@ -268,7 +630,34 @@ TEST(db_backend_multi_evict, Rocksdb) {
 }
 
 TEST(db_backend_dump_load, HashMap) { db_backend_dump_test<long long>(DatabaseType_t::HashMap); }
+TEST(db_backend_dump_load, SlabHashMap) {
+  db_backend_dump_test<long long>(DatabaseType_t::SlabHashMap);
+}
+TEST(db_backend_dump_load, TieredHashMap) {
+  db_backend_dump_test<long long>(DatabaseType_t::TieredHashMap);
+}
 TEST(db_backend_dump_load, RedisCluster) {
   db_backend_dump_test<long long>(DatabaseType_t::RedisCluster);
 }
 TEST(db_backend_dump_load, RocksDB) { db_backend_dump_test<long long>(DatabaseType_t::RocksDB); }
+
+TEST(db_backend_hash_map_snapshot, HashMap) { db_backend_hash_map_snapshot_test<long long>(); }
+
+TEST(db_backend_multi_sst_ingest, HashMap) {
+  db_backend_multi_sst_ingest_test<long long>(DatabaseType_t::HashMap);
+}
+TEST(db_backend_multi_sst_ingest, RocksDB) {
+  db_backend_multi_sst_ingest_test<long long>(DatabaseType_t::RocksDB);
+}
+
+TEST(db_backend_redis_value_encoding_test, Float16) {
+  db_backend_redis_value_encoding_test(DatabaseValueEncoding_t::Float16);
+}
+TEST(db_backend_redis_value_encoding_test, BFloat16) {
+  db_backend_redis_value_encoding_test(DatabaseValueEncoding_t::BFloat16);
+}
+
+TEST(db_backend_redis_near_cache_test, RedisCluster) { db_backend_redis_near_cache_test(); }
+
+TEST(db_backend_bloom_filter_test, BitsPerKey8) { bloom_filter_test<long long>(8, 0.04); }
+TEST(db_backend_bloom_filter_test, BitsPerKey16) { bloom_filter_test<long long>(16, 0.005); }
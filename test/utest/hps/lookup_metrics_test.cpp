@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <hps/lookup_metrics.hpp>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+TEST(lookup_metrics, histogram_buckets) {
+  LatencyHistogram histogram;
+  for (const uint64_t latency_us : std::vector<uint64_t>{0, 1, 2, 3, 4, 5, 1000, 1ull << 40}) {
+    histogram.observe(latency_us);
+  }
+  const LatencyHistogram::Snapshot snapshot{histogram.snapshot()};
+  EXPECT_EQ(snapshot.count, 8);
+  EXPECT_EQ(snapshot.counts[0], 2);   // <= 1 us
+  EXPECT_EQ(snapshot.counts[1], 1);   // <= 2 us
+  EXPECT_EQ(snapshot.counts[2], 2);   // <= 4 us
+  EXPECT_EQ(snapshot.counts[3], 1);   // <= 8 us
+  EXPECT_EQ(snapshot.counts[10], 1);  // <= 1024 us
+  EXPECT_EQ(snapshot.counts[LatencyHistogram::num_buckets - 1], 1);
+  EXPECT_EQ(snapshot.sum_us, 1015 + (1ull << 40));
+}
+
+TEST(lookup_metrics, concurrent_observations) {
+  LatencyHistogram histogram;
+  constexpr size_t num_threads{8};
+  constexpr size_t num_observations{100000};
+  std::vector<std::thread> threads;
+  for (size_t i{0}; i < num_threads; ++i) {
+    threads.emplace_back([&histogram]() {
+      for (size_t j{0}; j < num_observations; ++j) {
+        histogram.observe(j % 100);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(histogram.snapshot().count, num_threads * num_observations);
+}
+
+TEST(lookup_metrics, openmetrics_export) {
+  LookupMetrics& metrics{LookupMetrics::instance()};
+  LatencyHistogram& histogram{metrics.histogram("test_model", 1, LookupStage_t::VDBFetch)};
+  EXPECT_EQ(&histogram, &metrics.histogram("test_model", 1, LookupStage_t::VDBFetch));
+  histogram.observe(3);
+  histogram.observe(5000000);
+
+  const std::string labels{"{model=\"test_model\",table=\"1\",stage=\"vdb_fetch\""};
+  const std::string text{metrics.to_openmetrics()};
+  EXPECT_NE(text.find("hps_lookup_stage_latency_seconds_bucket" + labels + ",le=\"4e-06\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("hps_lookup_stage_latency_seconds_bucket" + labels + ",le=\"+Inf\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("hps_lookup_stage_latency_seconds_count" + labels + "} 2\n"),
+            std::string::npos);
+  EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+
+  size_t num_visited{0};
+  metrics.visit([&](const std::string& model_name, const size_t table_id, const LookupStage_t stage,
+                    const LatencyHistogram::Snapshot& snapshot) {
+    if (model_name == "test_model" && table_id == 1 && stage == LookupStage_t::VDBFetch) {
+      EXPECT_EQ(snapshot.count, 2);
+      ++num_visited;
+    }
+  });
+  EXPECT_EQ(num_visited, 1);
+}
+
+}  // namespace
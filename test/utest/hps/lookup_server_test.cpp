@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <hps/lookup_server.hpp>
+#include <hps/remote_lookup.hpp>
+#include <numeric>
+#include <thread>
+#include <utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+constexpr size_t max_batchsize{4};
+constexpr size_t max_keys_per_sample{8};
+const std::vector<size_t> vector_sizes{4, 2};
+
+// Looks up the vector key * (table_id + 1) + j, for j in [0, vector size), and counts its calls.
+class FakeLookupSession : public LookupSessionBase {
+ public:
+  FakeLookupSession()
+      : params_("test_model", max_batchsize, 1.0f, "", {"table0", "table1"}, 0, true, 1.0f) {
+    params_.maxnum_catfeature_query_per_table_per_sample = {max_keys_per_sample,
+                                                            max_keys_per_sample};
+    params_.embedding_vecsize_per_table = vector_sizes;
+  }
+
+  void lookup(const void* const h_keys, float* const d_vectors, const size_t num_keys,
+              const size_t table_id) override {
+    EXPECT_LE(num_keys, max_batchsize * max_keys_per_sample);
+    const long long* const keys{static_cast<const long long*>(h_keys)};
+    const size_t vector_size{vector_sizes[table_id]};
+    std::vector<float> vectors(num_keys * vector_size);
+    for (size_t i{0}; i < num_keys; ++i) {
+      for (size_t j{0}; j < vector_size; ++j) {
+        vectors[i * vector_size + j] = static_cast<float>(keys[i] * (table_id + 1) + j);
+      }
+    }
+    HCTR_LIB_THROW(cudaMemcpy(d_vectors, vectors.data(), sizeof(float) * vectors.size(),
+                              cudaMemcpyHostToDevice));
+    ++num_lookups;
+  }
+  void lookup(const void* const h_keys, float* const d_vectors, const size_t num_keys,
+              const size_t table_id, cudaStream_t) override {
+    lookup(h_keys, d_vectors, num_keys, table_id);
+  }
+  void lookup(const std::vector<const void*>&, const std::vector<float*>&,
+              const std::vector<size_t>&) override {}
+  void lookup_from_device(const void*, float*, size_t, size_t) override {}
+  void lookup_from_device(const void*, float*, size_t, size_t, cudaStream_t) override {}
+  void lookup_from_device(const std::vector<const void*>&, const std::vector<float*>&,
+                          const std::vector<size_t>&) override {}
+  void lookup_from_device_pooled(const void*, size_t, const PoolingRows&, float*,
+                                 size_t) override {}
+  void lookup_from_device_pooled(const void*, size_t, const PoolingRows&, float*, size_t,
+                                 cudaStream_t) override {}
+  const InferenceParams get_inference_params() const override { return params_; }
+  void set_profiler(int, int, bool) override {}
+  void profiler_print() override {}
+
+  std::atomic<size_t> num_lookups{0};
+
+ private:
+  void lookup_with_table_fusion_impl(const void*, float*, size_t, size_t, bool,
+                                     cudaStream_t) override {}
+  void lookup_from_device_impl(const void*, float*, size_t, size_t, cudaStream_t) override {}
+  void lookup_impl(const void* const, float* const, const size_t, const size_t,
+                   cudaStream_t) override {}
+
+  InferenceParams params_;
+};
+
+void check_vectors(const std::vector<long long>& keys, const std::vector<float>& vectors,
+                   const size_t table_id) {
+  const size_t vector_size{vector_sizes[table_id]};
+  ASSERT_EQ(vectors.size(), keys.size() * vector_size);
+  for (size_t i{0}; i < keys.size(); ++i) {
+    for (size_t j{0}; j < vector_size; ++j) {
+      ASSERT_EQ(vectors[i * vector_size + j], static_cast<float>(keys[i] * (table_id + 1) + j));
+    }
+  }
+}
+
+TEST(lookup_server, full_batch_is_one_lookup) {
+  const auto fake_session{std::make_shared<FakeLookupSession>()};
+  // The delay is long enough that only a full batch can start the lookup in time.
+  BatchedLookupSession session(fake_session, std::chrono::seconds(60));
+
+  constexpr size_t num_threads{max_batchsize};
+  std::vector<std::thread> threads;
+  for (size_t i{0}; i < num_threads; ++i) {
+    threads.emplace_back([&session, i]() {
+      std::vector<long long> keys(max_keys_per_sample);
+      std::iota(keys.begin(), keys.end(), static_cast<long long>(i * 1000));
+      std::vector<float> vectors(keys.size() * vector_sizes[0]);
+      session.lookup(keys.data(), vectors.data(), keys.size(), 0);
+      check_vectors(keys, vectors, 0);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(fake_session->num_lookups, 1);
+}
+
+TEST(lookup_server, remote_lookup) {
+  const auto fake_session{std::make_shared<FakeLookupSession>()};
+  const auto session{
+      std::make_shared<BatchedLookupSession>(fake_session, std::chrono::microseconds(100))};
+  LookupServer server({session}, 0);
+  std::thread serve_thread([&server]() { server.serve(); });
+
+  constexpr size_t num_clients{8};
+  std::vector<std::thread> clients;
+  for (size_t i{0}; i < num_clients; ++i) {
+    clients.emplace_back([&server, i]() {
+      RemoteLookupClient client("localhost", server.port());
+      for (size_t iteration{0}; iteration < 100; ++iteration) {
+        const size_t table_id{(i + iteration) % vector_sizes.size()};
+        std::vector<long long> keys(1 + (i + iteration) % max_keys_per_sample);
+        std::iota(keys.begin(), keys.end(), static_cast<long long>(i * 100000 + iteration));
+        check_vectors(keys, client.lookup(keys.data(), keys.size(), table_id), table_id);
+      }
+    });
+  }
+  for (std::thread& client : clients) {
+    client.join();
+  }
+
+  RemoteLookupClient client("localhost", server.port());
+  // Lookups of more keys than a batch holds are split.
+  std::vector<long long> keys(3 * max_batchsize * max_keys_per_sample + 1);
+  std::iota(keys.begin(), keys.end(), 0);
+  check_vectors(keys, client.lookup(keys.data(), keys.size(), 1), 1);
+  // Errors are reported to the client, and the connection stays usable.
+  EXPECT_THROW(client.lookup(keys.data(), keys.size(), vector_sizes.size()), std::runtime_error);
+  const std::vector<unsigned int> short_keys{1, 2, 3};
+  EXPECT_THROW(client.lookup(short_keys.data(), short_keys.size(), 0), std::runtime_error);
+  check_vectors({42}, client.lookup(keys.data() + 42, 1, 0), 0);
+
+  server.shutdown();
+  serve_thread.join();
+}
+
+TEST(lookup_server, reconnects_are_joined) {
+  const auto fake_session{std::make_shared<FakeLookupSession>()};
+  const auto session{
+      std::make_shared<BatchedLookupSession>(fake_session, std::chrono::microseconds(100))};
+  LookupServer server({session}, 0);
+  std::thread serve_thread([&server]() { server.serve(); });
+
+  // Each client connects, looks up once and disconnects again.
+  constexpr size_t num_clients{64};
+  for (size_t i{0}; i < num_clients; ++i) {
+    RemoteLookupClient client("localhost", server.port());
+    const std::vector<long long> keys{static_cast<long long>(i)};
+    check_vectors(keys, client.lookup(keys.data(), keys.size(), 0), 0);
+  }
+  // The threads of the closed connections are joined when the next client connects.
+  EXPECT_LT(server.num_connection_threads(), num_clients / 2);
+
+  server.shutdown();
+  serve_thread.join();
+}
+
+}  // namespace
@@ -116,13 +116,14 @@ void generate_config_file(const std::string& ps_config_file, bool i64_input_key,
                           const std::vector<std::string>& sparse_files,
                           const std::vector<size_t>& embedding_vecsize_per_table,
                           const std::vector<size_t>& maxnum_catfeature_query_per_table_per_sample,
-                          const std::string& embedding_cache_type) {
+                          const std::string& embedding_cache_type,
+                          bool fuse_embedding_table = true) {
   EXPECT_EQ(sparse_files.size(), embedding_vecsize_per_table.size());
   EXPECT_EQ(sparse_files.size(), maxnum_catfeature_query_per_table_per_sample.size());
 
   nlohmann::json ps_config;
   ps_config["supportlonglong"] = i64_input_key;
-  ps_config["fuse_embedding_table"] = true;
+  ps_config["fuse_embedding_table"] = fuse_embedding_table;
 
   nlohmann::json model_config;
   {
@@ -318,6 +319,86 @@ void lookup_session_fusing_table_test(
   }
 }
 
+// Pools rows of up to max_hotness keys of a single table, and compares them with the pooled ground
+// truth.
+template <typename TypeHashKey>
+void lookup_session_pooled_test(const std::string& ps_config_file, const std::string& sparse_file,
+                                size_t num_table_keys, size_t emb_vec_size, size_t max_hotness,
+                                const std::string& embedding_cache_type,
+                                PoolingCombiner_t combiner) {
+  bool i64_input_key = std::is_same<long long, TypeHashKey>::value;
+  generate_embedding_tables({sparse_file}, {emb_vec_size},
+                            {0, static_cast<long long>(num_table_keys)});
+  generate_config_file(ps_config_file, i64_input_key, {sparse_file}, {emb_vec_size}, {max_hotness},
+                       embedding_cache_type, false);
+
+  parameter_server_config ps_config{ps_config_file};
+  auto inference_params = ps_config.inference_params_array[0];
+  auto device_id = inference_params.deployed_devices[0];
+  auto parameter_server = HierParameterServerBase::create(ps_config);
+  auto embedding_cache = parameter_server->get_embedding_cache(inference_params.model_name,
+                                                               device_id);
+  auto lookup_session = LookupSessionBase::create(inference_params, embedding_cache);
+  std::map<size_t, std::map<TypeHashKey, std::vector<float>>> embeddings_per_table;
+  get_embedding_per_table({sparse_file}, {emb_vec_size}, embeddings_per_table);
+
+  CudaDeviceContext context(device_id);
+  const size_t num_rows = inference_params.max_batchsize;
+  TypeHashKey* d_keys;
+  int64_t* d_row_offsets;
+  float* d_pooled_vectors;
+  HCTR_LIB_THROW(
+      cudaMalloc(reinterpret_cast<void**>(&d_keys), num_rows * max_hotness * sizeof(TypeHashKey)));
+  HCTR_LIB_THROW(
+      cudaMalloc(reinterpret_cast<void**>(&d_row_offsets), (num_rows + 1) * sizeof(int64_t)));
+  HCTR_LIB_THROW(cudaMalloc(reinterpret_cast<void**>(&d_pooled_vectors),
+                            num_rows * emb_vec_size * sizeof(float)));
+
+  for (size_t iter{0}; iter < 10; ++iter) {
+    // Rows of 0 to max_hotness keys, which repeat within and across rows.
+    std::vector<int64_t> h_row_offsets{0};
+    std::vector<TypeHashKey> h_keys;
+    for (size_t row{0}; row < num_rows; ++row) {
+      const size_t hotness = rand() % (max_hotness + 1);
+      for (size_t j{0}; j < hotness; ++j) {
+        h_keys.push_back(static_cast<TypeHashKey>(rand() % num_table_keys));
+      }
+      h_row_offsets.push_back(static_cast<int64_t>(h_keys.size()));
+    }
+    HCTR_LIB_THROW(cudaMemcpy(d_keys, h_keys.data(), h_keys.size() * sizeof(TypeHashKey),
+                              cudaMemcpyHostToDevice));
+    HCTR_LIB_THROW(cudaMemcpy(d_row_offsets, h_row_offsets.data(),
+                              h_row_offsets.size() * sizeof(int64_t), cudaMemcpyHostToDevice));
+    const PoolingRows rows{d_row_offsets, num_rows, combiner};
+    lookup_session->lookup_from_device_pooled(d_keys, h_keys.size(), rows, d_pooled_vectors, 0);
+
+    std::vector<float> h_pooled_vectors(num_rows * emb_vec_size);
+    HCTR_LIB_THROW(cudaMemcpy(h_pooled_vectors.data(), d_pooled_vectors,
+                              h_pooled_vectors.size() * sizeof(float), cudaMemcpyDeviceToHost));
+    std::vector<float> h_pooled_vectors_gt(num_rows * emb_vec_size, 0.f);
+    for (size_t row{0}; row < num_rows; ++row) {
+      const int64_t begin = h_row_offsets[row], end = h_row_offsets[row + 1];
+      for (int64_t key_idx{begin}; key_idx < end; ++key_idx) {
+        const std::vector<float>& vector_gt = embeddings_per_table[0].at(h_keys[key_idx]);
+        for (size_t k{0}; k < emb_vec_size; ++k) {
+          h_pooled_vectors_gt[row * emb_vec_size + k] += vector_gt[k];
+        }
+      }
+      if (combiner == PoolingCombiner_t::Mean && end > begin) {
+        for (size_t k{0}; k < emb_vec_size; ++k) {
+          h_pooled_vectors_gt[row * emb_vec_size + k] /= static_cast<float>(end - begin);
+        }
+      }
+    }
+    compare_lookup(h_pooled_vectors_gt.data(), h_pooled_vectors.data(), h_pooled_vectors.size(),
+                   0.001);
+  }
+
+  HCTR_LIB_THROW(cudaFree(d_keys));
+  HCTR_LIB_THROW(cudaFree(d_row_offsets));
+  HCTR_LIB_THROW(cudaFree(d_pooled_vectors));
+}
+
 }  // end namespace
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -495,4 +576,19 @@ TEST(lookup_session, uvm_table_8_i64_internal_multithreading) {
        "fusion_utest/table4", "fusion_utest/table5", "fusion_utest/table6", "fusion_utest/table7"},
       {0, 10000, 20000, 30000, 40000, 50000, 60000, 70000, 80000},
       {128, 32, 32, 128, 128, 128, 32, 128}, {10, 20, 10, 10, 30, 20, 10, 30}, true, "uvm");
-}
\ No newline at end of file
+}
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Pooled Lookup Test
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST(lookup_session, dynamic_table_pooled_sum) {
+  lookup_session_pooled_test<long long>("pooled_utest.json", "pooled_utest/table0", 10000, 32, 20,
+                                        "dynamic", PoolingCombiner_t::Sum);
+}
+TEST(lookup_session, dynamic_table_pooled_mean) {
+  lookup_session_pooled_test<unsigned int>("pooled_utest.json", "pooled_utest/table0", 10000, 32,
+                                           20, "dynamic", PoolingCombiner_t::Mean);
+}
+TEST(lookup_session, static_table_pooled_mean) {
+  lookup_session_pooled_test<long long>("pooled_utest.json", "pooled_utest/table0", 10000, 32, 20,
+                                        "static", PoolingCombiner_t::Mean);
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <hps/mapped_sparse_model.hpp>
+#include <random>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const std::string sparse_model{"./mapped_sparse_model_test.model"};
+
+void write_and_map(const bool hash_index) {
+  constexpr size_t num_keys{10000};
+  constexpr size_t embedding_vec_size{16};
+  std::vector<long long> keys(num_keys);
+  std::vector<float> vectors(num_keys * embedding_vec_size);
+  std::mt19937_64 gen{42};
+  for (size_t i{0}; i < num_keys; ++i) {
+    keys[i] = static_cast<long long>(gen() >> 1) * (i % 2 == 0 ? 1 : -1);
+    for (size_t j{0}; j < embedding_vec_size; ++j) {
+      vectors[i * embedding_vec_size + j] = static_cast<float>(i * embedding_vec_size + j);
+    }
+  }
+
+  const std::string path{sparse_model + "/" + mapped_sparse_model_file_name};
+  std::filesystem::create_directories(sparse_model);
+  write_mapped_sparse_model(path, keys.data(), vectors.data(), num_keys, embedding_vec_size,
+                            hash_index);
+
+  const MappedSparseModel model{path};
+  ASSERT_EQ(model.num_keys(), num_keys);
+  ASSERT_EQ(model.embedding_vec_size(), embedding_vec_size);
+  EXPECT_TRUE(std::is_sorted(model.keys(), model.keys() + num_keys));
+  for (size_t i{0}; i < num_keys; ++i) {
+    const float* const vector{model.find(keys[i])};
+    ASSERT_NE(vector, nullptr);
+    for (size_t j{0}; j < embedding_vec_size; ++j) {
+      ASSERT_EQ(vector[j], vectors[i * embedding_vec_size + j]);
+    }
+  }
+  EXPECT_EQ(model.find(static_cast<long long>(gen() >> 1)), nullptr);
+  std::filesystem::remove_all(sparse_model);
+}
+
+TEST(mapped_sparse_model, binary_search) { write_and_map(false); }
+
+TEST(mapped_sparse_model, hash_index) { write_and_map(true); }
+
+TEST(mapped_sparse_model, duplicates_keep_last_vector) {
+  const std::vector<long long> keys{7, 3, 7, 5, 3};
+  const std::vector<float> vectors{1, 1, 2, 2, 3, 3, 4, 4, 5, 5};
+
+  const std::string path{sparse_model + "/" + mapped_sparse_model_file_name};
+  std::filesystem::create_directories(sparse_model);
+  write_mapped_sparse_model(path, keys.data(), vectors.data(), keys.size(), 2, true);
+
+  const MappedSparseModel model{path};
+  ASSERT_EQ(model.num_keys(), 3);
+  EXPECT_EQ(std::vector<long long>(model.keys(), model.keys() + 3),
+            std::vector<long long>({3, 5, 7}));
+  EXPECT_EQ(std::vector<float>(model.vectors(), model.vectors() + 6),
+            std::vector<float>({5, 5, 4, 4, 3, 3}));
+  std::filesystem::remove_all(sparse_model);
+}
+
+TEST(mapped_sparse_model, convert_key_and_emb_vector_files) {
+  const std::vector<long long> keys{4, 2, 9};
+  const std::vector<float> vectors{4, 4, 4, 2, 2, 2, 9, 9, 9};
+
+  std::filesystem::create_directories(sparse_model);
+  std::ofstream(sparse_model + "/key", std::ofstream::binary)
+      .write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(long long));
+  std::ofstream(sparse_model + "/emb_vector", std::ofstream::binary)
+      .write(reinterpret_cast<const char*>(vectors.data()), vectors.size() * sizeof(float));
+  convert_to_mapped_sparse_model(sparse_model);
+
+  const MappedSparseModel model{sparse_model + "/" + mapped_sparse_model_file_name};
+  ASSERT_EQ(model.num_keys(), 3);
+  ASSERT_EQ(model.embedding_vec_size(), 3);
+  for (const long long key : keys) {
+    const float* const vector{model.find(key)};
+    ASSERT_NE(vector, nullptr);
+    EXPECT_EQ(vector[0], static_cast<float>(key));
+  }
+  std::filesystem::remove_all(sparse_model);
+}
+
+TEST(mapped_sparse_model, rejects_other_files) {
+  std::filesystem::create_directories(sparse_model);
+  const std::string path{sparse_model + "/" + mapped_sparse_model_file_name};
+  std::ofstream(path, std::ofstream::binary) << std::string(4096, 'x');
+  EXPECT_ANY_THROW(MappedSparseModel{path});
+  std::filesystem::remove_all(sparse_model);
+}
+
+}  // namespace
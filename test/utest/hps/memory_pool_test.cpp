@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <hps/memory_pool.hpp>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+// Embedding cache whose workspaces are empty, and which counts how many of them exist.
+class FakeEmbeddingCache : public EmbeddingCacheBase {
+ public:
+  FakeEmbeddingCache() { config_.cuda_dev_id_ = 0; }
+
+  void lookup(size_t, float*, const void*, size_t, float, cudaStream_t) override {}
+  void lookup_from_device(size_t, float*, const void*, size_t, float, cudaStream_t) override {}
+  void insert(size_t, EmbeddingCacheWorkspace&, cudaStream_t) override {}
+  void init(const size_t, EmbeddingCacheRefreshspace&, cudaStream_t) override {}
+  void init(const size_t, void*, void*, float*, size_t, cudaStream_t) override {}
+  void dump(size_t, void*, size_t*, size_t, size_t, cudaStream_t) override {}
+  void refresh(size_t, const void*, const void*, size_t, cudaStream_t) override {}
+  void finalize() override {}
+
+  EmbeddingCacheWorkspace create_workspace() override {
+    ++num_workspaces;
+    return {};
+  }
+  void destroy_workspace(EmbeddingCacheWorkspace&) override { --num_workspaces; }
+  EmbeddingCacheRefreshspace create_refreshspace() override { return {}; }
+  void destroy_refreshspace(EmbeddingCacheRefreshspace&) override {}
+
+  const embedding_cache_config& get_cache_config() override { return config_; }
+  const std::vector<cudaStream_t>& get_refresh_streams() override { return streams_; }
+  const std::vector<cudaStream_t>& get_insert_streams() override { return streams_; }
+  int get_device_id() override { return 0; }
+  bool use_gpu_embedding_cache() override { return true; }
+  void set_profiler(int, int, bool) override {}
+  void profiler_print() override {}
+
+  std::atomic<int> num_workspaces{0};
+
+ private:
+  embedding_cache_config config_;
+  std::vector<cudaStream_t> streams_;
+};
+
+TEST(memory_pool, grows_up_to_limit) {
+  const auto cache{std::make_shared<FakeEmbeddingCache>()};
+  MemoryPool pool(2, cache, CACHE_SPACE_TYPE::WORKER, 4);
+  EXPECT_EQ(cache->num_workspaces, 2);
+
+  std::vector<void*> blocks;
+  for (size_t i{0}; i < 4; ++i) {
+    blocks.emplace_back(pool.AllocMemory());
+    ASSERT_NE(blocks.back(), nullptr);
+  }
+  EXPECT_EQ(cache->num_workspaces, 4);
+  EXPECT_EQ(pool.AllocMemory(), nullptr);
+
+  // Returned blocks are reused instead of growing the pool further.
+  pool.FreeMemory(blocks.back());
+  EXPECT_EQ(pool.AllocMemory(), blocks.back());
+  for (void* const block : blocks) {
+    pool.FreeMemory(block);
+  }
+  pool.DestoryMemoryPool(CACHE_SPACE_TYPE::WORKER);
+  EXPECT_EQ(cache->num_workspaces, 0);
+}
+
+TEST(memory_pool, fixed_size_without_limit) {
+  const auto cache{std::make_shared<FakeEmbeddingCache>()};
+  MemoryPool pool(1, cache);
+  void* const block{pool.AllocMemory()};
+  ASSERT_NE(block, nullptr);
+  EXPECT_EQ(pool.AllocMemory(), nullptr);
+  pool.FreeMemory(block);
+  EXPECT_EQ(pool.AllocMemory(), block);
+  pool.FreeMemory(block);
+  pool.DestoryMemoryPool(CACHE_SPACE_TYPE::WORKER);
+}
+
+TEST(memory_pool, concurrent_blocks_are_exclusive) {
+  const auto cache{std::make_shared<FakeEmbeddingCache>()};
+  constexpr size_t max_blocks{8};
+  MemoryPool pool(2, cache, CACHE_SPACE_TYPE::WORKER, max_blocks);
+
+  std::array<std::atomic<int>, MAX_MEMORY_SIZE> owners{};
+  std::atomic<bool> overlap{false};
+  std::vector<std::thread> threads;
+  for (size_t i{0}; i < 16; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t iteration{0}; iteration < 20000; ++iteration) {
+        MemoryBlock* block{nullptr};
+        while (block == nullptr) {
+          block = static_cast<MemoryBlock*>(pool.AllocMemory());
+        }
+        if (owners[block->nIndex].fetch_add(1) != 0) {
+          overlap = true;
+        }
+        owners[block->nIndex].fetch_sub(1);
+        pool.FreeMemory(block);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(overlap);
+  EXPECT_LE(cache->num_workspaces, static_cast<int>(max_blocks));
+
+  // All blocks are back in the pool.
+  std::vector<void*> blocks;
+  for (void* block{pool.AllocMemory()}; block; block = pool.AllocMemory()) {
+    blocks.emplace_back(block);
+  }
+  EXPECT_EQ(blocks.size(), max_blocks);
+  for (void* const block : blocks) {
+    pool.FreeMemory(block);
+  }
+  pool.DestoryMemoryPool(CACHE_SPACE_TYPE::WORKER);
+}
+
+}  // namespace
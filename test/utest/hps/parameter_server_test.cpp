@@ -17,12 +17,16 @@
 #include <cuda_profiler_api.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <filesystem>
 #include <fstream>
 #include <hps/embedding_cache.hpp>
 #include <hps/hier_parameter_server.hpp>
 #include <hps/inference_utils.hpp>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 using namespace HugeCTR;
@@ -124,6 +128,81 @@ void parameter_server_test(const std::string& config_file, const std::string& mo
   validate_lookup_result_per_table<long long>(config_file, infer_param, embedding_vec_size,
                                               parameter_server);
 }
+
+// Writes a sparse model, in which the embeddings of all keys are filled with `value`.
+void write_sparse_model(const std::string& path, const size_t num_keys,
+                        const size_t embedding_size, const float value) {
+  std::filesystem::create_directories(path);
+  std::vector<long long> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::ofstream(path + "/key", std::ios::binary)
+      .write(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(long long));
+  const std::vector<float> vectors(num_keys * embedding_size, value);
+  std::ofstream(path + "/emb_vector", std::ios::binary)
+      .write(reinterpret_cast<const char*>(vectors.data()), vectors.size() * sizeof(float));
+}
+
+void double_buffered_update_test(const std::string& config_file, const std::string& model,
+                                 const std::string& dense_model,
+                                 const std::vector<size_t> embedding_vec_size) {
+  const std::string model_path{"/tmp/hps_double_buffered_update"};
+  const size_t num_keys{4096};
+  std::vector<std::string> sparse_models_v1;
+  std::vector<std::string> sparse_models_v2;
+  for (size_t j = 0; j < embedding_vec_size.size(); j++) {
+    sparse_models_v1.emplace_back(model_path + "/v1/" + std::to_string(j));
+    write_sparse_model(sparse_models_v1.back(), num_keys, embedding_vec_size[j], 1);
+    sparse_models_v2.emplace_back(model_path + "/v2/" + std::to_string(j));
+    write_sparse_model(sparse_models_v2.back(), num_keys, embedding_vec_size[j], 2);
+  }
+
+  InferenceParams infer_param(model, 1, 0.5, dense_model, sparse_models_v1, 0, true, 0.8, false);
+  infer_param.volatile_db.double_buffered_update = true;
+  std::vector<InferenceParams> inference_params{infer_param};
+  std::vector<std::string> model_config_path{config_file};
+  parameter_server_config ps_config{model_config_path, inference_params};
+  std::shared_ptr<HierParameterServerBase> parameter_server =
+      HierParameterServerBase::create(ps_config);
+
+  // Looks up all keys of the last table, and returns the value of their embeddings, which must
+  // all stem from the same version.
+  const size_t table_id{embedding_vec_size.size() - 1};
+  std::vector<long long> keys(num_keys);
+  std::iota(keys.begin(), keys.end(), 0);
+  auto lookup = [&]() {
+    std::vector<float> vectors(num_keys * embedding_vec_size[table_id]);
+    parameter_server->lookup(keys.data(), keys.size(), vectors.data(), model, table_id);
+    EXPECT_TRUE(std::all_of(vectors.begin(), vectors.end(),
+                            [&](const float value) { return value == vectors.front(); }));
+    return vectors.front();
+  };
+  EXPECT_EQ(lookup(), 1);
+
+  // Lookups during the update see the previous version, until they are switched over to the new
+  // version for good.
+  std::atomic<bool> updating{true};
+  std::atomic<size_t> num_lookups{0};
+  std::thread lookup_thread([&]() {
+    float prev_value{1};
+    while (updating) {
+      const float value{lookup()};
+      EXPECT_TRUE(value == prev_value || value == 2) << "prev: " << prev_value << ", " << value;
+      prev_value = value;
+      num_lookups++;
+    }
+  });
+  while (!num_lookups) {
+    std::this_thread::yield();
+  }
+  infer_param.sparse_model_files = sparse_models_v2;
+  parameter_server->update_database_per_model(infer_param);
+  EXPECT_EQ(lookup(), 2);
+  updating = false;
+  lookup_thread.join();
+  EXPECT_EQ(lookup(), 2);
+
+  std::filesystem::remove_all(model_path);
+}
 }  // namespace
 
 std::string dense_model{"/models/wdl/1/wdl_dense_20000.model"};
@@ -140,6 +219,9 @@ TEST(parameter_server, Rocksdb_look_up) {
   parameter_server_test<long long>(network, model_name, dense_model, sparse_models,
                                    embedding_vec_size_wdl, DatabaseType_t::RocksDB);
 }
+TEST(parameter_server, double_buffered_update) {
+  double_buffered_update_test(network, model_name, dense_model, embedding_vec_size_wdl);
+}
 TEST(parameter_server, Redis_look_up) {
   parameter_server_test<long long>(network, model_name, dense_model, sparse_models,
                                    embedding_vec_size_wdl, DatabaseType_t::RedisCluster);
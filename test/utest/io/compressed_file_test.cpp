@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <io/compressed_file.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+// Rows of 16 floats, of which many repeat, like the rows of a table that were not trained.
+std::vector<float> get_weights(size_t num_rows) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> dist(-0.05f, 0.05f);
+  std::vector<float> weights(num_rows * 16);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = (i / 16) % 3 == 0 ? dist(gen) : 0.01f * (i % 16);
+  }
+  return weights;
+}
+
+void read_write_test(CompressionCodec codec) {
+  const std::string base_path = "./tmp/compressed/weight" + std::to_string(static_cast<int>(codec));
+  const std::string path = base_path + get_compressed_file_suffix(codec);
+  auto fs = FileSystemBuilder::build_unique_by_path(path);
+  fs->create_dir("./tmp/compressed");
+  const std::vector<float> weights = get_weights(10000);
+  write_compressed_file(*fs, path, weights.data(), weights.size() * sizeof(float), codec);
+  EXPECT_EQ(get_file_compression_codec(path), codec);
+  EXPECT_EQ(find_maybe_compressed_file(*fs, base_path), path);
+
+  CompressedFileReader reader(*fs, path);
+  ASSERT_EQ(reader.codec(), codec);
+  ASSERT_EQ(reader.size(), weights.size() * sizeof(float));
+  std::vector<float> read_weights(weights.size());
+  reader.read(*fs, read_weights.data(), reader.size(), 0);
+  EXPECT_EQ(read_weights, weights);
+
+  // A range across pages, which does not start or end at a page.
+  const size_t offset = 3001 * 16, num_floats = 5003 * 16;
+  std::vector<float> range(num_floats);
+  reader.read(*fs, range.data(), num_floats * sizeof(float), offset * sizeof(float));
+  EXPECT_TRUE(std::equal(range.begin(), range.end(), weights.begin() + offset));
+}
+
+// The parts of several ranks, whose last pages are shorter, in one file.
+void parts_test() {
+  const std::string path = "./tmp/compressed/emb_vector.bitcomp";
+  auto fs = FileSystemBuilder::build_unique_by_path(path);
+  fs->create_dir("./tmp/compressed");
+  const std::vector<float> weights = get_weights(10000);
+  const size_t split = 7777 * 16;
+  std::vector<CompressedPages> parts;
+  parts.push_back(
+      compress_pages(weights.data(), split * sizeof(float), CompressionCodec::Bitcomp));
+  parts.push_back(compress_pages(weights.data() + split, (weights.size() - split) * sizeof(float),
+                                 CompressionCodec::Bitcomp));
+  std::vector<char> bytes = get_compressed_file_head(parts);
+  for (const auto& part : parts) {
+    ASSERT_EQ(get_compressed_file_bytes(part), part.data.size());
+    bytes.insert(bytes.end(), part.data.begin(), part.data.end());
+  }
+  fs->write(path, bytes.data(), bytes.size(), true);
+
+  CompressedFileReader reader(*fs, path);
+  ASSERT_EQ(reader.size(), weights.size() * sizeof(float));
+  const size_t offset = split - 100, num_floats = 1000;
+  std::vector<float> range(num_floats);
+  reader.read(*fs, range.data(), num_floats * sizeof(float), offset * sizeof(float));
+  EXPECT_TRUE(std::equal(range.begin(), range.end(), weights.begin() + offset));
+  // The weights compress, and the index does not outweigh that.
+  EXPECT_LT(bytes.size(), weights.size() * sizeof(float));
+}
+
+}  // namespace
+
+TEST(compressed_file_test, lz4_test) { read_write_test(CompressionCodec::LZ4); }
+
+TEST(compressed_file_test, zstd_test) { read_write_test(CompressionCodec::Zstd); }
+
+TEST(compressed_file_test, bitcomp_test) { read_write_test(CompressionCodec::Bitcomp); }
+
+TEST(compressed_file_test, parts_test) { parts_test(); }
@@ -97,10 +97,46 @@ void append_test() {
   delete[] buffer_for_read;
 }
 
+void async_and_batch_test() {
+  auto hs = FileSystemBuilder::build_unique_by_data_source_params(
+      DataSourceParams{FileSystemType_t::Local, "", 8888});
+  const std::string writepath = "./tmp/async/data.txt";
+  const std::string buffer = "Hello, World!\nHello, LocalFS!\nHello, HugeCTR!\n";
+
+  const int size = static_cast<int>(buffer.size());
+  EXPECT_EQ(hs->write_async(writepath, buffer.data(), buffer.size(), true).get(), size);
+  std::string read_buffer(buffer.size(), '\0');
+  EXPECT_EQ(hs->read_async(writepath, read_buffer.data(), read_buffer.size(), 0).get(), size);
+  EXPECT_EQ(read_buffer, buffer);
+
+  // Appends to the same file keep the order of the requests.
+  std::vector<FileWriteRequest> writes;
+  for (size_t i = 0; i < 4; ++i) {
+    writes.push_back({"./tmp/async/part" + std::to_string(i), buffer.data(), buffer.size(), true});
+  }
+  writes.push_back({writepath, "Hello, ", 7, false});
+  writes.push_back({writepath, "batch!\n", 7, false});
+  hs->batch_write(writes);
+
+  std::vector<std::string> read_buffers(4, std::string(14, '\0'));
+  std::vector<FileReadRequest> reads;
+  for (size_t i = 0; i < 4; ++i) {
+    reads.push_back({"./tmp/async/part" + std::to_string(i), read_buffers[i].data(), 14, 14 * i});
+  }
+  reads.push_back({writepath, read_buffer.data(), 14, buffer.size()});
+  const std::vector<int> num_bytes_read = hs->batch_read(reads);
+  EXPECT_EQ(num_bytes_read[0], 14);
+  EXPECT_EQ(read_buffers[0], "Hello, World!\n");
+  EXPECT_EQ(read_buffers[1], "Hello, LocalFS");
+  EXPECT_EQ(read_buffer.substr(0, 14), "Hello, batch!\n");
+}
+
 TEST(local_fs_test, fs_builder_test) { simple_read_write_test_with_builder(); }
 
 TEST(local_fs_test, read_write_test) { simple_read_write_test(); }
 
 TEST(local_fs_test, local_append_test) { append_test(); }
 
+TEST(local_fs_test, async_and_batch_test) { async_and_batch_test(); }
+
 }  // namespace
\ No newline at end of file
@@ -17,6 +17,8 @@
 #include <gtest/gtest.h>
 
 #include <HugeCTR/include/network_buffer_channels.hpp>
+#include <algorithm>
+#include <cmath>
 #include <core23/tensor_container.hpp>
 #include <cstdlib>
 #include <loss.hpp>
@@ -202,3 +204,108 @@ void binary_cross_entropy_loss(int64_t batch_size) {
 
 TEST(loss_test, BinaryCrossEntropyLoss_2048) { binary_cross_entropy_loss(2048); }
 TEST(loss_test, BinaryCrossEntropyLoss_64) { binary_cross_entropy_loss(64); }
+
+void in_batch_softmax_loss(int64_t batch_size, int64_t dim, bool sampling_correction) {
+  core23::BufferParams blobs_buffer_params = {};
+  blobs_buffer_params.channel = GetBlobsBufferChannel();
+  const int64_t feature_dim = 2 * dim;
+  const int64_t label_dim = sampling_correction ? 2 : 1;
+
+  core23::Tensor input_tensor = core23::Tensor(core23::TensorParams()
+                                                   .data_type(core23::ToScalarType<float>::value)
+                                                   .shape({batch_size, feature_dim})
+                                                   .buffer_params(blobs_buffer_params));
+  core23::Tensor label_tensor = core23::Tensor(core23::TensorParams()
+                                                   .data_type(core23::ToScalarType<float>::value)
+                                                   .shape({batch_size, label_dim})
+                                                   .buffer_params(blobs_buffer_params));
+  core23::Tensor loss_tensor = core23::Tensor(core23::TensorParams()
+                                                  .data_type(core23::ToScalarType<float>::value)
+                                                  .shape({1, 1})
+                                                  .buffer_params(blobs_buffer_params));
+
+  std::shared_ptr<NoRegularizer<float>> no_regularizer(
+      new NoRegularizer<float>(std::nullopt, std::nullopt, batch_size, test::get_default_gpu()));
+
+  InBatchSoftmaxLoss<float> ibs(label_tensor, input_tensor, loss_tensor, no_regularizer,
+                                test::get_default_gpu(), 1);
+  ibs.set_label_weight(1.0);
+  float *d_input = input_tensor.data<float>();
+  float *d_label = label_tensor.data<float>();
+  float *d_loss = loss_tensor.data<float>();
+
+  std::vector<float> h_input(batch_size * feature_dim);
+  std::vector<float> h_label(batch_size * label_dim);
+  srand(time(NULL));
+  for (auto &x : h_input) x = (rand() % 100 - 50) * 0.01f;
+  for (int64_t i = 0; i < batch_size; ++i) {
+    // Every 8th sample is not a query
+    h_label[i * label_dim] = i % 8 == 7 ? 0.0f : 1.0f;
+    if (sampling_correction) {
+      h_label[i * label_dim + 1] = (rand() % 100 + 1) * 0.001f;
+    }
+  }
+  HCTR_LIB_THROW(cudaMemcpy(d_input, h_input.data(), sizeof(float) * h_input.size(),
+                            cudaMemcpyHostToDevice));
+  HCTR_LIB_THROW(cudaMemcpy(d_label, h_label.data(), sizeof(float) * h_label.size(),
+                            cudaMemcpyHostToDevice));
+  ibs.compute_and_init(true);
+
+  // CPU
+  int scaler = 1;
+#ifdef SCALE_128
+  scaler = 128;
+#elif SCALE_256
+  scaler = 256;
+#elif SCALE_512
+  scaler = 512;
+#elif SCALE_1024
+  scaler = 1024;
+#endif
+  std::vector<double> h_grad(h_input.size(), 0.0);
+  std::vector<double> logits(batch_size);
+  double cpu_loss = 0.0;
+  for (int64_t i = 0; i < batch_size; ++i) {
+    if (h_label[i * label_dim] < 0.5f) {
+      continue;
+    }
+    double max_logit = -INFINITY;
+    for (int64_t j = 0; j < batch_size; ++j) {
+      double logit = 0.0;
+      for (int64_t k = 0; k < dim; ++k) {
+        logit += h_input[i * feature_dim + k] * h_input[j * feature_dim + dim + k];
+      }
+      if (sampling_correction) {
+        logit -= std::log(h_label[j * label_dim + 1]);
+      }
+      logits[j] = logit;
+      max_logit = std::max(max_logit, logit);
+    }
+    double sum_exp = 0.0;
+    for (int64_t j = 0; j < batch_size; ++j) sum_exp += std::exp(logits[j] - max_logit);
+    const double lse = max_logit + std::log(sum_exp);
+    cpu_loss += lse - logits[i];
+    for (int64_t j = 0; j < batch_size; ++j) {
+      const double g = (std::exp(logits[j] - lse) - (i == j ? 1.0 : 0.0)) / batch_size * scaler;
+      for (int64_t k = 0; k < dim; ++k) {
+        h_grad[i * feature_dim + k] += g * h_input[j * feature_dim + dim + k];
+        h_grad[j * feature_dim + dim + k] += g * h_input[i * feature_dim + k];
+      }
+    }
+  }
+  cpu_loss /= batch_size;
+
+  float gpu_loss;
+  std::vector<float> gpu_grad(h_input.size());
+  HCTR_LIB_THROW(cudaMemcpy(&gpu_loss, d_loss, sizeof(float), cudaMemcpyDeviceToHost));
+  HCTR_LIB_THROW(cudaMemcpy(gpu_grad.data(), d_input, sizeof(float) * gpu_grad.size(),
+                            cudaMemcpyDeviceToHost));
+  ASSERT_NEAR(cpu_loss, gpu_loss, 1e-4 * std::abs(cpu_loss)) << " Loss calculation failed";
+  for (size_t i = 0; i < gpu_grad.size(); ++i) {
+    ASSERT_NEAR(h_grad[i], gpu_grad[i], 1e-5) << " Gradient calculation failed at " << i;
+  }
+}
+
+TEST(loss_test, InBatchSoftmaxLoss_256_16) { in_batch_softmax_loss(256, 16, false); }
+TEST(loss_test, InBatchSoftmaxLoss_1000_40) { in_batch_softmax_loss(1000, 40, false); }
+TEST(loss_test, InBatchSoftmaxLoss_333_64_logq) { in_batch_softmax_loss(333, 64, true); }
@@ -188,7 +188,8 @@ static int execution_number = 0;
 
 template <typename T, typename Generator>
 void metric_test(std::vector<int> device_list, size_t batch_size, size_t num_total_samples,
-                 Generator gen, bool auc, size_t num_evals = 1, size_t num_classes = 1) {
+                 Generator gen, bool auc, size_t num_evals = 1, size_t num_classes = 1,
+                 bool approx = false, bool fused = false) {
   int num_procs = 1, rank = 0;
 #ifdef ENABLE_MPI
   HCTR_MPI_THROW(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
@@ -249,12 +250,15 @@ void metric_test(std::vector<int> device_list, size_t batch_size, size_t num_tot
 
   // Create metric
   metrics::Metric* metric;
-  if (auc) {
+  if (auc && approx) {
+    metric = new metrics::ApproxAUC<T>(batch_size / num_classes, num_classes, resource_manager);
+  } else if (auc) {
     metric = new metrics::AUC<T>(batch_size / num_classes, num_batches, num_classes,
                                  resource_manager, false);
   } else {
     metric = new metrics::NDCG<T>(batch_size, num_batches, resource_manager, false);
   }
+  metrics::FusedLocalReduce fused_local_reduce({metric}, resource_manager);
 
   std::vector<float> h_labels(num_node_samples);
   std::vector<T> h_scores(num_node_samples);
@@ -284,7 +288,11 @@ void metric_test(std::vector<int> device_list, size_t batch_size, size_t num_tot
         HCTR_LIB_THROW(cudaMemcpyAsync(scores_tensors[i].data(), h_scores.data() + start,
                                        count * sizeof(T), cudaMemcpyHostToDevice, stream));
 
-        metric->local_reduce(i, metric_maps[i]);
+        if (fused) {
+          fused_local_reduce.local_reduce(i, metric_maps[i]);
+        } else {
+          metric->local_reduce(i, metric_maps[i]);
+        }
       }
       num_processed += batch_size_per_iter;
       metric->global_reduce(1);
@@ -296,6 +304,10 @@ void metric_test(std::vector<int> device_list, size_t batch_size, size_t num_tot
   // HCTR_LOG(INFO, WORLD, "GPU %f, ref %f \n", gpu_result, ref_result);
 
   float error_margin = auc ? eps : 10 * eps;  // Use a larger margin of error for NDCG
+  if (approx) {
+    // The ties of the predictions in the same bin
+    error_margin = 1.0e-4;
+  }
   ASSERT_NEAR(gpu_result, ref_result, error_margin);
   delete metric;
 }
@@ -376,6 +388,39 @@ TEST(auc_test, fp32_2gpu_random_multilabel) {
   metric_test<float>({3, 5}, 12, 2341, gen_random<float>, 1, 1, 3);
 }
 
+// Approximate AUC tests
+
+TEST(auc_test, approx_fp32_1gpu) {
+  metric_test<float>({0}, 10, 200, gen_random<float>, 1, 1, 1, true);
+}
+TEST(auc_test, approx_fp32_2gpu_odd) {
+  metric_test<float>({0, 1}, 10, 443, gen_random<float>, 1, 1, 1, true);
+}
+TEST(auc_test, approx_fp32_4gpu_same) {
+  metric_test<float>({0, 1, 2, 3}, 12, 154, gen_same<float>, 1, 1, 1, true);
+}
+TEST(auc_test, approx_fp32_4gpu_multi) {
+  metric_test<float>({0, 1, 2, 3}, 4143, 94622, gen_multilobe<float>, 1, 2, 1, true);
+}
+TEST(auc_test, approx_fp32_8gpu_correct) {
+  metric_test<float>({0, 1, 2, 3, 4, 5, 6, 7}, 5423, 874345, gen_correct<float>, 1, 1, 1, true);
+}
+TEST(auc_test, approx_fp16_2gpu) {
+  metric_test<__half>({0, 1}, 10, 540, gen_random<__half>, 1, 1, 1, true);
+}
+TEST(auc_test, approx_fp32_2gpu_multilabel) {
+  metric_test<float>({0, 1}, 10, 443, gen_random<float>, 1, 1, 5, true);
+}
+TEST(auc_test, approx_fused_fp32_2gpu_odd) {
+  metric_test<float>({0, 1}, 10, 443, gen_random<float>, 1, 1, 1, true, true);
+}
+TEST(auc_test, approx_fused_fp16_2gpu) {
+  metric_test<__half>({0, 1}, 10, 540, gen_random<__half>, 1, 1, 1, true, true);
+}
+TEST(auc_test, approx_fused_fp32_2gpu_multilabel) {
+  metric_test<float>({0, 1}, 10, 443, gen_random<float>, 1, 1, 5, true, true);
+}
+
 // Multi-label AUC performance tests
 const std::vector<int> one_gpu{0};
 const std::vector<int> two_gpu{0, 1};
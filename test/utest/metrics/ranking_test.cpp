@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <metrics.hpp>
+#include <random>
+#include <resource_managers/resource_manager_ext.hpp>
+#include <utest/test_utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const float eps = 1.0e-5;
+
+// Small integers keep the dot products exact, so that the GPU and the reference rank the ties
+// the same way.
+template <typename T>
+void gen_embeddings(std::vector<float>& h_labels, std::vector<T>& h_preds, int offset) {
+  std::mt19937 gen(424242 + offset);
+  std::uniform_int_distribution<int> dis_label(0, 3);
+  std::uniform_int_distribution<int> dis_value(-2, 2);
+  for (size_t i = 0; i < h_labels.size(); ++i) {
+    h_labels[i] = dis_label(gen) > 0 ? 1.0f : 0.0f;
+    h_preds[i] = (T)(float)dis_value(gen);
+  }
+}
+
+// Adds the Recall@K or NDCG@K terms of the count samples of one GPU batch to sum and num_queries.
+template <typename T>
+void ranking_reference(const float* labels, const T* preds, size_t count, int dim, int top_k,
+                       bool ndcg, double& sum, double& num_queries) {
+  auto score = [&](size_t query, size_t item) {
+    float s = 0.0f;
+    for (int k = 0; k < dim; k++) {
+      s += (float)preds[query * 2 * dim + k] * (float)preds[item * 2 * dim + dim + k];
+    }
+    return s;
+  };
+  for (size_t i = 0; i < count; i++) {
+    if (labels[i * 2 * dim] <= 0.5f) {
+      continue;
+    }
+    num_queries += 1.0;
+    const float pos_score = score(i, i);
+    int rank = 0;
+    for (size_t j = 0; j < count; j++) {
+      const float s = score(i, j);
+      if (j != i && (s > pos_score || (s == pos_score && j < i))) {
+        rank++;
+      }
+    }
+    if (rank < top_k) {
+      sum += ndcg ? 1.0 / std::log2(rank + 2.0) : 1.0;
+    }
+  }
+}
+
+template <typename T>
+void ranking_test(std::vector<int> device_list, size_t batch_size, size_t num_total_samples,
+                  int dim, int top_k, metrics::Type type, size_t num_evals = 1) {
+  int num_procs = 1, rank = 0;
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  HCTR_MPI_THROW(MPI_Comm_size(MPI_COMM_WORLD, &num_procs));
+#endif
+  std::vector<std::vector<int>> vvgpu;
+  int num_local_gpus = device_list.size();
+  int num_total_gpus = num_procs * num_local_gpus;
+  const int label_dim = 2 * dim;
+
+  size_t batch_size_per_node = batch_size * num_local_gpus;
+  size_t batch_size_per_iter = batch_size * num_total_gpus;
+  size_t num_batches = (num_total_samples + batch_size_per_iter - 1) / batch_size_per_iter;
+
+  size_t last_batch_iter = num_total_samples - (num_batches - 1) * batch_size_per_iter;
+  size_t last_batch_gpu = last_batch_iter > rank * batch_size_per_node
+                              ? last_batch_iter - rank * batch_size_per_node
+                              : 0;
+
+  size_t num_node_samples =
+      (num_batches - 1) * batch_size_per_node + std::min(last_batch_gpu, batch_size_per_node);
+
+  // if there are multi-node, we assume each node has the same gpu device_list
+  for (int i = 0; i < num_procs; i++) {
+    vvgpu.push_back(device_list);
+  }
+  const auto resource_manager = ResourceManagerExt::create(vvgpu, 424242);
+
+  core23::Shape dims = {static_cast<int64_t>(batch_size), static_cast<int64_t>(label_dim)};
+  std::vector<core23::Tensor> labels_tensors(num_local_gpus);
+  std::vector<core23::Tensor> preds_tensors(num_local_gpus);
+  std::vector<metrics::Core23RawMetricMap> metric_maps(num_local_gpus);
+
+  for (int i = 0; i < num_local_gpus; i++) {
+    int device_id = resource_manager->get_local_gpu(i)->get_device_id();
+    CudaDeviceContext context(device_id);
+    labels_tensors[i] =
+        core23::Tensor(core23::TensorParams()
+                           .data_type(core23::ToScalarType<float>::value)
+                           .device(core23::Device(core23::DeviceType::GPU, device_id))
+                           .shape(dims));
+    preds_tensors[i] =
+        core23::Tensor(core23::TensorParams()
+                           .data_type(core23::ToScalarType<T>::value)
+                           .device(core23::Device(core23::DeviceType::GPU, device_id))
+                           .shape(dims));
+    metric_maps[i] = {{metrics::RawType::Pred, preds_tensors[i]},
+                      {metrics::RawType::Label, labels_tensors[i]}};
+  }
+
+  metrics::InBatchRanking<T> metric(type, top_k, batch_size, label_dim, resource_manager);
+
+  std::vector<float> h_labels(num_node_samples * label_dim);
+  std::vector<T> h_preds(num_node_samples * label_dim);
+  gen_embeddings(h_labels, h_preds, rank);
+
+  float gpu_result;
+  double ref_sums[2];
+  for (size_t eval = 0; eval < num_evals; eval++) {
+    size_t num_processed = 0;
+    ref_sums[0] = ref_sums[1] = 0.0;
+    for (size_t batch = 0; batch < num_batches; batch++) {
+      metric.set_current_batch_size(
+          std::min(batch_size_per_iter, num_total_samples - num_processed));
+
+      for (int i = 0; i < num_local_gpus; i++) {
+        CudaDeviceContext context(resource_manager->get_local_gpu(i)->get_device_id());
+        size_t start =
+            std::min(batch * num_local_gpus * batch_size + i * batch_size, num_node_samples);
+        size_t count =
+            std::min(batch * num_local_gpus * batch_size + (i + 1) * batch_size, num_node_samples) -
+            start;
+        auto stream = resource_manager->get_local_gpu(i)->get_stream();
+
+        HCTR_LIB_THROW(cudaMemcpyAsync(labels_tensors[i].data(),
+                                       h_labels.data() + start * label_dim,
+                                       count * label_dim * sizeof(float), cudaMemcpyHostToDevice,
+                                       stream));
+        HCTR_LIB_THROW(cudaMemcpyAsync(preds_tensors[i].data(), h_preds.data() + start * label_dim,
+                                       count * label_dim * sizeof(T), cudaMemcpyHostToDevice,
+                                       stream));
+        metric.local_reduce(i, metric_maps[i]);
+
+        ranking_reference(h_labels.data() + start * label_dim, h_preds.data() + start * label_dim,
+                          count, dim, top_k, type == metrics::Type::NDCGAtK, ref_sums[0],
+                          ref_sums[1]);
+      }
+      num_processed += batch_size_per_iter;
+      metric.global_reduce(1);
+    }
+    gpu_result = metric.finalize_metric();
+  }
+#ifdef ENABLE_MPI
+  HCTR_MPI_THROW(MPI_Allreduce(MPI_IN_PLACE, ref_sums, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD));
+#endif
+  const float ref_result = ref_sums[1] > 0.0 ? ref_sums[0] / ref_sums[1] : 0.0f;
+  ASSERT_NEAR(gpu_result, ref_result, eps);
+}
+
+class MPIEnvironment : public ::testing::Environment {
+ protected:
+  virtual void SetUp() { test::mpi_init(); }
+  virtual void TearDown() { test::mpi_finalize(); }
+  virtual ~MPIEnvironment(){};
+};
+
+}  // namespace
+
+::testing::Environment* const mpi_env = ::testing::AddGlobalTestEnvironment(new MPIEnvironment);
+
+TEST(ranking_test, recall_fp32_1gpu) {
+  ranking_test<float>({0}, 64, 640, 16, 10, metrics::Type::RecallAtK);
+}
+TEST(ranking_test, recall_fp32_1gpu_odd) {
+  ranking_test<float>({0}, 77, 500, 40, 5, metrics::Type::RecallAtK, 2);
+}
+TEST(ranking_test, ndcg_fp32_1gpu) {
+  ranking_test<float>({0}, 64, 640, 16, 10, metrics::Type::NDCGAtK);
+}
+TEST(ranking_test, ndcg_fp32_2gpu_odd) {
+  ranking_test<float>({0, 1}, 100, 931, 33, 20, metrics::Type::NDCGAtK);
+}
+TEST(ranking_test, recall_fp16_2gpu) {
+  ranking_test<__half>({0, 1}, 128, 1024, 32, 10, metrics::Type::RecallAtK);
+}
+TEST(ranking_test, ndcg_fp16_4gpu_large) {
+  ranking_test<__half>({0, 1, 2, 3}, 2048, 20000, 64, 100, metrics::Type::NDCGAtK);
+}
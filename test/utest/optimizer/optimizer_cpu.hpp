@@ -16,7 +16,9 @@
 #pragma once
 
 #include <general_buffer2.hpp>
+#include <numeric>
 #include <utils.hpp>
+#include <vector>
 
 using namespace HugeCTR;
 
@@ -226,3 +228,125 @@ class SGDCPU {
   const float lr_;
   const float scaler_;
 };
+
+template <typename T>
+class LAMBCPU {
+ public:
+  LAMBCPU(const std::vector<int64_t>& layer_sizes, float* w, const T* g, float lr = 0.001,
+          float beta1 = 0.9, float beta2 = 0.999, float epsilon = 1e-6, float weight_decay = 0.01,
+          float scaler = 1.f)
+      : w_(w),
+        g_(g),
+        layer_sizes_(layer_sizes),
+        t_(0),
+        lr_(lr),
+        beta1_(beta1),
+        beta2_(beta2),
+        epsilon_(epsilon),
+        weight_decay_(weight_decay),
+        scaler_(scaler) {
+    const int64_t len = std::accumulate(layer_sizes.begin(), layer_sizes.end(), int64_t(0));
+    m_.resize(len);
+    v_.resize(len);
+  }
+
+  void update() {
+    ++t_;
+    int64_t begin = 0;
+    for (int64_t size : layer_sizes_) {
+      std::vector<float> r(size);
+      double w_square_sum = 0;
+      double r_square_sum = 0;
+      for (int64_t i = begin; i < begin + size; ++i) {
+        float gi = TypeConvert<float, T>::convert(g_[i]) / scaler_;
+        m_[i] = beta1_ * m_[i] + (1 - beta1_) * gi;
+        v_[i] = beta2_ * v_[i] + (1 - beta2_) * gi * gi;
+        float m_hat = m_[i] / (1 - pow(beta1_, t_));
+        float v_hat = v_[i] / (1 - pow(beta2_, t_));
+        float ri = m_hat / (sqrt(v_hat) + epsilon_) + weight_decay_ * w_[i];
+        r[i - begin] = ri;
+        w_square_sum += w_[i] * w_[i];
+        r_square_sum += ri * ri;
+      }
+      float trust_ratio = w_square_sum > 0 && r_square_sum > 0
+                              ? static_cast<float>(sqrt(w_square_sum) / sqrt(r_square_sum))
+                              : 1.f;
+      for (int64_t i = begin; i < begin + size; ++i) {
+        w_[i] -= lr_ * trust_ratio * r[i - begin];
+      }
+      begin += size;
+    }
+  }
+
+ private:
+  // named as in Algorithm 2 from LAMB paper (arXiv:1904.00962)
+  float* w_;
+  const T* g_;
+  std::vector<float> m_;
+  std::vector<float> v_;
+  const std::vector<int64_t> layer_sizes_;
+  uint64_t t_;
+  const float lr_;
+  const float beta1_;
+  const float beta2_;
+  const float epsilon_;
+  const float weight_decay_;
+  const float scaler_;
+};
+
+template <typename T>
+class LARSCPU {
+ public:
+  LARSCPU(const std::vector<int64_t>& layer_sizes, float* w, const T* g, float lr,
+          float momentum = 0.9, float trust_coefficient = 0.001, float epsilon = 1e-7,
+          float weight_decay = 0.f, float scaler = 1.f)
+      : w_(w),
+        g_(g),
+        layer_sizes_(layer_sizes),
+        lr_(lr),
+        momentum_(momentum),
+        trust_coefficient_(trust_coefficient),
+        epsilon_(epsilon),
+        weight_decay_(weight_decay),
+        scaler_(scaler) {
+    v_.resize(std::accumulate(layer_sizes.begin(), layer_sizes.end(), int64_t(0)));
+  }
+
+  void update() {
+    int64_t begin = 0;
+    for (int64_t size : layer_sizes_) {
+      double w_square_sum = 0;
+      double g_square_sum = 0;
+      for (int64_t i = begin; i < begin + size; ++i) {
+        float gi = TypeConvert<float, T>::convert(g_[i]) / scaler_;
+        w_square_sum += w_[i] * w_[i];
+        g_square_sum += gi * gi;
+      }
+      float w_norm = sqrt(w_square_sum);
+      float g_norm = sqrt(g_square_sum);
+      float local_lr = w_norm > 0 && g_norm > 0
+                           ? trust_coefficient_ * w_norm /
+                                 (g_norm + weight_decay_ * w_norm + epsilon_)
+                           : 1.f;
+      for (int64_t i = begin; i < begin + size; ++i) {
+        float gi = TypeConvert<float, T>::convert(g_[i]) / scaler_;
+        v_[i] = momentum_ * v_[i] + lr_ * local_lr * (gi + weight_decay_ * w_[i]);
+        w_[i] -= v_[i];
+      }
+      begin += size;
+    }
+  }
+
+ private:
+  // named as in Algorithm 1 from LARS paper (arXiv:1708.03888)
+  float* w_;
+  const T* g_;
+  std::vector<float> v_;
+  const std::vector<int64_t> layer_sizes_;
+  const float lr_;
+  const float momentum_;
+  const float trust_coefficient_;
+  const float epsilon_;
+  const float weight_decay_;
+  const float scaler_;
+};
@@ -27,6 +27,8 @@
 #include <optimizers/adagrad_optimizer.hpp>
 #include <optimizers/adam_optimizer.hpp>
 #include <optimizers/ftrl_optimizer.hpp>
+#include <optimizers/lamb_optimizer.hpp>
+#include <optimizers/lars_optimizer.hpp>
 #include <optimizers/momentum_sgd_optimizer.hpp>
 #include <optimizers/nesterov_optimizer.hpp>
 #include <optimizers/sgd_optimizer.hpp>
@@ -69,6 +71,35 @@ struct OptimizerGPUFactory<T, SGDOptimizer, ARGS...> {
   }
 };
 
+template <typename T, template <typename> typename OptimizerCPU, typename... ARGS>
+struct OptimizerCPUFactory {
+  std::unique_ptr<OptimizerCPU<T>> operator()(const std::vector<core23::Shape>& shapes, int len,
+                                              float* w, T* g, ARGS... args) {
+    return std::make_unique<OptimizerCPU<T>>(len, w, g, args...);
+  }
+};
+
+// The layer-wise optimizers need the sizes of the weight tensors.
+template <typename T, template <typename> typename OptimizerCPU, typename... ARGS>
+struct LayerWiseOptimizerCPUFactory {
+  std::unique_ptr<OptimizerCPU<T>> operator()(const std::vector<core23::Shape>& shapes, int len,
+                                              float* w, T* g, ARGS... args) {
+    std::vector<int64_t> layer_sizes;
+    for (const auto& shape : shapes) {
+      layer_sizes.push_back(shape.size());
+    }
+    return std::make_unique<OptimizerCPU<T>>(layer_sizes, w, g, args...);
+  }
+};
+
+template <typename T, typename... ARGS>
+struct OptimizerCPUFactory<T, LAMBCPU, ARGS...>
+    : LayerWiseOptimizerCPUFactory<T, LAMBCPU, ARGS...> {};
+
+template <typename T, typename... ARGS>
+struct OptimizerCPUFactory<T, LARSCPU, ARGS...>
+    : LayerWiseOptimizerCPUFactory<T, LARSCPU, ARGS...> {};
+
 template <typename T, template <typename> typename OptimizerGPU,
           template <typename> typename OptimizerCPU, typename... ARGS>
 void optimizer_test_with_new_tensor(std::vector<core23::Shape> shapes, int num_update,
@@ -123,7 +154,8 @@ void optimizer_test_with_new_tensor(std::vector<core23::Shape> shapes, int num_u
   core23::copy_sync(h_weight_expected.get(), flat_weight_tensor.data(),
                     flat_weight_tensor.size(0) * sizeof(float), core23::DeviceType::CPU, device);
 
-  OptimizerCPU<T> optimizerCPU(num_elements, h_weight_expected.get(), h_wgrad.get(), args...);
+  auto optimizerCPU = OptimizerCPUFactory<T, OptimizerCPU, ARGS...>()(
+      shapes, num_elements, h_weight_expected.get(), h_wgrad.get(), args...);
   for (int i = 0; i < num_update; ++i) {
     core23::normal_async<float>(h_float_wgrad.get(), num_elements, 0.f, 1.f,
                                 core23::DeviceType::CPU, generator_cpu, stream);
@@ -136,7 +168,7 @@ void optimizer_test_with_new_tensor(std::vector<core23::Shape> shapes, int num_u
 
     HCTR_LIB_THROW(cudaDeviceSynchronize());
     optimizerGPU->update();
-    optimizerCPU.update();
+    optimizerCPU->update();
     HCTR_LIB_THROW(cudaDeviceSynchronize());
   }
 
@@ -200,3 +232,21 @@ TEST(sgd, fp32_sgd) {
 TEST(sgd, fp16_sgd) {
   optimizer_test_with_new_tensor<__half, SGDOptimizer, SGDCPU>({{64, 256}, {256, 1}}, 5, 1e-3);
 }
+
+TEST(lamb_test, fp32_lamb) {
+  optimizer_test_with_new_tensor<float, LAMBOptimizer, LAMBCPU>({{64, 256}, {256, 1}}, 5, 1e-5);
+}
+
+TEST(lamb_test, fp16_lamb) {
+  optimizer_test_with_new_tensor<__half, LAMBOptimizer, LAMBCPU>({{64, 256}, {256, 1}}, 5, 1e-3);
+}
+
+TEST(lars_test, fp32_lars) {
+  optimizer_test_with_new_tensor<float, LARSOptimizer, LARSCPU, float, float, float, float, float>(
+      {{64, 256}, {256, 1}}, 5, 1e-5, 0.1, 0.9, 0.001, 1e-7, 0.0005);
+}
+
+TEST(lars_test, fp16_lars) {
+  optimizer_test_with_new_tensor<__half, LARSOptimizer, LARSCPU, float, float, float, float, float>(
+      {{64, 256}, {256, 1}}, 5, 1e-3, 0.1, 0.9, 0.001, 1e-7, 0.0005);
+}
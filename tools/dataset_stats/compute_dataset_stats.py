@@ -0,0 +1,251 @@
+"""
+ Copyright (c) 2023, NVIDIA CORPORATION.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+"""
+
+import argparse
+import concurrent.futures
+import glob
+import json
+import logging
+import os
+import sys
+
+import cudf
+import cupy as cp
+import cupyx
+import numpy as np
+
+logging.basicConfig(format="%(asctime)s %(message)s")
+logging.root.setLevel(logging.NOTSET)
+
+STATS_VERSION = 1
+CRITEO_CAT_POS = [c for c in range(14, 40)]
+
+
+def bit_length(x):
+    n = cp.zeros(x.shape, dtype=cp.int32)
+    for s in (32, 16, 8, 4, 2, 1):
+        big = x >= (cp.uint64(1) << cp.uint64(s))
+        x = cp.where(big, x >> cp.uint64(s), x)
+        n += big.astype(cp.int32) * s
+    return n + (x > 0).astype(cp.int32)
+
+
+def splitmix64(keys):
+    x = keys.astype(cp.uint64) + cp.uint64(0x9E3779B97F4A7C15)
+    x = (x ^ (x >> cp.uint64(30))) * cp.uint64(0xBF58476D1CE4E5B9)
+    x = (x ^ (x >> cp.uint64(27))) * cp.uint64(0x94D049BB133111EB)
+    return x ^ (x >> cp.uint64(31))
+
+
+class TableSketch:
+    """Streaming statistics of the keys of one table.
+
+    The most frequent keys are tracked among a bounded set of candidates, so their counts are
+    approximate once there are more distinct keys than candidates. The distinct keys are estimated
+    with a HyperLogLog sketch of 2^precision registers.
+    """
+
+    def __init__(self, name, top_k, precision):
+        self.name = name
+        self.top_k = top_k
+        self.capacity = max(10 * top_k, 100000)
+        self.precision = precision
+        self.registers = cp.zeros(1 << precision, dtype=cp.int32)
+        self.candidates = cudf.DataFrame(
+            {"key": cudf.Series([], dtype="int64"), "count": cudf.Series([], dtype="int64")}
+        )
+        self.num_keys = 0
+        self.pooling_factors = {}
+
+    def add(self, keys, pooling_factors):
+        keys = cp.asarray(keys, dtype=cp.int64)
+        self.num_keys += int(keys.size)
+        if keys.size == 0:
+            return
+        for value, count in cudf.Series(pooling_factors).value_counts().to_pandas().items():
+            self.pooling_factors[int(value)] = self.pooling_factors.get(int(value), 0) + int(count)
+
+        hashes = splitmix64(keys)
+        p = cp.uint64(self.precision)
+        index = (hashes >> (cp.uint64(64) - p)).astype(cp.int32)
+        rest = hashes & ((cp.uint64(1) << (cp.uint64(64) - p)) - cp.uint64(1))
+        rank = (64 - self.precision) - bit_length(rest) + 1
+        cupyx.scatter_max(self.registers, index, rank)
+
+        counts = cudf.Series(keys).value_counts().reset_index()
+        counts.columns = ["key", "count"]
+        merged = cudf.concat([self.candidates, counts]).groupby("key", as_index=False).sum()
+        self.candidates = merged.nlargest(self.capacity, "count")
+
+    def num_unique_keys(self):
+        m = float(1 << self.precision)
+        alpha = 0.7213 / (1 + 1.079 / m)
+        registers = self.registers.astype(cp.float64)
+        estimate = alpha * m * m / float(cp.sum(cp.exp2(-registers)))
+        zeros = int(cp.count_nonzero(self.registers == 0))
+        if estimate <= 2.5 * m and zeros > 0:
+            estimate = m * np.log(m / zeros)
+        return estimate
+
+    def to_json(self):
+        top = self.candidates.nlargest(self.top_k, "count").to_pandas()
+        return {
+            "name": self.name,
+            "num_keys": self.num_keys,
+            "num_unique_keys": self.num_unique_keys(),
+            "hll_precision": self.precision,
+            "pooling_factor_histogram": {
+                str(k): v for k, v in sorted(self.pooling_factors.items())
+            },
+            "top_keys": [[int(k), int(c)] for k, c in zip(top["key"], top["count"])],
+        }
+
+
+def raw_chunks(files, sample_bytes, chunk_samples):
+    chunks = []
+    for file in files:
+        num_samples = os.path.getsize(file) // sample_bytes
+        for begin in range(0, num_samples, chunk_samples):
+            chunks.append((file, begin, min(chunk_samples, num_samples - begin)))
+    return chunks
+
+
+def read_raw_chunk(chunk, sample_bytes):
+    file, begin, count = chunk
+    samples = np.fromfile(
+        file, dtype=np.uint8, count=count * sample_bytes, offset=begin * sample_bytes
+    )
+    return samples.reshape(count, sample_bytes)
+
+
+def raw_features(chunk, args):
+    """Returns the keys and pooling factors of each feature of a chunk of raw samples."""
+    key_type = np.int32 if args.key_bytes == 4 else np.int64
+    keys = np.ascontiguousarray(chunk[:, (args.label_dim + args.dense_dim) * 4 :]).view(key_type)
+    keys = cp.asarray(keys)
+    features = []
+    offset = 0
+    for hotness in args.hotness:
+        features.append(
+            (keys[:, offset : offset + hotness].ravel(), cp.full(len(chunk), hotness, cp.int32))
+        )
+        offset += hotness
+    return features
+
+
+def parquet_features(df, columns):
+    features = []
+    for column in columns:
+        series = df[column]
+        if isinstance(series.dtype, cudf.ListDtype):
+            pooling_factors = series.list.len().values
+            series = series.list.leaves
+        else:
+            pooling_factors = cp.ones(len(series), cp.int32)
+        features.append((series.dropna().values, pooling_factors))
+    return features, len(df)
+
+
+def compute_stats(args):
+    files = sorted(glob.glob(args.src))
+    if not files:
+        sys.exit("ERROR: no file matches '{}'".format(args.src))
+    num_features = len(args.hotness) if args.data_type == "raw" else len(args.cat_features_pos)
+    table_names = args.table_names or ["table_{}".format(i) for i in range(num_features)]
+    if len(table_names) != num_features:
+        sys.exit("ERROR: table_names must have one name per categorical feature")
+
+    # Features of the same table are merged, so that their pooling factors add up per sample.
+    sketches = {}
+    for name in table_names:
+        sketches.setdefault(name, TableSketch(name, args.top_k, args.hll_precision))
+
+    if args.data_type == "raw":
+        sample_bytes = (args.label_dim + args.dense_dim) * 4 + sum(args.hotness) * args.key_bytes
+        tasks = raw_chunks(files, sample_bytes, args.chunk_samples)
+
+        def read(task):
+            return read_raw_chunk(task, sample_bytes)
+
+    else:
+        tasks = files
+
+        def read(task):
+            df = cudf.read_parquet(task)
+            return df[[df.columns[i] for i in args.cat_features_pos]]
+
+    # Up to num_threads chunks are read ahead, while the current one is hashed.
+    num_samples = 0
+    with concurrent.futures.ThreadPoolExecutor(args.num_threads) as pool:
+        pending = [pool.submit(read, task) for task in tasks[: args.num_threads]]
+        for i in range(len(tasks)):
+            chunk = pending.pop(0).result()
+            if i + args.num_threads < len(tasks):
+                pending.append(pool.submit(read, tasks[i + args.num_threads]))
+            if args.data_type == "raw":
+                features, n = raw_features(chunk, args), len(chunk)
+            else:
+                features, n = parquet_features(chunk, chunk.columns)
+            num_samples += n
+            by_table = {}
+            for name, (keys, pooling_factors) in zip(table_names, features):
+                entry = by_table.setdefault(name, [[], 0])
+                entry[0].append(keys)
+                entry[1] = entry[1] + pooling_factors
+            for name, (keys, pooling_factors) in by_table.items():
+                sketches[name].add(cp.concatenate(keys), pooling_factors)
+            logging.info("Processed {} samples".format(num_samples))
+
+    return {
+        "version": STATS_VERSION,
+        "num_samples": num_samples,
+        "tables": [sketch.to_json() for sketch in sketches.values()],
+    }
+
+
+if __name__ == "__main__":
+    arg_parser = argparse.ArgumentParser(description="Computing key statistics of a dataset")
+
+    arg_parser.add_argument("--src", type=str, required=True, help="file or glob pattern")
+    arg_parser.add_argument("--stats_path", type=str, required=True)
+    arg_parser.add_argument("--data_type", type=str, choices=["raw", "parquet"], required=True)
+    arg_parser.add_argument("--table_names", nargs="*", type=str, required=False)
+    arg_parser.add_argument("--top_k", type=int, required=False, default=1000)
+    arg_parser.add_argument("--hll_precision", type=int, required=False, default=14)
+    arg_parser.add_argument("--num_threads", type=int, required=False, default=4)
+    # Raw and multi-hot raw files
+    arg_parser.add_argument("--label_dim", type=int, required=False, default=1)
+    arg_parser.add_argument("--dense_dim", type=int, required=False, default=13)
+    arg_parser.add_argument("--hotness", nargs="*", type=int, required=False)
+    arg_parser.add_argument("--key_bytes", type=int, choices=[4, 8], required=False, default=4)
+    arg_parser.add_argument("--chunk_samples", type=int, required=False, default=1 << 20)
+    # Parquet files
+    arg_parser.add_argument("--cat_features_pos", nargs="*", type=int, required=False)
+
+    args = arg_parser.parse_args()
+    if args.data_type == "raw" and not args.hotness:
+        args.hotness = [1] * len(CRITEO_CAT_POS)
+    if args.data_type == "parquet" and not args.cat_features_pos:
+        args.cat_features_pos = CRITEO_CAT_POS
+    if not 4 <= args.hll_precision <= 18:
+        sys.exit("ERROR: hll_precision must be between 4 and 18")
+
+    stats = compute_stats(args)
+    with open(args.stats_path, "w") as f:
+        json.dump(stats, f, indent=2)
+    logging.info(
+        "Wrote the stats of {} samples to {}".format(stats["num_samples"], args.stats_path)
+    )
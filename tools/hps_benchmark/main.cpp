@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <cmath>
+#include <core23/logger.hpp>
+#include <filesystem>
+#include <fstream>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/inference_utils.hpp>
+#include <hps/lookup_metrics.hpp>
+#include <hps/lookup_session_base.hpp>
+#include <iomanip>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+typedef long long Key;
+
+namespace {
+
+/**
+ * Draws ranks from a Zipf distribution over [0, n), where rank 0 is the most frequent one. An
+ * alpha of 0 is the uniform distribution.
+ */
+class ZipfSampler {
+ public:
+  ZipfSampler(const size_t n, const double alpha) : cdf_(n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+      sum += std::pow(static_cast<double>(i + 1), -alpha);
+      cdf_[i] = sum;
+    }
+    for (double& c : cdf_) {
+      c /= sum;
+    }
+  }
+
+  size_t operator()(std::mt19937_64& gen) const {
+    const double u = std::uniform_real_distribution<double>(0, 1)(gen);
+    const auto it = std::lower_bound(cdf_.begin(), cdf_.end(), u);
+    return std::min<size_t>(it - cdf_.begin(), cdf_.size() - 1);
+  }
+
+ private:
+  std::vector<double> cdf_;
+};
+
+// Writes a sparse model with the keys [0, num_keys) and random embedding vectors.
+void write_sparse_model(const std::string& path, const size_t num_keys, const size_t emb_size,
+                        const uint64_t seed) {
+  std::filesystem::create_directories(path);
+  std::ofstream key_stream(path + "/key", std::ofstream::binary | std::ofstream::trunc);
+  std::ofstream vec_stream(path + "/emb_vector", std::ofstream::binary | std::ofstream::trunc);
+  HCTR_CHECK_HINT(key_stream.is_open() && vec_stream.is_open(), "Cannot write to ", path);
+
+  std::mt19937_64 gen(seed);
+  std::uniform_real_distribution<float> val_dist(-1.0f, 1.0f);
+  constexpr size_t chunk_size = 64 * 1024;
+  std::vector<Key> keys(chunk_size);
+  std::vector<float> vectors(chunk_size * emb_size);
+  for (size_t i = 0; i < num_keys; i += chunk_size) {
+    const size_t n = std::min(chunk_size, num_keys - i);
+    std::iota(keys.begin(), keys.begin() + n, static_cast<Key>(i));
+    std::generate(vectors.begin(), vectors.begin() + n * emb_size, [&]() { return val_dist(gen); });
+    key_stream.write(reinterpret_cast<const char*>(keys.data()), n * sizeof(Key));
+    vec_stream.write(reinterpret_cast<const char*>(vectors.data()), n * emb_size * sizeof(float));
+  }
+}
+
+// Value of the quantile q of sorted latencies.
+double quantile(const std::vector<double>& sorted_latencies, const double q) {
+  if (sorted_latencies.empty()) {
+    return 0;
+  }
+  const size_t i = static_cast<size_t>(q * static_cast<double>(sorted_latencies.size() - 1));
+  return sorted_latencies[i];
+}
+
+// Upper bound of the bucket of a histogram that holds the quantile q, or -1 for the last bucket.
+double quantile(const LatencyHistogram::Snapshot& snapshot, const double q) {
+  const double rank = q * static_cast<double>(snapshot.count);
+  uint64_t count = 0;
+  for (size_t i = 0; i + 1 < LatencyHistogram::num_buckets; ++i) {
+    count += snapshot.counts[i];
+    if (count > 0 && static_cast<double>(count) >= rank) {
+      return static_cast<double>(LatencyHistogram::bucket_bound_us(i));
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--work_dir")
+      .help("Directory of the sparse model and of the persistent database.")
+      .default_value<std::string>("/tmp/hps_bench");
+
+  args.add_argument("--seed")
+      .help("Seed for the random number generator.")
+      .default_value<uint64_t>(4711)
+      .scan<'u', uint64_t>();
+
+  args.add_argument("--device").help("GPU to look up on.").default_value<int>(0).scan<'i', int>();
+
+  // Model parameters.
+  args.add_argument("--num_keys")
+      .help("Number of keys of the embedding table.")
+      .default_value<size_t>(10L * 1000 * 1000)
+      .scan<'u', size_t>();
+
+  args.add_argument("--emb_size")
+      .help("Size of one embedding.")
+      .default_value<size_t>(64)
+      .scan<'u', size_t>();
+
+  // Hierarchy parameters.
+  args.add_argument("--gpu_cache_ratio")
+      .help("Share of the keys which fit into the GPU embedding cache.")
+      .default_value<float>(0.1f)
+      .scan<'g', float>();
+
+  args.add_argument("--hit_rate_threshold")
+      .help("Hit rate below which missing keys are inserted into the GPU embedding cache.")
+      .default_value<float>(0.9f)
+      .scan<'g', float>();
+
+  args.add_argument("--vdb_type").help("Volatile database type.").default_value<std::string>(
+      "hash_map");
+
+  args.add_argument("--vdb_cache_ratio")
+      .help("Share of the keys which are initially loaded into the volatile database.")
+      .default_value<double>(0.5)
+      .scan<'g', double>();
+
+  args.add_argument("--pdb_type")
+      .help("Persistent database type.")
+      .default_value<std::string>("rocks_db");
+
+  // Load parameters.
+  args.add_argument("--zipf_alpha")
+      .help("Skew of the Zipf distribution of the keys. 0 is uniform.")
+      .default_value<double>(1.05)
+      .scan<'g', double>();
+
+  args.add_argument("--num_threads")
+      .help("Number of threads which look up concurrently, each with its own session.")
+      .default_value<size_t>(4)
+      .scan<'u', size_t>();
+
+  args.add_argument("--batch_size")
+      .help("Number of keys of one lookup.")
+      .default_value<size_t>(16 * 1024)
+      .scan<'u', size_t>();
+
+  args.add_argument("--warmup_batches")
+      .help("Number of lookups per thread before the measurement.")
+      .default_value<size_t>(100)
+      .scan<'u', size_t>();
+
+  args.add_argument("--num_batches")
+      .help("Number of measured lookups per thread.")
+      .default_value<size_t>(1000)
+      .scan<'u', size_t>();
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  const auto work_dir = args.get<std::string>("--work_dir");
+  const auto seed = args.get<uint64_t>("--seed");
+  const auto device = args.get<int>("--device");
+  // Model parameters.
+  const auto num_keys = args.get<size_t>("--num_keys");
+  const auto emb_size = args.get<size_t>("--emb_size");
+  // Hierarchy parameters.
+  const auto gpu_cache_ratio = args.get<float>("--gpu_cache_ratio");
+  const auto hit_rate_threshold = args.get<float>("--hit_rate_threshold");
+  const auto vdb_type = args.get<std::string>("--vdb_type");
+  const auto vdb_cache_ratio = args.get<double>("--vdb_cache_ratio");
+  const auto pdb_type = args.get<std::string>("--pdb_type");
+  // Load parameters.
+  const auto zipf_alpha = args.get<double>("--zipf_alpha");
+  const auto num_threads = args.get<size_t>("--num_threads");
+  const auto batch_size = args.get<size_t>("--batch_size");
+  const auto warmup_batches = args.get<size_t>("--warmup_batches");
+  const auto num_batches = args.get<size_t>("--num_batches");
+
+  std::cout << "Options: " << std::endl
+            << "  -----------------------------" << std::endl
+            << "  work_dir = " << work_dir << std::endl
+            << "  seed     = " << seed << std::endl
+            << "  device   = " << device << std::endl
+            << "  -----------------------------" << std::endl
+            << "  num_keys = " << num_keys << std::endl
+            << "  emb_size = " << emb_size << " x " << sizeof(float) << std::endl
+            << "  -----------------------------" << std::endl
+            << "  gpu_cache_ratio    = " << gpu_cache_ratio << std::endl
+            << "  hit_rate_threshold = " << hit_rate_threshold << std::endl
+            << "  vdb_type           = " << vdb_type << std::endl
+            << "  vdb_cache_ratio    = " << vdb_cache_ratio << std::endl
+            << "  pdb_type           = " << pdb_type << std::endl
+            << "  -----------------------------" << std::endl
+            << "  zipf_alpha     = " << zipf_alpha << std::endl
+            << "  num_threads    = " << num_threads << std::endl
+            << "  batch_size     = " << batch_size << std::endl
+            << "  warmup_batches = " << warmup_batches << std::endl
+            << "  num_batches    = " << num_batches << std::endl
+            << "  -----------------------------" << std::endl;
+
+  const std::string model_name = "hps_bench";
+  const std::string sparse_model = work_dir + "/sparse_model";
+  HCTR_LOG_S(INFO, WORLD) << "Writing the sparse model..." << std::endl;
+  write_sparse_model(sparse_model, num_keys, emb_size, seed);
+
+  nlohmann::json ps_config;
+  ps_config["supportlonglong"] = true;
+  ps_config["volatile_db"] = {{"type", vdb_type}, {"initial_cache_rate", vdb_cache_ratio}};
+  ps_config["persistent_db"] = {{"type", pdb_type}, {"path", work_dir + "/pdb"}};
+  nlohmann::json model_config;
+  model_config["model"] = model_name;
+  model_config["sparse_files"] = std::vector<std::string>{sparse_model};
+  model_config["embedding_table_names"] = std::vector<std::string>{"table0"};
+  model_config["embedding_vecsize_per_table"] = std::vector<size_t>{emb_size};
+  model_config["maxnum_catfeature_query_per_table_per_sample"] = std::vector<size_t>{1};
+  model_config["default_value_for_each_table"] = std::vector<float>{0.f};
+  model_config["deployed_device_list"] = std::vector<int>{device};
+  model_config["max_batch_size"] = batch_size;
+  model_config["num_of_worker_buffer_in_pool"] = num_threads;
+  model_config["hit_rate_threshold"] = hit_rate_threshold;
+  model_config["gpucacheper"] = gpu_cache_ratio;
+  model_config["gpucache"] = gpu_cache_ratio > 0;
+  ps_config["models"] = std::vector<nlohmann::json>{model_config};
+  const std::string ps_config_file = work_dir + "/hps_bench.json";
+  {
+    std::ofstream file_stream(ps_config_file);
+    file_stream << std::setw(2) << ps_config;
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << "Creating the parameter server..." << std::endl;
+  parameter_server_config config{ps_config_file};
+  const InferenceParams& inference_params = config.inference_params_array[0];
+  const auto parameter_server = HierParameterServerBase::create(config);
+  const auto embedding_cache = parameter_server->get_embedding_cache(model_name, device);
+
+  // Hot keys are spread over the key space, rather than being the smallest keys.
+  const ZipfSampler sampler(num_keys, zipf_alpha);
+  std::vector<Key> rank_to_key(num_keys);
+  std::iota(rank_to_key.begin(), rank_to_key.end(), 0);
+  std::shuffle(rank_to_key.begin(), rank_to_key.end(), std::mt19937_64(seed));
+
+  struct Worker {
+    std::shared_ptr<LookupSessionBase> session;
+    cudaStream_t stream;
+    Key* h_keys;
+    float* d_vectors;
+    std::mt19937_64 gen;
+    std::vector<double> latencies_us;
+  };
+  std::vector<Worker> workers(num_threads);
+  HCTR_LIB_THROW(cudaSetDevice(device));
+  for (size_t i = 0; i < num_threads; ++i) {
+    Worker& w = workers[i];
+    w.session = LookupSessionBase::create(inference_params, embedding_cache);
+    HCTR_LIB_THROW(cudaStreamCreateWithFlags(&w.stream, cudaStreamNonBlocking));
+    HCTR_LIB_THROW(cudaMallocHost(&w.h_keys, batch_size * sizeof(Key)));
+    HCTR_LIB_THROW(cudaMalloc(&w.d_vectors, batch_size * emb_size * sizeof(float)));
+    w.gen.seed(seed + i + 1);
+    w.latencies_us.reserve(num_batches);
+  }
+
+  // Runs a number of lookups on each thread, and records their latencies if measure is set.
+  const auto run = [&](const size_t num_lookups, const bool measure) {
+    std::vector<std::thread> threads;
+    for (Worker& w : workers) {
+      threads.emplace_back([&, num_lookups, measure]() {
+        HCTR_LIB_THROW(cudaSetDevice(device));
+        for (size_t b = 0; b < num_lookups; ++b) {
+          for (size_t j = 0; j < batch_size; ++j) {
+            w.h_keys[j] = rank_to_key[sampler(w.gen)];
+          }
+          const auto t0 = std::chrono::steady_clock::now();
+          w.session->lookup(w.h_keys, w.d_vectors, batch_size, 0, w.stream);
+          HCTR_LIB_THROW(cudaStreamSynchronize(w.stream));
+          const auto t1 = std::chrono::steady_clock::now();
+          if (measure) {
+            w.latencies_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+          }
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  };
+
+  // The stage latencies are recorded by the LookupMetrics of the process.
+  const auto stage_snapshots = [&model_name]() {
+    std::vector<std::pair<LookupStage_t, LatencyHistogram::Snapshot>> snapshots;
+    LookupMetrics::instance().visit([&](const std::string& name, const size_t table_id,
+                                        const LookupStage_t stage,
+                                        const LatencyHistogram::Snapshot& snapshot) {
+      if (name == model_name && table_id == 0) {
+        snapshots.emplace_back(stage, snapshot);
+      }
+    });
+    return snapshots;
+  };
+
+  HCTR_LOG_S(INFO, WORLD) << "Warming up..." << std::endl;
+  run(warmup_batches, false);
+  const auto warm_snapshots = stage_snapshots();
+
+  HCTR_LOG_S(INFO, WORLD) << "Measuring..." << std::endl;
+  const auto t0 = std::chrono::steady_clock::now();
+  run(num_batches, true);
+  const double duration_s =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  std::vector<double> latencies_us;
+  for (const Worker& w : workers) {
+    latencies_us.insert(latencies_us.end(), w.latencies_us.begin(), w.latencies_us.end());
+  }
+  std::sort(latencies_us.begin(), latencies_us.end());
+  const double num_lookups = static_cast<double>(num_threads * num_batches);
+
+  std::cout << std::fixed << std::setprecision(1) << "Results: " << std::endl
+            << "  -----------------------------" << std::endl
+            << "  lookups / s = " << num_lookups / duration_s << std::endl
+            << "  keys / s    = " << num_lookups * batch_size / duration_s << std::endl
+            << "  -----------------------------" << std::endl
+            << "  " << std::left << std::setw(16) << "stage" << std::right << std::setw(12)
+            << "count" << std::setw(12) << "mean us" << std::setw(12) << "p50 us" << std::setw(12)
+            << "p99 us" << std::setw(12) << "p999 us" << std::endl
+            << "  " << std::left << std::setw(16) << "lookup" << std::right << std::setw(12)
+            << latencies_us.size() << std::setw(12)
+            << std::accumulate(latencies_us.begin(), latencies_us.end(), 0.0) /
+                   std::max<size_t>(latencies_us.size(), 1)
+            << std::setw(12) << quantile(latencies_us, 0.5) << std::setw(12)
+            << quantile(latencies_us, 0.99) << std::setw(12) << quantile(latencies_us, 0.999)
+            << std::endl;
+
+  // Stage percentiles are the upper bounds of the histogram buckets which hold them, and -1 if they
+  // are beyond the last bound.
+  for (const auto& [stage, snapshot] : stage_snapshots()) {
+    LatencyHistogram::Snapshot s = snapshot;
+    for (const auto& [warm_stage, warm] : warm_snapshots) {
+      if (warm_stage == stage) {
+        for (size_t i = 0; i < LatencyHistogram::num_buckets; ++i) {
+          s.counts[i] -= warm.counts[i];
+        }
+        s.count -= warm.count;
+        s.sum_us -= warm.sum_us;
+      }
+    }
+    if (s.count == 0) {
+      continue;
+    }
+    std::cout << "  " << std::left << std::setw(16) << lookup_stage_name(stage) << std::right
+              << std::setw(12) << s.count << std::setw(12)
+              << static_cast<double>(s.sum_us) / s.count << std::setw(12) << quantile(s, 0.5)
+              << std::setw(12) << quantile(s, 0.99) << std::setw(12) << quantile(s, 0.999)
+              << std::endl;
+  }
+  std::cout << "  -----------------------------" << std::endl;
+
+  for (Worker& w : workers) {
+    w.session.reset();
+    HCTR_LIB_THROW(cudaStreamDestroy(w.stream));
+    HCTR_LIB_THROW(cudaFreeHost(w.h_keys));
+    HCTR_LIB_THROW(cudaFree(w.d_vectors));
+  }
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <data_readers/multi_hot/packed_format.hpp>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+using namespace HugeCTR::MultiHot;
+
+static std::string usage_str =
+    "usage: ./raw2packed in.bin out.bin label_dim dense_dim is_dense_float key_bytes hotness...\n"
+    "Converts a multi-hot raw file into the packed format. Keys are stored with the bits of the\n"
+    "largest key of their feature, dense features as FP16, after the log transform if they are\n"
+    "unsigned int. key_bytes is 4 for int32 and 8 for int64 keys.";
+
+// Writes value with the given number of bits at bit_offset, into zeroed words.
+static void pack_bits(std::vector<uint32_t> &words, uint32_t bit_offset, uint64_t value, int bits) {
+  for (int written = 0; written < bits;) {
+    const uint32_t word = (bit_offset + written) / 32;
+    const int shift = (bit_offset + written) % 32;
+    const int n = std::min(bits - written, 32 - shift);
+    const uint64_t mask = n == 32 ? 0xffffffffull : (uint64_t{1} << n) - 1;
+    words[word] |= static_cast<uint32_t>(((value >> written) & mask) << shift);
+    written += n;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 8) {
+    HCTR_LOG_S(INFO, WORLD) << usage_str << std::endl;
+    exit(-1);
+  }
+  const size_t label_dim = std::stoul(argv[3]);
+  const size_t dense_dim = std::stoul(argv[4]);
+  const bool is_dense_float = std::stoi(argv[5]) != 0;
+  const size_t key_bytes = std::stoul(argv[6]);
+  std::vector<uint32_t> hotness;
+  for (int i = 7; i < argc; ++i) {
+    hotness.push_back(std::stoul(argv[i]));
+  }
+  if ((key_bytes != 4 && key_bytes != 8) || hotness.size() > kPackedMaxFeatures) {
+    HCTR_LOG_S(ERROR, WORLD) << usage_str << std::endl;
+    exit(-1);
+  }
+  const size_t num_keys = std::accumulate(hotness.begin(), hotness.end(), size_t{0});
+  const size_t sample_size_bytes = (label_dim + dense_dim) * sizeof(float) + num_keys * key_bytes;
+
+  std::ifstream in_file(argv[1], std::ifstream::binary);
+  if (!in_file.is_open()) {
+    HCTR_LOG_S(ERROR, WORLD) << "Cannot open " << argv[1] << std::endl;
+    exit(-1);
+  }
+  std::vector<char> sample(sample_size_bytes);
+  auto key_at = [&](size_t k) -> int64_t {
+    const char *key = sample.data() + (label_dim + dense_dim) * sizeof(float) + k * key_bytes;
+    if (key_bytes == 4) {
+      int32_t value;
+      std::memcpy(&value, key, sizeof(value));
+      return value;
+    }
+    int64_t value;
+    std::memcpy(&value, key, sizeof(value));
+    return value;
+  };
+
+  // The first pass finds the bits of each feature.
+  std::vector<uint64_t> max_keys(hotness.size(), 0);
+  size_t num_samples = 0;
+  while (in_file.read(sample.data(), sample_size_bytes)) {
+    for (size_t fea_id = 0, k = 0; fea_id < hotness.size(); ++fea_id) {
+      for (uint32_t h = 0; h < hotness[fea_id]; ++h, ++k) {
+        const int64_t key = key_at(k);
+        if (key < 0) {
+          HCTR_LOG_S(ERROR, WORLD) << "Negative key in sample " << num_samples << std::endl;
+          exit(-1);
+        }
+        max_keys[fea_id] = std::max(max_keys[fea_id], static_cast<uint64_t>(key));
+      }
+    }
+    num_samples++;
+  }
+
+  PackedFileHeader header = {};
+  std::memcpy(header.magic, kPackedMagic, sizeof(kPackedMagic));
+  header.label_dim = label_dim;
+  header.dense_dim = dense_dim;
+  header.num_features = hotness.size();
+  uint32_t num_bits = (label_dim * 32) + (dense_dim * 16);
+  for (size_t fea_id = 0; fea_id < hotness.size(); ++fea_id) {
+    int bits = 1;
+    while (bits < 64 && (max_keys[fea_id] >> bits) != 0) {
+      bits++;
+    }
+    header.hotness[fea_id] = hotness[fea_id];
+    header.key_bits[fea_id] = bits;
+    HCTR_LOG_S(INFO, WORLD) << "feature " << fea_id << ": " << bits << " bits" << std::endl;
+    num_bits += hotness[fea_id] * bits;
+  }
+  header.sample_size_bytes = (num_bits + 31) / 32 * sizeof(uint32_t);
+
+  std::ofstream out_file(argv[2], std::ofstream::binary);
+  std::vector<char> header_bytes(kPackedHeaderBytes, 0);
+  std::memcpy(header_bytes.data(), &header, sizeof(header));
+  out_file.write(header_bytes.data(), header_bytes.size());
+
+  // The second pass packs the samples.
+  in_file.clear();
+  in_file.seekg(0);
+  std::vector<uint32_t> words(header.sample_size_bytes / sizeof(uint32_t));
+  while (in_file.read(sample.data(), sample_size_bytes)) {
+    std::fill(words.begin(), words.end(), 0);
+    uint32_t bit_offset = 0;
+    for (size_t i = 0; i < label_dim; ++i, bit_offset += 32) {
+      std::memcpy(&words[bit_offset / 32], sample.data() + i * sizeof(float), sizeof(float));
+    }
+    for (size_t i = 0; i < dense_dim; ++i, bit_offset += 16) {
+      const char *src = sample.data() + (label_dim + i) * sizeof(float);
+      float dense;
+      if (is_dense_float) {
+        std::memcpy(&dense, src, sizeof(float));
+      } else {
+        uint32_t value;
+        std::memcpy(&value, src, sizeof(value));
+        dense = std::log(static_cast<float>(value) + 1.f);
+      }
+      const __half_raw raw = __half(dense);
+      pack_bits(words, bit_offset, raw.x, 16);
+    }
+    for (size_t fea_id = 0, k = 0; fea_id < hotness.size(); ++fea_id) {
+      for (uint32_t h = 0; h < hotness[fea_id]; ++h, ++k, bit_offset += header.key_bits[fea_id]) {
+        pack_bits(words, bit_offset, key_at(k), header.key_bits[fea_id]);
+      }
+    }
+    out_file.write(reinterpret_cast<char *>(words.data()), header.sample_size_bytes);
+  }
+  HCTR_LOG_S(INFO, WORLD) << "#samples: " << num_samples << ", " << sample_size_bytes << " -> "
+                          << header.sample_size_bytes << " bytes per sample" << std::endl;
+  return 0;
+}
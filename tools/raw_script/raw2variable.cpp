@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <data_readers/multi_hot/variable_format.hpp>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+using namespace HugeCTR::MultiHot;
+
+static std::string usage_str =
+    "usage: ./raw2variable in.bin out.bin label_dim dense_dim key_bytes pad_key hotness...\n"
+    "Converts a multi-hot raw file into the variable-length format. The keys equal to pad_key\n"
+    "are dropped, and the number of keys of each feature is stored before the keys of a sample.\n"
+    "key_bytes is 4 for int32 and 8 for int64 keys.";
+
+int main(int argc, char *argv[]) {
+  if (argc < 8) {
+    HCTR_LOG_S(INFO, WORLD) << usage_str << std::endl;
+    exit(-1);
+  }
+  const size_t label_dim = std::stoul(argv[3]);
+  const size_t dense_dim = std::stoul(argv[4]);
+  const size_t key_bytes = std::stoul(argv[5]);
+  const int64_t pad_key = std::stoll(argv[6]);
+  std::vector<uint32_t> hotness;
+  for (int i = 7; i < argc; ++i) {
+    hotness.push_back(std::stoul(argv[i]));
+  }
+  if ((key_bytes != 4 && key_bytes != 8) || hotness.size() > kVariableMaxFeatures) {
+    HCTR_LOG_S(ERROR, WORLD) << usage_str << std::endl;
+    exit(-1);
+  }
+  const size_t num_keys = std::accumulate(hotness.begin(), hotness.end(), size_t{0});
+  const size_t label_dense_bytes = (label_dim + dense_dim) * sizeof(float);
+  const size_t sample_size_bytes = label_dense_bytes + num_keys * key_bytes;
+
+  std::ifstream in_file(argv[1], std::ifstream::binary);
+  if (!in_file.is_open()) {
+    HCTR_LOG_S(ERROR, WORLD) << "Cannot open " << argv[1] << std::endl;
+    exit(-1);
+  }
+  std::ofstream out_file(argv[2], std::ofstream::binary);
+  std::vector<char> header_bytes(kVariableHeaderBytes, 0);
+  out_file.write(header_bytes.data(), header_bytes.size());
+
+  VariableFileHeader header = {};
+  std::memcpy(header.magic, kVariableMagic, sizeof(kVariableMagic));
+  header.label_dim = label_dim;
+  header.dense_dim = dense_dim;
+  header.num_features = hotness.size();
+  header.key_bytes = key_bytes;
+
+  std::vector<uint64_t> offsets{0};
+  std::vector<char> sample(sample_size_bytes);
+  std::vector<char> out_sample;
+  while (in_file.read(sample.data(), sample_size_bytes)) {
+    out_sample.assign(sample.begin(), sample.begin() + label_dense_bytes);
+    const size_t nnz_begin = out_sample.size();
+    out_sample.resize(nnz_begin + hotness.size() * sizeof(int32_t));
+
+    const char *key = sample.data() + label_dense_bytes;
+    for (size_t fea_id = 0; fea_id < hotness.size(); ++fea_id) {
+      int32_t nnz = 0;
+      for (uint32_t h = 0; h < hotness[fea_id]; ++h, key += key_bytes) {
+        int64_t value = 0;
+        if (key_bytes == 4) {
+          int32_t value32;
+          std::memcpy(&value32, key, sizeof(value32));
+          value = value32;
+        } else {
+          std::memcpy(&value, key, sizeof(value));
+        }
+        if (value != pad_key) {
+          out_sample.insert(out_sample.end(), key, key + key_bytes);
+          nnz++;
+        }
+      }
+      std::memcpy(out_sample.data() + nnz_begin + fea_id * sizeof(int32_t), &nnz, sizeof(nnz));
+      header.max_hotness[fea_id] = std::max(header.max_hotness[fea_id], static_cast<uint32_t>(nnz));
+    }
+    out_file.write(out_sample.data(), out_sample.size());
+    offsets.push_back(offsets.back() + out_sample.size());
+  }
+
+  header.num_samples = offsets.size() - 1;
+  header.index_offset = kVariableHeaderBytes + offsets.back();
+  out_file.write(reinterpret_cast<char *>(offsets.data()), offsets.size() * sizeof(uint64_t));
+  std::memcpy(header_bytes.data(), &header, sizeof(header));
+  out_file.seekp(0);
+  out_file.write(header_bytes.data(), header_bytes.size());
+
+  HCTR_LOG_S(INFO, WORLD) << "#samples: " << header.num_samples << ", " << sample_size_bytes
+                          << " -> "
+                          << static_cast<double>(offsets.back()) /
+                                 std::max<uint64_t>(header.num_samples, 1)
+                          << " bytes per sample on average" << std::endl;
+  return 0;
+}